@@ -95,6 +95,27 @@ CREATE TABLE IF NOT EXISTS `QWorker` (
 ENGINE = InnoDB
 COMMENT = 'Mapping of queries to workers';
 
+-- -----------------------------------------------------
+-- Table `QProgress`
+-- -----------------------------------------------------
+CREATE TABLE IF NOT EXISTS `QProgress` (
+  `queryId` BIGINT NOT NULL COMMENT 'Query ID',
+  `totalChunks` INT NOT NULL COMMENT 'Chunk jobs submitted for the query',
+  `completedChunks` INT NOT NULL COMMENT 'Chunk jobs completed so far',
+  `rowsMerged` BIGINT NOT NULL COMMENT 'Result rows merged so far',
+  `bytesMerged` BIGINT NOT NULL COMMENT 'Result message bytes merged so far',
+  `estTimeLeftSec` INT NOT NULL DEFAULT -1 COMMENT 'Estimated seconds remaining, -1 when unknown',
+  `lastUpdate` TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP ON UPDATE CURRENT_TIMESTAMP
+      COMMENT 'Time of the last progress update',
+  PRIMARY KEY (`queryId`),
+  CONSTRAINT `QProgress_qid`
+    FOREIGN KEY (`queryId`)
+    REFERENCES `QInfo` (`queryId`)
+    ON DELETE CASCADE
+    ON UPDATE CASCADE)
+ENGINE = InnoDB
+COMMENT = 'Execution progress of running queries, updated periodically by the czar';
+
 -- -----------------------------------------------------
 -- View `ShowProcessList`
 -- This shows abbreviated Qmeta info suitable for "SHOW PROCESSLIST"
@@ -111,13 +132,15 @@ CREATE OR REPLACE
     NULL `Time`,
     `QInfo`.`status` `State`,
     `QInfo`.`query` `Info`,
-    NULL `Progress`,
+    CONCAT(`QProgress`.`completedChunks`, '/', `QProgress`.`totalChunks`) `Progress`,
+    `QProgress`.`estTimeLeftSec` `EstTimeLeftSec`,
     `QInfo`.`submitted` `Submitted`,
     `QInfo`.`completed` `Completed`,
     `QInfo`.`returned` `Returned`,
     `QInfo`.`czarId` `CzarId`,
     REPLACE(`QInfo`.`resultLocation`, '#QID#',  `QInfo`.`queryId`) `ResultLocation`
   FROM `QInfo` LEFT OUTER JOIN `QTable` USING (`queryId`)
+        LEFT OUTER JOIN `QProgress` USING (`queryId`)
   GROUP BY `QInfo`.`queryId`;
 
 -- -----------------------------------------------------
@@ -141,11 +164,54 @@ CREATE OR REPLACE
     `QInfo`.`returned` `RETURNED`,
     `QInfo`.`czarId` `CZARID`,
     REPLACE(`QInfo`.`resultLocation`, '#QID#',  `QInfo`.`queryId`) `RESULTLOCATION`,
-    NULLIF(COUNT(`QWorker`.`chunk`), 0) `NCHUNKS`
+    NULLIF(COUNT(`QWorker`.`chunk`), 0) `NCHUNKS`,
+    `QProgress`.`totalChunks` `TOTALCHUNKS`,
+    `QProgress`.`completedChunks` `COMPLETEDCHUNKS`,
+    `QProgress`.`rowsMerged` `ROWSMERGED`,
+    `QProgress`.`bytesMerged` `BYTESMERGED`,
+    `QProgress`.`estTimeLeftSec` `ESTTIMELEFTSEC`,
+    `QProgress`.`lastUpdate` `LASTUPDATE`
   FROM `QInfo` LEFT OUTER JOIN `QTable` USING (`queryId`)
         LEFT OUTER JOIN `QWorker` USING (`queryId`)
+        LEFT OUTER JOIN `QProgress` USING (`queryId`)
   GROUP BY `QInfo`.`queryId`;
 
+-- -----------------------------------------------------
+-- Table `QStats`
+-- -----------------------------------------------------
+CREATE TABLE IF NOT EXISTS `QStats` (
+  `queryId` BIGINT NOT NULL COMMENT 'Query ID',
+  `completedJobs` INT NOT NULL COMMENT 'Chunk jobs that reported timing',
+  `dispatchWaitMs` BIGINT NOT NULL COMMENT 'Czar dispatch until queued on a worker scheduler',
+  `workerQueueMs` BIGINT NOT NULL COMMENT 'Waiting on a worker scheduler queue',
+  `mysqldMs` BIGINT NOT NULL COMMENT 'Waiting on worker mysqld statement execution',
+  `serializeMs` BIGINT NOT NULL COMMENT 'Serializing/compressing result messages',
+  `transferMs` BIGINT NOT NULL COMMENT 'Final result handed to the channel until received by the czar',
+  `mergeMs` BIGINT NOT NULL COMMENT 'Merging results into the result table',
+  PRIMARY KEY (`queryId`),
+  CONSTRAINT `QStats_qid`
+    FOREIGN KEY (`queryId`)
+    REFERENCES `QInfo` (`queryId`)
+    ON DELETE CASCADE
+    ON UPDATE CASCADE)
+ENGINE = InnoDB
+COMMENT = 'Per-query phase timing, milliseconds summed over chunk jobs';
+
+-- -----------------------------------------------------
+-- Table `QShapeStats`
+-- -----------------------------------------------------
+CREATE TABLE IF NOT EXISTS `QShapeStats` (
+  `tableSet` VARCHAR(255) NOT NULL COMMENT 'Sorted comma-separated db.table list',
+  `shapeHash` BIGINT UNSIGNED NOT NULL COMMENT 'Hash of the per-chunk query template',
+  `queryCount` BIGINT NOT NULL COMMENT 'Completed queries of this shape',
+  `chunkCount` BIGINT NOT NULL COMMENT 'Chunks touched, summed over queries',
+  `rowCount` BIGINT NOT NULL COMMENT 'Result rows returned, summed over queries',
+  `workerMs` BIGINT NOT NULL COMMENT 'Worker execution+serialization ms, summed',
+  `mergeMs` BIGINT NOT NULL COMMENT 'Czar-side merge ms, summed',
+  PRIMARY KEY (`tableSet`, `shapeHash`))
+ENGINE = InnoDB
+COMMENT = 'Historical runtime statistics aggregated per query shape';
+
 -- -----------------------------------------------------
 -- Table `QMetadata`
 -- -----------------------------------------------------
@@ -160,7 +226,10 @@ COMMENT = 'Metadata about database as a whole, bunch of key-value pairs';
 -- Version 0 corresponds to initial QMeta release and it had no
 -- QMetadata table at all.
 -- Version 1 introduced QMetadata table and altered schema for QInfo table
-INSERT INTO `QMetadata` (`metakey`, `value`) VALUES ('version', '1');
+-- Version 2 introduced QStats table with per-query phase timing
+-- Version 3 introduced QShapeStats table with historical per-shape statistics
+-- Version 4 introduced QProgress table and progress columns in the views
+INSERT INTO `QMetadata` (`metakey`, `value`) VALUES ('version', '4');
 
 SET SQL_MODE=@OLD_SQL_MODE;
 SET FOREIGN_KEY_CHECKS=@OLD_FOREIGN_KEY_CHECKS;
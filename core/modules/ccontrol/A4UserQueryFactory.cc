@@ -23,8 +23,11 @@
 
 #include "ccontrol/A4UserQueryFactory.h"
 
+#include <chrono>
+#include <fstream>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "antlr4-runtime.h"
 
@@ -87,4 +90,58 @@ shared_ptr<query::SelectStmt> a4NewUserQuery(const string& userQuery) {
 }
 
 
+void a4WarmupParser(string const& corpusPath) {
+    // Statements chosen to exercise the grammar regions real traffic hits:
+    // point/cone lookups, joins, near-neighbor self-joins, aggregates and
+    // ORDER BY/LIMIT. The ATN/DFA caches warmed by an adaptive prediction
+    // are keyed by decision, not by statement text, so parsing these also
+    // speeds up statements that merely look similar.
+    vector<string> statements = {
+        "SELECT * FROM Object WHERE objectId = 12345",
+        "SELECT ra, decl FROM Object WHERE qserv_areaspec_circle(1.5, 3.5, 0.1)",
+        "SELECT ra, decl, psfFlux FROM Object WHERE qserv_areaspec_box(0.1, -6, 4, 6)"
+            " AND psfFlux > 0.0 ORDER BY psfFlux DESC LIMIT 100",
+        "SELECT o.objectId, s.sourceId FROM Object o, Source s"
+            " WHERE o.objectId = s.objectId AND o.objectId = 12345",
+        "SELECT o1.objectId, o2.objectId, scisql_angSep(o1.ra, o1.decl, o2.ra, o2.decl) AS dist"
+            " FROM Object o1, Object o2"
+            " WHERE qserv_areaspec_box(90.0, -10.0, 95.0, -5.0)"
+            " AND scisql_angSep(o1.ra, o1.decl, o2.ra, o2.decl) < 0.05",
+        "SELECT COUNT(*), AVG(psfFlux), MIN(ra), MAX(decl) FROM Object"
+            " WHERE psfFlux BETWEEN 0.1 AND 0.9 GROUP BY chunkId",
+    };
+    if (not corpusPath.empty()) {
+        std::ifstream corpus(corpusPath);
+        if (corpus.good()) {
+            string line;
+            while (std::getline(corpus, line)) {
+                if (line.empty() || line[0] == '#') continue;
+                statements.push_back(line);
+            }
+        } else {
+            LOGS(_log, LOG_LVL_WARN, "parser warm-up corpus " << corpusPath
+                 << " could not be read, using the built-in corpus only");
+        }
+    }
+    auto const start = std::chrono::steady_clock::now();
+    int failed = 0;
+    for (auto const& statement : statements) {
+        try {
+            a4NewUserQuery(statement);
+        } catch (std::exception const& e) {
+            LOGS(_log, LOG_LVL_WARN, "parser warm-up statement failed: " << statement
+                 << ", error: " << e.what());
+            ++failed;
+        } catch (...) {
+            LOGS(_log, LOG_LVL_WARN, "parser warm-up statement failed: " << statement);
+            ++failed;
+        }
+    }
+    auto const elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - start).count();
+    LOGS(_log, LOG_LVL_INFO, "parser warm-up parsed " << statements.size() - failed
+         << " of " << statements.size() << " statements in " << elapsedMs << "ms");
+}
+
+
 }}}
@@ -25,6 +25,7 @@
 #define A4USERQUERYFACTORY_H
 
 #include <memory>
+#include <string>
 
 namespace lsst {
 namespace qserv {
@@ -36,6 +37,15 @@ namespace ccontrol {
 
 std::shared_ptr<query::SelectStmt> a4NewUserQuery(const std::string& userQuery);
 
+/// Populate the generated parser's ATN/DFA prediction caches by parsing a
+/// corpus of representative statements, so the first real queries after a
+/// czar restart do not pay the warm-up cost. The caches live in static
+/// storage of the generated parser, so one pass serves the whole process.
+/// 'corpusPath' optionally names a file with one statement per line
+/// ('#' comments and blank lines ignored) parsed in addition to a small
+/// built-in corpus; parse failures are logged and ignored.
+void a4WarmupParser(std::string const& corpusPath);
+
 }}}
 
 #endif
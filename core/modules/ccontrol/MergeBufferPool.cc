@@ -0,0 +1,99 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "ccontrol/MergeBufferPool.h"
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+namespace {
+LOG_LOGGER _log = LOG_GET("lsst.qserv.ccontrol.MergeBufferPool");
+}
+
+namespace lsst {
+namespace qserv {
+namespace ccontrol {
+
+// definitions for the in-class initialized constants
+size_t const MergeBufferPool::_minClassBytes;
+size_t const MergeBufferPool::_maxClassBytes;
+size_t const MergeBufferPool::_maxIdleBytes;
+
+MergeBufferPool& MergeBufferPool::instance() {
+    static MergeBufferPool pool;
+    return pool;
+}
+
+size_t MergeBufferPool::_classFor(size_t sz) {
+    if (sz > _maxClassBytes) return 0;
+    size_t cls = _minClassBytes;
+    while (cls < sz) cls <<= 1;
+    return cls;
+}
+
+std::unique_ptr<MergeBufferPool::bufType> MergeBufferPool::acquire(size_t sz) {
+    size_t const cls = _classFor(sz);
+    if (cls != 0) {
+        std::lock_guard<std::mutex> lock(_mtx);
+        // The smallest class that fits sz, or failing that the next one
+        // up - a larger buffer is still a hit, just a looser fit.
+        for (auto iter = _free.lower_bound(cls); iter != _free.end(); ++iter) {
+            if (!iter->second.empty()) {
+                auto buff = std::move(iter->second.back());
+                iter->second.pop_back();
+                _idleBytes -= buff->capacity();
+                buff->resize(sz);
+                return buff;
+            }
+        }
+    }
+    std::unique_ptr<bufType> buff(new bufType);
+    // Reserve the full class so the buffer re-enters its class on release
+    // regardless of the exact block size that triggered the allocation.
+    if (cls != 0) buff->reserve(cls);
+    buff->resize(sz);
+    return buff;
+}
+
+void MergeBufferPool::release(std::unique_ptr<bufType> buff) {
+    if (buff == nullptr) return;
+    size_t const capacity = buff->capacity();
+    // Only pool buffers sitting exactly on a class boundary; odd capacities
+    // (from vectors that grew by resize) would fragment the free lists.
+    if (capacity < _minClassBytes || capacity > _maxClassBytes
+        || _classFor(capacity) != capacity) {
+        return; // freed on scope exit
+    }
+    buff->clear();
+    std::lock_guard<std::mutex> lock(_mtx);
+    if (_idleBytes + capacity > _maxIdleBytes) {
+        LOGS(_log, LOG_LVL_DEBUG, "release dropping buffer capacity=" << capacity
+             << " idleBytes=" << _idleBytes);
+        return; // freed on scope exit
+    }
+    _idleBytes += capacity;
+    _free[capacity].push_back(std::move(buff));
+}
+
+}}} // namespace lsst::qserv::ccontrol
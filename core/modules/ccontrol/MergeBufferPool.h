@@ -0,0 +1,95 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_CCONTROL_MERGEBUFFERPOOL_H
+#define LSST_QSERV_CCONTROL_MERGEBUFFERPOOL_H
+
+// System headers
+#include <map>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace lsst {
+namespace qserv {
+namespace ccontrol {
+
+/// MergeBufferPool recycles the receive buffers that result blocks from
+/// the workers land in (see MergeBuffer). Every block otherwise allocates
+/// and frees a vector sized to ProtoHeader::size - typically around the
+/// 2MB protobuf limit - and at merge rates of GB/s that is constant
+/// allocator traffic of large short-lived buffers. The pool is shared by
+/// all queries on the czar and keeps freed buffers on per-size-class free
+/// lists (capacities rounded up to powers of two), so a steady stream of
+/// blocks reuses a small working set of allocations. Idle bytes held by
+/// the pool are capped; buffers returned beyond the cap, or larger than
+/// the largest class, are freed instead of pooled.
+class MergeBufferPool {
+public:
+    using bufType = std::vector<char>;
+
+    /// @return the per-process pool instance.
+    static MergeBufferPool& instance();
+
+    // Instances cannot be copied
+    MergeBufferPool(MergeBufferPool const&) = delete;
+    MergeBufferPool& operator=(MergeBufferPool const&) = delete;
+
+    /// Get a buffer resized to sz. The buffer comes from the free list of
+    /// the smallest size class that fits sz when one is available, and is
+    /// freshly allocated (at the class capacity) otherwise.
+    std::unique_ptr<bufType> acquire(size_t sz);
+
+    /// Hand a no-longer-needed buffer back to the pool. The buffer is
+    /// offered to the free list of its capacity class; if the pool is at
+    /// its idle-bytes cap, or the buffer does not fit a class, it is
+    /// freed instead. nullptr is ignored.
+    void release(std::unique_ptr<bufType> buff);
+
+private:
+
+    MergeBufferPool() = default;
+
+    /// @return the class capacity for sz: the smallest power of two
+    /// >= both sz and _minClassBytes, or 0 if sz exceeds _maxClassBytes.
+    static size_t _classFor(size_t sz);
+
+    /// The smallest pooled capacity; smaller requests (the fixed-size
+    /// header reads) share this class.
+    static size_t const _minClassBytes = 4096;
+
+    /// The largest pooled capacity, the first power of two that fits
+    /// proto::ProtoHeaderWrap::PROTOBUFFER_HARD_LIMIT.
+    static size_t const _maxClassBytes = 64 * 1024 * 1024;
+
+    /// The most idle bytes kept across all free lists.
+    static size_t const _maxIdleBytes = 256 * 1024 * 1024;
+
+    std::map<size_t, std::vector<std::unique_ptr<bufType>>> _free; ///< idle buffers by class capacity
+    size_t _idleBytes = 0; ///< total capacity held in _free
+
+    std::mutex _mtx; ///< protects _free and _idleBytes
+};
+
+}}} // namespace lsst::qserv::ccontrol
+
+#endif // LSST_QSERV_CCONTROL_MERGEBUFFERPOOL_H
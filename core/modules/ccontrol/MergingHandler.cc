@@ -26,11 +26,13 @@
 
 // System headers
 #include <cassert>
+#include <vector>
 
 // LSST headers
 #include "lsst/log/Log.h"
 
 // Qserv headers
+#include "ccontrol/MergeBufferPool.h"
 #include "ccontrol/msgCode.h"
 #include "global/Bug.h"
 #include "global/debugUtil.h"
@@ -139,15 +141,36 @@ bool MergingHandler::flush(int bLen, bool& last, bool& largeResult) {
             } else {
                 LOGS(_log, LOG_LVL_DEBUG, jobId << " Message ends, setting last=true");
                 last = true;
+                // The final Result carries the worker's phase timing; hand it
+                // to the Executive for the per-query breakdown.
+                if (_response->result.has_timing() && jobQuery != nullptr) {
+                    if (auto exec = jobQuery->getExecutive()) {
+                        auto const& timing = _response->result.timing();
+                        exec->recordTaskTiming(jobQuery->getDispatchEpochMs(),
+                                               timing.queuedtime(), timing.starttime(),
+                                               timing.sendtime(), timing.mysqlms(),
+                                               timing.serializems());
+                    }
+                }
             }
             LOGS(_log, LOG_LVL_DEBUG, jobId << " Flushed msgContinues=" << msgContinues
                  << " last=" << last << " for tableName=" << _tableName);
 
-            auto success = _merge();
+            // Hand the parsed fragment over to mergeFlushed() instead of
+            // merging it here. This lets the caller put the request for the
+            // next block on the wire before the merge starts, overlapping
+            // the transfer with the merge. If the previous fragment is still
+            // being merged, wait for it first - at most one unmerged
+            // fragment is held at a time.
+            {
+                std::unique_lock<std::mutex> mergeLock(_mergeMtx);
+                _mergeCv.wait(mergeLock, [this](){ return _deferredResponse == nullptr; });
+                _deferredResponse = _response;
+            }
             if (msgContinues) {
                 _response.reset(new WorkerResponse());
             }
-            return success;
+            return true;
         }
     case MsgState::RESULT_EXTRA:
         if (!proto::ProtoHeaderWrap::unwrap(_response, _mBuf.getBuffer())) {
@@ -183,6 +206,25 @@ bool MergingHandler::flush(int bLen, bool& last, bool& largeResult) {
     return false;
 }
 
+bool MergingHandler::mergeFlushed() {
+    std::shared_ptr<WorkerResponse> response;
+    {
+        std::lock_guard<std::mutex> mergeLock(_mergeMtx);
+        response = _deferredResponse;
+    }
+    if (response == nullptr) {
+        // Nothing deferred, the last flush() handled a header.
+        return true;
+    }
+    auto success = _merge(response);
+    {
+        std::lock_guard<std::mutex> mergeLock(_mergeMtx);
+        _deferredResponse.reset();
+    }
+    _mergeCv.notify_one();
+    return success;
+}
+
 void MergingHandler::errorFlush(std::string const& msg, int code) {
     _setError(code, msg);
     // Might want more info from result service.
@@ -228,19 +270,18 @@ void MergingHandler::_initState() {
     _setError(0, "");
 }
 
-bool MergingHandler::_merge() {
+bool MergingHandler::_merge(std::shared_ptr<proto::WorkerResponse> const& response) {
     if (auto job = getJobQuery().lock()) {
         if (_flushed) {
             throw Bug("MergingRequester::_merge : already flushed");
         }
-        bool success = _infileMerger->merge(_response);
+        bool success = _infileMerger->merge(response);
         if (!success) {
             LOGS(_log, LOG_LVL_WARN, "_merge() failed");
             rproc::InfileMergerError const& err = _infileMerger->getError();
             _setError(ccontrol::MSG_RESULT_ERROR, err.getMsg());
             _state = MsgState::RESULT_ERR;
         }
-        _response.reset();
         return success;
     }
     LOGS(_log, LOG_LVL_ERROR, "MergingHandler::_merge() failed, jobQuery was NULL");
@@ -256,7 +297,23 @@ void MergingHandler::_setError(int code, std::string const& msg) {
 bool MergingHandler::_setResult() {
     auto start = std::chrono::system_clock::now();
     auto buff = _mBuf.getBuffer();
-    if (!ProtoImporter<proto::Result>::setMsgFrom(_response->result, &((buff)[0]), _mBuf.getSize())) {
+    char const* data = &((buff)[0]);
+    size_t size = _mBuf.getSize();
+    // If the worker compressed the message, decompress it before parsing.
+    // MD5 verification has already run on the bytes as transmitted.
+    std::vector<char> uncompressed;
+    if (_response->protoHeader.compression() != proto::COMP_NONE) {
+        if (!proto::ProtoHeaderWrap::decompressMsg(data, size, _response->protoHeader.compression(),
+                                                   _response->protoHeader.uncompressedsize(),
+                                                   uncompressed)) {
+            _setError(ccontrol::MSG_RESULT_DECODE, "Error decompressing result msg");
+            _state = MsgState::RESULT_ERR;
+            return false;
+        }
+        data = uncompressed.data();
+        size = uncompressed.size();
+    }
+    if (!ProtoImporter<proto::Result>::setMsgFrom(_response->result, data, size)) {
         _setError(ccontrol::MSG_RESULT_DECODE, "Error decoding result msg");
         _state = MsgState::RESULT_ERR;
         return false;
@@ -282,6 +339,7 @@ MergeBuffer::~MergeBuffer() {
         _totalBytes -= _buff->size();
         LOGS(_log, LOG_LVL_DEBUG, _id << " ~ totalBytes=" << _totalBytes);
     }
+    MergeBufferPool::instance().release(std::move(_buff));
 }
 
 
@@ -318,15 +376,26 @@ void MergeBuffer::zero() {
         _totalBytes -= _buff->size();
         LOGS(_log, LOG_LVL_DEBUG, _id << " zero totalBytes=" << _totalBytes);
     }
-    // Just resizing to 0 would not guarantee freeing the memory.
-    _buff.reset(new bufType(0));
+    // Hand the memory back to the pool instead of freeing it; the next
+    // result block on any query reuses it through acquire().
+    MergeBufferPool::instance().release(std::move(_buff));
+    _buff = MergeBufferPool::instance().acquire(0);
  }
 
 
  void MergeBuffer::_resize(int sz) {
      if (sz != (int)_buff->size()) {
          _totalBytes += sz - _buff->size();
-         _buff->resize(sz);
+         if (static_cast<size_t>(sz) > _buff->capacity()) {
+             // Growing always happens from an empty buffer (zero() precedes
+             // every target size change), so swap in a pooled buffer of the
+             // right size class rather than growing this one to a capacity
+             // the pool would not take back.
+             MergeBufferPool::instance().release(std::move(_buff));
+             _buff = MergeBufferPool::instance().acquire(sz);
+         } else {
+             _buff->resize(sz);
+         }
          LOGS(_log, LOG_LVL_DEBUG, _id << " resize totalBytes=" << _totalBytes);
      } else if (sz != 0) {
          LOGS(_log, LOG_LVL_WARN, _id << " resize called twice sz=" << sz << " totalBytes=" << _totalBytes);
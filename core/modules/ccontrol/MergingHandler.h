@@ -25,6 +25,7 @@
 
 // System headers
 #include <atomic>
+#include <condition_variable>
 #include <memory>
 #include <mutex>
 
@@ -50,7 +51,10 @@ namespace ccontrol {
 /// by xrootd SSI. The size of the buffer that will be needed is
 /// set using setTargetSize(int sz), and the buffer of that size is
 /// created by calling resizeToTargetSize(). When a buffer is no longer
-/// needed, zero() should be called to free the memory.
+/// needed, zero() should be called to release the memory. The memory
+/// itself comes from the czar-wide MergeBufferPool and is recycled
+/// there rather than freed, so result blocks arriving at GB/s do not
+/// allocate a fresh multi-megabyte buffer each.
 class MergeBuffer {
 public:
     using bufType = std::vector<char>;
@@ -126,6 +130,10 @@ public:
     /// @return true if successful (no error)
     bool flush(int bLen, bool& last, bool& largeResult) override;
 
+    /// Merge the result fragment accepted by the preceding flush() call.
+    /// @see ResponseHandler::mergeFlushed()
+    bool mergeFlushed() override;
+
     /// Signal an unrecoverable error condition. No further calls are expected.
     void errorFlush(std::string const& msg, int code) override;
 
@@ -149,7 +157,7 @@ public:
 
 private:
     void _initState();
-    bool _merge();
+    bool _merge(std::shared_ptr<proto::WorkerResponse> const& response);
     void _setError(int code, std::string const& msg);
     bool _setResult();
     bool _verifyResult();
@@ -163,6 +171,15 @@ private:
     mutable std::mutex _errorMutex; ///< Protect readers from partial updates
     MsgState _state; ///< Received message state
     std::shared_ptr<proto::WorkerResponse> _response; ///< protobufs msg buf
+
+    /// The result fragment handed over by flush() and waiting to be pushed
+    /// into the InfileMerger by mergeFlushed(). At most one fragment is held
+    /// here; flush() blocks while the previous fragment is still merging,
+    /// which bounds the memory spent on unmerged fragments.
+    std::shared_ptr<proto::WorkerResponse> _deferredResponse;
+    std::mutex _mergeMtx; ///< protects _deferredResponse
+    std::condition_variable _mergeCv; ///< signalled when _deferredResponse is consumed
+
     bool _flushed {false}; ///< flushed to InfileMerger?
     std::string _wName {"~"}; /// worker name
 };
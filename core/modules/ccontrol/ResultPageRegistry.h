@@ -0,0 +1,90 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_CCONTROL_RESULTPAGEREGISTRY_H
+#define LSST_QSERV_CCONTROL_RESULTPAGEREGISTRY_H
+
+// System headers
+#include <map>
+#include <memory>
+#include <mutex>
+
+// Qserv headers
+#include "global/intTypes.h"
+
+// Forward declarations
+namespace lsst {
+namespace qserv {
+namespace rproc {
+class InfileMerger;
+}}} // namespace lsst::qserv::rproc
+
+namespace lsst {
+namespace qserv {
+namespace ccontrol {
+
+/**
+ * ResultPageRegistry maps the query ID of an executing ASYNC query to its
+ * live InfileMerger, so that a QSERV_RESULT_PAGE statement (served by
+ * UserQueryResultPage) can export already-merged rows while the remaining
+ * chunks are still in flight. UserQuerySelect registers eligible queries
+ * when dispatch starts and removes them when the query is joined; mergers
+ * are held weakly, so a missed removal cannot extend a merger's life.
+ * Owned by the factory, shared between concurrent queries.
+ */
+class ResultPageRegistry {
+public:
+    using Ptr = std::shared_ptr<ResultPageRegistry>;
+
+    ResultPageRegistry() = default;
+    ResultPageRegistry(ResultPageRegistry const&) = delete;
+    ResultPageRegistry& operator=(ResultPageRegistry const&) = delete;
+
+    /// Register the merger of an executing pageable query.
+    void add(QueryId queryId, std::shared_ptr<rproc::InfileMerger> const& merger) {
+        std::lock_guard<std::mutex> lock(_mtx);
+        _mergers[queryId] = merger;
+    }
+
+    /// Remove a query's registration; harmless if it was never added.
+    void remove(QueryId queryId) {
+        std::lock_guard<std::mutex> lock(_mtx);
+        _mergers.erase(queryId);
+    }
+
+    /// @return the live merger of the given query, or nullptr if the query
+    /// is not registered (not pageable, or no longer executing).
+    std::shared_ptr<rproc::InfileMerger> find(QueryId queryId) {
+        std::lock_guard<std::mutex> lock(_mtx);
+        auto iter = _mergers.find(queryId);
+        if (iter == _mergers.end()) return nullptr;
+        return iter->second.lock();
+    }
+
+private:
+    std::mutex _mtx; ///< Protects _mergers.
+    std::map<QueryId, std::weak_ptr<rproc::InfileMerger>> _mergers;
+};
+
+}}} // namespace lsst::qserv::ccontrol
+
+#endif // LSST_QSERV_CCONTROL_RESULTPAGEREGISTRY_H
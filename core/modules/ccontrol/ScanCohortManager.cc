@@ -0,0 +1,88 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "ccontrol/ScanCohortManager.h"
+
+// System headers
+#include <set>
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+// Qserv headers
+#include "proto/ScanTableInfo.h"
+
+namespace {
+LOG_LOGGER _log = LOG_GET("lsst.qserv.ccontrol.ScanCohortManager");
+}
+
+namespace lsst {
+namespace qserv {
+namespace ccontrol {
+
+std::string
+ScanCohortManager::makeFamily(proto::ScanInfo const& scanInfo) {
+    // sort and deduplicate so the key does not depend on table order
+    std::set<std::string> names;
+    for (auto const& table : scanInfo.infoTables) {
+        names.insert(table.db + "." + table.table);
+    }
+    std::string family;
+    for (auto const& name : names) {
+        if (not family.empty()) family += ",";
+        family += name;
+    }
+    return family;
+}
+
+
+ScanCohortManager::Member::Ptr
+ScanCohortManager::join(std::string const& family) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    auto& cohort = _cohorts[family];
+    if (cohort == nullptr) {
+        cohort = std::make_shared<Cohort>();
+        LOGS(_log, LOG_LVL_DEBUG, "new scan cohort for " << family);
+    } else {
+        LOGS(_log, LOG_LVL_INFO, "joining scan cohort for " << family
+             << " with " << cohort->members << " members at chunk "
+             << cohort->position.load());
+    }
+    ++cohort->members;
+    return Member::Ptr(new Member(this, family, cohort));
+}
+
+
+void
+ScanCohortManager::_leave(std::string const& family) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    auto iter = _cohorts.find(family);
+    if (iter == _cohorts.end()) return;
+    if (--iter->second->members <= 0) {
+        LOGS(_log, LOG_LVL_DEBUG, "scan cohort for " << family << " finished");
+        _cohorts.erase(iter);
+    }
+}
+
+}}} // namespace lsst::qserv::ccontrol
@@ -0,0 +1,135 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_CCONTROL_SCANCOHORTMANAGER_H
+#define LSST_QSERV_CCONTROL_SCANCOHORTMANAGER_H
+
+// System headers
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// Forward declarations
+namespace lsst {
+namespace qserv {
+namespace proto {
+struct ScanInfo;
+}}} // namespace lsst::qserv::proto
+
+namespace lsst {
+namespace qserv {
+namespace ccontrol {
+
+/**
+ * ScanCohortManager groups concurrent full-scan queries over the same
+ * table family into cohorts so the cluster performs one circulating scan
+ * per family instead of one per query. The workers already align
+ * same-chunk Tasks (ChunkTasksQueue), but that only pays off when
+ * concurrent scans reach the same chunks at the same time; a query
+ * dispatched mid-scan used to start from chunk zero and trail the
+ * in-progress scan for its whole duration. A joining query now reads the
+ * cohort's current position - the chunk most recently completed by any
+ * member - rotates its chunk dispatch order to start just past it, and
+ * wraps around, so its Tasks meet the circulating scan where it is.
+ *
+ * The manager only influences dispatch order; it never delays or drops a
+ * chunk, so the worst case (an empty or stale position) is exactly the
+ * old behavior.
+ */
+class ScanCohortManager {
+public:
+    using Ptr = std::shared_ptr<ScanCohortManager>;
+
+    class Member;
+
+    ScanCohortManager() = default;
+    ScanCohortManager(ScanCohortManager const&) = delete;
+    ScanCohortManager& operator=(ScanCohortManager const&) = delete;
+
+    /// @return the cohort key for a query's shared-scan tables: the sorted
+    /// comma-separated "db.table" list, or an empty string when the query
+    /// has no scan tables (and thus joins no cohort).
+    static std::string makeFamily(proto::ScanInfo const& scanInfo);
+
+    /// Join the cohort scanning 'family', creating it on first join.
+    /// The returned handle leaves the cohort when destroyed.
+    std::shared_ptr<Member> join(std::string const& family);
+
+private:
+
+    /// One circulating scan; exists while it has members.
+    struct Cohort {
+        int members = 0;                 ///< Queries in the cohort.
+        std::atomic<int> position{-1};   ///< Most recently completed chunk, -1 before any.
+    };
+
+    friend class Member;
+
+    /// Called by ~Member().
+    void _leave(std::string const& family);
+
+    std::mutex _mtx;    ///< Protects _cohorts and Cohort::members.
+    std::map<std::string, std::shared_ptr<Cohort>> _cohorts;
+
+public:
+
+    /**
+     * Class Member is one query's membership in a cohort. The dispatching
+     * query reads getPosition() once to choose its starting chunk and calls
+     * advance() as its chunks complete; both are lock-free. Destroying the
+     * handle leaves the cohort, which is discarded with its last member.
+     */
+    class Member {
+    public:
+        using Ptr = std::shared_ptr<Member>;
+
+        Member(Member const&) = delete;
+        Member& operator=(Member const&) = delete;
+
+        ~Member() { _manager->_leave(_family); }
+
+        /// @return the chunk most recently completed by any cohort member,
+        /// -1 if the cohort has not completed a chunk yet.
+        int getPosition() const { return _cohort->position.load(); }
+
+        /// Report a completed chunk of the shared scan.
+        void advance(int chunkId) { _cohort->position.store(chunkId); }
+
+    private:
+        friend class ScanCohortManager;
+
+        Member(ScanCohortManager* manager, std::string const& family,
+               std::shared_ptr<Cohort> const& cohort)
+            : _manager(manager), _family(family), _cohort(cohort) {
+        }
+
+        ScanCohortManager* _manager;     ///< Owning manager, outlives members.
+        std::string const _family;
+        std::shared_ptr<Cohort> const _cohort;
+    };
+};
+
+}}} // namespace lsst::qserv::ccontrol
+
+#endif // LSST_QSERV_CCONTROL_SCANCOHORTMANAGER_H
@@ -31,12 +31,18 @@
 //   of tags.
 // * If you store objects, you probably want to store shared_ptrs.
 // * The session manager makes a copy of the Value that is stored.
+// * The session table is sharded by session id so that concurrent
+//   frontend calls operating on different sessions do not contend on
+//   a single mutex. Ids are dispensed sequentially from an atomic
+//   counter, so new sessions land on the shards round-robin.
 //
 #ifndef LSST_QSERV_CCONTROL_SESSIONMANAGER_H
 #define LSST_QSERV_CCONTROL_SESSIONMANAGER_H
 
 // System headers
-#include <cassert>
+#include <array>
+#include <atomic>
+#include <cstdint>
 #include <map>
 #include <mutex>
 
@@ -47,25 +53,33 @@ namespace ccontrol {
 template <typename Value>
 class SessionManager {
 public:
-    SessionManager() :_idLimit(200000000), _nextId(1) {}
+    SessionManager() : _idLimit(200000000), _nextId(0) {}
 
     int newSession(Value const& v) {
-        std::lock_guard<std::mutex> g(_mutex);
-        int id = _getNextId();
-        _map[id] = v;
-        return id;
+        while(true) {
+            int const id = _allocateId();
+            Shard& shard = _shard(id);
+            std::lock_guard<std::mutex> g(shard.mutex);
+            if(shard.map.insert(std::make_pair(id, v)).second) {
+                return id;
+            }
+            // The id is still in use after the counter wrapped
+            // around (coat check ran out of tags), try the next one.
+        }
     }
 
     Value& getSession(int id) {
-        std::lock_guard<std::mutex> g(_mutex);
-        return _map[id];
+        Shard& shard = _shard(id);
+        std::lock_guard<std::mutex> g(shard.mutex);
+        return shard.map[id];
     }
 
     void discardSession(int id) {
-        std::lock_guard<std::mutex> g(_mutex);
-        MapIterator i = _map.find(id);
-        if(i != _map.end()) {
-            _map.erase(i);
+        Shard& shard = _shard(id);
+        std::lock_guard<std::mutex> g(shard.mutex);
+        MapIterator i = shard.map.find(id);
+        if(i != shard.map.end()) {
+            shard.map.erase(i);
         }
     }
 
@@ -73,25 +87,28 @@ private:
     typedef std::map<int, Value> Map;
     typedef typename Map::iterator MapIterator;
 
-    int _getNextId() {
-        int goodId = _nextId++; // Dispense the next id.
-        while(true) {
-            if(_nextId < _idLimit) { // Still within limit?
-                MapIterator i = _map.find(_nextId);
-                if(i == _map.end()) { // Not already assigned?
-                    break;
-                }
-            }
-            ++_nextId;
-        }
-        assert(goodId != _nextId); // Should have found *new* nextId.
-        return goodId;
+    struct Shard {
+        Map map;
+        std::mutex mutex;
+    };
+
+    static size_t const _numShards = 16;
+
+    Shard& _shard(int id) {
+        return _shards[size_t(id) % _numShards];
+    }
+
+    // Dispense the next id without taking any locks. The monotonic
+    // counter is folded into [1, _idLimit), and for all practical
+    // purposes it never wraps around.
+    int _allocateId() {
+        uint64_t const count = _nextId.fetch_add(1, std::memory_order_relaxed);
+        return 1 + int(count % uint64_t(_idLimit - 1));
     }
 
-    std::mutex _mutex;
-    Map _map;
+    std::array<Shard, _numShards> _shards;
     int const _idLimit; // explicit arbitrary numerical id limit.
-    int _nextId;
+    std::atomic<uint64_t> _nextId;
 };
 
 }}} // namespace lsst::qserv::ccontrol
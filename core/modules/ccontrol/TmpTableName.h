@@ -50,7 +50,9 @@ public:
 private:
     std::string _makePrefix(QueryId qId, std::string const& query) const {
         std::stringstream ss;
-        ss << "r_" << qId << "_" << util::StringHash::getMd5Hex(query.data(), query.size()) << "_";
+        // The qId already makes the name unique; the query hash only guards
+        // against stale leftovers, so a fast 64-bit hash is plenty.
+        ss << "r_" << qId << "_" << util::StringHash::getXxHash64Hex(query.data(), query.size()) << "_";
         return ss.str();
     }
     std::string const _prefix;
@@ -26,8 +26,13 @@
 
 // System headers
 #include <cassert>
+#include <chrono>
 #include <cstdlib>
+#include <future>
+#include <map>
+#include <mutex>
 #include <string>
+#include <vector>
 
 // Third-party headers
 
@@ -38,22 +43,28 @@
 #include "ccontrol/ConfigError.h"
 #include "ccontrol/ConfigMap.h"
 #include "ccontrol/A4UserQueryFactory.h"
+#include "ccontrol/ResultPageRegistry.h"
+#include "ccontrol/ScanCohortManager.h"
 #include "ccontrol/UserQueryAsyncResult.h"
 #include "ccontrol/UserQueryDrop.h"
 #include "ccontrol/UserQueryFlushChunksCache.h"
 #include "ccontrol/UserQueryInvalid.h"
 #include "ccontrol/UserQueryProcessList.h"
+#include "ccontrol/UserQueryResultPage.h"
 #include "ccontrol/UserQuerySelect.h"
 #include "ccontrol/UserQueryType.h"
 #include "css/CssAccess.h"
+#include "css/EmptyChunks.h"
 #include "css/KvInterfaceImplMem.h"
 #include "czar/CzarConfig.h"
 #include "mysql/MySqlConfig.h"
+#include "parser/FastPathParser.h"
 #include "parser/ParseException.h"
 #include "parser/SelectParser.h"
 #include "qdisp/Executive.h"
 #include "qdisp/MessageStore.h"
 #include "qmeta/QMetaMysql.h"
+#include "qmeta/QMetaWriteBehind.h"
 #include "qmeta/QMetaSelect.h"
 #include "qproc/QuerySession.h"
 #include "qproc/SecondaryIndex.h"
@@ -61,6 +72,8 @@
 #include "query/SelectStmt.h"
 #include "rproc/InfileMerger.h"
 #include "sql/SqlConnection.h"
+#include "util/FlightRecorder.h"
+#include "util/Trace.h"
 
 namespace {
 LOG_LOGGER _log = LOG_GET("lsst.qserv.ccontrol.UserQueryFactory");
@@ -76,7 +89,16 @@ namespace ccontrol {
 class UserQueryFactory::Impl {
 public:
 
-    Impl(czar::CzarConfig const& czarConfig);
+    Impl(czar::CzarConfig const& czarConfig, std::string const& czarName);
+
+    /// @return a private copy of the parsed statement for 'query', or
+    /// nullptr if it has not been seen recently.
+    std::shared_ptr<query::SelectStmt> lookupParseCache(std::string const& query);
+
+    /// Remember the parse result for 'query'. A copy is stored; the caller
+    /// keeps sole ownership of 'stmt'.
+    void addToParseCache(std::string const& query,
+                         std::shared_ptr<query::SelectStmt> const& stmt);
 
     /// State shared between UserQueries
     qdisp::Executive::Config::Ptr executiveConfig;
@@ -87,25 +109,26 @@ public:
     std::shared_ptr<qmeta::QMetaSelect> qMetaSelect;
     std::unique_ptr<sql::SqlConnection> resultDbConn;
     qmeta::CzarId qMetaCzarId = {0};   ///< Czar ID in QMeta database
+    ScanCohortManager::Ptr scanCohorts; ///< Shared-scan cohorts across queries
+    ResultPageRegistry::Ptr resultPagers; ///< Executing pageable queries (QSERV_RESULT_PAGE)
+
+private:
+    /// Upper bound on cached parse results; the cache is flushed when the
+    /// limit is reached. Entries are parse trees only (no CSS or analysis
+    /// state), so a flush costs nothing but re-parsing.
+    static size_t const MAX_PARSE_CACHE_SIZE = 1000;
+
+    std::map<std::string, std::shared_ptr<query::SelectStmt>> _parseCache;
+    std::mutex _parseCacheMutex;
 };
 
 
 ////////////////////////////////////////////////////////////////////////
 UserQueryFactory::UserQueryFactory(czar::CzarConfig const& czarConfig,
                                    std::string const& czarName)
-    :  _impl(std::make_shared<Impl>(czarConfig)) {
+    :  _impl(std::make_shared<Impl>(czarConfig, czarName)) {
 
     ::putenv((char*)"XRDDEBUG=1");
-
-    // register czar in QMeta
-    // TODO: check that czar with the same name is not active already?
-    _impl->qMetaCzarId = _impl->queryMetadata->registerCzar(czarName);
-
-    // When czar crashes/exits while some queries are still in flight they
-    // are left in EXECUTING state in QMeta. We want to cleanup that state
-    // to avoid confusion. Note that when/if clean czar restart is implemented
-    // we'll need a new logic to restart query processing.
-    _impl->queryMetadata->cleanup(_impl->qMetaCzarId);
 }
 
 
@@ -117,12 +140,49 @@ UserQueryFactory::antlr2NewSelectStmt(const std::string& query) {
 }
 
 
+void
+UserQueryFactory::warmUpDatabase(std::string const& dbName) {
+    try {
+        if (not _impl->css->containsDb(dbName)) {
+            LOGS(_log, LOG_LVL_DEBUG, "warm-up skipped, db not in CSS: " << dbName);
+            return;
+        }
+        // Read through the database's CSS subtree; with snapshots enabled
+        // this is cheap, without them it fills the per-key caches that the
+        // first query would otherwise fill one blocking read at a time.
+        _impl->css->getDbStriping(dbName);
+        auto const tables = _impl->css->getTableNames(dbName, false);
+        std::vector<std::string> directors;
+        for (auto const& table : tables) {
+            auto const partParams = _impl->css->getPartTableParams(dbName, table);
+            if (partParams.dirTable == table) {
+                directors.push_back(table);
+            }
+        }
+        // Build and publish the empty-chunk bitmap for the database.
+        _impl->css->getEmptyChunks().getEmptyBitmap(dbName);
+        // Fault in the mmap'ed secondary index files of the director
+        // tables, the largest of the cold-metadata costs.
+        if (_impl->secondaryIndex != nullptr) {
+            _impl->secondaryIndex->warmDatabase(dbName, directors);
+        }
+        LOGS(_log, LOG_LVL_INFO, "warmed up db " << dbName << ": "
+             << tables.size() << " tables, " << directors.size() << " director tables");
+    } catch (std::exception const& exc) {
+        // Warm-up is an optimization; the first query pays the cost
+        // instead and reports any real problem itself.
+        LOGS(_log, LOG_LVL_WARN, "warm-up of db " << dbName << " failed: " << exc.what());
+    }
+}
+
+
 UserQuery::Ptr
 UserQueryFactory::newUserQuery(std::string const& aQuery,
                                std::string const& defaultDb,
                                qdisp::QdispPool::Ptr const& qdispPool,
                                std::string const& userQueryId,
-                               std::string const& msgTableName) {
+                               std::string const& msgTableName,
+                               std::string const& user) {
 
     // result location could potentially be specified by SUBMIT command, for now
     // we keep it empty which means that UserQuerySelect uses default result table.
@@ -144,6 +204,7 @@ UserQueryFactory::newUserQuery(std::string const& aQuery,
     }
 
     std::string dbName, tableName;
+    IntVector addedEmpty, removedEmpty;
     bool full = false;
     QueryId userJobId = 0;
 
@@ -156,14 +217,34 @@ UserQueryFactory::newUserQuery(std::string const& aQuery,
 
         // Parse SELECT
 
-        // parse using antlr4
-        std::shared_ptr<query::SelectStmt> stmt;
-        try {
-            stmt = a4NewUserQuery(query);
-        } catch (parser::adapter_order_error& e) {
-            return std::make_shared<UserQueryInvalid>(std::string("ParseException:") + e.what());
-        } catch (parser::adapter_execution_error& e) {
-            return std::make_shared<UserQueryInvalid>(std::string("ParseException:") + e.what());
+        // Check for a recent parse of the same statement text before paying
+        // for a full antlr4 parse. Dashboards and monitoring tend to
+        // re-issue identical statements at a fixed cadence, and a parse
+        // costs tens of ms on complex queries. The cached tree is
+        // pre-analysis, so CSS changes do not invalidate it; each hit hands
+        // back a private clone for the downstream plugins to mutate.
+        // Trivial point/cone lookups dominate interactive traffic; try the
+        // hand-rolled fast-path parser before anything else. Its results are
+        // cheap enough to rebuild that they are not worth cache slots.
+        std::shared_ptr<query::SelectStmt> stmt = parser::tryFastPathParse(query);
+        if (stmt == nullptr) {
+            stmt = _impl->lookupParseCache(query);
+        }
+        if (stmt == nullptr) {
+            // parse using antlr4
+            util::Span span("czar.parse");
+            auto const parseBegin = std::chrono::steady_clock::now();
+            try {
+                stmt = a4NewUserQuery(query);
+            } catch (parser::adapter_order_error& e) {
+                return std::make_shared<UserQueryInvalid>(std::string("ParseException:") + e.what());
+            } catch (parser::adapter_execution_error& e) {
+                return std::make_shared<UserQueryInvalid>(std::string("ParseException:") + e.what());
+            }
+            util::FlightRecorder::record(0, util::FlightRecorder::PARSE,
+                    std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now() - parseBegin).count());
+            _impl->addToParseCache(query, stmt);
         }
 
 // While the antlr4 parser is still under development we will leave in the code that can be used to generate
@@ -214,7 +295,12 @@ UserQueryFactory::newUserQuery(std::string const& aQuery,
                                                         _impl->mysqlResultConfig,
                                                         defaultDb);
         try {
+            util::Span span("czar.analyze");
+            auto const analyzeBegin = std::chrono::steady_clock::now();
             qs->analyzeQuery(query, stmt);
+            util::FlightRecorder::record(0, util::FlightRecorder::ANALYZE,
+                    std::chrono::duration_cast<std::chrono::milliseconds>(
+                        std::chrono::steady_clock::now() - analyzeBegin).count());
         } catch (...) {
             errorExtra = "Unknown failure occurred setting up QuerySession (query is invalid).";
             LOGS(_log, LOG_LVL_ERROR, errorExtra);
@@ -236,12 +322,20 @@ UserQueryFactory::newUserQuery(std::string const& aQuery,
         auto uq = std::make_shared<UserQuerySelect>(qs, messageStore, executive, infileMergerConfig,
                                                     _impl->secondaryIndex, _impl->queryMetadata,
                                                     _impl->qMetaCzarId, qdispPool,
-                                                    errorExtra, async);
+                                                    errorExtra, async, _impl->scanCohorts, user,
+                                                    _impl->resultPagers);
         if (sessionValid) {
             uq->qMetaRegister(resultLocation, msgTableName);
             uq->setupChunking();
         }
         return uq;
+    } else if (UserQueryType::isSelectResultPage(query, userJobId)) {
+        auto uq = std::make_shared<UserQueryResultPage>(userJobId, _impl->qMetaCzarId,
+                                                        _impl->queryMetadata,
+                                                        _impl->resultDbConn.get(),
+                                                        _impl->resultPagers, userQueryId);
+        LOGS(_log, LOG_LVL_DEBUG, "make UserQueryResultPage: userJobId=" << userJobId);
+        return uq;
     } else if (UserQueryType::isSelectResult(query, userJobId)) {
         auto uq = std::make_shared<UserQueryAsyncResult>(userJobId, _impl->qMetaCzarId,
                                                          _impl->queryMetadata,
@@ -265,6 +359,13 @@ UserQueryFactory::newUserQuery(std::string const& aQuery,
                                                   _impl->queryMetadata, _impl->qMetaCzarId);
         LOGS(_log, LOG_LVL_DEBUG, "make UserQueryDrop: db=" << dbName);
         return uq;
+    } else if (UserQueryType::isFlushChunksCacheDelta(query, dbName, addedEmpty, removedEmpty)) {
+        auto uq = std::make_shared<UserQueryFlushChunksCache>(_impl->css, dbName,
+                                                              addedEmpty, removedEmpty,
+                                                              _impl->resultDbConn.get());
+        LOGS(_log, LOG_LVL_DEBUG, "make UserQueryFlushChunksCache (delta): " << dbName
+             << " +" << addedEmpty.size() << " -" << removedEmpty.size());
+        return uq;
     } else if (UserQueryType::isFlushChunksCache(query, dbName)) {
         auto uq = std::make_shared<UserQueryFlushChunksCache>(_impl->css, dbName,
                                                               _impl->resultDbConn.get());
@@ -285,20 +386,84 @@ UserQueryFactory::newUserQuery(std::string const& aQuery,
     }
 }
 
-UserQueryFactory::Impl::Impl(czar::CzarConfig const& czarConfig)
+std::shared_ptr<query::SelectStmt>
+UserQueryFactory::Impl::lookupParseCache(std::string const& query) {
+    std::lock_guard<std::mutex> lock(_parseCacheMutex);
+    auto iter = _parseCache.find(query);
+    if (iter == _parseCache.end()) { return nullptr; }
+    return iter->second->clone();
+}
+
+
+void
+UserQueryFactory::Impl::addToParseCache(std::string const& query,
+                                        std::shared_ptr<query::SelectStmt> const& stmt) {
+    std::lock_guard<std::mutex> lock(_parseCacheMutex);
+    if (_parseCache.size() >= MAX_PARSE_CACHE_SIZE) {
+        LOGS(_log, LOG_LVL_DEBUG, "parse cache full, flushing "
+             << _parseCache.size() << " entries");
+        _parseCache.clear();
+    }
+    _parseCache[query] = stmt->clone();
+}
+
+
+UserQueryFactory::Impl::Impl(czar::CzarConfig const& czarConfig, std::string const& czarName)
     : mysqlResultConfig(czarConfig.getMySqlResultConfig()) {
 
     executiveConfig = std::make_shared<qdisp::Executive::Config>(czarConfig.getXrootdFrontendUrl());
-    secondaryIndex = std::make_shared<qproc::SecondaryIndex>(mysqlResultConfig);
 
-    // make one dedicated connection for results database
-    resultDbConn.reset(new sql::SqlConnection(mysqlResultConfig));
+    scanCohorts = std::make_shared<ScanCohortManager>();
+    resultPagers = std::make_shared<ResultPageRegistry>();
 
-    queryMetadata = std::make_shared<qmeta::QMetaMysql>(czarConfig.getMySqlQmetaConfig());
-    qMetaSelect = std::make_shared<qmeta::QMetaSelect>(czarConfig.getMySqlQmetaConfig());
+    // make one dedicated connection for results database; it connects
+    // lazily, on first use
+    resultDbConn.reset(new sql::SqlConnection(mysqlResultConfig));
 
-    // create CssAccess instance
-    css = css::CssAccess::createFromConfig(czarConfig.getCssConfigMap(), czarConfig.getEmptyChunkPath());
+    // The subsystems below each pay their own network round-trips (or, for
+    // the parser warm-up, a CPU burn) to come up and do not depend on each
+    // other, so they are brought up concurrently: czar restart then costs
+    // the slowest subsystem instead of the sum of all of them. Steps with a
+    // dependency (czar registration needs qmeta) are ordered inside one
+    // future.
+    auto cssFuture = std::async(std::launch::async, [this, &czarConfig]() {
+        css = css::CssAccess::createFromConfig(czarConfig.getCssConfigMap(),
+                                               czarConfig.getEmptyChunkPath());
+    });
+    auto qmetaFuture = std::async(std::launch::async, [this, &czarConfig, czarName]() {
+        // status updates go through a write-behind queue so that qmeta
+        // bookkeeping does not delay query dispatch
+        queryMetadata = std::make_shared<qmeta::QMetaWriteBehind>(
+            std::make_shared<qmeta::QMetaMysql>(czarConfig.getMySqlQmetaConfig()));
+        qMetaSelect = std::make_shared<qmeta::QMetaSelect>(czarConfig.getMySqlQmetaConfig());
+
+        // register czar in QMeta
+        // TODO: check that czar with the same name is not active already?
+        qMetaCzarId = queryMetadata->registerCzar(czarName);
+
+        // When czar crashes/exits while some queries are still in flight they
+        // are left in EXECUTING state in QMeta. We want to cleanup that state
+        // to avoid confusion. Note that when/if clean czar restart is implemented
+        // we'll need a new logic to restart query processing.
+        queryMetadata->cleanup(qMetaCzarId);
+    });
+    auto secondaryIndexFuture = std::async(std::launch::async, [this, &czarConfig]() {
+        secondaryIndex = std::make_shared<qproc::SecondaryIndex>(mysqlResultConfig,
+                                                                 czarConfig.getSecondaryIndexDir());
+    });
+    auto warmupFuture = std::async(std::launch::async, [&czarConfig]() {
+        // Warm up the antlr4 prediction caches before the first user query
+        // arrives; without this the first parses after a restart are several
+        // times slower than steady state.
+        a4WarmupParser(czarConfig.getParserWarmupPath());
+    });
+
+    // get() rather than wait() so a failed bring-up surfaces as the same
+    // exception a sequential bring-up would have thrown.
+    cssFuture.get();
+    qmetaFuture.get();
+    secondaryIndexFuture.get();
+    warmupFuture.get();
 }
 
 }}} // lsst::qserv::ccontrol
@@ -69,15 +69,24 @@ public:
     /// @param qdispPool:    Thread pool handling qdisp jobs.
     /// @param userQueryId:  Unique string identifying query
     /// @param msgTableName: Name of the message table without database name.
+    /// @param user:         Client name from proxy, may be empty. Recorded in
+    ///                      qmeta and sent to workers for fair scheduling.
     /// @return new UserQuery object
     UserQuery::Ptr newUserQuery(std::string const& query,
                                 std::string const& defaultDb,
                                 qdisp::QdispPool::Ptr const& qdispPool,
                                 std::string const& userQueryId,
-                                std::string const& msgTableName);
+                                std::string const& msgTableName,
+                                std::string const& user=std::string());
 
     static std::shared_ptr<query::SelectStmt> antlr2NewSelectStmt(const std::string& query);
 
+    /// Pre-touch the metadata a first query against 'dbName' would fault
+    /// in serially: the database's CSS subtree, the empty-chunk bitmap
+    /// and the memory-mapped secondary index files of its director
+    /// tables. Best effort and never throws; an unknown database is
+    /// ignored. Called from the czar when a client session connects.
+    void warmUpDatabase(std::string const& dbName);
 
 private:
     class Impl;
@@ -47,7 +47,19 @@ namespace ccontrol {
 UserQueryFlushChunksCache::UserQueryFlushChunksCache(std::shared_ptr<css::CssAccess> const& css,
                                                      std::string const& dbName,
                                                      sql::SqlConnection* resultDbConn)
-    : _css(css), _dbName(dbName), _resultDbConn(resultDbConn),
+    : _css(css), _dbName(dbName), _delta(false), _addedEmpty(), _removedEmpty(),
+      _resultDbConn(resultDbConn),
+      _qState(UNKNOWN), _messageStore(std::make_shared<qdisp::MessageStore>()) {
+}
+
+// Constructor for the incremental variant
+UserQueryFlushChunksCache::UserQueryFlushChunksCache(std::shared_ptr<css::CssAccess> const& css,
+                                                     std::string const& dbName,
+                                                     IntVector const& addedEmpty,
+                                                     IntVector const& removedEmpty,
+                                                     sql::SqlConnection* resultDbConn)
+    : _css(css), _dbName(dbName), _delta(true), _addedEmpty(addedEmpty),
+      _removedEmpty(removedEmpty), _resultDbConn(resultDbConn),
       _qState(UNKNOWN), _messageStore(std::make_shared<qdisp::MessageStore>()) {
 }
 
@@ -62,10 +74,19 @@ void UserQueryFlushChunksCache::kill() {
 // Submit or execute the query.
 void UserQueryFlushChunksCache::submit() {
 
-    LOGS(_log, LOG_LVL_INFO, "Flushing empty chunks for db: " << _dbName);
+    if (_delta) {
+        LOGS(_log, LOG_LVL_INFO, "Updating empty chunks for db: " << _dbName
+             << " +" << _addedEmpty.size() << " -" << _removedEmpty.size());
+
+        // patch the cached bitmap in place, this does not throw and never
+        // forces a re-read of the empty chunks state
+        _css->getEmptyChunks().updateCache(_dbName, _addedEmpty, _removedEmpty);
+    } else {
+        LOGS(_log, LOG_LVL_INFO, "Flushing empty chunks for db: " << _dbName);
 
-    // reset empty chunk cache , this does not throw
-    _css->getEmptyChunks().clearCache(_dbName);
+        // reset empty chunk cache , this does not throw
+        _css->getEmptyChunks().clearCache(_dbName);
+    }
 
     _qState = SUCCESS;
 }
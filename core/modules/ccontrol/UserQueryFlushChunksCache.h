@@ -29,6 +29,7 @@
 
 // Qserv headers
 #include "ccontrol/UserQuery.h"
+#include "global/intTypes.h"
 
 // Forward decl
 namespace lsst {
@@ -64,6 +65,22 @@ public:
                               std::string const& dbName,
                               sql::SqlConnection* resultDbConn);
 
+    /**
+     *  Constructor for the incremental variant which applies a delta to
+     *  the cached empty chunks bitmap instead of dropping it.
+     *
+     *  @param css:           CSS interface
+     *  @param dbName:        Name of the database where table is
+     *  @param addedEmpty:    Chunks which became empty
+     *  @param removedEmpty:  Chunks which are no longer empty
+     *  @param resultDbConn:  Connection to results database
+     */
+    UserQueryFlushChunksCache(std::shared_ptr<css::CssAccess> const& css,
+                              std::string const& dbName,
+                              IntVector const& addedEmpty,
+                              IntVector const& removedEmpty,
+                              sql::SqlConnection* resultDbConn);
+
     UserQueryFlushChunksCache(UserQueryFlushChunksCache const&) = delete;
     UserQueryFlushChunksCache& operator=(UserQueryFlushChunksCache const&) = delete;
 
@@ -96,6 +113,9 @@ private:
 
     std::shared_ptr<css::CssAccess> const _css;
     std::string const _dbName;
+    bool const _delta;                  ///< apply the lists below instead of a full flush
+    IntVector const _addedEmpty;        ///< chunks which became empty
+    IntVector const _removedEmpty;      ///< chunks which are no longer empty
     sql::SqlConnection* _resultDbConn;
     QueryState _qState;
     std::shared_ptr<qdisp::MessageStore> _messageStore;
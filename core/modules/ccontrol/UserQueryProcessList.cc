@@ -114,6 +114,7 @@ UserQueryProcessList::UserQueryProcessList(bool full,
     // use ShowProcessList view
     _query = "SELECT Id, User, Host, db, Command, Time, State, ";
     _query += full ? "Info, " : "SUBSTRING(Info FROM 1 FOR 100) Info, ";
+    _query += "Progress, EstTimeLeftSec, ";
     // These are non-standard but they need to be there because they appear in WHERE
     _query += "CzarId, Submitted, Completed, ResultLocation";
     _query += " FROM ShowProcessList";
@@ -136,10 +137,13 @@ void UserQueryProcessList::kill() {
 // Submit or execute the query.
 void UserQueryProcessList::submit() {
 
-    // query database
+    // query database; the filtering and projection (WHERE, the column
+    // list and LIMIT) are part of the query text and are evaluated by
+    // the qmeta server, and the surviving rows are streamed into the
+    // result table below without being materialized client-side first
     std::unique_ptr<sql::SqlResults> results;
     try {
-        results = _qMetaSelect->select(_query);
+        results = _qMetaSelect->selectStreaming(_query);
     } catch (std::exception const& exc) {
         LOGS(_log, LOG_LVL_ERROR, "error in querying QMeta: " << exc.what());
         std::string message = "Internal failure, error in querying QMeta: ";
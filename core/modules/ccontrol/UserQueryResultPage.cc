@@ -0,0 +1,185 @@
+/*
+ * LSST Data Management System
+ * Copyright 2018 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "ccontrol/UserQueryResultPage.h"
+
+// System headers
+
+// Third-party headers
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+// Qserv headers
+#include "qmeta/Exceptions.h"
+#include "qmeta/QMeta.h"
+#include "qdisp/MessageStore.h"
+#include "rproc/InfileMerger.h"
+#include "sql/SqlConnection.h"
+
+namespace {
+LOG_LOGGER _log = LOG_GET("lsst.qserv.ccontrol.UserQueryResultPage");
+}
+
+namespace lsst {
+namespace qserv {
+namespace ccontrol {
+
+// Constructor
+UserQueryResultPage::UserQueryResultPage(QueryId queryId,
+                                         qmeta::CzarId qMetaCzarId,
+                                         std::shared_ptr<qmeta::QMeta> const& qMeta,
+                                         sql::SqlConnection* resultDbConn,
+                                         ResultPageRegistry::Ptr const& resultPagers,
+                                         std::string const& userQueryId)
+    : UserQuery(),
+      _queryId(queryId),
+      _qMetaCzarId(qMetaCzarId),
+      _qMeta(qMeta),
+      _resultDbConn(resultDbConn),
+      _resultPagers(resultPagers),
+      _messageStore(std::make_shared<qdisp::MessageStore>()),
+      _resultTableName("qserv_result_page_" + userQueryId) {
+
+    LOGS(_log, LOG_LVL_DEBUG, "UserQueryResultPage: QID=" << queryId);
+
+    // get query info from QMeta
+    try {
+        _qInfo = qMeta->getQueryInfo(queryId);
+        LOGS(_log, LOG_LVL_DEBUG, "found QMeta record: czar=" << _qInfo.czarId()
+             << " status=" << _qInfo.queryStatus() << " resultLoc=" << _qInfo.resultLocation());
+    } catch (qmeta::QueryIdError const& exc) {
+        std::string message = "No job found for ID=" + std::to_string(queryId);
+        LOGS(_log, LOG_LVL_DEBUG, message);
+        _messageStore->addErrorMessage(message);
+    } catch (std::exception const& exc) {
+        LOGS(_log, LOG_LVL_ERROR, "error in querying QMeta: " << exc.what());
+        std::string message = "Internal failure, error in querying QMeta: ";
+        message += exc.what();
+        _messageStore->addErrorMessage(message);
+    }
+}
+
+
+std::string UserQueryResultPage::getError() const {
+    return std::string();
+}
+
+void UserQueryResultPage::submit() {
+
+    _qState = ERROR;
+
+    // if there are messages already it means the error was detected, stop right here
+    if (_messageStore->messageCount() > 0) {
+        return;
+    }
+
+    // The live merger only exists on the czar executing the query
+    if (_qInfo.czarId() != _qMetaCzarId) {
+        std::string message = "Query originated from different czar";
+        _messageStore->addErrorMessage(message);
+        return;
+    }
+
+    if (_qInfo.queryStatus() == qmeta::QInfo::COMPLETED) {
+        // The remaining (unconsumed) rows are in the regular result table.
+        std::string message = "Query has completed, retrieve the remaining rows with "
+                "SELECT * FROM QSERV_RESULT(" + std::to_string(_queryId) + ")";
+        LOGS(_log, LOG_LVL_DEBUG, message);
+        _messageStore->addErrorMessage(message);
+        return;
+    }
+    if (_qInfo.queryStatus() != qmeta::QInfo::EXECUTING) {
+        std::string message = "Query is not executing (FAILED or ABORTED)";
+        LOGS(_log, LOG_LVL_DEBUG, message);
+        _messageStore->addErrorMessage(message);
+        return;
+    }
+
+    // Pages carry no ordering guarantee
+    if (!_qInfo.proxyOrderBy().empty()) {
+        std::string message = "Query results cannot be paged (query has ORDER BY)";
+        LOGS(_log, LOG_LVL_DEBUG, message);
+        _messageStore->addErrorMessage(message);
+        return;
+    }
+
+    auto merger = _resultPagers->find(_queryId);
+    if (merger == nullptr) {
+        // Not registered: the query needs a merge/aggregation step, is too
+        // small to page, or completed since the status was read.
+        std::string message = "Query results cannot be paged (not a pageable query,"
+                " or it has just completed)";
+        LOGS(_log, LOG_LVL_DEBUG, message);
+        _messageStore->addErrorMessage(message);
+        return;
+    }
+
+    int const exported = merger->exportPage(_resultTableName);
+    if (exported >= 0) {
+        LOGS(_log, LOG_LVL_DEBUG, "exported page of " << exported
+             << " attempts for QID=" << _queryId << " into " << _resultTableName);
+        // the page table is dropped by the proxy after the rows are returned
+        _qState = SUCCESS;
+        return;
+    }
+    std::string message;
+    switch (exported) {
+        case -2:
+            message = "No results have been merged yet, retry later";
+            break;
+        case -3:
+            message = "Internal failure, error exporting result page";
+            break;
+        default:
+            message = "Query results cannot be paged (or the query has just completed)";
+            break;
+    }
+    LOGS(_log, LOG_LVL_DEBUG, "exportPage QID=" << _queryId
+         << " status=" << exported << ": " << message);
+    _messageStore->addErrorMessage(message);
+}
+
+QueryState UserQueryResultPage::join() {
+    return _qState;
+}
+
+void UserQueryResultPage::kill() {
+}
+
+void UserQueryResultPage::discard() {
+}
+
+std::shared_ptr<qdisp::MessageStore> UserQueryResultPage::getMessageStore() {
+    return _messageStore;
+}
+
+std::string UserQueryResultPage::getResultTableName() const {
+    return _resultTableName;
+}
+
+std::string UserQueryResultPage::getResultLocation() const {
+    return "table:" + _resultTableName;
+}
+
+}}} // namespace lsst::qserv::ccontrol
@@ -0,0 +1,138 @@
+/*
+ * LSST Data Management System
+ * Copyright 2018 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_CCONTROL_USERQUERYRESULTPAGE_H
+#define LSST_QSERV_CCONTROL_USERQUERYRESULTPAGE_H
+
+// System headers
+#include <string>
+
+// Third-party headers
+
+// Qserv headers
+#include "ccontrol/ResultPageRegistry.h"
+#include "ccontrol/UserQuery.h"
+#include "qmeta/QInfo.h"
+#include "qmeta/types.h"
+
+namespace lsst {
+namespace qserv {
+namespace qdisp {
+class MessageStore;
+}
+namespace qmeta {
+class QMeta;
+}
+namespace sql {
+class SqlConnection;
+}}}
+
+
+namespace lsst {
+namespace qserv {
+namespace ccontrol {
+
+/// @addtogroup ccontrol
+
+/**
+ *  @ingroup ccontrol
+ *
+ *  @brief UserQuery implementation for paged result retrieval of
+ *  executing async queries.
+ *
+ *  "SELECT * FROM QSERV_RESULT_PAGE(QID)" returns the rows of the chunks
+ *  that have completed since the previous page and removes them from the
+ *  query's merge table, so a client can start consuming a huge result
+ *  while the query is still running instead of waiting for the last
+ *  chunk. An empty result set means no new chunks have completed yet,
+ *  keep polling; once the query completes the statement returns an error
+ *  directing the client to QSERV_RESULT(QID), which then delivers the
+ *  rows not consumed by any page. Pages carry no ordering guarantee, so
+ *  queries with ORDER BY (or with a merge/aggregation step) are not
+ *  pageable and are reported as such.
+ */
+
+class UserQueryResultPage : public UserQuery {
+public:
+
+    /**
+     *  Constructor for "SELECT * FROM QSERV_RESULT_PAGE(QID)".
+     *
+     *  @param queryId:       Query ID for which to return a result page
+     *  @param qMetaCzarId:   ID for current czar
+     *  @param qMeta:         QMeta instance
+     *  @param resultDbConn:  Connection to results database
+     *  @param resultPagers:  Registry of executing pageable queries
+     *  @param userQueryId:   Unique string identifying this client query,
+     *                        used to name the page table
+     */
+    UserQueryResultPage(QueryId queryId,
+                        qmeta::CzarId qMetaCzarId,
+                        std::shared_ptr<qmeta::QMeta> const& qMeta,
+                        sql::SqlConnection* resultDbConn,
+                        ResultPageRegistry::Ptr const& resultPagers,
+                        std::string const& userQueryId);
+
+    UserQueryResultPage(UserQueryResultPage const&) = delete;
+    UserQueryResultPage& operator=(UserQueryResultPage const&) = delete;
+
+    /// @return a non-empty string describing the current error state
+    /// Returns an empty string if no errors have been detected.
+    std::string getError() const override;
+
+    /// Begin execution of the query over all ChunkSpecs added so far.
+    void submit() override;
+
+    /// Wait until the query has completed execution.
+    /// @return the final execution state.
+    QueryState join() override;
+
+    /// Stop a query in progress (for immediate shutdowns)
+    void kill() override;
+
+    /// Release resources related to user query
+    void discard() override;
+
+    // Delegate objects
+    std::shared_ptr<qdisp::MessageStore> getMessageStore() override;
+
+    /// @return Name of the page table for this query, can be empty
+    std::string getResultTableName() const override;
+
+    /// @return Result location for this query, can be empty
+    std::string getResultLocation() const override;
+
+private:
+
+    QueryId _queryId;
+    qmeta::CzarId _qMetaCzarId;
+    std::shared_ptr<qmeta::QMeta> _qMeta;
+    sql::SqlConnection* _resultDbConn;
+    ResultPageRegistry::Ptr _resultPagers;
+    qmeta::QInfo _qInfo;
+    std::shared_ptr<qdisp::MessageStore> _messageStore;
+    std::string _resultTableName;
+    QueryState _qState = UNKNOWN;
+};
+
+}}} // namespace lsst::qserv::ccontrol
+
+#endif // LSST_QSERV_CCONTROL_USERQUERYRESULTPAGE_H
@@ -64,8 +64,10 @@
 #include "ccontrol/UserQuerySelect.h"
 
 // System headers
+#include <algorithm>
 #include <cassert>
 #include <chrono>
+#include <future>
 #include <memory>
 
 // Third-party headers
@@ -94,8 +96,11 @@
 #include "query/JoinRef.h"
 #include "query/SelectStmt.h"
 #include "rproc/InfileMerger.h"
+#include "util/Disposer.h"
+#include "util/FlightRecorder.h"
 #include "util/IterableFormatter.h"
 #include "util/ThreadPriority.h"
+#include "util/Trace.h"
 
 namespace {
 
@@ -158,11 +163,15 @@ UserQuerySelect::UserQuerySelect(std::shared_ptr<qproc::QuerySession> const& qs,
                                  qmeta::CzarId czarId,
                                  std::shared_ptr<qdisp::QdispPool> const& qdispPool,
                                  std::string const& errorExtra,
-                                 bool async)
+                                 bool async,
+                                 std::shared_ptr<ScanCohortManager> const& scanCohorts,
+                                 std::string const& user,
+                                 ResultPageRegistry::Ptr const& resultPagers)
     :  _qSession(qs), _messageStore(messageStore), _executive(executive),
        _infileMergerConfig(infileMergerConfig), _secondaryIndex(secondaryIndex),
        _queryMetadata(queryMetadata), _qMetaCzarId(czarId), _qdispPool(qdispPool),
-       _errorExtra(errorExtra), _async(async) {
+       _errorExtra(errorExtra), _async(async), _scanCohorts(scanCohorts), _user(user),
+       _resultPagers(resultPagers) {
 }
 
 std::string UserQuerySelect::getError() const {
@@ -201,17 +210,79 @@ UserQuerySelect::getProxyOrderBy() const {
 
 /// Begin running on all chunks added so far.
 void UserQuerySelect::submit() {
-    _qSession->finalize();
-
-    // has to be done after result table name
+    util::Span span("czar.dispatch", _qMetaQueryId);
+    auto const submitBegin = std::chrono::steady_clock::now();
+    // has to be done after result table name. Runs before finalize() so that
+    // result table creation overlaps a deferred chunk coverage lookup; the
+    // merge statement it needs is fixed once analysis has run.
     _setupMerger();
 
+    try {
+        _qSession->finalize();
+    } catch (std::exception const& e) {
+        // A deferred chunk coverage lookup failed (e.g. secondary index
+        // error). Dispatch nothing and report through the message table;
+        // throwing here would escape the detached finalizer thread.
+        LOGS(_log, LOG_LVL_ERROR, getQueryIdString()
+             << " chunk coverage resolution failed: " << e.what());
+        _messageStore->addMessage(-1, 1105,
+                std::string("Failed to resolve chunk coverage: ") + e.what(),
+                MessageSeverity::MSG_ERROR);
+        _submitError = true;
+        return;
+    }
+
     // Using the QuerySession, generate query specs (text, db, chunkId) and then
     // create query messages and send them to the async query manager.
     LOGS(_log, LOG_LVL_DEBUG, getQueryIdString() << " UserQuerySelect beginning submission");
     assert(_infileMerger);
 
-    auto taskMsgFactory = std::make_shared<qproc::TaskMsgFactory>(_qMetaQueryId);
+    // Single-chunk passthrough: when the chunk list collapses to one job
+    // (the common case for objectId point lookups) and no merge statement
+    // is needed, rows are loaded straight into the result table without
+    // the jobId bookkeeping column, which also skips the column-dropping
+    // table rebuild at finalize time.
+    if (_qSession->getMergeStmt() == nullptr
+        and _qSession->cQueryEnd() - _qSession->cQueryBegin() == 1) {
+        LOGS(_log, LOG_LVL_DEBUG, getQueryIdString() << " single-job passthrough enabled");
+        _infileMerger->setSingleJobPassthrough();
+    }
+
+    // For a plain LIMIT query any rows are an acceptable answer, so squash
+    // the remaining jobs as soon as enough rows have been merged.
+    int rowBudget = _qSession->getRowBudget();
+    if (rowBudget > 0) {
+        std::weak_ptr<qdisp::Executive> weakExec = _executive;
+        _infileMerger->setRowLimit(rowBudget, [weakExec]() {
+            auto exec = weakExec.lock();
+            if (exec != nullptr) {
+                exec->squashEnoughRows();
+            }
+        });
+    }
+
+    // Make the merger reachable by QSERV_RESULT_PAGE while the query runs,
+    // so a client can consume completed chunks' rows in pages instead of
+    // waiting for the last chunk. Only async queries merged through the
+    // merge table qualify: a merge statement folds rows together and pages
+    // of an ORDER BY result would break the ordering; the single-job
+    // passthrough case has nothing worth paging.
+    if (_async && _resultPagers != nullptr
+        and _qSession->getMergeStmt() == nullptr
+        and getProxyOrderBy().empty()
+        and _qSession->cQueryEnd() - _qSession->cQueryBegin() > 1) {
+        _resultPagers->add(_qMetaQueryId, _infileMerger);
+    }
+
+    // Surface progress through qmeta while join() drains the query, so the
+    // processlist views can tell a healthy long scan from a hung one. The
+    // reporter only fires inside this object's join(), so capturing 'this'
+    // is safe.
+    _executive->setProgressReporter([this](qdisp::Executive::Progress const& progress) {
+        _qMetaUpdateProgress(progress.totalJobs, progress.completedJobs, progress.inFlightJobs);
+    });
+
+    auto taskMsgFactory = std::make_shared<qproc::TaskMsgFactory>(_qMetaQueryId, _user);
     TmpTableName ttn(_qMetaQueryId, _qSession->getOriginal());
     std::vector<int> chunks;
     std::mutex chunksMtx;
@@ -232,44 +303,108 @@ void UserQuerySelect::submit() {
         threadPriority.setPriorityPolicy(10);
     }
 
-    for(auto i = _qSession->cQueryBegin(), e = _qSession->cQueryEnd();
-            i != e && !_executive->getCancelled(); ++i) {
-        auto& chunkSpec = *i;
+    // Number of chunks handled by one job-building command. Building and
+    // registering jobs in batches amortizes pool queueing and executive
+    // bookkeeping over jobBatchSize chunks, which matters for queries
+    // that fan out to ~100k chunks.
+    int const jobBatchSize = 32;
 
-        std::function<void(util::CmdData*)> funcBuildJob =
-                [this, sequence,     // sequence must be a copy
-                 &chunkSpec, &queryTemplates,
+    std::vector<qproc::ChunkSpec> batch;
+    batch.reserve(jobBatchSize);
+
+    auto queueBatch = [this, &batch, jobBatchSize, &sequence, &queryTemplates, &chunks, &chunksMtx,
+                       &ttn, &taskMsgFactory, &addTimeSum]() {
+        if (batch.empty()) return;
+
+        // Move the batch behind a shared_ptr so queueing the command does
+        // not copy the spec vector (std::function requires copyability).
+        auto batchPtr = std::make_shared<std::vector<qproc::ChunkSpec>>(std::move(batch));
+        batch.clear();
+        batch.reserve(jobBatchSize);
+
+        std::function<void(util::CmdData*)> funcBuildJobs =
+                [this, sequence, batchPtr,  // sequence must be a copy
+                 &queryTemplates,
                  &chunks, &chunksMtx, &ttn,
                  &taskMsgFactory, &addTimeSum](util::CmdData*) {
 
             auto startbuildQSJ = std::chrono::system_clock::now(); // TEMPORARY-timing
-            qproc::ChunkQuerySpec::Ptr cs;
-            {
-                std::lock_guard<std::mutex> lock(chunksMtx);
-                cs = _qSession->buildChunkQuerySpec(queryTemplates, chunkSpec);
-                chunks.push_back(cs->chunkId);
+            std::vector<qdisp::JobDescription::Ptr> jobDescs;
+            jobDescs.reserve(batchPtr->size());
+            int jobId = sequence;
+            for (auto const& chunkSpec : *batchPtr) {
+                // buildChunkQuerySpec only reads session state that is
+                // immutable after finalize(), so batches run it concurrently;
+                // chunksMtx guards just the shared chunk list.
+                qproc::ChunkQuerySpec::Ptr cs =
+                        _qSession->buildChunkQuerySpec(queryTemplates, chunkSpec);
+                {
+                    std::lock_guard<std::mutex> lock(chunksMtx);
+                    chunks.push_back(cs->chunkId);
+                }
+                std::string chunkResultName = ttn.make(cs->chunkId);
+
+                std::shared_ptr<ChunkMsgReceiver> cmr =
+                        ChunkMsgReceiver::newInstance(cs->chunkId, _messageStore);
+                ResourceUnit ru;
+                ru.setAsDbChunk(cs->db, cs->chunkId);
+                jobDescs.push_back(qdisp::JobDescription::create(
+                        _executive->getId(), jobId, ru,
+                        std::make_shared<MergingHandler>(cmr, _infileMerger, chunkResultName),
+                        taskMsgFactory, cs, chunkResultName));
+                ++jobId;
             }
-            std::string chunkResultName = ttn.make(cs->chunkId);
-
-            std::shared_ptr<ChunkMsgReceiver> cmr = ChunkMsgReceiver::newInstance(cs->chunkId, _messageStore);
-            ResourceUnit ru;
-            ru.setAsDbChunk(cs->db, cs->chunkId);
-            qdisp::JobDescription::Ptr jobDesc = qdisp::JobDescription::create(
-                    _executive->getId(), sequence, ru,
-                    std::make_shared<MergingHandler>(cmr, _infileMerger, chunkResultName),
-                    taskMsgFactory, cs, chunkResultName);
-            _executive->add(jobDesc);
+            _executive->addJobs(jobDescs);
             auto endChunkAddQSJ = std::chrono::system_clock::now(); // TEMPORARY-timing
             { // TEMPORARY-timing
                 addTimeSum += timeDiff(startbuildQSJ, endChunkAddQSJ);
             }
         };
 
-        auto cmd = std::make_shared<qdisp::PriorityCommand>(funcBuildJob);
+        auto cmd = std::make_shared<qdisp::PriorityCommand>(funcBuildJobs);
         _executive->queueJobStart(cmd, _qSession->getScanInteractive());
-        ++sequence;
+        sequence += batchPtr->size();
+    };
+
+    // Copy the chunk coverage so the dispatch order can be rearranged
+    // without touching the session. For a shared scan, join the cohort
+    // circulating over the same table family and start dispatching just
+    // past its current chunk, wrapping around: concurrent scans then pass
+    // each chunk together, and the workers' same-chunk Task alignment
+    // (ChunkTasksQueue) turns N queries into one circulating scan.
+    qproc::ChunkSpecVector chunkSpecs(_qSession->cQueryBegin(), _qSession->cQueryEnd());
+    if (not _qSession->getScanInteractive() and _scanCohorts != nullptr) {
+        std::string const family = ScanCohortManager::makeFamily(_qSession->getScanInfo());
+        if (not family.empty()) {
+            _cohortMember = _scanCohorts->join(family);
+            int const position = _cohortMember->getPosition();
+            if (position >= 0) {
+                auto pivot = std::find_if(chunkSpecs.begin(), chunkSpecs.end(),
+                        [position](qproc::ChunkSpec const& cs) { return cs.chunkId > position; });
+                if (pivot != chunkSpecs.begin() and pivot != chunkSpecs.end()) {
+                    std::rotate(chunkSpecs.begin(), pivot, chunkSpecs.end());
+                    LOGS(_log, LOG_LVL_INFO, getQueryIdString()
+                         << " joining shared scan of " << family
+                         << " at chunk " << chunkSpecs.front().chunkId);
+                }
+            }
+            // keep the cohort position current as this query's chunks complete
+            auto member = _cohortMember;
+            _executive->setChunkCompletionNotifier([member](int chunkId) {
+                member->advance(chunkId);
+            });
+        }
     }
 
+    for(auto i = chunkSpecs.begin(), e = chunkSpecs.end();
+            i != e && !_executive->getCancelled(); ++i) {
+        batch.push_back(*i);
+        if (static_cast<int>(batch.size()) >= jobBatchSize) {
+            queueBatch();
+        }
+    }
+    queueBatch(); // queue any final partial batch.
+
     // attempt to restore original thread priority, requires root
     if (increaseThreadPriority) {
         threadPriority.restoreOriginalValues();
@@ -290,6 +425,11 @@ void UserQuerySelect::submit() {
              << "\nQSJ     endQSEASum        =" << _executive->endQSEASum );
     }
 
+    util::FlightRecorder::record(_qMetaQueryId, util::FlightRecorder::DISPATCH,
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - submitBegin).count(),
+            sequence);
+
     // we only care about per-chunk info for ASYNC queries
     if (_async) {
         std::lock_guard<std::mutex> lock(chunksMtx);
@@ -302,6 +442,17 @@ void UserQuerySelect::submit() {
 /// @return the QueryState indicating success or failure
 QueryState UserQuerySelect::join() {
     bool successful = _executive->join(); // Wait for all data
+    _cohortMember.reset(); // this query's part of the shared scan is over
+    if (_resultPagers != nullptr) {
+        // no more pages; finalize() below redirects a page request racing
+        // with the removal to the regular result path
+        _resultPagers->remove(_qMetaQueryId);
+    }
+    if (_submitError) {
+        // submit() bailed out before dispatching; an empty executive joins
+        // successfully, so force the failure path.
+        successful = false;
+    }
     // Since all data are in, run final SQL commands like GROUP BY.
     if (!_infileMerger->finalize()) {
         successful = false;
@@ -310,6 +461,10 @@ QueryState UserQuerySelect::join() {
         _messageStore->addMessage(-1, 1105, "Failure while merging result",
                 MessageSeverity::MSG_ERROR);
     }
+    // Capture the merge time and row count before the merger is discarded.
+    uint64_t const mergeMs = (_infileMerger != nullptr) ? _infileMerger->getTotalMergeMs() : 0;
+    uint64_t const resultRows = (_infileMerger != nullptr)
+            ? static_cast<uint64_t>(_infileMerger->getTotalResultRows()) : 0;
     try {
         _discardMerger();
     } catch (std::exception const& exc) {
@@ -317,8 +472,11 @@ QueryState UserQuerySelect::join() {
         // it or expose it to user, just dump it to log
         LOGS(_log, LOG_LVL_ERROR, getQueryIdString() << " exception from _discardMerger: "<< exc.what());
     }
+    util::FlightRecorder::record(_qMetaQueryId, util::FlightRecorder::QUERY_END,
+            successful ? 1 : 0, mergeMs);
     if (successful) {
         _qMetaUpdateStatus(qmeta::QInfo::COMPLETED);
+        _qMetaSaveStats(mergeMs, resultRows);
         LOGS(_log, LOG_LVL_DEBUG, getQueryIdString() << " Joined everything (success)");
         return SUCCESS;
     } else if (_killed) {
@@ -349,13 +507,19 @@ void UserQuerySelect::discard() {
             return;
         }
     }
+    if (_resultPagers != nullptr) {
+        _resultPagers->remove(_qMetaQueryId); // harmless if join() already did
+    }
     // Make sure resources are released.
     if (_executive && _executive->getNumInflight() > 0) {
         throw UserQueryError(getQueryIdString() + " Executive unfinished, cannot discard");
     }
     _executive.reset();
     _messageStore.reset();
-    _qSession.reset();
+    // The session owns the analyzed IR trees; tearing those down is a long
+    // destructor cascade, so hand it to the background disposer instead of
+    // running it here.
+    util::Disposer::instance().dispose(_qSession);
     try {
         _discardMerger();
     } catch(UserQueryError const &e) {
@@ -374,46 +538,42 @@ void UserQuerySelect::_setupMerger() {
 }
 
 void UserQuerySelect::setupChunking() {
+    util::Span span("czar.chunks", _qMetaQueryId);
     LOGS(_log, LOG_LVL_TRACE, getQueryIdString() << "Setup chunking");
     // Do not throw exceptions here, set _errorExtra .
-    std::shared_ptr<qproc::IndexMap> im;
     std::string dominantDb = _qSession->getDominantDb();
     if (dominantDb.empty() || !_qSession->validateDominantDb()) {
         // TODO: Revisit this for L3
         throw UserQueryError(getQueryIdString() + " Couldn't determine dominantDb for dispatch");
     }
 
-    std::shared_ptr<IntSet const> eSet = _qSession->getEmptyChunks();
-    {
-        eSet = _qSession->getEmptyChunks();
-        if (!eSet) {
-            eSet = std::make_shared<IntSet>();
-            LOGS(_log, LOG_LVL_WARN, getQueryIdString() << " Missing empty chunks info for " << dominantDb);
-        }
-    }
     // FIXME add operator<< for QuerySession
     LOGS(_log, LOG_LVL_TRACE, getQueryIdString() << " _qSession: " << _qSession);
     if (_qSession->hasChunks()) {
         std::shared_ptr<query::ConstraintVector> constraints = _qSession->getConstraints();
         css::StripingParams partStriping = _qSession->getDbStriping();
 
-        im = std::make_shared<qproc::IndexMap>(partStriping, _secondaryIndex);
-        qproc::ChunkSpecVector csv;
-        if (constraints) {
-            csv = im->getChunks(*constraints);
-        } else { // Unconstrained: full-sky
-            csv = im->getAllChunks();
-        }
-
-        LOGS(_log, LOG_LVL_TRACE, getQueryIdString() << " Chunk specs: " << util::printable(csv));
-        // Filter out empty chunks
-        for(qproc::ChunkSpecVector::const_iterator i=csv.begin(), e=csv.end();
-            i != e;
-            ++i) {
-            if (eSet->count(i->chunkId) == 0) { // chunk not in empty?
-                _qSession->addChunk(*i);
-            }
-        }
+        // Resolve chunk coverage in the background so the secondary index
+        // lookup overlaps the remaining dispatch setup (qmeta bookkeeping,
+        // result table creation). QuerySession joins the future the first
+        // time chunks are needed; exceptions thrown here reappear there.
+        auto queryIdStr = getQueryIdString();
+        auto future = std::async(std::launch::async,
+            [this, queryIdStr, constraints, partStriping]() -> qproc::ChunkSpecVector {
+                auto im = std::make_shared<qproc::IndexMap>(partStriping, _secondaryIndex);
+                qproc::ChunkSpecVector csv;
+                if (constraints) {
+                    csv = im->getChunks(*constraints);
+                } else { // Unconstrained: full-sky
+                    csv = im->getAllChunks();
+                }
+                LOGS(_log, LOG_LVL_TRACE, queryIdStr << " Chunk specs: " << util::printable(csv));
+
+                // Filter out empty chunks
+                _qSession->filterEmptyChunks(csv);
+                return csv;
+            });
+        _qSession->setChunksDeferred(std::move(future));
     } else {
         LOGS(_log, LOG_LVL_TRACE, getQueryIdString() << " No chunks added, QuerySession will add dummy chunk");
     }
@@ -424,7 +584,7 @@ void UserQuerySelect::setupChunking() {
 void UserQuerySelect::qMetaRegister(std::string const& resultLocation, std::string const& msgTableName)
 {
     qmeta::QInfo::QType qType = _async ? qmeta::QInfo::ASYNC : qmeta::QInfo::SYNC;
-    std::string user = "anonymous";    // we do not have access to that info yet
+    std::string user = _user.empty() ? "anonymous" : _user;
 
     std::string qTemplate;
     auto const& stmtVector = _qSession->getStmtParallel();
@@ -471,6 +631,10 @@ void UserQuerySelect::qMetaRegister(std::string const& resultLocation, std::stri
         }
     }
 
+    // keys for the shape-history record saved at completion
+    _qMetaTableSet = qmeta::makeTableSet(tableNames);
+    _qMetaShapeHash = qmeta::makeShapeHash(qTemplate);
+
     // register query, save its ID
     _qMetaQueryId = _queryMetadata->registerQuery(qInfo, tableNames);
     _queryIdStr = QueryIdHelper::makeIdStr(_qMetaQueryId);
@@ -525,6 +689,86 @@ void UserQuerySelect::_qMetaAddChunks(std::vector<int> const& chunks)
     _queryMetadata->addChunks(_qMetaQueryId, chunks);
 }
 
+// update this query's progress record in qmeta
+void UserQuerySelect::_qMetaUpdateProgress(int totalJobs, int completedJobs, int inFlightJobs)
+{
+    qmeta::QProgress progress;
+    progress.queryId = _qMetaQueryId;
+    progress.totalChunks = totalJobs;
+    progress.completedChunks = completedJobs;
+    if (_infileMerger != nullptr) {
+        progress.rowsMerged = static_cast<uint64_t>(_infileMerger->getTotalResultRows());
+        progress.bytesMerged = static_cast<uint64_t>(_infileMerger->getTotalResultBytes());
+    }
+
+    // Estimate the remaining time from a moving average of the completion
+    // rate; a plain completed/elapsed average would keep promising an early
+    // finish long after the fast chunks are done and only the slow tail of
+    // a skewed scan remains.
+    auto const now = std::chrono::steady_clock::now();
+    if (_progressLastTime.time_since_epoch().count() != 0) {
+        double const seconds = std::chrono::duration<double>(now - _progressLastTime).count();
+        int const completedSinceLast = completedJobs - _progressLastCompleted;
+        if (seconds > 0.0 && completedSinceLast >= 0) {
+            double const rate = completedSinceLast / seconds;
+            _progressChunksPerSec = (_progressChunksPerSec == 0.0)
+                    ? rate : 0.5*_progressChunksPerSec + 0.5*rate;
+        }
+    }
+    _progressLastTime = now;
+    _progressLastCompleted = completedJobs;
+    if (inFlightJobs == 0) {
+        progress.estTimeLeftSec = 0;
+    } else if (_progressChunksPerSec > 0.0) {
+        progress.estTimeLeftSec = static_cast<int>(inFlightJobs / _progressChunksPerSec);
+    }
+
+    try {
+        _queryMetadata->updateQueryProgress(progress);
+    } catch (std::exception const& exc) {
+        LOGS(_log, LOG_LVL_WARN, getQueryIdString()
+             << " failed to update query progress: " << exc.what());
+    }
+}
+
+// save the per-query phase breakdown and shape history to qmeta
+void UserQuerySelect::_qMetaSaveStats(uint64_t mergeMs, uint64_t resultRows)
+{
+    auto const phases = _executive->getPhaseStats();
+    qmeta::QStats stats;
+    stats.queryId = _qMetaQueryId;
+    stats.completedJobs = static_cast<int>(phases.jobs);
+    stats.dispatchWaitMs = phases.dispatchWaitMs;
+    stats.workerQueueMs = phases.workerQueueMs;
+    stats.mysqldMs = phases.mysqldMs;
+    stats.serializeMs = phases.serializeMs;
+    stats.transferMs = phases.transferMs;
+    stats.mergeMs = mergeMs;
+    LOGS(_log, LOG_LVL_DEBUG, getQueryIdString() << " phase breakdown jobs=" << stats.completedJobs
+         << " dispatchWaitMs=" << stats.dispatchWaitMs << " workerQueueMs=" << stats.workerQueueMs
+         << " mysqldMs=" << stats.mysqldMs << " serializeMs=" << stats.serializeMs
+         << " transferMs=" << stats.transferMs << " mergeMs=" << stats.mergeMs);
+    try {
+        _queryMetadata->saveQueryStats(stats);
+    } catch (std::exception const& exc) {
+        LOGS(_log, LOG_LVL_WARN, getQueryIdString() << " failed to save query stats: " << exc.what());
+    }
+
+    // fold this query's cost into its shape-history record
+    qmeta::QShapeStats shape;
+    shape.tableSet = _qMetaTableSet;
+    shape.shapeHash = _qMetaShapeHash;
+    shape.chunkCount = phases.jobs;
+    shape.rowCount = resultRows;
+    shape.workerMs = phases.mysqldMs + phases.serializeMs;
+    shape.mergeMs = mergeMs;
+    try {
+        _queryMetadata->addQueryShapeStats(shape);
+    } catch (std::exception const& exc) {
+        LOGS(_log, LOG_LVL_WARN, getQueryIdString() << " failed to save shape stats: " << exc.what());
+    }
+}
+
 
 /// Return this query's QueryId string.
 std::string UserQuerySelect::getQueryIdString() const {
@@ -32,6 +32,7 @@
   */
 
 // System headers
+#include <chrono>
 #include <cstdint>
 #include <memory>
 #include <mutex>
@@ -39,6 +40,8 @@
 // Third-party headers
 
 // Qserv headers
+#include "ccontrol/ResultPageRegistry.h"
+#include "ccontrol/ScanCohortManager.h"
 #include "ccontrol/UserQuery.h"
 #include "css/StripingParams.h"
 #include "qmeta/QInfo.h"
@@ -91,7 +94,10 @@ public:
                     qmeta::CzarId czarId,
                     std::shared_ptr<qdisp::QdispPool> const& qdispPool,
                     std::string const& errorExtra,
-                    bool async);
+                    bool async,
+                    std::shared_ptr<ScanCohortManager> const& scanCohorts,
+                    std::string const& user,
+                    ResultPageRegistry::Ptr const& resultPagers);
 
     UserQuerySelect(UserQuerySelect const&) = delete;
     UserQuerySelect& operator=(UserQuerySelect const&) = delete;
@@ -150,6 +156,17 @@ private:
     void _discardMerger();
     void _qMetaUpdateStatus(qmeta::QInfo::QStatus qStatus);
     void _qMetaAddChunks(std::vector<int> const& chunks);
+    /// Save the per-query phase breakdown and the query's contribution to
+    /// its shape history to qmeta. 'mergeMs' and 'resultRows' are captured
+    /// before the merger is discarded; the other phases come from the
+    /// executive. Errors are only logged, timing is not worth failing for.
+    void _qMetaSaveStats(uint64_t mergeMs, uint64_t resultRows);
+    /// Update this query's progress record in qmeta. Called every few
+    /// seconds from the executive's progress reporter while join() drains
+    /// the query; merge counters come from the merger and the remaining
+    /// time is estimated from a moving average of the completion rate.
+    /// Errors are only logged, progress is not worth failing for.
+    void _qMetaUpdateProgress(int totalJobs, int completedJobs, int inFlightJobs);
 
     // Delegate classes
     std::shared_ptr<qproc::QuerySession> _qSession;
@@ -162,15 +179,36 @@ private:
 
     qmeta::CzarId _qMetaCzarId; ///< Czar ID in QMeta database
     QueryId _qMetaQueryId{0};      ///< Query ID in QMeta database
+    std::string _qMetaTableSet;    ///< Canonical table-set key for shape statistics
+    uint64_t _qMetaShapeHash{0};   ///< Query template hash for shape statistics
     std::shared_ptr<qdisp::QdispPool> _qdispPool;
     /// QueryId in a standard string form, initially set to unknown.
     std::string _queryIdStr{QueryIdHelper::makeIdStr(0, true)};
     bool _killed{false};
     std::mutex _killMutex;
+    bool _submitError{false};   ///< True if submit() failed before dispatching jobs
     std::string _errorExtra;    ///< Additional error information
     std::string _resultTable;   ///< Result table name
     std::string _resultLoc;     ///< Result location
     bool _async;                ///< true for async query
+    std::string _user;          ///< Client name the query belongs to, may be empty
+
+    // Progress reporting state, only touched by _qMetaUpdateProgress()
+    // which runs on the single thread blocked in join().
+    std::chrono::steady_clock::time_point _progressLastTime; ///< Time of the previous snapshot.
+    int _progressLastCompleted{0};   ///< Completed jobs at the previous snapshot.
+    double _progressChunksPerSec{0}; ///< Moving average of the completion rate.
+
+    /// Shared-scan cohorts across concurrent queries; owned by the factory.
+    std::shared_ptr<ScanCohortManager> _scanCohorts;
+    /// This query's cohort membership, set in submit() for shared scans,
+    /// released in join().
+    std::shared_ptr<ScanCohortManager::Member> _cohortMember;
+
+    /// Registry of executing pageable queries (QSERV_RESULT_PAGE); owned
+    /// by the factory. Eligible async queries register their merger in
+    /// submit() and remove it in join().
+    ResultPageRegistry::Ptr _resultPagers;
 };
 
 }}} // namespace lsst::qserv:ccontrol
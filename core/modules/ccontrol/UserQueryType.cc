@@ -61,6 +61,28 @@ boost::regex _selectRe(R"(^select\s+.+$)",
 boost::regex _flushEmptyRe(R"(^flush\s+qserv_chunks_cache(\s+for\s+(["`]?)(\w+)\2)?\s*;?\s*$)",
                            boost::regex::ECMAScript | boost::regex::icase | boost::regex::optimize);
 
+// regex for FLUSH QSERV_CHUNKS_CACHE FOR database [ADD EMPTY (n, ...)] [REMOVE EMPTY (n, ...)]
+// db name will be in group 2, ADD list in group 3, REMOVE list in group 4.
+// Note that parens around whole string are not part of the regex but raw string literal
+boost::regex _flushEmptyDeltaRe(
+        R"(^flush\s+qserv_chunks_cache\s+for\s+(["`]?)(\w+)\1)"
+        R"((?:\s+add\s+empty\s*\(\s*(\d+(?:\s*,\s*\d+)*)\s*\))?)"
+        R"((?:\s+remove\s+empty\s*\(\s*(\d+(?:\s*,\s*\d+)*)\s*\))?\s*;?\s*$)",
+        boost::regex::ECMAScript | boost::regex::icase | boost::regex::optimize);
+
+// regex for extracting individual numbers from the chunk lists above
+boost::regex _chunkNumberRe(R"(\d+)",
+                            boost::regex::ECMAScript | boost::regex::optimize);
+
+// parse a comma-separated list of chunk numbers into a vector
+void parseChunkList(std::string const& list, lsst::qserv::IntVector& chunks) {
+    boost::sregex_iterator it(list.begin(), list.end(), _chunkNumberRe);
+    boost::sregex_iterator end;
+    for (; it != end; ++it) {
+        chunks.push_back(std::stoi(it->str()));
+    }
+}
+
 // regex for SHOW [FULL] PROCESSLIST
 // if FULL is present then group 1 is non-empty
 // Note that parens around whole string are not part of the regex but raw string literal
@@ -79,6 +101,12 @@ boost::regex _submitRe(R"(^submit\s+(.+)$)",
 boost::regex _selectResultRe(R"(^select\s+\*\s+from\s+qserv_result\s*\(\s*(\d+)\s*\)$)",
                              boost::regex::ECMAScript | boost::regex::icase | boost::regex::optimize);
 
+// regex for SELECT * FROM QSERV_RESULT_PAGE(12345)
+// group 1 is the query ID number
+// Note that parens around whole string are not part of the regex but raw string literal
+boost::regex _selectResultPageRe(R"(^select\s+\*\s+from\s+qserv_result_page\s*\(\s*(\d+)\s*\)$)",
+                                 boost::regex::ECMAScript | boost::regex::icase | boost::regex::optimize);
+
 // regex for KILL [QUERY|CONNECTION] 12345
 // group 1 is the thread ID number
 // Note that parens around whole string are not part of the regex but raw string literal
@@ -135,6 +163,9 @@ UserQueryType::isSelect(std::string const& query) {
         if (boost::regex_match(query, sm, _selectResultRe)) {
             LOGS(_log, LOG_LVL_DEBUG, "isSelect: match select result");
             match = false;
+        } else if (boost::regex_match(query, sm, _selectResultPageRe)) {
+            LOGS(_log, LOG_LVL_DEBUG, "isSelect: match select result page");
+            match = false;
         }
     }
     return match;
@@ -153,6 +184,26 @@ UserQueryType::isFlushChunksCache(std::string const& query, std::string& dbName)
     return match;
 }
 
+/// Returns true if query is FLUSH QSERV_CHUNKS_CACHE FOR database with
+/// an ADD EMPTY and/or REMOVE EMPTY chunk list
+bool
+UserQueryType::isFlushChunksCacheDelta(std::string const& query, std::string& dbName,
+                                       IntVector& addedEmpty, IntVector& removedEmpty) {
+    LOGS(_log, LOG_LVL_DEBUG, "isFlushChunksCacheDelta: " << query);
+    boost::smatch sm;
+    bool match = boost::regex_match(query, sm, _flushEmptyDeltaRe);
+    // without at least one chunk list this is a plain cache flush
+    if (match and (sm.length(3) != 0 or sm.length(4) != 0)) {
+        dbName = sm.str(2);
+        parseChunkList(sm.str(3), addedEmpty);
+        parseChunkList(sm.str(4), removedEmpty);
+        LOGS(_log, LOG_LVL_DEBUG, "isFlushChunksCacheDelta: match: " << dbName
+             << " +" << addedEmpty.size() << " -" << removedEmpty.size());
+        return true;
+    }
+    return false;
+}
+
 /// Returns true if query is SHOW [FULL] PROCESSLIST
 bool
 UserQueryType::isShowProcessList(std::string const& query, bool& full) {
@@ -199,6 +250,19 @@ UserQueryType::isSelectResult(std::string const& query, QueryId& queryId) {
      return match;
 }
 
+/// Returns true if query is SELECT * FROM QSERV_RESULT_PAGE(...)
+bool
+UserQueryType::isSelectResultPage(std::string const& query, QueryId& queryId) {
+     LOGS(_log, LOG_LVL_DEBUG, "isSelectResultPage: " << query);
+     boost::smatch sm;
+     bool match = boost::regex_match(query, sm, _selectResultPageRe);
+     if (match) {
+         queryId = std::stoull(sm.str(1));
+         LOGS(_log, LOG_LVL_DEBUG, "isSelectResultPage: queryId: " << queryId);
+     }
+     return match;
+}
+
 // Returns true if query is KILL [QUERY|CONNECTION] NNN
 bool
 UserQueryType::isKill(std::string const& query, int& threadId) {
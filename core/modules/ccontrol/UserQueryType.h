@@ -58,6 +58,14 @@ public:
     /// Returns true if query is FLUSH QSERV_CHUNKS_CACHE [FOR database]
     static bool isFlushChunksCache(std::string const& query, std::string& dbName);
 
+    /**
+     *  Returns true if query is FLUSH QSERV_CHUNKS_CACHE FOR database with
+     *  an incremental ADD EMPTY (chunk, ...) and/or REMOVE EMPTY (chunk, ...)
+     *  list, returns the chunk numbers in `addedEmpty` and `removedEmpty`.
+     */
+    static bool isFlushChunksCacheDelta(std::string const& query, std::string& dbName,
+                                        IntVector& addedEmpty, IntVector& removedEmpty);
+
     /**
      *  Returns true if query is SHOW [FULL] PROCESSLIST
      *
@@ -85,6 +93,12 @@ public:
      */
     static bool isSelectResult(std::string const& query, QueryId& queryId);
 
+    /**
+     *  Returns true if query is SELECT * FROM QSERV_RESULT_PAGE(...), returns
+     *  query ID in `queryId` argument.
+     */
+    static bool isSelectResultPage(std::string const& query, QueryId& queryId);
+
     /**
      *  Returns true if query is KILL [QUERY|CONNECTION] NNN, returns
      *  thread ID in `threadId` argument.
@@ -539,6 +539,41 @@ BOOST_AUTO_TEST_CASE(testUserQueryType) {
         BOOST_CHECK(not UserQueryType::isFlushChunksCache(test, db));
     }
 
+    struct {
+        const char* query;
+        const char* db;
+        IntVector added;
+        IntVector removed;
+    } flush_delta_ok[] = {
+        {"FLUSH QSERV_CHUNKS_CACHE FOR DB ADD EMPTY (1)", "DB", {1}, {}},
+        {"FLUSH QSERV_CHUNKS_CACHE FOR DB ADD EMPTY (1, 2,3)", "DB", {1, 2, 3}, {}},
+        {"FLUSH QSERV_CHUNKS_CACHE FOR DB REMOVE EMPTY (7);", "DB", {}, {7}},
+        {"FLUSH QSERV_CHUNKS_CACHE FOR `DB` ADD EMPTY (1) REMOVE EMPTY (2, 3)", "DB", {1}, {2, 3}},
+        {"flush qserv_chunks_cache for d_b add empty ( 42 ) ; ", "d_b", {42}, {}},
+    };
+    for (auto&& test: flush_delta_ok) {
+        std::string db;
+        IntVector added, removed;
+        BOOST_CHECK(UserQueryType::isFlushChunksCacheDelta(test.query, db, added, removed));
+        BOOST_CHECK_EQUAL(db, test.db);
+        BOOST_CHECK(added == test.added);
+        BOOST_CHECK(removed == test.removed);
+    }
+
+    const char* flush_delta_fail[] = {
+        "FLUSH QSERV_CHUNKS_CACHE FOR DB",                      // plain flush, no delta
+        "FLUSH QSERV_CHUNKS_CACHE ADD EMPTY (1)",               // no database
+        "FLUSH QSERV_CHUNKS_CACHE FOR DB ADD EMPTY ()",         // empty list
+        "FLUSH QSERV_CHUNKS_CACHE FOR DB ADD EMPTY (1,)",       // malformed list
+        "FLUSH QSERV_CHUNKS_CACHE FOR DB REMOVE EMPTY (A)",     // not a number
+        "FLUSH QSERV_CHUNKS_CACHE FOR DB DROP EMPTY (1)",       // unknown clause
+    };
+    for (auto test: flush_delta_fail) {
+        std::string db;
+        IntVector added, removed;
+        BOOST_CHECK(not UserQueryType::isFlushChunksCacheDelta(test, db, added, removed));
+    }
+
     const char* show_proclist_ok[] = {
         "SHOW PROCESSLIST",
         "show processlist",
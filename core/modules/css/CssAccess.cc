@@ -55,6 +55,11 @@ LOG_LOGGER _log = LOG_GET("lsst.qserv.css.CssAccess");
 // Name of sub-key used for packed data
 std::string const _packedKeyName(".packed.json");
 
+// How often the stored generation counter is compared against the one
+// seen at snapshot time, this limits the rate of server round-trips on
+// the read-only path to one per interval.
+std::chrono::seconds const _generationCheckInterval(1);
+
 }
 
 namespace lsst {
@@ -127,9 +132,14 @@ CssAccess::createFromConfig(std::map<std::string, std::string> const& config,
 // Construct from KvInterface instance and empty chunk list instance
 CssAccess::CssAccess(std::shared_ptr<KvInterface> const& kvInterface,
                      std::shared_ptr<EmptyChunks> const& emptyChunks,
-                     std::string const& prefix)
+                     std::string const& prefix,
+                     bool useSnapshot)
     : _kvI(kvInterface), _emptyChunks(emptyChunks),
-      _prefix(prefix), _versionOk(false) {
+      _prefix(prefix), _versionOk(false),
+      // memory-based storage is as fast as the snapshot would be,
+      // so there is no point in caching it (unless forced to)
+      _useSnapshot(useSnapshot or
+                   std::dynamic_pointer_cast<KvInterfaceImplMem>(kvInterface) == nullptr) {
 
     // Check CSS version defined in KV, or create key with version
     _checkVersion(false);
@@ -162,12 +172,61 @@ CssAccess::_checkVersion(bool mustExist) const {
     }
 }
 
+std::string
+CssAccess::getSnapshotGeneration() const {
+    if (not _useSnapshot) return std::string();
+    // make sure the snapshot (and its generation) is up to date
+    _kv();
+    std::lock_guard<std::mutex> lock(_snapshotMtx);
+    return _snapshotGeneration;
+}
+
+std::shared_ptr<KvInterface>
+CssAccess::_kv() const {
+    if (not _useSnapshot) return _kvI;
+
+    std::lock_guard<std::mutex> lock(_snapshotMtx);
+    auto const now = std::chrono::steady_clock::now();
+    if (_snapshot == nullptr or now >= _snapshotCheckTime) {
+        // single round-trip to the real storage, at most once per interval
+        auto const generation = _kvI->get(GENERATION_KEY, "");
+        if (_snapshot == nullptr or generation != _snapshotGeneration) {
+            LOGS(_log, LOG_LVL_DEBUG, "loading CSS snapshot, generation: '" << generation << "'");
+            std::istringstream str(_kvI->dumpKV());
+            _snapshot = std::make_shared<KvInterfaceImplMem>(str, true);
+            _snapshotGeneration = generation;
+        }
+        _snapshotCheckTime = now + ::_generationCheckInterval;
+    }
+    return _snapshot;
+}
+
+void
+CssAccess::_bumpGeneration() {
+    if (not _useSnapshot) return;
+
+    // get+set is not atomic but CSS updates are rare administrative
+    // operations and a lost increment only delays snapshot refresh
+    // in other instances until the following update
+    int generation = 0;
+    try {
+        generation = std::stoi(_kvI->get(GENERATION_KEY, "0"));
+    } catch (std::exception const& exc) {
+        LOGS(_log, LOG_LVL_WARN, "non-numeric generation key value, resetting: " << exc.what());
+    }
+    _kvI->set(GENERATION_KEY, std::to_string(generation + 1));
+
+    // drop local snapshot so that our own update is seen immediately
+    std::lock_guard<std::mutex> lock(_snapshotMtx);
+    _snapshot.reset();
+}
+
 std::vector<std::string>
 CssAccess::getDbNames() const {
     _checkVersion();
 
     std::string p = _prefix + "/DBS";
-    auto names = _kvI->getChildren(p);
+    auto names = _kv()->getChildren(p);
 
     // databases cannot be packed, but just in case remove packed key if any
     auto it = std::remove(names.begin(), names.end(), ::_packedKeyName);
@@ -181,7 +240,7 @@ CssAccess::getDbStatus() const {
     _checkVersion();
 
     std::string p = _prefix + "/DBS";
-    auto kvs = _kvI->getChildrenValues(p);
+    auto kvs = _kv()->getChildrenValues(p);
 
     // databases cannot be packed, but just in case remove packed key if any
     kvs.erase(::_packedKeyName);
@@ -197,6 +256,7 @@ CssAccess::setDbStatus(std::string const& dbName, std::string const& status) {
     _assertDbExists(dbName);
     std::string const dbKey = _prefix + "/DBS/" + dbName;
     _kvI->set(dbKey, status);
+    _bumpGeneration();
 }
 
 bool
@@ -207,7 +267,7 @@ CssAccess::containsDb(std::string const& dbName) const {
         return false;
     }
     std::string p = _prefix + "/DBS/" + dbName;
-    bool ret = _kvI->exists(p);
+    bool ret = _kv()->exists(p);
     LOGS(_log, LOG_LVL_DEBUG, "containsDb(" << dbName << "): " << ret);
     return ret;
 }
@@ -291,6 +351,7 @@ CssAccess::createDb(std::string const& dbName,
     std::string const dbKey = _prefix + "/DBS/" + dbName;
     _storePacked(dbKey, dbMap);
     _kvI->set(dbKey, KEY_STATUS_READY);
+    _bumpGeneration();
 }
 
 void
@@ -310,6 +371,7 @@ CssAccess::createDbLike(std::string const& dbName,
     std::string const dbKey = _prefix + "/DBS/" + dbName;
     _storePacked(dbKey, dbMap);
     _kvI->set(dbKey, KEY_STATUS_READY);
+    _bumpGeneration();
 }
 
 void
@@ -327,6 +389,7 @@ CssAccess::dropDb(std::string const& dbName) {
         LOGS(_log, LOG_LVL_DEBUG, "dropDb: key is not found: " << key);
         throw NoSuchDb(dbName);
     }
+    _bumpGeneration();
 }
 
 std::vector<std::string>
@@ -337,7 +400,7 @@ CssAccess::getTableNames(std::string const& dbName, bool readyOnly) const {
     std::string key = _prefix + "/DBS/" + dbName + "/TABLES";
     std::vector<std::string> names;
     try {
-        names = _kvI->getChildren(key);
+        names = _kv()->getChildren(key);
     } catch (NoSuchKey const& exc) {
         LOGS(_log, LOG_LVL_DEBUG, "getTableNames: key is not found: " << key);
         _assertDbExists(dbName);
@@ -368,7 +431,7 @@ CssAccess::getTableStatus(std::string const& dbName) const {
     std::string key = _prefix + "/DBS/" + dbName + "/TABLES";
     std::map<std::string, std::string> kvs;
     try {
-        kvs = _kvI->getChildrenValues(key);
+        kvs = _kv()->getChildrenValues(key);
     } catch (NoSuchKey const& exc) {
         LOGS(_log, LOG_LVL_DEBUG, "getTableNames: key is not found: " << key);
         _assertDbExists(dbName);
@@ -390,8 +453,10 @@ CssAccess::setTableStatus(std::string const& dbName,
     _checkVersion();
 
     std::string const tableKey = _prefix + "/DBS/" + dbName + "/TABLES/" + tableName;
+    // check against the real storage, snapshot may lag behind
     if (not _kvI->exists(tableKey)) throw NoSuchTable(dbName, tableName);
     _kvI->set(tableKey, status);
+    _bumpGeneration();
 }
 
 bool
@@ -401,7 +466,7 @@ CssAccess::containsTable(std::string const& dbName, std::string const& tableName
 
     std::string const key = _prefix + "/DBS/" + dbName + "/TABLES/" + tableName;
     // If key is not there pretend that its value is not "READY"
-    std::string const val = _kvI->get(key, "DOES_NOT_EXIST");
+    std::string const val = _kv()->get(key, "DOES_NOT_EXIST");
     if (val == "DOES_NOT_EXIST") {
         // table key is not there at all, throw if database name is not good
         _assertDbExists(dbName);
@@ -425,7 +490,7 @@ CssAccess::getTableSchema(std::string const& dbName, std::string const& tableNam
     auto const schema = kvMap["schema"];
     if (schema.empty()) {
         // check table key
-        if (not _kvI->exists(tableKey)) throw NoSuchTable(dbName, tableName);
+        if (not _kv()->exists(tableKey)) throw NoSuchTable(dbName, tableName);
     }
     return schema;
 }
@@ -445,7 +510,7 @@ CssAccess::getMatchTableParams(std::string const& dbName,
     auto paramMap = _getSubkeys(tableKey, subKeys);
     if (paramMap.empty()) {
         // check table key
-        if (not _kvI->exists(tableKey)) throw NoSuchTable(dbName, tableName);
+        if (not _kv()->exists(tableKey)) throw NoSuchTable(dbName, tableName);
         return params;
     }
 
@@ -469,7 +534,7 @@ CssAccess::getPartTableParams(std::string const& dbName,
     auto paramMap = _getSubkeys(tableKey, subKeys);
     if (paramMap.empty()) {
         // check table key
-        if (not _kvI->exists(tableKey)) throw NoSuchTable(dbName, tableName);
+        if (not _kv()->exists(tableKey)) throw NoSuchTable(dbName, tableName);
         return params;
     }
 
@@ -491,7 +556,7 @@ CssAccess::getScanTableParams(std::string const& dbName,
     auto paramMap = _getSubkeys(tableKey, subKeys);
     if (paramMap.empty()) {
         // check table key
-        if (not _kvI->exists(tableKey)) throw NoSuchTable(dbName, tableName);
+        if (not _kv()->exists(tableKey)) throw NoSuchTable(dbName, tableName);
         return params;
     }
 
@@ -517,7 +582,7 @@ CssAccess::getTableParams(std::string const& dbName, std::string const& tableNam
     auto paramMap = _getSubkeys(tableKey, subKeys);
     if (paramMap.empty()) {
         // check table key
-        if (not _kvI->exists(tableKey)) throw NoSuchTable(dbName, tableName);
+        if (not _kv()->exists(tableKey)) throw NoSuchTable(dbName, tableName);
         return params;
     }
 
@@ -582,6 +647,7 @@ CssAccess::createTable(std::string const& dbName,
 
     // done
     _kvI->set(tableKey, KEY_STATUS_READY);
+    _bumpGeneration();
 }
 
 void
@@ -623,6 +689,7 @@ CssAccess::createMatchTable(std::string const& dbName,
 
     // done, can mark table as ready
     _kvI->set(tableKey, KEY_STATUS_READY);
+    _bumpGeneration();
 }
 
 void
@@ -640,12 +707,13 @@ CssAccess::dropTable(std::string const& dbName, std::string const& tableName) {
         LOGS(_log, LOG_LVL_DEBUG, "dropTable: key is not found: " << key);
         throw NoSuchTable(dbName, tableName);
     }
+    _bumpGeneration();
 }
 
 std::vector<std::string>
 CssAccess::getNodeNames() const {
     std::string const key = _prefix + "/NODES";
-    auto nodes = _kvI->getChildren(key);
+    auto nodes = _kv()->getChildren(key);
     _checkVersion();
 
     // /NODES cannot have packed keys, but just in case remove packed key if any
@@ -668,7 +736,7 @@ CssAccess::getNodeParams(std::string const& nodeName) const {
     auto paramMap = _getSubkeys(key, subKeys);
     if (paramMap.empty()) {
         // check node key
-        if (not _kvI->exists(key + "/" + nodeName)) throw NoSuchNode(nodeName);
+        if (not _kv()->exists(key + "/" + nodeName)) throw NoSuchNode(nodeName);
         return params;
     }
 
@@ -735,6 +803,7 @@ CssAccess::addNode(std::string const& nodeName, NodeParams const& nodeParams) {
 
     // done
     _kvI->set(key, nodeParams.state);
+    _bumpGeneration();
 }
 
 void CssAccess::setNodeState(std::string const& nodeName, std::string const& newState) {
@@ -749,6 +818,7 @@ void CssAccess::setNodeState(std::string const& nodeName, std::string const& new
     }
 
     _kvI->set(key, newState);
+    _bumpGeneration();
 }
 
 void
@@ -779,6 +849,7 @@ CssAccess::deleteNode(std::string const& nodeName) {
         LOGS(_log, LOG_LVL_DEBUG, "deleteNode: key is not found: " << key);
         throw NoSuchNode(nodeName);
     }
+    _bumpGeneration();
 }
 
 void
@@ -799,6 +870,7 @@ CssAccess::addChunk(std::string const& dbName,
         std::map<std::string, std::string> chunkMap{std::make_pair("nodeName", node)};
         _storePacked(path, chunkMap);
     }
+    _bumpGeneration();
 }
 
 void
@@ -825,6 +897,7 @@ CssAccess::deleteChunk(std::string const& dbName,
             throw exc;
         }
     }
+    _bumpGeneration();
 }
 
 
@@ -838,14 +911,28 @@ CssAccess::getChunks(std::string const& dbName, std::string const& tableName) {
 
     std::map<int, std::vector<std::string>> result;
 
-    std::vector<std::string> chunks;
+    // fetch the whole chunk subtree with a single request and look at the
+    // local copy below, this avoids per-chunk and per-replica lookups
+    std::map<std::string, std::string> subtree;
     try {
-        chunks = _kvI->getChildren(chunksKey);
+        subtree = _kv()->getSubtree(chunksKey);
     } catch (NoSuchKey const& exc) {
-        if (not _kvI->exists(tableKey)) throw NoSuchTable(dbName, tableName);
+        if (not _kv()->exists(tableKey)) throw NoSuchTable(dbName, tableName);
         LOGS(_log, LOG_LVL_DEBUG, "getChunks: No CHUNKS sub-key for: " << tableKey);
         return result;
     }
+    KvInterfaceImplMem chunksKvi;
+    for (auto& pair: subtree) {
+        chunksKvi.set(pair.first, pair.second);
+    }
+
+    std::vector<std::string> chunks;
+    try {
+        chunks = chunksKvi.getChildren(chunksKey);
+    } catch (NoSuchKey const& exc) {
+        // CHUNKS key exists but has no sub-keys
+        return result;
+    }
 
     for (auto& chunk: chunks) {
         int chunkId;
@@ -859,7 +946,7 @@ CssAccess::getChunks(std::string const& dbName, std::string const& tableName) {
         std::string const replicasKey = chunksKey + "/" + chunk + "/REPLICAS";
         std::vector<std::string> replicas;
         try {
-            replicas = _kvI->getChildren(replicasKey);
+            replicas = chunksKvi.getChildren(replicasKey);
 
             // replicas cannot be packed, but just in case remove packed key if any
             auto it = std::remove(replicas.begin(), replicas.end(), ::_packedKeyName);
@@ -871,7 +958,7 @@ CssAccess::getChunks(std::string const& dbName, std::string const& tableName) {
 
         auto& nodes = result[chunkId];
         for (auto& replica: replicas) {
-            auto nodeMap = _getSubkeys(replicasKey + "/" + replica, {"nodeName"});
+            auto nodeMap = _getSubkeys(replicasKey + "/" + replica, {"nodeName"}, chunksKvi);
             auto iter = nodeMap.find("nodeName");
             if (iter != nodeMap.end()) {
                 nodes.push_back(iter->second);
@@ -892,6 +979,12 @@ CssAccess::_assertDbExists(std::string const& dbName) const {
 
 std::map<std::string, std::string>
 CssAccess::_getSubkeys(std::string const& key, std::vector<std::string> const& subKeys) const {
+    return _getSubkeys(key, subKeys, *_kv());
+}
+
+std::map<std::string, std::string>
+CssAccess::_getSubkeys(std::string const& key, std::vector<std::string> const& subKeys,
+                       KvInterface& kvI) const {
     LOGS(_log, LOG_LVL_DEBUG, "_getSubkeys(" << key << ", " << util::printable(subKeys) << ")");
 
     std::set<std::string> parentKeys;
@@ -921,7 +1014,7 @@ CssAccess::_getSubkeys(std::string const& key, std::vector<std::string> const& s
 
     // get everything in one call from KV store, this is
     // supposed to be consistent set of values
-    auto keyMap = _kvI->getMany(allKeys);
+    auto keyMap = kvI.getMany(allKeys);
     LOGS(_log, LOG_LVL_DEBUG, "_getSubkeys: kvI returned: " << util::printable(keyMap));
 
     // unpack packed guys, and add unpacked keys to a key map, this does not overwrite
@@ -23,8 +23,10 @@
 #define LSST_QSERV_CSS_CSSACCESS_H
 
 // System headers
+#include <chrono>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -46,6 +48,7 @@ namespace css {
 
 class EmptyChunks;
 class KvInterface;
+class KvInterfaceImplMem;
 
 /// @addtogroup css
 
@@ -66,6 +69,14 @@ class KvInterface;
  *
  *  This is a concrete class, instances can be copied around and all copies
  *  share the same KvInterface instance (and empty chunk list).
+ *
+ *  For storage implementations which need a server round-trip per lookup
+ *  (e.g. mysql) all read-only methods are served from an in-memory snapshot
+ *  of the whole CSS data. The snapshot is loaded once and is only re-loaded
+ *  when the generation counter stored in CSS under GENERATION_KEY changes,
+ *  the counter is checked at most once per second. Methods which update CSS
+ *  always go directly to the underlying storage and bump the generation
+ *  counter.
  */
 
 class CssAccess {
@@ -140,6 +151,17 @@ public:
      */
     static int cssVersion();
 
+    /**
+     * @brief Returns the generation counter of the current CSS snapshot.
+     *
+     * The counter changes whenever CSS data is updated, so it can be used
+     * by clients to key caches of information derived from CSS. An empty
+     * string is returned when snapshot caching is not in use (memory-based
+     * storage) or the generation counter has never been set; such caches
+     * must not assume CSS immutability in that case.
+     */
+    std::string getSnapshotGeneration() const;
+
     /**
      * @brief Returns the list of known databases.
      */
@@ -497,10 +519,14 @@ public:
 
 protected:
 
-    // Construct from KvInterface instance and empty chunk list instance
+    // Construct from KvInterface instance and empty chunk list instance.
+    // Snapshot caching is normally enabled only for storage implementations
+    // which need a server round-trip per lookup, useSnapshot forces it on
+    // for memory-based storage too (only useful for testing).
     CssAccess(std::shared_ptr<KvInterface> const& kvInterface,
               std::shared_ptr<EmptyChunks> const& emptyChunks,
-              std::string const& prefix = std::string());
+              std::string const& prefix = std::string(),
+              bool useSnapshot = false);
 
     // Methods below are protected only for testing purposes so that one can
     // subclass CssAccess and expose these methods for testing
@@ -518,6 +544,14 @@ protected:
     std::map<std::string, std::string> _getSubkeys(std::string const& key,
                                                    std::vector<std::string> const& subKeys) const;
 
+    /**
+     * Same as above but looks at the given KvInterface instance instead of
+     * the regular storage, used with locally pre-fetched subtrees.
+     */
+    std::map<std::string, std::string> _getSubkeys(std::string const& key,
+                                                   std::vector<std::string> const& subKeys,
+                                                   KvInterface& kvI) const;
+
     /**
      * Unpack json string into key-value map, only one-level nesting
      * is supported, keys with more complex values are ignored. For empty
@@ -540,6 +574,22 @@ protected:
 
 private:
 
+    /**
+     *  Returns KvInterface instance to be used for read-only methods.
+     *
+     *  When snapshot caching is disabled this is the underlying storage
+     *  itself. Otherwise it is an in-memory snapshot of the whole CSS data
+     *  which is re-loaded from the underlying storage when the generation
+     *  counter changes (checked at most once per second).
+     */
+    std::shared_ptr<KvInterface> _kv() const;
+
+    /**
+     *  Increments the generation counter stored in CSS and drops the local
+     *  snapshot, must be called by every method which updates CSS data.
+     */
+    void _bumpGeneration();
+
     void _fillPartTableParams(std::map<std::string, std::string>& paramMap,
                               PartTableParams& params,
                               std::string const& tableKey) const;
@@ -556,6 +606,13 @@ private:
     std::shared_ptr<EmptyChunks> _emptyChunks;
     std::string _prefix;    // optional prefix, for isolating tests from production
     mutable bool _versionOk;   // True if version is checked (and is OK)
+    bool _useSnapshot;      // True if read-only methods use memory snapshot
+
+    // State of the memory snapshot, see _kv() for details
+    mutable std::mutex _snapshotMtx;    // protects all members below
+    mutable std::shared_ptr<KvInterfaceImplMem> _snapshot;
+    mutable std::string _snapshotGeneration;    // generation counter at snapshot time
+    mutable std::chrono::steady_clock::time_point _snapshotCheckTime;   // next generation check
 };
 
 }}} // namespace lsst::qserv::css
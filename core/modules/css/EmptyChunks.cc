@@ -78,34 +78,86 @@ namespace lsst {
 namespace qserv {
 namespace css {
 
+std::shared_ptr<EmptyChunks::Bitmap const>
+EmptyChunks::getEmptyBitmap(std::string const& db) const {
+    std::lock_guard<std::mutex> lock(_bitmapsMutex);
+    BitmapMap::const_iterator i = _bitmaps.find(db);
+    if (i != _bitmaps.end()) {
+        return i->second;
+    }
+
+    IntSet chunks;
+    populate(_path, _fallbackFile, chunks, db);
+
+    auto bitmap = std::make_shared<Bitmap>();
+    if (not chunks.empty()) {
+        // sets are ordered so the largest chunk number comes last
+        bitmap->_bits.resize(*chunks.rbegin() + 1, false);
+        for (int chunk: chunks) {
+            if (chunk >= 0) bitmap->_bits[chunk] = true;
+        }
+    }
+    _bitmaps.insert(BitmapMap::value_type(db, bitmap));
+    return bitmap;
+}
+
 std::shared_ptr<IntSet const>
 EmptyChunks::getEmpty(std::string const& db) const {
-    std::lock_guard<std::mutex> lock(_setsMutex);
-    IntSetMap::const_iterator i = _sets.find(db);
-    if (i != _sets.end()) {
-        IntSetConstPtr readOnly = i->second;
-        return readOnly;
+    BitmapConstPtr bitmap = getEmptyBitmap(db);
+    auto newSet = std::make_shared<IntSet>();
+    for (size_t chunk = 0; chunk < bitmap->_bits.size(); ++chunk) {
+        if (bitmap->_bits[chunk]) {
+            newSet->insert(newSet->end(), int(chunk));
+        }
     }
-    IntSetPtr newSet = std::make_shared<IntSet>();
-    _sets.insert(IntSetMap::value_type(db, newSet));
-    populate(_path, _fallbackFile, *newSet, db); // Populate reference
-    return IntSetConstPtr(newSet);
+    return newSet;
 }
 
 bool
 EmptyChunks::isEmpty(std::string const& db, int chunk) const {
-    IntSetConstPtr s = getEmpty(db);
-    return s->end() != s->find(chunk);
+    return getEmptyBitmap(db)->contains(chunk);
+}
+
+void
+EmptyChunks::updateCache(std::string const& db,
+                         IntVector const& addedEmpty,
+                         IntVector const& removedEmpty) const {
+    std::lock_guard<std::mutex> lock(_bitmapsMutex);
+    BitmapMap::iterator i = _bitmaps.find(db);
+    if (i == _bitmaps.end()) {
+        LOGS(_log, LOG_LVL_DEBUG, "No cached empty chunks for database " << db
+             << ", delta update skipped");
+        return;
+    }
+    LOGS(_log, LOG_LVL_DEBUG, "Updating empty chunks cache for database " << db
+         << ": +" << addedEmpty.size() << " -" << removedEmpty.size());
+
+    // Published bitmaps are immutable, so patch a copy and republish it.
+    auto bitmap = std::make_shared<Bitmap>(*i->second);
+    for (int chunk: addedEmpty) {
+        if (chunk < 0) continue;
+        if (static_cast<size_t>(chunk) >= bitmap->_bits.size()) {
+            bitmap->_bits.resize(chunk + 1, false);
+        }
+        bitmap->_bits[chunk] = true;
+    }
+    for (int chunk: removedEmpty) {
+        if (chunk >= 0 and static_cast<size_t>(chunk) < bitmap->_bits.size()) {
+            bitmap->_bits[chunk] = false;
+        }
+    }
+    i->second = bitmap;
 }
 
 void
 EmptyChunks::clearCache(std::string const& db) const {
+    std::lock_guard<std::mutex> lock(_bitmapsMutex);
     if (db.empty()) {
         LOGS(_log, LOG_LVL_DEBUG, "Clearing empty chunks cache for all databases");
-        _sets.clear();
+        _bitmaps.clear();
     } else {
         LOGS(_log, LOG_LVL_DEBUG, "Clearing empty chunks cache for database " << db);
-        _sets.erase(db);
+        _bitmaps.erase(db);
     }
 }
 
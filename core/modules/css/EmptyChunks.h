@@ -38,6 +38,7 @@
 #include <memory>
 #include <mutex>
 #include <string>
+#include <vector>
 
 // Qserv headers
 #include "global/intTypes.h"
@@ -57,9 +58,29 @@ public:
                 std::string const& fallbackFile="emptyChunks.txt")
         : _path(path), _fallbackFile(fallbackFile) {}
 
+    /// Flat bitmap of empty chunk numbers for a single database. Probes
+    /// are O(1) bit tests, instances are immutable once published so they
+    /// can be used without locking.
+    class Bitmap {
+    public:
+        /// @return true if chunk is in the empty chunk list
+        bool contains(int chunk) const {
+            return chunk >= 0 and static_cast<size_t>(chunk) < _bits.size()
+                    and _bits[chunk];
+        }
+    private:
+        friend class EmptyChunks;
+        std::vector<bool> _bits;    ///< indexed by chunk number
+    };
+
     // accessors
 
-    /// @return set of empty chunks for this db
+    /// @return bitmap of empty chunks for this db, suitable for probing
+    /// many chunk numbers in a row
+    std::shared_ptr<Bitmap const> getEmptyBitmap(std::string const& db) const;
+
+    /// @return set of empty chunks for this db, the set is re-built from
+    /// the bitmap on every call so prefer getEmptyBitmap() for new code
     std::shared_ptr<IntSet const> getEmpty(std::string const& db) const;
 
     /// @return true if db/chunk is empty
@@ -70,17 +91,26 @@ public:
     // for all databases is cleared.
     void clearCache(std::string const& db=std::string()) const;
 
+    /// Apply an incremental update to the cached bitmap of a database:
+    /// chunks in addedEmpty become empty, chunks in removedEmpty stop being
+    /// empty. A new bitmap is published so queries holding the previous
+    /// snapshot are unaffected; nothing is re-read from disk. If the
+    /// database is not cached yet the update is a no-op since the next
+    /// lookup loads the current state anyway.
+    void updateCache(std::string const& db,
+                     IntVector const& addedEmpty,
+                     IntVector const& removedEmpty) const;
+
 private:
 
     // Convenience types
-    typedef std::shared_ptr<IntSet> IntSetPtr;
-    typedef std::shared_ptr<IntSet const> IntSetConstPtr;
+    typedef std::shared_ptr<Bitmap const> BitmapConstPtr;
 
-    typedef std::map<std::string, IntSetPtr> IntSetMap;
+    typedef std::map<std::string, BitmapConstPtr> BitmapMap;
     std::string _path; ///< Search path for empty chunks files
     std::string _fallbackFile; ///< Fallback path for empty chunks
-    mutable IntSetMap _sets; ///< Container for empty chunks sets (cache)
-    mutable std::mutex _setsMutex;
+    mutable BitmapMap _bitmaps; ///< Container for empty chunks bitmaps (cache)
+    mutable std::mutex _bitmapsMutex;
 };
 
 }}} // namespace lsst::qserv::css
@@ -129,6 +129,16 @@ public:
      */
     virtual std::map<std::string, std::string> getChildrenValues(std::string const& key) = 0;
 
+    /**
+     * Returns all key/value pairs in the subtree below the given key,
+     * the key itself is not included. Returned map has full key names
+     * as keys. Implementations which need a server round-trip per lookup
+     * fetch the whole subtree with a single request.
+     * @throws NoSuchKey if the key does not exist
+     * @throws CssError for other problems (e.g., a connection error is detected).
+     */
+    virtual std::map<std::string, std::string> getSubtree(std::string const& key) = 0;
+
     /**
      * Delete a key, and all of its children (if they exist)
      * @throws NoSuchKey on failure.
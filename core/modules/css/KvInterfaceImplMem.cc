@@ -34,9 +34,12 @@
 #include "css/KvInterfaceImplMem.h"
 
 // System headers
+#include <cstdint>
+#include <cstring>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <iterator>
 #include <sstream>
 #include <stdexcept>
 
@@ -69,6 +72,17 @@ std::string norm_key(std::string const& key) {
     return path;
 }
 
+// Binary snapshot format: SnapshotHeader followed by numRecords records,
+// each a pair of length-prefixed strings (key then value), in key order.
+uint32_t const snapshotMagic = 0x51435353;  // "QCSS"
+uint32_t const snapshotVersion = 1;
+
+struct SnapshotHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t numRecords;
+};
+
 }
 
 namespace lsst {
@@ -249,6 +263,24 @@ KvInterfaceImplMem::getChildrenValues(std::string const& key) {
     return retV;
 }
 
+std::map<std::string, std::string>
+KvInterfaceImplMem::getSubtree(std::string const& key) {
+    LOGS(_log, LOG_LVL_DEBUG, "getSubtree(), key: " << key);
+    std::string path = norm_key(key);
+    if ( ! exists(path) ) {
+        throw NoSuchKey(path);
+    }
+    const string pfx(path + "/");
+    std::map<std::string, std::string> retV;
+    for (auto const& pair: _kvMap) {
+        if (boost::starts_with(pair.first, pfx)) {
+            retV.insert(pair);
+        }
+    }
+    LOGS(_log, LOG_LVL_DEBUG, "got: " << retV.size() << " keys");
+    return retV;
+}
+
 void
 KvInterfaceImplMem::deleteKey(string const& key) {
     LOGS(_log, LOG_LVL_DEBUG, "deleteKey(" << key << ")");
@@ -295,6 +327,73 @@ std::string KvInterfaceImplMem::dumpKV(std::string const& key) {
     return str.str();
 }
 
+void KvInterfaceImplMem::dumpSnapshot(std::string const& filename) const {
+    std::ofstream f(filename.c_str(), std::ios::binary | std::ios::trunc);
+    if (f.fail()) {
+        throw CssError("KvInterfaceImplMem - failed to create snapshot file " + filename);
+    }
+
+    ::SnapshotHeader hdr{::snapshotMagic, ::snapshotVersion, _kvMap.size()};
+    f.write(reinterpret_cast<char const*>(&hdr), sizeof hdr);
+    for (auto const& pair: _kvMap) {
+        uint32_t len = pair.first.size();
+        f.write(reinterpret_cast<char const*>(&len), sizeof len);
+        f.write(pair.first.data(), len);
+        len = pair.second.size();
+        f.write(reinterpret_cast<char const*>(&len), sizeof len);
+        f.write(pair.second.data(), len);
+    }
+    if (f.fail()) {
+        throw CssError("KvInterfaceImplMem - failed to write snapshot file " + filename);
+    }
+}
+
+std::shared_ptr<KvInterfaceImplMem>
+KvInterfaceImplMem::loadSnapshot(std::string const& filename, bool readOnly) {
+    // slurp the whole file in one read, snapshots are small
+    std::ifstream f(filename.c_str(), std::ios::binary);
+    if (f.fail()) {
+        throw CssError("KvInterfaceImplMem - failed to open snapshot file " + filename);
+    }
+    std::string data((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+
+    if (data.size() < sizeof(::SnapshotHeader)) {
+        throw CssError("KvInterfaceImplMem - truncated snapshot file " + filename);
+    }
+    ::SnapshotHeader hdr;
+    memcpy(&hdr, data.data(), sizeof hdr);
+    if (hdr.magic != ::snapshotMagic or hdr.version != ::snapshotVersion) {
+        throw CssError("KvInterfaceImplMem - not a snapshot file: " + filename);
+    }
+
+    auto kvi = std::make_shared<KvInterfaceImplMem>();
+    std::string::size_type pos = sizeof hdr;
+    auto const readString = [&](std::string& str) {
+        uint32_t len;
+        if (pos + sizeof len > data.size()) {
+            throw CssError("KvInterfaceImplMem - truncated snapshot file " + filename);
+        }
+        memcpy(&len, data.data() + pos, sizeof len);
+        pos += sizeof len;
+        if (pos + len > data.size()) {
+            throw CssError("KvInterfaceImplMem - truncated snapshot file " + filename);
+        }
+        str.assign(data, pos, len);
+        pos += len;
+    };
+    std::string key, value;
+    for (uint64_t i = 0; i < hdr.numRecords; ++ i) {
+        readString(key);
+        readString(value);
+        // records are stored in key order, so the end of the map is
+        // always the right insertion hint
+        kvi->_kvMap.insert(kvi->_kvMap.end(), std::make_pair(key, value));
+    }
+    // read-only should only be set after the map is filled
+    kvi->_readOnly = readOnly;
+    return kvi;
+}
+
 void KvInterfaceImplMem::_init(std::istream& mapStream) {
     if (mapStream.fail()) {
         throw ConnError();
@@ -62,9 +62,22 @@ public:
     virtual std::map<std::string, std::string> getMany(std::vector<std::string> const& keys) override;
     virtual std::vector<std::string> getChildren(std::string const& key) override;
     virtual std::map<std::string, std::string> getChildrenValues(std::string const& key) override;
+    virtual std::map<std::string, std::string> getSubtree(std::string const& key) override;
     virtual void deleteKey(std::string const& key) override;
     virtual std::string dumpKV(std::string const& key=std::string()) override;
 
+    /// Write a compact binary snapshot of the whole key-value map to a file,
+    /// readable with loadSnapshot(). Loading a snapshot is much faster than
+    /// replaying the JSON stream accepted by the constructors, so snapshots
+    /// are the preferred bootstrap format for tests and local czars.
+    void dumpSnapshot(std::string const& filename) const;
+
+    /// @return a new instance initialized from a snapshot file produced
+    /// by dumpSnapshot()
+    /// @throws CssError if the file cannot be read or is not a valid snapshot
+    static std::shared_ptr<KvInterfaceImplMem> loadSnapshot(std::string const& filename,
+                                                            bool readOnly=false);
+
     std::shared_ptr<KvInterfaceImplMem> clone() const;
 
 protected:
@@ -38,6 +38,7 @@
 #include <fstream>
 #include <iomanip>
 #include <iostream>
+#include <memory>
 #include <sstream>
 #include <stdexcept>
 
@@ -124,12 +125,15 @@ class KvTransaction
 public:
     // Constructors
     KvTransaction(sql::SqlConnection& conn)
-        : _errObj(), _trans(conn, _errObj) {
+        : _conn(conn), _errObj(), _trans(conn, _errObj) {
         if (_errObj.isSet()) {
             throw CssError(_errObj);
         }
     }
 
+    /// @return the connection this transaction runs on
+    sql::SqlConnection& conn() const { return _conn; }
+
     // Destructor
     ~KvTransaction() {
         // instead of just destroying SqlTransaction instance we call abort and see
@@ -169,13 +173,19 @@ public:
     }
 
 private:
+    sql::SqlConnection& _conn;
     sql::SqlErrorObject _errObj; // this must be declared before _trans
     sql::SqlTransaction _trans;
 };
 
 
 KvInterfaceImplMySql::KvInterfaceImplMySql(mysql::MySqlConfig const& mysqlConf, bool readOnly)
-: _conn(mysqlConf), _readOnly(readOnly) {
+: KvInterfaceImplMySql(std::make_shared<sql::SqlConnectionPool>(mysqlConf), readOnly) {
+}
+
+
+KvInterfaceImplMySql::KvInterfaceImplMySql(sql::SqlConnectionPool::Ptr const& connPool, bool readOnly)
+: _connPool(connPool), _readOnly(readOnly) {
 }
 
 
@@ -205,10 +215,10 @@ KvInterfaceImplMySql::_findParentId(std::string const& childKvKey, bool* hasPare
 
     size_t loc = childKvKey.find_last_of(KEY_PATH_DELIMITER);
     std::string const parentKey(childKvKey, 0, loc);
-    std::string query = str(boost::format("SELECT kvId FROM kvData WHERE kvKey='%1%'") % _escapeSqlString(parentKey));
+    std::string query = str(boost::format("SELECT kvId FROM kvData WHERE kvKey='%1%'") % _escapeSqlString(parentKey, transaction.conn()));
     sql::SqlResults results;
     sql::SqlErrorObject errObj;
-    if (not _conn.runQuery(query, results, errObj)) {
+    if (not transaction.conn().runQuery(query, results, errObj)) {
         LOGS(_log, LOG_LVL_ERROR, "_findParentId - query failed: " << query);
         throw CssError(errObj);
     } else {
@@ -229,7 +239,8 @@ KvInterfaceImplMySql::create(std::string const& key, std::string const& value, b
     }
 
     // key is validated by _create
-    KvTransaction transaction(_conn);
+    sql::SqlConnectionPool::Lease lease(_connPool);
+    KvTransaction transaction(lease.conn());
 
     std::string path = norm_key(key);
     if (unique) {
@@ -242,13 +253,13 @@ KvInterfaceImplMySql::create(std::string const& key, std::string const& value, b
         // substring operations. This may kill indexing so it's not very efficient.
         const char* qTemplate = "SELECT RIGHT(kvKey, 10) FROM kvData WHERE "
                         "LENGTH(kvKey) = %1%+10 AND LEFT(kvKey, %1%) = '%2%'";
-        std::string query = (boost::format(qTemplate)  % path.size() % _escapeSqlString(path)).str();
+        std::string query = (boost::format(qTemplate)  % path.size() % _escapeSqlString(path, transaction.conn())).str();
 
         // run query
         sql::SqlErrorObject errObj;
         sql::SqlResults results;
         LOGS(_log, LOG_LVL_DEBUG, "create - executing query: " << query);
-        if (not _conn.runQuery(query, results, errObj)) {
+        if (not transaction.conn().runQuery(query, results, errObj)) {
             std::stringstream ss;
             ss << "create - " << query << " failed with err: " << errObj.errMsg() << std::ends;
             LOGS(_log, LOG_LVL_ERROR, ss.str());
@@ -305,17 +316,17 @@ KvInterfaceImplMySql::_create(std::string const& key, std::string const& value,
     boost::format fmQuery;
     if (hasParent) {
         fmQuery = boost::format("INSERT INTO kvData (kvKey, kvVal, parentKvId) VALUES ('%1%', '%2%', '%3%')");
-        fmQuery % _escapeSqlString(key) % _escapeSqlString(value) % parentKvId;
+        fmQuery % _escapeSqlString(key, transaction.conn()) % _escapeSqlString(value, transaction.conn()) % parentKvId;
     } else {
         fmQuery = boost::format("INSERT INTO kvData (kvKey, kvVal) VALUES ('%1%', '%2%')"); // leave parentKvId NULL
-        fmQuery % _escapeSqlString(key) % _escapeSqlString(value);
+        fmQuery % _escapeSqlString(key, transaction.conn()) % _escapeSqlString(value, transaction.conn());
     }
     if (updateIfExists) {
-        fmQuery = boost::format("%1% ON DUPLICATE KEY UPDATE kvVal='%2%'") % fmQuery % _escapeSqlString(value);
+        fmQuery = boost::format("%1% ON DUPLICATE KEY UPDATE kvVal='%2%'") % fmQuery % _escapeSqlString(value, transaction.conn());
     }
     std::string query = fmQuery.str();
     sql::SqlErrorObject errObj;
-    if (not _conn.runQuery(query, errObj)) {
+    if (not transaction.conn().runQuery(query, errObj)) {
         switch (errObj.errNo()) {
         default:
             throw CssError(errObj);
@@ -328,7 +339,7 @@ KvInterfaceImplMySql::_create(std::string const& key, std::string const& value,
         }
     }
 
-    unsigned int kvId = _conn.getInsertId();
+    unsigned int kvId = transaction.conn().getInsertId();
     LOGS(_log, LOG_LVL_DEBUG, "_create - executed query: " << query << ", kvId is:" << kvId);
     return kvId;
 }
@@ -341,7 +352,8 @@ KvInterfaceImplMySql::set(std::string const& key, std::string const& value) {
     }
 
     // key is validated by _create
-    KvTransaction transaction(_conn);
+    sql::SqlConnectionPool::Lease lease(_connPool);
+    KvTransaction transaction(lease.conn());
     _create(norm_key(key), value, true, transaction);
     transaction.commit();
 }
@@ -349,12 +361,23 @@ KvInterfaceImplMySql::set(std::string const& key, std::string const& value) {
 
 bool
 KvInterfaceImplMySql::exists(std::string const& key) {
-    KvTransaction transaction(_conn);
-    std::string query = str(boost::format("SELECT COUNT(*) FROM kvData WHERE kvKey='%1%'") % _escapeSqlString(key));
+    sql::SqlConnectionPool::Lease lease(_connPool);
+    KvTransaction transaction(lease.conn());
+    bool const ret = _exists(key, lease.conn());
+    transaction.commit();
+    return ret;
+}
+
+
+bool
+KvInterfaceImplMySql::_exists(std::string const& key, sql::SqlConnection& conn) {
+    // no transaction of its own so that it can be called on a connection
+    // with an active transaction
+    std::string query = str(boost::format("SELECT COUNT(*) FROM kvData WHERE kvKey='%1%'") % _escapeSqlString(key, conn));
     sql::SqlErrorObject errObj;
     sql::SqlResults results;
     LOGS(_log, LOG_LVL_DEBUG, "exists - executing query: " << query);
-    if (not _conn.runQuery(query, results, errObj)) {
+    if (not conn.runQuery(query, results, errObj)) {
         std::stringstream ss;
         ss << "exists - " << query << " failed with err: " << errObj.errMsg() << std::ends;
         LOGS(_log, LOG_LVL_ERROR, ss.str());
@@ -369,7 +392,6 @@ KvInterfaceImplMySql::exists(std::string const& key) {
     if (count > 1) {
         throw CssError("multiple keys for key");
     }
-    transaction.commit();
     return 1 == count;
 }
 
@@ -379,6 +401,9 @@ KvInterfaceImplMySql::getMany(std::vector<std::string> const& keys) {
         _validateKey(norm_key(key));
     }
 
+    sql::SqlConnectionPool::Lease lease(_connPool);
+    KvTransaction transaction(lease.conn());
+
     // build query
     std::string query = "SELECT kvKey, kvVal FROM kvData WHERE kvKey IN (";
     bool first = true;
@@ -386,17 +411,14 @@ KvInterfaceImplMySql::getMany(std::vector<std::string> const& keys) {
         if (not first) query += ", ";
         first = false;
         query += '"';
-        query += _escapeSqlString(norm_key(key));
+        query += _escapeSqlString(norm_key(key), transaction.conn());
         query += '"';
     }
     query += ')';
-
-    // run query
-    KvTransaction transaction(_conn);
     sql::SqlErrorObject errObj;
     sql::SqlResults results;
     LOGS(_log, LOG_LVL_DEBUG, "getMany - executing query: " << query);
-    if (not _conn.runQuery(query, results, errObj)) {
+    if (not transaction.conn().runQuery(query, results, errObj)) {
         std::stringstream ss;
         ss << "getMany - " << query << " failed with err: " << errObj.errMsg() << std::ends;
         LOGS(_log, LOG_LVL_ERROR, ss.str());
@@ -423,7 +445,8 @@ KvInterfaceImplMySql::getChildren(std::string const& parentKey) {
 
     _validateKey(key);
     // get the children with a /fully/qualified/path
-    KvTransaction transaction(_conn);
+    sql::SqlConnectionPool::Lease lease(_connPool);
+    KvTransaction transaction(lease.conn());
     std::vector<std::string> strVec = _getChildrenFullPath(key, transaction);
     transaction.commit();
 
@@ -448,10 +471,11 @@ KvInterfaceImplMySql::getChildrenValues(std::string const& parentKey) {
     _validateKey(key);
 
     // get the children with a /fully/qualified/path
-    KvTransaction transaction(_conn);
+    sql::SqlConnectionPool::Lease lease(_connPool);
+    KvTransaction transaction(lease.conn());
     unsigned int parentId;
     if (not _getIdFromServer(key, &parentId, transaction)) {
-        if (not exists(key)) {
+        if (not _exists(key, transaction.conn())) {
             throw NoSuchKey(parentKey);
         }
     }
@@ -460,7 +484,7 @@ KvInterfaceImplMySql::getChildrenValues(std::string const& parentKey) {
     sql::SqlErrorObject errObj;
     sql::SqlResults results;
     LOGS(_log, LOG_LVL_DEBUG, "getChildrenValues - executing query: " << query);
-    if (not _conn.runQuery(query, results, errObj)) {
+    if (not transaction.conn().runQuery(query, results, errObj)) {
         std::stringstream ss;
         ss << "getChildrenValues - " << query << " failed with err: "  << errObj.errMsg() << std::ends;
         LOGS(_log, LOG_LVL_ERROR, ss.str());
@@ -501,7 +525,7 @@ KvInterfaceImplMySql::_getChildrenFullPath(std::string const& parentKey, KvTrans
     _validateKey(parentKey);
     unsigned int parentId;
     if (not _getIdFromServer(parentKey, &parentId, transaction)) {
-        if (not exists(parentKey)) {
+        if (not _exists(parentKey, transaction.conn())) {
             throw NoSuchKey(parentKey);
         }
     }
@@ -510,7 +534,7 @@ KvInterfaceImplMySql::_getChildrenFullPath(std::string const& parentKey, KvTrans
     sql::SqlErrorObject errObj;
     sql::SqlResults results;
     LOGS(_log, LOG_LVL_DEBUG, "_getChildrenFullPath - executing query: " << query);
-    if (not _conn.runQuery(query, results, errObj)) {
+    if (not transaction.conn().runQuery(query, results, errObj)) {
         std::stringstream ss;
         ss << "_getChildrenFullPath - " << query << " failed with err: " << errObj.errMsg() << std::ends;
         LOGS(_log, LOG_LVL_ERROR, ss.str());
@@ -531,6 +555,51 @@ KvInterfaceImplMySql::_getChildrenFullPath(std::string const& parentKey, KvTrans
 }
 
 
+std::map<std::string, std::string>
+KvInterfaceImplMySql::getSubtree(std::string const& key) {
+    std::string path = norm_key(key);
+    _validateKey(path);
+
+    // Key can contain characters which are special to SQL pattern matching
+    // so instead of LIKE we compare fixed-length prefix of the key, same
+    // trick as in create() above.
+    sql::SqlConnectionPool::Lease lease(_connPool);
+    KvTransaction transaction(lease.conn());
+
+    std::string const pfx = path + "/";
+    const char* qTemplate = "SELECT kvKey, kvVal FROM kvData WHERE LEFT(kvKey, %1%) = '%2%'";
+    std::string query = (boost::format(qTemplate) % pfx.size() % _escapeSqlString(pfx, transaction.conn())).str();
+    sql::SqlErrorObject errObj;
+    sql::SqlResults results;
+    LOGS(_log, LOG_LVL_DEBUG, "getSubtree - executing query: " << query);
+    if (not transaction.conn().runQuery(query, results, errObj)) {
+        std::stringstream ss;
+        ss << "getSubtree - " << query << " failed with err: " << errObj.errMsg() << std::ends;
+        LOGS(_log, LOG_LVL_ERROR, ss.str());
+        throw CssError(ss.str());
+    }
+
+    // copy results
+    std::map<std::string, std::string> res;
+    for (auto& row: results) {
+        // row is the vector of pair<char const*, unsigned long>
+        // key cannot be NULL, but value could be?
+        const char* rowKey = row[0].first;
+        const char* val = row[1].first ? row[1].first : "";
+        res.insert(std::make_pair(rowKey, val));
+    }
+
+    transaction.commit();
+
+    // empty subtree is indistinguishable from missing key, check the key
+    // itself before complaining (root key always "exists")
+    if (res.empty() and not path.empty() and not _exists(path, lease.conn())) {
+        throw NoSuchKey(path);
+    }
+    return res;
+}
+
+
 void
 KvInterfaceImplMySql::deleteKey(std::string const& keyArg) {
     if (_readOnly) {
@@ -538,7 +607,8 @@ KvInterfaceImplMySql::deleteKey(std::string const& keyArg) {
     }
 
     std::string key = norm_key(keyArg);
-    KvTransaction transaction(_conn);
+    sql::SqlConnectionPool::Lease lease(_connPool);
+    KvTransaction transaction(lease.conn());
     _delete(key, transaction);
     transaction.commit();
 }
@@ -550,11 +620,12 @@ std::string KvInterfaceImplMySql::dumpKV(std::string const& key) {
     std::string query = "SELECT kvKey, kvVal FROM kvData ORDER BY kvKey";
 
     // run query
-    KvTransaction transaction(_conn);
+    sql::SqlConnectionPool::Lease lease(_connPool);
+    KvTransaction transaction(lease.conn());
     sql::SqlErrorObject errObj;
     sql::SqlResults results;
     LOGS(_log, LOG_LVL_DEBUG, "dumpKV - executing query: " << query);
-    if (not _conn.runQuery(query, results, errObj)) {
+    if (not transaction.conn().runQuery(query, results, errObj)) {
         std::stringstream ss;
         ss << "dumpKV - " << query << " failed with err: " << errObj.errMsg() << std::ends;
         LOGS(_log, LOG_LVL_ERROR, ss.str());
@@ -600,11 +671,11 @@ KvInterfaceImplMySql::_delete(std::string const& key, KvTransaction const& trans
         _delete(*strItr, transaction);
     }
 
-    std::string query = str(boost::format("DELETE FROM kvData WHERE kvKey='%1%'") % _escapeSqlString(key));
+    std::string query = str(boost::format("DELETE FROM kvData WHERE kvKey='%1%'") % _escapeSqlString(key, transaction.conn()));
     sql::SqlErrorObject errObj;
     sql::SqlResults resultsObj;
     LOGS(_log, LOG_LVL_DEBUG, "deleteKey - executing query: " << query);
-    if (not _conn.runQuery(query, resultsObj, errObj)) {
+    if (not transaction.conn().runQuery(query, resultsObj, errObj)) {
         LOGS(_log, LOG_LVL_ERROR, "deleteKey - " << query << " failed with err: " << errObj.errMsg());
         throw CssError(errObj);
     }
@@ -628,13 +699,14 @@ KvInterfaceImplMySql::_get(std::string const& keyArg, std::string const& default
 
     std::string key = norm_key(keyArg);
 
-    KvTransaction transaction(_conn);
+    sql::SqlConnectionPool::Lease lease(_connPool);
+    KvTransaction transaction(lease.conn());
 
     std::string val;
     sql::SqlErrorObject errObj;
-    std::string query = str(boost::format("SELECT kvVal FROM kvData WHERE kvKey='%1%'") % _escapeSqlString(key));
+    std::string query = str(boost::format("SELECT kvVal FROM kvData WHERE kvKey='%1%'") % _escapeSqlString(key, transaction.conn()));
     sql::SqlResults results;
-    if (not _conn.runQuery(query, results, errObj)) {
+    if (not transaction.conn().runQuery(query, results, errObj)) {
         LOGS(_log, LOG_LVL_ERROR, "_get - query failed: " << query);
         throw CssError(errObj);
     } else {
@@ -659,10 +731,10 @@ bool KvInterfaceImplMySql::_getIdFromServer(std::string const& key, unsigned int
         throw CssError("A transaction must active here.");
     }
 
-    std::string query = str(boost::format("SELECT kvId FROM kvData WHERE kvKey='%1%'") % _escapeSqlString(key));
+    std::string query = str(boost::format("SELECT kvId FROM kvData WHERE kvKey='%1%'") % _escapeSqlString(key, transaction.conn()));
     sql::SqlResults results;
     sql::SqlErrorObject errObj;
-    if (not _conn.runQuery(query, results, errObj)) {
+    if (not transaction.conn().runQuery(query, results, errObj)) {
         LOGS(_log, LOG_LVL_ERROR, "_getIdFromServer - query failed: " << query);
         throw CssError(errObj);
         return false;
@@ -695,12 +767,12 @@ void KvInterfaceImplMySql::_validateKey(std::string const& key) {
 }
 
 
-std::string KvInterfaceImplMySql::_escapeSqlString(std::string const& str) {
+std::string KvInterfaceImplMySql::_escapeSqlString(std::string const& str, sql::SqlConnection& conn) {
     // There is no need for a transaction here.
 
     sql::SqlErrorObject errObj;
     std::string escapedStr;
-    if (not _conn.escapeString(str, escapedStr, errObj)) {
+    if (not conn.escapeString(str, escapedStr, errObj)) {
         throw CssError(errObj);
     }
     return escapedStr;
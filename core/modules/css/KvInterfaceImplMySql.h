@@ -41,7 +41,7 @@
 // Local headers
 #include "css/KvInterface.h"
 #include "mysql/MySqlConfig.h"
-#include "sql/SqlConnection.h"
+#include "sql/SqlConnectionPool.h"
 
 namespace lsst {
 namespace qserv {
@@ -56,6 +56,12 @@ public:
      *  @param mysqlConf: Configuration object for mysql connection
      */
     explicit KvInterfaceImplMySql(mysql::MySqlConfig const& mysqlConf, bool readOnly=false);
+
+    /**
+     *  @param connPool: Connection pool, may be shared with other clients
+     *                   of the same database.
+     */
+    explicit KvInterfaceImplMySql(sql::SqlConnectionPool::Ptr const& connPool, bool readOnly=false);
     virtual ~KvInterfaceImplMySql() {};
 
     virtual std::string create(std::string const& key, std::string const& value,
@@ -71,6 +77,8 @@ public:
 
     virtual std::map<std::string, std::string> getChildrenValues(std::string const& key) override;
 
+    virtual std::map<std::string, std::string> getSubtree(std::string const& key) override;
+
     virtual void deleteKey(std::string const& key) override;
 
     virtual std::string dumpKV(std::string const& key=std::string()) override;
@@ -129,13 +137,21 @@ private:
     /**
      * @brief Escape a string for sql.
      * @param value will be escaped as needed
-     * Will connect to the local connection if needed.
+     * Will connect to the given connection if needed.
      * @throws CssErrror if connection fails
      * @return the escaped string
      */
-    std::string _escapeSqlString(std::string const& str);
+    std::string _escapeSqlString(std::string const& str, sql::SqlConnection& conn);
+
+    /**
+     * @brief Check whether the key exists.
+     *
+     * Unlike public exists() this does not start its own transaction so it
+     * can be called on a connection with an active transaction.
+     */
+    bool _exists(std::string const& key, sql::SqlConnection& conn);
 
-    sql::SqlConnection _conn;
+    sql::SqlConnectionPool::Ptr _connPool;
     bool _readOnly;
 };
 
@@ -40,6 +40,12 @@ int const VERSION = 1; ///< Current supported version (integer)
 // conversions I define this string once and use it with kvInterface
 char const VERSION_STR[] = "1"; ///< Current supported version
 
+/// Path to the generation counter which is bumped by CssAccess on every
+/// CSS update. Instances which cache CSS data in a memory snapshot compare
+/// the stored value against the one seen at snapshot time to detect that
+/// the snapshot needs a refresh.
+char const GENERATION_KEY[] = "/css_meta/generation";
+
 // Set of values used for database and table status.
 
 /// This status means CSS data is in inconsistent state, do not use.
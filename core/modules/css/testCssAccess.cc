@@ -840,4 +840,43 @@ BOOST_AUTO_TEST_CASE(testCssVersion) {
 
 BOOST_AUTO_TEST_SUITE_END()
 
+// Test fixture which forces snapshot caching even for memory-based store
+class CssAccessSnapshotFixture: public CssAccess {
+public:
+    CssAccessSnapshotFixture()
+        : CssAccess(initKVI(), make_shared<EmptyChunks>(), "", true) {}
+
+    ~CssAccessSnapshotFixture() {}
+};
+
+BOOST_FIXTURE_TEST_SUITE(CssAccessSnapshotTestSuite, CssAccessSnapshotFixture)
+
+BOOST_AUTO_TEST_CASE(testSnapshotReads) {
+    // regular reads are served from the snapshot
+    auto names = getDbNames();
+    BOOST_CHECK_EQUAL(names.size(), 3U);
+    BOOST_CHECK(containsDb("dbA"));
+    auto params = getPartTableParams("dbA", "Object");
+    BOOST_CHECK_EQUAL(params.lonColName, "ra_PS");
+}
+
+BOOST_AUTO_TEST_CASE(testSnapshotRefresh) {
+    // this loads the snapshot
+    BOOST_CHECK(not containsDb("dbNew"));
+
+    // update storage behind CssAccess's back, without a generation
+    // bump the change stays invisible to reads
+    getKvI()->create("/DBS/dbNew", KEY_STATUS_READY);
+    BOOST_CHECK(not containsDb("dbNew"));
+
+    // any update through CssAccess bumps the generation and drops the
+    // snapshot, next read re-loads it and sees the direct update too
+    setDbStatus("dbA", "DEAD");
+    BOOST_CHECK(containsDb("dbNew"));
+    auto statMap = getDbStatus();
+    BOOST_CHECK_EQUAL(statMap["dbA"], "DEAD");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
 }}} // namespace lsst::qserv::css
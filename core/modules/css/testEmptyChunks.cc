@@ -122,6 +122,37 @@ BOOST_AUTO_TEST_CASE(Basic) {
     BOOST_CHECK(ec.isEmpty("TestTwo", 103));
     BOOST_CHECK(ec.isEmpty("Default", 1003));
 
+    auto bitmap = ec.getEmptyBitmap("TestOne");
+    BOOST_CHECK(bitmap->contains(3));
+    BOOST_CHECK(!bitmap->contains(103));
+    BOOST_CHECK(!bitmap->contains(-1));
+    BOOST_CHECK(!bitmap->contains(1 << 30));
+}
+
+BOOST_AUTO_TEST_CASE(UpdateCache) {
+    EmptyChunks ec(dummyFile._path, dummyFile._fallback);
+
+    // Updating a database which is not cached yet is a no-op; the first
+    // lookup still loads the on-disk state.
+    ec.updateCache("TestOne", {500}, {3});
+    auto before = ec.getEmptyBitmap("TestOne");
+    BOOST_CHECK(before->contains(3));
+    BOOST_CHECK(!before->contains(500));
+
+    // An update beyond the current bitmap size grows it.
+    ec.updateCache("TestOne", {500}, {3});
+    auto after = ec.getEmptyBitmap("TestOne");
+    BOOST_CHECK(!after->contains(3));
+    BOOST_CHECK(after->contains(4));
+    BOOST_CHECK(after->contains(500));
+
+    // The previously obtained snapshot is untouched.
+    BOOST_CHECK(before->contains(3));
+    BOOST_CHECK(!before->contains(500));
+
+    // Removals outside of the bitmap are ignored.
+    ec.updateCache("TestOne", {}, {-1, 1 << 20});
+    BOOST_CHECK(ec.isEmpty("TestOne", 500));
 }
 
 BOOST_AUTO_TEST_SUITE_END()
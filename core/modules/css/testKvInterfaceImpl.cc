@@ -36,13 +36,16 @@
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
+#include <fstream>
 #include <string.h>  // memset
 #include <time.h>    // time
+#include <unistd.h>  // unlink
 
 // Third-party headers
 #include "boost/lexical_cast.hpp"
 
 // Qserv headers
+#include "css/CssError.h"
 #include "css/KvInterfaceImplMem.h"
 #include "css/KvInterfaceImplMySql.h"
 
@@ -80,6 +83,12 @@ struct KvInterfaceFixture {
         BOOST_CHECK(v[0]=="xyzA");
         BOOST_CHECK(v[1]=="xyzB");
 
+        std::map<std::string, std::string> subtree = kvI->getSubtree(prefix);
+        BOOST_CHECK(2 == subtree.size());
+        BOOST_CHECK(subtree[k1] == v1);
+        BOOST_CHECK(subtree[k2] == v2);
+        BOOST_CHECK_THROW(kvI->getSubtree(k3), lsst::qserv::css::NoSuchKey);
+
         kvI->deleteKey(k1);
         BOOST_CHECK(kvI->get(k1, "xyz4") == "xyz4");
 
@@ -110,4 +119,36 @@ BOOST_AUTO_TEST_CASE(testMem) {
     doIt(new lsst::qserv::css::KvInterfaceImplMem());
 }
 
+BOOST_AUTO_TEST_CASE(testMemSnapshot) {
+    std::cout << "========== Testing MEM snapshot ==========\n";
+
+    lsst::qserv::css::KvInterfaceImplMem kvI;
+    kvI.create(prefix, v1);
+    kvI.create(k1, v1);
+    kvI.create(k2, "");
+    kvI.create(k3, std::string("binary\0value", 12));
+
+    std::string const snapshot = "/tmp" + prefix + ".snapshot";
+    kvI.dumpSnapshot(snapshot);
+
+    auto kvI2 = lsst::qserv::css::KvInterfaceImplMem::loadSnapshot(snapshot, true);
+    BOOST_CHECK_EQUAL(kvI2->get(prefix), v1);
+    BOOST_CHECK_EQUAL(kvI2->get(k1), v1);
+    BOOST_CHECK_EQUAL(kvI2->get(k2), "");
+    BOOST_CHECK_EQUAL(kvI2->get(k3), std::string("binary\0value", 12));
+    BOOST_CHECK_EQUAL(kvI2->getChildren(prefix).size(), 3U);
+    BOOST_CHECK_THROW(kvI2->set(k1, v2), lsst::qserv::css::ReadonlyCss);
+
+    // not a snapshot and missing files must be rejected
+    std::string const junk = snapshot + ".junk";
+    std::ofstream(junk.c_str()) << "not a snapshot";
+    BOOST_CHECK_THROW(lsst::qserv::css::KvInterfaceImplMem::loadSnapshot(junk),
+                      lsst::qserv::css::CssError);
+    BOOST_CHECK_THROW(lsst::qserv::css::KvInterfaceImplMem::loadSnapshot(snapshot + ".missing"),
+                      lsst::qserv::css::CssError);
+
+    unlink(junk.c_str());
+    unlink(snapshot.c_str());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
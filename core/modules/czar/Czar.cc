@@ -24,6 +24,9 @@
 #include "czar/Czar.h"
 
 // System headers
+#include <chrono>
+#include <csignal>
+#include <sstream>
 #include <sys/time.h>
 #include <thread>
 
@@ -36,12 +39,22 @@
 
 // Qserv headers
 #include "ccontrol/ConfigMap.h"
+#include "ccontrol/UserQuerySelect.h"
 #include "ccontrol/UserQueryType.h"
 #include "czar/CzarErrors.h"
 #include "czar/MessageTable.h"
+#include "czar/QueryAdmission.h"
+#include "czar/QueryResultCache.h"
+#include "qdisp/ChunkLocationCache.h"
+#include "qdisp/MessageStore.h"
+#include "qdisp/WorkerHealthRegistry.h"
+#include "qhttp/MetricsServer.h"
 #include "rproc/InfileMerger.h"
 #include "sql/SqlConnection.h"
+#include "util/FlightRecorder.h"
 #include "util/IterableFormatter.h"
+#include "util/Mutex.h"
+#include "util/ObjectCensus.h"
 #include "XrdSsi/XrdSsiProvider.hh"
 
 
@@ -59,6 +72,11 @@ std::string const createAsyncResultTmpl("CREATE TABLE IF NOT EXISTS %1% "
 
 LOG_LOGGER _log = LOG_GET("lsst.qserv.czar.Czar");
 
+// How long a database stays warm after warmUpDatabase() before a new
+// connect triggers another warm-up pass. Metadata in active use stays
+// resident on its own; this only bounds the cost of reconnect storms.
+std::chrono::minutes const warmUpInterval(5);
+
 } // anonymous namespace
 
 namespace lsst {
@@ -102,15 +120,100 @@ Czar::Czar(std::string const& configPath, std::string const& czarName)
     LOGS(_log, LOG_LVL_INFO, "Creating czar instance with name " << czarName);
     LOGS(_log, LOG_LVL_DEBUG, "Czar config: " << _czarConfig);
 
+    // SIGUSR2 dumps per-callsite lock contention counters to the log
+    util::LockContention::logOnSignal(SIGUSR2);
+
     _uqFactory.reset(new ccontrol::UserQueryFactory(_czarConfig, _czarName));
+
+    if (_czarConfig.getResultCacheMaxQueries() > 0) {
+        _resultCache = std::make_shared<QueryResultCache>(
+                _czarConfig.getMySqlResultConfig(),
+                _czarConfig.getResultCacheMaxQueries(),
+                _czarConfig.getResultCacheMaxAgeSec());
+        LOGS(_log, LOG_LVL_INFO, "Result cache enabled, retaining up to "
+             << _czarConfig.getResultCacheMaxQueries() << " result tables");
+    }
+
+    if (_czarConfig.getAdmissionMaxQueries() > 0) {
+        _admission = std::make_shared<QueryAdmission>(
+                _czarConfig.getAdmissionMaxQueries(),
+                _czarConfig.getAdmissionMaxUserQueries());
+        LOGS(_log, LOG_LVL_INFO, "Admission control enabled, at most "
+             << _czarConfig.getAdmissionMaxQueries() << " concurrent queries ("
+             << _czarConfig.getAdmissionMaxUserQueries() << " per user, 0: no cap)");
+    }
+
+    if (_czarConfig.getMetricsPort() > 0) {
+        _startMetricsServer(_czarConfig.getMetricsPort());
+    }
+}
+
+void Czar::_startMetricsServer(int port) {
+    _metricsServer = qhttp::MetricsServer::create(port);
+
+    // The qdisp pool lane depths are read from a lock-free snapshot and the
+    // queue-wait percentiles from the histogram shards, so scrapes never
+    // contend with response dispatch.
+    auto qdispPool = _qdispPool;
+    _metricsServer->addSource([qdispPool](std::ostream& os) {
+        for (auto const& lane : qdispPool->laneStats()) {
+            std::string const labels = "priority=\"" + std::to_string(lane.priority) + "\"";
+            qhttp::MetricsServer::writeMetric(os, "qserv_czar_qdisp_queue_size", labels,
+                                              static_cast<uint64_t>(lane.size));
+            qhttp::MetricsServer::writeMetric(os, "qserv_czar_qdisp_running", labels,
+                                              static_cast<uint64_t>(lane.running));
+        }
+        qdispPool->queueWaitHistogram().writePrometheus(os, "qserv_czar_qdisp_queue_wait_ms");
+    });
+
+    _metricsServer->addSource([](std::ostream& os) {
+        rproc::InfileMerger::mergeHistogram().writePrometheus(os, "qserv_czar_merge_ms");
+    });
+
+    // Live-object counts from the census: one relaxed atomic read per
+    // registered class.
+    _metricsServer->addSource([](std::ostream& os) {
+        for (auto const& entry : util::ObjectCensus::get().snapshot()) {
+            std::string const labels = "class=\"" + entry.first + "\"";
+            qhttp::MetricsServer::writeMetric(os, "qserv_czar_live_objects", labels,
+                                              static_cast<uint64_t>(entry.second));
+        }
+    });
+
+    // Per-worker health as seen from this czar: response-time and failure
+    // EWMAs and the combined score the Executive shapes dispatch with.
+    _metricsServer->addSource([](std::ostream& os) {
+        for (auto const& entry : qdisp::WorkerHealthRegistry::get().snapshot()) {
+            std::string const labels = "worker=\"" + entry.first + "\"";
+            qhttp::MetricsServer::writeMetric(os, "qserv_czar_worker_latency_ms", labels,
+                                              entry.second.latencyMs);
+            qhttp::MetricsServer::writeMetric(os, "qserv_czar_worker_failure_rate", labels,
+                                              entry.second.failureRate);
+            qhttp::MetricsServer::writeMetric(os, "qserv_czar_worker_health_score", labels,
+                                              entry.second.score);
+        }
+    });
+
+    // Dump of the flight-recorder event ring for post-hoc diagnosis of
+    // recent queries; readers copy slots without locking, so the dump is
+    // safe against the query path.
+    _metricsServer->addHandler("GET", "/flightrecorder",
+            [](qhttp::Request::Ptr request, qhttp::Response::Ptr response) {
+        std::ostringstream os;
+        util::FlightRecorder::dump(os);
+        response->headers["Cache-Control"] = "no-cache";
+        response->send(os.str(), "text/plain");
+    });
+
+    _metricsServer->start();
+    LOGS(_log, LOG_LVL_INFO, "Serving /metrics on port " << _metricsServer->getPort());
 }
 
 SubmitResult
 Czar::submitQuery(std::string const& query,
                   std::map<std::string, std::string> const& hints) {
 
-    LOGS(_log, LOG_LVL_INFO, "New query: " << query
-         << ", hints: " << util::printable(hints));
+    LOGS(_log, LOG_LVL_DEBUG, "query hints: " << util::printable(hints));
 
     util::ConfigStore hintsConfigStore(hints);
 
@@ -123,8 +226,47 @@ Czar::submitQuery(std::string const& query,
     int threadId = hintsConfigStore.getInt("server_thread_id", -1);
 
     std::string defaultDb = hintsConfigStore.get("db");
+
+    return submitQuery(query, clientId, threadId, defaultDb);
+}
+
+SubmitResult
+Czar::submitQuery(std::string const& query,
+                  std::string const& clientId,
+                  int threadId,
+                  std::string const& defaultDb) {
+
+    LOGS(_log, LOG_LVL_INFO, "New query: " << query
+         << ", client: " << clientId << ", threadId: " << threadId);
     LOGS(_log, LOG_LVL_INFO, "Default database is \"" << defaultDb <<"\"");
 
+    // statements that change the data behind retained results flush the
+    // result cache before anything else happens
+    if (_resultCache != nullptr) {
+        std::string db, table;
+        if (ccontrol::UserQueryType::isFlushChunksCache(query, db)
+            or ccontrol::UserQueryType::isDropDb(query, db)
+            or ccontrol::UserQueryType::isDropTable(query, db, table)) {
+            _resultCache->invalidateAll();
+        }
+    }
+
+    // a chunk cache flush means the replication system changed chunk
+    // placement - forget the cached chunk locations of the affected
+    // database so new dispatches negotiate fresh locations
+    {
+        std::string db;
+        IntVector addedEmpty, removedEmpty;
+        if (ccontrol::UserQueryType::isFlushChunksCache(query, db)
+            or ccontrol::UserQueryType::isFlushChunksCacheDelta(query, db, addedEmpty, removedEmpty)) {
+            if (db.empty()) {
+                qdisp::ChunkLocationCache::get().invalidateAll();
+            } else {
+                qdisp::ChunkLocationCache::get().invalidateDb(db);
+            }
+        }
+    }
+
     // make message table name
     std::string userQueryId = std::to_string(_idCounter++);
     LOGS(_log, LOG_LVL_DEBUG, "userQueryId: " << userQueryId);
@@ -132,10 +274,18 @@ Czar::submitQuery(std::string const& query,
     std::string const msgTableName = "message_" + userQueryId;
     std::string const lockName = resultDb + "." + msgTableName;
 
+    // ASYNC queries are submitted without blocking the caller, recognizing
+    // the "SUBMIT" syntax is all that happens on this thread
+    std::string stripped;
+    if (ccontrol::UserQueryType::isSubmit(query, stripped)) {
+        return _submitQueryAsync(query, clientId, threadId, defaultDb, userQueryId);
+    }
+
     SubmitResult result;
 
     // instantiate message table manager
-    MessageTable msgTable(lockName, _czarConfig.getMySqlResultConfig());
+    MessageTable msgTable(lockName, _czarConfig.getMySqlResultConfig(),
+                          _czarConfig.getMessageTableErrorsOnly());
     try {
         msgTable.lock();
     } catch (std::exception const& exc) {
@@ -143,13 +293,34 @@ Czar::submitQuery(std::string const& query,
         return result;
     }
 
+    // repeated identical query: point the proxy at the retained result
+    // table of the previous run instead of re-dispatching
+    if (_resultCache != nullptr) {
+        auto cached = _resultCache->lookup(query, defaultDb);
+        if (cached != nullptr) {
+            try {
+                // release the message table empty, there is nothing to report
+                msgTable.unlock(ccontrol::UserQuery::Ptr());
+            } catch (std::exception const& exc) {
+                result.errorMessage = exc.what();
+                return result;
+            }
+            result.resultTable = cached->resultTable;
+            result.messageTable = lockName;
+            result.orderBy = cached->orderBy;
+            LOGS(_log, LOG_LVL_INFO, "Result cache hit, returning retained table "
+                 << result.resultTable);
+            return result;
+        }
+    }
 
     // make new UserQuery
     // this is atomic
     ccontrol::UserQuery::Ptr uq;
     {
         std::lock_guard<std::mutex> lock(_mutex);
-        uq = _uqFactory->newUserQuery(query, defaultDb, getQdispPool(), userQueryId, msgTableName);
+        uq = _uqFactory->newUserQuery(query, defaultDb, getQdispPool(), userQueryId, msgTableName,
+                                      clientId);
     }
     auto queryIdStr = uq->getQueryIdString();
 
@@ -162,10 +333,38 @@ Czar::submitQuery(std::string const& query,
 
     // spawn background thread to wait until query finishes to unlock,
     // note that lambda stores copies of uq and msgTable.
-    auto finalizer = [uq, msgTable]() mutable {
+    auto finalizer = [this, uq, msgTable, query, defaultDb, resultDb, clientId]() mutable {
+        // Admission gate: hold the query here until the global and
+        // per-user budgets allow it to run. The proxy is already waiting
+        // on the locked message table, so queueing on this thread does
+        // not block it; the queue wait is reported through the message
+        // table below.
+        QueryAdmission::Slot::Ptr admission;
+        if (_admission != nullptr) {
+            admission = _admission->admit(clientId.empty() ? "anonymous" : clientId);
+            if (admission->getQueueMs() > 0) {
+                uq->getMessageStore()->addMessage(-1, 1040,
+                        "Query queued by admission control for "
+                        + std::to_string(admission->getQueueMs()) + " ms at position "
+                        + std::to_string(admission->getQueuePosition() + 1));
+            }
+        }
         LOGS(_log, LOG_LVL_DEBUG, uq->getQueryIdString() << " submitting new query");
         uq->submit();
-        uq->join();
+        auto const state = uq->join();
+        // the query stopped consuming worker and merge resources, free
+        // the admission slot before the result bookkeeping below
+        admission.reset();
+        // retain results of successful plain SELECTs for identical
+        // resubmissions; the cast filters out process-list and other
+        // special queries whose results change between runs
+        if (state == ccontrol::SUCCESS and _resultCache != nullptr
+            and std::dynamic_pointer_cast<ccontrol::UserQuerySelect>(uq) != nullptr
+            and not uq->getResultTableName().empty()) {
+            _resultCache->insert(query, defaultDb,
+                                 resultDb + "." + uq->getResultTableName(),
+                                 uq->getProxyOrderBy());
+        }
         try {
             msgTable.unlock(uq);
             if (uq) uq->discard();
@@ -183,37 +382,140 @@ Czar::submitQuery(std::string const& query,
     // update/cleanup query map
     _updateQueryHistory(clientId, threadId, uq);
 
-    // return all info to caller
-    if (uq->isAsync()) {
+    // return all info to caller, note that ASYNC queries never reach
+    // this point as they are diverted to _submitQueryAsync() above
+    if (not uq->getResultTableName().empty()) {
+        result.resultTable = resultDb + "." + uq->getResultTableName();
+    }
+    result.messageTable = lockName;
+    result.orderBy = uq->getProxyOrderBy();
+
+    LOGS(_log, LOG_LVL_DEBUG, queryIdStr << " returning result to proxy: resultTable="
+         << result.resultTable << " messageTable=" << result.messageTable
+         << " orderBy=" << result.orderBy);
+
+    return result;
+}
+
+SubmitResult
+Czar::_submitQueryAsync(std::string const& query,
+                        std::string const& clientId,
+                        int threadId,
+                        std::string const& defaultDb,
+                        std::string const& userQueryId) {
+
+    std::string const resultDb = _czarConfig.getMySqlResultConfig().dbName;
+    std::string const msgTableName = "message_" + userQueryId;
+    std::string const lockName = resultDb + "." + msgTableName;
+    std::string const resultTableName = resultDb + ".result_async_" + userQueryId;
+    std::string const asyncLockName = resultDb + ".message_async_" + userQueryId;
+
+    SubmitResult result;
+
+    // create and lock the message table of the query handle, the proxy
+    // blocks reading the locked table until the submitter thread below
+    // registers the query and fills the result table
+    MessageTable asyncMsgTable(asyncLockName, _czarConfig.getMySqlResultConfig());
+    try {
+        asyncMsgTable.lock();
+    } catch (std::exception const& exc) {
+        result.errorMessage = exc.what();
+        return result;
+    }
+
+    // parse, analyze and dispatch the query off the proxy thread, note
+    // that lambda stores copies of both message table managers. The czar
+    // is a process-lifetime singleton so capturing "this" is safe here.
+    auto submitter = [this, query, clientId, threadId, defaultDb, userQueryId,
+                      msgTableName, lockName, resultTableName, asyncMsgTable]() mutable {
 
-        // make separate message and result tables to return info about ASYNC query,
-        // we do not need to lock message because result is ready before we return
-        std::string const resultTableName = resultDb + ".result_async_" + userQueryId;
-        std::string const asyncLockName = resultDb + ".message_async_" + userQueryId;
-        MessageTable msgTable(asyncLockName, _czarConfig.getMySqlResultConfig());
+        // the regular per-query message table collecting messages of the
+        // running query, for ASYNC queries its name is not returned to proxy
+        MessageTable msgTable(lockName, _czarConfig.getMySqlResultConfig(),
+                              _czarConfig.getMessageTableErrorsOnly());
+
+        ccontrol::UserQuery::Ptr uq;
+        std::string errorMessage;
         try {
-            _makeAsyncResult(resultTableName, uq->getQueryId(), uq->getResultLocation());
-            msgTable.create();
+            msgTable.lock();
+
+            // make new UserQuery, this is atomic
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                uq = _uqFactory->newUserQuery(query, defaultDb, getQdispPool(),
+                                              userQueryId, msgTableName, clientId);
+            }
+
+            // check for errors
+            auto error = uq->getError();
+            if (not error.empty()) {
+                errorMessage = uq->getQueryIdString() + " Failed to instantiate query: " + error;
+            } else {
+
+                // update/cleanup query map
+                _updateQueryHistory(clientId, threadId, uq);
+
+                // fill the result table of the handle
+                _makeAsyncResult(resultTableName, uq->getQueryId(), uq->getResultLocation());
+            }
         } catch (std::exception const& exc) {
-            result.errorMessage = exc.what();
-            return result;
+            errorMessage = exc.what();
         }
 
-        result.resultTable = resultTableName;
-        result.messageTable = asyncLockName;
+        // report registration failures to the proxy which is blocked
+        // on the message table lock
+        if (not errorMessage.empty()) {
+            LOGS(_log, LOG_LVL_ERROR, "Async query registration failed: " << errorMessage);
+            try {
+                asyncMsgTable.unlockOnError(errorMessage);
+            } catch (std::exception const& exc) {
+                LOGS(_log, LOG_LVL_ERROR,
+                     "Failed to unlock message table (client likely hangs): " << exc.what());
+            }
+            return;
+        }
 
-    } else {
+        auto queryIdStr = uq->getQueryIdString();
+        try {
 
-        if (not uq->getResultTableName().empty()) {
-            result.resultTable = resultDb + "." + uq->getResultTableName();
+            // the handle is complete, release the proxy
+            asyncMsgTable.unlock(ccontrol::UserQuery::Ptr());
+
+            // dispatch the query and wait until it finishes to save its
+            // messages, same as the finalizer of SYNC queries including
+            // the admission gate
+            QueryAdmission::Slot::Ptr admission;
+            if (_admission != nullptr) {
+                admission = _admission->admit(clientId.empty() ? "anonymous" : clientId);
+                if (admission->getQueueMs() > 0) {
+                    uq->getMessageStore()->addMessage(-1, 1040,
+                            "Query queued by admission control for "
+                            + std::to_string(admission->getQueueMs()) + " ms at position "
+                            + std::to_string(admission->getQueuePosition() + 1));
+                }
+            }
+            LOGS(_log, LOG_LVL_DEBUG, queryIdStr << " submitting new query");
+            uq->submit();
+            uq->join();
+            admission.reset();
+            msgTable.unlock(uq);
+            uq->discard();
+        } catch (std::exception const& exc) {
+            LOGS(_log, LOG_LVL_ERROR, queryIdStr
+                 << " Query finalization failed (client likely hangs): " << exc.what());
         }
-        result.messageTable = lockName;
-        result.orderBy = uq->getProxyOrderBy();
+    };
+    LOGS(_log, LOG_LVL_DEBUG, "starting submitter thread for async query: " << userQueryId);
+    std::thread submitThread(submitter);
+    submitThread.detach();
 
-    }
-    LOGS(_log, LOG_LVL_DEBUG, queryIdStr << " returning result to proxy: resultTable="
-         << result.resultTable << " messageTable=" << result.messageTable
-         << " orderBy=" << result.orderBy);
+    // return the handle right away, the proxy will wait on the lock of
+    // the message table until the query is registered
+    result.resultTable = resultTableName;
+    result.messageTable = asyncLockName;
+
+    LOGS(_log, LOG_LVL_DEBUG, "returning async query handle to proxy: resultTable="
+         << result.resultTable << " messageTable=" << result.messageTable);
 
     return result;
 }
@@ -280,6 +582,31 @@ Czar::killQuery(std::string const& query, std::string const& clientId) {
     }
 }
 
+void
+Czar::warmUpDatabase(std::string const& dbName) {
+    if (dbName.empty()) {
+        return;
+    }
+    auto const now = std::chrono::steady_clock::now();
+    {
+        std::lock_guard<std::mutex> lock(_warmedDbsMutex);
+        auto iter = _warmedDbs.find(dbName);
+        if (iter != _warmedDbs.end() and now - iter->second < warmUpInterval) {
+            return;
+        }
+        _warmedDbs[dbName] = now;
+    }
+    // Run on a detached thread, the proxy is waiting for the connect to
+    // complete. _uqFactory is set once at construction and never replaced,
+    // and the warm-up only touches the factory's internally synchronized
+    // shared state, so the thread does not need _mutex.
+    LOGS(_log, LOG_LVL_DEBUG, "starting warm-up thread for db " << dbName);
+    std::thread warmThread([this, dbName]() {
+        _uqFactory->warmUpDatabase(dbName);
+    });
+    warmThread.detach();
+}
+
 void
 Czar::_cleanupQueryHistoryLocked() {
     // _mutex must be locked
@@ -24,6 +24,7 @@
 
 // System headers
 #include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <map>
 #include <memory>
@@ -43,9 +44,18 @@
 #include "mysql/MySqlConfig.h"
 #include "util/ConfigStore.h"
 
+// Forward declarations
+namespace lsst {
+namespace qserv {
+namespace qhttp {
+class MetricsServer;
+}}} // namespace lsst::qserv::qhttp
+
 namespace lsst {
 namespace qserv {
 namespace czar {
+class QueryAdmission;
+class QueryResultCache;
 
 /// @addtogroup czar
 
@@ -74,6 +84,22 @@ public:
     SubmitResult submitQuery(std::string const& query,
                              std::map<std::string, std::string> const& hints);
 
+    /**
+     * Submit query for execution with hints already parsed. Session-aware
+     * callers (proxy::czarProxy) resolve the client context once per
+     * session and use this entry point to skip per-statement hint parsing.
+     *
+     * @param query: Query text.
+     * @param clientId:  Client name from proxy.
+     * @param threadId:  Thread id from proxy, -1 if unknown.
+     * @param defaultDb: Default database name, may be empty.
+     * @return Structure with info about submitted query.
+     */
+    SubmitResult submitQuery(std::string const& query,
+                             std::string const& clientId,
+                             int threadId,
+                             std::string const& defaultDb);
+
     /**
      * Process a kill query command (experimental).
      *
@@ -83,6 +109,19 @@ public:
      */
     void killQuery(std::string const& query, std::string const& clientId);
 
+    /**
+     * Warm up the metadata of a database on a detached thread.
+     *
+     * Called when a client session connects with a default database (or
+     * switches to one). Pre-touches the database's CSS subtree, builds
+     * its empty-chunk bitmap and faults in its secondary-index files so
+     * the session's first query does not pay those costs serially. Best
+     * effort; a database warmed recently is not warmed again.
+     *
+     * @param dbName: Database name, empty names are ignored.
+     */
+    void warmUpDatabase(std::string const& dbName);
+
     /**
      * Make new instance.
      *
@@ -111,6 +150,29 @@ private:
     /// Private constructor for singleton.
     Czar(std::string const& configPath, std::string const& czarName);
 
+    /**
+     * Submit ASYNC query for execution without blocking the caller.
+     *
+     * The query handle (the names of the result and message tables) is
+     * returned as soon as the "SUBMIT" syntax is recognized, parse and
+     * analysis of the query run on a detached thread. The message table
+     * of the handle stays locked until the query is registered (or fails
+     * to register), so the proxy waiting on the table lock is released
+     * exactly when the handle becomes readable.
+     *
+     * @param query:       Query text.
+     * @param clientId:    Client name from proxy.
+     * @param threadId:    Thread id from proxy, -1 if unknown.
+     * @param defaultDb:   Default database name.
+     * @param userQueryId: Unique identifier assigned to the query.
+     * @return Structure with info about submitted query.
+     */
+    SubmitResult _submitQueryAsync(std::string const& query,
+                                   std::string const& clientId,
+                                   int threadId,
+                                   std::string const& defaultDb,
+                                   std::string const& userQueryId);
+
     /// Clean query maps from expired entries, _mutex must be locked
     void _cleanupQueryHistoryLocked();
 
@@ -127,6 +189,9 @@ private:
                           QueryId queryId,
                           std::string const& resultLoc);
 
+    /// Start the embedded HTTP server exposing czar counters on /metrics.
+    void _startMetricsServer(int port);
+
     static Ptr _czar; ///< Pointer to single instance of the Czar.
 
     // combines client name (ID) and its thread ID into one unique ID
@@ -144,6 +209,23 @@ private:
     std::mutex _mutex;                  ///< protects _uqFactory, _clientToQuery, and _idToQuery
 
     qdisp::QdispPool::Ptr _qdispPool; ///< Thread pool for handling Responses from XrdSsi.
+
+    /// Databases recently warmed by warmUpDatabase() and when, so a burst
+    /// of connects to one database spawns a single warm-up thread.
+    std::map<std::string, std::chrono::steady_clock::time_point> _warmedDbs;
+    std::mutex _warmedDbsMutex;         ///< protects _warmedDbs
+
+    /// Embedded HTTP server for the Prometheus /metrics endpoint,
+    /// nullptr unless metrics.port is configured.
+    std::shared_ptr<qhttp::MetricsServer> _metricsServer;
+
+    /// Retained result tables for repeated identical queries,
+    /// nullptr unless resultcache.maxqueries is configured.
+    std::shared_ptr<QueryResultCache> _resultCache;
+
+    /// Global and per-user concurrency budgets with fair queueing of
+    /// pending queries, nullptr unless admission.maxqueries is configured.
+    std::shared_ptr<QueryAdmission> _admission;
 };
 
 }}} // namespace lsst::qserv::czar
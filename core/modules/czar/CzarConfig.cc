@@ -72,6 +72,7 @@ CzarConfig::CzarConfig(util::ConfigStore const& configStore)
             configStore.get("resultdb.db","qservResult"),
             configStore.getInt("resultdb.maxtablesize_mb", 5001)),
       _logConfig(configStore.get("log.logConfig")),
+      _messageTableErrorsOnly(configStore.getInt("resultdb.messageTableErrorsOnly", 0) != 0),
       _cssConfigMap(configStore.getSectionConfigMap("css")),
       _mySqlQmetaConfig(configStore.get( "qmeta.user", "qsmaster"),
                         configStore.get("qmeta.passwd"),
@@ -81,17 +82,27 @@ CzarConfig::CzarConfig(util::ConfigStore const& configStore)
                         configStore.get("qmeta.db", "qservMeta")),
        _xrootdFrontendUrl(configStore.get("frontend.xrootd", "localhost:1094")),
        _emptyChunkPath(configStore.get("partitioner.emptyChunkPath", ".")),
+       _secondaryIndexDir(configStore.get("czar.secondaryIndexDir", "")),
+       _parserWarmupPath(configStore.get("czar.parserWarmupPath", "")),
        _largeResultConcurrentMerges(configStore.getInt("tuning.largeResultConcurrentMerges", 3)),
        _xrootdCBThreadsMax(configStore.getInt("tuning.xrootdCBThreadsMax", 500)),
-       _xrootdCBThreadsInit(configStore.getInt("tuning.xrootdCBThreadsInit", 50)) {
+       _xrootdCBThreadsInit(configStore.getInt("tuning.xrootdCBThreadsInit", 50)),
+       _metricsPort(configStore.getInt("metrics.port", 0)),
+       _resultCacheMaxQueries(configStore.getInt("resultcache.maxqueries", 0)),
+       _resultCacheMaxAgeSec(configStore.getInt("resultcache.maxagesec", 3600)),
+       _admissionMaxQueries(configStore.getInt("admission.maxqueries", 0)),
+       _admissionMaxUserQueries(configStore.getInt("admission.maxuserqueries", 0)) {
 }
 
 std::ostream& operator<<(std::ostream &out, CzarConfig const& czarConfig) {
     out << "[cssConfigMap=" << util::printable(czarConfig._cssConfigMap) <<
            ", emptyChunkPath=" << czarConfig._emptyChunkPath <<
            ", logConfig=" << czarConfig._logConfig <<
+           ", messageTableErrorsOnly=" << czarConfig._messageTableErrorsOnly <<
            ", mySqlQmetaConfig=" << czarConfig._mySqlQmetaConfig <<
            ", mySqlResultConfig=" << czarConfig._mySqlResultConfig <<
+           ", parserWarmupPath=" << czarConfig._parserWarmupPath <<
+           ", secondaryIndexDir=" << czarConfig._secondaryIndexDir <<
            ", xrootdFrontendUrl=" << czarConfig._xrootdFrontendUrl <<
            "]";
 
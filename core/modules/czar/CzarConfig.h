@@ -101,6 +101,44 @@ public:
         return _emptyChunkPath;
     }
 
+    /* Get path to directory holding memory-mapped secondary index files
+     *
+     * One file per director table, maintained alongside the SQL secondary
+     * index. Empty (the default) disables the in-process lookup path and
+     * all secondary index lookups go to MySQL.
+     *
+     * @return path to the secondary index file directory, or empty
+     */
+    std::string const& getSecondaryIndexDir() const {
+        return _secondaryIndexDir;
+    }
+
+    /* Get path to the parser warm-up statement corpus
+     *
+     * Statements from this file (one per line, '#' comments allowed) are
+     * parsed once at startup, in addition to a built-in corpus, to populate
+     * the ANTLR prediction caches before the first user query arrives.
+     * Empty (the default) warms up with the built-in corpus only.
+     *
+     * @return path to the warm-up corpus file, or empty
+     */
+    std::string const& getParserWarmupPath() const {
+        return _parserWarmupPath;
+    }
+
+    /* Check if only error messages should be written to message tables
+     *
+     * When enabled, the informational messages of successfully completed
+     * queries are not materialized into the per-query message tables,
+     * which eliminates most of the message table traffic at interactive
+     * query rates. Error messages are always written.
+     *
+     * @return true if only error messages should be written
+     */
+    bool getMessageTableErrorsOnly() const {
+        return _messageTableErrorsOnly;
+    }
+
     /* Get hostname and port for xrootd manager
      *
      * "localhost:1094" is the most reasonable default, even though it is
@@ -136,6 +174,56 @@ public:
         return _xrootdCBThreadsInit;
     }
 
+    /* Get the TCP port of the embedded /metrics HTTP endpoint.
+     *
+     * Zero (the default) disables the endpoint.
+     *
+     * @return the port to serve /metrics on, or 0 when disabled.
+     */
+    int getMetricsPort() const {
+        return _metricsPort;
+    }
+
+    /* Get the number of result tables retained for the query result cache.
+     *
+     * Zero (the default) disables the cache.
+     *
+     * @return the maximum number of retained result tables.
+     */
+    int getResultCacheMaxQueries() const {
+        return _resultCacheMaxQueries;
+    }
+
+    /* Get the maximum age of a usable query result cache entry.
+     *
+     * @return the maximum entry age in seconds.
+     */
+    int getResultCacheMaxAgeSec() const {
+        return _resultCacheMaxAgeSec;
+    }
+
+    /* Get the global budget of concurrently executing user queries.
+     *
+     * Zero (the default) disables admission control and every accepted
+     * query is dispatched immediately.
+     *
+     * @return the maximum number of concurrently executing queries.
+     */
+    int getAdmissionMaxQueries() const {
+        return _admissionMaxQueries;
+    }
+
+    /* Get the per-user budget of concurrently executing queries.
+     *
+     * Only meaningful when admission control is enabled; zero means no
+     * per-user cap.
+     *
+     * @return the maximum number of concurrently executing queries per user.
+     */
+    int getAdmissionMaxUserQueries() const {
+        return _admissionMaxUserQueries;
+    }
+
 private:
 
     CzarConfig(util::ConfigStore const& ConfigStore);
@@ -143,15 +231,23 @@ private:
     // Parameters below used in czar::Czar
     mysql::MySqlConfig const _mySqlResultConfig;
     std::string const _logConfig;
+    bool const _messageTableErrorsOnly;
 
     // Parameters below used in ccontrol::UserQueryFactory
     std::map<std::string, std::string> const _cssConfigMap;
     mysql::MySqlConfig const _mySqlQmetaConfig;
     std::string const _xrootdFrontendUrl;
     std::string const _emptyChunkPath;
+    std::string const _secondaryIndexDir;
+    std::string const _parserWarmupPath;
     int const _largeResultConcurrentMerges;
     int const _xrootdCBThreadsMax;
     int const _xrootdCBThreadsInit;
+    int const _metricsPort;
+    int const _resultCacheMaxQueries;
+    int const _resultCacheMaxAgeSec;
+    int const _admissionMaxQueries;
+    int const _admissionMaxUserQueries;
 };
 
 }}} // namespace lsst::qserv::czar
@@ -24,6 +24,7 @@
 #include "czar/MessageTable.h"
 
 // System headers
+#include <ctime>
 
 // Third-party headers
 #include "boost/format.hpp"
@@ -53,6 +54,15 @@ std::string const createAndLockTmpl(createTmpl + "; LOCK TABLES %1% WRITE;");
 std::string const writeTmpl("INSERT INTO %1% (chunkId, code, message, severity, timeStamp) "
     "VALUES (%2%, %3%, '%4%', '%5%', %6%)");
 
+std::string const writeHeaderTmpl("INSERT INTO %1% (chunkId, code, message, severity, timeStamp) "
+    "VALUES ");
+
+std::string const writeRowTmpl("(%1%, %2%, '%3%', '%4%', %5%)");
+
+// Cap on the size of a single multi-row INSERT statement, keeps
+// the statement safely below the default max_allowed_packet
+size_t const maxWriteStatementSize = 1024*1024;
+
 // mysql can only unlock all locked tables,
 // there is no command to unlock single table
 std::string const unlockTmpl("UNLOCK TABLES");
@@ -65,8 +75,10 @@ namespace czar {
 
 // Constructors
 MessageTable::MessageTable(std::string const& tableName,
-                           mysql::MySqlConfig const& resultConfig)
+                           mysql::MySqlConfig const& resultConfig,
+                           bool errorsOnly)
     : _tableName(tableName),
+      _errorsOnly(errorsOnly),
       _sqlConn(std::make_shared<sql::SqlConnection>(resultConfig)) {
 }
 
@@ -110,6 +122,24 @@ MessageTable::unlock(ccontrol::UserQuery::Ptr const& userQuery) {
     }
 }
 
+// Store single error message in the table and release lock
+void
+MessageTable::unlockOnError(std::string const& message) {
+
+    LOGS(_log, LOG_LVL_DEBUG, "Insert error in message table: [" << message << "]");
+
+    std::string query = (boost::format(::writeTmpl) % _tableName % -1 % -1 %
+        _sqlConn->escapeString(message) % "ERROR" % std::time(nullptr)).str();
+    sql::SqlErrorObject sqlErr;
+    if (not _sqlConn->runQuery(query, sqlErr)) {
+        SqlError exc(ERR_LOC, "Failure updating message table", sqlErr);
+        LOGS(_log, LOG_LVL_ERROR, exc.message());
+        throw exc;
+    }
+
+    unlock(ccontrol::UserQuery::Ptr());
+}
+
 // store all messages from current session to the table
 void
 MessageTable::_saveQueryMessages(ccontrol::UserQuery::Ptr const& userQuery) {
@@ -119,24 +149,52 @@ MessageTable::_saveQueryMessages(ccontrol::UserQuery::Ptr const& userQuery) {
 
     auto msgStore = userQuery->getMessageStore();
 
-    // copy all messages from query message store to a message table
+    // copy all messages from query message store to a message table,
+    // the messages are batched into multi-row INSERT statements of
+    // a limited size
+    std::string const header = (boost::format(::writeHeaderTmpl) % _tableName).str();
+    std::string query;
+    int numRows = 0;
+
+    auto flush = [this, &query, &numRows]() {
+        if (numRows == 0) return;
+        LOGS(_log, LOG_LVL_DEBUG, "Insert " << numRows << " rows in message table");
+        sql::SqlErrorObject sqlErr;
+        if (not _sqlConn->runQuery(query, sqlErr)) {
+            SqlError exc(ERR_LOC, "Failure updating message table", sqlErr);
+            LOGS(_log, LOG_LVL_ERROR, exc.message());
+            throw exc;
+        }
+        query.clear();
+        numRows = 0;
+    };
+
     int msgCount = msgStore->messageCount();
     for (int i = 0; i != msgCount; ++ i) {
         const qdisp::QueryMessage& qm = msgStore->getMessage(i);
+
+        // non-error messages are skipped entirely if the table
+        // was configured to receive the errors only
+        if (_errorsOnly and qm.severity != MSG_ERROR) {
+            continue;
+        }
         LOGS(_log, LOG_LVL_DEBUG, "Insert in message table: ["
              << qm.description << ", " << qm.chunkId << ", " << qm.code
              << ", " << qm.severity << ", " << qm.timestamp << "]");
 
         char const* severity = (qm.severity == MSG_INFO ? "INFO" : "ERROR");
-        std::string query = (boost::format(::writeTmpl) % _tableName % qm.chunkId % qm.code %
+        std::string const row = (boost::format(::writeRowTmpl) % qm.chunkId % qm.code %
             _sqlConn->escapeString(qm.description) % severity % qm.timestamp).str();
-        sql::SqlErrorObject sqlErr;
-        if (not _sqlConn->runQuery(query, sqlErr)) {
-            SqlError exc(ERR_LOC, "Failure updating message table", sqlErr);
-            LOGS(_log, LOG_LVL_ERROR, exc.message());
-            throw exc;
+
+        query += query.empty() ? header : ",";
+        query += row;
+        numRows++;
+
+        if (query.size() > ::maxWriteStatementSize) {
+            flush();
         }
     }
+    flush();
 }
 
 }}} // namespace lsst::qserv::czar
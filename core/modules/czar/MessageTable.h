@@ -56,8 +56,10 @@ namespace czar {
 class MessageTable  {
 public:
 
-    // Constructor takes table name including database name
-    explicit MessageTable(std::string const& tableName, mysql::MySqlConfig const& resultConfig);
+    // Constructor takes table name including database name; if errorsOnly
+    // is set then only error messages are materialized into the table
+    explicit MessageTable(std::string const& tableName, mysql::MySqlConfig const& resultConfig,
+                          bool errorsOnly = false);
 
     /// Create the table, do not lock
     void create();
@@ -68,6 +70,10 @@ public:
     /// Release lock on message table so that proxy can proceed
     void unlock(ccontrol::UserQuery::Ptr const& userQuery);
 
+    /// Store single error message in the table and release lock, this is
+    /// for reporting failures which happen before a query has a message store
+    void unlockOnError(std::string const& message);
+
 protected:
 
 private:
@@ -76,6 +82,7 @@ private:
     void _saveQueryMessages(ccontrol::UserQuery::Ptr const& userQuery);
 
     std::string const _tableName;
+    bool const _errorsOnly;
     std::shared_ptr<sql::SqlConnection> _sqlConn;
 
 };
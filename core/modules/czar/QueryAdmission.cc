@@ -0,0 +1,147 @@
+/*
+ * LSST Data Management System
+ * Copyright 2017 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "czar/QueryAdmission.h"
+
+// System headers
+#include <chrono>
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.czar.QueryAdmission");
+
+} // anonymous namespace
+
+namespace lsst {
+namespace qserv {
+namespace czar {
+
+QueryAdmission::QueryAdmission(int maxQueries, int maxUserQueries)
+    : _maxQueries(maxQueries), _maxUserQueries(maxUserQueries) {
+}
+
+
+QueryAdmission::Slot::~Slot() {
+    _admission->_release(_user);
+}
+
+
+QueryAdmission::Slot::Ptr QueryAdmission::admit(std::string const& user) {
+    Slot::Ptr slot(new Slot(this, user));
+    std::unique_lock<std::mutex> lock(_mtx);
+
+    // The fast path: no one is waiting and the budgets have room. When
+    // queries are queued even an eligible new arrival goes through the
+    // queue, so it cannot overtake earlier queries of its own user.
+    if (_waiting == 0 and _canRunLocked(user)) {
+        ++_running;
+        ++_userRunning[user];
+        return slot;
+    }
+
+    Waiter waiter(user);
+    waiter.seq = _nextSeq++;
+    slot->_position = _waiting;
+    _queues[user].push_back(&waiter);
+    ++_waiting;
+    LOGS(_log, LOG_LVL_INFO, "admission: queueing query of user '" << user
+         << "' at position " << _waiting << " (" << _running << " running)");
+
+    auto const begin = std::chrono::steady_clock::now();
+    _scheduleLocked();
+    waiter.cv.wait(lock, [&waiter]() { return waiter.admitted; });
+    auto const waited = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - begin).count();
+    slot->_queueMs = waited > 0 ? waited : 0;
+    return slot;
+}
+
+
+void QueryAdmission::_release(std::string const& user) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    --_running;
+    auto iter = _userRunning.find(user);
+    if (iter != _userRunning.end() and --iter->second <= 0) {
+        _userRunning.erase(iter);
+    }
+    _scheduleLocked();
+}
+
+
+bool QueryAdmission::_canRunLocked(std::string const& user) const {
+    if (_running >= _maxQueries) {
+        return false;
+    }
+    if (_maxUserQueries > 0) {
+        auto iter = _userRunning.find(user);
+        if (iter != _userRunning.end() and iter->second >= _maxUserQueries) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+void QueryAdmission::_scheduleLocked() {
+    while (_running < _maxQueries and _waiting > 0) {
+        // Pick the eligible user with the fewest queries running; among
+        // equals the one whose head waiter arrived first. This is what
+        // keeps a single flooding user from monopolizing freed slots.
+        auto bestIter = _queues.end();
+        int bestRunning = 0;
+        uint64_t bestSeq = 0;
+        for (auto iter = _queues.begin(); iter != _queues.end(); ++iter) {
+            if (iter->second.empty() or not _canRunLocked(iter->first)) {
+                continue;
+            }
+            auto runIter = _userRunning.find(iter->first);
+            int const running = runIter == _userRunning.end() ? 0 : runIter->second;
+            uint64_t const seq = iter->second.front()->seq;
+            if (bestIter == _queues.end() or running < bestRunning
+                or (running == bestRunning and seq < bestSeq)) {
+                bestIter = iter;
+                bestRunning = running;
+                bestSeq = seq;
+            }
+        }
+        if (bestIter == _queues.end()) {
+            // Every waiting user is at its per-user cap.
+            return;
+        }
+        Waiter* waiter = bestIter->second.front();
+        bestIter->second.pop_front();
+        if (bestIter->second.empty()) {
+            _queues.erase(bestIter);
+        }
+        --_waiting;
+        ++_running;
+        ++_userRunning[waiter->user];
+        waiter->admitted = true;
+        waiter->cv.notify_one();
+    }
+}
+
+}}} // namespace lsst::qserv::czar
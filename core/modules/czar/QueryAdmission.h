@@ -0,0 +1,150 @@
+/*
+ * LSST Data Management System
+ * Copyright 2017 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_CZAR_QUERYADMISSION_H
+#define LSST_QSERV_CZAR_QUERYADMISSION_H
+
+// System headers
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace lsst {
+namespace qserv {
+namespace czar {
+
+/// @addtogroup czar
+
+/**
+ *  @ingroup czar
+ *
+ *  @brief Admission control for user queries with per-user fair queueing.
+ *
+ *  Without a gate the czar dispatches every accepted query immediately,
+ *  so one user submitting hundreds of scans starves everyone else and
+ *  overloads the merge layer. QueryAdmission bounds the number of
+ *  concurrently executing queries globally and per user; queries beyond
+ *  the budgets wait in per-user FIFO queues, and freed slots go to the
+ *  waiting user with the fewest queries already running (ties to the
+ *  longest waiter), so throughput under overload degrades fairly
+ *  instead of collapsing.
+ *
+ *  admit() blocks the calling thread, so it must only be called from the
+ *  per-query finalizer/submitter threads, never from the proxy-facing
+ *  submitQuery() path. The proxy is already waiting on the locked
+ *  message table at that point, and the queue wait is reported to it
+ *  through a message-table entry.
+ */
+class QueryAdmission {
+public:
+    typedef std::shared_ptr<QueryAdmission> Ptr;
+
+    /// The slot held by one admitted query. Destroying it releases the
+    /// slot and wakes the scheduler to admit a waiting query.
+    class Slot {
+    public:
+        typedef std::shared_ptr<Slot> Ptr;
+
+        ~Slot();
+
+        Slot(Slot const&) = delete;
+        Slot& operator=(Slot const&) = delete;
+
+        /// @return milliseconds this query waited for admission.
+        uint64_t getQueueMs() const { return _queueMs; }
+
+        /// @return the number of queries that were waiting ahead when
+        /// this query joined the queue; 0 if it was admitted directly.
+        size_t getQueuePosition() const { return _position; }
+
+    private:
+        friend class QueryAdmission;
+        Slot(QueryAdmission* admission, std::string const& user)
+            : _admission(admission), _user(user) {}
+
+        QueryAdmission* const _admission;
+        std::string const _user;
+        uint64_t _queueMs{0};
+        size_t _position{0};
+    };
+
+    /**
+     * @param maxQueries:     Global budget of concurrently executing
+     *                        queries, must be positive.
+     * @param maxUserQueries: Per-user budget, 0 for no per-user cap.
+     */
+    QueryAdmission(int maxQueries, int maxUserQueries);
+
+    QueryAdmission(QueryAdmission const&) = delete;
+    QueryAdmission& operator=(QueryAdmission const&) = delete;
+
+    /**
+     * Wait until the budgets allow one more query of the given user to
+     * run, then claim a slot.
+     *
+     * @param user: The fairness key, normally the proxy client name.
+     * @return the slot handle; release it (reset the pointer) as soon as
+     *         the query stops consuming czar resources.
+     */
+    Slot::Ptr admit(std::string const& user);
+
+private:
+    friend class Slot;
+
+    /// One queued query waiting for admission.
+    struct Waiter {
+        explicit Waiter(std::string const& user_) : user(user_) {}
+        std::string const user;
+        uint64_t seq{0}; ///< arrival order, for breaking fairness ties
+        bool admitted{false};
+        std::condition_variable cv;
+    };
+
+    /// Release the slot of one finished query and admit waiters.
+    void _release(std::string const& user);
+
+    /// @return true if one more query of 'user' fits the budgets.
+    /// Precondition: _mtx must be held.
+    bool _canRunLocked(std::string const& user) const;
+
+    /// Admit waiting queries while the budgets allow it, preferring the
+    /// eligible user with the fewest queries running.
+    /// Precondition: _mtx must be held.
+    void _scheduleLocked();
+
+    int const _maxQueries;     ///< global concurrency budget
+    int const _maxUserQueries; ///< per-user budget, 0: no cap
+
+    std::mutex _mtx; ///< protects everything below
+    int _running{0}; ///< queries currently holding a slot
+    uint64_t _nextSeq{0}; ///< arrival counter for Waiter::seq
+    size_t _waiting{0}; ///< total queued queries across all users
+    std::map<std::string, int> _userRunning; ///< slots held per user
+    std::map<std::string, std::deque<Waiter*>> _queues; ///< per-user FIFOs
+};
+
+}}} // namespace lsst::qserv::czar
+
+#endif // LSST_QSERV_CZAR_QUERYADMISSION_H
@@ -0,0 +1,165 @@
+/*
+ * LSST Data Management System
+ * Copyright 2018 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "czar/QueryResultCache.h"
+
+// System headers
+#include <utility>
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+// Qserv headers
+#include "sql/SqlConnection.h"
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.czar.QueryResultCache");
+
+}
+
+namespace lsst {
+namespace qserv {
+namespace czar {
+
+// Constructor
+QueryResultCache::QueryResultCache(mysql::MySqlConfig const& resultConfig,
+                                   size_t maxEntries, int maxAgeSecs)
+    : _resultConfig(resultConfig), _maxEntries(maxEntries), _maxAgeSecs(maxAgeSecs) {
+}
+
+// Look up a retained result for an identical earlier query.
+std::shared_ptr<QueryResultCache::Entry>
+QueryResultCache::lookup(std::string const& query, std::string const& defaultDb) {
+    std::string const key = _makeKey(query, defaultDb);
+    std::vector<std::string> expired;
+    std::shared_ptr<Entry> result;
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        auto iter = _entries.find(key);
+        if (iter == _entries.end()) {
+            return nullptr;
+        }
+        if (_maxAgeSecs > 0
+            and std::time(nullptr) - iter->second.created > _maxAgeSecs) {
+            // too old, drop the table and miss
+            expired.push_back(iter->second.entry.resultTable);
+            _lru.erase(iter->second.lruIter);
+            _entries.erase(iter);
+        } else {
+            // refresh recency
+            _lru.erase(iter->second.lruIter);
+            _lru.push_front(key);
+            iter->second.lruIter = _lru.begin();
+            result = std::make_shared<Entry>(iter->second.entry);
+        }
+    }
+    _dropTables(expired);
+    if (result != nullptr) {
+        LOGS(_log, LOG_LVL_INFO, "result cache hit, reusing " << result->resultTable);
+    }
+    return result;
+}
+
+// Retain a completed query's result table.
+void
+QueryResultCache::insert(std::string const& query, std::string const& defaultDb,
+                         std::string const& resultTable, std::string const& orderBy) {
+    std::string const key = _makeKey(query, defaultDb);
+    std::vector<std::string> evicted;
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        auto iter = _entries.find(key);
+        if (iter != _entries.end()) {
+            // the same statement completed twice concurrently; keep the
+            // newer table, the older one is unreferenced now
+            evicted.push_back(iter->second.entry.resultTable);
+            _lru.erase(iter->second.lruIter);
+            _entries.erase(iter);
+        }
+        _lru.push_front(key);
+        CacheEntry cacheEntry;
+        cacheEntry.entry.resultTable = resultTable;
+        cacheEntry.entry.orderBy = orderBy;
+        cacheEntry.created = std::time(nullptr);
+        cacheEntry.lruIter = _lru.begin();
+        _entries.emplace(key, std::move(cacheEntry));
+
+        while (_entries.size() > _maxEntries) {
+            std::string const& victim = _lru.back();
+            auto victimIter = _entries.find(victim);
+            evicted.push_back(victimIter->second.entry.resultTable);
+            _entries.erase(victimIter);
+            _lru.pop_back();
+        }
+    }
+    _dropTables(evicted);
+    LOGS(_log, LOG_LVL_DEBUG, "result cache retained " << resultTable);
+}
+
+// Drop all retained result tables and forget all entries.
+void
+QueryResultCache::invalidateAll() {
+    std::vector<std::string> dropped;
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        if (_entries.empty()) return;
+        dropped.reserve(_entries.size());
+        for (auto const& entry : _entries) {
+            dropped.push_back(entry.second.entry.resultTable);
+        }
+        _entries.clear();
+        _lru.clear();
+    }
+    LOGS(_log, LOG_LVL_INFO, "result cache invalidated, dropping "
+         << dropped.size() << " retained tables");
+    _dropTables(dropped);
+}
+
+// Build the cache key for a query submission.
+std::string
+QueryResultCache::_makeKey(std::string const& query, std::string const& defaultDb) {
+    // the default database resolves unqualified table names, so the same
+    // text against a different database is a different query
+    return defaultDb + '\0' + query;
+}
+
+// Drop the result tables of evicted entries.
+void
+QueryResultCache::_dropTables(std::vector<std::string> const& tables) {
+    if (tables.empty()) return;
+    std::lock_guard<std::mutex> lock(_sqlMtx);
+    if (_sqlConn == nullptr) {
+        _sqlConn = std::make_shared<sql::SqlConnection>(_resultConfig);
+    }
+    for (auto const& table : tables) {
+        sql::SqlErrorObject sqlErr;
+        if (not _sqlConn->runQuery("DROP TABLE IF EXISTS " + table, sqlErr)) {
+            // a leaked table wastes space but breaks nothing
+            LOGS(_log, LOG_LVL_WARN, "failed to drop evicted result table "
+                 << table << ": " << sqlErr.errMsg());
+        }
+    }
+}
+
+}}} // namespace lsst::qserv::czar
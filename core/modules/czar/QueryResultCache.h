@@ -0,0 +1,141 @@
+/*
+ * LSST Data Management System
+ * Copyright 2018 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_CZAR_QUERYRESULTCACHE_H
+#define LSST_QSERV_CZAR_QUERYRESULTCACHE_H
+
+// System headers
+#include <ctime>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Qserv headers
+#include "mysql/MySqlConfig.h"
+
+// Forward declarations
+namespace lsst {
+namespace qserv {
+namespace sql {
+class SqlConnection;
+}}} // namespace lsst::qserv::sql
+
+namespace lsst {
+namespace qserv {
+namespace czar {
+
+/// @addtogroup czar
+
+/**
+ *  @ingroup czar
+ *
+ *  @brief Cache of retained result tables for repeated identical queries.
+ *
+ *  The public-facing service replays identical statements constantly
+ *  (popular cone searches, documentation examples). When a SELECT
+ *  completes successfully its result table is retained and recorded here
+ *  under (query text, default database); a later identical submission is
+ *  answered by pointing the proxy at the retained table instead of
+ *  re-dispatching the query to the cluster.
+ *
+ *  Retention is bounded: beyond maxEntries the least recently used entry
+ *  is evicted and its result table dropped, and entries older than
+ *  maxAgeSecs are treated as misses. The whole cache is invalidated when
+ *  the czar sees a statement that changes the data behind it (ingest
+ *  flushes, DROP DATABASE/TABLE) - correctness over cleverness, those
+ *  events are rare.
+ */
+class QueryResultCache {
+public:
+
+    /// What a hit hands back to the caller.
+    struct Entry {
+        std::string resultTable;    ///< Fully qualified retained result table.
+        std::string orderBy;        ///< ORDER BY clause for the proxy-side SELECT.
+    };
+
+    /**
+     *  @param resultConfig:  Connection info for the result database, used
+     *                        to drop the tables of evicted entries.
+     *  @param maxEntries:    Retained result tables, oldest evicted beyond this.
+     *  @param maxAgeSecs:    Entries older than this are treated as misses.
+     */
+    QueryResultCache(mysql::MySqlConfig const& resultConfig,
+                     size_t maxEntries, int maxAgeSecs);
+
+    QueryResultCache(QueryResultCache const&) = delete;
+    QueryResultCache& operator=(QueryResultCache const&) = delete;
+
+    /**
+     *  @brief Look up a retained result for an identical earlier query.
+     *
+     *  A hit refreshes the entry's recency.
+     *
+     *  @return the entry, or nullptr on miss (including expired entries).
+     */
+    std::shared_ptr<Entry> lookup(std::string const& query, std::string const& defaultDb);
+
+    /**
+     *  @brief Retain a completed query's result table.
+     *
+     *  May evict (and drop the table of) the least recently used entry.
+     */
+    void insert(std::string const& query, std::string const& defaultDb,
+                std::string const& resultTable, std::string const& orderBy);
+
+    /// Drop all retained result tables and forget all entries. Called when
+    /// the data behind any cached result may have changed.
+    void invalidateAll();
+
+private:
+
+    /// One cached result with bookkeeping.
+    struct CacheEntry {
+        Entry entry;
+        std::time_t created = 0;    ///< For age-based expiry.
+        std::list<std::string>::iterator lruIter;  ///< Position in _lru.
+    };
+
+    /// @return the cache key for a query submission
+    static std::string _makeKey(std::string const& query, std::string const& defaultDb);
+
+    /// Drop the result tables of evicted entries; runs without _mtx held
+    /// so a slow mysqld never blocks query submission.
+    void _dropTables(std::vector<std::string> const& tables);
+
+    mysql::MySqlConfig const _resultConfig;
+    size_t const _maxEntries;
+    int const _maxAgeSecs;
+
+    std::mutex _mtx;    ///< Protects _entries and _lru.
+    std::map<std::string, CacheEntry> _entries;
+    std::list<std::string> _lru;    ///< Keys, most recently used first.
+
+    std::mutex _sqlMtx; ///< Serializes use of _sqlConn.
+    std::shared_ptr<sql::SqlConnection> _sqlConn;   ///< Created on first drop.
+};
+
+}}} // namespace lsst::qserv::czar
+
+#endif // LSST_QSERV_CZAR_QUERYRESULTCACHE_H
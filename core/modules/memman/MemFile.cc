@@ -39,6 +39,15 @@ namespace memman {
 namespace {
 std::mutex                                cacheMutex;
 std::unordered_map<std::string, MemFile*> fileCache;
+
+// Size of the regions used for incremental locking. It must be a multiple of
+// the page size so every region offset is page aligned.
+uint64_t const lockRegionSize = 64ULL*1024*1024;
+
+// Number of regions kept locked behind the lock cursor before older regions
+// are evicted. The lock cursor runs somewhat ahead of the actual scan, so
+// the lag must be generous enough that we never drop unread data.
+uint64_t const evictLagRegions = 4;
 }
 
 /******************************************************************************/
@@ -61,29 +70,164 @@ MemFile::MLResult MemFile::memLock() {
         return aokResult;
     }
 
-    // Lock this table in memory if possible. If not, simulate an ENOMEM.
+    // Flexible tables are locked in a single call, all or nothing, and any
+    // error is ignored as these files may remain unlocked.
     //
-    if (!_isMapped) rc = ENOMEM;
-    else {
-        rc = _memory.memLock(_memInfo, _isFlex);
-        if (rc == 0) {
-            MLResult aokResult(_memInfo.size(),0);
-            _isLocked = true;
-            return aokResult;
+    if (_isFlex) {
+        if (!_isMapped) rc = ENOMEM;
+        else {
+            rc = _memory.memLock(_memInfo, _isFlex);
+            if (rc == 0) {
+                MLResult aokResult(_memInfo.size(),0);
+                _isLocked = true;
+                _lockedSize = _memInfo.size();
+                return aokResult;
+            }
         }
+        MLResult nilResult(0,0);
+        return nilResult;
     }
- 
-    // If this is a flexible table, we can ignore this error.
+
+    // Required tables are locked region by region so memLockInit() and
+    // memLockFinish() may split the work; locking everything here simply
+    // finishes whatever is left.
     //
-    if (_isFlex) {
+    return _memLockUpTo(_memInfo.size());
+}
+
+/******************************************************************************/
+/*                           m e m L o c k I n i t                            */
+/******************************************************************************/
+
+MemFile::MLResult MemFile::memLockInit() {
+
+    std::lock_guard<std::mutex> guard(_fileMutex);
+
+    // If the file is already locked, indicate success
+    //
+    if (_isLocked) {
+        MLResult aokResult(_memInfo.size(), 0);
+        return aokResult;
+    }
+
+    // Lock just the first region; the caller may start using the file once
+    // every file in its set has its first region resident.
+    //
+    return _memLockUpTo(lockRegionSize);
+}
+
+/******************************************************************************/
+/*                         m e m L o c k F i n i s h                          */
+/******************************************************************************/
+
+MemFile::MLResult MemFile::memLockFinish() {
+
+    std::lock_guard<std::mutex> guard(_fileMutex);
+    return _memLockUpTo(_memInfo.size());
+}
+
+/******************************************************************************/
+/*                         _ m e m L o c k U p T o                            */
+/******************************************************************************/
+
+MemFile::MLResult MemFile::_memLockUpTo(uint64_t maxBytes) {
+
+    // If the file is already locked there is nothing left to lock.
+    //
+    if (_isLocked) {
         MLResult nilResult(0,0);
         return nilResult;
     }
 
-    // Diagnose any errors
+    // An unmapped file cannot be locked, simulate an ENOMEM.
     //
-    MLResult errResult(0, rc);
-    return errResult;
+    if (!_isMapped) {
+        MLResult errResult(0, ENOMEM);
+        return errResult;
+    }
+
+    // Lock region by region up to the target. Before locking a region, ask
+    // the kernel to start reading the region after it so by the time that one
+    // is locked most of its pages should already be resident.
+    //
+    uint64_t fSize = _memInfo.size();
+    uint64_t newly = 0;
+    if (maxBytes > fSize) maxBytes = fSize;
+    while(_lockedSize < maxBytes) {
+        uint64_t bytes = lockRegionSize;
+        if (bytes > fSize - _lockedSize) bytes = fSize - _lockedSize;
+        if (_lockedSize + bytes < fSize) {
+            _memory.memReadAhead(_memInfo, _lockedSize + bytes, lockRegionSize);
+        }
+        int rc = _memory.memLockRegion(_memInfo, _lockedSize, bytes);
+        if (rc != 0) {
+            MLResult errResult(newly, rc);
+            return errResult;
+        }
+        _lockedSize += bytes;
+        newly       += bytes;
+        _evictBehind();
+    }
+
+    // Mark the file locked once every byte of it is locked.
+    //
+    if (_lockedSize >= fSize) _isLocked = true;
+    MLResult aokResult(newly, 0);
+    return aokResult;
+}
+
+/******************************************************************************/
+/*                          _ e v i c t B e h i n d                           */
+/******************************************************************************/
+
+void MemFile::_evictBehind() {
+
+    // A streaming file is read exactly once, front to back, so regions behind
+    // the cursor are dead weight: mysqld buffers the rows it reads on its own
+    // side, and without eviction each byte of a one-pass scan sits in memory
+    // twice. Such files are always evicted from. For any other file eviction
+    // only makes sense when memory is tight; otherwise the regions stay
+    // locked and a later query on the same chunk finds them resident.
+    //
+    if (!_streaming() && _memory.bytesFree() >= lockRegionSize) return;
+
+    // A file shared by several file sets is never evicted from as the other
+    // scans may still be reading the regions behind our cursor.
+    //
+    if (_shared()) return;
+
+    // Release whole regions that are at least evictLagRegions behind the
+    // lock cursor. The freed memory is returned to the reservation pool so
+    // it can go to data ahead of this or any other scan.
+    //
+    uint64_t const lagBytes = evictLagRegions*lockRegionSize;
+    if (_lockedSize < lagBytes) return;
+    uint64_t evictTo = _lockedSize - lagBytes;
+    while(_evictedSize + lockRegionSize <= evictTo) {
+        _memory.memRelRegion(_memInfo, _evictedSize, lockRegionSize);
+        _memory.memRestore(lockRegionSize);
+        _evictedSize += lockRegionSize;
+    }
+}
+
+/******************************************************************************/
+/*                              _ s h a r e d                                 */
+/******************************************************************************/
+
+bool MemFile::_shared() {
+
+    std::lock_guard<std::mutex> guard(cacheMutex);
+    return _refs > 1;
+}
+
+/******************************************************************************/
+/*                           _ s t r e a m i n g                              */
+/******************************************************************************/
+
+bool MemFile::_streaming() {
+
+    std::lock_guard<std::mutex> guard(cacheMutex);
+    return _isStreaming;
 }
 
 /******************************************************************************/
@@ -152,13 +296,15 @@ uint32_t MemFile::numFiles() {
 /******************************************************************************/
   
 MemFile::MFResult MemFile::obtain(std::string const& fPath,
-                                  Memory& mem, bool isFlex) {
+                                  Memory& mem, bool isFlex, bool isStream) {
 
     std::lock_guard<std::mutex> guard(cacheMutex);
 
     // First look up if this table already exists in our cache and is using the
     // the same memory object (error if not). If so, up the reference count and
-    // return the object as it may be shared. Note: it->second == MemFile*!
+    // return the object as it may be shared. A non-streaming requester turns
+    // off streaming for good as it may reread any byte at any time.
+    // Note: it->second == MemFile*!
     //
     auto it = fileCache.find(fPath);
     if (it != fileCache.end()) {
@@ -167,6 +313,7 @@ MemFile::MFResult MemFile::obtain(std::string const& fPath,
             return errResult;
         }
         it->second->_refs++;
+        if (!isStream) it->second->_isStreaming = false;
         MFResult aokResult(it->second,0);
         return aokResult;
     }
@@ -181,7 +328,7 @@ MemFile::MFResult MemFile::obtain(std::string const& fPath,
 
     // Get a new file object and insert it into the map
     //
-    MemFile* mfP = new MemFile(fPath, mem, mInfo, isFlex);
+    MemFile* mfP = new MemFile(fPath, mem, mInfo, isFlex, isStream);
     fileCache.insert({fPath, mfP});
 
     // Return the pointer to the file object
@@ -217,16 +364,20 @@ void MemFile::release() {
     uint64_t fSize = _memInfo.size();
 
     // Release the memory if mapped and unreserve the memory if reserved.
+    // Bytes evicted behind the scan cursor were unlocked and unreserved
+    // as the scan went along, so only the remainder is accounted for here.
     //
     if (_isMapped) {
-        _memory.memRel(_memInfo, _isLocked);
+        _memory.memRel(_memInfo, _lockedSize - _evictedSize);
         _isLocked = false;
+        _lockedSize = 0;
         _isMapped = false;
     }
     if (_isReserved) {
-        _memory.memRestore(fSize);
+        _memory.memRestore(fSize - _evictedSize);
         _isReserved = false;
     }
+    _evictedSize = 0;
 
     // Delete ourselves as we are done
     //
@@ -65,6 +65,28 @@ public:
 
     MLResult    memLock();
 
+    //-----------------------------------------------------------------------------
+    //! @brief Lock the initial region of the file so a query may start using
+    //!        it, and ask the kernel to read the next region ahead of need.
+    //!        Call memLockFinish() to lock the rest of the file.
+    //!
+    //! @return MLResult  bLocked holds the bytes newly locked (the full file
+    //!                   size if the file was already locked) and retc any
+    //!                   error, as described by memLock().
+    //-----------------------------------------------------------------------------
+
+    MLResult    memLockInit();
+
+    //-----------------------------------------------------------------------------
+    //! @brief Lock whatever memLockInit() left unlocked, region by region
+    //!        with readahead of the following region.
+    //!
+    //! @return MLResult  bLocked holds the bytes newly locked here, which
+    //!                   excludes the bytes reported by memLockInit().
+    //-----------------------------------------------------------------------------
+
+    MLResult    memLockFinish();
+
     //-----------------------------------------------------------------------------
     //! @brief Map database file in memory.
     //!
@@ -91,6 +113,11 @@ public:
     //! @param  fPath   - The path to the file.
     //! @param  mem     - Reference to the memory object to use for the file.
     //! @param  isFlex  - Tag file as flexible or not (only if new file).
+    //! @param  isStream- Tag file as read once, front to back, so memory far
+    //!                   behind the scan cursor may be released. The file
+    //!                   stays streaming only while every requester says so;
+    //!                   one non-streaming request turns it off for good as
+    //!                   that requester may reread any byte at any time.
     //!
     //! @return MFResult  When mfP is zero or retc is not zero, the MemFile
     //!                   object could not be obtained and retc holds errno.
@@ -103,7 +130,8 @@ public:
         MFResult(MemFile* mfp, int rc) : mfP(mfp), retc(rc) {}
     };
 
-    static MFResult obtain(std::string const& fPath, Memory& mem, bool isFlex);
+    static MFResult obtain(std::string const& fPath, Memory& mem, bool isFlex,
+                           bool isStream=false);
 
     //-----------------------------------------------------------------------------
     //! @brief Release this table. Upon return it may not be references by
@@ -120,25 +148,70 @@ private:
     //! @param  mem     - Reference to the associated memory object.
     //! @param  mInfo   - Initial value of the MemInfo object for the file.
     //! @param  isFlex  - Tag file as flexible or not (for statistical reasons).
+    //! @param  isStream- Tag file as streaming, see obtain().
     //-----------------------------------------------------------------------------
 
     MemFile(std::string const& fPath,
             Memory&            mem,
             MemInfo const&     minfo,
-            bool               isFlex)
-           : _fPath(fPath), _memory(mem), _memInfo(minfo), _isFlex(isFlex) {}
+            bool               isFlex,
+            bool               isStream)
+           : _fPath(fPath), _memory(mem), _memInfo(minfo), _isFlex(isFlex),
+             _isStreaming(isStream) {}
 
    ~MemFile() {}
 
+    //-----------------------------------------------------------------------------
+    //! @brief Lock regions until at least maxBytes of the file are locked.
+    //!        The _fileMutex must be held by the caller.
+    //!
+    //! @param  maxBytes - Lock target, trimmed to the file size.
+    //!
+    //! @return MLResult  bLocked holds the bytes newly locked by this call.
+    //-----------------------------------------------------------------------------
+
+    MLResult _memLockUpTo(uint64_t maxBytes);
+
+    //-----------------------------------------------------------------------------
+    //! @brief Evict regions that are well behind the lock cursor so the
+    //!        memory goes to data ahead of the scan instead of regions it
+    //!        has already consumed. Streaming files are always evicted from;
+    //!        other files only when memory is tight. The _fileMutex must be
+    //!        held by the caller. Files shared by more than one file set are
+    //!        left alone as another scan may still be behind.
+    //-----------------------------------------------------------------------------
+
+    void     _evictBehind();
+
+    //-----------------------------------------------------------------------------
+    //! @brief Check whether more than one file set references this file.
+    //!
+    //! @return true if the file is shared, false otherwise.
+    //-----------------------------------------------------------------------------
+
+    bool     _shared();
+
+    //-----------------------------------------------------------------------------
+    //! @brief Check whether this file is still in streaming mode.
+    //!
+    //! @return true if every requester of the file is streaming it.
+    //-----------------------------------------------------------------------------
+
+    bool     _streaming();
+
     std::mutex  _fileMutex;
     std::string _fPath;
     Memory&     _memory;
     MemInfo     _memInfo;              // Protected by _fileMutex
     int         _refs = 1;             // Protected by cacheMutex
+    uint64_t    _lockedSize = 0;       // Bytes locked so far, protected by _fileMutex
+    uint64_t    _evictedSize = 0;      // Bytes evicted behind the cursor, ditto
     bool        _isMapped   = false;   // Protected by _fileMutex
     bool        _isReserved = false;   // Ditto
     bool        _isLocked   = false;   // Ditto
     bool        _isFlex;               // Set once at object creation
+    bool        _isStreaming;          // Protected by cacheMutex, only ever
+                                       // cleared after object creation
 };
 
 }}} // namespace lsst:qserv:memman
@@ -64,7 +64,8 @@ int MemFileSet::add(std::string const& tabname, int chunk,
 
     // Obtain a memory file object for this table and chunk
     //
-    MemFile::MFResult mfResult = MemFile::obtain(fPath, _memory, !mustLK);
+    MemFile::MFResult mfResult = MemFile::obtain(fPath, _memory, !mustLK,
+                                                 _streaming);
     if (mfResult.mfP == 0) return mfResult.retc;
 
     // Add to the appropriate file set
@@ -117,7 +118,68 @@ int MemFileSet::lockAll(bool strict) {
     return 0;
 }
 
-  
+/******************************************************************************/
+/*                           l o c k I n i t i a l                            */
+/******************************************************************************/
+
+int MemFileSet::lockInitial(bool strict) {
+
+    MemFile::MLResult mlResult;
+    uint64_t totLocked = 0;
+
+    // Lock just the initial region of each required table so the caller may
+    // start the scan; lockRemaining() finishes the job. Failures are handled
+    // exactly as in lockAll().
+    //
+    for (auto mfP : _lockFiles) {
+        mlResult = mfP->memLockInit();
+        totLocked += mlResult.bLocked;
+        if (mlResult.retc != 0 && strict) {
+            _lockBytes += totLocked;
+            return mlResult.retc;
+        }
+    }
+
+    // All done, update the statistics.
+    //
+    _lockBytes += totLocked;
+    return 0;
+}
+
+/******************************************************************************/
+/*                         l o c k R e m a i n i n g                          */
+/******************************************************************************/
+
+int MemFileSet::lockRemaining() {
+
+    MemFile::MLResult mlResult;
+    uint64_t totLocked = 0;
+    int retc = 0;
+
+    // Finish locking the required tables. The caller is already using the
+    // file set so an error here only means some pages stay unlocked; we
+    // record the first error but keep going.
+    //
+    for (auto mfP : _lockFiles) {
+        mlResult = mfP->memLockFinish();
+        totLocked += mlResult.bLocked;
+        if (mlResult.retc != 0 && retc == 0) retc = mlResult.retc;
+    }
+
+    // Try locking as many flexible files as we can, just as lockAll() does,
+    // ignoring all errors as these files may remain unlocked.
+    //
+    for (auto mfP : _flexFiles) {
+        mlResult = mfP->memLock();
+        totLocked += mlResult.bLocked;
+    }
+
+    // All done, update the statistics.
+    //
+    _lockBytes += totLocked;
+    return retc;
+}
+
 /******************************************************************************/
 /*                                m a p A l l                                 */
 /******************************************************************************/
@@ -88,6 +88,29 @@ public:
 
     int    lockAll(bool strict);
 
+    //-----------------------------------------------------------------------------
+    //! @bried Lock the initial region of every required table in a table set
+    //!        so a query may start scanning. Call lockRemaining() afterwards
+    //!        to lock the rest of the set.
+    //!
+    //! @param strict- Same meaning as for lockAll().
+    //!
+    //! @return =0 the initial region of each required file was locked.
+    //! @return !0 A required file could not be locked, errno value is returned.
+    //-----------------------------------------------------------------------------
+
+    int    lockInitial(bool strict);
+
+    //-----------------------------------------------------------------------------
+    //! @bried Lock whatever lockInitial() left unlocked, required tables first
+    //!        and then as many flexible files as possible.
+    //!
+    //! @return =0 all required bytes that could be locked were locked.
+    //! @return !0 A required file could not be locked, errno value is returned.
+    //-----------------------------------------------------------------------------
+
+    int    lockRemaining();
+
     //-----------------------------------------------------------------------------
     //! @bried Map all of the required tables in a table set and as many
     //!        flexible files as possible.
@@ -133,15 +156,19 @@ public:
     //-----------------------------------------------------------------------------
     //! @brief Constructor
     //!
-    //! @param  memory  - Memory object that owns this file set.
-    //! @param  numLock - Initial allocation for lock files vector.
-    //! @param  numFlex - Initial allocation for flex files vector.
-    //! @param  chunk   - The associated chunk number.
+    //! @param  memory    - Memory object that owns this file set.
+    //! @param  numLock   - Initial allocation for lock files vector.
+    //! @param  numFlex   - Initial allocation for flex files vector.
+    //! @param  chunk     - The associated chunk number.
+    //! @param  streaming - When true the files are read once, front to back,
+    //!                     and memory behind the scan cursor may be released,
+    //!                     see MemMan::prepare().
     //-----------------------------------------------------------------------------
 
-    MemFileSet(Memory& memory, int numLock, int numFlex, int chunk)
+    MemFileSet(Memory& memory, int numLock, int numFlex, int chunk,
+               bool streaming=false)
               : _memory(memory), _lockBytes(0), _numFiles(0), _chunk(chunk),
-                _mtxLocked(false) {
+                _mtxLocked(false), _streaming(streaming) {
                 _lockFiles.reserve(numLock);
                 _flexFiles.reserve(numFlex);
               }
@@ -157,6 +184,7 @@ private:
     uint32_t              _numFiles;
     int                   _chunk;
     std::atomic_bool      _mtxLocked;     // true -> _setMutex is locked
+    bool                  _streaming;     // Set at construction time
 };
 
 }}} // namespace lsst:qserv:memman
@@ -79,11 +79,12 @@ namespace memman {
 /*                                C r e a t e                                 */
 /******************************************************************************/
   
-MemMan *MemMan::create(uint64_t maxBytes, std::string const &dbPath) {
+MemMan *MemMan::create(uint64_t maxBytes, std::string const &dbPath,
+                       bool hugePages) {
 
     // Return a memory manager implementation
     //
-    return new MemManReal(dbPath, maxBytes);
+    return new MemManReal(dbPath, maxBytes, hugePages);
 }
 }}} // namespace lsst:qserv:memman
 
@@ -87,14 +87,21 @@ public:
     //-----------------------------------------------------------------------------
     //! @brief Create a memory manager and initialize for processing.
     //!
-    //! @param  maxBytes   - Maximum amount of memory that can be used
+    //! @param  maxBytes   - Maximum amount of memory that can be used. Under
+    //!                      a cgroup v2 memory limit this is only an upper
+    //!                      bound; the effective budget tracks the cgroup
+    //!                      limit, which may be resized at any time.
     //! @param  dbPath     - Path to directory where the database resides
+    //! @param  hugePages  - When true, mapped files are advised to use
+    //!                      transparent huge pages to reduce page table
+    //!                      pressure when locking and scanning large chunks.
     //!
     //! @return !0: The pointer to the memory manager.
     //! @return  0: A manager could not be created.
     //-----------------------------------------------------------------------------
 
-    static MemMan* create(uint64_t maxBytes, std::string const& dbPath);
+    static MemMan* create(uint64_t maxBytes, std::string const& dbPath,
+                          bool hugePages=true);
 
     //-----------------------------------------------------------------------------
     //! @brief Lock a set of tables in memory passed to the prepare() method.
@@ -129,11 +136,122 @@ public:
     virtual int    lock(Handle handle, bool strict=false) = 0;
 
     //-----------------------------------------------------------------------------
-    //! @briefPrepare a set of tables for locking into memory.
+    //! @brief Lock enough of each required table for a query to start, see
+    //!        lock() for the meaning of the arguments and return value.
+    //!
+    //! Call lockRemaining() afterwards to lock the rest of the tables; the
+    //! remaining pages are faulted in while the query runs. The default
+    //! implementation simply locks everything up front.
+    //-----------------------------------------------------------------------------
+
+    virtual int    lockInitial(Handle handle, bool strict=false) {
+                       return lock(handle, strict);
+                   }
+
+    //-----------------------------------------------------------------------------
+    //! @brief Lock whatever lockInitial() left unlocked.
+    //!
+    //! @param  handle - Handle returned by prepare() given a set of tables.
+    //!
+    //! @return =0     - All remaining bytes that could be locked were locked.
+    //! @return !0     - The errno reason some pages remain unlocked. The
+    //!                  handle stays valid either way as the query is already
+    //!                  running; release it with unlock(), as usual.
+    //-----------------------------------------------------------------------------
+
+    virtual int    lockRemaining(Handle handle) {return 0;}
+
+    //-----------------------------------------------------------------------------
+    //! @brief Forecast the number of bytes needed to lock a set of tables.
+    //!
+    //! The forecast is computed from the file sizes alone; no memory is
+    //! reserved and no files are mapped. Only REQUIRED tables are counted as
+    //! only they can make lock() fail. Files already locked by another file
+    //! set are counted again, so this is an upper bound.
     //!
     //! @param  tables - Reference to the tables to process.
     //! @param  chunk  - The chunk number associated with the tables.
     //!
+    //! @return The number of bytes a prepare()/lock() of the tables requires.
+    //-----------------------------------------------------------------------------
+
+    virtual uint64_t bytesRequired(std::vector<TableInfo> const& tables,
+                                   int chunk) {return 0;}
+
+    //-----------------------------------------------------------------------------
+    //! @brief Obtain the number of bytes still available for locking.
+    //!
+    //! Together with bytesRequired() this lets a scheduler pack work to the
+    //! memory budget instead of discovering overcommitment via an ENOMEM
+    //! from prepare(). The default is unlimited so implementations without
+    //! real accounting never turn work away.
+    //!
+    //! @return The number of bytes free, accounting for reserved bytes.
+    //-----------------------------------------------------------------------------
+
+    virtual uint64_t bytesFree() {return ~0ULL;}
+
+    //-----------------------------------------------------------------------------
+    //! @brief Change the maximum amount of memory that can be used.
+    //!
+    //! The new budget takes effect for subsequent admissions; memory which
+    //! is already locked is unaffected even if it exceeds a reduced budget,
+    //! it simply drains as its queries complete. Implementations without
+    //! real accounting ignore the call.
+    //!
+    //! @param  maxBytes - Maximum amount of memory that can be used.
+    //-----------------------------------------------------------------------------
+
+    virtual void setMaxBytes(uint64_t maxBytes) {}
+
+    //-----------------------------------------------------------------------------
+    //! @brief Ask for admission to reserve memory for a chunk's tables.
+    //!
+    //! Callers poll for memory and simply retry after a failed reservation,
+    //! so grants would otherwise follow retry arrival order. This call
+    //! imposes a policy on those retries: the caller is registered as a
+    //! waiter under (priority, age) and the call returns false while another
+    //! waiter holds a better claim, so memory freed by a finishing scan goes
+    //! to the fastest tier's oldest request rather than to whichever retry
+    //! happens to arrive first. To keep a busy fast tier from starving the
+    //! slow ones, a waiter that has waited past a starvation floor is served
+    //! first regardless of priority. Waiters that stop polling expire.
+    //! A caller whose reservation succeeds must call withdraw().
+    //!
+    //! @param  chunk    - The chunk number associated with the tables.
+    //! @param  priority - The scan priority of the requesting query (a
+    //!                    proto::ScanInfo rating, lower is faster).
+    //!
+    //! @return true     - The caller holds the best claim (or no other
+    //!                    waiters exist) and may attempt the reservation.
+    //! @return false    - A better claim is waiting; retry later.
+    //-----------------------------------------------------------------------------
+
+    virtual bool admit(int chunk, int priority) { return true; }
+
+    //-----------------------------------------------------------------------------
+    //! @brief Drop the caller's waiter claim on memory for a chunk, after
+    //!        a successful reservation or when abandoning the request.
+    //!
+    //! @param  chunk - The chunk number passed to admit().
+    //-----------------------------------------------------------------------------
+
+    virtual void withdraw(int chunk) {}
+
+    //-----------------------------------------------------------------------------
+    //! @briefPrepare a set of tables for locking into memory.
+    //!
+    //! @param  tables    - Reference to the tables to process.
+    //! @param  chunk     - The chunk number associated with the tables.
+    //! @param  streaming - When true the caller scans each table once, front
+    //!                     to back, and never rereads a byte. Implementations
+    //!                     may then release memory behind the scan cursor
+    //!                     instead of keeping the whole table locked; see
+    //!                     MemFile for the details. One-pass low-priority
+    //!                     scans should set this so their tables do not sit
+    //!                     in memory twice, once locked here and once in the
+    //!                     database server's own caches.
+    //!
     //! @return =0     - Nothing was locked. The errno variable holds the
     //!                  reason, as follows:
     //!                  xxxxxx - filesystem or memory error
@@ -142,7 +260,8 @@ public:
     //! @return !0     - Is the resource handle associated with this request.
     //-----------------------------------------------------------------------------
 
-    virtual Handle prepare(std::vector<TableInfo> const& tables, int chunk) = 0;
+    virtual Handle prepare(std::vector<TableInfo> const& tables, int chunk,
+                           bool streaming=false) = 0;
 
     //-----------------------------------------------------------------------------
     //! @brief Unlock a set of tables previously locked by the lock() or were
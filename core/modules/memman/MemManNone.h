@@ -45,8 +45,9 @@ public:
 
     int    lock(Handle handle, bool strict=false) override {return 0;}
 
-    Handle prepare(std::vector<TableInfo> const& tables, int chunk) override {
-               (void)chunk;
+    Handle prepare(std::vector<TableInfo> const& tables, int chunk,
+                   bool streaming=false) override {
+               (void)chunk; (void)streaming;
                if (_alwaysLock) return HandleType::ISEMPTY;
                for (auto it=tables.begin() ; it != tables.end(); it++) {
                    if (it->theData  == TableInfo::LockType::REQUIRED
@@ -52,6 +52,104 @@ namespace lsst {
 namespace qserv {
 namespace memman {
   
+/******************************************************************************/
+/*                                 a d m i t                                  */
+/******************************************************************************/
+
+bool MemManReal::admit(int chunk, int priority) {
+
+    using std::chrono::steady_clock;
+
+    // A waiter that has not polled for this long has stopped retrying
+    // (its task was cancelled or served another way) and is dropped.
+    static constexpr std::chrono::seconds waiterExpiry{10};
+
+    // A waiter older than this is served before better-priority waiters,
+    // so a busy fast tier cannot starve the slow ones indefinitely.
+    static constexpr std::chrono::seconds starvationFloor{60};
+
+    steady_clock::time_point const now = steady_clock::now();
+
+    std::lock_guard<std::mutex> guard(_admitMutex);
+
+    // Register or refresh this caller's claim, and drop expired waiters.
+    //
+    auto it = _waiters.find(chunk);
+    if (it == _waiters.end()) {
+        _waiters[chunk] = Waiter{priority, now, now};
+    } else {
+        it->second.priority = priority;
+        it->second.lastSeen = now;
+    }
+    for (auto wIt = _waiters.begin(); wIt != _waiters.end();) {
+        if (now - wIt->second.lastSeen > waiterExpiry) wIt = _waiters.erase(wIt);
+            else ++wIt;
+    }
+
+    // Find the best claim: lowest priority value, oldest first within a
+    // priority. A waiter past the starvation floor trumps everything.
+    //
+    auto best = _waiters.begin();
+    for (auto wIt = std::next(best); wIt != _waiters.end(); ++wIt) {
+        Waiter const& w = wIt->second;
+        Waiter const& b = best->second;
+        bool const wStarved = now - w.firstWait > starvationFloor;
+        bool const bStarved = now - b.firstWait > starvationFloor;
+        if (wStarved != bStarved) {
+            if (wStarved) best = wIt;
+            continue;
+        }
+        if (wStarved) { // both starved, oldest first
+            if (w.firstWait < b.firstWait) best = wIt;
+            continue;
+        }
+        if (w.priority != b.priority) {
+            if (w.priority < b.priority) best = wIt;
+        } else if (w.firstWait < b.firstWait) {
+            best = wIt;
+        }
+    }
+    return best->first == chunk;
+}
+
+/******************************************************************************/
+/*                              w i t h d r a w                               */
+/******************************************************************************/
+
+void MemManReal::withdraw(int chunk) {
+    std::lock_guard<std::mutex> guard(_admitMutex);
+    _waiters.erase(chunk);
+}
+
+/******************************************************************************/
+/*                         b y t e s R e q u i r e d                          */
+/******************************************************************************/
+
+uint64_t MemManReal::bytesRequired(std::vector<TableInfo> const& tables,
+                                   int chunk) {
+
+    uint64_t totBytes = 0;
+
+    // Sum the file sizes of the required tables. Flexible tables are skipped
+    // as prepare() and lock() succeed whether or not they can be locked. Any
+    // file that cannot be stat'ed is counted as zero; the error will surface
+    // in prepare() where it can be properly handled.
+    //
+    for (auto&& tab : tables) {
+        if (tab.theData == TableInfo::LockType::REQUIRED) {
+            MemInfo mInfo = _memory.fileInfo(_memory.filePath(tab.tableName,
+                                                              chunk, false));
+            if (mInfo.isValid()) totBytes += mInfo.size();
+        }
+        if (tab.theIndex == TableInfo::LockType::REQUIRED) {
+            MemInfo mInfo = _memory.fileInfo(_memory.filePath(tab.tableName,
+                                                              chunk, true));
+            if (mInfo.isValid()) totBytes += mInfo.size();
+        }
+    }
+    return totBytes;
+}
+
 /******************************************************************************/
 /*                         g e t S t a t i s t i c s                          */
 /******************************************************************************/
@@ -160,12 +258,97 @@ int MemManReal::lock(MemMan::Handle handle, bool strict) {
     //
     return rc;
 }
-  
+
+/******************************************************************************/
+/*                           l o c k I n i t i a l                            */
+/******************************************************************************/
+
+int MemManReal::lockInitial(MemMan::Handle handle, bool strict) {
+
+    MemFileSet* fsP = nullptr;
+    int rc;
+
+    // If this is a nil handle, then we need not do anything more. If this is
+    // a bad handle, return failure.
+    //
+    if (handle == HandleType::ISEMPTY) return 0;
+    if (handle == HandleType::INVALID) return EINVAL;
+
+    // Find the table set in the set cache and lock it, just as lock() does.
+    //
+    {    std::lock_guard<std::mutex> guard(hanMutex);
+         auto it = hanCache.find(handle);
+         if (it == hanCache.end() || !(it->second->isOwner(_memory))) {
+             return ENOENT;
+         }
+         fsP = it->second;
+         fsP->serialize(true);
+         _numLocks++;
+    }
+
+    // Lock the initial regions and then drop the file set lock.
+    //
+    rc = fsP->lockInitial(strict);
+    fsP->serialize(false);
+
+    // If there was an error, check if we should delete this handle
+    //
+    if (rc != 0) {
+        _numLkerrs++;
+        if (strict) unlock(handle);
+    }
+
+    // Return result
+    //
+    return rc;
+}
+
+/******************************************************************************/
+/*                         l o c k R e m a i n i n g                          */
+/******************************************************************************/
+
+int MemManReal::lockRemaining(MemMan::Handle handle) {
+
+    MemFileSet* fsP = nullptr;
+    int rc;
+
+    // If this is a nil handle, then we need not do anything more. If this is
+    // a bad handle, return failure.
+    //
+    if (handle == HandleType::ISEMPTY) return 0;
+    if (handle == HandleType::INVALID) return EINVAL;
+
+    // Find the table set in the set cache. The handle may have been unlocked
+    // since lockInitial() released the query; ENOENT is then the right answer.
+    //
+    {    std::lock_guard<std::mutex> guard(hanMutex);
+         auto it = hanCache.find(handle);
+         if (it == hanCache.end() || !(it->second->isOwner(_memory))) {
+             return ENOENT;
+         }
+         fsP = it->second;
+         fsP->serialize(true);
+    }
+
+    // Lock the remaining regions and then drop the file set lock. The query
+    // is already running so an error only means some pages stay unlocked;
+    // the handle is not deleted here.
+    //
+    rc = fsP->lockRemaining();
+    fsP->serialize(false);
+    if (rc != 0) _numLkerrs++;
+
+    // Return result
+    //
+    return rc;
+}
+
 /******************************************************************************/
 /*                               p r e p a r e                                */
 /******************************************************************************/
   
-MemMan::Handle MemManReal::prepare(std::vector<TableInfo> const& tables, int chunk) {
+MemMan::Handle MemManReal::prepare(std::vector<TableInfo> const& tables, int chunk,
+                                   bool streaming) {
 
     int  lockNum, flexNum, retc = 0;
     bool mustLock;
@@ -187,7 +370,8 @@ MemMan::Handle MemManReal::prepare(std::vector<TableInfo> const& tables, int chu
 
     // Allocate an empty file set sized to handle this request
     //
-    MemFileSet* fileSet = new MemFileSet(_memory, lockNum, flexNum, chunk);
+    MemFileSet* fileSet = new MemFileSet(_memory, lockNum, flexNum, chunk,
+                                         streaming);
 
     // Pass 2: Add required files to the file set
     //
@@ -26,6 +26,8 @@
 
 // System headers
 #include <atomic>
+#include <chrono>
+#include <map>
 #include <mutex>
 #include <unordered_map>
 
@@ -44,9 +46,25 @@ class MemFileSet;
 class MemManReal : public MemMan {
 public:
 
+    bool   admit(int chunk, int priority) override;
+
+    void   withdraw(int chunk) override;
+
     int    lock(Handle handle, bool strict=false) override;
 
-    Handle prepare(std::vector<TableInfo> const& tables, int chunk) override;
+    int    lockInitial(Handle handle, bool strict=false) override;
+
+    int    lockRemaining(Handle handle) override;
+
+    uint64_t bytesRequired(std::vector<TableInfo> const& tables,
+                           int chunk) override;
+
+    uint64_t bytesFree() override {return _memory.bytesFree();}
+
+    void   setMaxBytes(uint64_t maxBytes) override {_memory.setCfgBytes(maxBytes);}
+
+    Handle prepare(std::vector<TableInfo> const& tables, int chunk,
+                   bool streaming=false) override;
 
     bool   unlock(Handle handle) override;
 
@@ -59,14 +77,24 @@ public:
     MemManReal & operator=(const MemManReal&) = delete;
     MemManReal(const MemManReal&) = delete;
 
-    MemManReal(std::string const& dbPath, uint64_t maxBytes)
-              : _memory(dbPath, maxBytes), _numErrors(0), _numLkerrs(0),
+    MemManReal(std::string const& dbPath, uint64_t maxBytes, bool hugePages=true)
+              : _memory(dbPath, maxBytes, hugePages), _numErrors(0), _numLkerrs(0),
                 _numLocks(0), _numReqdFiles(0), _numFlexFiles(0) {}
 
     ~MemManReal() override {unlockAll();}
 
 private:
 
+    //! One registered memory waiter, see admit().
+    struct Waiter {
+        int priority;
+        std::chrono::steady_clock::time_point firstWait; //< For (priority, age) order
+        std::chrono::steady_clock::time_point lastSeen;  //< For expiring dead waiters
+    };
+
+    std::mutex           _admitMutex;  //< Guards _waiters
+    std::map<int,Waiter> _waiters;     //< Waiters by chunk number
+
     Memory           _memory;
     std::atomic_uint _numErrors;
     std::atomic_uint _numLkerrs;
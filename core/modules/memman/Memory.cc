@@ -27,10 +27,53 @@
 // System Headers
 #include <errno.h>
 #include <fcntl.h>
+#include <fstream>
 #include <sys/mman.h>
 #include <sys/stat.h>
 #include <sys/types.h>
 
+/******************************************************************************/
+/*                  L o c a l   S t a t i c   O b j e c t s                   */
+/******************************************************************************/
+
+namespace {
+
+// How often the cgroup memory limit and usage are re-read. Operations resizes
+// cgroups rarely, so anything well under a minute just burns sysfs reads.
+std::chrono::seconds const budgetRefreshInterval(30);
+
+// Read a single cgroup v2 value file. Returns false if the file cannot be
+// read or holds no limit (i.e. "max"), in which case value is untouched.
+//
+bool readCgroupValue(std::string const& fPath, uint64_t& value) {
+    std::ifstream f(fPath);
+    if (!f.is_open()) return false;
+    std::string line;
+    if (!std::getline(f, line) || line.empty() || line == "max") return false;
+    try {
+        value = std::stoull(line);
+    } catch (std::exception const&) {
+        return false;
+    }
+    return true;
+}
+
+// Find the cgroup v2 directory of this process. Returns an empty string if
+// the process is not in a cgroup v2 hierarchy. The unified hierarchy entry
+// in /proc/self/cgroup is the one with an empty controller list ("0::...").
+//
+std::string findCgroupDir() {
+    std::ifstream f("/proc/self/cgroup");
+    std::string line;
+    while(std::getline(f, line)) {
+        if (line.compare(0, 3, "0::") == 0) {
+            return std::string("/sys/fs/cgroup") + line.substr(3);
+        }
+    }
+    return std::string();
+}
+}
+
 namespace lsst {
 namespace qserv {
 namespace memman {
@@ -107,6 +150,46 @@ int Memory::memLock(MemInfo mInfo, bool isFlex) {
     return (errno == EAGAIN ? ENOMEM : errno);
 }
 
+/******************************************************************************/
+/*                         m e m L o c k R e g i o n                          */
+/******************************************************************************/
+
+int Memory::memLockRegion(MemInfo mInfo, uint64_t offset, uint64_t bytes) {
+
+    // Verify that this is a valid mapping and the region is inside it
+    //
+    if (!mInfo.isValid() || offset >= mInfo._memSize) return EFAULT;
+    if (bytes > mInfo._memSize - offset) bytes = mInfo._memSize - offset;
+
+    // Lock this region into memory. Return success if this worked.
+    //
+    if (!mlock(static_cast<char*>(mInfo._memAddr) + offset, bytes)) {
+        _lokBytes += bytes;
+        return 0;
+    }
+
+    // Return failure
+    //
+    _numLokErrs++;
+    return (errno == EAGAIN ? ENOMEM : errno);
+}
+
+/******************************************************************************/
+/*                          m e m R e a d A h e a d                           */
+/******************************************************************************/
+
+void Memory::memReadAhead(MemInfo mInfo, uint64_t offset, uint64_t bytes) {
+
+    // Verify that this is a valid mapping and the region is inside it
+    //
+    if (!mInfo.isValid() || offset >= mInfo._memSize) return;
+    if (bytes > mInfo._memSize - offset) bytes = mInfo._memSize - offset;
+
+    // This is only advice, so any error can be safely ignored.
+    //
+    madvise(static_cast<char*>(mInfo._memAddr) + offset, bytes, MADV_WILLNEED);
+}
+
 /******************************************************************************/
 /*                               m a p F i l e                                */
 /******************************************************************************/
@@ -146,6 +229,20 @@ MemInfo Memory::mapFile(std::string const& fPath) {
     if (mInfo._memAddr == MAP_FAILED) {
         mInfo.setErrCode(errno);
         _numMapErrs++;
+    } else {
+        // Tell the kernel how the mapping will be used. Chunks are scanned
+        // front to back, so sequential readahead helps; huge pages collapse
+        // hundreds of 4K page table entries into one, which speeds up both
+        // the mlock() and the scan itself. MAP_HUGETLB does not apply to
+        // ordinary file-backed mappings, so we rely on khugepaged via
+        // MADV_HUGEPAGE. This is only advice, so errors are ignored.
+        //
+        madvise(mInfo._memAddr, mInfo._memSize, MADV_SEQUENTIAL);
+#if defined(MADV_HUGEPAGE)
+        if (_mapHugePages) {
+            madvise(mInfo._memAddr, mInfo._memSize, MADV_HUGEPAGE);
+        }
+#endif
     }
 
     // Close the file and return result
@@ -154,19 +251,82 @@ MemInfo Memory::mapFile(std::string const& fPath) {
     return mInfo;
 }
 
+/******************************************************************************/
+/*                        _ r e f r e s h B u d g e t                         */
+/******************************************************************************/
+
+void Memory::_refreshBudget() {
+
+    // Between refreshes this is a single clock read. The caller holds
+    // _memMutex, so the bookkeeping below needs no further protection.
+    //
+    auto now = std::chrono::steady_clock::now();
+    if (now < _nextBudgetCheck) return;
+    _nextBudgetCheck = now + budgetRefreshInterval;
+
+    // Locate our cgroup directory the first time through. A cgroup whose
+    // limit file cannot be read is treated as no cgroup at all; the
+    // configured maximum then remains the budget.
+    //
+    if (!_cgroupResolved) {
+        _cgroupResolved = true;
+        _cgroupDir = findCgroupDir();
+    }
+    if (_cgroupDir.empty()) return;
+
+    // Read the cgroup limit and its current usage. The usage includes our
+    // own locked bytes, so they are added back to get the memory available
+    // to us; what remains is used by everything else in the cgroup (e.g.
+    // mysqld and the page cache charged to it). Unreadable files leave the
+    // budget at the configured maximum.
+    //
+    uint64_t cgLimit, cgUsage;
+    if (!readCgroupValue(_cgroupDir + "/memory.max", cgLimit)
+    ||  !readCgroupValue(_cgroupDir + "/memory.current", cgUsage)) {
+        _maxBytes = _cfgBytes;
+        return;
+    }
+    uint64_t otherBytes = (cgUsage > _lokBytes ? cgUsage - _lokBytes : 0);
+    uint64_t availBytes = (cgLimit > otherBytes ? cgLimit - otherBytes : 0);
+    _maxBytes = (availBytes < _cfgBytes ? availBytes : _cfgBytes);
+}
+
+/******************************************************************************/
+/*                          m e m R e l R e g i o n                           */
+/******************************************************************************/
+
+void Memory::memRelRegion(MemInfo mInfo, uint64_t offset, uint64_t bytes) {
+
+    // Verify that this is a valid mapping and the region is inside it
+    //
+    if (!mInfo.isValid() || offset >= mInfo._memSize) return;
+    if (bytes > mInfo._memSize - offset) bytes = mInfo._memSize - offset;
+
+    // Unlock the region and drop its pages. The mapping is read-only so the
+    // pages are clean and can be discarded without any writeback. Errors can
+    // be ignored; at worst the pages linger until normal reclaim finds them.
+    //
+    if (!munlock(static_cast<char*>(mInfo._memAddr) + offset, bytes)) {
+        std::lock_guard<std::mutex> guard(_memMutex);
+        if (_lokBytes > bytes) _lokBytes -= bytes;
+        else _lokBytes = 0;
+    }
+    madvise(static_cast<char*>(mInfo._memAddr) + offset, bytes, MADV_DONTNEED);
+}
+
 /******************************************************************************/
 /*                                m e m R e l                                 */
 /******************************************************************************/
-  
-void Memory::memRel(MemInfo& mInfo, bool islkd) {
+
+void Memory::memRel(MemInfo& mInfo, uint64_t lkdBytes) {
 
     // If this is a valid object then unmap/unlock it (munmap does it for us).
     //
     if (mInfo._memSize > 0 && mInfo._memAddr != MAP_FAILED) {
         munmap(mInfo._memAddr, mInfo._memSize);
-        if (islkd) {
+        if (lkdBytes > 0) {
             _memMutex.lock();
-            if (_lokBytes > mInfo._memSize) _lokBytes -= mInfo._memSize;
+            if (_lokBytes > lkdBytes) _lokBytes -= lkdBytes;
             else _lokBytes = 0;
             _memMutex.unlock();
         }
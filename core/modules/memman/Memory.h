@@ -26,6 +26,7 @@
 
 // System headers
 #include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <mutex>
 #include <string>
@@ -100,15 +101,34 @@ public:
 
     //-----------------------------------------------------------------------------
     //! Obtain number of bytes free (this takes into account reserved bytes).
+    //! As this is the admission gate, the memory budget is re-evaluated
+    //! against the cgroup limit here, see _refreshBudget().
     //!
     //! @return The number of bytes free.
     //-----------------------------------------------------------------------------
 
     uint64_t bytesFree() {
         std::lock_guard<std::mutex> guard(_memMutex);
+        _refreshBudget();
         return (_maxBytes <= _rsvBytes ? 0 : _maxBytes - _rsvBytes);
     }
 
+    //-----------------------------------------------------------------------------
+    //! Change the configured maximum number of bytes. The budget is
+    //! re-evaluated against the cgroup limit at the next admission, so the
+    //! effective maximum never exceeds what the cgroup allows. Bytes already
+    //! locked are unaffected by a reduced budget.
+    //!
+    //! @param memSZ - New maximum amount of memory that can be used.
+    //-----------------------------------------------------------------------------
+
+    void setCfgBytes(uint64_t memSZ) {
+        std::lock_guard<std::mutex> guard(_memMutex);
+        _cfgBytes = memSZ;
+        _maxBytes = memSZ;
+        _nextBudgetCheck = std::chrono::steady_clock::time_point();
+    }
+
     //-----------------------------------------------------------------------------
     //! @brief Get file information.
     //!
@@ -148,6 +168,31 @@ public:
 
     int     memLock(MemInfo mInfo, bool isFlex);
 
+    //-----------------------------------------------------------------------------
+    //! @brief Lock a region of a mapped database file in memory.
+    //!
+    //! @param  mInfo  - The memory mapping returned by mapFile().
+    //! @param  offset - Byte offset of the region. It must be aligned to a
+    //!                  page boundary.
+    //! @param  bytes  - Length of the region. It is trimmed to the mapping.
+    //!
+    //! @return =0     - Memory was locked.
+    //! @return !0     - Memory not locked, returned value is the errno.
+    //-----------------------------------------------------------------------------
+
+    int     memLockRegion(MemInfo mInfo, uint64_t offset, uint64_t bytes);
+
+    //-----------------------------------------------------------------------------
+    //! @brief Ask the kernel to page in a region of a mapping ahead of need.
+    //!
+    //! @param  mInfo  - The memory mapping returned by mapFile().
+    //! @param  offset - Byte offset of the region. It must be aligned to a
+    //!                  page boundary.
+    //! @param  bytes  - Length of the region. It is trimmed to the mapping.
+    //-----------------------------------------------------------------------------
+
+    void    memReadAhead(MemInfo mInfo, uint64_t offset, uint64_t bytes);
+
     //-----------------------------------------------------------------------------
     //! @brief Map a database file in memory.
     //!
@@ -163,12 +208,27 @@ public:
     //-----------------------------------------------------------------------------
     //! @brief Unlock a memory object.
     //!
-    //! @param  mInfo   - Memory MemInfo object returned by memLock(). It is
-    //!                   reset to an invalid state upon return.
-    //! @param  islkd   - When true, update locked memory statistics.
+    //! @param  mInfo    - Memory MemInfo object returned by memLock(). It is
+    //!                    reset to an invalid state upon return.
+    //! @param  lkdBytes - Number of bytes of the mapping that were locked,
+    //!                    used to update the locked memory statistics. With
+    //!                    incremental locking this may be less than the size
+    //!                    of the mapping.
+    //-----------------------------------------------------------------------------
+
+    void    memRel(MemInfo& mInfo, uint64_t lkdBytes);
+
+    //-----------------------------------------------------------------------------
+    //! @brief Unlock a region of memory and tell the kernel its pages are no
+    //!        longer needed. Used to evict data behind a scan cursor while
+    //!        the rest of the mapping stays locked.
+    //!
+    //! @param  mInfo   - Memory mapping information.
+    //! @param  offset  - Offset of the region in the mapping, page aligned.
+    //! @param  bytes   - Size of the region, trimmed to the mapping size.
     //-----------------------------------------------------------------------------
 
-    void    memRel(MemInfo& mInfo, bool islkd);
+    void    memRelRegion(MemInfo mInfo, uint64_t offset, uint64_t bytes);
 
     //-----------------------------------------------------------------------------
     //! @brief Reserve memory for future locking.
@@ -211,8 +271,8 @@ public:
 
     MemStats statistics() {
         MemStats mStats;
-        mStats.bytesMax      = _maxBytes;
         _memMutex.lock();
+        mStats.bytesMax      = _maxBytes;
         mStats.bytesReserved = _rsvBytes;
         mStats.bytesLocked   = _lokBytes;
         _memMutex.unlock();
@@ -225,26 +285,56 @@ public:
     //-----------------------------------------------------------------------------
     //! Constructor
     //!
-    //! @param  dbDir  - Directory path to where managed files reside.
-    //! @param  memSZ  - Size of memory to manage in bytes.
+    //! @param  dbDir     - Directory path to where managed files reside.
+    //! @param  memSZ     - Size of memory to manage in bytes. When the worker
+    //!                     runs under a cgroup v2 memory limit this is only
+    //!                     an upper bound, see _refreshBudget().
+    //! @param  hugePages - When true, advise the kernel to back mappings with
+    //!                     transparent huge pages. Locking a large chunk with
+    //!                     4K pages populates millions of page table entries
+    //!                     and the scan pays for them in dTLB misses.
     //-----------------------------------------------------------------------------
 
-    Memory(std::string const& dbDir, uint64_t memSZ)
-          : _dbDir(dbDir), _maxBytes(memSZ), _lokBytes(0), _rsvBytes(0),
-            _numMapErrs(0), _numLokErrs(0), _flexNum(0) {}
+    Memory(std::string const& dbDir, uint64_t memSZ, bool hugePages=true)
+          : _dbDir(dbDir), _cfgBytes(memSZ), _maxBytes(memSZ),
+            _lokBytes(0), _rsvBytes(0),
+            _numMapErrs(0), _numLokErrs(0), _flexNum(0),
+            _mapHugePages(hugePages) {}
 
     ~Memory() {}
 
 private:
 
+    //-----------------------------------------------------------------------------
+    //! @brief Re-evaluate the memory budget against the cgroup v2 limit.
+    //!        The _memMutex must be held by the caller.
+    //!
+    //! The effective budget is the cgroup memory limit minus the memory used
+    //! by everything else in the cgroup (e.g. mysqld), capped by the
+    //! configured maximum. Operations may resize the cgroup without
+    //! restarting the worker, so the limit is re-read periodically; between
+    //! re-reads this method returns at once. Without a cgroup limit the
+    //! configured maximum is used, as before.
+    //-----------------------------------------------------------------------------
+
+    void    _refreshBudget();
+
     std::string        _dbDir;
     std::mutex         _memMutex;
-    uint64_t           _maxBytes;    // Set at construction time
-    uint64_t           _lokBytes;    // Protected by _memMutex
+    uint64_t           _cfgBytes;    // Set at construction time
+    uint64_t           _maxBytes;    // Protected by _memMutex
+    uint64_t           _lokBytes;    // Ditto
     uint64_t           _rsvBytes;    // Ditto
     std::atomic_uint   _numMapErrs;
     std::atomic_uint   _numLokErrs;
     std::atomic_uint   _flexNum;
+    bool               _mapHugePages; // Set at construction time
+
+    // Budget refresh state, all protected by _memMutex.
+    //
+    std::chrono::steady_clock::time_point _nextBudgetCheck;
+    std::string        _cgroupDir;       // Empty -> no usable cgroup limit
+    bool               _cgroupResolved = false;
 };
 }}} // namespace lsst:qserv:memman
 #endif  // LSST_QSERV_MEMMAN_MEMORY_H
@@ -0,0 +1,326 @@
+/*
+ * LSST Data Management System
+ * Copyright 2018 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/**
+ * @file
+ *
+ * @brief Microbenchmark and page-fault harness for memman.
+ *
+ * Generates a synthetic chunk file set laid out the way Memory::filePath()
+ * expects ("<dbDir>/<db>/<table>_<chunk>.MYD"), then drives the
+ * prepare()/lock()/unlock() cycle of a real MemManReal instance under a
+ * configurable number of concurrent locker threads and reports:
+ *   - prepare(), lock() and unlock() call latency percentiles;
+ *   - minor/major page faults taken over the drive phase, read from
+ *     /proc/self/stat, absolute and per MB locked;
+ *   - residency accuracy at peak: bytes actually locked (per manager
+ *     statistics) against the bytes the file set required.
+ *
+ * Tables are locked FLEXIBLE by default so the harness degrades gracefully
+ * where RLIMIT_MEMLOCK is small: lock() then succeeds regardless and the
+ * shortfall shows up in the residency figure instead of as a hard failure.
+ * Pass required=1 to make lock failures fatal, as on a production worker.
+ *
+ * Usage: qserv-memman-bench [chunks] [tables] [fileMB] [lockers]
+ *                           [iterations] [budgetMB] [hugepages]
+ *                           [required] [dbDir]
+ *
+ * Defaults: 16 chunks of 2 tables x 4 MB, 4 lockers, 200 lock cycles,
+ * 256 MB budget, no hugepages, FLEXIBLE locks, file set under $TMPDIR.
+ * The file set is created at startup and removed at exit unless an
+ * existing dbDir is given (which is then used and left as is).
+ */
+
+// System headers
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Qserv headers
+#include "memman/MemMan.h"
+
+using namespace lsst::qserv;
+
+namespace {
+
+/// Shape of the synthetic workload.
+struct Shape {
+    int chunks = 16;
+    int tables = 2;       ///< tables per chunk
+    int fileMB = 4;       ///< size of each table file
+    int lockers = 4;      ///< concurrent locker threads
+    int iterations = 200; ///< lock cycles per locker
+    int budgetMB = 256;   ///< memory manager budget
+    bool hugePages = false;
+    bool required = false; ///< REQUIRED locks instead of FLEXIBLE
+};
+
+std::string const benchDb = "memmanbench";
+
+uint64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/// Minor and major fault counts of this process, from /proc/self/stat
+/// (fields 10 and 12; children's counts are not included).
+struct Faults {
+    uint64_t minor = 0;
+    uint64_t major = 0;
+};
+
+Faults readFaults() {
+    Faults faults;
+    std::ifstream stat("/proc/self/stat");
+    std::string field;
+    // Field 2 (comm) may contain spaces but is parenthesized; skip past it.
+    std::getline(stat, field, ')');
+    for (int i = 3; i <= 12 && (stat >> field); ++i) {
+        if (i == 10) faults.minor = std::stoull(field);
+        if (i == 12) faults.major = std::stoull(field);
+    }
+    return faults;
+}
+
+/// Create one synthetic table file of 'mb' MB filled with pseudorandom
+/// bytes, so mapping and locking it behaves like a real chunk rather than
+/// a hole-backed sparse file.
+bool writeFile(std::string const& path, int mb, std::mt19937& rng) {
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (f == nullptr) return false;
+    std::vector<uint32_t> block((1 << 20) / sizeof(uint32_t));
+    for (auto& word : block) word = rng();
+    bool ok = true;
+    for (int i = 0; i != mb && ok; ++i) {
+        ok = std::fwrite(block.data(), 1, 1 << 20, f) == (1 << 20);
+    }
+    return (std::fclose(f) == 0) && ok;
+}
+
+/// The table set of one chunk, named as Memory::filePath() will resolve it.
+std::vector<memman::TableInfo> chunkTables(Shape const& shape) {
+    memman::TableInfo::LockType const lockType = shape.required
+            ? memman::TableInfo::LockType::REQUIRED
+            : memman::TableInfo::LockType::FLEXIBLE;
+    std::vector<memman::TableInfo> tables;
+    for (int t = 0; t != shape.tables; ++t) {
+        tables.emplace_back(benchDb + "/Object" + std::to_string(t),
+                            lockType, memman::TableInfo::LockType::NOLOCK);
+    }
+    return tables;
+}
+
+void printPercentiles(char const* name, std::vector<uint64_t>& ns) {
+    if (ns.empty()) return;
+    std::sort(ns.begin(), ns.end());
+    auto at = [&ns](double p) {
+        return ns[std::min(ns.size() - 1, size_t(p * ns.size()))];
+    };
+    std::printf("%-10s %8llu ns/call p50  %8llu p90  %8llu p99  %8llu max  (%zu calls)\n",
+                name,
+                static_cast<unsigned long long>(at(0.50)),
+                static_cast<unsigned long long>(at(0.90)),
+                static_cast<unsigned long long>(at(0.99)),
+                static_cast<unsigned long long>(ns.back()), ns.size());
+}
+
+} // namespace
+
+
+int main(int argc, char const* argv[]) {
+
+    Shape shape;
+    std::string dbDir;
+    if (argc > 1) shape.chunks = std::atoi(argv[1]);
+    if (argc > 2) shape.tables = std::atoi(argv[2]);
+    if (argc > 3) shape.fileMB = std::atoi(argv[3]);
+    if (argc > 4) shape.lockers = std::atoi(argv[4]);
+    if (argc > 5) shape.iterations = std::atoi(argv[5]);
+    if (argc > 6) shape.budgetMB = std::atoi(argv[6]);
+    if (argc > 7) shape.hugePages = std::atoi(argv[7]) != 0;
+    if (argc > 8) shape.required = std::atoi(argv[8]) != 0;
+    if (argc > 9) dbDir = argv[9];
+    if (shape.chunks < 1 || shape.tables < 1 || shape.fileMB < 1
+        || shape.lockers < 1 || shape.iterations < 1 || shape.budgetMB < 1) {
+        std::cerr << "usage: qserv-memman-bench [chunks] [tables] [fileMB]"
+                     " [lockers] [iterations] [budgetMB] [hugepages]"
+                     " [required] [dbDir]" << std::endl;
+        return 2;
+    }
+
+    // Generate the synthetic file set (untimed) unless an existing one was
+    // given. A generated set is removed again at exit.
+    bool const generated = dbDir.empty();
+    if (generated) {
+        char const* tmp = std::getenv("TMPDIR");
+        std::string tmplate = std::string(tmp ? tmp : "/tmp") + "/memman-bench-XXXXXX";
+        std::vector<char> buf(tmplate.begin(), tmplate.end());
+        buf.push_back('\0');
+        if (mkdtemp(buf.data()) == nullptr) {
+            std::cerr << "cannot create scratch directory " << tmplate << std::endl;
+            return 1;
+        }
+        dbDir = buf.data();
+        mkdir((dbDir + "/" + benchDb).c_str(), 0755);
+        std::mt19937 rng(42);
+        for (int c = 0; c != shape.chunks; ++c) {
+            for (int t = 0; t != shape.tables; ++t) {
+                std::string const path = dbDir + "/" + benchDb + "/Object"
+                        + std::to_string(t) + "_" + std::to_string(c) + ".MYD";
+                if (!writeFile(path, shape.fileMB, rng)) {
+                    std::cerr << "cannot write " << path << std::endl;
+                    return 1;
+                }
+            }
+        }
+    }
+    uint64_t const chunkBytes = uint64_t(shape.tables) * shape.fileMB << 20;
+    std::printf("fileset    %d chunks x %d tables x %d MB (%s), %d lockers,"
+                " %d iterations, budget %d MB, hugepages %s, %s locks\n",
+                shape.chunks, shape.tables, shape.fileMB,
+                generated ? "generated" : dbDir.c_str(),
+                shape.lockers, shape.iterations, shape.budgetMB,
+                shape.hugePages ? "on" : "off",
+                shape.required ? "REQUIRED" : "FLEXIBLE");
+
+    std::unique_ptr<memman::MemMan> memMan(memman::MemMan::create(
+            uint64_t(shape.budgetMB) << 20, dbDir, shape.hugePages));
+    if (memMan == nullptr) {
+        std::cerr << "cannot create memory manager" << std::endl;
+        return 1;
+    }
+
+    //----- Residency accuracy: lock as many whole chunks as the budget was
+    //      sized for and compare what the manager reports locked with what
+    //      the files required. mlock() shortfalls (RLIMIT_MEMLOCK, cgroup
+    //      limits) surface here as a residency below 100%.
+
+    int const residentChunks = std::min<uint64_t>(
+            shape.chunks, (uint64_t(shape.budgetMB) << 20) / chunkBytes);
+    std::vector<memman::MemMan::Handle> resident;
+    for (int c = 0; c != residentChunks; ++c) {
+        memman::MemMan::Handle const handle = memMan->prepare(chunkTables(shape), c);
+        if (handle == 0) break;
+        if (memMan->lock(handle) != 0) {
+            memMan->unlock(handle);
+            break;
+        }
+        resident.push_back(handle);
+    }
+    memman::MemMan::Statistics const peak = memMan->getStatistics();
+    uint64_t const expectedBytes = uint64_t(resident.size()) * chunkBytes;
+    std::printf("residency  %.1f%% of required bytes locked at peak"
+                " (%llu MB locked, %llu MB required, %u mlock errors)\n",
+                expectedBytes ? 100.0 * peak.bytesLocked / expectedBytes : 0.0,
+                static_cast<unsigned long long>(peak.bytesLocked >> 20),
+                static_cast<unsigned long long>(expectedBytes >> 20),
+                peak.numLokErrors);
+    for (auto const handle : resident) memMan->unlock(handle);
+
+    //----- Drive phase: each locker cycles prepare/lock/unlock over chunks
+    //      of its own residue class, timing each call. Page faults are read
+    //      around the whole phase; they are process-wide, which is what a
+    //      worker cares about.
+
+    std::mutex mergeMutex;
+    std::vector<uint64_t> prepareNs, lockNs, unlockNs;
+    std::vector<std::thread> lockers;
+    std::atomic<bool> failed{false};
+    Faults const before = readFaults();
+    uint64_t const t0 = nowNs();
+    for (int id = 0; id != shape.lockers; ++id) {
+        lockers.emplace_back([&, id]() {
+            std::vector<uint64_t> myPrepare, myLock, myUnlock;
+            for (int i = 0; i != shape.iterations && !failed; ++i) {
+                int const chunk = (id + i * shape.lockers) % shape.chunks;
+                uint64_t t = nowNs();
+                memman::MemMan::Handle const handle
+                        = memMan->prepare(chunkTables(shape), chunk);
+                myPrepare.push_back(nowNs() - t);
+                if (handle == 0) {
+                    if (errno == ENOMEM) continue; // overcommitted, retry later
+                    std::cerr << "prepare failed, errno=" << errno << std::endl;
+                    failed = true;
+                    break;
+                }
+                t = nowNs();
+                int const lkret = memMan->lock(handle);
+                myLock.push_back(nowNs() - t);
+                if (lkret != 0 && lkret != ENOMEM) {
+                    std::cerr << "lock failed, errno=" << lkret << std::endl;
+                    failed = true;
+                }
+                t = nowNs();
+                memMan->unlock(handle);
+                myUnlock.push_back(nowNs() - t);
+            }
+            std::lock_guard<std::mutex> lock(mergeMutex);
+            prepareNs.insert(prepareNs.end(), myPrepare.begin(), myPrepare.end());
+            lockNs.insert(lockNs.end(), myLock.begin(), myLock.end());
+            unlockNs.insert(unlockNs.end(), myUnlock.begin(), myUnlock.end());
+        });
+    }
+    for (auto& locker : lockers) locker.join();
+    uint64_t const driveNs = nowNs() - t0;
+    Faults const after = readFaults();
+
+    if (failed) return 1;
+
+    printPercentiles("prepare", prepareNs);
+    printPercentiles("lock", lockNs);
+    printPercentiles("unlock", unlockNs);
+    uint64_t const lockedMB = (uint64_t(lockNs.size()) * chunkBytes) >> 20;
+    std::printf("faults     %llu minor %llu major over %.2fs drive"
+                " (%.1f minor/MB locked)\n",
+                static_cast<unsigned long long>(after.minor - before.minor),
+                static_cast<unsigned long long>(after.major - before.major),
+                driveNs * 1e-9,
+                lockedMB ? double(after.minor - before.minor) / lockedMB : 0.0);
+
+    memman::MemMan::Statistics const stats = memMan->getStatistics();
+    std::printf("manager    %u locks %u errors %u mmap errors %u mlock errors\n",
+                stats.numLocks, stats.numErrors, stats.numMapErrors,
+                stats.numLokErrors);
+
+    memMan->unlockAll();
+    if (generated) {
+        std::string const cmd = "rm -rf '" + dbDir + "'";
+        if (std::system(cmd.c_str()) != 0) {
+            std::cerr << "could not remove scratch directory " << dbDir << std::endl;
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,230 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "mysql/AsyncQueryMgr.h"
+
+// System headers
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <poll.h>
+#include <unistd.h>
+
+// Third-party headers
+#include <mysql/mysql.h>
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+// Qserv headers
+#include "mysql/MySqlConnection.h"
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.mysql.AsyncQueryMgr");
+
+/// Translate MYSQL_WAIT_* flags into poll() events.
+short pollEvents(int waitStatus) {
+    short events = 0;
+    if (waitStatus & MYSQL_WAIT_READ) events |= POLLIN;
+    if (waitStatus & MYSQL_WAIT_WRITE) events |= POLLOUT;
+    if (waitStatus & MYSQL_WAIT_EXCEPT) events |= POLLPRI;
+    return events;
+}
+
+/// Translate poll() revents into MYSQL_WAIT_* flags.
+int mysqlStatus(short revents) {
+    int status = 0;
+    if (revents & POLLIN) status |= MYSQL_WAIT_READ;
+    if (revents & POLLOUT) status |= MYSQL_WAIT_WRITE;
+    if (revents & POLLPRI) status |= MYSQL_WAIT_EXCEPT;
+    // Treat error conditions as readable so the client library notices
+    // the dead socket and fails the statement.
+    if (revents & (POLLERR | POLLHUP | POLLNVAL)) status |= MYSQL_WAIT_READ;
+    return status;
+}
+
+} // anonymous namespace
+
+
+namespace lsst {
+namespace qserv {
+namespace mysql {
+
+AsyncQueryMgr::Ptr AsyncQueryMgr::instance() {
+    static Ptr mgr = std::make_shared<AsyncQueryMgr>();
+    return mgr;
+}
+
+
+AsyncQueryMgr::AsyncQueryMgr(unsigned int threadCount) {
+    assert(threadCount > 0);
+    for (unsigned int i = 0; i < threadCount; ++i) {
+        std::unique_ptr<Lane> lane(new Lane);
+        int rc = ::pipe(lane->wakeupFd);
+        assert(rc == 0);
+        (void)rc;
+        _lanes.push_back(std::move(lane));
+    }
+    for (unsigned int i = 0; i < threadCount; ++i) {
+        Lane* lane = _lanes[i].get();
+        _threads.emplace_back([this, lane]() { _run(*lane); });
+    }
+}
+
+
+AsyncQueryMgr::~AsyncQueryMgr() {
+    _shutdown = true;
+    for (auto& lane : _lanes) { _wake(*lane); }
+    for (auto& t : _threads) { t.join(); }
+    for (auto& lane : _lanes) {
+        ::close(lane->wakeupFd[0]);
+        ::close(lane->wakeupFd[1]);
+    }
+}
+
+
+void AsyncQueryMgr::submit(MySqlConnection& conn, std::string const& query,
+                           DoneCallback onDone) {
+    auto stmt = std::make_shared<Statement>();
+    stmt->conn = &conn;
+    stmt->query = query;
+    stmt->onDone = onDone;
+    Lane& lane = *_lanes[_laneSeq++ % _lanes.size()];
+    {
+        std::lock_guard<std::mutex> lock(lane.mtx);
+        lane.incoming.push_back(stmt);
+    }
+    _wake(lane);
+}
+
+
+std::future<bool> AsyncQueryMgr::submitFuture(MySqlConnection& conn,
+                                              std::string const& query) {
+    auto promise = std::make_shared<std::promise<bool>>();
+    std::future<bool> future = promise->get_future();
+    submit(conn, query, [promise](bool success) { promise->set_value(success); });
+    return future;
+}
+
+
+void AsyncQueryMgr::_wake(Lane& lane) {
+    char b = 0;
+    ssize_t rc = ::write(lane.wakeupFd[1], &b, 1);
+    (void)rc; // A full pipe already guarantees a wakeup.
+}
+
+
+bool AsyncQueryMgr::_advance(Statement& stmt, int readyStatus) {
+    int rc = 1;
+    if (!stmt.started) {
+        stmt.conn->enableNonBlocking();
+        stmt.waitStatus = stmt.conn->queryStart(stmt.query, rc);
+        stmt.started = true;
+    } else {
+        stmt.waitStatus = stmt.conn->queryCont(readyStatus, rc);
+    }
+    if (stmt.waitStatus != 0) {
+        if (stmt.waitStatus & MYSQL_WAIT_TIMEOUT) {
+            stmt.deadline = std::chrono::steady_clock::now()
+                + std::chrono::milliseconds(stmt.conn->waitTimeoutMs());
+        }
+        return false;
+    }
+    if (rc != 0) {
+        LOGS(_log, LOG_LVL_WARN, "async statement failed: mysql errno="
+             << stmt.conn->getErrno() << " " << stmt.conn->getError());
+    }
+    if (stmt.onDone) { stmt.onDone(rc == 0); }
+    return true;
+}
+
+
+void AsyncQueryMgr::_run(Lane& lane) {
+    std::vector<Statement::Ptr> active;
+    std::vector<struct pollfd> fds;
+    while (!_shutdown) {
+        // Pick up and start newly submitted statements.
+        std::deque<Statement::Ptr> fresh;
+        {
+            std::lock_guard<std::mutex> lock(lane.mtx);
+            fresh.swap(lane.incoming);
+        }
+        for (auto& stmt : fresh) {
+            if (!_advance(*stmt, 0)) { active.push_back(stmt); }
+        }
+        // Wait on the self-pipe plus every active statement's socket.
+        fds.clear();
+        fds.push_back({lane.wakeupFd[0], POLLIN, 0});
+        int timeoutMs = -1;
+        auto now = std::chrono::steady_clock::now();
+        for (auto& stmt : active) {
+            fds.push_back({stmt->conn->socketFd(), pollEvents(stmt->waitStatus), 0});
+            if (stmt->waitStatus & MYSQL_WAIT_TIMEOUT) {
+                auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    stmt->deadline - now).count();
+                int stmtMs = std::max(static_cast<long long>(0),
+                                      static_cast<long long>(ms));
+                if (timeoutMs < 0 || stmtMs < timeoutMs) { timeoutMs = stmtMs; }
+            }
+        }
+        int nReady = ::poll(&fds[0], fds.size(), timeoutMs);
+        if (nReady < 0) {
+            if (errno == EINTR) { continue; }
+            LOGS(_log, LOG_LVL_ERROR, "poll() failed, errno=" << errno);
+            continue;
+        }
+        if (fds[0].revents & POLLIN) { // Drain wakeup bytes.
+            char buf[64];
+            while (::read(lane.wakeupFd[0], buf, sizeof(buf)) == sizeof(buf)) {}
+        }
+        // Continue statements whose sockets became ready or timed out.
+        now = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < active.size();) {
+            short revents = fds[i + 1].revents;
+            int status = mysqlStatus(revents);
+            if ((active[i]->waitStatus & MYSQL_WAIT_TIMEOUT)
+                && active[i]->deadline <= now) {
+                status |= MYSQL_WAIT_TIMEOUT;
+            }
+            if (status != 0 && _advance(*active[i], status)) {
+                // Completed: drop it (fds is rebuilt each iteration).
+                active.erase(active.begin() + i);
+                fds.erase(fds.begin() + i + 1);
+            } else {
+                ++i;
+            }
+        }
+    }
+    // Fail anything still in flight or queued so waiters are released.
+    for (auto& stmt : active) {
+        if (stmt->onDone) { stmt->onDone(false); }
+    }
+    std::lock_guard<std::mutex> lock(lane.mtx);
+    for (auto& stmt : lane.incoming) {
+        if (stmt->onDone) { stmt->onDone(false); }
+    }
+}
+
+}}} // namespace lsst::qserv::mysql
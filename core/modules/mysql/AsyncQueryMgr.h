@@ -0,0 +1,113 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_MYSQL_ASYNCQUERYMGR_H
+#define LSST_QSERV_MYSQL_ASYNCQUERYMGR_H
+
+// System headers
+#include <atomic>
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Third-party headers
+#include "boost/utility.hpp"
+
+namespace lsst {
+namespace qserv {
+namespace mysql {
+
+// Forward
+class MySqlConnection;
+
+/// AsyncQueryMgr drives SQL statements through the MariaDB client's
+/// non-blocking API on a small, fixed set of event threads. Each in-flight
+/// statement costs a poll() slot rather than a blocked thread, so many
+/// concurrent statements (merges on the czar, chunk queries on workers)
+/// share a handful of threads instead of pinning one apiece.
+///
+/// A statement's connection belongs to the event thread from submit()
+/// until its completion callback has run; callers must not touch it in
+/// between. Callbacks run on an event thread and should be brief.
+class AsyncQueryMgr : boost::noncopyable {
+public:
+    typedef std::shared_ptr<AsyncQueryMgr> Ptr;
+    typedef std::function<void(bool success)> DoneCallback;
+
+    static unsigned int const DEFAULT_THREADS = 4;
+
+    /// @return the process-wide instance shared by all clients.
+    static Ptr instance();
+
+    explicit AsyncQueryMgr(unsigned int threadCount=DEFAULT_THREADS);
+    ~AsyncQueryMgr();
+
+    /// Submit 'query' for execution on 'conn'. 'onDone' is invoked on an
+    /// event thread once the statement completes, with success==true iff
+    /// mysql_real_query returned 0. The connection's result set (if any)
+    /// is not touched; retrieve it with MySqlConnection::useResult().
+    void submit(MySqlConnection& conn, std::string const& query, DoneCallback onDone);
+
+    /// Future-based rendezvous for callers that need the outcome inline.
+    std::future<bool> submitFuture(MySqlConnection& conn, std::string const& query);
+
+private:
+    /// One statement being driven through queryStart()/queryCont().
+    struct Statement {
+        typedef std::shared_ptr<Statement> Ptr;
+        MySqlConnection* conn;
+        std::string query;
+        DoneCallback onDone;
+        int waitStatus{0}; ///< MYSQL_WAIT_* flags currently waited for
+        bool started{false};
+        std::chrono::steady_clock::time_point deadline; ///< valid if MYSQL_WAIT_TIMEOUT set
+    };
+
+    /// Per-thread event loop state. Statements are assigned to a lane at
+    /// submit() time and stay there until they complete.
+    struct Lane {
+        std::mutex mtx;
+        std::deque<Statement::Ptr> incoming;
+        int wakeupFd[2]; ///< self-pipe, [0]=read end polled by the loop
+    };
+
+    void _run(Lane& lane);
+    void _wake(Lane& lane);
+    /// Advance 'stmt' with the given ready-status; invoke the callback and
+    /// @return true if it completed.
+    bool _advance(Statement& stmt, int readyStatus);
+
+    std::vector<std::unique_ptr<Lane>> _lanes;
+    std::vector<std::thread> _threads;
+    std::atomic<unsigned int> _laneSeq{0}; ///< round-robin lane selector
+    std::atomic<bool> _shutdown{false};
+};
+
+}}} // namespace lsst::qserv::mysql
+
+#endif // LSST_QSERV_MYSQL_ASYNCQUERYMGR_H
@@ -65,6 +65,7 @@ LocalInfile::LocalInfile(char const* filename, MYSQL_RES* result)
     const int defaultBuffer = infileBufferSize;
     _buffer = new char[defaultBuffer];
     _bufferSize = defaultBuffer;
+    _ownBuffer = true;
     _leftover = 0;
     _leftoverSize = 0;
     assert(result);
@@ -79,13 +80,28 @@ LocalInfile::LocalInfile(char const* filename,
     const int defaultBuffer = infileBufferSize;
     _buffer = new char[defaultBuffer];
     _bufferSize = defaultBuffer;
+    _ownBuffer = true;
     _leftover = 0;
     _leftoverSize = 0;
     assert(_rowBuffer);
 }
 
+LocalInfile::LocalInfile(char const* filename,
+                         std::shared_ptr<RowBuffer> rowBuffer,
+                         char* buffer, unsigned int bufferSize)
+    : _buffer(buffer),
+      _bufferSize(bufferSize),
+      _ownBuffer(false),
+      _filename(filename),
+      _rowBuffer(rowBuffer) {
+    _leftover = 0;
+    _leftoverSize = 0;
+    assert(_buffer);
+    assert(_rowBuffer);
+}
+
 LocalInfile::~LocalInfile() {
-    if (_buffer) {
+    if (_buffer && _ownBuffer) {
         delete[] _buffer;
     }
 }
@@ -108,6 +124,11 @@ int LocalInfile::read(char* buf, unsigned int bufLen) {
     }
     if (bufLen > 0) { // continue?
         // Leftover couldn't satisfy bufLen, so it's empty.
+        if (bufLen >= _bufferSize) {
+            // mysql's buffer is at least as large as ours: fetch straight
+            // into it and skip the staging copy entirely.
+            return copied + _rowBuffer->fetch(buf, bufLen);
+        }
         // Re-fill the buffer.
 
         unsigned fetchSize = _rowBuffer->fetch(_buffer, _bufferSize);
@@ -176,9 +197,12 @@ int LocalInfile::Mgr::local_infile_init(void **ptr, const char *filename, void *
     assert(userdata);
     //cout << "New infile:" << filename << "\n";
     LocalInfile::Mgr* m = static_cast<LocalInfile::Mgr*>(userdata);
-    RowBuffer::Ptr rb= m->get(std::string(filename));
+    RowBuffer::Ptr rb= m->take(std::string(filename));
     assert(rb);
-    LocalInfile* lf = new LocalInfile(filename, rb);
+    // A Mgr serves one connection and mysql runs one LOAD DATA at a time on
+    // it, so all infiles of this Mgr can share its persistent channel buffer.
+    LocalInfile* lf = new LocalInfile(filename, rb,
+                                      m->channelBuffer(), m->channelSize());
     *ptr = lf;
     if (!lf->isValid()) {
         return 1;
@@ -224,6 +248,16 @@ RowBuffer::Ptr LocalInfile::Mgr::get(std::string const& s) {
 }
 
 
+RowBuffer::Ptr LocalInfile::Mgr::take(std::string const& s) {
+    std::lock_guard<std::mutex> lock(_mapMutex);
+    RowBufferMap::iterator i = _map.find(s);
+    if (i == _map.end()) { return std::shared_ptr<RowBuffer>(); }
+    RowBuffer::Ptr rb = i->second;
+    _map.erase(i);
+    return rb;
+}
+
+
 std::string LocalInfile::Mgr::_nextFilename() {
     static std::atomic<std::uint64_t> sequence(0);
 
@@ -62,6 +62,13 @@ public:
 
     LocalInfile(char const* filename, MYSQL_RES* result);
     LocalInfile(char const* filename, std::shared_ptr<RowBuffer> rowBuffer);
+    /// Construct using a borrowed staging buffer instead of allocating one.
+    /// The caller retains ownership of 'buffer' and must keep it alive (and
+    /// unshared) for the lifetime of this instance. Used by Mgr to reuse one
+    /// pre-sized channel buffer across the many LOAD DATA statements of a
+    /// query instead of allocating per statement.
+    LocalInfile(char const* filename, std::shared_ptr<RowBuffer> rowBuffer,
+                char* buffer, unsigned int bufferSize);
     ~LocalInfile();
 
     /// Read up to bufLen bytes of infile contents into buf.
@@ -77,7 +84,8 @@ public:
 
 private:
     char* _buffer; ///< Internal buffer for passing to mysql
-    int _bufferSize; ///< Allocated size of internal buffer
+    unsigned int _bufferSize; ///< Allocated size of internal buffer
+    bool _ownBuffer; ///< True if _buffer was allocated here (not borrowed)
     char* _leftover; ///< Ptr to bytes not yet sent to mysql
     unsigned _leftoverSize; ///< Size of bytes not yet sent in _leftover
     std::string _filename; ///< virtual filename for mysql
@@ -93,7 +101,15 @@ private:
 /// for more information on the required interface.
 class LocalInfile::Mgr : boost::noncopyable {
 public:
-    Mgr() {}
+    /// Default size of the reusable channel buffer shared by the LocalInfile
+    /// instances of this Mgr. A Mgr serves one connection, and a connection
+    /// runs one LOAD DATA at a time, so one buffer suffices; sizing it well
+    /// above the old per-statement 1M buffer lets RowBuffer sources hand
+    /// over large blocks in a single fetch.
+    static unsigned int const DEFAULT_CHANNEL_SIZE = 8*1024*1024;
+
+    explicit Mgr(unsigned int channelSize=DEFAULT_CHANNEL_SIZE)
+        : _channel(new char[channelSize]), _channelSize(channelSize) {}
     ~Mgr() {}
 
     // User interface //////////////////////////////////////////////////
@@ -127,8 +143,13 @@ public:
     std::string insertBuffer(std::shared_ptr<RowBuffer> const& rb);
     void setBuffer(std::string const& s, std::shared_ptr<RowBuffer> const& rb);
     std::shared_ptr<RowBuffer> get(std::string const& s);
+    /// Fetch-and-remove the RowBuffer registered under 's'. Like get(), but
+    /// drops the map entry so completed infiles do not accumulate.
+    std::shared_ptr<RowBuffer> take(std::string const& s);
 
-
+    /// @return the reusable channel buffer (valid for the Mgr's lifetime)
+    char* channelBuffer() { return _channel.get(); }
+    unsigned int channelSize() const { return _channelSize; }
 
 private:
     /// @return next filename
@@ -140,6 +161,8 @@ private:
     typedef std::map<std::string, std::shared_ptr<RowBuffer>> RowBufferMap;
     RowBufferMap _map;
     std::mutex _mapMutex;
+    std::unique_ptr<char[]> _channel; ///< Reusable staging buffer
+    unsigned int _channelSize; ///< Size of _channel
 };
 
 }}} // namespace lsst::qserv::mysql
@@ -0,0 +1,109 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "mysql/MySqlConnPool.h"
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+// Qserv headers
+#include "mysql/MySqlConfig.h"
+
+namespace {
+LOG_LOGGER _log = LOG_GET("lsst.qserv.mysql.MySqlConnPool");
+}
+
+namespace lsst {
+namespace qserv {
+namespace mysql {
+
+std::size_t const MySqlConnPool::MAX_IDLE = 32;
+
+MySqlConnPool& MySqlConnPool::instance() {
+    static MySqlConnPool connPool;
+    return connPool;
+}
+
+
+std::string MySqlConnPool::_key(MySqlConfig const& cfg) {
+    return cfg.username + '\0' + cfg.hostname + '\0' + std::to_string(cfg.port)
+            + '\0' + cfg.socket + '\0' + cfg.dbName;
+}
+
+
+std::shared_ptr<MySqlConnection> MySqlConnPool::acquire(MySqlConfig const& cfg) {
+    std::string const key = _key(cfg);
+    std::shared_ptr<MySqlConnection> conn;
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        auto iter = _idle.find(key);
+        if (iter != _idle.end() && !iter->second.empty()) {
+            conn = iter->second.back();
+            iter->second.pop_back();
+            --_idleCount;
+        }
+    }
+    while (conn != nullptr) {
+        // Reconnecting through a fresh instance below is cheaper than
+        // untangling a half-dead session, so a failed ping just drops the
+        // connection.
+        if (conn->getMySql() != nullptr && mysql_ping(conn->getMySql()) == 0) {
+            LOGS(_log, LOG_LVL_DEBUG, "MySqlConnPool reusing connection user=" << cfg.username);
+            return conn;
+        }
+        LOGS(_log, LOG_LVL_DEBUG, "MySqlConnPool dropping stale connection user=" << cfg.username);
+        std::lock_guard<std::mutex> lock(_mtx);
+        auto iter = _idle.find(key);
+        conn = nullptr;
+        if (iter != _idle.end() && !iter->second.empty()) {
+            conn = iter->second.back();
+            iter->second.pop_back();
+            --_idleCount;
+        }
+    }
+    // Miss: hand back a fresh instance; the caller connects it.
+    return std::make_shared<MySqlConnection>(cfg);
+}
+
+
+void MySqlConnPool::release(std::shared_ptr<MySqlConnection> const& conn) {
+    if (conn == nullptr || !conn->connected()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(_mtx);
+    if (_idleCount >= MAX_IDLE) {
+        LOGS(_log, LOG_LVL_DEBUG, "MySqlConnPool idle set full, dropping connection");
+        return; // Dropped; ~MySqlConnection closes it.
+    }
+    _idle[_key(conn->getMySqlConfig())].push_back(conn);
+    ++_idleCount;
+}
+
+
+std::size_t MySqlConnPool::idleCount() const {
+    std::lock_guard<std::mutex> lock(_mtx);
+    return _idleCount;
+}
+
+}}} // namespace lsst::qserv::mysql
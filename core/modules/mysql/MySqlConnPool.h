@@ -0,0 +1,90 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_MYSQL_MYSQLCONNPOOL_H
+#define LSST_QSERV_MYSQL_MYSQLCONNPOOL_H
+
+// System headers
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Third-party headers
+#include "boost/utility.hpp"
+
+// Local headers
+#include "mysql/MySqlConnection.h"
+
+namespace lsst {
+namespace qserv {
+namespace mysql {
+
+/// MySqlConnPool keeps warm mysqld connections for reuse across Tasks.
+/// The worker opens a connection per Task and pays TCP plus authentication
+/// setup thousands of times per second during busy periods; with the pool a
+/// Task start is usually a map lookup and a ping.
+///
+/// Connections are keyed by their configuration (the czar-passed username
+/// varies per Task), handed out exclusively, and health-checked with
+/// mysql_ping before reuse. acquire() never blocks: on a miss it returns a
+/// fresh, unconnected instance and the caller connects as before. Callers
+/// return a connection with release() only when it finished cleanly;
+/// cancelled or erred connections are simply dropped, which keeps the
+/// KILL-query cancellation path unchanged. The idle set is bounded; excess
+/// returned connections are closed.
+class MySqlConnPool : boost::noncopyable {
+public:
+    /// Bound on the total number of idle connections retained.
+    static std::size_t const MAX_IDLE;
+
+    /// Return the process-wide instance.
+    static MySqlConnPool& instance();
+
+    /// Check a connection out for 'cfg'.
+    /// @return a warm connected instance when one is available, otherwise
+    ///         a fresh instance the caller must connect().
+    std::shared_ptr<MySqlConnection> acquire(MySqlConfig const& cfg);
+
+    /// Return a cleanly finished connection for reuse. Drops the connection
+    /// instead when the idle set is full.
+    void release(std::shared_ptr<MySqlConnection> const& conn);
+
+    /// @return the number of idle connections currently retained.
+    std::size_t idleCount() const;
+
+private:
+    MySqlConnPool() = default;
+
+    /// @return the pool key for a configuration.
+    static std::string _key(MySqlConfig const& cfg);
+
+    mutable std::mutex _mtx; ///< Protects _idle and _idleCount.
+    std::map<std::string, std::vector<std::shared_ptr<MySqlConnection>>> _idle;
+    std::size_t _idleCount = 0;
+};
+
+}}} // namespace lsst::qserv::mysql
+
+#endif // LSST_QSERV_MYSQL_MYSQLCONNPOOL_H
@@ -150,6 +150,43 @@ MySqlConnection::queryUnbuffered(std::string const& query) {
     return true;
 }
 
+void
+MySqlConnection::enableNonBlocking() {
+    assert(_mysql);
+    mysql_options(_mysql, MYSQL_OPT_NONBLOCK, nullptr);
+}
+
+int
+MySqlConnection::queryStart(std::string const& query, int& rc) {
+    {
+        std::lock_guard<std::mutex> lock(_interruptMutex);
+        _isExecuting = true;
+        _interrupted = false;
+    }
+    int status = mysql_real_query_start(&rc, _mysql, query.c_str(), query.length());
+    if (status == 0) {
+        std::lock_guard<std::mutex> lock(_interruptMutex);
+        _isExecuting = false;
+    }
+    return status;
+}
+
+int
+MySqlConnection::queryCont(int readyStatus, int& rc) {
+    int status = mysql_real_query_cont(&rc, _mysql, readyStatus);
+    if (status == 0) {
+        std::lock_guard<std::mutex> lock(_interruptMutex);
+        _isExecuting = false;
+    }
+    return status;
+}
+
+bool
+MySqlConnection::useResult() {
+    _mysql_res = mysql_use_result(_mysql);
+    return _mysql_res != nullptr;
+}
+
 /// Cancel existing query
 /// @return 0 on success.
 /// 1 indicates error in connecting. (may try again)
@@ -74,6 +74,41 @@ public:
     bool queryUnbuffered(std::string const& query);
     int cancel();
 
+    // Non-blocking statement execution, built on the MariaDB client's
+    // mysql_real_query_start/_cont API. Clients normally submit through
+    // AsyncQueryMgr rather than driving these directly. While a statement
+    // is in flight the connection must not be used for anything else.
+
+    /// Allow non-blocking operations on this connection. Must be called
+    /// before queryStart(); safe to call more than once.
+    void enableNonBlocking();
+
+    /// Begin executing 'query' without blocking.
+    /// @param rc receives the mysql_real_query return code once complete.
+    /// @return 0 if the statement completed immediately, else the
+    /// MYSQL_WAIT_* flags the caller must wait for before calling
+    /// queryCont().
+    int queryStart(std::string const& query, int& rc);
+
+    /// Continue a statement begun with queryStart() after the socket became
+    /// ready. 'readyStatus' holds the MYSQL_WAIT_* flags that occurred.
+    /// @return 0 when complete ('rc' is then valid), else flags to wait for.
+    int queryCont(int readyStatus, int& rc);
+
+    /// Grab the (unbuffered) result set of a completed statement.
+    /// @return false if no result set is available.
+    bool useResult();
+
+    /// @return the socket to wait on between queryStart()/queryCont() calls.
+    int socketFd() const { assert(_mysql); return mysql_get_socket(_mysql); }
+
+    /// @return the active wait timeout in ms; only meaningful when the last
+    /// queryStart()/queryCont() returned MYSQL_WAIT_TIMEOUT.
+    unsigned int waitTimeoutMs() const {
+        assert(_mysql);
+        return mysql_get_timeout_value_ms(_mysql);
+    }
+
     MYSQL_RES* getResult() { return _mysql_res; }
     void freeResult() { mysql_free_result(_mysql_res); _mysql_res = nullptr; }
     int getResultFieldCount() {
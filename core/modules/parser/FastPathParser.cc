@@ -0,0 +1,450 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/**
+  * @file
+  *
+  * @brief Implementation of the point/cone query fast-path parser.
+  *
+  * The tokenizer and recursive descent below accept only the statement
+  * shapes documented in FastPathParser.h; every unsupported construct makes
+  * the parse return nullptr so the caller falls back to ANTLR. The produced
+  * IR deliberately mirrors QSMySqlListener: restrictor functions go into
+  * WhereClause restrictors via WhereFactory::addQservRestrictor, other
+  * predicates form BoolFactors under a single AndTerm under the root OrTerm.
+  */
+
+// Class header
+#include "parser/FastPathParser.h"
+
+// System headers
+#include <cctype>
+#include <cstdlib>
+#include <vector>
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+// Qserv headers
+#include "global/constants.h"
+#include "parser/ValueExprFactory.h"
+#include "parser/WhereFactory.h"
+#include "query/BoolTerm.h"
+#include "query/ColumnRef.h"
+#include "query/FromList.h"
+#include "query/OrderByClause.h"
+#include "query/Predicate.h"
+#include "query/SelectList.h"
+#include "query/SelectStmt.h"
+#include "query/TableRef.h"
+#include "query/ValueExpr.h"
+#include "query/ValueFactor.h"
+#include "query/WhereClause.h"
+
+namespace {
+LOG_LOGGER _log = LOG_GET("lsst.qserv.parser.FastPathParser");
+}
+
+namespace { // File-scope helpers
+
+using namespace lsst::qserv;
+
+struct Token {
+    enum Type {
+        IDENT, NUMBER, STRING, COMMA, DOT, LPAREN, RPAREN, STAR,
+        OP,     // = < > <= >= <> !=
+        PLUS, MINUS, SEMI, END
+    };
+    Token(Type type_, std::string const& text_) : type(type_), text(text_) {}
+    Type type;
+    std::string text;
+};
+
+bool isIdentChar(char c) {
+    return std::isalnum(static_cast<unsigned char>(c)) || c == '_' || c == '$';
+}
+
+/// Case-insensitive comparison against an upper-case keyword.
+bool matchesKeyword(std::string const& text, char const* keyword) {
+    char const* k = keyword;
+    for (std::string::const_iterator i = text.begin(); i != text.end(); ++i, ++k) {
+        if (*k == '\0' || std::toupper(static_cast<unsigned char>(*i)) != *k) {
+            return false;
+        }
+    }
+    return *k == '\0';
+}
+
+/// Tokenize the query. @return false on any character outside the fast-path
+/// alphabet (backquotes, braces, arithmetic, comments, ...).
+bool tokenize(std::string const& query, std::vector<Token>& tokens) {
+    size_t pos = 0;
+    size_t const end = query.size();
+    while (pos < end) {
+        char c = query[pos];
+        if (std::isspace(static_cast<unsigned char>(c))) {
+            ++pos;
+            continue;
+        }
+        if (std::isalpha(static_cast<unsigned char>(c)) || c == '_' || c == '$') {
+            size_t start = pos;
+            while (pos < end && isIdentChar(query[pos])) { ++pos; }
+            tokens.push_back(Token(Token::IDENT, query.substr(start, pos - start)));
+            continue;
+        }
+        if (std::isdigit(static_cast<unsigned char>(c))
+            || (c == '.' && pos + 1 < end
+                && std::isdigit(static_cast<unsigned char>(query[pos + 1])))) {
+            size_t start = pos;
+            while (pos < end && std::isdigit(static_cast<unsigned char>(query[pos]))) { ++pos; }
+            if (pos < end && query[pos] == '.') {
+                ++pos;
+                while (pos < end && std::isdigit(static_cast<unsigned char>(query[pos]))) { ++pos; }
+            }
+            if (pos < end && (query[pos] == 'e' || query[pos] == 'E')) {
+                size_t expPos = pos + 1;
+                if (expPos < end && (query[expPos] == '+' || query[expPos] == '-')) { ++expPos; }
+                if (expPos < end && std::isdigit(static_cast<unsigned char>(query[expPos]))) {
+                    pos = expPos;
+                    while (pos < end && std::isdigit(static_cast<unsigned char>(query[pos]))) { ++pos; }
+                } else {
+                    return false; // "1e" followed by non-digit: not a number we handle
+                }
+            }
+            tokens.push_back(Token(Token::NUMBER, query.substr(start, pos - start)));
+            continue;
+        }
+        if (c == '\'') {
+            size_t start = pos;
+            ++pos;
+            while (pos < end) {
+                if (query[pos] == '\\') { return false; } // escapes: full parser
+                if (query[pos] == '\'') {
+                    if (pos + 1 < end && query[pos + 1] == '\'') { pos += 2; continue; }
+                    break;
+                }
+                ++pos;
+            }
+            if (pos >= end) { return false; } // unterminated
+            ++pos; // past closing quote
+            tokens.push_back(Token(Token::STRING, query.substr(start, pos - start)));
+            continue;
+        }
+        switch (c) {
+        case ',': tokens.push_back(Token(Token::COMMA, ",")); ++pos; continue;
+        case '.': tokens.push_back(Token(Token::DOT, ".")); ++pos; continue;
+        case '(': tokens.push_back(Token(Token::LPAREN, "(")); ++pos; continue;
+        case ')': tokens.push_back(Token(Token::RPAREN, ")")); ++pos; continue;
+        case '*': tokens.push_back(Token(Token::STAR, "*")); ++pos; continue;
+        case '+': tokens.push_back(Token(Token::PLUS, "+")); ++pos; continue;
+        case '-': tokens.push_back(Token(Token::MINUS, "-")); ++pos; continue;
+        case ';': tokens.push_back(Token(Token::SEMI, ";")); ++pos; continue;
+        case '=': tokens.push_back(Token(Token::OP, "=")); ++pos; continue;
+        case '<':
+            if (pos + 1 < end && query[pos + 1] == '=') { tokens.push_back(Token(Token::OP, "<=")); pos += 2; }
+            else if (pos + 1 < end && query[pos + 1] == '>') { tokens.push_back(Token(Token::OP, "<>")); pos += 2; }
+            else { tokens.push_back(Token(Token::OP, "<")); ++pos; }
+            continue;
+        case '>':
+            if (pos + 1 < end && query[pos + 1] == '=') { tokens.push_back(Token(Token::OP, ">=")); pos += 2; }
+            else { tokens.push_back(Token(Token::OP, ">")); ++pos; }
+            continue;
+        case '!':
+            if (pos + 1 < end && query[pos + 1] == '=') { tokens.push_back(Token(Token::OP, "<>")); pos += 2; continue; }
+            return false;
+        default:
+            return false;
+        }
+    }
+    tokens.push_back(Token(Token::END, ""));
+    return true;
+}
+
+/// Recursive-descent recognizer over the token stream. All parse methods
+/// return false (or nullptr) to signal "not fast-path material"; nothing
+/// here throws on bad input.
+class FastPathParser {
+public:
+    explicit FastPathParser(std::vector<Token> const& tokens) : _tokens(tokens) {}
+
+    std::shared_ptr<query::SelectStmt> parse() {
+        if (!_acceptKeyword("SELECT")) { return nullptr; }
+        std::shared_ptr<query::SelectList> selectList = _parseSelectList();
+        if (selectList == nullptr) { return nullptr; }
+        if (!_acceptKeyword("FROM")) { return nullptr; }
+        std::shared_ptr<query::FromList> fromList = _parseFromList();
+        if (fromList == nullptr) { return nullptr; }
+
+        std::shared_ptr<query::WhereClause> whereClause;
+        if (_acceptKeyword("WHERE")) {
+            whereClause = _parseWhereClause();
+            if (whereClause == nullptr) { return nullptr; }
+        }
+        std::shared_ptr<query::OrderByClause> orderByClause;
+        if (_atKeyword("ORDER")) {
+            _next();
+            if (!_acceptKeyword("BY")) { return nullptr; }
+            orderByClause = _parseOrderByList();
+            if (orderByClause == nullptr) { return nullptr; }
+        }
+        int limit = lsst::qserv::NOTSET;
+        if (_acceptKeyword("LIMIT")) {
+            if (_peek().type != Token::NUMBER
+                || _peek().text.find_first_not_of("0123456789") != std::string::npos) {
+                return nullptr;
+            }
+            limit = std::atoi(_next().text.c_str());
+        }
+        if (_peek().type == Token::SEMI) { _next(); }
+        if (_peek().type != Token::END) { return nullptr; }
+
+        return std::make_shared<query::SelectStmt>(fromList, selectList, whereClause,
+                                                   orderByClause, nullptr, nullptr,
+                                                   false, limit);
+    }
+
+private:
+    Token const& _peek(unsigned ahead=0) const {
+        size_t i = _pos + ahead;
+        if (i >= _tokens.size()) { i = _tokens.size() - 1; } // END
+        return _tokens[i];
+    }
+    Token const& _next() { return _tokens[_pos++]; }
+
+    bool _atKeyword(char const* keyword) const {
+        return _peek().type == Token::IDENT && matchesKeyword(_peek().text, keyword);
+    }
+    bool _acceptKeyword(char const* keyword) {
+        if (!_atKeyword(keyword)) { return false; }
+        _next();
+        return true;
+    }
+
+    /// column or table.column; three-part references fall back.
+    std::shared_ptr<query::ColumnRef> _parseColumnRef() {
+        if (_peek().type != Token::IDENT) { return nullptr; }
+        std::string first = _next().text;
+        if (_peek().type != Token::DOT) {
+            return query::ColumnRef::newShared("", "", first);
+        }
+        _next();
+        if (_peek().type != Token::IDENT || _peek(1).type == Token::DOT) { return nullptr; }
+        return query::ColumnRef::newShared("", first, _next().text);
+    }
+
+    std::shared_ptr<query::ValueExpr> _makeColumnValueExpr(
+            std::shared_ptr<query::ColumnRef> const& columnRef) {
+        auto valueExpr = std::make_shared<query::ValueExpr>();
+        parser::ValueExprFactory::addValueFactor(
+                valueExpr, query::ValueFactor::newColumnRefFactor(columnRef));
+        return valueExpr;
+    }
+
+    std::shared_ptr<query::ValueExpr> _makeConstValueExpr(std::string const& text) {
+        auto valueExpr = std::make_shared<query::ValueExpr>();
+        parser::ValueExprFactory::addValueFactor(
+                valueExpr, query::ValueFactor::newConstFactor(text));
+        return valueExpr;
+    }
+
+    /// Signed numeric literal; @return empty string when absent.
+    std::string _parseNumber() {
+        std::string sign;
+        if (_peek().type == Token::MINUS) { sign = "-"; }
+        if (_peek().type == Token::MINUS || _peek().type == Token::PLUS) {
+            if (_peek(1).type != Token::NUMBER) { return std::string(); }
+            _next();
+        }
+        if (_peek().type != Token::NUMBER) { return std::string(); }
+        return sign + _next().text;
+    }
+
+    /// Numeric or string literal as a ValueExpr; nullptr when absent.
+    std::shared_ptr<query::ValueExpr> _parseLiteral() {
+        if (_peek().type == Token::STRING) {
+            return _makeConstValueExpr(_next().text);
+        }
+        std::string num = _parseNumber();
+        if (num.empty()) { return nullptr; }
+        return _makeConstValueExpr(num);
+    }
+
+    std::shared_ptr<query::SelectList> _parseSelectList() {
+        auto selectList = std::make_shared<query::SelectList>();
+        if (_peek().type == Token::STAR) {
+            _next();
+            auto valueExpr = std::make_shared<query::ValueExpr>();
+            parser::ValueExprFactory::addValueFactor(
+                    valueExpr, query::ValueFactor::newStarFactor(""));
+            selectList->getValueExprList()->push_back(valueExpr);
+            return selectList;
+        }
+        while (true) {
+            std::shared_ptr<query::ColumnRef> columnRef = _parseColumnRef();
+            if (columnRef == nullptr) { return nullptr; }
+            selectList->getValueExprList()->push_back(_makeColumnValueExpr(columnRef));
+            if (_peek().type != Token::COMMA) { break; }
+            _next();
+        }
+        return selectList;
+    }
+
+    /// Single [db.]table reference; joins and aliases fall back.
+    std::shared_ptr<query::FromList> _parseFromList() {
+        if (_peek().type != Token::IDENT) { return nullptr; }
+        std::string first = _next().text;
+        std::string db, table;
+        if (_peek().type == Token::DOT) {
+            _next();
+            if (_peek().type != Token::IDENT) { return nullptr; }
+            db = first;
+            table = _next().text;
+        } else {
+            table = first;
+        }
+        auto tableRefList = std::make_shared<query::TableRefList>();
+        tableRefList->push_back(std::make_shared<query::TableRef>(db, table, ""));
+        return std::make_shared<query::FromList>(tableRefList);
+    }
+
+    /// qserv_*(...) restrictor spec; numeric args only.
+    bool _parseRestrictor(std::shared_ptr<query::WhereClause>& whereClause) {
+        std::string name = _next().text;
+        _next(); // LPAREN, checked by caller
+        std::vector<std::shared_ptr<query::ValueFactor>> args;
+        if (_peek().type != Token::RPAREN) {
+            while (true) {
+                std::string num = _parseNumber();
+                if (num.empty()) { return false; }
+                args.push_back(query::ValueFactor::newConstFactor(num));
+                if (_peek().type != Token::COMMA) { break; }
+                _next();
+            }
+        }
+        if (_peek().type != Token::RPAREN) { return false; }
+        _next();
+        parser::WhereFactory::addQservRestrictor(whereClause, name, args);
+        return true;
+    }
+
+    /// column <op> literal, or column IN (literal, ...).
+    std::shared_ptr<query::BoolFactor> _parsePredicate() {
+        std::shared_ptr<query::ColumnRef> columnRef = _parseColumnRef();
+        if (columnRef == nullptr) { return nullptr; }
+        std::shared_ptr<query::BoolFactorTerm> term;
+        if (_peek().type == Token::OP) {
+            std::string op = _next().text;
+            auto predicate = std::make_shared<query::CompPredicate>();
+            predicate->left = _makeColumnValueExpr(columnRef);
+            predicate->op = query::CompPredicate::lookupOp(op.c_str());
+            predicate->right = _parseLiteral();
+            if (predicate->right == nullptr) { return nullptr; }
+            term = predicate;
+        } else if (_acceptKeyword("IN")) {
+            if (_peek().type != Token::LPAREN) { return nullptr; }
+            _next();
+            auto predicate = std::make_shared<query::InPredicate>();
+            predicate->value = _makeColumnValueExpr(columnRef);
+            while (true) {
+                std::shared_ptr<query::ValueExpr> cand = _parseLiteral();
+                if (cand == nullptr) { return nullptr; }
+                predicate->cands.push_back(cand);
+                if (_peek().type != Token::COMMA) { break; }
+                _next();
+            }
+            if (_peek().type != Token::RPAREN) { return nullptr; }
+            _next();
+            term = predicate;
+        } else {
+            return nullptr; // BETWEEN, LIKE, IS NULL, ...: full parser
+        }
+        auto boolFactor = std::make_shared<query::BoolFactor>();
+        boolFactor->addBoolFactorTerm(term);
+        return boolFactor;
+    }
+
+    std::shared_ptr<query::WhereClause> _parseWhereClause() {
+        auto whereClause = std::make_shared<query::WhereClause>();
+        auto andTerm = std::make_shared<query::AndTerm>();
+        bool hasTree = false;
+        do {
+            if (_peek().type == Token::IDENT
+                && matchesKeyword(_peek().text.substr(0, 6), "QSERV_")
+                && _peek(1).type == Token::LPAREN) {
+                if (!_parseRestrictor(whereClause)) { return nullptr; }
+            } else {
+                std::shared_ptr<query::BoolFactor> boolFactor = _parsePredicate();
+                if (boolFactor == nullptr) { return nullptr; }
+                andTerm->addBoolTerm(boolFactor);
+                hasTree = true;
+            }
+        } while (_acceptKeyword("AND"));
+        if (hasTree) {
+            // Match the listener's shape: root OrTerm over one AndTerm.
+            auto orTerm = std::make_shared<query::OrTerm>();
+            orTerm->addBoolTerm(andTerm);
+            whereClause->setRootTerm(orTerm);
+        }
+        return whereClause;
+    }
+
+    std::shared_ptr<query::OrderByClause> _parseOrderByList() {
+        auto orderByClause = std::make_shared<query::OrderByClause>();
+        while (true) {
+            std::shared_ptr<query::ColumnRef> columnRef = _parseColumnRef();
+            if (columnRef == nullptr) { return nullptr; }
+            query::OrderByTerm::Order order = query::OrderByTerm::DEFAULT;
+            if (_acceptKeyword("ASC")) { order = query::OrderByTerm::ASC; }
+            else if (_acceptKeyword("DESC")) { order = query::OrderByTerm::DESC; }
+            orderByClause->addTerm(query::OrderByTerm(
+                    _makeColumnValueExpr(columnRef), order, ""));
+            if (_peek().type != Token::COMMA) { break; }
+            _next();
+        }
+        return orderByClause;
+    }
+
+    std::vector<Token> const& _tokens;
+    size_t _pos = 0;
+};
+
+} // anonymous namespace
+
+namespace lsst {
+namespace qserv {
+namespace parser {
+
+std::shared_ptr<query::SelectStmt> tryFastPathParse(std::string const& userQuery) {
+    std::vector<Token> tokens;
+    if (!tokenize(userQuery, tokens)) {
+        return nullptr;
+    }
+    FastPathParser fastPathParser(tokens);
+    std::shared_ptr<query::SelectStmt> stmt = fastPathParser.parse();
+    if (stmt != nullptr) {
+        LOGS(_log, LOG_LVL_DEBUG, "Fast-path parse succeeded, bypassing antlr4");
+    }
+    return stmt;
+}
+
+}}} // namespace lsst::qserv::parser
@@ -0,0 +1,69 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#ifndef LSST_QSERV_PARSER_FASTPATHPARSER_H
+#define LSST_QSERV_PARSER_FASTPATHPARSER_H
+/**
+  * @file
+  *
+  * @brief A hand-rolled recursive-descent parser for the restricted grammar
+  * of point and cone queries, used as a fast path in front of the generated
+  * ANTLR parser.
+  */
+
+// System headers
+#include <memory>
+#include <string>
+
+// Forward declarations
+namespace lsst {
+namespace qserv {
+namespace query {
+    class SelectStmt;
+}}}
+
+namespace lsst {
+namespace qserv {
+namespace parser {
+
+/// Attempt to parse a user query with the fast-path parser. The recognized
+/// grammar is the shape of interactive point/cone lookups:
+///
+///   SELECT {*|column[.column] , ...} FROM [db.]table
+///   [WHERE term [AND term]* ]  -- term: qserv_*(...) restrictor spec,
+///                                       column <op> literal, or
+///                                       column IN (literal, ...)
+///   [ORDER BY column [ASC|DESC] , ...] [LIMIT n] [;]
+///
+/// Anything outside that grammar returns nullptr and the caller is expected
+/// to fall back to the full ANTLR parser; this function never throws on
+/// unrecognized input. The IR produced matches what QSMySqlListener builds
+/// for the same query text.
+///
+/// @return the parsed statement, or nullptr if the query does not fit the
+/// fast-path grammar.
+std::shared_ptr<query::SelectStmt> tryFastPathParse(std::string const& userQuery);
+
+}}} // namespace lsst::qserv::parser
+
+#endif // LSST_QSERV_PARSER_FASTPATHPARSER_H
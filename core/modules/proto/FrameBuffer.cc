@@ -48,10 +48,14 @@ uint32_t FrameBufferView::parseLength() {
 
     uint32_t const headerLength = sizeof(uint32_t);
     if (_size - (_next - _data) < headerLength)
-        FrameBufferError(
+        throw FrameBufferError(
             "FrameBufferView::parseLength()  ** not enough data to be interpreted as the frame header **");
 
-    uint32_t const messageLength = ntohl(*(reinterpret_cast<const uint32_t*>(_next)));
+    // The header is not guaranteed to be aligned within the blob, hence
+    // the memcpy instead of a direct uint32_t read.
+    uint32_t messageLengthBE;
+    std::memcpy(&messageLengthBE, _next, headerLength);
+    uint32_t const messageLength = ntohl(messageLengthBE);
 
     // Move the pointer to the next message (if any)
     _next += headerLength;
@@ -125,4 +129,53 @@ void FrameBuffer::extend(size_t newCapacityBytes) {
     _capacity = newCapacityBytes;
 }
 
+///////////////////////////
+// Class FrameBufferPool //
+///////////////////////////
+
+const size_t FrameBufferPool::DEFAULT_MAX_BUFFERS = 64;
+const size_t FrameBufferPool::RETAIN_LIMIT        = FrameBuffer::DESIRED_LIMIT;
+
+FrameBufferPool::FrameBufferPool(size_t maxBuffers)
+    :   _maxBuffers(maxBuffers) {
+}
+
+std::unique_ptr<FrameBuffer> FrameBufferPool::acquire(size_t capacity) {
+
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+
+        // Prefer the most recently released buffer of a sufficient capacity
+        // (its pages are the most likely to still be warm).
+        for (auto itr = _buffers.rbegin(); itr != _buffers.rend(); ++itr) {
+            if ((*itr)->capacity() >= capacity) {
+                std::unique_ptr<FrameBuffer> buffer = std::move(*itr);
+                _buffers.erase(std::next(itr).base());
+                return buffer;
+            }
+        }
+    }
+    return std::unique_ptr<FrameBuffer>(new FrameBuffer(capacity));
+}
+
+void FrameBufferPool::release(std::unique_ptr<FrameBuffer> buffer) {
+
+    if (buffer == nullptr) return;
+
+    // Oversized buffers are dropped so that one large message can't pin
+    // its memory in the pool forever.
+    if (buffer->capacity() > RETAIN_LIMIT) return;
+
+    buffer->resize(0);
+
+    std::lock_guard<std::mutex> lock(_mtx);
+    if (_buffers.size() < _maxBuffers)
+        _buffers.push_back(std::move(buffer));
+}
+
+size_t FrameBufferPool::idleCount() const {
+    std::lock_guard<std::mutex> lock(_mtx);
+    return _buffers.size();
+}
+
 }}} // namespace lsst::qserv::proto
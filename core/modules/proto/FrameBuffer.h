@@ -28,14 +28,22 @@
 /// struct FrameBufferError
 /// class FrameBufferView
 /// class FrameBuffer
+/// class FrameBufferPool
 ///
 /// (see individual class documentation for more information)
 
 // System headers
 #include <arpa/inet.h>  // ntohl
 #include <cstdint>      // uint32_t
+#include <cstring>      // memcpy
+#include <memory>
+#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <vector>
+
+// Third-party headers
+#include <google/protobuf/io/coded_stream.h>
 
 // Qserv headers
 
@@ -70,7 +78,13 @@ struct FrameBufferError
  *
  *   4-bytes: frame header containing 'N' - the length of a message
  *   N-bytes: the message serialized as a Protobuf object
- *   ... 
+ *   ...
+ *
+ * This is the zero-copy path of the protocol: messages are parsed directly
+ * from the caller's (typically a connection's) receive buffer via a bounded
+ * CodedInputStream over the borrowed memory, with no intermediate copy.
+ * The view does not own the memory - the caller must keep the blob alive
+ * until parsing is complete.
  */
 class FrameBufferView {
 
@@ -119,7 +133,12 @@ public:
                     "FrameBufferView::parse() ** not enough data (" + std::to_string(_size - (_next - _data)) +
                     " bytes instead of " + std::to_string(messageLength) + " to be interpreted as the message");
 
-        if (not message.ParseFromArray(_next, messageLength) ||
+        // Parse in place over the borrowed memory. The explicit stream
+        // bounds the parser to this message's bytes, so no copy into an
+        // owned buffer is needed between the socket and the parser.
+        google::protobuf::io::CodedInputStream coded(
+            reinterpret_cast<google::protobuf::uint8 const*>(_next), messageLength);
+        if (not message.ParseFromCodedStream(&coded) ||
             not message.IsInitialized()) {
             throw FrameBufferError(
                     "FrameBufferView::parse() ** message deserialization failed **");
@@ -129,6 +148,9 @@ public:
         _next += messageLength;
     }
 
+    /// @return the number of bytes not yet consumed by parsing
+    size_t remaining() const { return _size - (_next - _data); }
+
 private:
 
    /**
@@ -269,6 +291,63 @@ private:
     size_t _size;
 };
 
+
+/**
+ * Class FrameBufferPool recycles FrameBuffer objects for the cases that
+ * must own their data (partially received frames, messages outliving the
+ * receive buffer). High-rate message streams then pay neither a heap
+ * allocation nor a capacity ramp-up per message. The pool is thread-safe.
+ */
+class FrameBufferPool {
+
+public:
+
+    /// The default number of buffers retained by the pool
+    static const size_t DEFAULT_MAX_BUFFERS;
+
+    /// Buffers above this capacity (bytes) are not retained on release
+    static const size_t RETAIN_LIMIT;
+
+    /**
+     * Construct the pool
+     *
+     * @param maxBuffers - maximum number of idle buffers to retain
+     */
+    explicit FrameBufferPool(size_t maxBuffers=DEFAULT_MAX_BUFFERS);
+
+    // Copy semantics are prohibited
+
+    FrameBufferPool(FrameBufferPool const&) = delete;
+    FrameBufferPool& operator=(FrameBufferPool const&) = delete;
+
+    /**
+     * Get a buffer of at least the specified capacity, reusing a pooled
+     * one when available. The buffer is returned empty (size 0).
+     *
+     * @param capacity - minimum capacity (bytes) of the buffer
+     */
+    std::unique_ptr<FrameBuffer> acquire(size_t capacity=FrameBuffer::DEFAULT_SIZE);
+
+    /**
+     * Return a buffer to the pool. Oversized buffers and buffers beyond
+     * the pool's retention limit are simply destroyed.
+     *
+     * @param buffer - the buffer to be recycled (may be nullptr)
+     */
+    void release(std::unique_ptr<FrameBuffer> buffer);
+
+    /// @return the number of idle buffers currently retained
+    size_t idleCount() const;
+
+private:
+
+    mutable std::mutex _mtx;    // for thread safety of the pool
+
+    std::vector<std::unique_ptr<FrameBuffer>> _buffers;
+
+    size_t _maxBuffers;
+};
+
 }}} // namespace lsst::qserv::proto
 
 #endif // LSST_QSERV_PROTO_FRAME_BUFFER_H
@@ -23,6 +23,9 @@
 
 // System headers
 
+// Third-party headers
+#include <zlib.h>
+
 // LSST headers
 #include "lsst/log/Log.h"
 
@@ -66,4 +69,43 @@ bool ProtoHeaderWrap::unwrap(std::shared_ptr<WorkerResponse>& response, std::vec
     return true;
 }
 
+
+bool ProtoHeaderWrap::compressMsg(std::string& msg, int codec) {
+    if (codec != COMP_ZLIB) {
+        return false;
+    }
+    uLongf compressedSize = compressBound(msg.size());
+    std::string compressed(compressedSize, '\0');
+    // Z_BEST_SPEED keeps the CPU cost of compression to a few percent of
+    // the row-packing cost while still shrinking typical projections well.
+    int rc = compress2(reinterpret_cast<Bytef*>(&compressed[0]), &compressedSize,
+                       reinterpret_cast<Bytef const*>(msg.data()), msg.size(),
+                       Z_BEST_SPEED);
+    if (rc != Z_OK) {
+        LOGS(_log, LOG_LVL_WARN, "compressMsg failed rc=" << rc << " size=" << msg.size());
+        return false;
+    }
+    compressed.resize(compressedSize);
+    msg.swap(compressed);
+    return true;
+}
+
+
+bool ProtoHeaderWrap::decompressMsg(char const* src, size_t srcSize, int codec,
+                                    size_t uncompressedSize, std::vector<char>& dest) {
+    if (codec != COMP_ZLIB) {
+        return false;
+    }
+    dest.resize(uncompressedSize);
+    uLongf destSize = uncompressedSize;
+    int rc = uncompress(reinterpret_cast<Bytef*>(dest.data()), &destSize,
+                        reinterpret_cast<Bytef const*>(src), srcSize);
+    if (rc != Z_OK || destSize != uncompressedSize) {
+        LOGS(_log, LOG_LVL_ERROR, "decompressMsg failed rc=" << rc
+             << " srcSize=" << srcSize << " expected=" << uncompressedSize);
+        return false;
+    }
+    return true;
+}
+
 }}} // namespace lsst::qserv::proto
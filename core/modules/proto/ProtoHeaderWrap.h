@@ -33,6 +33,7 @@
 
 // System headers
 #include <memory>
+#include <vector>
 
 // Qserv headers
 #include "proto/ProtoImporter.h"
@@ -52,6 +53,17 @@ public:
 
     static std::string wrap(std::string& protoHeaderString);
     static bool unwrap(std::shared_ptr<WorkerResponse>& response, std::vector<char>& buffer);
+
+    /// Compress 'msg' in place with 'codec' (a CompressionCodec value).
+    /// @return false if the codec is unsupported or compression failed,
+    ///         in which case 'msg' is unchanged and should be sent raw.
+    static bool compressMsg(std::string& msg, int codec);
+
+    /// Decompress 'srcSize' bytes at 'src' into 'dest'.
+    /// @param uncompressedSize expected size, from ProtoHeader.uncompressedsize.
+    /// @return false if the codec is unsupported or the data is corrupt.
+    static bool decompressMsg(char const* src, size_t srcSize, int codec,
+                              size_t uncompressedSize, std::vector<char>& dest);
 };
 
 }}} // end namespace
@@ -62,7 +62,7 @@ int ScanTableInfo::compare(ScanTableInfo const& rhs) const {
 /// @return 0 if approximately equal, -1 if this < rhs, 1 if this > rhs
 /// Faster (easier) scans are less than slower (larger) scans.
 /// Precondition, tables must be sorted before calling this function.
-int ScanInfo::compareTables(ScanInfo const& rhs) {
+int ScanInfo::compareTables(ScanInfo const& rhs) const {
     if (infoTables.size() == 0) {
         if (rhs.infoTables.size() == 0) return 0;
         return -1; // this is faster
@@ -69,7 +69,7 @@ struct ScanInfo {
     enum Rating { FASTEST = 0, FAST = 10, MEDIUM = 20, SLOW = 30, SLOWEST = 100 };
 
     void sortTablesSlowestFirst();
-    int compareTables(ScanInfo const& rhs);
+    int compareTables(ScanInfo const& rhs) const;
 
     ScanTableInfo::ListOf infoTables;
     int scanRating{Rating::FASTEST};
@@ -24,19 +24,9 @@
 // Class header
 #include "proto/TaskMsgDigest.h"
 
-// System headers
-#ifdef __SUNPRO_CC
-#include <sys/md5.h>
-#elif __APPLE__
-#define COMMON_DIGEST_FOR_OPENSSL
-#include <CommonCrypto/CommonDigest.h>
-#define MD5 CC_MD5
-#else // Linux?
-#include <openssl/md5.h>
-#endif
-
 // Qserv headers
 #include "proto/worker.pb.h"
+#include "util/StringHash.h"
 
 namespace {
     char hexChar[16] = {'0', '1', '2', '3',
@@ -49,20 +39,21 @@ namespace lsst {
 namespace qserv {
 namespace proto {
 
-std::string
-hashTaskMsg(TaskMsg const& m) {
-    unsigned char hashVal[MD5_DIGEST_LENGTH];
-    char output[MD5_DIGEST_LENGTH*2 + 1];
+uint64_t
+hashTaskMsg64(TaskMsg const& m) {
     std::string str;
-
     m.SerializeToString(&str); // Use whole, serialized message
-    MD5(reinterpret_cast<unsigned char const*>(str.data()),
-        str.size(), hashVal);
-    for(int i=0; i < MD5_DIGEST_LENGTH; ++i) {
-        output[i*2] = hexChar[(hashVal[i] >> 4) & 0x0F];
-        output[i*2 + 1] = hexChar[hashVal[i] & 0x0F];
+    return util::StringHash::getXxHash64(str.data(), str.size());
+}
+
+std::string
+hashTaskMsg(TaskMsg const& m) {
+    uint64_t const hashVal = hashTaskMsg64(m);
+    char output[16 + 1];
+    for (int i = 0; i < 16; ++i) {
+        output[i] = hexChar[(hashVal >> ((15 - i) * 4)) & 0x0F];
     }
-    output[MD5_DIGEST_LENGTH*2] = '\0';
+    output[16] = '\0';
     return std::string(output);
 }
 
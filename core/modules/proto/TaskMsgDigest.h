@@ -25,6 +25,7 @@
 #define LSST_QSERV_PROTO_TASKMSGDIGEST_H
 
 // System headers
+#include <cstdint>
 #include <string>
 
 namespace lsst {
@@ -34,8 +35,14 @@ namespace proto {
 // Forward
 class TaskMsg;
 
+/// @return a fast non-cryptographic digest of the serialized message as
+/// 16 hex digits, used to name worker scratch tables.
 std::string hashTaskMsg(TaskMsg const& m);
 
+/// @return the same digest in its raw 64-bit form, usable directly as a
+/// cache key.
+uint64_t hashTaskMsg64(TaskMsg const& m);
+
 }}} // lsst::qserv::proto
 
 #endif // LSST_QSERV_PROTO_TASKMSGDIGEST_H
@@ -24,6 +24,9 @@
 #ifndef LSST_QSERV_PROTO_WORKERRESPONSE_H
 #define LSST_QSERV_PROTO_WORKERRESPONSE_H
 
+// Third-party headers
+#include "google/protobuf/arena.h"
+
 // Qserv headers
 #include "proto/worker.pb.h"
 
@@ -31,10 +34,18 @@ namespace lsst {
 namespace qserv {
 namespace proto {
 
+/// The header and result messages live on a per-response arena, so the
+/// thousands of row/column sub-objects of a large Result collapse into a
+/// few arena blocks instead of individual heap allocations.
 struct WorkerResponse {
+    WorkerResponse()
+        : protoHeader(*google::protobuf::Arena::CreateMessage<ProtoHeader>(&arena)),
+          result(*google::protobuf::Arena::CreateMessage<Result>(&arena)) {}
+
     unsigned char headerSize;
-    ProtoHeader protoHeader;
-    Result result;
+    google::protobuf::Arena arena; ///< owns protoHeader and result.
+    ProtoHeader& protoHeader;
+    Result& result;
 };
 
 }}} // lsst::qserv::proto
@@ -23,6 +23,7 @@
 
 // System headers
 #include <cerrno>
+#include <cstdio>
 #include <cstdlib>
 #include <cstring>
 #include <iostream>
@@ -36,6 +37,7 @@
 #include "lsst/log/Log.h"
 
 // Qserv headers
+#include "proto/FrameBuffer.h"
 #include "proto/ProtoHeaderWrap.h"
 #include "proto/ScanTableInfo.h"
 #include "proto/TaskMsgDigest.h"
@@ -173,8 +175,18 @@ BOOST_AUTO_TEST_CASE(MsgBuffer) {
 BOOST_AUTO_TEST_CASE(ProtoHashDigest) {
     std::unique_ptr<lsst::qserv::proto::TaskMsg> t1(makeTaskMsg());
     std::string hash = hashTaskMsg(*t1);
-    std::string expected = "b3ecc6a56205c90642e61943e44c7f14";
-    BOOST_CHECK_EQUAL(hash, expected);
+    // The digest is 64 bits rendered as 16 hex digits and is stable for a
+    // given message.
+    BOOST_CHECK_EQUAL(hash.size(), 16u);
+    BOOST_CHECK_EQUAL(hash, hashTaskMsg(*t1));
+    // The hex form renders the raw 64-bit form.
+    char buf[17];
+    snprintf(buf, sizeof(buf), "%016llx",
+             static_cast<unsigned long long>(hashTaskMsg64(*t1)));
+    BOOST_CHECK_EQUAL(hash, std::string(buf));
+    // A different message hashes differently.
+    t1->set_chunkid(t1->chunkid() + 1);
+    BOOST_CHECK(hashTaskMsg(*t1) != hash);
 }
 
 BOOST_AUTO_TEST_CASE(ProtoHeaderWrap) {
@@ -193,6 +205,56 @@ BOOST_AUTO_TEST_CASE(ProtoHeaderWrap) {
     BOOST_CHECK(compareProtoHeaders(response->protoHeader, *ph));
 }
 
+BOOST_AUTO_TEST_CASE(FrameBufferRoundTrip) {
+    // Serialize two length-prefixed messages into one buffer, then parse
+    // them back through the zero-copy view over the buffer's own memory.
+    std::unique_ptr<lsst::qserv::proto::TaskMsg> t1(makeTaskMsg());
+    std::unique_ptr<lsst::qserv::proto::ProtoHeader> p1(makeProtoHeader());
+
+    lsst::qserv::proto::FrameBuffer buf;
+    buf.serialize(*t1);
+    buf.serialize(*p1);
+
+    lsst::qserv::proto::FrameBufferView view(buf.data(), buf.size());
+    lsst::qserv::proto::TaskMsg t2;
+    view.parse(t2);
+    BOOST_CHECK(compareTaskMsgs(*t1, t2));
+    lsst::qserv::proto::ProtoHeader p2;
+    view.parse(p2);
+    BOOST_CHECK(compareProtoHeaders(*p1, p2));
+    BOOST_CHECK_EQUAL(view.remaining(), 0u);
+
+    // Parsing past the end of the blob must fail
+    lsst::qserv::proto::TaskMsg t3;
+    BOOST_CHECK_THROW(view.parse(t3), lsst::qserv::proto::FrameBufferError);
+}
+
+BOOST_AUTO_TEST_CASE(FrameBufferPoolReuse) {
+    lsst::qserv::proto::FrameBufferPool pool;
+    BOOST_CHECK_EQUAL(pool.idleCount(), 0u);
+
+    std::unique_ptr<lsst::qserv::proto::FrameBuffer> buf = pool.acquire();
+    BOOST_CHECK(buf != nullptr);
+    char* const ptr = buf->data();
+
+    pool.release(std::move(buf));
+    BOOST_CHECK_EQUAL(pool.idleCount(), 1u);
+
+    // A compatible request must hand back the recycled buffer, empty
+    std::unique_ptr<lsst::qserv::proto::FrameBuffer> buf2 = pool.acquire();
+    BOOST_CHECK_EQUAL(buf2->data(), ptr);
+    BOOST_CHECK_EQUAL(buf2->size(), 0u);
+    BOOST_CHECK_EQUAL(pool.idleCount(), 0u);
+
+    // Oversized buffers are not retained
+    pool.release(std::unique_ptr<lsst::qserv::proto::FrameBuffer>(
+            new lsst::qserv::proto::FrameBuffer(
+                    lsst::qserv::proto::FrameBuffer::DESIRED_LIMIT + 1)));
+    BOOST_CHECK_EQUAL(pool.idleCount(), 0u);
+    pool.release(std::move(buf2));
+    BOOST_CHECK_EQUAL(pool.idleCount(), 1u);
+}
+
 BOOST_AUTO_TEST_CASE(ScanTableInfo) {
     lsst::qserv::proto::ScanTableInfo stiA{"dba", "fruit", false, 1};
     lsst::qserv::proto::ScanTableInfo stiB{"dba", "fruit", true, 1};
@@ -37,6 +37,7 @@
 
 // Qserv headers
 #include "czar/Czar.h"
+#include "util/ConfigStore.h"
 
 
 namespace {
@@ -53,6 +54,18 @@ std::shared_ptr<lsst::qserv::czar::Czar> _czar;
 // happen simultaneously from several threads.
 std::mutex _czarMutex;
 
+/// Context of one registered client session; the hints are parsed once
+/// at registration and per-query calls pass just the session handle.
+struct SessionContext {
+    std::string clientId; ///< client_dst_name from proxy.
+    int threadId = -1;    ///< server_thread_id from proxy, -1 if unknown.
+    std::string defaultDb;
+};
+
+std::mutex _sessionMutex; ///< protects the two members below.
+std::map<int, SessionContext> _sessions;
+int _nextSessionId = 0;
+
 }
 
 namespace lsst {
@@ -102,6 +115,81 @@ submitQuery(std::string const& query, std::map<std::string, std::string> const&
     return ::_czar->submitQuery(query, hints);
 }
 
+int
+registerSession(std::map<std::string, std::string> const& hints) {
+    util::ConfigStore hintsConfigStore(hints);
+    SessionContext context;
+    context.clientId = hintsConfigStore.get("client_dst_name");
+    context.threadId = hintsConfigStore.getInt("server_thread_id", -1);
+    context.defaultDb = hintsConfigStore.get("db");
+
+    std::string const defaultDb = context.defaultDb;
+    int sessionId;
+    {
+        std::lock_guard<std::mutex> lock(_sessionMutex);
+        sessionId = ++::_nextSessionId;
+        ::_sessions[sessionId] = std::move(context);
+        LOGS(_log, LOG_LVL_INFO, "Registered session " << sessionId
+             << " client=" << ::_sessions[sessionId].clientId
+             << " threadId=" << ::_sessions[sessionId].threadId
+             << " db=" << ::_sessions[sessionId].defaultDb);
+    }
+    // Warm up the session's database in the background so its first
+    // query finds the metadata already resident. The czar spawns a
+    // detached thread, so the connect is not delayed.
+    if (not defaultDb.empty() and ::_czar != nullptr) {
+        ::_czar->warmUpDatabase(defaultDb);
+    }
+    return sessionId;
+}
+
+void
+updateSessionDb(int sessionId, std::string const& defaultDb) {
+    bool dbChanged = false;
+    {
+        std::lock_guard<std::mutex> lock(_sessionMutex);
+        auto iter = ::_sessions.find(sessionId);
+        if (iter == ::_sessions.end()) {
+            throw std::runtime_error("czarProxy/updateSessionDb(): unknown session "
+                                     + std::to_string(sessionId));
+        }
+        LOGS(_log, LOG_LVL_INFO, "Session " << sessionId << " default db changed to \""
+             << defaultDb << "\"");
+        dbChanged = iter->second.defaultDb != defaultDb;
+        iter->second.defaultDb = defaultDb;
+    }
+    // First reference of a database by this session, warm it up like on
+    // connect (see registerSession).
+    if (dbChanged and not defaultDb.empty() and ::_czar != nullptr) {
+        ::_czar->warmUpDatabase(defaultDb);
+    }
+}
+
+void
+unregisterSession(int sessionId) {
+    std::lock_guard<std::mutex> lock(_sessionMutex);
+    ::_sessions.erase(sessionId);
+    LOGS(_log, LOG_LVL_DEBUG, "Unregistered session " << sessionId);
+}
+
+czar::SubmitResult
+submitQuery(std::string const& query, int sessionId) {
+    if (not ::_czar) {
+        throw std::runtime_error("czarProxy/submitQuery(): czar instance not initialized");
+    }
+    SessionContext context;
+    {
+        std::lock_guard<std::mutex> lock(_sessionMutex);
+        auto iter = ::_sessions.find(sessionId);
+        if (iter == ::_sessions.end()) {
+            throw std::runtime_error("czarProxy/submitQuery(): unknown session "
+                                     + std::to_string(sessionId));
+        }
+        context = iter->second;
+    }
+    return ::_czar->submitQuery(query, context.clientId, context.threadId, context.defaultDb);
+}
+
 void
 killQuery(std::string const& query, std::string const& clientId) {
     if (not ::_czar) {
@@ -70,6 +70,47 @@ void initCzar(std::string const& czarName);
 czar::SubmitResult submitQuery(std::string const& query,
                                std::map<std::string, std::string> const& hints);
 
+/**
+ * Register a client session.
+ *
+ * The hints map is parsed once here instead of once per statement: the
+ * client identity ("client_dst_name"), thread id ("server_thread_id")
+ * and default database ("db") are kept in an indexed session context,
+ * and per-query calls pass just the returned handle. The context is
+ * also the natural place for future per-session state (plan or result
+ * cache hooks).
+ *
+ * @param hints: Session hints, same keys as the per-query hints map.
+ * @return Session handle for subsequent submitQuery() calls.
+ */
+int registerSession(std::map<std::string, std::string> const& hints);
+
+/**
+ * Update the default database of a registered session, to be called
+ * when the client changes it (USE <db>).
+ *
+ * @param sessionId: Handle returned by registerSession().
+ * @param defaultDb: New default database name, may be empty.
+ */
+void updateSessionDb(int sessionId, std::string const& defaultDb);
+
+/**
+ * Forget a registered session, to be called when the client disconnects.
+ * Unknown handles are ignored.
+ *
+ * @param sessionId: Handle returned by registerSession().
+ */
+void unregisterSession(int sessionId);
+
+/**
+ * Submit query for execution under a registered session.
+ *
+ * @param query:     Query text.
+ * @param sessionId: Handle returned by registerSession().
+ * @return Structure with info about submitted query.
+ */
+czar::SubmitResult submitQuery(std::string const& query, int sessionId);
+
 /**
  * Process a kill query command (experimental).
  *
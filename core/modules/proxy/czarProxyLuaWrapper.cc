@@ -14,6 +14,9 @@ extern "C" {
 namespace {
 
 int luaInitCzar(lua_State *L);
+int luaRegisterSession(lua_State *L);
+int luaUpdateSessionDb(lua_State *L);
+int luaUnregisterSession(lua_State *L);
 int luaSubmitQuery(lua_State *L);
 int luaKillQuery(lua_State *L);
 int luaLog(lua_State *L);
@@ -33,6 +36,9 @@ luaopen_czarProxy(lua_State* L) {
         lua_CFunction fun;
     } methods[] = {
             {"initCzar", luaInitCzar},
+            {"registerSession", luaRegisterSession},
+            {"updateSessionDb", luaUpdateSessionDb},
+            {"unregisterSession", luaUnregisterSession},
             {"submitQuery", luaSubmitQuery},
             {"killQuery", luaKillQuery},
             {"log", luaLog}
@@ -71,19 +77,17 @@ int luaInitCzar(lua_State *L) {
     }
 }
 
-int luaSubmitQuery(lua_State *L) {
-    // called as submitQuery(query:str, hints:table) -> table
+int luaRegisterSession(lua_State *L) {
+    // called as registerSession(hints:table) -> number
     try {
-        if (lua_gettop(L) != 2) {
-            lua_pushstring(L, "Two arguments expected in submitQuery(query:str, hints:table)");
+        if (lua_gettop(L) != 1) {
+            lua_pushstring(L, "One argument expected in registerSession(hints:table)");
             lua_error(L);   // lua_error() does not return
         }
-        if (!lua_istable(L, -1) or !lua_isstring(L, -2)) {
-            lua_pushstring(L, "submitQuery(query:str, hints:table) -- incorrect argument type");
+        if (!lua_istable(L, -1)) {
+            lua_pushstring(L, "registerSession(hints:table) -- incorrect argument type");
             lua_error(L);   // lua_error() does not return
         }
-        size_t lenQuery;
-        const char* query = lua_tolstring(L, -2, &lenQuery);
 
         // copy table to map
         std::map<std::string, std::string> hints;
@@ -91,7 +95,7 @@ int luaSubmitQuery(lua_State *L) {
         while (lua_next(L, -2) != 0) {
             /* uses 'key' (at index -2) and 'value' (at index -1) */
             if(!(lua_isstring(L, -2) && lua_isstring(L, -1))) {
-                lua_pushstring(L, "submitQuery(query:str, hints:table) - incorrect type in hints table");
+                lua_pushstring(L, "registerSession(hints:table) - incorrect type in hints table");
                 lua_error(L);   // lua_error() does not return
             }
             size_t lenKey, lenVal;
@@ -101,7 +105,102 @@ int luaSubmitQuery(lua_State *L) {
             lua_pop(L, 1);  // removes 'value'; keeps 'key' for next iteration
         }
 
-        lsst::qserv::czar::SubmitResult res = lsst::qserv::proxy::submitQuery(std::string(query, lenQuery), hints);
+        int const sessionId = lsst::qserv::proxy::registerSession(hints);
+        lua_pushinteger(L, sessionId);
+        return 1;
+
+    } catch (std::exception const& exc) {
+        lua_pushstring(L, exc.what());
+        lua_error(L);   // lua_error() does not return
+        return 0;
+    }
+}
+
+int luaUpdateSessionDb(lua_State *L) {
+    // called as updateSessionDb(sessionId:number, db:str)
+    try {
+        if (lua_gettop(L) != 2) {
+            lua_pushstring(L, "Two arguments expected in updateSessionDb(sessionId:number, db:str)");
+            lua_error(L);   // lua_error() does not return
+        }
+        if (!lua_isstring(L, -1) or !lua_isnumber(L, -2)) {
+            lua_pushstring(L, "updateSessionDb(sessionId:number, db:str) -- incorrect argument type");
+            lua_error(L);   // lua_error() does not return
+        }
+        int const sessionId = lua_tointeger(L, -2);
+        size_t lenDb;
+        const char* db = lua_tolstring(L, -1, &lenDb);
+
+        lsst::qserv::proxy::updateSessionDb(sessionId, std::string(db, lenDb));
+        return 0;
+
+    } catch (std::exception const& exc) {
+        lua_pushstring(L, exc.what());
+        lua_error(L);   // lua_error() does not return
+        return 0;
+    }
+}
+
+int luaUnregisterSession(lua_State *L) {
+    // called as unregisterSession(sessionId:number)
+    try {
+        if (lua_gettop(L) != 1) {
+            lua_pushstring(L, "One argument expected in unregisterSession(sessionId:number)");
+            lua_error(L);   // lua_error() does not return
+        }
+        if (!lua_isnumber(L, -1)) {
+            lua_pushstring(L, "unregisterSession(sessionId:number) -- incorrect argument type");
+            lua_error(L);   // lua_error() does not return
+        }
+        lsst::qserv::proxy::unregisterSession(lua_tointeger(L, -1));
+        return 0;
+
+    } catch (std::exception const& exc) {
+        lua_pushstring(L, exc.what());
+        lua_error(L);   // lua_error() does not return
+        return 0;
+    }
+}
+
+int luaSubmitQuery(lua_State *L) {
+    // called as submitQuery(query:str, sessionId:number) -> table
+    // (or, for unregistered callers, submitQuery(query:str, hints:table) -> table)
+    try {
+        if (lua_gettop(L) != 2) {
+            lua_pushstring(L, "Two arguments expected in submitQuery(query:str, sessionId:number)");
+            lua_error(L);   // lua_error() does not return
+        }
+        if (!(lua_isnumber(L, -1) or lua_istable(L, -1)) or !lua_isstring(L, -2)) {
+            lua_pushstring(L, "submitQuery(query:str, sessionId:number) -- incorrect argument type");
+            lua_error(L);   // lua_error() does not return
+        }
+        size_t lenQuery;
+        const char* query = lua_tolstring(L, -2, &lenQuery);
+
+        lsst::qserv::czar::SubmitResult res;
+        if (lua_isnumber(L, -1)) {
+            // session handle, the context was parsed at registration
+            int const sessionId = lua_tointeger(L, -1);
+            res = lsst::qserv::proxy::submitQuery(std::string(query, lenQuery), sessionId);
+        } else {
+            // copy table to map
+            std::map<std::string, std::string> hints;
+            lua_pushnil(L);  /* first key */
+            while (lua_next(L, -2) != 0) {
+                /* uses 'key' (at index -2) and 'value' (at index -1) */
+                if(!(lua_isstring(L, -2) && lua_isstring(L, -1))) {
+                    lua_pushstring(L, "submitQuery(query:str, hints:table) - incorrect type in hints table");
+                    lua_error(L);   // lua_error() does not return
+                }
+                size_t lenKey, lenVal;
+                const char* key = lua_tolstring(L, -2, &lenKey);
+                const char* val = lua_tolstring(L, -1, &lenVal);
+                hints.insert(std::make_pair(std::string(key, lenKey), std::string(val, lenVal)));
+                lua_pop(L, 1);  // removes 'value'; keeps 'key' for next iteration
+            }
+
+            res = lsst::qserv::proxy::submitQuery(std::string(query, lenQuery), hints);
+        }
 
         // convert result to table
         lua_newtable(L);
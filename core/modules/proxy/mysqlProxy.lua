@@ -284,7 +284,9 @@ function queryProcessing()
     local self = { msgTableName = nil,
                    resultTableName = nil,
                    orderByClause = nil,
-                   initialized = false }
+                   initialized = false,
+                   sessionId = nil,
+                   sessionDb = nil }
 
     ---------------------------------------------------------------------------
 
@@ -309,24 +311,41 @@ function queryProcessing()
     --
     local sendToQserv = function(q, qU)
 
-        local hintsToPassArr = {}
         -- Force original query to delegate spatial work to qsmaster.
         local queryToPassStr = q
-        -- Add client db context
-        hintsToPassArr["db"] = proxy.connection.client.default_db
 
-        -- Need to save thread_id and reuse for killing query
-        hintsToPassArr["client_dst_name"] = proxy.connection.client.dst.name
-        hintsToPassArr["server_thread_id"] = proxy.connection.server.thread_id
-        czarProxy.log("mysql-proxy", "INFO", "proxy.connection.server.thread_id: " .. proxy.connection.server.thread_id)
-        czarProxy.log("mysql-proxy", "INFO", "Passing query: " .. queryToPassStr)
+        -- Register this client connection with the czar once; per-query
+        -- calls then pass just the session handle instead of a hints
+        -- table that would be rebuilt and re-parsed on every statement.
+        -- The default db can change mid-session (USE <db>), push the
+        -- change to the session context when it happens.
+        local clientDb = proxy.connection.client.default_db or ""
+        if (self.sessionId == nil) then
+            local hintsToPassArr = {}
+            -- Add client db context
+            hintsToPassArr["db"] = clientDb
+            -- Need to save thread_id and reuse for killing query
+            hintsToPassArr["client_dst_name"] = proxy.connection.client.dst.name
+            hintsToPassArr["server_thread_id"] = proxy.connection.server.thread_id
+            czarProxy.log("mysql-proxy", "INFO", "Registering session: " .. utils.tableToString(hintsToPassArr))
+            local ok, res = pcall(czarProxy.registerSession, hintsToPassArr)
+            if (not ok) then
+                return err.set(ERR_CZAR_EXCEPTION, "Exception in call to czar method: " .. res)
+            end
+            self.sessionId = res
+            self.sessionDb = clientDb
+        elseif (self.sessionDb ~= clientDb) then
+            local ok, res = pcall(czarProxy.updateSessionDb, self.sessionId, clientDb)
+            if (not ok) then
+                return err.set(ERR_CZAR_EXCEPTION, "Exception in call to czar method: " .. res)
+            end
+            self.sessionDb = clientDb
+        end
 
-        -- Build hint string
-        local hintsToPassStr = utils.tableToString(hintsToPassArr)
-        czarProxy.log("mysql-proxy", "INFO", "Passing hints: " .. hintsToPassStr)
+        czarProxy.log("mysql-proxy", "INFO", "Passing query: " .. queryToPassStr)
 
         -- send query to czar
-        local ok, res = pcall(czarProxy.submitQuery, queryToPassStr, hintsToPassArr)
+        local ok, res = pcall(czarProxy.submitQuery, queryToPassStr, self.sessionId)
         if (not ok) then
             return err.set(ERR_CZAR_EXCEPTION, "Exception in call to czar method: " .. res)
         end
@@ -445,8 +464,19 @@ function queryProcessing()
 
     ---------------------------------------------------------------------------
 
+    local endSession = function()
+        if (self.sessionId ~= nil) then
+            pcall(czarProxy.unregisterSession, self.sessionId)
+            self.sessionId = nil
+            self.sessionDb = nil
+        end
+    end
+
+    ---------------------------------------------------------------------------
+
     return {
         initializeCzar = initializeCzar,
+        endSession = endSession,
         sendToQserv = sendToQserv,
         killQservQuery = killQservQuery,
         processLocally = processLocally,
@@ -573,3 +603,9 @@ function read_query_result(inj)
         czarProxy.log("mysql-proxy", "INFO", "q2 - passing")
     end
 end
+
+function disconnect_client()
+    -- each client connection has its own script scope, so this drops
+    -- exactly the session registered by this connection (if any)
+    qProc.endSession()
+end
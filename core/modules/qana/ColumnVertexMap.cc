@@ -38,6 +38,24 @@
 #include "query/QueryTemplate.h"
 
 
+namespace {
+
+/// Pack a (db, table, column) triple into a single hash key. NUL is used
+/// as the separator since it cannot occur inside an identifier.
+std::string makeIndexKey(lsst::qserv::query::ColumnRef const& c) {
+    std::string key;
+    key.reserve(c.db.size() + c.table.size() + c.column.size() + 2);
+    key += c.db;
+    key += '\0';
+    key += c.table;
+    key += '\0';
+    key += c.column;
+    return key;
+}
+
+} // anonymous namespace
+
+
 namespace lsst {
 namespace qserv {
 namespace qana {
@@ -50,20 +68,32 @@ ColumnVertexMap::ColumnVertexMap(Vertex& v) {
 std::vector<Vertex*> const& ColumnVertexMap::find(
     query::ColumnRef const& c) const
 {
-    typedef std::vector<Entry>::const_iterator Iter;
     std::vector<Vertex*> static const NONE;
 
-    std::pair<Iter,Iter> p = std::equal_range(
-        _entries.begin(), _entries.end(), c, ColumnRefLt());
-    if (p.first == p.second) {
+    if (!_indexValid) {
+        _buildIndex();
+    }
+    auto const i = _index.find(makeIndexKey(c));
+    if (i == _index.end()) {
         return NONE;
-    } else if (p.first->isAmbiguous()) {
+    }
+    Entry const& entry = _entries[i->second];
+    if (entry.isAmbiguous()) {
         query::QueryTemplate qt;
         c.renderTo(qt);
         throw QueryNotEvaluableError("Column reference " + qt.sqlFragment() +
                                      " is ambiguous");
     }
-    return p.first->vertices;
+    return entry.vertices;
+}
+
+void ColumnVertexMap::_buildIndex() const {
+    _index.clear();
+    _index.reserve(_entries.size());
+    for (size_t i = 0; i < _entries.size(); ++i) {
+        _index[makeIndexKey(*_entries[i].cr)] = i;
+    }
+    _indexValid = true;
 }
 
 void ColumnVertexMap::fuse(ColumnVertexMap& m,
@@ -124,6 +154,9 @@ void ColumnVertexMap::fuse(ColumnVertexMap& m,
         // entries at or before cur - erase them.
         _entries.erase(++cur, _entries.end());
     }
+    // Entry positions have changed; rebuild the hash index on next use.
+    _indexValid = false;
+    m._indexValid = false;
 }
 
 std::vector<std::string> const ColumnVertexMap::computeCommonColumns(
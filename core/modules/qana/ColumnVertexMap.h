@@ -31,6 +31,7 @@
 #include <algorithm>
 #include <memory>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
 // Local headers
@@ -108,11 +109,19 @@ public:
 
     void swap(ColumnVertexMap& m) {
         _entries.swap(m._entries);
+        _index.swap(m._index);
+        std::swap(_indexValid, m._indexValid);
     }
 
     /// `find` returns the vertices for table references corresponding to the
     /// given column reference. An empty vector is returned for unrecognized
     /// columns. If `c` is ambiguous, an exception is thrown.
+    ///
+    /// Lookups go through a hash index over the entries, so a single find
+    /// is O(1) in the number of columns. The index is invalidated by `fuse`
+    /// and rebuilt lazily on the next find; graph construction alternates
+    /// between a fusing phase and a classification phase with many finds,
+    /// so each index is built at most once per join.
     std::vector<Vertex*> const& find(query::ColumnRef const& c) const;
 
     /// `fuse` transfers the entries of `m` to this map, emptying `m`.
@@ -139,12 +148,20 @@ public:
 private:
     std::vector<Entry> _entries; // sorted
 
+    // Hash index from column reference to entry position, rebuilt lazily
+    // after mutations (see find()). Keys are the packed (db, table, column)
+    // triple of each entry.
+    mutable std::unordered_map<std::string, size_t> _index;
+    mutable bool _indexValid = false;
+
     // Not implemented
     ColumnVertexMap(ColumnVertexMap const&);
     ColumnVertexMap& operator=(ColumnVertexMap const&);
 
     template <typename InputIterator>
     inline void _init(Vertex& v, InputIterator first, InputIterator last);
+
+    void _buildIndex() const;
 };
 
 
@@ -221,6 +238,7 @@ inline void ColumnVertexMap::_init(Vertex& v,
         _entries.push_back(Entry(*first, &v));
     }
     std::sort(_entries.begin(), _entries.end(), ColumnRefLt());
+    _indexValid = false;
 }
 
 }}} // namespace lsst::qserv::qana
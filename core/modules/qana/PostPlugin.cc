@@ -85,7 +85,20 @@ PostPlugin::applyPhysical(QueryPlugin::Plan& plan,
     LOGS(_log, LOG_LVL_DEBUG, "Apply physical");
 
     if (_limit != NOTSET) {
-        // [ORDER BY ...] LIMIT ... is a special case which require sort on worker and sort/aggregation on czar
+        // A plain LIMIT (no ORDER BY, DISTINCT, or aggregation - the latter
+        // two would have set needsMerge before this plugin runs) lets each
+        // worker stop scanning after LIMIT rows and lets the czar squash the
+        // remaining jobs once enough rows have been merged, since any LIMIT
+        // rows are an acceptable answer. Record the budget for dispatch.
+        if (!_orderBy && !context.needsMerge && !plan.stmtOriginal.getDistinct()
+            && !plan.stmtOriginal.hasGroupBy()) {
+            LOGS(_log, LOG_LVL_DEBUG, "Plain LIMIT, setting rowBudget=" << _limit);
+            context.rowBudget = _limit;
+        }
+        // [ORDER BY ...] LIMIT ... is a special case which require sort on worker and sort/aggregation
+        // on czar. The parallel statements keep both clauses (they are clones of the original), so each
+        // chunk query returns at most LIMIT rows, and the merge statement keeps them so the czar can
+        // retain just the overall top rows (see rproc::TopKCombiner).
         if (context.hasChunks()) {
              LOGS(_log, LOG_LVL_DEBUG, "Add merge operation");
              context.needsMerge = true;
@@ -336,13 +336,12 @@ newInPred(std::string const& aliasTable,
     return p;
 }
 
-template <typename C>
-query::FuncExpr::Ptr newFuncExpr(char const fName[],
+query::FuncExpr::Ptr newFuncExpr(std::string const& fName,
                                  std::string const& tableAlias,
                                  StringPair const& chunkColumns,
-                                 C& c) {
+                                 query::ValueExprPtrVector const& constParams) {
     query::FuncExpr::Ptr fe = std::make_shared<query::FuncExpr>();
-    fe->setName(UDF_PREFIX + fName);
+    fe->setName(fName);
     fe->params.push_back(
           query::ValueExpr::newSimple(query::ValueFactor::newColumnRefFactor(
                   std::make_shared<query::ColumnRef>(
@@ -351,12 +350,7 @@ query::FuncExpr::Ptr newFuncExpr(char const fName[],
           query::ValueExpr::newSimple(query::ValueFactor::newColumnRefFactor(
                   std::make_shared<query::ColumnRef>(
                           "", tableAlias, chunkColumns.second))));
-
-    typename C::const_iterator i;
-    for (i = c.begin(); i != c.end(); ++i) {
-        fe->params.push_back(
-          query::ValueExpr::newSimple(query::ValueFactor::newConstFactor(*i)));
-    }
+    fe->params.insert(fe->params.end(), constParams.begin(), constParams.end());
     return fe;
 }
 
@@ -418,6 +412,14 @@ public:
 // QservRestrictorPlugin::Restriction
 // Generates WHERE clause terms from restriction specs. Borrowed from
 // older parsing framework.
+//
+// A Restriction is compiled once per restrictor: the spec name is
+// resolved to its scisql UDF and the literal parameters are tokenized
+// into ValueExprs in the constructor. generate() then only builds the
+// per-table pieces (the chunk-column refs for a given alias), so a
+// query with many areaspecs over many tables does the string work once.
+// The constant parameter nodes are shared between the generated factors;
+// this is safe because later plugins never rewrite constant factors.
 ////////////////////////////////////////////////////////////////////////
 class QservRestrictorPlugin::Restriction {
 public:
@@ -429,13 +431,6 @@ public:
         return (*_generator)(e);
     }
 
-    // std::string getUdfCallString(std::string const& tName,
-    //                              StringMap const& tableConfig) const {
-    //     if (_generator.get()) {
-    //         return (*_generator)(tName, tableConfig);
-    //     }
-    //     return std::string();
-    // }
     class Generator {
     public:
         virtual ~Generator() {}
@@ -446,12 +441,19 @@ private:
     public:
         AreaGenerator(char const* fName_, int paramCount_,
                       StringVector const& params_)
-            :  fName(fName_), paramCount(paramCount_), params(params_) {
+            :  fName(UDF_PREFIX + fName_), paramCount(paramCount_) {
             if (paramCount_ == USE_STRING) {
                 // Convert param list to one quoted string.
                 // This bundles a variable-sized list into a single
                 // parameter to work with the MySQL UDF facility.
             }
+            // Pre-tokenize the literal parameters; they are identical for
+            // every table entry and every chunk render.
+            constParams.reserve(params_.size());
+            for (auto const& param : params_) {
+                constParams.push_back(query::ValueExpr::newSimple(
+                        query::ValueFactor::newConstFactor(param)));
+            }
         }
 
         virtual query::BoolFactor::Ptr operator()(RestrictorEntry const& e) {
@@ -461,7 +463,7 @@ private:
             query::CompPredicate::Ptr cp =
                     std::make_shared<query::CompPredicate>();
             std::shared_ptr<query::FuncExpr> fe =
-                newFuncExpr(fName, e.alias, e.chunkColumns, params);
+                newFuncExpr(fName, e.alias, e.chunkColumns, constParams);
             cp->left =
                 query::ValueExpr::newSimple(query::ValueFactor::newFuncFactor(fe));
             cp->op = SqlSQL2Tokens::EQUALS_OP;
@@ -470,9 +472,9 @@ private:
             terms.push_back(cp);
             return newFactor;
         }
-        char const* const fName;
+        std::string const fName;
         int const paramCount;
-        StringVector const& params;
+        query::ValueExprPtrVector constParams;
         static const int USE_STRING = -999;
     };
 
@@ -549,10 +551,11 @@ QservRestrictorPlugin::applyLogical(query::SelectStmt& stmt,
         // spatial restrictions
         // Now, for each of the qserv restrictors:
         for (auto const& restrictor : *whereClauseRestrictors) {
-            // for each restrictor entry
-            // generate a restrictor condition.
+            // Compile the restrictor once, then generate a condition for
+            // each restrictor entry.
+            Restriction compiled(*restrictor);
             for (auto const& entry : entries) {
-                newTerm->_terms.push_back(_makeCondition(restrictor, entry));
+                newTerm->_terms.push_back(compiled.generate(entry));
             }
             // Save restrictor in QueryContext.
             ctxRestrictors.push_back(restrictor);
@@ -577,12 +580,4 @@ QservRestrictorPlugin::applyPhysical(QueryPlugin::Plan& p,
     // Probably nothing is needed here...
 }
 
-query::BoolTerm::Ptr
-QservRestrictorPlugin::_makeCondition(
-             std::shared_ptr<query::QsRestrictor> const restr,
-             RestrictorEntry const& restrictorEntry) {
-    Restriction r(*restr);
-    return r.generate(restrictorEntry);
-}
-
 }}} // namespace lsst::qserv::qana
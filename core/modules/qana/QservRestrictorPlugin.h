@@ -74,11 +74,6 @@ public:
 
     void applyLogical(query::SelectStmt& stmt, query::QueryContext&) override;
     void applyPhysical(QueryPlugin::Plan& p, query::QueryContext& context) override;
-
-private:
-    query::BoolTerm::Ptr
-        _makeCondition(std::shared_ptr<query::QsRestrictor> const restr,
-                       RestrictorEntry const& restrictorEntry);
 };
 
 
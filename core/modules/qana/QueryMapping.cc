@@ -26,9 +26,9 @@
 #include "qana/QueryMapping.h"
 
 // System headers
-#include <deque>
 #include <sstream>
 #include <stdexcept>
+#include <vector>
 
 // Third-party headers
 #include "boost/lexical_cast.hpp"
@@ -53,117 +53,91 @@ namespace qserv {
 namespace qana {
 
 
-std::string const replace(std::string const& s, std::string const& pat, std::string const& value) {
-    std::string result;
-    size_t i = 0;
-    result.reserve(s.size() + value.size());
-    while(true) {
-        size_t j = s.find(pat, i);
-        result.append(s, i, j - i);
-        if (j == std::string::npos) {
-            break;
-        }
-        result.append(value);
-        i = j + pat.size();
-    }
-    return result;
-}
-
-class Mapping : public query::QueryTemplate::EntryMapping {
-public:
-
-    Mapping(QueryMapping::ParameterMap const& m, qproc::ChunkSpec const& s)
-        : _subChunks(s.subChunks.begin(), s.subChunks.end()) {
-        _chunkString = boost::lexical_cast<std::string>(s.chunkId);
-        if (!_subChunks.empty()) {
-            _subChunkString = boost::lexical_cast<std::string>(_subChunks.front());
-        }
-        _initMap(m);
-    }
-    Mapping(QueryMapping::ParameterMap const& m, qproc::ChunkSpecSingle const& s) {
-        _chunkString = boost::lexical_cast<std::string>(s.chunkId);
-        _subChunkString = boost::lexical_cast<std::string>(s.subChunkId);
-        _subChunks.push_back(s.subChunkId);
-        _initMap(m);
-    }
-    virtual ~Mapping() {}
-
-    query::QueryTemplate::Entry::Ptr mapEntry(query::QueryTemplate::Entry const& e) const override {
-        auto newE = std::make_shared<query::QueryTemplate::StringEntry>(e.getValue());
-
-        // FIXME see if this works
-        //if (!e.isDynamic()) {return newE; }
+////////////////////////////////////////////////////////////////////////
+// struct QueryMapping::CompiledTemplate
+////////////////////////////////////////////////////////////////////////
 
-        for(auto i=_replaceItems.begin(); i != _replaceItems.end(); ++i) {
-            newE->s = replace(newE->s, i->pattern, i->target);
-        }
-        return newE;
-    }
-    bool valid() const {
-        return _subChunkString.empty()
-            || (!_subChunkString.empty() && !_subChunks.empty());
-    }
-private:
-    inline void _initMap(QueryMapping::ParameterMap const& m) {
-        QueryMapping::ParameterMap::const_iterator i;
-        for(i = m.begin(); i != m.end(); ++i) {
-            _replaceItems.push_back(MapTuple(i->first, lookup(i->second), i->second));
+/// The literal text of a rendered template plus the ordered substitution
+/// slots found in it. literals has one more element than slots; the output
+/// is literals[0] + value(slots[0]) + literals[1] + ...
+struct QueryMapping::CompiledTemplate {
+    std::vector<std::string> literals;
+    std::vector<QueryMapping::Parameter> slots;
+    size_t literalSize = 0; ///< total bytes in literals, for reserve()
+
+    /// Build from the template's rendered text by splitting it at every
+    /// occurrence of a tag in 'subs'. Tags sit inside generated table names,
+    /// so rendering before substitution yields the same separator decisions
+    /// as the entry-by-entry path it replaces ('%' and digits join alnum
+    /// neighbors identically in sqlShouldSeparate).
+    CompiledTemplate(std::string const& text, QueryMapping::ParameterMap const& subs) {
+        size_t pos = 0;
+        while (pos <= text.size()) {
+            size_t bestAt = std::string::npos;
+            QueryMapping::ParameterMap::const_iterator best = subs.end();
+            for (auto i = subs.begin(); i != subs.end(); ++i) {
+                size_t at = text.find(i->first, pos);
+                if (at < bestAt) { bestAt = at; best = i; }
+            }
+            if (best == subs.end()) { break; }
+            literals.push_back(text.substr(pos, bestAt - pos));
+            slots.push_back(best->second);
+            pos = bestAt + best->first.size();
         }
+        literals.push_back(text.substr(pos));
+        for (auto const& lit : literals) { literalSize += lit.size(); }
     }
 
-    inline std::string lookup(QueryMapping::Parameter const& p) const {
-        switch(p) {
-        case QueryMapping::INVALID:
-            return "INVALID";
-        case QueryMapping::CHUNK:
-            return _chunkString;
-        case QueryMapping::SUBCHUNK:
-            return _subChunkString;
-        case QueryMapping::HTM1:
-            throw std::range_error("HTM unimplemented");
-        default:
-            throw std::range_error("Unknown mapping parameter");
+    std::string render(std::string const& chunk, std::string const& subChunk) const {
+        std::string out;
+        out.reserve(literalSize + slots.size()*chunk.size());
+        for (size_t i = 0; i != slots.size(); ++i) {
+            out += literals[i];
+            switch (slots[i]) {
+            case QueryMapping::CHUNK: out += chunk; break;
+            case QueryMapping::SUBCHUNK: out += subChunk; break;
+            case QueryMapping::HTM1:
+                throw std::range_error("HTM unimplemented");
+            default:
+                throw std::range_error("Unknown mapping parameter");
+            }
         }
+        out += literals.back();
+        return out;
     }
-    void _nextSubChunk() {
-        _subChunks.pop_front();
-        if (_subChunks.empty()) return;
-        _subChunkString = boost::lexical_cast<std::string>(_subChunks.front());
-    }
-
-    std::string _chunkString;
-    std::string _subChunkString;
-    std::deque<int> _subChunks;
-
-    struct MapTuple {
-        MapTuple(std::string const& pattern,
-                 std::string const& target,
-                 QueryMapping::Parameter p)
-            : pattern(pattern), target(target), paramType(p) {}
-        std::string pattern;
-        std::string target;
-        QueryMapping::Parameter paramType;
-    };
-
-    std::deque<MapTuple> _replaceItems;
 };
 
+
 ////////////////////////////////////////////////////////////////////////
 // class QueryMapping implementation
 ////////////////////////////////////////////////////////////////////////
 QueryMapping::QueryMapping() {}
 
+std::shared_ptr<QueryMapping::CompiledTemplate const>
+QueryMapping::_compile(query::QueryTemplate const& t) const {
+    std::lock_guard<std::mutex> lock(_compiledMutex);
+    auto iter = _compiled.find(&t);
+    if (iter != _compiled.end()) { return iter->second; }
+    auto ct = std::make_shared<CompiledTemplate const>(t.sqlFragment(), _subs);
+    _compiled[&t] = ct;
+    return ct;
+}
+
+
 std::string QueryMapping::apply(qproc::ChunkSpec const& s, query::QueryTemplate const& t) const {
-    Mapping m(_subs, s);
-    std::string str = t.generate(m);
-    return str;
+    std::string const chunk = boost::lexical_cast<std::string>(s.chunkId);
+    std::string subChunk;
+    if (!s.subChunks.empty()) {
+        subChunk = boost::lexical_cast<std::string>(s.subChunks.front());
+    }
+    return _compile(t)->render(chunk, subChunk);
 }
 
 
 std::string QueryMapping::apply(qproc::ChunkSpecSingle const& s, query::QueryTemplate const& t) const {
-    Mapping m(_subs, s);
-    std::string str = t.generate(m);
-    return str;
+    std::string const chunk = boost::lexical_cast<std::string>(s.chunkId);
+    std::string const subChunk = boost::lexical_cast<std::string>(s.subChunkId);
+    return _compile(t)->render(chunk, subChunk);
 }
 
 
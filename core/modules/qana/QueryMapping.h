@@ -31,6 +31,7 @@
 // System headers
 #include <map>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <string>
 
@@ -99,8 +100,22 @@ public:
     DbTableSet const& getSubChunkTables() const { return _subChunkTables; }
 
 private:
+    /// A template rendered once to text and split at its substitution tags:
+    /// per-chunk generation then just splices the partition numbers between
+    /// the literal pieces instead of re-walking the template entries.
+    struct CompiledTemplate;
+
+    /// @return the compiled form of 't', building and caching it on first
+    /// use. Templates are immutable once built, so they are keyed by
+    /// address; the cache lives only as long as this mapping (and thus the
+    /// query session that owns both).
+    std::shared_ptr<CompiledTemplate const> _compile(query::QueryTemplate const& t) const;
+
     ParameterMap _subs;
     DbTableSet _subChunkTables;
+    mutable std::map<query::QueryTemplate const*,
+                     std::shared_ptr<CompiledTemplate const>> _compiled;
+    mutable std::mutex _compiledMutex;
 };
 
 }}} // namespace lsst::qserv::qana
@@ -42,6 +42,7 @@
 // Qserv headers
 #include "global/stringTypes.h"
 #include "proto/ScanTableInfo.h"
+#include "qana/TableStats.h"
 #include "query/ColumnRef.h"
 #include "query/FromList.h"
 #include "query/QsRestrictor.h"
@@ -207,12 +208,26 @@ ScanTablePlugin::_findScanTables(query::SelectStmt& stmt,
 
     // Ask css if any of the tables should be locked in memory and their scan rating.
     // Use this information to determine scanPriority.
+    // Where measured statistics exist the rating is computed from the bytes
+    // a chunk scan will actually touch; the static CSS hint is only a
+    // fallback, so a tiny table declared "large" in CSS no longer costs a
+    // shared-scan slot.
     proto::ScanInfo scanInfo;
+    TableStats::Ptr const tableStats = TableStats::get();
     for (auto& pair : scanTables) {
         proto::ScanTableInfo info(pair.first, pair.second);
         css::ScanTableParams const params = context.css->getScanTableParams(info.db, info.table);
         info.lockInMemory = params.lockInMem;
-        info.scanRating = params.scanRating;
+        TableStats::Stats stats;
+        if (tableStats->lookup(info.db, info.table, stats)) {
+            info.scanRating = TableStats::ratingForBytesPerChunk(stats.bytesPerChunk());
+            LOGS(_log, LOG_LVL_DEBUG, "ScanInfo " << info.db << "." << info.table
+                  << " measured bytesPerChunk=" << stats.bytesPerChunk()
+                  << " rating=" << info.scanRating
+                  << " (css hint=" << params.scanRating << ")");
+        } else {
+            info.scanRating = params.scanRating;
+        }
         scanInfo.infoTables.push_back(info);
         scanInfo.scanRating = std::max(scanInfo.scanRating, info.scanRating);
         scanInfo.scanRating = std::min(scanInfo.scanRating, static_cast<int>(proto::ScanInfo::SLOWEST));
@@ -29,7 +29,9 @@
 
 // System headers
 #include <algorithm>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <utility>
 
 // Third-party headers
@@ -41,15 +43,59 @@
 #include "query/QueryContext.h"
 
 namespace {
+
+using lsst::qserv::qana::TableInfo;
+
 /// `TableInfoLt` is a less-than comparison functor for non-null `TableInfo`
 /// pointers.
 struct TableInfoLt {
-    bool operator()(std::unique_ptr<lsst::qserv::qana::TableInfo const> const& t1,
-            std::unique_ptr<lsst::qserv::qana::TableInfo const> const& t2) const {
+    bool operator()(std::shared_ptr<TableInfo const> const& t1,
+                    std::shared_ptr<TableInfo const> const& t2) const {
         return *t1 < *t2;
     }
 };
-}
+
+/// Czar-wide cache of built `TableInfo` objects, keyed by the CSS
+/// generation counter plus the (db, table) pair. A cached object carries
+/// the other objects it references (e.g. a match table's directors) so a
+/// hit keeps the whole linked group alive. Entries for a stale generation
+/// are simply left behind and dropped when the cache is trimmed; in-flight
+/// pools keep their own references, so pointers remain valid.
+class TableInfoCache {
+public:
+    /// Cached object plus the objects its raw pointers reference.
+    struct Entry {
+        std::shared_ptr<TableInfo const> info; ///< null for unpartitioned tables
+        std::vector<std::shared_ptr<TableInfo const>> deps;
+    };
+
+    static size_t const MAX_ENTRIES = 4096;
+
+    bool get(std::string const& key, Entry& entry) const {
+        std::lock_guard<std::mutex> lock(_mtx);
+        auto const iter = _entries.find(key);
+        if (iter == _entries.end()) { return false; }
+        entry = iter->second;
+        return true;
+    }
+
+    void put(std::string const& key, Entry const& entry) {
+        std::lock_guard<std::mutex> lock(_mtx);
+        if (_entries.size() >= MAX_ENTRIES) {
+            // Catalogs are nowhere near this large; this guards against a
+            // runaway generation counter, where dumping everything is fine.
+            _entries.clear();
+        }
+        _entries.insert(std::make_pair(key, entry));
+    }
+
+private:
+    mutable std::mutex _mtx;
+    std::map<std::string, Entry> _entries;
+};
+TableInfoCache tableInfoCache;
+
+} // anonymous namespace
 
 
 namespace lsst {
@@ -58,33 +104,61 @@ namespace qana {
 
 TableInfo const*
 TableInfoPool::get(std::string const& db, std::string const& table) {
+    return _get(db, table).get();
+}
+
+std::shared_ptr<TableInfo const>
+TableInfoPool::_get(std::string const& db, std::string const& table) {
 
     std::string const& db_ = db.empty() ? _defaultDb : db;
 
     // Note that t.kind is irrelevant to the search,
     // and is set to an arbitrary value.
-    std::unique_ptr<TableInfo const> t(new TableInfo(db, table, TableInfo::DIRECTOR));
+    std::shared_ptr<TableInfo const> t(new TableInfo(db_, table, TableInfo::DIRECTOR));
     auto range = std::equal_range(_pool.begin(), _pool.end(), t, TableInfoLt());
     if (range.first != range.second) {
-        return range.first->get();
+        return *range.first;
+    }
+
+    // Consult the czar-wide cache. An empty generation means the CSS
+    // backend cannot report data changes, so sharing across queries would
+    // risk staleness - objects then stay private to this pool.
+    std::string const generation = _css.getSnapshotGeneration();
+    std::string const cacheKey = generation + ":" + db_ + "." + table;
+    if (!generation.empty()) {
+        TableInfoCache::Entry entry;
+        if (tableInfoCache.get(cacheKey, entry)) {
+            // Adopt the object and its referenced group into this pool so
+            // everything stays alive and locally findable.
+            for (auto const& dep : entry.deps) {
+                _insert(dep);
+            }
+            if (entry.info == nullptr) { return nullptr; }
+            return _insert(entry.info);
+        }
     }
 
+    TableInfoCache::Entry entry;
+
     css::TableParams const tParam = _css.getTableParams(db_, table);
     css::PartTableParams const& partParam = tParam.partitioning;
     int const chunkLevel = partParam.chunkLevel();
     // unpartitioned table
     if (chunkLevel == 0) {
+        if (!generation.empty()) {
+            tableInfoCache.put(cacheKey, entry);
+        }
         return nullptr;
     }
     // match table
     if (tParam.match.isMatchTable()) {
         css::MatchTableParams const& m = tParam.match;
         double angSep = m.angSep;
-        std::unique_ptr<MatchTableInfo> infoPtr(new MatchTableInfo(db_, table, angSep));
-        infoPtr->director.first = dynamic_cast<DirTableInfo const*>(
-            get(db_, m.dirTable1));
-        infoPtr->director.second = dynamic_cast<DirTableInfo const*>(
-            get(db_, m.dirTable2));
+        std::shared_ptr<MatchTableInfo> infoPtr(new MatchTableInfo(db_, table, angSep));
+        std::shared_ptr<TableInfo const> const dir1 = _get(db_, m.dirTable1);
+        std::shared_ptr<TableInfo const> const dir2 = _get(db_, m.dirTable2);
+        infoPtr->director.first = dynamic_cast<DirTableInfo const*>(dir1.get());
+        infoPtr->director.second = dynamic_cast<DirTableInfo const*>(dir2.get());
         if (!infoPtr->director.first || !infoPtr->director.second) {
             throw InvalidTableError(db_ + "." + table + " is a match table, but"
                                     " does not reference two director tables!");
@@ -103,7 +177,13 @@ TableInfoPool::get(std::string const& db, std::string const& table) {
                                     " relates two director tables with"
                                     " different partitionings!");
         }
-        return _insert(std::move(infoPtr));
+        entry.info = _insert(infoPtr);
+        entry.deps.push_back(dir1);
+        entry.deps.push_back(dir2);
+        if (!generation.empty()) {
+            tableInfoCache.put(cacheKey, entry);
+        }
+        return entry.info;
     }
     std::string const& dirTable = partParam.dirTable;
     // director table
@@ -115,8 +195,8 @@ TableInfoPool::get(std::string const& db, std::string const& table) {
         css::StripingParams dbStriping = _css.getDbStriping(db_);
         // use per-table or per-database overlap value
         double overlap = partParam.overlap != 0.0 ? partParam.overlap : dbStriping.overlap;
-        std::unique_ptr<DirTableInfo> infoPtr(new DirTableInfo(db_, table, overlap));
-        std::vector<std::string> v = _css.getPartTableParams(db, table).partitionCols();
+        std::shared_ptr<DirTableInfo> infoPtr(new DirTableInfo(db_, table, overlap));
+        std::vector<std::string> v = _css.getPartTableParams(db_, table).partitionCols();
         if (v.size() != 3 ||
             v[0].empty() || v[1].empty() || v[2].empty() ||
             v[0] == v[1] || v[1] == v[2] || v[0] == v[2]) {
@@ -129,16 +209,20 @@ TableInfoPool::get(std::string const& db, std::string const& table) {
         infoPtr->lon = v[0];
         infoPtr->lat = v[1];
         infoPtr->partitioningId = dbStriping.partitioningId;
-        return _insert(std::move(infoPtr));
+        entry.info = _insert(infoPtr);
+        if (!generation.empty()) {
+            tableInfoCache.put(cacheKey, entry);
+        }
+        return entry.info;
     }
     // child table
     if (chunkLevel != 1) {
         throw InvalidTableError(db_ + "." + table + " is a child"
                                 " table, but can be sub-chunked!");
     }
-    std::unique_ptr<ChildTableInfo> infoPtr(new ChildTableInfo(db_, table));
-    infoPtr->director = dynamic_cast<DirTableInfo const*>(
-        get(db_, partParam.dirTable));
+    std::shared_ptr<ChildTableInfo> infoPtr(new ChildTableInfo(db_, table));
+    std::shared_ptr<TableInfo const> const dir = _get(db_, partParam.dirTable);
+    infoPtr->director = dynamic_cast<DirTableInfo const*>(dir.get());
     if (!infoPtr->director) {
         throw InvalidTableError(db_ + "." + table + " is a child table, but"
                                 " does not reference a director table!");
@@ -149,18 +233,25 @@ TableInfoPool::get(std::string const& db, std::string const& table) {
                                 " does not contain a director column name!");
     }
 
-    return _insert(std::move(infoPtr));
+    entry.info = _insert(infoPtr);
+    entry.deps.push_back(dir);
+    if (!generation.empty()) {
+        tableInfoCache.put(cacheKey, entry);
+    }
+    return entry.info;
 }
 
-TableInfo const*
-TableInfoPool::_insert(std::unique_ptr<TableInfo const> t) {
+std::shared_ptr<TableInfo const>
+TableInfoPool::_insert(std::shared_ptr<TableInfo const> t) {
     if (t != nullptr) {
         Pool::iterator iter =
-            std::upper_bound(_pool.begin(), _pool.end(), t, TableInfoLt());
-        iter = _pool.insert(iter, std::move(t));
-        return iter->get();
+            std::equal_range(_pool.begin(), _pool.end(), t, TableInfoLt()).second;
+        if (iter == _pool.begin() || !(**(iter - 1) == *t)) {
+            iter = _pool.insert(iter, t);
+        }
+        return *iter;
     }
-    return nullptr;
+    return t;
 }
 
 }}} // namespace lsst::qserv::qana
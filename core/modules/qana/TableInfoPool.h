@@ -47,7 +47,7 @@ namespace lsst {
 namespace qserv {
 namespace qana {
 
-/// `TableInfoPool` is a factory and pool of owned, immutable `TableInfo`
+/// `TableInfoPool` is a factory and pool of shared, immutable `TableInfo`
 /// objects.
 ///
 /// Clients that obtain all `TableInfo` pointers from the same pool
@@ -55,7 +55,15 @@ namespace qana {
 /// is no facility for removing pool entries, so the lifetime of all retrieved
 /// pointers is that of the pool itself.
 ///
-/// `TableInfoPool` is not currently thread-safe.
+/// The metadata is an immutable fact about the catalog, so built objects
+/// are shared through a czar-wide cache keyed by (db, table, CSS
+/// generation): repeated join-query analysis reuses the same objects
+/// instead of re-fetching CSS and re-allocating per query. When the CSS
+/// backend exposes no generation counter (memory-based test storage) the
+/// cache is bypassed and objects stay private to the pool.
+///
+/// `TableInfoPool` is not currently thread-safe, but distinct pools may be
+/// used concurrently.
 class TableInfoPool {
 public:
     TableInfoPool(std::string const& defaultDb, css::CssAccess const& css)
@@ -66,7 +74,8 @@ public:
     TableInfoPool& operator=(TableInfoPool const&) = delete;
 
     /// `get` returns a pointer to metadata for the given table, creating
-    /// a metadata object if necessary. The pool retains pointer ownership.
+    /// a metadata object if necessary. The pool keeps the object (and any
+    /// objects it references) alive for its own lifetime.
     /// Null pointers are returned for unpartitioned tables, as they have no
     /// metadata and representing them is not worthwhile. Newly created
     /// metadata objects are sanity checked, and an `InvalidTableError` is
@@ -84,10 +93,15 @@ public:
 private:
     // A set implemented as a sorted vector since the number of entries
     // is expected to be small.
-    typedef std::vector<std::unique_ptr<TableInfo const>> Pool;
+    typedef std::vector<std::shared_ptr<TableInfo const>> Pool;
+
+    // get() against the local pool and the czar-wide cache, building and
+    // publishing the object on a miss.
+    std::shared_ptr<TableInfo const> _get(std::string const& db,
+                                          std::string const& table);
 
-    // save owned TableInfo pointer in pool, return non-owned pointer.
-    TableInfo const* _insert(std::unique_ptr<TableInfo const> t);
+    // save shared TableInfo pointer in pool and return it.
+    std::shared_ptr<TableInfo const> _insert(std::shared_ptr<TableInfo const> t);
 
     std::string const _defaultDb;
     css::CssAccess const& _css;
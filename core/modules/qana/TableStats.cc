@@ -0,0 +1,78 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "qana/TableStats.h"
+
+// Qserv headers
+#include "proto/ScanTableInfo.h"
+
+namespace {
+
+// Per-chunk byte thresholds for the rating buckets. A chunk table below
+// MB1 costs no more than an interactive query; one above GB4 dominates a
+// shared-scan pass.
+uint64_t const MB1   =          1024ULL * 1024ULL;
+uint64_t const MB64  =   64ULL * 1024ULL * 1024ULL;
+uint64_t const MB512 =  512ULL * 1024ULL * 1024ULL;
+uint64_t const GB4   = 4096ULL * 1024ULL * 1024ULL;
+
+std::string makeKey(std::string const& db, std::string const& table) {
+    return db + "." + table;
+}
+
+} // anonymous namespace
+
+namespace lsst {
+namespace qserv {
+namespace qana {
+
+TableStats::Ptr TableStats::get() {
+    static Ptr instance(new TableStats());
+    return instance;
+}
+
+void TableStats::set(std::string const& db, std::string const& table,
+                     Stats const& stats) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    _stats[makeKey(db, table)] = stats;
+}
+
+bool TableStats::lookup(std::string const& db, std::string const& table,
+                        Stats& stats) const {
+    std::lock_guard<std::mutex> lock(_mtx);
+    auto const itr = _stats.find(makeKey(db, table));
+    if (itr == _stats.end()) return false;
+    stats = itr->second;
+    return true;
+}
+
+int TableStats::ratingForBytesPerChunk(uint64_t bytes) {
+    if (bytes < MB1)   return proto::ScanInfo::FASTEST;
+    if (bytes < MB64)  return proto::ScanInfo::FAST;
+    if (bytes < MB512) return proto::ScanInfo::MEDIUM;
+    if (bytes < GB4)   return proto::ScanInfo::SLOW;
+    return proto::ScanInfo::SLOWEST;
+}
+
+}}} // namespace lsst::qserv::qana
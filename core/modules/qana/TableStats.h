@@ -0,0 +1,83 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_QANA_TABLESTATS_H
+#define LSST_QSERV_QANA_TABLESTATS_H
+
+// System headers
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace lsst {
+namespace qserv {
+namespace qana {
+
+/// TableStats is a czar-side registry of measured per-table statistics:
+/// total row counts, data bytes, and the number of chunks they are spread
+/// over. It is meant to be refreshed out-of-band from worker reports
+/// (ChunkInventory registrations and QueriesAndChunks scan timings) so
+/// that ScanTablePlugin can rate a scan by the bytes it will actually
+/// touch instead of trusting the static CSS per-table hints. Tables with
+/// no entry fall back to the CSS rating. The registry is thread-safe.
+class TableStats {
+public:
+    typedef std::shared_ptr<TableStats> Ptr;
+
+    /// Measured statistics for one (db, table).
+    struct Stats {
+        uint64_t rowCount{0};   ///< total rows across all chunks
+        uint64_t dataBytes{0};  ///< total data bytes across all chunks
+        int chunkCount{0};      ///< number of chunks holding the table
+
+        /// @return the average data bytes per chunk, 0 if unknown
+        uint64_t bytesPerChunk() const {
+            return chunkCount > 0 ? dataBytes / chunkCount : 0;
+        }
+    };
+
+    /// @return the process-wide registry instance
+    static Ptr get();
+
+    /// Record (or refresh) the statistics for a table.
+    void set(std::string const& db, std::string const& table, Stats const& stats);
+
+    /// Look up the statistics for a table.
+    /// @return true and fill 'stats' if an entry exists, false otherwise
+    bool lookup(std::string const& db, std::string const& table, Stats& stats) const;
+
+    /// Map an estimate of bytes touched per chunk to a scan rating on the
+    /// proto::ScanInfo::Rating scale.
+    static int ratingForBytesPerChunk(uint64_t bytes);
+
+private:
+    TableStats() = default;
+
+    mutable std::mutex _mtx; ///< protects _stats
+    std::map<std::string, Stats> _stats; ///< keyed by "db.table"
+};
+
+}}} // namespace lsst::qserv::qana
+
+#endif // LSST_QSERV_QANA_TABLESTATS_H
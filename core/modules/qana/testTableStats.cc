@@ -0,0 +1,77 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+ /**
+  *
+  * @brief Test for the TableStats registry
+  *
+  */
+
+// Qserv headers
+#include "proto/ScanTableInfo.h"
+#include "qana/TableStats.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE TableStats
+#include "boost/test/included/unit_test.hpp"
+
+using lsst::qserv::proto::ScanInfo;
+using lsst::qserv::qana::TableStats;
+
+BOOST_AUTO_TEST_SUITE(Suite)
+
+BOOST_AUTO_TEST_CASE(SetAndLookup) {
+    TableStats::Ptr stats = TableStats::get();
+    // get() always hands back the same registry.
+    BOOST_CHECK_EQUAL(stats.get(), TableStats::get().get());
+
+    TableStats::Stats found;
+    BOOST_CHECK(!stats->lookup("LSST", "NoSuchTable", found));
+
+    TableStats::Stats object;
+    object.rowCount = 1000000;
+    object.dataBytes = 400ULL * 1024 * 1024;
+    object.chunkCount = 100;
+    stats->set("LSST", "Object", object);
+
+    BOOST_CHECK(stats->lookup("LSST", "Object", found));
+    BOOST_CHECK_EQUAL(found.rowCount, object.rowCount);
+    BOOST_CHECK_EQUAL(found.bytesPerChunk(), 4ULL * 1024 * 1024);
+
+    // A refresh overwrites the previous entry.
+    object.chunkCount = 200;
+    stats->set("LSST", "Object", object);
+    BOOST_CHECK(stats->lookup("LSST", "Object", found));
+    BOOST_CHECK_EQUAL(found.bytesPerChunk(), 2ULL * 1024 * 1024);
+}
+
+BOOST_AUTO_TEST_CASE(RatingBuckets) {
+    uint64_t const MB = 1024ULL * 1024;
+    BOOST_CHECK_EQUAL(TableStats::ratingForBytesPerChunk(0), ScanInfo::FASTEST);
+    BOOST_CHECK_EQUAL(TableStats::ratingForBytesPerChunk(MB - 1), ScanInfo::FASTEST);
+    BOOST_CHECK_EQUAL(TableStats::ratingForBytesPerChunk(MB), ScanInfo::FAST);
+    BOOST_CHECK_EQUAL(TableStats::ratingForBytesPerChunk(64 * MB), ScanInfo::MEDIUM);
+    BOOST_CHECK_EQUAL(TableStats::ratingForBytesPerChunk(512 * MB), ScanInfo::SLOW);
+    BOOST_CHECK_EQUAL(TableStats::ratingForBytesPerChunk(4096 * MB), ScanInfo::SLOWEST);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,92 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "qdisp/ChunkLocationCache.h"
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.qdisp.ChunkLocationCache");
+
+} // anonymous namespace
+
+namespace lsst {
+namespace qserv {
+namespace qdisp {
+
+ChunkLocationCache& ChunkLocationCache::get() {
+    static ChunkLocationCache instance;
+    return instance;
+}
+
+std::string ChunkLocationCache::lookup(std::string const& resourcePath) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    auto iter = _entries.find(resourcePath);
+    if (iter == _entries.end()) return std::string();
+    if (iter->second.expires <= std::time(nullptr)) {
+        _entries.erase(iter);
+        return std::string();
+    }
+    return iter->second.endPoint;
+}
+
+void ChunkLocationCache::noteLocation(std::string const& resourcePath,
+                                      std::string const& endPoint) {
+    if (endPoint.empty()) return;
+    std::lock_guard<std::mutex> lock(_mtx);
+    Entry& entry = _entries[resourcePath];
+    entry.endPoint = endPoint;
+    entry.expires  = std::time(nullptr) + _ttlSecs;
+}
+
+void ChunkLocationCache::invalidateDb(std::string const& database) {
+    std::string const prefix = "/chk/" + database + "/";
+    std::lock_guard<std::mutex> lock(_mtx);
+    // The entries of the database form one contiguous range of the ordered map
+    auto iter = _entries.lower_bound(prefix);
+    size_t count = 0;
+    while (iter != _entries.end()
+           and iter->first.compare(0, prefix.size(), prefix) == 0) {
+        iter = _entries.erase(iter);
+        ++count;
+    }
+    LOGS(_log, LOG_LVL_INFO, "ChunkLocationCache invalidated db=" << database
+         << " entries=" << count);
+}
+
+void ChunkLocationCache::invalidateAll() {
+    std::lock_guard<std::mutex> lock(_mtx);
+    LOGS(_log, LOG_LVL_INFO, "ChunkLocationCache invalidated, entries="
+         << _entries.size());
+    _entries.clear();
+}
+
+void ChunkLocationCache::setTtlSecs(int ttlSecs) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    _ttlSecs = ttlSecs;
+}
+
+}}} // namespace lsst::qserv::qdisp
@@ -0,0 +1,96 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_QDISP_CHUNKLOCATIONCACHE_H
+#define LSST_QSERV_QDISP_CHUNKLOCATIONCACHE_H
+
+// System headers
+#include <ctime>
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace lsst {
+namespace qserv {
+namespace qdisp {
+
+/// A czar-wide cache of chunk resource paths (e.g. "/chk/LSST/12345") to the
+/// worker endpoints serving them. Chunk placement only changes at replication
+/// events, yet every dispatch of a chunk resource otherwise pays a location
+/// lookup through XRootD. Executive::startQuery() consults this cache before
+/// SSI provisioning: a fresh entry means the SSI client already holds a
+/// channel bound to the right worker, so the resource is dispatched with
+/// reusable affinity and no redirector lookup; an expired or invalidated
+/// entry makes that dispatch negotiate a fresh location. QueryRequest primes
+/// the cache with the endpoint of whichever worker answers, and the
+/// replication system's "FLUSH QSERV_CHUNKS_CACHE" statements invalidate it
+/// when chunks move.
+///
+/// All methods are thread safe.
+class ChunkLocationCache {
+public:
+
+    /// @return the czar-wide instance
+    static ChunkLocationCache& get();
+
+    ChunkLocationCache(ChunkLocationCache const&) = delete;
+    ChunkLocationCache& operator=(ChunkLocationCache const&) = delete;
+
+    /// @return the endpoint last seen serving the resource, or the empty
+    /// string if the location is unknown, expired or was invalidated.
+    /// An expired entry is dropped by the lookup.
+    std::string lookup(std::string const& resourcePath);
+
+    /// Record (or refresh) the endpoint serving a resource. Called with the
+    /// endpoint of the worker which answered a request on the resource.
+    void noteLocation(std::string const& resourcePath, std::string const& endPoint);
+
+    /// Forget the locations of all chunks of a database. Called when
+    /// the replication system flushes the chunk cache of the database.
+    void invalidateDb(std::string const& database);
+
+    /// Forget all locations. Called when the replication system flushes
+    /// the chunk cache with no database scope.
+    void invalidateAll();
+
+    /// Change the time entries stay valid, [default: 300]. A value of 0
+    /// makes every entry expire immediately (effectively disables the cache).
+    void setTtlSecs(int ttlSecs);
+
+private:
+
+    ChunkLocationCache() = default;
+
+    /// One cached location
+    struct Entry {
+        std::string endPoint;
+        std::time_t expires = 0;
+    };
+
+    std::mutex _mtx;                        ///< Guards all members below
+    std::map<std::string, Entry> _entries;  ///< Resource path to location
+    int _ttlSecs = 300;
+};
+
+}}} // namespace lsst::qserv::qdisp
+
+#endif // LSST_QSERV_QDISP_CHUNKLOCATIONCACHE_H
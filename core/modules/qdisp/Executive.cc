@@ -44,6 +44,7 @@
 #include <deque>
 #include <functional>
 #include <iostream>
+#include <set>
 #include <sstream>
 
 // Third-party headers
@@ -60,12 +61,16 @@
 #include "ccontrol/msgCode.h"
 #include "global/Bug.h"
 #include "global/ResourceUnit.h"
+#include "qdisp/ChunkLocationCache.h"
 #include "qdisp/JobQuery.h"
+#include "qdisp/KillQueryRequest.h"
 #include "qdisp/MessageStore.h"
 #include "qdisp/QueryRequest.h"
 #include "qdisp/ResponseHandler.h"
+#include "qdisp/WorkerHealthRegistry.h"
 #include "qdisp/XrdSsiMocks.h"
 #include "util/EventThread.h"
+#include "util/FlightRecorder.h"
 
 extern XrdSsiProvider *XrdSsiProviderClient;
 
@@ -81,6 +86,23 @@ std::string getErrorText(XrdSsiErrInfo & e) {
     return os.str();
 }
 
+// Hedged dispatch tuning. A job is a straggler once it has run longer than
+// hedgeLatencyFactor times the hedgeLatencyPercentile-th percentile of the
+// completion latencies seen so far, but never sooner than hedgeMinThresholdMs.
+// Hedging only starts once at least hedgeMinSamples jobs have completed and
+// the query is in its tail (most jobs done), so replicas are not asked to
+// duplicate work the cluster is still busy with anyway.
+int const hedgeLatencyPercentile = 95;
+int const hedgeLatencyFactor = 3;
+int const hedgeMinThresholdMs = 2000;
+size_t const hedgeMinSamples = 50;
+
+// Jobs whose chunk is last known to live on a degraded worker (see
+// WorkerHealthRegistry) are hedged at this fraction of the straggler
+// threshold, so a sick worker's jobs get their duplicate dispatched
+// before they dominate the query's tail.
+int const degradedHedgeDivisor = 2;
+
 } // anonymous namespace
 
 namespace lsst {
@@ -181,6 +203,65 @@ JobQuery::Ptr Executive::add(JobDescription::Ptr const& jobDesc) {
 }
 
 
+/// Add a batch of new jobs to the executive. Not thread-safe.
+/// The JobQuery objects are built up front, then registered under a single
+/// acquisition of the cancellation lock, then started.
+///
+std::vector<JobQuery::Ptr> Executive::addJobs(std::vector<JobDescription::Ptr> const& jobDescs) {
+    std::vector<JobQuery::Ptr> jobQueries;
+    jobQueries.reserve(jobDescs.size());
+    Ptr thisPtr = shared_from_this();
+    for (auto const& jobDesc : jobDescs) {
+        JobStatus::Ptr jobStatus = std::make_shared<JobStatus>();
+        MarkCompleteFunc::Ptr mcf = std::make_shared<MarkCompleteFunc>(thisPtr, jobDesc->id());
+        jobQueries.push_back(JobQuery::create(thisPtr, jobDesc, jobStatus, mcf, _id));
+    }
+    {
+        std::lock_guard<std::recursive_mutex> lock(_cancelled.getMutex());
+        if (_cancelled) {
+            LOGS(_log, LOG_LVL_DEBUG, "Executive already cancelled, ignoring addJobs of "
+                    << jobDescs.size() << " jobs");
+            return std::vector<JobQuery::Ptr>();
+        }
+        for (auto const& jobQuery : jobQueries) {
+            if (!_addJobToMap(jobQuery)) {
+                LOGS(_log, LOG_LVL_ERROR, "Executive ignoring duplicate job add " << jobQuery->getIdStr());
+                continue;
+            }
+            if (!_track(jobQuery->getIdInt(), jobQuery)) {
+                LOGS(_log, LOG_LVL_ERROR, "Executive ignoring duplicate track add " << jobQuery->getIdStr());
+            }
+        }
+    }
+    if (_empty.exchange(false)) {
+        LOGS(_log, LOG_LVL_DEBUG, "Flag _empty set to false by addJobs");
+    }
+    _requestCount += jobQueries.size();
+    LOGS(_log, LOG_LVL_DEBUG, "Executive::addJobs registered " << jobQueries.size() << " jobs");
+
+    // Dispatch shaping: start the jobs whose chunks are last known to live
+    // on the healthiest workers first, so a degraded worker receives its
+    // share of the query last and its slowness overlaps the healthy
+    // workers' processing instead of heading the queue. The sort is stable,
+    // preserving chunk order among jobs of equal (typically nominal) score;
+    // chunks with no cached location score nominal.
+    std::vector<std::pair<double, JobQuery::Ptr>> startOrder;
+    startOrder.reserve(jobQueries.size());
+    for (auto const& jobQuery : jobQueries) {
+        std::string const worker = ChunkLocationCache::get().lookup(
+                jobQuery->getDescription()->resource().path());
+        startOrder.emplace_back(WorkerHealthRegistry::get().score(worker), jobQuery);
+    }
+    std::stable_sort(startOrder.begin(), startOrder.end(),
+            [](std::pair<double, JobQuery::Ptr> const& a,
+               std::pair<double, JobQuery::Ptr> const& b) { return a.first < b.first; });
+    for (auto const& entry : startOrder) {
+        entry.second->runJob();
+    }
+    return jobQueries;
+}
+
+
 void Executive::queueJobStart(PriorityCommand::Ptr const& cmd, bool scanInteractive) {
     _jobStartCmdList.push_back(cmd);
     if (scanInteractive) {
@@ -218,9 +299,20 @@ bool Executive::startQuery(std::shared_ptr<JobQuery> const& jobQuery) {
     if (_cancelled) return false;
 
     // Construct a temporary resource object to pass to ProcessRequest().
-    // For now, we don't set any other attributes except the resource name.
+    // The czar-wide location cache is consulted first: a fresh entry means
+    // a worker recently answered on this resource, so the SSI client already
+    // holds a channel bound to it and the resource is marked Reusable with
+    // strong affinity - dispatch is then a frame on the existing channel
+    // with no location lookup. On a miss (first touch of the chunk, TTL
+    // expiry, or an invalidation after the replication system moved chunks)
+    // the resource is dispatched without the reuse option, forcing a fresh
+    // location negotiation; the worker's response re-primes the cache.
     //
-    XrdSsiResource jobResource(jobQuery->getDescription()->resource().path());
+    std::string const resourcePath = jobQuery->getDescription()->resource().path();
+    bool const locationKnown = not ChunkLocationCache::get().lookup(resourcePath).empty();
+    XrdSsiResource jobResource(resourcePath, "", "", "",
+                               locationKnown ? XrdSsiResource::Reusable : 0,
+                               XrdSsiResource::Strong);
 
     // Now construct the actual query request and tie it to the jobQuery. The
     // shared pointer is used by QueryRequest to keep itself alive, sloppy design.
@@ -236,6 +328,31 @@ bool Executive::startQuery(std::shared_ptr<JobQuery> const& jobQuery) {
 }
 
 
+// Dispatch a duplicate request for a straggler job. The resource is steered
+// away from the worker serving the primary request, so the SSI client asks
+// XRootD for another replica of the chunk. The hedge is deliberately not
+// marked Reusable: the bound channel for this resource name leads to the
+// very worker being avoided.
+//
+bool Executive::startHedge(std::shared_ptr<JobQuery> const& jobQuery, std::string const& avoidWorker) {
+
+    std::lock_guard<std::recursive_mutex> lock(_cancelled.getMutex());
+
+    if (_cancelled) return false;
+
+    XrdSsiResource jobResource(jobQuery->getDescription()->resource().path(),
+                               "", "", avoidWorker);
+
+    QueryRequest::Ptr qr = QueryRequest::create(jobQuery, true);
+    jobQuery->setHedgeRequest(qr);
+
+    LOGS(_log, LOG_LVL_INFO, jobQuery->getIdStr() << " dispatching hedge, avoiding worker="
+         << avoidWorker);
+    getXrdSsiService()->ProcessRequest(*(qr.get()), jobResource);
+    return true;
+}
+
+
 /// Add a JobQuery to this Executive.
 /// Return true if it was successfully added to the map.
 ///
@@ -266,12 +383,16 @@ bool Executive::join() {
     if (sCount == _requestCount) {
         LOGS(_log, LOG_LVL_DEBUG, "Query execution succeeded: " << _requestCount
              << " jobs dispatched and completed.");
+    } else if (_limitSquash) {
+        LOGS(_log, LOG_LVL_DEBUG, "Query execution succeeded by LIMIT: " << _requestCount
+             << " jobs dispatched, " << sCount << " jobs completed before the remainder"
+             << " were squashed");
     } else {
         LOGS(_log, LOG_LVL_ERROR, "Query execution failed: " << _requestCount
              << " jobs dispatched, but only " << sCount << " jobs completed");
     }
     _updateProxyMessages();
-    bool empty = (sCount == _requestCount);
+    bool empty = (sCount == _requestCount) || _limitSquash;
     _empty.store(empty);
     LOGS(_log, LOG_LVL_DEBUG, "Flag set to _empty=" << empty << ", sCount=" << sCount
          << ", requestCount=" << _requestCount);
@@ -283,16 +404,23 @@ void Executive::markCompleted(int jobId, bool success) {
     std::string idStr = QueryIdHelper::makeIdStr(_id, jobId);
     LOGS(_log, LOG_LVL_DEBUG, "Executive::markCompleted " << idStr
             << " " << success);
+    if (!success && _limitSquash) {
+        // Jobs failing now were squashed because the LIMIT was already
+        // satisfied; their cancellation is not an error worth recording.
+        _unTrack(jobId);
+        return;
+    }
     if (!success) {
         {
-            std::lock_guard<std::mutex> lock(_incompleteJobsMutex);
-            auto iter = _incompleteJobs.find(jobId);
-            if (iter != _incompleteJobs.end()) {
+            JobShard& shard = _shardFor(jobId);
+            std::lock_guard<std::mutex> lock(shard.mtx);
+            auto iter = shard.jobs.find(jobId);
+            if (iter != shard.jobs.end()) {
                 auto jobQuery =  iter->second;
                 err = jobQuery->getDescription()->respHandler()->getError();
             } else {
                 std::string msg = "Executive::markCompleted failed to find TRACKED " + idStr +
-                        " size=" + std::to_string(_incompleteJobs.size());
+                        " size=" + std::to_string(_incompleteCount.load());
                 // If the user query has been cancelled, this is expected for jobs that have not yet
                 // been tracked. Otherwise, this indicates a serious problem.
                 if (!getCancelled()) {
@@ -319,6 +447,29 @@ void Executive::markCompleted(int jobId, bool success) {
                  << " registered errors: " << _multiError);
         }
     }
+    if (success) {
+        // Record how long the job took, to spot stragglers later.
+        JobShard& shard = _shardFor(jobId);
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        auto iter = shard.jobs.find(jobId);
+        if (iter != shard.jobs.end()) {
+            auto const elapsed = std::chrono::steady_clock::now() - iter->second->getDispatchTime();
+            _recordJobLatency(static_cast<int>(
+                    std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count()));
+        }
+    }
+    if (success and _chunkNotifier) {
+        // Report the completed chunk for shared-scan cohort tracking.
+        int chunk = -1;
+        {
+            std::lock_guard<std::recursive_mutex> lockJobMap(_jobMapMtx);
+            auto iter = _jobMap.find(jobId);
+            if (iter != _jobMap.end()) {
+                chunk = iter->second->getDescription()->resource().chunk();
+            }
+        }
+        if (chunk >= 0) _chunkNotifier(chunk);
+    }
     _unTrack(jobId);
     if (!success) {
         LOGS(_log, LOG_LVL_ERROR, "Executive: requesting squash, cause: "
@@ -335,6 +486,14 @@ void Executive::squash() {
         return;
     }
 
+    util::FlightRecorder::record(_id, _limitSquash
+            ? util::FlightRecorder::LIMIT_SQUASH : util::FlightRecorder::SQUASH);
+
+    // Tell every involved worker to drop all of this query's tasks first, so
+    // worker capacity comes back quickly, then cancel the individual jobs to
+    // tear down the czar side of each request.
+    _broadcastKillQuery();
+
     LOGS(_log, LOG_LVL_DEBUG, getIdStr() << " Executive::squash Trying to cancel all queries...");
     std::deque<JobQuery::Ptr> jobsToCancel;
     {
@@ -350,9 +509,52 @@ void Executive::squash() {
     LOGS_DEBUG(getIdStr() << " Executive::squash done");
 }
 
+
+void Executive::_broadcastKillQuery() {
+    // Collect the distinct workers the incomplete jobs are talking to. Jobs
+    // that have not been bound to an endpoint yet report an empty string and
+    // are covered by the per-job cancellation that follows.
+    std::set<std::string> workers;
+    for (unsigned int sh = 0; sh < SHARD_COUNT; ++sh) {
+        JobShard& shard = _incompleteShards[sh];
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        for (auto const& entry : shard.jobs) {
+            auto queryRequest = entry.second->getQueryRequest();
+            if (queryRequest == nullptr) continue;
+            std::string endPoint = queryRequest->GetEndPoint();
+            auto const colon = endPoint.find(':');
+            if (colon != std::string::npos) endPoint.resize(colon);
+            if (not endPoint.empty()) workers.insert(endPoint);
+        }
+    }
+
+    for (auto const& worker : workers) {
+        LOGS(_log, LOG_LVL_INFO, getIdStr() << " sending KILL_QUERY to worker=" << worker);
+        XrdSsiResource workerResource(ResourceUnit::makeWorkerPath(worker));
+        auto killRequest = KillQueryRequest::create(_id, worker);
+        getXrdSsiService()->ProcessRequest(*(killRequest.get()), workerResource);
+    }
+}
+
+
+void Executive::squashEnoughRows() {
+    LOGS(_log, LOG_LVL_DEBUG, getIdStr()
+         << " Executive::squashEnoughRows() LIMIT satisfied, cancelling remaining jobs");
+    _limitSquash = true;
+    squash();
+}
+
+
 int Executive::getNumInflight() {
-    std::unique_lock<std::mutex> lock(_incompleteJobsMutex);
-    return _incompleteJobs.size();
+    return _incompleteCount.load();
+}
+
+Executive::Progress Executive::getProgress() const {
+    Progress progress;
+    progress.totalJobs = _requestCount.load();
+    progress.inFlightJobs = _incompleteCount.load();
+    progress.completedJobs = progress.totalJobs - progress.inFlightJobs;
+    return progress;
 }
 
 std::string Executive::getProgressDesc() const {
@@ -404,15 +606,16 @@ bool Executive::_track(int jobId, std::shared_ptr<JobQuery> const& r) {
     std::string idStr = QueryIdHelper::makeIdStr(_id, jobId);
     int size = -1;
     {
-        std::lock_guard<std::mutex> lock(_incompleteJobsMutex);
-        if (_incompleteJobs.find(jobId) != _incompleteJobs.end()) {
+        JobShard& shard = _shardFor(jobId);
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        if (shard.jobs.find(jobId) != shard.jobs.end()) {
             LOGS(_log, LOG_LVL_WARN, "Attempt for TRACKING " << idStr
                  << " failed as jobId already found in incomplete jobs. "
                  << _getIncompleteJobsString(-1));
             return false;
         }
-        _incompleteJobs[jobId] = r;
-        size = _incompleteJobs.size();
+        shard.jobs[jobId] = r;
+        size = ++_incompleteCount;
     }
     LOGS(_log, LOG_LVL_DEBUG, "Success TRACKING " << idStr << " size=" << size);
     return true;
@@ -422,34 +625,46 @@ void Executive::_unTrack(int jobId) {
     bool untracked = false;
     std::string s;
     {
-        std::lock_guard<std::mutex> lock(_incompleteJobsMutex);
-        auto i = _incompleteJobs.find(jobId);
-        if (i != _incompleteJobs.end()) {
-            _incompleteJobs.erase(i);
+        JobShard& shard = _shardFor(jobId);
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        auto i = shard.jobs.find(jobId);
+        if (i != shard.jobs.end()) {
+            shard.jobs.erase(i);
             untracked = true;
-            if (_incompleteJobs.empty()) _allJobsComplete.notify_all();
         }
-        if (!untracked || LOG_CHECK_LVL(_log, LOG_LVL_DEBUG)) {
-            // Log up to 5 incomplete jobs. Very useful when jobs do not finish.
-            s = _getIncompleteJobsString(5);
+    }
+    if (untracked) {
+        if (--_incompleteCount == 0) {
+            std::lock_guard<std::mutex> lock(_allJobsCompleteMtx);
+            _allJobsComplete.notify_all();
         }
     }
+    if (!untracked || LOG_CHECK_LVL(_log, LOG_LVL_DEBUG)) {
+        // Log up to 5 incomplete jobs. Very useful when jobs do not finish.
+        s = _getIncompleteJobsString(5);
+    }
     LOGS(_log, (untracked ? LOG_LVL_DEBUG : LOG_LVL_WARN),
          "Executive UNTRACKING " << QueryIdHelper::makeIdStr(_id, jobId)
              << " " << (untracked ? "success":"failed") << "::" << s);
 }
 
 
-/// _incompleteJobsMutex must be held before calling this function.
+/// Collects ids across all shards, taking each shard lock in turn. Callers
+/// may hold at most one shard lock; that shard is skipped to avoid deadlock.
 /// @return: a string containing a list of incomplete jobs containing up to 'maxToList' jobs.
 ///          If maxToList is less than 0, all jobs are printed
 std::string Executive::_getIncompleteJobsString(int maxToList) {
     std::ostringstream os;
     int c = 0;
-    if (maxToList < 0) maxToList = _incompleteJobs.size();
-    os << "_incompleteJobs listing first" << maxToList << " of size=" << _incompleteJobs.size() << " ";
-    for(auto j = _incompleteJobs.begin(), e = _incompleteJobs.end(); j != e && c < maxToList; ++j, ++c) {
-        os << j->first << " ";
+    if (maxToList < 0) maxToList = _incompleteCount.load();
+    os << "_incompleteJobs listing first" << maxToList << " of size=" << _incompleteCount.load() << " ";
+    for (unsigned int sh = 0; sh < SHARD_COUNT && c < maxToList; ++sh) {
+        JobShard& shard = _incompleteShards[sh];
+        std::unique_lock<std::mutex> lock(shard.mtx, std::try_to_lock);
+        if (!lock.owns_lock()) continue; // caller holds this shard's lock.
+        for (auto j = shard.jobs.begin(), e = shard.jobs.end(); j != e && c < maxToList; ++j, ++c) {
+            os << j->first << " ";
+        }
     }
     return os.str();
 }
@@ -487,18 +702,113 @@ void Executive::_updateProxyMessages() {
     }
 }
 
+void Executive::recordTaskTiming(uint64_t dispatchEpochMs, uint64_t queuedTimeMs,
+                                 uint64_t startTimeMs, uint64_t sendTimeMs,
+                                 uint64_t mysqldMs, uint64_t serializeMs) {
+    auto const nowMs = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+    // Differences spanning the two hosts can come out negative under clock
+    // skew; a clamped zero keeps the totals sane.
+    auto diff = [](uint64_t end, uint64_t begin) -> uint64_t {
+        return end > begin ? end - begin : 0;
+    };
+    std::lock_guard<std::mutex> lock(_phaseMtx);
+    ++_phaseStats.jobs;
+    _phaseStats.dispatchWaitMs += diff(queuedTimeMs, dispatchEpochMs);
+    _phaseStats.workerQueueMs += diff(startTimeMs, queuedTimeMs);
+    _phaseStats.mysqldMs += mysqldMs;
+    _phaseStats.serializeMs += serializeMs;
+    _phaseStats.transferMs += diff(nowMs, sendTimeMs);
+}
+
+
+Executive::PhaseStats Executive::getPhaseStats() const {
+    std::lock_guard<std::mutex> lock(_phaseMtx);
+    return _phaseStats;
+}
+
+
+void Executive::_recordJobLatency(int latencyMs) {
+    std::lock_guard<std::mutex> lock(_latencyMtx);
+    if (_latencySamples.size() < LATENCY_SAMPLE_MAX) {
+        _latencySamples.push_back(latencyMs);
+    } else {
+        _latencySamples[_latencyNext % LATENCY_SAMPLE_MAX] = latencyMs;
+    }
+    ++_latencyNext;
+}
+
+
+int Executive::_stragglerThresholdMs() {
+    std::vector<int> samples;
+    {
+        std::lock_guard<std::mutex> lock(_latencyMtx);
+        if (_latencySamples.size() < hedgeMinSamples) return -1;
+        samples = _latencySamples;
+    }
+    auto nth = samples.begin() + (samples.size() * hedgeLatencyPercentile) / 100;
+    if (nth == samples.end()) --nth;
+    std::nth_element(samples.begin(), nth, samples.end());
+    return std::max(*nth * hedgeLatencyFactor, hedgeMinThresholdMs);
+}
+
+
+/// Dispatch hedge requests for jobs running far beyond the completion
+/// latencies this query has seen. Collects candidates shard by shard, then
+/// hedges outside the shard locks; JobQuery::hedge() itself rejects jobs
+/// that are already responding, hedged, or cancelled.
+void Executive::_hedgeStragglers() {
+    if (getCancelled()) return;
+    int const thresholdMs = _stragglerThresholdMs();
+    if (thresholdMs < 0) return;
+    // Only hedge in the tail of the query: while most jobs are still in
+    // flight the replicas are busy with this query's other chunks, and a
+    // duplicate would just add load.
+    int const incomplete = _incompleteCount.load();
+    if (incomplete <= 0 || incomplete * 4 > _requestCount.load()) return;
+
+    auto const now = std::chrono::steady_clock::now();
+    std::vector<JobQuery::Ptr> stragglers;
+    for (unsigned int sh = 0; sh < SHARD_COUNT; ++sh) {
+        JobShard& shard = _incompleteShards[sh];
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        for (auto const& entry : shard.jobs) {
+            auto const elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                    now - entry.second->getDispatchTime()).count();
+            // Jobs on a degraded worker are hedged earlier; its slowness is
+            // already explained and waiting the full threshold just lets it
+            // stretch the tail further.
+            int jobThresholdMs = thresholdMs;
+            std::string const worker = ChunkLocationCache::get().lookup(
+                    entry.second->getDescription()->resource().path());
+            if (not worker.empty() and WorkerHealthRegistry::get().isDegraded(worker)) {
+                jobThresholdMs = thresholdMs / degradedHedgeDivisor;
+            }
+            if (elapsed > jobThresholdMs) {
+                stragglers.push_back(entry.second);
+            }
+        }
+    }
+    for (auto const& job : stragglers) {
+        if (job->hedge()) {
+            LOGS(_log, LOG_LVL_INFO, job->getIdStr() << " hedged straggler, threshold="
+                 << thresholdMs << "ms");
+        }
+    }
+}
+
+
 /// This function blocks until it has reaped all the requesters.
 /// Typically the requesters are handled by markCompleted().
 /// _reapRequesters() deals with cases that involve errors.
 void Executive::_waitAllUntilEmpty() {
-    std::unique_lock<std::mutex> lock(_incompleteJobsMutex);
+    std::unique_lock<std::mutex> lock(_allJobsCompleteMtx);
     int lastCount = -1;
     int count;
     int moreDetailThreshold = 5;
     int complainCount = 0;
     const std::chrono::seconds statePrintDelay(5);
-    while(!_incompleteJobs.empty()) {
-        count = _incompleteJobs.size();
+    while((count = _incompleteCount.load()) != 0) {
         if (count != lastCount) {
             lastCount = count;
             ++complainCount;
@@ -516,6 +826,19 @@ void Executive::_waitAllUntilEmpty() {
             }
         }
         _allJobsComplete.wait_for(lock, statePrintDelay);
+        // Hedge any stragglers each time through. The lock is released so
+        // that the jobs hedged here can complete (and _unTrack) meanwhile.
+        lock.unlock();
+        if (_progressReporter != nullptr) {
+            _progressReporter(getProgress());
+        }
+        _hedgeStragglers();
+        lock.lock();
+    }
+    if (_progressReporter != nullptr) {
+        // Final snapshot so observers see the query reach completion.
+        lock.unlock();
+        _progressReporter(getProgress());
     }
 }
 
@@ -525,11 +848,15 @@ std::ostream& operator<<(std::ostream& os, Executive::JobMap::value_type const&
     return os;
 }
 
-/// precondition: _requestersMutex is held by current thread.
+/// Takes each shard lock in turn while printing that shard's jobs.
 void Executive::_printState(std::ostream& os) {
-    for (auto const& entry : _incompleteJobs) {
-        JobQuery::Ptr job = entry.second;
-        os << *job << "\n";
+    for (unsigned int sh = 0; sh < SHARD_COUNT; ++sh) {
+        JobShard& shard = _incompleteShards[sh];
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        for (auto const& entry : shard.jobs) {
+            JobQuery::Ptr job = entry.second;
+            os << *job << "\n";
+        }
     }
 }
 
@@ -28,6 +28,8 @@
 
 // System headers
 #include <atomic>
+#include <cstdint>
+#include <functional>
 #include <mutex>
 #include <sstream>
 #include <unordered_map>
@@ -42,7 +44,7 @@
 #include "qdisp/ResponseHandler.h"
 #include "qdisp/QdispPool.h"
 #include "util/EventThread.h"
-#include "util/InstanceCount.h"
+#include "util/ObjectCensus.h"
 #include "util/MultiError.h"
 #include "util/threadSafe.h"
 #include "util/ThreadPool.h"
@@ -61,7 +63,8 @@ class MessageStore;
 
 /// class Executive manages the execution of jobs for a UserQuery, while
 /// maintaining minimal information about the jobs themselves.
-class Executive : public std::enable_shared_from_this<Executive> {
+class Executive : public std::enable_shared_from_this<Executive>,
+                  public util::CensusMember<Executive> {
 public:
     typedef std::shared_ptr<Executive> Ptr;
     typedef std::unordered_map<int, std::shared_ptr<JobQuery>> JobMap;
@@ -87,6 +90,12 @@ public:
     /// Add an item with a reference number
     std::shared_ptr<JobQuery> add(JobDescription::Ptr const& s);
 
+    /// Add a batch of jobs in one shot. Equivalent to calling add() for each
+    /// description, but the cancellation check and bookkeeping are amortized
+    /// over the whole batch, which matters when a query covers ~100k chunks.
+    /// @return the JobQuery objects created; empty if execution was cancelled.
+    std::vector<std::shared_ptr<JobQuery>> addJobs(std::vector<JobDescription::Ptr> const& jobDescs);
+
     /// Queue a job to be sent to a worker so it can be started.
     void queueJobStart(PriorityCommand::Ptr const& cmd, bool scanInteractive);
 
@@ -102,9 +111,21 @@ public:
     /// Notify the executive that an item has completed
     void markCompleted(int refNum, bool success);
 
+    /// Install a callback invoked with the chunk id of every successfully
+    /// completed job. Used by shared-scan cohort tracking; must be set
+    /// before jobs are added.
+    void setChunkCompletionNotifier(std::function<void(int)> const& notifier) {
+        _chunkNotifier = notifier;
+    }
+
     /// Squash all the jobs.
     void squash();
 
+    /// Squash the remaining jobs because the merged result already satisfies
+    /// the user query's LIMIT. Unlike squash(), join() then reports success
+    /// for the execution even though some jobs never completed.
+    void squashEnoughRows();
+
     bool getEmpty() { return _empty; }
 
     void setQueryId(QueryId id);
@@ -112,11 +133,54 @@ public:
     std::string const& getIdStr() const { return _idStr; }
 
     /// @return number of items in flight.
-    int getNumInflight(); // non-const, requires a mutex.
+    int getNumInflight(); // atomic counter, no lock needed.
 
     /// @return a description of the current execution progress.
     std::string getProgressDesc() const;
 
+    /// Snapshot of how far this query's execution has progressed. Built from
+    /// the job counters, so taking one is cheap enough to do periodically.
+    struct Progress {
+        int totalJobs = 0;     ///< Chunk jobs submitted so far.
+        int completedJobs = 0; ///< Jobs that finished, successfully or not.
+        int inFlightJobs = 0;  ///< Jobs still queued or running on workers.
+    };
+
+    /// @return a snapshot of the current execution progress.
+    Progress getProgress() const;
+
+    /// Install a callback invoked with a progress snapshot every few seconds
+    /// while join() waits for the query to drain, and once more when the
+    /// last job completes. Used to surface progress through qmeta; must be
+    /// set before join() is called.
+    void setProgressReporter(std::function<void(Progress const&)> const& reporter) {
+        _progressReporter = reporter;
+    }
+
+    /// Aggregated per-phase milliseconds for the completed jobs of this
+    /// query, built from the worker-reported timing attached to each final
+    /// Result message. The dispatch and transfer phases compare worker epoch
+    /// stamps with czar epoch stamps, so they inherit whatever clock skew
+    /// exists between the hosts (negative differences are clamped to zero).
+    struct PhaseStats {
+        uint64_t jobs = 0;           ///< Jobs that reported timing.
+        uint64_t dispatchWaitMs = 0; ///< Czar dispatch until queued on a worker scheduler.
+        uint64_t workerQueueMs = 0;  ///< Waiting on a worker scheduler queue.
+        uint64_t mysqldMs = 0;       ///< Waiting on mysqld statement execution.
+        uint64_t serializeMs = 0;    ///< Serializing/compressing result messages.
+        uint64_t transferMs = 0;     ///< Final Result handed to the channel until received here.
+    };
+
+    /// Record the worker-reported timing of one completed job. Called by the
+    /// response handler when the final Result message of a job arrives.
+    /// All arguments are epoch milliseconds or millisecond durations, see
+    /// proto::TaskTiming.
+    void recordTaskTiming(uint64_t dispatchEpochMs, uint64_t queuedTimeMs, uint64_t startTimeMs,
+                          uint64_t sendTimeMs, uint64_t mysqldMs, uint64_t serializeMs);
+
+    /// @return a copy of the aggregated phase breakdown collected so far.
+    PhaseStats getPhaseStats() const;
+
     /// @return true if cancelled
     bool getCancelled() { return _cancelled; }
 
@@ -126,6 +190,12 @@ public:
 
     bool startQuery(std::shared_ptr<JobQuery> const& jobQuery);
 
+    /// Dispatch a duplicate request for a straggler job, steered away from
+    /// the worker serving the primary request so XRootD picks another
+    /// replica of the chunk. Called by JobQuery::hedge().
+    /// @return true if the hedge request was handed to SSI.
+    bool startHedge(std::shared_ptr<JobQuery> const& jobQuery, std::string const& avoidWorker);
+
     std::mutex sumMtx; // TEMPORARY-timing
     int cancelLockQSEASum{0}; // TEMPORARY-timing
     int jobQueryQSEASum{0}; // TEMPORARY-timing
@@ -139,6 +209,19 @@ private:
 
     void _setup();
 
+    /// One shard of the incomplete job tracking structure. Each shard has its
+    /// own mutex so that completion callbacks arriving on different XrdSsi
+    /// threads only contend when they hash to the same shard, instead of
+    /// funneling through a single mutex at high chunk counts.
+    struct JobShard {
+        std::mutex mtx;
+        JobMap jobs;
+    };
+
+    JobShard& _shardFor(int jobId) {
+        return _incompleteShards[static_cast<unsigned int>(jobId) % SHARD_COUNT];
+    }
+
     bool _track(int refNum, std::shared_ptr<JobQuery> const& r);
     void _unTrack(int refNum);
     bool _addJobToMap(std::shared_ptr<JobQuery> const& job);
@@ -148,6 +231,24 @@ private:
 
     void _waitAllUntilEmpty();
 
+    /// Send one KILL_QUERY command to each distinct worker holding incomplete
+    /// jobs of this query, so the workers can drop all of the query's Tasks at
+    /// once instead of as each per-chunk cancellation trickles in.
+    void _broadcastKillQuery();
+
+    /// Record how long a successfully completed job took, for straggler detection.
+    void _recordJobLatency(int latencyMs);
+
+    /// @return the elapsed time beyond which a still-running job counts as a
+    /// straggler, in milliseconds; -1 while too few jobs have completed to
+    /// estimate the latency distribution.
+    int _stragglerThresholdMs();
+
+    /// Hedge jobs that have been running well beyond the latency the
+    /// completed jobs of this query exhibited. Called periodically while
+    /// waiting for the query to drain.
+    void _hedgeStragglers();
+
     // for debugging
     void _printState(std::ostream& os);
 
@@ -156,7 +257,18 @@ private:
     std::shared_ptr<MessageStore> _messageStore; ///< MessageStore for logging
     XrdSsiService* _xrdSsiService; ///< RPC interface
     JobMap _jobMap; ///< Contains information about all jobs.
-    JobMap _incompleteJobs; ///< Map of incomplete jobs.
+
+    static unsigned int const SHARD_COUNT = 32; ///< Number of incomplete job shards.
+    JobShard _incompleteShards[SHARD_COUNT]; ///< Sharded maps of incomplete jobs.
+    std::atomic<int> _incompleteCount{0}; ///< Count of incomplete jobs across all shards.
+
+    static size_t const LATENCY_SAMPLE_MAX = 1024; ///< Completion latency samples kept.
+    mutable std::mutex _phaseMtx; ///< protects _phaseStats.
+    PhaseStats _phaseStats; ///< Aggregated phase breakdown of completed jobs.
+    std::mutex _latencyMtx; ///< protects _latencySamples and _latencyNext.
+    std::vector<int> _latencySamples; ///< Ring of recent job completion latencies, in ms.
+    size_t _latencyNext{0}; ///< Next slot of _latencySamples to overwrite.
+
     QdispPool::Ptr _qdispPool; ///< Shared thread pool for handling commands to and from workers.
 
     std::deque<PriorityCommand::Ptr> _jobStartCmdList; ///< list of jobs to start.
@@ -166,9 +278,18 @@ private:
 
     std::atomic<int> _requestCount; ///< Count of submitted jobs
     util::Flag<bool> _cancelled {false}; ///< Has execution been cancelled.
+    std::atomic<bool> _limitSquash{false}; ///< Jobs were squashed because LIMIT was satisfied.
+
+    /// Called with the chunk id of every successfully completed job; set
+    /// once before jobs are added, never changed afterwards.
+    std::function<void(int)> _chunkNotifier;
+
+    /// Called periodically with a progress snapshot while join() drains the
+    /// query; set once before join() is called, never changed afterwards.
+    std::function<void(Progress const&)> _progressReporter;
 
     // Mutexes
-    std::mutex _incompleteJobsMutex; ///< protect incompleteJobs map.
+    std::mutex _allJobsCompleteMtx; ///< Used with _allJobsComplete; shard maps have their own mutexes.
 
     /** Used to record execution errors */
     mutable std::mutex _errorsMutex;
@@ -178,7 +299,6 @@ private:
 
     QueryId _id{0}; ///< Unique identifier for this query.
     std::string    _idStr{QueryIdHelper::makeIdStr(0, true)};
-    util::InstanceCount _instC{"Executive"};
 };
 
 class MarkCompleteFunc {
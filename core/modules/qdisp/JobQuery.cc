@@ -34,6 +34,7 @@
 // Qserv headers
 #include "qdisp/Executive.h"
 #include "qdisp/QueryRequest.h"
+#include "util/FlightRecorder.h"
 
 namespace {
 LOG_LOGGER _log = LOG_GET("lsst.qserv.qdisp.JobQuery");
@@ -91,6 +92,10 @@ bool JobQuery::runJob() {
                 criticalErr("bad payload");
                 return false;
             }
+            if (_jobDescription->getAttemptCount() > 1) {
+                util::FlightRecorder::record(_qid, util::FlightRecorder::JOB_RETRY,
+                        _jobDescription->id(), _jobDescription->getAttemptCount());
+            }
         } else {
             LOGS(_log, LOG_LVL_DEBUG, _idStr << " runJob max retries");
             criticalErr("hit maximum number of retries");
@@ -104,6 +109,16 @@ bool JobQuery::runJob() {
         //
         LOGS(_log, LOG_LVL_DEBUG, _idStr << " runJob calls StartQuery()");
         std::shared_ptr<JobQuery> jq(shared_from_this());
+        // A retry supersedes any earlier race between the primary and a
+        // hedge request; the new attempt starts with a clean slate.
+        _respondingRequest = nullptr;
+        if (_hedgeRequestPtr != nullptr) {
+            _hedgeRequestPtr->squashForHedge();
+            _hedgeRequestPtr.reset();
+        }
+        _dispatchTick.store(std::chrono::steady_clock::now().time_since_epoch().count());
+        _dispatchEpochMs.store(std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count());
         _inSsi = true;
         if (executive->startQuery(jq)) {
            _jobStatus->updateInfo(_idStr, JobStatus::REQUEST);
@@ -133,6 +148,10 @@ bool JobQuery::cancel() {
                 LOGS(_log, LOG_LVL_DEBUG, _idStr << " QueryRequest could not cancel");
             }
         }
+        if (_hedgeRequestPtr != nullptr) {
+            // The hedge reports nothing on its own; squash it quietly.
+            _hedgeRequestPtr->squashForHedge();
+        }
         if (!cancelled) {
             std::ostringstream os;
             os << _idStr <<" cancel QueryRequest=" << _queryRequestPtr ;
@@ -153,6 +172,56 @@ bool JobQuery::cancel() {
 }
 
 
+/// Dispatch a duplicate request for this job to another replica of its chunk.
+/// Only jobs whose worker has not yet started to respond are hedged: once a
+/// response stream is open the shared response handler belongs to it, and a
+/// duplicate could not take over anyway.
+/// @return true if a hedge request was actually dispatched.
+bool JobQuery::hedge() {
+    if (_cancelled) return false;
+    auto executive = _executive.lock();
+    if (executive == nullptr || executive->getCancelled()) return false;
+    // _rmutex is held across startHedge() to follow the lock order runJob()
+    // establishes (_rmutex before the Executive's cancellation mutex);
+    // setHedgeRequest() re-enters it recursively on this thread.
+    std::lock_guard<std::recursive_mutex> lock(_rmutex);
+    if (!_inSsi || _queryRequestPtr == nullptr) return false;
+    if (_hedgeRequestPtr != nullptr || _respondingRequest != nullptr) {
+        return false; // Already hedged, or the response race is over.
+    }
+    if (_jobStatus->getInfo().state != JobStatus::REQUEST) {
+        return false; // The primary's worker has started to respond.
+    }
+    std::string const avoidWorker = _queryRequestPtr->GetEndPoint();
+    LOGS(_log, LOG_LVL_INFO, _idStr << " hedging straggler, avoiding worker=" << avoidWorker);
+    return executive->startHedge(shared_from_this(), avoidWorker);
+}
+
+
+/// The first of the primary and hedge requests whose worker starts answering
+/// claims the job here; the loser gets squashed so the two never touch the
+/// shared response handler concurrently.
+/// @return true if 'qr' may proceed with importing the response.
+bool JobQuery::claimResponse(QueryRequest* qr) {
+    std::shared_ptr<QueryRequest> loser;
+    {
+        std::lock_guard<std::recursive_mutex> lock(_rmutex);
+        if (_hedgeRequestPtr == nullptr) return true; // No race to resolve.
+        if (_respondingRequest == nullptr) {
+            _respondingRequest = qr;
+            loser = (qr == _hedgeRequestPtr.get()) ? _queryRequestPtr : _hedgeRequestPtr;
+        } else if (_respondingRequest != qr) {
+            return false;
+        }
+    }
+    if (loser != nullptr && loser.get() != qr) {
+        LOGS(_log, LOG_LVL_INFO, _idStr << " response race won, squashing " << *loser);
+        loser->squashForHedge();
+    }
+    return true;
+}
+
+
 /// @return true if this job's executive has been cancelled.
 /// There is enough delay between the executive being cancelled and the executive
 /// cancelling all the jobs that it makes a difference. If either the executive,
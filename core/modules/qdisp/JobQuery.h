@@ -28,6 +28,7 @@
 
 // System headers
 #include <atomic>
+#include <chrono>
 #include <memory>
 #include <mutex>
 
@@ -35,7 +36,7 @@
 #include "qdisp/Executive.h"
 #include "qdisp/JobDescription.h"
 #include "qdisp/ResponseHandler.h"
-#include "util/InstanceCount.h"
+#include "util/ObjectCensus.h"
 
 namespace lsst {
 namespace qserv {
@@ -47,7 +48,8 @@ class QueryRequest;
 /** This class is used to describe, monitor, and control a single query to a worker.
  *
  */
-class JobQuery : public std::enable_shared_from_this<JobQuery> {
+class JobQuery : public std::enable_shared_from_this<JobQuery>,
+                 public util::CensusMember<JobQuery> {
 public:
     typedef std::shared_ptr<JobQuery> Ptr;
 
@@ -82,6 +84,37 @@ public:
     bool cancel();
     bool isQueryCancelled();
 
+    /// Dispatch a duplicate request for this job to another replica of its
+    /// chunk. Called by the Executive when this job looks like a straggler.
+    /// The primary and hedge requests race; the first one the worker starts
+    /// answering wins (see claimResponse()) and the other is squashed.
+    /// @return true if a hedge request was actually dispatched.
+    bool hedge();
+
+    void setHedgeRequest(std::shared_ptr<QueryRequest> const& qr) {
+        std::lock_guard<std::recursive_mutex> lock(_rmutex);
+        _hedgeRequestPtr = qr;
+    }
+
+    /// Called by a QueryRequest when its worker has started to respond.
+    /// Only one of the primary and hedge requests may import the response
+    /// stream into the shared response handler; the first caller wins and
+    /// the loser is quietly squashed. Trivially true while no hedge exists.
+    /// @return true if 'qr' may proceed with importing the response.
+    bool claimResponse(QueryRequest* qr);
+
+    /// @return the time the current attempt was handed to SSI. Lock free,
+    /// as the Executive reads this while holding its own shard mutex.
+    std::chrono::steady_clock::time_point getDispatchTime() const {
+        return std::chrono::steady_clock::time_point(
+                std::chrono::steady_clock::duration(_dispatchTick.load()));
+    }
+
+    /// @return the time the current attempt was handed to SSI, as
+    /// milliseconds since the UNIX epoch. Comparable with the worker
+    /// stamps in proto::TaskTiming, modulo clock skew between the hosts.
+    uint64_t getDispatchEpochMs() const { return _dispatchEpochMs.load(); }
+
     Executive::Ptr getExecutive() { return _executive.lock(); }
 
     std::shared_ptr<QdispPool> getQdispPool() { return _qdispPool; }
@@ -124,11 +157,16 @@ protected:
 
     // SSI items
     std::shared_ptr<QueryRequest> _queryRequestPtr;
+    std::shared_ptr<QueryRequest> _hedgeRequestPtr; ///< duplicate request to another replica, or nullptr.
+    QueryRequest* _respondingRequest{nullptr}; ///< which request won the response race, protected by _rmutex.
+    /// When the current attempt entered SSI, as a steady clock tick count.
+    std::atomic<std::chrono::steady_clock::duration::rep> _dispatchTick{0};
+    /// Same instant as epoch milliseconds, for comparison with worker stamps.
+    std::atomic<uint64_t> _dispatchEpochMs{0};
     bool _inSsi{false};
 
     // Cancellation
     std::atomic<bool> _cancelled {false}; ///< Lock to make sure cancel() is only called once.
-    util::InstanceCount _instC{"JobQuery"};
 
     std::shared_ptr<QdispPool> _qdispPool;
 };
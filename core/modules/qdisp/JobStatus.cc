@@ -50,19 +50,77 @@ namespace lsst {
 namespace qserv {
 namespace qdisp {
 
+JobStatus::JobStatus() : _ctorTime(_coarseTime()) {
+    for (auto& entry : _ring) {
+        entry.store(0, std::memory_order_relaxed);
+    }
+}
+
 JobStatus::Info::Info()
     : state(UNKNOWN), stateCode(0) {
     stateTime = ::time(NULL);
 }
 
-void JobStatus::updateInfo(std::string const& idMsg, JobStatus::State s, int code, std::string const& desc) {
-    std::lock_guard<std::mutex> lock(_mutex);
+time_t JobStatus::_coarseTime() {
+#ifdef CLOCK_REALTIME_COARSE
+    // A vDSO read of the kernel's tick-cached time, no syscall and much
+    // cheaper than a full clock read; second resolution is all that is
+    // kept anyway.
+    struct timespec ts;
+    ::clock_gettime(CLOCK_REALTIME_COARSE, &ts);
+    return ts.tv_sec;
+#else
+    return ::time(nullptr);
+#endif
+}
 
+void JobStatus::updateInfo(std::string const& idMsg, JobStatus::State s, int code, std::string const& desc) {
     LOGS(_log, LOG_LVL_INFO, idMsg << " Updating state to: " << s << " code=" << code << " " << desc);
-    _info.stateTime = ::time(NULL);
-    _info.state = s;
-    _info.stateCode = code;
-    _info.stateDesc = desc;
+    if (!desc.empty()) {
+        std::lock_guard<std::mutex> lock(_descMutex);
+        _stateDesc = desc;
+    }
+    uint64_t const t = static_cast<uint64_t>(_coarseTime());
+    uint32_t const idx = _transitions.fetch_add(1, std::memory_order_acq_rel);
+    _ring[idx % HISTORY_SIZE].store((t << 16) | (s & 0xffff),
+                                    std::memory_order_relaxed);
+    uint64_t const word = (static_cast<uint64_t>(static_cast<uint32_t>(code)) << 32)
+                        | (s & 0xffff);
+    _stateWord.store(word, std::memory_order_release);
+}
+
+
+JobStatus::Info JobStatus::getInfo() const {
+    Info info;
+    uint32_t const n = _transitions.load(std::memory_order_acquire);
+    if (n == 0) {
+        info.stateTime = _ctorTime;
+        return info;
+    }
+    uint64_t const word = _stateWord.load(std::memory_order_acquire);
+    info.state = static_cast<State>(word & 0xffff);
+    info.stateCode = static_cast<int32_t>(word >> 32);
+    uint64_t const entry = _ring[(n - 1) % HISTORY_SIZE].load(std::memory_order_relaxed);
+    info.stateTime = static_cast<time_t>(entry >> 16);
+    {
+        std::lock_guard<std::mutex> lock(_descMutex);
+        info.stateDesc = _stateDesc;
+    }
+    return info;
+}
+
+
+std::vector<std::pair<JobStatus::State, time_t>> JobStatus::getHistory() const {
+    std::vector<std::pair<State, time_t>> history;
+    uint32_t const n = _transitions.load(std::memory_order_acquire);
+    uint32_t const start = n > static_cast<uint32_t>(HISTORY_SIZE) ? n - HISTORY_SIZE : 0;
+    for (uint32_t i = start; i != n; ++i) {
+        uint64_t const entry = _ring[i % HISTORY_SIZE].load(std::memory_order_relaxed);
+        if (entry == 0) continue; // not yet published
+        history.emplace_back(static_cast<State>(entry & 0xffff),
+                             static_cast<time_t>(entry >> 16));
+    }
+    return history;
 }
 
 
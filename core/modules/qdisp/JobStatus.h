@@ -24,11 +24,15 @@
 #define LSST_QSERV_QDISP_JOBSTATUS_H
 
 // System headers
+#include <array>
+#include <atomic>
 #include <fstream>
 #include <memory>
 #include <mutex>
 #include <string>
 #include <time.h>
+#include <utility>
+#include <vector>
 
 namespace lsst {
 namespace qserv {
@@ -40,15 +44,19 @@ namespace qdisp {
  *  allows a manager object to receive updates on status without exposing its
  *  existence to a delegate class.
  *
- *  TODO: The JobStatus class could be extended to
- *  save all received reports to provide a timeline of state changes.
+ *  A job goes through several transitions and a query dispatches many
+ *  thousands of jobs, so reporting must be cheap: the current state and
+ *  code live in one atomic word, timestamps come from a coarse cached
+ *  clock, and the recent (state, time) transitions are kept in a small
+ *  fixed ring. Only the rare transition carrying an error description
+ *  takes a lock.
  *
  *  @see qdisp::JobDescription
  */
 class JobStatus {
 public:
     typedef std::shared_ptr<JobStatus> Ptr;
-    JobStatus() {}
+    JobStatus();
 
     // TODO: these shouldn't be exposed, and so shouldn't be user-level error
     // codes, but maybe we can be clever and avoid an ugly remap/translation
@@ -71,36 +79,51 @@ public:
      *  @param s state value
      *  @param code code value, default to 0
      *  @param desc message, default to ""
-     *
-     * TODO: Save past state history:
-     *  - resourceUnit should be extracted from Info (beware of mutex)
-     *  - Info should be put in a vector
      */
     void updateInfo(std::string const& idMsg, State s, int code=0, std::string const& desc="");
 
     struct Info {
         Info();
-        // More detailed debugging may store a vector of states, appending
-        // with each invocation of report().
         State state; ///< Actual state
         time_t stateTime; ///< Last modified timestamp
         int stateCode; ///< Code associated with state (e.g. xrd or mysql error code)
         std::string stateDesc; ///< Textual description
     };
 
-    Info getInfo() const {
-        std::lock_guard<std::mutex> lock(_mutex);
-        return _info;
-    }
+    Info getInfo() const;
 
+    /// @return up to the last HISTORY_SIZE (state, time) transitions,
+    /// oldest first. Best effort: a concurrent transition may overwrite
+    /// the oldest entry while it is being read.
+    std::vector<std::pair<State, time_t>> getHistory() const;
 
     static std::string stateStr(JobStatus::State const& state);
 
     friend std::ostream& operator<<(std::ostream& os, JobStatus const& es);
 
+    static int const HISTORY_SIZE = 8;
+
 private:
-    Info _info;
-    mutable std::mutex _mutex; ///< Mutex to guard concurrent updates
+    /// @return seconds since the epoch from the kernel's cached coarse
+    /// clock, avoiding a full clock read on every transition.
+    static time_t _coarseTime();
+
+    // The current state and code are packed into one word so a transition
+    // is a single release store and getInfo() a single acquire load:
+    // bits [63:32] the code, bits [15:0] the state.
+    std::atomic<uint64_t> _stateWord{0};
+
+    // Recent transitions, each packed as (time << 16) | state. Slots are
+    // claimed from _transitions and overwritten ring-fashion.
+    std::array<std::atomic<uint64_t>, HISTORY_SIZE> _ring;
+    std::atomic<uint32_t> _transitions{0}; ///< Transitions reported so far.
+
+    time_t const _ctorTime; ///< getInfo() time before the first transition.
+
+    // Only transitions reporting an error carry a description; the mutex
+    // is off the hot path.
+    std::string _stateDesc;
+    mutable std::mutex _descMutex; ///< Guards _stateDesc.
 };
 std::ostream& operator<<(std::ostream& os, JobStatus const& es);
 std::ostream& operator<<(std::ostream& os, JobStatus::Info const& inf);
@@ -0,0 +1,138 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "qdisp/KillQueryRequest.h"
+
+// System headers
+#include <algorithm>
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+// Qserv headers
+#include "proto/worker.pb.h"
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.qdisp.KillQueryRequest");
+
+} // anonymous namespace
+
+namespace lsst {
+namespace qserv {
+namespace qdisp {
+
+// The worker reply is a single small message, one increment is normally enough.
+int const KillQueryRequest::_bufIncrementSize = 1024;
+
+KillQueryRequest::KillQueryRequest(QueryId queryId, std::string const& worker)
+    : _queryId(queryId),
+      _worker(worker),
+      _idStr(QueryIdHelper::makeIdStr(queryId)),
+      _bufCapacity(_bufIncrementSize),
+      _buf(new char[_bufIncrementSize]) {
+}
+
+char* KillQueryRequest::GetRequest(int& requestLength) {
+    proto::WorkerCommandH header;
+    header.set_command(proto::WorkerCommandH::KILL_QUERY);
+    _frameBuf.serialize(header);
+
+    proto::WorkerCommandKillQueryM message;
+    message.set_query_id(_queryId);
+    _frameBuf.serialize(message);
+
+    requestLength = _frameBuf.size();
+    return _frameBuf.data();
+}
+
+bool KillQueryRequest::ProcessResponse(XrdSsiErrInfo const& eInfo,
+                                       XrdSsiRespInfo const& rInfo) {
+    if (eInfo.hasError()) {
+        // The kill is best effort; the per-job cancellation will still clean
+        // up each request, so just log the failure and go away.
+        LOGS(_log, LOG_LVL_WARN, _idStr << "KillQueryRequest to worker=" << _worker
+             << " failed, error: " << rInfo.eMsg);
+        _finish();
+        return false;
+    }
+    switch (rInfo.rType) {
+        case XrdSsiRespInfo::isData:
+        case XrdSsiRespInfo::isStream:
+            GetResponseData(_buf.get() + _bufSize, _bufIncrementSize);
+            return true;
+        default:
+            LOGS(_log, LOG_LVL_WARN, _idStr << "KillQueryRequest to worker=" << _worker
+                 << " unexpected response type: " << rInfo.rType);
+            _finish();
+            return false;
+    }
+}
+
+XrdSsiRequest::PRD_Xeq KillQueryRequest::ProcessResponseData(XrdSsiErrInfo const& eInfo,
+                                                             char* buff, int blen, bool last) {
+    if (not eInfo.isOK()) {
+        LOGS(_log, LOG_LVL_WARN, _idStr << "KillQueryRequest to worker=" << _worker
+             << " failed, error: " << eInfo.Get());
+        _finish();
+        return XrdSsiRequest::PRD_Normal;
+    }
+    _bufSize += blen;
+    if (not last) {
+        // Extend the buffer, copy over its previous content and keep reading.
+        int const prevBufCapacity = _bufCapacity;
+        _bufCapacity += _bufIncrementSize;
+        std::unique_ptr<char[]> prevBuf = std::move(_buf);
+        _buf.reset(new char[_bufCapacity]);
+        std::copy(prevBuf.get(), prevBuf.get() + prevBufCapacity, _buf.get());
+        GetResponseData(_buf.get() + _bufSize, _bufIncrementSize);
+        return XrdSsiRequest::PRD_Normal;
+    }
+    try {
+        proto::FrameBufferView view(_buf.get(), _bufSize);
+        proto::WorkerCommandKillQueryR reply;
+        view.parse(reply);
+        if (reply.status() == proto::WorkerCommandKillQueryR::SUCCESS) {
+            LOGS(_log, LOG_LVL_INFO, _idStr << "worker=" << _worker
+                 << " cancelled " << reply.cancelled() << " tasks");
+        } else {
+            LOGS(_log, LOG_LVL_WARN, _idStr << "worker=" << _worker
+                 << " failed to kill query, error: " << reply.error());
+        }
+    } catch (proto::FrameBufferError const& ex) {
+        LOGS(_log, LOG_LVL_WARN, _idStr << "failed to decode the kill query reply from worker="
+             << _worker << ", error: " << ex.what());
+    }
+    _finish();
+    return XrdSsiRequest::PRD_Normal;
+}
+
+void KillQueryRequest::_finish() {
+    Finished();
+    // Release the self reference. This may delete the object, so it must be
+    // the last thing done with it.
+    _keepAlive.reset();
+}
+
+}}} // namespace lsst::qserv::qdisp
@@ -0,0 +1,97 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_QDISP_KILLQUERYREQUEST_H
+#define LSST_QSERV_QDISP_KILLQUERYREQUEST_H
+
+// System headers
+#include <memory>
+#include <string>
+
+// Third-party headers
+#include "XrdSsi/XrdSsiRequest.hh"
+
+// Qserv headers
+#include "global/intTypes.h"
+#include "proto/FrameBuffer.h"
+
+namespace lsst {
+namespace qserv {
+namespace qdisp {
+
+/// KillQueryRequest is a fire-and-forget request carrying the KILL_QUERY
+/// worker management command to a single worker. The Executive sends one of
+/// these per worker when squashing a query so each worker can cancel all of
+/// the query's Tasks at once, instead of waiting for the per-chunk requests
+/// to be cancelled one at a time. The worker's reply is only logged; the
+/// per-job cancellation still runs to tear down the czar side of each
+/// request. The object keeps itself alive until Finished() has been called.
+class KillQueryRequest : public XrdSsiRequest, public std::enable_shared_from_this<KillQueryRequest> {
+public:
+    typedef std::shared_ptr<KillQueryRequest> Ptr;
+
+    /// @param queryId id of the user query to cancel
+    /// @param worker  hostname of the target worker, for log messages.
+    static Ptr create(QueryId queryId, std::string const& worker) {
+        Ptr newRequest(new KillQueryRequest(queryId, worker));
+        newRequest->_keepAlive = newRequest;
+        return newRequest;
+    }
+
+    virtual ~KillQueryRequest() = default;
+
+    /// Called by SSI to get the request payload.
+    char* GetRequest(int& requestLength) override;
+
+    /// Called by SSI when a response is ready.
+    bool ProcessResponse(XrdSsiErrInfo const& eInfo,
+                         XrdSsiRespInfo const& rInfo) override;
+
+    /// Called by SSI when new data is available.
+    XrdSsiRequest::PRD_Xeq ProcessResponseData(XrdSsiErrInfo const& eInfo,
+                           char* buff, int blen, bool last) override;
+
+private:
+    // Private constructor to safeguard enable_shared_from_this construction.
+    KillQueryRequest(QueryId queryId, std::string const& worker);
+
+    /// Release SSI resources and then the self reference keeping this alive.
+    void _finish();
+
+    QueryId _queryId;
+    std::string _worker; ///< target worker, for log messages only.
+    std::string _idStr;  ///< for debugging only.
+
+    proto::FrameBuffer _frameBuf; ///< serialized request payload.
+
+    // Buffer for the streamed response.
+    static int const _bufIncrementSize;
+    int _bufSize{0};
+    int _bufCapacity;
+    std::unique_ptr<char[]> _buf;
+
+    std::shared_ptr<KillQueryRequest> _keepAlive; ///< Keeps this alive until Finished().
+};
+
+}}} // namespace lsst::qserv::qdisp
+
+#endif // LSST_QSERV_QDISP_KILLQUERYREQUEST_H
@@ -26,7 +26,11 @@
 #include "qdisp/MessageStore.h"
 
 // System headers
+#include <algorithm>
+#include <functional>
 #include <iostream>
+#include <stdexcept>
+#include <thread>
 
 // Third-party headers
 #include "boost/format.hpp"
@@ -58,11 +62,48 @@ void MessageStore::addMessage(int chunkId, int code,
     }
     auto level = code < 0 ? LOG_LVL_ERROR : LOG_LVL_DEBUG;
     LOGS(_log, level, "Add msg: " << chunkId << " " << code << " " << description);
-    {
-        std::lock_guard<std::mutex> lock(_storeMutex);
-        _queryMessages.insert(_queryMessages.end(),
-                              QueryMessage(chunkId, code, description, timestamp, severity));
+
+    Shard& shard = _shard();
+
+    // Coalesce a run of identical messages into the shard's latest slot.
+    // With thousands of jobs reporting the same status this keeps the
+    // store at one slot per distinct message instead of one per job.
+    uint32_t const n = std::min(shard.claimed.load(std::memory_order_acquire),
+                                static_cast<uint32_t>(SHARD_CAPACITY));
+    if (n > 0) {
+        Slot& last = shard.slots[n - 1];
+        if (last.ready.load(std::memory_order_acquire)
+            && last.code == code && last.severity == severity
+            && last.description == description) {
+            last.repeat.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    }
+
+    uint32_t const idx = shard.claimed.fetch_add(1, std::memory_order_acq_rel);
+    if (idx < static_cast<uint32_t>(SHARD_CAPACITY)) {
+        Slot& slot = shard.slots[idx];
+        slot.chunkId = chunkId;
+        slot.code = code;
+        slot.description = description;
+        slot.timestamp = timestamp;
+        slot.severity = severity;
+        slot.ready.store(true, std::memory_order_release);
+        return;
+    }
+
+    // The shard is full; coalesce into any identical slot rather than grow.
+    for (auto& slot : shard.slots) {
+        if (slot.ready.load(std::memory_order_acquire)
+            && slot.code == code && slot.severity == severity
+            && slot.description == description) {
+            slot.repeat.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
     }
+    auto droppedCount = shard.dropped.fetch_add(1, std::memory_order_relaxed) + 1;
+    LOGS(_log, LOG_LVL_WARN, "MessageStore shard full, dropped message code="
+         << code << " (" << droppedCount << " dropped)");
 }
 
 void MessageStore::addErrorMessage(std::string const& description) {
@@ -70,20 +111,68 @@ void MessageStore::addErrorMessage(std::string const& description) {
 }
 
 const QueryMessage MessageStore::getMessage(int idx) {
-    return _queryMessages.at(idx);
+    for (auto& shard : _shards) {
+        uint32_t const n = shard.count();
+        if (idx < static_cast<int>(n)) {
+            Slot& slot = shard.slots[idx];
+            // The slot is claimed before it is published; a reader racing
+            // the last few writers waits out the fill.
+            while (!slot.ready.load(std::memory_order_acquire)) {
+                std::this_thread::yield();
+            }
+            return _render(slot);
+        }
+        idx -= n;
+    }
+    throw std::out_of_range("MessageStore::getMessage bad index");
 }
 
 const int MessageStore::messageCount() {
-    return _queryMessages.size();
+    int count = 0;
+    for (auto& shard : _shards) {
+        count += shard.count();
+    }
+    return count;
 }
 
 const int MessageStore::messageCount(int code) {
     int count = 0;
-    for (std::vector<QueryMessage>::const_iterator i = _queryMessages.begin();
-         i != _queryMessages.end(); ++i) {
-        if (i->code == code) count++;
+    for (auto& shard : _shards) {
+        uint32_t const n = shard.count();
+        for (uint32_t i = 0; i != n; ++i) {
+            Slot& slot = shard.slots[i];
+            if (slot.ready.load(std::memory_order_acquire) && slot.code == code) {
+                count += 1 + slot.repeat.load(std::memory_order_relaxed);
+            }
+        }
     }
     return count;
 }
 
+////////////////////////////////////////////////////////////////////////
+// private
+////////////////////////////////////////////////////////////////////////
+
+uint32_t MessageStore::Shard::count() const {
+    return std::min(claimed.load(std::memory_order_acquire),
+                    static_cast<uint32_t>(SHARD_CAPACITY));
+}
+
+MessageStore::Shard& MessageStore::_shard() {
+    static std::hash<std::thread::id> const hasher;
+    return _shards[hasher(std::this_thread::get_id()) % NUM_SHARDS];
+}
+
+QueryMessage MessageStore::_render(Slot const& slot) {
+    uint32_t const repeat = slot.repeat.load(std::memory_order_relaxed);
+    std::string description = slot.description;
+    if (repeat > 0) {
+        // The coalesced occurrences keep the first slot's chunkId and
+        // timestamp; the count records that others followed.
+        description += " [" + std::to_string(repeat + 1) + " times]";
+    }
+    return QueryMessage(slot.chunkId, slot.code, description,
+                        slot.timestamp, slot.severity);
+}
+
 }}} // namespace lsst::qserv::qdisp
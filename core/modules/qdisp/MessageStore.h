@@ -33,8 +33,9 @@
 #define LSST_QSERV_QDISP_MESSAGESTORE_H
 
 // System headers
+#include <array>
+#include <atomic>
 #include <ctime>
-#include <mutex>
 #include <string>
 #include <vector>
 
@@ -73,6 +74,16 @@ struct QueryMessage {
  * For each SQL query, these messages are stored in a MySQL message table
  * so that mysql-proxy can retrieve it and log it or send error messages
  * to client.
+ *
+ * Messages arrive from many job completion callbacks at once, so the store
+ * is sharded by producer thread and each shard is a bounded slot array
+ * claimed with an atomic counter: adding a message takes no lock. Runs of
+ * identical messages (the common case when thousands of jobs report the
+ * same status) coalesce into one slot with a repeat count, and once a
+ * shard is full further messages coalesce into any matching slot instead
+ * of growing the store, so memory stays bounded no matter the job count.
+ * Messages are ordered within a shard but not across shards; timestamps
+ * give the global order where it matters.
  */
 class MessageStore {
 public:
@@ -107,8 +118,39 @@ public:
     const int messageCount(int code);
 
 private:
-    std::mutex _storeMutex;
-    std::vector<QueryMessage> _queryMessages;
+    static int const NUM_SHARDS = 16;
+    static int const SHARD_CAPACITY = 1024;
+
+    /// One stored message. The claiming thread fills the plain fields and
+    /// then publishes them with a release store of 'ready'; afterwards only
+    /// the atomic repeat count changes.
+    struct Slot {
+        std::atomic<bool> ready{false};
+        std::atomic<uint32_t> repeat{0}; ///< further identical messages
+        int chunkId{0};
+        int code{0};
+        std::string description;
+        std::time_t timestamp{0};
+        MessageSeverity severity{MessageSeverity::MSG_INFO};
+    };
+
+    struct Shard {
+        Shard() : slots(SHARD_CAPACITY) {}
+        std::atomic<uint32_t> claimed{0}; ///< slots claimed so far (may pass capacity)
+        std::atomic<uint32_t> dropped{0}; ///< messages lost after overflow
+        std::vector<Slot> slots;
+
+        /// @return the number of retrievable slots.
+        uint32_t count() const;
+    };
+
+    /// @return this thread's shard.
+    Shard& _shard();
+
+    /// @return a QueryMessage for the slot, noting the repeat count.
+    static QueryMessage _render(Slot const& slot);
+
+    std::array<Shard, NUM_SHARDS> _shards;
 };
 
 }}} // namespace lsst::qserv::qdisp
@@ -37,10 +37,10 @@ namespace qserv {
 namespace qdisp {
 
 
-// must hold pq._mtx before calling
+// Reads the lock-free snapshot, no locks needed.
 std::ostream& operator<<(std::ostream& os, PriorityQueue const& pq) {
-    for (auto const& elem : pq._queues)   {
-        PriorityQueue::PriQ::Ptr const& que = elem.second;
+    auto queueList = pq._getQueueList();
+    for (auto const& que : *queueList)   {
         os << "(pri=" << que->getPriority()
            << ":sz="  << que->size()
            << ":r="   << que->running << ")";
@@ -49,16 +49,46 @@ std::ostream& operator<<(std::ostream& os, PriorityQueue const& pq) {
 }
 
 
+/// Rebuild the snapshot used by the lock-free paths. The map iterates in
+/// priority order, so the snapshot is sorted highest priority first.
+void PriorityQueue::_updateQueueList() {
+    auto newList = std::make_shared<QueueList>();
+    for (auto const& elem : _queues) {
+        newList->push_back(elem.second);
+    }
+    std::atomic_store(&_queueList, std::shared_ptr<QueueList const>(newList));
+}
+
+
+PriorityQueue::PriQ::Ptr PriorityQueue::_getQueue(int priority) const {
+    auto queueList = _getQueueList();
+    for (auto const& que : *queueList) {
+        if (que->getPriority() == priority) return que;
+    }
+    return nullptr;
+}
+
+
+void PriorityQueue::_notify() {
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        _changed = true;
+    }
+    _cv.notify_all();
+}
+
+
 ///< @Return true if the queue could be added.
 bool PriorityQueue::addPriQueue(int priority, int minRunning) {
     std::lock_guard<std::mutex> lock(_mtx);
     auto q = std::make_shared<PriQ>(priority, minRunning);
-    //std::pair<int, PriQ::Ptr> item(priority, q);
     auto item = std::make_pair(priority, q);
     auto ret = _queues.insert(item);
     if (!ret.second) {
         LOGS(_log, LOG_LVL_ERROR, "Failed addPriQueue priority=" << priority <<
                                   " minRunning=" << minRunning);
+    } else {
+        _updateQueueList();
     }
     return ret.second;
 }
@@ -66,54 +96,50 @@ bool PriorityQueue::addPriQueue(int priority, int minRunning) {
 
 /// The pool needs to be able to place commands in this queue for shutdown.
 void PriorityQueue::queCmd(util::Command::Ptr const& cmd) {
-    {
-        std::lock_guard<std::mutex> lock(_mtx);
-        auto iter = _queues.find(_defaultPriority);
-        if (iter == _queues.end()) {
-            throw Bug("PriorityQueue default priority queue not found a!");
-        }
-        iter->second->queCmd(cmd);
-        _changed = true;
+    auto que = _getQueue(_defaultPriority);
+    if (que == nullptr) {
+        throw Bug("PriorityQueue default priority queue not found a!");
     }
-    _cv.notify_all();
+    que->queCmd(cmd); // each lane has its own internal lock.
+    _notify();
 }
 
 
 void PriorityQueue::queCmd(PriorityCommand::Ptr const& cmd, int priority) {
-    {
-        std::lock_guard<std::mutex> lock(_mtx);
-        auto iter = _queues.find(priority);
-        if (iter == _queues.end()) {
-            // give it the default priority
-            LOGS(_log, LOG_LVL_WARN, "queCmd invalid priority=" << priority <<
-                                     " using default priority=" << _defaultPriority);
-            iter = _queues.find(_defaultPriority);
-            if (iter == _queues.end()) {
-                throw Bug("PriorityQueue default priority queue not found b!");
-            }
+    auto que = _getQueue(priority);
+    if (que == nullptr) {
+        // give it the default priority
+        LOGS(_log, LOG_LVL_WARN, "queCmd invalid priority=" << priority <<
+                                 " using default priority=" << _defaultPriority);
+        priority = _defaultPriority;
+        que = _getQueue(priority);
+        if (que == nullptr) {
+            throw Bug("PriorityQueue default priority queue not found b!");
         }
-        cmd->_priority = priority;
-        iter->second->queCmd(cmd);
-        LOGS (_log, LOG_LVL_DEBUG, "priQue p=" << priority << *this);
-        _changed = true;
     }
-    _cv.notify_all();
+    cmd->_priority = priority;
+    cmd->_queuedTime = std::chrono::steady_clock::now();
+    que->queCmd(cmd); // each lane has its own internal lock.
+    LOGS (_log, LOG_LVL_DEBUG, "priQue p=" << priority << *this);
+    _notify();
 }
 
 
 util::Command::Ptr PriorityQueue::getCmd(bool wait){
     util::Command::Ptr ptr;
-    std::unique_lock<std::mutex> uLock(_mtx);
     while (true) {
-        _changed = false;
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+            _changed = false;
+        }
         LOGS (_log, LOG_LVL_DEBUG, "priQueGet " << *this);
+        auto queueList = _getQueueList();
 
         /// Make sure minimum number of jobs running per priority.
         if (!_shuttingDown) {
             // If shutting down, this could prevent all jobs from completing.
             // Goes from highest to lowest priority queue
-            for (auto const& elem : _queues) {
-                PriQ::Ptr const& que = elem.second;
+            for (auto const& que : *queueList) {
                 if (que->running < que->getMinRunning()) {
                     ptr = que->getCmd(false); // no wait
                     if (ptr != nullptr) {
@@ -123,9 +149,10 @@ util::Command::Ptr PriorityQueue::getCmd(bool wait){
             }
         }
 
-        // Since all the minimums are met, just run the first command found.
-        for (auto const& elem : _queues) {
-            PriQ::Ptr const& que = elem.second;
+        // Since all the minimums are met, steal the first command found,
+        // scanning from the highest priority lane down. This lets threads
+        // nominally reserved for an idle lane work on the busy ones.
+        for (auto const& que : *queueList) {
             //  TODO: Maybe add a check for max running.
             ptr = que->getCmd(false); // no wait
             if (ptr != nullptr) {
@@ -136,6 +163,7 @@ util::Command::Ptr PriorityQueue::getCmd(bool wait){
         // If nothing was found, wait or return nullptr.
         if (wait) {
             LOGS (_log, LOG_LVL_DEBUG, "getCmd wait " << *this);
+            std::unique_lock<std::mutex> uLock(_mtx);
             _cv.wait(uLock, [this](){ return _changed; });
         } else {
             return ptr;
@@ -145,32 +173,37 @@ util::Command::Ptr PriorityQueue::getCmd(bool wait){
 
 
 void PriorityQueue::prepareShutdown() {
-    std::lock_guard<std::mutex> lock(_mtx);
     _shuttingDown = true;
+    _notify();
 }
 
 
 void PriorityQueue::_incrDecrRunningCount(util::Command::Ptr const& cmd, int incrDecr) {
-    std::lock_guard<std::mutex> lock(_mtx);
     PriorityCommand::Ptr priCmd = std::dynamic_pointer_cast<PriorityCommand>(cmd);
     if (priCmd != nullptr) {
-        int priority = priCmd->_priority;
-        auto iter = _queues.find(priority);
-        if (iter != _queues.end()) {
-            iter->second->running += incrDecr;
+        auto que = _getQueue(priCmd->_priority);
+        if (que != nullptr) {
+            que->running += incrDecr; // atomic, no lock needed.
             return;
         }
     } else if (cmd != nullptr) {
         // Non-PriorityCommands go on the default queue.
-        auto iter = _queues.find(_defaultPriority);
-        if (iter != _queues.end()) {
-            iter->second->running += incrDecr;
+        auto que = _getQueue(_defaultPriority);
+        if (que != nullptr) {
+            que->running += incrDecr; // atomic, no lock needed.
         }
     }
 }
 
 
 void PriorityQueue::commandStart(util::Command::Ptr const& cmd) {
+    PriorityCommand::Ptr priCmd = std::dynamic_pointer_cast<PriorityCommand>(cmd);
+    // Commands queued without a priority never got a timestamp; skip them.
+    if (priCmd != nullptr && priCmd->_queuedTime != std::chrono::steady_clock::time_point()) {
+        auto const waited = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - priCmd->_queuedTime);
+        _queueWaitHisto.record(waited.count() > 0 ? waited.count() : 0);
+    }
     // Increase running count by 1
     _incrDecrRunningCount(cmd, 1);
 }
@@ -183,9 +216,8 @@ void PriorityQueue::commandFinish(util::Command::Ptr const& cmd) {
 
 
 std::string PriorityQueue::statsStr() {
-    std::lock_guard<std::mutex> lock(_mtx);
     std::stringstream os;
-    os << *this;
+    os << *this << " " << _queueWaitHisto.summary();
     return os.str();
 }
 
@@ -24,12 +24,16 @@
 #define LSST_QSERV_QDISP_QDISPPOOL_H
 
 // System headers
+#include <chrono>
 #include <map>
+#include <memory>
+#include <vector>
 
 // Third-party headers
 
 // Qserv headers
 #include "global/Bug.h"
+#include "util/Histogram.h"
 #include "util/ThreadPool.h"
 
 namespace lsst {
@@ -47,11 +51,18 @@ public:
     friend PriorityQueue;
 private:
     int _priority{0}; // Need to know what queue this was placed on.
+    std::chrono::steady_clock::time_point _queuedTime; // When queCmd() accepted this command.
 };
 
 
 // FIFO priority queue. Elements with the same priority are handled in
 // a FIFO manner. Lower integer values are higher priority.
+//
+// Each priority lane is its own CommandQueue with its own internal lock.
+// queCmd() and getCmd() work on a copy-on-write snapshot of the lane list,
+// so producers on different lanes do not contend and _mtx is only taken
+// briefly for condition variable signalling. An idle thread that finds its
+// lane empty steals work from any other lane (highest priority first).
 class PriorityQueue : public util::CommandQueue {
 public:
     using Ptr = std::shared_ptr<PriorityQueue>;
@@ -78,6 +89,7 @@ public:
 
     PriorityQueue(int defaultPriority, int minRunning) : _defaultPriority(defaultPriority) {
         _queues[_defaultPriority] = std::make_shared<PriQ>(_defaultPriority, minRunning);
+        _updateQueueList();
     }
 
     ///< @Return true if the queue could be added.
@@ -96,17 +108,60 @@ public:
 
     std::string statsStr();
 
+    /// Counters of one priority lane as sampled by laneStats().
+    struct LaneStats {
+        int priority;
+        std::size_t size;
+        int running;
+    };
+
+    /// @return current size and running count per lane, read from the
+    /// lock-free snapshot; safe to call from a metrics scrape at any rate.
+    std::vector<LaneStats> laneStats() const {
+        std::vector<LaneStats> lanes;
+        auto queueList = _getQueueList();
+        for (auto const& que : *queueList) {
+            lanes.push_back(LaneStats{que->getPriority(), que->size(), que->running});
+        }
+        return lanes;
+    }
+
+    /// @return the queue-wait histogram, e.g. for Prometheus export.
+    util::Histogram const& queueWaitHistogram() const { return _queueWaitHisto; }
+
 private:
+    using QueueList = std::vector<PriQ::Ptr>;
+
     void _incrDecrRunningCount(util::Command::Ptr const& cmd, int incrDecr);
 
-    std::mutex _mtx;
+    /// @return the current lane snapshot; safe to read without holding _mtx.
+    std::shared_ptr<QueueList const> _getQueueList() const {
+        return std::atomic_load(&_queueList);
+    }
+
+    /// @return the lane for 'priority', or nullptr if there is none.
+    PriQ::Ptr _getQueue(int priority) const;
+
+    /// Flag a change and wake waiting threads. Takes _mtx briefly.
+    void _notify();
+
+    /// Rebuild the _queueList snapshot from _queues. _mtx must be held,
+    /// except during construction.
+    void _updateQueueList();
+
+    std::mutex _mtx; ///< protects _cv/_changed and modification of _queues.
     std::condition_variable _cv;
-    bool _shuttingDown{false};
+    std::atomic<bool> _shuttingDown{false};
     bool _changed{false};
 
-    std::map<int, PriQ::Ptr> _queues;
+    std::map<int, PriQ::Ptr> _queues; ///< master copy, modified under _mtx.
+    std::shared_ptr<QueueList const> _queueList; ///< snapshot sorted by priority, use atomic_load/store.
     int _defaultPriority{1};
 
+    /// Milliseconds commands waited between queCmd() and commandStart(),
+    /// all lanes combined. Recording is lock free, see util::Histogram.
+    util::Histogram _queueWaitHisto{"qdispQueueWaitMs"};
+
     friend std::ostream& operator<<(std::ostream& os, PriorityQueue const& pq);
 };
 
@@ -150,6 +205,12 @@ public:
         _pool->shutdownPool();
     }
 
+    /// @return current size and running count per priority lane.
+    std::vector<PriorityQueue::LaneStats> laneStats() const { return _prQueue->laneStats(); }
+
+    /// @return the queue-wait histogram shared by all lanes.
+    util::Histogram const& queueWaitHistogram() const { return _prQueue->queueWaitHistogram(); }
+
 private:
     /// The default priority queue is meant for pool control commands.
     PriorityQueue::Ptr _prQueue = std::make_shared<PriorityQueue>(100,1); // default (lowest) priority.
@@ -34,6 +34,7 @@
 #include "qdisp/QueryRequest.h"
 
 // System headers
+#include <chrono>
 #include <cstddef>
 #include <iostream>
 
@@ -42,8 +43,10 @@
 
 // Qserv headers
 #include "czar/Czar.h"
+#include "qdisp/ChunkLocationCache.h"
 #include "qdisp/JobStatus.h"
 #include "qdisp/ResponseHandler.h"
+#include "qdisp/WorkerHealthRegistry.h"
 #include "util/common.h"
 
 namespace {
@@ -56,7 +59,8 @@ namespace qdisp {
 
 
 // Run action() when the system expects to have time to accept data.
-class QueryRequest::AskForResponseDataCmd : public PriorityCommand {
+class QueryRequest::AskForResponseDataCmd : public PriorityCommand,
+                                            public util::CensusMember<AskForResponseDataCmd> {
 public:
     typedef std::shared_ptr<AskForResponseDataCmd> Ptr;
     enum class State { STARTED0, DATAREADY1, DONE2 };
@@ -160,18 +164,20 @@ private:
 
     int _blen{-1};
     bool _last{true};
-    util::InstanceCount _ic{"AskForResponseDataCmd"};
 };
 
 
 ////////////////////////////////////////////////////////////////////////
 // QueryRequest
 ////////////////////////////////////////////////////////////////////////
-QueryRequest::QueryRequest(JobQuery::Ptr const& jobQuery) :
+QueryRequest::QueryRequest(JobQuery::Ptr const& jobQuery, bool isHedge) :
   _jobQuery(jobQuery),
+  _isHedge(isHedge),
   _jobIdStr(jobQuery->getIdStr()),
   _qdispPool(_jobQuery->getQdispPool()){
-    LOGS(_log, LOG_LVL_DEBUG, _jobIdStr <<" New QueryRequest");
+    // A hedge must never spawn a retry of its own; the primary owns that.
+    if (_isHedge) _retried.store(true);
+    LOGS(_log, LOG_LVL_DEBUG, _jobIdStr <<" New QueryRequest" << (_isHedge ? " (hedge)" : ""));
 }
 
 QueryRequest::~QueryRequest() {
@@ -226,20 +232,50 @@ bool QueryRequest::ProcessResponse(XrdSsiErrInfo  const& eInfo, XrdSsiRespInfo c
         }
     }
     if (eInfo.hasError()) {
+        if (_isHedge) {
+            // A failing hedge is not an error of the job; the primary
+            // request is still racing for the response on another replica.
+            LOGS(_log, LOG_LVL_INFO, _jobIdStr << " hedge request failed quietly "
+                 << getSsiErr(eInfo, nullptr));
+            squashForHedge();
+            return true;
+        }
         std::ostringstream os;
         os << _jobIdStr << "ProcessResponse request failed "
            << getSsiErr(eInfo, nullptr);
         jq->getDescription()->respHandler()->errorFlush(os.str(), -1);
         jq->getStatus()->updateInfo(_jobIdStr, JobStatus::RESPONSE_ERROR);
+        // Charge the failure to the worker's health record (a no-op when
+        // the request failed before reaching any worker).
+        WorkerHealthRegistry::get().noteFailure(GetEndPoint());
         _errorFinish();
         return true;
     }
+
+    // A worker answered on this resource - prime the czar-wide location
+    // cache so later dispatches of the chunk can reuse the bound channel
+    // instead of paying another location lookup.
+    ChunkLocationCache::get().noteLocation(
+            jq->getDescription()->resource().path(), GetEndPoint());
+
+    // Feed the worker's health record with the time to first response; the
+    // Executive uses it to shape dispatch order and hedge earlier on
+    // degraded workers.
+    auto const sinceDispatch = std::chrono::steady_clock::now() - jq->getDispatchTime();
+    WorkerHealthRegistry::get().noteSuccess(
+            GetEndPoint(),
+            std::chrono::duration_cast<std::chrono::milliseconds>(sinceDispatch).count());
+
     switch(rInfo.rType) {
     case XrdSsiRespInfo::isNone: // All responses are non-null right now
         errorDesc += "Unexpected XrdSsiRespInfo.rType == isNone";
         break;
     case XrdSsiRespInfo::isData: // Local-only for Mock tests!
         if (std::string(rInfo.buff, rInfo.blen) == "MockResponse") {
+           if (!jq->claimResponse(this)) {
+               squashForHedge();
+               return true;
+           }
            jq->getStatus()->updateInfo(_jobIdStr, JobStatus::COMPLETE);
            _finish();
            return true;
@@ -247,6 +283,12 @@ bool QueryRequest::ProcessResponse(XrdSsiErrInfo  const& eInfo, XrdSsiRespInfo c
         errorDesc += "Unexpected XrdSsiRespInfo.rType == isData";
         break;
     case XrdSsiRespInfo::isError:
+        if (_isHedge) {
+            LOGS(_log, LOG_LVL_INFO, _jobIdStr << " hedge request error quietly eNum="
+                 << rInfo.eNum << " " << rInfo.eMsg);
+            squashForHedge();
+            return true;
+        }
         jq->getStatus()->updateInfo(_jobIdStr, JobStatus::RESPONSE_ERROR,
                                     rInfo.eNum, std::string(rInfo.eMsg));
         return _importError(std::string(rInfo.eMsg), rInfo.eNum);
@@ -254,6 +296,13 @@ bool QueryRequest::ProcessResponse(XrdSsiErrInfo  const& eInfo, XrdSsiRespInfo c
         errorDesc += "Unexpected XrdSsiRespInfo.rType == isFile";
         break;
     case XrdSsiRespInfo::isStream: // All remote requests
+        // Settle the race between the primary and hedge requests before
+        // anything touches the shared response handler.
+        if (!jq->claimResponse(this)) {
+            LOGS(_log, LOG_LVL_INFO, _jobIdStr << " lost response race, squashing self");
+            squashForHedge();
+            return true;
+        }
         jq->getStatus()->updateInfo(_jobIdStr, JobStatus::RESPONSE_READY);
         return _importStream(jq);
     default:
@@ -391,6 +440,11 @@ void QueryRequest::_processData(JobQuery::Ptr const& jq, int blen, bool last) {
                 LOGS(_log, LOG_LVL_WARN,
                      _jobIdStr << " Connection closed when more information expected sz=" << sz);
             }
+            // Merge the final result fragment before marking the job complete.
+            if (!jq->getDescription()->respHandler()->mergeFlushed()) {
+                _flushError(jq);
+                return;
+            }
             jq->getStatus()->updateInfo(_jobIdStr, JobStatus::COMPLETE);
             _finish();
             // At this point all blocks for this job have been read, there's no point in
@@ -400,20 +454,34 @@ void QueryRequest::_processData(JobQuery::Ptr const& jq, int blen, bool last) {
             _askForResponseDataCmd = std::make_shared<AskForResponseDataCmd>(shared_from_this(), jq);
             LOGS(_log, LOG_LVL_DEBUG, _jobIdStr << "queuing askForResponseDataCmd");
             _queueAskForResponse(_askForResponseDataCmd, jq);
+            // Now that the request for the next block is on its way to the
+            // worker, merge the fragment accepted by flush() above. The
+            // transfer of the next block and this merge run in parallel.
+            if (!jq->getDescription()->respHandler()->mergeFlushed()) {
+                _flushError(jq);
+                return;
+            }
         }
     } else {
-        LOGS(_log, LOG_LVL_DEBUG, _jobIdStr << " ProcessResponse data flush failed");
-        ResponseHandler::Error err = jq->getDescription()->respHandler()->getError();
-        jq->getStatus()->updateInfo(_jobIdStr, JobStatus::MERGE_ERROR, err.getCode(), err.getMsg());
-        // @todo DM-2378 Take a closer look at what causes this error and take
-        // appropriate action. There could be cases where this is recoverable.
-        _retried.store(true); // Do not retry
-        _errorFinish(true);
+        _flushError(jq);
     }
     return;
 }
 
 
+/// Handle a failure reported by the response handler while flushing or
+/// merging a result fragment.
+void QueryRequest::_flushError(JobQuery::Ptr const& jq) {
+    LOGS(_log, LOG_LVL_DEBUG, _jobIdStr << " ProcessResponse data flush failed");
+    ResponseHandler::Error err = jq->getDescription()->respHandler()->getError();
+    jq->getStatus()->updateInfo(_jobIdStr, JobStatus::MERGE_ERROR, err.getCode(), err.getMsg());
+    // @todo DM-2378 Take a closer look at what causes this error and take
+    // appropriate action. There could be cases where this is recoverable.
+    _retried.store(true); // Do not retry
+    _errorFinish(true);
+}
+
+
 /// @return true if QueryRequest cancelled successfully.
 bool QueryRequest::cancel() {
     LOGS(_log, LOG_LVL_DEBUG, _jobIdStr << " QueryRequest::cancel");
@@ -435,6 +503,18 @@ bool QueryRequest::cancel() {
 }
 
 
+/// Squash the losing side of a primary/hedge response race. The surviving
+/// request reports the job's outcome, so this path must neither flush an
+/// error to the response handler nor call MarkCompleteFunc, and it must not
+/// disturb the job status the winner is updating.
+void QueryRequest::squashForHedge() {
+    LOGS(_log, LOG_LVL_DEBUG, _jobIdStr << " QueryRequest::squashForHedge");
+    _hedgeSquash.store(true);
+    _retried.store(true); // Prevent retries.
+    _errorFinish(true);
+}
+
+
 /// @return true if this object's JobQuery, or its Executive has been cancelled.
 /// It takes time for the Executive to flag all jobs as being cancelled
 bool QueryRequest::isQueryCancelled() {
@@ -516,7 +596,7 @@ bool QueryRequest::_errorFinish(bool shouldCancel) {
             LOGS(_log, LOG_LVL_DEBUG, _jobIdStr << "errorFinish retry failed");
             _callMarkComplete(false);
         }
-    } else {
+    } else if (!_hedgeSquash) {
         _callMarkComplete(false);
     }
     cleanup(); // Reset smart pointers so this object can be deleted.
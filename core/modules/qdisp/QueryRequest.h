@@ -39,6 +39,7 @@
 #include "czar/Czar.h"
 #include "qdisp/JobQuery.h"
 #include "qdisp/QdispPool.h"
+#include "util/ObjectCensus.h"
 
 namespace lsst {
 namespace qserv {
@@ -92,12 +93,16 @@ public:
 /// cancellation function with its client that maintains a pointer to the
 /// QueryRequest. After Finished(), the cancellation function must be prevented
 /// from accessing the QueryRequest instance.
-class QueryRequest : public XrdSsiRequest, public std::enable_shared_from_this<QueryRequest> {
+class QueryRequest : public XrdSsiRequest, public std::enable_shared_from_this<QueryRequest>,
+                     public util::CensusMember<QueryRequest> {
 public:
     typedef std::shared_ptr<QueryRequest> Ptr;
 
-    static Ptr create(std::shared_ptr<JobQuery> const& jobQuery) {
-        Ptr newQueryRequest(new QueryRequest(jobQuery));
+    /// @param isHedge true for a duplicate request dispatched to another
+    ///        replica of a straggler job; hedges never retry and lose the
+    ///        response race quietly (see JobQuery::claimResponse()).
+    static Ptr create(std::shared_ptr<JobQuery> const& jobQuery, bool isHedge=false) {
+        Ptr newQueryRequest(new QueryRequest(jobQuery, isHedge));
         return newQueryRequest;
     }
 
@@ -125,6 +130,12 @@ public:
     bool isQueryCancelled();
     bool isQueryRequestCancelled();
     void doNotRetry() { _retried.store(true); }
+
+    /// Squash this request because the other side of a primary/hedge pair
+    /// won the response race (or the pair is being torn down). Unlike
+    /// cancel(), nothing is reported to the response handler or the
+    /// Executive; the surviving request speaks for the job.
+    void squashForHedge();
     std::string getSsiErr(XrdSsiErrInfo const& eInfo, int* eCode);
     void cleanup(); ///< Must be called when this object is no longer needed.
 
@@ -133,7 +144,7 @@ public:
     friend std::ostream& operator<<(std::ostream& os, QueryRequest const& r);
 private:
     // Private constructor to safeguard enable_shared_from_this construction.
-    QueryRequest(std::shared_ptr<JobQuery> const& jobQuery);
+    QueryRequest(std::shared_ptr<JobQuery> const& jobQuery, bool isHedge);
 
     void _callMarkComplete(bool success);
     bool _importStream(JobQuery::Ptr const& jq);
@@ -141,6 +152,7 @@ private:
     bool _errorFinish(bool shouldCancel=false);
     void _finish();
     void _processData(JobQuery::Ptr const& jq, int blen, bool last);
+    void _flushError(JobQuery::Ptr const& jq);
     void _queueAskForResponse(std::shared_ptr<AskForResponseDataCmd> const& cmd, JobQuery::Ptr const& jq);
 
     /// _holdState indicates the data is being held by SSI for a large response using LargeResultMgr.
@@ -155,8 +167,11 @@ private:
     /// as needed. If (_finishStatus == ACTIVE) _jobQuery should be good.
     std::shared_ptr<JobQuery> _jobQuery;
 
-    std::atomic<bool> _retried {false}; ///< Protect against multiple retries of _jobQuery from a 
+    bool const _isHedge; ///< True for the duplicate request of a hedged straggler job.
+
+    std::atomic<bool> _retried {false}; ///< Protect against multiple retries of _jobQuery from a
                                         /// single QueryRequest.
+    std::atomic<bool> _hedgeSquash {false}; ///< Lost the primary/hedge response race; finish silently.
     std::atomic<bool> _calledMarkComplete {false}; ///< Protect against multiple calls to MarkCompleteFunc
                                                    /// from a single QueryRequest.
 
@@ -166,7 +181,6 @@ private:
 
     std::shared_ptr<QueryRequest> _keepAlive; ///< Used to keep this object alive during race condition.
     std::string _jobIdStr {QueryIdHelper::makeIdStr(0, 0, true)}; ///< for debugging only.
-    util::InstanceCount _instC{"QueryRequest"};
 
     std::atomic<bool> _finishedCalled{false};
 
@@ -67,6 +67,14 @@ public:
     /// @return true if successful (no error)
     virtual bool flush(int bLen, bool& last, bool& largeResult) = 0;
 
+    /// Merge the result fragment accepted by the preceding call to flush()
+    /// into the result table. The merge is separated from flush() so that
+    /// the caller may ask the worker for the next block of the stream before
+    /// merging this one, which lets the transfer of the next block and the
+    /// (comparatively slow) merge proceed in parallel.
+    /// @return true if successful (no error)
+    virtual bool mergeFlushed() { return true; }
+
     /// Signal an unrecoverable error condition. No further calls are expected.
     virtual void errorFlush(std::string const& msg, int code) = 0;
 
@@ -0,0 +1,127 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "qdisp/WorkerHealthRegistry.h"
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.qdisp.WorkerHealthRegistry");
+
+// Weight of each new sample in the moving averages. At 0.1 a worker's
+// figures reflect roughly its last couple dozen requests, fast enough to
+// spot a worker going bad mid-scan but slow enough that one hiccup does
+// not reorder dispatch.
+double const ewmaAlpha = 0.1;
+
+// How strongly the failure-rate EWMA weighs into the score: at 10.0 a
+// steady 10% failure rate alone scores a nominal-latency worker at 2.0.
+double const failurePenalty = 10.0;
+
+// Score at and above which a worker counts as degraded: twice the fleet
+// mean response time, a steady 10% failure rate, or a mixture of both.
+double const degradedScore = 2.0;
+
+} // anonymous namespace
+
+namespace lsst {
+namespace qserv {
+namespace qdisp {
+
+WorkerHealthRegistry& WorkerHealthRegistry::get() {
+    static WorkerHealthRegistry instance;
+    return instance;
+}
+
+void WorkerHealthRegistry::noteSuccess(std::string const& worker, double latencyMs) {
+    if (worker.empty()) return;
+    std::lock_guard<std::mutex> lock(_mtx);
+    Entry& entry = _workers[worker];
+    if (entry.seeded) {
+        entry.latencyMs += ewmaAlpha * (latencyMs - entry.latencyMs);
+    } else {
+        entry.latencyMs = latencyMs;
+        entry.seeded = true;
+    }
+    entry.failureRate *= 1.0 - ewmaAlpha;
+}
+
+void WorkerHealthRegistry::noteFailure(std::string const& worker) {
+    if (worker.empty()) return;
+    std::lock_guard<std::mutex> lock(_mtx);
+    Entry& entry = _workers[worker];
+    entry.failureRate += ewmaAlpha * (1.0 - entry.failureRate);
+    LOGS(_log, LOG_LVL_DEBUG, "worker=" << worker << " failureRate="
+         << entry.failureRate);
+}
+
+double WorkerHealthRegistry::score(std::string const& worker) {
+    if (worker.empty()) return 1.0;
+    std::lock_guard<std::mutex> lock(_mtx);
+    auto iter = _workers.find(worker);
+    if (iter == _workers.end()) return 1.0;
+    return _score(iter->second, _fleetLatencyMs());
+}
+
+bool WorkerHealthRegistry::isDegraded(std::string const& worker) {
+    return score(worker) >= degradedScore;
+}
+
+std::map<std::string, WorkerHealthRegistry::Health> WorkerHealthRegistry::snapshot() {
+    std::map<std::string, Health> result;
+    std::lock_guard<std::mutex> lock(_mtx);
+    double const fleet = _fleetLatencyMs();
+    for (auto const& entry : _workers) {
+        result[entry.first] = Health{entry.second.latencyMs, entry.second.failureRate,
+                                     _score(entry.second, fleet)};
+    }
+    return result;
+}
+
+void WorkerHealthRegistry::reset() {
+    std::lock_guard<std::mutex> lock(_mtx);
+    _workers.clear();
+}
+
+double WorkerHealthRegistry::_fleetLatencyMs() const {
+    double sum = 0.0;
+    int count = 0;
+    for (auto const& entry : _workers) {
+        if (entry.second.seeded) {
+            sum += entry.second.latencyMs;
+            ++count;
+        }
+    }
+    return count == 0 ? 0.0 : sum / count;
+}
+
+double WorkerHealthRegistry::_score(Entry const& entry, double fleetLatencyMs) const {
+    double const relativeLatency = (entry.seeded and fleetLatencyMs > 0.0)
+            ? entry.latencyMs / fleetLatencyMs : 1.0;
+    return relativeLatency + failurePenalty * entry.failureRate;
+}
+
+}}} // namespace lsst::qserv::qdisp
@@ -0,0 +1,110 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_QDISP_WORKERHEALTHREGISTRY_H
+#define LSST_QSERV_QDISP_WORKERHEALTHREGISTRY_H
+
+// System headers
+#include <map>
+#include <mutex>
+#include <string>
+
+namespace lsst {
+namespace qserv {
+namespace qdisp {
+
+/// A czar-wide registry of per-worker health, fed by QueryRequest with the
+/// time to first response and the failures of every request. A worker with
+/// a failing disk or a throttled CPU otherwise looks like any other until
+/// its jobs run into the straggler timeouts, by which point every scan's
+/// tail is stretched by it. Each worker's response time and failure rate
+/// are tracked as exponentially weighted moving averages and folded into a
+/// single score (1.0 is nominal, larger is worse); the Executive uses the
+/// score to start jobs headed for degraded workers last and to hedge their
+/// stragglers earlier, and the czar exports the scores via metrics.
+///
+/// All methods are thread safe.
+class WorkerHealthRegistry {
+public:
+
+    /// The per-worker health figures, see snapshot().
+    struct Health {
+        double latencyMs;    ///< EWMA of time from dispatch to first response
+        double failureRate;  ///< EWMA of the failure indicator (0..1)
+        double score;        ///< combined score, see score()
+    };
+
+    /// @return the czar-wide instance
+    static WorkerHealthRegistry& get();
+
+    WorkerHealthRegistry(WorkerHealthRegistry const&) = delete;
+    WorkerHealthRegistry& operator=(WorkerHealthRegistry const&) = delete;
+
+    /// Record a successful response from a worker and the milliseconds from
+    /// dispatch to its arrival. An empty worker name is ignored.
+    void noteSuccess(std::string const& worker, double latencyMs);
+
+    /// Record a failed request to a worker. An empty worker name is ignored
+    /// (a request that failed before reaching any worker says nothing about
+    /// one worker's health).
+    void noteFailure(std::string const& worker);
+
+    /// @return the worker's health score: the ratio of its response-time
+    /// EWMA to the fleet-wide mean, plus a penalty for its failure rate.
+    /// 1.0 is nominal, larger is worse; an unknown or empty worker name
+    /// scores nominal.
+    double score(std::string const& worker);
+
+    /// @return true if the worker's score is past the degraded threshold,
+    /// i.e. roughly twice as slow as the fleet or failing steadily.
+    bool isDegraded(std::string const& worker);
+
+    /// @return the health of every tracked worker, for metrics export.
+    std::map<std::string, Health> snapshot();
+
+    /// Drop all tracked workers. For testing only.
+    void reset();
+
+private:
+
+    WorkerHealthRegistry() = default;
+
+    /// One tracked worker
+    struct Entry {
+        double latencyMs = 0.0;   ///< response-time EWMA, seeded by first sample
+        double failureRate = 0.0; ///< failure-indicator EWMA
+        bool seeded = false;      ///< true once a first latency sample arrived
+    };
+
+    /// @return the mean of the seeded response-time EWMAs. _mtx must be held.
+    double _fleetLatencyMs() const;
+
+    /// @return the score of an entry against the fleet mean. _mtx must be held.
+    double _score(Entry const& entry, double fleetLatencyMs) const;
+
+    mutable std::mutex _mtx;              ///< Guards _workers
+    std::map<std::string, Entry> _workers;
+};
+
+}}} // namespace lsst::qserv::qdisp
+
+#endif // LSST_QSERV_QDISP_WORKERHEALTHREGISTRY_H
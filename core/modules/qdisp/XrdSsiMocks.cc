@@ -24,10 +24,13 @@
  */
 
 // System headers
+#include <algorithm>
 #include <atomic>
+#include <chrono>
 #include <cstddef>
 #include <errno.h>
 #include <mutex>
+#include <random>
 #include <string>
 #include <stdlib.h>
 #include <thread>
@@ -65,6 +68,29 @@ std::atomic<int> totCount(0);
 
 bool _aOK = true;
 
+// Synthetic worker behavior for benchmark runs, all zero (disabled) for
+// the unit tests. Latency is drawn uniformly per request, bandwidth
+// shaping adds a delay per stream block proportional to its size.
+std::atomic<int> _latencyMinMs(0);
+std::atomic<int> _latencyMaxMs(0);
+std::atomic<int> _bandwidthKBps(0);
+
+void _latencySleep() {
+    int const hi = _latencyMaxMs.load();
+    if (hi <= 0) return;
+    int const lo = _latencyMinMs.load();
+    thread_local std::mt19937 rng(std::random_device{}());
+    std::uniform_int_distribution<int> dist(lo, hi);
+    std::this_thread::sleep_for(std::chrono::milliseconds(dist(rng)));
+}
+
+void _bandwidthSleep(int bytes) {
+    int const kbps = _bandwidthKBps.load();
+    if (kbps <= 0 || bytes <= 0) return;
+    std::this_thread::sleep_for(
+        std::chrono::microseconds(static_cast<int64_t>(bytes) * 1000 / kbps));
+}
+
 enum RespType {RESP_BADREQ, RESP_DATA, RESP_ERROR, RESP_ERRNR,
                RESP_STREAM, RESP_STRERR};
 
@@ -92,6 +118,7 @@ public:
 
     void Reply(RespType rType) {
         _go.wait(true);
+        _latencySleep();
 
         // We may have been cancelled before being able to reply
         //
@@ -196,6 +223,7 @@ private:
             last = true;
             eP->Set("Mock stream error!", 17);
         } else {
+            _bandwidthSleep(std::min(blen, _bLen));
             if (_bLen <= blen) {
                 memcpy(buff, _msgBuf.data()+_bOff, _bLen);
                 blen = _bLen; _bLen = 0;
@@ -248,6 +276,13 @@ void XrdSsiServiceMock::Reset() {
 
 void XrdSsiServiceMock::setGo(bool go) {_go.exchangeNotify(go);}
 
+void XrdSsiServiceMock::setLatency(int minMs, int maxMs) {
+    _latencyMinMs = minMs;
+    _latencyMaxMs = maxMs;
+}
+
+void XrdSsiServiceMock::setBandwidthKBps(int kbps) {_bandwidthKBps = kbps;}
+
 void XrdSsiServiceMock::ProcessRequest(XrdSsiRequest  &reqRef,
                                        XrdSsiResource &resRef) {
     static struct {const char *cmd; RespType rType;} reqTab[] = {
@@ -64,6 +64,15 @@ public:
 
     static void setGo(bool go);
 
+    /// Make every mock worker sleep a uniform random time in [minMs, maxMs]
+    /// before replying, zero to disable (the default). Used by the dispatch
+    /// benchmark to model worker latency distributions.
+    static void setLatency(int minMs, int maxMs);
+
+    /// Throttle mock stream blocks to roughly the given KB/s per request,
+    /// zero to disable (the default).
+    static void setBandwidthKBps(int kbps);
+
     static void setRName(std::string const& rname) {_myRName = rname;}
 
 private:
@@ -36,10 +36,12 @@
 #include "ccontrol/MergingHandler.h"
 #include "global/ResourceUnit.h"
 #include "global/MsgReceiver.h"
+#include "qdisp/ChunkLocationCache.h"
 #include "qdisp/Executive.h"
 #include "qdisp/JobQuery.h"
 #include "qdisp/MessageStore.h"
 #include "qdisp/QueryRequest.h"
+#include "qdisp/WorkerHealthRegistry.h"
 #include "qdisp/XrdSsiMocks.h"
 #include "qproc/ChunkQuerySpec.h"
 #include "qproc/TaskMsgFactory.h"
@@ -278,9 +280,102 @@ BOOST_AUTO_TEST_CASE(MessageStore) {
     BOOST_CHECK(ms.messageCount(-12) == 2);
     qdisp::QueryMessage qm = ms.getMessage(1);
     BOOST_CHECK(qm.chunkId == 124 && qm.code == -12 && str.compare(qm.description) == 0);
+    // A run of identical messages coalesces into one stored message with a
+    // repeat count rather than one message per job.
+    ms.addMessage(87, 2, "done");
+    ms.addMessage(88, 2, "done");
+    ms.addMessage(89, 2, "done");
+    BOOST_CHECK(ms.messageCount() == 4);
+    BOOST_CHECK(ms.messageCount(2) == 3);
+    qdisp::QueryMessage qmc = ms.getMessage(3);
+    BOOST_CHECK(qmc.code == 2 && qmc.description == "done [3 times]");
     LOGS_DEBUG("MessageStore test end");
 }
 
+BOOST_AUTO_TEST_CASE(ChunkLocationCache) {
+    LOGS_DEBUG("ChunkLocationCache test start");
+    qdisp::ChunkLocationCache& cache = qdisp::ChunkLocationCache::get();
+    cache.invalidateAll();
+
+    // Unknown resources miss, recorded ones hit
+    BOOST_CHECK(cache.lookup("/chk/LSST/100") == "");
+    cache.noteLocation("/chk/LSST/100", "worker-1:1094");
+    cache.noteLocation("/chk/LSST/200", "worker-2:1094");
+    cache.noteLocation("/chk/WISE/100", "worker-3:1094");
+    BOOST_CHECK(cache.lookup("/chk/LSST/100") == "worker-1:1094");
+    BOOST_CHECK(cache.lookup("/chk/WISE/100") == "worker-3:1094");
+
+    // Empty endpoints are not worth remembering
+    cache.noteLocation("/chk/LSST/300", "");
+    BOOST_CHECK(cache.lookup("/chk/LSST/300") == "");
+
+    // A database-scoped invalidation only drops that database's chunks
+    cache.invalidateDb("LSST");
+    BOOST_CHECK(cache.lookup("/chk/LSST/100") == "");
+    BOOST_CHECK(cache.lookup("/chk/LSST/200") == "");
+    BOOST_CHECK(cache.lookup("/chk/WISE/100") == "worker-3:1094");
+
+    // A TTL of zero expires entries immediately
+    cache.setTtlSecs(0);
+    cache.noteLocation("/chk/WISE/200", "worker-4:1094");
+    BOOST_CHECK(cache.lookup("/chk/WISE/200") == "");
+    cache.setTtlSecs(300);
+
+    cache.invalidateAll();
+    BOOST_CHECK(cache.lookup("/chk/WISE/100") == "");
+    LOGS_DEBUG("ChunkLocationCache test end");
+}
+
+BOOST_AUTO_TEST_CASE(WorkerHealthRegistry) {
+    LOGS_DEBUG("WorkerHealthRegistry test start");
+    qdisp::WorkerHealthRegistry& registry = qdisp::WorkerHealthRegistry::get();
+    registry.reset();
+
+    // Unknown workers score nominal
+    BOOST_CHECK_EQUAL(registry.score("worker-1:1094"), 1.0);
+    BOOST_CHECK_EQUAL(registry.score(""), 1.0);
+
+    // Two workers at equal latency both score nominal
+    for (int i = 0; i < 50; ++i) {
+        registry.noteSuccess("worker-1:1094", 100.0);
+        registry.noteSuccess("worker-2:1094", 100.0);
+    }
+    BOOST_CHECK_CLOSE(registry.score("worker-1:1094"), 1.0, 1.0);
+    BOOST_CHECK(not registry.isDegraded("worker-1:1094"));
+
+    // A worker far slower than the fleet becomes degraded
+    for (int i = 0; i < 50; ++i) {
+        registry.noteSuccess("worker-3:1094", 1000.0);
+    }
+    BOOST_CHECK(registry.isDegraded("worker-3:1094"));
+    BOOST_CHECK(registry.score("worker-3:1094") > registry.score("worker-1:1094"));
+    BOOST_CHECK(not registry.isDegraded("worker-1:1094"));
+
+    // Steady failures degrade a worker even at nominal latency, and
+    // successes work the failure rate back down
+    for (int i = 0; i < 20; ++i) {
+        registry.noteFailure("worker-2:1094");
+    }
+    BOOST_CHECK(registry.isDegraded("worker-2:1094"));
+    for (int i = 0; i < 100; ++i) {
+        registry.noteSuccess("worker-2:1094", 100.0);
+    }
+    BOOST_CHECK(not registry.isDegraded("worker-2:1094"));
+
+    // Failures with no worker attached are ignored
+    registry.noteFailure("");
+
+    // The snapshot reports every tracked worker for metrics export
+    auto health = registry.snapshot();
+    BOOST_CHECK_EQUAL(health.size(), 3U);
+    BOOST_CHECK(health["worker-3:1094"].score > health["worker-1:1094"].score);
+    BOOST_CHECK_CLOSE(health["worker-3:1094"].latencyMs, 1000.0, 1.0);
+
+    registry.reset();
+    BOOST_CHECK(registry.snapshot().empty());
+    LOGS_DEBUG("WorkerHealthRegistry test end");
+}
+
 BOOST_AUTO_TEST_CASE(QueryRequest) {
     {
         LOGS_DEBUG("QueryRequest error retry test");
@@ -23,40 +23,134 @@
 // Class-header
 #include "qhttp/AjaxEndpoint.h"
 
+// System headers
+#include <cstdlib>
+
 // Local headers
 #include "qhttp/Request.h"
 #include "qhttp/Response.h"
 #include "qhttp/Server.h"
 
+namespace {
+
+std::size_t const defaultDeltaLogSize = 64;
+
+} // anon. namespace
+
 namespace lsst {
 namespace qserv {
 namespace qhttp {
 
 
-AjaxEndpoint::AjaxEndpoint()
+AjaxEndpoint::AjaxEndpoint(std::size_t deltaLogSize)
+:
+    _deltaLogSize(deltaLogSize)
 {
 }
 
 
 AjaxEndpoint::Ptr AjaxEndpoint::add(Server& server, std::string const& path)
 {
-    auto aep = std::shared_ptr<AjaxEndpoint>(new AjaxEndpoint);
+    return add(server, path, ::defaultDeltaLogSize);
+}
+
+
+AjaxEndpoint::Ptr AjaxEndpoint::add(Server& server, std::string const& path, std::size_t deltaLogSize)
+{
+    auto aep = std::shared_ptr<AjaxEndpoint>(new AjaxEndpoint(deltaLogSize));
     server.addHandler("GET", path, [aep](Request::Ptr request, Response::Ptr response) {
         std::lock_guard<std::mutex> lock{aep->_pendingResponsesMutex};
-        aep->_pendingResponses.push_back(response);
+
+        // Clients which do not present a last-seen version get the original behavior: the full
+        // payload of the next update, unwrapped
+        auto const sinceQuery = request->query.find("since");
+        if (sinceQuery == request->query.end()) {
+            aep->_pendingResponses.push_back(response);
+            return;
+        }
+
+        std::uint64_t const since = std::strtoull(sinceQuery->second.c_str(), nullptr, 10);
+        if ((aep->_version == 0) || (since == aep->_version)) {
+            // Nothing published yet, or the client is current -- park until the next update
+            aep->_pendingVersioned.push_back(std::make_pair(response, since));
+        } else if ((since < aep->_version) && (aep->_version - since <= aep->_deltaLog.size())) {
+            // The client is behind, and everything it missed is still in the delta log
+            aep->_respondDeltas(response, since);
+        } else {
+            // The client is behind the bounded delta log, or claims a version from the future
+            // (e.g. across an endpoint restart) -- resynchronize with the full payload
+            aep->_respondFull(response);
+        }
     });
     return aep;
 }
 
 
 void AjaxEndpoint::update(std::string const& json)
+{
+    _update(json, nullptr);
+}
+
+
+void AjaxEndpoint::update(std::string const& json, std::string const& delta)
+{
+    _update(json, &delta);
+}
+
+
+void AjaxEndpoint::_update(std::string const& json, std::string const* delta)
 {
     std::lock_guard<std::mutex> lock(_pendingResponsesMutex);
+
+    ++_version;
+    _currentJson = json;
+    if (delta == nullptr) {
+        // No delta was provided for this transition, so previously logged deltas no longer chain up
+        // to the current payload; versioned clients will be resynchronized with the full payload
+        _deltaLog.clear();
+    } else {
+        _deltaLog.push_back(*delta);
+        if (_deltaLog.size() > _deltaLogSize) _deltaLog.pop_front();
+    }
+
     for(auto& pendingResponse : _pendingResponses) {
         pendingResponse->headers["Cache-Control"] = "no-cache";
         pendingResponse->send(json, "application/json");
     }
     _pendingResponses.clear();
+
+    for(auto& pendingVersioned : _pendingVersioned) {
+        std::uint64_t const since = pendingVersioned.second;
+        if ((since < _version) && (_version - since <= _deltaLog.size())) {
+            _respondDeltas(pendingVersioned.first, since);
+        } else {
+            _respondFull(pendingVersioned.first);
+        }
+    }
+    _pendingVersioned.clear();
+}
+
+
+void AjaxEndpoint::_respondDeltas(Response::Ptr const& response, std::uint64_t since)
+{
+    std::string body = "{\"version\":" + std::to_string(_version) + ",\"deltas\":[";
+    auto const first = _deltaLog.end() - (_version - since);
+    for(auto i = first; i != _deltaLog.end(); ++i) {
+        if (i != first) body += ",";
+        body += *i;
+    }
+    body += "]}";
+    response->headers["Cache-Control"] = "no-cache";
+    response->send(body, "application/json");
+}
+
+
+void AjaxEndpoint::_respondFull(Response::Ptr const& response)
+{
+    std::string body = "{\"version\":" + std::to_string(_version) + ",\"full\":" + _currentJson + "}";
+    response->headers["Cache-Control"] = "no-cache";
+    response->send(body, "application/json");
 }
 
+
 }}} // namespace lsst::qserv::qhttp
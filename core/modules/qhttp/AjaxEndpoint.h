@@ -24,9 +24,12 @@
 #define LSST_QSERV_QHTTP_AJAXENDPOINT_H
 
 // System headers
+#include <cstdint>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <utility>
 #include <vector>
 
 // Local headers
@@ -52,16 +55,50 @@ public:
     //      application/json, and the pending request list is cleared.  Note that the update() method is
     //      thread-safe.  Note also that the Server::addAjaxEndpoint() convenience method would typically be
     //      called in preference to calling the add() method here directly.
+    //
+    //----- Versioned delta updates.  Updates are numbered from 1, and the two-argument update() overload
+    //      additionally provides a delta payload describing just the change from the previous update;
+    //      the endpoint retains up to deltaLogSize of the most recent deltas.  A client which passes its
+    //      last-seen version as a "since" query parameter is answered from that log with an envelope
+    //
+    //          {"version":<current>,"deltas":[<delta>,...]}
+    //
+    //      containing only the deltas it missed -- immediately if it is behind, or on the next update()
+    //      if it is current.  If the missed deltas have aged out of the log (or an update arrived via the
+    //      one-argument overload, which provides no delta), the endpoint falls back to an envelope with
+    //      the full payload instead:
+    //
+    //          {"version":<current>,"full":<payload>}
+    //
+    //      Delta payloads are opaque to the endpoint; their format is a contract between the update()
+    //      caller and its clients.  Clients which do not pass "since" retain the original behavior: the
+    //      next update's full payload, unwrapped.
 
     static Ptr add(Server& server, std::string const& path);
+    static Ptr add(Server& server, std::string const& path, std::size_t deltaLogSize);
+
     void update(std::string const& json); // thread-safe
+    void update(std::string const& json, std::string const& delta); // thread-safe
 
 private:
 
-    AjaxEndpoint();
+    explicit AjaxEndpoint(std::size_t deltaLogSize);
+
+    void _update(std::string const& json, std::string const* delta);
+
+    //----- Response builders for versioned clients; callers must hold _pendingResponsesMutex
+
+    void _respondDeltas(Response::Ptr const& response, std::uint64_t since);
+    void _respondFull(Response::Ptr const& response);
 
     std::vector<Response::Ptr> _pendingResponses;
-    std::mutex _pendingResponsesMutex;
+    std::vector<std::pair<Response::Ptr, std::uint64_t>> _pendingVersioned; // response, "since" version
+    std::mutex _pendingResponsesMutex; // guards all mutable state below as well
+
+    std::uint64_t _version = 0;        // version of the most recent update, 0 = no update yet
+    std::string _currentJson;          // payload of the most recent update
+    std::deque<std::string> _deltaLog; // most recent deltas, oldest first
+    std::size_t const _deltaLogSize;   // upper bound on _deltaLog
 
 };
 
@@ -0,0 +1,126 @@
+/*
+ * LSST Data Management System
+ * Copyright 2018 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class-header
+#include "qhttp/MetricsServer.h"
+
+// System headers
+#include <sstream>
+
+// Local headers
+#include "qhttp/Request.h"
+#include "qhttp/Response.h"
+
+namespace lsst {
+namespace qserv {
+namespace qhttp {
+
+
+MetricsServer::MetricsServer(unsigned short port)
+{
+    _server = Server::create(_ioService, port);
+}
+
+
+MetricsServer::~MetricsServer()
+{
+    stop();
+}
+
+
+MetricsServer::Ptr MetricsServer::create(unsigned short port)
+{
+    return Ptr(new MetricsServer(port));
+}
+
+
+void MetricsServer::addSource(Source const& source)
+{
+    _sources.push_back(source);
+}
+
+
+void MetricsServer::addHandler(std::string const& method, std::string const& pattern,
+                               Server::Handler handler)
+{
+    _server->addHandler(method, pattern, handler);
+}
+
+
+void MetricsServer::start()
+{
+    auto self = shared_from_this();
+    _server->addHandler("GET", "/metrics", [self](Request::Ptr request, Response::Ptr response) {
+        self->_handleScrape(request, response);
+    });
+    _server->accept();
+    _thread = std::thread([self]() {
+        self->_ioService.run();
+    });
+    _started = true;
+}
+
+
+void MetricsServer::stop()
+{
+    if (!_started) return;
+    _started = false;
+    _ioService.stop();
+    _thread.join();
+}
+
+
+unsigned short MetricsServer::getPort()
+{
+    return _server->getPort();
+}
+
+
+void MetricsServer::_handleScrape(Request::Ptr request, Response::Ptr response)
+{
+    std::ostringstream os;
+    for(auto& source : _sources) {
+        source(os);
+    }
+    response->headers["Cache-Control"] = "no-cache";
+    response->send(os.str(), "text/plain; version=0.0.4");
+}
+
+
+void MetricsServer::writeMetric(std::ostream& os, std::string const& name,
+                                std::string const& labels, uint64_t value)
+{
+    os << name;
+    if (!labels.empty()) os << "{" << labels << "}";
+    os << " " << value << "\n";
+}
+
+
+void MetricsServer::writeMetric(std::ostream& os, std::string const& name,
+                                std::string const& labels, double value)
+{
+    os << name;
+    if (!labels.empty()) os << "{" << labels << "}";
+    os << " " << value << "\n";
+}
+
+}}} // namespace lsst::qserv::qhttp
@@ -0,0 +1,109 @@
+/*
+ * LSST Data Management System
+ * Copyright 2018 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#ifndef LSST_QSERV_QHTTP_METRICSSERVER_H
+#define LSST_QSERV_QHTTP_METRICSSERVER_H
+
+// System headers
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Third-party headers
+#include "boost/asio.hpp"
+
+// Local headers
+#include "qhttp/Server.h"
+
+namespace lsst {
+namespace qserv {
+namespace qhttp {
+
+class MetricsServer : public std::enable_shared_from_this<MetricsServer>
+{
+public:
+
+    using Ptr = std::shared_ptr<MetricsServer>;
+
+    //----- MetricsServer is a self-contained qhttp::Server serving a GET /metrics endpoint in the
+    //      Prometheus text exposition format, for embedding in processes that otherwise have no HTTP
+    //      surface.  It owns a private asio::io_service run by a single internal thread, so the hosting
+    //      process only creates it, registers Sources, and calls start().
+    //
+    //      A Source is a callable that appends zero or more complete exposition-format lines to the
+    //      provided stream.  Sources are invoked once per scrape, on the server thread; they must be
+    //      safe to call concurrently with the process hot paths, which in practice means reading atomic
+    //      counters or pre-merged snapshots rather than taking locks those paths contend on.  All Sources
+    //      must be registered before start() is called.
+
+    using Source = std::function<void(std::ostream&)>;
+
+    static Ptr create(unsigned short port);
+
+    void addSource(Source const& source); // must be called before start()
+
+    //----- addHandler() installs an additional handler on the embedded server, for hosting processes
+    //      that want to expose ad hoc diagnostic endpoints (e.g. a flight-recorder dump) next to
+    //      /metrics without running a second server.  Must be called before start().
+
+    void addHandler(std::string const& method, std::string const& pattern, Server::Handler handler);
+
+    void start();
+    void stop(); // idempotent; also called by the destructor
+
+    unsigned short getPort(); // valid after start(); useful when created with port 0
+
+    ~MetricsServer();
+
+    //----- writeMetric() appends one exposition-format sample line: name, an optional comma-separated
+    //      label list without the enclosing braces (e.g. R"(scheduler="SchedFast")"), and the value.
+
+    static void writeMetric(std::ostream& os, std::string const& name,
+                            std::string const& labels, uint64_t value);
+    static void writeMetric(std::ostream& os, std::string const& name,
+                            std::string const& labels, double value);
+
+private:
+
+    MetricsServer(MetricsServer const&) = delete;
+    MetricsServer& operator=(MetricsServer const&) = delete;
+
+    explicit MetricsServer(unsigned short port);
+
+    void _handleScrape(Request::Ptr request, Response::Ptr response);
+
+    boost::asio::io_service _ioService;
+    Server::Ptr _server;
+    std::thread _thread;
+    bool _started = false;
+
+    std::vector<Source> _sources;
+
+};
+
+}}} // namespace lsst::qserv::qhttp
+
+#endif // LSST_QSERV_QHTTP_METRICSSERVER_H
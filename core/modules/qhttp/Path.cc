@@ -87,6 +87,10 @@ void Path::parse(std::string const& pattern)
     std::string path;
     std::vector<boost::variant<PathToken, std::string>> segments;
 
+    // Assume the pattern is trivial (see Path.h) until a construct below proves otherwise; patterns
+    // not rooted at "/" or with a trailing "/" have delimiter subtleties the trie does not model.
+    bool isTrivial = !pattern.empty() && pattern.front() == '/' && pattern.back() != '/';
+
     auto end = boost::sregex_iterator{};
     auto last = pattern.begin();
     for(auto i=boost::make_regex_iterator(pattern, patternRe); i!=end; ++i) {
@@ -103,6 +107,13 @@ void Path::parse(std::string const& pattern)
         // Grab stuff between last match and this
         path.append(i->prefix());
 
+        // Only a plain ":name" parameter occupying a whole path element keeps the pattern trivial
+        if (escaped.matched || capture.matched || group.matched || suffix.matched || asterisk.matched
+            || !prefix.matched)
+        {
+            isTrivial = false;
+        }
+
         // Handle explicitly escaped characters
         if (escaped.matched) {
 
@@ -181,6 +192,24 @@ void Path::parse(std::string const& pattern)
     }
     route += R"((?:\/(?=$))?$)";
     regex = route;
+
+    // For trivial patterns, derive the segment list straight from the pattern string: triviality
+    // guarantees it is nothing but "/"-delimited literals and plain ":name" parameters.
+    trivial = isTrivial;
+    if (trivial) {
+        std::string::size_type pos = 1;
+        while (pos <= pattern.size()) {
+            auto slash = pattern.find('/', pos);
+            if (slash == std::string::npos) slash = pattern.size();
+            std::string part = pattern.substr(pos, slash - pos);
+            if ((part.size() > 1) && (part.front() == ':')) {
+                this->segments.push_back({true, part.substr(1)});
+            } else {
+                this->segments.push_back({false, std::move(part)});
+            }
+            pos = slash + 1;
+        }
+    }
 }
 
 
@@ -54,6 +54,22 @@ public:
     boost::regex regex;
     std::vector<std::string> paramNames;
 
+    //----- When a pattern is built from nothing but literal segments and plain ":name" parameters (the
+    //      overwhelmingly common case in REST APIs), parse() additionally records the segment list below
+    //      and sets trivial, and the Server dispatches the route through a prefix trie (see PathTrie)
+    //      instead of the compiled regex.  Patterns using any further path-to-regexp syntax (custom
+    //      captures, optional/repeated suffixes, wildcards, escapes, trailing slashes) leave trivial
+    //      false and are matched against the compiled regex as before.
+
+    struct Segment
+    {
+        bool isParam;       // true for a ":name" parameter segment
+        std::string value;  // literal segment text, or parameter name
+    };
+
+    bool trivial = false;
+    std::vector<Segment> segments;
+
 };
 
 }}} // namespace lsst::qserv::qhttp
@@ -0,0 +1,113 @@
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "qhttp/PathTrie.h"
+
+// System headers
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace lsst {
+namespace qserv {
+namespace qhttp {
+
+
+void PathTrie::addRoute(Path const& path, int handlerIndex)
+{
+    Node* node = &_root;
+    for(auto& segment: path.segments) {
+        if (segment.isParam) {
+            if (!node->param) node->param.reset(new Node());
+            node = node->param.get();
+        } else {
+            auto& child = node->literals[segment.value];
+            if (!child) child.reset(new Node());
+            node = child.get();
+        }
+    }
+    if (node->handlerIndex < 0) {
+        node->handlerIndex = handlerIndex;
+        node->paramNames = path.paramNames;
+    }
+}
+
+
+int PathTrie::match(Request::Ptr const& request) const
+{
+    std::string const& path = request->path;
+    if (path.empty() || (path.front() != '/')) return -1;
+
+    // Accept at most one trailing slash, as the compiled regexes do
+    std::string::size_type end = path.size();
+    if ((end > 1) && (path[end-1] == '/')) --end;
+
+    std::vector<Capture> captures;
+    Node const* matched = _match(_root, path, 1, end, captures);
+    if (matched == nullptr) return -1;
+
+    for(size_t i=0; i<matched->paramNames.size(); ++i) {
+        request->params[matched->paramNames[i]] = path.substr(captures[i].first, captures[i].second);
+    }
+    return matched->handlerIndex;
+}
+
+
+PathTrie::Node const* PathTrie::_match(
+    Node const& node, std::string const& path, std::string::size_type pos,
+    std::string::size_type end, std::vector<Capture>& captures) const
+{
+    // All segments consumed; did a route terminate on this node?
+    if (pos >= end) {
+        return (node.handlerIndex >= 0) ? &node : nullptr;
+    }
+
+    auto slash = path.find('/', pos);
+    if ((slash == std::string::npos) || (slash > end)) slash = end;
+    auto const len = slash - pos;
+
+    // A matching literal child takes precedence over a parameter child, but if the rest of the path
+    // fails to match below it, fall back to the parameter child.  Literal children are compared against
+    // the segment in place, without extracting a segment copy.
+    for(auto const& child: node.literals) {
+        if (path.compare(pos, len, child.first) == 0) {
+            auto const matched = _match(*child.second, path, slash + 1, end, captures);
+            if (matched != nullptr) return matched;
+            break; // segment texts are unique among literal children
+        }
+    }
+
+    // A parameter matches any single non-empty segment, as do the "[^/]+?" captures in the compiled
+    // regexes
+    if (node.param && (len != 0)) {
+        captures.push_back(Capture(pos, len));
+        auto const matched = _match(*node.param, path, slash + 1, end, captures);
+        if (matched != nullptr) return matched;
+        captures.pop_back();
+    }
+
+    return nullptr;
+}
+
+
+}}} // namespace lsst::qserv::qhttp
@@ -0,0 +1,83 @@
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#ifndef LSST_QSERV_QHTTP_PATHTRIE_H
+#define LSST_QSERV_QHTTP_PATHTRIE_H
+
+// System headers
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Local headers
+#include "qhttp/Path.h"
+#include "qhttp/Request.h"
+
+namespace lsst {
+namespace qserv {
+namespace qhttp {
+
+
+//----- This is an internal utility class, used by the Server class.  Routes with trivial patterns (see
+//      Path.h) are compiled into a per-method prefix trie at handler installation time, so that dispatch
+//      of a matching request costs a single walk over the segments of the request path, instead of a
+//      sequential regex match against every installed handler.
+
+class PathTrie
+{
+public:
+
+    //----- Install a route.  The Path must have been parsed and have Path::trivial set; handlerIndex is
+    //      an opaque identifier returned by match() on success (the Server uses the position of the
+    //      handler in its per-method handler table).  If a route with the same shape was installed
+    //      earlier the first one wins, preserving the first-match-wins semantics of sequential dispatch.
+
+    void addRoute(Path const& path, int handlerIndex);
+
+    //----- Match a request path, and update captured params in the request on success.  Returns the
+    //      handlerIndex of the matched route, or -1 if no installed route matches.
+
+    int match(Request::Ptr const& request) const;
+
+private:
+
+    struct Node
+    {
+        std::map<std::string, std::unique_ptr<Node>> literals;  // literal children, by segment text
+        std::unique_ptr<Node> param;                            // ":name" parameter child, if any
+        int handlerIndex = -1;                                  // route terminating here, or -1
+        std::vector<std::string> paramNames;                    // param names of that route, in order
+    };
+
+    using Capture = std::pair<std::string::size_type, std::string::size_type>; // pos, len
+
+    Node const* _match(Node const& node, std::string const& path, std::string::size_type pos,
+                       std::string::size_type end, std::vector<Capture>& captures) const;
+
+    Node _root;
+
+};
+
+}}} // namespace lsst::qserv::qhttp
+
+#endif // LSST_QSERV_QHTTP_PATHTRIE_H
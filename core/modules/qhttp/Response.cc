@@ -24,16 +24,24 @@
 #include "qhttp/Response.h"
 
 // System headers
+#include <algorithm>
+#include <cstring>
+#include <ctime>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <sstream>
 #include <string>
+#include <vector>
 
 // Third-party headers
+#include <zlib.h>
+#include "boost/algorithm/string.hpp"
 #include "boost/asio.hpp"
 #include "boost/filesystem.hpp"
 #include "boost/filesystem/fstream.hpp"
+#include "boost/regex.hpp"
 
 namespace asio = boost::asio;
 namespace ip = boost::asio::ip;
@@ -41,6 +49,59 @@ namespace fs = boost::filesystem;
 
 namespace {
 
+std::size_t const sendStreamBlockSize = 64 * 1024; // bytes read/written per sendStream() block
+
+//----- Negotiated gzip compression of send() bodies.  Bodies below the threshold aren't worth the
+//      CPU and the extra ~20 byte gzip envelope; above it, the JSON emitted by the REST and metrics
+//      endpoints typically shrinks by an order of magnitude.
+
+std::size_t const compressThresholdBytes = 1024;
+
+bool isCompressibleContentType(std::string const& contentType)
+{
+    return boost::starts_with(contentType, "text/")
+        || contentType == "application/javascript"
+        || contentType == "application/json";
+}
+
+// gzip 'in' into 'out'.  Returns false (leaving 'out' unspecified) on any zlib error.
+bool gzipCompress(std::string const& in, std::string& out)
+{
+    z_stream strm;
+    ::memset(&strm, 0, sizeof(strm));
+    // windowBits 15+16 selects a gzip wrapper rather than a raw zlib one
+    if (deflateInit2(&strm, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+        return false;
+    }
+    out.resize(deflateBound(&strm, in.size()));
+    strm.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+    strm.avail_in = in.size();
+    strm.next_out = reinterpret_cast<Bytef*>(&out[0]);
+    strm.avail_out = out.size();
+    int const zret = deflate(&strm, Z_FINISH);
+    std::size_t const compressedSize = strm.total_out;
+    deflateEnd(&strm);
+    if (zret != Z_STREAM_END) return false;
+    out.resize(compressedSize);
+    return true;
+}
+
+//----- Cache of small files recently served by sendFile(), keyed by path and validated against file
+//      mtime on each hit.  Hot dashboard assets are typically small and fetched by every page load;
+//      caching them avoids a filesystem read per request.  The cache is crudely bounded: it is
+//      dropped wholesale when the entry limit is hit.
+
+std::size_t const fileCacheMaxFileSize = 64 * 1024;
+std::size_t const fileCacheMaxEntries = 256;
+
+struct FileCacheEntry {
+    std::time_t mtime;
+    std::string content;
+};
+
+std::mutex fileCacheMutex;
+std::map<std::string, FileCacheEntry> fileCache;
+
 std::map<unsigned int, const std::string> responseStringsByCode = {
     {100, "Continue"},                          {101, "Switching Protocols"},
     {102, "Processing"},                        {200, "OK"},
@@ -118,14 +179,37 @@ void Response::sendStatus(unsigned int status)
 
 void Response::send(std::string const& content, std::string const& contentType)
 {
+    // hold the body in a member and gather-write it together with the headers
+    // rather than pushing it through the response streambuf a second time
+    _responseContent = content;
+
+    //----- Compress compressible bodies when the client asked for gzip, unless the body is small or
+    //      already encoded (e.g. a pre-compressed file forwarded by sendFile).  A body that zlib
+    //      fails on or fails to shrink is sent as-is.
+
+    if (_acceptsGzip && content.length() >= compressThresholdBytes
+        && isCompressibleContentType(contentType) && (headers.count("Content-Encoding") == 0))
+    {
+        std::string compressed;
+        if (gzipCompress(content, compressed) && (compressed.length() < content.length())) {
+            headers["Content-Encoding"] = "gzip";
+            headers["Vary"] = "Accept-Encoding";
+            _responseContent = std::move(compressed);
+        }
+    }
+
     headers["Content-Type"] = contentType;
-    headers["Content-Length"] = std::to_string(content.length());
+    headers["Content-Length"] = std::to_string(_responseContent.length());
 
     std::ostream responseStream(&_responsebuf);
-    responseStream << _headers() << "\r\n" << content;
+    responseStream << _headers() << "\r\n";
+
+    std::vector<asio::const_buffer> buffers;
+    buffers.push_back(_responsebuf.data());
+    buffers.push_back(asio::buffer(_responseContent));
 
     auto self = shared_from_this();
-    asio::async_write(*_socket, _responsebuf,
+    asio::async_write(*_socket, buffers,
         [self](boost::system::error_code const& ec, std::size_t sent) {
             if (self->_doneCallback) {
                 self->_doneCallback(ec, sent);
@@ -135,7 +219,7 @@ void Response::send(std::string const& content, std::string const& contentType)
 }
 
 
-void Response::sendFile(fs::path const& path)
+void Response::sendFile(fs::path const& path, std::string const& range)
 {
     if (!fs::exists(path)) {
         sendStatus(404);
@@ -143,25 +227,183 @@ void Response::sendFile(fs::path const& path)
     }
 
     auto ct = contentTypesByExtension.find(path.extension().string());
-    headers["Content-Type"] = (ct != contentTypesByExtension.end()) ? ct->second : "text/plain";
+    std::string const contentType =
+        (ct != contentTypesByExtension.end()) ? ct->second : "text/plain";
+
+    //----- Serve a pre-compressed sibling ("<file>.gz") when the client accepts gzip and no byte
+    //      range was requested (byte ranges address the uncompressed representation).  The content
+    //      type remains that of the plain file.
+
+    fs::path servePath = path;
+    if (_acceptsGzip && range.empty()) {
+        fs::path const gzPath(path.string() + ".gz");
+        if (fs::exists(gzPath)) {
+            servePath = gzPath;
+            headers["Content-Encoding"] = "gzip";
+            headers["Vary"] = "Accept-Encoding";
+        }
+    }
+
+    std::size_t const fileSize = fs::file_size(servePath);
+    std::time_t const mtime = fs::last_write_time(servePath);
+
+    headers["Accept-Ranges"] = "bytes";
 
-    headers["Content-Length"] = std::to_string(fs::file_size(path));
-    fs::ifstream responseFile(path);
+    //----- Parse single byte-range requests ("bytes=first-last", "bytes=first-", or "bytes=-suffix").
+    //      An unsatisfiable range gets a 416; a syntactically unrecognized one is ignored and the
+    //      whole file is served, as RFC 7233 allows.
+
+    std::size_t begin = 0;
+    std::size_t end = fileSize; // one past the last byte to send
+    bool partial = false;
+
+    if (!range.empty()) {
+        static boost::regex const rangeRe{" *bytes *= *([0-9]*) *- *([0-9]*) *"};
+        boost::smatch rangeMatch;
+        if (boost::regex_match(range, rangeMatch, rangeRe)
+            && (rangeMatch[1].length() + rangeMatch[2].length() > 0))
+        {
+            if (rangeMatch[1].length() == 0) {
+                // suffix form: last N bytes of the file
+                std::size_t const suffix = stoull(rangeMatch[2].str());
+                begin = (suffix < fileSize) ? fileSize - suffix : 0;
+            } else {
+                begin = stoull(rangeMatch[1].str());
+                if (rangeMatch[2].length() > 0) {
+                    end = std::min<std::size_t>(fileSize, stoull(rangeMatch[2].str()) + 1);
+                }
+            }
+            if (begin >= end || begin >= fileSize) {
+                headers["Content-Range"] = "bytes */" + std::to_string(fileSize);
+                sendStatus(416);
+                return;
+            }
+            partial = true;
+            status = 206;
+            headers["Content-Range"] = "bytes " + std::to_string(begin) + "-"
+                + std::to_string(end - 1) + "/" + std::to_string(fileSize);
+        }
+    }
+
+    //----- Serve small whole-file requests from the in-memory cache
+
+    if (!partial && fileSize <= fileCacheMaxFileSize) {
+        std::string content;
+        bool cached = false;
+        {
+            std::lock_guard<std::mutex> lock(fileCacheMutex);
+            auto entry = fileCache.find(servePath.string());
+            if (entry != fileCache.end() && entry->second.mtime == mtime) {
+                content = entry->second.content;
+                cached = true;
+            }
+        }
+        if (!cached) {
+            fs::ifstream file(servePath, std::ios::binary);
+            std::ostringstream buffer;
+            buffer << file.rdbuf();
+            content = buffer.str();
+            std::lock_guard<std::mutex> lock(fileCacheMutex);
+            if (fileCache.size() >= fileCacheMaxEntries) fileCache.clear();
+            fileCache[servePath.string()] = FileCacheEntry{mtime, content};
+        }
+        send(content, contentType);
+        return;
+    }
+
+    auto responseFile = std::make_shared<fs::ifstream>(servePath, std::ios::binary);
+    if (partial) responseFile->seekg(begin);
+    sendStream(responseFile, contentType, end - begin);
+}
+
+
+void Response::sendStream(
+    std::shared_ptr<std::istream> stream,
+    std::string const& contentType,
+    std::size_t contentLength)
+{
+    headers["Content-Type"] = contentType;
+    headers["Content-Length"] = std::to_string(contentLength);
+
+    _streamRemaining = contentLength;
 
     std::ostream responseStream(&_responsebuf);
-    responseStream << _headers() << "\r\n" << responseFile.rdbuf();
+    responseStream << _headers() << "\r\n";
 
     auto self = shared_from_this();
     asio::async_write(*_socket, _responsebuf,
-        [self](boost::system::error_code const& ec, std::size_t sent) {
-            if (self->_doneCallback) {
-                self->_doneCallback(ec, sent);
+        [self, stream](boost::system::error_code const& ec, std::size_t sent) {
+            if (ec) {
+                if (self->_doneCallback) {
+                    self->_doneCallback(ec, sent);
+                }
+                return;
+            }
+            self->_writeStreamBlock(stream, sent);
+        }
+    );
+}
+
+
+void Response::_writeStreamBlock(std::shared_ptr<std::istream> stream, std::size_t bytesSent)
+{
+    if (_streamRemaining == 0) {
+        // advertised content length reached, the body is complete
+        if (_doneCallback) {
+            _doneCallback(boost::system::error_code(), bytesSent);
+        }
+        return;
+    }
+
+    _streamBlock.resize(std::min(sendStreamBlockSize, _streamRemaining));
+    stream->read(_streamBlock.data(), _streamBlock.size());
+    std::size_t const bytesRead = stream->gcount();
+    if (bytesRead == 0) {
+        // stream ended short of the advertised content length; nothing useful
+        // can be sent at this point, so just signal completion
+        if (_doneCallback) {
+            _doneCallback(boost::system::error_code(), bytesSent);
+        }
+        return;
+    }
+    _streamRemaining -= bytesRead;
+
+    auto self = shared_from_this();
+    asio::async_write(*_socket, asio::buffer(_streamBlock.data(), bytesRead),
+        [self, stream, bytesSent](boost::system::error_code const& ec, std::size_t sent) {
+            if (ec) {
+                if (self->_doneCallback) {
+                    self->_doneCallback(ec, bytesSent + sent);
+                }
+                return;
             }
+            self->_writeStreamBlock(stream, bytesSent + sent);
         }
     );
 }
 
 
+bool Response::_clientAcceptsGzip(std::string const& acceptEncoding)
+{
+    // Accept-Encoding is a comma-separated list of codings, each with an optional q-value
+    // (e.g. "gzip;q=0.8, identity").  A coding with q=0 is explicitly refused.
+    std::vector<std::string> codings;
+    boost::split(codings, acceptEncoding, boost::is_any_of(","));
+    for (auto& coding : codings) {
+        boost::trim(coding);
+        std::string::size_type const semi = coding.find(';');
+        std::string const name = boost::trim_copy(coding.substr(0, semi));
+        if ((name != "gzip") && (name != "x-gzip") && (name != "*")) continue;
+        if (semi != std::string::npos) {
+            static boost::regex const qZeroRe{" *q *= *0(\\.0*)? *"};
+            if (boost::regex_match(coding.substr(semi + 1), qZeroRe)) continue;
+        }
+        return true;
+    }
+    return false;
+}
+
+
 std::string Response::_headers() const
 {
     std::ostringstream headerst;
@@ -29,6 +29,7 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 // Third-party headers
 #include "boost/asio.hpp"
@@ -47,11 +48,31 @@ public:
     //----- These methods are used to send a response back to the HTTP client.  When using sendStatus,
     //      an appropriate HTML body will be automatically generated.  When using sendFile, contentType
     //      will be inferred based on file extension for a handful of known file types (see map defined
-    //      near the top of Response.cc for specific extensions supported.)
+    //      near the top of Response.cc for specific extensions supported.)  sendFile accepts the value
+    //      of the request's Range header, if any; a single satisfiable byte range is answered with a
+    //      206 partial response, an unsatisfiable one with a 416.  Small whole files are served from
+    //      an mtime-validated in-memory cache; anything else is streamed via sendStream.
+    //
+    //      If the client advertised gzip support in Accept-Encoding, send() gzips bodies of
+    //      compressible content types above a size threshold, and sendFile serves a pre-compressed
+    //      sibling file ("<file>.gz", with the content type of the plain file) when one exists and no
+    //      byte range was requested.  Responses that already carry a Content-Encoding are passed
+    //      through untouched.
 
     void send(std::string const& content, std::string const& contentType="text/html");
     void sendStatus(unsigned int status);
-    void sendFile(boost::filesystem::path const& path);
+    void sendFile(boost::filesystem::path const& path, std::string const& range=std::string());
+
+    //----- sendStream() sends a response body of known length read incrementally from the provided
+    //      stream, in fixed-size blocks, instead of buffering the entire body in memory first.  Use
+    //      this for large bodies (sendFile uses it internally); the stream must remain valid until
+    //      the response is complete, which the shared ptr ensures.
+
+    void sendStream(
+        std::shared_ptr<std::istream> stream,
+        std::string const& contentType,
+        std::size_t contentLength
+    );
 
     //----- Response status code and additional headers may also be set with these members, and will be
     //      included/observed by the send methods above (sendStatus and sendFile will override status set
@@ -77,10 +98,19 @@ private:
         DoneCallback const& doneCallback
     );
 
+    //----- Parse of the request's Accept-Encoding header, used by Server to set _acceptsGzip below.
+
+    static bool _clientAcceptsGzip(std::string const& acceptEncoding);
+
     std::string _headers() const;
+    void _writeStreamBlock(std::shared_ptr<std::istream> stream, std::size_t bytesSent);
 
     std::shared_ptr<boost::asio::ip::tcp::socket> _socket;
     boost::asio::streambuf _responsebuf;
+    std::string _responseContent;         // body for send(), written without further copies
+    std::vector<char> _streamBlock;       // in-flight block for sendStream()
+    std::size_t _streamRemaining = { 0 }; // body bytes left to send via sendStream()
+    bool _acceptsGzip = { false };        // set by Server from the request's Accept-Encoding
 
     DoneCallback _doneCallback;
 
@@ -28,6 +28,7 @@
 #include <string>
 
 // Third-party headers
+#include "boost/algorithm/string/predicate.hpp"
 #include "boost/asio.hpp"
 #include "boost/asio/steady_timer.hpp"
 #include "boost/regex.hpp"
@@ -74,6 +75,9 @@ void Server::addHandler(std::string const& method, std::string const& pattern, H
     auto &phandler = handlers.back();
     phandler.path.parse(pattern);
     phandler.handler = handler;
+    if (phandler.path.trivial) {
+        _pathTrieByMethod[method].addRoute(phandler.path, handlers.size() - 1);
+    }
 }
 
 
@@ -155,9 +159,16 @@ void Server::_readRequest(std::shared_ptr<ip::tcp::socket> socket)
                 size_t bytesBuffered = request->_requestbuf.size() - bytesRead;
                 request->_parseHeader();
                 request->_parseUri();
-                if (request->version == "HTTP/1.1") {
+                // HTTP/1.1 connections are persistent unless the client opts
+                // out; let the client know which way the decision went so it
+                // doesn't have to wait for EOF to detect a closed connection
+                if ((request->version == "HTTP/1.1")
+                    && !boost::iequals(request->header["Connection"], "close"))
+                {
                     *reuseSocket = true;
                 }
+                response->headers["Connection"] = *reuseSocket ? "keep-alive" : "close";
+                response->_acceptsGzip = Response::_clientAcceptsGzip(request->header["Accept-Encoding"]);
                 if (request->header.count("Content-Length") > 0) {
                     asio::async_read(
                         *socket, request->_requestbuf,
@@ -192,8 +203,23 @@ void Server::_dispatchRequest(Request::Ptr request, Response::Ptr response)
 {
     auto pathHandlersIt = _pathHandlersByMethod.find(request->method);
     if (pathHandlersIt != _pathHandlersByMethod.end()) {
+
+        // Handlers with trivial path patterns are dispatched through the per-method prefix trie, in a
+        // single walk over the request path
+        auto pathTrieIt = _pathTrieByMethod.find(request->method);
+        if (pathTrieIt != _pathTrieByMethod.end()) {
+            int const matched = pathTrieIt->second.match(request);
+            if (matched >= 0) {
+                pathHandlersIt->second[matched].handler(request, response);
+                return;
+            }
+        }
+
+        // Remaining handlers are matched sequentially against their compiled regexes.  Handlers with
+        // trivial patterns are all covered by the trie, so they are skipped here.
         boost::smatch pathMatch;
         for(auto& pathHandler : pathHandlersIt->second) {
+            if (pathHandler.path.trivial) continue;
             if (boost::regex_match(request->path, pathMatch, pathHandler.path.regex)) {
                 pathHandler.path.updateParamsFromMatch(request, pathMatch);
                 pathHandler.handler(request, response);
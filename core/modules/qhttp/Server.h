@@ -38,6 +38,7 @@
 // Local headers
 #include "qhttp/AjaxEndpoint.h"
 #include "qhttp/Path.h"
+#include "qhttp/PathTrie.h"
 #include "qhttp/Response.h"
 #include "qhttp/Request.h"
 
@@ -97,7 +98,10 @@ public:
 
     //----- accept() installs the head of the asynchronous even handler chain onto the asio::io_service
     //      provided when the Server instance was constructed.  Event handlers for the Server tail out when
-    //      asio::io_service::stop() is subsquently called to shutdown that io_service.
+    //      asio::io_service::stop() is subsquently called to shutdown that io_service.  The io_service may
+    //      be run from a pool of threads, in which case requests on separate connections are read, handled,
+    //      and responded to concurrently; installed Handlers must then be thread-safe, and all handlers
+    //      must be installed before accept() is called (the handler tables are not guarded by locks).
 
     void accept();
 
@@ -118,6 +122,12 @@ private:
 
     std::unordered_map<std::string, std::vector<PathHandler>> _pathHandlersByMethod;
 
+    //----- Handlers with trivial path patterns (see Path.h) are additionally indexed by these per-method
+    //      prefix tries, and dispatched in a single walk over the request path instead of a sequential
+    //      regex match over the handler table above.
+
+    std::unordered_map<std::string, PathTrie> _pathTrieByMethod;
+
     boost::asio::io_service& _io_service;
     boost::asio::ip::tcp::acceptor _acceptor;
 
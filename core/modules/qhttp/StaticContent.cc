@@ -93,7 +93,7 @@ void StaticContent::add(Server& server, std::string const& pattern, std::string
             }
             requestPath /= "index.htm";
         }
-        response->sendFile(requestPath);
+        response->sendFile(requestPath, request->header["Range"]);
     });
 }
 
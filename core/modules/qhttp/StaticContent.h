@@ -43,8 +43,10 @@ public:
     //      specified in the "path" argument and postfix match paths to existing files under rootDirectory
     //      in the local filesystem.  Content-Type of responses is inferred from the file extension for
     //      several common file extensions (see the file type map near the top of Response.cc for a complete
-    //      list of these.)  Note that the Server::addStaticContent() convenience method would typically be
-    //      called in preference to calling the add() method here directly.
+    //      list of these.)  A pre-compressed sibling file ("<file>.gz") is served in place of its plain
+    //      counterpart for clients that accept gzip (see Response::sendFile).  Note that the
+    //      Server::addStaticContent() convenience method would typically be called in preference to calling
+    //      the add() method here directly.
 
     static void add(Server& server, std::string const& path, std::string const& rootDirectory);
 
@@ -24,6 +24,7 @@
 #include "boost/test/included/unit_test.hpp"
 
 #include <chrono>
+#include <cstring>
 #include <fstream>
 #include <sstream>
 #include <set>
@@ -34,6 +35,7 @@
 #include "boost/algorithm/string/join.hpp"
 #include "boost/range/adaptors.hpp"
 #include "curl/curl.h"
+#include <zlib.h>
 
 #include "qhttp/Server.h"
 
@@ -53,6 +55,29 @@ void compareWithFile(std::string const& content, std::string const& file)
 }
 
 
+// Decompress a gzipped response body, for validating negotiated compression below.
+std::string gunzip(std::string const& in)
+{
+    z_stream strm;
+    ::memset(&strm, 0, sizeof(strm));
+    BOOST_TEST(inflateInit2(&strm, 15 + 16) == Z_OK); // 15+16: expect a gzip wrapper
+    strm.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+    strm.avail_in = in.size();
+    std::string out;
+    char buf[4096];
+    int zret = Z_OK;
+    do {
+        strm.next_out = reinterpret_cast<Bytef*>(buf);
+        strm.avail_out = sizeof(buf);
+        zret = inflate(&strm, Z_NO_FLUSH);
+        BOOST_TEST(((zret == Z_OK) || (zret == Z_STREAM_END)));
+        out.append(buf, sizeof(buf) - strm.avail_out);
+    } while (zret == Z_OK);
+    inflateEnd(&strm);
+    return out;
+}
+
+
 std::string printParams(lsst::qserv::qhttp::Request::Ptr const& req)
 {
     std::map<std::string, std::string> pparams;
@@ -271,16 +296,20 @@ struct QhttpFixture
         BOOST_TEST(curl_global_init(CURL_GLOBAL_DEFAULT) == CURLE_OK);
     }
 
-    void start()
+    void start(unsigned numThreads = 1)
     {
         server->accept();
-        serviceThread = std::move(std::thread([this](){ service.run(); }));
+        for(unsigned i = 0; i < numThreads; ++i) {
+            serviceThreads.emplace_back([this](){ service.run(); });
+        }
     }
 
     ~QhttpFixture()
     {
         service.stop();
-        serviceThread.join();
+        for(auto& serviceThread: serviceThreads) {
+            serviceThread.join();
+        }
         curl_global_cleanup();
     }
 
@@ -338,7 +367,7 @@ struct QhttpFixture
     }
 
     asio::io_service service;
-    std::thread serviceThread;
+    std::vector<std::thread> serviceThreads;
     qhttp::Server::Ptr server;
     std::string urlPrefix;
 };
@@ -412,6 +441,85 @@ BOOST_FIXTURE_TEST_CASE(case_insensitive_headers, QhttpFixture)
 }
 
 
+BOOST_FIXTURE_TEST_CASE(persistent_connections, QhttpFixture)
+{
+    server->addHandler("GET", "/", [](qhttp::Request::Ptr req, qhttp::Response::Ptr resp){
+        resp->sendStatus(200);
+    });
+
+    start(2); // also exercise running the io_service from more than one thread
+
+    boost::system::error_code ec;
+
+    ip::tcp::endpoint endpoint(ip::address::from_string("127.0.0.1"), server->getPort());
+    ip::tcp::socket socket(service);
+    socket.connect(endpoint, ec);
+    BOOST_TEST(!ec);
+
+    asio::streambuf respbuf;
+    std::istream resp(&respbuf);
+
+    auto readHeader = [&resp]() {
+        std::map<std::string, std::string> header;
+        std::string line;
+        getline(resp, line); // status line
+        static boost::regex headerRe{"^([^:\\r]+): ?([^\\r]*)\\r$"};
+        boost::smatch headerMatch;
+        while(getline(resp, line) && boost::regex_match(line, headerMatch, headerRe)) {
+            header[headerMatch[1]] = headerMatch[2];
+        }
+        return header;
+    };
+
+    //----- several requests in turn on the same connection; HTTP/1.1 defaults to
+    //      keep-alive, and the server should advertise that in its response
+
+    for(int i = 0; i < 3; ++i) {
+        std::string req = "GET / HTTP/1.1\r\n\r\n";
+        asio::write(socket, asio::buffer(req), ec);
+        BOOST_TEST(!ec);
+        asio::read_until(socket, respbuf, "\r\n\r\n", ec);
+        BOOST_TEST(!ec);
+        auto header = readHeader();
+        BOOST_TEST(header["Connection"] == "keep-alive");
+        size_t contentLength = stoull(header["Content-Length"]);
+        if (respbuf.size() < contentLength) {
+            asio::read(socket, respbuf, asio::transfer_exactly(contentLength - respbuf.size()), ec);
+            BOOST_TEST(!ec);
+        }
+        respbuf.consume(contentLength);
+    }
+
+    //----- a client request to close the connection should be honored
+
+    std::string req = "GET / HTTP/1.1\r\nConnection: close\r\n\r\n";
+    asio::write(socket, asio::buffer(req), ec);
+    BOOST_TEST(!ec);
+    asio::read_until(socket, respbuf, "\r\n\r\n", ec);
+    BOOST_TEST(!ec);
+    auto header = readHeader();
+    BOOST_TEST(header["Connection"] == "close");
+}
+
+
+BOOST_FIXTURE_TEST_CASE(streamed_response, QhttpFixture)
+{
+    //----- body large enough to span several sendStream() blocks
+
+    std::string content(1000000, 'x');
+    server->addHandler("GET", "/stream", [&content](qhttp::Request::Ptr req, qhttp::Response::Ptr resp){
+        auto stream = std::make_shared<std::istringstream>(content);
+        resp->sendStream(stream, "text/plain", content.size());
+    });
+
+    start();
+    CurlEasy curl;
+
+    curl.setup("GET", urlPrefix + "stream", "").perform().validate(200, "text/plain");
+    BOOST_TEST(curl.recdContent == content);
+}
+
+
 BOOST_FIXTURE_TEST_CASE(percent_decoding, QhttpFixture)
 {
     //----- server with handlers to catch potential encoded "/" dispatch error
@@ -480,6 +588,109 @@ BOOST_FIXTURE_TEST_CASE(static_content, QhttpFixture)
 }
 
 
+BOOST_FIXTURE_TEST_CASE(compression, QhttpFixture)
+{
+    //----- build a large, highly compressible JSON-ish body
+
+    std::string largeBody = "[";
+    for (int i = 0; i < 1000; ++i) largeBody += "{\"key\": \"value\"},";
+    largeBody += "{}]";
+
+    server->addHandler("GET", "/api", [&largeBody](qhttp::Request::Ptr req, qhttp::Response::Ptr resp) {
+        resp->send(largeBody, "application/json");
+    });
+    server->addHandler("GET", "/small", [](qhttp::Request::Ptr req, qhttp::Response::Ptr resp) {
+        resp->send("{}", "application/json");
+    });
+    server->addHandler("GET", "/binary", [&largeBody](qhttp::Request::Ptr req, qhttp::Response::Ptr resp) {
+        resp->send(largeBody, "application/octet-stream");
+    });
+    server->addStaticContent("/*", "core/modules/qhttp/testdata");
+
+    start();
+    CurlEasy curl;
+
+    //----- without Accept-Encoding the body is sent verbatim
+
+    curl.setup("GET", urlPrefix + "api", "").perform().validate(200, "application/json");
+    BOOST_TEST(curl.recdContent == largeBody);
+
+    //----- a gzip-accepting client gets a smaller, gzipped body that inflates back to the original
+    //      (the raw Accept-Encoding header keeps libcurl from decoding the response itself)
+
+    curl.setup("GET", urlPrefix + "api", "", {"Accept-Encoding: gzip"});
+    curl.perform().validate(200, "application/json");
+    BOOST_TEST(curl.recdContent.size() < largeBody.size());
+    BOOST_TEST(gunzip(curl.recdContent) == largeBody);
+
+    //----- small and non-compressible bodies are passed through, as is an explicitly refused coding
+
+    curl.setup("GET", urlPrefix + "small", "", {"Accept-Encoding: gzip"});
+    curl.perform().validate(200, "application/json");
+    BOOST_TEST(curl.recdContent == "{}");
+    curl.setup("GET", urlPrefix + "binary", "", {"Accept-Encoding: gzip"});
+    curl.perform().validate(200, "application/octet-stream");
+    BOOST_TEST(curl.recdContent == largeBody);
+    curl.setup("GET", urlPrefix + "api", "", {"Accept-Encoding: gzip;q=0"});
+    curl.perform().validate(200, "application/json");
+    BOOST_TEST(curl.recdContent == largeBody);
+
+    //----- a pre-compressed static sibling is served to accepting clients, keeping the plain
+    //      file's content type; other clients still get the plain file
+
+    curl.setup("GET", urlPrefix + "js/main.js", "", {"Accept-Encoding: gzip"});
+    curl.perform().validate(200, "application/javascript");
+    compareWithFile(curl.recdContent, "core/modules/qhttp/testdata/js/main.js.gz");
+    compareWithFile(gunzip(curl.recdContent), "core/modules/qhttp/testdata/js/main.js");
+    curl.setup("GET", urlPrefix + "js/main.js", "").perform().validate(200, "application/javascript");
+    compareWithFile(curl.recdContent, "core/modules/qhttp/testdata/js/main.js");
+}
+
+
+BOOST_FIXTURE_TEST_CASE(range_requests, QhttpFixture)
+{
+    server->addStaticContent("/*", "core/modules/qhttp/testdata");
+    start();
+
+    CurlEasy curl;
+
+    std::ifstream f("core/modules/qhttp/testdata/css/style.css", std::ios::binary);
+    std::stringstream fbuf;
+    fbuf << f.rdbuf();
+    std::string const file = fbuf.str();
+
+    //----- whole-file requests; second fetch is served from the small-file cache
+
+    curl.setup("GET", urlPrefix + "css/style.css", "").perform().validate(200, "text/css");
+    BOOST_TEST(curl.recdContent == file);
+    curl.setup("GET", urlPrefix + "css/style.css", "").perform().validate(200, "text/css");
+    BOOST_TEST(curl.recdContent == file);
+
+    //----- single byte-range requests, in first-last, first-, and -suffix forms
+
+    curl.setup("GET", urlPrefix + "css/style.css", "", {"Range: bytes=0-9"});
+    curl.perform().validate(206, "text/css");
+    BOOST_TEST(curl.recdContent == file.substr(0, 10));
+
+    curl.setup("GET", urlPrefix + "css/style.css", "", {"Range: bytes=10-19"});
+    curl.perform().validate(206, "text/css");
+    BOOST_TEST(curl.recdContent == file.substr(10, 10));
+
+    curl.setup("GET", urlPrefix + "css/style.css", "", {"Range: bytes=10-"});
+    curl.perform().validate(206, "text/css");
+    BOOST_TEST(curl.recdContent == file.substr(10));
+
+    curl.setup("GET", urlPrefix + "css/style.css", "", {"Range: bytes=-10"});
+    curl.perform().validate(206, "text/css");
+    BOOST_TEST(curl.recdContent == file.substr(file.size() - 10));
+
+    //----- unsatisfiable range
+
+    curl.setup("GET", urlPrefix + "css/style.css", "", {"Range: bytes=1000000-"});
+    curl.perform().validate(416, "text/html");
+}
+
+
 BOOST_FIXTURE_TEST_CASE(relative_url_containment, QhttpFixture)
 {
     server->addStaticContent("/*", "core/modules/qhttp/testdata");
@@ -520,7 +731,8 @@ BOOST_FIXTURE_TEST_CASE(handler_dispatch, QhttpFixture)
         {"PATCH",  "/api/v1/bars",           testHandler("Handler4")},
         {"DELETE", "/api/v1/bars",           testHandler("Handler5")},
         {"GET",    "/api/v1/foos/:foo",      testHandler("Handler6")},
-        {"GET",    "/api/v1/foos/:foo/:bar", testHandler("Handler7")}
+        {"GET",    "/api/v1/foos/:foo/:bar", testHandler("Handler7")},
+        {"GET",    "/api/v1/opts/:opt?",     testHandler("Handler8")}
     });
 
     start();
@@ -560,6 +772,13 @@ BOOST_FIXTURE_TEST_CASE(handler_dispatch, QhttpFixture)
     BOOST_TEST(curl.recdContent == "Handler6 params[foo=boz] query[]");
     curl.setup("GET", urlPrefix + "api/v1/foos/gleep/glorp", "").perform().validate(200, "text/plain");
     BOOST_TEST(curl.recdContent == "Handler7 params[bar=glorp,foo=gleep] query[]");
+
+    //----- Test non-trivial patterns, dispatched by sequential regex match rather than the path trie
+
+    curl.setup("GET", urlPrefix + "api/v1/opts", "").perform().validate(200, "text/plain");
+    BOOST_TEST(curl.recdContent == "Handler8 params[opt=] query[]");
+    curl.setup("GET", urlPrefix + "api/v1/opts/grault", "").perform().validate(200, "text/plain");
+    BOOST_TEST(curl.recdContent == "Handler8 params[opt=grault] query[]");
 }
 
 
@@ -683,4 +902,49 @@ BOOST_FIXTURE_TEST_CASE(ajax, QhttpFixture)
     t3.join();
 }
 
+
+BOOST_FIXTURE_TEST_CASE(ajax_delta, QhttpFixture)
+{
+    auto ajax = qhttp::AjaxEndpoint::add(*server, "/ajax/delta", 2); // delta log bounded at 2
+
+    start();
+
+    ajax->update(R"({"a":1})", R"({"a":1})");                   // version 1
+    ajax->update(R"({"a":1,"b":2})", R"({"b":2})");             // version 2
+    ajax->update(R"({"a":1,"b":2,"c":3})", R"({"c":3})");       // version 3
+
+    //----- A client within the delta log gets only the deltas it missed
+
+    std::string content = asioHttpGet("/ajax/delta?since=2", 200, "application/json");
+    BOOST_TEST(content == R"({"version":3,"deltas":[{"c":3}]})");
+    content = asioHttpGet("/ajax/delta?since=1", 200, "application/json");
+    BOOST_TEST(content == R"({"version":3,"deltas":[{"b":2},{"c":3}]})");
+
+    //----- A client beyond the bounded delta log, or from the future, is resynchronized with full state
+
+    content = asioHttpGet("/ajax/delta?since=0", 200, "application/json");
+    BOOST_TEST(content == R"({"version":3,"full":{"a":1,"b":2,"c":3}})");
+    content = asioHttpGet("/ajax/delta?since=7", 200, "application/json");
+    BOOST_TEST(content == R"({"version":3,"full":{"a":1,"b":2,"c":3}})");
+
+    //----- An update without a delta invalidates the log, forcing full-state fallback
+
+    ajax->update(R"({"d":4})");                                 // version 4, no delta
+    content = asioHttpGet("/ajax/delta?since=3", 200, "application/json");
+    BOOST_TEST(content == R"({"version":4,"full":{"d":4}})");
+
+    //----- An up-to-date client is parked until the next update, then gets just that delta
+
+    std::atomic<bool> updated{false};
+    std::thread t([&ajax, &updated]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds{100});
+        ajax->update(R"({"d":5})", R"({"d":5})");               // version 5
+        updated = true;
+    });
+    content = asioHttpGet("/ajax/delta?since=4", 200, "application/json");
+    BOOST_TEST(updated.load());
+    BOOST_TEST(content == R"({"version":5,"deltas":[{"d":5}]})");
+    t.join();
+}
+
 }} // namespace lsst::qserv
@@ -31,6 +31,9 @@
 
 // Qserv headers
 #include "qmeta/QInfo.h"
+#include "qmeta/QProgress.h"
+#include "qmeta/QShapeStats.h"
+#include "qmeta/QStats.h"
 #include "qmeta/types.h"
 
 
@@ -194,6 +197,55 @@ public:
      */
     virtual void finishQuery(QueryId queryId) = 0;
 
+    /**
+     *  @brief Update execution progress of a running query.
+     *
+     *  Creates the progress record on the first call and overwrites it on
+     *  later calls; the czar calls this every few seconds while a query
+     *  drains. The processlist views expose the record to clients.
+     *  This method will throw if query ID is not known.
+     *
+     *  @param progress:   Progress snapshot, progress.queryId must be set.
+     */
+    virtual void updateQueryProgress(QProgress const& progress) = 0;
+
+    /**
+     *  @brief Save per-query phase timing statistics.
+     *
+     *  This should be called once when a query completes successfully; the
+     *  row records where the query's wall-clock time went, summed over its
+     *  chunk jobs.
+     *  This method will throw if query ID is not known.
+     *
+     *  @param stats:   Timing statistics, stats.queryId must be set.
+     */
+    virtual void saveQueryStats(QStats const& stats) = 0;
+
+    /**
+     *  @brief Record one completed query against its shape history.
+     *
+     *  Adds one query's observed cost (chunks touched, result rows, worker
+     *  and merge milliseconds) to the aggregate record for its
+     *  (tableSet, shapeHash) shape, creating the record on first sight.
+     *  stats.queryCount is ignored; each call counts as one query.
+     *
+     *  @param stats:   One query's observation, tableSet and shapeHash
+     *                  must be set (see QShapeStats.h helpers).
+     */
+    virtual void addQueryShapeStats(QShapeStats const& stats) = 0;
+
+    /**
+     *  @brief Retrieve historical statistics for a query shape.
+     *
+     *  Absence of history is a normal outcome, not an error: the returned
+     *  record has queryCount == 0 when the shape has never been seen.
+     *
+     *  @param tableSet:   Canonical table list, see makeTableSet().
+     *  @param shapeHash:  Query template hash, see makeShapeHash().
+     */
+    virtual QShapeStats getQueryShapeStats(std::string const& tableSet,
+                                           uint64_t shapeHash) = 0;
+
     /**
      *  @brief Generic interface for finding queries.
      *
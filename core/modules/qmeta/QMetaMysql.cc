@@ -25,6 +25,8 @@
 
 // System headers
 #include <algorithm>
+#include <cstdlib>
+#include <memory>
 
 // Third-party headers
 #include "boost/lexical_cast.hpp"
@@ -43,8 +45,8 @@ namespace {
 
 // Current version of QMeta schema, to avoid conversion I define it as string,
 // change both when updating schema.
-int const VERSION = 1;
-char const VERSION_STR[] = "1";
+int const VERSION = 4;
+char const VERSION_STR[] = "4";
 
 LOG_LOGGER _log = LOG_GET("lsst.qserv.qmeta.QMetaMysql");
 
@@ -84,6 +86,17 @@ QInfo::QStatus string2status(char const* statusStr) {
     }
 }
 
+// Collect a single column of integer ids from a query result, converting
+// each cell in place from the row memory (valid for the iteration step)
+// instead of materializing a std::string per cell. Consumes all rows, so
+// it also works for streaming results.
+template <typename T>
+void extractIdColumn(lsst::qserv::sql::SqlResults& results, std::vector<T>& ids) {
+    for (auto rowIter = results.begin(), e = results.end(); rowIter != e; ++rowIter) {
+        // cells are guaranteed NUL-terminated by the mysql client library
+        ids.push_back(static_cast<T>(std::strtoull((*rowIter)[0].first, nullptr, 10)));
+    }
+}
 
 }
 
@@ -93,7 +106,11 @@ namespace qmeta {
 
 // Constructors
 QMetaMysql::QMetaMysql(mysql::MySqlConfig const& mysqlConf)
-  : QMeta(), _conn(mysqlConf) {
+  : QMetaMysql(std::make_shared<sql::SqlConnectionPool>(mysqlConf)) {
+}
+
+QMetaMysql::QMetaMysql(sql::SqlConnectionPool::Ptr const& connPool)
+  : QMeta(), _connPool(connPool) {
     // Check that database is in consistent state
     _checkDb();
 }
@@ -106,30 +123,28 @@ QMetaMysql::~QMetaMysql() {
 CzarId
 QMetaMysql::getCzarID(std::string const& name) {
 
-    std::lock_guard<std::mutex> sync(_dbMutex);
+    sql::SqlConnectionPool::Lease lease(_connPool);
+    sql::SqlConnection& conn = lease.conn();
 
-    QMetaTransaction trans(_conn);
+    QMetaTransaction trans(conn);
 
     // run query
     sql::SqlErrorObject errObj;
     sql::SqlResults results;
     std::string const query = "SELECT czarId FROM QCzar WHERE czar = '" + name +"'";
     LOGS(_log, LOG_LVL_DEBUG, "Executing query: " << query);
-    if (not _conn.runQuery(query, results, errObj)) {
+    if (not conn.runQuery(query, results, errObj)) {
         LOGS(_log, LOG_LVL_ERROR, "SQL query failed: " << query);
         throw SqlError(ERR_LOC, errObj);
     }
 
     // get results of the query
-    std::vector<std::string> ids;
-    if (not results.extractFirstColumn(ids, errObj)) {
-        LOGS(_log, LOG_LVL_ERROR, "Failed to extract czar ID from query result");
-        throw SqlError(ERR_LOC, errObj);
-    }
+    std::vector<CzarId> ids;
+    ::extractIdColumn(results, ids);
 
     trans.commit();
 
-    // check number of results and convert to integer
+    // check number of results
     if (ids.empty()) {
         LOGS(_log, LOG_LVL_DEBUG, "Result set is empty");
         return 0;
@@ -138,7 +153,7 @@ QMetaMysql::getCzarID(std::string const& name) {
                                ": " + boost::lexical_cast<std::string>(ids.size()));
     } else {
         LOGS(_log, LOG_LVL_DEBUG, "Found czar ID: " << ids[0]);
-        return boost::lexical_cast<CzarId>(ids[0]);
+        return ids[0];
     }
 }
 
@@ -146,28 +161,26 @@ QMetaMysql::getCzarID(std::string const& name) {
 CzarId
 QMetaMysql::registerCzar(std::string const& name) {
 
-    std::lock_guard<std::mutex> sync(_dbMutex);
+    sql::SqlConnectionPool::Lease lease(_connPool);
+    sql::SqlConnection& conn = lease.conn();
 
-    QMetaTransaction trans(_conn);
+    QMetaTransaction trans(conn);
 
     // check if czar is already defined
     sql::SqlErrorObject errObj;
     sql::SqlResults results;
     std::string query = "SELECT czarId FROM QCzar WHERE czar = '" + name +"'";
     LOGS(_log, LOG_LVL_DEBUG, "Executing query: " << query);
-    if (not _conn.runQuery(query, results, errObj)) {
+    if (not conn.runQuery(query, results, errObj)) {
         LOGS(_log, LOG_LVL_ERROR, "SQL query failed: " << query);
         throw SqlError(ERR_LOC, errObj);
     }
 
     // get results of the query
-    std::vector<std::string> ids;
-    if (not results.extractFirstColumn(ids, errObj)) {
-        LOGS(_log, LOG_LVL_ERROR, "Failed to extract czar ID from query result");
-        throw SqlError(ERR_LOC, errObj);
-    }
+    std::vector<CzarId> ids;
+    ::extractIdColumn(results, ids);
 
-    // check number of results and convert to integer
+    // check number of results
     CzarId czarId = 0;
     if (ids.size() > 1) {
         throw ConsistencyError(ERR_LOC, "More than one czar ID found for czar name " + name +
@@ -179,25 +192,26 @@ QMetaMysql::registerCzar(std::string const& name) {
         results.freeResults();
         query = "INSERT INTO QCzar (czar, active) VALUES ('" + name +"', b'1')";
         LOGS(_log, LOG_LVL_DEBUG, "Executing query: " << query);
-        if (not _conn.runQuery(query, results, errObj)) {
+        if (not conn.runQuery(query, results, errObj)) {
             LOGS(_log, LOG_LVL_ERROR, "SQL query failed: " << query);
             throw SqlError(ERR_LOC, errObj);
         }
-        auto newId = _conn.getInsertId();
+        auto newId = conn.getInsertId();
         LOGS(_log, LOG_LVL_DEBUG, "Created czar ID: " << newId);
         czarId = static_cast<CzarId>(newId);
 
     } else {
 
         // its exists, get its ID
-        czarId = boost::lexical_cast<CzarId>(ids[0]);
+        czarId = ids[0];
         LOGS(_log, LOG_LVL_DEBUG, "Use existing czar with ID: " << czarId);
 
         // make sure it's active
         results.freeResults();
-        query = "UPDATE QCzar SET active = b'1' WHERE czarId = " + ids[0];
+        query = "UPDATE QCzar SET active = b'1' WHERE czarId = "
+                + boost::lexical_cast<std::string>(czarId);
         LOGS(_log, LOG_LVL_DEBUG, "Executing query: " << query);
-        if (not _conn.runQuery(query, results, errObj)) {
+        if (not conn.runQuery(query, results, errObj)) {
             LOGS(_log, LOG_LVL_ERROR, "SQL query failed: " << query);
             throw SqlError(ERR_LOC, errObj);
         }
@@ -212,9 +226,10 @@ QMetaMysql::registerCzar(std::string const& name) {
 void
 QMetaMysql::setCzarActive(CzarId czarId, bool active) {
 
-    std::lock_guard<std::mutex> sync(_dbMutex);
+    sql::SqlConnectionPool::Lease lease(_connPool);
+    sql::SqlConnection& conn = lease.conn();
 
-    QMetaTransaction trans(_conn);
+    QMetaTransaction trans(conn);
 
     // run query
     sql::SqlErrorObject errObj;
@@ -223,7 +238,7 @@ QMetaMysql::setCzarActive(CzarId czarId, bool active) {
             std::string(active ? "1" : "0") +
             "' WHERE czarId = " + boost::lexical_cast<std::string>(czarId);
     LOGS(_log, LOG_LVL_DEBUG, "Executing query: " << query);
-    if (not _conn.runQuery(query, results, errObj)) {
+    if (not conn.runQuery(query, results, errObj)) {
         LOGS(_log, LOG_LVL_ERROR, "SQL query failed: " << query);
         throw SqlError(ERR_LOC, errObj);
     }
@@ -243,9 +258,10 @@ QMetaMysql::setCzarActive(CzarId czarId, bool active) {
 // Cleanup of query status.
 void
 QMetaMysql::cleanup(CzarId czarId) {
-    std::lock_guard<std::mutex> sync(_dbMutex);
+    sql::SqlConnectionPool::Lease lease(_connPool);
+    sql::SqlConnection& conn = lease.conn();
 
-    QMetaTransaction trans(_conn);
+    QMetaTransaction trans(conn);
 
     // run query
     sql::SqlErrorObject errObj;
@@ -254,7 +270,7 @@ QMetaMysql::cleanup(CzarId czarId) {
             " WHERE czarId = " + boost::lexical_cast<std::string>(czarId) +
             " AND status = 'EXECUTING'";
     LOGS(_log, LOG_LVL_DEBUG, "Executing query: " << query);
-    if (not _conn.runQuery(query, results, errObj)) {
+    if (not conn.runQuery(query, results, errObj)) {
         LOGS(_log, LOG_LVL_ERROR, "SQL query failed: " << query);
         throw SqlError(ERR_LOC, errObj);
     }
@@ -267,25 +283,26 @@ QueryId
 QMetaMysql::registerQuery(QInfo const& qInfo,
                           TableNames const& tables) {
 
-    std::lock_guard<std::mutex> sync(_dbMutex);
+    sql::SqlConnectionPool::Lease lease(_connPool);
+    sql::SqlConnection& conn = lease.conn();
 
-    QMetaTransaction trans(_conn);
+    QMetaTransaction trans(conn);
 
     // build query
     sql::SqlErrorObject errObj;
     std::string const qType(qInfo.queryType() == QInfo::SYNC ? "'SYNC'" : "'ASYNC'");
-    std::string const user = "'" + _conn.escapeString(qInfo.user()) + "'";
-    std::string const queryText = "'" + _conn.escapeString(qInfo.queryText()) + "'";
-    std::string const queryTemplate = "'" + _conn.escapeString(qInfo.queryTemplate()) + "'";
-    std::string const resultLocation = "'" + _conn.escapeString(qInfo.resultLocation()) + "'";
-    std::string const msgTableName = "'" + _conn.escapeString(qInfo.msgTableName()) + "'";
+    std::string const user = "'" + conn.escapeString(qInfo.user()) + "'";
+    std::string const queryText = "'" + conn.escapeString(qInfo.queryText()) + "'";
+    std::string const queryTemplate = "'" + conn.escapeString(qInfo.queryTemplate()) + "'";
+    std::string const resultLocation = "'" + conn.escapeString(qInfo.resultLocation()) + "'";
+    std::string const msgTableName = "'" + conn.escapeString(qInfo.msgTableName()) + "'";
     std::string qMerge = "NULL";
     if (not qInfo.mergeQuery().empty()) {
-        qMerge = "'" + _conn.escapeString(qInfo.mergeQuery()) + "'";
+        qMerge = "'" + conn.escapeString(qInfo.mergeQuery()) + "'";
     }
     std::string proxyOrderBy = "NULL";
     if (not qInfo.proxyOrderBy().empty()) {
-        proxyOrderBy = "'" + _conn.escapeString(qInfo.proxyOrderBy()) + "'";
+        proxyOrderBy = "'" + conn.escapeString(qInfo.proxyOrderBy()) + "'";
     }
     std::string query = "INSERT INTO QInfo (qType, czarId, user, query, qTemplate, qMerge, "
                         "proxyOrderBy, status, messageTable, resultLocation) VALUES (";
@@ -310,13 +327,13 @@ QMetaMysql::registerQuery(QInfo const& qInfo,
 
     // run query
     LOGS(_log, LOG_LVL_DEBUG, "Executing query: " << query);
-    if (not _conn.runQuery(query, errObj)) {
+    if (not conn.runQuery(query, errObj)) {
         LOGS(_log, LOG_LVL_ERROR, "SQL query failed: " << query);
         throw SqlError(ERR_LOC, errObj);
     }
 
     // return value of the auto-increment column
-    QueryId queryId = static_cast<QueryId>(_conn.getInsertId());
+    QueryId queryId = static_cast<QueryId>(conn.getInsertId());
     std::string qIdStr = QueryIdHelper::makeIdStr(queryId);
 
     // register all tables, first remove all duplicates from a list
@@ -326,13 +343,13 @@ QMetaMysql::registerQuery(QInfo const& qInfo,
         query = "INSERT INTO QTable (queryId, dbName, tblName) VALUES (";
         query += boost::lexical_cast<std::string>(queryId);
         query += ", '";
-        query += _conn.escapeString(itr->first);
+        query += conn.escapeString(itr->first);
         query += "', '";
-        query += _conn.escapeString(itr->second);
+        query += conn.escapeString(itr->second);
         query += "')";
 
         LOGS(_log, LOG_LVL_DEBUG, qIdStr << " Executing query: " << query);
-        if (not _conn.runQuery(query, errObj)) {
+        if (not conn.runQuery(query, errObj)) {
             LOGS(_log, LOG_LVL_ERROR, qIdStr << " SQL query failed: " << query);
             throw SqlError(ERR_LOC, errObj);
         }
@@ -347,24 +364,30 @@ QMetaMysql::registerQuery(QInfo const& qInfo,
 void
 QMetaMysql::addChunks(QueryId queryId, std::vector<int> const& chunks) {
 
-    std::lock_guard<std::mutex> sync(_dbMutex);
+    if (chunks.empty()) return;
+
+    sql::SqlConnectionPool::Lease lease(_connPool);
+    sql::SqlConnection& conn = lease.conn();
 
-    QMetaTransaction trans(_conn);
+    QMetaTransaction trans(conn);
 
-    // register all tables
+    // register all chunks with a single multi-row insert, queries can cover
+    // a very large number of chunks and per-row inserts take too long
     sql::SqlErrorObject errObj;
+    std::string query = "INSERT INTO QWorker (queryId, chunk) VALUES ";
     for (std::vector<int>::const_iterator itr = chunks.begin(); itr != chunks.end(); ++ itr) {
-        std::string query = "INSERT INTO QWorker (queryId, chunk) VALUES (";
+        if (itr != chunks.begin()) query += ", ";
+        query += "(";
         query += boost::lexical_cast<std::string>(queryId);
         query += ", ";
         query += boost::lexical_cast<std::string>(*itr);
         query += ")";
+    }
 
-        LOGS(_log, LOG_LVL_DEBUG, "Executing query: " << query);
-        if (not _conn.runQuery(query, errObj)) {
-            LOGS(_log, LOG_LVL_ERROR, "SQL query failed: " << query);
-            throw SqlError(ERR_LOC, errObj);
-        }
+    LOGS(_log, LOG_LVL_DEBUG, "Executing query: " << query);
+    if (not conn.runQuery(query, errObj)) {
+        LOGS(_log, LOG_LVL_ERROR, "SQL query failed: " << query);
+        throw SqlError(ERR_LOC, errObj);
     }
 
     trans.commit();
@@ -376,14 +399,15 @@ QMetaMysql::assignChunk(QueryId queryId,
                         int chunk,
                         std::string const& xrdEndpoint) {
 
-    std::lock_guard<std::mutex> sync(_dbMutex);
+    sql::SqlConnectionPool::Lease lease(_connPool);
+    sql::SqlConnection& conn = lease.conn();
 
-    QMetaTransaction trans(_conn);
+    QMetaTransaction trans(conn);
 
     // find and update chunk info
     sql::SqlErrorObject errObj;
     std::string query = "UPDATE QWorker SET wxrd = '";
-    query += _conn.escapeString(xrdEndpoint);
+    query += conn.escapeString(xrdEndpoint);
     query += "', submitted = NOW() WHERE queryId = ";
     query += boost::lexical_cast<std::string>(queryId);
     query += " AND chunk = ";
@@ -391,7 +415,7 @@ QMetaMysql::assignChunk(QueryId queryId,
 
     LOGS(_log, LOG_LVL_DEBUG, "Executing query: " << query);
     sql::SqlResults results;
-    if (not _conn.runQuery(query, results, errObj)) {
+    if (not conn.runQuery(query, results, errObj)) {
         LOGS(_log, LOG_LVL_ERROR, "SQL query failed: " << query);
         throw SqlError(ERR_LOC, errObj);
     }
@@ -413,9 +437,10 @@ QMetaMysql::assignChunk(QueryId queryId,
 void
 QMetaMysql::finishChunk(QueryId queryId, int chunk) {
 
-    std::lock_guard<std::mutex> sync(_dbMutex);
+    sql::SqlConnectionPool::Lease lease(_connPool);
+    sql::SqlConnection& conn = lease.conn();
 
-    QMetaTransaction trans(_conn);
+    QMetaTransaction trans(conn);
 
     // find and update query info
     sql::SqlErrorObject errObj;
@@ -426,7 +451,7 @@ QMetaMysql::finishChunk(QueryId queryId, int chunk) {
 
     LOGS(_log, LOG_LVL_DEBUG, "Executing query: " << query);
     sql::SqlResults results;
-    if (not _conn.runQuery(query, results, errObj)) {
+    if (not conn.runQuery(query, results, errObj)) {
         LOGS(_log, LOG_LVL_ERROR, "SQL query failed: " << query);
         throw SqlError(ERR_LOC, errObj);
     }
@@ -448,9 +473,10 @@ QMetaMysql::finishChunk(QueryId queryId, int chunk) {
 void
 QMetaMysql::completeQuery(QueryId queryId, QInfo::QStatus qStatus) {
 
-    std::lock_guard<std::mutex> sync(_dbMutex);
+    sql::SqlConnectionPool::Lease lease(_connPool);
+    sql::SqlConnection& conn = lease.conn();
 
-    QMetaTransaction trans(_conn);
+    QMetaTransaction trans(conn);
 
     // find and update query info
     std::string query = "UPDATE QInfo SET completed = NOW(), status = ";
@@ -461,7 +487,7 @@ QMetaMysql::completeQuery(QueryId queryId, QInfo::QStatus qStatus) {
     LOGS(_log, LOG_LVL_DEBUG, "Executing query: " << query);
     sql::SqlErrorObject errObj;
     sql::SqlResults results;
-    if (not _conn.runQuery(query, results, errObj)) {
+    if (not conn.runQuery(query, results, errObj)) {
         LOGS(_log, LOG_LVL_ERROR, "SQL query failed: " << query);
         throw SqlError(ERR_LOC, errObj);
     }
@@ -482,9 +508,10 @@ QMetaMysql::completeQuery(QueryId queryId, QInfo::QStatus qStatus) {
 void
 QMetaMysql::finishQuery(QueryId queryId) {
 
-    std::lock_guard<std::mutex> sync(_dbMutex);
+    sql::SqlConnectionPool::Lease lease(_connPool);
+    sql::SqlConnection& conn = lease.conn();
 
-    QMetaTransaction trans(_conn);
+    QMetaTransaction trans(conn);
 
     // find and update chunk info
     std::string query = "UPDATE QInfo SET returned = NOW() WHERE queryId = ";
@@ -493,7 +520,7 @@ QMetaMysql::finishQuery(QueryId queryId) {
     LOGS(_log, LOG_LVL_DEBUG, "Executing query: " << query);
     sql::SqlErrorObject errObj;
     sql::SqlResults results;
-    if (not _conn.runQuery(query, results, errObj)) {
+    if (not conn.runQuery(query, results, errObj)) {
         LOGS(_log, LOG_LVL_ERROR, "SQL query failed: " << query);
         throw SqlError(ERR_LOC, errObj);
     }
@@ -510,6 +537,169 @@ QMetaMysql::finishQuery(QueryId queryId) {
     trans.commit();
 }
 
+// Update execution progress of a running query.
+void
+QMetaMysql::updateQueryProgress(QProgress const& progress) {
+
+    sql::SqlConnectionPool::Lease lease(_connPool);
+    sql::SqlConnection& conn = lease.conn();
+
+    QMetaTransaction trans(conn);
+
+    // one statement creates the record or overwrites the previous snapshot,
+    // the record only ever needs the latest state
+    std::string query = "INSERT INTO QProgress (queryId, totalChunks, completedChunks, "
+            "rowsMerged, bytesMerged, estTimeLeftSec) VALUES (";
+    query += boost::lexical_cast<std::string>(progress.queryId);
+    query += ", ";
+    query += boost::lexical_cast<std::string>(progress.totalChunks);
+    query += ", ";
+    query += boost::lexical_cast<std::string>(progress.completedChunks);
+    query += ", ";
+    query += boost::lexical_cast<std::string>(progress.rowsMerged);
+    query += ", ";
+    query += boost::lexical_cast<std::string>(progress.bytesMerged);
+    query += ", ";
+    query += boost::lexical_cast<std::string>(progress.estTimeLeftSec);
+    query += ") ON DUPLICATE KEY UPDATE totalChunks = VALUES(totalChunks)";
+    query += ", completedChunks = VALUES(completedChunks)";
+    query += ", rowsMerged = VALUES(rowsMerged)";
+    query += ", bytesMerged = VALUES(bytesMerged)";
+    query += ", estTimeLeftSec = VALUES(estTimeLeftSec)";
+
+    LOGS(_log, LOG_LVL_DEBUG, "Executing query: " << query);
+    sql::SqlErrorObject errObj;
+    sql::SqlResults results;
+    if (not conn.runQuery(query, results, errObj)) {
+        LOGS(_log, LOG_LVL_ERROR, "SQL query failed: " << query);
+        throw SqlError(ERR_LOC, errObj);
+    }
+
+    trans.commit();
+}
+
+// Save per-query phase timing statistics.
+void
+QMetaMysql::saveQueryStats(QStats const& stats) {
+
+    sql::SqlConnectionPool::Lease lease(_connPool);
+    sql::SqlConnection& conn = lease.conn();
+
+    QMetaTransaction trans(conn);
+
+    std::string query = "INSERT INTO QStats (queryId, completedJobs, dispatchWaitMs, "
+            "workerQueueMs, mysqldMs, serializeMs, transferMs, mergeMs) VALUES (";
+    query += boost::lexical_cast<std::string>(stats.queryId);
+    query += ", ";
+    query += boost::lexical_cast<std::string>(stats.completedJobs);
+    query += ", ";
+    query += boost::lexical_cast<std::string>(stats.dispatchWaitMs);
+    query += ", ";
+    query += boost::lexical_cast<std::string>(stats.workerQueueMs);
+    query += ", ";
+    query += boost::lexical_cast<std::string>(stats.mysqldMs);
+    query += ", ";
+    query += boost::lexical_cast<std::string>(stats.serializeMs);
+    query += ", ";
+    query += boost::lexical_cast<std::string>(stats.transferMs);
+    query += ", ";
+    query += boost::lexical_cast<std::string>(stats.mergeMs);
+    query += ")";
+
+    LOGS(_log, LOG_LVL_DEBUG, "Executing query: " << query);
+    sql::SqlErrorObject errObj;
+    sql::SqlResults results;
+    if (not conn.runQuery(query, results, errObj)) {
+        LOGS(_log, LOG_LVL_ERROR, "SQL query failed: " << query);
+        throw SqlError(ERR_LOC, errObj);
+    }
+
+    trans.commit();
+}
+
+// Record one completed query against its shape history.
+void
+QMetaMysql::addQueryShapeStats(QShapeStats const& stats) {
+
+    sql::SqlConnectionPool::Lease lease(_connPool);
+    sql::SqlConnection& conn = lease.conn();
+
+    QMetaTransaction trans(conn);
+
+    // one statement creates the record or folds the observation into an
+    // existing one, so concurrent czars need no read-modify-write cycle
+    std::string query = "INSERT INTO QShapeStats (tableSet, shapeHash, queryCount, "
+            "chunkCount, rowCount, workerMs, mergeMs) VALUES ('";
+    query += conn.escapeString(stats.tableSet);
+    query += "', ";
+    query += boost::lexical_cast<std::string>(stats.shapeHash);
+    query += ", 1, ";
+    query += boost::lexical_cast<std::string>(stats.chunkCount);
+    query += ", ";
+    query += boost::lexical_cast<std::string>(stats.rowCount);
+    query += ", ";
+    query += boost::lexical_cast<std::string>(stats.workerMs);
+    query += ", ";
+    query += boost::lexical_cast<std::string>(stats.mergeMs);
+    query += ") ON DUPLICATE KEY UPDATE queryCount = queryCount + 1";
+    query += ", chunkCount = chunkCount + VALUES(chunkCount)";
+    query += ", rowCount = rowCount + VALUES(rowCount)";
+    query += ", workerMs = workerMs + VALUES(workerMs)";
+    query += ", mergeMs = mergeMs + VALUES(mergeMs)";
+
+    LOGS(_log, LOG_LVL_DEBUG, "Executing query: " << query);
+    sql::SqlErrorObject errObj;
+    sql::SqlResults results;
+    if (not conn.runQuery(query, results, errObj)) {
+        LOGS(_log, LOG_LVL_ERROR, "SQL query failed: " << query);
+        throw SqlError(ERR_LOC, errObj);
+    }
+
+    trans.commit();
+}
+
+// Retrieve historical statistics for a query shape.
+QShapeStats
+QMetaMysql::getQueryShapeStats(std::string const& tableSet, uint64_t shapeHash) {
+
+    QShapeStats stats;
+    stats.tableSet = tableSet;
+    stats.shapeHash = shapeHash;
+
+    sql::SqlConnectionPool::Lease lease(_connPool);
+    sql::SqlConnection& conn = lease.conn();
+
+    QMetaTransaction trans(conn);
+
+    sql::SqlErrorObject errObj;
+    sql::SqlResults results;
+    std::string query = "SELECT queryCount, chunkCount, rowCount, workerMs, mergeMs"
+            " FROM QShapeStats WHERE tableSet = '";
+    query += conn.escapeString(tableSet);
+    query += "' AND shapeHash = ";
+    query += boost::lexical_cast<std::string>(shapeHash);
+    LOGS(_log, LOG_LVL_DEBUG, "Executing query: " << query);
+    if (not conn.runQuery(query, results, errObj)) {
+        LOGS(_log, LOG_LVL_ERROR, "SQL query failed: " << query);
+        throw SqlError(ERR_LOC, errObj);
+    }
+
+    sql::SqlResults::iterator rowIter = results.begin();
+    if (rowIter != results.end()) {
+        sql::SqlResults::value_type const& row = *rowIter;
+        stats.queryCount = boost::lexical_cast<uint64_t>(row[0].first);
+        stats.chunkCount = boost::lexical_cast<uint64_t>(row[1].first);
+        stats.rowCount = boost::lexical_cast<uint64_t>(row[2].first);
+        stats.workerMs = boost::lexical_cast<uint64_t>(row[3].first);
+        stats.mergeMs = boost::lexical_cast<uint64_t>(row[4].first);
+    }
+    // no row means no history, which the zeroed queryCount already conveys
+
+    trans.commit();
+
+    return stats;
+}
+
 // Generic interface for finding queries.
 std::vector<QueryId>
 QMetaMysql::findQueries(CzarId czarId,
@@ -519,11 +709,12 @@ QMetaMysql::findQueries(CzarId czarId,
                         int completed,
                         int returned) {
 
-    std::lock_guard<std::mutex> sync(_dbMutex);
+    sql::SqlConnectionPool::Lease lease(_connPool);
+    sql::SqlConnection& conn = lease.conn();
 
     std::vector<QueryId> result;
 
-    QMetaTransaction trans(_conn);
+    QMetaTransaction trans(conn);
 
     // all conditions for query
     std::vector<std::string> cond;
@@ -535,7 +726,7 @@ QMetaMysql::findQueries(CzarId czarId,
         cond.push_back("qType = '" + qTypeStr + "'");
     }
     if (not user.empty()) {
-        cond.push_back("user = '" + _conn.escapeString(user) + "'");
+        cond.push_back("user = '" + conn.escapeString(user) + "'");
     }
     if (not status.empty()) {
         std::string condStr = "status IN (";
@@ -566,25 +757,17 @@ QMetaMysql::findQueries(CzarId czarId,
         query += *itr;
     }
     LOGS(_log, LOG_LVL_DEBUG, "Executing query: " << query);
-    if (not _conn.runQuery(query, results, errObj)) {
+    if (not conn.runQueryStreaming(query, results, errObj)) {
         LOGS(_log, LOG_LVL_ERROR, "SQL query failed: " << query);
         throw SqlError(ERR_LOC, errObj);
     }
 
-    // get results of the query
-    std::vector<std::string> ids;
-    if (not results.extractFirstColumn(ids, errObj)) {
-        LOGS(_log, LOG_LVL_ERROR, "Failed to extract query ID from query result");
-        throw SqlError(ERR_LOC, errObj);
-    }
+    // get results of the query; the streamed rows must be fully
+    // consumed before anything else runs on this connection
+    ::extractIdColumn(results, result);
 
     trans.commit();
 
-    // convert strings to numbers
-    result.reserve(ids.size());
-    std::transform(ids.begin(), ids.end(), std::back_inserter(result),
-                   boost::lexical_cast<QueryId, std::string>);
-
     return result;
 }
 
@@ -594,9 +777,10 @@ QMetaMysql::getPendingQueries(CzarId czarId) {
 
     std::vector<QueryId> result;
 
-    std::lock_guard<std::mutex> sync(_dbMutex);
+    sql::SqlConnectionPool::Lease lease(_connPool);
+    sql::SqlConnection& conn = lease.conn();
 
-    QMetaTransaction trans(_conn);
+    QMetaTransaction trans(conn);
 
     // run query
     sql::SqlErrorObject errObj;
@@ -605,25 +789,17 @@ QMetaMysql::getPendingQueries(CzarId czarId) {
     query += boost::lexical_cast<std::string>(czarId);
     query += " AND returned IS NULL";
     LOGS(_log, LOG_LVL_DEBUG, "Executing query: " << query);
-    if (not _conn.runQuery(query, results, errObj)) {
+    if (not conn.runQueryStreaming(query, results, errObj)) {
         LOGS(_log, LOG_LVL_ERROR, "SQL query failed: " << query);
         throw SqlError(ERR_LOC, errObj);
     }
 
-    // get results of the query
-    std::vector<std::string> ids;
-    if (not results.extractFirstColumn(ids, errObj)) {
-        LOGS(_log, LOG_LVL_ERROR, "Failed to extract query ID from query result");
-        throw SqlError(ERR_LOC, errObj);
-    }
+    // get results of the query; the streamed rows must be fully
+    // consumed before anything else runs on this connection
+    ::extractIdColumn(results, result);
 
     trans.commit();
 
-    // convert strings to numbers
-    result.reserve(ids.size());
-    std::transform(ids.begin(), ids.end(), std::back_inserter(result),
-                   boost::lexical_cast<QueryId, std::string>);
-
     return result;
 }
 
@@ -631,9 +807,10 @@ QMetaMysql::getPendingQueries(CzarId czarId) {
 QInfo
 QMetaMysql::getQueryInfo(QueryId queryId) {
 
-    std::lock_guard<std::mutex> sync(_dbMutex);
+    sql::SqlConnectionPool::Lease lease(_connPool);
+    sql::SqlConnection& conn = lease.conn();
 
-    QMetaTransaction trans(_conn);
+    QMetaTransaction trans(conn);
 
     // run query
     sql::SqlErrorObject errObj;
@@ -644,7 +821,7 @@ QMetaMysql::getQueryInfo(QueryId queryId) {
             " FROM QInfo WHERE queryId = ";
     query += boost::lexical_cast<std::string>(queryId);
     LOGS(_log, LOG_LVL_DEBUG, "Executing query: " << query);
-    if (not _conn.runQuery(query, results, errObj)) {
+    if (not conn.runQuery(query, results, errObj)) {
         LOGS(_log, LOG_LVL_ERROR, "SQL query failed: " << query);
         throw SqlError(ERR_LOC, errObj);
     }
@@ -695,36 +872,29 @@ QMetaMysql::getQueriesForDb(std::string const& dbName) {
 
     std::vector<QueryId> result;
 
-    std::lock_guard<std::mutex> sync(_dbMutex);
+    sql::SqlConnectionPool::Lease lease(_connPool);
+    sql::SqlConnection& conn = lease.conn();
 
-    QMetaTransaction trans(_conn);
+    QMetaTransaction trans(conn);
 
     // run query
     sql::SqlErrorObject errObj;
     sql::SqlResults results;
     std::string query = "SELECT QInfo.queryId FROM QInfo NATURAL JOIN QTable WHERE QTable.dbName = '";
-    query += _conn.escapeString(dbName);
+    query += conn.escapeString(dbName);
     query += "' AND QInfo.completed IS NULL";
     LOGS(_log, LOG_LVL_DEBUG, "Executing query: " << query);
-    if (not _conn.runQuery(query, results, errObj)) {
+    if (not conn.runQueryStreaming(query, results, errObj)) {
         LOGS(_log, LOG_LVL_ERROR, "SQL query failed: " << query);
         throw SqlError(ERR_LOC, errObj);
     }
 
-    // get results of the query
-    std::vector<std::string> ids;
-    if (not results.extractFirstColumn(ids, errObj)) {
-        LOGS(_log, LOG_LVL_ERROR, "Failed to extract query ID from query result");
-        throw SqlError(ERR_LOC, errObj);
-    }
+    // get results of the query; the streamed rows must be fully
+    // consumed before anything else runs on this connection
+    ::extractIdColumn(results, result);
 
     trans.commit();
 
-    // convert strings to numbers
-    result.reserve(ids.size());
-    std::transform(ids.begin(), ids.end(), std::back_inserter(result),
-                   boost::lexical_cast<QueryId, std::string>);
-
     return result;
 }
 
@@ -735,38 +905,31 @@ QMetaMysql::getQueriesForTable(std::string const& dbName,
 
     std::vector<QueryId> result;
 
-    std::lock_guard<std::mutex> sync(_dbMutex);
+    sql::SqlConnectionPool::Lease lease(_connPool);
+    sql::SqlConnection& conn = lease.conn();
 
-    QMetaTransaction trans(_conn);
+    QMetaTransaction trans(conn);
 
     // run query
     sql::SqlErrorObject errObj;
     sql::SqlResults results;
     std::string query = "SELECT QInfo.queryId FROM QInfo NATURAL JOIN QTable WHERE QTable.dbName = '";
-    query += _conn.escapeString(dbName);
+    query += conn.escapeString(dbName);
     query += "' AND QTable.tblName = '";
-    query += _conn.escapeString(tableName);
+    query += conn.escapeString(tableName);
     query += "' AND QInfo.completed IS NULL";
     LOGS(_log, LOG_LVL_DEBUG, "Executing query: " << query);
-    if (not _conn.runQuery(query, results, errObj)) {
+    if (not conn.runQueryStreaming(query, results, errObj)) {
         LOGS(_log, LOG_LVL_ERROR, "SQL query failed: " << query);
         throw SqlError(ERR_LOC, errObj);
     }
 
-    // get results of the query
-    std::vector<std::string> ids;
-    if (not results.extractFirstColumn(ids, errObj)) {
-        LOGS(_log, LOG_LVL_ERROR, "Failed to extract query ID from query result");
-        throw SqlError(ERR_LOC, errObj);
-    }
+    // get results of the query; the streamed rows must be fully
+    // consumed before anything else runs on this connection
+    ::extractIdColumn(results, result);
 
     trans.commit();
 
-    // convert strings to numbers
-    result.reserve(ids.size());
-    std::transform(ids.begin(), ids.end(), std::back_inserter(result),
-                   boost::lexical_cast<QueryId, std::string>);
-
     return result;
 }
 
@@ -774,19 +937,21 @@ QMetaMysql::getQueriesForTable(std::string const& dbName,
 void
 QMetaMysql::_checkDb() {
 
-    // this is only called from constructor, no locking is needed here
+    sql::SqlConnectionPool::Lease lease(_connPool);
+    sql::SqlConnection& conn = lease.conn();
 
     std::vector<std::string> tables;
     sql::SqlErrorObject errObj;
-    if (not _conn.listTables(tables, errObj)) {
+    if (not conn.listTables(tables, errObj)) {
         // likely failed to connect to server or database is missing
         LOGS(_log, LOG_LVL_ERROR, "Failed to connect to query metadata database, check that "
-             "server is running and database " << _conn.getActiveDbName() << " exists");
+             "server is running and database " << conn.getActiveDbName() << " exists");
         throw SqlError(ERR_LOC, errObj);
     }
 
     // check that all tables are there
-    char const* requiredTables[] = {"QCzar", "QInfo", "QTable", "QWorker", "QMetadata"};
+    char const* requiredTables[] = {"QCzar", "QInfo", "QTable", "QWorker", "QMetadata", "QStats",
+                                    "QShapeStats"};
     int const nTables = sizeof requiredTables / sizeof requiredTables[0];
     for (int i = 0; i != nTables; ++ i) {
         char const* const table = requiredTables[i];
@@ -799,7 +964,7 @@ QMetaMysql::_checkDb() {
     // check schema version
     sql::SqlResults results;
     std::string query = "SELECT value FROM QMetadata WHERE metakey = 'version'";
-    if (not _conn.runQuery(query, results, errObj)) {
+    if (not conn.runQuery(query, results, errObj)) {
         LOGS(_log, LOG_LVL_ERROR, "SQL query failed: " << query);
         throw SqlError(ERR_LOC, errObj);
     }
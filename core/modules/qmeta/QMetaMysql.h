@@ -23,14 +23,13 @@
 #define LSST_QSERV_QMETA_QMETAMYSQL_H
 
 // System headers
-#include <mutex>
 
 // Third-party headers
 
 // Qserv headers
 #include "mysql/MySqlConfig.h"
 #include "qmeta/QMeta.h"
-#include "sql/SqlConnection.h"
+#include "sql/SqlConnectionPool.h"
 
 namespace lsst {
 namespace qserv {
@@ -52,6 +51,12 @@ public:
      */
     QMetaMysql(mysql::MySqlConfig const& mysqlConf);
 
+    /**
+     *  @param connPool: Connection pool, may be shared with other clients
+     *                   of the same database.
+     */
+    explicit QMetaMysql(sql::SqlConnectionPool::Ptr const& connPool);
+
     // Instances cannot be copied
     QMetaMysql(QMetaMysql const&) = delete;
     QMetaMysql& operator=(QMetaMysql const&) = delete;
@@ -170,6 +175,43 @@ public:
      */
     virtual void finishQuery(QueryId queryId) override;
 
+    /**
+     *  @brief Update execution progress of a running query.
+     *
+     *  This method will throw if query ID is not known.
+     *
+     *  @param progress:   Progress snapshot, progress.queryId must be set.
+     */
+    virtual void updateQueryProgress(QProgress const& progress) override;
+
+    /**
+     *  @brief Save per-query phase timing statistics.
+     *
+     *  This method will throw if query ID is not known.
+     *
+     *  @param stats:   Timing statistics, stats.queryId must be set.
+     */
+    virtual void saveQueryStats(QStats const& stats) override;
+
+    /**
+     *  @brief Record one completed query against its shape history.
+     *
+     *  @param stats:   One query's observation, tableSet and shapeHash
+     *                  must be set.
+     */
+    virtual void addQueryShapeStats(QShapeStats const& stats) override;
+
+    /**
+     *  @brief Retrieve historical statistics for a query shape.
+     *
+     *  Returns a record with queryCount == 0 when the shape has no history.
+     *
+     *  @param tableSet:   Canonical table list.
+     *  @param shapeHash:  Query template hash.
+     */
+    virtual QShapeStats getQueryShapeStats(std::string const& tableSet,
+                                           uint64_t shapeHash) override;
+
     /**
      *  @brief Generic interface for finding queries.
      *
@@ -255,8 +297,7 @@ protected:
 
 private:
 
-    sql::SqlConnection _conn;
-    std::mutex _dbMutex;    ///< Synchronizes access to certain DB operations
+    sql::SqlConnectionPool::Ptr _connPool;
 
 };
 
@@ -68,4 +68,19 @@ QMetaSelect::select(std::string const& query) {
     return results;
 }
 
+std::unique_ptr<sql::SqlResults>
+QMetaSelect::selectStreaming(std::string const& query) {
+
+    // run query, rows are fetched lazily as the result set is iterated
+    sql::SqlErrorObject errObj;
+    std::unique_ptr<sql::SqlResults> results(new sql::SqlResults);
+    LOGS(_log, LOG_LVL_DEBUG, "Executing query (streaming): " << query);
+    if (not _conn.runQueryStreaming(query, *results, errObj)) {
+        LOGS(_log, LOG_LVL_ERROR, "SQL query failed: " << query);
+        throw SqlError(ERR_LOC, errObj);
+    }
+
+    return results;
+}
+
 }}} // namespace lsst::qserv::qmeta
@@ -77,6 +77,21 @@ public:
      */
     virtual std::unique_ptr<sql::SqlResults> select(std::string const& query);
 
+    /**
+     *  @brief Streaming variant of select().
+     *
+     *  Rows are fetched from the server as the returned result set is
+     *  iterated instead of being materialized client-side first. Note
+     *  that the connection stays busy until all rows have been iterated
+     *  or the result set is destroyed, so callers should drain the rows
+     *  promptly.
+     *
+     *  @param query:   Complete SQL query.
+     *  @returns SqlResults instance
+     *  @throws SqlError
+     */
+    virtual std::unique_ptr<sql::SqlResults> selectStreaming(std::string const& query);
+
 protected:
 
     sql::SqlConnection _conn;
@@ -0,0 +1,324 @@
+/*
+ * LSST Data Management System
+ * Copyright 2017 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "qmeta/QMetaWriteBehind.h"
+
+// System headers
+#include <utility>
+
+// Third-party headers
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+// Qserv headers
+#include "qmeta/Exceptions.h"
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.qmeta.QMetaWriteBehind");
+
+}
+
+namespace lsst {
+namespace qserv {
+namespace qmeta {
+
+// Constructor
+QMetaWriteBehind::QMetaWriteBehind(std::shared_ptr<QMeta> const& qMeta)
+    : _qMeta(qMeta), _thread(&QMetaWriteBehind::_run, this) {
+}
+
+// Destructor
+QMetaWriteBehind::~QMetaWriteBehind() {
+    {
+        std::lock_guard<std::mutex> lock(_queueMtx);
+        _stop = true;
+    }
+    _queueCv.notify_all();
+    _thread.join();
+}
+
+// Return czar ID given czar "name".
+CzarId
+QMetaWriteBehind::getCzarID(std::string const& name) {
+    return _qMeta->getCzarID(name);
+}
+
+// Register new czar, return czar ID.
+CzarId
+QMetaWriteBehind::registerCzar(std::string const& name) {
+    return _qMeta->registerCzar(name);
+}
+
+// Mark specified czar as active or inactive.
+void
+QMetaWriteBehind::setCzarActive(CzarId czarId, bool active) {
+    _qMeta->setCzarActive(czarId, active);
+}
+
+// Cleanup of query status.
+void
+QMetaWriteBehind::cleanup(CzarId czarId) {
+    _drain();
+    _qMeta->cleanup(czarId);
+}
+
+// Register new query.
+QueryId
+QMetaWriteBehind::registerQuery(QInfo const& qInfo,
+                                TableNames const& tables) {
+    // caller needs the new query ID, so this stays synchronous
+    return _qMeta->registerQuery(qInfo, tables);
+}
+
+// Add list of chunks to query.
+void
+QMetaWriteBehind::addChunks(QueryId queryId, std::vector<int> const& chunks) {
+    Op op;
+    op.type = Op::ADD_CHUNKS;
+    op.queryId = queryId;
+    op.chunks = chunks;
+    _enqueue(std::move(op));
+}
+
+// Assign or re-assign chunk to a worker.
+void
+QMetaWriteBehind::assignChunk(QueryId queryId,
+                              int chunk,
+                              std::string const& xrdEndpoint) {
+    Op op;
+    op.type = Op::ASSIGN_CHUNK;
+    op.queryId = queryId;
+    op.chunk = chunk;
+    op.xrdEndpoint = xrdEndpoint;
+    _enqueue(std::move(op));
+}
+
+// Mark chunk as completed.
+void
+QMetaWriteBehind::finishChunk(QueryId queryId, int chunk) {
+    Op op;
+    op.type = Op::FINISH_CHUNK;
+    op.queryId = queryId;
+    op.chunk = chunk;
+    _enqueue(std::move(op));
+}
+
+// Mark query as completed or failed.
+void
+QMetaWriteBehind::completeQuery(QueryId queryId, QInfo::QStatus qStatus) {
+    Op op;
+    op.type = Op::COMPLETE_QUERY;
+    op.queryId = queryId;
+    op.qStatus = qStatus;
+    _enqueue(std::move(op));
+}
+
+// Mark query as finished and returned to client.
+void
+QMetaWriteBehind::finishQuery(QueryId queryId) {
+    Op op;
+    op.type = Op::FINISH_QUERY;
+    op.queryId = queryId;
+    _enqueue(std::move(op));
+}
+
+// Update execution progress of a running query.
+void
+QMetaWriteBehind::updateQueryProgress(QProgress const& progress) {
+    Op op;
+    op.type = Op::UPDATE_PROGRESS;
+    op.queryId = progress.queryId;
+    op.progress = progress;
+    _enqueue(std::move(op));
+}
+
+// Save per-query phase timing statistics.
+void
+QMetaWriteBehind::saveQueryStats(QStats const& stats) {
+    Op op;
+    op.type = Op::SAVE_STATS;
+    op.queryId = stats.queryId;
+    op.stats = stats;
+    _enqueue(std::move(op));
+}
+
+// Record one completed query against its shape history.
+void
+QMetaWriteBehind::addQueryShapeStats(QShapeStats const& stats) {
+    Op op;
+    op.type = Op::SHAPE_STATS;
+    op.queryId = 0; // shape records are not tied to one query
+    op.shapeStats = stats;
+    _enqueue(std::move(op));
+}
+
+// Retrieve historical statistics for a query shape.
+QShapeStats
+QMetaWriteBehind::getQueryShapeStats(std::string const& tableSet,
+                                     uint64_t shapeHash) {
+    _drain();
+    return _qMeta->getQueryShapeStats(tableSet, shapeHash);
+}
+
+// Generic interface for finding queries.
+std::vector<QueryId>
+QMetaWriteBehind::findQueries(CzarId czarId,
+                              QInfo::QType qType,
+                              std::string const& user,
+                              std::vector<QInfo::QStatus> const& status,
+                              int completed,
+                              int returned) {
+    _drain();
+    return _qMeta->findQueries(czarId, qType, user, status, completed, returned);
+}
+
+// Find all pending queries for given czar.
+std::vector<QueryId>
+QMetaWriteBehind::getPendingQueries(CzarId czarId) {
+    _drain();
+    return _qMeta->getPendingQueries(czarId);
+}
+
+// Get full query information.
+QInfo
+QMetaWriteBehind::getQueryInfo(QueryId queryId) {
+    _drain();
+    return _qMeta->getQueryInfo(queryId);
+}
+
+// Get queries which use specified database.
+std::vector<QueryId>
+QMetaWriteBehind::getQueriesForDb(std::string const& dbName) {
+    _drain();
+    return _qMeta->getQueriesForDb(dbName);
+}
+
+// Get queries which use specified table.
+std::vector<QueryId>
+QMetaWriteBehind::getQueriesForTable(std::string const& dbName,
+                                     std::string const& tableName) {
+    _drain();
+    return _qMeta->getQueriesForTable(dbName, tableName);
+}
+
+// Add update to the queue.
+void
+QMetaWriteBehind::_enqueue(Op op) {
+    {
+        std::lock_guard<std::mutex> lock(_queueMtx);
+        if (op.type == Op::ADD_CHUNKS and not _queue.empty()) {
+            // coalesce with the last queued chunk registration for the same
+            // query, the wrapped instance turns the combined list into a
+            // single statement
+            Op& last = _queue.back();
+            if (last.type == Op::ADD_CHUNKS and last.queryId == op.queryId) {
+                last.chunks.insert(last.chunks.end(), op.chunks.begin(), op.chunks.end());
+                return;
+            }
+        }
+        if (op.type == Op::UPDATE_PROGRESS and not _queue.empty()) {
+            // only the latest snapshot matters, replace a still-queued one
+            // for the same query instead of applying both
+            Op& last = _queue.back();
+            if (last.type == Op::UPDATE_PROGRESS and last.queryId == op.queryId) {
+                last.progress = op.progress;
+                return;
+            }
+        }
+        _queue.push_back(std::move(op));
+    }
+    _queueCv.notify_all();
+}
+
+// Wait until all queued updates have been applied.
+void
+QMetaWriteBehind::_drain() {
+    std::unique_lock<std::mutex> lock(_queueMtx);
+    _queueCv.wait(lock, [this]() { return _queue.empty() and not _busy; });
+}
+
+// Apply single update to the wrapped instance.
+void
+QMetaWriteBehind::_apply(Op const& op) {
+    try {
+        switch (op.type) {
+        case Op::ADD_CHUNKS:
+            _qMeta->addChunks(op.queryId, op.chunks);
+            break;
+        case Op::ASSIGN_CHUNK:
+            _qMeta->assignChunk(op.queryId, op.chunk, op.xrdEndpoint);
+            break;
+        case Op::FINISH_CHUNK:
+            _qMeta->finishChunk(op.queryId, op.chunk);
+            break;
+        case Op::COMPLETE_QUERY:
+            _qMeta->completeQuery(op.queryId, op.qStatus);
+            break;
+        case Op::FINISH_QUERY:
+            _qMeta->finishQuery(op.queryId);
+            break;
+        case Op::UPDATE_PROGRESS:
+            _qMeta->updateQueryProgress(op.progress);
+            break;
+        case Op::SAVE_STATS:
+            _qMeta->saveQueryStats(op.stats);
+            break;
+        case Op::SHAPE_STATS:
+            _qMeta->addQueryShapeStats(op.shapeStats);
+            break;
+        }
+    } catch (std::exception const& exc) {
+        // nobody to report this to, query execution must not depend on
+        // qmeta bookkeeping
+        LOGS(_log, LOG_LVL_ERROR, "queued QMeta update failed for query "
+             << op.queryId << ": " << exc.what());
+    }
+}
+
+// Background thread loop.
+void
+QMetaWriteBehind::_run() {
+    std::unique_lock<std::mutex> lock(_queueMtx);
+    while (true) {
+        _queueCv.wait(lock, [this]() { return not _queue.empty() or _stop; });
+        if (_queue.empty()) break;
+        Op op = std::move(_queue.front());
+        _queue.pop_front();
+        _busy = true;
+
+        // do not hold the lock over the database round-trip
+        lock.unlock();
+        _apply(op);
+        lock.lock();
+
+        _busy = false;
+        if (_queue.empty()) {
+            // wake up threads waiting in _drain()
+            _queueCv.notify_all();
+        }
+    }
+}
+
+}}} // namespace lsst::qserv::qmeta
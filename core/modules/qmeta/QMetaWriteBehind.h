@@ -0,0 +1,253 @@
+/*
+ * LSST Data Management System
+ * Copyright 2017 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_QMETA_QMETAWRITEBEHIND_H
+#define LSST_QSERV_QMETA_QMETAWRITEBEHIND_H
+
+// System headers
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// Third-party headers
+
+// Qserv headers
+#include "qmeta/QMeta.h"
+
+namespace lsst {
+namespace qserv {
+namespace qmeta {
+
+/// @addtogroup qmeta
+
+/**
+ *  @ingroup qmeta
+ *
+ *  @brief Write-behind decorator for QMeta implementations.
+ *
+ *  Status updates (chunk registration, chunk/query completion) are pure
+ *  bookkeeping - their result is never needed by the caller - but each of
+ *  them costs a synchronous database transaction when issued directly
+ *  against QMetaMysql. This class queues those updates and applies them to
+ *  the wrapped instance from a background thread so that they leave the
+ *  query critical path. Updates for the same query are applied in the order
+ *  they were queued, and consecutive addChunks() calls for the same query
+ *  are coalesced into a single call. Errors from queued updates cannot be
+ *  reported to the caller and are only logged.
+ *
+ *  Methods which return data to the caller (registerQuery and all query
+ *  methods) are passed through to the wrapped instance, the query methods
+ *  wait for the queue to drain first so that callers see their own updates.
+ */
+
+class QMetaWriteBehind : public QMeta {
+public:
+
+    /**
+     *  @param qMeta: Wrapped instance which does the actual work.
+     */
+    QMetaWriteBehind(std::shared_ptr<QMeta> const& qMeta);
+
+    // Instances cannot be copied
+    QMetaWriteBehind(QMetaWriteBehind const&) = delete;
+    QMetaWriteBehind& operator=(QMetaWriteBehind const&) = delete;
+
+    /// Destructor waits until all queued updates have been applied.
+    virtual ~QMetaWriteBehind();
+
+    /// @see QMeta::getCzarID()
+    virtual CzarId getCzarID(std::string const& name) override;
+
+    /// @see QMeta::registerCzar()
+    virtual CzarId registerCzar(std::string const& name) override;
+
+    /// @see QMeta::setCzarActive()
+    virtual void setCzarActive(CzarId czarId, bool active) override;
+
+    /// @see QMeta::cleanup()
+    void cleanup(CzarId czarId) override;
+
+    /// @see QMeta::registerQuery()
+    virtual QueryId registerQuery(QInfo const& qInfo,
+                                  TableNames const& tables) override;
+
+    /**
+     *  @brief Add list of chunks to query.
+     *
+     *  The update is queued and applied in the background, errors
+     *  (including unknown query ID) are only logged.
+     *
+     *  @param queryId:   Query ID, non-negative number.
+     *  @param chunks:    Set of chunk numbers.
+     */
+    virtual void addChunks(QueryId queryId, std::vector<int> const& chunks) override;
+
+    /**
+     *  @brief Assign or re-assign chunk to a worker.
+     *
+     *  The update is queued and applied in the background, errors
+     *  (including unknown query ID or chunk number) are only logged.
+     *
+     *  @param queryId:   Query ID, non-negative number.
+     *  @param chunk:     Chunk number.
+     *  @param xrdEndpoint:  Worker xrootd communication endpoint ("host:port").
+     */
+    virtual void assignChunk(QueryId queryId,
+                             int chunk,
+                             std::string const& xrdEndpoint) override;
+
+    /**
+     *  @brief Mark chunk as completed.
+     *
+     *  The update is queued and applied in the background, errors
+     *  (including unknown query ID or chunk number) are only logged.
+     *
+     *  @param queryId:   Query ID, non-negative number.
+     *  @param chunk:     Sequence of chunk numbers.
+     */
+    virtual void finishChunk(QueryId queryId, int chunk) override;
+
+    /**
+     *  @brief Mark query as completed or failed.
+     *
+     *  The update is queued and applied in the background, errors
+     *  (including unknown query ID) are only logged.
+     *
+     *  @param queryId:   Query ID, non-negative number.
+     *  @param qStatus:   Query completion status, one of COMPLETED, FAILED, or ABORTED.
+     */
+    virtual void completeQuery(QueryId queryId, QInfo::QStatus qStatus) override;
+
+    /**
+     *  @brief Mark query as finished and returned to client.
+     *
+     *  The update is queued and applied in the background, errors
+     *  (including unknown query ID) are only logged.
+     *
+     *  @param queryId:   Query ID, non-negative number.
+     */
+    virtual void finishQuery(QueryId queryId) override;
+
+    /**
+     *  @brief Update execution progress of a running query.
+     *
+     *  The update is queued and applied in the background, errors
+     *  (including unknown query ID) are only logged. A snapshot still
+     *  queued when the next one for the same query arrives is replaced by
+     *  it, only the latest state matters.
+     *
+     *  @param progress:   Progress snapshot, progress.queryId must be set.
+     */
+    virtual void updateQueryProgress(QProgress const& progress) override;
+
+    /**
+     *  @brief Save per-query phase timing statistics.
+     *
+     *  The update is queued and applied in the background, errors
+     *  (including unknown query ID) are only logged.
+     *
+     *  @param stats:   Timing statistics, stats.queryId must be set.
+     */
+    virtual void saveQueryStats(QStats const& stats) override;
+
+    /**
+     *  @brief Record one completed query against its shape history.
+     *
+     *  The update is queued and applied in the background, errors are
+     *  only logged.
+     *
+     *  @param stats:   One query's observation, tableSet and shapeHash
+     *                  must be set.
+     */
+    virtual void addQueryShapeStats(QShapeStats const& stats) override;
+
+    /// @see QMeta::getQueryShapeStats()
+    virtual QShapeStats getQueryShapeStats(std::string const& tableSet,
+                                           uint64_t shapeHash) override;
+
+    /// @see QMeta::findQueries()
+    virtual std::vector<QueryId> findQueries(CzarId czarId=0,
+                                             QInfo::QType qType=QInfo::ANY,
+                                             std::string const& user=std::string(),
+                                             std::vector<QInfo::QStatus> const& status=std::vector<QInfo::QStatus>(),
+                                             int completed=-1,
+                                             int returned=-1) override;
+
+    /// @see QMeta::getPendingQueries()
+    virtual std::vector<QueryId> getPendingQueries(CzarId czarId) override;
+
+    /// @see QMeta::getQueryInfo()
+    virtual QInfo getQueryInfo(QueryId queryId) override;
+
+    /// @see QMeta::getQueriesForDb()
+    virtual std::vector<QueryId> getQueriesForDb(std::string const& dbName) override;
+
+    /// @see QMeta::getQueriesForTable()
+    virtual std::vector<QueryId> getQueriesForTable(std::string const& dbName,
+                                                    std::string const& tableName) override;
+
+private:
+
+    /// One queued update.
+    struct Op {
+        enum Type { ADD_CHUNKS, ASSIGN_CHUNK, FINISH_CHUNK, COMPLETE_QUERY, FINISH_QUERY,
+                    UPDATE_PROGRESS, SAVE_STATS, SHAPE_STATS };
+
+        Type type;
+        QueryId queryId;
+        std::vector<int> chunks;        ///< ADD_CHUNKS only
+        int chunk = -1;                 ///< ASSIGN_CHUNK and FINISH_CHUNK only
+        std::string xrdEndpoint;        ///< ASSIGN_CHUNK only
+        QInfo::QStatus qStatus = QInfo::FAILED;     ///< COMPLETE_QUERY only
+        QProgress progress;             ///< UPDATE_PROGRESS only
+        QStats stats;                   ///< SAVE_STATS only
+        QShapeStats shapeStats;         ///< SHAPE_STATS only
+    };
+
+    /// Add update to the queue, wakes up the background thread.
+    void _enqueue(Op op);
+
+    /// Wait until all queued updates have been applied.
+    void _drain();
+
+    /// Apply single update to the wrapped instance, exceptions are
+    /// caught and logged. Runs on the background thread.
+    void _apply(Op const& op);
+
+    /// Background thread loop, stops when _stop is set and queue is empty.
+    void _run();
+
+    std::shared_ptr<QMeta> _qMeta;      ///< Wrapped instance
+
+    std::mutex _queueMtx;               ///< Protects all members below
+    std::condition_variable _queueCv;
+    std::deque<Op> _queue;
+    bool _busy = false;                 ///< True while an update is being applied
+    bool _stop = false;                 ///< Tells background thread to quit
+
+    std::thread _thread;    // must be declared last, runs on members above
+};
+
+}}} // namespace lsst::qserv::qmeta
+
+#endif // LSST_QSERV_QMETA_QMETAWRITEBEHIND_H
@@ -0,0 +1,59 @@
+/*
+ * LSST Data Management System
+ * Copyright 2018 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_QMETA_QPROGRESS_H
+#define LSST_QSERV_QMETA_QPROGRESS_H
+
+// System headers
+#include <cstdint>
+
+// Qserv headers
+#include "qmeta/types.h"
+
+namespace lsst {
+namespace qserv {
+namespace qmeta {
+
+/// @addtogroup qmeta
+
+/**
+ *  @ingroup qmeta
+ *
+ *  @brief Execution progress of a running query.
+ *
+ *  The czar updates this record every few seconds while a query drains,
+ *  and once more when the last chunk job completes. The processlist views
+ *  expose it so clients can tell a healthy long-running scan from a hung
+ *  one. The estimate comes from a moving average of the chunk completion
+ *  rate and is only as steady as the rate itself.
+ */
+struct QProgress {
+    QueryId queryId = 0;       ///< Query ID this row belongs to.
+    int totalChunks = 0;       ///< Chunk jobs submitted for the query.
+    int completedChunks = 0;   ///< Chunk jobs completed so far.
+    uint64_t rowsMerged = 0;   ///< Result rows merged so far.
+    uint64_t bytesMerged = 0;  ///< Result message bytes merged so far.
+    int estTimeLeftSec = -1;   ///< Estimated seconds remaining, -1 when unknown.
+};
+
+}}} // namespace lsst::qserv::qmeta
+
+#endif // LSST_QSERV_QMETA_QPROGRESS_H
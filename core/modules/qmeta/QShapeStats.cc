@@ -0,0 +1,60 @@
+/*
+ * LSST Data Management System
+ * Copyright 2018 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "qmeta/QShapeStats.h"
+
+// System headers
+#include <algorithm>
+#include <set>
+
+namespace lsst {
+namespace qserv {
+namespace qmeta {
+
+std::string
+makeTableSet(std::vector<std::pair<std::string, std::string>> const& tables) {
+    // sort and deduplicate so the key does not depend on FROM-list order
+    std::set<std::string> names;
+    for (auto const& table : tables) {
+        names.insert(table.first + "." + table.second);
+    }
+    std::string result;
+    for (auto const& name : names) {
+        if (not result.empty()) result += ",";
+        result += name;
+    }
+    return result;
+}
+
+uint64_t
+makeShapeHash(std::string const& queryTemplate) {
+    // 64-bit FNV-1a
+    uint64_t hash = 14695981039346656037ULL;
+    for (char const c : queryTemplate) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+}}} // namespace lsst::qserv::qmeta
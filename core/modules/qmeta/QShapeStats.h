@@ -0,0 +1,72 @@
+/*
+ * LSST Data Management System
+ * Copyright 2018 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_QMETA_QSHAPESTATS_H
+#define LSST_QSERV_QMETA_QSHAPESTATS_H
+
+// System headers
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace lsst {
+namespace qserv {
+namespace qmeta {
+
+/// @addtogroup qmeta
+
+/**
+ *  @ingroup qmeta
+ *
+ *  @brief Historical runtime statistics for one query shape.
+ *
+ *  A query shape is identified by the set of tables it touches and a hash
+ *  of its per-chunk query template, so repeated submissions of the same
+ *  statement with different constants aggregate into one record. The
+ *  counters are sums over all completed queries of that shape; divide by
+ *  queryCount for per-query averages. This is the history the czar
+ *  consults when it has to estimate the cost of a new query before any of
+ *  its chunks have run.
+ */
+struct QShapeStats {
+    std::string tableSet;    ///< Canonical table list, see makeTableSet().
+    uint64_t shapeHash = 0;  ///< Query template hash, see makeShapeHash().
+    uint64_t queryCount = 0; ///< Completed queries of this shape; 0 means no history.
+    uint64_t chunkCount = 0; ///< Chunks touched, summed over queries.
+    uint64_t rowCount = 0;   ///< Result rows returned, summed over queries.
+    uint64_t workerMs = 0;   ///< Worker execution+serialization milliseconds, summed.
+    uint64_t mergeMs = 0;    ///< Czar-side merge milliseconds, summed.
+};
+
+/// @return the canonical table-set key for a list of (db, table) pairs:
+/// "db.table" entries sorted and deduplicated, comma-separated. Callers
+/// must use this helper so lookups and updates agree on the key.
+std::string makeTableSet(std::vector<std::pair<std::string, std::string>> const& tables);
+
+/// @return a stable 64-bit hash (FNV-1a) of a query template. Computed
+/// here rather than with std::hash so the value stored in the database
+/// stays comparable across builds and standard library versions.
+uint64_t makeShapeHash(std::string const& queryTemplate);
+
+}}} // namespace lsst::qserv::qmeta
+
+#endif // LSST_QSERV_QMETA_QSHAPESTATS_H
@@ -0,0 +1,61 @@
+/*
+ * LSST Data Management System
+ * Copyright 2018 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <https://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_QMETA_QSTATS_H
+#define LSST_QSERV_QMETA_QSTATS_H
+
+// System headers
+#include <cstdint>
+
+// Qserv headers
+#include "qmeta/types.h"
+
+namespace lsst {
+namespace qserv {
+namespace qmeta {
+
+/// @addtogroup qmeta
+
+/**
+ *  @ingroup qmeta
+ *
+ *  @brief Per-query phase timing statistics.
+ *
+ *  Describes where a completed query's wall-clock time went, summed in
+ *  milliseconds over its chunk jobs. The worker-side phases come from the
+ *  timing records each worker attaches to its final result message; the
+ *  dispatch and transfer phases compare worker clocks with the czar clock
+ *  and inherit whatever skew exists between the hosts.
+ */
+struct QStats {
+    QueryId queryId = 0;          ///< Query ID this row belongs to.
+    int completedJobs = 0;        ///< Chunk jobs that reported timing.
+    uint64_t dispatchWaitMs = 0;  ///< Czar dispatch until queued on a worker scheduler.
+    uint64_t workerQueueMs = 0;   ///< Waiting on a worker scheduler queue.
+    uint64_t mysqldMs = 0;        ///< Waiting on worker mysqld statement execution.
+    uint64_t serializeMs = 0;     ///< Serializing/compressing result messages.
+    uint64_t transferMs = 0;      ///< Final result handed to the channel until received by the czar.
+    uint64_t mergeMs = 0;         ///< Merging results into the result table.
+};
+
+}}} // namespace lsst::qserv::qmeta
+
+#endif // LSST_QSERV_QMETA_QSTATS_H
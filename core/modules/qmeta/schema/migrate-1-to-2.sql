@@ -0,0 +1,28 @@
+--
+-- Migration script from version 1 to version 2 of QMeta database:
+--   - QStats table is added with per-query phase timing
+--
+
+-- -----------------------------------------------------
+-- Create table `QStats`
+-- -----------------------------------------------------
+CREATE TABLE IF NOT EXISTS `QStats` (
+  `queryId` BIGINT NOT NULL COMMENT 'Query ID',
+  `completedJobs` INT NOT NULL COMMENT 'Chunk jobs that reported timing',
+  `dispatchWaitMs` BIGINT NOT NULL COMMENT 'Czar dispatch until queued on a worker scheduler',
+  `workerQueueMs` BIGINT NOT NULL COMMENT 'Waiting on a worker scheduler queue',
+  `mysqldMs` BIGINT NOT NULL COMMENT 'Waiting on worker mysqld statement execution',
+  `serializeMs` BIGINT NOT NULL COMMENT 'Serializing/compressing result messages',
+  `transferMs` BIGINT NOT NULL COMMENT 'Final result handed to the channel until received by the czar',
+  `mergeMs` BIGINT NOT NULL COMMENT 'Merging results into the result table',
+  PRIMARY KEY (`queryId`),
+  CONSTRAINT `QStats_qid`
+    FOREIGN KEY (`queryId`)
+    REFERENCES `QInfo` (`queryId`)
+    ON DELETE CASCADE
+    ON UPDATE CASCADE)
+ENGINE = InnoDB
+COMMENT = 'Per-query phase timing, milliseconds summed over chunk jobs';
+
+-- Update schema version
+UPDATE `QMetadata` SET `value` = '2' WHERE `metakey` = 'version';
@@ -0,0 +1,22 @@
+--
+-- Migration script from version 2 to version 3 of QMeta database:
+--   - QShapeStats table is added with historical per-query-shape statistics
+--
+
+-- -----------------------------------------------------
+-- Create table `QShapeStats`
+-- -----------------------------------------------------
+CREATE TABLE IF NOT EXISTS `QShapeStats` (
+  `tableSet` VARCHAR(255) NOT NULL COMMENT 'Sorted comma-separated db.table list',
+  `shapeHash` BIGINT UNSIGNED NOT NULL COMMENT 'Hash of the per-chunk query template',
+  `queryCount` BIGINT NOT NULL COMMENT 'Completed queries of this shape',
+  `chunkCount` BIGINT NOT NULL COMMENT 'Chunks touched, summed over queries',
+  `rowCount` BIGINT NOT NULL COMMENT 'Result rows returned, summed over queries',
+  `workerMs` BIGINT NOT NULL COMMENT 'Worker execution+serialization ms, summed',
+  `mergeMs` BIGINT NOT NULL COMMENT 'Czar-side merge ms, summed',
+  PRIMARY KEY (`tableSet`, `shapeHash`))
+ENGINE = InnoDB
+COMMENT = 'Historical runtime statistics aggregated per query shape';
+
+-- Update schema version
+UPDATE `QMetadata` SET `value` = '3' WHERE `metakey` = 'version';
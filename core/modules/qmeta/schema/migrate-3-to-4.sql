@@ -0,0 +1,83 @@
+--
+-- Migration script from version 3 to version 4 of QMeta database:
+--   - QProgress table is added with execution progress of running queries
+--   - processlist views expose progress and the remaining-time estimate
+--
+
+-- -----------------------------------------------------
+-- Create table `QProgress`
+-- -----------------------------------------------------
+CREATE TABLE IF NOT EXISTS `QProgress` (
+  `queryId` BIGINT NOT NULL COMMENT 'Query ID',
+  `totalChunks` INT NOT NULL COMMENT 'Chunk jobs submitted for the query',
+  `completedChunks` INT NOT NULL COMMENT 'Chunk jobs completed so far',
+  `rowsMerged` BIGINT NOT NULL COMMENT 'Result rows merged so far',
+  `bytesMerged` BIGINT NOT NULL COMMENT 'Result message bytes merged so far',
+  `estTimeLeftSec` INT NOT NULL DEFAULT -1 COMMENT 'Estimated seconds remaining, -1 when unknown',
+  `lastUpdate` TIMESTAMP NOT NULL DEFAULT CURRENT_TIMESTAMP ON UPDATE CURRENT_TIMESTAMP
+      COMMENT 'Time of the last progress update',
+  PRIMARY KEY (`queryId`),
+  CONSTRAINT `QProgress_qid`
+    FOREIGN KEY (`queryId`)
+    REFERENCES `QInfo` (`queryId`)
+    ON DELETE CASCADE
+    ON UPDATE CASCADE)
+ENGINE = InnoDB
+COMMENT = 'Execution progress of running queries, updated periodically by the czar';
+
+-- -----------------------------------------------------
+-- Update view `ShowProcessList`, fill in the Progress column
+-- -----------------------------------------------------
+ALTER  VIEW `ShowProcessList` AS
+  SELECT DISTINCT
+    `QInfo`.`queryId` `Id`,
+    `QInfo`.`user` `User`,
+    NULL `Host`,
+    GROUP_CONCAT(DISTINCT `QTable`.`dbName`) `db`,
+    `QInfo`.`qType` `Command`,
+    NULL `Time`,
+    `QInfo`.`status` `State`,
+    `QInfo`.`query` `Info`,
+    CONCAT(`QProgress`.`completedChunks`, '/', `QProgress`.`totalChunks`) `Progress`,
+    `QProgress`.`estTimeLeftSec` `EstTimeLeftSec`,
+    `QInfo`.`submitted` `Submitted`,
+    `QInfo`.`completed` `Completed`,
+    `QInfo`.`returned` `Returned`,
+    `QInfo`.`czarId` `CzarId`,
+    REPLACE(`QInfo`.`resultLocation`, '#QID#',  `QInfo`.`queryId`) `ResultLocation`
+  FROM `QInfo` LEFT OUTER JOIN `QTable` USING (`queryId`)
+        LEFT OUTER JOIN `QProgress` USING (`queryId`)
+  GROUP BY `QInfo`.`queryId`;
+
+-- -----------------------------------------------------
+-- Update view `InfoSchemaProcessList`
+-- -----------------------------------------------------
+ALTER VIEW `InfoSchemaProcessList` AS
+  SELECT DISTINCT
+    `QInfo`.`queryId` `ID`,
+    `QInfo`.`user` `USER`,
+    NULL `HOST`,
+    GROUP_CONCAT(DISTINCT `QTable`.`dbName`) `DB`,
+    `QInfo`.`qType` `COMMAND`,
+    NULL `TIME`,
+    `QInfo`.`status` `STATE`,
+    `QInfo`.`query` `INFO`,
+    `QInfo`.`submitted` `SUBMITTED`,
+    `QInfo`.`completed` `COMPLETED`,
+    `QInfo`.`returned` `RETURNED`,
+    `QInfo`.`czarId` `CZARID`,
+    REPLACE(`QInfo`.`resultLocation`, '#QID#',  `QInfo`.`queryId`) `RESULTLOCATION`,
+    NULLIF(COUNT(`QWorker`.`chunk`), 0) `NCHUNKS`,
+    `QProgress`.`totalChunks` `TOTALCHUNKS`,
+    `QProgress`.`completedChunks` `COMPLETEDCHUNKS`,
+    `QProgress`.`rowsMerged` `ROWSMERGED`,
+    `QProgress`.`bytesMerged` `BYTESMERGED`,
+    `QProgress`.`estTimeLeftSec` `ESTTIMELEFTSEC`,
+    `QProgress`.`lastUpdate` `LASTUPDATE`
+  FROM `QInfo` LEFT OUTER JOIN `QTable` USING (`queryId`)
+        LEFT OUTER JOIN `QWorker` USING (`queryId`)
+        LEFT OUTER JOIN `QProgress` USING (`queryId`)
+  GROUP BY `QInfo`.`queryId`;
+
+-- Update schema version
+UPDATE `QMetadata` SET `value` = '4' WHERE `metakey` = 'version';
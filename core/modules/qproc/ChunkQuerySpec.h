@@ -67,6 +67,7 @@ public:
     // Consider saving subChunkTable templates, and substituting the chunkIds
     // and subChunkIds into them on-the-fly.
     bool scanInteractive{false};
+    int rowBudget{0}; ///< Rows each worker task needs for a plain LIMIT; 0: no budget.
     DbTableSet subChunkTables;
     std::vector<int> subChunkIds;
     std::vector<std::string> queries;
@@ -80,11 +80,11 @@ void intersectSorted(ChunkSpecVector& dest, ChunkSpecVector const& a) {
         }
 
         if (ai->chunkId == di->chunkId) {
-            ChunkSpec cs = *di;
+            ChunkSpec cs = std::move(*di); // dest is overwritten below
             // On a match, perform the intersection.
             cs.restrict(*ai);
-            if (di->chunkId != ChunkSpec::CHUNKID_INVALID) {
-                tmp.push_back(cs);
+            if (cs.chunkId != ChunkSpec::CHUNKID_INVALID) {
+                tmp.push_back(std::move(cs));
             }
         }
     }
@@ -106,6 +106,7 @@ void normalize(ChunkSpecVector& specs) {
     // An in-place algorithm is possible, but slightly more difficult to
     // understand and debug.
     ChunkSpecVector output;
+    output.reserve(specs.size());
     std::sort(specs.begin(), specs.end());
     // Merge duplicate chunkId entries.
     for(ChunkSpecVector::iterator i=specs.begin(), e=specs.end();
@@ -119,7 +120,7 @@ void normalize(ChunkSpecVector& specs) {
             // Same chunkId, then merge and mark.
             i->mergeUnion(*j);
         }
-        output.push_back(*i);
+        output.push_back(std::move(*i));
         i = j;
     }
     specs.swap(output);
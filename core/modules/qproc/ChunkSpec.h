@@ -34,6 +34,7 @@
 #include <ostream>
 #include <list>
 #include <map>
+#include <utility>
 #include <vector>
 
 // Qserv headers
@@ -55,6 +56,9 @@ public:
     ChunkSpec() : chunkId(CHUNKID_INVALID) {}
     ChunkSpec(int chunkId_, Int32Vector const& subChunks_)
         : chunkId(chunkId_), subChunks(subChunks_) {}
+    /// Adopt an existing subchunk list without copying it.
+    ChunkSpec(int chunkId_, Int32Vector&& subChunks_)
+        : chunkId(chunkId_), subChunks(std::move(subChunks_)) {}
 
 
     int32_t chunkId; ///< ChunkId of interest
@@ -97,7 +101,10 @@ ChunkSpecVector intersect(ChunkSpecVector const& a, ChunkSpecVector const& b);
 /// Merge and eliminate duplicates.
 void normalize(ChunkSpecVector& specs);
 
-/// An iterating fragmenter to reduce the number of subChunkIds per ChunkSpec
+/// An iterating fragmenter to reduce the number of subChunkIds per ChunkSpec.
+/// Holds a reference to the fragmented spec, which must outlive the
+/// fragmenter; it is only ever used within the scope of building one chunk's
+/// queries.
 class ChunkSpecFragmenter {
 public:
     ChunkSpecFragmenter(ChunkSpec const& s);
@@ -106,7 +113,7 @@ public:
     bool isDone();
 private:
     typedef std::vector<int32_t>::const_iterator Iter;
-    ChunkSpec _original;
+    ChunkSpec const& _original;
     Iter _pos;
 
 };
@@ -35,6 +35,8 @@
 #include <algorithm>
 #include <cassert>
 #include <iterator>
+#include <list>
+#include <mutex>
 #include <stdexcept>
 #include <set>
 #include <vector>
@@ -45,6 +47,7 @@
 // LSST headers
 #include "lsst/log/Log.h"
 #include "lsst/sphgeom/Chunker.h"
+#include "lsst/sphgeom/Region.h"
 
 // Qserv headers
 #include "global/Bug.h"
@@ -133,6 +136,43 @@ std::shared_ptr<Region> getRegion(lsst::qserv::query::Constraint const& c) {
     return covered_region;
 }
 
+/// LRU cache of region -> coverage results, shared by every IndexMap.
+/// Sky-survey load repeats a small set of region shapes endlessly (cone
+/// searches at gridded positions, dashboard boxes), and chunk intersection
+/// is pure geometry on immutable striping, so results are keyed on the
+/// striping parameters plus the region's canonical serialized form.
+class CoverageCache {
+public:
+    static size_t const MAX_ENTRIES = 256;
+
+    /// @return true and fill 'out' on a hit, refreshing the entry's age.
+    bool get(std::string const& key, SubChunksVector& out) {
+        std::lock_guard<std::mutex> lock(_mtx);
+        auto iter = _index.find(key);
+        if (iter == _index.end()) { return false; }
+        _lru.splice(_lru.begin(), _lru, iter->second);
+        out = _lru.front().second;
+        return true;
+    }
+
+    void put(std::string const& key, SubChunksVector const& scv) {
+        std::lock_guard<std::mutex> lock(_mtx);
+        if (_index.find(key) != _index.end()) { return; }
+        _lru.emplace_front(key, scv);
+        _index[key] = _lru.begin();
+        if (_lru.size() > MAX_ENTRIES) {
+            _index.erase(_lru.back().first);
+            _lru.pop_back();
+        }
+    }
+
+private:
+    std::list<std::pair<std::string, SubChunksVector>> _lru;
+    std::map<std::string, std::list<std::pair<std::string, SubChunksVector>>::iterator> _index;
+    std::mutex _mtx;
+};
+CoverageCache coverageCache;
+
 lsst::qserv::qproc::ChunkSpec convertSgSubChunks(SubChunks const& sc) {
     lsst::qserv::qproc::ChunkSpec cs;
     cs.chunkId = sc.chunkId;
@@ -162,7 +202,8 @@ public:
     explicit PartitioningMap(css::StripingParams const& sp) {
         _chunker = std::make_shared<lsst::sphgeom::Chunker>(sp.stripes,
                                                             sp.subStripes);
-
+        _cacheKeyPrefix = std::to_string(sp.stripes) + ","
+            + std::to_string(sp.subStripes) + ":";
     }
     /// @return un-canonicalized vector<SubChunks> of concatenated region
     /// results. Regions are assumed to be joined by implicit "OR" and not "AND"
@@ -189,7 +230,14 @@ public:
     }
 
     inline SubChunksVector getCoverage(Region const& r) {
-        return _chunker->getSubChunksIntersecting(r);
+        std::string key = _cacheKeyPrefix;
+        auto const encoded = r.encode();
+        key.append(encoded.begin(), encoded.end());
+        SubChunksVector scv;
+        if (coverageCache.get(key, scv)) { return scv; }
+        scv = _chunker->getSubChunksIntersecting(r);
+        coverageCache.put(key, scv);
+        return scv;
     }
     ChunkSpecVector getAllChunks() const {
         Int32Vector allChunks = _chunker->getAllChunks();
@@ -203,6 +251,7 @@ public:
     }
 private:
     std::shared_ptr<lsst::sphgeom::Chunker> _chunker;
+    std::string _cacheKeyPrefix; ///< striping portion of coverage cache keys
 };
 
 ////////////////////////////////////////////////////////////////////////
@@ -38,6 +38,7 @@
 #include <algorithm>
 #include <cassert>
 #include <cstddef>
+#include <future>
 #include <iostream>
 #include <sstream>
 #include <stdexcept>
@@ -151,6 +152,10 @@ bool QuerySession::hasChunks() const {
     return _context->hasChunks();
 }
 
+int QuerySession::getRowBudget() const {
+    return _context->rowBudget;
+}
+
 std::shared_ptr<query::ConstraintVector> QuerySession::getConstraints() const {
     std::shared_ptr<query::ConstraintVector> cv;
     std::shared_ptr<query::QsRestrictor::PtrVector const> p = _context->restrictors;
@@ -194,6 +199,27 @@ void QuerySession::addChunk(ChunkSpec const& cs) {
 }
 
 
+void QuerySession::setChunksDeferred(std::future<ChunkSpecVector> chunksFuture) {
+    _chunksFuture = std::move(chunksFuture);
+}
+
+
+/// Collect the result of a deferred coverage computation, if one is pending.
+/// future::get() invalidates the future, so this waits at most once; any
+/// exception thrown by the computation is rethrown here.
+void QuerySession::_waitForChunks() {
+    if (!_chunksFuture.valid()) {
+        return;
+    }
+    ChunkSpecVector csv = _chunksFuture.get();
+    for(ChunkSpecVector::const_iterator i=csv.begin(), e=csv.end();
+        i != e; ++i) {
+        addChunk(*i);
+    }
+    setScanInteractive();
+}
+
+
 void QuerySession::setScanInteractive() {
     // Default is for interactive scan.
     if (_context->chunkCount > _interactiveChunkLimit) {
@@ -201,6 +227,10 @@ void QuerySession::setScanInteractive() {
     }
 }
 
+proto::ScanInfo const& QuerySession::getScanInfo() const {
+    return _context->scanInfo;
+}
+
 void QuerySession::setDummy() {
     _isDummy = true;
     // Clear out chunk counts and _chunks, and replace with dummy chunk.
@@ -232,10 +262,18 @@ QuerySession::getDbStriping() {
     return _context->getDbStriping();
 }
 
-std::shared_ptr<IntSet const>
-QuerySession::getEmptyChunks() {
+void
+QuerySession::filterEmptyChunks(ChunkSpecVector& csv) {
     // FIXME: do we need to catch an exception here?
-    return _css->getEmptyChunks().getEmpty(_context->dominantDb);
+    auto const empty = _css->getEmptyChunks().getEmptyBitmap(_context->dominantDb);
+    ChunkSpecVector kept;
+    kept.reserve(csv.size());
+    for (auto& spec: csv) {
+        if (not empty->contains(spec.chunkId)) {
+            kept.push_back(std::move(spec));
+        }
+    }
+    csv.swap(kept);
 }
 
 /// Returns the merge statment, if appropriate.
@@ -253,6 +291,9 @@ void QuerySession::finalize() {
     if (_isFinal) {
         return;
     }
+    // applyFinal() and the dummy-chunk decision both need the full coverage,
+    // so join any deferred coverage computation now.
+    _waitForChunks();
     QueryPluginPtrVector::iterator i;
     for(i=_plugins->begin(); i != _plugins->end(); ++i) {
         (**i).applyFinal(*_context);
@@ -392,10 +433,13 @@ std::ostream& operator<<(std::ostream& out, QuerySession const& querySession) {
 }
 
 
+// Reads only state that is immutable once finalize() has run, so callers
+// may invoke this concurrently from several threads for different chunks.
 ChunkQuerySpec::Ptr QuerySession::buildChunkQuerySpec(query::QueryTemplate::Vect const& queryTemplates,
                                                  ChunkSpec const& chunkSpec) const {
     auto cQSpec = std::make_shared<ChunkQuerySpec>(_context->dominantDb, chunkSpec.chunkId,
                                                   _context->scanInfo, _scanInteractive);
+    cQSpec->rowBudget = _context->rowBudget;
     // Reset subChunkTables
     qana::QueryMapping const& queryMapping = *(_context->queryMapping);
     DbTableSet const& sTables = queryMapping.getSubChunkTables();
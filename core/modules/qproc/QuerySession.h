@@ -32,6 +32,7 @@
 
 // System headers
 #include <cstddef>
+#include <future>
 #include <memory>
 #include <string>
 #include <vector>
@@ -102,8 +103,18 @@ public:
     bool needsMerge() const;
     bool hasChunks() const;
 
+    /// @return the number of rows each worker task needs for a plain LIMIT
+    ///         query, or 0 when workers must scan their whole chunk.
+    int getRowBudget() const;
+
     std::shared_ptr<query::ConstraintVector> getConstraints() const;
     void addChunk(ChunkSpec const& cs);
+    /// Adopt a chunk coverage computation that is still in flight. The session
+    /// waits on the future the first time chunks are needed (finalize() or
+    /// iteration), letting the caller overlap coverage resolution with other
+    /// dispatch setup. Errors thrown by the computation surface from the
+    /// waiting call.
+    void setChunksDeferred(std::future<ChunkSpecVector> chunksFuture);
     void setDummy();
 
     query::SelectStmt const& getStmt() const { return *_stmt; }
@@ -128,7 +139,8 @@ public:
     bool containsTable(std::string const& dbName, std::string const& tableName) const;
     bool validateDominantDb() const;
     css::StripingParams getDbStriping();
-    std::shared_ptr<IntSet const> getEmptyChunks();
+    /// Remove chunks which are in the empty chunk list of the dominant db
+    void filterEmptyChunks(ChunkSpecVector& csv);
     std::string const& getError() const { return _error; }
 
     std::shared_ptr<query::SelectStmt> getMergeStmt() const;
@@ -138,10 +150,10 @@ public:
 
     /// Finalize a query after chunk coverage has been updated
     void finalize();
-    // Iteration
-    ChunkSpecVector::iterator cQueryBegin() { return _chunks.begin(); }
-    ChunkSpecVector::iterator cQueryEnd() { return _chunks.end(); }
-    int getChunksSize() const { return _chunks.size(); }
+    // Iteration. Waits for deferred chunk coverage, if any.
+    ChunkSpecVector::iterator cQueryBegin() { _waitForChunks(); return _chunks.begin(); }
+    ChunkSpecVector::iterator cQueryEnd() { _waitForChunks(); return _chunks.end(); }
+    int getChunksSize() { _waitForChunks(); return _chunks.size(); }
 
     // For test harnesses.
     struct Test {
@@ -157,6 +169,10 @@ public:
     void setScanInteractive();
     bool getScanInteractive() const { return _scanInteractive; }
 
+    /// @return the shared-scan table info collected during analysis
+    /// (ScanTablePlugin); empty when the query touches no scan tables.
+    proto::ScanInfo const& getScanInfo() const;
+
     /**
      *  Print query session to stream.
      *
@@ -170,6 +186,7 @@ private:
     typedef std::vector<qana::QueryPlugin::Ptr> QueryPluginPtrVector;
 
     // Pipeline helpers
+    void _waitForChunks();
     void _initContext();
     void _preparePlugins();
     void _applyLogicPlugins();
@@ -226,6 +243,8 @@ private:
     int _isFinal{0}; ///< Has query analysis/optimization completed?
 
     ChunkSpecVector _chunks; ///< Chunk coverage
+    /// In-flight chunk coverage computation; consumed by _waitForChunks().
+    std::future<ChunkSpecVector> _chunksFuture;
     std::shared_ptr<QueryPluginPtrVector> _plugins; ///< Analysis plugin chain
 
     /// Maximum number of chunks in an interactive query. TODO: DM-10273 put in config file.
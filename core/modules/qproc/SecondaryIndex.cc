@@ -33,6 +33,14 @@
 
 // System headers
 #include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fcntl.h>
+#include <map>
+#include <mutex>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 
 // LSST headers
 #include "lsst/log/Log.h"
@@ -46,6 +54,7 @@
 #include "global/constants.h"
 #include "global/stringUtil.h"
 #include "qproc/ChunkSpec.h"
+#include "qproc/SecondaryIndexFormat.h"
 #include "query/Constraint.h"
 #include "sql/SqlConnection.h"
 #include "util/IterableFormatter.h"
@@ -68,6 +77,10 @@ public:
     /// Lookup an index constraint. Ignore constraints that are not "sIndex"
     /// constraints.
     virtual ChunkSpecVector lookup(query::ConstraintVector const& cv) = 0;
+
+    /// Pre-fault index state for the director tables of a database,
+    /// see SecondaryIndex::warmDatabase(). No-op by default.
+    virtual void warmDatabase(std::string const&, std::vector<std::string> const&) {}
 };
 
 class MySqlBackend : public SecondaryIndex::Backend {
@@ -99,7 +112,7 @@ public:
     }
 
 
-private:
+protected:
     static std::string _buildIndexTableName(
         std::string const& db,
         std::string const& table) {
@@ -208,13 +221,196 @@ private:
         // Add results to output
         for(auto i=tmp.begin(), e=tmp.end();
             i != e; ++i) {
-            output.push_back(ChunkSpec(i->first, i->second));
+            output.push_back(ChunkSpec(i->first, std::move(i->second)));
         }
     }
 
     sql::SqlConnection _sqlConnection;
 };
 
+
+/// MmapBackend resolves secondary index lookups against memory-mapped
+/// sorted index files, one per director table, falling back to the SQL
+/// index for tables without a file. A file holds a small header followed
+/// by fixed 16-byte records (int64 key, int32 chunkId, int32 subChunkId),
+/// sorted by key, and is produced by the same loading pipeline that
+/// populates the SQL index. Lookups are an in-process binary search, so
+/// point restrictors cost microseconds and large IN lists resolve in one
+/// merge pass instead of a multi-MB SQL statement.
+class MmapBackend : public MySqlBackend {
+public:
+    MmapBackend(mysql::MySqlConfig const& c, std::string const& indexDir)
+        : MySqlBackend(c), _indexDir(indexDir) {
+    }
+
+    ChunkSpecVector lookup(query::ConstraintVector const& cv) override {
+        ChunkSpecVector output;
+        bool hasIndex = false;
+        for(auto i=cv.begin(), e=cv.end(); i != e; ++i) {
+            if (i->name == "sIndex") {
+                hasIndex = true;
+                if (!_fileLookup(output, i->params, IN)) {
+                    _sqlLookup(output, i->params, IN);
+                }
+            } else if (i->name == "sIndexBetween") {
+                hasIndex = true;
+                if (!_fileLookup(output, i->params, BETWEEN)) {
+                    _sqlLookup(output, i->params, BETWEEN);
+                }
+            }
+        }
+        if (!hasIndex) {
+            throw SecondaryIndex::NoIndexConstraint();
+        }
+        normalize(output);
+        return output;
+    }
+
+    void warmDatabase(std::string const& db,
+                      std::vector<std::string> const& tables) override {
+        size_t warmed = 0;
+        for (auto const& table : tables) {
+            auto idx = _getIndex(db, table);
+            if (idx != nullptr) {
+                idx->warm();
+                ++warmed;
+            }
+        }
+        LOGS(_log, LOG_LVL_DEBUG, "warmed " << warmed << " of " << tables.size()
+             << " index files for db " << db);
+    }
+
+private:
+    // The file format (header, records, naming) is shared with the index
+    // builder, see SecondaryIndexFormat.h.
+    typedef sidx::Record Record;
+    typedef sidx::FileHeader FileHeader;
+
+    /// A read-only mapping of one index file.
+    class MappedIndex {
+    public:
+        MappedIndex(std::string const& path) {
+            int fd = ::open(path.c_str(), O_RDONLY);
+            if (fd < 0) { return; }
+            struct stat st;
+            if (::fstat(fd, &st) != 0 || static_cast<size_t>(st.st_size) < sizeof(FileHeader)) {
+                ::close(fd);
+                return;
+            }
+            void* addr = ::mmap(nullptr, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+            ::close(fd); // The mapping keeps the file alive.
+            if (addr == MAP_FAILED) { return; }
+            FileHeader const* hdr = static_cast<FileHeader const*>(addr);
+            if (hdr->magic != sidx::INDEX_MAGIC || hdr->version != sidx::INDEX_VERSION
+                || sizeof(FileHeader) + hdr->numRecords*sizeof(Record)
+                   > static_cast<size_t>(st.st_size)) {
+                LOGS(_log, LOG_LVL_WARN, "bad secondary index file: " << path);
+                ::munmap(addr, st.st_size);
+                return;
+            }
+            _addr = addr;
+            _size = st.st_size;
+            _begin = reinterpret_cast<Record const*>(
+                static_cast<char const*>(addr) + sizeof(FileHeader));
+            _end = _begin + hdr->numRecords;
+        }
+        ~MappedIndex() {
+            if (_addr) { ::munmap(_addr, _size); }
+        }
+        bool valid() const { return _begin != nullptr; }
+        Record const* begin() const { return _begin; }
+        Record const* end() const { return _end; }
+        /// Ask the kernel to read the whole mapping ahead and touch every
+        /// page, so later binary searches probe resident memory instead of
+        /// taking a major fault per step.
+        void warm() const {
+            if (_addr == nullptr) { return; }
+            ::madvise(_addr, _size, MADV_WILLNEED);
+            size_t const pageSize = ::sysconf(_SC_PAGESIZE);
+            char const* base = static_cast<char const*>(_addr);
+            char sink = 0;
+            for (size_t off = 0; off < _size; off += pageSize) {
+                sink += *static_cast<char const volatile*>(base + off);
+            }
+            (void)sink;
+        }
+    private:
+        void* _addr = nullptr;
+        size_t _size = 0;
+        Record const* _begin = nullptr;
+        Record const* _end = nullptr;
+    };
+
+    /// @return the mapping for db.table, opening it on first use;
+    /// nullptr if the table has no (valid) index file.
+    std::shared_ptr<MappedIndex> _getIndex(std::string const& db, std::string const& table) {
+        std::string const name = sidx::indexFileName(db, table);
+        std::lock_guard<std::mutex> lock(_mapsMutex);
+        auto iter = _maps.find(name);
+        if (iter != _maps.end()) { return iter->second; }
+        auto idx = std::make_shared<MappedIndex>(_indexDir + "/" + name);
+        if (!idx->valid()) {
+            idx = nullptr; // Remember the miss; fall back to SQL from now on.
+            LOGS(_log, LOG_LVL_DEBUG, "no mmap secondary index for " << name
+                 << ", using SQL lookups");
+        }
+        _maps[name] = idx;
+        return idx;
+    }
+
+    /// Resolve one constraint against the mapped file.
+    /// @return false if the table has no index file (caller falls back to SQL).
+    bool _fileLookup(ChunkSpecVector& output, StringVector const& params,
+                     QueryType const& queryType) {
+        auto iter = params.begin();
+        std::string const& db = *(iter++);    // params[0]
+        std::string const& table = *(iter++); // params[1]
+        ++iter;                               // params[2] is the key column
+        auto idx = _getIndex(db, table);
+        if (idx == nullptr) { return false; }
+
+        std::map<int, Int32Vector> tmp;
+        auto const cmp = [](Record const& r, int64_t key) { return r.key < key; };
+        if (queryType == IN) {
+            // Sort the probe keys so the search can resume where the
+            // previous key left off, one merge pass for the whole IN list.
+            std::vector<int64_t> keys;
+            keys.reserve(params.size() - 3);
+            for (; iter != params.end(); ++iter) {
+                keys.push_back(std::stoll(*iter));
+            }
+            std::sort(keys.begin(), keys.end());
+            Record const* pos = idx->begin();
+            for (int64_t key : keys) {
+                pos = std::lower_bound(pos, idx->end(), key, cmp);
+                if (pos == idx->end()) { break; }
+                for (Record const* r = pos; r != idx->end() && r->key == key; ++r) {
+                    tmp[r->chunkId].push_back(r->subChunkId);
+                }
+            }
+        } else { // BETWEEN
+            if (params.size() != 5) {
+                throw Bug("Incorrect parameters for bounded secondary index lookup ");
+            }
+            int64_t const lo = std::stoll(*(iter++));
+            int64_t const hi = std::stoll(*iter);
+            for (Record const* r = std::lower_bound(idx->begin(), idx->end(), lo, cmp);
+                 r != idx->end() && r->key <= hi; ++r) {
+                tmp[r->chunkId].push_back(r->subChunkId);
+            }
+        }
+        for (auto i=tmp.begin(), e=tmp.end(); i != e; ++i) {
+            output.push_back(ChunkSpec(i->first, std::move(i->second)));
+        }
+        return true;
+    }
+
+    std::string const _indexDir;
+    std::map<std::string, std::shared_ptr<MappedIndex>> _maps;
+    std::mutex _mapsMutex;
+};
+
+
 class FakeBackend : public SecondaryIndex::Backend {
 public:
     FakeBackend() {}
@@ -243,6 +439,12 @@ SecondaryIndex::SecondaryIndex(mysql::MySqlConfig const& c)
     : _backend(std::make_shared<MySqlBackend>(c)) {
 }
 
+SecondaryIndex::SecondaryIndex(mysql::MySqlConfig const& c, std::string const& indexDir)
+    : _backend(indexDir.empty()
+               ? std::shared_ptr<Backend>(std::make_shared<MySqlBackend>(c))
+               : std::shared_ptr<Backend>(std::make_shared<MmapBackend>(c, indexDir))) {
+}
+
 SecondaryIndex::SecondaryIndex()
     : _backend(std::make_shared<FakeBackend>()) {
 }
@@ -255,5 +457,12 @@ ChunkSpecVector SecondaryIndex::lookup(query::ConstraintVector const& cv) {
     }
 }
 
+void SecondaryIndex::warmDatabase(std::string const& db,
+                                  std::vector<std::string> const& tables) {
+    if (_backend) {
+        _backend->warmDatabase(db, tables);
+    }
+}
+
 }}} // namespace lsst::qserv::qproc
 
@@ -33,6 +33,8 @@
 // System headers
 #include <memory>
 #include <stdexcept>
+#include <string>
+#include <vector>
 
 // Qserv headers
 #include "mysql/MySqlConfig.h"
@@ -53,6 +55,13 @@ class SecondaryIndex {
 public:
     explicit SecondaryIndex(mysql::MySqlConfig const& c);
 
+    /** Construct an instance that resolves lookups against memory-mapped
+     *  index files in 'indexDir' when one exists for the director table,
+     *  falling back to the SQL index otherwise. An empty 'indexDir' is
+     *  equivalent to the SQL-only constructor.
+     */
+    SecondaryIndex(mysql::MySqlConfig const& c, std::string const& indexDir);
+
     /** Construct a fake instance
      *
      *  Used for testing purpose
@@ -66,6 +75,15 @@ public:
      */
     ChunkSpecVector lookup(query::ConstraintVector const& cv);
 
+    /** Pre-fault the index state for the given director tables of a
+     *  database so the first lookup against them does not page the
+     *  index in from disk. For the memory-mapped backend this maps each
+     *  table's index file and touches its pages; the SQL and fake
+     *  backends ignore the call. Best effort: tables without an index
+     *  file are skipped silently, and the call never throws.
+     */
+    void warmDatabase(std::string const& db, std::vector<std::string> const& tables);
+
     class NoIndexConstraint : public std::invalid_argument {
     public:
         NoIndexConstraint()
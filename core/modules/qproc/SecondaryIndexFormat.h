@@ -0,0 +1,72 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#ifndef LSST_QSERV_QPROC_SECONDARYINDEXFORMAT_H
+#define LSST_QSERV_QPROC_SECONDARYINDEXFORMAT_H
+/**
+  * @file
+  *
+  * @brief On-disk format of the memory-mapped secondary index files,
+  * shared by the lookup path in SecondaryIndex and the index builder
+  * (qserv-index-build).
+  */
+
+// System headers
+#include <cstdint>
+#include <string>
+
+// Qserv headers
+#include "global/stringUtil.h"
+
+namespace lsst {
+namespace qserv {
+namespace qproc {
+namespace sidx {
+
+/// One index record; the file layout after the header is an array of
+/// these sorted by key. Duplicate keys are allowed and are stored
+/// adjacently.
+struct Record {
+    int64_t key;
+    int32_t chunkId;
+    int32_t subChunkId;
+};
+
+uint32_t const INDEX_MAGIC = 0x51534958; // "QSIX"
+uint32_t const INDEX_VERSION = 1;
+
+struct FileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t numRecords;
+};
+
+/// @return the index file name for a director table, relative to the
+/// index directory
+inline std::string indexFileName(std::string const& db, std::string const& table) {
+    return sanitizeName(db) + "__" + sanitizeName(table) + ".sidx";
+}
+
+}}}} // namespace lsst::qserv::qproc::sidx
+
+#endif // LSST_QSERV_QPROC_SECONDARYINDEXFORMAT_H
@@ -36,11 +36,13 @@
 #include <stdexcept>
 
 // Third-party headers
+#include "google/protobuf/arena.h"
 
 // LSST headers
 #include "lsst/log/Log.h"
 
 // Qserv headers
+#include "proto/ProtoHeaderWrap.h"
 #include "qproc/ChunkQuerySpec.h"
 #include "qproc/QueryProcessingBug.h"
 #include "util/common.h"
@@ -54,19 +56,26 @@ namespace qserv {
 namespace qproc {
 
 
-std::shared_ptr<proto::TaskMsg> TaskMsgFactory::_makeMsg(ChunkQuerySpec const& chunkQuerySpec,
-                                                        std::string const& chunkResultName,
-                                                        uint64_t queryId, int jobId, int attemptCount) {
-    std::string resultTable("Asdfasfd");
-    if (!chunkResultName.empty()) { resultTable = chunkResultName; }
-    auto taskMsg = std::make_shared<proto::TaskMsg>();
-    // shared
+std::shared_ptr<proto::TaskMsg> TaskMsgFactory::_makePrototype(ChunkQuerySpec const& chunkQuerySpec,
+                                                               uint64_t queryId) {
+    // Build the message and all its sub-objects on one arena; the arena is
+    // torn down when the last shared_ptr to the message goes away.
+    auto arena = std::make_shared<google::protobuf::Arena>();
+    std::shared_ptr<proto::TaskMsg> taskMsg(
+            google::protobuf::Arena::CreateMessage<proto::TaskMsg>(arena.get()),
+            [arena](proto::TaskMsg*) {});
     taskMsg->set_session(_session);
     taskMsg->set_db(chunkQuerySpec.db);
+    if (!_user.empty()) {
+        // Workers use this for per-user fair scheduling within a shared scan.
+        taskMsg->set_user(_user);
+    }
     taskMsg->set_protocol(2);
+    // Advertise the best codec this czar can decode for Result messages.
+    taskMsg->set_resultcompression(proto::COMP_ZLIB);
+    // This czar can consume the columnar RowBlock result format.
+    taskMsg->set_columnarresult(true);
     taskMsg->set_queryid(queryId);
-    taskMsg->set_jobid(jobId);
-    taskMsg->set_attemptcount(attemptCount);
     // scanTables (for shared scans)
     // check if more than 1 db in scanInfo
     std::string db;
@@ -83,8 +92,48 @@ std::shared_ptr<proto::TaskMsg> TaskMsgFactory::_makeMsg(ChunkQuerySpec const& c
 
     taskMsg->set_scanpriority(chunkQuerySpec.scanInfo.scanRating);
     taskMsg->set_scaninteractive(chunkQuerySpec.scanInteractive);
+    if (chunkQuerySpec.rowBudget > 0) {
+        taskMsg->set_rowbudget(chunkQuerySpec.rowBudget);
+    }
+    // Negotiate the transmit block cap: interactive queries get small blocks
+    // so the first rows arrive quickly, scans get full-sized blocks to cut
+    // per-block turnarounds on large results.
+    if (chunkQuerySpec.scanInteractive) {
+        taskMsg->set_transmitblocksize(256*1024);
+    } else {
+        taskMsg->set_transmitblocksize(proto::ProtoHeaderWrap::PROTOBUFFER_DESIRED_LIMIT);
+    }
+    return taskMsg;
+}
+
+
+std::shared_ptr<proto::TaskMsg> TaskMsgFactory::_makeMsg(ChunkQuerySpec const& chunkQuerySpec,
+                                                        std::string const& chunkResultName,
+                                                        uint64_t queryId, int jobId, int attemptCount) {
+    std::string resultTable("Asdfasfd");
+    if (!chunkResultName.empty()) { resultTable = chunkResultName; }
+    // The shared (chunk-invariant) fields are built once per query and
+    // copied into every chunk's message. The queryId check guards against
+    // a factory being reused across queries; normally one factory serves
+    // exactly one user query.
+    std::shared_ptr<proto::TaskMsg> prototype;
+    {
+        std::lock_guard<std::mutex> lock(_prototypeMtx);
+        if (_prototype == nullptr || _prototypeQueryId != queryId) {
+            _prototype = _makePrototype(chunkQuerySpec, queryId);
+            _prototypeQueryId = queryId;
+        }
+        prototype = _prototype;
+    }
+    auto arena = std::make_shared<google::protobuf::Arena>();
+    std::shared_ptr<proto::TaskMsg> taskMsg(
+            google::protobuf::Arena::CreateMessage<proto::TaskMsg>(arena.get()),
+            [arena](proto::TaskMsg*) {});
+    taskMsg->CopyFrom(*prototype);
 
     // per-chunk
+    taskMsg->set_jobid(jobId);
+    taskMsg->set_attemptcount(attemptCount);
     taskMsg->set_chunkid(chunkQuerySpec.chunkId);
     // per-fragment
     // TODO refactor to simplify
@@ -124,21 +173,21 @@ void TaskMsgFactory::_addFragment(proto::TaskMsg& taskMsg, std::string const& re
          frag->add_query(qry);
      }
 
-     proto::TaskMsg_Subchunk sc;
+     // Build the subchunk message in place (on the same arena as taskMsg)
+     // rather than staging it in a stack temporary and copying it over.
+     proto::TaskMsg_Subchunk* sc = frag->mutable_subchunks();
 
      // Add the db+table pairs to the subchunk.
      for(auto& tbl : subChunkTables) {
-         proto::TaskMsg_Subchunk_DbTbl* dbTbl = sc.add_dbtbl();
+         proto::TaskMsg_Subchunk_DbTbl* dbTbl = sc->add_dbtbl();
          dbTbl->set_db(tbl.db);
          dbTbl->set_tbl(tbl.table);
          LOGS(_log, LOG_LVL_DEBUG, "added dbtbl=" << tbl.db << "." << tbl.table);
      }
 
      for(auto& subChunkId : subChunkIds) {
-         sc.add_id(subChunkId);
+         sc->add_id(subChunkId);
      }
-
-     frag->mutable_subchunks()->CopyFrom(sc);
 }
 
 
@@ -34,6 +34,8 @@
 // System headers
 #include <iostream>
 #include <memory>
+#include <mutex>
+#include <string>
 
 // Qserv headers
 #include "global/DbTable.h"
@@ -51,7 +53,10 @@ class TaskMsgFactory {
 public:
     using Ptr = std::shared_ptr<TaskMsgFactory>;
 
-    TaskMsgFactory(uint64_t session) : _session(session) {}
+    /// 'user' identifies who the query belongs to; workers use it for
+    /// per-user fair scheduling. It may be empty when the client is unknown.
+    TaskMsgFactory(uint64_t session, std::string const& user=std::string())
+        : _session(session), _user(user) {}
     virtual ~TaskMsgFactory() {}
 
     /// Construct a TaskMsg and serialize it to a stream
@@ -65,12 +70,22 @@ private:
                                              std::string const& chunkResultName,
                                              uint64_t queryId, int jobId, int attemptCount);
 
+    /// @return a TaskMsg holding only the fields shared by every chunk of
+    /// the query (session, db, scan info, negotiated limits). Built once per
+    /// query and copied into each chunk's message, so the per-chunk work is
+    /// one CopyFrom plus the chunk id and fragments.
+    std::shared_ptr<proto::TaskMsg> _makePrototype(ChunkQuerySpec const& s, uint64_t queryId);
+
     void _addFragment(proto::TaskMsg& taskMsg, std::string const& resultName,
                       DbTableSet const& subChunkTables, std::vector<int> const& subChunkIds,
                       std::vector<std::string> const& queries);
 
     /// All member variable need to be thread safe.
     uint64_t const _session;
+    std::string const _user; ///< User the query belongs to, may be empty.
+    std::mutex _prototypeMtx; ///< Protects _prototype and _prototypeQueryId.
+    std::shared_ptr<proto::TaskMsg> _prototype; ///< See _makePrototype().
+    uint64_t _prototypeQueryId = 0; ///< Query the cached prototype was built for.
 };
 
 }}} // namespace lsst::qserv::qproc
@@ -0,0 +1,309 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/**
+ * @file
+ *
+ * @brief Parallel builder for the memory-mapped secondary index files
+ * consumed by qproc::SecondaryIndex (see SecondaryIndexFormat.h).
+ *
+ * The inputs are per-chunk dumps of a director table, one TSV row per
+ * object: <objectId> <chunkId> <subChunkId>. A pool of threads sorts the
+ * dumps into binary runs concurrently, then a single merge pass combines
+ * the runs - and, in append mode, the previous index - into a new index
+ * file. The output is written next to its final name and renamed into
+ * place, so a czar can keep serving lookups from the old file while the
+ * new one is built.
+ */
+
+// System headers
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <unistd.h>
+#include <vector>
+
+// Qserv headers
+#include "qproc/SecondaryIndexFormat.h"
+#include "util/CmdLineParser.h"
+
+namespace qproc = lsst::qserv::qproc;
+namespace util = lsst::qserv::util;
+
+using lsst::qserv::qproc::sidx::FileHeader;
+using lsst::qserv::qproc::sidx::Record;
+
+namespace {
+
+// Command line parameters
+
+std::string outFileName;
+std::vector<std::string> inFileNames;
+std::string appendFileName;
+std::string tmpDir;
+unsigned int numThreads;
+
+/// Read one TSV dump and sort it into a binary run file.
+/// @return the number of records in the run
+uint64_t makeRun(std::string const& inFileName, std::string const& runFileName) {
+
+    std::ifstream in(inFileName);
+    if (not in.good()) {
+        throw std::runtime_error("failed to open input file: " + inFileName);
+    }
+    std::vector<Record> records;
+    Record r;
+    while (in >> r.key >> r.chunkId >> r.subChunkId) {
+        records.push_back(r);
+    }
+    if (not in.eof()) {
+        throw std::runtime_error("malformed row in input file: " + inFileName);
+    }
+    std::sort(records.begin(), records.end(),
+              [](Record const& a, Record const& b) { return a.key < b.key; });
+
+    std::ofstream run(runFileName, std::ios::binary | std::ios::trunc);
+    if (not run.good()) {
+        throw std::runtime_error("failed to create run file: " + runFileName);
+    }
+    run.write(reinterpret_cast<char const*>(records.data()),
+              records.size() * sizeof(Record));
+    if (not run.good()) {
+        throw std::runtime_error("failed to write run file: " + runFileName);
+    }
+    return records.size();
+}
+
+/// A buffered reader of sorted records: a binary run file, or an index
+/// file when constructed with a non-zero header offset.
+class RunReader {
+public:
+    RunReader(std::string const& fileName, size_t headerBytes, uint64_t numRecords)
+        : _in(fileName, std::ios::binary), _left(numRecords) {
+        if (not _in.good()) {
+            throw std::runtime_error("failed to open file: " + fileName);
+        }
+        _in.seekg(headerBytes);
+        _advance();
+    }
+    bool valid() const { return _valid; }
+    Record const& record() const { return _record; }
+    void next() { _advance(); }
+
+private:
+    void _advance() {
+        if (_left == 0) { _valid = false; return; }
+        _in.read(reinterpret_cast<char*>(&_record), sizeof(Record));
+        _valid = _in.good();
+        --_left;
+    }
+    std::ifstream _in;
+    uint64_t _left;
+    Record _record;
+    bool _valid = false;
+};
+
+int build() {
+
+    auto const begin = std::chrono::steady_clock::now();
+
+    // Stage 1: sort the input dumps into runs, in parallel. Each run is
+    // independent, so the threads just pull file indexes off a counter.
+
+    std::vector<std::string> runFileNames(inFileNames.size());
+    std::vector<uint64_t> runSizes(inFileNames.size(), 0);
+    for (size_t i = 0; i < inFileNames.size(); ++i) {
+        runFileNames[i] = tmpDir + "/qserv-index-build." + std::to_string(::getpid())
+                        + "." + std::to_string(i) + ".run";
+    }
+    std::atomic<size_t> nextInput(0);
+    std::mutex errorMtx;
+    std::string firstError;
+
+    std::vector<std::thread> threads;
+    for (unsigned int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([&]() {
+            while (true) {
+                size_t const i = nextInput++;
+                if (i >= inFileNames.size()) break;
+                try {
+                    runSizes[i] = makeRun(inFileNames[i], runFileNames[i]);
+                } catch (std::exception const& ex) {
+                    std::lock_guard<std::mutex> lock(errorMtx);
+                    if (firstError.empty()) firstError = ex.what();
+                }
+            }
+        });
+    }
+    for (auto& t: threads) t.join();
+
+    if (not firstError.empty()) {
+        for (auto const& name: runFileNames) std::remove(name.c_str());
+        std::cerr << "error: " << firstError << std::endl;
+        return 1;
+    }
+    auto const sorted = std::chrono::steady_clock::now();
+
+    // Stage 2: merge the runs (and the previous index in append mode)
+    // into the output file. The header is rewritten at the end once the
+    // record count is final, and the file is renamed into place so that
+    // readers never observe a partially written index.
+
+    typedef std::pair<Record, size_t> HeapEntry; // record, reader index
+    auto const cmp = [](HeapEntry const& a, HeapEntry const& b) {
+        return a.first.key > b.first.key;
+    };
+    std::priority_queue<HeapEntry, std::vector<HeapEntry>, decltype(cmp)> heap(cmp);
+
+    std::vector<std::unique_ptr<RunReader>> readers;
+    for (size_t i = 0; i < runFileNames.size(); ++i) {
+        readers.emplace_back(new RunReader(runFileNames[i], 0, runSizes[i]));
+    }
+    if (not appendFileName.empty()) {
+        std::ifstream in(appendFileName, std::ios::binary);
+        FileHeader hdr;
+        if (not in.read(reinterpret_cast<char*>(&hdr), sizeof hdr)
+            or hdr.magic != qproc::sidx::INDEX_MAGIC
+            or hdr.version != qproc::sidx::INDEX_VERSION) {
+            for (auto const& name: runFileNames) std::remove(name.c_str());
+            std::cerr << "error: not a valid index file: " << appendFileName << std::endl;
+            return 1;
+        }
+        in.close();
+        readers.emplace_back(new RunReader(appendFileName, sizeof(FileHeader), hdr.numRecords));
+    }
+    for (size_t i = 0; i < readers.size(); ++i) {
+        if (readers[i]->valid()) heap.emplace(readers[i]->record(), i);
+    }
+
+    std::string const tmpOutFileName = outFileName + ".tmp";
+    std::ofstream out(tmpOutFileName, std::ios::binary | std::ios::trunc);
+    if (not out.good()) {
+        for (auto const& name: runFileNames) std::remove(name.c_str());
+        std::cerr << "error: failed to create output file: " << tmpOutFileName << std::endl;
+        return 1;
+    }
+    FileHeader hdr{qproc::sidx::INDEX_MAGIC, qproc::sidx::INDEX_VERSION, 0};
+    out.write(reinterpret_cast<char const*>(&hdr), sizeof hdr);
+
+    uint64_t numRecords = 0;
+    std::vector<Record> buffer;
+    buffer.reserve(64 * 1024);
+    while (not heap.empty()) {
+        HeapEntry const top = heap.top();
+        heap.pop();
+        buffer.push_back(top.first);
+        if (buffer.size() == buffer.capacity()) {
+            out.write(reinterpret_cast<char const*>(buffer.data()),
+                      buffer.size() * sizeof(Record));
+            buffer.clear();
+        }
+        ++numRecords;
+        readers[top.second]->next();
+        if (readers[top.second]->valid()) {
+            heap.emplace(readers[top.second]->record(), top.second);
+        }
+    }
+    out.write(reinterpret_cast<char const*>(buffer.data()),
+              buffer.size() * sizeof(Record));
+
+    hdr.numRecords = numRecords;
+    out.seekp(0);
+    out.write(reinterpret_cast<char const*>(&hdr), sizeof hdr);
+    out.close();
+
+    for (auto const& name: runFileNames) std::remove(name.c_str());
+
+    if (not out.good() or std::rename(tmpOutFileName.c_str(), outFileName.c_str()) != 0) {
+        std::remove(tmpOutFileName.c_str());
+        std::cerr << "error: failed to finalize output file: " << outFileName << std::endl;
+        return 1;
+    }
+    auto const merged = std::chrono::steady_clock::now();
+
+    double const sortSec = std::chrono::duration<double>(sorted - begin).count();
+    double const mergeSec = std::chrono::duration<double>(merged - sorted).count();
+    double const totalSec = std::chrono::duration<double>(merged - begin).count();
+    std::cout << "records:   " << numRecords << "\n"
+              << "sort:      " << sortSec << " s (" << inFileNames.size() << " runs, "
+              << numThreads << " threads)\n"
+              << "merge:     " << mergeSec << " s\n"
+              << "total:     " << totalSec << " s, "
+              << (totalSec > 0. ? numRecords / totalSec / 1e6 : 0.) << " Mrec/s" << std::endl;
+    return 0;
+}
+} // namespace
+
+int main(int argc, const char* const argv[]) {
+
+    // Parse command line parameters
+    try {
+        util::CmdLineParser parser(
+            argc,
+            argv,
+            "\n"
+            "Usage:\n"
+            "  <output> <input> [<input> [...]]\n"
+            "           [--threads=<num>]\n"
+            "           [--tmp-dir=<dir>]\n"
+            "           [--append=<index>]\n"
+            "\n"
+            "Parameters:\n"
+            "  <output>  - the index file to produce, e.g. LSST__Object.sidx\n"
+            "  <input>   - a TSV dump of a director table chunk, one row per object:\n"
+            "              <objectId> <chunkId> <subChunkId>\n"
+            "\n"
+            "Flags and options:\n"
+            "  --threads=<num>  - the number of concurrent sort threads\n"
+            "                     (default: the number of hardware threads)\n"
+            "  --tmp-dir=<dir>  - directory for the sorted runs (default: '/tmp')\n"
+            "  --append=<index> - merge an existing index file into the output, for\n"
+            "                     incremental nightly ingest\n");
+
+        ::outFileName = parser.parameter<std::string>(1);
+        ::inFileNames = parser.parameters<std::string>(2);
+        ::numThreads = parser.option<unsigned int>("threads", 0);
+        ::tmpDir = parser.option<std::string>("tmp-dir", "/tmp");
+        ::appendFileName = parser.option<std::string>("append", "");
+
+        if (::numThreads == 0) {
+            ::numThreads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        if (::inFileNames.empty()) {
+            std::cerr << "error: no input files" << std::endl;
+            return 1;
+        }
+    } catch (std::exception const& ex) {
+        return 1;
+    }
+    return ::build();
+}
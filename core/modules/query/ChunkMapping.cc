@@ -39,6 +39,24 @@ namespace query {
 
 ChunkMapping::Map
 ChunkMapping::getMapping(int chunk, int subChunk) {
+    return getMapReference(chunk, subChunk);
+}
+
+ChunkMapping::Map const&
+ChunkMapping::getMapReference(int chunk, int subChunk) {
+    // Generated table names like Object_12345 are identical across renders
+    // of the same chunk, so build the mapping once and intern it here for
+    // the lifetime of the session; later renders reuse the cached strings.
+    CacheMap::key_type const key(chunk, subChunk);
+    CacheMap::iterator i = _cache.find(key);
+    if (i == _cache.end()) {
+        i = _cache.insert(CacheMap::value_type(key, _buildMapping(chunk, subChunk))).first;
+    }
+    return i->second;
+}
+
+ChunkMapping::Map
+ChunkMapping::_buildMapping(int chunk, int subChunk) {
     Map m;
     ModeMap::const_iterator end = _map.end();
     std::string chunkStr = std::to_string(chunk);
@@ -78,12 +96,6 @@ ChunkMapping::getMapping(int chunk, int subChunk) {
     return m;
 }
 
-ChunkMapping::Map const&
-ChunkMapping::getMapReference(int chunk, int subChunk) {
-    _instanceMap = getMapping(chunk, subChunk);
-    return _instanceMap;
-}
-
 void
 ChunkMapping::setFromMeta(qdisp::ChunkMeta const& m) {
     qdisp::ChunkMeta::EntryVector const& elist = m.getEntries();
@@ -29,6 +29,7 @@
 #include <memory>
 #include <sstream>
 #include <string>
+#include <utility>
 
 // Local headers
 #include "global/stringTypes.h"
@@ -57,23 +58,31 @@ public:
     // Get a StringMapping for use with the Substitution class
     Map getMapping(int chunk, int subChunk);
 
-    // Get a reference to this instance's Mapping, which is overwritten
-    // each time this method is called.
+    // Get a reference to this instance's Mapping for (chunk, subChunk).
+    // Mappings are built once per (chunk, subChunk) pair and then cached
+    // for the lifetime of this instance (i.e. the query session), so a
+    // repeated render of the same chunk is a single map lookup and the
+    // returned strings stay at stable addresses. Adding a key invalidates
+    // the cache.
     std::map<std::string,std::string> const& getMapReference(int chunk, int subChunk);
 
     // ChunkKeys: tables partitioned into chunks (not subc)
     // SubChunkKeys: tables partitioned into chunks and subchunks.
-    void addChunkKey(std::string const& key) { _map[key] = CHUNK; }
-    void addSubChunkKey(std::string const& key) { _map[key] = CHUNK_WITH_SUB; }
+    void addChunkKey(std::string const& key) { _map[key] = CHUNK; _cache.clear(); }
+    void addSubChunkKey(std::string const& key) { _map[key] = CHUNK_WITH_SUB; _cache.clear(); }
     void setFromMeta(qdisp::ChunkMeta const& m);
 
 private:
     enum Mode {UNKNOWN, CHUNK, CHUNK_WITH_SUB};
     typedef std::map<std::string, Mode> ModeMap;
     typedef ModeMap::value_type ModeMapValue;
+    typedef std::map<std::pair<int,int>, Map> CacheMap;
+
+    // Build the mapping for (chunk, subChunk) from scratch.
+    Map _buildMapping(int chunk, int subChunk);
 
     ModeMap _map;
-    Map _instanceMap;
+    CacheMap _cache; // generated mappings, interned per (chunk, subChunk)
     std::string _subPrefix;
 };
 
@@ -33,16 +33,47 @@
 
 // System headers
 #include <iostream>
+#include <map>
+#include <mutex>
 #include <tuple>
 
 // Qserv headers
 #include "query/QueryTemplate.h"
 
+namespace { // File-scope helpers
+
+/// Pool of interned ColumnRef instances, shared by all queries. Flushed
+/// wholesale when it grows past MAX_POOL_SIZE to bound memory; entries still
+/// referenced by live statements stay alive through their shared_ptrs.
+size_t const MAX_POOL_SIZE = 10000;
+std::map<std::string, lsst::qserv::query::ColumnRef::Ptr> internPool;
+std::mutex internPoolMutex;
+
+} // anonymous namespace
+
 namespace lsst {
 namespace qserv {
 namespace query {
 
 
+ColumnRef::Ptr ColumnRef::intern(std::string const& db_,
+                                 std::string const& table_,
+                                 std::string const& column_) {
+    // '\0' cannot occur in identifiers, so this key is unambiguous.
+    std::string key = db_ + '\0' + table_ + '\0' + column_;
+    std::lock_guard<std::mutex> lock(internPoolMutex);
+    auto iter = internPool.find(key);
+    if (iter != internPool.end()) {
+        return iter->second;
+    }
+    if (internPool.size() >= MAX_POOL_SIZE) {
+        internPool.clear();
+    }
+    Ptr cr = std::make_shared<ColumnRef>(db_, table_, column_);
+    internPool[key] = cr;
+    return cr;
+}
+
 std::ostream& operator<<(std::ostream& os, ColumnRef const& cr) {
     os << "ColumnRef(";
     os << "db:" << cr.db;
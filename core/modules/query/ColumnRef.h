@@ -56,6 +56,13 @@ public:
                          std::string const& column_) {
         return std::make_shared<ColumnRef>(db_, table_, column_);
     }
+    /// Return a pooled instance for the given triple. db/table/column triples
+    /// are highly repetitive across queries, so interning them deduplicates
+    /// allocations. Pooled instances are shared; holders that need to mutate
+    /// one must copy first (ValueFactor's non-const accessor does this).
+    static Ptr intern(std::string const& db_,
+                      std::string const& table_,
+                      std::string const& column_);
 
     std::string db;
     std::string table;
@@ -95,6 +95,10 @@ public:
 
     bool needsMerge{false}; ///< Does this query require a merge/post-processing step?
 
+    /// For plain LIMIT queries (no ORDER BY, DISTINCT, or aggregation), the
+    /// number of rows each worker task needs to produce; 0 means no budget.
+    int rowBudget{0};
+
     css::StripingParams getDbStriping() {
         return css->getDbStriping(dominantDb); }
     bool containsDb(std::string const& dbName) {
@@ -55,7 +55,9 @@ namespace query {
 ValueFactorPtr ValueFactor::newColumnRefFactor(std::shared_ptr<ColumnRef const> cr) {
     ValueFactorPtr term = std::make_shared<ValueFactor>();
     term->_type = COLUMNREF;
-    term->_columnRef = std::make_shared<ColumnRef>(*cr);
+    // Share the interned instance; the non-const accessor detaches a private
+    // copy if a mutation is requested later.
+    term->_columnRef = ColumnRef::intern(cr->db, cr->table, cr->column);
     return term;
 }
 
@@ -121,10 +123,9 @@ void ValueFactor::findColumnRefs(ColumnRef::Vector& vector) const {
 
 ValueFactorPtr ValueFactor::clone() const{
     ValueFactorPtr expr = std::make_shared<ValueFactor>(*this);
-    // Clone refs.
-    if (_columnRef.get()) {
-        expr->_columnRef = std::make_shared<ColumnRef>(*_columnRef);
-    }
+    // Clone refs. The ColumnRef is shared rather than deep-copied: plugin
+    // passes clone statements far more often than they patch column refs,
+    // and the non-const accessor copies on write.
     if (_funcExpr.get()) {
         expr->_funcExpr = _funcExpr->clone();
     }
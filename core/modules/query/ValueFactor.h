@@ -68,7 +68,15 @@ public:
 
     // May need non-const, otherwise, need new construction
     std::shared_ptr<ColumnRef const> getColumnRef() const { return _columnRef; }
-    std::shared_ptr<ColumnRef> getColumnRef() { return _columnRef; }
+    /// Non-const access implies intent to mutate. The ColumnRef may be shared
+    /// with other factors (clone() shares it, and interned refs are shared by
+    /// construction), so detach a private copy first: copy-on-write.
+    std::shared_ptr<ColumnRef> getColumnRef() {
+        if (_columnRef != nullptr && _columnRef.use_count() > 1) {
+            _columnRef = std::make_shared<ColumnRef>(*_columnRef);
+        }
+        return _columnRef;
+    }
     std::shared_ptr<FuncExpr const> getFuncExpr() const { return _funcExpr; }
     std::shared_ptr<FuncExpr> getFuncExpr() { return _funcExpr; }
     std::shared_ptr<ValueExpr const> getExpr() const { return _valueExpr; }
@@ -36,6 +36,7 @@
 
 // Qserv headers
 #include "query/ColumnRef.h"
+#include "query/ValueFactor.h"
 
 // Boost unit test header
 #define BOOST_TEST_MODULE ColumnRef
@@ -105,6 +106,35 @@ BOOST_DATA_TEST_CASE(ColumnRefMatches, COLUMN_REF_MATCHES, columns) {
 }
 
 
+BOOST_AUTO_TEST_CASE(Intern) {
+    // Interning the same triple must hand back the same instance.
+    auto a = query::ColumnRef::intern("db", "tbl", "col");
+    auto b = query::ColumnRef::intern("db", "tbl", "col");
+    BOOST_CHECK(a == b);
+    // Different triples get different instances, even when the concatenated
+    // fields are identical.
+    auto c = query::ColumnRef::intern("db", "tblc", "ol");
+    BOOST_CHECK(a != c);
+    BOOST_CHECK(*a == *b);
+}
+
+
+BOOST_AUTO_TEST_CASE(CopyOnWrite) {
+    // A cloned factor shares its ColumnRef until one side mutates.
+    auto factor = query::ValueFactor::newColumnRefFactor(
+            query::ColumnRef::newShared("db", "tbl", "col"));
+    auto copy = factor->clone();
+    query::ValueFactor const& constFactor = *factor;
+    query::ValueFactor const& constCopy = *copy;
+    BOOST_CHECK(constFactor.getColumnRef() == constCopy.getColumnRef());
+    // Non-const access detaches a private instance for mutation.
+    copy->getColumnRef()->table = "alias";
+    BOOST_CHECK(constFactor.getColumnRef() != constCopy.getColumnRef());
+    BOOST_CHECK_EQUAL(factor->getColumnRef()->table, "tbl");
+    BOOST_CHECK_EQUAL(copy->getColumnRef()->table, "alias");
+}
+
+
 BOOST_AUTO_TEST_SUITE_END()
 
 
@@ -57,18 +57,25 @@ std::ostream& operator<<(std::ostream& os, Chunk const& chunk) {
 //                ChunkLocker              //
 /////////////////////////////////////////////
 
+size_t const ChunkLocker::_numShards;
+
 bool ChunkLocker::isLocked(Chunk const& chunk) const {
-    util::Lock mLock(_mtx, "ChunkLocker::isLocked(chunk)");
-    return _chunk2owner.count(chunk);
+
+    Shard const& shard = _shards[shardIdx(chunk)];
+
+    util::Lock mLock(shard.mtx, "ChunkLocker::isLocked(chunk)");
+    return shard.chunk2owner.count(chunk);
 }
 
 bool ChunkLocker::isLocked(Chunk const& chunk,
                            std::string& owner) const {
 
-    util::Lock mLock(_mtx, "ChunkLocker::isLocked(chunk,owner)");
+    Shard const& shard = _shards[shardIdx(chunk)];
 
-    auto itr = _chunk2owner.find(chunk);
-    if (itr != _chunk2owner.end()) {
+    util::Lock mLock(shard.mtx, "ChunkLocker::isLocked(chunk,owner)");
+
+    auto itr = shard.chunk2owner.find(chunk);
+    if (itr != shard.chunk2owner.end()) {
         owner = itr->second;
         return true;
     }
@@ -77,21 +84,23 @@ bool ChunkLocker::isLocked(Chunk const& chunk,
 
 ChunkLocker::OwnerToChunks ChunkLocker::locked(std::string const& owner) const {
 
-    util::Lock mLock(_mtx, "ChunkLocker::locked");
-
     OwnerToChunks owner2chunks;
-    lockedImpl(mLock,
-               owner,
-               owner2chunks);
-
+    for (Shard const& shard: _shards) {
+        util::Lock mLock(shard.mtx, "ChunkLocker::locked");
+        lockedImpl(mLock,
+                   shard,
+                   owner,
+                   owner2chunks);
+    }
     return owner2chunks;
 }
 
 void ChunkLocker::lockedImpl(util::Lock const& mLock,
+                             ChunkLocker::Shard const& shard,
                              std::string const& owner,
                              ChunkLocker::OwnerToChunks& owner2chunks) const {
 
-    for (auto&& entry: _chunk2owner) {
+    for (auto&& entry: shard.chunk2owner) {
         Chunk       const& chunk      = entry.first;
         std::string const& chunkOwner = entry.second;
 
@@ -104,70 +113,145 @@ void ChunkLocker::lockedImpl(util::Lock const& mLock,
 bool ChunkLocker::lock(Chunk const&       chunk,
                        std::string const& owner) {
 
-    util::Lock mLock(_mtx, "ChunkLocker::lock");
-
     if (owner.empty()) {
         throw std::invalid_argument("ChunkLocker::lock  empty owner");
     }
-    auto itr = _chunk2owner.find(chunk);
-    if (itr != _chunk2owner.end()) return owner == itr->second;
+    Shard& shard = _shards[shardIdx(chunk)];
+
+    util::Lock mLock(shard.mtx, "ChunkLocker::lock");
 
-    _chunk2owner[chunk] = owner;
+    auto itr = shard.chunk2owner.find(chunk);
+    if (itr != shard.chunk2owner.end()) return owner == itr->second;
+
+    shard.chunk2owner[chunk] = owner;
     return true;
 }
 
+std::list<Chunk> ChunkLocker::lock(std::list<Chunk> const& chunks,
+                                   std::string const& owner) {
+
+    if (owner.empty()) {
+        throw std::invalid_argument("ChunkLocker::lock  empty owner");
+    }
+
+    // Regroup the input collection by shards of the lock table, so that
+    // each shard's mutex would be acquired just once regardless of a number
+    // of chunks landing on the shard.
+
+    std::map<size_t, std::list<Chunk>> shard2chunks;
+    for (auto&& chunk: chunks) {
+        shard2chunks[shardIdx(chunk)].push_back(chunk);
+    }
+
+    std::list<Chunk> lockedChunks;
+    for (auto&& entry: shard2chunks) {
+        Shard& shard = _shards[entry.first];
+
+        util::Lock mLock(shard.mtx, "ChunkLocker::lock(chunks)");
+
+        for (auto&& chunk: entry.second) {
+            auto itr = shard.chunk2owner.find(chunk);
+            if (itr != shard.chunk2owner.end()) {
+                if (owner == itr->second) lockedChunks.push_back(chunk);
+                continue;
+            }
+            shard.chunk2owner[chunk] = owner;
+            lockedChunks.push_back(chunk);
+        }
+    }
+    return lockedChunks;
+}
+
 bool ChunkLocker::release(Chunk const& chunk) {
 
-    util::Lock mLock(_mtx, "ChunkLocker::release(chunk)");
+    Shard& shard = _shards[shardIdx(chunk)];
+
+    util::Lock mLock(shard.mtx, "ChunkLocker::release(chunk)");
 
     // An owner (if set) will be ignored by the current method
 
     std::string owner;
-    return releaseImpl(mLock, chunk, owner);
+    return releaseImpl(mLock, shard, chunk, owner);
 }
 
 bool ChunkLocker::release(Chunk const& chunk,
                           std::string& owner) {
 
-    util::Lock mLock(_mtx, "ChunkLocker::release(chunk,owner)");
-    return releaseImpl(mLock, chunk, owner);
+    Shard& shard = _shards[shardIdx(chunk)];
+
+    util::Lock mLock(shard.mtx, "ChunkLocker::release(chunk,owner)");
+    return releaseImpl(mLock, shard, chunk, owner);
+}
+
+size_t ChunkLocker::release(std::list<Chunk> const& chunks) {
+
+    // Regroup the input collection by shards of the lock table, so that
+    // each shard's mutex would be acquired just once regardless of a number
+    // of chunks landing on the shard.
+
+    std::map<size_t, std::list<Chunk>> shard2chunks;
+    for (auto&& chunk: chunks) {
+        shard2chunks[shardIdx(chunk)].push_back(chunk);
+    }
+
+    size_t numReleased = 0;
+    for (auto&& entry: shard2chunks) {
+        Shard& shard = _shards[entry.first];
+
+        util::Lock mLock(shard.mtx, "ChunkLocker::release(chunks)");
+
+        for (auto&& chunk: entry.second) {
+
+            // An owner (if set) will be ignored by the current method
+
+            std::string owner;
+            if (releaseImpl(mLock, shard, chunk, owner)) ++numReleased;
+        }
+    }
+    return numReleased;
 }
 
 bool ChunkLocker::releaseImpl(util::Lock const& mLock,
+                              ChunkLocker::Shard& shard,
                               Chunk const& chunk,
                               std::string& owner) {
 
-    auto itr = _chunk2owner.find(chunk);
-    if (itr == _chunk2owner.end()) return false;
+    auto itr = shard.chunk2owner.find(chunk);
+    if (itr == shard.chunk2owner.end()) return false;
 
     // ATTENTION: remove the chunk from this map _only_ after
     //            getting its owner
 
     owner = itr->second;
-    _chunk2owner.erase(itr);
+    shard.chunk2owner.erase(itr);
 
     return true;
 }
 
 std::list<Chunk> ChunkLocker::release(std::string const& owner) {
 
-    util::Lock mLock(_mtx, "ChunkLocker::release(owner)");
-
     if (owner.empty()) {
         throw std::invalid_argument("ChunkLocker::release  empty owner");
     }
 
     // Get rid of chunks owned by the specified owner, and also collect
-    // those (removed) chunks into a vector to be returned to a caller.
+    // those (removed) chunks into a collection to be returned to a caller.
 
-    OwnerToChunks owner2chunks;
-    lockedImpl(mLock,
-               owner,
-               owner2chunks);
+    std::list<Chunk> chunks;
+    for (Shard& shard: _shards) {
 
-    std::list<Chunk> chunks = owner2chunks[owner];
-    for (auto&& chunk: chunks) {
-        _chunk2owner.erase(chunk);
+        util::Lock mLock(shard.mtx, "ChunkLocker::release(owner)");
+
+        OwnerToChunks owner2chunks;
+        lockedImpl(mLock,
+                   shard,
+                   owner,
+                   owner2chunks);
+
+        for (auto&& chunk: owner2chunks[owner]) {
+            shard.chunk2owner.erase(chunk);
+            chunks.push_back(chunk);
+        }
     }
     return chunks;
 }
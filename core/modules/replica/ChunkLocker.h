@@ -30,6 +30,7 @@
 /// (see individual class documentation for more information)
 
 // System headers
+#include <array>
 #include <list>
 #include <map>
 #include <ostream>
@@ -82,6 +83,10 @@ std::ostream& operator<< (std::ostream& os, Chunk const& chunk);
  * Class ChunkLocker provides a thread-safe mechanism allowing
  * owners (represented by unique string-based identifiers) to claim
  * exclusive 'locks' (ownership claims) on chunks.
+ *
+ * The lock table is sharded by a hash of the chunk number, with each
+ * shard guarded by its own mutex. This reduces the contention between
+ * jobs which lock and release chunks concurrently.
  */
 class ChunkLocker {
 
@@ -148,6 +153,24 @@ public:
     bool lock(Chunk const&       chunk,
               std::string const& owner);
 
+    /**
+     * Lock a collection of chunks to a specific owner
+     *
+     * The input collection is regrouped by shards of the lock table, so
+     * that each shard's mutex is acquired just once regardless of a number
+     * of chunks. Chunks which are found locked by another owner are skipped.
+     *
+     * @param chunks - chunks to be locked
+     * @param owner  - an identifier of an owner claiming the chunks
+     *
+     * @return a collection of chunks which were successfully locked (this
+     * also includes chunks which were already locked by the same owner)
+     *
+     * @throw std::invalid_argument - if the owner 'id' is an empty string
+     */
+    std::list<Chunk> lock(std::list<Chunk> const& chunks,
+                          std::string const& owner);
+
     /**
      * Release a chunk regardless of its owner
      *
@@ -171,6 +194,19 @@ public:
     bool release(Chunk const& chunk,
                  std::string& owner);
 
+    /**
+     * Release a collection of chunks regardless of their owners
+     *
+     * The input collection is regrouped by shards of the lock table, so
+     * that each shard's mutex is acquired just once regardless of a number
+     * of chunks.
+     *
+     * @param chunks - chunks to be released
+     *
+     * @return the number of chunks actually released
+     */
+    size_t release(std::list<Chunk> const& chunks);
+
     /**
      * Release all chunks which were found claimed by the specified owner
      * and return a collection of those chunks
@@ -181,11 +217,36 @@ public:
 
 private:
 
+    /// The number of shards in the lock table
+    static size_t const _numShards = 16;
+
+    /// The type for a shard of the lock table
+    struct Shard {
+
+        /// Mapping a chunk to its "owner" (the one which holds the lock)
+        ChunkToOwner chunk2owner;
+
+        /// For thread safety where it's required
+        mutable util::Mutex mtx;
+    };
+
     /**
-     * Find chunks which are loacked by a particular owner (if provided),
-     * or by all owners.
+     * @param chunk - a chunk to be mapped onto the lock table
+     *
+     * @return an index of a shard of the lock table which is responsible
+     * for the chunk
+     */
+    static size_t shardIdx(Chunk const& chunk) {
+        return chunk.number % _numShards;
+    }
+
+    /**
+     * Find chunks of a shard which are loacked by a particular owner
+     * (if provided), or by all owners.
      *
-     * @param mLock  - a lock on a mutex must be made before calling this method
+     * @param mLock  - a lock on the shard's mutex must be made before calling
+     *                 this method
+     * @param shard  - a shard of the lock table to be inspected
      * @param owner  - an optional owner. If the owner is not provided then
      *                 all chunks will be returned
      * @owner2chunks - collection of chunks to be initialized
@@ -193,6 +254,7 @@ private:
      * @return a collection of chunks groupped by owners
      */
     void lockedImpl(util::Lock const& mLock,
+                    Shard const& shard,
                     std::string const& owner,
                     OwnerToChunks& owner2chunks) const;
 
@@ -204,7 +266,9 @@ private:
      * NOTE: this metod is not thread-safe. It's up to its callers to ensure
      *       proper synchronization context before invoking the method.
      *
-     * @param mLock - a lock on a mutex must be made before calling this method
+     * @param mLock - a lock on the shard's mutex must be made before calling
+     *                this method
+     * @param shard - a shard of the lock table holding the chunk (if locked)
      * @param chunk - a chunk to be released
      * @param owner - a reference to a string which will be initialized with
      *                an identifier of an owner which had a claim on the chunk
@@ -213,16 +277,14 @@ private:
      * @return 'true' if the operation was successful
      */
     bool releaseImpl(util::Lock const& mLock,
+                     Shard& shard,
                      Chunk const& chunk,
                      std::string& owner);
 
 private:
 
-    /// Mapping a chunk to its "owner" (the one which holds the lock)
-    ChunkToOwner _chunk2owner;
-
-    /// For thread safety where it's required
-    mutable util::Mutex _mtx;
+    /// The lock table sharded by a hash of the chunk number
+    std::array<Shard, _numShards> _shards;
 };
 
 }}} // namespace lsst::qserv::replica
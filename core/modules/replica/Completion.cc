@@ -0,0 +1,77 @@
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "replica/Completion.h"
+
+namespace lsst {
+namespace qserv {
+namespace replica {
+
+std::function<void()> Completion::expect() {
+
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        _numExpected++;
+    }
+
+    // The returned function counts a completion and wakes up the waiting
+    // threads. It must be called exactly once.
+
+    return [this] () {
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+            _numFinished++;
+        }
+        _cv.notify_all();
+    };
+}
+
+void Completion::waitAll() {
+    std::unique_lock<std::mutex> lock(_mtx);
+    _cv.wait(lock, [this] () { return _numFinished >= _numExpected; });
+}
+
+bool Completion::waitAllFor(std::chrono::milliseconds const& timeout) {
+    std::unique_lock<std::mutex> lock(_mtx);
+    return _cv.wait_for(lock, timeout,
+                        [this] () { return _numFinished >= _numExpected; });
+}
+
+size_t Completion::waitAny() {
+    std::unique_lock<std::mutex> lock(_mtx);
+    _cv.wait(lock, [this] () { return _numFinished > _numSeen; });
+    _numSeen = _numFinished;
+    return _numFinished;
+}
+
+size_t Completion::numExpected() const {
+    std::lock_guard<std::mutex> lock(_mtx);
+    return _numExpected;
+}
+
+size_t Completion::numFinished() const {
+    std::lock_guard<std::mutex> lock(_mtx);
+    return _numFinished;
+}
+
+}}} // namespace lsst::qserv::replica
@@ -0,0 +1,137 @@
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_REPLICA_COMPLETION_H
+#define LSST_QSERV_REPLICA_COMPLETION_H
+
+/// Completion.h declares:
+///
+/// class Completion
+///
+/// (see individual class documentation for more information)
+
+// System headers
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+
+// This header declarations
+
+namespace lsst {
+namespace qserv {
+namespace replica {
+
+/**
+ * Class Completion is a condition variable based primitive for waiting on
+ * the completion of a set of asynchronous operations (requests or jobs)
+ * without polling. A waiter registers each operation via method expect()
+ * and arranges for the returned function to be called from the operation's
+ * 'onFinish' callback. Then the waiter blocks in waitAll() (or waitAny())
+ * and is woken up the moment a completion arrives, instead of discovering
+ * it at the next iteration of a sleep loop.
+ *
+ * Here is how the class is supposed to be used:
+ *
+ * @code
+ *   Completion completion;
+ *
+ *   auto const done = completion.expect();
+ *   auto job = SomeJob::create(
+ *       controller,
+ *       parentJobId,
+ *       [done] (SomeJob::Ptr const& job) {
+ *           done();
+ *       });
+ *   job->start();
+ *
+ *   completion.waitAll();
+ * @endcode
+ *
+ * The object must stay alive until the last registered completion function
+ * has been called. Completion functions may be called from any thread.
+ */
+class Completion {
+
+public:
+
+    Completion() = default;
+
+    // Copy semantics is prohibited
+
+    Completion(Completion const&) = delete;
+    Completion& operator=(Completion const&) = delete;
+
+    ~Completion() = default;
+
+    /**
+     * Register one more operation to be waited upon.
+     *
+     * @return a function to be called exactly once when the operation
+     * completes
+     */
+    std::function<void()> expect();
+
+    /**
+     * Block the calling thread until all registered operations complete.
+     */
+    void waitAll();
+
+    /**
+     * Block the calling thread until all registered operations complete,
+     * or the specified timeout expires, whichever comes first. The method
+     * is meant for waiters which want to post periodic progress reports.
+     *
+     * @param timeout - the maximum duration to wait
+     *
+     * @return 'true' if all operations have completed
+     */
+    bool waitAllFor(std::chrono::milliseconds const& timeout);
+
+    /**
+     * Block the calling thread until at least one operation which was not
+     * yet seen by a previous call to this method completes. The method
+     * returns immediately if such operation has already completed.
+     *
+     * @return the total number of operations completed so far
+     */
+    size_t waitAny();
+
+    /// @return the number of operations registered so far
+    size_t numExpected() const;
+
+    /// @return the number of operations completed so far
+    size_t numFinished() const;
+
+private:
+
+    mutable std::mutex _mtx;        ///< for implementing synchronized methods
+    std::condition_variable _cv;    ///< for suspending the waiting threads
+
+    size_t _numExpected{0};     ///< the number of operations registered
+    size_t _numFinished{0};     ///< the number of operations completed
+    size_t _numSeen{0};         ///< completions consumed by waitAny()
+};
+
+}}} // namespace lsst::qserv::replica
+
+#endif // LSST_QSERV_REPLICA_COMPLETION_H
@@ -26,6 +26,7 @@
 // System headers
 #include <set>
 #include <stdexcept>
+#include <thread>
 
 // Qserv headers
 #include "lsst/log/Log.h"
@@ -108,6 +109,47 @@ Configuration::Ptr Configuration::load(std::map<std::string, std::string> const&
     return std::make_shared<ConfigurationMap>(kvMap);
 }
 
+unsigned int Configuration::subscribe(SubscriberCallbackType const& onChange) {
+    std::lock_guard<std::mutex> lock(_subscribersMtx);
+    unsigned int const subscriberId = _nextSubscriberId++;
+    _subscribers[subscriberId] = onChange;
+    return subscriberId;
+}
+
+void Configuration::unsubscribe(unsigned int subscriberId) {
+    std::lock_guard<std::mutex> lock(_subscribersMtx);
+    _subscribers.erase(subscriberId);
+}
+
+void Configuration::incrementVersion() {
+
+    uint64_t const version = ++_version;
+
+    std::vector<SubscriberCallbackType> subscribers;
+    {
+        std::lock_guard<std::mutex> lock(_subscribersMtx);
+        if (_subscribers.empty()) return;
+        for (auto&& entry: _subscribers) {
+            subscribers.push_back(entry.second);
+        }
+    }
+
+    // Notifications are delivered from a separate thread because the modifying
+    // methods of subclasses call this one while holding _mtx, and subscribers
+    // will typically re-read the updated state via methods which also lock it.
+    std::thread notifier([subscribers, version]() {
+        for (auto&& callback: subscribers) {
+            try {
+                callback(version);
+            } catch (std::exception const& ex) {
+                LOGS(_log, LOG_LVL_ERROR, "Configuration::incrementVersion  "
+                     << "subscriber threw an exception: " << ex.what());
+            }
+        }
+    });
+    notifier.detach();
+}
+
 // Set some reasonable defaults
 
 size_t       const Configuration::defaultRequestBufferSizeBytes      (1024);
@@ -126,6 +168,8 @@ std::string  const Configuration::defaultWorkerTechnology            ("TEST");
 size_t       const Configuration::defaultWorkerNumProcessingThreads  (1);
 size_t       const Configuration::defaultFsNumProcessingThreads      (1);
 size_t       const Configuration::defaultWorkerFsBufferSizeBytes     (1048576);
+size_t       const Configuration::defaultWorkerDiskRateLimitBytesSec (0);
+size_t       const Configuration::defaultWorkerNetRateLimitBytesSec  (0);
 std::string  const Configuration::defaultWorkerSvcHost               ("localhost");
 uint16_t     const Configuration::defaultWorkerSvcPort               (50000);
 std::string  const Configuration::defaultWorkerFsHost                ("localhost");
@@ -137,6 +181,7 @@ uint16_t     const Configuration::defaultDatabasePort                (3306);
 std::string  const Configuration::defaultDatabaseUser                (FileUtils::getEffectiveUser());
 std::string  const Configuration::defaultDatabasePassword            ("");
 std::string  const Configuration::defaultDatabaseName                ("replica");
+size_t       const Configuration::defaultDatabaseSaveBatchSize       (1000);
 size_t       const Configuration::defaultReplicationLevel            (1);
 unsigned int const Configuration::defaultNumStripes                  (340);
 unsigned int const Configuration::defaultNumSubStripes               (12);
@@ -161,7 +206,8 @@ void Configuration::translateDataDir(std::string&       dataDir,
 }
 
 Configuration::Configuration()
-    :   _requestBufferSizeBytes     (defaultRequestBufferSizeBytes),
+    :   _version                    (1),
+        _requestBufferSizeBytes     (defaultRequestBufferSizeBytes),
         _retryTimeoutSec            (defaultRetryTimeoutSec),
         _controllerThreads          (defaultControllerThreads),
         _controllerHttpPort         (defaultControllerHttpPort),
@@ -177,12 +223,15 @@ Configuration::Configuration()
         _workerNumProcessingThreads (defaultWorkerNumProcessingThreads),
         _fsNumProcessingThreads     (defaultFsNumProcessingThreads),
         _workerFsBufferSizeBytes    (defaultWorkerFsBufferSizeBytes),
+        _workerDiskRateLimitBytesSec(defaultWorkerDiskRateLimitBytesSec),
+        _workerNetRateLimitBytesSec (defaultWorkerNetRateLimitBytesSec),
         _databaseTechnology         (defaultDatabaseTechnology),
         _databaseHost               (defaultDatabaseHost),
         _databasePort               (defaultDatabasePort),
         _databaseUser               (defaultDatabaseUser),
         _databasePassword           (defaultDatabasePassword),
-        _databaseName               (defaultDatabaseName) {
+        _databaseName               (defaultDatabaseName),
+        _databaseSaveBatchSize      (defaultDatabaseSaveBatchSize) {
 }
 
 std::string Configuration::context() const {
@@ -334,6 +383,8 @@ void Configuration::dumpIntoLogger() {
     LOGS(_log, LOG_LVL_DEBUG, context() << "defaultWorkerNumProcessingThreads:   " << defaultWorkerNumProcessingThreads);
     LOGS(_log, LOG_LVL_DEBUG, context() << "defaultFsNumProcessingThreads:       " << defaultFsNumProcessingThreads);
     LOGS(_log, LOG_LVL_DEBUG, context() << "defaultWorkerFsBufferSizeBytes:      " << defaultWorkerFsBufferSizeBytes);
+    LOGS(_log, LOG_LVL_DEBUG, context() << "defaultWorkerDiskRateLimitBytesSec:  " << defaultWorkerDiskRateLimitBytesSec);
+    LOGS(_log, LOG_LVL_DEBUG, context() << "defaultWorkerNetRateLimitBytesSec:   " << defaultWorkerNetRateLimitBytesSec);
     LOGS(_log, LOG_LVL_DEBUG, context() << "defaultWorkerSvcHost:                " << defaultWorkerSvcHost);
     LOGS(_log, LOG_LVL_DEBUG, context() << "defaultWorkerSvcPort:                " << defaultWorkerSvcPort);
     LOGS(_log, LOG_LVL_DEBUG, context() << "defaultWorkerFsHost:                 " << defaultWorkerFsHost);
@@ -345,6 +396,7 @@ void Configuration::dumpIntoLogger() {
     LOGS(_log, LOG_LVL_DEBUG, context() << "defaultDatabaseUser:                 " << defaultDatabaseUser);
     LOGS(_log, LOG_LVL_DEBUG, context() << "defaultDatabasePassword:             " << "*****");
     LOGS(_log, LOG_LVL_DEBUG, context() << "defaultDatabaseName:                 " << defaultDatabaseName);
+    LOGS(_log, LOG_LVL_DEBUG, context() << "defaultDatabaseSaveBatchSize:        " << defaultDatabaseSaveBatchSize);
     LOGS(_log, LOG_LVL_DEBUG, context() << "defaultReplicationLevel:             " << defaultReplicationLevel);
     LOGS(_log, LOG_LVL_DEBUG, context() << "defaultNumStripes:                   " << defaultNumStripes);
     LOGS(_log, LOG_LVL_DEBUG, context() << "defaultNumSubStripes:                " << defaultNumSubStripes);
@@ -364,12 +416,15 @@ void Configuration::dumpIntoLogger() {
     LOGS(_log, LOG_LVL_DEBUG, context() << "_workerNumProcessingThreads:         " << _workerNumProcessingThreads);
     LOGS(_log, LOG_LVL_DEBUG, context() << "_fsNumProcessingThreads:             " << _fsNumProcessingThreads);
     LOGS(_log, LOG_LVL_DEBUG, context() << "_workerFsBufferSizeBytes:            " << _workerFsBufferSizeBytes);
+    LOGS(_log, LOG_LVL_DEBUG, context() << "_workerDiskRateLimitBytesSec:        " << _workerDiskRateLimitBytesSec);
+    LOGS(_log, LOG_LVL_DEBUG, context() << "_workerNetRateLimitBytesSec:         " << _workerNetRateLimitBytesSec);
     LOGS(_log, LOG_LVL_DEBUG, context() << "_databaseTechnology:                 " << _databaseTechnology);
     LOGS(_log, LOG_LVL_DEBUG, context() << "_databaseHost:                       " << _databaseHost);
     LOGS(_log, LOG_LVL_DEBUG, context() << "_databasePort:                       " << _databasePort);
     LOGS(_log, LOG_LVL_DEBUG, context() << "_databaseUser:                       " << _databaseUser);
     LOGS(_log, LOG_LVL_DEBUG, context() << "_databasePassword:                   " << "*****");
     LOGS(_log, LOG_LVL_DEBUG, context() << "_databaseName:                       " << _databaseName);
+    LOGS(_log, LOG_LVL_DEBUG, context() << "_databaseSaveBatchSize:              " << _databaseSaveBatchSize);
     for (auto&& elem: _workerInfo) {
         LOGS(_log, LOG_LVL_DEBUG, context() << elem.second);
     }
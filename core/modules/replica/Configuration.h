@@ -28,9 +28,12 @@
 /// (see individual class documentation for more information)
 
 // System headers
+#include <atomic>
+#include <functional>
 #include <iosfwd>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -186,6 +189,53 @@ public:
      */
     virtual std::string configUrl() const=0;
 
+    /**
+     * @return the version number of the transient state of the configuration.
+     *
+     * The number is guaranteed to monotonically increase each time
+     * the transient state gets modified (workers disabled or deleted, ports
+     * changed, the configuration reloaded from its source, etc.). Clients
+     * maintaining caches derived from the configuration may compare this
+     * number against the one memorized at a time the cache was built to
+     * cheaply check if the cache is still valid.
+     */
+    uint64_t version() const { return _version.load(); }
+
+    /// The callback type used for notifications on changes in the transient
+    /// state of the configuration. The only argument of the callback is
+    /// the new version number of the state.
+    typedef std::function<void(uint64_t)> SubscriberCallbackType;
+
+    /**
+     * Register a subscriber to be notified each time the transient state
+     * of the configuration gets modified (workers disabled or deleted, ports
+     * changed, the configuration reloaded from its source, etc.).
+     *
+     * Notifications are delivered asynchronously, from a separate thread and
+     * without any locks on the configuration held, so it's safe (and typical)
+     * for a subscriber to re-read the relevant parameters via the regular
+     * methods of this class when notified. Long-lived components (the
+     * Controller, worker processing pools, etc.) are expected to subscribe
+     * once and refresh their cached parameters from the callback, instead of
+     * being restarted to pick up new values.
+     *
+     * @param onChange - the callback function to be invoked on each change
+     *
+     * @return a unique identifier of the subscriber, to be used for
+     * unsubscribing
+     */
+    unsigned int subscribe(SubscriberCallbackType const& onChange);
+
+    /**
+     * Stop notifying the specified subscriber. The method has no effect
+     * if the identifier is unknown (including a subscriber which was already
+     * unsubscribed).
+     *
+     * @param subscriberId - an identifier returned by the earlier call to
+     * the method subscribe()
+     */
+    void unsubscribe(unsigned int subscriberId);
+
     // ------------------------------------------------------------------------
     // -- Common configuration parameters of both the controller and workers --
     // ------------------------------------------------------------------------
@@ -270,6 +320,11 @@ public:
     /// @return the name of a database to be set upon the connection
     std::string const& databaseName() const { return _databaseName; }
 
+    /// @return the number of rows to be packed into a single multi-row
+    /// statement when saving bulk collections (replica info, etc.) into
+    /// the database
+    size_t databaseSaveBatchSize() const { return _databaseSaveBatchSize; }
+
     // ---------------------------------------------------
     // -- Configuration parameters related to databases --
     // ---------------------------------------------------
@@ -430,6 +485,14 @@ public:
     /// @return the buffer size for the file I/O operations
     size_t workerFsBufferSizeBytes() const { return _workerFsBufferSizeBytes; }
 
+    /// @return the maximum rate (bytes per second) for reading input files
+    /// from the local disks during replication operations (0 means 'unlimited')
+    size_t workerDiskRateLimitBytesSec() const { return _workerDiskRateLimitBytesSec; }
+
+    /// @return the maximum rate (bytes per second) for pulling input files
+    /// over the network during replication operations (0 means 'unlimited')
+    size_t workerNetRateLimitBytesSec() const { return _workerNetRateLimitBytesSec; }
+
     // -----------
     // -- Misc. --
     // -----------
@@ -461,6 +524,8 @@ protected:
     static size_t       const defaultWorkerNumProcessingThreads;
     static size_t       const defaultFsNumProcessingThreads;
     static size_t       const defaultWorkerFsBufferSizeBytes;
+    static size_t       const defaultWorkerDiskRateLimitBytesSec;
+    static size_t       const defaultWorkerNetRateLimitBytesSec;
     static std::string  const defaultWorkerSvcHost;
     static uint16_t     const defaultWorkerSvcPort;
     static std::string  const defaultWorkerFsHost;
@@ -472,6 +537,7 @@ protected:
     static std::string  const defaultDatabaseUser;
     static std::string  const defaultDatabasePassword;
     static std::string  const defaultDatabaseName;
+    static size_t       const defaultDatabaseSaveBatchSize;
     static size_t       const defaultReplicationLevel;
     static unsigned int const defaultNumStripes;
     static unsigned int const defaultNumSubStripes;
@@ -496,11 +562,29 @@ protected:
     /// @return the context string for debugging and diagnostic printouts
     std::string context() const;
 
+    /// Advance the version number of the transient state and notify
+    /// the registered subscribers (if any). The method is required to be
+    /// called by subclasses upon each modification of the state (including
+    /// reloading it from the configuration source).
+    void incrementVersion();
+
 protected:
 
     /// To be used were thread safety is required
     mutable util::Mutex _mtx;
 
+    /// The version number of the transient state
+    /// @see Configuration::version()
+    std::atomic<uint64_t> _version;
+
+    /// Registered change subscribers and the generator of their identifiers.
+    /// The collection is guarded by its own mutex (not by _mtx) because
+    /// subscribers are notified of changes made while _mtx is held.
+    /// @see Configuration::subscribe()
+    std::map<unsigned int, SubscriberCallbackType> _subscribers;
+    unsigned int _nextSubscriberId = 1;
+    mutable std::mutex _subscribersMtx;
+
     // -- Cached values of parameters --
 
     size_t       _requestBufferSizeBytes;
@@ -527,6 +611,8 @@ protected:
     size_t _workerNumProcessingThreads;
     size_t _fsNumProcessingThreads;
     size_t _workerFsBufferSizeBytes;
+    size_t _workerDiskRateLimitBytesSec;
+    size_t _workerNetRateLimitBytesSec;
 
     std::map<std::string, DatabaseFamilyInfo> _databaseFamilyInfo;
     std::map<std::string, DatabaseInfo>       _databaseInfo;
@@ -551,6 +637,10 @@ protected:
 
     /// The name of a database to be set upon the connection
     std::string _databaseName;
+
+    /// The number of rows per a single multi-row statement when saving
+    /// bulk collections into the database
+    size_t _databaseSaveBatchSize;
 };
 
 }}} // namespace lsst::qserv::replica
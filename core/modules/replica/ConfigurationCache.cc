@@ -0,0 +1,98 @@
+/*
+ * LSST Data Management System
+ * Copyright 2017 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "replica/ConfigurationCache.h"
+
+namespace lsst {
+namespace qserv {
+namespace replica {
+
+ConfigurationCache::Ptr ConfigurationCache::create(
+                            std::shared_ptr<Configuration> const& configuration) {
+    return ConfigurationCache::Ptr(
+        new ConfigurationCache(configuration));
+}
+
+ConfigurationCache::ConfigurationCache(std::shared_ptr<Configuration> const& configuration)
+    :   _configuration(configuration),
+        _version(0) {
+}
+
+ConfigurationCache::WorkerInfoPtr ConfigurationCache::workerInfo(std::string const& name) const {
+
+    util::Lock lock(_mtx, "ConfigurationCache::workerInfo");
+
+    validateCache(lock);
+
+    auto itr = _workerInfo.find(name);
+    if (_workerInfo.end() == itr) {
+        itr = _workerInfo.insert(
+            std::make_pair(
+                name,
+                std::make_shared<WorkerInfo const>(
+                    _configuration->workerInfo(name)))).first;
+    }
+    return itr->second;
+}
+
+ConfigurationCache::DatabaseInfoPtr ConfigurationCache::databaseInfo(std::string const& name) const {
+
+    util::Lock lock(_mtx, "ConfigurationCache::databaseInfo");
+
+    validateCache(lock);
+
+    auto itr = _databaseInfo.find(name);
+    if (_databaseInfo.end() == itr) {
+        itr = _databaseInfo.insert(
+            std::make_pair(
+                name,
+                std::make_shared<DatabaseInfo const>(
+                    _configuration->databaseInfo(name)))).first;
+    }
+    return itr->second;
+}
+
+void ConfigurationCache::invalidate() {
+
+    util::Lock lock(_mtx, "ConfigurationCache::invalidate");
+
+    _workerInfo.clear();
+    _databaseInfo.clear();
+
+    _version = 0;
+}
+
+void ConfigurationCache::validateCache(util::Lock const& lock) const {
+
+    // Note that versions of the Configuration start with 1, hence the value
+    // of 0 kept by an invalidated cache never matches.
+
+    uint64_t const version = _configuration->version();
+    if (version != _version) {
+        _workerInfo.clear();
+        _databaseInfo.clear();
+        _version = version;
+    }
+}
+
+}}} // namespace lsst::qserv::replica
@@ -0,0 +1,156 @@
+/*
+ * LSST Data Management System
+ * Copyright 2017 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_REPLICA_CONFIGURATIONCACHE_H
+#define LSST_QSERV_REPLICA_CONFIGURATIONCACHE_H
+
+/// ConfigurationCache.h declares:
+///
+/// class ConfigurationCache
+/// (see individual class documentation for more information)
+
+// System headers
+#include <map>
+#include <memory>
+#include <string>
+
+// Qserv headers
+#include "replica/Configuration.h"
+#include "util/Mutex.h"
+
+// This header declarations
+
+namespace lsst {
+namespace qserv {
+namespace replica {
+
+/**
+ * Class ConfigurationCache is a versioned in-process cache of the worker
+ * and database descriptors of the Configuration.
+ *
+ * The descriptors are returned via shared pointers onto immutable objects,
+ * which makes repeated lookups cheap (no copying of the descriptors and
+ * no contention on the Configuration mutex) when a large number of requests
+ * is issued against the same set of workers and databases.
+ *
+ * The cache tracks the version number of the Configuration (see method
+ * Configuration::version()) and transparently discards its content when
+ * the configuration gets modified. Method invalidate() is also provided
+ * for discarding the content explicitly.
+ *
+ * THREAD SAFETY: the cache is thread-safe.
+ */
+class ConfigurationCache {
+
+public:
+
+    /// The pointer type for instances of the class
+    typedef std::shared_ptr<ConfigurationCache> Ptr;
+
+    // Pointers onto the immutable cached descriptors
+
+    typedef std::shared_ptr<WorkerInfo const>   WorkerInfoPtr;
+    typedef std::shared_ptr<DatabaseInfo const> DatabaseInfoPtr;
+
+    /**
+     * Static factory method is needed to prevent issue with the lifespan
+     * and memory management of instances created otherwise (as values or via
+     * low-level pointers).
+     *
+     * @param configuration - the configuration service
+     *
+     * @return pointer to the created object
+     */
+    static Ptr create(std::shared_ptr<Configuration> const& configuration);
+
+    // Default construction and copy semantics are prohibited
+
+    ConfigurationCache() = delete;
+    ConfigurationCache(ConfigurationCache const&) = delete;
+    ConfigurationCache& operator=(ConfigurationCache const&) = delete;
+
+    ~ConfigurationCache() = default;
+
+    /**
+     * Return a pointer onto the cached worker descriptor
+     *
+     * @param name - the name of a worker
+     *
+     * @throw std::invalid_argument - if the specified worker was not found in
+     *                                the configuration.
+     */
+    WorkerInfoPtr workerInfo(std::string const& name) const;
+
+    /**
+     * Return a pointer onto the cached database descriptor
+     *
+     * @param name - the name of a database
+     *
+     * @throw std::invalid_argument - if the specified database was not found in
+     *                                the configuration
+     */
+    DatabaseInfoPtr databaseInfo(std::string const& name) const;
+
+    /**
+     * Explicitly discard the content of the cache. The descriptors will be
+     * re-fetched from the Configuration on the next lookups.
+     */
+    void invalidate();
+
+private:
+
+    /**
+     * Construct the object
+     *
+     * @see ConfigurationCache::create()
+     */
+    explicit ConfigurationCache(std::shared_ptr<Configuration> const& configuration);
+
+    /**
+     * Discard the content of the cache if the Configuration has been
+     * modified since the content was built.
+     *
+     * @param lock - lock on a mutex must be acquired before calling this method
+     */
+    void validateCache(util::Lock const& lock) const;
+
+private:
+
+    /// The configuration service
+    std::shared_ptr<Configuration> _configuration;
+
+    /// The version of the Configuration the content of the cache was
+    /// built from (0 if the cache is invalid)
+    mutable uint64_t _version;
+
+    /// Cached worker descriptors
+    mutable std::map<std::string, WorkerInfoPtr> _workerInfo;
+
+    /// Cached database descriptors
+    mutable std::map<std::string, DatabaseInfoPtr> _databaseInfo;
+
+    /// The mutex for enforcing thread safety of the operations
+    mutable util::Mutex _mtx;
+};
+
+}}} // namespace lsst::qserv::replica
+
+#endif // LSST_QSERV_REPLICA_CONFIGURATIONCACHE_H
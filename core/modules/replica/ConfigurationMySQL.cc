@@ -84,7 +84,9 @@ ConfigurationMySQL::ConfigurationMySQL(database::mysql::ConnectionParams const&
     :   Configuration(),
         _connectionParams(connectionParams) {
 
-    loadConfiguration();
+    util::Lock lock(_mtx, context() + "ConfigurationMySQL::constructor");
+
+    loadConfiguration(lock);
 }
 
 std::string ConfigurationMySQL::configUrl() const {
@@ -118,6 +120,8 @@ WorkerInfo const ConfigurationMySQL::disableWorker(std::string const& name) {
         }
         itr->second.isEnabled = false;
 
+        incrementVersion();
+
     } catch (database::mysql::Error const& ex) {
         LOGS(_log, LOG_LVL_ERROR, context() << "MySQL error: " << ex.what());
         if (conn and conn->inTransaction()) {
@@ -150,6 +154,8 @@ void ConfigurationMySQL::deleteWorker(std::string const& name) {
         }
         _workerInfo.erase(itr);
 
+        incrementVersion();
+
     } catch (database::mysql::Error const& ex) {
         LOGS(_log, LOG_LVL_ERROR, context ()<< ex.what());
         if (conn and conn->inTransaction()) {
@@ -184,6 +190,8 @@ WorkerInfo const ConfigurationMySQL::setWorkerSvcPort(std::string const& name,
         }
         itr->second.svcPort = port;
 
+        incrementVersion();
+
     } catch (database::mysql::Error const& ex) {
         LOGS(_log, LOG_LVL_ERROR, context() << "MySQL error: " << ex.what());
         if (conn and conn->inTransaction()) {
@@ -220,6 +228,8 @@ WorkerInfo const ConfigurationMySQL::setWorkerFsPort(std::string const& name,
         }
         itr->second.fsPort = port;
 
+        incrementVersion();
+
     } catch (database::mysql::Error const& ex) {
         LOGS(_log, LOG_LVL_ERROR, context() << "MySQL error: " << ex.what());
         if (conn and conn->inTransaction()) {
@@ -229,11 +239,22 @@ WorkerInfo const ConfigurationMySQL::setWorkerFsPort(std::string const& name,
     return workerInfo(name);
 }
 
-void ConfigurationMySQL::loadConfiguration() {
+void ConfigurationMySQL::reload() {
 
-    LOGS(_log, LOG_LVL_DEBUG, context() << "ConfigurationMySQL::loadConfiguration");
+    LOGS(_log, LOG_LVL_DEBUG, context() << "ConfigurationMySQL::reload");
+
+    util::Lock lock(_mtx, context() + "ConfigurationMySQL::reload");
 
-    util::Lock lock(_mtx, context() + "ConfigurationMySQL::loadConfiguration");
+    _workerInfo.clear();
+    _databaseInfo.clear();
+    _databaseFamilyInfo.clear();
+
+    loadConfiguration(lock);
+}
+
+void ConfigurationMySQL::loadConfiguration(util::Lock const& lock) {
+
+    LOGS(_log, LOG_LVL_DEBUG, context() << "ConfigurationMySQL::loadConfiguration");
 
     // The common parameters (if any defined) of the workers will be intialize
     // from table 'config' and be used as defaults when reading worker-specific
@@ -258,6 +279,7 @@ void ConfigurationMySQL::loadConfiguration() {
 
         ::tryParameter(row, "common", "request_buf_size_bytes",     _requestBufferSizeBytes) or
         ::tryParameter(row, "common", "request_retry_interval_sec", _retryTimeoutSec) or
+        ::tryParameter(row, "common", "database_save_batch_size",   _databaseSaveBatchSize) or
 
         ::tryParameter(row, "controller", "num_threads",         _controllerThreads) or
         ::tryParameter(row, "controller", "http_server_port",    _controllerHttpPort) or
@@ -275,6 +297,8 @@ void ConfigurationMySQL::loadConfiguration() {
         ::tryParameter(row, "worker", "num_svc_processing_threads", _workerNumProcessingThreads) or
         ::tryParameter(row, "worker", "num_fs_processing_threads",  _fsNumProcessingThreads) or
         ::tryParameter(row, "worker", "fs_buf_size_bytes",          _workerFsBufferSizeBytes) or
+        ::tryParameter(row, "worker", "disk_rate_limit_bytes_sec",  _workerDiskRateLimitBytesSec) or
+        ::tryParameter(row, "worker", "net_rate_limit_bytes_sec",   _workerNetRateLimitBytesSec) or
         ::tryParameter(row, "worker", "svc_port",                   commonWorkerSvcPort)  or
         ::tryParameter(row, "worker", "fs_port",                    commonWorkerFsPort) or
         ::tryParameter(row, "worker", "data_dir",                   commonWorkerDataDir);
@@ -364,6 +388,8 @@ void ConfigurationMySQL::loadConfiguration() {
     _databasePassword   = _connectionParams.password;
     _databaseName       = _connectionParams.database;
 
+    incrementVersion();
+
     dumpIntoLogger();
 }
 
@@ -98,6 +98,19 @@ public:
     WorkerInfo const setWorkerFsPort(std::string const& name,
                                      uint16_t port) final;
 
+    /**
+     * Explicitly invalidate the transient state by re-reading the configuration
+     * from the database. The version number of the transient state will be
+     * advanced so that clients maintaining derived caches would notice
+     * the change.
+     *
+     * The method will throw one of these exceptions:
+     *
+     *   std::runtime_error
+     *      the configuration is not consistent with expectations of the application
+     */
+    void reload();
+
 private:
 
     /**
@@ -107,8 +120,10 @@ private:
      *
      *   std::runtime_error
      *      the configuration is not consistent with expectations of the application
+     *
+     * @param lock - lock on a mutex must be acquired before calling this method
      */
-    void loadConfiguration();
+    void loadConfiguration(util::Lock const& lock);
 
 private:
 
@@ -97,6 +97,8 @@ WorkerInfo const ConfigurationStore::disableWorker(std::string const& name) {
     }
     itr->second.isEnabled = false;
 
+    incrementVersion();
+
     return itr->second;
 }
 
@@ -111,6 +113,8 @@ void ConfigurationStore::deleteWorker(std::string const& name) {
         throw std::invalid_argument("ConfigurationStore::deleteWorker  no such worker: " + name);
     }
     _workerInfo.erase(itr);
+
+    incrementVersion();
 }
 
 WorkerInfo const ConfigurationStore::setWorkerSvcPort(std::string const& name,
@@ -126,6 +130,8 @@ WorkerInfo const ConfigurationStore::setWorkerSvcPort(std::string const& name,
     }
     itr->second.svcPort = port;
 
+    incrementVersion();
+
     return itr->second;
 }
 
@@ -142,6 +148,8 @@ WorkerInfo const ConfigurationStore::setWorkerFsPort(std::string const& name,
     }
     itr->second.fsPort = port;
 
+    incrementVersion();
+
     return itr->second;}
 
 void ConfigurationStore::loadConfiguration(util::ConfigStore const& configStore) {
@@ -181,6 +189,8 @@ void ConfigurationStore::loadConfiguration(util::ConfigStore const& configStore)
     ::parseKeyVal(configStore, "common.database_password",   _databasePassword,   defaultDatabasePassword);
     ::parseKeyVal(configStore, "common.database_name",       _databaseName,       defaultDatabaseName);
 
+    ::parseKeyVal(configStore, "common.database_save_batch_size", _databaseSaveBatchSize, defaultDatabaseSaveBatchSize);
+
     ::parseKeyVal(configStore, "controller.num_threads",         _controllerThreads,           defaultControllerThreads);
     ::parseKeyVal(configStore, "controller.http_server_port",    _controllerHttpPort,          defaultControllerHttpPort);
     ::parseKeyVal(configStore, "controller.http_server_threads", _controllerHttpThreads,       defaultControllerHttpThreads);
@@ -197,6 +207,8 @@ void ConfigurationStore::loadConfiguration(util::ConfigStore const& configStore)
     ::parseKeyVal(configStore, "worker.num_svc_processing_threads", _workerNumProcessingThreads,   defaultWorkerNumProcessingThreads);
     ::parseKeyVal(configStore, "worker.num_fs_processing_threads",  _fsNumProcessingThreads,       defaultFsNumProcessingThreads);
     ::parseKeyVal(configStore, "worker.fs_buf_size_bytes",          _workerFsBufferSizeBytes,      defaultWorkerFsBufferSizeBytes);
+    ::parseKeyVal(configStore, "worker.disk_rate_limit_bytes_sec",  _workerDiskRateLimitBytesSec,  defaultWorkerDiskRateLimitBytesSec);
+    ::parseKeyVal(configStore, "worker.net_rate_limit_bytes_sec",   _workerNetRateLimitBytesSec,   defaultWorkerNetRateLimitBytesSec);
 
 
     // Optional common parameters for workers
@@ -0,0 +1,91 @@
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "replica/ControllerShard.h"
+
+// System headers
+#include <ostream>
+#include <stdexcept>
+
+namespace {
+
+/**
+ * The 64-bit FNV-1a hash of a string. The ownership of a database family must
+ * be computed identically by every controller instance of any build on any
+ * host, so a fixed algorithm is used here instead of std::hash whose values
+ * are implementation specific.
+ */
+uint64_t fnv1a(std::string const& str) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (char const c: str) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+} /// namespace
+
+namespace lsst {
+namespace qserv {
+namespace replica {
+
+ControllerShard::ControllerShard(unsigned int numShards,
+                                 unsigned int shard)
+    :   _numShards(numShards),
+        _shard(shard) {
+
+    if (0 == numShards) {
+        throw std::invalid_argument(
+                "ControllerShard  the total number of shards can't be 0");
+    }
+    if (shard >= numShards) {
+        throw std::invalid_argument(
+                "ControllerShard  the shard number " + std::to_string(shard) +
+                " is not less than the total number of shards " + std::to_string(numShards));
+    }
+}
+
+bool ControllerShard::isResponsibleFor(std::string const& databaseFamily) const {
+    if (single()) return true;
+    return ::fnv1a(databaseFamily) % _numShards == _shard;
+}
+
+std::vector<std::string> ControllerShard::responsibleFor(
+        std::vector<std::string> const& databaseFamilies) const {
+
+    std::vector<std::string> result;
+    for (auto&& family: databaseFamilies) {
+        if (isResponsibleFor(family)) {
+            result.push_back(family);
+        }
+    }
+    return result;
+}
+
+std::ostream& operator<<(std::ostream& os, ControllerShard const& shard) {
+    os << "ControllerShard(" << shard.shard() << " of " << shard.numShards() << ")";
+    return os;
+}
+
+}}} // namespace lsst::qserv::replica
@@ -0,0 +1,132 @@
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_REPLICA_CONTROLLERSHARD_H
+#define LSST_QSERV_REPLICA_CONTROLLERSHARD_H
+
+/// ControllerShard.h declares:
+///
+/// class ControllerShard
+///
+/// (see individual class documentation for more information)
+
+// System headers
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <vector>
+
+// This header declarations
+
+namespace lsst {
+namespace qserv {
+namespace replica {
+
+/**
+ * Class ControllerShard describes which slice of the cluster a controller
+ * instance is responsible for when more than one controller is deployed.
+ * The partitioning unit is the database family: every family is owned by
+ * exactly one shard, computed as a stable hash of the family name modulo
+ * the total number of shards. Each controller instance is configured with
+ * the same total and its own index, so the instances agree on the ownership
+ * map without talking to each other, and families are reassigned only when
+ * the total changes.
+ *
+ * The default constructed object represents the traditional single-controller
+ * setup which owns all families.
+ */
+class ControllerShard {
+
+public:
+
+    /**
+     * The normal constructor
+     *
+     * The method will throw std::invalid_argument if the total number of
+     * shards is 0 or if the shard number is not less than the total.
+     *
+     * @param numShards - the total number of controller shards in the setup
+     * @param shard     - the number of this shard, from 0 to numShards-1
+     */
+    ControllerShard(unsigned int numShards,
+                    unsigned int shard);
+
+    /// The default constructor produces a single-controller setup owning
+    /// all database families
+    ControllerShard()
+        :   _numShards(1),
+            _shard(0) {
+    }
+
+    ControllerShard(ControllerShard const&) = default;
+    ControllerShard& operator=(ControllerShard const&) = default;
+
+    ~ControllerShard() = default;
+
+    /// @return the total number of controller shards in the setup
+    unsigned int numShards() const { return _numShards; }
+
+    /// @return the number of this shard
+    unsigned int shard() const { return _shard; }
+
+    /// @return 'true' if this is the traditional single-controller setup
+    bool single() const { return 1 == _numShards; }
+
+    /// @return 'true' if this shard is also responsible for the cluster-wide
+    /// operations which are not scoped to any database family (such as
+    /// the replica verification scan). Exactly one shard in any setup will
+    /// report 'true'.
+    bool ownsClusterWideJobs() const { return 0 == _shard; }
+
+    /**
+     * Check if a database family belongs to this shard
+     *
+     * @param databaseFamily - the name of a database family
+     *
+     * @return 'true' if this shard is responsible for the family
+     */
+    bool isResponsibleFor(std::string const& databaseFamily) const;
+
+    /**
+     * Filter a collection of database families down to the ones owned
+     * by this shard
+     *
+     * @param databaseFamilies - the names of database families to be filtered
+     *
+     * @return the names of the families owned by this shard, in the input order
+     */
+    std::vector<std::string> responsibleFor(std::vector<std::string> const& databaseFamilies) const;
+
+private:
+
+    /// The total number of controller shards in the setup
+    unsigned int _numShards;
+
+    /// The number of this shard
+    unsigned int _shard;
+};
+
+/// The overloaded streaming operator for shard descriptors
+std::ostream& operator<<(std::ostream& os, ControllerShard const& shard);
+
+}}} // namespace lsst::qserv::replica
+
+#endif // LSST_QSERV_REPLICA_CONTROLLERSHARD_H
@@ -218,9 +218,10 @@ void DatabaseServicesMySQL::saveState(QservMgtRequest const& request,
 
     util::Lock lock(_mtx, context);
 
-    // The algorithm will first try the INSERT query into the base table.
-    // If a row with the same primary key (QservMgtRequest id) already exists in the table
-    // then the UPDATE query will be executed.
+    // The request is saved with a single-statement upsert which will insert
+    // a new row into the base table, or (if a row with the same primary key
+    // (QservMgtRequest id) already exists in the table) update the state of
+    // the existing row.
 
     // Requests which haven't started yet or the ones which aren't associated
     // with any job should be ignored.
@@ -236,26 +237,39 @@ void DatabaseServicesMySQL::saveState(QservMgtRequest const& request,
 
     try {
         _conn->begin();
-        _conn->executeInsertQuery(
-            "request",
-            request.id(),
-            request.jobId(),
-            request.type(),
-            request.worker(),
-            0,
-            QservMgtRequest::state2string(request.state()),
-            QservMgtRequest::state2string(request.extendedState()),
-            serverError,
-            performance.c_create_time,
-            performance.c_start_time,
-            performance.w_receive_time,
-            performance.w_start_time,
-            performance.w_finish_time,
-            performance.c_finish_time);
+        _conn->execute(
+            _conn->sqlInsertQuery(
+                "request",
+                request.id(),
+                request.jobId(),
+                request.type(),
+                request.worker(),
+                0,
+                QservMgtRequest::state2string(request.state()),
+                QservMgtRequest::state2string(request.extendedState()),
+                serverError,
+                performance.c_create_time,
+                performance.c_start_time,
+                performance.w_receive_time,
+                performance.w_start_time,
+                performance.w_finish_time,
+                performance.c_finish_time) +
+            " ON DUPLICATE KEY UPDATE " + _conn->sqlPackPairs(
+                std::make_pair( "state",          QservMgtRequest::state2string(request.state())),
+                std::make_pair( "ext_state",      QservMgtRequest::state2string(request.extendedState())),
+                std::make_pair( "server_status",                                serverError),
+                std::make_pair( "c_create_time",  performance.c_create_time),
+                std::make_pair( "c_start_time",   performance.c_start_time),
+                std::make_pair( "w_receive_time", performance.w_receive_time),
+                std::make_pair( "w_start_time",   performance.w_start_time),
+                std::make_pair( "w_finish_time",  performance.w_finish_time),
+                std::make_pair( "c_finish_time",  performance.c_finish_time)));
 
         // Extended state (if any provided by a specific request class) is recorded
         // in a request-specific table whose name is based on a value of the request's
-        // 'type' parameter.
+        // 'type' parameter. The extended state never changes during the lifetime of
+        // a request, hence the 'IGNORE' qualifier which suppresses the duplicate key
+        // error on the repeated saves.
 
         std::string extendedTableName = "request_" + request.type();
         std::transform(extendedTableName.begin(),
@@ -268,35 +282,14 @@ void DatabaseServicesMySQL::saveState(QservMgtRequest const& request,
         std::string const extendedPersistentState = request.extendedPersistentState(_conn);
         if (not extendedPersistentState.empty()) {
             LOGS(_log, LOG_LVL_DEBUG, context << "extendedPersistentState: " << extendedPersistentState);
-            _conn->execute("INSERT INTO " + _conn->sqlId(extendedTableName) +
+            _conn->execute("INSERT IGNORE INTO " + _conn->sqlId(extendedTableName) +
                            " VALUES " + extendedPersistentState);
         }
         _conn->commit ();
 
-    } catch (database::mysql::DuplicateKeyError const&) {
-
-        try {
-            _conn->rollback();
-            _conn->begin();
-            _conn->executeSimpleUpdateQuery(
-                "request",
-                _conn->sqlEqual("id",                                           request.id()),
-                std::make_pair( "state",          QservMgtRequest::state2string(request.state())),
-                std::make_pair( "ext_state",      QservMgtRequest::state2string(request.extendedState())),
-                std::make_pair( "server_status",                                serverError),
-                std::make_pair( "c_create_time",  performance.c_create_time),
-                std::make_pair( "c_start_time",   performance.c_start_time),
-                std::make_pair( "w_receive_time", performance.w_receive_time),
-                std::make_pair( "w_start_time",   performance.w_start_time),
-                std::make_pair( "w_finish_time",  performance.w_finish_time),
-                std::make_pair( "c_finish_time",  performance.c_finish_time));
-
-            _conn->commit();
-
-        } catch (database::mysql::Error const& ex) {
-            if (_conn->inTransaction()) _conn->rollback();
-            throw std::runtime_error(context + "failed to save the state, exception: " + ex.what());
-        }
+    } catch (database::mysql::Error const& ex) {
+        if (_conn->inTransaction()) _conn->rollback();
+        throw std::runtime_error(context + "failed to save the state, exception: " + ex.what());
     }
 
     LOGS(_log, LOG_LVL_DEBUG, context + "** DONE **");
@@ -311,9 +304,10 @@ void DatabaseServicesMySQL::saveState(Request const& request,
 
     util::Lock lock(_mtx, context);
 
-    // The algorithm will first try the INSERT query into the base table.
-    // If a row with the same primary key (QservMgtRequest id) already exists in the table
-    // then the UPDATE query will be executed.
+    // The request is saved with a single-statement upsert which will insert
+    // a new row into the base table, or (if a row with the same primary key
+    // (Request id) already exists in the table) update the state of
+    // the existing row.
 
     // Requests which haven't started yet or the ones which aren't associated
     // with any job should be ignored.
@@ -329,26 +323,39 @@ void DatabaseServicesMySQL::saveState(Request const& request,
 
     try {
         _conn->begin();
-        _conn->executeInsertQuery(
-            "request",
-            request.id(),
-            request.jobId(),
-            request.type(),
-            request.worker(),
-            request.priority(),
-            Request::state2string(request.state()),
-            Request::state2string(request.extendedState()),
-            status2string(request.extendedServerStatus()),
-            performance.c_create_time,
-            performance.c_start_time,
-            performance.w_receive_time,
-            performance.w_start_time,
-            performance.w_finish_time,
-            performance.c_finish_time);
+        _conn->execute(
+            _conn->sqlInsertQuery(
+                "request",
+                request.id(),
+                request.jobId(),
+                request.type(),
+                request.worker(),
+                request.priority(),
+                Request::state2string(request.state()),
+                Request::state2string(request.extendedState()),
+                status2string(request.extendedServerStatus()),
+                performance.c_create_time,
+                performance.c_start_time,
+                performance.w_receive_time,
+                performance.w_start_time,
+                performance.w_finish_time,
+                performance.c_finish_time) +
+            " ON DUPLICATE KEY UPDATE " + _conn->sqlPackPairs(
+                std::make_pair( "state",          Request::state2string(request.state())),
+                std::make_pair( "ext_state",      Request::state2string(request.extendedState())),
+                std::make_pair( "server_status",          status2string(request.extendedServerStatus())),
+                std::make_pair( "c_create_time",  performance.c_create_time),
+                std::make_pair( "c_start_time",   performance.c_start_time),
+                std::make_pair( "w_receive_time", performance.w_receive_time),
+                std::make_pair( "w_start_time",   performance.w_start_time),
+                std::make_pair( "w_finish_time",  performance.w_finish_time),
+                std::make_pair( "c_finish_time",  performance.c_finish_time)));
 
         // Extended state (if any provided by a specific request class) is recorded
         // in a request-specific table whose name is based on a value of the request's
-        // 'type' parameter.
+        // 'type' parameter. The extended state never changes during the lifetime of
+        // a request, hence the 'IGNORE' qualifier which suppresses the duplicate key
+        // error on the repeated saves.
 
         std::string extendedTableName = "request_" + request.type();
         std::transform(extendedTableName.begin(),
@@ -361,35 +368,14 @@ void DatabaseServicesMySQL::saveState(Request const& request,
         std::string const extendedPersistentState = request.extendedPersistentState(_conn);
         if (not extendedPersistentState.empty()) {
             LOGS(_log, LOG_LVL_DEBUG, context << "extendedPersistentState: " << extendedPersistentState);
-            _conn->execute("INSERT INTO " + _conn->sqlId(extendedTableName) +
+            _conn->execute("INSERT IGNORE INTO " + _conn->sqlId(extendedTableName) +
                            " VALUES " + extendedPersistentState);
         }
         _conn->commit ();
 
-    } catch (database::mysql::DuplicateKeyError const&) {
-
-        try {
-            _conn->rollback();
-            _conn->begin();
-            _conn->executeSimpleUpdateQuery(
-                "request",
-                _conn->sqlEqual("id",                                   request.id()),
-                std::make_pair( "state",          Request::state2string(request.state())),
-                std::make_pair( "ext_state",      Request::state2string(request.extendedState())),
-                std::make_pair( "server_status",          status2string(request.extendedServerStatus())),
-                std::make_pair( "c_create_time",  performance.c_create_time),
-                std::make_pair( "c_start_time",   performance.c_start_time),
-                std::make_pair( "w_receive_time", performance.w_receive_time),
-                std::make_pair( "w_start_time",   performance.w_start_time),
-                std::make_pair( "w_finish_time",  performance.w_finish_time),
-                std::make_pair( "c_finish_time",  performance.c_finish_time));
-
-            _conn->commit();
-
-        } catch (database::mysql::Error const& ex) {
-            if (_conn->inTransaction()) _conn->rollback();
-            throw std::runtime_error(context + "failed to save the state, exception: " + ex.what());
-        }
+    } catch (database::mysql::Error const& ex) {
+        if (_conn->inTransaction()) _conn->rollback();
+        throw std::runtime_error(context + "failed to save the state, exception: " + ex.what());
     }
     LOGS(_log, LOG_LVL_DEBUG, context + "** DONE **");
 }
@@ -457,6 +443,12 @@ void DatabaseServicesMySQL::saveReplicaInfo(ReplicaInfo const& info) {
         if (_conn->inTransaction()) _conn->rollback();
         throw std::runtime_error(context + "failed to save the state, exception: " + ex.what());
     }
+
+    // Propagate the change into the in-memory view of the replica disposition
+    // (where applies)
+
+    updateReplicaInfoView(lock, info);
+
     LOGS(_log, LOG_LVL_DEBUG, context + "** DONE **");
 }
 
@@ -468,18 +460,40 @@ void DatabaseServicesMySQL::saveReplicaInfoCollection(std::string const& worker,
 
     util::Lock lock(_mtx, context);
 
+    // Transactions are managed by the implementation method which pipelines
+    // the input collection through a series of batches, with one transaction
+    // per batch.
+
     try {
-        _conn->begin();
         saveReplicaInfoCollectionImpl(
             lock,
             worker,
             database,
             infoCollection);
-        _conn->commit();
     } catch (database::mysql::Error const& ex) {
         if (_conn->inTransaction()) _conn->rollback();
         throw std::runtime_error(context + "failed to save the state, exception: " + ex.what());
     }
+
+    // Rebuild the in-memory view of the (worker,database) context from
+    // the complete disposition just reported. Replicas of other contexts
+    // (if any were present in the input collection) are propagated into
+    // the view individually.
+
+    auto& contextView = _replicaInfoView[worker][database];
+    contextView.clear();
+
+    for (auto&& info: infoCollection) {
+        if ((info.worker() == worker) and (info.database() == database)) {
+            if (info.status() == ReplicaInfo::Status::COMPLETE) {
+                contextView[info.chunk()] = info;
+            }
+        } else {
+            updateReplicaInfoView(lock, info);
+        }
+    }
+    _viewedContexts.insert(std::make_pair(worker, database));
+
     LOGS(_log, LOG_LVL_DEBUG, context + "** DONE **");
 }
 
@@ -587,6 +601,8 @@ void DatabaseServicesMySQL::saveReplicaInfoCollectionImpl(util::Lock const& lock
     // in the requested ('worker' and 'database' parameters of the method)
     // context only.
 
+    _conn->begin();
+
     if (newReplicas.count( worker) and
         newReplicas.at(    worker).count(database) and
         not newReplicas.at(worker).at(   database).empty()) {
@@ -617,15 +633,169 @@ void DatabaseServicesMySQL::saveReplicaInfoCollectionImpl(util::Lock const& lock
             "  WHERE " +     _conn->sqlEqual("worker",   worker) +
             "    AND " +     _conn->sqlEqual("database", database));
     }
+    _conn->commit();
+
+    // Finally push new (or update existing) replicas info into the database.
+    // Complete replicas (the vast majority in the normal scenario) are packed
+    // into batches which get saved via multi-row statements, with one transaction
+    // per batch. The rest is saved one at a time.
+
+    size_t const batchSize = std::max(size_t(1), _configuration->databaseSaveBatchSize());
+
+    std::vector<ReplicaInfo> batch;
+    batch.reserve(batchSize);
 
-    // Finally push new (or update existing) replicas info into the database
-    // (some of those replicas will be brand new, others - will need to be updated)
     for (auto&& info: infoCollection) {
-        saveReplicaInfoImpl(lock, info);
+        if (info.status() == ReplicaInfo::Status::COMPLETE) {
+            batch.push_back(info);
+            if (batch.size() >= batchSize) {
+                saveReplicaInfoBatchImpl(lock, batch);
+                batch.clear();
+            }
+        } else {
+            _conn->begin();
+            saveReplicaInfoImpl(lock, info);
+            _conn->commit();
+        }
+    }
+    if (not batch.empty()) {
+        saveReplicaInfoBatchImpl(lock, batch);
+    }
+    LOGS(_log, LOG_LVL_DEBUG, context << "** DONE **");
+}
+
+void DatabaseServicesMySQL::saveReplicaInfoBatchImpl(util::Lock const& lock,
+                                                     std::vector<ReplicaInfo> const& replicas) {
+
+    std::string const context = "DatabaseServicesMySQL::saveReplicaInfoBatchImpl  ";
+
+    LOGS(_log, LOG_LVL_DEBUG, context << "replicas.size(): " << replicas.size());
+
+    if (replicas.empty()) return;
+
+    // Group chunks by their (worker,database) contexts to allow the bulk
+    // eviction and the replica identifier lookup below.
+
+    std::map<std::string,                       // worker
+             std::map<std::string,              // database
+                      std::vector<unsigned int>>> context2chunks;
+
+    for (auto&& info: replicas) {
+        context2chunks[info.worker()][info.database()].push_back(info.chunk());
+    }
+
+    _conn->begin();
+
+    // Evict prior states of the replicas (if any existed). Together with
+    // the multi-row INSERT below this is an equivalent of the multi-row
+    // upsert given the auto-incremented PK of the table and the cascade
+    // deletion of the file entries.
+
+    for (auto&& workerEntry: context2chunks) {
+        std::string const& worker = workerEntry.first;
+        for (auto&& databaseEntry: workerEntry.second) {
+            std::string const& database = databaseEntry.first;
+            _conn->execute(
+                "DELETE FROM " + _conn->sqlId(   "replica") +
+                "  WHERE " +     _conn->sqlEqual("worker",   worker) +
+                "    AND " +     _conn->sqlEqual("database", database) +
+                "    AND " +     _conn->sqlIn(   "chunk",    databaseEntry.second));
+        }
     }
+
+    // Insert all replicas of the batch in a single multi-row statement
+
+    std::string rows;
+    for (auto&& info: replicas) {
+        rows += (rows.empty() ? "" : ",") + _conn->sqlPackValues(
+            database::mysql::Keyword::SQL_NULL,     /* the auto-incremented PK */
+            info.worker(),
+            info.database(),
+            info.chunk(),
+            info.verifyTime());
+    }
+    _conn->execute(
+        "INSERT INTO " + _conn->sqlId("replica") + " VALUES " + rows);
+
+    // Fetch the auto-generated identifiers of the inserted rows in order
+    // to link the file entries with their replicas.
+
+    std::map<std::string,                       // worker
+             std::map<std::string,              // database
+                      std::map<unsigned int,    // chunk
+                               uint64_t>>> id;
+
+    for (auto&& workerEntry: context2chunks) {
+        std::string const& worker = workerEntry.first;
+        for (auto&& databaseEntry: workerEntry.second) {
+            std::string const& database = databaseEntry.first;
+            _conn->execute(
+                "SELECT " +  _conn->sqlId(   "id") + "," + _conn->sqlId("chunk") +
+                "  FROM " +  _conn->sqlId(   "replica") +
+                "  WHERE " + _conn->sqlEqual("worker",   worker) +
+                "    AND " + _conn->sqlEqual("database", database) +
+                "    AND " + _conn->sqlIn(   "chunk",    databaseEntry.second));
+
+            if (_conn->hasResult()) {
+                database::mysql::Row row;
+                while (_conn->next(row)) {
+
+                    uint64_t     replicaId;
+                    unsigned int chunk;
+
+                    row.get("id",    replicaId);
+                    row.get("chunk", chunk);
+
+                    id[worker][database][chunk] = replicaId;
+                }
+            }
+        }
+    }
+
+    // Insert the file entries of all replicas of the batch in a single
+    // multi-row statement.
+    //
+    // NOTES: in theory method 'at' may throw exceptions. Though, this shouldn't
+    //        be happening in this context because the replicas in question
+    //        have just been inserted above within the same transaction.
+
+    rows.clear();
+    for (auto&& info: replicas) {
+        uint64_t const replicaId = id.at(info.worker()).at(info.database()).at(info.chunk());
+        for (auto&& f: info.fileInfo()) {
+            rows += (rows.empty() ? "" : ",") + _conn->sqlPackValues(
+                replicaId,                      /* FK -> PK of the replica */
+                f.name,
+                f.size,
+                f.mtime,
+                f.cs,
+                f.beginTransferTime,
+                f.endTransferTime);
+        }
+    }
+    if (not rows.empty()) {
+        _conn->execute(
+            "INSERT INTO " + _conn->sqlId("replica_file") + " VALUES " + rows);
+    }
+    _conn->commit();
+
     LOGS(_log, LOG_LVL_DEBUG, context << "** DONE **");
 }
 
+void DatabaseServicesMySQL::updateReplicaInfoView(util::Lock const& lock,
+                                                  ReplicaInfo const& info) {
+
+    if (not _viewedContexts.count(std::make_pair(info.worker(), info.database()))) return;
+
+    auto& contextView = _replicaInfoView[info.worker()][info.database()];
+
+    if (info.status() == ReplicaInfo::Status::COMPLETE) {
+        contextView[info.chunk()] = info;
+    } else {
+        contextView.erase(info.chunk());
+    }
+}
+
 bool DatabaseServicesMySQL::findOldestReplicas(std::vector<ReplicaInfo>& replicas,
                                                size_t maxReplicas,
                                                bool enabledWorkersOnly) const {
@@ -716,6 +886,21 @@ bool DatabaseServicesMySQL::findWorkerReplicasImpl(util::Lock const& lock,
             throw std::invalid_argument(context + "unknow database");
         }
     }
+
+    // Serve the request from the in-memory view if the context is covered.
+    // This avoids a round trip to the database for the most frequent query
+    // issued by the replication jobs.
+
+    if (not database.empty() and
+        _viewedContexts.count(std::make_pair(worker, database))) {
+
+        replicas.clear();
+        for (auto&& entry: _replicaInfoView.at(worker).at(database)) {
+            replicas.push_back(entry.second);
+        }
+        LOGS(_log, LOG_LVL_DEBUG, context << "(view) replicas.size(): " << replicas.size());
+        return true;
+    }
     if (not findReplicasImpl(
                 lock,
                 replicas,
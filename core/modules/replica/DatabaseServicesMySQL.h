@@ -28,6 +28,10 @@
 /// (see individual class documentation for more information)
 
 // System headers
+#include <map>
+#include <set>
+#include <string>
+#include <utility>
 #include <vector>
 
 // Qserv headers
@@ -191,6 +195,30 @@ private:
                                        std::string const& database,
                                        ReplicaInfoCollection const& infoCollection);
 
+    /**
+     * Save a batch of complete replicas using multi-row statements.
+     *
+     * All replicas of the batch are persisted within a single transaction
+     * which is open and committed by the method. Each replica of the batch
+     * is required to have status ReplicaInfo::Status::COMPLETE.
+     *
+     * @param lock     - lock on a mutex must be acquired before calling this method
+     * @param replicas - batch of replicas to be saved
+     */
+    void saveReplicaInfoBatchImpl(util::Lock const& lock,
+                                  std::vector<ReplicaInfo> const& replicas);
+
+    /**
+     * Update the in-memory view of the replica disposition with the new
+     * state of a replica. The update applies only if the (worker,database)
+     * context of the replica is covered by the view.
+     *
+     * @param lock - lock on a mutex must be acquired before calling this method
+     * @param info - replica which was added/updated or deleted
+     */
+    void updateReplicaInfoView(util::Lock const& lock,
+                               ReplicaInfo const& info);
+
     /**
      * Fetch replicas satisfying the specified query
      *
@@ -215,6 +243,23 @@ private:
     /// Database connection (second instance for nested queries)
     database::mysql::Connection::Ptr _conn2;
 
+    /// The in-memory view of the replica disposition incrementally maintained
+    /// from the replica states saved by the service. The view covers
+    /// the (worker,database) contexts for which the complete disposition has
+    /// been reported via method saveReplicaInfoCollection(). Per-worker lookups
+    /// within the covered contexts are served from the view w/o querying
+    /// the database.
+    ///
+    /// NOTE: the view assumes the current process is the only writer into
+    /// the replica table (which is the case for the Master Controller).
+    std::map<std::string,                       // worker
+             std::map<std::string,              // database
+                      std::map<unsigned int,    // chunk
+                               ReplicaInfo>>> _replicaInfoView;
+
+    /// The (worker,database) contexts covered by the view
+    std::set<std::pair<std::string, std::string>> _viewedContexts;
+
     /// The mutex for enforcing thread safety of the class's public API
     /// and internal operations.
     mutable util::Mutex _mtx;
@@ -23,6 +23,9 @@
 // Class header
 #include "replica/FileClient.h"
 
+// System headers
+#include <algorithm>
+
 // Third party headers
 #include <boost/bind.hpp>
 
@@ -49,14 +52,20 @@ FileClient::Ptr FileClient::instance(ServiceProvider::Ptr const& serviceProvider
                                      std::string const& workerName,
                                      std::string const& databaseName,
                                      std::string const& fileName,
-                                     bool readContent) {
+                                     bool readContent,
+                                     bool keepOpen,
+                                     size_t digestBlockSize,
+                                     std::vector<uint64_t> const& blocks) {
     try {
         FileClient::Ptr ptr(
             new FileClient(serviceProvider,
                            workerName,
                            databaseName,
                            fileName,
-                           readContent));
+                           readContent,
+                           keepOpen,
+                           digestBlockSize,
+                           blocks));
 
         if (ptr->openImpl()) return ptr;
 
@@ -74,15 +83,22 @@ FileClient::FileClient(ServiceProvider::Ptr const& serviceProvider,
                        std::string const& workerName,
                        std::string const& databaseName,
                        std::string const& fileName,
-                       bool readContent)
+                       bool readContent,
+                       bool keepOpen,
+                       size_t digestBlockSize,
+                       std::vector<uint64_t> const& blocks)
     :   _workerInfo(serviceProvider->config()->workerInfo(workerName)),
         _databaseInfo(serviceProvider->config()->databaseInfo(databaseName)),
         _fileName(fileName),
         _readContent(readContent),
+        _keepOpen(keepOpen),
+        _digestBlockSize(digestBlockSize),
+        _blocks(blocks),
         _bufferPtr(new ProtocolBuffer(serviceProvider->config()->requestBufferSizeBytes())),
         _io_service(),
         _socket(_io_service),
         _size(0),
+        _sizeBytesRemaining(0),
         _mtime(0),
         _eof(false) {
 }
@@ -136,8 +152,21 @@ bool FileClient::openImpl() {
         return false;
     }
 
+    // Send the file request to the server and wait for the reply
+
+    return requestFileImpl();
+}
+
+bool FileClient::requestFileImpl() {
+
+    static std::string const context = "FileClient::requestFileImpl  ";
+
+    LOGS(_log, LOG_LVL_DEBUG, context);
+
+    boost::system::error_code ec;
+
     // Send the file request to the server and wait for the reply.
-    // This step is also implemented through a series of synchronous operations.
+    // This step is implemented through a series of synchronous operations.
     //
     // NOTE: this sequence of steps is happening inside the exception
     //       trap block to catch exceptions thrown by the Google protobuf
@@ -155,6 +184,11 @@ bool FileClient::openImpl() {
         request.set_database(database());
         request.set_file(file());
         request.set_send_content(_readContent);
+        request.set_keep_open(_keepOpen);
+        request.set_digest_block_size(_digestBlockSize);
+        for (auto&& block: _blocks) {
+            request.add_block(block);
+        }
 
         _bufferPtr->serialize(request);
 
@@ -233,8 +267,13 @@ bool FileClient::openImpl() {
         _bufferPtr->parse(response, responseLengthBytes);
 
         if (response.available()) {
-            _size  = response.size();
-            _mtime = response.mtime();
+            _size               = response.size();
+            _sizeBytesRemaining = response.size();
+            _mtime              = response.mtime();
+            _eof                = false;
+
+            _blockDigests.assign(response.block_cs().begin(),
+                                 response.block_cs().end());
             return true;
         }
 
@@ -249,6 +288,32 @@ bool FileClient::openImpl() {
 }
 
 
+bool FileClient::openNext(std::string const& fileName) {
+
+    static std::string const context = "FileClient::openNext  ";
+
+    LOGS(_log, LOG_LVL_DEBUG, context << "file: " << fileName);
+
+    if (not (_readContent and _keepOpen)) {
+        throw FileClientError(
+            context + "the session mode was not requested when opening the connection, server: "
+            + _workerInfo.svcHost + ":" + std::to_string(_workerInfo.fsPort) +
+            ", database: " + database() +
+            ", file: " + fileName);
+    }
+    if (_sizeBytesRemaining != 0) {
+        throw FileClientError(
+            context + "the content of the previous file was not fully read, server: "
+            + _workerInfo.svcHost + ":" + std::to_string(_workerInfo.fsPort) +
+            ", database: " + database() +
+            ", previous file: " + file() +
+            ", bytes remaining: " + std::to_string(_sizeBytesRemaining));
+    }
+    _fileName = fileName;
+
+    return requestFileImpl();
+}
+
 size_t FileClient::read(uint8_t* buf, size_t bufSize) {
 
     static std::string const context = "FileClient::read  ";
@@ -270,15 +335,29 @@ size_t FileClient::read(uint8_t* buf, size_t bufSize) {
     // If EOF was detected earlier
     if (_eof) return 0;
 
+    // In the session mode the server won't close the connection at the end
+    // of the file, so the end of the file is detected by counting the bytes
+    // consumed so far. Reading past the end of the file would otherwise eat
+    // into the response of the next file request.
+
+    size_t bytes2read = bufSize;
+    if (_keepOpen) {
+        if (not _sizeBytesRemaining) {
+            _eof = true;
+            return 0;
+        }
+        bytes2read = std::min(bufSize, _sizeBytesRemaining);
+    }
+
     // Read the specified number of bytes
     boost::system::error_code ec;
     const size_t num = boost::asio::read(
         _socket,
         boost::asio::buffer(
             buf,
-            bufSize
+            bytes2read
         ),
-        boost::asio::transfer_at_least(bufSize),
+        boost::asio::transfer_at_least(bytes2read),
         ec
     );
     if (ec.value() != 0) {
@@ -299,7 +378,12 @@ size_t FileClient::read(uint8_t* buf, size_t bufSize) {
                         ", error message: " + ec.message());
         }
     } else {
-        if (not num) _eof = true;
+        if (num) {
+            _sizeBytesRemaining -= std::min(num, _sizeBytesRemaining);
+            if (_keepOpen and (not _sizeBytesRemaining)) _eof = true;
+        } else {
+            _eof = true;
+        }
     }
     return num;
 }
@@ -33,6 +33,7 @@
 #include <memory>
 #include <stdexcept>
 #include <string>
+#include <vector>
 
 // Qserv headers
 #include "replica/Configuration.h"
@@ -88,21 +89,96 @@ public:
      * and the file content could be read via method FileClient::read().
      * Otherwise return the null pointer.
      *
+     * If flag 'keepOpen' is set then the server will be asked to keep
+     * the connection open after the file content is fully transferred
+     * (the session mode). This allows requesting further files over
+     * the same connection via method FileClient::openNext(), which avoids
+     * paying the connection setup cost for each file of a chunk.
+     *
      * @param serviceProvider - for configuration, etc. services
      * @param workerName      - the name of a worker where the file resides
      * @param databaseName    - the name of a atabase the file belongs to
      * @param fileName        - the file to read or examine
+     * @param keepOpen        - request the session mode (see above)
      */
     static Ptr open(ServiceProvider::Ptr const& serviceProvider,
                     std::string const& workerName,
                     std::string const& databaseName,
-                    std::string const& fileName) {
+                    std::string const& fileName,
+                    bool keepOpen=false) {
+
+        return instance(serviceProvider,
+                        workerName,
+                        databaseName,
+                        fileName,
+                        true /* readContent */,
+                        keepOpen,
+                        0 /* digestBlockSize */,
+                        std::vector<uint64_t>());
+    }
+
+    /**
+     * Open a file for examining the per-block control sums of its content.
+     *
+     * The returned object (if any) can't be used to read the file content.
+     * The digests are available via method FileClient::blockDigests().
+     * This is one half of the incremental (delta) replication protocol:
+     * comparing the digests against the ones of a local (stale) copy of
+     * the file tells which blocks to transfer via FileClient::openBlocks().
+     *
+     * @param serviceProvider - for configuration, etc. services
+     * @param workerName      - the name of a worker where the file resides
+     * @param databaseName    - the name of a atabase the file belongs to
+     * @param fileName        - the file to examine
+     * @param blockSizeBytes  - the size of the blocks over which the control
+     *                          sums will be computed
+     */
+    static Ptr digests(ServiceProvider::Ptr const& serviceProvider,
+                       std::string const& workerName,
+                       std::string const& databaseName,
+                       std::string const& fileName,
+                       size_t blockSizeBytes) {
+
+        return instance(serviceProvider,
+                        workerName,
+                        databaseName,
+                        fileName,
+                        false /* readContent */,
+                        false /* keepOpen */,
+                        blockSizeBytes,
+                        std::vector<uint64_t>());
+    }
+
+    /**
+     * Open a file for reading the content of the specified blocks only.
+     *
+     * The content of the requested blocks (zero-based indexes of blocks
+     * of size 'blockSizeBytes', in the increasing order) will be streamed
+     * back-to-back in the order the blocks were requested, and it should
+     * be consumed via method FileClient::read() until the end of stream.
+     *
+     * @param serviceProvider - for configuration, etc. services
+     * @param workerName      - the name of a worker where the file resides
+     * @param databaseName    - the name of a atabase the file belongs to
+     * @param fileName        - the file to read
+     * @param blockSizeBytes  - the size of a block
+     * @param blocks          - the blocks to be transferred
+     */
+    static Ptr openBlocks(ServiceProvider::Ptr const& serviceProvider,
+                          std::string const& workerName,
+                          std::string const& databaseName,
+                          std::string const& fileName,
+                          size_t blockSizeBytes,
+                          std::vector<uint64_t> const& blocks) {
 
         return instance(serviceProvider,
                         workerName,
                         databaseName,
                         fileName,
-                        true /* readContent */);
+                        true /* readContent */,
+                        false /* keepOpen */,
+                        blockSizeBytes,
+                        blocks);
     }
 
     /**
@@ -132,9 +208,30 @@ public:
                         workerName,
                         databaseName,
                         fileName,
-                        false /* readContent */);
+                        false /* readContent */,
+                        false /* keepOpen */,
+                        0 /* digestBlockSize */,
+                        std::vector<uint64_t>());
     }
 
+    /**
+     * Request the next file over the existing connection (the session mode).
+     *
+     * The method is only allowed for objects open via method FileClient::open()
+     * with flag 'keepOpen' set, and only after the content of the previous file
+     * was fully consumed via method FileClient::read(). If the operation is
+     * successful then the object's size, mtime and read state will be reset
+     * for the new file and the method will return 'true'. Otherwise the method
+     * will return 'false' and a caller should fall back to opening a new
+     * connection. Illegal use of the method (no session mode, or the previous
+     * file was not fully read) will be reported by throwing FileClientError.
+     *
+     * @param fileName - the next file to read (within the same database)
+     *
+     * @return 'true' if the file is available and its content will follow
+     */
+    bool openNext(std::string const& fileName);
+
     // Default construction and copy semantics are prohibited
 
     FileClient() = delete;
@@ -155,6 +252,10 @@ public:
     /// @return the last modification time (mtime) of the file
     std::time_t mtime() const { return _mtime; }
 
+    /// @return the per-block control sums of the file content (as reported
+    /// by a server if the file was open via method FileClient::digests())
+    std::vector<uint64_t> const& blockDigests() const { return _blockDigests; }
+
     /**
      * Read (up to, but not exceeding) the specified number of bytes into a buffer.
      *
@@ -182,12 +283,19 @@ private:
      * @param databaseName    - the name of a atabase the file belongs to
      * @param fileName        - the file to read or examine
      * @param readContent     - the mode in which the file will be used
+     * @param keepOpen        - request the session mode
+     * @param digestBlockSize - request per-block control sums computed over
+     *                          blocks of the specified size (0 - no digests)
+     * @param blocks          - the blocks to be transferred (empty - the whole file)
      */
     static Ptr instance(ServiceProvider::Ptr const& serviceProvider,
                         std::string const& workerName,
                         std::string const& databaseName,
                         std::string const& fileName,
-                        bool readContent);
+                        bool readContent,
+                        bool keepOpen,
+                        size_t digestBlockSize,
+                        std::vector<uint64_t> const& blocks);
 
     /**
      * Construct an object with the specified configuration.
@@ -200,12 +308,18 @@ private:
      * @param databaseName    - the name of a atabase the file belongs to
      * @param fileName        - the file to read or examine
      * @param readContent     - indicates if a file is open for reading its content
+     * @param keepOpen        - indicates if the session mode was requested
+     * @param digestBlockSize - the block size for the per-block control sums
+     * @param blocks          - the blocks to be transferred (empty - the whole file)
      */
     FileClient(ServiceProvider::Ptr const& serviceProvider,
                std::string const& workerName,
                std::string const& databaseName,
                std::string const& fileName,
-               bool readContent);
+               bool readContent,
+               bool keepOpen,
+               size_t digestBlockSize,
+               std::vector<uint64_t> const& blocks);
 
     /**
      * Try opening the file
@@ -214,6 +328,15 @@ private:
      */
     bool openImpl();
 
+    /**
+     * Send the file request over the (already established) connection and
+     * process the server's response. This is the part of the protocol shared
+     * between methods openImpl() and openNext().
+     *
+     * @return 'true' if the file is available
+     */
+    bool requestFileImpl();
+
 private:
 
     // Cached descriptors obtained from the configuration
@@ -229,6 +352,21 @@ private:
     // its content
     bool _readContent;
 
+    /// The flag indicating if the session mode was requested, in which
+    /// the server keeps the connection open after each file
+    bool _keepOpen;
+
+    /// The block size (bytes) for the per-block control sums, or 0 if
+    /// no digests were requested
+    size_t _digestBlockSize;
+
+    /// The blocks to be transferred, or empty for the whole file
+    std::vector<uint64_t> _blocks;
+
+    /// The per-block control sums of the file content (as reported by
+    /// a server if the digests were requested)
+    std::vector<uint64_t> _blockDigests;
+
     /// Buffer for data moved over the network
     std::unique_ptr<ProtocolBuffer> _bufferPtr;
 
@@ -240,6 +378,11 @@ private:
     /// The size of the file in bytes (to be determined after contacting a server)
     size_t _size;
 
+    /// The number of bytes of the current file not yet consumed by reads.
+    /// In the session mode the end of a file is detected by exhausting this
+    /// counter because the server won't close the connection.
+    size_t _sizeBytesRemaining;
+
     /// The last modification time (mtime) of the file
     std::time_t _mtime;
 
@@ -24,10 +24,13 @@
 #include "replica/FileServerConnection.h"
 
 // System headers
+#include <algorithm>
 #include <cerrno>
 #include <cstring>
 #include <ctime>
+#include <fcntl.h>
 #include <stdexcept>
+#include <utility>
 
 // Third party headers
 #include <boost/bind.hpp>
@@ -36,6 +39,7 @@
 // Qserv headers
 #include "lsst/log/Log.h"
 #include "replica/Configuration.h"
+#include "replica/FileUtils.h"
 #include "replica/ServiceProvider.h"
 
 namespace fs    = boost::filesystem;
@@ -133,9 +137,16 @@ FileServerConnection::FileServerConnection(ServiceProvider::Ptr const& servicePr
             std::make_shared<ProtocolBuffer>(
                 serviceProvider->config()->requestBufferSizeBytes())),
         _fileName(),
+        _keepOpen(false),
         _filePtr(0),
+        _blockSize(0),
+        _blockItr(0),
+        _blockBytesRemaining(0),
         _fileBufSize(serviceProvider->config()->workerFsBufferSizeBytes()),
-        _fileBuf(0) {
+        _fileBuf(0),
+        _nextBuf(0),
+        _nextBytes(0),
+        _nextReady(false) {
 
     if (not _fileBufSize or (_fileBufSize > maxFileBufSizeBytes)) {
         throw std::invalid_argument(
@@ -143,14 +154,16 @@ FileServerConnection::FileServerConnection(ServiceProvider::Ptr const& servicePr
                   std::to_string(maxFileBufSizeBytes) + " bytes. Check the configuration.");
     }
     _fileBuf = new uint8_t[_fileBufSize];
-    if (not _fileBuf) {
-        throw std::runtime_error("FileServerConnection: failed to allocate the buffer, size: " +
+    _nextBuf = new uint8_t[_fileBufSize];
+    if (not _fileBuf or not _nextBuf) {
+        throw std::runtime_error("FileServerConnection: failed to allocate the buffers, size: " +
                                  std::to_string(maxFileBufSizeBytes) + " bytes.");
     }
 }
 
 FileServerConnection::~FileServerConnection() {
     delete [] _fileBuf;
+    delete [] _nextBuf;
 }
 
 void FileServerConnection::beginProtocol() {
@@ -202,13 +215,19 @@ void FileServerConnection::requestReceived(boost::system::error_code const& ec,
     if (not ::readMessage(_socket, _bufferPtr, _bufferPtr->parseLength(), request)) return;
 
     LOGS(_log, LOG_LVL_INFO, context << "requestReceived  <OPEN> database: " << request.database()
-         << ", file: " << request.file());
+         << ", file: " << request.file()
+         << ", keep_open: " << (request.keep_open() ? "true" : "false"));
+
+    _keepOpen = request.keep_open();
 
     // Find a file requested by a client
 
     bool        available = false;
     uint64_t    size      = 0;
     std::time_t mtime     = 0;
+
+    std::vector<uint64_t> blockDigests;
+
     do {
         if (not _serviceProvider->config()->isKnownDatabase(request.database())) {
             LOGS(_log, LOG_LVL_ERROR, context << "requestReceived  unknown database: "
@@ -242,6 +261,38 @@ void FileServerConnection::requestReceived(boost::system::error_code const& ec,
             break;
         }
 
+        // If requested compute the block-level digests of the file
+
+        if (request.digest_block_size()) {
+            try {
+                blockDigests = FileUtils::cachedBlockDigests(file.string(),
+                                                             request.digest_block_size());
+            } catch (std::exception const& ex) {
+                LOGS(_log, LOG_LVL_ERROR, context
+                     << "requestReceived  failed to compute block digests of file: " << file
+                     << ", error: " << ex.what());
+                break;
+            }
+        }
+
+        // Set up the block mode transfer if specific blocks were requested
+
+        _blockSize = 0;
+        _blocks.clear();
+        _blockItr = 0;
+        _blockBytesRemaining = 0;
+
+        if (request.block_size() != 0) {
+            if (not request.digest_block_size()) {
+                LOGS(_log, LOG_LVL_ERROR, context
+                     << "requestReceived  blocks requested w/o a block size, file: " << file);
+                break;
+            }
+            _blockSize = request.digest_block_size();
+            _blocks.assign(request.block().begin(),
+                           request.block().end());
+        }
+
         // If requested open the file and leave its descriptor open
 
         _fileName = file.string();
@@ -253,6 +304,9 @@ void FileServerConnection::requestReceived(boost::system::error_code const& ec,
                      << ", file: " << file);
                 break;
             }
+            // Tell the kernel the file will be read sequentially so it uses
+            // aggressive readahead. This is only advice, errors are ignored.
+            ::posix_fadvise(fileno(_filePtr), 0, 0, POSIX_FADV_SEQUENTIAL);
         }
         available = true;
 
@@ -265,6 +319,13 @@ void FileServerConnection::requestReceived(boost::system::error_code const& ec,
     response.set_size(size);
     response.set_mtime(mtime);
 
+    if (available and request.digest_block_size()) {
+        response.set_digest_block_size(request.digest_block_size());
+        for (auto&& cs: blockDigests) {
+            response.add_block_cs(cs);
+        }
+    }
+
     _bufferPtr->resize();
     _bufferPtr->serialize(response);
 
@@ -302,9 +363,13 @@ void FileServerConnection::responseSent(boost::system::error_code const& ec,
     // - there was a problem with locating/accessing/opening the file, or
     // - a client indicated no interest in receiving the content of the file
     //
-    // In either case just finish the protocol right here.
+    // In either case finish with this file right here. In the session mode
+    // go back to waiting for the next file request over the same connection.
 
-    if (not _filePtr) return;
+    if (not _filePtr) {
+        if (_keepOpen) receiveRequest();
+        return;
+    }
 
     // The file is open. Begin streaming its content.
     sendData();
@@ -314,29 +379,63 @@ void FileServerConnection::sendData() {
 
     LOGS(_log, LOG_LVL_DEBUG, context << "sendData  file: " << _fileName);
 
+    // Prime the double buffered pipeline with the first record. After this
+    // point there is always one record in flight on the socket while
+    // the next one is being read from disk.
+
+    _nextReady = false;
+
+    size_t const bytes = readRecord(_fileBuf);
+    if (not bytes) {
+        closeFile();
+        return;
+    }
+    sendRecord(bytes);
+}
+
+size_t FileServerConnection::readRecord(uint8_t* buf) {
+
+    // In the block mode seek to the next requested block when the current
+    // one (if any) is exhausted, and never read past the end of a block.
+    // Running out of requested blocks ends the transfer the same way as
+    // reaching the end of the file does in the whole-file mode.
+
+    size_t bytes2read = _fileBufSize;
+    if (_blockSize != 0) {
+        if (not _blockBytesRemaining) {
+            if (_blockItr == _blocks.size()) return 0;
+            std::fseek(_filePtr,
+                       (long)(_blocks[_blockItr] * _blockSize),
+                       SEEK_SET);
+            _blockBytesRemaining = _blockSize;
+            ++_blockItr;
+        }
+        bytes2read = std::min(_fileBufSize, _blockBytesRemaining);
+    }
+
     // Read next record if possible (a failure or EOF)
 
     size_t const bytes =
-        std::fread(_fileBuf,
+        std::fread(buf,
                    sizeof(uint8_t),
-                   _fileBufSize,
+                   bytes2read,
                    _filePtr);
     if (not bytes) {
         if (std::ferror(_filePtr)) {
             LOGS(_log, LOG_LVL_ERROR, context
-                 << "sendData  file read error: " << std::strerror(errno)
+                 << "readRecord  file read error: " << std::strerror(errno)
                  << ", file: " << _fileName);
-        } else if (std::feof(_filePtr)) {
-            LOGS(_log, LOG_LVL_INFO, context << "sendData  <CLOSE> file: " << _fileName);
         } else {
-            ;   // This file was empty, or the previous read was aligned exactly on
-                // the end of the file.
+            ;   // The end of the file, the end of the requested blocks, or
+                // the previous read was aligned exactly on the end of the file.
         }
-        std::fclose(_filePtr);
-        return;
+        return 0;
     }
+    if (_blockSize != 0) _blockBytesRemaining -= bytes;
+    return bytes;
+}
 
-    // Send the record
+void FileServerConnection::sendRecord(size_t bytes) {
 
     boost::asio::async_write(
         _socket,
@@ -351,6 +450,26 @@ void FileServerConnection::sendData() {
             boost::asio::placeholders::bytes_transferred
         )
     );
+
+    // Read the next record while the one above is in flight. The kernel
+    // progresses the socket send on its own, so the disk read and
+    // the network transfer overlap.
+
+    _nextBytes = readRecord(_nextBuf);
+    _nextReady = true;
+}
+
+void FileServerConnection::closeFile() {
+
+    LOGS(_log, LOG_LVL_INFO, context << "sendData  <CLOSE> file: " << _fileName);
+
+    std::fclose(_filePtr);
+    _filePtr = 0;
+
+    // In the session mode the client will be requesting the next file
+    // over the same connection.
+
+    if (_keepOpen) receiveRequest();
 }
 
 void FileServerConnection::dataSent(boost::system::error_code const& ec,
@@ -360,7 +479,16 @@ void FileServerConnection::dataSent(boost::system::error_code const& ec,
 
     if (::isErrorCode(ec, "dataSent")) return;
 
-    sendData();
+    // The record read ahead while the previous one was being sent becomes
+    // the one to send. Nothing read ahead means the transfer is over.
+
+    if (not _nextReady or not _nextBytes) {
+        closeFile();
+        return;
+    }
+    _nextReady = false;
+    std::swap(_fileBuf, _nextBuf);
+    sendRecord(_nextBytes);
 }
 
 }}} // namespace lsst::qserv::replica
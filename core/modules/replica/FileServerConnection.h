@@ -31,6 +31,7 @@
 // System headers
 #include <cstdio>       // std::FILE, C-style file I/O
 #include <memory>
+#include <vector>
 
 // Third party headers
 #include <boost/asio.hpp>
@@ -65,7 +66,10 @@ namespace replica {
   * The lifespan of this object is exactly one request until it's fully
   * satisfied or any failure during request execution (when reading a file,
   * or communicating with a client) occures. When this happens the object
-  * stops doing anyting.
+  * stops doing anyting. A client may extend the lifespan of the connection
+  * by setting flag 'keep_open' in its requests (the session mode), in which
+  * case the object will go back to waiting for the next file request after
+  * finishing with the current file.
   */
 class FileServerConnection
     :   public std::enable_shared_from_this<FileServerConnection> {
@@ -172,16 +176,49 @@ private:
                       size_t bytes_transferred);
 
     /**
-     * Read the next record from the currently open file, and if succeeded
+     * Read the first record from the currently open file, and if succeeded
      * then begin streaming (asynchronosly) it to a client.
+     *
+     * The transfer is double buffered: while one record is in flight on
+     * the socket the next one is read from disk into the second buffer,
+     * so disk and network transfers overlap instead of alternating.
      */
     void sendData();
 
+    /**
+     * Read the next record of the current transfer into the specified buffer.
+     *
+     * In the block mode (when a client requested specific blocks of the file)
+     * the method seeks to the next requested block before reading, and only
+     * the content of the requested blocks is read.
+     *
+     * @param buf - the buffer to read into
+     *
+     * @return the number of bytes read, or 0 when the transfer is over
+     * (end of file, end of the requested blocks, or a read error)
+     */
+    size_t readRecord(uint8_t* buf);
+
+    /**
+     * Begin sending (asynchronosly) a record from the primary buffer, then
+     * read the next record into the secondary buffer while the send is
+     * in flight.
+     *
+     * @param bytes - number of bytes of the record in the primary buffer
+     */
+    void sendRecord(size_t bytes);
+
+    /**
+     * Close the currently open file and, in the session mode, go back to
+     * waiting for the next file request over the same connection.
+     */
+    void closeFile();
+
     /**
      * The calback on finishing (either successfully or not) of aynchronious writes.
      *
      * @param ec                - error code to be evaluated
-     * @param bytes_transferred - number of bytes of the file payload sent to a client 
+     * @param bytes_transferred - number of bytes of the file payload sent to a client
      */
     void dataSent(boost::system::error_code const& ec,
                   size_t bytes_transferred);
@@ -204,14 +241,41 @@ private:
     /// The name of a file during on-going transfer
     std::string _fileName;
 
+    /// The flag indicating if a client requested the session mode, in which
+    /// the connection stays open after finishing with the current file
+    bool _keepOpen;
+
     /// For a file during on-going transfer
     std::FILE* _filePtr;
-    
+
+    /// The block size (bytes) of the block mode transfer, or 0 if the whole
+    /// file was requested
+    size_t _blockSize;
+
+    /// Zero-based indexes of the blocks to be sent (the block mode only)
+    std::vector<uint64_t> _blocks;
+
+    /// The index (into _blocks) of the next block to be sent
+    size_t _blockItr;
+
+    /// The number of bytes of the current block not yet sent
+    size_t _blockBytesRemaining;
+
     /// The file record buffer size (bytes)
     size_t _fileBufSize;
 
-    /// The file record buffer
+    /// The file record buffer whose content is being sent to a client
     uint8_t* _fileBuf;
+
+    /// The second file record buffer, read into while _fileBuf is in flight
+    uint8_t* _nextBuf;
+
+    /// The number of bytes read ahead into _nextBuf (0 means the transfer
+    /// is over once the in-flight record is sent)
+    size_t _nextBytes;
+
+    /// The flag indicating that _nextBuf holds the result of a read-ahead
+    bool _nextReady;
 };
 
 }}} // namespace lsst::qserv::replica
@@ -29,6 +29,8 @@
 #include <cstring>
 #include <cstdio>
 #include <stdexcept>
+#include <thread>
+#include <sys/stat.h>   // stat
 #include <sys/types.h>  // struct passwd
 #include <pwd.h>        // getpwuid
 #include <unistd.h>     // geteuid
@@ -61,6 +63,17 @@ bool isValidExtention(std::string const& str) {
  *
  * @return 'true' if this is a valid table name
  */
+/// The minimum number of bytes each thread of the parallel control sum
+/// computation should get. Segments smaller than this aren't worth
+/// the thread startup cost.
+size_t const minSegmentSizeBytes = 16*1024*1024;
+
+/// The file name extention of the block digest sidecar files
+std::string const digestSidecarExt = ".bds";
+
+/// The format version of the block digest sidecar files
+uint64_t const digestSidecarVersion = 1;
+
 bool isValidPartitionedTable(
             std::string const& str,
             lsst::qserv::replica::DatabaseInfo const& databaseInfo) {
@@ -191,6 +204,214 @@ uint64_t FileUtils::compute_cs(std::string const& fileName,
     return cs;
 }
 
+uint64_t FileUtils::compute_cs_parallel(std::string const& fileName,
+                                        size_t             numThreads,
+                                        size_t             recordSizeBytes) {
+
+    if (fileName.empty()) {
+        throw std::invalid_argument("empty file name passed into FileUtils::compute_cs_parallel");
+    }
+    if (not recordSizeBytes or (recordSizeBytes > MAX_RECORD_SIZE_BYTES)) {
+        throw std::invalid_argument("invalid record size " + std::to_string(recordSizeBytes) +
+                                    "passed into FileUtils::compute_cs_parallel");
+    }
+    if (not numThreads) {
+        numThreads = std::thread::hardware_concurrency();
+        if (not numThreads) numThreads = 1;
+    }
+
+    // Get the file size to split the file between the threads. Cap the number
+    // of threads so that each one gets a reasonably large segment, which also
+    // sends small files down the plain single-threaded path.
+
+    struct stat st;
+    if (::stat(fileName.c_str(), &st)) {
+        throw std::runtime_error(
+            std::string("file stat error: ") + std::strerror(errno) +
+            std::string(", file: ") + fileName);
+    }
+    size_t const size = (size_t)st.st_size;
+    if (size / ::minSegmentSizeBytes < numThreads) {
+        numThreads = size / ::minSegmentSizeBytes;
+    }
+    if (numThreads < 2) return compute_cs(fileName, recordSizeBytes);
+
+    // Each thread opens its own descriptor and sums its own contiguous
+    // segment of the file. The control sum is a plain byte sum, so adding up
+    // the partial results gives exactly the single-threaded answer.
+
+    size_t const segmentSize = size / numThreads;
+
+    std::vector<uint64_t> partialCs(numThreads, 0);
+    std::vector<int>      errors(numThreads, 0);
+
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < numThreads; ++i) {
+        threads.emplace_back([&, i]() {
+
+            size_t const beg = i * segmentSize;
+            size_t const end = (i == numThreads - 1) ? size : beg + segmentSize;
+
+            std::FILE* fp = std::fopen(fileName.c_str(), "rb");
+            if (not fp) {
+                errors[i] = errno;
+                return;
+            }
+            if (std::fseek(fp, (long)beg, SEEK_SET)) {
+                errors[i] = errno;
+                std::fclose(fp);
+                return;
+            }
+            uint8_t* buf = new uint8_t[recordSizeBytes];
+
+            uint64_t cs = 0;
+            size_t bytesLeft = end - beg;
+            while (bytesLeft) {
+                size_t const num =
+                    std::fread(buf, sizeof(uint8_t), std::min(recordSizeBytes, bytesLeft), fp);
+                if (not num) {
+                    if (std::ferror(fp)) errors[i] = errno ? errno : EIO;
+                    break;
+                }
+                for (uint8_t *ptr = buf, *bufEnd = buf + num; ptr != bufEnd; ++ptr) {
+                    cs += (uint64_t)(*ptr);
+                }
+                bytesLeft -= num;
+            }
+            partialCs[i] = cs;
+
+            std::fclose(fp);
+            delete [] buf;
+        });
+    }
+    for (auto&& t: threads) {
+        t.join();
+    }
+    uint64_t cs = 0;
+    for (size_t i = 0; i < numThreads; ++i) {
+        if (errors[i]) {
+            throw std::runtime_error(
+                std::string("file read error: ") + std::strerror(errors[i]) +
+                std::string(", file: ") + fileName);
+        }
+        cs += partialCs[i];
+    }
+    return cs;
+}
+
+std::vector<uint64_t> FileUtils::blockDigests(std::string const& fileName,
+                                              size_t             blockSizeBytes) {
+
+    if (fileName.empty()) {
+        throw std::invalid_argument("empty file name passed into FileUtils::blockDigests");
+    }
+    if (not blockSizeBytes or (blockSizeBytes > MAX_RECORD_SIZE_BYTES)) {
+        throw std::invalid_argument("invalid block size " + std::to_string(blockSizeBytes) +
+                                    "passed into FileUtils::blockDigests");
+    }
+    std::FILE* fp = std::fopen(fileName.c_str(), "rb");
+    if (not fp) {
+        throw std::runtime_error(
+            std::string("file open error: ") + std::strerror(errno) +
+            std::string(", file: ") + fileName);
+    }
+    uint8_t *buf = new uint8_t[blockSizeBytes];
+
+    std::vector<uint64_t> digests;
+    size_t num;
+    while ((num = std::fread(buf, sizeof(uint8_t), blockSizeBytes, fp))) {
+        uint64_t cs = 0;
+        for (uint8_t *ptr = buf, *end = buf + num; ptr != end; ++ptr) {
+            cs += (uint64_t)(*ptr);
+        }
+        digests.push_back(cs);
+    }
+    if (std::ferror(fp)) {
+        const std::string err =
+            std::string("file read error: ") + std::strerror(errno) +
+            std::string(", file: ") + fileName;
+        fclose(fp);
+        delete [] buf;
+        throw std::runtime_error(err);
+    }
+    std::fclose(fp);
+    delete [] buf;
+
+    return digests;
+}
+
+std::vector<uint64_t> FileUtils::cachedBlockDigests(std::string const& fileName,
+                                                    size_t             blockSizeBytes) {
+
+    if (fileName.empty()) {
+        throw std::invalid_argument("empty file name passed into FileUtils::cachedBlockDigests");
+    }
+
+    // Grab the identity of the data file. A sidecar is only trusted when
+    // the block size, the file size and the modification time it recorded
+    // all match the file as it is now.
+
+    struct stat st;
+    if (::stat(fileName.c_str(), &st)) {
+        throw std::runtime_error(
+            std::string("file stat error: ") + std::strerror(errno) +
+            std::string(", file: ") + fileName);
+    }
+    std::string const sidecarName = fileName + ::digestSidecarExt;
+
+    std::FILE* fp = std::fopen(sidecarName.c_str(), "rb");
+    if (fp) {
+        uint64_t header[5];
+        if ((sizeof(header)/sizeof(header[0]) ==
+                 std::fread(header, sizeof(uint64_t), sizeof(header)/sizeof(header[0]), fp)) and
+            (header[0] == ::digestSidecarVersion) and
+            (header[1] == (uint64_t)blockSizeBytes) and
+            (header[2] == (uint64_t)st.st_size) and
+            (header[3] == (uint64_t)st.st_mtime)) {
+
+            std::vector<uint64_t> digests(header[4]);
+            if (digests.size() == std::fread(digests.data(), sizeof(uint64_t), digests.size(), fp)) {
+                std::fclose(fp);
+                return digests;
+            }
+        }
+        std::fclose(fp);
+    }
+
+    // No sidecar, or a stale or truncated one. Digest the file from scratch
+    // and rewrite the sidecar via a rename so readers never see a partially
+    // written one. The sidecar is just a cache, so any failure to write it
+    // is ignored and the freshly computed digests are returned regardless.
+
+    std::vector<uint64_t> const digests = blockDigests(fileName, blockSizeBytes);
+
+    struct stat stAfter;
+    if (::stat(fileName.c_str(), &stAfter) or
+        (stAfter.st_size != st.st_size) or (stAfter.st_mtime != st.st_mtime)) {
+        // The file mutated while it was being digested, don't cache.
+        return digests;
+    }
+    std::string const tmpName = sidecarName + ".tmp";
+    fp = std::fopen(tmpName.c_str(), "wb");
+    if (fp) {
+        uint64_t const header[5] = {
+            ::digestSidecarVersion,
+            (uint64_t)blockSizeBytes,
+            (uint64_t)st.st_size,
+            (uint64_t)st.st_mtime,
+            (uint64_t)digests.size()
+        };
+        bool const written =
+            (sizeof(header)/sizeof(header[0]) ==
+                 std::fwrite(header, sizeof(uint64_t), sizeof(header)/sizeof(header[0]), fp)) and
+            (digests.size() == std::fwrite(digests.data(), sizeof(uint64_t), digests.size(), fp));
+        std::fclose(fp);
+        if (written) std::rename(tmpName.c_str(), sidecarName.c_str());
+        else         std::remove(tmpName.c_str());
+    }
+    return digests;
+}
+
 std::string FileUtils::getEffectiveUser() {
     return std::string(getpwuid(geteuid())->pw_name);
 }
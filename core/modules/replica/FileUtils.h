@@ -62,6 +62,10 @@ public:
     /// The maximum number of bytes to be read during file I/O operations
     static constexpr size_t MAX_RECORD_SIZE_BYTES = 1024*1024*1024;
 
+    /// The default block size for the block-level digests used by
+    /// the incremental (delta) replication protocol
+    static constexpr size_t DEFAULT_BLOCK_SIZE_BYTES = 1024*1024;
+
     // Default construction and copy semantics are prohibited
 
     FileUtils() = delete;
@@ -130,6 +134,72 @@ public:
     static uint64_t compute_cs(std::string const& fileName,
                                size_t recordSizeBytes=DEFAULT_RECORD_SIZE_BYTES);
 
+    /**
+     * Compute a simple control sum on the specified file using multiple threads
+     *
+     * The file is split into contiguous segments, one per thread, and each
+     * thread sums its own segment. The control sum is a plain byte sum, so
+     * the partial results combine into exactly the value which method
+     * FileUtils::compute_cs() would produce. Small files are processed in
+     * the calling thread as they're not worth the thread startup cost.
+     *
+     * The method will throw the same exceptions as method FileUtils::compute_cs()
+     * and for the same reasons.
+     *
+     * @param fileName        - the name of a file to read
+     * @param numThreads      - the maximum number of threads to use, or 0 to
+     *                          use the number of hardware threads of the host
+     * @param recordSizeBytes - desired record size
+     *
+     * @return the control sum of the file content
+     */
+    static uint64_t compute_cs_parallel(std::string const& fileName,
+                                        size_t numThreads=0,
+                                        size_t recordSizeBytes=DEFAULT_RECORD_SIZE_BYTES);
+
+    /**
+     * Compute control sums over fixed-size blocks of the specified file
+     *
+     * The last block of a file is usually shorter than 'blockSizeBytes'
+     * unless the file size is aligned exactly on the block size. Two files
+     * digested with the same block size can be compared block-by-block
+     * to find which blocks differ (the incremental replication protocol).
+     *
+     * The method will throw the same exceptions as method FileUtils::compute_cs()
+     * and for the same reasons.
+     *
+     * @param fileName       - the name of a file to read
+     * @param blockSizeBytes - the size of a block
+     *
+     * @return the control sums of each block of the file, in the file order
+     */
+    static std::vector<uint64_t> blockDigests(std::string const& fileName,
+                                              size_t blockSizeBytes=DEFAULT_BLOCK_SIZE_BYTES);
+
+    /**
+     * Return the block-level digests of the specified file, reusing a digest
+     * sidecar file when one is present and still valid
+     *
+     * The digests are persisted next to the file in '<fileName>.bds' along
+     * with the block size, the file size and the modification time they were
+     * computed for. When all three still match the file the digests are read
+     * back instead of re-hashing the content, so routine verification of
+     * unmodified replicas costs a couple of small reads. A modified file is
+     * digested from scratch and its sidecar is rewritten (atomically, via
+     * a rename). Failures to write the sidecar are ignored as it's just
+     * a cache.
+     *
+     * The method will throw the same exceptions as method FileUtils::blockDigests()
+     * and for the same reasons.
+     *
+     * @param fileName       - the name of a file to read
+     * @param blockSizeBytes - the size of a block
+     *
+     * @return the control sums of each block of the file, in the file order
+     */
+    static std::vector<uint64_t> cachedBlockDigests(std::string const& fileName,
+                                                    size_t blockSizeBytes=DEFAULT_BLOCK_SIZE_BYTES);
+
     /// @return user account uner which the current process runs
     static std::string getEffectiveUser();
 };
@@ -222,7 +222,7 @@ void Job::finish(util::Lock const& lock,
     // Stop timers if they're still running
 
     if(_heartbeatTimerPtr)  _heartbeatTimerPtr->cancel();
-    if(_expirationTimerPtr) _expirationTimerPtr->cancel();
+    if(_expirationTimeout)  _expirationTimeout->cancel();
 
     notify();
 }
@@ -390,31 +390,26 @@ void Job::startExpirationTimer(util::Lock const& lock) {
 
         LOGS(_log, LOG_LVL_DEBUG, context() << "startExpirationTimer");
 
-        // The time needs to be initialized each time when a new interval
-        // is about to begin. Otherwise it will strt firing immediately.
-        _expirationTimerPtr.reset(
-            new boost::asio::deadline_timer(
-                controller()->io_service(),
-                boost::posix_time::seconds(_expirationIvalSec)));
-
-        _expirationTimerPtr->async_wait(
-            boost::bind(
-                &Job::expired,
-                shared_from_this(),
-                boost::asio::placeholders::error
-            )
+        if (_expirationTimeout != nullptr) _expirationTimeout->cancel();
+
+        // The timeout holds a weak pointer so an abandoned job isn't kept
+        // alive until its nominal expiration just because the wheel still
+        // holds the cancelled entry.
+        std::weak_ptr<Job> job = shared_from_this();
+        _expirationTimeout = controller()->serviceProvider()->timerWheel()->schedule(
+            std::chrono::seconds(_expirationIvalSec),
+            [job]() {
+                auto const ptr = job.lock();
+                if (ptr != nullptr) ptr->expired();
+            }
         );
     }
 }
 
-void Job::expired(boost::system::error_code const& ec) {
+void Job::expired() {
 
-    LOGS(_log, LOG_LVL_DEBUG, context() << "expired: "
-         << (ec == boost::asio::error::operation_aborted ? "** ABORTED **" : ""));
+    LOGS(_log, LOG_LVL_DEBUG, context() << "expired");
 
-    // Ignore this event if the timer was aborted
-    if (ec == boost::asio::error::operation_aborted) return;
-         
     // IMPORTANT: the final state is required to be tested twice. The first time
     // it's done in order to avoid deadlock on the "in-flight" requests reporting
     // their completion while the job termination is in a progress. And the second
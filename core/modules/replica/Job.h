@@ -42,6 +42,7 @@
 #include "replica/Controller.h"
 #include "replica/RemoveReplicaQservMgtRequest.h"
 #include "util/Mutex.h"
+#include "util/TimerWheel.h"
 
 // Forward declarations
 
@@ -406,13 +407,11 @@ private:
     void startExpirationTimer(util::Lock const& lock);
 
     /**
-     * Job expiration timer's handler. The expiration interval (if any)
+     * Job expiration timeout's handler. The expiration interval (if any)
      * is configured via the configuraton service. When the job expires
      * it finishes with completion status FINISHED::TIMEOUT_EXPIRED.
-     *
-     * @param ec - error code to be evaluated
      */
-    void expired(boost::system::error_code const& ec);
+    void expired();
 
     /**
      * This method will begin an optional user protocol upon a completion
@@ -462,14 +461,15 @@ private:
     unsigned int _heartbeatTimerIvalSec;
     std::unique_ptr<boost::asio::deadline_timer> _heartbeatTimerPtr;
 
-    /// This timer is used (if configured) to limit the total run time
-    /// of a job. The timer starts when the job is started. And it's
-    /// explicitly finished when a job finishes (successfully or not).
+    /// This timeout is used (if configured) to limit the total run time
+    /// of a job. It is scheduled on the shared timer wheel (see
+    /// ServiceProvider::timerWheel()) when the job is started. And it's
+    /// explicitly cancelled when a job finishes (successfully or not).
     ///
-    /// If the time has a chance to expire then the request would finish
+    /// If the timeout has a chance to expire then the request would finish
     /// with status: FINISHED::TIMEOUT_EXPIRED.
     unsigned int _expirationIvalSec;
-    std::unique_ptr<boost::asio::deadline_timer> _expirationTimerPtr;
+    util::TimerWheel::Timeout::Ptr _expirationTimeout;
 };
 
 /// Comparision type for strict weak ordering reaquired by std::priority_queue
@@ -90,17 +90,29 @@ std::string JobController::state2string(State state) {
     }
 }
 
-JobController::Ptr JobController::create(ServiceProvider::Ptr const& serviceProvider) {
+JobController::Ptr JobController::create(ServiceProvider::Ptr const& serviceProvider,
+                                         ControllerShard const& shard) {
     return JobController::Ptr(
-        new JobController(serviceProvider));
+        new JobController(serviceProvider, shard));
 }
 
-JobController::JobController(ServiceProvider::Ptr const& serviceProvider)
+JobController::JobController(ServiceProvider::Ptr const& serviceProvider,
+                             ControllerShard const& shard)
     :   _serviceProvider(serviceProvider),
         _controller(Controller::create (serviceProvider)),
+        _shard(shard),
         _state(State::NOT_RUNNING) {
 }
 
+bool JobController::ownsFamily(std::string const& databaseFamily,
+                               std::string const& context) const {
+    if (_shard.isResponsibleFor(databaseFamily)) return true;
+    LOGS(_log, LOG_LVL_WARN, "JobController::" << context
+         << "  database family '" << databaseFamily
+         << "' is owned by another shard, this controller is " << _shard);
+    return false;
+}
+
 bool JobController::run() {
 
     LOGS(_log, LOG_LVL_DEBUG, "JobController::run");
@@ -171,6 +183,7 @@ FindAllJob::Ptr JobController::findAll(std::string const& databaseFamily,
     util::Lock lock(_mtx, "JobController::findAll");
 
     if (State::IS_RUNNING != _state) return nullptr;
+    if (not ownsFamily(databaseFamily, "findAll")) return nullptr;
 
     auto const self = shared_from_this();
     auto const job = FindAllJob::create(
@@ -208,6 +221,7 @@ FixUpJob::Ptr JobController::fixUp(std::string const& databaseFamily,
     util::Lock lock(_mtx, "JobController::fixUp");
 
     if (State::IS_RUNNING != _state) return nullptr;
+    if (not ownsFamily(databaseFamily, "fixUp")) return nullptr;
 
     auto const self = shared_from_this();
     auto const job = FixUpJob::create(
@@ -245,6 +259,7 @@ PurgeJob::Ptr JobController::purge(std::string const& databaseFamily,
     util::Lock lock(_mtx, "JobController::purge");
 
     if (State::IS_RUNNING != _state) return nullptr;
+    if (not ownsFamily(databaseFamily, "purge")) return nullptr;
 
     auto const self = shared_from_this();
     auto const job = PurgeJob::create(
@@ -283,6 +298,7 @@ ReplicateJob::Ptr JobController::replicate(std::string const& databaseFamily,
     util::Lock lock(_mtx, "JobController::replicate");
 
     if (State::IS_RUNNING != _state) return nullptr;
+    if (not ownsFamily(databaseFamily, "replicate")) return nullptr;
 
     auto const self = shared_from_this();
     auto const job = ReplicateJob::create(
@@ -333,6 +349,8 @@ VerifyJob::Ptr JobController::verify(VerifyJob::CallbackType onFinish,
         onReplicaDifference,
         maxReplicas,
         computeCheckSum,
+        100,    /* samplePercent (the exhaustive mode) */
+        0,      /* forceCheckSumAgeSec */
         options
     );
 
@@ -37,6 +37,7 @@
 
 // Qserv headers
 #include "replica/Controller.h"
+#include "replica/ControllerShard.h"
 #include "replica/DeleteWorkerJob.h"
 #include "replica/FindAllJob.h"
 #include "replica/FixUpJob.h"
@@ -150,11 +151,20 @@ public:
      * The Controller will need to be started (see method JobController::run) before
      * it will be able to accept job submission requests.
      *
+     * In the sharded (multi-controller) setups the optional shard descriptor
+     * limits this Job Controller to the database families owned by the shard.
+     * Submission requests for families owned by other shards will return
+     * 'nullptr', the same way as submissions in a wrong state do.
+     *
      * @param serviceProvider - for configuration, other services
+     * @param shard           - (optional) the slice of the cluster this controller
+     *                          is responsible for. The default value is the
+     *                          traditional single-controller setup.
      *
      * @return pointer to the new object
      */
-    static Ptr create(ServiceProvider::Ptr const& serviceProvider);
+    static Ptr create(ServiceProvider::Ptr const& serviceProvider,
+                      ControllerShard const& shard = ControllerShard());
 
     // Default construction and copy semantics are prohibited
 
@@ -167,6 +177,9 @@ public:
     /// @return current state of the Controller
     State state() const { return _state; }
 
+    /// @return the slice of the cluster this controller is responsible for
+    ControllerShard const& shard() const { return _shard; }
+
     /**
      * Run the Job Controller unless it's already running. This operation assumes
      * that the Controller is either in State::NOT_RUNNING or State::IS_RUNNING.
@@ -204,7 +217,8 @@ public:
      * @param options         - (optional) job options
      *
      * @return pointer to the submitted job, or nullptr if the operation isn't allowed
-     * in the current state of the Controller.
+     * in the current state of the Controller or the database family is owned
+     * by another controller shard.
      */
     FindAllJob::Ptr findAll(std::string const& databaseFamily,
                             bool saveReplicaInfo,
@@ -221,7 +235,8 @@ public:
      * @param options        - (optional) job options
      *
      * @return pointer to the submitted job, or nullptr if the operation isn't allowed
-     * in the current state of the Controller.
+     * in the current state of the Controller or the database family is owned
+     * by another controller shard.
      */
     FixUpJob::Ptr fixUp(std::string const& databaseFamily,
                         FixUpJob::CallbackType onFinish = nullptr,
@@ -241,7 +256,8 @@ public:
      * @param options        - (optional) job options
      * 
      * @return pointer to the submitted job, or nullptr if the operation isn't allowed
-     * in the current state of the Controller.
+     * in the current state of the Controller or the database family is owned
+     * by another controller shard.
      */
     PurgeJob::Ptr purge(std::string const& databaseFamily,
                         unsigned int numReplicas = 0,
@@ -262,7 +278,8 @@ public:
      * @param options        - (optional) job options
      * 
      * @return pointer to the submitted job, or nullptr if the operation isn't allowed
-     * in the current state of the Controller.
+     * in the current state of the Controller or the database family is owned
+     * by another controller shard.
      */
     ReplicateJob::Ptr replicate(std::string const& databaseFamily,
                                 unsigned int numReplicas = 0,
@@ -320,7 +337,22 @@ private:
      *
      * @see JobController::create()
      */
-    JobController(ServiceProvider::Ptr const& serviceProvider);
+    JobController(ServiceProvider::Ptr const& serviceProvider,
+                  ControllerShard const& shard);
+
+    /**
+     * Check if a database family is owned by this controller's shard.
+     * Families of other shards are reported (once per submission attempt)
+     * at the warning level as they normally indicate a misconfigured
+     * sharded setup.
+     *
+     * @param databaseFamily - the name of a database family
+     * @param context        - the name of the calling method, for the log
+     *
+     * @return 'true' if the family is owned by this controller's shard
+     */
+    bool ownsFamily(std::string const& databaseFamily,
+                    std::string const& context) const;
 
     /**
      * The callback method to be called upon a completion of a job.
@@ -338,6 +370,9 @@ private:
     /// A dedciated instance of the Controller for executing requests
     Controller::Ptr _controller;
 
+    /// The slice of the cluster this controller is responsible for
+    ControllerShard const _shard;
+
     /// The current state
     std::atomic<State> _state;
 
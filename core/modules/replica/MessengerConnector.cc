@@ -24,7 +24,9 @@
 #include "replica/MessengerConnector.h"
 
 // System headers
+#include <algorithm>
 #include <stdexcept>
+#include <vector>
 
 // Third party headers
 #include <boost/bind.hpp>
@@ -33,6 +35,7 @@
 // Qserv headers
 #include "lsst/log/Log.h"
 #include "replica/Configuration.h"
+#include "replica/ConfigurationCache.h"
 #include "replica/ProtocolBuffer.h"
 #include "replica/ServiceProvider.h"
 
@@ -40,6 +43,17 @@ namespace {
 
 LOG_LOGGER _log = LOG_GET("lsst.qserv.replica.MessengerConnector");
 
+/// The maximum number of requests written to a worker before the first of
+/// them gets answered. The value is a compromise between keeping a connection
+/// busy on high-latency links and not buffering too many unanswered requests
+/// at a worker.
+size_t const maxInFlightRequests = 16;
+
+/// The maximum number of queued requests packed into a single batch
+/// envelope and written to a worker in one operation. Batching amortizes
+/// the per-request framing and I/O costs on both sides of a connection.
+size_t const maxRequestsPerBatch = 8;
+
 } /// namespace
 
 namespace lsst {
@@ -70,14 +84,16 @@ MessengerConnector::MessengerConnector(ServiceProvider::Ptr const& serviceProvid
                                        boost::asio::io_service& io_service,
                                        std::string const& worker)
     :   _serviceProvider(serviceProvider),
-        _workerInfo(serviceProvider->config()->workerInfo(worker)),
+        _workerInfo(serviceProvider->configCache()->workerInfo(worker)),
         _bufferCapacityBytes(serviceProvider->config()->requestBufferSizeBytes()),
         _timerIvalSec(serviceProvider->config()->retryTimeoutSec()),
         _state(State::STATE_INITIAL),
         _resolver(io_service),
         _socket(io_service),
         _timer(io_service),
-        _inBuffer(serviceProvider->config()->requestBufferSizeBytes()) {
+        _readInProgress(false),
+        _inBuffer(serviceProvider->config()->requestBufferSizeBytes()),
+        _batchHeaderBuffer(serviceProvider->config()->requestBufferSizeBytes()) {
 }
 
 void MessengerConnector::stop() {
@@ -105,18 +121,22 @@ void MessengerConnector::stop() {
                 _socket.close();
                 _timer.cancel();
     
-                // Make sure the current request's owner gets notified
-    
-                if (_currentRequest != nullptr) {
-                    requests2notify.push_back(_currentRequest);
-                    _currentRequest = nullptr;
-                }
+                // Make sure the owners of the requests being written get notified
+
+                for (auto&& ptr: _currentRequests) requests2notify.push_back(ptr);
+                _currentRequests.clear();
+
+                // The in-flight requests will never see their responses
+
+                for (auto&& ptr: _inFlight) requests2notify.push_back(ptr);
+                _inFlight.clear();
+                _readInProgress = false;
 
                 // Also cancel the queued requests and notify their owners
-                
+
                 for (auto&& ptr: _requests) requests2notify.push_back(ptr);
                 _requests.clear();
-    
+
                 break;
     
             default:
@@ -134,23 +154,56 @@ void MessengerConnector::cancel(std::string const& id) {
 
     LOGS(_log, LOG_LVL_DEBUG, context() << "cancel  id=" << id);
 
-    util::Lock lock(_mtx, context() + "cancel");
+    std::list<MessageWrapperBase::Ptr> requests2notify;
+    {
+        util::Lock lock(_mtx, context() + "cancel");
 
-    // Remove request from the queue (if it's still there)
+        // Remove request from the queue (if it's still there)
 
-    _requests.remove_if(
-        [&id] (MessageWrapperBase::Ptr const& ptr) {
-            return ptr->id() == id;
-        }
-    );
+        _requests.remove_if(
+            [&id] (MessageWrapperBase::Ptr const& ptr) {
+                return ptr->id() == id;
+            }
+        );
 
-    // Also, if the request is already being processed then terminate all
-    // communications with a worker. This will automatically abort the request.
+        // An in-flight request is simply forgotten. Its response will arrive
+        // with an identifier matching no request and will be discarded.
 
-    if (_currentRequest and (_currentRequest->id() == id)) {
-        _currentRequest = nullptr;
-        if (_state == STATE_COMMUNICATING) restart(lock);
+        _inFlight.remove_if(
+            [&id] (MessageWrapperBase::Ptr const& ptr) {
+                return ptr->id() == id;
+            }
+        );
+
+        // Also, if the request is being written then terminate all communications
+        // with a worker. This will automatically abort the request. The other
+        // requests of the write (if it was a batch) get requeued to be served
+        // first when the connection is reestablished. The responses to
+        // the in-flight requests are lost along with the connection, so
+        // their owners get notified about the failure.
+
+        auto itr = std::find_if(_currentRequests.begin(),
+                                _currentRequests.end(),
+                                [&id] (MessageWrapperBase::Ptr const& ptr) {
+                                    return ptr->id() == id;
+                                });
+        if (itr != _currentRequests.end()) {
+            _currentRequests.erase(itr);
+            _requests.insert(_requests.begin(),
+                             _currentRequests.begin(),
+                             _currentRequests.end());
+            _currentRequests.clear();
+
+            if (_state == STATE_COMMUNICATING) {
+                requests2notify = abandonInFlight(lock);
+                restart(lock);
+            }
+        }
     }
+
+    // Sending notifications (if requsted) outsize the lock guard to avoid deadlocks.
+
+    for (auto&& ptr: requests2notify) ptr->parseAndNotify();
 }
 
 bool MessengerConnector::exists(std::string const& id) const {
@@ -201,7 +254,7 @@ void MessengerConnector::sendImpl(MessageWrapperBase::Ptr const& ptr) {
 void MessengerConnector::restart(util::Lock const& lock) {
 
     LOGS(_log, LOG_LVL_DEBUG, context() << "restart"
-         << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : ""));
+         << "  currentRequests=" << _currentRequests.size());
 
     // Cancel any asynchronous operation(s) if not in the initial state
 
@@ -230,13 +283,13 @@ void MessengerConnector::restart(util::Lock const& lock) {
 void MessengerConnector::resolve(util::Lock const& lock) {
 
     LOGS(_log, LOG_LVL_DEBUG, context() << "resolve"
-         << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : ""));
+         << "  currentRequests=" << _currentRequests.size());
 
     if (_state != STATE_INITIAL) return;
 
     boost::asio::ip::tcp::resolver::query query(
-        _workerInfo.svcHost,
-        std::to_string(_workerInfo.svcPort)
+        _workerInfo->svcHost,
+        std::to_string(_workerInfo->svcPort)
     );
     _resolver.async_resolve(
         query,
@@ -254,7 +307,7 @@ void MessengerConnector::resolved(boost::system::error_code const& ec,
                                   boost::asio::ip::tcp::resolver::iterator iter) {
 
     LOGS(_log, LOG_LVL_DEBUG, context() << "resolved"
-         << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : ""));
+         << "  currentRequests=" << _currentRequests.size());
 
     if (isAborted(ec)) return;
 
@@ -271,7 +324,7 @@ void MessengerConnector::connect(util::Lock const& lock,
                                  boost::asio::ip::tcp::resolver::iterator iter) {
 
     LOGS(_log, LOG_LVL_DEBUG, context() << "connect"
-         << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : ""));
+         << "  currentRequests=" << _currentRequests.size());
 
     boost::asio::async_connect(
         _socket,
@@ -289,7 +342,7 @@ void MessengerConnector::connected(boost::system::error_code const& ec,
                                    boost::asio::ip::tcp::resolver::iterator iter) {
 
     LOGS(_log, LOG_LVL_DEBUG, context() << "connected"
-         << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : ""));
+         << "  currentRequests=" << _currentRequests.size());
 
     if (isAborted(ec)) return;
 
@@ -306,7 +359,7 @@ void MessengerConnector::connected(boost::system::error_code const& ec,
 void MessengerConnector::waitBeforeRestart(util::Lock const& lock) {
 
     LOGS(_log, LOG_LVL_DEBUG, context() << "waitBeforeRestart"
-         << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : ""));
+         << "  currentRequests=" << _currentRequests.size());
 
     // Allways need to set the interval before launching the timer.
 
@@ -323,7 +376,7 @@ void MessengerConnector::waitBeforeRestart(util::Lock const& lock) {
 void MessengerConnector::awakenForRestart(boost::system::error_code const& ec) {
 
     LOGS(_log, LOG_LVL_DEBUG, context() << "awakenForRestart"
-         << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : ""));
+         << "  currentRequests=" << _currentRequests.size());
 
     if (isAborted(ec)) return;
 
@@ -337,27 +390,59 @@ void MessengerConnector::awakenForRestart(boost::system::error_code const& ec) {
 void MessengerConnector::sendRequest(util::Lock const& lock) {
 
     LOGS(_log, LOG_LVL_DEBUG, context() << "sendRequest"
-         << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : ""));
+         << "  currentRequests=" << _currentRequests.size());
+
+    // Check if there is an outstanding write operation
 
-    // Check if there is an outstanding send request
+    if (not _currentRequests.empty()) return;
 
-    if (_currentRequest) return;
+    // Don't pipeline more requests into the connection beyond the limit
 
-    // Pull a request (if any) from the from of the queue
+    if (_inFlight.size() >= maxInFlightRequests) return;
+
+    // Pull requests (if any) from the front of the queue, up to the batch
+    // limit and the number of the remaining in-flight slots.
 
     if (_requests.empty()) return;
 
-    _currentRequest = _requests.front();
-    _requests.pop_front();
+    size_t const maxRequests = std::min(maxRequestsPerBatch,
+                                        maxInFlightRequests - _inFlight.size());
+    while ((_currentRequests.size() < maxRequests) and not _requests.empty()) {
+        _currentRequests.push_back(_requests.front());
+        _requests.pop_front();
+    }
+
+    // Send the message(s). If more than one request was pulled from the queue
+    // then the requests are packed into a batch envelope which tells a worker
+    // how many requests follow within the same write. The worker will coalesce
+    // its responses to the requests of the envelope into a single write as well.
+
+    std::vector<boost::asio::const_buffer> buffers;
 
-    // Send the message
+    if (_currentRequests.size() > 1) {
 
+        proto::ReplicationRequestHeader hdr;
+        hdr.set_id(_currentRequests.front()->id());
+        hdr.set_type(proto::ReplicationRequestHeader::BATCH);
+        hdr.set_batch_size(_currentRequests.size());
+
+        _batchHeaderBuffer.resize();
+        _batchHeaderBuffer.serialize(hdr);
+
+        buffers.push_back(
+            boost::asio::buffer(
+                _batchHeaderBuffer.data(),
+                _batchHeaderBuffer.size()));
+    }
+    for (auto&& ptr: _currentRequests) {
+        buffers.push_back(
+            boost::asio::buffer(
+                ptr->requestBufferPtr()->data(),
+                ptr->requestBufferPtr()->size()));
+    }
     boost::asio::async_write(
         _socket,
-        boost::asio::buffer(
-            _currentRequest->requestBufferPtr()->data(),
-            _currentRequest->requestBufferPtr()->size()
-        ),
+        buffers,
         boost::bind(
             &MessengerConnector::requestSent,
             shared_from_this(),
@@ -371,51 +456,85 @@ void MessengerConnector::requestSent(boost::system::error_code const& ec,
                                      size_t bytes_transferred) {
 
     LOGS(_log, LOG_LVL_DEBUG, context() << "requestSent"
-         << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : ""));
+         << "  currentRequests=" << _currentRequests.size());
+
+    std::list<MessageWrapperBase::Ptr> requests2notify;
+    {
+        util::Lock lock(_mtx, context() + "requestSent");
 
-    util::Lock lock(_mtx, context() + "requestSent");
+        // Check if the write was aborted by a cancellation of one of its
+        // requests. If that happens then _currentRequests should already be
+        // emptied and the requests removed from all data structures. Otherwise
+        // the write was aborted by a concurrent restart (e.g. after a failed
+        // read), in which case the requests get requeued to be sent first when
+        // the connection is reestablished.
 
-    // Check if the request was cancelled while still in flight.
-    // If that happens then _currentRequest should already be nullified
-    // and request removed from all data structures.
+        if (isAborted(ec)) {
+            LOGS(_log, LOG_LVL_DEBUG, context() << "requestSent  isAborted -> restart");
 
-    if (isAborted(ec)) {
-        LOGS(_log, LOG_LVL_DEBUG, context() << "requestSent  isAborted -> restart");
+            if (not _currentRequests.empty()) {
+                _requests.insert(_requests.begin(),
+                                 _currentRequests.begin(),
+                                 _currentRequests.end());
+                _currentRequests.clear();
+            }
+            restart(lock);
 
-        restart(lock);
-        return;
-    }
-    if (_currentRequest) {
+        } else if (not _currentRequests.empty()) {
 
-        // The requst is still valid
-        if (ec.value() != 0) {
+            // The requsts are still valid
+            if (ec.value() != 0) {
 
-            // If something bad happened along the line then make sure this request
-            // will be the first to be served before restarting the communication.
+                // If something bad happened along the line then make sure these requests
+                // will be the first to be served before restarting the communication.
+                // The responses to the in-flight requests are lost along with
+                // the connection.
 
-            _requests.push_front(_currentRequest);
-            _currentRequest = nullptr;
+                _requests.insert(_requests.begin(),
+                                 _currentRequests.begin(),
+                                 _currentRequests.end());
+                _currentRequests.clear();
 
-            LOGS(_log, LOG_LVL_DEBUG, context() << "requestSent  request is valid, but failed -> restart");
+                LOGS(_log, LOG_LVL_DEBUG, context() << "requestSent  requests are valid, but failed -> restart");
 
-            restart(lock);
+                requests2notify = abandonInFlight(lock);
+                restart(lock);
 
-        } else {
+            } else {
 
-            // Go wait for a server respone
+                // The requests are now awaiting their responses. Make sure a read
+                // is in progress and keep the pipeline full with the next batch
+                // of requests (if any).
 
-            receiveResponse(lock);
-        }
+                for (auto&& ptr: _currentRequests) _inFlight.push_back(ptr);
+                _currentRequests.clear();
 
-    } else {
-        LOGS(_log, LOG_LVL_DEBUG, context() << "requestSent  no current request (cancelled?)");
+                receiveResponse(lock);
+                sendRequest(lock);
+            }
+
+        } else {
+            LOGS(_log, LOG_LVL_DEBUG, context() << "requestSent  no current requests (cancelled?)");
+        }
     }
+
+    // Sending notifications (if requsted) outsize the lock guard to avoid deadlocks.
+
+    for (auto&& ptr: requests2notify) ptr->parseAndNotify();
 }
 
 void MessengerConnector::receiveResponse(util::Lock const& lock) {
 
     LOGS(_log, LOG_LVL_DEBUG, context() << "receiveResponse"
-         << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : ""));
+         << "  inFlight=" << _inFlight.size());
+
+    // Only one read operation at a time, and only when there are in-flight
+    // requests whose responses are still expected.
+
+    if (_readInProgress) return;
+    if (_inFlight.empty()) return;
+
+    _readInProgress = true;
 
     // Start with receiving the fixed length frame carrying
     // the size (in bytes) the length of the subsequent message.
@@ -448,7 +567,7 @@ void MessengerConnector::responseReceived(boost::system::error_code const& ec,
                                           size_t bytes_transferred) {
 
     LOGS(_log, LOG_LVL_DEBUG, context() << "responseReceived"
-         << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : "")
+         << "  inFlight=" << _inFlight.size()
          << " error_code=" << ec);
 
     // The notification if any should be happening outside the lock guard
@@ -461,107 +580,116 @@ void MessengerConnector::responseReceived(boost::system::error_code const& ec,
     // the notification in a separate (new) thread.
 
     MessageWrapperBase::Ptr request2notify;
+    std::list<MessageWrapperBase::Ptr> requests2notify;
     {
         util::Lock lock(_mtx, context() + "responseReceived");
 
-        // Check if the request was cancelled while still in flight.
-        // If that happens then _currentRequest should already be nullified
-        // and request removed from all data structures.
+        _readInProgress = false;
+
+        // Check if the read was aborted by a cancellation or a concurrent
+        // restart. Whoever initiated the abort has already taken care of
+        // the in-flight requests.
 
         if (isAborted(ec)) {
             restart(lock);
             return;
         }
 
-        if (_currentRequest) {
+        if (ec.value() != 0) {
 
-            // At this point we're done with the current request, regardless of its completion
-            // status, or any failures to pull or digest the response data. Hence, removing
-            // completelly it and getting ready to notify a caller.
+            // Failed to get any response from a worker. The responses to all
+            // in-flight requests are lost along with the connection.
 
-            std::swap(request2notify, _currentRequest);
+            requests2notify = abandonInFlight(lock);
+            restart(lock);
 
-            // The requst is still valid
-            if (ec.value() != 0) {
+        } else {
 
-                // Failed to get any response from a worker
+            // Receive response header into the temporary buffer and find which
+            // in-flight request is being answered.
 
+            std::string id;
+            if (syncReadHeader(lock,
+                               _inBuffer,
+                               _inBuffer.parseLength(),
+                               id).value() != 0) {
+
+                // Failed to receive the header
+
+                requests2notify = abandonInFlight(lock);
                 restart(lock);
 
             } else {
 
-                // Receive response header into the temporary buffer
+                // Detach the matching in-flight request (if any). A response
+                // with no matching request belongs to a cancelled request, and
+                // its body gets read below and discarded.
+
+                auto itr = std::find_if(_inFlight.begin(),
+                                        _inFlight.end(),
+                                        [&id] (MessageWrapperBase::Ptr const& ptr) {
+                                            return ptr->id() == id;
+                                        });
+                if (itr != _inFlight.end()) {
+                    request2notify = *itr;
+                    _inFlight.erase(itr);
+                } else {
+                    LOGS(_log, LOG_LVL_DEBUG, context() << "responseReceived"
+                         << "  discarding response for unknown id=" << id);
+                }
+
+                // Read the response frame
 
-                if (syncReadVerifyHeader(lock,
-                                         _inBuffer,
-                                         _inBuffer.parseLength(),
-                                         request2notify->id()).value() != 0) {
+                size_t bytes;
+                if (syncReadFrame(lock,
+                                  _inBuffer,
+                                  bytes).value() != 0) {
 
-                    // Failed to receive the header
+                    // Failed to read the frame
 
+                    requests2notify = abandonInFlight(lock);
                     restart(lock);
 
                 } else {
 
-                    // Read the response frame
+                    LOGS(_log, LOG_LVL_DEBUG, context() << "responseReceived"
+                         << "  id=" << id
+                         << " bytes=" << bytes);
+
+                    // Receive response body into a buffer inside the wrapper
+                    // (or into the temporary buffer if the request was cancelled)
 
-                    size_t bytes;
-                    if (syncReadFrame(lock,
-                                      _inBuffer,
-                                      bytes).value() != 0) {
+                    if (syncReadMessageImpl(lock,
+                                            request2notify ? request2notify->responseBuffer()
+                                                           : _inBuffer,
+                                            bytes).value() != 0) {
 
-                        // Failed to read the frame
+                        // Failed to read the message body
 
+                        requests2notify = abandonInFlight(lock);
                         restart(lock);
 
                     } else {
 
-                        LOGS(_log, LOG_LVL_DEBUG, context() << "responseReceived"
-                             << "  _currentRequest=" << request2notify->id()
-                             << " bytes=" << bytes);
-
-                        // Receive response body into a buffer inside the wrapper
-
-                        if (syncReadMessageImpl(lock,
-                                                request2notify->responseBuffer(),
-                                                bytes).value() != 0) {
-
-                            // Failed to read the message body
+                        // Finally, success!
 
-                            restart(lock);
+                        if (request2notify) request2notify->setSuccess(true);
 
-                        } else {
+                        // Keep the pipeline moving: refill the freed slot and
+                        // go wait for the next response (if any is expected)
 
-                            // Finally, success!
-
-                            request2notify->setSuccess(true);
-
-                            // Initiate the next request (if any) processing
-
-                            sendRequest(lock);
-                        }
+                        sendRequest(lock);
+                        receiveResponse(lock);
                     }
                 }
             }
-
-        } else {
-
-            // We're here because there is no '_currentRequest'.
-            // The request submission had a chance to finish (successfully or not)
-            // before the cancellation attempt was made. So, we just forget about
-            // this request and send no notification to a caller.
-
-            if (ec.value() != 0) {
-                restart(lock);
-            } else {
-                sendRequest(lock);
-            }
         }
     }
 
     // Sending notifications (if requsted) outsize the lock guard to avoid
     // deadlocks.
 
+    for (auto&& ptr: requests2notify) ptr->parseAndNotify();
     if (request2notify) request2notify->parseAndNotify();
 }
 
@@ -582,17 +710,17 @@ boost::system::error_code MessengerConnector::syncReadFrame(util::Lock const& lo
         ec
     );
     LOGS(_log, LOG_LVL_DEBUG, context() << "syncReadFrame"
-         << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : "")
+         << "  currentRequests=" << _currentRequests.size()
          << " error_code=" << ec);
 
     if (ec.value() == 0) bytes = buf.parseLength();
     return ec;
 }
 
-boost::system::error_code MessengerConnector::syncReadVerifyHeader(util::Lock const& lock,
-                                                                   replica::ProtocolBuffer& buf,
-                                                                   size_t bytes,
-                                                                   std::string const& id) {
+boost::system::error_code MessengerConnector::syncReadHeader(util::Lock const& lock,
+                                                             replica::ProtocolBuffer& buf,
+                                                             size_t bytes,
+                                                             std::string& id) {
     boost::system::error_code const ec =
         syncReadMessageImpl(lock,
                             buf,
@@ -600,11 +728,7 @@ boost::system::error_code MessengerConnector::syncReadVerifyHeader(util::Lock co
     if (ec.value() == 0) {
         proto::ReplicationResponseHeader hdr;
         buf.parse(hdr, bytes);
-        if (id != hdr.id()) {
-            throw std::logic_error(
-                    "MessengerConnector::syncReadVerifyHeader  got unexpected id: " + hdr.id() +
-                    " instead of: " + id);
-        }
+        id = hdr.id();
     }
     return ec;
 }
@@ -625,7 +749,7 @@ boost::system::error_code MessengerConnector::syncReadMessageImpl(util::Lock con
         ec
     );
     LOGS(_log, LOG_LVL_DEBUG, context() << "syncReadMessageImpl"
-         << "  _currentRequest=" << (_currentRequest ? _currentRequest->id() : "")
+         << "  currentRequests=" << _currentRequests.size()
          << " error_code=" << ec);
 
     return ec;
@@ -641,18 +765,42 @@ bool MessengerConnector::isAborted(boost::system::error_code const& ec) const {
 }
 
 std::string MessengerConnector::context() const {
-    return "MESSENGER-CONNECTION [worker=" + _workerInfo.name + ", state=" + state2string(_state) + "]  ";
+    return "MESSENGER-CONNECTION [worker=" + _workerInfo->name + ", state=" + state2string(_state) + "]  ";
 }
 
 MessageWrapperBase::Ptr MessengerConnector::find(util::Lock const& lock,
                                                  std::string const& id) const {
-    auto itr = std::find_if(_requests.begin(),
-                            _requests.end(),
-                            [&id] (MessageWrapperBase::Ptr const& ptr) {
-                                return ptr->id() == id;
-                            });
+    auto const matchId =
+        [&id] (MessageWrapperBase::Ptr const& ptr) {
+            return ptr->id() == id;
+        };
+
+    auto itr = std::find_if(_currentRequests.begin(),
+                            _currentRequests.end(),
+                            matchId);
+    if (_currentRequests.end() != itr) return *itr;
+
+    itr = std::find_if(_requests.begin(),
+                       _requests.end(),
+                       matchId);
+    if (_requests.end() != itr) return *itr;
 
-    return _requests.end() == itr ? MessageWrapperBase::Ptr() : *itr;
+    itr = std::find_if(_inFlight.begin(),
+                       _inFlight.end(),
+                       matchId);
+
+    return _inFlight.end() == itr ? MessageWrapperBase::Ptr() : *itr;
+}
+
+std::list<MessageWrapperBase::Ptr> MessengerConnector::abandonInFlight(util::Lock const& lock) {
+
+    std::list<MessageWrapperBase::Ptr> abandoned;
+    abandoned.swap(_inFlight);
+
+    if (not abandoned.empty()) {
+        LOGS(_log, LOG_LVL_DEBUG, context() << "abandonInFlight  count=" << abandoned.size());
+    }
+    return abandoned;
 }
 
 }}} // namespace lsst::qserv::replica
@@ -204,6 +204,21 @@ private:
  * messages to and from worker services. It provides connection multiplexing and
  * automatic reconnects.
  *
+ * Requests are pipelined: up to a fixed number of requests may be written to
+ * the worker before the first response comes back, and responses are matched
+ * to their requests by the identifier carried in the response header. This
+ * keeps the connection throughput limited by bandwidth rather than by the
+ * round-trip time per request, which matters when thousands of small status
+ * polls are in flight.
+ *
+ * In addition, when more than one request is queued at a time when the
+ * connection becomes available for writing, the requests are packed into
+ * a batch envelope (see message ReplicationRequestHeader in replication.proto)
+ * and written to the worker in a single (gather) operation. The worker will
+ * coalesce its responses to the requests of the envelope into a single write
+ * as well. Responses stay individually framed on the wire, so the response
+ * reading code path is not affected by batching.
+ *
  * NOTES ON THREAD SAFETY:
  *
  * - in the implementation of this class a mutex is used to prevent race conditions
@@ -397,9 +412,13 @@ private:
     void awakenForRestart(boost::system::error_code const& ec);
 
     /**
-     * Lookup for the next available request and begin sending it
-     * unless there is another ongoing request at a time of the call.
-     * 
+     * Lookup for the next available request(s) and begin sending them, unless
+     * another write is in progress at a time of the call or the limit
+     * on the number of in-flight (sent, but not yet answered) requests has
+     * been reached. If more than one request is pulled from the queue then
+     * the requests are packed into a batch envelope and written to a worker
+     * in a single operation.
+     *
      * @param lock - a lock on a mutex must be acquired before calling this method
      */
     void sendRequest(util::Lock const& lock);
@@ -414,8 +433,11 @@ private:
                      size_t bytes_transferred);
 
     /**
-     * Begin receiving a response
-     * 
+     * Begin receiving a response, unless a read is already in progress or
+     * there are no in-flight requests to be answered. Which request the
+     * response belongs to is determined from the response header when it
+     * arrives.
+     *
      * @param lock - a lock on a mutex must be acquired before calling this method
      */
     void receiveResponse(util::Lock const& lock);
@@ -445,25 +467,22 @@ private:
                                             size_t& bytes);
 
    /**
-     * Synchriniously read a response header of a known size. Then parse it
-     * and analyze it to ensure its content matches expecations. Return
+     * Synchriniously read a response header of a known size, parse it and
+     * extract the identifier of a request the response corresponds to. Return
      * the completion status of the operation.
      *
-     * The method will throw exception std::logic_error if the header's
-     * content won't match expectations.
-     *
      * @param lock  - a lock on a mutex must be acquired before calling this method
      * @param buf   - the buffer to use
      * @param bytes - a expected length of the message (obtained from a preceeding frame)
      *                to be received into the network buffer from the network.
-     * @param id    - a unique identifier of a request to match the 'id' in a response header
+     * @param id    - the identifier of a request extracted from the response header
      *
      * @return the completion code of the operation
      */
-    boost::system::error_code syncReadVerifyHeader(util::Lock const& lock,
-                                                   ProtocolBuffer& buf,
-                                                   size_t bytes,
-                                                   std::string const& id);
+    boost::system::error_code syncReadHeader(util::Lock const& lock,
+                                             ProtocolBuffer& buf,
+                                             size_t bytes,
+                                             std::string& id);
 
     /**
      * Synchriniously read a message of a known size into the specified buffer.
@@ -501,7 +520,8 @@ private:
     std::string context() const;
 
     /**
-     * Find a request matching the specified identifier
+     * Find a request matching the specified identifier among the queued,
+     * the being sent and the in-flight (sent, but not yet answered) requests
      *
      * @param lock  - a lock on a mutex must be acquired before calling this method
      * @param id    - an identifier of the request
@@ -511,12 +531,24 @@ private:
     MessageWrapperBase::Ptr find(util::Lock const& lock,
                                  std::string const& id) const;
 
+    /**
+     * Extract all in-flight requests so that their owners could be notified
+     * about the failure. The responses to these requests are lost along with
+     * the connection when the communication gets restarted. The notifications
+     * must be sent by the caller after releasing the lock.
+     *
+     * @param lock  - a lock on a mutex must be acquired before calling this method
+     *
+     * @return the collection of the abandoned requests
+     */
+    std::list<MessageWrapperBase::Ptr> abandonInFlight(util::Lock const& lock);
+
 private:
 
     ServiceProvider::Ptr _serviceProvider;
 
-    /// Cached worker descriptor obtained from the configuration
-    WorkerInfo _workerInfo;
+    /// Worker descriptor shared via the configuration cache
+    std::shared_ptr<WorkerInfo const> _workerInfo;
 
     /// The cached parameter for the buffer sizes (pulled from
     /// the Configuration upon the construction of the object).
@@ -542,12 +574,28 @@ private:
     /// The queue (FIFO) of requests
     std::list<MessageWrapperBase::Ptr> _requests;
 
-    /// The currently processed (being sent) request (if any, otherwise
-    /// the pointer is set to nullptr)
-    MessageWrapperBase::Ptr _currentRequest;
+    /// The requests which are being written into the connection as a single
+    /// (possibly batched) operation. The collection is empty when no write
+    /// is in progress. Only one write operation is allowed at a time.
+    std::list<MessageWrapperBase::Ptr> _currentRequests;
+
+    /// The queue (FIFO) of in-flight requests - the ones which have been
+    /// fully sent to a worker and are awaiting their responses. Responses
+    /// are matched against this collection by the identifier found in
+    /// the response header.
+    std::list<MessageWrapperBase::Ptr> _inFlight;
+
+    /// The flag indicating if a response read operation is in progress.
+    /// Only one read operation is allowed at a time.
+    bool _readInProgress;
 
     /// The intermediate buffer for messages received from a worker
     ProtocolBuffer _inBuffer;
+
+    /// The buffer for serializing batch envelope headers. The buffer must
+    /// stay intact while an asynchronous write is in progress, hence it's
+    /// a member of the class.
+    ProtocolBuffer _batchHeaderBuffer;
 };
 
 }}} // namespace lsst::qserv::replica
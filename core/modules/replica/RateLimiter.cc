@@ -0,0 +1,87 @@
+/*
+ * LSST Data Management System
+ * Copyright 2017 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "replica/RateLimiter.h"
+
+// System headers
+#include <algorithm>
+
+// Qserv headers
+#include "replica/Performance.h"
+#include "util/BlockPost.h"
+
+namespace lsst {
+namespace qserv {
+namespace replica {
+
+RateLimiter::Ptr RateLimiter::create(size_t rateBytesSec) {
+    return RateLimiter::Ptr(
+        new RateLimiter(rateBytesSec));
+}
+
+RateLimiter::RateLimiter(size_t rateBytesSec)
+    :   _rateBytesSec(rateBytesSec),
+        _available(static_cast<double>(rateBytesSec)),
+        _updateTimeMs(PerformanceUtils::now()) {
+}
+
+void RateLimiter::consume(size_t numBytes) {
+
+    if ((_rateBytesSec == 0) or (numBytes == 0)) return;
+
+    int delayMs = 0;
+    {
+        util::Lock lock(_mtx, "RateLimiter::consume");
+
+        // Refill the bucket with tokens accumulated at the configured rate
+        // since the last update, while not allowing bursts longer than
+        // one second worth of the traffic.
+
+        uint64_t const now = PerformanceUtils::now();
+        _available = std::min(
+            static_cast<double>(_rateBytesSec),
+            _available + _rateBytesSec * (now - _updateTimeMs) / 1000.);
+        _updateTimeMs = now;
+
+        // Withdraw the tokens. The balance is allowed to go negative in order
+        // to permit withdrawals exceeding the capacity of the bucket. In that
+        // case the caller will be delayed until the deficit would be repaid
+        // at the configured rate.
+
+        _available -= static_cast<double>(numBytes);
+        if (_available < 0.) {
+            delayMs = static_cast<int>(1000. * (- _available) / _rateBytesSec);
+        }
+    }
+
+    // Sleep (if the balance went negative) without holding the mutex so that
+    // other threads could make their withdrawals and get their own delays
+    // computed in the meantime.
+
+    if (delayMs > 0) {
+        util::BlockPost blockPost(1, 2);    // the random interval is never used
+        blockPost.wait(delayMs);
+    }
+}
+
+}}} // namespace lsst::qserv::replica
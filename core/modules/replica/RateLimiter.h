@@ -0,0 +1,131 @@
+/*
+ * LSST Data Management System
+ * Copyright 2017 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_REPLICA_RATELIMITER_H
+#define LSST_QSERV_REPLICA_RATELIMITER_H
+
+/// RateLimiter.h declares:
+///
+/// class RateLimiter
+/// (see individual class documentation for more information)
+
+// System headers
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+// Qserv headers
+#include "util/Mutex.h"
+
+// This header declarations
+
+namespace lsst {
+namespace qserv {
+namespace replica {
+
+/**
+ * Class RateLimiter implements the token-bucket algorithm for pacing
+ * a class of traffic at a configured aggregate rate (bytes per second).
+ *
+ * The limiter is meant to be shared by all operations of the same traffic
+ * class within a process (for example, the file copy loops of the worker
+ * replication requests) so that the background replication traffic won't
+ * steal the disk and network bandwidth from the latency-sensitive activities
+ * (such as the shared scans of the Qserv worker) collocated on the same node.
+ *
+ * Callers withdraw tokens (bytes) from the bucket as they move data.
+ * The bucket is refilled at the configured rate and accumulates at most
+ * one second worth of traffic, which caps the burst size. Withdrawals
+ * exceeding the balance put the caller to sleep until the deficit would
+ * be repaid at the configured rate. The rate of 0 disables the limiter.
+ *
+ * THREAD SAFETY: the limiter is thread-safe.
+ */
+class RateLimiter {
+
+public:
+
+    /// The pointer type for instances of the class
+    typedef std::shared_ptr<RateLimiter> Ptr;
+
+    /**
+     * Static factory method is needed to prevent issue with the lifespan
+     * and memory management of instances created otherwise (as values or via
+     * low-level pointers).
+     *
+     * @param rateBytesSec - the maximum rate of the traffic class (bytes
+     *                       per second). The rate of 0 means 'unlimited'.
+     *
+     * @return pointer to the created object
+     */
+    static Ptr create(size_t rateBytesSec);
+
+    // Default construction and copy semantics are prohibited
+
+    RateLimiter() = delete;
+    RateLimiter(RateLimiter const&) = delete;
+    RateLimiter& operator=(RateLimiter const&) = delete;
+
+    ~RateLimiter() = default;
+
+    /// @return the maximum rate of the traffic class (bytes per second)
+    size_t rateBytesSec() const { return _rateBytesSec; }
+
+    /**
+     * Withdraw the specified number of bytes from the bucket. The method
+     * may block the calling thread to keep the aggregate traffic of all
+     * users of the limiter within the configured rate. The method returns
+     * immediately if the limiter was configured with the unlimited rate.
+     *
+     * @param numBytes - the number of bytes moved by the caller
+     */
+    void consume(size_t numBytes);
+
+private:
+
+    /**
+     * Construct the object
+     *
+     * @see RateLimiter::create()
+     */
+    explicit RateLimiter(size_t rateBytesSec);
+
+private:
+
+    /// The maximum rate of the traffic class (bytes per second).
+    /// The rate of 0 means 'unlimited'.
+    size_t _rateBytesSec;
+
+    /// The current balance of the bucket (bytes). The balance may
+    /// go negative after an oversized withdrawal, in which case the caller
+    /// is delayed until the deficit would be repaid at the configured rate.
+    double _available;
+
+    /// The timestamp (milliseconds) of the last refill of the bucket
+    uint64_t _updateTimeMs;
+
+    /// The mutex for enforcing thread safety of the operations
+    util::Mutex _mtx;
+};
+
+}}} // namespace lsst::qserv::replica
+
+#endif // LSST_QSERV_REPLICA_RATELIMITER_H
@@ -26,6 +26,8 @@
 // System headers
 #include <algorithm>
 #include <future>
+#include <list>
+#include <set>
 #include <stdexcept>
 
 // Qserv headers
@@ -80,6 +82,7 @@ Job::Options const& RebalanceJob::defaultOptions() {
 RebalanceJob::Ptr RebalanceJob::create(
                             std::string const& databaseFamily,
                             bool estimateOnly,
+                            bool optimalPlan,
                             Controller::Ptr const& controller,
                             std::string const& parentJobId,
                             CallbackType onFinish,
@@ -87,6 +90,7 @@ RebalanceJob::Ptr RebalanceJob::create(
     return RebalanceJob::Ptr(
         new RebalanceJob(databaseFamily,
                          estimateOnly,
+                         optimalPlan,
                          controller,
                          parentJobId,
                          onFinish,
@@ -95,6 +99,7 @@ RebalanceJob::Ptr RebalanceJob::create(
 
 RebalanceJob::RebalanceJob(std::string const& databaseFamily,
                            bool estimateOnly,
+                           bool optimalPlan,
                            Controller::Ptr const& controller,
                            std::string const& parentJobId,
                            CallbackType onFinish,
@@ -105,7 +110,9 @@ RebalanceJob::RebalanceJob(std::string const& databaseFamily,
             options),
         _databaseFamily(databaseFamily),
         _estimateOnly(estimateOnly),
-        _onFinish(onFinish) {
+        _optimalPlan(optimalPlan),
+        _onFinish(onFinish),
+        _numFailedLocks(0) {
 }
 
 RebalanceJob::~RebalanceJob() {
@@ -130,26 +137,11 @@ std::string RebalanceJob::extendedPersistentState(SqlGeneratorPtr const& gen) co
 
 void RebalanceJob::startImpl(util::Lock const& lock) {
 
-    LOGS(_log, LOG_LVL_DEBUG, context() << "startImpl  numIterations=" << _replicaData.numIterations);
-
-    _replicaData.numIterations++;
+    LOGS(_log, LOG_LVL_DEBUG, context() << "startImpl");
 
     // Launch the chained job to get chunk disposition
 
-    auto self = shared_from_base<RebalanceJob>();
-
-    bool const saveReplicInfo = true;           // always save the replica info in a database because
-                                                // the algorithm depends on it.
-    _findAllJob = FindAllJob::create(
-        databaseFamily(),
-        saveReplicInfo,
-        controller(),
-        id(),
-        [self] (FindAllJob::Ptr job) {
-            self->onPrecursorJobFinish();
-        }
-    );
-    _findAllJob->start();
+    submitDiscovery(lock);
 
     setState(lock, State::IN_PROGRESS);
 }
@@ -193,6 +185,7 @@ void RebalanceJob::restart(util::Lock const& lock) {
     }
 
     _moveReplicaJobs.clear();
+    _numFailedLocks = 0;
 
     // Take a fresh snapshot of chunk disposition within the cluster
     // to see what else can be rebalanced. Note that this is going to be
@@ -200,6 +193,21 @@ void RebalanceJob::restart(util::Lock const& lock) {
     // to be finished before the current job will get another chance
     // to rebalance (if needed).
 
+    submitDiscovery(lock);
+}
+
+void RebalanceJob::submitDiscovery(util::Lock const& lock) {
+
+    LOGS(_log, LOG_LVL_DEBUG, context() << "submitDiscovery  numIterations=" << _replicaData.numIterations);
+
+    _replicaData.numIterations++;
+
+    // Launch the chained job to get a (fresh) snapshot of chunk disposition
+    // within the cluster. Note that the discovery may run concurrently with
+    // replica movements launched for the previous snapshot. Chunks which are
+    // still being moved are protected by the chunk locks, so the planner
+    // will skip them when analyzing the new snapshot.
+
     auto self = shared_from_base<RebalanceJob>();
 
     bool const saveReplicInfo = true;           // always save the replica info in a database because
@@ -290,7 +298,7 @@ void RebalanceJob::onPrecursorJobFinish() {
         LOGS(_log, LOG_LVL_DEBUG, context() << "onPrecursorJobFinish:  "
              << "no eligible 'good' chunks found");
 
-        finish(lock, ExtendedState::SUCCESS);
+        onNothingToMove(lock);
         return;
     }
 
@@ -301,7 +309,7 @@ void RebalanceJob::onPrecursorJobFinish() {
              << "the average number of 'good' chunks per worker is 0. "
              << "This won't trigger the operation");
 
-        finish(lock, ExtendedState::SUCCESS);
+        onNothingToMove(lock);
         return;
     }
 
@@ -395,7 +403,7 @@ void RebalanceJob::onPrecursorJobFinish() {
         LOGS(_log, LOG_LVL_DEBUG, context() << "onPrecursorJobFinish:  "
              << "no overloaded 'source' workers found");
 
-        finish(lock, ExtendedState::SUCCESS);
+        onNothingToMove(lock);
         return;
     }
     std::sort(
@@ -407,6 +415,53 @@ void RebalanceJob::onPrecursorJobFinish() {
         }
     );
 
+    // In the cost-optimizing mode of the planner estimate the amount of data
+    // in each candidate chunk (as the sum of sizes of the replica's files
+    // accross all databases of the family as reported by the precursor job)
+    // and reorder chunks of each source worker so that the cheapest chunks
+    // would be picked for the moves first. The final distribution of a number
+    // of chunks per worker is the same in both modes of the planner, while
+    // the total amount of data pushed over the network is lower when moving
+    // the smallest chunks.
+
+    if (optimalPlan()) {
+
+        std::map<std::string,               // worker
+                 std::map<unsigned int,     // chunk
+                          uint64_t>> worker2chunkSize;
+
+        for (auto chunk: replicaData.chunks.chunkNumbers()) {
+            auto chunkMap = replicaData.chunks.chunk(chunk);
+
+            for (auto&& database: chunkMap.databaseNames()) {
+                auto databaseMap = chunkMap.database(database);
+
+                for (auto&& worker: databaseMap.workerNames()) {
+                    uint64_t& chunkSize = worker2chunkSize[worker][chunk];
+                    for (auto&& file: databaseMap.worker(worker).fileInfo()) {
+                        chunkSize += file.size;
+                    }
+                }
+            }
+        }
+        for (auto&& sourceWorkerEntry: sourceWorkers) {
+
+            auto const& chunk2size = worker2chunkSize[sourceWorkerEntry.first];
+            auto const  sizeOf     = [&chunk2size] (unsigned int chunk) -> uint64_t {
+                auto itr = chunk2size.find(chunk);
+                return itr == chunk2size.end() ? 0 : itr->second;
+            };
+            std::stable_sort(
+                sourceWorkerEntry.second.begin(),
+                sourceWorkerEntry.second.end(),
+                [&sizeOf] (unsigned int a,
+                           unsigned int b) {
+                    return sizeOf(a) < sizeOf(b);
+                }
+            );
+        }
+    }
+
     // Get a disposition of the destination workers along with the number
     // of available slots for chunks which can be hosted by the workers
     // before they'll hist the average. The number of good chunks on each
@@ -431,7 +486,7 @@ void RebalanceJob::onPrecursorJobFinish() {
         LOGS(_log, LOG_LVL_DEBUG, context() << "onPrecursorJobFinish:  "
              << "no underloaded 'destination' workers found");
 
-        finish(lock, ExtendedState::SUCCESS);
+        onNothingToMove(lock);
         return;
     }
 
@@ -522,14 +577,30 @@ void RebalanceJob::onPrecursorJobFinish() {
         return;
     }
 
-    // Finish right away if no badly unbalanced workers found to trigger
-    // the operation
+    // If no badly unbalanced workers were found to trigger the operation
+    // then wait for the in-flight movements (if any) or finish right away.
 
     if (_replicaData.plan.empty()) {
-        finish(lock, ExtendedState::SUCCESS);
+        onNothingToMove(lock);
         return;
     }
 
+    // Get rid of the movement jobs from the previous iterations which have
+    // already finished (their results were harvested by the completion
+    // handler). Only in-flight jobs are left to be tracked along with
+    // the new ones.
+
+    _moveReplicaJobs.erase(
+        std::remove_if(
+            _moveReplicaJobs.begin(),
+            _moveReplicaJobs.end(),
+            [] (MoveReplicaJob::Ptr const& ptr) {
+                return ptr->state() == Job::State::FINISHED;
+            }
+        ),
+        _moveReplicaJobs.end()
+    );
+
     // Now submit chunk movement requests for chunks which could be
     // locked.
     //
@@ -539,14 +610,23 @@ void RebalanceJob::onPrecursorJobFinish() {
 
     auto self = shared_from_base<RebalanceJob>();
 
-    size_t numFailedLocks = 0;
+    // Lock the chunks of the plan in a single bulk operation to avoid
+    // contention on the lock table with other concurrent jobs.
+
+    std::list<Chunk> chunks2lock;
+    for (auto&& chunkEntry: _replicaData.plan) {
+        chunks2lock.push_back(Chunk{databaseFamily(), chunkEntry.first});
+    }
+    std::set<unsigned int> lockedChunks;
+    for (auto&& chunk: controller()->serviceProvider()->chunkLocker().lock(chunks2lock, id())) {
+        lockedChunks.insert(chunk.number);
+    }
+    _numFailedLocks = chunks2lock.size() - lockedChunks.size();
 
     for (auto&& chunkEntry: _replicaData.plan) {
         unsigned int const chunk = chunkEntry.first;
-        if (not controller()->serviceProvider()->chunkLocker().lock({databaseFamily(), chunk}, id())) {
-            ++_numFailedLocks;
-            continue;
-        }
+        if (not lockedChunks.count(chunk)) continue;
+
         for (auto&& sourceWorkerEntry: chunkEntry.second) {
             std::string const& sourceWorker      = sourceWorkerEntry.first;
             std::string const& destinationWorker = sourceWorkerEntry.second;
@@ -569,19 +649,37 @@ void RebalanceJob::onPrecursorJobFinish() {
         }
     }
 
-    // Finish right away if no jobs were submitted and no failed attempts
-    // to lock chunks were encountered.
+    // Begin the next round of the chunk disposition discovery right away
+    // so that it runs concurrently with the movements just launched (and with
+    // any movements still in-flight since the previous iterations). The next
+    // plan will be built as soon as the discovery finishes without waiting
+    // for the movements to drain.
 
-    if (not _moveReplicaJobs.size()) {
-        if (not numFailedLocks) {
-            finish(lock, ExtendedState::SUCCESS);
-        } else {
+    submitDiscovery(lock);
+}
 
-            // Start another iteration by requesting the fresh state of
-            // chunks within the family or until it all fails.
+void RebalanceJob::onNothingToMove(util::Lock const& lock) {
 
-            restart(lock);
-        }
+    LOGS(_log, LOG_LVL_DEBUG, context() << "onNothingToMove");
+
+    // The latest snapshot hasn't yielded any (more) movements. If movements
+    // launched for the previous snapshots are still in-flight then wait for
+    // those to drain (the last of them will trigger a confirming discovery).
+    // Otherwise the cluster is quiescent and the job is complete.
+
+    size_t numLaunched;
+    size_t numFinished;
+    size_t numSuccess;
+
+    ::countJobStates(numLaunched,
+                     numFinished,
+                     numSuccess,
+                     _moveReplicaJobs);
+
+    if (numLaunched != numFinished) {
+        _findAllJob = nullptr;
+    } else {
+        finish(lock, ExtendedState::SUCCESS);
     }
 }
 
@@ -658,13 +756,16 @@ void RebalanceJob::onJobFinish(MoveReplicaJob::Ptr const& job) {
     if (numFinished == numLaunched) {
         if (numSuccess == numLaunched) {
 
-            // Make another iteration (and another one, etc. as many as needed)
-            // before it succeeds or fails.
+            // All movements have drained. If the next round of the chunk
+            // disposition discovery is already in-flight then its completion
+            // handler will do the planning. Otherwise launch a confirming
+            // discovery to make another iteration (and another one, etc.
+            // as many as needed) before the job succeeds or fails.
             //
             // NOTE: a condition for this jobs to succeed is evaluated in
             //       the precursor job completion code.
 
-            restart(lock);
+            if (_findAllJob == nullptr) restart(lock);
 
         } else {
             finish(lock, ExtendedState::FAILED);
@@ -135,6 +135,14 @@ struct RebalanceJobResult {
   * - [TO BE CONFIRMED] at a each iteration a limited number (from the Configuration?)
   *   of replicas will be processed. Then chunk disposition will be recomputed to adjust
   *   for other parallel activities (replication, purge, etc.).
+  *
+  * The iterations of the job are pipelined: as soon as a plan is built and
+  * the corresponding replica movements are launched the next round of the chunk
+  * disposition discovery begins right away instead of waiting for the movements
+  * to drain. Chunks which are still being moved are protected by the chunk
+  * locks, so the planner will skip them when analyzing the new snapshot and
+  * reconsider them on the next iteration. The job succeeds when a snapshot
+  * taken with no movements in-flight yields an empty plan.
   */
 class RebalanceJob
     :   public Job  {
@@ -157,6 +165,9 @@ public:
      *
      * @param databaseFamily - the name of a database family
      * @param estimateOnly   - do not perform any changes to chunk disposition. Just produce an estimate report.
+     * @param optimalPlan    - select the cost-optimizing planner which picks the cheapest
+     *                         (in terms of an amount of data to be transferred) chunks
+     *                         for the moves instead of taking chunks in an arbitrary order
      * @param controller     - for launching requests
      * @param parentJobId    - optional identifier of a parent job
      * @param onFinish       - a callback function to be called upon a completion of the job
@@ -167,6 +178,7 @@ public:
      */
     static Ptr create(std::string const& databaseFamily,
                       bool estimateOnly,
+                      bool optimalPlan,
                       Controller::Ptr const& controller,
                       std::string const& parentJobId,
                       CallbackType onFinish,
@@ -187,6 +199,9 @@ public:
     /// @return the estimate mode option
     bool estimateOnly() const { return _estimateOnly; }
 
+    /// @return the cost-optimizing planner option
+    bool optimalPlan() const { return _optimalPlan; }
+
     /**
      * Return the result of the operation.
      *
@@ -220,6 +235,7 @@ protected:
      */
     RebalanceJob(std::string const& databaseFamily,
                  bool estimateOnly,
+                 bool optimalPlan,
                  Controller::Ptr const& controller,
                  std::string const& parentJobId,
                  CallbackType onFinish,
@@ -257,12 +273,34 @@ protected:
     /**
      * Restart the job from scratch. This method will reset object context
      * to a state it was before method Job::startImpl() called and then call
-     * Job::startImpl() again.
+     * Job::startImpl() again. The method is only allowed when no discovery
+     * and no replica movements are in-flight.
      *
      * @param lock - the lock must be acquired by a caller of the method
      */
     void restart(util::Lock const& lock);
 
+    /**
+     * Launch the next round of the chunk disposition discovery (the precursor
+     * job). Unlike method restart() this one is also allowed while replica
+     * movements launched for the previous snapshot are still in-flight, in
+     * which case the discovery will run concurrently with the movements.
+     *
+     * @param lock - the lock must be acquired by a caller of the method
+     */
+    void submitDiscovery(util::Lock const& lock);
+
+    /**
+     * Evaluate the completion condition when the latest snapshot hasn't
+     * yielded any (more) replica movements. If movements launched for
+     * the previous snapshots are still in-flight then the method will wait
+     * for those to drain (the last of them will trigger a confirming
+     * discovery). Otherwise the job will be finished with SUCCESS.
+     *
+     * @param lock - the lock must be acquired by a caller of the method
+     */
+    void onNothingToMove(util::Lock const& lock);
+
     /**
      * Unconditionally release the specified chunk
      *
@@ -278,11 +316,15 @@ protected:
     /// Estimate mode option
     bool _estimateOnly;
 
+    /// Cost-optimizing planner option
+    bool _optimalPlan;
+
     /// Client-defined function to be called upon the completion of the job
     CallbackType _onFinish;
 
     /// The chained job to be completed first in order to figure out
-    /// replica disposition.
+    /// replica disposition. It's set to 'nullptr' when no discovery is
+    /// in-flight (while waiting for the movements to drain).
     FindAllJob::Ptr _findAllJob;
 
     /// The number of chunks which required to be moved but couldn't be locked
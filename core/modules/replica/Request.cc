@@ -34,6 +34,7 @@
 // Qserv headers
 #include "lsst/log/Log.h"
 #include "replica/Configuration.h"
+#include "replica/ConfigurationCache.h"
 #include "replica/Controller.h"
 #include "replica/ProtocolBuffer.h"
 #include "replica/ServiceProvider.h"
@@ -105,11 +106,10 @@ Request::Request(ServiceProvider::Ptr const& serviceProvider,
         _extendedState(NONE),
         _extendedServerStatus(ExtendedCompletionStatus::EXT_STATUS_NONE),
         _bufferPtr(new ProtocolBuffer(serviceProvider->config()->requestBufferSizeBytes())),
-        _workerInfo(serviceProvider->config()->workerInfo(worker)),
+        _workerInfo(serviceProvider->configCache()->workerInfo(worker)),
         _timerIvalSec(serviceProvider->config()->retryTimeoutSec()),
         _timer(io_service),
-        _requestExpirationIvalSec(serviceProvider->config()->controllerRequestTimeoutSec()),
-        _requestExpirationTimer(io_service) {
+        _requestExpirationIvalSec(serviceProvider->config()->controllerRequestTimeoutSec()) {
 
     _serviceProvider->assertWorkerIsValid(worker);
 }
@@ -166,14 +166,18 @@ void Request::start(std::shared_ptr<Controller> const& controller,
     _performance.setUpdateStart();
 
     if (_requestExpirationIvalSec) {
-        _requestExpirationTimer.cancel();
-        _requestExpirationTimer.expires_from_now(boost::posix_time::seconds(_requestExpirationIvalSec));
-        _requestExpirationTimer.async_wait(
-            boost::bind(
-                &Request::expired,
-                shared_from_this(),
-                boost::asio::placeholders::error
-            )
+        if (_expirationTimeout != nullptr) _expirationTimeout->cancel();
+
+        // The timeout holds a weak pointer so an abandoned request isn't
+        // kept alive until its nominal expiration just because the wheel
+        // still holds the cancelled entry.
+        std::weak_ptr<Request> request = shared_from_this();
+        _expirationTimeout = serviceProvider()->timerWheel()->schedule(
+            std::chrono::seconds(_requestExpirationIvalSec),
+            [request]() {
+                auto const ptr = request.lock();
+                if (ptr != nullptr) ptr->expired();
+            }
         );
     }
 
@@ -194,14 +198,9 @@ std::string const& Request::jobId() const {
     return _jobId;
 }
 
-void Request::expired(boost::system::error_code const& ec) {
+void Request::expired() {
 
-    LOGS(_log, LOG_LVL_DEBUG, context() << "expired"
-         << (ec == boost::asio::error::operation_aborted ? "  ** ABORTED **" : ""));
-
-    // Ignore this event if the timer was aborted
-
-    if (ec == boost::asio::error::operation_aborted) return;
+    LOGS(_log, LOG_LVL_DEBUG, context() << "expired");
 
     // IMPORTANT: the final state is required to be tested twice. The first time
     // it's done in order to avoid deadlock on the "in-flight" callbacks reporting
@@ -258,9 +257,9 @@ void Request::finish(util::Lock const& lock,
              FINISHED,
              extendedState);
 
-    // Stop the timer if the one is still running
+    // Stop the expiration timeout if the one is still pending
 
-    _requestExpirationTimer.cancel();
+    if (_expirationTimeout != nullptr) _expirationTimeout->cancel();
 
     // Let a subclass to run its own finalization if needed
 
@@ -42,6 +42,8 @@
 #include "replica/ProtocolBuffer.h"
 #include "replica/ServiceProvider.h"
 #include "util/Mutex.h"
+#include "util/ObjectCensus.h"
+#include "util/TimerWheel.h"
 
 // This header declarations
 
@@ -62,7 +64,8 @@ class Connection;
   * the master server.
   */
 class Request
-    :   public std::enable_shared_from_this<Request>  {
+    :   public std::enable_shared_from_this<Request>,
+        public util::CensusMember<Request>  {
 
 public:
 
@@ -349,13 +352,11 @@ protected:
     virtual void startImpl(util::Lock const& lock)=0;
 
     /**
-     * Request expiration timer's handler. The expiration interval (if any)
+     * Request expiration timeout's handler. The expiration interval (if any)
      * is configured via the configuraton service. When the request expires
      * it finishes with completion status FINISHED::TIMEOUT_EXPIRED.
-     *
-     * @param ec - error code to be checked
      */
-    void expired(boost::system::error_code const& ec);
+    void expired();
 
     /**
      * Finalize request processing (as reported by subclasses)
@@ -489,8 +490,9 @@ private:
     /// Buffer for data moved over the network
     std::shared_ptr<ProtocolBuffer> _bufferPtr;
 
-    /// Cached worker descriptor obtained from a configuration
-    WorkerInfo _workerInfo;
+    /// Worker descriptor shared via the configuration cache to avoid
+    /// copying the descriptor for each request
+    std::shared_ptr<WorkerInfo const> _workerInfo;
 
     /// This timer is used to in the communication protocol for requests
     /// which may require multiple retries or any time spacing between network
@@ -505,14 +507,17 @@ private:
     unsigned int                _timerIvalSec;
     boost::asio::deadline_timer _timer;
 
-    /// This timer is used (if configured) to limit the total run time
-    /// of a request. The timer starts when the request is started. And it's
-    /// explicitly finished when a request finishes (successfully or not).
+    /// This timeout is used (if configured) to limit the total run time
+    /// of a request. It is scheduled on the shared timer wheel (see
+    /// ServiceProvider::timerWheel()) when the request is started, and it's
+    /// explicitly cancelled when a request finishes (successfully or not).
+    /// The shared wheel keeps the per-request cost O(1) no matter how many
+    /// requests are in flight during a campaign.
     ///
-    /// If the time has a chance to expire then the request would finish
+    /// If the timeout has a chance to expire then the request would finish
     /// with status: FINISHED::TIMEOUT_EXPIRED.
-    unsigned int                _requestExpirationIvalSec;
-    boost::asio::deadline_timer _requestExpirationTimer;
+    unsigned int                   _requestExpirationIvalSec;
+    util::TimerWheel::Timeout::Ptr _expirationTimeout;
 
     /// The optional association with the Controller
     std::shared_ptr<Controller> _controller;
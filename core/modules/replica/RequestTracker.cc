@@ -24,10 +24,10 @@
 #include "replica/RequestTracker.h"
 
 // System headers
+#include <chrono>
 
 // Qserv headers
 #include "replica/Controller.h"
-#include "util/BlockPost.h"
 
 namespace lsst {
 namespace qserv {
@@ -52,10 +52,16 @@ void RequestTrackerBase::track() const {
 
     // Wait before all request are finished. Then analyze results
     // and print a report on failed requests (if any)
-
-    util::BlockPost blockPost(100, 200);
-    while (_numFinished < _numLaunched) {
-        blockPost.wait();
+    //
+    // The wait is driven by a condition variable notified by finishedOne(),
+    // so the last completion is seen immediately. The 1 second timeout only
+    // paces the progress reporting.
+
+    std::unique_lock<std::mutex> lock(_trackMtx);
+    while (not _trackCv.wait_for(
+                    lock,
+                    std::chrono::seconds(1),
+                    [this] () { return _numFinished >= _numLaunched; })) {
         if (_progressReport) {
             _os << "RequestTracker::track()  "
                 << "launched: " << _numLaunched << ", "
@@ -76,6 +82,15 @@ void RequestTrackerBase::track() const {
     }
 }
 
+void RequestTrackerBase::finishedOne(bool success) {
+    {
+        std::lock_guard<std::mutex> lock(_trackMtx);
+        _numFinished++;
+        if (success) _numSuccess++;
+    }
+    _trackCv.notify_all();
+}
+
 void RequestTrackerBase::cancel(bool propagateToServers) {
 
     auto onFinish     = nullptr;
@@ -152,10 +167,8 @@ AnyRequestTracker::AnyRequestTracker(std::ostream& os,
 }
 
 void AnyRequestTracker::onFinish(Request::Ptr const& ptr) {
-    RequestTrackerBase::_numFinished++;
-    if (ptr->extendedState() == Request::ExtendedState::SUCCESS) {
-        RequestTrackerBase::_numSuccess++;
-    }
+    RequestTrackerBase::finishedOne(
+        ptr->extendedState() == Request::ExtendedState::SUCCESS);
 }
 
 void AnyRequestTracker::add(Request::Ptr const& ptr) {
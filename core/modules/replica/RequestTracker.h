@@ -32,6 +32,8 @@
 
 // System headers
 #include <atomic>
+#include <condition_variable>
+#include <mutex>
 #include <ostream>
 #include <stdexcept>
 #include <string>
@@ -135,6 +137,15 @@ protected:
      */
     virtual void resetImpl()=0;
 
+    /**
+     * Count one more finished request and wake up a thread (if any) waiting
+     * within method track(). The method is invoked by the onFinish() methods
+     * of the subclasses from within the Controller's thread.
+     *
+     * @param success - the request finished with extended state SUCCESS
+     */
+    void finishedOne(bool success);
+
 protected:
 
     // The counter of requests which will be updated. They need to be atomic
@@ -151,6 +162,12 @@ private:
 
     bool _progressReport;
     bool _errorReport;
+
+    // For waking up a thread waiting within method track() the moment
+    // a request finishes instead of polling the counters.
+
+    mutable std::mutex _trackMtx;
+    mutable std::condition_variable _trackCv;
 };
 
 /**
@@ -196,10 +213,8 @@ public:
      * @param ptr - pointer to a completed request
      */
     void onFinish(typename T::Ptr ptr) {
-        RequestTrackerBase::_numFinished++;
-        if (ptr->extendedState() == Request::ExtendedState::SUCCESS) {
-            RequestTrackerBase::_numSuccess++;
-        }
+        RequestTrackerBase::finishedOne(
+            ptr->extendedState() == Request::ExtendedState::SUCCESS);
     }
 
     /**
@@ -30,8 +30,11 @@
 // Qserv headers
 #include "replica/ChunkLocker.h"
 #include "replica/Configuration.h"
+#include "replica/ConfigurationCache.h"
 #include "replica/DatabaseServices.h"
 #include "replica/QservMgtServices.h"
+#include "replica/RateLimiter.h"
+#include "util/TimerWheel.h"
 
 namespace lsst {
 namespace qserv {
@@ -47,8 +50,12 @@ ServiceProvider::Ptr ServiceProvider::create(std::string const& configUrl) {
 }
 
 ServiceProvider::ServiceProvider(std::string const& configUrl) {
-    _configuration    = Configuration::load(configUrl);
-    _databaseServices = DatabaseServices::create(_configuration);
+    _configuration      = Configuration::load(configUrl);
+    _configurationCache = ConfigurationCache::create(_configuration);
+    _databaseServices   = DatabaseServices::create(_configuration);
+    _diskRateLimiter    = RateLimiter::create(_configuration->workerDiskRateLimitBytesSec());
+    _netRateLimiter     = RateLimiter::create(_configuration->workerNetRateLimitBytesSec());
+    _timerWheel         = util::TimerWheel::newTimerWheel();
 }
 
 void ServiceProvider::assertWorkerIsValid(std::string const& name) {
@@ -37,14 +37,23 @@
 
 // This header declarations
 
+// Forward declarations
+namespace lsst {
+namespace qserv {
+namespace util {
+class TimerWheel;
+}}} // namespace lsst::qserv::util
+
 namespace lsst {
 namespace qserv {
 namespace replica {
 
 // Forward declarations
 class Configuration;
+class ConfigurationCache;
 class DatabaseServices;
 class QservMgtServices;
+class RateLimiter;
 
 /**
   * Class ServiceProvider hosts various serviceses for the master server.
@@ -59,9 +68,12 @@ public:
 
     // Forward definition for pointer types of the owned services
 
-    typedef std::shared_ptr<Configuration>    ConfigurationPtr;
-    typedef std::shared_ptr<DatabaseServices> DatabaseServicesPtr;
+    typedef std::shared_ptr<Configuration>      ConfigurationPtr;
+    typedef std::shared_ptr<ConfigurationCache> ConfigurationCachePtr;
+    typedef std::shared_ptr<DatabaseServices>   DatabaseServicesPtr;
     typedef std::shared_ptr<QservMgtServices> QservMgtServicesPtr;
+    typedef std::shared_ptr<RateLimiter>      RateLimiterPtr;
+    typedef std::shared_ptr<util::TimerWheel> TimerWheelPtr;
 
     // Default construction and copy semantics are prohibited
 
@@ -83,6 +95,10 @@ public:
     /// @return a reference to the configuration service
     ConfigurationPtr const& config() const { return _configuration; }
 
+    /// @return a reference to the versioned cache of the configuration
+    /// descriptors
+    ConfigurationCachePtr const& configCache() const { return _configurationCache; }
+
     /// @return a reference to the database services
     DatabaseServicesPtr const& databaseServices() const { return _databaseServices; }
 
@@ -92,6 +108,18 @@ public:
     /// @return a reference to the Qserv notification services
     QservMgtServicesPtr const& qservMgtServices() const { return _qservMgtServices; }
 
+    /// @return a reference to the rate limiter shared by the operations
+    /// reading input files from the local disks
+    RateLimiterPtr const& diskRateLimiter() const { return _diskRateLimiter; }
+
+    /// @return a reference to the rate limiter shared by the operations
+    /// pulling input files over the network
+    RateLimiterPtr const& netRateLimiter() const { return _netRateLimiter; }
+
+    /// @return a reference to the timer service shared by requests and jobs
+    /// for retry delays and expiration timeouts
+    TimerWheelPtr const& timerWheel() const { return _timerWheel; }
+
     /**
      * Make sure this worker is known in the configuration
      *
@@ -135,6 +163,10 @@ private:
     /// Configuration manager
     ConfigurationPtr _configuration;
 
+    /// The cache of the configuration descriptors shared by the clients
+    /// of the provider
+    ConfigurationCachePtr _configurationCache;
+
     /// Database services
     DatabaseServicesPtr _databaseServices;
 
@@ -144,6 +176,19 @@ private:
 
     /// Qserv management services
     QservMgtServicesPtr _qservMgtServices;
+
+    /// For pacing the local disk traffic of the replication operations
+    /// at the configured rate
+    RateLimiterPtr _diskRateLimiter;
+
+    /// For pacing the network traffic of the replication operations
+    /// at the configured rate
+    RateLimiterPtr _netRateLimiter;
+
+    /// The shared timer service. A hashed wheel keeps scheduling and
+    /// cancellation O(1) with very many outstanding timeouts, almost all
+    /// of which are cancelled before they fire.
+    TimerWheelPtr _timerWheel;
 };
 
 }}} // namespace lsst::qserv::replica
@@ -136,7 +136,8 @@ void SetReplicasQservMgtRequest::startImpl(util::Lock const& lock) {
         force(),
         [request] (wpublish::SetChunkListQservRequest::Status status,
                    std::string const& error,
-                   wpublish::SetChunkListQservRequest::ChunkCollection const& collection) {
+                   wpublish::SetChunkListQservRequest::ChunkCollection const& collection,
+                   uint64_t version) {
 
             // IMPORTANT: the final state is required to be tested twice. The first time
             // it's done in order to avoid deadlock on the "in-flight" callbacks reporting
@@ -31,6 +31,7 @@
 #include "lsst/log/Log.h"
 #include "replica/DatabaseMySQL.h"
 #include "replica/DatabaseServices.h"
+#include "replica/Performance.h"
 #include "replica/ServiceProvider.h"
 #include "util/BlockPost.h"
 
@@ -178,6 +179,8 @@ VerifyJob::Ptr VerifyJob::create(
                         CallbackTypeOnDiff onReplicaDifference,
                         size_t maxReplicas,
                         bool computeCheckSum,
+                        unsigned int samplePercent,
+                        uint64_t forceCheckSumAgeSec,
                         Job::Options const& options) {
     return VerifyJob::Ptr(
         new VerifyJob(controller,
@@ -186,6 +189,8 @@ VerifyJob::Ptr VerifyJob::create(
                       onReplicaDifference,
                       maxReplicas,
                       computeCheckSum,
+                      samplePercent,
+                      forceCheckSumAgeSec,
                       options));
 }
 
@@ -195,6 +200,8 @@ VerifyJob::VerifyJob(Controller::Ptr const& controller,
                      CallbackTypeOnDiff onReplicaDifference,
                      size_t maxReplicas,
                      bool computeCheckSum,
+                     unsigned int samplePercent,
+                     uint64_t forceCheckSumAgeSec,
                      Job::Options const& options)
     :   Job(controller,
             parentJobId,
@@ -203,7 +210,10 @@ VerifyJob::VerifyJob(Controller::Ptr const& controller,
         _onFinish(onFinish),
         _onReplicaDifference(onReplicaDifference),
         _maxReplicas(maxReplicas),
-        _computeCheckSum(computeCheckSum) {
+        _computeCheckSum(computeCheckSum),
+        _samplePercent(samplePercent > 100 ? 100 : samplePercent),
+        _forceCheckSumAgeSec(forceCheckSumAgeSec),
+        _random(std::random_device()()) {
 }
 
 std::string VerifyJob::extendedPersistentState(SqlGeneratorPtr const& gen) const {
@@ -216,8 +226,6 @@ void VerifyJob::startImpl(util::Lock const& lock) {
 
     LOGS(_log, LOG_LVL_DEBUG, context() << "startImpl");
 
-    auto self = shared_from_base<VerifyJob>();
-
     // Launch the first batch of requests
 
     std::vector<ReplicaInfo> replicas;
@@ -226,20 +234,9 @@ void VerifyJob::startImpl(util::Lock const& lock) {
                      maxReplicas())) {
 
         for (ReplicaInfo const& replica: replicas) {
-            auto request = controller()->findReplica(
-                replica.worker(),
-                replica.database(),
-                replica.chunk(),
-                [self] (FindRequest::Ptr request) {
-                    self->onRequestFinish(request);
-                },
-                options(lock).priority,     /* inherited from the one of the current job */
-                computeCheckSum(),
-                true,                       /* keepTracking*/
-                id()                        /* jobId */
-            );
-            _replicas[request->id()] = replica;
-            _requests[request->id()] = request;
+            launchRequest(lock,
+                          replica,
+                          requestCheckSum(replica));
         }
 
         setState(lock, State::IN_PROGRESS);
@@ -308,8 +305,6 @@ void VerifyJob::onRequestFinish(FindRequest::Ptr request) {
     ReplicaDiff              selfReplicaDiff;   // against the previous state of the current replica
     std::vector<ReplicaDiff> otherReplicaDiff;  // against other known replicas
 
-    auto self = shared_from_base<VerifyJob>();
-
     if (request->extendedState() == Request::ExtendedState::SUCCESS) {
 
         // TODO:
@@ -338,6 +333,21 @@ void VerifyJob::onRequestFinish(FindRequest::Ptr request) {
                  << selfReplicaDiff);
         }
 
+        // In the statistical mode a difference reported by the cheap
+        // metadata-only probe escalates to a full verification of the same
+        // replica with the check/control sums computed. The escalated
+        // request has the sums on, so it can't escalate again.
+
+        if (selfReplicaDiff() and computeCheckSum() and not request->computeCheckSum()) {
+            LOGS(_log, LOG_LVL_INFO, context() << "onRequestFinish  escalating to a full"
+                 << " verification, database: " << request->database()
+                 << " worker: " << request->worker()
+                 << " chunk: "  << request->chunk());
+            launchRequest(lock,
+                          oldReplica,
+                          true);
+        }
+
         std::vector<ReplicaInfo> otherReplicas;
         controller()->serviceProvider()->databaseServices()->findReplicas(
                                                                 otherReplicas,
@@ -374,20 +384,9 @@ void VerifyJob::onRequestFinish(FindRequest::Ptr request) {
                      1)) {
 
         for (ReplicaInfo const& replica: replicas) {
-            auto request = controller()->findReplica(
-                replica.worker(),
-                replica.database(),
-                replica.chunk(),
-                [self] (FindRequest::Ptr request) {
-                    self->onRequestFinish(request);
-                },
-                options(lock).priority, /* inherited from the one of the current job */
-                computeCheckSum(),
-                true,                   /* keepTracking*/
-                id()                    /* jobId */
-            );
-            _replicas[request->id()] = replica;
-            _requests[request->id()] = request;
+            launchRequest(lock,
+                          replica,
+                          requestCheckSum(replica));
         }
 
     } else {
@@ -424,4 +423,44 @@ bool VerifyJob::nextReplicas(util::Lock const& lock,
                                                                     numReplicas);
 }
 
+void VerifyJob::launchRequest(util::Lock const& lock,
+                              ReplicaInfo const& replica,
+                              bool checkSum) {
+
+    auto self = shared_from_base<VerifyJob>();
+
+    auto request = controller()->findReplica(
+        replica.worker(),
+        replica.database(),
+        replica.chunk(),
+        [self] (FindRequest::Ptr request) {
+            self->onRequestFinish(request);
+        },
+        options(lock).priority,     /* inherited from the one of the current job */
+        checkSum,
+        true,                       /* keepTracking*/
+        id()                        /* jobId */
+    );
+    _replicas[request->id()] = replica;
+    _requests[request->id()] = request;
+}
+
+bool VerifyJob::requestCheckSum(ReplicaInfo const& replica) {
+
+    if (not computeCheckSum()) return false;
+    if (samplePercent() >= 100) return true;
+
+    // Replicas not verified in full for longer than the age bound are never
+    // skipped by the sampling, so every replica still gets periodically
+    // re-hashed no matter how the dice roll.
+
+    if (forceCheckSumAgeSec() != 0) {
+        uint64_t const nowMs = PerformanceUtils::now();
+        uint64_t const ageBoundMs = forceCheckSumAgeSec() * 1000;
+        if ((replica.verifyTime() == 0) or
+            (nowMs > replica.verifyTime() + ageBoundMs)) return true;
+    }
+    return std::uniform_int_distribution<unsigned int>(0, 99)(_random) < samplePercent();
+}
+
 }}} // namespace lsst::qserv::replica
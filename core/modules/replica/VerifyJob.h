@@ -30,6 +30,7 @@
 
 // System headers
 #include <functional>
+#include <random>
 #include <string>
 
 // Qserv headers
@@ -174,6 +175,17 @@ public:
      *                              If the parameter is set to 0 (the default value) then 1 replica
      *                              will be assumed.
      * @param computeCheckSum     - (optional) tell a worker server to compute check/control sum on each file
+     * @param samplePercent       - (optional) percentage of the inspected replicas for which
+     *                              the check/control sums are computed (the statistical mode).
+     *                              The remaining replicas get the cheap metadata-only probe,
+     *                              and any of them found different is re-verified in full.
+     *                              The value of 100 (the default one) verifies every replica
+     *                              exhaustively. Has no effect unless 'computeCheckSum' is set.
+     * @param forceCheckSumAgeSec - (optional) the age (seconds since the last verification)
+     *                              beyond which a replica is always verified in full
+     *                              regardless of the sampling. The value of 0 (the default
+     *                              one) disables the age bound. Has no effect unless
+     *                              the statistical mode is on.
      * @param onFinish            - (optional) callback function to be called upon a completion of the job
      * @param options             - (optional) job options
      *
@@ -185,6 +197,8 @@ public:
                       CallbackTypeOnDiff onReplicaDifference,
                       size_t maxReplicas = 0,
                       bool computeCheckSum = false,
+                      unsigned int samplePercent = 100,
+                      uint64_t forceCheckSumAgeSec = 0,
                       Job::Options const& options=defaultOptions());
 
     // Default construction and copy semantics are prohibited
@@ -201,6 +215,14 @@ public:
     /// @return true if file check/control sums need to be recomputed
     bool computeCheckSum() const { return _computeCheckSum; }
 
+    /// @return percentage of the inspected replicas getting their check/control
+    /// sums computed (the statistical mode when less than 100)
+    unsigned int samplePercent() const { return _samplePercent; }
+
+    /// @return the age (seconds) beyond which a replica is always verified
+    /// in full in the statistical mode (0 if the age bound is disabled)
+    uint64_t forceCheckSumAgeSec() const { return _forceCheckSumAgeSec; }
+
     /**
      * @see Job::extendedPersistentState()
      */
@@ -219,6 +241,8 @@ protected:
               CallbackTypeOnDiff onReplicaDifference,
               size_t maxReplicas,
               bool computeCheckSum,
+              unsigned int samplePercent,
+              uint64_t forceCheckSumAgeSec,
               Job::Options const& options);
 
     /**
@@ -259,6 +283,31 @@ protected:
                       std::vector<ReplicaInfo>& replicas,
                       size_t numReplicas);
 
+    /**
+     * Launch a replica lookup request for the specified replica and register
+     * it within the job.
+     *
+     * @param lock     - the lock must be acquired by a caller of the method
+     * @param replica  - the replica to be inspected
+     * @param checkSum - tell a worker server to compute check/control sums
+     */
+    void launchRequest(util::Lock const& lock,
+                       ReplicaInfo const& replica,
+                       bool checkSum);
+
+    /**
+     * Decide if check/control sums should be requested for the specified
+     * replica. In the exhaustive mode the decision is simply the value of
+     * the 'computeCheckSum' parameter of the job. In the statistical mode
+     * replicas older than the age bound always get the sums computed, and
+     * the rest are sampled at the configured percentage.
+     *
+     * @param replica - the replica about to be inspected
+     *
+     * @return 'true' if the check/control sums should be computed
+     */
+    bool requestCheckSum(ReplicaInfo const& replica);
+
 protected:
 
     /// Client-defined function to be called upon the completion of the job
@@ -273,6 +322,17 @@ protected:
     /// This option will be passed on to the worker services
     bool _computeCheckSum;
 
+    /// Percentage of the inspected replicas getting their check/control sums
+    /// computed (the statistical mode when less than 100)
+    unsigned int _samplePercent;
+
+    /// The age (seconds) beyond which a replica is always verified in full
+    /// in the statistical mode (0 if the age bound is disabled)
+    uint64_t _forceCheckSumAgeSec;
+
+    /// Pseudo-random generator driving the sampling (the statistical mode)
+    std::mt19937 _random;
+
     /// The current (last) batch if replicas which are being inspected.
     /// The replicas are registered by the corresponding request IDs.
     std::map<std::string, ReplicaInfo> _replicas;
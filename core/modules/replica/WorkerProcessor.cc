@@ -124,13 +124,24 @@ WorkerProcessor::WorkerProcessor(ServiceProvider::Ptr const& serviceProvider,
         _requestFactory(requestFactory),
         _worker(worker),
         _state(STATE_IS_STOPPED),
-        _startTime(PerformanceUtils::now()) {
+        _startTime(PerformanceUtils::now()),
+        _journal(serviceProvider->config()->workerInfo(worker).dataDir +
+                 "/qserv-replica-requests.journal"),
+        _journalReplayed(false) {
 }
 
 void WorkerProcessor::run() {
 
     LOGS(_log, LOG_LVL_DEBUG, context() << "run");
 
+    // Replay the journal before committing to the running state so that
+    // requests accepted before the last restart of the service would get
+    // re-enqueued ahead of any new arrivals. Note that this has to be done
+    // before acquiring the lock because the replay goes through the regular
+    // (locking) registration methods.
+
+    replayJournal();
+
     util::Lock lock(_mtx, context() + "run");
 
     if (_state == STATE_IS_STOPPED) {
@@ -196,6 +207,66 @@ void WorkerProcessor::drain() {
     for (auto&& id: ids) dequeueOrCancelImpl(lock, id);
 }
 
+void WorkerProcessor::replayJournal() {
+
+    if (_journalReplayed.exchange(true)) return;
+
+    LOGS(_log, LOG_LVL_DEBUG, context() << "replayJournal");
+
+    _journal.replay(
+        [this] (proto::ReplicationRequestJournalRecord const& record) {
+
+            // Re-enqueue the request through the regular registration
+            // methods. This would also re-journal the request. The responses
+            // are thrown away because the original clients are gone. It's up
+            // to a controller to poll for statuses of the restored requests.
+
+            switch (record.replica_type()) {
+
+                case proto::ReplicationReplicaRequestType::REPLICA_CREATE: {
+                    proto::ReplicationRequestReplicate request;
+                    if (not request.ParseFromString(record.request())) break;
+                    proto::ReplicationResponseReplicate response;
+                    enqueueForReplication(record.id(), request, response);
+                    break;
+                }
+                case proto::ReplicationReplicaRequestType::REPLICA_DELETE: {
+                    proto::ReplicationRequestDelete request;
+                    if (not request.ParseFromString(record.request())) break;
+                    proto::ReplicationResponseDelete response;
+                    enqueueForDeletion(record.id(), request, response);
+                    break;
+                }
+                case proto::ReplicationReplicaRequestType::REPLICA_FIND: {
+                    proto::ReplicationRequestFind request;
+                    if (not request.ParseFromString(record.request())) break;
+                    proto::ReplicationResponseFind response;
+                    enqueueForFind(record.id(), request, response);
+                    break;
+                }
+                case proto::ReplicationReplicaRequestType::REPLICA_FIND_ALL: {
+                    proto::ReplicationRequestFindAll request;
+                    if (not request.ParseFromString(record.request())) break;
+                    proto::ReplicationResponseFindAll response;
+                    enqueueForFindAll(record.id(), request, response);
+                    break;
+                }
+                case proto::ReplicationReplicaRequestType::REPLICA_ECHO: {
+                    proto::ReplicationRequestEcho request;
+                    if (not request.ParseFromString(record.request())) break;
+                    proto::ReplicationResponseEcho response;
+                    enqueueForEcho(record.id(), request, response);
+                    break;
+                }
+                default:
+                    LOGS(_log, LOG_LVL_WARN, context() << "replayJournal"
+                         << "  ignoring a record of an unsupported type, id: " << record.id());
+                    break;
+            }
+        }
+    );
+}
+
 void WorkerProcessor::enqueueForReplication(
                             std::string const& id,
                             proto::ReplicationRequestReplicate const& request,
@@ -233,6 +304,7 @@ void WorkerProcessor::enqueueForReplication(
             request.worker()
         );
         _newRequests.push(ptr);
+        _journal.accepted(id, proto::ReplicationReplicaRequestType::REPLICA_CREATE, request);
 
         response.set_status(proto::ReplicationStatus::QUEUED);
         response.set_status_ext(proto::ReplicationStatusExt::NONE);
@@ -283,6 +355,7 @@ void WorkerProcessor::enqueueForDeletion(std::string const& id,
             request.chunk()
         );
         _newRequests.push(ptr);
+        _journal.accepted(id, proto::ReplicationReplicaRequestType::REPLICA_DELETE, request);
 
         response.set_status(proto::ReplicationStatus::QUEUED);
         response.set_status_ext(proto::ReplicationStatusExt::NONE);
@@ -324,6 +397,7 @@ void WorkerProcessor::enqueueForFind(std::string const& id,
             request.compute_cs()
         );
         _newRequests.push(ptr);
+        _journal.accepted(id, proto::ReplicationReplicaRequestType::REPLICA_FIND, request);
     
         response.set_status(proto::ReplicationStatus::QUEUED);
         response.set_status_ext(proto::ReplicationStatusExt::NONE);
@@ -361,6 +435,7 @@ void WorkerProcessor::enqueueForFindAll(std::string const& id,
             request.database()
         );
         _newRequests.push(ptr);
+        _journal.accepted(id, proto::ReplicationReplicaRequestType::REPLICA_FIND_ALL, request);
     
         response.set_status(proto::ReplicationStatus::QUEUED);
         response.set_status_ext(proto::ReplicationStatusExt::NONE);
@@ -417,6 +492,7 @@ void WorkerProcessor::enqueueForEcho(std::string const& id,
             request.delay()
         );
         _newRequests.push(ptr);
+        _journal.accepted(id, proto::ReplicationReplicaRequestType::REPLICA_ECHO, request);
     
         response.set_status(proto::ReplicationStatus::QUEUED);
         response.set_status_ext(proto::ReplicationStatusExt::NONE);
@@ -455,6 +531,7 @@ WorkerRequest::Ptr WorkerProcessor::dequeueOrCancelImpl(util::Lock const& lock,
 
                     _newRequests.remove(id);
                     _finishedRequests.push_back(ptr);
+                    _journal.finished(id, proto::ReplicationStatus::CANCELLED);
 
                     return ptr;
 
@@ -808,6 +885,7 @@ void WorkerProcessor::processingFinished(WorkerRequest::Ptr const& request) {
         }
     );
     _finishedRequests.push_back(request);
+    _journal.finished(request->id(), translate(request->status()));
 }
 
 void WorkerProcessor::processorThreadStopped(
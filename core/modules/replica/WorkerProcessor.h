@@ -30,6 +30,7 @@
 
 // System headers
 #include <algorithm>
+#include <atomic>
 #include <list>
 #include <memory>
 #include <queue>
@@ -42,6 +43,7 @@
 #include "replica/ServiceProvider.h"
 #include "replica/WorkerProcessorThread.h"
 #include "replica/WorkerRequest.h"
+#include "replica/WorkerRequestJournal.h"
 #include "util/Mutex.h"
 
 // This header declarations
@@ -514,6 +516,16 @@ private:
      */
     void processingRefused(WorkerRequest::Ptr const& request);
 
+    /**
+     * Replay the write-ahead journal of the requests.
+     *
+     * Requests which had been accepted before the last restart of the service,
+     * but hadn't reached their terminal states get re-enqueued for processing.
+     * The method is called on the first invocation of method run() and does
+     * nothing afterwards.
+     */
+    void replayJournal();
+
     /**
      * Report a request which has been processed or cancelled.
      *
@@ -571,6 +583,15 @@ private:
 
     /// Completed (succeeded or otherwise) requests
     CollectionType _finishedRequests;
+
+    /// The write-ahead journal of the accepted requests and their terminal
+    /// states. The journal is replayed on the first invocation of run() so
+    /// that requests which hadn't finished before a restart of the service
+    /// get re-enqueued instead of being lost.
+    WorkerRequestJournal _journal;
+
+    /// The flag ensuring the one-time replay of the journal
+    std::atomic<bool> _journalReplayed;
 };
 
 }}} // namespace lsst::qserv::replica
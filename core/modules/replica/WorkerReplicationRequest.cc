@@ -24,9 +24,14 @@
 #include "replica/WorkerReplicationRequest.h"
 
 // System headers
+#include <algorithm>
+#include <atomic>
 #include <cerrno>
 #include <cstring>
+#include <memory>
+#include <mutex>
 #include <stdexcept>
+#include <thread>
 
 // Qserv headers
 #include "lsst/log/Log.h"
@@ -34,6 +39,7 @@
 #include "replica/FileClient.h"
 #include "replica/FileUtils.h"
 #include "replica/Performance.h"
+#include "replica/RateLimiter.h"
 #include "replica/ServiceProvider.h"
 
 namespace fs = boost::filesystem;
@@ -42,6 +48,16 @@ namespace {
 
 LOG_LOGGER _log = LOG_GET("lsst.qserv.replica.WorkerReplicationRequest");
 
+/// Files of at least this size are copied via the striped protocol which
+/// spreads the transfer over several parallel connections and can resume
+/// an interrupted attempt, see WorkerReplicationRequestFS::stripedTransfer().
+// TODO: add to the Configuration
+size_t const stripedSizeThresholdBytes = 1024*1024*1024;
+
+/// The number of parallel connections used by a striped copy
+// TODO: add to the Configuration
+size_t const numTransferStripes = 4;
+
 } /// namespace
 
 namespace lsst {
@@ -229,6 +245,7 @@ bool WorkerReplicationRequestPOSIX::execute () {
     std::map<std::string,fs::path> file2outFile;
 
     std::map<fs::path,std::time_t> inFile2mtime;
+    std::map<fs::path,uintmax_t>   inFile2size;
 
     for (auto&& file: files) {
 
@@ -268,13 +285,15 @@ bool WorkerReplicationRequestPOSIX::execute () {
                         ExtendedCompletionStatus::EXT_STATUS_NO_FILE,
                         "the input file does not exist: " + file.string());
 
-            totalBytes += fs::file_size(file, ec);
+            inFile2size[file] = fs::file_size(file, ec);
             errorContext = errorContext
                 or reportErrorIf(
                         ec.value() != 0,
                         ExtendedCompletionStatus::EXT_STATUS_FILE_SIZE,
                         "failed to get the size of input file: " + file.string());
 
+            totalBytes += inFile2size[file];
+
             inFile2mtime[file] = fs::last_write_time(file, ec);
             errorContext = errorContext
                 or reportErrorIf(
@@ -362,6 +381,13 @@ bool WorkerReplicationRequestPOSIX::execute () {
         fs::path const inFile  = file2inFile [file];
         fs::path const tmpFile = file2tmpFile[file];
 
+        // Pace the copy at the configured disk read rate (if any) so that
+        // the replication traffic won't compete with the latency-sensitive
+        // activities (such as the shared scans) for the same spindles.
+        // The granularity of the pacing is one file.
+
+        _serviceProvider->diskRateLimiter()->consume(inFile2size[inFile]);
+
         fs::copy_file(inFile, tmpFile, ec);
         errorContext = errorContext
             or reportErrorIf(
@@ -517,21 +543,17 @@ bool WorkerReplicationRequestFS::execute () {
 
         fs::path const outDir = fs::path(_outWorkerInfo.dataDir) / database();
 
-        std::vector<fs::path> tmpFiles;
-        std::vector<fs::path> outFiles;
-
         for (auto&& file: _files) {
 
             fs::path const tmpFile = outDir / ("_" + file);
-            tmpFiles.push_back(tmpFile);
-
             fs::path const outFile = outDir / file;
-            outFiles.push_back(outFile);
 
             _file2descr[file].inSizeBytes       = 0;
             _file2descr[file].outSizeBytes      = 0;
             _file2descr[file].mtime             = 0;
             _file2descr[file].cs                = 0;
+            _file2descr[file].hasStaleCopy      = false;
+            _file2descr[file].hasPartialCopy    = false;
             _file2descr[file].tmpFile           = tmpFile;
             _file2descr[file].outFile           = outFile;
             _file2descr[file].beginTransferTime = 0;
@@ -588,40 +610,53 @@ bool WorkerReplicationRequestFS::execute () {
                         ExtendedCompletionStatus::EXT_STATUS_NO_FOLDER,
                         "the output directory doesn't exist: " + outDir.string());
 
-            // The files with canonical(!) names should NOT exist at the destination
-            // folder.
+            // The files with canonical(!) names found at the destination folder
+            // are (possibly stale) copies left by a former replica. They're not
+            // an error for this implementation. Such files will be refreshed
+            // via the incremental (delta) protocol which only transfers
+            // the blocks which differ from the input files.
 
-            for (auto&& file: outFiles) {
-                fs::file_status const stat = fs::status(file, ec);
+            for (auto&& file: _files) {
+                fs::file_status const stat = fs::status(_file2descr[file].outFile, ec);
                 errorContext = errorContext
                     or reportErrorIf(
                             stat.type() == fs::status_error,
                             ExtendedCompletionStatus::EXT_STATUS_FILE_STAT,
-                            "failed to check the status of output file: " + file.string())
-                    or reportErrorIf(
-                            fs::exists(stat),
-                            ExtendedCompletionStatus::EXT_STATUS_FILE_EXISTS,
-                            "the output file already exists: " + file.string());
+                            "failed to check the status of output file: " +
+                            _file2descr[file].outFile.string());
+
+                if (fs::exists(stat)) {
+                    _file2descr[file].hasStaleCopy = true;
+                }
             }
 
             // Check if there are any files with the temporary names at the destination
-            // folder and if so then get rid of them.
+            // folder and if so then get rid of them. The exception is a leftover
+            // of an interrupted attempt at a file large enough for the striped
+            // protocol: such a file is kept as the checkpoint, and only the blocks
+            // it's missing will be re-sent.
 
-            for (auto&& file: tmpFiles) {
-                fs::file_status const stat = fs::status(file, ec);
+            for (auto&& file: _files) {
+                fs::path const tmpFile = _file2descr[file].tmpFile;
+                fs::file_status const stat = fs::status(tmpFile, ec);
                 errorContext = errorContext
                     or reportErrorIf(
                             stat.type() == fs::status_error,
                             ExtendedCompletionStatus::EXT_STATUS_FILE_STAT,
-                            "failed to check the status of temporary file: " + file.string());
+                            "failed to check the status of temporary file: " + tmpFile.string());
 
                 if (fs::exists(stat)) {
-                    fs::remove(file, ec);
+                    if (not _file2descr[file].hasStaleCopy
+                        and (_file2descr[file].inSizeBytes >= stripedSizeThresholdBytes)) {
+                        _file2descr[file].hasPartialCopy = true;
+                        continue;
+                    }
+                    fs::remove(tmpFile, ec);
                     errorContext = errorContext
                         or reportErrorIf(
                                 ec.value() != 0,
                                 ExtendedCompletionStatus::EXT_STATUS_FILE_DELETE,
-                                "failed to remove temporary file: " + file.string());
+                                "failed to remove temporary file: " + tmpFile.string());
                 }
             }
 
@@ -643,9 +678,17 @@ bool WorkerReplicationRequestFS::execute () {
 
             // Precreate temporary files with the final size to assert disk space
             // availability before filling these files with the actual payload.
+            //
+            // NOTE: the files to be refreshed via the delta protocol are skipped
+            //       here because their temporary files will be created by copying
+            //       the stale local files. The files to be resumed by the striped
+            //       protocol are skipped because truncating their temporary files
+            //       would lose the checkpoint.
 
             for (auto&& file: _files) {
 
+                if (_file2descr[file].hasStaleCopy or _file2descr[file].hasPartialCopy) continue;
+
                 fs::path const tmpFile = _file2descr[file].tmpFile;
 
                 // Create a file of size 0
@@ -704,6 +747,13 @@ bool WorkerReplicationRequestFS::execute () {
         try {
             num = _inFilePtr->read(_buf, _bufSize);
             if (num) {
+
+                // Pace the transfer at the configured network rate (if any)
+                // so that the replication traffic won't compete with Qserv
+                // for the shared network links.
+
+                _serviceProvider->netRateLimiter()->consume(num);
+
                 if (num == std::fwrite(_buf, sizeof(uint8_t), num, _tmpFilePtr)) {
 
                     // Update the descriptor (the number of bytes copied so far
@@ -777,6 +827,461 @@ bool WorkerReplicationRequestFS::execute () {
     return finalize(lock);
 }
 
+bool WorkerReplicationRequestFS::deltaTransfer(util::Lock const& lock) {
+
+    LOGS(_log, LOG_LVL_DEBUG, context() << "deltaTransfer"
+         << "  sourceWorker: " << sourceWorker()
+         << "  database: "     << database()
+         << "  chunk: "        << chunk()
+         << "  file: "         << *_fileItr);
+
+    WorkerRequest::ErrorContext errorContext;
+    boost::system::error_code   ec;
+
+    std::string const file  = *_fileItr;
+    FileDescr&        descr = _file2descr[file];
+
+    descr.beginTransferTime = PerformanceUtils::now();
+
+    size_t const blockSize = FileUtils::DEFAULT_BLOCK_SIZE_BYTES;
+
+    // Compute the block digests of the stale local copy
+
+    std::vector<uint64_t> localDigests;
+    try {
+        localDigests = FileUtils::blockDigests(descr.outFile.string(), blockSize);
+    } catch (std::exception const& ex) {
+        errorContext = errorContext
+            or reportErrorIf(
+                true,
+                ExtendedCompletionStatus::EXT_STATUS_FILE_READ,
+                "failed to compute the block digests of local file: " + descr.outFile.string() +
+                ", error: " + std::string(ex.what()));
+    }
+    if (errorContext.failed) {
+        setStatus(lock, STATUS_FAILED, errorContext.extendedStatus);
+        return false;
+    }
+
+    // Fetch the block digests of the input file from the remote server
+
+    FileClient::Ptr remote = FileClient::digests(_serviceProvider,
+                                                 _inWorkerInfo.name,
+                                                 _databaseInfo.name,
+                                                 file,
+                                                 blockSize);
+    errorContext = errorContext
+        or reportErrorIf(
+            not remote,
+            ExtendedCompletionStatus::EXT_STATUS_FILE_ROPEN,
+            "failed to open input file on remote worker: " + _inWorkerInfo.name +
+            ", database: " + _databaseInfo.name +
+            ", file: " + file);
+
+    if (errorContext.failed) {
+        setStatus(lock, STATUS_FAILED, errorContext.extendedStatus);
+        return false;
+    }
+    descr.inSizeBytes = remote->size();
+    descr.mtime       = remote->mtime();
+
+    // Identify the blocks to be transferred: the ones whose control sums
+    // differ, plus the ones appended past the end of the local copy.
+
+    std::vector<uint64_t> const& remoteDigests = remote->blockDigests();
+
+    std::vector<uint64_t> blocks;
+    for (size_t i = 0; i < remoteDigests.size(); ++i) {
+        if ((i >= localDigests.size()) or (localDigests[i] != remoteDigests[i])) {
+            blocks.push_back(i);
+        }
+    }
+    LOGS(_log, LOG_LVL_DEBUG, context() << "deltaTransfer"
+         << "  file: " << file
+         << "  blocks total: "   << remoteDigests.size()
+         << "  blocks changed: " << blocks.size());
+
+    // Build the temporary file from the local copy resized to match
+    // the input file.
+
+    fs::copy_file(descr.outFile, descr.tmpFile, fs::copy_option::overwrite_if_exists, ec);
+    errorContext = errorContext
+        or reportErrorIf(
+                ec.value() != 0,
+                ExtendedCompletionStatus::EXT_STATUS_FILE_COPY,
+                "failed to copy file: " + descr.outFile.string() +
+                " into: " + descr.tmpFile.string());
+
+    if (not errorContext.failed) {
+        fs::resize_file(descr.tmpFile, descr.inSizeBytes, ec);
+        errorContext = errorContext
+            or reportErrorIf(
+                    ec.value() != 0,
+                    ExtendedCompletionStatus::EXT_STATUS_FILE_RESIZE,
+                    "failed to resize the temporary file: " + descr.tmpFile.string());
+    }
+    if (errorContext.failed) {
+        setStatus(lock, STATUS_FAILED, errorContext.extendedStatus);
+        return false;
+    }
+
+    // Transfer the changed blocks (if any) and patch them into the temporary
+    // file at their offsets.
+
+    if (not blocks.empty()) {
+
+        FileClient::Ptr inFilePtr = FileClient::openBlocks(_serviceProvider,
+                                                           _inWorkerInfo.name,
+                                                           _databaseInfo.name,
+                                                           file,
+                                                           blockSize,
+                                                           blocks);
+        errorContext = errorContext
+            or reportErrorIf(
+                not inFilePtr,
+                ExtendedCompletionStatus::EXT_STATUS_FILE_ROPEN,
+                "failed to open input file on remote worker: " + _inWorkerInfo.name +
+                ", database: " + _databaseInfo.name +
+                ", file: " + file);
+
+        std::FILE* tmpFilePtr = nullptr;
+        if (not errorContext.failed) {
+            tmpFilePtr = std::fopen(descr.tmpFile.string().c_str(), "rb+");
+            errorContext = errorContext
+                or reportErrorIf(
+                    not tmpFilePtr,
+                    ExtendedCompletionStatus::EXT_STATUS_FILE_OPEN,
+                    "failed to open temporary file: " + descr.tmpFile.string() +
+                    ", error: " + std::strerror(errno));
+        }
+        if (not errorContext.failed) {
+            try {
+                for (auto&& block: blocks) {
+
+                    size_t const offset = block * blockSize;
+                    size_t bytesLeft    = std::min(blockSize, descr.inSizeBytes - offset);
+
+                    std::fseek(tmpFilePtr, static_cast<long>(offset), SEEK_SET);
+
+                    while (bytesLeft != 0) {
+                        size_t const num = inFilePtr->read(_buf, std::min(_bufSize, bytesLeft));
+                        if (not num) break;
+
+                        // Pace the transfer at the configured network rate (if any)
+                        _serviceProvider->netRateLimiter()->consume(num);
+
+                        if (num != std::fwrite(_buf, sizeof(uint8_t), num, tmpFilePtr)) {
+                            errorContext = errorContext
+                                or reportErrorIf(
+                                    true,
+                                    ExtendedCompletionStatus::EXT_STATUS_FILE_WRITE,
+                                    "failed to write into temporary file: " + descr.tmpFile.string() +
+                                    ", error: " + std::strerror(errno));
+                            break;
+                        }
+                        bytesLeft -= num;
+                    }
+                    errorContext = errorContext
+                        or reportErrorIf(
+                            bytesLeft != 0,
+                            ExtendedCompletionStatus::EXT_STATUS_FILE_READ,
+                            "short read of the input file from remote worker: " + _inWorkerInfo.name +
+                            ", database: " + _databaseInfo.name +
+                            ", file: " + file);
+
+                    if (errorContext.failed) break;
+                }
+            } catch (FileClientError const& ex) {
+                errorContext = errorContext
+                    or reportErrorIf(
+                        true,
+                        ExtendedCompletionStatus::EXT_STATUS_FILE_READ,
+                        "failed to read input file from remote worker: " + _inWorkerInfo.name +
+                        ", database: " + _databaseInfo.name +
+                        ", file: " + file);
+            }
+        }
+        if (tmpFilePtr) {
+            std::fflush(tmpFilePtr);
+            std::fclose(tmpFilePtr);
+        }
+        if (errorContext.failed) {
+            setStatus(lock, STATUS_FAILED, errorContext.extendedStatus);
+            return false;
+        }
+    }
+
+    // Recompute the control sum over the whole patched file because
+    // the unchanged blocks never pass through the record buffer.
+
+    try {
+        descr.cs = FileUtils::compute_cs(descr.tmpFile.string());
+    } catch (std::exception const& ex) {
+        errorContext = errorContext
+            or reportErrorIf(
+                true,
+                ExtendedCompletionStatus::EXT_STATUS_FILE_READ,
+                "failed to compute the control sum of temporary file: " + descr.tmpFile.string() +
+                ", error: " + std::string(ex.what()));
+    }
+    if (errorContext.failed) {
+        setStatus(lock, STATUS_FAILED, errorContext.extendedStatus);
+        return false;
+    }
+    descr.outSizeBytes    = descr.inSizeBytes;
+    descr.endTransferTime = PerformanceUtils::now();
+
+    updateInfo(lock);
+
+    return true;
+}
+
+bool WorkerReplicationRequestFS::stripedTransfer(util::Lock const& lock) {
+
+    LOGS(_log, LOG_LVL_DEBUG, context() << "stripedTransfer"
+         << "  sourceWorker: " << sourceWorker()
+         << "  database: "     << database()
+         << "  chunk: "        << chunk()
+         << "  file: "         << *_fileItr);
+
+    WorkerRequest::ErrorContext errorContext;
+    boost::system::error_code   ec;
+
+    std::string const file  = *_fileItr;
+    FileDescr&        descr = _file2descr[file];
+
+    descr.beginTransferTime = PerformanceUtils::now();
+
+    size_t const blockSize = FileUtils::DEFAULT_BLOCK_SIZE_BYTES;
+
+    // Compute the block digests of the checkpoint (the temporary file left
+    // behind by an interrupted attempt) if the one was found. Otherwise
+    // every block of the input file is to be transferred.
+
+    std::vector<uint64_t> localDigests;
+    if (descr.hasPartialCopy) {
+        try {
+            localDigests = FileUtils::blockDigests(descr.tmpFile.string(), blockSize);
+        } catch (std::exception const& ex) {
+            errorContext = errorContext
+                or reportErrorIf(
+                    true,
+                    ExtendedCompletionStatus::EXT_STATUS_FILE_READ,
+                    "failed to compute the block digests of temporary file: " + descr.tmpFile.string() +
+                    ", error: " + std::string(ex.what()));
+        }
+        if (errorContext.failed) {
+            setStatus(lock, STATUS_FAILED, errorContext.extendedStatus);
+            return false;
+        }
+    }
+
+    // Fetch the block digests of the input file from the remote server
+
+    FileClient::Ptr remote = FileClient::digests(_serviceProvider,
+                                                 _inWorkerInfo.name,
+                                                 _databaseInfo.name,
+                                                 file,
+                                                 blockSize);
+    errorContext = errorContext
+        or reportErrorIf(
+            not remote,
+            ExtendedCompletionStatus::EXT_STATUS_FILE_ROPEN,
+            "failed to open input file on remote worker: " + _inWorkerInfo.name +
+            ", database: " + _databaseInfo.name +
+            ", file: " + file);
+
+    if (errorContext.failed) {
+        setStatus(lock, STATUS_FAILED, errorContext.extendedStatus);
+        return false;
+    }
+    descr.inSizeBytes = remote->size();
+    descr.mtime       = remote->mtime();
+
+    // Identify the blocks to be transferred: all of them for a fresh copy,
+    // or just the ones missing from (or corrupt within) the checkpoint when
+    // resuming an interrupted attempt.
+
+    std::vector<uint64_t> const& remoteDigests = remote->blockDigests();
+
+    std::vector<uint64_t> blocks;
+    for (size_t i = 0; i < remoteDigests.size(); ++i) {
+        if ((i >= localDigests.size()) or (localDigests[i] != remoteDigests[i])) {
+            blocks.push_back(i);
+        }
+    }
+    LOGS(_log, LOG_LVL_DEBUG, context() << "stripedTransfer"
+         << "  file: " << file
+         << "  blocks total: "  << remoteDigests.size()
+         << "  blocks needed: " << blocks.size());
+
+    // Make sure the temporary file exists and has the final size so that
+    // the stripes can write their blocks at the proper offsets.
+
+    if (not descr.hasPartialCopy) {
+        std::FILE* tmpFilePtr = std::fopen(descr.tmpFile.string().c_str(), "wb");
+        errorContext = errorContext
+            or reportErrorIf(
+                not tmpFilePtr,
+                ExtendedCompletionStatus::EXT_STATUS_FILE_CREATE,
+                "failed to create temporary file: " + descr.tmpFile.string() +
+                ", error: " + std::strerror(errno));
+        if (tmpFilePtr) std::fclose(tmpFilePtr);
+    }
+    if (not errorContext.failed) {
+        fs::resize_file(descr.tmpFile, descr.inSizeBytes, ec);
+        errorContext = errorContext
+            or reportErrorIf(
+                    ec.value() != 0,
+                    ExtendedCompletionStatus::EXT_STATUS_FILE_RESIZE,
+                    "failed to resize the temporary file: " + descr.tmpFile.string());
+    }
+    if (errorContext.failed) {
+        setStatus(lock, STATUS_FAILED, errorContext.extendedStatus);
+        return false;
+    }
+
+    // Transfer the blocks over parallel connections, each streaming its own
+    // contiguous slice of the needed blocks so the throughput of the file
+    // isn't limited by one TCP stream. Each stripe runs in its own thread
+    // with its own connection, file handle and record buffer, and the stripes
+    // never overlap so no synchronization over the file is needed.
+
+    if (not blocks.empty()) {
+
+        size_t const numStripes = std::min(::numTransferStripes, blocks.size());
+
+        std::atomic<bool> failed{false};
+        std::mutex        errMtx;
+        std::string       firstError;
+
+        std::vector<std::thread> stripes;
+
+        for (size_t stripe = 0; stripe < numStripes; ++stripe) {
+
+            // Carve out a contiguous slice of the needed blocks for this stripe
+
+            size_t const chunkSize  = blocks.size() / numStripes;
+            size_t const remainder  = blocks.size() % numStripes;
+            size_t const beginIdx   = stripe * chunkSize + std::min(stripe, remainder);
+            size_t const endIdx     = beginIdx + chunkSize + (stripe < remainder ? 1 : 0);
+
+            std::vector<uint64_t> const stripeBlocks(blocks.begin() + beginIdx,
+                                                     blocks.begin() + endIdx);
+
+            stripes.emplace_back([&, stripeBlocks] () {
+
+                auto const reportStripeError = [&] (std::string const& msg) {
+                    std::lock_guard<std::mutex> guard(errMtx);
+                    if (not failed.exchange(true)) firstError = msg;
+                };
+
+                FileClient::Ptr inFilePtr = FileClient::openBlocks(_serviceProvider,
+                                                                   _inWorkerInfo.name,
+                                                                   _databaseInfo.name,
+                                                                   file,
+                                                                   blockSize,
+                                                                   stripeBlocks);
+                if (not inFilePtr) {
+                    reportStripeError(
+                        "failed to open input file on remote worker: " + _inWorkerInfo.name +
+                        ", database: " + _databaseInfo.name +
+                        ", file: " + file);
+                    return;
+                }
+                std::FILE* tmpFilePtr = std::fopen(descr.tmpFile.string().c_str(), "rb+");
+                if (not tmpFilePtr) {
+                    reportStripeError(
+                        "failed to open temporary file: " + descr.tmpFile.string() +
+                        ", error: " + std::strerror(errno));
+                    return;
+                }
+                std::unique_ptr<uint8_t[]> const buf(new uint8_t[_bufSize]);
+                try {
+                    for (auto&& block: stripeBlocks) {
+
+                        if (failed) break;
+
+                        size_t const offset = block * blockSize;
+                        size_t bytesLeft    = std::min(blockSize, descr.inSizeBytes - offset);
+
+                        std::fseek(tmpFilePtr, static_cast<long>(offset), SEEK_SET);
+
+                        while (bytesLeft != 0) {
+                            size_t const num = inFilePtr->read(buf.get(), std::min(_bufSize, bytesLeft));
+                            if (not num) break;
+
+                            // Pace the transfer at the configured network rate (if any).
+                            // The limiter is shared by all stripes so the aggregate rate
+                            // of the striped copy stays within the limit.
+                            _serviceProvider->netRateLimiter()->consume(num);
+
+                            if (num != std::fwrite(buf.get(), sizeof(uint8_t), num, tmpFilePtr)) {
+                                reportStripeError(
+                                    "failed to write into temporary file: " + descr.tmpFile.string() +
+                                    ", error: " + std::strerror(errno));
+                                break;
+                            }
+                            bytesLeft -= num;
+                        }
+                        if (bytesLeft != 0) {
+                            reportStripeError(
+                                "short read of the input file from remote worker: " + _inWorkerInfo.name +
+                                ", database: " + _databaseInfo.name +
+                                ", file: " + file);
+                        }
+                        if (failed) break;
+                    }
+                } catch (FileClientError const& ex) {
+                    reportStripeError(
+                        "failed to read input file from remote worker: " + _inWorkerInfo.name +
+                        ", database: " + _databaseInfo.name +
+                        ", file: " + file);
+                }
+                std::fflush(tmpFilePtr);
+                std::fclose(tmpFilePtr);
+            });
+        }
+        for (auto&& stripe: stripes) {
+            stripe.join();
+        }
+        errorContext = errorContext
+            or reportErrorIf(
+                failed,
+                ExtendedCompletionStatus::EXT_STATUS_FILE_READ,
+                firstError);
+
+        if (errorContext.failed) {
+            setStatus(lock, STATUS_FAILED, errorContext.extendedStatus);
+            return false;
+        }
+    }
+
+    // Recompute the control sum over the whole file because the resumed
+    // blocks of the checkpoint never pass through the record buffers.
+
+    try {
+        descr.cs = FileUtils::compute_cs(descr.tmpFile.string());
+    } catch (std::exception const& ex) {
+        errorContext = errorContext
+            or reportErrorIf(
+                true,
+                ExtendedCompletionStatus::EXT_STATUS_FILE_READ,
+                "failed to compute the control sum of temporary file: " + descr.tmpFile.string() +
+                ", error: " + std::string(ex.what()));
+    }
+    if (errorContext.failed) {
+        setStatus(lock, STATUS_FAILED, errorContext.extendedStatus);
+        return false;
+    }
+    descr.outSizeBytes    = descr.inSizeBytes;
+    descr.endTransferTime = PerformanceUtils::now();
+
+    updateInfo(lock);
+
+    return true;
+}
+
 bool WorkerReplicationRequestFS::openFiles(util::Lock const& lock) {
 
     LOGS(_log, LOG_LVL_DEBUG, context() << "openFiles"
@@ -787,11 +1292,38 @@ bool WorkerReplicationRequestFS::openFiles(util::Lock const& lock) {
 
     WorkerRequest::ErrorContext errorContext;
 
-    // Open the input file on the remote server
-    _inFilePtr = FileClient::open(_serviceProvider,
-                                  _inWorkerInfo.name,
-                                  _databaseInfo.name,
-                                  *_fileItr);
+    // Refresh the files for which the destination already holds a (stale)
+    // copy via the incremental (delta) protocol, and copy the large files
+    // via the striped (parallel connection) protocol. Each such file
+    // completes in one shot, so advance the iterator to the first file
+    // (if any) requiring an ordinary sequential copy.
+
+    while (_files.end() != _fileItr) {
+        if (_file2descr[*_fileItr].hasStaleCopy) {
+            if (not deltaTransfer(lock)) return false;
+        } else if (_file2descr[*_fileItr].inSizeBytes >= stripedSizeThresholdBytes) {
+            if (not stripedTransfer(lock)) return false;
+        } else {
+            break;
+        }
+        ++_fileItr;
+    }
+    if (_files.end() == _fileItr) return true;
+
+    // Open the input file on the remote server. The first file of the chunk
+    // opens the connection in the session mode, and each subsequent file is
+    // requested over the same connection so that the whole file set of
+    // the chunk streams over one connection w/o paying the connection setup
+    // cost per file. Should the session not continue for any reason, fall
+    // back to opening a fresh connection.
+
+    if ((_inFilePtr == nullptr) or not _inFilePtr->openNext(*_fileItr)) {
+        _inFilePtr = FileClient::open(_serviceProvider,
+                                      _inWorkerInfo.name,
+                                      _databaseInfo.name,
+                                      *_fileItr,
+                                      true /* keepOpen */);
+    }
     errorContext = errorContext
         or reportErrorIf(
             not _inFilePtr,
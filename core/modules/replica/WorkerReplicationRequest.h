@@ -289,6 +289,36 @@ private:
      */
     bool openFiles(util::Lock const& lock);
 
+    /**
+     * Refresh the file pointed to by iterator _fileItr via the incremental
+     * (delta) protocol: the block-level digests of the stale local copy are
+     * compared against the ones reported by the source worker, and only
+     * the blocks which differ get transferred and patched into the local
+     * temporary file. Unlike the full-copy path this method completes
+     * the whole file in one call.
+     *
+     * @param lock - lock which must be acquired before calling this method
+     *
+     * @return 'false' in case of any error
+     */
+    bool deltaTransfer(util::Lock const& lock);
+
+    /**
+     * Copy the (large) file pointed to by iterator _fileItr over several
+     * parallel connections to the source worker, each streaming its own
+     * contiguous range of blocks, so the throughput of a single file isn't
+     * limited by one TCP stream. The temporary file left behind by
+     * an interrupted attempt serves as the checkpoint: its block-level
+     * digests are compared against the ones reported by the source worker
+     * and only the blocks which are missing or differ get re-sent.
+     * Like deltaTransfer() this method completes the whole file in one call.
+     *
+     * @param lock - lock which must be acquired before calling this method
+     *
+     * @return 'false' in case of any error
+     */
+    bool stripedTransfer(util::Lock const& lock);
+
     /**
      * The final stage to be executed just once after copying the content
      * of the remote files into the local temporary ones. It will rename
@@ -365,6 +395,16 @@ private:
         /// Control sum computed locally while copying the file
         uint64_t cs;
 
+        /// The flag indicating if the destination already holds a (possibly
+        /// stale) copy of the file, in which case the file is refreshed via
+        /// the incremental (delta) protocol instead of a full copy
+        bool hasStaleCopy;
+
+        /// The flag indicating if a temporary file left behind by an interrupted
+        /// attempt was found at the destination. The striped transfer resumes
+        /// from such a file, re-sending only the blocks it's missing.
+        bool hasPartialCopy;
+
         /// The absolute path of a temporary file at a local directory.
         boost::filesystem::path tmpFile;
 
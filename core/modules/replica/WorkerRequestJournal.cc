@@ -0,0 +1,246 @@
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "replica/WorkerRequestJournal.h"
+
+// System headers
+#include <cerrno>
+#include <cstring>
+#include <list>
+#include <map>
+#include <set>
+#include <stdexcept>
+#include <fcntl.h>      // open
+#include <sys/mman.h>   // mmap, munmap
+#include <sys/stat.h>   // fstat
+#include <unistd.h>     // write, fdatasync, ftruncate, close
+
+// Qserv headers
+#include "lsst/log/Log.h"
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.replica.WorkerRequestJournal");
+
+} /// namespace
+
+namespace lsst {
+namespace qserv {
+namespace replica {
+
+WorkerRequestJournal::WorkerRequestJournal(std::string const& fileName)
+    :   _fileName(fileName),
+        _fd(-1),
+        _stop(false) {
+
+    _fd = ::open(fileName.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0666);
+    if (_fd < 0) {
+        throw std::runtime_error(
+                "WorkerRequestJournal: failed to open the journal file: " + fileName +
+                ", error: " + std::strerror(errno));
+    }
+    _thread = std::thread(&WorkerRequestJournal::flushThread, this);
+}
+
+WorkerRequestJournal::~WorkerRequestJournal() {
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        _stop = true;
+    }
+    _cv.notify_one();
+    _thread.join();
+
+    ::close(_fd);
+}
+
+void WorkerRequestJournal::replay(ReplayCallbackType const& onRecord) {
+
+    LOGS(_log, LOG_LVL_DEBUG, "WorkerRequestJournal::replay  file: " << _fileName);
+
+    int const fd = ::open(_fileName.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::runtime_error(
+                "WorkerRequestJournal::replay  failed to open the journal file: " + _fileName +
+                ", error: " + std::strerror(errno));
+    }
+    struct stat status;
+    if (::fstat(fd, &status) != 0) {
+        ::close(fd);
+        throw std::runtime_error(
+                "WorkerRequestJournal::replay  failed to stat the journal file: " + _fileName +
+                ", error: " + std::strerror(errno));
+    }
+    size_t const size = status.st_size;
+
+    // Collect the records. A request survives the replay if it was accepted,
+    // but no terminal state was journaled for it.
+
+    std::list<std::string> order;
+    std::map<std::string, proto::ReplicationRequestJournalRecord> accepted;
+    std::set<std::string> finished;
+
+    if (size != 0) {
+
+        void* data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            ::close(fd);
+            throw std::runtime_error(
+                    "WorkerRequestJournal::replay  failed to map the journal file: " + _fileName +
+                    ", error: " + std::strerror(errno));
+        }
+        char const* ptr = static_cast<char const*>(data);
+
+        size_t pos = 0;
+        while (pos + sizeof(uint32_t) <= size) {
+
+            uint32_t bytes;
+            std::memcpy(&bytes, ptr + pos, sizeof(uint32_t));
+            pos += sizeof(uint32_t);
+
+            // An incomplete record at the very end of the file is left there
+            // if the service crashed in the middle of a write. It's safe to
+            // ignore the record because it was never acknowledged to a client.
+
+            if (pos + bytes > size) {
+                LOGS(_log, LOG_LVL_WARN, "WorkerRequestJournal::replay"
+                     << "  ignoring an incomplete record at offset: " << pos - sizeof(uint32_t));
+                break;
+            }
+            proto::ReplicationRequestJournalRecord record;
+            if (not record.ParseFromArray(ptr + pos, bytes)) {
+                LOGS(_log, LOG_LVL_WARN, "WorkerRequestJournal::replay"
+                     << "  ignoring a corrupt record at offset: " << pos - sizeof(uint32_t));
+                break;
+            }
+            pos += bytes;
+
+            switch (record.event()) {
+
+                case proto::ReplicationRequestJournalRecord::ACCEPTED:
+                    if (not accepted.count(record.id())) order.push_back(record.id());
+                    accepted[record.id()] = record;
+                    break;
+
+                case proto::ReplicationRequestJournalRecord::FINISHED:
+                    finished.insert(record.id());
+                    break;
+            }
+        }
+        ::munmap(data, size);
+    }
+    ::close(fd);
+
+    // Rotate the journal before reporting the survivors. The requests get
+    // re-journaled as a caller re-registers them.
+
+    if (::ftruncate(_fd, 0) != 0) {
+        throw std::runtime_error(
+                "WorkerRequestJournal::replay  failed to truncate the journal file: " + _fileName +
+                ", error: " + std::strerror(errno));
+    }
+
+    size_t numReported = 0;
+    for (auto&& id: order) {
+        if (finished.count(id)) continue;
+        onRecord(accepted.at(id));
+        numReported++;
+    }
+    LOGS(_log, LOG_LVL_DEBUG, "WorkerRequestJournal::replay"
+         << "  accepted: " << accepted.size()
+         << "  finished: " << finished.size()
+         << "  reported: " << numReported);
+}
+
+void WorkerRequestJournal::accepted(std::string const& id,
+                                    proto::ReplicationReplicaRequestType type,
+                                    google::protobuf::MessageLite const& request) {
+
+    proto::ReplicationRequestJournalRecord record;
+    record.set_id(id);
+    record.set_event(proto::ReplicationRequestJournalRecord::ACCEPTED);
+    record.set_replica_type(type);
+    record.set_request(request.SerializeAsString());
+
+    append(record);
+}
+
+void WorkerRequestJournal::finished(std::string const& id,
+                                    proto::ReplicationStatus status) {
+
+    proto::ReplicationRequestJournalRecord record;
+    record.set_id(id);
+    record.set_event(proto::ReplicationRequestJournalRecord::FINISHED);
+    record.set_status(status);
+
+    append(record);
+}
+
+void WorkerRequestJournal::append(proto::ReplicationRequestJournalRecord const& record) {
+
+    std::string const data = record.SerializeAsString();
+    uint32_t const bytes = data.size();
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+
+        _pending.append(reinterpret_cast<char const*>(&bytes), sizeof(uint32_t));
+        _pending.append(data);
+    }
+    _cv.notify_one();
+}
+
+void WorkerRequestJournal::flushThread() {
+
+    std::string batch;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(_mtx);
+            _cv.wait(lock, [this]() { return _stop or not _pending.empty(); });
+
+            if (_pending.empty()) break;
+
+            batch.clear();
+            std::swap(batch, _pending);
+        }
+
+        // Group commit: all records accumulated while the previous batch
+        // was being written are made durable with a single write and
+        // a single sync.
+
+        char const* ptr = batch.data();
+        size_t bytes = batch.size();
+        while (bytes != 0) {
+            ssize_t const written = ::write(_fd, ptr, bytes);
+            if (written < 0) {
+                LOGS(_log, LOG_LVL_ERROR, "WorkerRequestJournal::flushThread"
+                     << "  failed to write into the journal file: " << _fileName
+                     << ", error: " << std::strerror(errno));
+                break;
+            }
+            ptr   += written;
+            bytes -= written;
+        }
+        ::fdatasync(_fd);
+    }
+}
+
+}}} // namespace lsst::qserv::replica
@@ -0,0 +1,173 @@
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_REPLICA_WORKERREQUESTJOURNAL_H
+#define LSST_QSERV_REPLICA_WORKERREQUESTJOURNAL_H
+
+/// WorkerRequestJournal.h declares:
+///
+/// class WorkerRequestJournal
+/// (see individual class documentation for more information)
+
+// System headers
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Qserv headers
+#include "proto/replication.pb.h"
+
+// This header declarations
+
+namespace lsst {
+namespace qserv {
+namespace replica {
+
+/**
+ * Class WorkerRequestJournal is a lightweight write-ahead journal of requests
+ * accepted by a worker service and of their terminal states. The journal allows
+ * the service to resume processing of the outstanding requests after a restart
+ * instead of forcing a controller to re-discover and re-issue everything.
+ *
+ * Records (see message ReplicationRequestJournalRecord in replication.proto)
+ * are appended to a file in the length-framed binary format. Appends are group
+ * committed: records are accumulated in a memory buffer and made durable by
+ * a dedicated thread with a single write and a single sync per batch, so
+ * the per-request journaling overhead stays negligible even at high request
+ * rates. When the journal is replayed (see method replay()) the file is mapped
+ * into memory and scanned, and records of the accepted requests which hadn't
+ * reached their terminal states are reported to a caller. An incomplete record
+ * at the very end of the file (left there if the service crashed in the middle
+ * of a write) is silently ignored.
+ *
+ * The journal file is maintained by (and replayed on) the same host, hence
+ * no attempts are made to make its binary format portable across machines.
+ */
+class WorkerRequestJournal {
+
+public:
+
+    /// The function type for receiving records of the accepted requests
+    /// which hadn't reached their terminal states by the time the journal
+    /// was written
+    typedef std::function<void(proto::ReplicationRequestJournalRecord const&)> ReplayCallbackType;
+
+    // Default construction and copy semantics are prohibited
+
+    WorkerRequestJournal() = delete;
+    WorkerRequestJournal(WorkerRequestJournal const&) = delete;
+    WorkerRequestJournal& operator=(WorkerRequestJournal const&) = delete;
+
+    /**
+     * Construct the journal over the specified file. The file gets created
+     * if it doesn't exist yet.
+     *
+     * @param fileName - an absolute path to the journal file
+     *
+     * @throws std::runtime_error - if the file can't be opened for writing
+     */
+    explicit WorkerRequestJournal(std::string const& fileName);
+
+    /// Destructor (non-trivial in order to flush the pending records and
+    /// stop the group commit thread)
+    ~WorkerRequestJournal();
+
+    /**
+     * Replay the journal.
+     *
+     * The method maps the journal file into memory, scans the records and
+     * reports (via the specified callback) the accepted requests which hadn't
+     * reached their terminal states, in the order in which they were accepted.
+     * The journal file is then truncated. It's up to a caller to re-register
+     * the reported requests (which would also re-journal them).
+     *
+     * The method has to be called before the first request is recorded.
+     *
+     * @param onRecord - a callback function to be called for each surviving record
+     */
+    void replay(ReplayCallbackType const& onRecord);
+
+    /**
+     * Record a request accepted for processing
+     *
+     * @param id      - a unique identifier of the request
+     * @param type    - the type of the request
+     * @param request - the protobuf body of the request to be preserved for replays
+     */
+    void accepted(std::string const& id,
+                  proto::ReplicationReplicaRequestType type,
+                  google::protobuf::MessageLite const& request);
+
+    /**
+     * Record the terminal state of a request
+     *
+     * @param id     - a unique identifier of the request
+     * @param status - the terminal status of the request
+     */
+    void finished(std::string const& id,
+                  proto::ReplicationStatus status);
+
+private:
+
+    /**
+     * Serialize the record into the pending buffer and wake up the group
+     * commit thread.
+     *
+     * @param record - the record to be appended
+     */
+    void append(proto::ReplicationRequestJournalRecord const& record);
+
+    /**
+     * The group commit thread. The thread picks up all records accumulated
+     * in the pending buffer while the previous batch was being written, and
+     * makes them durable with a single write and a single sync.
+     */
+    void flushThread();
+
+private:
+
+    /// An absolute path to the journal file
+    std::string _fileName;
+
+    /// A file descriptor of the journal opened in the append mode
+    int _fd;
+
+    /// The flag telling the group commit thread to finish
+    bool _stop;
+
+    /// Records serialized and framed, but not yet written to the file
+    std::string _pending;
+
+    /// The mutex guarding the pending buffer and the stop flag
+    std::mutex _mtx;
+
+    /// The condition variable for waking up the group commit thread
+    std::condition_variable _cv;
+
+    /// The group commit thread
+    std::thread _thread;
+};
+
+}}} // namespace lsst::qserv::replica
+
+#endif // LSST_QSERV_REPLICA_WORKERREQUESTJOURNAL_H
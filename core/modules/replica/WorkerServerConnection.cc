@@ -135,7 +135,10 @@ WorkerServerConnection::WorkerServerConnection(ServiceProvider::Ptr const& servi
         _processor(processor),
         _socket(io_service),
         _bufferPtr(std::make_shared<ProtocolBuffer>(
-                       serviceProvider->config()->requestBufferSizeBytes())) {
+                       serviceProvider->config()->requestBufferSizeBytes())),
+        _batchBufferPtr(std::make_shared<ProtocolBuffer>(
+                       serviceProvider->config()->requestBufferSizeBytes())),
+        _batchedReplies(false) {
 }
 
 void WorkerServerConnection::beginProtocol() {
@@ -197,6 +200,7 @@ void WorkerServerConnection::received(boost::system::error_code const& ec,
         case proto::ReplicationRequestHeader::REPLICA: processReplicaRequest(   hdr); break;
         case proto::ReplicationRequestHeader::REQUEST: processManagementRequest(hdr); break;
         case proto::ReplicationRequestHeader::SERVICE: processServiceRequest(   hdr); break;
+        case proto::ReplicationRequestHeader::BATCH:   processBatchRequest(     hdr); break;
 
         default:
             throw std::logic_error(
@@ -474,15 +478,63 @@ void WorkerServerConnection::processServiceRequest(proto::ReplicationRequestHead
     }
 }
 
-void WorkerServerConnection::send() {
+void WorkerServerConnection::processBatchRequest(proto::ReplicationRequestHeader& hdr) {
+
+    LOGS(_log, LOG_LVL_DEBUG, context << "processBatchRequest  batch_size: " << hdr.batch_size());
+
+    if (not hdr.batch_size()) {
+        throw std::logic_error(
+              "WorkerServerConnection::processBatchRequest() the batch envelope is empty");
+    }
+
+    // Responses to the requests of the envelope are accumulated in the dedicated
+    // buffer (see the implementation of method reply()) and flushed to a client
+    // in a single write after the last request of the envelope has been processed.
+    // This amortizes the framing and I/O overhead of serving large volumes of
+    // small (status polling, etc.) requests.
+
+    _batchedReplies = true;
+    _batchBufferPtr->resize();
+
+    for (uint32_t i = 0; i < hdr.batch_size(); ++i) {
+
+        // Read the header of the next request of the envelope. The rest of
+        // that request will be read by the corresponding processor.
+
+        uint32_t bytes;
+        proto::ReplicationRequestHeader requestHdr;
+        if (not ::readLength( _socket, _bufferPtr, bytes) or
+            not ::readMessage(_socket, _bufferPtr, bytes, requestHdr)) {
+            _batchedReplies = false;
+            return;
+        }
+        switch (requestHdr.type()) {
+
+            case proto::ReplicationRequestHeader::REPLICA: processReplicaRequest(   requestHdr); break;
+            case proto::ReplicationRequestHeader::REQUEST: processManagementRequest(requestHdr); break;
+            case proto::ReplicationRequestHeader::SERVICE: processServiceRequest(   requestHdr); break;
+
+            default:
+                _batchedReplies = false;
+                throw std::logic_error(
+                      "WorkerServerConnection::processBatchRequest() unhandled request class: '" +
+                      proto::ReplicationRequestHeader::RequestType_Name(requestHdr.type()));
+        }
+    }
+    _batchedReplies = false;
+
+    send(_batchBufferPtr);
+}
+
+void WorkerServerConnection::send(std::shared_ptr<ProtocolBuffer> const& bufferPtr) {
 
     LOGS(_log, LOG_LVL_DEBUG, context << "send");
 
     boost::asio::async_write(
         _socket,
         boost::asio::buffer(
-            _bufferPtr->data(),
-            _bufferPtr->size()
+            bufferPtr->data(),
+            bufferPtr->size()
         ),
         boost::bind(
             &WorkerServerConnection::sent,
@@ -168,6 +168,17 @@ private:
      */
     void processServiceRequest(proto::ReplicationRequestHeader& hdr);
 
+    /**
+     * Process a batch envelope packing multiple requests into a single
+     * frame. Responses to all requests of the envelope are coalesced into
+     * a single write back to a client. This amortizes the per-request
+     * framing and I/O costs for clients sending large volumes of small
+     * requests.
+     *
+     * @param hdr - request header to be inspected
+     */
+    void processBatchRequest(proto::ReplicationRequestHeader& hdr);
+
     /**
      * Serialize an identifier of a request into response header
      * followed by the protobuf response body protobuf object and
@@ -180,21 +191,33 @@ private:
     void reply(std::string const& id,
                T&& body) {
 
-        _bufferPtr->resize();
-
         proto::ReplicationResponseHeader hdr;
         hdr.set_id(id);
 
+        if (_batchedReplies) {
+
+            // Accumulate the response in the dedicated buffer. The whole
+            // collection of responses to the requests of an envelope will be
+            // flushed to a client in a single write by the batch processor.
+
+            _batchBufferPtr->serialize(hdr);
+            _batchBufferPtr->serialize(body);
+            return;
+        }
+        _bufferPtr->resize();
+
         _bufferPtr->serialize(hdr);
         _bufferPtr->serialize(body);
 
-        send();
+        send(_bufferPtr);
     }
 
     /**
      * Begin sending (asynchronosly) a result back to a client
+     *
+     * @param bufferPtr - a buffer with the serialized response(s) to be sent
      */
-    void send();
+    void send(std::shared_ptr<ProtocolBuffer> const& bufferPtr);
 
     /**
      * The calback on finishing (either successfully or not) of aynchronious writes.
@@ -215,6 +238,17 @@ private:
     /// Buffer management class facilitating serialization/deserialization
     /// of data sent over the network
     std::shared_ptr<ProtocolBuffer> _bufferPtr;
+
+    /// The buffer for accumulating responses to the requests of a batch
+    /// envelope before flushing them to a client in a single write. A separate
+    /// buffer is required here because the primary one gets reused for reading
+    /// bodies of the subsequent requests of the envelope.
+    std::shared_ptr<ProtocolBuffer> _batchBufferPtr;
+
+    /// The flag indicating that requests of a batch envelope are being
+    /// processed, in which case responses are to be accumulated in the above
+    /// defined buffer instead of being sent individually
+    bool _batchedReplies;
 };
 
 }}} // namespace lsst::qserv::replica
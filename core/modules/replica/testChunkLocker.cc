@@ -128,6 +128,29 @@ BOOST_AUTO_TEST_CASE(ChunkLockerTest) {
     BOOST_CHECK(locker.release(chunk1));
     BOOST_CHECK_EQUAL(locker.locked().size(), 0UL);
 
+    // Test bulk chunk insertion and removal
+
+    std::list<Chunk> const chunks{chunk1, chunk2, chunk3, chunk4};
+
+    BOOST_CHECK_EQUAL(locker.lock(chunks, "qserv").size(), 4UL);
+    BOOST_CHECK_EQUAL(locker.locked("qserv").at("qserv").size(), 4UL);
+
+    // Re-locking by the same owner must report all chunks, while another
+    // owner must be denied all of them
+
+    BOOST_CHECK_EQUAL(locker.lock(chunks, "qserv").size(), 4UL);
+    BOOST_CHECK_EQUAL(locker.lock(chunks, "root").size(), 0UL);
+
+    // Partially locked collections must report the difference only
+
+    BOOST_CHECK(locker.release(chunk2));
+    BOOST_CHECK_EQUAL(locker.lock(chunks, "root").size(), 1UL);
+    BOOST_CHECK(locker.isLocked(chunk2, owner) and ("root" == owner));
+
+    BOOST_CHECK_EQUAL(locker.release(chunks), 4UL);
+    BOOST_CHECK_EQUAL(locker.release(chunks), 0UL);
+    BOOST_CHECK_EQUAL(locker.locked().size(), 0UL);
+
     // A this point the locker must be completelly empty
 
     // Run a limited thread safety test if the hardware concurrency permits so.
@@ -26,9 +26,13 @@
 
 // System headers
 #include <algorithm>
+#include <chrono>
+#include <condition_variable>
 #include <map>
+#include <mutex>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 // Third-party headers
@@ -396,4 +400,65 @@ BOOST_AUTO_TEST_CASE(ConfigurationTest) {
     LOGS_INFO("Configuration test ends");
 }
 
+BOOST_AUTO_TEST_CASE(ConfigurationSubscriberTest) {
+
+    LOGS_INFO("Configuration subscriber test begins");
+
+    std::map<std::string,std::string> kvMap = {
+        {"common.workers",           "worker-A"},
+        {"common.database_families", "test"},
+        {"common.databases",         "db1"},
+
+        {"worker:worker-A.is_enabled",   "1"},
+        {"worker:worker-A.is_read_only", "0"},
+        {"worker:worker-A.svc_host",     "host-A"},
+        {"worker:worker-A.fs_host",      "host-A"},
+
+        {"database_family:test.min_replication_level", "1"},
+        {"database_family:test.num_stripes",           "14"},
+        {"database_family:test.num_sub_stripes",       "15"},
+
+        {"database:db1.family",             "test"},
+        {"database:db1.partitioned_tables", "Table11"},
+        {"database:db1.regular_tables",     ""}
+    };
+    Configuration::Ptr const config = Configuration::load(kvMap);
+
+    // Notifications are delivered asynchronously, so collect them under
+    // a condition variable
+
+    std::mutex mtx;
+    std::condition_variable cv;
+    std::vector<uint64_t> notifiedVersions;
+
+    unsigned int const subscriberId = config->subscribe([&mtx, &cv, &notifiedVersions](uint64_t version) {
+        std::unique_lock<std::mutex> lock(mtx);
+        notifiedVersions.push_back(version);
+        cv.notify_one();
+    });
+
+    uint64_t const versionBefore = config->version();
+    config->disableWorker("worker-A");
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        BOOST_CHECK(cv.wait_for(lock, std::chrono::seconds(5),
+                                [&notifiedVersions] { return not notifiedVersions.empty(); }));
+        BOOST_CHECK(notifiedVersions.size() == 1);
+        BOOST_CHECK(notifiedVersions.front() == versionBefore + 1);
+        BOOST_CHECK(notifiedVersions.front() == config->version());
+    }
+
+    // No further notifications should arrive after unsubscribing
+
+    config->unsubscribe(subscriberId);
+    config->setWorkerSvcPort("worker-A", 1);
+    std::this_thread::sleep_for(std::chrono::milliseconds(250));
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        BOOST_CHECK(notifiedVersions.size() == 1);
+    }
+
+    LOGS_INFO("Configuration subscriber test ends");
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,109 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+ /**
+  * @brief test ControllerShard
+  */
+
+// System headers
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+// Third-party headers
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+// Qserv headers
+#include "replica/ControllerShard.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE ControllerShard
+#include "boost/test/included/unit_test.hpp"
+
+namespace test = boost::test_tools;
+using namespace lsst::qserv::replica;
+
+BOOST_AUTO_TEST_SUITE(Suite)
+
+BOOST_AUTO_TEST_CASE(ControllerShardTest) {
+
+    LOGS_INFO("ControllerShard test begins");
+
+    // The default constructed shard represents the single-controller setup
+    // which owns everything
+
+    ControllerShard single;
+
+    BOOST_CHECK_EQUAL(single.numShards(), 1U);
+    BOOST_CHECK_EQUAL(single.shard(), 0U);
+    BOOST_CHECK(single.single());
+    BOOST_CHECK(single.ownsClusterWideJobs());
+    BOOST_CHECK(single.isResponsibleFor("production"));
+    BOOST_CHECK(single.isResponsibleFor(""));
+
+    // Invalid shard configurations must be rejected
+
+    BOOST_CHECK_THROW(ControllerShard(0, 0), std::invalid_argument);
+    BOOST_CHECK_THROW(ControllerShard(2, 2), std::invalid_argument);
+    BOOST_CHECK_THROW(ControllerShard(2, 3), std::invalid_argument);
+
+    // Every database family must be owned by exactly one shard of a setup,
+    // and the ownership must not depend on which instance computes it
+
+    std::vector<std::string> const families{
+        "production", "test", "sdss_stripe82", "wise", "gaia_dr2", ""};
+
+    unsigned int const numShards = 3;
+    for (auto&& family: families) {
+        unsigned int owners = 0;
+        for (unsigned int shard = 0; shard < numShards; ++shard) {
+            if (ControllerShard(numShards, shard).isResponsibleFor(family)) ++owners;
+            BOOST_CHECK_EQUAL(
+                ControllerShard(numShards, shard).isResponsibleFor(family),
+                ControllerShard(numShards, shard).isResponsibleFor(family));
+        }
+        BOOST_CHECK_EQUAL(owners, 1U);
+    }
+
+    // Exactly one shard of a setup runs the cluster-wide jobs
+
+    unsigned int clusterWideOwners = 0;
+    for (unsigned int shard = 0; shard < numShards; ++shard) {
+        if (ControllerShard(numShards, shard).ownsClusterWideJobs()) ++clusterWideOwners;
+    }
+    BOOST_CHECK_EQUAL(clusterWideOwners, 1U);
+
+    // The filtered collection is the union of the shards' collections and
+    // each family stays in exactly one of them
+
+    size_t totalOwned = 0;
+    for (unsigned int shard = 0; shard < numShards; ++shard) {
+        totalOwned += ControllerShard(numShards, shard).responsibleFor(families).size();
+    }
+    BOOST_CHECK_EQUAL(totalOwned, families.size());
+
+    LOGS_INFO("ControllerShard test ends");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,119 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+ /**
+  * @brief test WorkerRequestJournal
+  */
+
+// System headers
+#include <cstdio>
+#include <list>
+#include <string>
+
+// Third-party headers
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+// Qserv headers
+#include "replica/WorkerRequestJournal.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE WorkerRequestJournal
+#include "boost/test/included/unit_test.hpp"
+
+namespace test = boost::test_tools;
+using namespace lsst::qserv::replica;
+namespace proto = lsst::qserv::proto;
+
+BOOST_AUTO_TEST_SUITE(Suite)
+
+BOOST_AUTO_TEST_CASE(WorkerRequestJournalTest) {
+
+    LOGS_INFO("WorkerRequestJournal test begins");
+
+    std::string const fileName = "/tmp/testWorkerRequestJournal.journal";
+    std::remove(fileName.c_str());
+
+    // Populate the journal with three accepted requests, one of which
+    // reaches its terminal state. The destructor is expected to flush
+    // the pending records to the file.
+
+    proto::ReplicationRequestEcho request;
+    request.set_priority(0);
+    request.set_data("abcdef");
+    request.set_delay(1000);
+
+    {
+        WorkerRequestJournal journal(fileName);
+        journal.accepted("id1", proto::ReplicationReplicaRequestType::REPLICA_ECHO, request);
+        journal.accepted("id2", proto::ReplicationReplicaRequestType::REPLICA_ECHO, request);
+        journal.accepted("id3", proto::ReplicationReplicaRequestType::REPLICA_ECHO, request);
+        journal.finished("id2", proto::ReplicationStatus::SUCCESS);
+    }
+
+    // Replay the journal as if the service restarted. Only the requests
+    // with no terminal states are expected to be reported, in the order
+    // in which they were accepted.
+
+    std::list<std::string> ids;
+    {
+        WorkerRequestJournal journal(fileName);
+        journal.replay(
+            [&ids,&request] (proto::ReplicationRequestJournalRecord const& record) {
+
+                ids.push_back(record.id());
+
+                BOOST_CHECK(record.event()        == proto::ReplicationRequestJournalRecord::ACCEPTED);
+                BOOST_CHECK(record.replica_type() == proto::ReplicationReplicaRequestType::REPLICA_ECHO);
+
+                proto::ReplicationRequestEcho restored;
+                BOOST_CHECK(restored.ParseFromString(record.request()));
+                BOOST_CHECK_EQUAL(restored.data(),  request.data());
+                BOOST_CHECK_EQUAL(restored.delay(), request.delay());
+            }
+        );
+    }
+    BOOST_CHECK_EQUAL(ids.size(), 2UL);
+    BOOST_CHECK_EQUAL(ids.front(), "id1");
+    BOOST_CHECK_EQUAL(ids.back(),  "id3");
+
+    // The replay must have rotated (truncated) the journal, so another
+    // replay is expected to report nothing.
+
+    size_t numReported = 0;
+    {
+        WorkerRequestJournal journal(fileName);
+        journal.replay(
+            [&numReported] (proto::ReplicationRequestJournalRecord const& record) {
+                numReported++;
+            }
+        );
+    }
+    BOOST_CHECK_EQUAL(numReported, 0UL);
+
+    std::remove(fileName.c_str());
+
+    LOGS_INFO("WorkerRequestJournal test ends");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
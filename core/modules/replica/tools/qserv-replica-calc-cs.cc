@@ -43,6 +43,9 @@ std::vector<std::string> fileNames;
 /// USe the incremental engine if set
 bool incremental;
 
+/// Split each file between all cores of the host if set
+bool parallel;
+
 /// The test
 void test() {
     try {
@@ -52,6 +55,10 @@ void test() {
             for (auto const& name: fileNames) {
                 std::cout << name << ": " << eng.cs(name) << std::endl;
             }
+        } else if (parallel) {
+            for (auto const& name: fileNames) {
+                std::cout << name << ": " << replica::FileUtils::compute_cs_parallel(name) << std::endl;
+            }
         } else {
             for (auto const& name: fileNames) {
                 std::cout << name << ": " << replica::FileUtils::compute_cs(name) << std::endl;
@@ -79,10 +86,12 @@ int main(int argc, const char *argv[]) {
             "  <file>  - the name of a file to read. Multiple files can be specified\n"
             "\n"
             "Flags and options\n"
-            "  --incremental  -- use the incremental ile reader instead\n");
+            "  --incremental  -- use the incremental ile reader instead\n"
+            "  --parallel     -- split each file between all cores of the host\n");
 
         parser.parameters<std::string>(::fileNames);
         ::incremental = parser.flag("incremental");
+        ::parallel    = parser.flag("parallel");
 
     } catch (std::exception const &ex) {
         return 1;
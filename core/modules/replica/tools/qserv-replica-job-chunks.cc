@@ -25,7 +25,6 @@
 /// disposition within a database family.
 
 // System headers
-#include <atomic>
 #include <list>
 #include <iomanip>
 #include <iostream>
@@ -37,13 +36,13 @@
 
 // Qserv headers
 #include "proto/replication.pb.h"
+#include "replica/Completion.h"
 #include "replica/Configuration.h"
 #include "replica/Controller.h"
 #include "replica/FindAllJob.h"
 #include "replica/QservGetReplicasJob.h"
 #include "replica/ReplicaInfo.h"
 #include "replica/ServiceProvider.h"
-#include "util/BlockPost.h"
 #include "util/CmdLineParser.h"
 
 using namespace lsst::qserv;
@@ -132,51 +131,47 @@ bool test() {
 
         controller->run();
 
-        util::BlockPost blockPost(1000,2000);
-
         ///////////////////////////////////////////////////////////////////
         // Start two parallel jobs, the firts one getting the latest state
         // of replicas accross the Replication cluster, and the second one
         // getting a list of replicas known to Qserv workers.
 
-        std::atomic<bool> replicaJobFinished{false};
+        replica::Completion completion;
+
+        auto const replicaJobDone = completion.expect();
         auto findAllJob = replica::FindAllJob::create(
             databaseFamily,
             saveReplicaInfo,
             controller,
             std::string(),
-            [&replicaJobFinished] (replica::FindAllJob::Ptr const& job) {
-                replicaJobFinished = true;
+            [replicaJobDone] (replica::FindAllJob::Ptr const& job) {
+                replicaJobDone();
             }
         );
         findAllJob->start();
 
         replica::QservGetReplicasJob::Ptr qservGetReplicasJob;
         if (pullQservReplicas) {
-            std::atomic<bool> qservJobFinished{false};
+            auto const qservJobDone = completion.expect();
             bool const inUseOnly = false;
             qservGetReplicasJob = replica::QservGetReplicasJob::create(
                 databaseFamily,
                 controller,
                 std::string(),
                 inUseOnly,
-                [&qservJobFinished] (replica::QservGetReplicasJob::Ptr const& job) {
-                    qservJobFinished = true;
+                [qservJobDone] (replica::QservGetReplicasJob::Ptr const& job) {
+                    qservJobDone();
                 }
             );
             qservGetReplicasJob->start();
 
-            while (not (replicaJobFinished and qservJobFinished)) {
-                blockPost.wait();
-            }
+            completion.waitAll();
             OUT << "qserv-replica-job-cunks:\n"
                 << "   FindAllJob          finished: " << findAllJob->state2string() << "\n"
                 << "   QservGetReplicasJob finished: " << qservGetReplicasJob->state2string() << "\n"
                 << std::endl;
         } else {
-            while (not replicaJobFinished) {
-                blockPost.wait();
-            }
+            completion.waitAll();
             OUT << "qserv-replica-job-cunks:\n"
                 << "   FindAllJob          finished: " << findAllJob->state2string() << "\n"
                 << std::endl;
@@ -24,7 +24,6 @@
 /// for testing the corresponding job.
 
 // System headers
-#include <atomic>
 #include <iomanip>
 #include <iostream>
 #include <stdexcept>
@@ -32,10 +31,10 @@
 
 // Qserv headers
 #include "proto/replication.pb.h"
+#include "replica/Completion.h"
 #include "replica/Controller.h"
 #include "replica/ReplicaInfo.h"
 #include "replica/DeleteWorkerJob.h"
-#include "util/BlockPost.h"
 #include "util/CmdLineParser.h"
 
 using namespace lsst::qserv;
@@ -69,22 +68,20 @@ bool test() {
         ////////////////////
         // Start replication
 
-        std::atomic<bool> finished{false};
+        replica::Completion completion;
+        auto const done = completion.expect();
         auto job = replica::DeleteWorkerJob::create(
             worker,
             permanentDelete,
             controller,
             std::string(),
-            [&finished] (replica::DeleteWorkerJob::Ptr job) {
-                finished = true;
+            [done] (replica::DeleteWorkerJob::Ptr job) {
+                done();
             }
         );
         job->start();
 
-        util::BlockPost blockPost(1000,2000);
-        while (not finished) {
-            blockPost.wait();
-        }
+        completion.waitAll();
 
         replica::DeleteWorkerJobResult const& jobReport = job->getReplicaData();
 
@@ -24,7 +24,6 @@
 /// which is meant to run the corresponding job.
 
 // System headers
-#include <atomic>
 #include <iomanip>
 #include <iostream>
 #include <map>
@@ -35,11 +34,11 @@
 
 // Qserv headers
 #include "proto/replication.pb.h"
+#include "replica/Completion.h"
 #include "replica/Configuration.h"
 #include "replica/Controller.h"
 #include "replica/FixUpJob.h"
 #include "replica/ServiceProvider.h"
-#include "util/BlockPost.h"
 #include "util/CmdLineParser.h"
 
 using namespace lsst::qserv;
@@ -72,21 +71,19 @@ bool test() {
         ////////////////////////////////////////
         // Find all replicas accross all workers
 
-        std::atomic<bool> finished{false};
+        replica::Completion completion;
+        auto const done = completion.expect();
         auto job = replica::FixUpJob::create(
             databaseFamily,
             controller,
             std::string(),
-            [&finished] (replica::FixUpJob::Ptr job) {
-                finished = true;
+            [done] (replica::FixUpJob::Ptr job) {
+                done();
             }
         );
         job->start();
 
-        util::BlockPost blockPost(1000,2000);
-        while (not finished) {
-            blockPost.wait();
-        }
+        completion.waitAll();
 
         //////////////////////////////
         // Analyse and display results
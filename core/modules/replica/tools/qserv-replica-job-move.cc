@@ -24,7 +24,7 @@
 /// which is meant to run the corresponding job.
 
 // System headers
-#include <atomic>
+#include <chrono>
 #include <iostream>
 #include <iomanip>
 #include <stdexcept>
@@ -32,11 +32,11 @@
 
 // Qserv headers
 #include "proto/replication.pb.h"
+#include "replica/Completion.h"
 #include "replica/Controller.h"
 #include "replica/ReplicaInfo.h"
 #include "replica/MoveReplicaJob.h"
 #include "replica/ServiceProvider.h"
-#include "util/BlockPost.h"
 #include "util/CmdLineParser.h"
 
 using namespace lsst::qserv;
@@ -118,7 +118,8 @@ bool test() {
         ////////////////////
         // Start replication
 
-        std::atomic<bool> finished{false};
+        replica::Completion completion;
+        auto const done = completion.expect();
         auto job = replica::MoveReplicaJob::create(
             databaseFamily,
             chunk,
@@ -127,20 +128,18 @@ bool test() {
             purge,
             controller,
             std::string(),
-            [&finished] (replica::MoveReplicaJob::Ptr job) {
-                finished = true;
+            [done] (replica::MoveReplicaJob::Ptr job) {
+                done();
             }
         );
         job->start();
 
-        util::BlockPost blockPost(1000,2000);
-        while (not finished) {
+        while (not completion.waitAllFor(std::chrono::seconds(1))) {
             std::cout
                 << "qserv-replica-job-move:"
                 << "  Controller::numActiveRequests: " << controller->numActiveRequests()
                 << ", MoveReplicaJob::state: " << job->state2string()
                 << std::endl;
-            blockPost.wait();
         }
 
         //////////////////////////////
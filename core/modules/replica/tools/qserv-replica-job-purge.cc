@@ -24,18 +24,17 @@
 /// which is meant to run the corresponding job.
 
 // System headers
-#include <atomic>
 #include <iostream>
 #include <stdexcept>
 #include <string>
 
 // Qserv headers
 #include "proto/replication.pb.h"
+#include "replica/Completion.h"
 #include "replica/Controller.h"
 #include "replica/ReplicaInfo.h"
 #include "replica/PurgeJob.h"
 #include "replica/ServiceProvider.h"
-#include "util/BlockPost.h"
 #include "util/CmdLineParser.h"
 
 using namespace lsst::qserv;
@@ -69,22 +68,20 @@ bool test() {
         ////////////////////
         // Start replication
 
-        std::atomic<bool> finished{false};
+        replica::Completion completion;
+        auto const done = completion.expect();
         auto job = replica::PurgeJob::create(
             databaseFamily,
             numReplicas,
             controller,
             std::string(),
-            [&finished] (replica::PurgeJob::Ptr job) {
-                finished = true;
+            [done] (replica::PurgeJob::Ptr job) {
+                done();
             }
         );
         job->start();
 
-        util::BlockPost blockPost(1000,2000);
-        while (not finished) {
-            blockPost.wait();
-        }
+        completion.waitAll();
 
         ///////////////////////////////////////////////////
         // Shutdown the controller and join with its thread
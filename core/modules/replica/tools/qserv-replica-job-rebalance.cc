@@ -24,7 +24,6 @@
 /// which is meant to run the corresponding job.
 
 // System headers
-#include <atomic>
 #include <iostream>
 #include <iomanip>
 #include <stdexcept>
@@ -32,11 +31,11 @@
 
 // Qserv headers
 #include "proto/replication.pb.h"
+#include "replica/Completion.h"
 #include "replica/Controller.h"
 #include "replica/ReplicaInfo.h"
 #include "replica/RebalanceJob.h"
 #include "replica/ServiceProvider.h"
-#include "util/BlockPost.h"
 #include "util/CmdLineParser.h"
 
 using namespace lsst::qserv;
@@ -48,6 +47,7 @@ namespace {
 std::string databaseFamily;
 std::string configUrl;
 bool        estimateOnly;
+bool        optimalPlan;
 bool        progressReport;
 bool        errorReport;
 bool        chunkLocksReport;
@@ -143,22 +143,21 @@ bool test () {
         ////////////////////
         // Start replication
 
-        std::atomic<bool> finished{false};
+        replica::Completion completion;
+        auto const done = completion.expect();
         auto job = replica::RebalanceJob::create(
             databaseFamily,
             estimateOnly,
+            optimalPlan,
             controller,
             std::string(),
-            [&finished] (replica::RebalanceJob::Ptr job) {
-                finished = true;
+            [done] (replica::RebalanceJob::Ptr job) {
+                done();
             }
         );
         job->start();
 
-        util::BlockPost blockPost(1000,2000);
-        while (not finished) {
-            blockPost.wait();
-        }
+        completion.waitAll();
 
         //////////////////////////////
         // Analyse and display results
@@ -199,6 +198,7 @@ int main(int argc, const char* const argv[]) {
             "  <database-family>\n"
             "  [--config=<url>]\n"
             "  [--estimate-only]\n"
+            "  [--optimal-plan]\n"
             "  [--progress-report]\n"
             "  [--error-report]\n"
             "  [--chunk-locks-report]\n"
@@ -211,6 +211,8 @@ int main(int argc, const char* const argv[]) {
             "                         connection parameters [ DEFAULT: file:replication.cfg ]\n"
             "  --estimate-only      - do not make any changes to chunk disposition. Just produce\n"
             "                         and print an estimate for the rebalance plan.\n"
+            "  --optimal-plan       - use the cost-optimizing planner which picks the cheapest\n"
+            "                         (in terms of an amount of data to be moved) chunks\n"
             "  --progress-report    - progress report when executing batches of requests\n"
             "  --error-report       - the flag triggering detailed report on failed requests\n"
             "  --chunk-locks-report - report chunks which are locked\n");
@@ -218,6 +220,7 @@ int main(int argc, const char* const argv[]) {
         ::databaseFamily   = parser.parameter<std::string> (1);
         ::configUrl        = parser.option<std::string>("config", "file:replication.cfg");
         ::estimateOnly     = parser.flag("estimate-only");
+        ::optimalPlan      = parser.flag("optimal-plan");
         ::progressReport   = parser.flag("progress-report");
         ::errorReport      = parser.flag("error-report");
         ::chunkLocksReport = parser.flag("chunk-locks-report");
@@ -24,7 +24,6 @@
 /// which is meant to run the corresponding job.
 
 // System headers
-#include <atomic>
 #include <iomanip>
 #include <iostream>
 #include <map>
@@ -35,11 +34,11 @@
 
 // Qserv headers
 #include "proto/replication.pb.h"
+#include "replica/Completion.h"
 #include "replica/Configuration.h"
 #include "replica/Controller.h"
 #include "replica/QservSyncJob.h"
 #include "replica/ServiceProvider.h"
-#include "util/BlockPost.h"
 #include "util/CmdLineParser.h"
 
 using namespace lsst::qserv;
@@ -73,22 +72,20 @@ bool test() {
         ////////////////////////////////////////
         // Find all replicas accross all workers
 
-        std::atomic<bool> finished{false};
+        replica::Completion completion;
+        auto const done = completion.expect();
         auto job = replica::QservSyncJob::create(
             databaseFamily,
             controller,
             std::string(),
             force,
-            [&finished] (replica::QservSyncJob::Ptr const& job) {
-                finished = true;
+            [done] (replica::QservSyncJob::Ptr const& job) {
+                done();
             }
         );
         job->start();
 
-        util::BlockPost blockPost(1000,2000);
-        while (not finished) {
-            blockPost.wait();
-        }
+        completion.waitAll();
 
         //////////////////////////////
         // Analyse and display results
@@ -24,7 +24,6 @@
 /// which is meant to run the corresponding job.
 
 // System headers
-#include <atomic>
 #include <iomanip>
 #include <iostream>
 #include <stdexcept>
@@ -32,11 +31,11 @@
 
 // Qserv headers
 #include "proto/replication.pb.h"
+#include "replica/Completion.h"
 #include "replica/Controller.h"
 #include "replica/VerifyJob.h"
 #include "replica/ReplicaInfo.h"
 #include "replica/ServiceProvider.h"
-#include "util/BlockPost.h"
 #include "util/CmdLineParser.h"
 
 using namespace lsst::qserv;
@@ -48,6 +47,8 @@ namespace {
 std::string configUrl;
 size_t      maxReplicas;
 bool        computeCheckSum;
+unsigned int samplePercent;
+uint64_t    checkSumAgeSec;
 bool        progressReport;
 bool        errorReport;
 bool        detailedReport;
@@ -70,12 +71,13 @@ bool run() {
         ////////////////////////////////////////
         // Find all replicas accross all workers
 
-        std::atomic<bool> finished{false};
+        replica::Completion completion;
+        auto const done = completion.expect();
         auto job = replica::VerifyJob::create (
             controller,
             std::string(),
-            [&finished] (replica::VerifyJob::Ptr const& job) {
-                finished = true;
+            [done] (replica::VerifyJob::Ptr const& job) {
+                done();
             },
             [] (replica::VerifyJob::Ptr const& job,
                 replica::ReplicaDiff const& selfReplicaDiff,
@@ -102,14 +104,13 @@ bool run() {
                     }
             },
             maxReplicas,
-            computeCheckSum
+            computeCheckSum,
+            samplePercent,
+            checkSumAgeSec
         );
         job->start();
 
-        util::BlockPost blockPost(1000,2000);
-        while (not finished) {
-            blockPost.wait();
-        }
+        completion.waitAll();
 
         ///////////////////////////////////////////////////
         // Shutdown the controller and join with its thread
@@ -141,6 +142,8 @@ int main(int argc, const char* const argv[]) {
             "  [--config=<url>]\n"
             "  [--max-replicas]\n"
             "  [--check-sum]\n"
+            "  [--sample-percent]\n"
+            "  [--check-sum-age-sec]\n"
             "  [--progress-report]\n"
             "  [--error-report]\n"
             "  [--detailed-report]\n"
@@ -151,6 +154,12 @@ int main(int argc, const char* const argv[]) {
             "  --max-replicas     - the maximum number of replicas to be processed simultaneously\n"
             "                       [ DEFAULT: 1 ]\n"
             "  --check-sum        - compute check/control sum of files\n"
+            "  --sample-percent   - percentage of replicas getting their check/control sums\n"
+            "                       computed (the statistical verification mode)\n"
+            "                       [ DEFAULT: 100 ]\n"
+            "  --check-sum-age-sec - the age (seconds since the last verification) beyond which\n"
+            "                       a replica is always verified in full in the statistical mode\n"
+            "                       [ DEFAULT: 0 (disabled) ]\n"
             "  --progress-report  - progress report when executing batches of requests\n"
             "  --error-report     - detailed report on failed requests\n"
             "  --detailed-report  - detailed report on results\n");
@@ -158,6 +167,8 @@ int main(int argc, const char* const argv[]) {
         ::configUrl       = parser.option<std::string>("config", "file:replication.cfg");
         ::maxReplicas     = parser.option<unsigned int>("max-replicas", 1);
         ::computeCheckSum = parser.flag("check-sum");
+        ::samplePercent   = parser.option<unsigned int>("sample-percent", 100);
+        ::checkSumAgeSec  = parser.option<unsigned int>("check-sum-age-sec", 0);
         ::progressReport  = parser.flag("progress-report");
         ::errorReport     = parser.flag("error-report");
         ::detailedReport  = parser.flag("detailed-report");
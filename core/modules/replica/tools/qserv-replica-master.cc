@@ -37,6 +37,7 @@
 // Qserv headers
 #include "proto/replication.pb.h"
 #include "replica/Configuration.h"
+#include "replica/ControllerShard.h"
 #include "replica/FindAllJob.h"
 #include "replica/FixUpJob.h"
 #include "replica/JobController.h"
@@ -53,6 +54,8 @@ namespace {
 
 // Command line parameters
 std::string  configUrl;
+unsigned int numShards;
+unsigned int shardNumber;
 unsigned int numReplicas;
 bool         computeCheckSum;
 bool         bestEffort;
@@ -111,7 +114,8 @@ bool run() {
         // of the job will be run in a thread wich will differ from the current one
 
         replica::ServiceProvider::Ptr const provider  = replica::ServiceProvider::create(configUrl);
-        replica::JobController::Ptr   const jobCtrl   = replica::JobController::create(provider);
+        replica::ControllerShard      const shard(numShards, shardNumber);
+        replica::JobController::Ptr   const jobCtrl   = replica::JobController::create(provider, shard);
 
         jobCtrl->run();
 
@@ -121,7 +125,7 @@ bool run() {
         bool const saveReplicaInfo = true;      // Always do this because chained jobs may
                                                 // depend on a persistent state of replicas.
 
-        for (auto const& databaseFamily: provider->config()->databaseFamilies()) {
+        for (auto const& databaseFamily: shard.responsibleFor(provider->config()->databaseFamilies())) {
             std::atomic<bool> finished{false};
             replica::FindAllJob::Ptr const job = jobCtrl->findAll(
                 databaseFamily,
@@ -136,9 +140,13 @@ bool run() {
             }
         }
 
-        // Launch a never-ending replicas verification job
+        // Launch a never-ending replicas verification job. The job is not scoped
+        // to any database family, so in a sharded setup it's run by exactly
+        // one of the controllers to avoid verifying every replica per shard.
 
-        submitVerifyJob(jobCtrl);
+        if (shard.ownsClusterWideJobs()) {
+            submitVerifyJob(jobCtrl);
+        }
 
         // Launch a series of jobs witin an infinite loop for each databse family
         //
@@ -150,7 +158,7 @@ bool run() {
             // Check for chunks which need to be fixed and do so if the ones
             // were found.
 
-            for (auto const& databaseFamily: provider->config()->databaseFamilies()) {
+            for (auto const& databaseFamily: shard.responsibleFor(provider->config()->databaseFamilies())) {
                 std::atomic<bool> finished{false};
                 replica::FixUpJob::Ptr const job = jobCtrl->fixUp(
                     databaseFamily,
@@ -167,7 +175,7 @@ bool run() {
             // Check the replication level and bring the minimum number of replicas
             // to the desired level if needed
 
-            for (auto const& databaseFamily: provider->config()->databaseFamilies()) {
+            for (auto const& databaseFamily: shard.responsibleFor(provider->config()->databaseFamilies())) {
                 std::atomic<bool> finished{false};
                 replica::ReplicateJob::Ptr const job = jobCtrl->replicate(
                     databaseFamily,
@@ -185,7 +193,7 @@ bool run() {
             // Check the replication level and shave off the excess replicas
             // to the desired level if needed
 
-            for (auto const& databaseFamily: provider->config()->databaseFamilies()) {
+            for (auto const& databaseFamily: shard.responsibleFor(provider->config()->databaseFamilies())) {
                 std::atomic<bool> finished{false};
                 replica::PurgeJob::Ptr const job = jobCtrl->purge(
                     databaseFamily,
@@ -228,6 +236,8 @@ int main(int argc, const char* const argv[]) {
             "\n"
             "Usage:\n"
             "  [--config=<url>]\n"
+            "  [--num-shards=<number>]\n"
+            "  [--shard=<number>]\n"
             "  [--replicas=<number>]\n"
             "  [--check-sum]\n"
             "  [--best-effort]\n"
@@ -238,6 +248,12 @@ int main(int argc, const char* const argv[]) {
             "Flags and options:\n"
             "  --config             - a configuration URL (a configuration file or a set of the database\n"
             "                         connection parameters [ DEFAULT: file:replication.cfg ]\n"
+            "  --num-shards         - the total number of controller instances in a sharded setup.\n"
+            "                         Each instance must be given the same total and its own --shard,\n"
+            "                         and will only process the database families its shard owns\n"
+            "                         [ DEFAULT: '1' for the traditional single-controller setup ]\n"
+            "  --shard              - the number of this controller's shard, from 0 to the total\n"
+            "                         number of shards minus 1 [ DEFAULT: '0' ]\n"
             "  --replicas           - the desired number of replicas [ DEFAULT: '0' to pull the number\n"
             "                         from the Configuration]\n"
             "  --check-sum          - compute check/control sum of files\n"
@@ -248,6 +264,8 @@ int main(int argc, const char* const argv[]) {
             "  --chunk-locks-report - report chunks which are locked after finishing each job\n");
 
         ::configUrl        = parser.option<std::string>("config", "file:replication.cfg");
+        ::numShards        = parser.option<unsigned int>("num-shards", 1);
+        ::shardNumber      = parser.option<unsigned int>("shard", 0);
         ::numReplicas      = parser.option<unsigned int>("replicas", 0);
         ::computeCheckSum  = parser.flag("check-sum");
         ::bestEffort       = parser.flag("best-effort");
@@ -0,0 +1,374 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2017 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "rproc/AggregateCombiner.h"
+
+// System headers
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+// Qserv headers
+#include "query/ColumnRef.h"
+#include "query/FuncExpr.h"
+#include "query/SelectList.h"
+#include "query/SelectStmt.h"
+#include "query/ValueExpr.h"
+#include "query/ValueFactor.h"
+#include "sql/Schema.h"
+#include "sql/statement.h"
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.rproc.AggregateCombiner");
+
+/// Classify a SQL column type for accumulation.
+/// @return 0 if not numeric, 1 if integer, 2 if floating point. DECIMAL and
+/// NUMERIC accumulate as double, trading the last bits of precision for the
+/// in-memory combine; MIN/MAX on such columns are exact regardless.
+int classifySqlType(std::string const& sqlType) {
+    static std::vector<std::string> const intPrefixes = {
+        "TINYINT", "SMALLINT", "MEDIUMINT", "INTEGER", "INT", "BIGINT", "YEAR"};
+    static std::vector<std::string> const floatPrefixes = {
+        "FLOAT", "DOUBLE", "DECIMAL", "NUMERIC", "REAL"};
+    std::string upper;
+    upper.reserve(sqlType.size());
+    for (char c : sqlType) {
+        upper += std::toupper(static_cast<unsigned char>(c));
+    }
+    for (auto const& prefix : intPrefixes) {
+        if (upper.compare(0, prefix.size(), prefix) == 0) return 1;
+    }
+    for (auto const& prefix : floatPrefixes) {
+        if (upper.compare(0, prefix.size(), prefix) == 0) return 2;
+    }
+    return 0;
+}
+
+/// @return true if the cell at rowIdx is null according to the column's
+/// null bitmap (same encoding wpublish uses when building RowBlocks).
+bool blockIsNull(lsst::qserv::proto::ColumnBlock const& col, uint32_t rowIdx) {
+    std::string const& bitmap = col.nullbitmap();
+    size_t byteIdx = rowIdx / 8;
+    if (byteIdx >= bitmap.size()) return false;
+    return (bitmap[byteIdx] >> (rowIdx % 8)) & 1;
+}
+
+/// Format a double so the value round-trips exactly through the result table.
+std::string formatDouble(double d) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.17g", d);
+    return buf;
+}
+
+} // anonymous namespace
+
+
+namespace lsst {
+namespace qserv {
+namespace rproc {
+
+AggregateCombiner::Ptr AggregateCombiner::create(query::SelectStmt const& mergeStmt) {
+    if (mergeStmt.hasGroupBy() or mergeStmt.hasHaving() or mergeStmt.getDistinct()) {
+        return nullptr;
+    }
+    auto const veList = mergeStmt.getSelectList().getValueExprList();
+    if (veList == nullptr or veList->empty()) {
+        return nullptr;
+    }
+    Ptr combiner(new AggregateCombiner());
+    for (auto const& ve : *veList) {
+        if (ve == nullptr) {
+            return nullptr;
+        }
+        OutCol out;
+        if (not _parseOutCol(*ve, out)) {
+            return nullptr;
+        }
+        // MySQL names an unaliased CREATE TABLE ... SELECT column after the
+        // expression text; do the same so the result schema is unchanged.
+        out.name = ve->getAlias().empty() ? ve->sqlFragment() : ve->getAlias();
+        combiner->_outCols.push_back(out);
+    }
+    return combiner;
+}
+
+
+bool AggregateCombiner::_parseOutCol(query::ValueExpr const& ve, OutCol& out) {
+    // Extract the function name and single column-ref argument of a factor,
+    // the only function shape AggregatePlugin puts in merge statements.
+    auto funcCol = [](query::ValueFactor const& factor, std::string& opName,
+                      std::string& column) -> bool {
+        if (factor.getType() != query::ValueFactor::FUNCTION
+            and factor.getType() != query::ValueFactor::AGGFUNC) {
+            return false;
+        }
+        auto const fe = factor.getFuncExpr();
+        if (fe == nullptr) return false;
+        opName = fe->getName();
+        std::transform(opName.begin(), opName.end(), opName.begin(), ::toupper);
+        auto const params = fe->getParams();
+        if (params.size() != 1 or params[0] == nullptr) return false;
+        auto const cr = params[0]->copyAsColumnRef();
+        if (cr == nullptr or cr->column.empty()) return false;
+        column = cr->column;
+        return true;
+    };
+
+    auto const& factorOps = ve.getFactorOps();
+    if (factorOps.size() == 1) {
+        query::ValueFactor const& factor = *factorOps[0].factor;
+        if (factor.getType() == query::ValueFactor::EXPR) {
+            // The AVG quotient arrives wrapped in a single EXPR factor.
+            auto const inner = factor.getExpr();
+            if (inner == nullptr) return false;
+            return _parseOutCol(*inner, out);
+        }
+        std::string opName;
+        std::string column;
+        if (not funcCol(factor, opName, column)) return false;
+        if (opName == "SUM")      out.kind = OutCol::SUM;
+        else if (opName == "MIN") out.kind = OutCol::MIN;
+        else if (opName == "MAX") out.kind = OutCol::MAX;
+        else return false;
+        out.colName = column;
+        return true;
+    }
+    if (factorOps.size() == 2 and factorOps[0].op == query::ValueExpr::DIVIDE) {
+        // SUM(sum partials) / SUM(count partials), as produced for AVG.
+        std::string opA, colA;
+        std::string opB, colB;
+        if (not funcCol(*factorOps[0].factor, opA, colA)) return false;
+        if (not funcCol(*factorOps[1].factor, opB, colB)) return false;
+        if (opA != "SUM" or opB != "SUM") return false;
+        out.kind = OutCol::RATIO;
+        out.colName = colA;
+        out.colDenom = colB;
+        return true;
+    }
+    return false;
+}
+
+
+int AggregateCombiner::_bindColumn(proto::RowSchema const& schema,
+                                   std::string const& column, bool& isInt) {
+    int schemaIdx = -1;
+    for (int i = 0, e = schema.columnschema_size(); i != e; ++i) {
+        if (schema.columnschema(i).name() == column) {
+            schemaIdx = i;
+            break;
+        }
+    }
+    if (schemaIdx < 0) {
+        LOGS(_log, LOG_LVL_DEBUG, "combiner: no partial column " << column);
+        return -1;
+    }
+    int cls = classifySqlType(schema.columnschema(schemaIdx).sqltype());
+    if (cls == 0) {
+        LOGS(_log, LOG_LVL_DEBUG, "combiner: non-numeric partial column " << column
+             << " type " << schema.columnschema(schemaIdx).sqltype());
+        return -1;
+    }
+    isInt = (cls == 1);
+    for (size_t s = 0; s != _slotSchemaIdx.size(); ++s) {
+        if (_slotSchemaIdx[s] == schemaIdx) {
+            return s;
+        }
+    }
+    _slotSchemaIdx.push_back(schemaIdx);
+    _slotIsInt.push_back(isInt);
+    return _slotSchemaIdx.size() - 1;
+}
+
+
+bool AggregateCombiner::bindSchema(proto::RowSchema const& schema) {
+    for (auto& out : _outCols) {
+        out.slot = _bindColumn(schema, out.colName, out.isInt);
+        if (out.slot < 0) {
+            return false;
+        }
+        if (out.kind == OutCol::RATIO) {
+            bool denomInt = false;
+            out.slotDenom = _bindColumn(schema, out.colDenom, denomInt);
+            if (out.slotDenom < 0) {
+                return false;
+            }
+            out.sqlType = "DOUBLE";
+        } else if (out.kind == OutCol::SUM) {
+            out.sqlType = out.isInt ? "BIGINT" : "DOUBLE";
+        } else {
+            // MIN/MAX keep the partial column's own type.
+            out.sqlType = schema.columnschema(_slotSchemaIdx[out.slot]).sqltype();
+        }
+    }
+    _schemaBound = true;
+    return true;
+}
+
+
+void AggregateCombiner::add(proto::Result const& result, int jobIdAttempt) {
+    auto parse = [](char const* data, size_t len, bool isInt) -> Value {
+        Value v;
+        std::string const text(data, len);
+        if (isInt) {
+            v.i = std::strtoll(text.c_str(), nullptr, 10);
+            v.d = static_cast<double>(v.i);
+        } else {
+            v.d = std::strtod(text.c_str(), nullptr);
+        }
+        v.isNull = false;
+        return v;
+    };
+
+    for (int ri = 0, re = result.row_size(); ri != re; ++ri) {
+        proto::RowBundle const& rb = result.row(ri);
+        PartialRow row;
+        row.jobIdAttempt = jobIdAttempt;
+        row.values.resize(_slotSchemaIdx.size());
+        for (size_t s = 0; s != _slotSchemaIdx.size(); ++s) {
+            int const ci = _slotSchemaIdx[s];
+            if (ci >= rb.column_size() or rb.isnull(ci)) continue;
+            std::string const& cell = rb.column(ci);
+            row.values[s] = parse(cell.data(), cell.size(), _slotIsInt[s]);
+        }
+        _partials.push_back(std::move(row));
+    }
+
+    if (result.has_rowblock()) {
+        proto::RowBlock const& block = result.rowblock();
+        std::vector<size_t> offsets(block.column_size(), 0);
+        for (uint32_t ri = 0, re = block.numrows(); ri != re; ++ri) {
+            PartialRow row;
+            row.jobIdAttempt = jobIdAttempt;
+            row.values.resize(_slotSchemaIdx.size());
+            for (size_t s = 0; s != _slotSchemaIdx.size(); ++s) {
+                int const ci = _slotSchemaIdx[s];
+                if (ci >= block.column_size()) continue;
+                proto::ColumnBlock const& col = block.column(ci);
+                uint32_t const len = col.cellsize(ri);
+                if (blockIsNull(col, ri)) continue;
+                row.values[s] = parse(col.data().data() + offsets[ci], len,
+                                      _slotIsInt[s]);
+                offsets[ci] += len;
+            }
+            _partials.push_back(std::move(row));
+        }
+    }
+}
+
+
+void AggregateCombiner::render(std::string const& targetTable,
+                               std::function<bool(int)> const& isInvalid,
+                               std::string& createStmt, std::string& insertStmt) const {
+    // Evaluate attempt validity once per partial row rather than per column.
+    std::vector<char> rowValid(_partials.size(), 1);
+    for (size_t r = 0; r != _partials.size(); ++r) {
+        if (isInvalid(_partials[r].jobIdAttempt)) {
+            rowValid[r] = 0;
+        }
+    }
+
+    sql::Schema schema;
+    std::string values;
+    for (auto const& out : _outCols) {
+        bool any = false;
+        long long accI = 0;
+        double accD = 0.0;
+        double denomD = 0.0;
+        bool anyDenom = false;
+        for (size_t r = 0; r != _partials.size(); ++r) {
+            if (not rowValid[r]) continue;
+            Value const& v = _partials[r].values[out.slot];
+            if (out.kind == OutCol::RATIO) {
+                Value const& dv = _partials[r].values[out.slotDenom];
+                if (not v.isNull) {
+                    accD += v.d;
+                    any = true;
+                }
+                if (not dv.isNull) {
+                    denomD += dv.d;
+                    anyDenom = true;
+                }
+                continue;
+            }
+            if (v.isNull) continue;
+            switch (out.kind) {
+            case OutCol::SUM:
+                accI += v.i;
+                accD += v.d;
+                break;
+            case OutCol::MIN:
+                if (not any or (out.isInt ? v.i < accI : v.d < accD)) {
+                    accI = v.i;
+                    accD = v.d;
+                }
+                break;
+            case OutCol::MAX:
+                if (not any or (out.isInt ? v.i > accI : v.d > accD)) {
+                    accI = v.i;
+                    accD = v.d;
+                }
+                break;
+            default:
+                break;
+            }
+            any = true;
+        }
+
+        sql::ColSchema col;
+        col.name = out.name;
+        col.colType.sqlType = out.sqlType;
+        schema.columns.push_back(col);
+
+        if (not values.empty()) {
+            values += ",";
+        }
+        if (out.kind == OutCol::RATIO) {
+            // NULL when no rows contributed or the count sums to zero,
+            // matching SUM()/SUM() in mysqld.
+            if (not any or not anyDenom or denomD == 0.0) {
+                values += "NULL";
+            } else {
+                values += formatDouble(accD / denomD);
+            }
+        } else if (not any) {
+            values += "NULL";
+        } else if (out.isInt) {
+            values += std::to_string(accI);
+        } else {
+            values += formatDouble(accD);
+        }
+    }
+
+    createStmt = sql::formCreateTable(targetTable, schema) + " ENGINE=MyISAM";
+    insertStmt = "INSERT INTO " + targetTable + " VALUES (" + values + ")";
+    LOGS(_log, LOG_LVL_DEBUG, "combiner folded " << _partials.size()
+         << " partial rows into " << targetTable);
+}
+
+}}} // namespace lsst::qserv::rproc
@@ -0,0 +1,146 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2017 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_RPROC_AGGREGATECOMBINER_H
+#define LSST_QSERV_RPROC_AGGREGATECOMBINER_H
+
+// System headers
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Qserv headers
+#include "proto/worker.pb.h"
+
+// Forward declarations
+namespace lsst {
+namespace qserv {
+namespace query {
+    class SelectStmt;
+    class ValueExpr;
+}}} // End of forward declarations
+
+
+namespace lsst {
+namespace qserv {
+namespace rproc {
+
+/// AggregateCombiner folds worker partial-aggregate rows in memory for
+/// queries whose merge statement is a pure aggregate, i.e. every select
+/// item is one of the shapes qana::AggregatePlugin emits for
+/// COUNT/SUM/MIN/MAX/AVG: SUM, MIN or MAX of a single partial column, or
+/// the SUM/SUM quotient used for AVG. For such queries each worker task
+/// contributes a single tiny row, and routing 100k+ of them through the
+/// merge table (one LOAD DATA each plus a final aggregating SELECT) costs
+/// far more in mysqld round trips than folding them here. The final result
+/// table is still created so the proxy can return it to the user, but it
+/// receives exactly one INSERT.
+///
+/// Partial rows are kept per job attempt and only folded at render() time,
+/// so rows from job attempts invalidated after delivery (retries,
+/// cancellations) can be excluded without any analog of the result-table
+/// row scrubbing.
+class AggregateCombiner {
+public:
+    typedef std::shared_ptr<AggregateCombiner> Ptr;
+
+    /// Inspect the merge statement's select list.
+    /// @return a combiner if every item is a combinable aggregate and the
+    /// statement has no grouping; nullptr otherwise.
+    static Ptr create(query::SelectStmt const& mergeStmt);
+
+    AggregateCombiner(AggregateCombiner const&) = delete;
+    AggregateCombiner& operator=(AggregateCombiner const&) = delete;
+
+    /// Bind to the worker result schema, called with the first response.
+    /// @return false if a referenced partial column is missing from the
+    /// schema or is not numeric; the caller should then fall back to the
+    /// SQL merge path (no rows have been consumed yet).
+    bool bindSchema(proto::RowSchema const& schema);
+
+    /// @return true once bindSchema() has succeeded.
+    bool schemaBound() const { return _schemaBound; }
+
+    /// Record all partial rows of a worker result under its job attempt.
+    /// Must not be called before a successful bindSchema().
+    void add(proto::Result const& result, int jobIdAttempt);
+
+    /// Fold the recorded partials, skipping job attempts for which
+    /// 'isInvalid' returns true, and form the CREATE TABLE and INSERT
+    /// statements that produce the single-row result table.
+    void render(std::string const& targetTable,
+                std::function<bool(int)> const& isInvalid,
+                std::string& createStmt, std::string& insertStmt) const;
+
+    /// @return the number of partial rows recorded so far.
+    size_t partialCount() const { return _partials.size(); }
+
+private:
+    AggregateCombiner() = default;
+
+    /// A parsed partial value. Values are parsed when recorded so only
+    /// plain data needs to be stored until render() time.
+    struct Value {
+        bool isNull{true};
+        long long i{0};
+        double d{0.0};
+    };
+
+    /// One output column of the final result row.
+    struct OutCol {
+        enum Kind { SUM, MIN, MAX, RATIO };
+        Kind kind;
+        std::string name;     ///< final column name (alias or expression text)
+        std::string colName;  ///< partial column folded (numerator for RATIO)
+        std::string colDenom; ///< denominator partial column (RATIO only)
+        int slot{-1};         ///< value slot of colName, set by bindSchema()
+        int slotDenom{-1};    ///< value slot of colDenom (RATIO only)
+        bool isInt{false};    ///< integer accumulator (vs floating point)
+        std::string sqlType;  ///< SQL type of the output column
+    };
+
+    /// The partial rows of one worker result row.
+    struct PartialRow {
+        int jobIdAttempt;
+        std::vector<Value> values; ///< one entry per referenced column slot
+    };
+
+    /// Try to interpret one merge select item as a combinable aggregate.
+    /// @return true on success, filling everything in 'out' except 'name'
+    static bool _parseOutCol(query::ValueExpr const& ve, OutCol& out);
+
+    /// Map 'column' to a value slot, creating the slot on first use.
+    /// @return the slot index, or -1 if the column is missing or not numeric
+    int _bindColumn(proto::RowSchema const& schema, std::string const& column,
+                    bool& isInt);
+
+    std::vector<OutCol> _outCols;       ///< output columns, select-list order
+    std::vector<int> _slotSchemaIdx;    ///< schema column index per value slot
+    std::vector<bool> _slotIsInt;       ///< integer parse flag per value slot
+    std::vector<PartialRow> _partials;  ///< recorded partial rows
+    bool _schemaBound{false};
+};
+
+}}} // namespace lsst::qserv::rproc
+
+#endif // LSST_QSERV_RPROC_AGGREGATECOMBINER_H
@@ -0,0 +1,669 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2017 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "rproc/GroupByCombiner.h"
+
+// System headers
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstdlib>
+#include <sys/time.h>
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+// Qserv headers
+#include "query/ColumnRef.h"
+#include "query/FuncExpr.h"
+#include "query/GroupByClause.h"
+#include "query/SelectList.h"
+#include "query/SelectStmt.h"
+#include "query/ValueExpr.h"
+#include "query/ValueFactor.h"
+#include "sql/Schema.h"
+#include "sql/statement.h"
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.rproc.GroupByCombiner");
+
+/// Rough cap on a batched INSERT statement, comfortably below the usual
+/// max_allowed_packet (same budget the other combiners use).
+size_t const MAX_INSERT_SIZE = 950000;
+
+/// Estimated bookkeeping bytes per group beyond its key and cells: the
+/// hash table node, the vectors, and allocator slack.
+size_t const GROUP_OVERHEAD_BYTES = 96;
+
+/// Classify a SQL column type for accumulation and grouping.
+/// @return 0 if not numeric, 1 if integer, 2 if floating point. DECIMAL and
+/// NUMERIC accumulate as double, trading the last bits of precision for the
+/// in-memory combine; MIN/MAX on such columns are exact regardless.
+int classifySqlType(std::string const& sqlType) {
+    static std::vector<std::string> const intPrefixes = {
+        "TINYINT", "SMALLINT", "MEDIUMINT", "INTEGER", "INT", "BIGINT", "YEAR"};
+    static std::vector<std::string> const floatPrefixes = {
+        "FLOAT", "DOUBLE", "DECIMAL", "NUMERIC", "REAL"};
+    std::string upper;
+    upper.reserve(sqlType.size());
+    for (char c : sqlType) {
+        upper += std::toupper(static_cast<unsigned char>(c));
+    }
+    for (auto const& prefix : intPrefixes) {
+        if (upper.compare(0, prefix.size(), prefix) == 0) return 1;
+    }
+    for (auto const& prefix : floatPrefixes) {
+        if (upper.compare(0, prefix.size(), prefix) == 0) return 2;
+    }
+    return 0;
+}
+
+/// @return true if the cell at rowIdx is null according to the column's
+/// null bitmap (same encoding wpublish uses when building RowBlocks).
+bool blockIsNull(lsst::qserv::proto::ColumnBlock const& col, uint32_t rowIdx) {
+    std::string const& bitmap = col.nullbitmap();
+    size_t byteIdx = rowIdx / 8;
+    if (byteIdx >= bitmap.size()) return false;
+    return (bitmap[byteIdx] >> (rowIdx % 8)) & 1;
+}
+
+/// Format a double so the value round-trips exactly through the result table.
+std::string formatDouble(double d) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "%.17g", d);
+    return buf;
+}
+
+/// @return a 64-bit FNV-1a hash of a group key, used to pick the shard.
+uint64_t hashKey(std::string const& key) {
+    uint64_t h = 14695981039346656037ULL;
+    for (char c : key) {
+        h ^= static_cast<unsigned char>(c);
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+/// @return a timestamp id for generating the journal file name.
+std::string getTimeStampId() {
+    struct timeval now;
+    if (gettimeofday(&now, nullptr) != 0) {
+        return "0";
+    }
+    return std::to_string(now.tv_sec % 10000) + std::to_string(now.tv_usec);
+}
+
+} // anonymous namespace
+
+
+namespace lsst {
+namespace qserv {
+namespace rproc {
+
+GroupByCombiner::GroupByCombiner(std::string const& spillDir, size_t memoryLimitMB)
+    : _spillDir(spillDir), _memoryLimitBytes(int64_t(memoryLimitMB)*1024*1024) {
+}
+
+
+GroupByCombiner::~GroupByCombiner() {
+    if (_journalFile.is_open()) {
+        _journalFile.close();
+    }
+    if (not _journalFileName.empty()) {
+        std::remove(_journalFileName.c_str());
+    }
+}
+
+
+GroupByCombiner::Ptr GroupByCombiner::create(query::SelectStmt const& mergeStmt,
+                                             std::string const& spillDir,
+                                             size_t memoryLimitMB) {
+    if (not mergeStmt.hasGroupBy() or mergeStmt.hasHaving() or mergeStmt.getDistinct()) {
+        return nullptr;
+    }
+    // A LIMIT needs the final ordering mysqld applies on the merge table.
+    // A bare ORDER BY is different: the proxy applies the user query's
+    // ORDER BY when it reads the result table, so it is safe to ignore.
+    if (mergeStmt.hasLimit()) {
+        return nullptr;
+    }
+    auto const veList = mergeStmt.getSelectList().getValueExprList();
+    if (veList == nullptr or veList->empty()) {
+        return nullptr;
+    }
+    Ptr combiner(new GroupByCombiner(spillDir, memoryLimitMB));
+
+    query::ValueExprPtrVector groupExprs;
+    mergeStmt.getGroupBy().clone()->findValueExprs(groupExprs);
+    if (groupExprs.empty()) {
+        return nullptr;
+    }
+    for (auto const& ge : groupExprs) {
+        if (ge == nullptr) {
+            return nullptr;
+        }
+        auto const cr = ge->copyAsColumnRef();
+        if (cr == nullptr or cr->column.empty()) {
+            return nullptr;
+        }
+        GroupCol gc;
+        gc.column = cr->column;
+        combiner->_groupCols.push_back(gc);
+    }
+
+    for (auto const& ve : *veList) {
+        if (ve == nullptr) {
+            return nullptr;
+        }
+        OutCol out;
+        auto const cr = ve->copyAsColumnRef();
+        if (cr != nullptr and not cr->column.empty()) {
+            // A plain column must be one of the GROUP BY terms; selecting
+            // a non-grouped column would need mysqld's pick-any semantics.
+            out.kind = OutCol::GROUP_COL;
+            out.colName = cr->column;
+            for (size_t g = 0; g != combiner->_groupCols.size(); ++g) {
+                if (combiner->_groupCols[g].column == out.colName) {
+                    out.groupIdx = g;
+                    break;
+                }
+            }
+            if (out.groupIdx < 0) {
+                return nullptr;
+            }
+        } else if (_parseAggCol(*ve, out)) {
+            out.accIdx = combiner->_accCount++;
+        } else {
+            return nullptr;
+        }
+        // MySQL names an unaliased CREATE TABLE ... SELECT column after the
+        // expression text; do the same so the result schema is unchanged.
+        out.name = ve->getAlias().empty() ? ve->sqlFragment() : ve->getAlias();
+        combiner->_outCols.push_back(out);
+    }
+    return combiner;
+}
+
+
+bool GroupByCombiner::_parseAggCol(query::ValueExpr const& ve, OutCol& out) {
+    // Extract the function name and single column-ref argument of a factor,
+    // the only function shape AggregatePlugin puts in merge statements.
+    auto funcCol = [](query::ValueFactor const& factor, std::string& opName,
+                      std::string& column) -> bool {
+        if (factor.getType() != query::ValueFactor::FUNCTION
+            and factor.getType() != query::ValueFactor::AGGFUNC) {
+            return false;
+        }
+        auto const fe = factor.getFuncExpr();
+        if (fe == nullptr) return false;
+        opName = fe->getName();
+        std::transform(opName.begin(), opName.end(), opName.begin(), ::toupper);
+        auto const params = fe->getParams();
+        if (params.size() != 1 or params[0] == nullptr) return false;
+        auto const cr = params[0]->copyAsColumnRef();
+        if (cr == nullptr or cr->column.empty()) return false;
+        column = cr->column;
+        return true;
+    };
+
+    auto const& factorOps = ve.getFactorOps();
+    if (factorOps.size() == 1) {
+        query::ValueFactor const& factor = *factorOps[0].factor;
+        if (factor.getType() == query::ValueFactor::EXPR) {
+            // The AVG quotient arrives wrapped in a single EXPR factor.
+            auto const inner = factor.getExpr();
+            if (inner == nullptr) return false;
+            return _parseAggCol(*inner, out);
+        }
+        std::string opName;
+        std::string column;
+        if (not funcCol(factor, opName, column)) return false;
+        if (opName == "SUM")      out.kind = OutCol::SUM;
+        else if (opName == "MIN") out.kind = OutCol::MIN;
+        else if (opName == "MAX") out.kind = OutCol::MAX;
+        else return false;
+        out.colName = column;
+        return true;
+    }
+    if (factorOps.size() == 2 and factorOps[0].op == query::ValueExpr::DIVIDE) {
+        // SUM(sum partials) / SUM(count partials), as produced for AVG.
+        std::string opA, colA;
+        std::string opB, colB;
+        if (not funcCol(*factorOps[0].factor, opA, colA)) return false;
+        if (not funcCol(*factorOps[1].factor, opB, colB)) return false;
+        if (opA != "SUM" or opB != "SUM") return false;
+        out.kind = OutCol::RATIO;
+        out.colName = colA;
+        out.colDenom = colB;
+        return true;
+    }
+    return false;
+}
+
+
+bool GroupByCombiner::bindSchema(proto::RowSchema const& schema) {
+    auto findCol = [&schema](std::string const& name) -> int {
+        for (int i = 0, e = schema.columnschema_size(); i != e; ++i) {
+            if (schema.columnschema(i).name() == name) {
+                return i;
+            }
+        }
+        return -1;
+    };
+
+    for (auto& gc : _groupCols) {
+        gc.schemaIdx = findCol(gc.column);
+        if (gc.schemaIdx < 0) {
+            LOGS(_log, LOG_LVL_DEBUG, "groupBy: no result column " << gc.column);
+            return false;
+        }
+        if (classifySqlType(schema.columnschema(gc.schemaIdx).sqltype()) == 0) {
+            // Grouping strings by byte equality could split groups that
+            // mysqld's collation rules would merge; leave such queries on
+            // the SQL merge path.
+            LOGS(_log, LOG_LVL_DEBUG, "groupBy: non-numeric group column "
+                 << gc.column << " type "
+                 << schema.columnschema(gc.schemaIdx).sqltype());
+            return false;
+        }
+    }
+
+    for (auto& out : _outCols) {
+        if (out.kind == OutCol::GROUP_COL) {
+            out.schemaIdx = _groupCols[out.groupIdx].schemaIdx;
+            out.sqlType = schema.columnschema(out.schemaIdx).sqltype();
+            continue;
+        }
+        out.schemaIdx = findCol(out.colName);
+        if (out.schemaIdx < 0) {
+            LOGS(_log, LOG_LVL_DEBUG, "groupBy: no partial column " << out.colName);
+            return false;
+        }
+        int cls = classifySqlType(schema.columnschema(out.schemaIdx).sqltype());
+        if (cls == 0) {
+            LOGS(_log, LOG_LVL_DEBUG, "groupBy: non-numeric partial column "
+                 << out.colName << " type "
+                 << schema.columnschema(out.schemaIdx).sqltype());
+            return false;
+        }
+        out.isInt = (cls == 1);
+        if (out.kind == OutCol::RATIO) {
+            out.schemaIdxDenom = findCol(out.colDenom);
+            if (out.schemaIdxDenom < 0
+                or classifySqlType(
+                       schema.columnschema(out.schemaIdxDenom).sqltype()) == 0) {
+                LOGS(_log, LOG_LVL_DEBUG, "groupBy: unusable denominator column "
+                     << out.colDenom);
+                return false;
+            }
+            out.sqlType = "DOUBLE";
+        } else if (out.kind == OutCol::SUM) {
+            out.sqlType = out.isInt ? "BIGINT" : "DOUBLE";
+        } else {
+            // MIN/MAX keep the partial column's own type.
+            out.sqlType = schema.columnschema(out.schemaIdx).sqltype();
+        }
+    }
+    _schemaBound = true;
+    return true;
+}
+
+
+void GroupByCombiner::_foldRow(std::vector<std::string> const& cells,
+                               std::vector<bool> const& nulls) {
+    // Group columns are numeric, so their mysqld-formatted text is
+    // canonical and a separator byte cannot occur inside a cell.
+    std::string key;
+    for (auto const& gc : _groupCols) {
+        int const ci = gc.schemaIdx;
+        bool const isNull = ci >= static_cast<int>(cells.size()) or nulls[ci];
+        key += isNull ? '\1' : '\0';
+        if (not isNull) {
+            key += cells[ci];
+        }
+        key += '\x1f';
+    }
+
+    Shard& shard = _shards[hashKey(key) % SHARD_COUNT];
+    std::lock_guard<std::mutex> shardLock(shard.mtx);
+    auto ins = shard.groups.emplace(key, Group());
+    Group& group = ins.first->second;
+    if (ins.second) {
+        size_t cellBytes = 0;
+        group.cells.reserve(_groupCols.size());
+        group.nulls.reserve(_groupCols.size());
+        for (auto const& gc : _groupCols) {
+            int const ci = gc.schemaIdx;
+            bool const isNull = ci >= static_cast<int>(cells.size()) or nulls[ci];
+            group.cells.push_back(isNull ? std::string() : cells[ci]);
+            group.nulls.push_back(isNull);
+            cellBytes += group.cells.back().size();
+        }
+        group.accs.resize(_accCount);
+        _groupBytes += 2*key.size() + cellBytes
+                     + _accCount*sizeof(Acc) + GROUP_OVERHEAD_BYTES;
+        ++_groupCount;
+    }
+
+    for (auto const& out : _outCols) {
+        if (out.kind == OutCol::GROUP_COL) continue;
+        Acc& acc = group.accs[out.accIdx];
+        int const ci = out.schemaIdx;
+        bool const isNull = ci >= static_cast<int>(cells.size()) or nulls[ci];
+        if (out.kind == OutCol::RATIO) {
+            if (not isNull) {
+                acc.d += std::strtod(cells[ci].c_str(), nullptr);
+                acc.any = true;
+            }
+            int const di = out.schemaIdxDenom;
+            if (di < static_cast<int>(cells.size()) and not nulls[di]) {
+                acc.denom += std::strtod(cells[di].c_str(), nullptr);
+                acc.anyDenom = true;
+            }
+            continue;
+        }
+        if (isNull) continue;
+        long long const vi = out.isInt ? std::strtoll(cells[ci].c_str(), nullptr, 10) : 0;
+        double const vd = out.isInt ? static_cast<double>(vi)
+                                    : std::strtod(cells[ci].c_str(), nullptr);
+        switch (out.kind) {
+        case OutCol::SUM:
+            acc.i += vi;
+            acc.d += vd;
+            break;
+        case OutCol::MIN:
+            if (not acc.any or (out.isInt ? vi < acc.i : vd < acc.d)) {
+                acc.i = vi;
+                acc.d = vd;
+            }
+            break;
+        case OutCol::MAX:
+            if (not acc.any or (out.isInt ? vi > acc.i : vd > acc.d)) {
+                acc.i = vi;
+                acc.d = vd;
+            }
+            break;
+        default:
+            break;
+        }
+        acc.any = true;
+    }
+}
+
+
+void GroupByCombiner::_fold(proto::Result const& result) {
+    for (int ri = 0, re = result.row_size(); ri != re; ++ri) {
+        proto::RowBundle const& rb = result.row(ri);
+        std::vector<std::string> cells;
+        std::vector<bool> nulls;
+        cells.reserve(rb.column_size());
+        nulls.reserve(rb.column_size());
+        for (int ci = 0, ce = rb.column_size(); ci != ce; ++ci) {
+            cells.push_back(rb.column(ci));
+            nulls.push_back(rb.isnull(ci));
+        }
+        _foldRow(cells, nulls);
+    }
+
+    if (result.has_rowblock()) {
+        proto::RowBlock const& block = result.rowblock();
+        std::vector<size_t> offsets(block.column_size(), 0);
+        for (uint32_t ri = 0, re = block.numrows(); ri != re; ++ri) {
+            std::vector<std::string> cells;
+            std::vector<bool> nulls;
+            cells.reserve(block.column_size());
+            nulls.reserve(block.column_size());
+            for (int ci = 0, ce = block.column_size(); ci != ce; ++ci) {
+                proto::ColumnBlock const& col = block.column(ci);
+                if (blockIsNull(col, ri)) {
+                    cells.push_back(std::string());
+                    nulls.push_back(true);
+                    continue;
+                }
+                uint32_t const len = col.cellsize(ri);
+                cells.push_back(std::string(col.data().data() + offsets[ci], len));
+                nulls.push_back(false);
+                offsets[ci] += len;
+            }
+            _foldRow(cells, nulls);
+        }
+    }
+}
+
+
+GroupByCombiner::AddStatus GroupByCombiner::add(proto::Result const& result,
+                                                int jobIdAttempt) {
+    {
+        std::lock_guard<std::mutex> journalLock(_journalMtx);
+        if (_abandoned) {
+            return AddStatus::DIVERTED;
+        }
+        if (not _journalFile.is_open()) {
+            _journalFileName = _spillDir + "/qserv_groupby_journal_" + getTimeStampId();
+            _journalFile.open(_journalFileName,
+                              std::ios::in | std::ios::out | std::ios::trunc | std::ios::binary);
+            if (not _journalFile.is_open()) {
+                LOGS(_log, LOG_LVL_ERROR, "groupBy: failed to open journal "
+                     << _journalFileName);
+                _abandoned = true;
+                return AddStatus::ERROR;
+            }
+        }
+        std::string record;
+        if (not result.SerializeToString(&record)) {
+            LOGS(_log, LOG_LVL_ERROR, "groupBy: failed to serialize response for journal");
+            _abandoned = true;
+            return AddStatus::ERROR;
+        }
+        int32_t const attempt = jobIdAttempt;
+        uint32_t const length = record.size();
+        _journalFile.clear();
+        _journalFile.seekp(0, std::ios::end);
+        _journalFile.write(reinterpret_cast<char const*>(&attempt), sizeof attempt);
+        _journalFile.write(reinterpret_cast<char const*>(&length), sizeof length);
+        _journalFile.write(record.data(), length);
+        _journalFile.flush();
+        if (not _journalFile) {
+            LOGS(_log, LOG_LVL_ERROR, "groupBy: failed to write journal "
+                 << _journalFileName);
+            _abandoned = true;
+            return AddStatus::ERROR;
+        }
+        ++_journalRecords;
+        _contributingAttempts.insert(jobIdAttempt);
+    }
+
+    _fold(result);
+
+    if (_groupBytes.load() > _memoryLimitBytes) {
+        std::lock_guard<std::mutex> journalLock(_journalMtx);
+        if (not _abandoned) {
+            // This call owns the fallback; everything folded so far
+            // (including this response) is in the journal.
+            _abandoned = true;
+            return AddStatus::EXCEEDED;
+        }
+        // Another response won the race to trigger the fallback; its
+        // journal replay covers this response too.
+    }
+    return AddStatus::FOLDED;
+}
+
+
+bool GroupByCombiner::drainJournal(std::function<bool(proto::Result&)> const& consume) {
+    std::lock_guard<std::mutex> journalLock(_journalMtx);
+    // _abandoned is set by now, so no new records can be appended.
+    _journalFile.clear();
+    _journalFile.seekg(0);
+    for (size_t r = 0; r != _journalRecords; ++r) {
+        int32_t attempt = 0;
+        uint32_t length = 0;
+        _journalFile.read(reinterpret_cast<char*>(&attempt), sizeof attempt);
+        _journalFile.read(reinterpret_cast<char*>(&length), sizeof length);
+        std::string record(length, '\0');
+        if (_journalFile and length > 0) {
+            _journalFile.read(&record[0], length);
+        }
+        proto::Result result;
+        if (not _journalFile or not result.ParseFromString(record)) {
+            LOGS(_log, LOG_LVL_ERROR, "groupBy: failed to read journal "
+                 << _journalFileName);
+            return false;
+        }
+        if (not consume(result)) {
+            return false;
+        }
+    }
+    _journalFile.close();
+    std::remove(_journalFileName.c_str());
+    _journalFileName.clear();
+    _journalRecords = 0;
+    return true;
+}
+
+
+bool GroupByCombiner::_refold(std::function<bool(int)> const& isInvalid) {
+    for (auto& shard : _shards) {
+        std::lock_guard<std::mutex> shardLock(shard.mtx);
+        shard.groups.clear();
+    }
+    _groupBytes = 0;
+    _groupCount = 0;
+
+    _journalFile.clear();
+    _journalFile.seekg(0);
+    for (size_t r = 0; r != _journalRecords; ++r) {
+        int32_t attempt = 0;
+        uint32_t length = 0;
+        _journalFile.read(reinterpret_cast<char*>(&attempt), sizeof attempt);
+        _journalFile.read(reinterpret_cast<char*>(&length), sizeof length);
+        std::string record(length, '\0');
+        if (_journalFile and length > 0) {
+            _journalFile.read(&record[0], length);
+        }
+        proto::Result result;
+        if (not _journalFile or not result.ParseFromString(record)) {
+            LOGS(_log, LOG_LVL_ERROR, "groupBy: failed to refold journal "
+                 << _journalFileName);
+            return false;
+        }
+        if (isInvalid(attempt)) continue;
+        _fold(result);
+    }
+    return true;
+}
+
+
+bool GroupByCombiner::render(std::string const& targetTable,
+                             std::function<bool(int)> const& isInvalid,
+                             std::string& createStmt,
+                             std::vector<std::string>& insertStmts) {
+    {
+        std::lock_guard<std::mutex> journalLock(_journalMtx);
+        bool needRefold = false;
+        for (int attempt : _contributingAttempts) {
+            if (isInvalid(attempt)) {
+                needRefold = true;
+                break;
+            }
+        }
+        if (needRefold) {
+            LOGS(_log, LOG_LVL_INFO, "groupBy: invalidated job attempt "
+                 "contributed, refolding journal");
+            if (not _refold(isInvalid)) {
+                return false;
+            }
+        }
+    }
+
+    sql::Schema schema;
+    for (auto const& out : _outCols) {
+        sql::ColSchema col;
+        col.name = out.name;
+        col.colType.sqlType = out.sqlType;
+        schema.columns.push_back(col);
+    }
+    createStmt = sql::formCreateTable(targetTable, schema) + " ENGINE=MyISAM";
+
+    insertStmts.clear();
+    std::string const prefix = "INSERT INTO " + targetTable + " VALUES ";
+    std::string stmt;
+    size_t emitted = 0;
+    for (auto& shard : _shards) {
+        std::lock_guard<std::mutex> shardLock(shard.mtx);
+        for (auto const& entry : shard.groups) {
+            Group const& group = entry.second;
+            std::string values = "(";
+            bool first = true;
+            for (auto const& out : _outCols) {
+                if (not first) values += ",";
+                first = false;
+                if (out.kind == OutCol::GROUP_COL) {
+                    if (group.nulls[out.groupIdx]) {
+                        values += "NULL";
+                    } else {
+                        values += group.cells[out.groupIdx];
+                    }
+                    continue;
+                }
+                Acc const& acc = group.accs[out.accIdx];
+                if (out.kind == OutCol::RATIO) {
+                    // NULL when no rows contributed or the count sums to
+                    // zero, matching SUM()/SUM() in mysqld.
+                    if (not acc.any or not acc.anyDenom or acc.denom == 0.0) {
+                        values += "NULL";
+                    } else {
+                        values += formatDouble(acc.d / acc.denom);
+                    }
+                } else if (not acc.any) {
+                    values += "NULL";
+                } else if (out.isInt) {
+                    values += std::to_string(acc.i);
+                } else {
+                    values += formatDouble(acc.d);
+                }
+            }
+            values += ")";
+            if (not stmt.empty() and stmt.size() + values.size() > MAX_INSERT_SIZE) {
+                insertStmts.push_back(stmt);
+                stmt.clear();
+            }
+            if (stmt.empty()) {
+                stmt = prefix + values;
+            } else {
+                stmt += "," + values;
+            }
+            ++emitted;
+        }
+    }
+    if (not stmt.empty()) {
+        insertStmts.push_back(stmt);
+    }
+    LOGS(_log, LOG_LVL_DEBUG, "groupBy rendered " << emitted
+         << " groups into " << targetTable);
+    return true;
+}
+
+}}} // namespace lsst::qserv::rproc
@@ -0,0 +1,231 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2017 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_RPROC_GROUPBYCOMBINER_H
+#define LSST_QSERV_RPROC_GROUPBYCOMBINER_H
+
+// System headers
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Qserv headers
+#include "proto/worker.pb.h"
+
+// Forward declarations
+namespace lsst {
+namespace qserv {
+namespace query {
+    class SelectStmt;
+    class ValueExpr;
+}}} // End of forward declarations
+
+
+namespace lsst {
+namespace qserv {
+namespace rproc {
+
+/// GroupByCombiner folds worker partial-aggregate rows into an in-memory
+/// hash table for queries whose merge statement is a GROUP BY over plain
+/// group columns with the aggregate shapes qana::AggregatePlugin emits
+/// (SUM, MIN, MAX, or the SUM/SUM quotient used for AVG). The SQL merge
+/// path materializes every partial row in the merge table and re-groups
+/// them with a single-threaded SELECT, which leaves the czar grinding for
+/// minutes on high-cardinality GROUP BY merges. Here the group table is
+/// partitioned into hash shards with independent mutexes, so the response
+/// handler threads delivering worker results fold their partials
+/// concurrently; the final rows are inserted straight into the result
+/// table at finalize() time, with no merge table at all.
+///
+/// The groups are folded eagerly, so unlike the other combiners a partial
+/// row cannot be skipped retroactively when its job attempt is
+/// invalidated after delivery. Instead every response is first appended
+/// to an on-disk journal (a sequential write, cheap next to the LOAD it
+/// replaces); if an invalidated attempt contributed, render() refolds the
+/// journal without it. The journal also bounds memory: when the group
+/// table outgrows its budget the combiner abandons folding and the caller
+/// replays the journal through the ordinary merge-table path, so the
+/// worst case is exactly the old behavior.
+class GroupByCombiner {
+public:
+    typedef std::shared_ptr<GroupByCombiner> Ptr;
+
+    /// Outcome of offering one response to the combiner.
+    enum class AddStatus {
+        FOLDED,   ///< journaled and folded into the group table
+        EXCEEDED, ///< journaled, but the group table outgrew its memory
+                  ///< budget; the caller owns the fallback and should
+                  ///< replay the journal into the merge table
+        DIVERTED, ///< not consumed; folding was already abandoned and the
+                  ///< caller should merge the response through the table
+        ERROR     ///< the journal could not be written; the query cannot
+                  ///< be completed correctly
+    };
+
+    /// Inspect the merge statement.
+    /// @return a combiner if the statement groups by plain columns and
+    /// every other select item is a combinable aggregate; nullptr
+    /// otherwise. 'spillDir' hosts the journal file and 'memoryLimitMB'
+    /// bounds the in-memory group table.
+    static Ptr create(query::SelectStmt const& mergeStmt,
+                      std::string const& spillDir, size_t memoryLimitMB);
+
+    ~GroupByCombiner();
+
+    GroupByCombiner(GroupByCombiner const&) = delete;
+    GroupByCombiner& operator=(GroupByCombiner const&) = delete;
+
+    /// Bind to the worker result schema, called with the first response.
+    /// @return false if a group or partial column is missing from the
+    /// schema, a group column is non-numeric (grouping strings needs
+    /// mysqld's collation rules), or a partial column is not numeric; the
+    /// caller should then fall back to the SQL merge path (no rows have
+    /// been consumed yet).
+    bool bindSchema(proto::RowSchema const& schema);
+
+    /// @return true once bindSchema() has succeeded.
+    bool schemaBound() const { return _schemaBound; }
+
+    /// Journal a worker result and fold its partial rows into the group
+    /// table. Must not be called before a successful bindSchema(). Safe to
+    /// call concurrently; responses folding into different hash shards do
+    /// not contend.
+    AddStatus add(proto::Result const& result, int jobIdAttempt);
+
+    /// Feed every journaled response to 'consume', in arrival order, then
+    /// discard the journal. Called by the owner after add() returned
+    /// EXCEEDED, to replay the responses through the merge-table path.
+    /// @return false if the journal could not be read or 'consume' failed.
+    bool drainJournal(std::function<bool(proto::Result&)> const& consume);
+
+    /// Form the CREATE TABLE and batched INSERT statements that produce
+    /// the grouped result table. If any job attempt that contributed was
+    /// invalidated ('isInvalid' returns true for it), the group table is
+    /// refolded from the journal without that attempt first.
+    /// @return false if a required refold failed.
+    bool render(std::string const& targetTable,
+                std::function<bool(int)> const& isInvalid,
+                std::string& createStmt,
+                std::vector<std::string>& insertStmts);
+
+    /// @return the number of distinct groups folded so far.
+    size_t groupCount() const { return _groupCount.load(); }
+
+private:
+    GroupByCombiner(std::string const& spillDir, size_t memoryLimitMB);
+
+    /// Accumulator state of one aggregate column within one group.
+    struct Acc {
+        bool any{false};      ///< a non-null partial has been folded
+        long long i{0};       ///< integer accumulator
+        double d{0.0};        ///< floating-point accumulator (numerator)
+        double denom{0.0};    ///< denominator accumulator (RATIO only)
+        bool anyDenom{false}; ///< a non-null denominator has been folded
+    };
+
+    /// One entry of the group table.
+    struct Group {
+        std::vector<std::string> cells; ///< group column cells, clause order
+        std::vector<bool> nulls;
+        std::vector<Acc> accs;          ///< one entry per aggregate column
+    };
+
+    /// One shard of the group table. Responses hashing to different
+    /// shards fold concurrently without contending.
+    struct Shard {
+        std::mutex mtx;
+        std::unordered_map<std::string, Group> groups;
+    };
+
+    /// One term of the GROUP BY clause.
+    struct GroupCol {
+        std::string column;
+        int schemaIdx{-1}; ///< schema column index, set by bindSchema()
+    };
+
+    /// One output column of the result table.
+    struct OutCol {
+        enum Kind { GROUP_COL, SUM, MIN, MAX, RATIO };
+        Kind kind;
+        std::string name;     ///< final column name (alias or expression text)
+        std::string colName;  ///< partial column folded (numerator for RATIO)
+        std::string colDenom; ///< denominator partial column (RATIO only)
+        int groupIdx{-1};     ///< GROUP_COL: index into the GROUP BY terms
+        int schemaIdx{-1};    ///< schema column index, set by bindSchema()
+        int schemaIdxDenom{-1}; ///< schema index of colDenom (RATIO only)
+        int accIdx{-1};       ///< aggregate: index into Group::accs
+        bool isInt{false};    ///< integer accumulator (vs floating point)
+        std::string sqlType;  ///< SQL type of the output column
+    };
+
+    /// Try to interpret one merge select item as a combinable aggregate.
+    /// @return true on success, filling everything in 'out' except 'name'.
+    static bool _parseAggCol(query::ValueExpr const& ve, OutCol& out);
+
+    /// Fold one materialized row (all cells in schema order) into its
+    /// group table shard.
+    void _foldRow(std::vector<std::string> const& cells,
+                  std::vector<bool> const& nulls);
+
+    /// Fold all rows of a result. Never journals and never checks the
+    /// budget; add() and the render()-time refold share it.
+    void _fold(proto::Result const& result);
+
+    /// Discard the group table and refold the journal, skipping records
+    /// whose job attempt 'isInvalid'. Caller must hold _journalMtx.
+    /// @return false if the journal could not be read.
+    bool _refold(std::function<bool(int)> const& isInvalid);
+
+    static unsigned int const SHARD_COUNT = 16; ///< group table shards.
+
+    std::string const _spillDir;      ///< directory hosting the journal
+    int64_t const _memoryLimitBytes;  ///< group table memory budget
+
+    std::vector<GroupCol> _groupCols; ///< GROUP BY terms, clause order
+    std::vector<OutCol> _outCols;     ///< output columns, select-list order
+    size_t _accCount{0};              ///< aggregate columns per group
+    bool _schemaBound{false};
+
+    Shard _shards[SHARD_COUNT];
+    std::atomic<int64_t> _groupBytes{0}; ///< estimated group table memory
+    std::atomic<size_t> _groupCount{0};  ///< distinct groups folded
+
+    // The journal of every response folded so far, appended before
+    // folding so the group table can always be rebuilt from it.
+    std::mutex _journalMtx; ///< protects the journal state below.
+    std::fstream _journalFile;
+    std::string _journalFileName; ///< empty until the first response.
+    size_t _journalRecords{0};
+    bool _abandoned{false}; ///< folding stopped; journal closed to appends.
+    std::set<int> _contributingAttempts; ///< job attempts folded so far.
+};
+
+}}} // namespace lsst::qserv::rproc
+
+#endif // LSST_QSERV_RPROC_GROUPBYCOMBINER_H
@@ -39,8 +39,10 @@
 #include "rproc/InfileMerger.h"
 
 // System headers
+#include <algorithm>
 #include <chrono>
 #include <cstddef>
+#include <cstdio>
 #include <iostream>
 #include <sstream>
 #include <sys/time.h>
@@ -57,17 +59,24 @@
 #include "czar/Czar.h"
 #include "global/Bug.h"
 #include "global/intTypes.h"
+#include "mysql/AsyncQueryMgr.h"
 #include "proto/WorkerResponse.h"
 #include "proto/ProtoImporter.h"
 #include "query/SelectStmt.h"
+#include "rproc/AggregateCombiner.h"
+#include "rproc/GroupByCombiner.h"
 #include "rproc/ProtoRowBuffer.h"
+#include "rproc/ResultTablePool.h"
+#include "rproc/TopKCombiner.h"
 #include "sql/Schema.h"
 #include "sql/SqlConnection.h"
 #include "sql/SqlResults.h"
 #include "sql/SqlErrorObject.h"
 #include "sql/statement.h"
+#include "util/Histogram.h"
 #include "util/IterableFormatter.h"
 #include "util/StringHash.h"
+#include "util/Trace.h"
 
 namespace { // File-scope helpers
 
@@ -92,6 +101,36 @@ std::string getTimeStampId() {
     // Alternative (for production?) Use boost::uuid to construct ids that are
     // guaranteed to be unique.
 }
+
+// The global budget of in-flight merge memory shared by all queries of
+// this czar, and the current usage (bytes).
+std::atomic<int64_t> globalMergeMemoryLimit{int64_t(4096)*1024*1024};
+std::atomic<int64_t> globalMergeMemoryBytes{0};
+
+
+/// @return a 64-bit FNV-1a fingerprint of a result row schema. All worker
+/// responses of a query carry the same schema, so after the merge table is
+/// created each response is checked against the table with this fingerprint
+/// instead of a rebuilt sql::Schema.
+uint64_t fingerprintRowSchema(lsst::qserv::proto::RowSchema const& rs) {
+    uint64_t h = 14695981039346656037ULL;
+    auto mix = [&h](char const* data, size_t size) {
+        for (size_t i = 0; i != size; ++i) {
+            h ^= static_cast<unsigned char>(data[i]);
+            h *= 1099511628211ULL;
+        }
+    };
+    for (int i = 0, e = rs.columnschema_size(); i != e; ++i) {
+        lsst::qserv::proto::ColumnSchema const& cs = rs.columnschema(i);
+        // The terminating NUL of each field keeps adjacent fields from
+        // running together in the hash.
+        mix(cs.name().c_str(), cs.name().size() + 1);
+        mix(cs.sqltype().c_str(), cs.sqltype().size() + 1);
+        int32_t const mysqlType = cs.has_mysqltype() ? cs.mysqltype() : -1;
+        mix(reinterpret_cast<char const*>(&mysqlType), sizeof(mysqlType));
+    }
+    return h;
+}
 } // anonymous namespace
 
 namespace lsst {
@@ -103,8 +142,7 @@ namespace rproc {
 // InfileMerger public
 ////////////////////////////////////////////////////////////////////////
 InfileMerger::InfileMerger(InfileMergerConfig const& c)
-    : _config(c),
-      _mysqlConn(_config.mySqlConfig) {
+    : _config(c) {
     _alterJobIdColName(); // initialize jobIdColName.
     _fixupTargetName();
     _maxResultTableSizeMB = _config.mySqlConfig.maxTableSizeMB;
@@ -121,6 +159,33 @@ InfileMerger::InfileMerger(InfileMergerConfig const& c)
                               << " checkSizeEveryXRows=" << _checkSizeEveryXRows);
     if (_config.mergeStmt) {
         _config.mergeStmt->setFromListAsTable(_mergeTable);
+        // Pure-aggregate merges are folded in memory: each worker partial is
+        // one tiny row and round tripping 100k+ of them through the merge
+        // table costs far more than combining them here.
+        _combiner = AggregateCombiner::create(*_config.mergeStmt);
+        if (_combiner != nullptr) {
+            LOGS(_log, LOG_LVL_DEBUG, "InfileMerger combining aggregates in memory");
+        } else {
+            // Plain ORDER BY ... LIMIT merges keep only the running top K
+            // rows in memory instead of materializing every worker row in
+            // the merge table just to sort and keep K of them.
+            _topK = TopKCombiner::create(*_config.mergeStmt);
+            if (_topK != nullptr) {
+                LOGS(_log, LOG_LVL_DEBUG, "InfileMerger keeping top "
+                     << _config.mergeStmt->getLimit() << " rows in memory");
+            } else {
+                // GROUP BY merges with combinable aggregates fold into a
+                // sharded in-memory group table instead of being re-grouped
+                // by a single-threaded SELECT over the merge table.
+                _groupBy = GroupByCombiner::create(*_config.mergeStmt,
+                                                   _config.spillDir,
+                                                   _config.mergeMemoryLimitMB);
+                if (_groupBy != nullptr) {
+                    LOGS(_log, LOG_LVL_DEBUG,
+                         "InfileMerger combining group-by aggregates in memory");
+                }
+            }
+        }
     }
 
     _invalidJobAttemptMgr.setDeleteFunc([this](InvalidJobAttemptMgr::jASetType const& jobAttempts) -> bool {
@@ -132,13 +197,31 @@ InfileMerger::InfileMerger(InfileMergerConfig const& c)
         return !_needCreateTable;
     });
 
-    if (!_setupConnection()) {
-        throw InfileMergerError(util::ErrorCode::MYSQLCONNECT, "InfileMerger mysql connect failure.");
+    // Create the pool of result-loading sessions. Concurrent worker
+    // responses are merged through separate sessions, round-robin, so
+    // they are not serialized on a single connection.
+    int connCount = std::max(_config.mergeConnectionCount, 1);
+    for (int i = 0; i < connCount; ++i) {
+        std::unique_ptr<MergeConnection> conn(new MergeConnection(_config.mySqlConfig));
+        if (!conn->setup()) {
+            throw InfileMergerError(util::ErrorCode::MYSQLCONNECT, "InfileMerger mysql connect failure.");
+        }
+        _mergeConnections.push_back(std::move(conn));
     }
+
+    // Make sure the result table pool is running against this result
+    // database; only the first configure() has any effect.
+    ResultTablePool::instance().configure(_config.mySqlConfig);
 }
 
 
 InfileMerger::~InfileMerger() {
+    if (_spillFile.is_open()) {
+        _spillFile.close();
+    }
+    if (not _spillFileName.empty()) {
+        std::remove(_spillFileName.c_str());
+    }
 }
 
 
@@ -159,6 +242,270 @@ bool InfileMerger::merge(std::shared_ptr<proto::WorkerResponse> response) {
     if (!response) {
         return false;
     }
+    // Admission control for czar merge memory: a response which does not
+    // fit the per-query or the global budget is staged to the on-disk run
+    // file and merged later, when budget frees up (or at finalize() time
+    // at the latest).
+    size_t const bytes = response->result.ByteSize();
+    if (not _reserveMergeMemory(bytes)) {
+        return _spillResponse(*response);
+    }
+    bool const ret = _merge(response);
+    _releaseMergeMemory(bytes);
+    // Budget was just released, try to merge staged responses.
+    _drainSpilled(false);
+    return ret;
+}
+
+void InfileMerger::setGlobalMergeMemoryLimitMB(size_t sizeMB) {
+    ::globalMergeMemoryLimit = int64_t(sizeMB)*1024*1024;
+}
+
+util::Histogram& InfileMerger::mergeHistogram() {
+    // Milliseconds per LOAD DATA INFILE into a merge table, aggregated over
+    // all queries of this czar.
+    static util::Histogram histogram("czarMergeMs");
+    return histogram;
+}
+
+bool InfileMerger::_reserveMergeMemory(size_t bytes) {
+    int64_t const b = int64_t(bytes);
+    int64_t const queryLimit = int64_t(_config.mergeMemoryLimitMB)*1024*1024;
+    if (_mergeMemoryBytes.fetch_add(b) + b > queryLimit) {
+        _mergeMemoryBytes.fetch_sub(b);
+        return false;
+    }
+    if (::globalMergeMemoryBytes.fetch_add(b) + b > ::globalMergeMemoryLimit.load()) {
+        ::globalMergeMemoryBytes.fetch_sub(b);
+        _mergeMemoryBytes.fetch_sub(b);
+        return false;
+    }
+    return true;
+}
+
+void InfileMerger::_releaseMergeMemory(size_t bytes) {
+    int64_t const b = int64_t(bytes);
+    _mergeMemoryBytes.fetch_sub(b);
+    ::globalMergeMemoryBytes.fetch_sub(b);
+}
+
+bool InfileMerger::_spillResponse(proto::WorkerResponse const& response) {
+    std::string record;
+    if (not response.result.SerializeToString(&record)) {
+        _error = InfileMergerError(util::ErrorCode::RESULT_IMPORT,
+                                   _getQueryIdStr() + " failed to serialize response for spilling");
+        LOGS(_log, LOG_LVL_ERROR, "InfileMerger error: " << _error.getMsg());
+        return false;
+    }
+
+    std::lock_guard<std::mutex> lock(_spillMtx);
+    if (not _spillFile.is_open()) {
+        _spillFileName = _config.spillDir + "/qserv_merge_spill_" + getTimeStampId();
+        _spillFile.open(_spillFileName,
+                        std::ios::in | std::ios::out | std::ios::trunc | std::ios::binary);
+        if (not _spillFile.is_open()) {
+            _error = InfileMergerError(util::ErrorCode::RESULT_IMPORT,
+                                       _getQueryIdStr() + " failed to open spill file " + _spillFileName);
+            LOGS(_log, LOG_LVL_ERROR, "InfileMerger error: " << _error.getMsg());
+            return false;
+        }
+        LOGS(_log, LOG_LVL_INFO, _getQueryIdStr()
+             << " merge memory budget exhausted, staging responses to " << _spillFileName);
+    }
+
+    uint32_t const length = record.size();
+    _spillFile.clear();
+    _spillFile.seekp(0, std::ios::end);
+    _spillFile.write(reinterpret_cast<char const*>(&length), sizeof length);
+    _spillFile.write(record.data(), length);
+    _spillFile.flush();
+    if (not _spillFile) {
+        _error = InfileMergerError(util::ErrorCode::RESULT_IMPORT,
+                                   _getQueryIdStr() + " failed to write spill file " + _spillFileName);
+        LOGS(_log, LOG_LVL_ERROR, "InfileMerger error: " << _error.getMsg());
+        return false;
+    }
+    ++_spillRecords;
+    return true;
+}
+
+void InfileMerger::_drainSpilled(bool force) {
+    while (true) {
+
+        auto response = std::make_shared<proto::WorkerResponse>();
+        size_t bytes = 0;
+        {
+            std::lock_guard<std::mutex> lock(_spillMtx);
+            if (_spillRecords == 0) {
+                // The backlog is empty, every held-back seal is now safe:
+                // all earlier fragments of those attempts have been merged.
+                _promotePendingSeals();
+                return;
+            }
+
+            _spillFile.clear();
+            _spillFile.seekg(_spillReadOffset);
+            uint32_t length = 0;
+            _spillFile.read(reinterpret_cast<char*>(&length), sizeof length);
+            if (not _spillFile) {
+                _error = InfileMergerError(util::ErrorCode::RESULT_IMPORT,
+                                           _getQueryIdStr() + " failed to read spill file " + _spillFileName);
+                LOGS(_log, LOG_LVL_ERROR, "InfileMerger error: " << _error.getMsg());
+                _spillRecords = 0;
+                return;
+            }
+
+            // Merge the staged record only if it fits the budgets again;
+            // at finalize() time the budgets no longer matter.
+            if (not force and not _reserveMergeMemory(length)) return;
+            bytes = length;
+
+            std::string record(length, '\0');
+            _spillFile.read(&record[0], length);
+            if (not _spillFile or not response->result.ParseFromString(record)) {
+                _error = InfileMergerError(util::ErrorCode::RESULT_IMPORT,
+                                           _getQueryIdStr() + " failed to read spill file " + _spillFileName);
+                LOGS(_log, LOG_LVL_ERROR, "InfileMerger error: " << _error.getMsg());
+                if (not force) _releaseMergeMemory(bytes);
+                _spillRecords = 0;
+                return;
+            }
+            response->headerSize = 0;
+
+            _spillReadOffset += std::streamoff(sizeof length + length);
+            --_spillRecords;
+            if (_spillRecords == 0) {
+                // All staged records have been consumed, rotate the run file.
+                _spillFile.close();
+                _spillFile.open(_spillFileName,
+                                std::ios::in | std::ios::out | std::ios::trunc | std::ios::binary);
+                _spillReadOffset = 0;
+            }
+        }
+        _merge(response);
+        if (not force) _releaseMergeMemory(bytes);
+    }
+}
+
+void InfileMerger::_sealIfFinal(proto::WorkerResponse const& response, int jobIdAttempt) {
+    // Paging only applies to queries merged through the merge table with
+    // per-row jobId bookkeeping and no merge statement.
+    if (_singleJobPassthrough || _config.mergeStmt != nullptr) return;
+    if (response.result.continues()) return; // more fragments of this attempt follow
+    bool spillBacklog;
+    {
+        std::lock_guard<std::mutex> spillLock(_spillMtx);
+        spillBacklog = _spillRecords > 0;
+    }
+    std::lock_guard<std::mutex> sealLock(_sealMtx);
+    if (_pagingClosed) return;
+    if (spillBacklog) {
+        // Earlier fragments of this attempt may still be staged in the run
+        // file; the seal is promoted when the backlog drains.
+        _pendingSeals.insert(jobIdAttempt);
+    } else {
+        _sealedAttempts.insert(jobIdAttempt);
+    }
+}
+
+void InfileMerger::_promotePendingSeals() {
+    std::lock_guard<std::mutex> sealLock(_sealMtx);
+    if (_pendingSeals.empty()) return;
+    _sealedAttempts.insert(_pendingSeals.begin(), _pendingSeals.end());
+    _pendingSeals.clear();
+}
+
+int InfileMerger::exportPage(std::string const& pageTable) {
+    // Holding _sealMtx for the whole export also serializes against
+    // finalize(), which closes paging under the same mutex; concurrent
+    // merges are unaffected as they never touch a sealed attempt's rows.
+    std::lock_guard<std::mutex> sealLock(_sealMtx);
+    if (_pagingClosed || _singleJobPassthrough || _config.mergeStmt != nullptr) {
+        return -1;
+    }
+    std::string jobIdCol;
+    {
+        std::lock_guard<std::mutex> lockTable(_createTableMutex);
+        if (_needCreateTable) return -2; // no response merged yet, schema unknown
+        jobIdCol = _jobIdColName;
+    }
+    if (_sealedAttempts.empty()) {
+        // Nothing consumable yet; hand back an empty page with the result
+        // schema so the client can keep polling.
+        bool ok = _applySqlLocal("CREATE TABLE " + pageTable + " ENGINE=MyISAM SELECT * FROM "
+                                 + _mergeTable + " WHERE 1=0", "exportPage empty");
+        if (ok) {
+            ok = _applySqlLocal("ALTER TABLE " + pageTable + " DROP COLUMN " + jobIdCol,
+                                "exportPage drop jobId");
+        }
+        return ok ? 0 : -3;
+    }
+    // Copy the sealed attempts' rows out and delete them from the merge
+    // table, several attempts at a time to keep statements under the
+    // packet limit (same chunking as _deleteInvalidRows).
+    unsigned int const maxSize = 950000;
+    std::vector<std::string> inLists;
+    auto iter = _sealedAttempts.begin();
+    auto end = _sealedAttempts.end();
+    while (iter != end) {
+        bool first = true;
+        std::string inList;
+        while (inList.size() < maxSize && iter != end) {
+            if (!first) {
+                inList += ",";
+            } else {
+                first = false;
+            }
+            inList += std::to_string(*iter);
+            ++iter;
+        }
+        inLists.push_back(inList);
+    }
+    bool ok = true;
+    bool firstChunk = true;
+    for (auto const& inList : inLists) {
+        std::string const select = " SELECT * FROM " + _mergeTable
+                + " WHERE " + jobIdCol + " IN (" + inList + ")";
+        std::string const sql = firstChunk
+                ? "CREATE TABLE " + pageTable + " ENGINE=MyISAM" + select
+                : "INSERT INTO " + pageTable + select;
+        firstChunk = false;
+        if (!(ok = _applySqlLocal(sql, "exportPage copy"))) break;
+    }
+    if (ok) {
+        ok = _applySqlLocal("ALTER TABLE " + pageTable + " DROP COLUMN " + jobIdCol,
+                            "exportPage drop jobId");
+    }
+    if (!ok) {
+        // The copy failed before anything was deleted; drop the partial
+        // page and leave the attempts sealed, the next page retries the
+        // whole batch with no rows lost or duplicated.
+        _applySqlLocal("DROP TABLE IF EXISTS " + pageTable, "exportPage cleanup");
+        return -3;
+    }
+    for (auto const& inList : inLists) {
+        if (!_applySqlLocal("DELETE FROM " + _mergeTable
+                            + " WHERE " + jobIdCol + " IN (" + inList + ")",
+                            "exportPage truncate")) {
+            // The page is complete and must be delivered, but some of its
+            // rows could not be removed from the merge table and will show
+            // up again in the final result. Losing rows would be worse;
+            // a failing DELETE means the merge table is in trouble anyway.
+            LOGS(_log, LOG_LVL_ERROR, _getQueryIdStr()
+                 << " exportPage failed to truncate consumed rows, the final"
+                 << " result may repeat rows of " << pageTable);
+            break;
+        }
+    }
+    int const exported = static_cast<int>(_sealedAttempts.size());
+    _sealedAttempts.clear();
+    LOGS(_log, LOG_LVL_DEBUG, _getQueryIdStr() << " exported page of "
+         << exported << " attempts to " << pageTable);
+    return exported;
+}
+
+bool InfileMerger::_merge(std::shared_ptr<proto::WorkerResponse>& response) {
+    util::Span span("czar.merge", response->result.queryid());
     // TODO: Check session id (once session id mgmt is implemented)
     std::string queryIdJobStr =
         QueryIdHelper::makeIdStr(response->result.queryid(), response->result.jobid());
@@ -182,24 +529,129 @@ bool InfileMerger::merge(std::shared_ptr<proto::WorkerResponse> response) {
         LOGS(_log, LOG_LVL_ERROR, "Error in response data: " << _error);
         return false;
     }
+    {
+        std::lock_guard<std::mutex> combinerLock(_combinerMtx);
+        if (_combiner != nullptr) {
+            if (!_combiner->schemaBound()
+                && !_combiner->bindSchema(response->result.rowschema())) {
+                // A partial column the combiner can't fold (e.g. non-numeric
+                // MIN/MAX); fall back to the SQL merge path before any rows
+                // have been consumed.
+                LOGS(_log, LOG_LVL_DEBUG, queryIdJobStr
+                     << " in-memory combine not applicable, using merge table");
+                _combiner.reset();
+            } else {
+                _combiner->add(response->result,
+                               makeJobIdAttempt(response->result.jobid(),
+                                                response->result.attemptcount()));
+                return true;
+            }
+        }
+    }
+    {
+        std::lock_guard<std::mutex> topKLock(_topKMtx);
+        if (_topK != nullptr) {
+            if (!_topK->schemaBound()
+                && !_topK->bindSchema(response->result.rowschema())) {
+                // A sort column the combiner can't order (e.g. a string
+                // needing mysqld's collation); fall back to the SQL merge
+                // path before any rows have been consumed.
+                LOGS(_log, LOG_LVL_DEBUG, queryIdJobStr
+                     << " in-memory top-K not applicable, using merge table");
+                _topK.reset();
+            } else {
+                _topK->add(response->result,
+                           makeJobIdAttempt(response->result.jobid(),
+                                            response->result.attemptcount()));
+                return true;
+            }
+        }
+    }
+    {
+        std::shared_ptr<GroupByCombiner> groupBy;
+        {
+            std::lock_guard<std::mutex> groupByLock(_groupByMtx);
+            if (_groupBy != nullptr && !_groupBy->schemaBound()
+                && !_groupBy->bindSchema(response->result.rowschema())) {
+                // A group or partial column the combiner can't handle (e.g.
+                // a string group key needing mysqld's collation); fall back
+                // to the SQL merge path before any rows have been consumed.
+                LOGS(_log, LOG_LVL_DEBUG, queryIdJobStr
+                     << " in-memory group-by combine not applicable, using merge table");
+                _groupBy.reset();
+            }
+            groupBy = _groupBy;
+        }
+        if (groupBy != nullptr) {
+            int const jobIdAttempt = makeJobIdAttempt(response->result.jobid(),
+                                                      response->result.attemptcount());
+            auto const status = groupBy->add(response->result, jobIdAttempt);
+            if (status == GroupByCombiner::AddStatus::FOLDED) {
+                return true;
+            }
+            {
+                std::lock_guard<std::mutex> groupByLock(_groupByMtx);
+                _groupBy.reset();
+            }
+            if (status == GroupByCombiner::AddStatus::EXCEEDED) {
+                // The group table outgrew its memory budget. Everything
+                // folded so far (including this response) is in the
+                // combiner's journal; replay it into the merge table.
+                return _replayGroupByJournal(groupBy);
+            }
+            if (status == GroupByCombiner::AddStatus::ERROR) {
+                _error = InfileMergerError(util::ErrorCode::RESULT_IMPORT,
+                        _getQueryIdStr() + " failed to journal response for group-by combine");
+                LOGS(_log, LOG_LVL_ERROR, "InfileMerger error: " << _error.getMsg());
+                return false;
+            }
+            // DIVERTED: another response triggered the fallback and owns
+            // the journal replay; merge this one through the table.
+        }
+    }
+
     if (_needCreateTable) {
         if (!_setupTable(*response)) {
             return false;
         }
+    } else if (fingerprintRowSchema(response->result.rowschema()) != _schemaFingerprint) {
+        // The response's schema does not match the merge table; loading its
+        // rows would corrupt the result, so reject it.
+        _error = InfileMergerError(util::ErrorCode::RESULT_IMPORT,
+                                   queryIdJobStr + " row schema differs from merge table schema");
+        LOGS(_log, LOG_LVL_ERROR, "Error in response data: " << _error);
+        return false;
     }
 
-    // Nothing to do if size is zero.
-    if (response->result.row_size() == 0) {
+    // Nothing to do if there are no rows in either representation.
+    int rowsInMsg = response->result.row_size();
+    if (response->result.has_rowblock()) {
+        rowsInMsg += response->result.rowblock().numrows();
+    }
+    if (rowsInMsg == 0) {
+        _sealIfFinal(*response, makeJobIdAttempt(response->result.jobid(),
+                                                 response->result.attemptcount()));
         return true;
     }
-    _sizeCheckRowCount += response->result.row_size();
+    _sizeCheckRowCount += rowsInMsg;
 
     bool ret = false;
-    // Add columns to rows in virtFile.
+    // Add columns to rows in virtFile. In single-job passthrough mode the
+    // rows are loaded as-is (negative jobId, no bookkeeping column).
     int resultJobId = makeJobIdAttempt(response->result.jobid(), response->result.attemptcount());
-    ProtoRowBuffer::Ptr pRowBuffer = std::make_shared<ProtoRowBuffer>(response->result,
-                                     resultJobId, _jobIdColName, _jobIdSqlType, _jobIdMysqlType);
-    std::string const virtFile = _infileMgr.prepareSrc(pRowBuffer, queryIdJobStr);
+    int const loadJobId = _singleJobPassthrough ? -1 : resultJobId;
+    mysql::RowBuffer::Ptr pRowBuffer;
+    if (response->result.has_rowblock()) {
+        pRowBuffer = std::make_shared<BlockRowBuffer>(response->result, loadJobId);
+    } else {
+        pRowBuffer = std::make_shared<ProtoRowBuffer>(response->result,
+                                     loadJobId, _jobIdColName, _jobIdSqlType, _jobIdMysqlType);
+    }
+    // Grab a loading session; different responses spread over the pool so
+    // they only wait on each other when the pool is fully busy.
+    MergeConnection& mergeConn = _getMergeConnection();
+    std::lock_guard<std::mutex> connLock(mergeConn.mtx);
+    std::string const virtFile = mergeConn.infileMgr.prepareSrc(pRowBuffer, queryIdJobStr);
     std::string const infileStatement = sql::formLoadInfile(_mergeTable, virtFile);
     auto start = std::chrono::system_clock::now();
     // If the job attempt is invalid, exit without adding rows.
@@ -207,11 +659,27 @@ bool InfileMerger::merge(std::shared_ptr<proto::WorkerResponse> response) {
     if (_invalidJobAttemptMgr.incrConcurrentMergeCount(resultJobId)) {
         return true;
     }
-    ret = _applyMysql(infileStatement);
+    ret = _applyMysql(infileStatement, mergeConn);
     _invalidJobAttemptMgr.decrConcurrentMergeCount();
     auto end = std::chrono::system_clock::now();
     auto mergeDur = std::chrono::duration_cast<std::chrono::milliseconds>(end - start);
-    LOGS(_log, LOG_LVL_DEBUG, queryIdJobStr << " mergeDur=" << mergeDur.count());
+    mergeHistogram().record(mergeDur.count() > 0 ? mergeDur.count() : 0);
+    _totalMergeMs += mergeDur.count() > 0 ? mergeDur.count() : 0;
+    LOGS(_log, LOG_LVL_DEBUG, queryIdJobStr << " mergeDur=" << mergeDur.count()
+         << " " << mergeHistogram().summary());
+    // For plain LIMIT queries, tell the executive once the merged result
+    // already satisfies the LIMIT so the remaining jobs can be squashed.
+    if (ret) {
+        auto totalRows = (_totalResultRows += rowsInMsg);
+        _totalResultBytes += response->result.ByteSize();
+        if (_rowLimit > 0 && totalRows >= _rowLimit && _rowLimitFunc != nullptr
+            && !_rowLimitHit.exchange(true)) {
+            LOGS(_log, LOG_LVL_DEBUG, queryIdJobStr << " row limit " << _rowLimit
+                 << " satisfied with " << totalRows << " rows merged");
+            _rowLimitFunc();
+        }
+        _sealIfFinal(*response, resultJobId);
+    }
     /// Check the size of the result table.
     if (_sizeCheckRowCount >= _checkSizeEveryXRows) {
         auto tSize = _getResultTableSizeMB();
@@ -241,20 +709,41 @@ bool InfileMerger::merge(std::shared_ptr<proto::WorkerResponse> response) {
 }
 
 
-bool InfileMerger::_applyMysql(std::string const& query) {
-    std::lock_guard<std::mutex> lock(_mysqlMutex);
-    if (!_mysqlConn.connected()) {
+/// Apply a query on the given merge connection. The caller must hold
+/// conn.mtx; merge() takes it when selecting the connection.
+bool InfileMerger::_applyMysql(std::string const& query, MergeConnection& conn) {
+    if (!conn.mysqlConn.connected()) {
         // should have connected during construction
         // Try reconnecting--maybe we timed out.
-        if (!_setupConnection()) {
-            LOGS(_log, LOG_LVL_ERROR, "InfileMerger::_applyMysql _setupConnection() failed!!!");
+        if (!conn.setup()) {
+            LOGS(_log, LOG_LVL_ERROR, "InfileMerger::_applyMysql reconnect failed!!!");
             return false; // Reconnection failed. This is an error.
         }
     }
 
-    int rc = mysql_real_query(_mysqlConn.getMySql(),
-                              query.data(), query.size());
-    return rc == 0;
+    // Drive the statement through the shared event-loop threads rather
+    // than blocking this thread inside the client library.
+    auto future = mysql::AsyncQueryMgr::instance()->submitFuture(conn.mysqlConn, query);
+    return future.get();
+}
+
+
+bool InfileMerger::_replayGroupByJournal(std::shared_ptr<GroupByCombiner> const& combiner) {
+    LOGS(_log, LOG_LVL_INFO, _getQueryIdStr()
+         << " group-by memory budget exhausted with " << combiner->groupCount()
+         << " groups, replaying journal into merge table");
+    bool ok = combiner->drainJournal([this](proto::Result& result) {
+        auto response = std::make_shared<proto::WorkerResponse>();
+        response->result.Swap(&result);
+        response->headerSize = 0;
+        return _merge(response);
+    });
+    if (!ok) {
+        _error = InfileMergerError(util::ErrorCode::RESULT_IMPORT,
+                                   _getQueryIdStr() + " failed to replay group-by journal");
+        LOGS(_log, LOG_LVL_ERROR, "InfileMerger error: " << _error.getMsg());
+    }
+    return ok;
 }
 
 
@@ -264,11 +753,80 @@ bool InfileMerger::finalize() {
     if (_isFinished) {
         LOGS(_log, LOG_LVL_ERROR, "InfileMerger::finalize(), but _isFinished == true");
     }
+    {
+        // Stop page exports; rows not consumed through exportPage() are
+        // delivered through the normal result path below. Taking the mutex
+        // also waits out an export still in flight.
+        std::lock_guard<std::mutex> sealLock(_sealMtx);
+        _pagingClosed = true;
+    }
+    // Merge any responses still staged in the run file, the memory budgets
+    // no longer matter as no new responses are coming in.
+    _drainSpilled(true);
     // Delete all invalid rows in the table.
     if (not _invalidJobAttemptMgr.holdMergingForRowDelete("finalize")) {
         LOGS(_log, LOG_LVL_ERROR, " failed to remove invalid rows.");
         return false;
     }
+    if (_combiner != nullptr) {
+        // In-memory combine: render the single result row directly into the
+        // target table. Partials from invalidated job attempts are skipped
+        // at fold time, and there is no merge table to aggregate or drop.
+        std::string createStmt;
+        std::string insertStmt;
+        _combiner->render(_config.targetTable,
+                          [this](int jobIdAttempt) {
+                              return _invalidJobAttemptMgr.isJobAttemptInvalid(jobIdAttempt);
+                          },
+                          createStmt, insertStmt);
+        LOGS(_log, LOG_LVL_DEBUG, "Combining " << _combiner->partialCount()
+             << " partials w/" << insertStmt);
+        finalizeOk = _applySqlLocal(createStmt, "combinerCreate")
+                 and _applySqlLocal(insertStmt, "combinerInsert");
+        _isFinished = true;
+        return finalizeOk;
+    }
+    if (_topK != nullptr) {
+        // In-memory top-K: render the retained rows into the target table
+        // in final order. Rows from invalidated job attempts are skipped at
+        // render time, and there is no merge table to sort or drop.
+        std::string createStmt;
+        std::vector<std::string> insertStmts;
+        _topK->render(_config.targetTable,
+                      [this](int jobIdAttempt) {
+                          return _invalidJobAttemptMgr.isJobAttemptInvalid(jobIdAttempt);
+                      },
+                      createStmt, insertStmts);
+        LOGS(_log, LOG_LVL_DEBUG, "Top-K rendering from " << _topK->retainedCount()
+             << " retained rows w/" << createStmt);
+        finalizeOk = _applySqlLocal(createStmt, "topKCreate");
+        for (auto const& insertStmt : insertStmts) {
+            finalizeOk = finalizeOk and _applySqlLocal(insertStmt, "topKInsert");
+        }
+        _isFinished = true;
+        return finalizeOk;
+    }
+    if (_groupBy != nullptr) {
+        // In-memory group-by combine: render the grouped rows directly
+        // into the target table. If an invalidated job attempt
+        // contributed, the combiner refolds its journal without it first;
+        // there is no merge table to aggregate or drop.
+        std::string createStmt;
+        std::vector<std::string> insertStmts;
+        finalizeOk = _groupBy->render(_config.targetTable,
+                      [this](int jobIdAttempt) {
+                          return _invalidJobAttemptMgr.isJobAttemptInvalid(jobIdAttempt);
+                      },
+                      createStmt, insertStmts);
+        LOGS(_log, LOG_LVL_DEBUG, "Group-by combining " << _groupBy->groupCount()
+             << " groups w/" << createStmt);
+        finalizeOk = finalizeOk and _applySqlLocal(createStmt, "groupByCreate");
+        for (auto const& insertStmt : insertStmts) {
+            finalizeOk = finalizeOk and _applySqlLocal(insertStmt, "groupByInsert");
+        }
+        _isFinished = true;
+        return finalizeOk;
+    }
     if (_mergeTable != _config.targetTable) {
         // Aggregation needed: Do the aggregation.
         std::string mergeSelect = _config.mergeStmt->getQueryTemplate().sqlFragment();
@@ -283,16 +841,23 @@ bool InfileMerger::finalize() {
         // Don't report failure on not exist
         LOGS(_log, LOG_LVL_DEBUG, "Cleaning up " << _mergeTable);
 #if 1 // Set to 0 when we want to retain mergeTables for debugging.
-        bool cleanupOk = _sqlConn->dropTable(_mergeTable, eObj,
-                                             false,
-                                             _config.mySqlConfig.dbName);
+        bool cleanupOk = true;
+        if (not _needCreateTable and not _createBody.empty()) {
+            // Hand the merge table back to the pool: it is truncated in the
+            // background and offered to the next query with this schema.
+            ResultTablePool::instance().recycle(_mergeTable, _createBody);
+        } else {
+            cleanupOk = _sqlConn->dropTable(_mergeTable, eObj,
+                                            false,
+                                            _config.mySqlConfig.dbName);
+        }
 #else
         bool cleanupOk = true;
 #endif
         if (!cleanupOk) {
             LOGS(_log, LOG_LVL_DEBUG, "Failure cleaning up table " << _mergeTable);
         }
-    } else {
+    } else if (not _singleJobPassthrough) {
         // Remove jobId and attemptCount information from the result table.
         // Returning a view could be faster, but is more complicated.
         std::string sqlDropCol = std::string("ALTER TABLE ") + _mergeTable
@@ -300,6 +865,8 @@ bool InfileMerger::finalize() {
         LOGS(_log, LOG_LVL_DEBUG, "Removing w/" << sqlDropCol);
         finalizeOk = _applySqlLocal(sqlDropCol, "dropCol Removing");
     }
+    // In single-job passthrough mode the result table was loaded without
+    // the jobId column, so there is nothing to drop or rebuild here.
     LOGS(_log, LOG_LVL_DEBUG, "Merged " << _mergeTable << " into " << _config.targetTable);
     _isFinished = true;
     return finalizeOk;
@@ -311,6 +878,11 @@ bool InfileMerger::isFinished() const {
 
 
 bool InfileMerger::_deleteInvalidRows(InvalidJobAttemptMgr::jASetType const& jobIdAttempts) {
+    // In single-job passthrough mode there is no jobId column, and all
+    // rows in the table belong to the invalidated (only) job attempt.
+    if (_singleJobPassthrough) {
+        return _applySqlLocal(std::string("DELETE FROM ") + _mergeTable, "deleteAllRows");
+    }
     // delete several rows at a time
     unsigned int maxSize = 950000; /// default 1mb limit
     auto iter = jobIdAttempts.begin();
@@ -354,6 +926,12 @@ int InfileMerger::makeJobIdAttempt(int jobId, int attemptCount) {
 
 bool InfileMerger::prepScrub(int jobId, int attemptCount) {
     int jobIdAttempt = makeJobIdAttempt(jobId, attemptCount);
+    {
+        // An invalidated attempt must not be handed out as a page.
+        std::lock_guard<std::mutex> sealLock(_sealMtx);
+        _sealedAttempts.erase(jobIdAttempt);
+        _pendingSeals.erase(jobIdAttempt);
+    }
     return _invalidJobAttemptMgr.prepScrub(jobIdAttempt);
 }
 
@@ -506,7 +1084,11 @@ bool InfileMerger::_setupTable(proto::WorkerResponse const& response) {
 
 
         sql::Schema schema;
-        {
+        if (_singleJobPassthrough) {
+            // Single-job passthrough: all rows belong to the only job
+            // attempt, so no bookkeeping column is needed to scrub them.
+            schema.columns = sch.columns;
+        } else {
             sql::ColSchema scs;
             scs.name              = _jobIdColName;
             scs.colType.mysqlType = _jobIdMysqlType;
@@ -515,18 +1097,42 @@ bool InfileMerger::_setupTable(proto::WorkerResponse const& response) {
             schema.columns.insert(schema.columns.end(), sch.columns.begin(), sch.columns.end());
         }
         std::string createStmt = sql::formCreateTable(_mergeTable, schema);
+        // Keep the body of the statement (everything past the table name)
+        // separate: it keys this table's schema in the ResultTablePool.
+        _createBody = createStmt.substr(std::string("CREATE TABLE ").size() + _mergeTable.size());
+        // Index the jobId column so that scrubbing the rows of invalid job
+        // attempts is an index-ranged delete instead of a full-table scan.
+        // The index costs a little on every load but keeps the scrub (and
+        // the pause of merging around it) short during retry storms.
+        if (not _singleJobPassthrough) {
+            _createBody.insert(_createBody.rfind(')'), ",KEY(`" + _jobIdColName + "`)");
+        }
         // Specifying engine. There is some question about whether InnoDB or MyISAM is the better
         // choice when multiple threads are writing to the result table.
-        createStmt += " ENGINE=MyISAM";
-        LOGS(_log, LOG_LVL_DEBUG, _getQueryIdStr() << "InfileMerger query prepared: " << createStmt);
-
-        if (not _applySqlLocal(createStmt, "setupTable")) {
+        _createBody += " ENGINE=MyISAM";
+        LOGS(_log, LOG_LVL_DEBUG, _getQueryIdStr() << "InfileMerger query prepared: "
+             << "CREATE TABLE " << _mergeTable << _createBody);
+
+        // Prefer claiming a pre-created empty table from the pool: renaming
+        // it into place is a metadata operation, so the first response is
+        // not delayed by CREATE TABLE DDL. Fall back to creating the table.
+        bool created = false;
+        std::string const pooled = ResultTablePool::instance().claim(_createBody);
+        if (not pooled.empty()) {
+            created = _applySqlLocal("RENAME TABLE " + pooled + " TO " + _mergeTable,
+                                     "claimPooledTable");
+        }
+        if (not created) {
+            created = _applySqlLocal("CREATE TABLE " + _mergeTable + _createBody, "setupTable");
+        }
+        if (not created) {
             _error = InfileMergerError(util::ErrorCode::CREATE_TABLE,
                                        "Error creating table (" + _mergeTable + ")");
             _isFinished = true; // Cannot continue.
             LOGS(_log, LOG_LVL_ERROR, _getQueryIdStr() << "InfileMerger sql error: " << _error.getMsg());
             return false;
         }
+        _schemaFingerprint = fingerprintRowSchema(rs);
         _needCreateTable = false;
     } else {
         // Do nothing, table already created.
@@ -30,10 +30,14 @@
 /// (see individual class documentation for more information)
 
 // System headers
+#include <atomic>
+#include <cstdint>
+#include <fstream>
 #include <memory>
 #include <mutex>
 #include <set>
 #include <string>
+#include <vector>
 
 // Qserv headers
 #include "mysql/LocalInfile.h"
@@ -42,6 +46,7 @@
 #include "sql/SqlConnection.h"
 #include "util/Error.h"
 #include "util/EventThread.h"
+#include "util/Histogram.h"
 
 // Forward declarations
 namespace lsst {
@@ -70,6 +75,10 @@ namespace lsst {
 namespace qserv {
 namespace rproc {
 
+class AggregateCombiner;
+class GroupByCombiner;
+class TopKCombiner;
+
 /** \typedef InfileMergerError Store InfileMerger error code.
  *
  * \note:
@@ -91,6 +100,9 @@ public:
     mysql::MySqlConfig const mySqlConfig;
     std::string targetTable;
     std::shared_ptr<query::SelectStmt> mergeStmt;
+    int mergeConnectionCount{4}; ///< Number of concurrent result-loading sessions.
+    std::string spillDir{"/tmp"}; ///< Directory for the per-query merge spill (run) files.
+    size_t mergeMemoryLimitMB{256}; ///< Per-query budget of in-flight merge memory.
 };
 
 
@@ -161,6 +173,12 @@ private:
 /// Bytes 1 - size_ph : ProtoHeader message (containing size of result message)
 /// Bytes size_ph - size_ph + size_rm : Result message
 /// At present, Result messages are not chained.
+///
+/// The memory held by in-flight merges is kept within per-query and global
+/// budgets: a response which does not fit the budgets is staged (spilled)
+/// to a per-query on-disk run file and merged later, when budget frees up
+/// or at finalize() time at the latest. This keeps czar memory predictable
+/// under concurrent large-result extractions.
 class InfileMerger {
 public:
     explicit InfileMerger(InfileMergerConfig const& c);
@@ -170,6 +188,24 @@ public:
     // @return the size of the large result thread pool.
     static int setLargeResultPoolSize(int size);
 
+    /// Set the global budget of in-flight merge memory shared by all
+    /// queries of this czar. Responses over budget are staged to per-query
+    /// on-disk run files instead of being held in memory.
+    static void setGlobalMergeMemoryLimitMB(size_t sizeMB);
+
+    /// @return the histogram of per-LOAD merge durations (milliseconds),
+    /// shared by all queries of this czar; read by the /metrics endpoint.
+    static util::Histogram& mergeHistogram();
+
+    /// @return total milliseconds this query has spent in merge LOADs so far.
+    uint64_t getTotalMergeMs() const { return _totalMergeMs.load(); }
+
+    /// @return total result rows merged so far.
+    int64_t getTotalResultRows() const { return _totalResultRows.load(); }
+
+    /// @return total result message bytes merged so far.
+    int64_t getTotalResultBytes() const { return _totalResultBytes.load(); }
+
     /// Merge a worker response, which contains:
     /// Size of ProtoHeader message
     /// ProtoHeader message
@@ -190,9 +226,91 @@ public:
     bool scrubResults(int jobId, int attempt);
     int makeJobIdAttempt(int jobId, int attemptCount);
 
+    /// Export the rows of all sealed job attempts (attempts whose final
+    /// response has been merged) into 'pageTable' and delete them from the
+    /// merge table, so a client can consume the result of a long-running
+    /// ASYNC query in pages while the remaining chunks are still merging.
+    /// Only valid for queries merged through the merge table without a
+    /// merge statement; finalize() closes paging, and rows not consumed
+    /// here are delivered through the normal result path.
+    /// @return the number of attempts exported (0 for an empty page), or
+    ///   -1 if paging is closed or not applicable to this query,
+    ///   -2 if no response has been merged yet (result schema unknown),
+    ///   -3 on an SQL error (no rows are lost; the page can be retried).
+    int exportPage(std::string const& pageTable);
+
+    /// Enable the single-job passthrough mode. To be called before any
+    /// response is merged, and only for queries with exactly one job and
+    /// no merge statement. Rows are loaded without the jobId bookkeeping
+    /// column, finalize() skips the column-dropping table rebuild, and
+    /// invalidating the (only) job attempt clears the whole table.
+    void setSingleJobPassthrough() { _singleJobPassthrough = true; }
+
+    /// Set the number of rows that satisfies the user query's LIMIT and a
+    /// function to call (once) when that many rows have been merged. Only
+    /// meaningful for plain LIMIT queries where any rows are an acceptable
+    /// answer; the caller uses it to squash the remaining jobs.
+    void setRowLimit(int64_t rowLimit, std::function<void()> const& func) {
+        _rowLimit = rowLimit;
+        _rowLimitFunc = func;
+    }
+
 private:
-    bool _applyMysql(std::string const& query);
+    /// One mysql session used for loading result rows. InfileMerger keeps a
+    /// small pool of these so that concurrent worker responses can LOAD DATA
+    /// through separate sessions instead of serializing on one connection.
+    struct MergeConnection {
+        explicit MergeConnection(mysql::MySqlConfig const& cfg) : mysqlConn(cfg) {}
+
+        bool setup() {
+            if (mysqlConn.connect()) {
+                infileMgr.attach(mysqlConn.getMySql());
+                return true;
+            }
+            return false;
+        }
+
+        mysql::MySqlConnection mysqlConn;
+        mysql::LocalInfile::Mgr infileMgr;
+        std::mutex mtx; ///< serializes use of this session.
+    };
+
+    /// @return the next merge connection, round-robin.
+    MergeConnection& _getMergeConnection() {
+        return *_mergeConnections[_mergeConnSeq++ % _mergeConnections.size()];
+    }
+
+    bool _applyMysql(std::string const& query, MergeConnection& conn);
     bool _merge(std::shared_ptr<proto::WorkerResponse>& response);
+
+    /// Replay every response the group-by combiner consumed through the
+    /// merge-table path. Called after the combiner's group table outgrew
+    /// its memory budget, with _groupBy already reset.
+    /// @return true if the whole journal was merged successfully.
+    bool _replayGroupByJournal(std::shared_ptr<GroupByCombiner> const& combiner);
+
+    /// Try to reserve merge memory for a response of the given size
+    /// against both the per-query and the global budgets.
+    /// @return false if either budget is exhausted.
+    bool _reserveMergeMemory(size_t bytes);
+    void _releaseMergeMemory(size_t bytes);
+
+    /// Stage a response to the on-disk run file to be merged later.
+    /// @return true if the response was staged successfully.
+    bool _spillResponse(proto::WorkerResponse const& response);
+
+    /// Merge staged responses while the budgets allow it; with force set
+    /// the budgets are ignored and the run file is drained completely.
+    void _drainSpilled(bool force);
+
+    /// Mark a job attempt consumable by exportPage() once its final
+    /// response has been merged. While staged responses are pending in
+    /// the run file the seal is held back, as earlier fragments of the
+    /// attempt may still be in the backlog.
+    void _sealIfFinal(proto::WorkerResponse const& response, int jobIdAttempt);
+
+    /// Promote held-back seals once the spill backlog has fully drained.
+    void _promotePendingSeals();
     int _readHeader(proto::ProtoHeader& header, char const* buffer, int length);
     int _readResult(proto::Result& result, char const* buffer, int length);
     bool _verifySession(int sessionId);
@@ -206,15 +324,34 @@ private:
     void _setQueryIdStr(std::string const& qIdStr);
     void _fixupTargetName();
 
-    bool _setupConnection() {
-        if (_mysqlConn.connect()) {
-            _infileMgr.attach(_mysqlConn.getMySql());
-            return true;
-        }
-        return false;
-    }
-
     InfileMergerConfig _config; ///< Configuration
+
+    /// In-memory combiner for pure-aggregate merge statements; worker
+    /// partials are folded here instead of being loaded into the merge
+    /// table. Reset to nullptr (under _combinerMtx) if the first response
+    /// shows a schema the combiner can't fold, falling back to SQL merging.
+    std::shared_ptr<AggregateCombiner> _combiner;
+    std::mutex _combinerMtx; ///< protects _combiner and its contents
+
+    /// In-memory top-K retention for plain ORDER BY ... LIMIT merge
+    /// statements; only rows that can still place in the final top K are
+    /// kept, so the result table receives exactly K rows. Reset to nullptr
+    /// (under _topKMtx) if the first response shows a schema the combiner
+    /// can't order, falling back to SQL merging.
+    std::shared_ptr<TopKCombiner> _topK;
+    std::mutex _topKMtx; ///< protects _topK and its contents
+
+    /// In-memory sharded hash aggregation for GROUP BY merge statements
+    /// with combinable aggregates; response threads fold their partials
+    /// concurrently into per-shard group tables and the final rows go
+    /// straight to the result table. Reset to nullptr (under _groupByMtx)
+    /// if the first response shows a schema the combiner can't handle, or
+    /// when the group table outgrows its memory budget, in which case the
+    /// combiner's journal of consumed responses is replayed through the
+    /// SQL merge path.
+    std::shared_ptr<GroupByCombiner> _groupBy;
+    std::mutex _groupByMtx; ///< protects the _groupBy pointer
+
     std::shared_ptr<sql::SqlConnection> _sqlConn; ///< SQL connection
     std::string _mergeTable; ///< Table for result loading
     InfileMergerError _error; ///< Error state
@@ -222,16 +359,23 @@ private:
     std::mutex _createTableMutex; ///< protection from creating tables
     std::mutex _sqlMutex; ///< Protection for SQL connection
     bool _needCreateTable{true}; ///< Does the target table need creating?
+    /// Fingerprint of the row schema the merge table was created from; all
+    /// responses of a query carry the same schema, so later responses are
+    /// checked against the table with a 64-bit compare instead of a
+    /// rebuilt sql::Schema. Zero until the table exists.
+    std::atomic<uint64_t> _schemaFingerprint{0};
+    /// The body of the CREATE statement of the merge table (everything past
+    /// the table name), set under _createTableMutex. It keys the table in
+    /// the ResultTablePool when the table is claimed and recycled.
+    std::string _createBody;
     size_t _getResultTableSizeMB(); ///< Return the size of the result table in MB.
     /// Alter the jobId column name in hopes that it will be unique.
     void _alterJobIdColName() {
         _jobIdColName = "jobId" + std::to_string(_jobIdColNameAdj++);
     }
 
-    mysql::MySqlConnection _mysqlConn;
-
-    std::mutex _mysqlMutex;
-    lsst::qserv::mysql::LocalInfile::Mgr _infileMgr;
+    std::vector<std::unique_ptr<MergeConnection>> _mergeConnections; ///< pool of loading sessions.
+    std::atomic<unsigned int> _mergeConnSeq{0}; ///< round-robin counter for _getMergeConnection().
 
     std::mutex _queryIdStrMtx; ///< protects _queryIdStr
     std::atomic<bool> _queryIdStrSet{false};
@@ -246,10 +390,40 @@ private:
     InvalidJobAttemptMgr _invalidJobAttemptMgr;
     bool _deleteInvalidRows(std::set<int> const& jobIdAttempts);
 
+    /// Single-job queries skip the jobId bookkeeping column entirely;
+    /// see setSingleJobPassthrough().
+    bool _singleJobPassthrough{false};
+
 
     int _sizeCheckRowCount{0}; ///< Number of rows read since last size check.
     int _checkSizeEveryXRows{1000}; ///< Check the size of the result table after every x number of rows.
     size_t _maxResultTableSizeMB{5000}; ///< Max result table size.
+
+    // The spill (run) file of responses which did not fit the merge-memory
+    // budgets. Records are appended at the tail and consumed from the head;
+    // the file is truncated whenever all staged records have been merged.
+    std::mutex _spillMtx; ///< protects the spill file state below.
+    std::fstream _spillFile; ///< per-query run file of staged responses.
+    std::string _spillFileName; ///< empty until the first response is staged.
+    std::streamoff _spillReadOffset{0}; ///< offset of the next staged record.
+    size_t _spillRecords{0}; ///< number of staged records not merged yet.
+    std::atomic<int64_t> _mergeMemoryBytes{0}; ///< in-flight merge memory of this query.
+
+    // Paged result retrieval (exportPage). An attempt is sealed when its
+    // final response has landed in the merge table; sealed attempts' rows
+    // may be handed out as a page and deleted from the table. prepScrub()
+    // unseals an attempt being invalidated, and finalize() closes paging.
+    std::mutex _sealMtx; ///< protects the three members below.
+    std::set<int> _sealedAttempts; ///< attempts consumable by the next page.
+    std::set<int> _pendingSeals;   ///< seals held back by the spill backlog.
+    bool _pagingClosed{false};     ///< set at finalize(), no more pages.
+
+    std::atomic<int64_t> _totalResultRows{0}; ///< Total rows merged so far.
+    std::atomic<int64_t> _totalResultBytes{0}; ///< Total result message bytes merged so far.
+    std::atomic<uint64_t> _totalMergeMs{0}; ///< Total milliseconds spent in merge LOADs.
+    int64_t _rowLimit{0}; ///< Rows needed to satisfy a plain LIMIT; 0: scan everything.
+    std::atomic<bool> _rowLimitHit{false}; ///< Ensures _rowLimitFunc runs only once.
+    std::function<void()> _rowLimitFunc; ///< Called when _rowLimit rows have been merged.
 };
 
 }}} // namespace lsst::qserv::rproc
@@ -23,7 +23,9 @@
 #include "rproc/ProtoRowBuffer.h"
 
 // System headers
+#include <algorithm>
 #include <cassert>
+#include <cctype>
 #include <sstream>
 #include <stdexcept>
 #include <string.h>
@@ -60,6 +62,28 @@ std::string printCharVect(std::vector<char> const& cVect) {
     return str;
 }
 
+/// @return true if cells of the given SQL type render from digits, sign,
+/// decimal point, exponent, dash, colon, period and space characters only,
+/// none of which require LOAD DATA escaping or field quoting. This covers
+/// the numeric types and the date/time types.
+bool isNoEscapeSqlType(std::string const& sqlType) {
+    static std::vector<std::string> const prefixes = {
+        "TINYINT", "SMALLINT", "MEDIUMINT", "INTEGER", "INT", "BIGINT",
+        "FLOAT", "DOUBLE", "DECIMAL", "NUMERIC", "REAL", "YEAR",
+        "DATETIME", "DATE", "TIMESTAMP", "TIME"};
+    std::string upper;
+    upper.reserve(sqlType.size());
+    for (char c : sqlType) {
+        upper += std::toupper(static_cast<unsigned char>(c));
+    }
+    for (auto const& prefix : prefixes) {
+        if (upper.compare(0, prefix.size(), prefix) == 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
 } // namespace
 
 
@@ -79,44 +103,119 @@ ProtoRowBuffer::ProtoRowBuffer(proto::Result& res, int jobId, std::string const&
       _jobIdColName(jobIdColName),
       _jobIdSqlType(jobIdSqlType),
       _jobIdMysqlType(jobIdMysqlType) {
-    _jobIdStr = std::string("'") + std::to_string(jobId) + "'";
-    _initSchema();
-    if (_result.row_size() > 0) {
-        _initCurrentRow();
+    // A negative jobId suppresses the bookkeeping column entirely
+    // (single-job passthrough, no scrubbing by jobId needed).
+    if (jobId >= 0) {
+        _jobIdStr = std::to_string(jobId);
     }
+    _initSchema();
 }
 
 
-/// Fetch a up to a single row from from the Result message
+/// Fill 'buffer' with as many escaped rows from the Result message as fit.
+/// Rows are escaped directly into the LocalInfile callback buffer; only a
+/// row that straddles the end of the buffer is staged through _currentRow,
+/// so result bytes are normally written just once.
 unsigned ProtoRowBuffer::fetch(char* buffer, unsigned bufLen) {
     unsigned fetched = 0;
-    if (bufLen <= _currentRow.size()) {
-        memcpy(buffer, &_currentRow[0], bufLen);
-        _currentRow.erase(_currentRow.begin(), _currentRow.begin() + bufLen);
-        fetched = bufLen;
-    } else { // Want more than we have.
-        if (_currentRow.size()) {
-            memcpy(buffer, &_currentRow[0], _currentRow.size());
-            fetched = _currentRow.size();
-            _currentRow.clear();
+    // Drain any partial row held over from the previous fetch.
+    if (!_currentRow.empty()) {
+        if (bufLen < _currentRow.size()) {
+            memcpy(buffer, &_currentRow[0], bufLen);
+            _currentRow.erase(_currentRow.begin(), _currentRow.begin() + bufLen);
+            return bufLen;
         }
+        memcpy(buffer, &_currentRow[0], _currentRow.size());
+        fetched = _currentRow.size();
+        _currentRow.clear();
     }
-    if ((_currentRow.size() == 0) && (_rowIdx < _rowTotal)) {
-        _readNextRow();
+    while (_rowIdx < _rowTotal) {
+        proto::RowBundle const& rb = _result.row(_rowIdx);
+        if (fetched + _maxRowSize(rb) <= bufLen) {
+            // The whole row is guaranteed to fit, write it in place.
+            fetched += _writeRowBundle(buffer + fetched, rb);
+            ++_rowIdx;
+        } else {
+            // Stage the row and hand over whatever fits.
+            if (_rowIdx != 0) {
+                _currentRow.insert(_currentRow.end(), _rowSep.begin(), _rowSep.end());
+            }
+            _copyRowBundle(_currentRow, rb);
+            ++_rowIdx;
+            unsigned cpy = std::min(static_cast<unsigned>(_currentRow.size()), bufLen - fetched);
+            memcpy(buffer + fetched, &_currentRow[0], cpy);
+            _currentRow.erase(_currentRow.begin(), _currentRow.begin() + cpy);
+            fetched += cpy;
+            break;
+        }
     }
     return fetched;
 }
 
+
+unsigned ProtoRowBuffer::_maxRowSize(proto::RowBundle const& rb) const {
+    unsigned sz = _rowSep.size() + _jobIdStr.size();
+    for(int ci=0, ce=rb.column_size(); ci != ce; ++ci) {
+        sz += _colSep.size();
+        if (!rb.isnull(ci)) {
+            if (ci < static_cast<int>(_noEscape.size()) && _noEscape[ci]) {
+                sz += rb.column(ci).size(); // unquoted, escaping impossible.
+            } else {
+                sz += 2 + 2*rb.column(ci).size(); // quotes plus worst-case escaping.
+            }
+        } else {
+            sz += _nullToken.size();
+        }
+    }
+    return sz;
+}
+
+
+int ProtoRowBuffer::_writeRowBundle(char* dest, proto::RowBundle const& rb) {
+    char* p = dest;
+    if (_rowIdx != 0) {
+        p = std::copy(_rowSep.begin(), _rowSep.end(), p);
+    }
+    p = std::copy(_jobIdStr.begin(), _jobIdStr.end(), p);
+    for(int ci=0, ce=rb.column_size(); ci != ce; ++ci) {
+        // No separator before the first column if there is no jobId column.
+        if (ci != 0 or not _jobIdStr.empty()) {
+            p = std::copy(_colSep.begin(), _colSep.end(), p);
+        }
+        if (!rb.isnull(ci)) {
+            std::string const& rawColumn = rb.column(ci);
+            if (ci < static_cast<int>(_noEscape.size()) && _noEscape[ci]) {
+                // Numeric or date/time column: the cell text can never
+                // contain a byte that needs escaping, and the enclosure is
+                // optional on LOAD DATA input, so the cell goes in bare and
+                // the server skips the dequoting.
+                memcpy(p, rawColumn.data(), rawColumn.size());
+                p += rawColumn.size();
+            } else {
+                *p++ = '\'';
+                p += escapeString(p, rawColumn.begin(), rawColumn.end());
+                *p++ = '\'';
+            }
+        } else {
+            p = std::copy(_nullToken.begin(), _nullToken.end(), p);
+        }
+    }
+    return p - dest;
+}
+
 /// Import schema from the proto message into a Schema object
 void ProtoRowBuffer::_initSchema() {
     _schema.columns.clear();
+    _noEscape.clear();
 
     // Set jobId and attemptCount
-    sql::ColSchema jobIdCol;
-    jobIdCol.name = _jobIdColName;
-    jobIdCol.colType.sqlType = _jobIdSqlType;
-    jobIdCol.colType.mysqlType = _jobIdMysqlType;
-    _schema.columns.push_back(jobIdCol);
+    if (not _jobIdStr.empty()) {
+        sql::ColSchema jobIdCol;
+        jobIdCol.name = _jobIdColName;
+        jobIdCol.colType.sqlType = _jobIdSqlType;
+        jobIdCol.colType.mysqlType = _jobIdMysqlType;
+        _schema.columns.push_back(jobIdCol);
+    }
 
     proto::RowSchema const& prs = _result.rowschema();
     for(int i=0, e=prs.columnschema_size(); i != e; ++i) {
@@ -130,6 +229,7 @@ void ProtoRowBuffer::_initSchema() {
             cs.colType.mysqlType = pcs.mysqltype();
         }
         _schema.columns.push_back(cs);
+        _noEscape.push_back(isNoEscapeSqlType(pcs.sqltype()));
     }
 }
 
@@ -148,26 +248,128 @@ std::string ProtoRowBuffer::dump() const {
 }
 
 
-/// Import the next row into the buffer
-void ProtoRowBuffer::_readNextRow() {
-    ++_rowIdx;
-    if (_rowIdx >= _rowTotal) {
-        return;
+BlockRowBuffer::BlockRowBuffer(proto::Result& res, int jobId)
+    : _colSep("\t"),
+      _rowSep("\n"),
+      _nullToken("\\N"),
+      _block(res.rowblock()),
+      _rowTotal(res.rowblock().numrows()),
+      _colOffsets(res.rowblock().column_size(), 0) {
+    // A negative jobId suppresses the bookkeeping column entirely
+    // (single-job passthrough, no scrubbing by jobId needed).
+    if (jobId >= 0) {
+        _jobIdStr = std::to_string(jobId);
+    }
+    proto::RowSchema const& prs = res.rowschema();
+    _noEscape.reserve(prs.columnschema_size());
+    for (int i = 0, e = prs.columnschema_size(); i != e; ++i) {
+        _noEscape.push_back(isNoEscapeSqlType(prs.columnschema(i).sqltype()));
+    }
+}
+
+
+/// Same contract as ProtoRowBuffer::fetch, reading from the columnar block.
+unsigned BlockRowBuffer::fetch(char* buffer, unsigned bufLen) {
+    unsigned fetched = 0;
+    // Drain any partial row held over from the previous fetch.
+    if (!_currentRow.empty()) {
+        if (bufLen < _currentRow.size()) {
+            memcpy(buffer, &_currentRow[0], bufLen);
+            _currentRow.erase(_currentRow.begin(), _currentRow.begin() + bufLen);
+            return bufLen;
+        }
+        memcpy(buffer, &_currentRow[0], _currentRow.size());
+        fetched = _currentRow.size();
+        _currentRow.clear();
+    }
+    while (_rowIdx < _rowTotal) {
+        if (fetched + _maxRowSize(_rowIdx) <= bufLen) {
+            // The whole row is guaranteed to fit, write it in place.
+            fetched += _writeRow(buffer + fetched, _rowIdx);
+            ++_rowIdx;
+        } else {
+            // Stage the row and hand over whatever fits.
+            _currentRow.resize(_maxRowSize(_rowIdx));
+            int sz = _writeRow(&_currentRow[0], _rowIdx);
+            _currentRow.resize(sz);
+            ++_rowIdx;
+            unsigned cpy = std::min(static_cast<unsigned>(sz), bufLen - fetched);
+            memcpy(buffer + fetched, &_currentRow[0], cpy);
+            _currentRow.erase(_currentRow.begin(), _currentRow.begin() + cpy);
+            fetched += cpy;
+            break;
+        }
+    }
+    return fetched;
+}
+
+
+unsigned BlockRowBuffer::_maxRowSize(uint32_t rowIdx) const {
+    unsigned sz = _rowSep.size() + _jobIdStr.size();
+    for(int ci=0, ce=_block.column_size(); ci != ce; ++ci) {
+        proto::ColumnBlock const& col = _block.column(ci);
+        sz += _colSep.size();
+        if (!_isNull(col, rowIdx)) {
+            if (ci < static_cast<int>(_noEscape.size()) && _noEscape[ci]) {
+                sz += col.cellsize(rowIdx); // unquoted, escaping impossible.
+            } else {
+                sz += 2 + 2*col.cellsize(rowIdx); // quotes plus worst-case escaping.
+            }
+        } else {
+            sz += _nullToken.size();
+        }
+    }
+    return sz;
+}
+
+
+int BlockRowBuffer::_writeRow(char* dest, uint32_t rowIdx) {
+    char* p = dest;
+    if (rowIdx != 0) {
+        p = std::copy(_rowSep.begin(), _rowSep.end(), p);
+    }
+    p = std::copy(_jobIdStr.begin(), _jobIdStr.end(), p);
+    for(int ci=0, ce=_block.column_size(); ci != ce; ++ci) {
+        proto::ColumnBlock const& col = _block.column(ci);
+        // No separator before the first column if there is no jobId column.
+        if (ci != 0 or not _jobIdStr.empty()) {
+            p = std::copy(_colSep.begin(), _colSep.end(), p);
+        }
+        uint32_t len = col.cellsize(rowIdx);
+        if (_isNull(col, rowIdx)) {
+            p = std::copy(_nullToken.begin(), _nullToken.end(), p);
+        } else {
+            char const* src = col.data().data() + _colOffsets[ci];
+            if (ci < static_cast<int>(_noEscape.size()) && _noEscape[ci]) {
+                // Numeric or date/time cell, bare and unescaped (see
+                // ProtoRowBuffer::_writeRowBundle).
+                memcpy(p, src, len);
+                p += len;
+            } else {
+                *p++ = '\'';
+                p += ProtoRowBuffer::escapeString(p, src, src + len);
+                *p++ = '\'';
+            }
+            _colOffsets[ci] += len;
+        }
     }
-    _currentRow.clear();
-    // Start the new row with a row separator.
-    _currentRow.insert(_currentRow.end(), _rowSep.begin(), _rowSep.end());
-    _copyRowBundle(_currentRow, _result.row(_rowIdx));
-    LOGS(_log, LOG_LVL_TRACE, "_currentrow=" << printCharVect(_currentRow));
+    return p - dest;
 }
 
 
-/// Setup the row byte buffer
-void ProtoRowBuffer::_initCurrentRow() {
-    // Copy row and reserve 2x size.
-    int rowSize = _copyRowBundle(_currentRow, _result.row(_rowIdx));
-    LOGS(_log, LOG_LVL_TRACE, "init _rowIdx=" <<_rowIdx << " _currentrow=" << printCharVect(_currentRow));
-    _currentRow.reserve(rowSize*2); // for future usage
+bool BlockRowBuffer::_isNull(proto::ColumnBlock const& col, uint32_t rowIdx) {
+    std::string const& bitmap = col.nullbitmap();
+    size_t byteIdx = rowIdx / 8;
+    if (byteIdx >= bitmap.size()) return false;
+    return (bitmap[byteIdx] >> (rowIdx % 8)) & 1;
+}
+
+
+std::string BlockRowBuffer::dump() const {
+    std::string str("BlockRowBuffer columns=" + std::to_string(_block.column_size()));
+    str += " rows=" + std::to_string(_rowTotal);
+    str += " next=" + std::to_string(_rowIdx);
+    return str;
 }
 
 
@@ -24,7 +24,15 @@
 #define LSST_QSERV_RPROC_PROTOROWBUFFER_H
 
 // System headers
+#include <cassert>
+#include <cstdint>
+#include <cstring>
 #include <limits>
+#include <vector>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 
 // Qserv headers
@@ -38,7 +46,9 @@ namespace rproc {
 
 
 /// ProtoRowBuffer is an implementation of RowBuffer designed to allow a
-/// LocalInfile object to use a Protobufs Result message as a row source
+/// LocalInfile object to use a Protobufs Result message as a row source.
+/// A negative jobId suppresses the jobId bookkeeping column entirely
+/// (single-job passthrough).
 class ProtoRowBuffer : public mysql::RowBuffer {
 public:
     ProtoRowBuffer(proto::Result& res, int jobId, std::string const& jobIdColName,
@@ -58,6 +68,34 @@ public:
     /// \Z     ASCII 26 (Control+Z)
     /// \N     NULL
     ///
+    /// @return a pointer to the first byte in [ptr, end) that may require
+    /// escaping - a control character (anything below 0x20, a superset of
+    /// the escaped set above) or a backslash - or 'end' if there is none.
+    static inline char const* scanForEscapes(char const* ptr, char const* end) {
+#if defined(__SSE2__)
+        // Probe 16 bytes at a time. SSE2 only has signed byte compares, so
+        // the unsigned "below 0x20" test is done as min(chunk, 0x1f) == chunk.
+        __m128i const low = _mm_set1_epi8(0x1f);
+        __m128i const backslash = _mm_set1_epi8('\\');
+        while (end - ptr >= 16) {
+            __m128i chunk = _mm_loadu_si128(reinterpret_cast<__m128i const*>(ptr));
+            __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(_mm_min_epu8(chunk, low), chunk),
+                                        _mm_cmpeq_epi8(chunk, backslash));
+            int mask = _mm_movemask_epi8(hits);
+            if (mask != 0) {
+                return ptr + __builtin_ctz(mask);
+            }
+            ptr += 16;
+        }
+#endif
+        for (; ptr != end; ++ptr) {
+            if (static_cast<unsigned char>(*ptr) < 0x20 || *ptr == '\\') {
+                return ptr;
+            }
+        }
+        return end;
+    }
+
     /// @return the number of bytes written to dest
     template <typename Iter, typename CIter>
     static inline int escapeString(Iter destBegin, CIter srcBegin, CIter srcEnd) {
@@ -66,32 +104,43 @@ public:
         if (srcEnd == srcBegin) return 0;
         assert(srcEnd - srcBegin > 0);
         assert(srcEnd - srcBegin < std::numeric_limits<int>::max() / 2);
-        Iter destI = destBegin;
-        for(CIter i = srcBegin; i != srcEnd; ++i) {
-            switch(*i) {
+        // All callers pass iterators over contiguous memory, so the work can
+        // run on raw pointers: scan for the next byte needing attention and
+        // bulk-copy the clean run in front of it, instead of inspecting the
+        // source byte-by-byte.
+        char const* src = &(*srcBegin);
+        char const* const srcEndP = src + (srcEnd - srcBegin);
+        char* const dest = &(*destBegin);
+        char* destI = dest;
+        while (src != srcEndP) {
+            char const* stop = scanForEscapes(src, srcEndP);
+            if (stop != src) {
+                memcpy(destI, src, stop - src);
+                destI += stop - src;
+                src = stop;
+                if (src == srcEndP) break;
+            }
+            char const c = *src++;
+            switch(c) {
               case '\0':   *destI++ = '\\'; *destI++ = '0'; break;
               case '\b':   *destI++ = '\\'; *destI++ = 'b'; break;
               case '\n':   *destI++ = '\\'; *destI++ = 'n'; break;
               case '\r':   *destI++ = '\\'; *destI++ = 'r'; break;
               case '\t':   *destI++ = '\\'; *destI++ = 't'; break;
               case '\032': *destI++ = '\\'; *destI++ = 'Z'; break;
-              case '\\': {
-                  auto const nextI = i + 1;
-                  if (srcEnd == nextI) {
-                      *destI++ = *i;
-                  } else if (*nextI != 'N') {
+              case '\\':
+                  if (src != srcEndP && *src != 'N') {
                       *destI++ = '\\'; *destI++ = '\\';
                   } else {
-                      // in this case don't modify anything, because Null (\N) is not treated by escaping in
-                      // this context.
-                      *destI++ = *i;
+                      // Null (\N) is not treated by escaping in this context,
+                      // and a trailing backslash passes through unmodified.
+                      *destI++ = c;
                   }
                   break;
-              }
-              default: *destI++ = *i; break;
+              default: *destI++ = c; break; // unescaped control character
             }
         }
-        return destI - destBegin;
+        return destI - dest;
     }
 
     /// Copy a rawColumn to an STL container
@@ -108,9 +157,17 @@ public:
     }
 
 private:
-    void _initCurrentRow();
     void _initSchema();
-    void _readNextRow();
+
+    /// @return an upper bound on the number of bytes row 'rb' can occupy
+    /// once escaped, including the leading row separator.
+    unsigned _maxRowSize(proto::RowBundle const& rb) const;
+
+    /// Write a row bundle directly into 'dest', escaping columns in place.
+    /// 'dest' must have room for at least _maxRowSize(rb) bytes.
+    /// @return the number of bytes written.
+    int _writeRowBundle(char* dest, proto::RowBundle const& rb);
+
     // Copy a row bundle into a destination STL char container
     template <typename T>
     int _copyRowBundle(T& dest, proto::RowBundle const& rb) {
@@ -120,7 +177,13 @@ private:
         for(int ci=0, ce=rb.column_size(); ci != ce; ++ci) {
             dest.insert(dest.end(), _colSep.begin(), _colSep.end());
             if (!rb.isnull(ci)) {
-                copyColumn(dest, rb.column(ci));
+                if (ci < static_cast<int>(_noEscape.size()) && _noEscape[ci]) {
+                    // Numeric or date/time cell, bare and unescaped
+                    // (see _writeRowBundle).
+                    dest.insert(dest.end(), rb.column(ci).begin(), rb.column(ci).end());
+                } else {
+                    copyColumn(dest, rb.column(ci));
+                }
             } else {
                 dest.insert(dest.end(), _nullToken.begin(), _nullToken.end() );
             }
@@ -135,9 +198,16 @@ private:
     proto::Result& _result; ///< Ref to Resultmessage
 
     sql::Schema _schema; ///< Schema object
-    int _rowIdx; ///< Row index
+
+    /// Per-result-column flag: true if the column's SQL type is numeric or
+    /// date/time, so its cell text can never contain bytes that need escaping
+    /// and the cell is emitted bare, skipping both the escape scan here and
+    /// the dequoting on the server.
+    std::vector<bool> _noEscape;
+
+    int _rowIdx; ///< Index of the next row to emit.
     int _rowTotal; ///< Total row count
-    std::vector<char> _currentRow; ///< char buffer representing current row.
+    std::vector<char> _currentRow; ///< holds any partial row left over from the previous fetch().
 
     /// Name and type for jobId column in result table. Passed from InfileMerger.
     std::string _jobIdStr; ///< String form of jobId.
@@ -148,5 +218,42 @@ private:
 
 
 
+/// BlockRowBuffer renders rows from the columnar RowBlock payload of a
+/// Result message. Each column's cell bytes are contiguous in the message,
+/// so emitting a row is a gather of column slices plus escaping, with no
+/// per-cell protobuf objects involved. A negative jobId suppresses the
+/// jobId bookkeeping column entirely (single-job passthrough).
+class BlockRowBuffer : public mysql::RowBuffer {
+public:
+    BlockRowBuffer(proto::Result& res, int jobId);
+    unsigned fetch(char* buffer, unsigned bufLen) override;
+    std::string dump() const override;
+
+private:
+    /// @return an upper bound on the escaped size of row 'rowIdx',
+    /// including the leading row separator.
+    unsigned _maxRowSize(uint32_t rowIdx) const;
+
+    /// Write row 'rowIdx' into 'dest' (room for _maxRowSize(rowIdx) bytes
+    /// required), advancing the per-column read offsets. Rows must be
+    /// written in order.
+    /// @return the number of bytes written.
+    int _writeRow(char* dest, uint32_t rowIdx);
+
+    static bool _isNull(proto::ColumnBlock const& col, uint32_t rowIdx);
+
+    std::string _colSep; ///< Column separator
+    std::string _rowSep; ///< Row separator
+    std::string _nullToken; ///< Null indicator (e.g. \N)
+    proto::RowBlock const& _block; ///< Columnar payload of the Result message.
+    uint32_t _rowIdx{0}; ///< Index of the next row to emit.
+    uint32_t _rowTotal; ///< Total row count
+    std::vector<size_t> _colOffsets; ///< Read offset into each column's data.
+    std::vector<bool> _noEscape; ///< Per-column flag: cells never need quoting or escaping.
+    std::vector<char> _currentRow; ///< holds any partial row left over from the previous fetch().
+    std::string _jobIdStr; ///< String form of jobId.
+};
+
+
 }}} // namespace lsst::qserv::rproc
 #endif // LSST_QSERV_RPROC_PROTOROWBUFFER_H
@@ -0,0 +1,176 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "rproc/ResultTablePool.h"
+
+// System headers
+#include <functional>
+#include <sstream>
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+// Qserv headers
+#include "sql/SqlConnection.h"
+#include "sql/SqlErrorObject.h"
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.rproc.ResultTablePool");
+
+} // anonymous namespace
+
+namespace lsst {
+namespace qserv {
+namespace rproc {
+
+size_t const ResultTablePool::_maxFreePerSchema;
+
+ResultTablePool& ResultTablePool::instance() {
+    static ResultTablePool pool;
+    return pool;
+}
+
+ResultTablePool::~ResultTablePool() {
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        _stop = true;
+    }
+    _cv.notify_all();
+    if (_thread.joinable()) {
+        _thread.join();
+    }
+}
+
+void ResultTablePool::configure(mysql::MySqlConfig const& config) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    if (_configured) return;
+    _config = config;
+    _configured = true;
+    _thread = std::thread(&ResultTablePool::_poolThread, this);
+}
+
+std::string ResultTablePool::claim(std::string const& createBody) {
+
+    uint64_t const fp = _fingerprint(createBody);
+
+    std::lock_guard<std::mutex> lock(_mtx);
+    if (not _configured) return std::string();
+
+    auto itr = _free.find(fp);
+    if (itr == _free.end() or itr->second.empty()) {
+        // Miss: provision a spare for the next query with this schema.
+        _tasks.push_back(Task{Task::PROVISION, std::string(), createBody});
+        _cv.notify_one();
+        return std::string();
+    }
+    std::string const tableName = itr->second.back();
+    itr->second.pop_back();
+    LOGS(_log, LOG_LVL_DEBUG, "claimed pooled table " << tableName);
+    return tableName;
+}
+
+void ResultTablePool::recycle(std::string const& tableName, std::string const& createBody) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    if (not _configured) return;
+    _tasks.push_back(Task{Task::RECYCLE, tableName, createBody});
+    _cv.notify_one();
+}
+
+uint64_t ResultTablePool::_fingerprint(std::string const& createBody) {
+    return std::hash<std::string>()(createBody);
+}
+
+std::string ResultTablePool::_nextTableName() {
+    std::ostringstream os;
+    os << "qserv_pool_" << std::hex << _seq++;
+    return os.str();
+}
+
+void ResultTablePool::_poolThread() {
+
+    // The thread owns its connection to the result database; all DDL of
+    // the pool happens here, off the latency path of the queries.
+    sql::SqlConnection conn(_config);
+
+    while (true) {
+
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(_mtx);
+            _cv.wait(lock, [this]() { return _stop or not _tasks.empty(); });
+            if (_stop) break;
+            task = _tasks.front();
+            _tasks.pop_front();
+        }
+
+        uint64_t const fp = _fingerprint(task.createBody);
+        sql::SqlErrorObject errObj;
+
+        switch (task.type) {
+
+            case Task::PROVISION: {
+                {
+                    std::lock_guard<std::mutex> lock(_mtx);
+                    if (_free[fp].size() >= _maxFreePerSchema) continue;
+                }
+                std::string const tableName = _nextTableName();
+                if (not conn.runQuery("CREATE TABLE " + tableName + task.createBody, errObj)) {
+                    LOGS(_log, LOG_LVL_WARN, "failed to provision pooled table " << tableName
+                         << ": " << errObj.errMsg());
+                    continue;
+                }
+                std::lock_guard<std::mutex> lock(_mtx);
+                _free[fp].push_back(tableName);
+                break;
+            }
+
+            case Task::RECYCLE: {
+                bool full = false;
+                {
+                    std::lock_guard<std::mutex> lock(_mtx);
+                    full = _free[fp].size() >= _maxFreePerSchema;
+                }
+                if (full) {
+                    if (not conn.runQuery("DROP TABLE IF EXISTS " + task.tableName, errObj)) {
+                        LOGS(_log, LOG_LVL_WARN, "failed to drop returned table "
+                             << task.tableName << ": " << errObj.errMsg());
+                    }
+                    continue;
+                }
+                if (not conn.runQuery("TRUNCATE TABLE " + task.tableName, errObj)) {
+                    LOGS(_log, LOG_LVL_WARN, "failed to truncate returned table "
+                         << task.tableName << ": " << errObj.errMsg());
+                    conn.runQuery("DROP TABLE IF EXISTS " + task.tableName, errObj);
+                    continue;
+                }
+                std::lock_guard<std::mutex> lock(_mtx);
+                _free[fp].push_back(task.tableName);
+                break;
+            }
+        }
+    }
+}
+
+}}} // namespace lsst::qserv::rproc
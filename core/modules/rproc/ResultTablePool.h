@@ -0,0 +1,133 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_RPROC_RESULTTABLEPOOL_H
+#define LSST_QSERV_RPROC_RESULTTABLEPOOL_H
+
+// System headers
+#include <atomic>
+#include <condition_variable>
+#include <list>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Qserv headers
+#include "mysql/MySqlConfig.h"
+
+// Forward declarations
+namespace lsst {
+namespace qserv {
+namespace sql {
+    class SqlConnection;
+}}}
+
+namespace lsst {
+namespace qserv {
+namespace rproc {
+
+/// ResultTablePool keeps empty result tables pre-created in the result
+/// database, keyed by a fingerprint of their CREATE body (the column list,
+/// keys and engine). A query whose schema matches a pooled table claims it
+/// with a RENAME (a metadata operation) instead of paying the CREATE TABLE
+/// DDL inside the first merge, and tables that are no longer needed are
+/// handed back to be truncated and re-offered by a background thread.
+/// On a claim miss a spare table with that schema is provisioned in the
+/// background, so repeated queries with a hot schema hit the pool.
+class ResultTablePool {
+public:
+
+    /// @return the per-process pool instance.
+    static ResultTablePool& instance();
+
+    // Instances cannot be copied
+    ResultTablePool(ResultTablePool const&) = delete;
+    ResultTablePool& operator=(ResultTablePool const&) = delete;
+
+    ~ResultTablePool();
+
+    /// Set the result database configuration and start the background
+    /// thread. The first call wins; later calls are ignored.
+    void configure(mysql::MySqlConfig const& config);
+
+    /// Try to claim a pre-created empty table with the given CREATE body.
+    /// On a miss a spare table is provisioned in the background for the
+    /// next query with the same schema.
+    ///
+    /// @param createBody - the CREATE statement without the leading
+    ///                     "CREATE TABLE <name>" part
+    /// @return the name of the claimed table (to be renamed by the caller),
+    ///         or the empty string if the pool has none
+    std::string claim(std::string const& createBody);
+
+    /// Hand a no-longer-needed table back to the pool. The table is
+    /// truncated in the background and offered to the next claim with the
+    /// same CREATE body; if the pool is already full for that schema the
+    /// table is dropped instead.
+    void recycle(std::string const& tableName, std::string const& createBody);
+
+private:
+
+    // Tasks executed by the background thread
+    struct Task {
+        enum Type {
+            PROVISION,  ///< create an empty pooled table
+            RECYCLE     ///< truncate (or drop) a returned table
+        };
+        Type type;
+        std::string tableName;   ///< used by RECYCLE only
+        std::string createBody;
+    };
+
+    ResultTablePool() = default;
+
+    /// The background thread creating and truncating pooled tables.
+    void _poolThread();
+
+    /// @return the fingerprint of a CREATE body.
+    static uint64_t _fingerprint(std::string const& createBody);
+
+    /// @return a unique name for a new pooled table.
+    std::string _nextTableName();
+
+    /// The most pre-created tables kept per schema fingerprint
+    static size_t const _maxFreePerSchema = 4;
+
+    mysql::MySqlConfig _config;
+    bool _configured = false;
+
+    std::map<uint64_t, std::vector<std::string>> _free; ///< ready tables by fingerprint
+    std::list<Task> _tasks; ///< work queue of the background thread
+    bool _stop = false;
+
+    std::atomic<uint64_t> _seq{0}; ///< makes pooled table names unique
+
+    std::mutex _mtx; ///< protects all members above
+    std::condition_variable _cv;
+    std::thread _thread;
+};
+
+}}} // namespace lsst::qserv::rproc
+
+#endif // LSST_QSERV_RPROC_RESULTTABLEPOOL_H
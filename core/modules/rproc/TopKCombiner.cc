@@ -0,0 +1,388 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2017 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "rproc/TopKCombiner.h"
+
+// System headers
+#include <cctype>
+#include <cstdlib>
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+// Qserv headers
+#include "query/ColumnRef.h"
+#include "query/OrderByClause.h"
+#include "query/SelectList.h"
+#include "query/SelectStmt.h"
+#include "query/ValueExpr.h"
+#include "sql/Schema.h"
+#include "sql/statement.h"
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.rproc.TopKCombiner");
+
+/// LIMITs above this stay on the SQL merge path; the memory and statement
+/// sizes of an in-memory top-K stop paying off well before this point.
+int const MAX_TOPK_LIMIT = 100000;
+
+/// Rows retained per requested row. The slack beyond K lets rows from an
+/// invalidated job attempt be dropped at render time without coming up
+/// short of K valid rows.
+size_t const RETAIN_FACTOR = 4;
+
+/// Rough cap on a batched INSERT statement, comfortably below the usual
+/// max_allowed_packet (same budget _deleteInvalidRows uses).
+size_t const MAX_INSERT_SIZE = 950000;
+
+/// Classify a SQL column type for sorting and rendering.
+/// @return 0 if not numeric, 1 if integer, 2 if floating point.
+int classifySqlType(std::string const& sqlType) {
+    static std::vector<std::string> const intPrefixes = {
+        "TINYINT", "SMALLINT", "MEDIUMINT", "INTEGER", "INT", "BIGINT", "YEAR"};
+    static std::vector<std::string> const floatPrefixes = {
+        "FLOAT", "DOUBLE", "DECIMAL", "NUMERIC", "REAL"};
+    std::string upper;
+    upper.reserve(sqlType.size());
+    for (char c : sqlType) {
+        upper += std::toupper(static_cast<unsigned char>(c));
+    }
+    for (auto const& prefix : intPrefixes) {
+        if (upper.compare(0, prefix.size(), prefix) == 0) return 1;
+    }
+    for (auto const& prefix : floatPrefixes) {
+        if (upper.compare(0, prefix.size(), prefix) == 0) return 2;
+    }
+    return 0;
+}
+
+/// @return true if the cell at rowIdx is null according to the column's
+/// null bitmap (same encoding wpublish uses when building RowBlocks).
+bool blockIsNull(lsst::qserv::proto::ColumnBlock const& col, uint32_t rowIdx) {
+    std::string const& bitmap = col.nullbitmap();
+    size_t byteIdx = rowIdx / 8;
+    if (byteIdx >= bitmap.size()) return false;
+    return (bitmap[byteIdx] >> (rowIdx % 8)) & 1;
+}
+
+/// @return 'cell' as a quoted SQL string literal, escaped for mysqld.
+std::string quoteValue(std::string const& cell) {
+    std::string out;
+    out.reserve(cell.size() + 2);
+    out += '\'';
+    for (char c : cell) {
+        switch (c) {
+        case '\0': out += "\\0"; break;
+        case '\n': out += "\\n"; break;
+        case '\r': out += "\\r"; break;
+        case '\032': out += "\\Z"; break;
+        case '\'': out += "\\'"; break;
+        case '\\': out += "\\\\"; break;
+        default: out += c;
+        }
+    }
+    out += '\'';
+    return out;
+}
+
+} // anonymous namespace
+
+
+namespace lsst {
+namespace qserv {
+namespace rproc {
+
+TopKCombiner::Ptr TopKCombiner::create(query::SelectStmt const& mergeStmt) {
+    if (not mergeStmt.hasOrderBy() or not mergeStmt.hasLimit()) {
+        return nullptr;
+    }
+    if (mergeStmt.hasGroupBy() or mergeStmt.hasHaving() or mergeStmt.getDistinct()) {
+        return nullptr;
+    }
+    int const limit = mergeStmt.getLimit();
+    if (limit <= 0 or limit > MAX_TOPK_LIMIT) {
+        return nullptr;
+    }
+    auto const veList = mergeStmt.getSelectList().getValueExprList();
+    if (veList == nullptr or veList->empty()) {
+        return nullptr;
+    }
+    Ptr combiner(new TopKCombiner());
+    for (auto const& ve : *veList) {
+        if (ve == nullptr) {
+            return nullptr;
+        }
+        if (ve->isStar()) {
+            // A lone star passes every worker column through unchanged; a
+            // star mixed with other items would need mysqld's expansion.
+            if (veList->size() != 1) {
+                return nullptr;
+            }
+            combiner->_selectStar = true;
+            break;
+        }
+        auto const cr = ve->copyAsColumnRef();
+        if (cr == nullptr or cr->column.empty()) {
+            return nullptr;
+        }
+        SelItem item;
+        item.alias = ve->getAlias();
+        item.column = cr->column;
+        // MySQL names an unaliased CREATE TABLE ... SELECT column after the
+        // expression text; do the same so the result schema is unchanged.
+        item.name = item.alias.empty() ? ve->sqlFragment() : item.alias;
+        combiner->_selItems.push_back(item);
+    }
+    auto const terms = mergeStmt.getOrderBy().getTerms();
+    if (terms == nullptr or terms->empty()) {
+        return nullptr;
+    }
+    for (auto const& term : *terms) {
+        auto const& expr = term.getExpr();
+        if (expr == nullptr) {
+            return nullptr;
+        }
+        auto const cr = expr->copyAsColumnRef();
+        if (cr == nullptr or cr->column.empty()) {
+            return nullptr;
+        }
+        KeySpec ks;
+        ks.column = cr->column;
+        ks.descending = (term.getOrder() == query::OrderByTerm::DESC);
+        combiner->_keySpecs.push_back(ks);
+    }
+    combiner->_limit = limit;
+    combiner->_capacity = static_cast<size_t>(limit) * RETAIN_FACTOR;
+    return combiner;
+}
+
+
+bool TopKCombiner::bindSchema(proto::RowSchema const& schema) {
+    auto findCol = [&schema](std::string const& name) -> int {
+        if (name.empty()) return -1;
+        for (int i = 0, e = schema.columnschema_size(); i != e; ++i) {
+            if (schema.columnschema(i).name() == name) {
+                return i;
+            }
+        }
+        return -1;
+    };
+
+    if (_selectStar) {
+        for (int i = 0, e = schema.columnschema_size(); i != e; ++i) {
+            proto::ColumnSchema const& cs = schema.columnschema(i);
+            SelItem item;
+            item.name = cs.name();
+            item.schemaIdx = i;
+            item.sqlType = cs.sqltype();
+            item.quoted = (classifySqlType(cs.sqltype()) == 0);
+            _selItems.push_back(item);
+        }
+    } else {
+        for (auto& item : _selItems) {
+            // Worker result columns are named after the select item's alias
+            // if it has one, otherwise after the expression itself.
+            item.schemaIdx = findCol(item.alias);
+            if (item.schemaIdx < 0) item.schemaIdx = findCol(item.column);
+            if (item.schemaIdx < 0) item.schemaIdx = findCol(item.name);
+            if (item.schemaIdx < 0) {
+                LOGS(_log, LOG_LVL_DEBUG, "topK: no result column for " << item.name);
+                return false;
+            }
+            item.sqlType = schema.columnschema(item.schemaIdx).sqltype();
+            item.quoted = (classifySqlType(item.sqlType) == 0);
+        }
+    }
+
+    for (auto& ks : _keySpecs) {
+        ks.schemaIdx = findCol(ks.column);
+        if (ks.schemaIdx < 0) {
+            LOGS(_log, LOG_LVL_DEBUG, "topK: no sort column " << ks.column);
+            return false;
+        }
+        int cls = classifySqlType(schema.columnschema(ks.schemaIdx).sqltype());
+        if (cls == 0) {
+            // A non-numeric sort key would need mysqld's collation rules;
+            // leave such queries on the SQL merge path.
+            LOGS(_log, LOG_LVL_DEBUG, "topK: non-numeric sort column " << ks.column
+                 << " type " << schema.columnschema(ks.schemaIdx).sqltype());
+            return false;
+        }
+        ks.isInt = (cls == 1);
+    }
+
+    _rows = RowSet(RowLess(&_keySpecs));
+    _schemaBound = true;
+    return true;
+}
+
+
+bool TopKCombiner::RowLess::operator()(Row const& a, Row const& b) const {
+    for (size_t k = 0; k != keySpecs->size(); ++k) {
+        KeySpec const& ks = (*keySpecs)[k];
+        Key const& ka = a.keys[k];
+        Key const& kb = b.keys[k];
+        int cmp = 0;
+        if (ka.isNull != kb.isNull) {
+            cmp = ka.isNull ? -1 : 1;
+        } else if (not ka.isNull) {
+            if (ks.isInt) {
+                cmp = (ka.i < kb.i) ? -1 : (ka.i > kb.i ? 1 : 0);
+            } else {
+                cmp = (ka.d < kb.d) ? -1 : (ka.d > kb.d ? 1 : 0);
+            }
+        }
+        if (ks.descending) cmp = -cmp;
+        if (cmp != 0) return cmp < 0;
+    }
+    return false;
+}
+
+
+void TopKCombiner::_addRow(Row row) {
+    if (_rows.size() >= _capacity) {
+        auto worst = std::prev(_rows.end());
+        if (not _rows.key_comp()(row, *worst)) {
+            return; // Ranks below everything retained.
+        }
+        _rows.erase(worst);
+    }
+    _rows.insert(std::move(row));
+}
+
+
+void TopKCombiner::add(proto::Result const& result, int jobIdAttempt) {
+    auto parseKeys = [this](Row& row) {
+        row.keys.resize(_keySpecs.size());
+        for (size_t k = 0; k != _keySpecs.size(); ++k) {
+            KeySpec const& ks = _keySpecs[k];
+            int const ci = ks.schemaIdx;
+            if (ci >= static_cast<int>(row.cells.size()) or row.nulls[ci]) continue;
+            Key& key = row.keys[k];
+            if (ks.isInt) {
+                key.i = std::strtoll(row.cells[ci].c_str(), nullptr, 10);
+            } else {
+                key.d = std::strtod(row.cells[ci].c_str(), nullptr);
+            }
+            key.isNull = false;
+        }
+    };
+
+    for (int ri = 0, re = result.row_size(); ri != re; ++ri) {
+        proto::RowBundle const& rb = result.row(ri);
+        Row row;
+        row.jobIdAttempt = jobIdAttempt;
+        row.cells.reserve(rb.column_size());
+        row.nulls.reserve(rb.column_size());
+        for (int ci = 0, ce = rb.column_size(); ci != ce; ++ci) {
+            row.cells.push_back(rb.column(ci));
+            row.nulls.push_back(rb.isnull(ci));
+        }
+        parseKeys(row);
+        _addRow(std::move(row));
+    }
+
+    if (result.has_rowblock()) {
+        proto::RowBlock const& block = result.rowblock();
+        std::vector<size_t> offsets(block.column_size(), 0);
+        for (uint32_t ri = 0, re = block.numrows(); ri != re; ++ri) {
+            Row row;
+            row.jobIdAttempt = jobIdAttempt;
+            row.cells.reserve(block.column_size());
+            row.nulls.reserve(block.column_size());
+            for (int ci = 0, ce = block.column_size(); ci != ce; ++ci) {
+                proto::ColumnBlock const& col = block.column(ci);
+                if (blockIsNull(col, ri)) {
+                    row.cells.push_back(std::string());
+                    row.nulls.push_back(true);
+                    continue;
+                }
+                uint32_t const len = col.cellsize(ri);
+                row.cells.push_back(
+                    std::string(col.data().data() + offsets[ci], len));
+                row.nulls.push_back(false);
+                offsets[ci] += len;
+            }
+            parseKeys(row);
+            _addRow(std::move(row));
+        }
+    }
+}
+
+
+void TopKCombiner::render(std::string const& targetTable,
+                          std::function<bool(int)> const& isInvalid,
+                          std::string& createStmt,
+                          std::vector<std::string>& insertStmts) const {
+    sql::Schema schema;
+    for (auto const& item : _selItems) {
+        sql::ColSchema col;
+        col.name = item.name;
+        col.colType.sqlType = item.sqlType;
+        schema.columns.push_back(col);
+    }
+    createStmt = sql::formCreateTable(targetTable, schema) + " ENGINE=MyISAM";
+
+    insertStmts.clear();
+    std::string const prefix = "INSERT INTO " + targetTable + " VALUES ";
+    std::string stmt;
+    int emitted = 0;
+    for (Row const& row : _rows) {
+        if (emitted == _limit) break;
+        if (isInvalid(row.jobIdAttempt)) continue;
+        std::string values = "(";
+        bool first = true;
+        for (auto const& item : _selItems) {
+            if (not first) values += ",";
+            first = false;
+            int const ci = item.schemaIdx;
+            if (ci >= static_cast<int>(row.cells.size()) or row.nulls[ci]) {
+                values += "NULL";
+            } else if (item.quoted) {
+                values += quoteValue(row.cells[ci]);
+            } else {
+                values += row.cells[ci];
+            }
+        }
+        values += ")";
+        if (not stmt.empty() and stmt.size() + values.size() > MAX_INSERT_SIZE) {
+            insertStmts.push_back(stmt);
+            stmt.clear();
+        }
+        if (stmt.empty()) {
+            stmt = prefix + values;
+        } else {
+            stmt += "," + values;
+        }
+        ++emitted;
+    }
+    if (not stmt.empty()) {
+        insertStmts.push_back(stmt);
+    }
+    LOGS(_log, LOG_LVL_DEBUG, "topK rendered " << emitted << " of "
+         << _rows.size() << " retained rows into " << targetTable);
+}
+
+}}} // namespace lsst::qserv::rproc
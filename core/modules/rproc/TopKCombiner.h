@@ -0,0 +1,162 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2017 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_RPROC_TOPKCOMBINER_H
+#define LSST_QSERV_RPROC_TOPKCOMBINER_H
+
+// System headers
+#include <functional>
+#include <memory>
+#include <set>
+#include <string>
+#include <vector>
+
+// Qserv headers
+#include "proto/worker.pb.h"
+
+// Forward declarations
+namespace lsst {
+namespace qserv {
+namespace query {
+    class SelectStmt;
+}}} // End of forward declarations
+
+
+namespace lsst {
+namespace qserv {
+namespace rproc {
+
+/// TopKCombiner keeps only the running top K rows in memory for queries
+/// whose merge statement is a plain ORDER BY ... LIMIT K over simple
+/// columns. The parallel statements already carry both clauses, so each
+/// chunk returns at most K rows, but loading all of them into the merge
+/// table and sorting materializes O(chunks * K) rows to keep K. Here a
+/// worker row is retained only while it can still place in the final
+/// top K, so the result table receives exactly K rows and the final sort
+/// disappears.
+///
+/// Rows are tagged with their job attempt and filtered at render() time,
+/// so rows from job attempts invalidated after delivery (retries,
+/// cancellations) can be excluded without any analog of the result-table
+/// row scrubbing. Since discarded rows cannot be recovered, the combiner
+/// retains a few multiples of K rather than exactly K; an invalidated
+/// attempt would have to supply more than the slack's worth of top-ranked
+/// rows before the rendered result could come up short.
+class TopKCombiner {
+public:
+    typedef std::shared_ptr<TopKCombiner> Ptr;
+
+    /// Inspect the merge statement.
+    /// @return a combiner if the statement is a plain-column select with
+    /// ORDER BY and a modest LIMIT and no grouping; nullptr otherwise.
+    static Ptr create(query::SelectStmt const& mergeStmt);
+
+    TopKCombiner(TopKCombiner const&) = delete;
+    TopKCombiner& operator=(TopKCombiner const&) = delete;
+
+    /// Bind to the worker result schema, called with the first response.
+    /// @return false if a select or sort column is missing from the schema
+    /// or a sort column is not numeric; the caller should then fall back to
+    /// the SQL merge path (no rows have been consumed yet).
+    bool bindSchema(proto::RowSchema const& schema);
+
+    /// @return true once bindSchema() has succeeded.
+    bool schemaBound() const { return _schemaBound; }
+
+    /// Offer all rows of a worker result, retaining those that still rank.
+    /// Must not be called before a successful bindSchema().
+    void add(proto::Result const& result, int jobIdAttempt);
+
+    /// Form the CREATE TABLE and batched INSERT statements that produce
+    /// the K-row result table in final order, skipping rows from job
+    /// attempts for which 'isInvalid' returns true.
+    void render(std::string const& targetTable,
+                std::function<bool(int)> const& isInvalid,
+                std::string& createStmt,
+                std::vector<std::string>& insertStmts) const;
+
+    /// @return the number of rows currently retained.
+    size_t retainedCount() const { return _rows.size(); }
+
+private:
+    TopKCombiner() = default;
+
+    /// A parsed sort-key cell. Keys are parsed when rows are recorded so
+    /// comparisons work on plain data.
+    struct Key {
+        bool isNull{true};
+        long long i{0};
+        double d{0.0};
+    };
+
+    /// One term of the ORDER BY clause.
+    struct KeySpec {
+        std::string column;    ///< sort column name
+        bool descending{false};
+        int schemaIdx{-1};     ///< schema column index, set by bindSchema()
+        bool isInt{false};     ///< integer comparison (vs floating point)
+    };
+
+    /// One output column of the result table.
+    struct SelItem {
+        std::string name;   ///< final column name (alias or expression text)
+        std::string alias;
+        std::string column; ///< unqualified source column name
+        int schemaIdx{-1};  ///< schema column index, set by bindSchema()
+        bool quoted{false}; ///< non-numeric: quote and escape on render
+        std::string sqlType;
+    };
+
+    /// One retained worker row: parsed sort keys plus the raw cells.
+    struct Row {
+        int jobIdAttempt;
+        std::vector<Key> keys;
+        std::vector<std::string> cells; ///< all cells, schema order
+        std::vector<bool> nulls;
+    };
+
+    /// Orders rows by the ORDER BY terms, best row first. NULLs sort first
+    /// ascending and last descending, as in mysqld.
+    struct RowLess {
+        RowLess() {}
+        explicit RowLess(std::vector<KeySpec> const* ks) : keySpecs(ks) {}
+        bool operator()(Row const& a, Row const& b) const;
+        std::vector<KeySpec> const* keySpecs{nullptr};
+    };
+    typedef std::multiset<Row, RowLess> RowSet;
+
+    /// Retain 'row' if it ranks within the capacity, evicting the worst
+    /// retained row when full.
+    void _addRow(Row row);
+
+    int _limit{0};              ///< K, the user query's LIMIT
+    size_t _capacity{0};        ///< rows retained: K plus invalidation slack
+    std::vector<KeySpec> _keySpecs;
+    std::vector<SelItem> _selItems;
+    bool _selectStar{false};    ///< select list is a lone star
+    RowSet _rows;               ///< retained rows, best first
+    bool _schemaBound{false};
+};
+
+}}} // namespace lsst::qserv::rproc
+
+#endif // LSST_QSERV_RPROC_TOPKCOMBINER_H
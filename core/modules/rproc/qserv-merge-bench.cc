@@ -0,0 +1,336 @@
+/*
+ * LSST Data Management System
+ * Copyright 2018 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/**
+ * @file
+ *
+ * @brief Throughput benchmark for the czar merge path.
+ *
+ * Generates synthetic proto::Result blocks with a parameterized shape
+ * (row width via column counts and string width, escaping density,
+ * target block size, RowBundle or columnar RowBlock payload) and times
+ * each stage of the merge path over them:
+ *   - deserialize: parsing the wire bytes into a Result message on a
+ *     WorkerResponse arena;
+ *   - escape/copy: rendering the parsed rows to LOAD DATA text through
+ *     ProtoRowBuffer / BlockRowBuffer (the stage the SIMD escape scan
+ *     accelerates);
+ *   - load: end-to-end InfileMerger::merge() + finalize() into a real
+ *     mysqld, with the time spent inside LOAD DATA reported separately
+ *     (InfileMerger::getTotalMergeMs()).
+ *
+ * The load stage needs a mysqld and runs only when a socket is given;
+ * like testLocalInfile, this depends on local site configuration and so
+ * is not a unit test. The first two stages always run.
+ *
+ * Usage: qserv-merge-bench [blocks] [blockMB] [intCols] [dblCols]
+ *                          [strCols] [strWidth] [escapePct]
+ *                          [bundle|block] [socket [user [db]]]
+ *
+ * Defaults: 16 blocks of 2MB (the worker's desired transmit size), rows
+ * of 2 BIGINT + 2 DOUBLE + 2 VARCHAR(32) columns, 1% of string bytes
+ * needing escaping, RowBundle payload, no mysqld.
+ */
+
+// System headers
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+// Qserv headers
+#include "mysql/MySqlConfig.h"
+#include "proto/worker.pb.h"
+#include "proto/WorkerResponse.h"
+#include "rproc/InfileMerger.h"
+#include "rproc/ProtoRowBuffer.h"
+#include "sql/SqlConnection.h"
+#include "sql/SqlErrorObject.h"
+
+using namespace lsst::qserv;
+
+namespace {
+
+/// Shape of the synthetic result stream.
+struct Shape {
+    int blocks = 16;
+    int blockMB = 2;       ///< target wire size of one Result message.
+    int intCols = 2;
+    int dblCols = 2;
+    int strCols = 2;
+    int strWidth = 32;     ///< bytes per string cell.
+    int escapePct = 1;     ///< % of string bytes that need escaping.
+    bool columnar = false; ///< RowBlock payload instead of RowBundles.
+};
+
+uint64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/// Fill the row schema matching Shape's column layout.
+void buildSchema(proto::Result& res, Shape const& shape) {
+    auto addCol = [&res](std::string const& name, std::string const& sqlType,
+                         int mysqlType) {
+        proto::ColumnSchema* cs = res.mutable_rowschema()->add_columnschema();
+        cs->set_name(name);
+        cs->set_deprecated_hasdefault(false);
+        cs->set_sqltype(sqlType);
+        cs->set_mysqltype(mysqlType);
+    };
+    for (int i = 0; i != shape.intCols; ++i) {
+        addCol("i" + std::to_string(i), "BIGINT", MYSQL_TYPE_LONGLONG);
+    }
+    for (int i = 0; i != shape.dblCols; ++i) {
+        addCol("d" + std::to_string(i), "DOUBLE", MYSQL_TYPE_DOUBLE);
+    }
+    for (int i = 0; i != shape.strCols; ++i) {
+        addCol("s" + std::to_string(i),
+               "VARCHAR(" + std::to_string(shape.strWidth) + ")",
+               MYSQL_TYPE_VAR_STRING);
+    }
+}
+
+/// @return the text of one cell of result column 'col' (schema order).
+std::string genCell(Shape const& shape, int col, std::mt19937& rng) {
+    char buf[32];
+    if (col < shape.intCols) {
+        std::snprintf(buf, sizeof(buf), "%lld",
+                      static_cast<long long>(rng()) * 65537);
+        return buf;
+    }
+    if (col < shape.intCols + shape.dblCols) {
+        std::snprintf(buf, sizeof(buf), "%.12g",
+                      rng() * 1e-3 - (1u << 31) * 1e-3);
+        return buf;
+    }
+    // String cell: mostly clean printable bytes, escapePct% drawn from the
+    // set LOAD DATA must escape.
+    static char const escaped[] = "\n\t\r\b\\\032";
+    std::string cell(shape.strWidth, ' ');
+    for (int i = 0; i != shape.strWidth; ++i) {
+        if (static_cast<int>(rng() % 100) < shape.escapePct) {
+            cell[i] = escaped[rng() % (sizeof(escaped) - 1)];
+        } else {
+            cell[i] = 'a' + rng() % 26;
+        }
+    }
+    return cell;
+}
+
+/// Build one Result message of 'rows' rows in the requested payload form
+/// and serialize it to wire bytes.
+std::string genBlock(Shape const& shape, int jobId, int rows, std::mt19937& rng) {
+    int const cols = shape.intCols + shape.dblCols + shape.strCols;
+    proto::Result res;
+    buildSchema(res, shape);
+    res.set_continues(false);
+    res.set_session(1);
+    res.set_queryid(1);
+    res.set_jobid(jobId);
+    res.set_attemptcount(0);
+    res.set_largeresult(false);
+    res.set_rowcount(rows);
+    if (shape.columnar) {
+        proto::RowBlock* block = res.mutable_rowblock();
+        block->set_numrows(rows);
+        for (int c = 0; c != cols; ++c) block->add_column();
+        // Cells are generated row-major so both payload forms see the same
+        // random sequence for a given seed.
+        for (int r = 0; r != rows; ++r) {
+            for (int c = 0; c != cols; ++c) {
+                std::string const cell = genCell(shape, c, rng);
+                proto::ColumnBlock* cb = block->mutable_column(c);
+                cb->mutable_data()->append(cell);
+                cb->add_cellsize(cell.size());
+            }
+        }
+    } else {
+        for (int r = 0; r != rows; ++r) {
+            proto::RowBundle* rb = res.add_row();
+            for (int c = 0; c != cols; ++c) {
+                rb->add_column(genCell(shape, c, rng));
+                rb->add_isnull(false);
+            }
+        }
+    }
+    res.set_transmitsize(res.ByteSize());
+    std::string wire;
+    res.SerializeToString(&wire);
+    return wire;
+}
+
+/// Parse one wire block into a fresh WorkerResponse (arena-backed, as the
+/// production receive path does).
+std::shared_ptr<proto::WorkerResponse> parseBlock(std::string const& wire) {
+    auto response = std::make_shared<proto::WorkerResponse>();
+    if (!response->result.ParseFromString(wire)) {
+        std::cerr << "failed to parse generated Result block" << std::endl;
+        std::exit(1);
+    }
+    response->headerSize = 0;
+    return response;
+}
+
+} // namespace
+
+
+int main(int argc, char const* argv[]) {
+
+    Shape shape;
+    std::string socket, user = "qsmaster", db = "test";
+    if (argc > 1) shape.blocks = std::atoi(argv[1]);
+    if (argc > 2) shape.blockMB = std::atoi(argv[2]);
+    if (argc > 3) shape.intCols = std::atoi(argv[3]);
+    if (argc > 4) shape.dblCols = std::atoi(argv[4]);
+    if (argc > 5) shape.strCols = std::atoi(argv[5]);
+    if (argc > 6) shape.strWidth = std::atoi(argv[6]);
+    if (argc > 7) shape.escapePct = std::atoi(argv[7]);
+    if (argc > 8) {
+        if (std::strcmp(argv[8], "block") == 0) {
+            shape.columnar = true;
+        } else if (std::strcmp(argv[8], "bundle") != 0) {
+            std::cerr << "payload form must be 'bundle' or 'block'" << std::endl;
+            return 2;
+        }
+    }
+    if (argc > 9) socket = argv[9];
+    if (argc > 10) user = argv[10];
+    if (argc > 11) db = argv[11];
+    if (shape.blocks < 1 || shape.blockMB < 1
+        || shape.intCols < 0 || shape.dblCols < 0 || shape.strCols < 1
+        || shape.strWidth < 1 || shape.escapePct < 0 || shape.escapePct > 100) {
+        std::cerr << "usage: qserv-merge-bench [blocks] [blockMB] [intCols] [dblCols]"
+                     " [strCols] [strWidth] [escapePct] [bundle|block]"
+                     " [socket [user [db]]]" << std::endl;
+        return 2;
+    }
+
+    // Generation (untimed). Size the row count from a one-row sample of the
+    // chosen payload form so blocks land near the target wire size.
+    std::mt19937 rng(42);
+    size_t const sampleBytes = genBlock(shape, 0, 1, rng).size();
+    size_t const schemaBytes = genBlock(shape, 0, 0, rng).size();
+    int const rowsPerBlock = std::max<size_t>(
+            1, (size_t(shape.blockMB) << 20) / (sampleBytes - schemaBytes));
+    std::vector<std::string> wire;
+    size_t wireBytes = 0;
+    for (int b = 0; b != shape.blocks; ++b) {
+        wire.push_back(genBlock(shape, b, rowsPerBlock, rng));
+        wireBytes += wire.back().size();
+    }
+    int64_t const totalRows = int64_t(rowsPerBlock) * shape.blocks;
+    std::printf("generated    %d blocks of %d rows, %.2f MB/block wire,"
+                " %d cols, form=%s, escape %d%%\n",
+                shape.blocks, rowsPerBlock, double(wire.front().size()) / (1 << 20),
+                shape.intCols + shape.dblCols + shape.strCols,
+                shape.columnar ? "block" : "bundle", shape.escapePct);
+
+    // Stage 1: deserialize.
+    std::vector<std::shared_ptr<proto::WorkerResponse>> responses;
+    auto t0 = nowNs();
+    for (auto const& w : wire) {
+        responses.push_back(parseBlock(w));
+    }
+    auto const parseNs = nowNs() - t0;
+    std::printf("deserialize  %8.1f MB/s wire  (%.2f Mrow/s)\n",
+                wireBytes * 1e3 / parseNs, totalRows * 1e3 / parseNs);
+
+    // Stage 2: escape/copy to LOAD DATA text. A negative jobId selects the
+    // passthrough form (no bookkeeping column), so this measures rendering
+    // and escaping alone. The row buffers consume their Result, so this
+    // uses up 'responses'.
+    std::vector<char> buf(1 << 20);
+    size_t textBytes = 0;
+    t0 = nowNs();
+    for (auto const& response : responses) {
+        mysql::RowBuffer::Ptr rowBuffer;
+        if (response->result.has_rowblock()) {
+            rowBuffer = std::make_shared<rproc::BlockRowBuffer>(response->result, -1);
+        } else {
+            rowBuffer = std::make_shared<rproc::ProtoRowBuffer>(
+                    response->result, -1, "", "", 0);
+        }
+        unsigned got;
+        while ((got = rowBuffer->fetch(buf.data(), buf.size())) != 0) {
+            textBytes += got;
+        }
+    }
+    auto const escapeNs = nowNs() - t0;
+    std::printf("escape/copy  %8.1f MB/s wire  (%.1f MB/s text out, %.2f Mrow/s)\n",
+                wireBytes * 1e3 / escapeNs, textBytes * 1e3 / escapeNs,
+                totalRows * 1e3 / escapeNs);
+    responses.clear();
+
+    // Stage 3: end-to-end InfileMerger into a real mysqld.
+    if (socket.empty()) {
+        std::printf("load         skipped (no mysqld socket given)\n");
+        return 0;
+    }
+    mysql::MySqlConfig const sqlConfig(user, "", socket, db, 5000);
+    rproc::InfileMergerConfig mergerConfig(sqlConfig);
+    mergerConfig.targetTable = db + ".qservMergeBench";
+    {
+        // Make sure a leftover table from an aborted run doesn't pollute
+        // the timings with an extra schema.
+        sql::SqlConnection conn(sqlConfig);
+        sql::SqlErrorObject errObj;
+        conn.dropTable(mergerConfig.targetTable, errObj, false);
+    }
+    rproc::InfileMerger merger(mergerConfig);
+    // Re-parse the wire blocks untimed (the parse cost was measured above)
+    // so the merge timing covers merge() alone.
+    for (auto const& w : wire) {
+        responses.push_back(parseBlock(w));
+    }
+    t0 = nowNs();
+    for (auto const& response : responses) {
+        if (!merger.merge(response)) {
+            std::cerr << "merge failed: " << merger.getError().getMsg() << std::endl;
+            return 1;
+        }
+    }
+    auto const mergeNs = nowNs() - t0;
+    t0 = nowNs();
+    bool const finalized = merger.finalize();
+    auto const finalizeNs = nowNs() - t0;
+    if (!finalized) {
+        std::cerr << "finalize failed: " << merger.getError().getMsg() << std::endl;
+        return 1;
+    }
+    std::printf("merge        %8.1f MB/s wire  (%.2f Mrow/s, %lld rows merged)\n",
+                wireBytes * 1e3 / mergeNs, totalRows * 1e3 / mergeNs,
+                static_cast<long long>(merger.getTotalResultRows()));
+    std::printf("  of which LOAD DATA %.3fs, merge wall %.3fs, finalize %.3fs\n",
+                merger.getTotalMergeMs() / 1e3, mergeNs / 1e9, finalizeNs / 1e9);
+
+    // Leave the database as found.
+    sql::SqlConnection conn(sqlConfig);
+    sql::SqlErrorObject errObj;
+    conn.dropTable(merger.getTargetTable(), errObj, false);
+    return 0;
+}
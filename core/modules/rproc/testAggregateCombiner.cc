@@ -0,0 +1,184 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2017 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "rproc/AggregateCombiner.h"
+
+// Qserv headers
+#include "global/constants.h"
+#include "proto/worker.pb.h"
+#include "query/FuncExpr.h"
+#include "query/GroupByClause.h"
+#include "query/SelectList.h"
+#include "query/SelectStmt.h"
+#include "query/ValueExpr.h"
+#include "query/ValueFactor.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE AggregateCombiner_1
+#include "boost/test/included/unit_test.hpp"
+
+namespace test = boost::test_tools;
+
+using lsst::qserv::proto::Result;
+using lsst::qserv::query::FuncExpr;
+using lsst::qserv::query::GroupByClause;
+using lsst::qserv::query::SelectList;
+using lsst::qserv::query::SelectStmt;
+using lsst::qserv::query::ValueExpr;
+using lsst::qserv::query::ValueFactor;
+using lsst::qserv::rproc::AggregateCombiner;
+
+namespace {
+
+/// Build a merge-style select item: op(column), e.g. SUM(QS1_COUNT).
+std::shared_ptr<ValueExpr> makeAggItem(std::string const& op,
+                                       std::string const& column,
+                                       std::string const& alias) {
+    auto ve = ValueExpr::newSimple(
+        ValueFactor::newFuncFactor(FuncExpr::newArg1(op, column)));
+    ve->setAlias(alias);
+    return ve;
+}
+
+/// Build the SUM/SUM quotient AggregatePlugin emits for AVG.
+std::shared_ptr<ValueExpr> makeAvgItem(std::string const& sumCol,
+                                       std::string const& countCol,
+                                       std::string const& alias) {
+    auto inner = std::make_shared<ValueExpr>();
+    ValueExpr::FactorOpVector& factorOps = inner->getFactorOps();
+    ValueExpr::FactorOp fo;
+    fo.factor = ValueFactor::newFuncFactor(FuncExpr::newArg1("SUM", sumCol));
+    fo.op = ValueExpr::DIVIDE;
+    factorOps.push_back(fo);
+    fo.factor = ValueFactor::newFuncFactor(FuncExpr::newArg1("SUM", countCol));
+    fo.op = ValueExpr::NONE;
+    factorOps.push_back(fo);
+    auto ve = ValueExpr::newSimple(ValueFactor::newExprFactor(inner));
+    ve->setAlias(alias);
+    return ve;
+}
+
+std::shared_ptr<SelectStmt> makeStmt(std::shared_ptr<SelectList> const& sList) {
+    return std::make_shared<SelectStmt>(nullptr, sList, nullptr, nullptr,
+                                        nullptr, nullptr, false,
+                                        lsst::qserv::NOTSET);
+}
+
+void addSchemaCol(Result& result, std::string const& name,
+                  std::string const& sqlType) {
+    auto* cs = result.mutable_rowschema()->add_columnschema();
+    cs->set_name(name);
+    cs->set_sqltype(sqlType);
+}
+
+void addRow(Result& result, std::vector<std::string> const& cells) {
+    auto* row = result.add_row();
+    for (auto const& cell : cells) {
+        row->add_column(cell);
+        row->add_isnull(false);
+    }
+}
+
+} // namespace
+
+
+struct Fixture {
+    Fixture(void) {}
+    ~Fixture(void) {}
+};
+
+
+BOOST_FIXTURE_TEST_SUITE(suite, Fixture)
+
+BOOST_AUTO_TEST_CASE(TestEligibility) {
+    auto sList = std::make_shared<SelectList>();
+    sList->getValueExprList()->push_back(makeAggItem("SUM", "QS1_COUNT", "cnt"));
+    auto stmt = makeStmt(sList);
+    BOOST_CHECK(AggregateCombiner::create(*stmt) != nullptr);
+
+    // GROUP BY disqualifies the statement.
+    stmt->setGroupBy(std::make_shared<GroupByClause>());
+    BOOST_CHECK(AggregateCombiner::create(*stmt) == nullptr);
+
+    // A plain column select item disqualifies the statement.
+    auto sList2 = std::make_shared<SelectList>();
+    sList2->getValueExprList()->push_back(makeAggItem("SUM", "QS1_COUNT", "cnt"));
+    sList2->getValueExprList()->push_back(ValueExpr::newSimple(
+        ValueFactor::newColumnRefFactor(
+            std::make_shared<lsst::qserv::query::ColumnRef>("", "", "objectId"))));
+    BOOST_CHECK(AggregateCombiner::create(*makeStmt(sList2)) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(TestCombine) {
+    auto sList = std::make_shared<SelectList>();
+    sList->getValueExprList()->push_back(makeAggItem("SUM", "QS1_COUNT", "cnt"));
+    sList->getValueExprList()->push_back(makeAggItem("MIN", "QS2_MIN", "lo"));
+    sList->getValueExprList()->push_back(makeAvgItem("QS3_SUM", "QS4_COUNT", "avgv"));
+    auto combiner = AggregateCombiner::create(*makeStmt(sList));
+    BOOST_REQUIRE(combiner != nullptr);
+
+    Result result;
+    addSchemaCol(result, "QS1_COUNT", "BIGINT");
+    addSchemaCol(result, "QS2_MIN", "DOUBLE");
+    addSchemaCol(result, "QS3_SUM", "DOUBLE");
+    addSchemaCol(result, "QS4_COUNT", "BIGINT");
+    BOOST_REQUIRE(combiner->bindSchema(result.rowschema()));
+
+    addRow(result, {"5", "3.5", "10", "5"});
+    combiner->add(result, 100);
+    Result result2;
+    addRow(result2, {"7", "2.25", "20", "5"});
+    combiner->add(result2, 200);
+    BOOST_CHECK_EQUAL(combiner->partialCount(), 2u);
+
+    std::string createStmt;
+    std::string insertStmt;
+    combiner->render("qservResult.r1", [](int) { return false; },
+                     createStmt, insertStmt);
+    BOOST_CHECK_EQUAL(createStmt,
+                      "CREATE TABLE qservResult.r1 (`cnt` BIGINT,`lo` DOUBLE,"
+                      "`avgv` DOUBLE) ENGINE=MyISAM");
+    BOOST_CHECK_EQUAL(insertStmt,
+                      "INSERT INTO qservResult.r1 VALUES (12,2.25,3)");
+
+    // Partials from an invalidated job attempt are excluded at fold time.
+    combiner->render("qservResult.r1",
+                     [](int jobIdAttempt) { return jobIdAttempt == 200; },
+                     createStmt, insertStmt);
+    BOOST_CHECK_EQUAL(insertStmt,
+                      "INSERT INTO qservResult.r1 VALUES (5,3.5,2)");
+}
+
+BOOST_AUTO_TEST_CASE(TestNonNumericFallback) {
+    auto sList = std::make_shared<SelectList>();
+    sList->getValueExprList()->push_back(makeAggItem("MAX", "QS1_MAX", "hi"));
+    auto combiner = AggregateCombiner::create(*makeStmt(sList));
+    BOOST_REQUIRE(combiner != nullptr);
+
+    Result result;
+    addSchemaCol(result, "QS1_MAX", "VARCHAR(32)");
+    BOOST_CHECK(!combiner->bindSchema(result.rowschema()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
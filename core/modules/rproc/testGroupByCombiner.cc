@@ -0,0 +1,255 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2017 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "rproc/GroupByCombiner.h"
+
+// Qserv headers
+#include "global/constants.h"
+#include "proto/worker.pb.h"
+#include "query/ColumnRef.h"
+#include "query/FuncExpr.h"
+#include "query/GroupByClause.h"
+#include "query/SelectList.h"
+#include "query/SelectStmt.h"
+#include "query/ValueExpr.h"
+#include "query/ValueFactor.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE GroupByCombiner_1
+#include "boost/test/included/unit_test.hpp"
+
+namespace test = boost::test_tools;
+
+using lsst::qserv::proto::Result;
+using lsst::qserv::query::ColumnRef;
+using lsst::qserv::query::FuncExpr;
+using lsst::qserv::query::GroupByClause;
+using lsst::qserv::query::GroupByTerm;
+using lsst::qserv::query::SelectList;
+using lsst::qserv::query::SelectStmt;
+using lsst::qserv::query::ValueExpr;
+using lsst::qserv::query::ValueFactor;
+using lsst::qserv::rproc::GroupByCombiner;
+
+namespace {
+
+std::string const SPILL_DIR = "/tmp";
+
+/// Build a plain-column select item, e.g. objectId.
+std::shared_ptr<ValueExpr> makeColItem(std::string const& column,
+                                       std::string const& alias) {
+    auto ve = ValueExpr::newSimple(ValueFactor::newColumnRefFactor(
+        std::make_shared<ColumnRef>("", "", column)));
+    ve->setAlias(alias);
+    return ve;
+}
+
+/// Build a merge-style select item: op(column), e.g. SUM(QS1_COUNT).
+std::shared_ptr<ValueExpr> makeAggItem(std::string const& op,
+                                       std::string const& column,
+                                       std::string const& alias) {
+    auto ve = ValueExpr::newSimple(
+        ValueFactor::newFuncFactor(FuncExpr::newArg1(op, column)));
+    ve->setAlias(alias);
+    return ve;
+}
+
+/// Build the SUM/SUM quotient AggregatePlugin emits for AVG.
+std::shared_ptr<ValueExpr> makeAvgItem(std::string const& sumCol,
+                                       std::string const& countCol,
+                                       std::string const& alias) {
+    auto inner = std::make_shared<ValueExpr>();
+    ValueExpr::FactorOpVector& factorOps = inner->getFactorOps();
+    ValueExpr::FactorOp fo;
+    fo.factor = ValueFactor::newFuncFactor(FuncExpr::newArg1("SUM", sumCol));
+    fo.op = ValueExpr::DIVIDE;
+    factorOps.push_back(fo);
+    fo.factor = ValueFactor::newFuncFactor(FuncExpr::newArg1("SUM", countCol));
+    fo.op = ValueExpr::NONE;
+    factorOps.push_back(fo);
+    auto ve = ValueExpr::newSimple(ValueFactor::newExprFactor(inner));
+    ve->setAlias(alias);
+    return ve;
+}
+
+std::shared_ptr<SelectStmt> makeStmt(std::shared_ptr<SelectList> const& sList,
+                                     std::vector<std::string> const& groupCols) {
+    auto stmt = std::make_shared<SelectStmt>(nullptr, sList, nullptr, nullptr,
+                                             nullptr, nullptr, false,
+                                             lsst::qserv::NOTSET);
+    auto groupBy = std::make_shared<GroupByClause>();
+    for (auto const& col : groupCols) {
+        groupBy->addTerm(GroupByTerm(makeColItem(col, ""), ""));
+    }
+    stmt->setGroupBy(groupBy);
+    return stmt;
+}
+
+void addSchemaCol(Result& result, std::string const& name,
+                  std::string const& sqlType) {
+    auto* cs = result.mutable_rowschema()->add_columnschema();
+    cs->set_name(name);
+    cs->set_sqltype(sqlType);
+}
+
+void addRow(Result& result, std::vector<std::string> const& cells) {
+    auto* row = result.add_row();
+    for (auto const& cell : cells) {
+        row->add_column(cell);
+        row->add_isnull(false);
+    }
+}
+
+/// The select list and schema most tests use: objectId, SUM, AVG quotient.
+std::shared_ptr<SelectList> makeDefaultList() {
+    auto sList = std::make_shared<SelectList>();
+    sList->getValueExprList()->push_back(makeColItem("objectId", "oid"));
+    sList->getValueExprList()->push_back(makeAggItem("SUM", "QS1_COUNT", "cnt"));
+    sList->getValueExprList()->push_back(makeAvgItem("QS3_SUM", "QS4_COUNT", "avgv"));
+    return sList;
+}
+
+void addDefaultSchema(Result& result) {
+    addSchemaCol(result, "objectId", "BIGINT");
+    addSchemaCol(result, "QS1_COUNT", "BIGINT");
+    addSchemaCol(result, "QS3_SUM", "DOUBLE");
+    addSchemaCol(result, "QS4_COUNT", "BIGINT");
+}
+
+} // namespace
+
+
+struct Fixture {
+    Fixture(void) {}
+    ~Fixture(void) {}
+};
+
+
+BOOST_FIXTURE_TEST_SUITE(suite, Fixture)
+
+BOOST_AUTO_TEST_CASE(TestEligibility) {
+    auto stmt = makeStmt(makeDefaultList(), {"objectId"});
+    BOOST_CHECK(GroupByCombiner::create(*stmt, SPILL_DIR, 64) != nullptr);
+
+    // A LIMIT needs the final ordering of the SQL merge path.
+    stmt->setLimit(100);
+    BOOST_CHECK(GroupByCombiner::create(*stmt, SPILL_DIR, 64) == nullptr);
+
+    // No GROUP BY: AggregateCombiner territory.
+    auto sList2 = std::make_shared<SelectList>();
+    sList2->getValueExprList()->push_back(makeAggItem("SUM", "QS1_COUNT", "cnt"));
+    auto stmt2 = std::make_shared<SelectStmt>(nullptr, sList2, nullptr, nullptr,
+                                              nullptr, nullptr, false,
+                                              lsst::qserv::NOTSET);
+    BOOST_CHECK(GroupByCombiner::create(*stmt2, SPILL_DIR, 64) == nullptr);
+
+    // Selecting a plain column that is not grouped disqualifies.
+    auto sList3 = std::make_shared<SelectList>();
+    sList3->getValueExprList()->push_back(makeColItem("ra", "ra"));
+    sList3->getValueExprList()->push_back(makeAggItem("SUM", "QS1_COUNT", "cnt"));
+    BOOST_CHECK(GroupByCombiner::create(*makeStmt(sList3, {"objectId"}),
+                                        SPILL_DIR, 64) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(TestCombine) {
+    auto combiner = GroupByCombiner::create(*makeStmt(makeDefaultList(), {"objectId"}),
+                                            SPILL_DIR, 64);
+    BOOST_REQUIRE(combiner != nullptr);
+
+    Result result;
+    addDefaultSchema(result);
+    BOOST_REQUIRE(combiner->bindSchema(result.rowschema()));
+
+    addRow(result, {"1", "5", "10", "5"});
+    addRow(result, {"2", "7", "20", "5"});
+    BOOST_CHECK(combiner->add(result, 100) == GroupByCombiner::AddStatus::FOLDED);
+    Result result2;
+    addRow(result2, {"1", "3", "2", "1"});
+    BOOST_CHECK(combiner->add(result2, 200) == GroupByCombiner::AddStatus::FOLDED);
+    BOOST_CHECK_EQUAL(combiner->groupCount(), 2u);
+
+    std::string createStmt;
+    std::vector<std::string> insertStmts;
+    BOOST_REQUIRE(combiner->render("qservResult.r1", [](int) { return false; },
+                                   createStmt, insertStmts));
+    BOOST_CHECK_EQUAL(createStmt,
+                      "CREATE TABLE qservResult.r1 (`oid` BIGINT,`cnt` BIGINT,"
+                      "`avgv` DOUBLE) ENGINE=MyISAM");
+    BOOST_REQUIRE_EQUAL(insertStmts.size(), 1u);
+    // Group iteration order is unspecified; check each tuple is present.
+    BOOST_CHECK(insertStmts[0].find("(1,8,2)") != std::string::npos);
+    BOOST_CHECK(insertStmts[0].find("(2,7,4)") != std::string::npos);
+
+    // An invalidated job attempt forces a refold from the journal.
+    BOOST_REQUIRE(combiner->render("qservResult.r1",
+                                   [](int jobIdAttempt) { return jobIdAttempt == 200; },
+                                   createStmt, insertStmts));
+    BOOST_REQUIRE_EQUAL(insertStmts.size(), 1u);
+    BOOST_CHECK(insertStmts[0].find("(1,5,2)") != std::string::npos);
+    BOOST_CHECK(insertStmts[0].find("(2,7,4)") != std::string::npos);
+}
+
+BOOST_AUTO_TEST_CASE(TestBudgetFallback) {
+    // A zero budget overflows on the first response.
+    auto combiner = GroupByCombiner::create(*makeStmt(makeDefaultList(), {"objectId"}),
+                                            SPILL_DIR, 0);
+    BOOST_REQUIRE(combiner != nullptr);
+
+    Result result;
+    addDefaultSchema(result);
+    BOOST_REQUIRE(combiner->bindSchema(result.rowschema()));
+    addRow(result, {"1", "5", "10", "5"});
+    BOOST_CHECK(combiner->add(result, 100) == GroupByCombiner::AddStatus::EXCEEDED);
+
+    // Folding is abandoned; later responses go to the merge table.
+    Result result2;
+    addRow(result2, {"2", "7", "20", "5"});
+    BOOST_CHECK(combiner->add(result2, 200) == GroupByCombiner::AddStatus::DIVERTED);
+
+    // The journal replays exactly the consumed response.
+    int replayed = 0;
+    BOOST_REQUIRE(combiner->drainJournal([&replayed](Result& r) {
+        ++replayed;
+        BOOST_CHECK_EQUAL(r.row_size(), 1);
+        return true;
+    }));
+    BOOST_CHECK_EQUAL(replayed, 1);
+}
+
+BOOST_AUTO_TEST_CASE(TestNonNumericGroupFallback) {
+    auto sList = std::make_shared<SelectList>();
+    sList->getValueExprList()->push_back(makeColItem("filterName", "f"));
+    sList->getValueExprList()->push_back(makeAggItem("SUM", "QS1_COUNT", "cnt"));
+    auto combiner = GroupByCombiner::create(*makeStmt(sList, {"filterName"}),
+                                            SPILL_DIR, 64);
+    BOOST_REQUIRE(combiner != nullptr);
+
+    Result result;
+    addSchemaCol(result, "filterName", "VARCHAR(8)");
+    addSchemaCol(result, "QS1_COUNT", "BIGINT");
+    // Grouping strings needs mysqld's collation rules.
+    BOOST_CHECK(!combiner->bindSchema(result.rowschema()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
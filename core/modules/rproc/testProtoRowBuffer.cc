@@ -61,6 +61,29 @@ BOOST_AUTO_TEST_CASE(TestEscape) {
     BOOST_CHECK_EQUAL(target.substr(0, count), eTest1);
 }
 
+BOOST_AUTO_TEST_CASE(TestEscapeLongRuns) {
+    // Long clean runs exercise the bulk-copy path of escapeString; place
+    // escaped bytes at assorted offsets so runs of different lengths get cut.
+    std::string test1(100, 'a');
+    test1[17] = '\n';
+    test1[18] = '\t';
+    test1[50] = '\\';
+    std::string eTest1;
+    for (char c : test1) {
+        switch (c) {
+        case '\n': eTest1 += "\\n"; break;
+        case '\t': eTest1 += "\\t"; break;
+        case '\\': eTest1 += "\\\\"; break;
+        default: eTest1 += c;
+        }
+    }
+    std::string target(test1.size() * 2, 'X');
+
+    int count = ProtoRowBuffer::escapeString(target.begin(), test1.begin(), test1.end());
+    BOOST_CHECK_EQUAL(count, static_cast<int>(eTest1.size()));
+    BOOST_CHECK_EQUAL(target.substr(0, count), eTest1);
+}
+
 BOOST_AUTO_TEST_CASE(TestEscapeEmptyString) {
     std::string test1("");
 
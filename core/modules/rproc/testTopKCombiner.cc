@@ -0,0 +1,205 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2017 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "rproc/TopKCombiner.h"
+
+// Qserv headers
+#include "global/constants.h"
+#include "proto/worker.pb.h"
+#include "query/ColumnRef.h"
+#include "query/OrderByClause.h"
+#include "query/SelectList.h"
+#include "query/SelectStmt.h"
+#include "query/ValueExpr.h"
+#include "query/ValueFactor.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE TopKCombiner_1
+#include "boost/test/included/unit_test.hpp"
+
+namespace test = boost::test_tools;
+
+using lsst::qserv::proto::Result;
+using lsst::qserv::query::ColumnRef;
+using lsst::qserv::query::OrderByClause;
+using lsst::qserv::query::OrderByTerm;
+using lsst::qserv::query::SelectList;
+using lsst::qserv::query::SelectStmt;
+using lsst::qserv::query::ValueExpr;
+using lsst::qserv::query::ValueFactor;
+using lsst::qserv::rproc::TopKCombiner;
+
+namespace {
+
+std::shared_ptr<ValueExpr> makeColExpr(std::string const& column) {
+    return ValueExpr::newSimple(ValueFactor::newColumnRefFactor(
+        std::make_shared<ColumnRef>("", "", column)));
+}
+
+std::shared_ptr<OrderByClause> makeOrderBy(std::string const& column,
+                                           OrderByTerm::Order order) {
+    auto clause = std::make_shared<OrderByClause>();
+    clause->addTerm(OrderByTerm(makeColExpr(column), order, ""));
+    return clause;
+}
+
+std::shared_ptr<SelectStmt> makeStmt(std::shared_ptr<SelectList> const& sList,
+                                     std::shared_ptr<OrderByClause> const& orderBy,
+                                     int limit) {
+    return std::make_shared<SelectStmt>(nullptr, sList, nullptr, orderBy,
+                                        nullptr, nullptr, false, limit);
+}
+
+std::shared_ptr<SelectList> makeSelectList(std::vector<std::string> const& cols) {
+    auto sList = std::make_shared<SelectList>();
+    for (auto const& col : cols) {
+        sList->getValueExprList()->push_back(makeColExpr(col));
+    }
+    return sList;
+}
+
+void addSchemaCol(Result& result, std::string const& name,
+                  std::string const& sqlType) {
+    auto* cs = result.mutable_rowschema()->add_columnschema();
+    cs->set_name(name);
+    cs->set_sqltype(sqlType);
+}
+
+void addRow(Result& result, std::vector<std::string> const& cells) {
+    auto* row = result.add_row();
+    for (auto const& cell : cells) {
+        row->add_column(cell);
+        row->add_isnull(false);
+    }
+}
+
+} // namespace
+
+
+struct Fixture {
+    Fixture(void) {}
+    ~Fixture(void) {}
+};
+
+
+BOOST_FIXTURE_TEST_SUITE(suite, Fixture)
+
+BOOST_AUTO_TEST_CASE(TestEligibility) {
+    auto orderBy = makeOrderBy("flux", OrderByTerm::DESC);
+    auto stmt = makeStmt(makeSelectList({"objectId", "flux"}), orderBy, 100);
+    BOOST_CHECK(TopKCombiner::create(*stmt) != nullptr);
+
+    // No LIMIT disqualifies the statement, as does no ORDER BY.
+    stmt->setLimit(lsst::qserv::NOTSET);
+    BOOST_CHECK(TopKCombiner::create(*stmt) == nullptr);
+    stmt->setLimit(100);
+    stmt->setOrderBy(nullptr);
+    BOOST_CHECK(TopKCombiner::create(*stmt) == nullptr);
+
+    // A lone star select is acceptable.
+    auto sList = std::make_shared<SelectList>();
+    sList->addStar(std::string());
+    BOOST_CHECK(TopKCombiner::create(*makeStmt(sList, orderBy, 100)) != nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(TestTopK) {
+    auto stmt = makeStmt(makeSelectList({"objectId", "flux"}),
+                         makeOrderBy("flux", OrderByTerm::DESC), 2);
+    auto combiner = TopKCombiner::create(*stmt);
+    BOOST_REQUIRE(combiner != nullptr);
+
+    Result result;
+    addSchemaCol(result, "objectId", "BIGINT");
+    addSchemaCol(result, "flux", "DOUBLE");
+    BOOST_REQUIRE(combiner->bindSchema(result.rowschema()));
+
+    addRow(result, {"1", "5.0"});
+    addRow(result, {"2", "1.0"});
+    combiner->add(result, 100);
+    Result result2;
+    addRow(result2, {"3", "9.5"});
+    addRow(result2, {"4", "3.25"});
+    combiner->add(result2, 200);
+
+    std::string createStmt;
+    std::vector<std::string> insertStmts;
+    combiner->render("qservResult.r1", [](int) { return false; },
+                     createStmt, insertStmts);
+    BOOST_CHECK_EQUAL(createStmt,
+                      "CREATE TABLE qservResult.r1 (`objectId` BIGINT,"
+                      "`flux` DOUBLE) ENGINE=MyISAM");
+    BOOST_REQUIRE_EQUAL(insertStmts.size(), 1u);
+    BOOST_CHECK_EQUAL(insertStmts[0],
+                      "INSERT INTO qservResult.r1 VALUES (3,9.5),(1,5.0)");
+
+    // Rows from an invalidated job attempt are excluded at render time,
+    // with rows in the retention slack taking their place.
+    combiner->render("qservResult.r1",
+                     [](int jobIdAttempt) { return jobIdAttempt == 200; },
+                     createStmt, insertStmts);
+    BOOST_REQUIRE_EQUAL(insertStmts.size(), 1u);
+    BOOST_CHECK_EQUAL(insertStmts[0],
+                      "INSERT INTO qservResult.r1 VALUES (1,5.0),(2,1.0)");
+}
+
+BOOST_AUTO_TEST_CASE(TestBoundedRetention) {
+    auto stmt = makeStmt(makeSelectList({"objectId", "flux"}),
+                         makeOrderBy("flux", OrderByTerm::DESC), 1);
+    auto combiner = TopKCombiner::create(*stmt);
+    BOOST_REQUIRE(combiner != nullptr);
+
+    Result result;
+    addSchemaCol(result, "objectId", "BIGINT");
+    addSchemaCol(result, "flux", "DOUBLE");
+    BOOST_REQUIRE(combiner->bindSchema(result.rowschema()));
+    for (int i = 0; i != 100; ++i) {
+        Result r;
+        addRow(r, {std::to_string(i), std::to_string(i) + ".5"});
+        combiner->add(r, 100);
+    }
+    // Retention is bounded to a small multiple of K, not the row count.
+    BOOST_CHECK_EQUAL(combiner->retainedCount(), 4u);
+
+    std::string createStmt;
+    std::vector<std::string> insertStmts;
+    combiner->render("qservResult.r1", [](int) { return false; },
+                     createStmt, insertStmts);
+    BOOST_REQUIRE_EQUAL(insertStmts.size(), 1u);
+    BOOST_CHECK_EQUAL(insertStmts[0],
+                      "INSERT INTO qservResult.r1 VALUES (99,99.5)");
+}
+
+BOOST_AUTO_TEST_CASE(TestNonNumericSortFallback) {
+    auto stmt = makeStmt(makeSelectList({"objectId", "name"}),
+                         makeOrderBy("name", OrderByTerm::ASC), 10);
+    auto combiner = TopKCombiner::create(*stmt);
+    BOOST_REQUIRE(combiner != nullptr);
+
+    Result result;
+    addSchemaCol(result, "objectId", "BIGINT");
+    addSchemaCol(result, "name", "VARCHAR(32)");
+    BOOST_CHECK(!combiner->bindSchema(result.rowschema()));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
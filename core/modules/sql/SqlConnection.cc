@@ -223,6 +223,31 @@ SqlConnection::runQuery(std::string const query,
     return runQuery(query.data(), query.size(), results, errObj);
 }
 
+bool
+SqlConnection::runQueryStreaming(std::string const& query,
+                                 SqlResults& results,
+                                 SqlErrorObject& errObj) {
+    if (!connectToDb(errObj)) {
+        LOGS(_log, LOG_LVL_ERROR, "runQueryStreaming failed connectToDb: " << query);
+        return false;
+    }
+    if (mysql_real_query(_connection->getMySql(), query.data(), query.size()) != 0) {
+        return _setErrorObject(errObj,
+                std::string("Unable to execute query: ") + query);
+    }
+    // Unlike mysql_store_result this does not buffer the rows client-side;
+    // they are pulled from the server one at a time by mysql_fetch_row as
+    // the caller iterates.
+    MYSQL_RES* result = mysql_use_result(_connection->getMySql());
+    if (result) {
+        results.addResult(result);
+    } else if (mysql_field_count(_connection->getMySql()) != 0) {
+        return _setErrorObject(errObj,
+                std::string("Unable to read result for query: ") + query);
+    }
+    return true;
+}
+
 /// with runQueryIter SqlConnection is busy until SqlResultIter is closed
 std::shared_ptr<SqlResultIter>
 SqlConnection::getQueryIter(std::string const& query) {
@@ -92,6 +92,13 @@ public:
     virtual bool runQuery(char const* query, int qSize, SqlErrorObject&);
     virtual bool runQuery(std::string const query, SqlResults&,
                           SqlErrorObject&);
+    /// Streaming variant of runQuery: rows are produced with
+    /// mysql_use_result, so they are fetched from the server as the result
+    /// iterator advances instead of being buffered client-side first. Only
+    /// a single result set is supported, and the connection stays busy
+    /// until all rows have been iterated or the results are freed.
+    virtual bool runQueryStreaming(std::string const& query, SqlResults&,
+                                   SqlErrorObject&);
     /// with runQueryIter SqlConnection is busy until SqlResultIter is closed
     virtual std::shared_ptr<SqlResultIter> getQueryIter(std::string const& query);
     virtual bool runQuery(std::string const query, SqlErrorObject&);
@@ -0,0 +1,89 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2017 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "sql/SqlConnectionPool.h"
+
+// System headers
+#include <utility>
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+// Local headers
+#include "sql/SqlErrorObject.h"
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.sql.SqlConnectionPool");
+
+}
+
+namespace lsst {
+namespace qserv {
+namespace sql {
+
+SqlConnectionPool::SqlConnectionPool(mysql::MySqlConfig const& sc, unsigned maxConnections)
+    : _sqlConfig(sc), _maxConnections(maxConnections) {
+}
+
+std::unique_ptr<SqlConnection>
+SqlConnectionPool::_acquire() {
+    std::unique_lock<std::mutex> lock(_mtx);
+    while (true) {
+        if (not _idle.empty()) {
+            std::unique_ptr<SqlConnection> conn = std::move(_idle.back());
+            _idle.pop_back();
+            lock.unlock();
+
+            // health check outside the lock, connectToDb pings the server
+            // and reconnects if the connection went stale
+            SqlErrorObject errObj;
+            if (not conn->connectToDb(errObj)) {
+                LOGS(_log, LOG_LVL_WARN, "discarding stale pooled connection: "
+                     << errObj.errMsg());
+                // replace with a fresh instance, it connects on first use
+                conn.reset(new SqlConnection(_sqlConfig));
+            }
+            return conn;
+        }
+        if (_numConnections < _maxConnections) {
+            ++ _numConnections;
+            LOGS(_log, LOG_LVL_DEBUG, "pool grows to " << _numConnections
+                 << " connection(s)");
+            return std::unique_ptr<SqlConnection>(new SqlConnection(_sqlConfig));
+        }
+        _cv.wait(lock);
+    }
+}
+
+void
+SqlConnectionPool::_release(std::unique_ptr<SqlConnection> conn) {
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        _idle.push_back(std::move(conn));
+    }
+    _cv.notify_one();
+}
+
+}}} // namespace lsst::qserv::sql
@@ -0,0 +1,107 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2017 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_SQL_SQLCONNECTIONPOOL_H
+#define LSST_QSERV_SQL_SQLCONNECTIONPOOL_H
+
+// System headers
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Local headers
+#include "mysql/MySqlConfig.h"
+#include "sql/SqlConnection.h"
+
+namespace lsst {
+namespace qserv {
+namespace sql {
+
+/// Pool of SqlConnection instances sharing one configuration.
+///
+/// Callers check a connection out by constructing a Lease and use it
+/// exclusively until the Lease goes out of scope. Connections are created
+/// lazily up to a fixed limit, which also caps the number of simultaneous
+/// server connections opened by the process; when all connections are
+/// checked out the next Lease blocks until one is returned. Connections
+/// returned to the pool are health-checked (ping, reconnect if needed)
+/// before being handed out again, so callers do not see stale connections
+/// after a server restart.
+class SqlConnectionPool {
+public:
+    typedef std::shared_ptr<SqlConnectionPool> Ptr;
+
+    /**
+     *  @param sc: Configuration object for mysql connections.
+     *  @param maxConnections: Limit on the number of simultaneous connections.
+     */
+    explicit SqlConnectionPool(mysql::MySqlConfig const& sc, unsigned maxConnections=4);
+
+    // Instances cannot be copied
+    SqlConnectionPool(SqlConnectionPool const&) = delete;
+    SqlConnectionPool& operator=(SqlConnectionPool const&) = delete;
+
+    /// Exclusive checkout of one connection, connection is returned to
+    /// the pool when the Lease is destroyed. Blocks while all connections
+    /// are checked out.
+    class Lease {
+    public:
+        explicit Lease(Ptr const& pool)
+            : _pool(pool), _conn(pool->_acquire()) {}
+
+        // Instances cannot be copied
+        Lease(Lease const&) = delete;
+        Lease& operator=(Lease const&) = delete;
+
+        ~Lease() { _pool->_release(std::move(_conn)); }
+
+        /// @return the checked-out connection
+        SqlConnection& conn() { return *_conn; }
+
+    private:
+        Ptr _pool;
+        std::unique_ptr<SqlConnection> _conn;
+    };
+
+private:
+    friend class Lease;
+
+    /// Take a connection out of the pool, blocks while none is available.
+    std::unique_ptr<SqlConnection> _acquire();
+
+    /// Return a connection to the pool.
+    void _release(std::unique_ptr<SqlConnection> conn);
+
+    mysql::MySqlConfig const _sqlConfig;
+    unsigned const _maxConnections;
+
+    std::mutex _mtx;    ///< Protects all members below
+    std::condition_variable _cv;
+    std::vector<std::unique_ptr<SqlConnection>> _idle;
+    unsigned _numConnections = 0;   ///< Total created, idle plus checked out
+
+}; // class SqlConnectionPool
+
+}}} // namespace lsst::qserv::sql
+
+#endif // LSST_QSERV_SQL_SQLCONNECTIONPOOL_H
@@ -0,0 +1,220 @@
+/*
+ * LSST Data Management System
+ * Copyright 2018 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/**
+ * @file
+ *
+ * @brief Microbenchmark for czar query parse and analysis.
+ *
+ * Times a4NewUserQuery() (the antlr4 parse) and QuerySession::analyzeQuery()
+ * (parse plus the full qana plugin chain) over a corpus of representative
+ * query shapes, reporting ns/query and heap allocations/query for each
+ * phase. The unit tests in qproc assert correctness but never timing; this
+ * binary exists so that analysis-time regressions can be measured before a
+ * release instead of being discovered in production.
+ *
+ * Usage: qserv-czar-bench [iterations] [corpus-file]
+ *
+ * The optional corpus file holds one statement per line ('#' comments and
+ * blank lines ignored) and is benchmarked in addition to the built-in
+ * corpus; statements must parse against the test CSS map (database "LSST",
+ * see tests/testKvMap.h). Results go to stdout, one line per statement plus
+ * a summary line per phase.
+ */
+
+// System headers
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <string>
+#include <vector>
+
+// Qserv headers
+#include "ccontrol/A4UserQueryFactory.h"
+#include "qproc/QuerySession.h"
+#include "tests/QueryAnaFixture.h"
+
+namespace {
+
+// Heap allocation counter. Replacing the global operator new in the
+// executable interposes on the allocations of the shared libraries too,
+// so the counts cover the parser and the plugins, not just this file.
+std::atomic<std::uint64_t> allocCount{0};
+std::atomic<std::uint64_t> allocBytes{0};
+
+struct PhaseStats {
+    std::uint64_t ns = 0;
+    std::uint64_t allocs = 0;
+    std::uint64_t bytes = 0;
+    std::uint64_t queries = 0;
+    int failed = 0;
+};
+
+/// Run 'iterations' calls of 'work' for one statement and add the
+/// per-query averages of the statement to 'total'.
+template <typename F>
+void benchStatement(std::string const& phase, std::string const& stmt,
+                    int iterations, PhaseStats& total, F&& work) {
+    // One untimed call warms caches (parser ATN/DFA, allocator) so the
+    // timed runs measure the steady state the czar sees.
+    try {
+        work(stmt);
+    } catch (std::exception const&) {
+        std::cout << phase << " FAILED " << stmt << std::endl;
+        ++total.failed;
+        return;
+    }
+    std::uint64_t const allocs0 = allocCount.load();
+    std::uint64_t const bytes0 = allocBytes.load();
+    auto const start = std::chrono::steady_clock::now();
+    for (int i = 0; i != iterations; ++i) {
+        work(stmt);
+    }
+    auto const ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count();
+    std::uint64_t const allocs = (allocCount.load() - allocs0) / iterations;
+    std::uint64_t const bytes = (allocBytes.load() - bytes0) / iterations;
+    std::printf("%s %10llu ns/query %8llu allocs/query %10llu bytes/query  %s\n",
+                phase.c_str(),
+                static_cast<unsigned long long>(ns / iterations),
+                static_cast<unsigned long long>(allocs),
+                static_cast<unsigned long long>(bytes),
+                stmt.c_str());
+    total.ns += ns / iterations;
+    total.allocs += allocs;
+    total.bytes += bytes;
+    ++total.queries;
+}
+
+void printSummary(std::string const& phase, PhaseStats const& total) {
+    if (total.queries == 0) {
+        std::printf("%s no statements measured (%d failed)\n", phase.c_str(), total.failed);
+        return;
+    }
+    std::printf("%s %10llu ns/query %8llu allocs/query %10llu bytes/query  MEAN over %llu statements"
+                " (%d failed)\n",
+                phase.c_str(),
+                static_cast<unsigned long long>(total.ns / total.queries),
+                static_cast<unsigned long long>(total.allocs / total.queries),
+                static_cast<unsigned long long>(total.bytes / total.queries),
+                static_cast<unsigned long long>(total.queries),
+                total.failed);
+}
+
+} // namespace
+
+// Counting overrides of the global allocation functions. Kept minimal:
+// malloc/free do the work, the atomics do the counting.
+void* operator new(std::size_t sz) {
+    allocCount.fetch_add(1, std::memory_order_relaxed);
+    allocBytes.fetch_add(sz, std::memory_order_relaxed);
+    if (void* p = std::malloc(sz ? sz : 1)) return p;
+    throw std::bad_alloc();
+}
+
+void* operator new[](std::size_t sz) {
+    return operator new(sz);
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void* p, std::size_t) noexcept { std::free(p); }
+
+
+int main(int argc, char const* argv[]) {
+
+    int iterations = 100;
+    if (argc > 1) {
+        iterations = std::atoi(argv[1]);
+        if (iterations < 1) {
+            std::cerr << "usage: qserv-czar-bench [iterations] [corpus-file]" << std::endl;
+            return 2;
+        }
+    }
+
+    // The built-in corpus covers the query shapes real traffic hits:
+    // point/cone lookups, joins, near-neighbor self-joins, aggregates
+    // and ORDER BY/LIMIT, matching the parser warm-up corpus.
+    std::vector<std::string> statements = {
+        "SELECT * FROM Object WHERE objectIdObjTest = 12345",
+        "SELECT ra_Test, decl_Test FROM Object WHERE qserv_areaspec_circle(1.5, 3.5, 0.1)",
+        "SELECT ra_Test, decl_Test FROM Object WHERE qserv_areaspec_box(0.1, -6, 4, 6)"
+            " AND rFlux_PS > 0.0 ORDER BY rFlux_PS DESC LIMIT 100",
+        "SELECT o.objectIdObjTest, s.objectIdSourceTest FROM Object o, Source s"
+            " WHERE o.objectIdObjTest = s.objectIdSourceTest AND o.objectIdObjTest = 12345",
+        "SELECT o1.objectIdObjTest, o2.objectIdObjTest"
+            " FROM Object o1, Object o2"
+            " WHERE qserv_areaspec_box(90.0, -10.0, 95.0, -5.0)"
+            " AND scisql_angSep(o1.ra_Test, o1.decl_Test, o2.ra_Test, o2.decl_Test) < 0.05",
+        "SELECT COUNT(*), AVG(rFlux_PS), MIN(ra_Test), MAX(decl_Test) FROM Object"
+            " WHERE rFlux_PS BETWEEN 0.1 AND 0.9 GROUP BY chunkId",
+    };
+    if (argc > 2) {
+        std::ifstream corpus(argv[2]);
+        if (!corpus.good()) {
+            std::cerr << "cannot read corpus file " << argv[2] << std::endl;
+            return 2;
+        }
+        std::string line;
+        while (std::getline(corpus, line)) {
+            if (line.empty() || line[0] == '#') continue;
+            statements.push_back(line);
+        }
+    }
+
+    std::printf("%d iterations per statement, %zu statements\n",
+                iterations, statements.size());
+
+    // Phase 1: the antlr4 parse alone.
+    PhaseStats parseTotal;
+    for (auto const& stmt : statements) {
+        benchStatement("parse   ", stmt, iterations, parseTotal,
+                       [](std::string const& s) {
+                           lsst::qserv::ccontrol::a4NewUserQuery(s);
+                       });
+    }
+
+    // Phase 2: parse plus the full qana plugin chain, against the
+    // in-memory CSS map the qproc unit tests use.
+    lsst::qserv::tests::QueryAnaFixture fixture;
+    PhaseStats anaTotal;
+    for (auto const& stmt : statements) {
+        benchStatement("analyze ", stmt, iterations, anaTotal,
+                       [&fixture](std::string const& s) {
+                           lsst::qserv::qproc::QuerySession session(fixture.qsTest);
+                           session.analyzeQuery(s);
+                           if (!session.getError().empty()) {
+                               throw std::runtime_error(session.getError());
+                           }
+                       });
+    }
+
+    printSummary("parse   ", parseTotal);
+    printSummary("analyze ", anaTotal);
+
+    return (parseTotal.failed + anaTotal.failed) == 0 ? 0 : 1;
+}
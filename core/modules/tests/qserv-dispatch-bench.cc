@@ -0,0 +1,215 @@
+/*
+ * LSST Data Management System
+ * Copyright 2018 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/**
+ * @file
+ *
+ * @brief Benchmark for the czar dispatch path (qdisp::Executive).
+ *
+ * Drives an Executive with synthetic jobs through the mocked SSI layer
+ * (qdisp::XrdSsiMocks) that testQDisp uses, with configurable worker
+ * latency, and reports:
+ *   - submission rate: Executive::add() calls per second, and the mean
+ *     time of one add() call summed over the submitting threads (its
+ *     inflation as threads are added shows lock contention on the
+ *     executive's bookkeeping);
+ *   - completion-handling rate: jobs finished per second over the whole
+ *     run (submission through join());
+ *   - memory per job: VmRSS growth across submission, and across the
+ *     whole run;
+ *   - context switches per job, voluntary and nonvoluntary - the
+ *     nonvoluntary count is a cheap proxy for lock contention.
+ *
+ * Usage: qserv-dispatch-bench [jobs] [threads] [latMinMs latMaxMs]
+ *
+ * Defaults: 10000 jobs, 4 submitting threads, no worker latency. Latency
+ * is drawn uniformly in [latMinMs, latMaxMs] per job by the mock worker.
+ * Dispatch today is only benchmarked on the production cluster; this
+ * binary is the offline harness for czar-side scalability work.
+ */
+
+// System headers
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+// Qserv headers
+#include "ccontrol/MergingHandler.h"
+#include "global/MsgReceiver.h"
+#include "global/ResourceUnit.h"
+#include "qdisp/Executive.h"
+#include "qdisp/JobDescription.h"
+#include "qdisp/JobQuery.h"
+#include "qdisp/MessageStore.h"
+#include "qdisp/QdispPool.h"
+#include "qdisp/XrdSsiMocks.h"
+#include "qproc/ChunkQuerySpec.h"
+#include "qproc/TaskMsgFactory.h"
+
+using namespace lsst::qserv;
+
+namespace {
+
+/// Discards worker messages; the benchmark only cares about throughput.
+class NullMsgReceiver : public MsgReceiver {
+public:
+    void operator()(int code, std::string const& msg) override {}
+};
+
+/// Serializes a fixed payload understood by the mock service
+/// ("respdata" makes the mock worker reply with data immediately).
+class MockTaskMsgFactory : public qproc::TaskMsgFactory {
+public:
+    explicit MockTaskMsgFactory(std::string const& payload)
+        : TaskMsgFactory(0), _payload(payload) {}
+    void serializeMsg(qproc::ChunkQuerySpec const& s,
+                      std::string const& chunkResultName,
+                      uint64_t queryId, int jobId, int attemptCount,
+                      std::ostream& os) override {
+        os << _payload;
+    }
+private:
+    std::string _payload;
+};
+
+/// @return the numeric value of one field of /proc/self/status (kB for
+/// the Vm* fields, a count for the ctxt_switches fields), or 0.
+long readProcStatus(std::string const& field) {
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, field.size(), field) == 0) {
+            return std::atol(line.c_str() + field.size());
+        }
+    }
+    return 0;
+}
+
+uint64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+} // namespace
+
+
+int main(int argc, char const* argv[]) {
+
+    int jobs = 10000;
+    int threads = 4;
+    int latMinMs = 0;
+    int latMaxMs = 0;
+    if (argc > 1) jobs = std::atoi(argv[1]);
+    if (argc > 2) threads = std::atoi(argv[2]);
+    if (argc > 4) {
+        latMinMs = std::atoi(argv[3]);
+        latMaxMs = std::atoi(argv[4]);
+    }
+    if (jobs < 1 || threads < 1 || latMinMs < 0 || latMaxMs < latMinMs) {
+        std::cerr << "usage: qserv-dispatch-bench [jobs] [threads] [latMinMs latMaxMs]"
+                  << std::endl;
+        return 2;
+    }
+
+    std::printf("%d jobs, %d submitting threads, worker latency %d..%dms\n",
+                jobs, threads, latMinMs, latMaxMs);
+
+    qdisp::XrdSsiServiceMock::Reset();
+    qdisp::XrdSsiServiceMock::setLatency(latMinMs, latMaxMs);
+
+    auto conf = std::make_shared<qdisp::Executive::Config>(
+            qdisp::Executive::Config::getMockStr());
+    auto ms = std::make_shared<qdisp::MessageStore>();
+    auto qdispPool = std::make_shared<qdisp::QdispPool>();
+    auto ex = qdisp::Executive::create(conf, ms, qdispPool);
+
+    long const rss0 = readProcStatus("VmRSS:");
+    long const volCtx0 = readProcStatus("voluntary_ctxt_switches:");
+    long const nonvolCtx0 = readProcStatus("nonvoluntary_ctxt_switches:");
+
+    // Submission phase: 'threads' threads each add their share of the
+    // jobs, one handler and factory per job as in a real query.
+    std::vector<std::thread> submitters;
+    std::vector<uint64_t> addNs(threads, 0);
+    auto const submitStart = nowNs();
+    for (int t = 0; t != threads; ++t) {
+        submitters.emplace_back([&, t]() {
+            auto msgReceiver = std::make_shared<NullMsgReceiver>();
+            uint64_t spent = 0;
+            for (int j = t; j < jobs; j += threads) {
+                ResourceUnit ru;
+                ru.setAsDbChunk("Mock", j % 1000);
+                auto handler = std::make_shared<ccontrol::MergingHandler>(
+                        msgReceiver, std::shared_ptr<rproc::InfileMerger>(), "benchResult");
+                auto factory = std::make_shared<MockTaskMsgFactory>("respdata");
+                auto cqs = std::make_shared<qproc::ChunkQuerySpec>();
+                auto job = qdisp::JobDescription::create(
+                        ex->getId(), j, ru, handler, factory, cqs, "benchResult", true);
+                auto const t0 = nowNs();
+                ex->add(job);
+                spent += nowNs() - t0;
+            }
+            addNs[t] = spent;
+        });
+    }
+    for (auto& t : submitters) t.join();
+    auto const submitNs = nowNs() - submitStart;
+    long const rssSubmitted = readProcStatus("VmRSS:");
+
+    // Completion phase: wait out the mock workers.
+    ex->join();
+    auto const totalNs = nowNs() - submitStart;
+
+    long const rss1 = readProcStatus("VmRSS:");
+    long const volCtx = readProcStatus("voluntary_ctxt_switches:") - volCtx0;
+    long const nonvolCtx = readProcStatus("nonvoluntary_ctxt_switches:") - nonvolCtx0;
+
+    uint64_t addNsTotal = 0;
+    for (auto ns : addNs) addNsTotal += ns;
+
+    std::printf("submission   %10.0f jobs/s  (%llu ns/add mean across threads)\n",
+                jobs * 1e9 / submitNs,
+                static_cast<unsigned long long>(addNsTotal / jobs));
+    std::printf("completion   %10.0f jobs/s  (submit+drain wall %.3fs)\n",
+                jobs * 1e9 / totalNs, totalNs / 1e9);
+    std::printf("memory       %10.1f KB/job after submit, %.1f KB/job after join"
+                " (VmRSS %ld -> %ld -> %ld KB)\n",
+                double(rssSubmitted - rss0) / jobs, double(rss1 - rss0) / jobs,
+                rss0, rssSubmitted, rss1);
+    std::printf("ctx switches %10.2f voluntary/job, %.2f nonvoluntary/job"
+                " (nonvoluntary ~ lock contention)\n",
+                double(volCtx) / jobs, double(nonvolCtx) / jobs);
+
+    int const finished = qdisp::XrdSsiServiceMock::getFinCount();
+    std::printf("mock workers saw %d requests, finished %d, aOK=%s\n",
+                qdisp::XrdSsiServiceMock::getReqCount(), finished,
+                qdisp::XrdSsiServiceMock::isAOK() ? "true" : "false");
+
+    return qdisp::XrdSsiServiceMock::isAOK() ? 0 : 1;
+}
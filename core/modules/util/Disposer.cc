@@ -0,0 +1,78 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "util/Disposer.h"
+
+// System headers
+#include <utility>
+#include <vector>
+
+namespace lsst {
+namespace qserv {
+namespace util {
+
+Disposer& Disposer::instance() {
+    static Disposer disposer;
+    return disposer;
+}
+
+Disposer::Disposer() {
+    _thread = std::thread(&Disposer::_run, this);
+}
+
+Disposer::~Disposer() {
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        _shutdown = true;
+    }
+    _cv.notify_one();
+    _thread.join();
+}
+
+void Disposer::_enqueue(std::shared_ptr<void> holder) {
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        _queue.push_back(std::move(holder));
+    }
+    _cv.notify_one();
+}
+
+void Disposer::_run() {
+    std::unique_lock<std::mutex> lock(_mtx);
+    while (true) {
+        _cv.wait(lock, [this]() { return !_queue.empty() || _shutdown; });
+        if (_queue.empty() && _shutdown) {
+            return;
+        }
+        // Drop the lock while destructors run; they can take a while and
+        // must not block producers.
+        std::vector<std::shared_ptr<void>> doomed(_queue.begin(), _queue.end());
+        _queue.clear();
+        lock.unlock();
+        doomed.clear();
+        lock.lock();
+    }
+}
+
+}}} // namespace lsst::qserv::util
@@ -0,0 +1,83 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_UTIL_DISPOSER_H
+#define LSST_QSERV_UTIL_DISPOSER_H
+
+// System headers
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+// Third-party headers
+#include "boost/utility.hpp"
+
+namespace lsst {
+namespace qserv {
+namespace util {
+
+/// Disposer destroys objects on a dedicated background thread. Large
+/// shared_ptr-based object trees (notably the analyzed query IR) are torn
+/// down node-by-node, and running those destructor cascades and frees on a
+/// query-serving thread is pure overhead on the latency path. Handing the
+/// final reference to the disposer makes teardown O(1) for the caller and
+/// serializes the free traffic on one thread.
+///
+/// Objects are destroyed in the order they are queued. The disposer thread
+/// drains its queue before shutdown, so queued destructors always run.
+class Disposer : boost::noncopyable {
+public:
+    /// Return the process-wide instance.
+    static Disposer& instance();
+
+    Disposer();
+    ~Disposer();
+
+    /// Take the caller's reference to 'obj' and destroy the object on the
+    /// disposer thread once all other references are gone. 'obj' is reset.
+    /// A null pointer is a no-op.
+    template <typename T>
+    void dispose(std::shared_ptr<T>& obj) {
+        if (obj == nullptr) {
+            return;
+        }
+        std::shared_ptr<void> holder = std::move(obj);
+        obj.reset();
+        _enqueue(std::move(holder));
+    }
+
+private:
+    void _enqueue(std::shared_ptr<void> holder);
+    void _run();
+
+    std::deque<std::shared_ptr<void>> _queue;
+    std::mutex _mtx;
+    std::condition_variable _cv;
+    bool _shutdown{false};
+    std::thread _thread;
+};
+
+}}} // namespace lsst::qserv::util
+
+#endif // LSST_QSERV_UTIL_DISPOSER_H
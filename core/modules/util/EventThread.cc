@@ -28,6 +28,7 @@
 
 // System headers
 #include <algorithm>
+#include <chrono>
 
 // Third-party headers
 
@@ -35,13 +36,165 @@
 #include "lsst/log/Log.h"
 
 namespace {
+
 LOG_LOGGER _log = LOG_GET("lsst.qserv.util.EventThread");
+
+// How long a waiting consumer sleeps before re-scanning for stealable work.
+// Commands on the shared fifo wake a consumer directly; this is a backstop
+// for commands sitting on another consumer's private deque.
+std::chrono::milliseconds const stealPollTime(100);
+
 }
 
 namespace lsst {
 namespace qserv {
 namespace util {
 
+void CommandQueue::queCmd(Command::Ptr const& cmd) {
+    // A command queued by one of this queue's own consumers goes on the front
+    // of that consumer's private deque: it will be the next command the
+    // thread runs, while its cache is still warm. Everything else goes on
+    // the back of the shared fifo.
+    auto local = _local(false);
+    if (local != nullptr) {
+        {
+            std::lock_guard<std::mutex> lock(local->mx);
+            local->qu.push_front(cmd);
+        }
+        // Wake one waiter in case this consumer stays busy and the command
+        // has to be stolen.
+        notify(false);
+        return;
+    }
+    std::lock_guard<std::mutex> lock(_mx);
+    _qu.push_back(cmd);
+    notify(false);
+}
+
+
+Command::Ptr CommandQueue::getCmd(bool wait) {
+    auto local = _local(true);
+    for (;;) {
+        // Newest private work first (lifo slack), ...
+        {
+            std::lock_guard<std::mutex> lock(local->mx);
+            if (!local->qu.empty()) {
+                auto cmd = local->qu.front();
+                local->qu.pop_front();
+                return cmd;
+            }
+        }
+        // ... then the oldest shared work, ...
+        {
+            std::lock_guard<std::mutex> lock(_mx);
+            if (!_qu.empty()) {
+                auto cmd = _qu.front();
+                _qu.pop_front();
+                return cmd;
+            }
+        }
+        // ... then the oldest work on anyone else's private deque.
+        auto cmd = _steal(local.get());
+        if (cmd != nullptr) {
+            return cmd;
+        }
+        if (!wait) {
+            return nullptr;
+        }
+        std::unique_lock<std::mutex> lock(_mx);
+        _cv.wait_for(lock, stealPollTime, [this]() { return !_qu.empty(); });
+    }
+}
+
+
+size_t CommandQueue::size() {
+    size_t sz;
+    {
+        std::lock_guard<std::mutex> lock(_mx);
+        sz = _qu.size();
+    }
+    std::lock_guard<std::mutex> localsLock(_localsMx);
+    for (auto const& entry : _locals) {
+        std::lock_guard<std::mutex> lock(entry.second->mx);
+        sz += entry.second->qu.size();
+    }
+    return sz;
+}
+
+
+void CommandQueue::consumerFinish() {
+    std::shared_ptr<_Local> local;
+    {
+        std::lock_guard<std::mutex> localsLock(_localsMx);
+        auto iter = _locals.find(std::this_thread::get_id());
+        if (iter == _locals.end()) {
+            return;
+        }
+        local = iter->second;
+        _locals.erase(iter);
+    }
+    std::deque<Command::Ptr> leftovers;
+    {
+        std::lock_guard<std::mutex> lock(local->mx);
+        leftovers.swap(local->qu);
+    }
+    if (!leftovers.empty()) {
+        std::lock_guard<std::mutex> lock(_mx);
+        for (auto const& cmd : leftovers) {
+            _qu.push_back(cmd);
+        }
+        notify(true);
+    }
+}
+
+
+std::shared_ptr<CommandQueue::_Local> CommandQueue::_local(bool create) {
+    // Resolve through a thread-local cache so the registry mutex stays off
+    // the per-command path. Entries expire when consumerFinish() drops the
+    // registry's reference, so a stale hit can't outlive its queue.
+    thread_local std::map<CommandQueue const*, std::weak_ptr<_Local>> cache;
+    auto cached = cache.find(this);
+    if (cached != cache.end()) {
+        auto local = cached->second.lock();
+        if (local != nullptr) {
+            return local;
+        }
+        cache.erase(cached);
+    }
+    std::lock_guard<std::mutex> localsLock(_localsMx);
+    auto iter = _locals.find(std::this_thread::get_id());
+    if (iter != _locals.end()) {
+        cache[this] = iter->second;
+        return iter->second;
+    }
+    if (!create) {
+        return nullptr;
+    }
+    auto local = std::make_shared<_Local>();
+    _locals[std::this_thread::get_id()] = local;
+    cache[this] = local;
+    return local;
+}
+
+
+Command::Ptr CommandQueue::_steal(_Local const* self) {
+    std::lock_guard<std::mutex> localsLock(_localsMx);
+    for (auto const& entry : _locals) {
+        auto& victim = *entry.second;
+        if (&victim == self) {
+            continue;
+        }
+        std::lock_guard<std::mutex> lock(victim.mx);
+        if (!victim.qu.empty()) {
+            auto cmd = victim.qu.back();
+            victim.qu.pop_back();
+            return cmd;
+        }
+    }
+    return nullptr;
+}
+
+
 /// Handle commands as they arrive until queEnd() is called.
 void EventThread::handleCmds() {
     startup();
@@ -61,6 +214,7 @@ void EventThread::handleCmds() {
         _cmd.reset();
         _currentCommand = nullptr;
     }
+    _q->consumerFinish(); // flush anything left on this thread's private deque
     finishup();
 }
 
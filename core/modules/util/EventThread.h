@@ -30,6 +30,8 @@
 #include <atomic>
 #include <cassert>
 #include <deque>
+#include <map>
+#include <memory>
 #include <queue>
 #include <thread>
 #include <vector>
@@ -76,37 +78,28 @@ namespace util {
 
 /// A queue of Commands meant to drive an EventThread.
 ///
+/// In the base implementation, commands queued by outside threads go onto a
+/// shared fifo while commands queued by a consuming thread go onto a small
+/// deque private to that thread. Consumers drain their private deque lifo
+/// first (a command queued while working runs next, on the same warm core),
+/// then the shared fifo, then steal the oldest command from another
+/// consumer's deque. Each enqueue wakes at most one waiting thread, so large
+/// pools no longer stampede on every command. Derived schedulers that
+/// override queCmd()/getCmd() (see wsched) are unaffected; the protected
+/// _qu/_cv/_mx members keep their meaning for them.
 class CommandQueue {
 public:
     using Ptr = std::shared_ptr<CommandQueue>;
     virtual ~CommandQueue() {};
     /// Queue a command object in a thread safe way and signal any threads
     /// waiting on the queue that a command is available.
-    virtual void queCmd(Command::Ptr const& cmd) {
-        std::lock_guard<std::mutex> lock(_mx);
-        _qu.push_back(cmd);
-        notify(_qu.size() > 1);
-    };
+    virtual void queCmd(Command::Ptr const& cmd);
 
     /// Get a command off the queue.
     /// If wait is true, wait until a message is available.
-    virtual Command::Ptr getCmd(bool wait=true) {
-        std::unique_lock<std::mutex> lock(_mx);
-        if (wait) {
-            _cv.wait(lock, [this](){return !_qu.empty();});
-        }
-        if (_qu.empty()) {
-            return nullptr;
-        }
-        auto cmd = _qu.front();
-        _qu.pop_front();
-        return cmd;
-    };
+    virtual Command::Ptr getCmd(bool wait=true);
 
-    virtual size_t size() {
-        std::lock_guard<std::mutex> lock(_mx);
-        return _qu.size();
-    }
+    virtual size_t size();
 
     /// Notify all threads waiting on this queue, or just 1 if all is false.
     virtual void notify(bool all=true) {
@@ -120,10 +113,35 @@ public:
     virtual void commandStart(Command::Ptr const&) {}; //< Derived methods must be thread safe.
     virtual void commandFinish(Command::Ptr const&) {}; //< Derived methods must be thread safe.
 
+    /// Called by a consuming thread when it stops taking commands from this
+    /// queue (see EventThread::handleCmds). The base implementation moves
+    /// anything left on that thread's private deque to the shared fifo so no
+    /// command is stranded when a pool thread retires.
+    virtual void consumerFinish();
+
 protected:
     std::deque<Command::Ptr> _qu{};
     std::condition_variable  _cv{};
     mutable std::mutex       _mx{};
+
+private:
+    /// Per-consumer private deque; the owner pushes and pops the front,
+    /// thieves pop the back.
+    struct _Local {
+        std::mutex mx;
+        std::deque<Command::Ptr> qu;
+    };
+
+    /// @return this thread's _Local, registering one if 'create' is set and
+    /// none exists; may return nullptr when 'create' is false.
+    std::shared_ptr<_Local> _local(bool create);
+
+    /// @return the oldest command stolen from another consumer's private
+    /// deque, or nullptr if there is nothing to steal.
+    Command::Ptr _steal(_Local const* self);
+
+    mutable std::mutex _localsMx; ///< Protects _locals.
+    std::map<std::thread::id, std::shared_ptr<_Local>> _locals;
 };
 
 /// An event driven thread, the event loop is in handleCmds().
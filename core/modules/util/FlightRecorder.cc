@@ -0,0 +1,120 @@
+// -*- LSST-C++ -*-
+
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "util/FlightRecorder.h"
+
+// System headers
+#include <atomic>
+#include <chrono>
+
+namespace {
+
+using lsst::qserv::util::FlightEvent;
+using lsst::qserv::util::FlightRecorder;
+
+// One ring slot. The sequence word is 2*ticket+1 while a writer is filling
+// the slot and 2*ticket+2 once the event is committed, where 'ticket' is
+// the global event ordinal that claimed the slot. A reader that sees any
+// other value knows the slot is torn or has been reclaimed and skips it.
+struct Slot {
+    std::atomic<uint64_t> seq{0};
+    FlightEvent event;
+};
+
+Slot ring[FlightRecorder::ringCapacity];
+std::atomic<uint64_t> nextTicket{0};
+
+uint64_t nowMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+} // anon namespace
+
+namespace lsst {
+namespace qserv {
+namespace util {
+
+// Out-of-line definition for odr-uses of the in-class constant.
+size_t const FlightRecorder::ringCapacity;
+
+
+void FlightRecorder::record(uint64_t queryId, Type type, int64_t value, int64_t extra) {
+    uint64_t const ticket = nextTicket.fetch_add(1, std::memory_order_relaxed);
+    Slot& slot = ring[ticket % ringCapacity];
+    slot.seq.store(2*ticket + 1, std::memory_order_release);
+    slot.event.timeMs = nowMs();
+    slot.event.queryId = queryId;
+    slot.event.type = type;
+    slot.event.value = value;
+    slot.event.extra = extra;
+    slot.seq.store(2*ticket + 2, std::memory_order_release);
+}
+
+
+std::vector<FlightEvent> FlightRecorder::snapshot() {
+    uint64_t const end = nextTicket.load(std::memory_order_acquire);
+    uint64_t const begin = end > ringCapacity ? end - ringCapacity : 0;
+    std::vector<FlightEvent> result;
+    result.reserve(end - begin);
+    for (uint64_t ticket = begin; ticket < end; ++ticket) {
+        Slot& slot = ring[ticket % ringCapacity];
+        if (slot.seq.load(std::memory_order_acquire) != 2*ticket + 2) continue;
+        FlightEvent event = slot.event;
+        // re-check after the copy; a writer may have reclaimed the slot
+        // while the fields were being read
+        if (slot.seq.load(std::memory_order_acquire) != 2*ticket + 2) continue;
+        result.push_back(event);
+    }
+    return result;
+}
+
+
+void FlightRecorder::dump(std::ostream& os) {
+    auto const events = snapshot();
+    os << "# flight recorder: " << events.size() << " events, oldest first\n";
+    for (auto const& event : events) {
+        os << event.timeMs << " QI=" << event.queryId
+           << " " << typeName(event.type)
+           << " value=" << event.value
+           << " extra=" << event.extra << "\n";
+    }
+}
+
+
+char const* FlightRecorder::typeName(uint32_t type) {
+    switch (type) {
+    case PARSE:        return "PARSE";
+    case ANALYZE:      return "ANALYZE";
+    case DISPATCH:     return "DISPATCH";
+    case JOB_RETRY:    return "JOB_RETRY";
+    case SQUASH:       return "SQUASH";
+    case LIMIT_SQUASH: return "LIMIT_SQUASH";
+    case QUERY_END:    return "QUERY_END";
+    }
+    return "UNKNOWN";
+}
+
+}}} // namespace lsst::qserv::util
@@ -0,0 +1,105 @@
+// -*- LSST-C++ -*-
+
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_UTIL_FLIGHTRECORDER_H
+#define LSST_QSERV_UTIL_FLIGHTRECORDER_H
+
+/// FlightRecorder.h declares:
+///
+///   struct FlightEvent
+///   class  FlightRecorder
+///
+/// An always-on ring of recent query diagnostics. Where util::Trace keeps
+/// aggregate per-phase timing, the flight recorder keeps the individual
+/// noteworthy events of the last few thousand queries - phase durations,
+/// job counts, retries and squashes - so that when a query misbehaves its
+/// recent history can be dumped without having had debug logging enabled.
+
+// System headers
+#include <cstddef>
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+namespace lsst {
+namespace qserv {
+namespace util {
+
+/// One recorded event. The meaning of value/extra depends on the event
+/// type; see FlightRecorder::Type.
+struct FlightEvent {
+    uint64_t timeMs;   ///< event time, milliseconds since the epoch
+    uint64_t queryId;  ///< query id, 0 when not yet assigned (e.g. PARSE)
+    uint32_t type;     ///< a FlightRecorder::Type value
+    int64_t value;     ///< primary payload, per-type meaning
+    int64_t extra;     ///< secondary payload, per-type meaning
+};
+
+/**
+ * Class FlightRecorder is the process-wide event ring. Events are written
+ * directly into preallocated slots: the writer claims a slot with a single
+ * atomic fetch-add and brackets its stores with a per-slot sequence word,
+ * so recording costs no locks and no allocation and is cheap enough to
+ * leave enabled in production. Readers copy slots and discard any that a
+ * concurrent writer was overwriting (detected by a sequence mismatch), so
+ * dumping the ring never stalls the query path.
+ */
+class FlightRecorder {
+public:
+
+    /// Events retained in the ring; older events are overwritten.
+    static size_t const ringCapacity = 16*1024;
+
+    /// Event types and what value/extra hold for each.
+    enum Type : uint32_t {
+        PARSE = 1,     ///< value=parse ms (queryId is 0, not assigned yet)
+        ANALYZE,       ///< value=analysis ms (queryId is 0, not assigned yet)
+        DISPATCH,      ///< value=dispatch ms, extra=jobs dispatched
+        JOB_RETRY,     ///< value=job id, extra=attempt number
+        SQUASH,        ///< query cancelled, all jobs being squashed
+        LIMIT_SQUASH,  ///< LIMIT satisfied early, remaining jobs squashed
+        QUERY_END      ///< value=1 on success else 0, extra=merge ms
+    };
+
+    /// Record one event. Lock-free; safe from any thread.
+    static void record(uint64_t queryId, Type type, int64_t value=0, int64_t extra=0);
+
+    /// @return a copy of the events currently in the ring, oldest first.
+    /// Events a concurrent writer is replacing are omitted.
+    static std::vector<FlightEvent> snapshot();
+
+    /// Write the current ring contents to 'os', one line per event,
+    /// oldest first.
+    static void dump(std::ostream& os);
+
+    /// @return the printable name of an event type
+    static char const* typeName(uint32_t type);
+
+private:
+    // All state is static; no instances.
+    FlightRecorder() = delete;
+};
+
+}}} // namespace lsst::qserv::util
+
+#endif // LSST_QSERV_UTIL_FLIGHTRECORDER_H
@@ -0,0 +1,185 @@
+// -*- LSST-C++ -*-
+
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "util/Histogram.h"
+
+// System headers
+#include <cmath>
+#include <limits>
+#include <sstream>
+#include <unordered_map>
+
+namespace {
+
+/// Source of process-unique histogram ids. Ids rather than object addresses
+/// key the per-thread shard cache so a histogram allocated at a recycled
+/// address can never pick up a dead histogram's shards.
+std::atomic<uint64_t> nextHistogramId{0};
+
+} // anonymous namespace
+
+namespace lsst {
+namespace qserv {
+namespace util {
+
+// Definitions for the in-class constants, needed wherever one is bound to
+// a reference.
+unsigned int const Histogram::SUB_BUCKET_BITS;
+unsigned int const Histogram::SUB_BUCKETS;
+unsigned int const Histogram::BUCKET_COUNT;
+
+Histogram::Shard::Shard() : count(0), sum(0), max(0) {
+    min.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed);
+    for (unsigned int j = 0; j < BUCKET_COUNT; ++j) {
+        buckets[j].store(0, std::memory_order_relaxed);
+    }
+}
+
+Histogram::Histogram(std::string const& name)
+    : _name(name), _id(++nextHistogramId) {
+}
+
+unsigned int Histogram::bucketFor(uint64_t value) {
+    if (value < 2*SUB_BUCKETS) return static_cast<unsigned int>(value);
+    // Find the highest set bit, then keep SUB_BUCKET_BITS+1 significant bits:
+    // the implicit leading one selects the run, the rest the sub-bucket.
+    unsigned int const exp = 63 - __builtin_clzll(value);
+    unsigned int const shift = exp - SUB_BUCKET_BITS;
+    return shift*SUB_BUCKETS + static_cast<unsigned int>(value >> shift);
+}
+
+uint64_t Histogram::bucketMin(unsigned int bucket) {
+    if (bucket < 2*SUB_BUCKETS) return bucket;
+    unsigned int const shift = bucket/SUB_BUCKETS - 1;
+    return static_cast<uint64_t>(SUB_BUCKETS + bucket%SUB_BUCKETS) << shift;
+}
+
+Histogram::Shard& Histogram::_localShard() {
+    // Each thread caches the shards it has registered, keyed by histogram
+    // id. An entry for a destroyed histogram lingers until the thread exits,
+    // but is never looked up again; the shared_ptr keeps it safely allocated.
+    thread_local std::unordered_map<uint64_t, std::shared_ptr<Shard>> shards;
+    auto iter = shards.find(_id);
+    if (iter != shards.end()) return *(iter->second);
+    auto shard = std::make_shared<Shard>();
+    {
+        std::lock_guard<std::mutex> lock(_shardsMtx);
+        _shards.push_back(shard);
+    }
+    shards[_id] = shard;
+    return *shard;
+}
+
+void Histogram::record(uint64_t value) {
+    Shard& shard = _localShard();
+    // This thread is the shard's only writer, so plain load-test-store is
+    // enough for min and max; no compare-exchange loops are needed.
+    shard.count.fetch_add(1, std::memory_order_relaxed);
+    shard.sum.fetch_add(value, std::memory_order_relaxed);
+    if (value < shard.min.load(std::memory_order_relaxed)) {
+        shard.min.store(value, std::memory_order_relaxed);
+    }
+    if (value > shard.max.load(std::memory_order_relaxed)) {
+        shard.max.store(value, std::memory_order_relaxed);
+    }
+    shard.buckets[bucketFor(value)].fetch_add(1, std::memory_order_relaxed);
+}
+
+Histogram::Snapshot Histogram::snapshot() const {
+    Snapshot s;
+    s.buckets.assign(BUCKET_COUNT, 0);
+    s.min = std::numeric_limits<uint64_t>::max();
+    std::lock_guard<std::mutex> lock(_shardsMtx);
+    for (auto const& shard : _shards) {
+        s.count += shard->count.load(std::memory_order_relaxed);
+        s.sum += shard->sum.load(std::memory_order_relaxed);
+        uint64_t const shardMin = shard->min.load(std::memory_order_relaxed);
+        if (shardMin < s.min) s.min = shardMin;
+        uint64_t const shardMax = shard->max.load(std::memory_order_relaxed);
+        if (shardMax > s.max) s.max = shardMax;
+        for (unsigned int j = 0; j < BUCKET_COUNT; ++j) {
+            s.buckets[j] += shard->buckets[j].load(std::memory_order_relaxed);
+        }
+    }
+    if (s.count == 0) s.min = 0;
+    return s;
+}
+
+uint64_t Histogram::Snapshot::percentile(double percent) const {
+    if (count == 0) return 0;
+    auto rank = static_cast<uint64_t>(std::ceil((percent/100.0)*count));
+    if (rank < 1) rank = 1;
+    uint64_t cumulative = 0;
+    for (unsigned int j = 0; j < buckets.size(); ++j) {
+        cumulative += buckets[j];
+        if (cumulative >= rank) return bucketMin(j);
+    }
+    // A value counted but not yet bucketed by a concurrent record() can
+    // leave the rank unreachable; the maximum is the honest answer then.
+    return max;
+}
+
+uint64_t Histogram::Snapshot::countLessThan(uint64_t value) const {
+    unsigned int const bucket = bucketFor(value);
+    uint64_t below = 0;
+    for (unsigned int j = 0; j < bucket; ++j) {
+        below += buckets[j];
+    }
+    uint64_t const lo = bucketMin(bucket);
+    if (bucket + 1 < BUCKET_COUNT && value > lo) {
+        uint64_t const width = bucketMin(bucket + 1) - lo;
+        below += buckets[bucket]*(value - lo)/width;
+    }
+    return below;
+}
+
+void Histogram::writePrometheus(std::ostream& os, std::string const& name,
+                                std::string const& labels) const {
+    Snapshot const s = snapshot();
+    std::string const sep = labels.empty() ? "" : ",";
+    os << name << "{" << labels << sep << "quantile=\"0.5\"} " << s.percentile(50.0) << "\n";
+    os << name << "{" << labels << sep << "quantile=\"0.9\"} " << s.percentile(90.0) << "\n";
+    os << name << "{" << labels << sep << "quantile=\"0.99\"} " << s.percentile(99.0) << "\n";
+    os << name << "_sum";
+    if (!labels.empty()) os << "{" << labels << "}";
+    os << " " << s.sum << "\n";
+    os << name << "_count";
+    if (!labels.empty()) os << "{" << labels << "}";
+    os << " " << s.count << "\n";
+}
+
+std::string Histogram::summary() const {
+    Snapshot const s = snapshot();
+    std::ostringstream os;
+    os << _name << " count=" << s.count << " mean=" << s.mean()
+       << " min=" << s.min
+       << " p50=" << s.percentile(50.0)
+       << " p90=" << s.percentile(90.0)
+       << " p99=" << s.percentile(99.0)
+       << " max=" << s.max;
+    return os.str();
+}
+
+}}} // namespace lsst::qserv::util
@@ -0,0 +1,160 @@
+// -*- LSST-C++ -*-
+
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_UTIL_HISTOGRAM_H
+#define LSST_QSERV_UTIL_HISTOGRAM_H
+
+/// Histogram.h declares:
+///
+///   class Histogram
+
+// System headers
+#include <atomic>
+#include <cstdint>
+#include <iosfwd>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace lsst {
+namespace qserv {
+namespace util {
+
+/**
+ * Class Histogram is a lock-free streaming histogram of unsigned values,
+ * typically millisecond durations or queue depths. Values are folded into
+ * logarithmic buckets, one run of linear sub-buckets per power of two, so
+ * any reported quantile is off by at most one sub-bucket width (about 3%
+ * of the value at the default resolution).
+ *
+ * Each recording thread writes its own shard, so record() is a few relaxed
+ * atomic updates with no shared cache lines and no locks; readers merge the
+ * shards under a mutex only when a snapshot is requested. Shards are never
+ * freed: counts recorded by a thread survive its exit, which is what a
+ * monotonic process-lifetime statistic wants.
+ *
+ * Unlike util::Trace, which retains the most recent raw spans in a bounded
+ * ring, a Histogram aggregates every value recorded since process start in
+ * fixed space, so tail percentiles cover the full history rather than
+ * whatever still fits in the ring.
+ */
+class Histogram {
+public:
+    using Ptr = std::shared_ptr<Histogram>;
+
+    /// Linear sub-buckets per power of two. 2^5 = 32 bounds the relative
+    /// error of any bucket boundary by 1/32, about 3%.
+    static unsigned int const SUB_BUCKET_BITS = 5;
+    static unsigned int const SUB_BUCKETS = 1 << SUB_BUCKET_BITS;
+
+    /// Buckets needed to cover the entire uint64_t range: the first two runs
+    /// of sub-buckets are a single linear range [0, 2*SUB_BUCKETS), then one
+    /// run per remaining power of two.
+    static unsigned int const BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1)*SUB_BUCKETS;
+
+    /// A merged view of everything recorded so far. Counts are monotonic,
+    /// so the difference of two snapshots is the histogram of the interval
+    /// between them.
+    struct Snapshot {
+        uint64_t count = 0; ///< number of values recorded
+        uint64_t sum = 0;   ///< sum of the recorded values
+        uint64_t min = 0;   ///< smallest recorded value, 0 when count == 0
+        uint64_t max = 0;   ///< largest recorded value
+        std::vector<uint64_t> buckets; ///< per-bucket counts, bounds per bucketMin()
+
+        double mean() const { return count == 0 ? 0.0 : double(sum)/double(count); }
+
+        /// @return an estimate of the value 'percent' (0-100) of the recorded
+        /// values fall at or below: the lower bound of the bucket holding the
+        /// nearest-rank element.
+        uint64_t percentile(double percent) const;
+
+        /// @return the number of recorded values below 'value'. The bucket
+        /// containing 'value' contributes pro rata, assuming values spread
+        /// uniformly within it.
+        uint64_t countLessThan(uint64_t value) const;
+    };
+
+    /// @param name - label used by summary(), e.g. "Scan-timeInQMs"
+    explicit Histogram(std::string const& name);
+
+    Histogram(Histogram const&) = delete;
+    Histogram& operator=(Histogram const&) = delete;
+
+    std::string const& getName() const { return _name; }
+
+    /// Fold 'value' into the calling thread's shard. Lock-free except for
+    /// the calling thread's first record() into this histogram, which
+    /// registers a new shard.
+    void record(uint64_t value);
+
+    /// @return the merged view of all shards. Values being recorded
+    /// concurrently may or may not be included; consistency between the
+    /// count and the buckets is within the few values in flight.
+    Snapshot snapshot() const;
+
+    /// @return a one-line summary with count, mean, min, p50/p90/p99 and max,
+    /// suitable for logging.
+    std::string summary() const;
+
+    /// Append this histogram to 'os' in the Prometheus summary exposition
+    /// format: quantile sample lines for p50/p90/p99 plus <name>_sum and
+    /// <name>_count. 'labels' is an optional comma-separated label list
+    /// without the enclosing braces; it is merged with the quantile label.
+    void writePrometheus(std::ostream& os, std::string const& name,
+                         std::string const& labels = std::string()) const;
+
+    /// @return the bucket index for 'value'.
+    static unsigned int bucketFor(uint64_t value);
+
+    /// @return the smallest value that maps to 'bucket'.
+    static uint64_t bucketMin(unsigned int bucket);
+
+private:
+    /// One recording thread's counters. Only the owning thread writes a
+    /// shard, so writes are plain relaxed stores; atomics make the values
+    /// safely readable from snapshot().
+    struct Shard {
+        Shard();
+        std::atomic<uint64_t> count;
+        std::atomic<uint64_t> sum;
+        std::atomic<uint64_t> min;
+        std::atomic<uint64_t> max;
+        std::atomic<uint64_t> buckets[BUCKET_COUNT];
+    };
+
+    /// @return the calling thread's shard for this histogram, registering
+    /// one on first use.
+    Shard& _localShard();
+
+    std::string const _name;
+    uint64_t const _id; ///< process-unique, keys the per-thread shard cache.
+
+    mutable std::mutex _shardsMtx; ///< protects _shards.
+    std::vector<std::shared_ptr<Shard>> _shards; ///< one per thread that has recorded.
+};
+
+}}} // namespace lsst::qserv::util
+
+#endif // LSST_QSERV_UTIL_HISTOGRAM_H
@@ -24,14 +24,41 @@
 #include "util/Mutex.h"
 
 // System headers
+#include <algorithm>
 #include <cassert>
+#include <chrono>
+#include <csignal>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <thread>
 
 // Qserv headers
 #include "lsst/log/Log.h"
 #include "util/IterableFormatter.h"
+#include "util/Trace.h"
 
 namespace {
+
 LOG_LOGGER _log = LOG_GET("lsst.qserv.util.Mutex");
+
+// The contention registry. Entries are allocated once and never removed, so
+// references handed out by forContext() stay valid while counters are being
+// bumped lock-free.
+std::mutex registryMtx;
+std::map<std::string, std::unique_ptr<lsst::qserv::util::LockContention::Stats>> registry;
+
+// Locks constructed without a context are aggregated under one entry.
+std::string const anonymousContext = "(anonymous)";
+
+// Set by the signal handler, polled by the dump thread; a handler can't
+// safely format or log anything itself.
+volatile std::sig_atomic_t dumpRequested = 0;
+
+void requestDump(int) {
+    dumpRequested = 1;
+}
+
 }
 
 namespace lsst {
@@ -41,9 +68,68 @@ namespace util {
 std::mutex Mutex::_lockedIdMtx;
 std::set<unsigned int> Mutex::_lockedId;
 
+
+LockContention::Stats& LockContention::forContext(std::string const& context) {
+    std::lock_guard<std::mutex> lg(registryMtx);
+    auto& stats = registry[context.empty() ? anonymousContext : context];
+    if (stats == nullptr) {
+        stats.reset(new Stats());
+    }
+    return *stats;
+}
+
+
+std::vector<LockContention::Sample> LockContention::snapshot() {
+    std::lock_guard<std::mutex> lg(registryMtx);
+    std::vector<Sample> result;
+    result.reserve(registry.size());
+    for (auto const& entry : registry) {
+        result.push_back(Sample{entry.first,
+                                entry.second->acquisitions.load(),
+                                entry.second->waitNs.load(),
+                                entry.second->holdNs.load()});
+    }
+    return result;
+}
+
+
+std::string LockContention::dump() {
+    auto samples = snapshot();
+    std::sort(samples.begin(), samples.end(),
+              [](Sample const& a, Sample const& b) { return a.waitNs > b.waitNs; });
+    std::ostringstream os;
+    os << "lock contention by callsite (hottest first):\n";
+    for (auto const& s : samples) {
+        os << "  " << s.context
+           << "  acquisitions=" << s.acquisitions
+           << "  waitMs=" << s.waitNs / 1000000.0
+           << "  holdMs=" << s.holdNs / 1000000.0 << "\n";
+    }
+    return os.str();
+}
+
+
+void LockContention::logOnSignal(int signo) {
+    std::signal(signo, requestDump);
+    static std::once_flag watcherStarted;
+    std::call_once(watcherStarted, []() {
+        std::thread([]() {
+            for (;;) {
+                std::this_thread::sleep_for(std::chrono::seconds(1));
+                if (dumpRequested) {
+                    dumpRequested = 0;
+                    LOGS(_log, LOG_LVL_INFO, dump());
+                }
+            }
+        }).detach();
+    });
+}
+
+
 Lock::Lock(Mutex& mutex, std::string const& context)
         :   _mutex(mutex),
-            _context(context) {
+            _context(context),
+            _stats(LockContention::forContext(context)) {
 
     if (not _context.empty()) {
         LOGS(_log, LOG_LVL_DEBUG, _context << "  LOCK[" << _mutex.id() << "]:1 "
@@ -51,7 +137,11 @@ Lock::Lock(Mutex& mutex, std::string const& context)
     }
 
     assert(not _mutex.lockedByCaller());
+    uint64_t const requestedNs = Trace::nowNs();
     _mutex.lock();
+    _acquiredNs = Trace::nowNs();
+    _stats.acquisitions++;
+    _stats.waitNs += _acquiredNs - requestedNs;
 
     if (not _context.empty()) {
         LOGS(_log, LOG_LVL_DEBUG, _context << "  LOCK[" << _mutex.id() << "]:2 "
@@ -66,6 +156,7 @@ Lock::~Lock() {
         LOGS(_log, LOG_LVL_DEBUG, _context << "  LOCK[" << _mutex.id() << "]:3 "
              << "  LOCKED: " << util::printable(Mutex::lockedId(), "", "", " "));
     }
+    _stats.holdNs += Trace::nowNs() - _acquiredNs;
     _mutex.unlock();
 }
 }}} // namespace lsst::qserv::util
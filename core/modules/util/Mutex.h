@@ -26,15 +26,19 @@
 /// Mutex.h declares:
 ///
 ///   class Mutex
+///   class LockContention
+///   class Lock
 ///
 /// (see individual class documentation for more information)
 
 // System headers
 #include <atomic>
+#include <cstdint>
 #include <mutex>
 #include <set>
 #include <string>
 #include <thread>
+#include <vector>
 
 // Qserv headers
 
@@ -138,6 +142,51 @@ private:
 //Lock&& lock(Mutex& mutex, std::string const& context=std::string());
 
 
+/**
+ * Class LockContention aggregates per-callsite lock contention statistics.
+ * Class Lock reports each acquisition here, keyed by the context string
+ * passed to its constructor, so locking hot spots can be ranked without
+ * rebuilding with profiling annotations. Counters are plain atomics; the
+ * registry mutex is taken only briefly to resolve a context to its counters.
+ */
+class LockContention {
+
+public:
+
+    /// Counters for one callsite. Updated lock-free after registration.
+    struct Stats {
+        std::atomic<std::uint64_t> acquisitions{0}; ///< times the lock was taken
+        std::atomic<std::uint64_t> waitNs{0};       ///< total time blocked acquiring, nanoseconds
+        std::atomic<std::uint64_t> holdNs{0};       ///< total time held, nanoseconds
+    };
+
+    /// A copied-out view of one callsite's counters, for reporting.
+    struct Sample {
+        std::string context;
+        std::uint64_t acquisitions;
+        std::uint64_t waitNs;
+        std::uint64_t holdNs;
+    };
+
+    /// @return the counters registered for the specified context, creating
+    /// them on first use. The returned reference remains valid for the life
+    /// of the process.
+    static Stats& forContext(std::string const& context);
+
+    /// @return a copy of all callsites' counters
+    static std::vector<Sample> snapshot();
+
+    /// @return a human-readable table of all callsites, sorted by total
+    /// wait time descending (the hottest locks first)
+    static std::string dump();
+
+    /// Arrange for dump() to be written to the log whenever the process
+    /// receives the specified signal. The signal handler only sets a flag;
+    /// a background thread does the formatting and logging.
+    static void logOnSignal(int signo);
+};
+
+
 /**
  * Class Lock is designed to completement the above defined class Mutex.
  * The current implementation of the class is very similar to std::lock_guard.
@@ -150,6 +199,10 @@ private:
  *
  * The lock will assert that no lock is being held on a mutex by the calling
  * thread before attempting to lock the mutex.
+ *
+ * Each acquisition also feeds the contention profiler (see class
+ * LockContention above): acquisition count, wait time, and hold time are
+ * accumulated per context string.
  */
 class Lock {
 
@@ -174,6 +227,8 @@ public:
 private:
     Mutex& _mutex;
     std::string _context;
+    LockContention::Stats& _stats;
+    std::uint64_t _acquiredNs;
 };
 
 }}} // namespace lsst::qserv::util
@@ -0,0 +1,150 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "util/NumaNode.h"
+
+// System headers
+#include <cerrno>
+#include <fstream>
+#include <sched.h>
+#include <sstream>
+#include <vector>
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.util.NumaNode");
+
+/// Host topology, read once from /sys/devices/system/node.
+struct Topology {
+    int nodeCount{1};
+    std::vector<int> cpuToNode;        ///< indexed by cpu id, value is node id.
+    std::vector<cpu_set_t> nodeCpus;   ///< indexed by node id.
+};
+
+/// Parse a cpulist string such as "0-7,16-23" and assign those cpus to 'node'.
+/// @return false if the string could not be parsed.
+bool parseCpuList(std::string const& list, int node, Topology& topo) {
+    std::istringstream is(list);
+    std::string range;
+    bool found = false;
+    while (std::getline(is, range, ',')) {
+        int first = -1;
+        int last = -1;
+        auto dash = range.find('-');
+        try {
+            if (dash == std::string::npos) {
+                first = last = std::stoi(range);
+            } else {
+                first = std::stoi(range.substr(0, dash));
+                last = std::stoi(range.substr(dash + 1));
+            }
+        } catch (std::exception const&) {
+            return false;
+        }
+        if (first < 0 || last < first) {
+            return false;
+        }
+        for (int cpu = first; cpu <= last; ++cpu) {
+            if (cpu >= static_cast<int>(topo.cpuToNode.size())) {
+                topo.cpuToNode.resize(cpu + 1, -1);
+            }
+            topo.cpuToNode[cpu] = node;
+            if (cpu < CPU_SETSIZE) {
+                CPU_SET(cpu, &topo.nodeCpus[node]);
+            }
+            found = true;
+        }
+    }
+    return found;
+}
+
+/// Read the topology from /sys. On any problem, fall back to a single node.
+Topology readTopology() {
+    Topology topo;
+    for (int node = 0; ; ++node) {
+        std::ostringstream path;
+        path << "/sys/devices/system/node/node" << node << "/cpulist";
+        std::ifstream file(path.str());
+        if (!file.good()) {
+            break;
+        }
+        std::string list;
+        std::getline(file, list);
+        topo.nodeCpus.emplace_back();
+        CPU_ZERO(&topo.nodeCpus.back());
+        if (!parseCpuList(list, node, topo)) {
+            LOGS(_log, LOG_LVL_WARN, "NumaNode could not parse cpulist for node " << node
+                 << " '" << list << "', ignoring NUMA topology");
+            return Topology();
+        }
+        topo.nodeCount = node + 1;
+    }
+    LOGS(_log, LOG_LVL_DEBUG, "NumaNode found " << topo.nodeCount << " node(s)");
+    return topo;
+}
+
+Topology const& getTopology() {
+    static Topology const topo = readTopology();
+    return topo;
+}
+
+} // anonymous namespace
+
+namespace lsst {
+namespace qserv {
+namespace util {
+
+int NumaNode::nodeCount() {
+    return getTopology().nodeCount;
+}
+
+int NumaNode::currentNode() {
+    auto const& topo = getTopology();
+    if (topo.nodeCount <= 1) {
+        return topo.cpuToNode.empty() ? -1 : 0;
+    }
+    int cpu = ::sched_getcpu();
+    if (cpu < 0 || cpu >= static_cast<int>(topo.cpuToNode.size())) {
+        return -1;
+    }
+    return topo.cpuToNode[cpu];
+}
+
+bool NumaNode::pinCurrentThread(int node) {
+    auto const& topo = getTopology();
+    if (node < 0 || node >= static_cast<int>(topo.nodeCpus.size())) {
+        return false;
+    }
+    if (::sched_setaffinity(0, sizeof(cpu_set_t), &topo.nodeCpus[node]) != 0) {
+        LOGS(_log, LOG_LVL_WARN, "NumaNode failed to pin thread to node " << node
+             << " errno=" << errno);
+        return false;
+    }
+    return true;
+}
+
+}}} // namespace lsst::qserv::util
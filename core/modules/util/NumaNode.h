@@ -0,0 +1,62 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_UTIL_NUMANODE_H
+#define LSST_QSERV_UTIL_NUMANODE_H
+
+// System headers
+#include <string>
+
+namespace lsst {
+namespace qserv {
+namespace util {
+
+/// NumaNode answers simple questions about the NUMA topology of the host.
+/// The topology is read once from /sys/devices/system/node, which avoids a
+/// dependency on libnuma. On hosts where that information is unavailable
+/// (or there is only one node), nodeCount() returns 1 and the other methods
+/// degrade to harmless defaults, so callers can use this unconditionally.
+///
+/// The worker uses this to keep a scan's processing near the memory where
+/// MemMan locked the chunk's tables; on a multi-socket machine, reading a
+/// locked table from the remote node costs significantly more than from
+/// the local one.
+class NumaNode {
+public:
+    /// @return the number of NUMA nodes on this host, at least 1.
+    static int nodeCount();
+
+    /// @return the node the calling thread is currently running on,
+    ///         or -1 if it cannot be determined.
+    static int currentNode();
+
+    /// Restrict the calling thread to the CPUs of 'node'.
+    /// @return false if 'node' is unknown or the affinity call failed.
+    static bool pinCurrentThread(int node);
+
+private:
+    NumaNode() = delete;
+};
+
+}}} // namespace lsst::qserv::util
+
+#endif // LSST_QSERV_UTIL_NUMANODE_H
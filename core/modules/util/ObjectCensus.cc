@@ -0,0 +1,78 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "util/ObjectCensus.h"
+
+// System headers
+#include <cstdlib>
+#include <memory>
+#include <tuple>
+
+// Third-party headers
+#include <cxxabi.h>
+
+namespace lsst {
+namespace qserv {
+namespace util {
+
+ObjectCensus& ObjectCensus::get() {
+    static ObjectCensus instance;
+    return instance;
+}
+
+
+std::atomic<std::int64_t>& ObjectCensus::counter(std::string const& name) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    auto iter = _counters.find(name);
+    if (iter == _counters.end()) {
+        iter = _counters.emplace(std::piecewise_construct,
+                                 std::forward_as_tuple(name),
+                                 std::forward_as_tuple(0)).first;
+    }
+    return iter->second;
+}
+
+
+std::map<std::string, std::int64_t> ObjectCensus::snapshot() {
+    std::map<std::string, std::int64_t> result;
+    std::lock_guard<std::mutex> lock(_mtx);
+    for (auto const& entry : _counters) {
+        result[entry.first] = entry.second.load(std::memory_order_relaxed);
+    }
+    return result;
+}
+
+
+std::string demangledName(std::type_info const& typeInfo) {
+    int status = 0;
+    std::unique_ptr<char, void(*)(void*)> demangled(
+            abi::__cxa_demangle(typeInfo.name(), nullptr, nullptr, &status),
+            std::free);
+    if (status != 0 or demangled == nullptr) {
+        return typeInfo.name();
+    }
+    return demangled.get();
+}
+
+}}} // namespace lsst::qserv::util
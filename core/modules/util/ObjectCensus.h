@@ -0,0 +1,106 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_UTIL_OBJECTCENSUS_H
+#define LSST_QSERV_UTIL_OBJECTCENSUS_H
+
+// System headers
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <mutex>
+#include <string>
+#include <typeinfo>
+
+namespace lsst {
+namespace qserv {
+namespace util {
+
+/// ObjectCensus keeps a live-object count per registered type. Unlike
+/// InstanceCount it is cheap enough to leave on in production: each object
+/// lifetime costs one relaxed atomic increment and one decrement on a counter
+/// that is resolved once per type, with the global registration mutex taken
+/// only the first time a type is seen. The counts are exported through the
+/// metrics endpoint, so slow memory growth shows up as a rising live-object
+/// curve labeled with the class that is leaking.
+///
+/// Types join the census by inheriting from the CRTP helper below:
+///
+///     class Task : public util::CensusMember<Task> { ... };
+class ObjectCensus {
+public:
+
+    /// @return the process-wide census
+    static ObjectCensus& get();
+
+    ObjectCensus(ObjectCensus const&) = delete;
+    ObjectCensus& operator=(ObjectCensus const&) = delete;
+
+    /// Register (or look up) the counter for a type name. The returned
+    /// counter lives for the life of the process, so callers may cache
+    /// the reference. Thread safe.
+    std::atomic<std::int64_t>& counter(std::string const& name);
+
+    /// @return a point-in-time copy of all live-object counts by type name
+    std::map<std::string, std::int64_t> snapshot();
+
+private:
+
+    ObjectCensus() = default;
+
+    std::mutex _mtx;    ///< Guards _counters registration
+    /// Counters are held by reference from census members, so entries are
+    /// never removed.
+    std::map<std::string, std::atomic<std::int64_t>> _counters;
+};
+
+
+/// @return the demangled name of a type_info, or the raw name if
+/// demangling fails.
+std::string demangledName(std::type_info const& typeInfo);
+
+
+/// CRTP mix-in counting the live instances of T in the process ObjectCensus.
+/// The counter reference is resolved once per type; every construction,
+/// copy and destruction after that is a single relaxed atomic operation.
+template <typename T>
+class CensusMember {
+protected:
+    CensusMember() { _counter().fetch_add(1, std::memory_order_relaxed); }
+    CensusMember(CensusMember const&) { _counter().fetch_add(1, std::memory_order_relaxed); }
+    CensusMember& operator=(CensusMember const&) { return *this; } // count is per object, not per value
+    ~CensusMember() { _counter().fetch_sub(1, std::memory_order_relaxed); }
+
+    /// @return the number of live instances of T, for tests and logging
+    static std::int64_t liveCount() { return _counter().load(std::memory_order_relaxed); }
+
+private:
+    static std::atomic<std::int64_t>& _counter() {
+        static std::atomic<std::int64_t>& counter
+                = ObjectCensus::get().counter(demangledName(typeid(T)));
+        return counter;
+    }
+};
+
+}}} // namespace lsst::qserv::util
+
+#endif // LSST_QSERV_UTIL_OBJECTCENSUS_H
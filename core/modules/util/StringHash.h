@@ -25,6 +25,8 @@
 #define LSST_QSERV_UTIL_STRINGHASH_H
 
 // System headers
+#include <cstddef>
+#include <cstdint>
 #include <string>
 
 namespace lsst {
@@ -34,6 +36,23 @@ namespace util {
 /// Small wrappers for computing hashes
 class StringHash {
 public:
+    /// Fast non-cryptographic 64-bit hash of the input buffer (xxHash64).
+    /// Suitable for naming scratch tables and keying caches where speed
+    /// matters; not suitable for integrity checks or anything adversarial.
+    static uint64_t getXxHash64(void const* buffer, size_t bufferSize,
+                                uint64_t seed = 0);
+
+    /// @return getXxHash64 of the input formatted as 16 hex digits; a fast
+    /// drop-in for the *Hex crypto digests where names embed a hash.
+    static std::string getXxHash64Hex(void const* buffer, size_t bufferSize,
+                                      uint64_t seed = 0);
+
+    /// Fast non-cryptographic 128-bit hash (two independently seeded
+    /// xxHash64 runs), for keys where a 64-bit collision would be harmful
+    /// rather than merely unlucky, e.g. cache keys that select result data.
+    /// @return the raw 16-byte hash
+    static std::string getXxHash128(void const* buffer, size_t bufferSize);
+
     static std::string getMd5Hex(char const* buffer, int bufferSize);
     static std::string getSha1Hex(char const* buffer, int bufferSize);
     static std::string getSha256Hex(char const* buffer, int bufferSize);
@@ -36,6 +36,12 @@
 
 namespace {
 LOG_LOGGER _log = LOG_GET("lsst.qserv.util.ThreadPool");
+
+/// The pool the current thread belongs to, nullptr on non-pool threads.
+/// Set once at thread startup and never cleared; a thread that leaves its
+/// pool keeps a shared_ptr to it, so the pointer stays valid for the
+/// blocked-count bookkeeping until the thread ends.
+thread_local lsst::qserv::util::ThreadPool* currentThreadPool = nullptr;
 }
 
 namespace lsst {
@@ -62,6 +68,16 @@ PoolEventThread::~PoolEventThread() {
 }
 
 
+/// Run the pool's per-thread startup function, if one was provided.
+void PoolEventThread::startup() {
+    currentThreadPool = _threadPool.get();
+    auto threadStartup = _threadPool->getThreadStartup();
+    if (threadStartup != nullptr) {
+        threadStartup();
+    }
+}
+
+
 /// If cmd is a CommandThreadPool object, give it a copy of our this pointer.
 void PoolEventThread::specialActions(Command::Ptr const& cmd) {
     CommandThreadPool::Ptr cmdPool = std::dynamic_pointer_cast<CommandThreadPool>(cmd);
@@ -137,16 +153,18 @@ PoolEventThread::Ptr CommandThreadPool::getAndNullPoolEventThread() {
 
 
 ThreadPool::Ptr ThreadPool::newThreadPool(unsigned int thrdCount,
-      CommandQueue::Ptr const& q, EventThreadJoiner::Ptr const& joiner) {
-    Ptr thp(new ThreadPool(thrdCount, q, joiner)); // private constructor
+      CommandQueue::Ptr const& q, EventThreadJoiner::Ptr const& joiner,
+      std::function<void()> const& threadStartup) {
+    Ptr thp(new ThreadPool(thrdCount, q, joiner, threadStartup)); // private constructor
     thp->_resize();
     return thp;
 }
 
 
 ThreadPool::ThreadPool(unsigned int thrdCount, CommandQueue::Ptr const& q,
-                       EventThreadJoiner::Ptr const& joiner)
-    : _targetThrdCount(thrdCount), _q(q), _joinerThread(joiner) {
+                       EventThreadJoiner::Ptr const& joiner,
+                       std::function<void()> const& threadStartup)
+    : _targetThrdCount(thrdCount), _q(q), _joinerThread(joiner), _threadStartup(threadStartup) {
     if (_q == nullptr) {
         _q = std::make_shared<CommandQueue>();
     }
@@ -243,6 +261,20 @@ void ThreadPool::_resize() {
     }
 }
 
+void ThreadPool::markBlocked() {
+    if (currentThreadPool != nullptr) {
+        ++(currentThreadPool->_blockedCount);
+    }
+}
+
+
+void ThreadPool::markUnblocked() {
+    if (currentThreadPool != nullptr) {
+        --(currentThreadPool->_blockedCount);
+    }
+}
+
+
 /// Wait for the pool to reach the _targetThrdCount number of threads.
 /// It will wait forever if 'millisecs' is zero, otherwise it will timeout
 /// after that number of milliseconds.
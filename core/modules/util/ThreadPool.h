@@ -30,6 +30,7 @@
 #include <atomic>
 #include <cassert>
 #include <deque>
+#include <functional>
 #include <queue>
 #include <thread>
 #include <vector>
@@ -59,6 +60,7 @@ public:
     bool leavePool(Command::Ptr const& cmd);
 
 protected:
+    void startup() override; ///< Runs the pool's thread startup function, if any.
     void specialActions(Command::Ptr const& cmd) override;
     void finishup() override;
     std::shared_ptr<ThreadPool> _threadPool;
@@ -98,9 +100,14 @@ private:
 class ThreadPool : public std::enable_shared_from_this<ThreadPool> {
 public:
     using Ptr = std::shared_ptr<ThreadPool>;
+    /// 'threadStartup', when provided, is run by each pool thread as it starts,
+    /// before it handles any commands. This includes replacement threads created
+    /// when the pool is resized or a thread leaves the pool. It is meant for
+    /// per-thread setup such as setting cpu affinity and must be thread safe.
     static ThreadPool::Ptr newThreadPool(unsigned int thrdCount,
                                          CommandQueue::Ptr const& q,
-                                         EventThreadJoiner::Ptr const& joiner = nullptr);
+                                         EventThreadJoiner::Ptr const& joiner = nullptr,
+                                         std::function<void()> const& threadStartup = nullptr);
 
     virtual ~ThreadPool();
 
@@ -120,8 +127,31 @@ public:
     void resize(unsigned int targetThrdCount);
     bool release(PoolEventThread *thread);
 
+    /// @return the number of this pool's threads currently inside a blocked section.
+    int getBlockedCount() const { return _blockedCount; }
+
+    /// Mark the calling thread as entering/leaving a section where it blocks
+    /// (disk or network I/O, long waits). No-ops on threads that are not part
+    /// of a ThreadPool. Closed-loop pool sizing (see wcontrol::Foreman) uses
+    /// the count to tell runnable threads from blocked ones.
+    static void markBlocked();
+    static void markUnblocked();
+
+    /// RAII wrapper for markBlocked()/markUnblocked().
+    class BlockedRegion {
+    public:
+        BlockedRegion() { markBlocked(); }
+        ~BlockedRegion() { markUnblocked(); }
+        BlockedRegion(BlockedRegion const&) = delete;
+        BlockedRegion& operator=(BlockedRegion const&) = delete;
+    };
+
+    /// @return the function each pool thread runs at startup, possibly nullptr.
+    std::function<void()> getThreadStartup() { return _threadStartup; }
+
 private:
-    ThreadPool(unsigned int thrdCount, CommandQueue::Ptr const& q, EventThreadJoiner::Ptr const& joiner);
+    ThreadPool(unsigned int thrdCount, CommandQueue::Ptr const& q, EventThreadJoiner::Ptr const& joiner,
+               std::function<void()> const& threadStartup);
     void _resize();
 
     std::mutex _poolMutex; ///< Protects _pool
@@ -133,7 +163,9 @@ private:
     CommandQueue::Ptr _q; ///< The queue used by all threads in the _pool.
 
     EventThreadJoiner::Ptr _joinerThread; ///< Tracks and joins threads removed from the pool.
+    std::function<void()> _threadStartup; ///< Run by each pool thread as it starts, may be nullptr.
     std::atomic<bool> _shutdown{false}; ///< True after shutdownPool has been called.
+    std::atomic<int> _blockedCount{0}; ///< Threads of this pool inside a blocked section.
 };
 
 
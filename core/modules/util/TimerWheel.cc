@@ -0,0 +1,127 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "util/TimerWheel.h"
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+namespace {
+LOG_LOGGER _log = LOG_GET("lsst.qserv.util.TimerWheel");
+}
+
+namespace lsst {
+namespace qserv {
+namespace util {
+
+TimerWheel::Ptr TimerWheel::newTimerWheel(std::chrono::milliseconds tickInterval,
+                                          unsigned int numSlots, unsigned int poolThreads) {
+    return TimerWheel::Ptr(new TimerWheel(tickInterval, numSlots, poolThreads));
+}
+
+
+TimerWheel::TimerWheel(std::chrono::milliseconds tickInterval, unsigned int numSlots,
+                       unsigned int poolThreads)
+    : _tick(tickInterval), _slots(numSlots),
+      _dispatchQueue(std::make_shared<CommandQueue>()) {
+    _pool = ThreadPool::newThreadPool(poolThreads, _dispatchQueue);
+    _thread = std::thread(&TimerWheel::_run, this);
+}
+
+
+TimerWheel::~TimerWheel() {
+    shutdown();
+}
+
+
+TimerWheel::Timeout::Ptr TimerWheel::schedule(std::chrono::milliseconds delay,
+                                              CallbackFunc const& func) {
+    Timeout::Ptr timeout(new Timeout(func));
+    // A timeout must never fire early, so the delay is rounded up to whole
+    // ticks. A zero tick count would put it in the slot currently being
+    // drained, where it could be missed for a full turn of the wheel.
+    uint64_t ticks = (delay.count() + _tick.count() - 1) / _tick.count();
+    if (ticks == 0) ticks = 1;
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        timeout->_remainingRounds = ticks / _slots.size();
+        _slots[(_cursor + ticks) % _slots.size()].push_back(timeout);
+    }
+    return timeout;
+}
+
+
+void TimerWheel::_run() {
+    auto nextTick = std::chrono::steady_clock::now() + _tick;
+    std::vector<Timeout::Ptr> due;
+    std::unique_lock<std::mutex> lock(_mtx);
+    while (!_shutdown) {
+        // Waiting on the absolute tick time keeps the wheel from drifting
+        // when draining a slot takes a while.
+        if (_cv.wait_until(lock, nextTick, [this]() { return _shutdown; })) break;
+        nextTick += _tick;
+        _cursor = (_cursor + 1) % _slots.size();
+
+        // Entries still owed a full turn of the wheel stay in the slot with
+        // one less round; everything else is due (or cancelled) and leaves.
+        auto& slot = _slots[_cursor];
+        auto keep = slot.begin();
+        for (auto& timeout : slot) {
+            if (timeout->_remainingRounds > 0) {
+                --timeout->_remainingRounds;
+                *keep++ = std::move(timeout);
+            } else {
+                due.push_back(std::move(timeout));
+            }
+        }
+        slot.erase(keep, slot.end());
+
+        // Dispatch outside the lock so schedule() and cancel() never wait on
+        // the pool's queue.
+        lock.unlock();
+        for (auto& timeout : due) {
+            if (timeout->_done.exchange(true)) continue; // Cancelled.
+            auto func = timeout->_func;
+            _dispatchQueue->queCmd(std::make_shared<Command>(
+                    [func](CmdData*) { func(); }));
+        }
+        due.clear();
+        lock.lock();
+    }
+}
+
+
+void TimerWheel::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        if (_shutdown) return;
+        _shutdown = true;
+    }
+    _cv.notify_all();
+    _thread.join();
+    _pool->shutdownPool();
+    LOGS(_log, LOG_LVL_DEBUG, "TimerWheel shutdown complete");
+}
+
+}}} // namespace lsst::qserv::util
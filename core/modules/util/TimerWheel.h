@@ -0,0 +1,126 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+#ifndef LSST_QSERV_UTIL_TIMERWHEEL_H
+#define LSST_QSERV_UTIL_TIMERWHEEL_H
+
+// System headers
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Qserv headers
+#include "util/EventThread.h"
+#include "util/ThreadPool.h"
+
+namespace lsst {
+namespace qserv {
+namespace util {
+
+/// A hashed-wheel timer service.
+///
+/// A single thread advances a circular array of slots once per tick. A
+/// timeout is hashed into the slot where it is due, together with the number
+/// of full turns of the wheel remaining, making schedule() and cancel() O(1)
+/// regardless of how many timeouts are outstanding. This is the right tool
+/// when there are very many timeouts and almost all of them are cancelled
+/// before they fire (retry delays, request expirations); a heap of timers
+/// pays O(log n) per operation for precision that such timeouts do not need.
+///
+/// Expired callbacks are dispatched onto a small internal ThreadPool so a
+/// slow callback cannot stall the wheel. Precision is one tick: a timeout
+/// fires no earlier than requested and up to one tick interval late.
+///
+/// shutdown() must be called before the TimerWheel is destroyed unless the
+/// destructor is relied upon to do it; timeouts still pending at shutdown
+/// are dropped without firing.
+class TimerWheel : public std::enable_shared_from_this<TimerWheel> {
+public:
+    using Ptr = std::shared_ptr<TimerWheel>;
+    using CallbackFunc = std::function<void()>;
+
+    /// Handle to a scheduled timeout, returned by schedule().
+    class Timeout {
+    public:
+        using Ptr = std::shared_ptr<Timeout>;
+
+        /// Cancel the timeout. O(1); the wheel discards the entry when its
+        /// slot next comes due.
+        /// @return true if the callback will not run, false if it has
+        /// already run or has been handed to the dispatch pool.
+        bool cancel() { return !_done.exchange(true); }
+
+        friend class TimerWheel;
+    private:
+        explicit Timeout(CallbackFunc const& func) : _func(func) {}
+        CallbackFunc _func;
+        std::atomic<bool> _done{false}; ///< Set by cancel() or by firing, whichever is first.
+        uint32_t _remainingRounds{0}; ///< Full wheel turns left, protected by the wheel's _mtx.
+    };
+
+    /// @param tickInterval - wheel resolution; timeouts fire up to one tick late.
+    /// @param numSlots     - slots on the wheel; delays beyond numSlots ticks
+    ///                       simply take extra turns of the wheel.
+    /// @param poolThreads  - threads dispatching expired callbacks.
+    static Ptr newTimerWheel(std::chrono::milliseconds tickInterval=std::chrono::milliseconds(100),
+                             unsigned int numSlots=512, unsigned int poolThreads=2);
+
+    TimerWheel(TimerWheel const&) = delete;
+    TimerWheel& operator=(TimerWheel const&) = delete;
+    virtual ~TimerWheel();
+
+    /// Schedule 'func' to run after at least 'delay'. O(1).
+    /// @return a handle that may be used to cancel the timeout.
+    Timeout::Ptr schedule(std::chrono::milliseconds delay, CallbackFunc const& func);
+
+    /// Stop the wheel thread and the dispatch pool. Pending timeouts are
+    /// dropped without firing; callbacks already dispatched complete.
+    void shutdown();
+
+private:
+    TimerWheel(std::chrono::milliseconds tickInterval, unsigned int numSlots,
+               unsigned int poolThreads);
+
+    void _run(); ///< The wheel thread, advances the cursor once per tick.
+
+    std::chrono::milliseconds const _tick;
+    std::vector<std::vector<Timeout::Ptr>> _slots; ///< Protected by _mtx.
+    size_t _cursor{0}; ///< Slot currently due, protected by _mtx.
+
+    std::mutex _mtx;
+    std::condition_variable _cv; ///< Wakes the wheel thread for shutdown.
+    bool _shutdown{false}; ///< Protected by _mtx.
+    std::thread _thread;
+
+    CommandQueue::Ptr _dispatchQueue; ///< Expired callbacks are queued here...
+    ThreadPool::Ptr _pool;            ///< ...and run by this pool.
+};
+
+}}} // namespace lsst::qserv::util
+
+#endif // LSST_QSERV_UTIL_TIMERWHEEL_H
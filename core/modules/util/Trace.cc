@@ -0,0 +1,142 @@
+// -*- LSST-C++ -*-
+
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "util/Trace.h"
+
+// System headers
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+
+namespace {
+
+size_t const threadBufferCapacity = 256; // spans buffered per thread before a flush
+
+// The ring buffer and its write cursor; _ringFull distinguishes a wrapped
+// ring from a partially filled one.
+std::mutex ringMutex;
+std::vector<lsst::qserv::util::TraceSpan> ring;
+size_t ringNext = 0;
+bool ringFull = false;
+
+void flushBuffer(std::vector<lsst::qserv::util::TraceSpan>& buffer) {
+    if (buffer.empty()) {
+        return;
+    }
+    std::lock_guard<std::mutex> lock(ringMutex);
+    if (ring.empty()) {
+        ring.resize(lsst::qserv::util::Trace::ringCapacity);
+    }
+    for (auto const& span : buffer) {
+        ring[ringNext] = span;
+        if (++ringNext == ring.size()) {
+            ringNext = 0;
+            ringFull = true;
+        }
+    }
+    buffer.clear();
+}
+
+// Per-thread span buffer; the destructor flushes whatever the thread
+// accumulated but never reported before exiting.
+struct ThreadBuffer {
+    std::vector<lsst::qserv::util::TraceSpan> spans;
+    ThreadBuffer() { spans.reserve(threadBufferCapacity); }
+    ~ThreadBuffer() { flushBuffer(spans); }
+};
+
+thread_local ThreadBuffer threadBuffer;
+
+// Nearest-rank percentile of a sorted duration sample.
+uint64_t percentile(std::vector<uint64_t> const& sorted, double p) {
+    size_t rank = static_cast<size_t>(p * sorted.size());
+    if (rank >= sorted.size()) rank = sorted.size() - 1;
+    return sorted[rank];
+}
+
+} // anon namespace
+
+namespace lsst {
+namespace qserv {
+namespace util {
+
+uint64_t Trace::nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+void Trace::record(TraceSpan const& span) {
+    auto& buffer = threadBuffer.spans;
+    buffer.push_back(span);
+    if (buffer.size() >= threadBufferCapacity) {
+        flushBuffer(buffer);
+    }
+}
+
+
+void Trace::flush() {
+    flushBuffer(threadBuffer.spans);
+}
+
+
+std::vector<TraceSpan> Trace::snapshot() {
+    std::lock_guard<std::mutex> lock(ringMutex);
+    std::vector<TraceSpan> result;
+    if (ring.empty()) {
+        return result;
+    }
+    if (ringFull) {
+        result.reserve(ring.size());
+        result.insert(result.end(), ring.begin() + ringNext, ring.end());
+    } else {
+        result.reserve(ringNext);
+    }
+    result.insert(result.end(), ring.begin(), ring.begin() + ringNext);
+    return result;
+}
+
+
+std::map<std::string, Trace::PhaseStats> Trace::summarize() {
+    std::map<std::string, std::vector<uint64_t>> durationsByName;
+    for (auto const& span : snapshot()) {
+        durationsByName[span.name].push_back(span.durationNs);
+    }
+    std::map<std::string, PhaseStats> result;
+    for (auto& entry : durationsByName) {
+        auto& durations = entry.second;
+        std::sort(durations.begin(), durations.end());
+        PhaseStats stats;
+        stats.count = durations.size();
+        stats.p50Ns = percentile(durations, 0.50);
+        stats.p90Ns = percentile(durations, 0.90);
+        stats.p99Ns = percentile(durations, 0.99);
+        stats.maxNs = durations.back();
+        result[entry.first] = stats;
+    }
+    return result;
+}
+
+}}} // namespace lsst::qserv::util
@@ -0,0 +1,134 @@
+// -*- LSST-C++ -*-
+
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_UTIL_TRACE_H
+#define LSST_QSERV_UTIL_TRACE_H
+
+/// Trace.h declares:
+///
+///   struct TraceSpan
+///   class  Trace
+///   class  Span
+///
+/// Structured timing instrumentation for the query path. Unlike util::Timer,
+/// whose readings end up scattered through debug logs, completed spans are
+/// collected in a process-wide ring buffer from which per-phase latency
+/// percentiles can be computed at any time while the process runs.
+
+// System headers
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace lsst {
+namespace qserv {
+namespace util {
+
+/// A completed span: one timed execution of a named phase.
+struct TraceSpan {
+    char const* name;      ///< phase name; must point at a string literal
+    uint64_t id;           ///< correlation id (e.g. query id), 0 when not applicable
+    uint64_t beginNs;      ///< begin time, nanoseconds on the monotonic clock
+    uint64_t durationNs;   ///< span duration, nanoseconds
+};
+
+/**
+ * Class Trace is the process-wide span collector. Completed spans are
+ * buffered per-thread and flushed in batches into a fixed-capacity ring
+ * buffer, so recording a span costs a clock read and a couple of stores on
+ * the common path, with a mutex taken only once per batch. When the ring is
+ * full the oldest spans are overwritten. Spans still sitting in a
+ * thread-local buffer are invisible to snapshot() and summarize() until that
+ * buffer fills or its thread exits.
+ */
+class Trace {
+public:
+
+    /// Completed spans retained in the ring buffer.
+    static size_t const ringCapacity = 64*1024;
+
+    /// Per-phase duration statistics over the spans currently in the ring.
+    struct PhaseStats {
+        uint64_t count = 0;  ///< spans observed
+        uint64_t p50Ns = 0;  ///< median duration, nanoseconds
+        uint64_t p90Ns = 0;  ///< 90th percentile duration, nanoseconds
+        uint64_t p99Ns = 0;  ///< 99th percentile duration, nanoseconds
+        uint64_t maxNs = 0;  ///< maximum duration, nanoseconds
+    };
+
+    /// @return current time in nanoseconds on the monotonic clock
+    static uint64_t nowNs();
+
+    /// Append a completed span to the calling thread's buffer, flushing the
+    /// buffer to the ring if it is full. Normally called by ~Span().
+    static void record(TraceSpan const& span);
+
+    /// Flush the calling thread's buffer to the ring immediately.
+    static void flush();
+
+    /// @return a copy of the spans currently in the ring, oldest first
+    static std::vector<TraceSpan> snapshot();
+
+    /// @return nearest-rank percentiles per phase name over the current ring
+    static std::map<std::string, PhaseStats> summarize();
+
+private:
+    // All state is static; no instances.
+    Trace() = delete;
+};
+
+/**
+ * Class Span times the scope it is constructed in: the constructor reads the
+ * clock and the destructor records the completed TraceSpan with Trace. The
+ * name must be a string literal (it is stored by pointer, not copied).
+ *
+ *   {
+ *       util::Span span("czar.merge", queryId);
+ *       ... work to be timed ...
+ *   }
+ */
+class Span {
+public:
+
+    explicit Span(char const* name, uint64_t id=0)
+        : _name(name), _id(id), _beginNs(Trace::nowNs()) {
+    }
+
+    Span(Span const&) = delete;
+    Span& operator=(Span const&) = delete;
+
+    ~Span() {
+        Trace::record(TraceSpan{_name, _id, _beginNs, Trace::nowNs() - _beginNs});
+    }
+
+private:
+    char const* _name;
+    uint64_t _id;
+    uint64_t _beginNs;
+};
+
+}}} // namespace lsst::qserv::util
+
+#endif // LSST_QSERV_UTIL_TRACE_H
@@ -0,0 +1,75 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+ /**
+  * @brief test Disposer
+  */
+
+// System headers
+#include <atomic>
+#include <memory>
+
+// Qserv headers
+#include "util/Disposer.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE Disposer
+#include "boost/test/included/unit_test.hpp"
+
+namespace test = boost::test_tools;
+
+using namespace lsst::qserv::util;
+
+namespace {
+
+/// Sets a flag from its destructor so tests can observe teardown.
+struct Tracked {
+    explicit Tracked(std::atomic<bool>& destroyed_) : destroyed(destroyed_) {}
+    ~Tracked() { destroyed = true; }
+    std::atomic<bool>& destroyed;
+};
+
+}
+
+BOOST_AUTO_TEST_SUITE(Suite)
+
+BOOST_AUTO_TEST_CASE(DisposeRunsDestructor) {
+    std::atomic<bool> destroyed{false};
+    {
+        Disposer disposer;
+        auto obj = std::make_shared<Tracked>(destroyed);
+        disposer.dispose(obj);
+        // The caller's reference is taken immediately.
+        BOOST_CHECK(obj == nullptr);
+        // Disposer shutdown drains the queue.
+    }
+    BOOST_CHECK(destroyed.load());
+}
+
+BOOST_AUTO_TEST_CASE(DisposeNull) {
+    Disposer disposer;
+    std::shared_ptr<int> obj;
+    disposer.dispose(obj); // no-op, must not crash
+    BOOST_CHECK(obj == nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -261,6 +261,88 @@ BOOST_AUTO_TEST_CASE(EventThreadTest) {
 }
 
 
+BOOST_AUTO_TEST_CASE(CommandQueueLifoTest) {
+    // A command queued by a pool thread goes on that thread's private deque
+    // and runs next (lifo slack), ahead of older work on the shared fifo.
+    auto cmdQueue = std::make_shared<CommandQueue>();
+    auto pool = ThreadPool::newThreadPool(1, cmdQueue);
+
+    std::vector<std::string> order;
+    std::mutex orderMtx;
+    auto record = [&order, &orderMtx](std::string const& name) {
+        std::lock_guard<std::mutex> lock(orderMtx);
+        order.push_back(name);
+    };
+
+    auto cmdB = std::make_shared<CommandTracked>([&record](CmdData*){ record("B"); });
+    auto cmdA = std::make_shared<CommandTracked>(
+        [&record, cmdQueue, cmdB](CmdData*){
+            record("A");
+            cmdQueue->queCmd(cmdB); // queued from the pool thread
+        });
+    auto cmdC = std::make_shared<CommandTracked>([&record](CmdData*){ record("C"); });
+
+    cmdQueue->queCmd(cmdA);
+    cmdQueue->queCmd(cmdC);
+    cmdB->waitComplete();
+    cmdC->waitComplete();
+    pool->shutdownPool();
+
+    BOOST_REQUIRE(order.size() == 3U);
+    BOOST_CHECK(order[0] == "A");
+    BOOST_CHECK(order[1] == "B"); // lifo slack: B jumps ahead of C
+    BOOST_CHECK(order[2] == "C");
+}
+
+
+BOOST_AUTO_TEST_CASE(CommandQueueStealTest) {
+    // A command sitting on a busy thread's private deque must be stolen by
+    // an idle pool thread; the blocker below deadlocks if stealing fails.
+    auto cmdQueue = std::make_shared<CommandQueue>();
+    auto pool = ThreadPool::newThreadPool(2, cmdQueue);
+
+    auto inner = std::make_shared<CommandTracked>([](CmdData*){});
+    auto blocker = std::make_shared<CommandTracked>(
+        [cmdQueue, inner](CmdData*){
+            cmdQueue->queCmd(inner); // lands on this thread's private deque
+            inner->waitComplete();   // only a thief can run it
+        });
+    cmdQueue->queCmd(blocker);
+    blocker->waitComplete();
+    pool->shutdownPool();
+}
+
+
+BOOST_AUTO_TEST_CASE(BlockedCountTest) {
+    // A pool thread inside a BlockedRegion shows up in getBlockedCount();
+    // the marker is a no-op on threads outside any pool.
+    auto cmdQueue = std::make_shared<CommandQueue>();
+    auto pool = ThreadPool::newThreadPool(1, cmdQueue);
+    BOOST_CHECK(pool->getBlockedCount() == 0);
+
+    auto entered = std::make_shared<CommandTracked>([](CmdData*){});
+    auto release = std::make_shared<CommandTracked>([](CmdData*){});
+    auto blocker = std::make_shared<CommandTracked>(
+        [entered, release](CmdData*){
+            ThreadPool::BlockedRegion blocked;
+            entered->setComplete();
+            release->waitComplete();
+        });
+    cmdQueue->queCmd(blocker);
+    entered->waitComplete();
+    BOOST_CHECK(pool->getBlockedCount() == 1);
+    release->setComplete();
+    blocker->waitComplete();
+    BOOST_CHECK(pool->getBlockedCount() == 0);
+
+    ThreadPool::markBlocked(); // not a pool thread, must be ignored
+    BOOST_CHECK(pool->getBlockedCount() == 0);
+    ThreadPool::markUnblocked();
+
+    pool->shutdownPool();
+}
+
+
 BOOST_AUTO_TEST_CASE(InstanceCountTest) {
 
     struct CA {
@@ -0,0 +1,117 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// System headers
+#include <thread>
+#include <vector>
+
+// Qserv headers
+#include "util/Histogram.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE Histogram
+#include "boost/test/included/unit_test.hpp"
+
+namespace test = boost::test_tools;
+using lsst::qserv::util::Histogram;
+
+BOOST_AUTO_TEST_SUITE(Suite)
+
+BOOST_AUTO_TEST_CASE(HistogramBuckets) {
+    // Small values map linearly, one value per bucket.
+    for (uint64_t v = 0; v < 2*Histogram::SUB_BUCKETS; ++v) {
+        BOOST_CHECK_EQUAL(Histogram::bucketFor(v), v);
+        BOOST_CHECK_EQUAL(Histogram::bucketMin(v), v);
+    }
+    // Buckets partition the value range: every value lands in a bucket whose
+    // bounds contain it, and bucket minimums are monotonic.
+    uint64_t probes[] = {64, 65, 100, 1000, 12345, 1ULL << 20, (1ULL << 40) + 17,
+                         1ULL << 63, ~0ULL};
+    for (uint64_t v : probes) {
+        unsigned int b = Histogram::bucketFor(v);
+        BOOST_CHECK(b < Histogram::BUCKET_COUNT);
+        BOOST_CHECK(Histogram::bucketMin(b) <= v);
+        if (b + 1 < Histogram::BUCKET_COUNT) {
+            BOOST_CHECK(v < Histogram::bucketMin(b + 1));
+        }
+    }
+    for (unsigned int b = 1; b < Histogram::BUCKET_COUNT; ++b) {
+        BOOST_CHECK(Histogram::bucketMin(b - 1) < Histogram::bucketMin(b));
+    }
+}
+
+BOOST_AUTO_TEST_CASE(HistogramStats) {
+    Histogram h("test");
+    BOOST_CHECK_EQUAL(h.snapshot().count, 0U);
+    BOOST_CHECK_EQUAL(h.snapshot().percentile(50.0), 0U);
+
+    // 1..1000 recorded once each.
+    for (uint64_t v = 1; v <= 1000; ++v) {
+        h.record(v);
+    }
+    auto s = h.snapshot();
+    BOOST_CHECK_EQUAL(s.count, 1000U);
+    BOOST_CHECK_EQUAL(s.sum, 500500U);
+    BOOST_CHECK_EQUAL(s.min, 1U);
+    BOOST_CHECK_EQUAL(s.max, 1000U);
+    // Percentiles are bucket lower bounds; allow one sub-bucket of slack.
+    auto p50 = s.percentile(50.0);
+    BOOST_CHECK(p50 >= 480 && p50 <= 500);
+    auto p99 = s.percentile(99.0);
+    BOOST_CHECK(p99 >= 950 && p99 <= 990);
+    // countLessThan interpolates but is exact at bucket boundaries.
+    BOOST_CHECK_EQUAL(s.countLessThan(1), 0U);
+    BOOST_CHECK_EQUAL(s.countLessThan(33), 32U);
+    auto less500 = s.countLessThan(500);
+    BOOST_CHECK(less500 >= 485 && less500 <= 500);
+}
+
+BOOST_AUTO_TEST_CASE(HistogramThreads) {
+    // Several threads record concurrently; the merged snapshot must account
+    // for every value.
+    Histogram h("threads");
+    int const threadCount = 8;
+    uint64_t const perThread = 10000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; ++t) {
+        threads.emplace_back([&h, perThread]() {
+            for (uint64_t v = 0; v < perThread; ++v) {
+                h.record(v % 97);
+            }
+        });
+    }
+    for (auto& thrd : threads) {
+        thrd.join();
+    }
+    auto s = h.snapshot();
+    BOOST_CHECK_EQUAL(s.count, threadCount*perThread);
+    BOOST_CHECK_EQUAL(s.min, 0U);
+    BOOST_CHECK_EQUAL(s.max, 96U);
+    uint64_t bucketTotal = 0;
+    for (auto b : s.buckets) {
+        bucketTotal += b;
+    }
+    BOOST_CHECK_EQUAL(bucketTotal, s.count);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,56 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+ /**
+  * @brief test NumaNode
+  */
+
+// Qserv headers
+#include "util/NumaNode.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE NumaNode
+#include "boost/test/included/unit_test.hpp"
+
+namespace test = boost::test_tools;
+
+using namespace lsst::qserv::util;
+
+BOOST_AUTO_TEST_SUITE(Suite)
+
+BOOST_AUTO_TEST_CASE(Topology) {
+    // Whatever the host looks like, there is always at least one node and
+    // currentNode() must answer with a valid node or -1.
+    int nodes = NumaNode::nodeCount();
+    BOOST_CHECK(nodes >= 1);
+    int node = NumaNode::currentNode();
+    BOOST_CHECK(node >= -1);
+    BOOST_CHECK(node < nodes);
+}
+
+BOOST_AUTO_TEST_CASE(PinInvalid) {
+    // Pinning to a node that doesn't exist must fail without side effects.
+    BOOST_CHECK(!NumaNode::pinCurrentThread(-1));
+    BOOST_CHECK(!NumaNode::pinCurrentThread(NumaNode::nodeCount() + 100));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
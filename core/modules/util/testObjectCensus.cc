@@ -0,0 +1,84 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// System headers
+#include <memory>
+#include <vector>
+
+// Qserv headers
+#include "util/ObjectCensus.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE ObjectCensus
+#include "boost/test/included/unit_test.hpp"
+
+namespace test = boost::test_tools;
+using namespace lsst::qserv::util;
+
+namespace {
+
+class Counted : public CensusMember<Counted> {
+public:
+    using CensusMember<Counted>::liveCount;
+};
+
+class OtherCounted : public CensusMember<OtherCounted> {
+public:
+    using CensusMember<OtherCounted>::liveCount;
+};
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(Suite)
+
+BOOST_AUTO_TEST_CASE(ObjectCensusCounts) {
+    BOOST_CHECK_EQUAL(Counted::liveCount(), 0);
+
+    // Construction, copying and destruction keep the live count current.
+    {
+        Counted a;
+        BOOST_CHECK_EQUAL(Counted::liveCount(), 1);
+        Counted b(a);
+        std::vector<std::shared_ptr<Counted>> more;
+        for (int i = 0; i < 10; ++i) {
+            more.push_back(std::make_shared<Counted>());
+        }
+        BOOST_CHECK_EQUAL(Counted::liveCount(), 12);
+        more.clear();
+        BOOST_CHECK_EQUAL(Counted::liveCount(), 2);
+    }
+    BOOST_CHECK_EQUAL(Counted::liveCount(), 0);
+
+    // Each type has its own counter.
+    Counted a;
+    OtherCounted other;
+    BOOST_CHECK_EQUAL(Counted::liveCount(), 1);
+    BOOST_CHECK_EQUAL(OtherCounted::liveCount(), 1);
+
+    // The snapshot reports the live counts under demangled type names.
+    auto counts = ObjectCensus::get().snapshot();
+    BOOST_CHECK_EQUAL(counts[demangledName(typeid(Counted))], 1);
+    BOOST_CHECK_EQUAL(counts[demangledName(typeid(OtherCounted))], 1);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
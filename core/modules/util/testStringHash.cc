@@ -0,0 +1,82 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// System headers
+#include <string>
+
+// Qserv headers
+#include "util/StringHash.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE StringHash
+#include "boost/test/included/unit_test.hpp"
+
+namespace test = boost::test_tools;
+using lsst::qserv::util::StringHash;
+
+BOOST_AUTO_TEST_SUITE(Suite)
+
+BOOST_AUTO_TEST_CASE(XxHash64Vectors) {
+    // Published reference values of the xxHash64 specification; they pin
+    // our from-spec implementation to the upstream algorithm.
+    BOOST_CHECK_EQUAL(StringHash::getXxHash64("", 0), 0xef46db3751d8e999ULL);
+    std::string const abc = "abc";
+    BOOST_CHECK_EQUAL(StringHash::getXxHash64(abc.data(), abc.size()),
+                      0x44bc2cf5ad770999ULL);
+}
+
+BOOST_AUTO_TEST_CASE(XxHash64Behavior) {
+    // A >32 byte input exercises the striped main loop plus every tail size.
+    std::string const base = "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJ";
+    for (size_t len = 0; len <= base.size(); ++len) {
+        // Stable for a given input...
+        BOOST_CHECK_EQUAL(StringHash::getXxHash64(base.data(), len),
+                          StringHash::getXxHash64(base.data(), len));
+        // ...and the seed changes the result.
+        BOOST_CHECK(StringHash::getXxHash64(base.data(), len)
+                    != StringHash::getXxHash64(base.data(), len, 1));
+        if (len > 0) {
+            BOOST_CHECK(StringHash::getXxHash64(base.data(), len)
+                        != StringHash::getXxHash64(base.data(), len - 1));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(XxHash64Hex) {
+    std::string const hex = StringHash::getXxHash64Hex("", 0);
+    BOOST_CHECK_EQUAL(hex.size(), 16u);
+    BOOST_CHECK_EQUAL(hex, "ef46db3751d8e999");
+}
+
+BOOST_AUTO_TEST_CASE(XxHash128) {
+    std::string const in = "some fragment share key material";
+    std::string const h = StringHash::getXxHash128(in.data(), in.size());
+    BOOST_CHECK_EQUAL(h.size(), 16u);
+    BOOST_CHECK_EQUAL(h, StringHash::getXxHash128(in.data(), in.size()));
+    // The two halves come from independently seeded runs.
+    BOOST_CHECK(h.substr(0, 8) != h.substr(8, 8));
+    std::string const other = StringHash::getXxHash128(in.data(), in.size() - 1);
+    BOOST_CHECK(h != other);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,110 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/**
+ * @brief test TimerWheel
+ */
+
+// System headers
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+// Qserv headers
+#include "util/TimerWheel.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE TimerWheel
+#include "boost/test/included/unit_test.hpp"
+
+namespace test = boost::test_tools;
+
+using namespace lsst::qserv::util;
+using namespace std::chrono;
+
+BOOST_AUTO_TEST_SUITE(Suite)
+
+BOOST_AUTO_TEST_CASE(TimerWheelFire) {
+    auto wheel = TimerWheel::newTimerWheel(milliseconds(10), 16, 2);
+
+    // A timeout fires, and no earlier than its delay.
+    std::atomic<int> fired{0};
+    auto start = steady_clock::now();
+    std::atomic<long> firedAfterMs{-1};
+    wheel->schedule(milliseconds(50), [&]() {
+        firedAfterMs = duration_cast<milliseconds>(steady_clock::now() - start).count();
+        ++fired;
+    });
+
+    // A delay longer than a full turn of the wheel (16 slots * 10ms) must
+    // wait out its extra rounds rather than fire on the first pass.
+    wheel->schedule(milliseconds(250), [&]() { ++fired; });
+
+    std::this_thread::sleep_for(milliseconds(150));
+    BOOST_CHECK_EQUAL(fired.load(), 1);
+    BOOST_CHECK(firedAfterMs.load() >= 50);
+
+    std::this_thread::sleep_for(milliseconds(200));
+    BOOST_CHECK_EQUAL(fired.load(), 2);
+    wheel->shutdown();
+}
+
+BOOST_AUTO_TEST_CASE(TimerWheelCancel) {
+    auto wheel = TimerWheel::newTimerWheel(milliseconds(10), 16, 2);
+
+    std::atomic<int> fired{0};
+    auto timeout = wheel->schedule(milliseconds(50), [&]() { ++fired; });
+    BOOST_CHECK(timeout->cancel());
+    BOOST_CHECK(!timeout->cancel()); // Second cancel reports too late.
+
+    std::this_thread::sleep_for(milliseconds(120));
+    BOOST_CHECK_EQUAL(fired.load(), 0);
+
+    // Cancelling after the callback ran reports too late as well.
+    auto timeout2 = wheel->schedule(milliseconds(20), [&]() { ++fired; });
+    std::this_thread::sleep_for(milliseconds(100));
+    BOOST_CHECK_EQUAL(fired.load(), 1);
+    BOOST_CHECK(!timeout2->cancel());
+    wheel->shutdown();
+}
+
+BOOST_AUTO_TEST_CASE(TimerWheelMany) {
+    auto wheel = TimerWheel::newTimerWheel(milliseconds(10), 16, 2);
+
+    // Schedule a pile of timeouts and cancel every other one, the common
+    // usage pattern for retry/expiration timers.
+    int const count = 1000;
+    std::atomic<int> fired{0};
+    std::vector<TimerWheel::Timeout::Ptr> timeouts;
+    for (int j = 0; j < count; ++j) {
+        timeouts.push_back(wheel->schedule(milliseconds(30 + j % 50), [&]() { ++fired; }));
+    }
+    for (int j = 0; j < count; j += 2) {
+        BOOST_CHECK(timeouts[j]->cancel());
+    }
+    std::this_thread::sleep_for(milliseconds(300));
+    BOOST_CHECK_EQUAL(fired.load(), count / 2);
+    wheel->shutdown();
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,106 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+ /**
+  * @brief test Trace
+  */
+
+// System headers
+#include <thread>
+#include <vector>
+
+// Qserv headers
+#include "util/Trace.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE Trace
+#include "boost/test/included/unit_test.hpp"
+
+namespace test = boost::test_tools;
+
+using namespace lsst::qserv::util;
+
+BOOST_AUTO_TEST_SUITE(Suite)
+
+BOOST_AUTO_TEST_CASE(SpanTest) {
+
+    // Record spans with known durations and check that they show up in the
+    // ring with sane fields once flushed.
+    for (int i = 0; i < 10; ++i) {
+        Span span("test.phase", 42);
+    }
+    Trace::flush();
+
+    int found = 0;
+    for (auto const& span : Trace::snapshot()) {
+        if (std::string(span.name) == "test.phase") {
+            BOOST_CHECK_EQUAL(span.id, 42U);
+            ++found;
+        }
+    }
+    BOOST_CHECK_EQUAL(found, 10);
+}
+
+BOOST_AUTO_TEST_CASE(SummarizeTest) {
+
+    // Synthesize a phase with a known duration distribution, bypassing the
+    // clock so percentiles are deterministic.
+    for (uint64_t d = 1; d <= 100; ++d) {
+        Trace::record(TraceSpan{"test.summary", 0, 0, d * 1000});
+    }
+    Trace::flush();
+
+    auto stats = Trace::summarize();
+    BOOST_REQUIRE(stats.count("test.summary") == 1);
+    auto const& s = stats["test.summary"];
+    BOOST_CHECK_EQUAL(s.count, 100U);
+    BOOST_CHECK_EQUAL(s.p50Ns, 51000U);
+    BOOST_CHECK_EQUAL(s.p90Ns, 91000U);
+    BOOST_CHECK_EQUAL(s.p99Ns, 100000U);
+    BOOST_CHECK_EQUAL(s.maxNs, 100000U);
+}
+
+BOOST_AUTO_TEST_CASE(MultiThreadTest) {
+
+    // Spans recorded by several threads must all reach the ring; each
+    // thread's buffer is flushed when the thread exits.
+    int const numThreads = 4;
+    int const spansPerThread = 1000;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        threads.emplace_back([]() {
+            for (int i = 0; i < spansPerThread; ++i) {
+                Span span("test.threads");
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    auto stats = Trace::summarize();
+    BOOST_REQUIRE(stats.count("test.threads") == 1);
+    BOOST_CHECK_EQUAL(stats["test.threads"].count,
+                      static_cast<uint64_t>(numThreads * spansPerThread));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -38,8 +38,9 @@
 #include "lsst/log/Log.h"
 
 // Qserv headers
-#include "proto/TaskMsgDigest.h"
 #include "proto/worker.pb.h"
+#include "util/NumaNode.h"
+#include "util/Trace.h"
 #include "wbase/Base.h"
 #include "wbase/SendChannel.h"
 
@@ -104,28 +105,16 @@ IdSet Task::allIds{};
 /// the util::CommandThreadPool is not called here.
 Task::Task(Task::TaskMsgPtr const& t, SendChannel::Ptr const& sc)
     : msg(t), sendChannel(sc),
+      queryInfo(TaskQueryInfo::obtain(*t)),
+      user(queryInfo->user),
       _qId(t->queryid()), _jId(t->jobid()), _attemptCount(t->attemptcount()),
       _idStr(QueryIdHelper::makeIdStr(_qId, _jId)) {
-    hash = hashTaskMsg(*t);
-
-    if (t->has_user()) {
-        user = t->user();
-    } else {
-        user = defaultUser;
-    }
+    // The user name, the scan tables and the other per-query fields are parsed
+    // once per query and shared via 'queryInfo', not copied into each Task.
     timestr[0] = '\0';
 
     allIds.add(std::to_string(_qId) + "_" + std::to_string(_jId));
     LOGS(_log, LOG_LVL_DEBUG, "Task(...) " << _idStr << " this=" << this << " : " << allIds);
-
-    // Determine which major tables this task will use.
-    int const size = msg->scantable_size();
-    for(int j=0; j < size; ++j) {
-        _scanInfo.infoTables.push_back(proto::ScanTableInfo(msg->scantable(j)));
-    }
-    _scanInfo.scanRating = msg->scanpriority();
-    _scanInfo.sortTablesSlowestFirst();
-    _scanInteractive = msg->scaninteractive();
 }
 
 Task::~Task() {
@@ -195,6 +184,15 @@ void Task::started(std::chrono::system_clock::time_point const& now) {
     std::lock_guard<std::mutex> guard(_stateMtx);
     _state = State::RUNNING;
     _startTime = now;
+    // Report the time this Task spent on the scheduler queue as a trace span.
+    auto const waitNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+        now - _queueTime).count();
+    if (waitNs > 0) {
+        uint64_t const endNs = util::Trace::nowNs();
+        util::Trace::record(util::TraceSpan{"worker.queuewait", _qId,
+                                            endNs - static_cast<uint64_t>(waitNs),
+                                            static_cast<uint64_t>(waitNs)});
+    }
 }
 
 
@@ -233,6 +231,41 @@ std::chrono::milliseconds Task::getRunTime() const {
 }
 
 
+/// @return the amount of time the task spent waiting on a scheduler queue
+/// in milliseconds, or the time spent so far if it is still queued.
+std::chrono::milliseconds Task::getQueuedTime() const {
+    std::chrono::milliseconds duration{0};
+    {
+        std::lock_guard<std::mutex> guard(_stateMtx);
+        if (_state == State::QUEUED) {
+            auto now = std::chrono::system_clock::now();
+            duration = std::chrono::duration_cast<std::chrono::milliseconds>(now - _queueTime);
+        } else if (_state == State::RUNNING || _state == State::FINISHED) {
+            duration = std::chrono::duration_cast<std::chrono::milliseconds>(_startTime - _queueTime);
+        }
+    }
+    return duration;
+}
+
+
+/// @return the time the Task was queued on a scheduler, as milliseconds
+/// since the UNIX epoch; 0 if the Task has not been queued yet.
+uint64_t Task::getQueueTimeMs() const {
+    std::lock_guard<std::mutex> guard(_stateMtx);
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+            _queueTime.time_since_epoch()).count();
+}
+
+
+/// @return the time the Task started running, as milliseconds since the
+/// UNIX epoch; 0 if the Task has not started yet.
+uint64_t Task::getStartTimeMs() const {
+    std::lock_guard<std::mutex> guard(_stateMtx);
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+            _startTime.time_since_epoch()).count();
+}
+
+
 /// Wait for MemMan to finish reserving resources. The mlock call can take several seconds
 /// and only one mlock call can be running at a time. Further, queries finish slightly faster
 /// if they are mlock'ed in the same order they were scheduled, hence the ulockEvents
@@ -243,11 +276,19 @@ void Task::waitForMemMan() {
         using Ptr = std::shared_ptr<CommandMlock>;
         CommandMlock(memman::MemMan::Ptr memMan, memman::MemMan::Handle handle) : _memMan{memMan}, _handle{handle} {}
         void action(util::CmdData*) override {
-            if (_memMan->lock(_handle, true)) {
+            // Lock enough of the chunk for the scan to start, release the
+            // waiting Task, then fault in the rest while the scan runs.
+            if (_memMan->lockInitial(_handle, true)) {
                 errorCode = (errno == EAGAIN ? ENOMEM : errno);
             }
+            // The pages were faulted in by the locking thread, so sample the
+            // node here, not on the thread waiting for the lock.
+            memNode = util::NumaNode::currentNode();
+            setComplete();
+            _memMan->lockRemaining(_handle);
         }
         int errorCode{0}; ///< Error code if mlock fails.
+        int memNode{-1}; ///< NUMA node where the lock call ran.
     private:
         memman::MemMan::Ptr _memMan;
         memman::MemMan::Handle _handle;
@@ -262,7 +303,7 @@ void Task::waitForMemMan() {
         if (cmd->errorCode) {
             LOGS(_log, LOG_LVL_WARN, _idStr << " mlock err=" << cmd->errorCode);
         }
-
+        _memNode = cmd->memNode;
     }
     LOGS(_log, LOG_LVL_DEBUG, _idStr << " waitForMemMan end");
     _safeToMoveRunning = true;
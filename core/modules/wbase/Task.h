@@ -28,6 +28,7 @@
 // System headers
 #include <atomic>
 #include <chrono>
+#include <cstdint>
 #include <deque>
 #include <memory>
 #include <mutex>
@@ -39,9 +40,10 @@
 #include "global/intTypes.h"
 #include "memman/MemMan.h"
 #include "proto/ScanTableInfo.h"
-#include "util/InstanceCount.h"
+#include "util/ObjectCensus.h"
 #include "util/ThreadPool.h"
 #include "util/threadSafe.h"
+#include "wbase/TaskQueryInfo.h"
 
 // Forward declarations
 namespace lsst {
@@ -105,7 +107,7 @@ private:
 /// (over-the-wire) additional concrete info related to physical
 /// execution conditions.
 /// Task is non-copyable
-class Task : public util::CommandThreadPool {
+class Task : public util::CommandThreadPool, public util::CensusMember<Task> {
 public:
     static std::string const defaultUser;
     using Ptr =  std::shared_ptr<Task>;
@@ -127,8 +129,8 @@ public:
 
     TaskMsgPtr msg; ///< Protobufs Task spec
     std::shared_ptr<SendChannel> sendChannel; ///< For result reporting
-    std::string hash; ///< hash of TaskMsg
-    std::string user; ///< Incoming username
+    TaskQueryInfo::Ptr const queryInfo; ///< Immutable state shared by all Tasks of the query
+    std::string const& user; ///< Incoming username (owned by queryInfo)
     time_t entryTime {0}; ///< Timestamp for task admission
     char timestr[100]; ///< ::ctime_r(&t.entryTime, timestr)
     // Note that manpage spec of "26 bytes"  is insufficient
@@ -147,8 +149,8 @@ public:
     QueryId getQueryId() const { return _qId; }
     int getJobId() const { return _jId; }
     int getAttemptCount() const { return _attemptCount; }
-    bool getScanInteractive() {return _scanInteractive; }
-    proto::ScanInfo& getScanInfo() { return _scanInfo; }
+    bool getScanInteractive() const { return queryInfo->scanInteractive; }
+    proto::ScanInfo const& getScanInfo() const { return queryInfo->scanInfo; }
     void setOnInteractive(bool val) { _onInteractive = val; }
     bool getOnInteractive() { return _onInteractive; }
     bool hasMemHandle() const { return _memHandle != memman::MemMan::HandleType::INVALID; }
@@ -156,6 +158,13 @@ public:
     void setMemHandle(memman::MemMan::Handle handle) { _memHandle = handle; }
     void setMemMan(memman::MemMan::Ptr const& memMan) { _memMan = memMan; }
     void waitForMemMan();
+    /// @return the NUMA node where MemMan locked this Task's tables, -1 if unknown.
+    int getMemNode() const { return _memNode; }
+
+    /// Set the absolute time by which this Task should have started running.
+    /// Set by the scheduler when the Task is queued, from its maximum scan time.
+    void setDeadline(time_t deadline) { _deadline = deadline; }
+    time_t getDeadline() const { return _deadline; } ///< @return the deadline, 0 if none was set.
     bool getSafeToMoveRunning() { return _safeToMoveRunning; }
     void setSafeToMoveRunning(bool val) { _safeToMoveRunning = val; } ///< For testing only.
 
@@ -168,6 +177,13 @@ public:
     // Functions for tracking task state and statistics.
     State getState() const;
     std::chrono::milliseconds getRunTime() const;
+    std::chrono::milliseconds getQueuedTime() const;
+    /// @return the time the Task was queued on a scheduler, as milliseconds
+    /// since the UNIX epoch; 0 if the Task has not been queued yet.
+    uint64_t getQueueTimeMs() const;
+    /// @return the time the Task started running, as milliseconds since the
+    /// UNIX epoch; 0 if the Task has not started yet.
+    uint64_t getStartTimeMs() const;
     void queued(std::chrono::system_clock::time_point const& now);
     void started(std::chrono::system_clock::time_point const& now);
     std::chrono::milliseconds finished(std::chrono::system_clock::time_point const& now);
@@ -182,19 +198,17 @@ private:
     std::atomic<bool> _safeToMoveRunning{false}; ///< false until done with waitForMemMan().
     TaskQueryRunner::Ptr _taskQueryRunner;
     std::weak_ptr<TaskScheduler> _taskScheduler;
-    proto::ScanInfo _scanInfo;
-    bool _scanInteractive; ///< True if the czar thinks this query should be interactive.
     bool _onInteractive{false}; ///< True if the scheduler put this task on the interactive (group) scheduler.
     std::atomic<memman::MemMan::Handle> _memHandle{memman::MemMan::HandleType::INVALID};
     memman::MemMan::Ptr _memMan;
+    std::atomic<int> _memNode{-1}; ///< NUMA node where the tables were locked, -1 if unknown.
+    std::atomic<time_t> _deadline{0}; ///< Time by which this Task should have started, 0 if none.
 
     mutable std::mutex _stateMtx; ///< Mutex to protect state related members _state, _???Time.
     State _state{State::CREATED};
     std::chrono::system_clock::time_point _queueTime;
     std::chrono::system_clock::time_point _startTime;
     std::chrono::system_clock::time_point _finishTime;
-
-    util::InstanceCount _ic{"Task"}; ///< Count of existing Task objects.
 };
 
 }}} // namespace lsst::qserv::wbase
@@ -0,0 +1,93 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "wbase/TaskQueryInfo.h"
+
+// Qserv headers
+#include "proto/worker.pb.h"
+#include "wbase/Task.h"
+
+namespace {
+
+/// Build the shared scan descriptor from the message, sorted the way
+/// the schedulers expect it.
+lsst::qserv::proto::ScanInfo makeScanInfo(lsst::qserv::proto::TaskMsg const& msg) {
+    lsst::qserv::proto::ScanInfo scanInfo;
+    int const size = msg.scantable_size();
+    for(int j=0; j < size; ++j) {
+        scanInfo.infoTables.push_back(lsst::qserv::proto::ScanTableInfo(msg.scantable(j)));
+    }
+    scanInfo.scanRating = msg.scanpriority();
+    scanInfo.sortTablesSlowestFirst();
+    return scanInfo;
+}
+
+} // annonymous namespace
+
+namespace lsst {
+namespace qserv {
+namespace wbase {
+
+std::mutex TaskQueryInfo::_registryMtx;
+std::map<QueryId, std::weak_ptr<TaskQueryInfo const>> TaskQueryInfo::_registry;
+
+
+TaskQueryInfo::TaskQueryInfo(proto::TaskMsg const& msg)
+    :   queryId(msg.queryid()),
+        user(msg.has_user() ? msg.user() : Task::defaultUser),
+        db(msg.has_db() ? msg.db() : std::string()),
+        scanInfo(::makeScanInfo(msg)),
+        scanInteractive(msg.scaninteractive()) {
+}
+
+
+TaskQueryInfo::Ptr TaskQueryInfo::obtain(proto::TaskMsg const& msg) {
+
+    QueryId const queryId = msg.queryid();
+
+    std::lock_guard<std::mutex> lock(_registryMtx);
+
+    auto& entry = _registry[queryId];
+    Ptr info = entry.lock();
+    if (info != nullptr) return info;
+
+    // The deleter drops the registry entry when the last Task of the query
+    // goes away, unless the entry was replaced by a fresh descriptor (e.g.
+    // for a retry of the query) in the meantime.
+    info = Ptr(new TaskQueryInfo(msg),
+               [](TaskQueryInfo const* ptr) {
+                   {
+                       std::lock_guard<std::mutex> lock(_registryMtx);
+                       auto itr = _registry.find(ptr->queryId);
+                       if (itr != _registry.end() and itr->second.expired()) {
+                           _registry.erase(itr);
+                       }
+                   }
+                   delete ptr;
+               });
+    entry = info;
+    return info;
+}
+
+}}} // namespace lsst::qserv::wbase
@@ -0,0 +1,84 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_WBASE_TASKQUERYINFO_H
+#define LSST_QSERV_WBASE_TASKQUERYINFO_H
+
+// System headers
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// Qserv headers
+#include "global/intTypes.h"
+#include "proto/ScanTableInfo.h"
+
+// Forward declarations
+namespace lsst {
+namespace qserv {
+namespace proto {
+    class TaskMsg;
+}}} // End of forward declarations
+
+namespace lsst {
+namespace qserv {
+namespace wbase {
+
+/// TaskQueryInfo is an immutable bundle of the fields of a TaskMsg which are
+/// identical for every Task of the same user query: the user name, the default
+/// database and the shared scan parameters. All Tasks of a query share a single
+/// instance obtained from a process-wide registry, so these fields are parsed
+/// out of the protobuf message and stored only once per query rather than once
+/// per Task. With thousands of Tasks of a shared scan resident on the scheduler
+/// queues this cuts both the per-Task construction cost and the queue memory
+/// footprint.
+class TaskQueryInfo {
+public:
+    using Ptr = std::shared_ptr<TaskQueryInfo const>;
+
+    /// Obtain the descriptor shared by all Tasks of the message's query.
+    /// The descriptor is built from the message on the first call for a query
+    /// and dropped from the registry when the last Task referencing it is
+    /// destroyed.
+    static Ptr obtain(proto::TaskMsg const& msg);
+
+    // The instances are shared and immutable, hence non-copyable
+    TaskQueryInfo(TaskQueryInfo const&) = delete;
+    TaskQueryInfo& operator=(TaskQueryInfo const&) = delete;
+
+    QueryId const queryId;          ///< queryId from the czar
+    std::string const user;         ///< incoming user name, Task::defaultUser if none was supplied
+    std::string const db;           ///< default database targeted by the query
+    proto::ScanInfo const scanInfo; ///< shared scan tables, sorted slowest first
+    bool const scanInteractive;     ///< true if the czar thinks the query should be interactive
+
+private:
+    explicit TaskQueryInfo(proto::TaskMsg const& msg);
+
+    static std::mutex _registryMtx; ///< Guards _registry
+    static std::map<QueryId, std::weak_ptr<TaskQueryInfo const>> _registry;
+};
+
+}}} // namespace lsst::qserv::wbase
+
+#endif // LSST_QSERV_WBASE_TASKQUERYINFO_H
@@ -49,9 +49,11 @@ WorkerConfig::WorkerConfig(const util::ConfigStore& configStore)
     : _mySqlConfig(configStore.getRequired("mysql.username"),
             configStore.get("mysql.password"),
             configStore.getRequired("mysql.socket")),
+      _inventorySnapshotPath(configStore.get("inventory.snapshot_path", "")),
       _memManClass(configStore.get("memman.class", "MemManReal")),
       _memManSizeMb(configStore.getInt("memman.memory", 1000)),
       _memManLocation(configStore.getRequired("memman.location")),
+      _memManHugePages(configStore.getInt("memman.hugepages", 1) != 0),
       _threadPoolSize(configStore.getInt("scheduler.thread_pool_size", wsched::BlendScheduler::getMinPoolSize())),
       _maxGroupSize(configStore.getInt("scheduler.group_size", 1)),
       _requiredTasksCompleted(configStore.getInt("scheduler.required_tasks_completed", 25)),
@@ -71,7 +73,9 @@ WorkerConfig::WorkerConfig(const util::ConfigStore& configStore)
       _scanMaxMinutesMed(configStore.getInt("scheduler.scanmaxminutes_med", 60*8)),
       _scanMaxMinutesSlow(configStore.getInt("scheduler.scanmaxminutes_slow", 60*12)),
       _scanMaxMinutesSnail(configStore.getInt("scheduler.scanmaxminutes_snail", 60*24)),
-      _maxTasksBootedPerUserQuery(configStore.getInt("scheduler.maxtasksbootedperuserquery", 5)) {
+      _maxTasksBootedPerUserQuery(configStore.getInt("scheduler.maxtasksbootedperuserquery", 5)),
+      _scanFlashQueue(configStore.getInt("scheduler.flash_queue", 0) != 0),
+      _metricsPort(configStore.getInt("metrics.port", 0)) {
 }
 
 std::ostream& operator<<(std::ostream &out, WorkerConfig const& workerConfig) {
@@ -79,6 +83,7 @@ std::ostream& operator<<(std::ostream &out, WorkerConfig const& workerConfig) {
     if (workerConfig._memManClass == "MemManReal") {
         out << "MemManSizeMb=" << workerConfig._memManSizeMb;
     }
+    out << " flashQueue=" << workerConfig._scanFlashQueue;
     out << " poolSize=" << workerConfig._threadPoolSize << ", maxGroupSize=" << workerConfig._maxGroupSize;
     out << " requiredTasksCompleted=" << workerConfig._requiredTasksCompleted;
 
@@ -129,6 +129,18 @@ public:
         return _maxGroupSize;
     }
 
+    /* Check whether the shared scans should use the flash-storage task queue
+     *
+     * On SSD/NVMe workers the ascending chunk id order used to minimize seeks
+     * sacrifices parallelism for nothing; the flash queue dispatches chunks
+     * for memory sharing and queue depth instead. Off by default.
+     *
+     * @return true if the scan schedulers should use FlashTasksQueue
+     */
+    bool getScanFlashQueue() const {
+        return _scanFlashQueue;
+    }
+
     /* Get max thread reserve for fast shared scan
      *
      * @return max thread reserve for fast shared scan
@@ -185,6 +197,14 @@ public:
         return _memManSizeMb;
     }
 
+    /* Check whether the Memory Manager should map chunks with transparent huge pages
+     *
+     * @return true if mapped chunks should be advised to use huge pages
+     */
+    bool getMemManHugePages() const {
+        return _memManHugePages;
+    }
+
     /* Get MySQL configuration for worker MySQL instance
      *
      * @return a structure containing MySQL parameters
@@ -193,6 +213,24 @@ public:
         return _mySqlConfig;
     }
 
+    /* Get the TCP port of the embedded /metrics HTTP endpoint
+     *
+     * Zero (the default) disables the endpoint.
+     *
+     * @return the port to serve /metrics on, or 0 when disabled
+     */
+    unsigned int getMetricsPort() const {
+        return _metricsPort;
+    }
+
+    /* Get the path to the chunk inventory snapshot file
+     *
+     * @return the path to the snapshot file (empty if snapshots are disabled)
+     */
+    std::string const& getInventorySnapshotPath() const {
+        return _inventorySnapshotPath;
+    }
+
     /* Get fast shared scan priority
      *
      * @return fast shared scan priority
@@ -272,9 +310,12 @@ private:
 
     mysql::MySqlConfig const _mySqlConfig;
 
+    std::string const _inventorySnapshotPath;
+
     std::string const _memManClass;
     uint64_t const _memManSizeMb;
     std::string const _memManLocation;
+    bool const _memManHugePages;
 
     unsigned int const _threadPoolSize;
     unsigned int const _maxGroupSize;
@@ -300,6 +341,8 @@ private:
     unsigned int const _scanMaxMinutesSlow;
     unsigned int const _scanMaxMinutesSnail;
     unsigned int const _maxTasksBootedPerUserQuery;
+    bool const _scanFlashQueue;
+    unsigned int const _metricsPort;
 };
 
 }}} // namespace qserv::core::wconfig
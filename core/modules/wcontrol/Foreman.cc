@@ -25,7 +25,9 @@
 #include "wcontrol/Foreman.h"
 
 // System headers
+#include <algorithm>
 #include <cassert>
+#include <chrono>
 #include <deque>
 #include <iostream>
 #include <memory>
@@ -39,6 +41,7 @@
 // Qserv headers
 #include "mysql/MySqlConfig.h"
 #include "proto/worker.pb.h"
+#include "util/NumaNode.h"
 #include "wbase/Base.h"
 #include "wbase/SendChannel.h"
 #include "wbase/WorkerCommand.h"
@@ -72,18 +75,93 @@ Foreman::Foreman(Scheduler::Ptr                  const& scheduler,
 
     assert(_scheduler); // Cannot operate without scheduler.
 
-    LOGS(_log, LOG_LVL_DEBUG, "poolSize=" << poolSize);
-    _pool = util::ThreadPool::newThreadPool(poolSize, _scheduler);
+    // Let the schedulers pre-build subchunk tables for upcoming chunks so the
+    // CREATE+INSERT work overlaps the current chunk's scan.
+    _scheduler->setPrefetchFunc([this](std::vector<std::shared_ptr<wbase::Task>> const& tasks) {
+        _chunkResourceMgr->prefetchTasks(tasks);
+    });
+
+    // Split the task pool by NUMA node, pinning each pool's threads to its
+    // node's cpus. All pools pull from the same scheduler; BlendScheduler
+    // prefers handing a chunk's Tasks to threads on the node where MemMan
+    // locked the chunk's tables. A single-node host gets one unpinned pool.
+    int const numaNodes = util::NumaNode::nodeCount();
+    LOGS(_log, LOG_LVL_DEBUG, "poolSize=" << poolSize << " numaNodes=" << numaNodes);
+    if (numaNodes <= 1) {
+        _pools.push_back(util::ThreadPool::newThreadPool(poolSize, _scheduler));
+        _poolBaseSizes.push_back(poolSize);
+    } else {
+        for (int node = 0; node < numaNodes; ++node) {
+            uint share = poolSize/numaNodes + (node < static_cast<int>(poolSize%numaNodes) ? 1 : 0);
+            if (share == 0) continue;
+            auto pin = [node]() { util::NumaNode::pinCurrentThread(node); };
+            _pools.push_back(util::ThreadPool::newThreadPool(share, _scheduler, nullptr, pin));
+            _poolBaseSizes.push_back(share);
+        }
+    }
+    _basePoolSize = poolSize;
 
     _workerCommandQueue = std::make_shared<util::CommandQueue>();
     _workerCommandPool  = util::ThreadPool::newThreadPool(poolSize, _workerCommandQueue);
+
+    _poolSizer = std::thread([this]() { _poolSizerLoop(); });
 }
 
 Foreman::~Foreman() {
     LOGS(_log, LOG_LVL_DEBUG, "Foreman::~Foreman()");
     // It will take significant effort to have xrootd shutdown cleanly and this will never get called
     // until that happens.
-    _pool->shutdownPool();
+    {
+        std::lock_guard<std::mutex> lock(_poolSizerMtx);
+        _poolSizerStop = true;
+    }
+    _poolSizerCv.notify_all();
+    if (_poolSizer.joinable()) {
+        _poolSizer.join();
+    }
+    for (auto const& pool : _pools) {
+        pool->shutdownPool();
+    }
+}
+
+
+/// Grow the pools while their threads sit in blocked sections (I/O heavy cold
+/// scans) and shrink them back as the threads become runnable again (CPU bound
+/// warm scans). One extra thread is added per blocked thread, bounded at twice
+/// the configured size, and the scheduler's inFlight budget moves in lockstep
+/// so runnable Tasks never exceed the configured mysqld concurrency; the extra
+/// threads only fill in for blocked ones. Growth is applied at once, shrinking
+/// steps down one thread per pool per tick to ride out brief unblocks.
+void Foreman::_poolSizerLoop() {
+    uint target = _basePoolSize;
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(_poolSizerMtx);
+            _poolSizerCv.wait_for(lock, std::chrono::seconds(1), [this]() { return _poolSizerStop; });
+            if (_poolSizerStop) return;
+        }
+        uint blocked = 0;
+        for (auto const& pool : _pools) {
+            blocked += std::max(0, pool->getBlockedCount());
+        }
+        uint desired = std::min(_basePoolSize + blocked, 2*_basePoolSize);
+        if (desired > target) {
+            target = desired;
+        } else if (desired < target) {
+            target = std::max(desired, target - static_cast<uint>(_pools.size()));
+        } else {
+            continue;
+        }
+        // Spread the extra threads over the pools in proportion to their
+        // configured shares.
+        uint extra = target - _basePoolSize;
+        for (size_t i = 0; i < _pools.size(); ++i) {
+            uint extraShare = extra/_pools.size() + (i < extra%_pools.size() ? 1 : 0);
+            _pools[i]->resize(_poolBaseSizes[i] + extraShare);
+        }
+        _scheduler->setSchedMaxThreads(target);
+        LOGS(_log, LOG_LVL_DEBUG, "pool sizer blocked=" << blocked << " target=" << target);
+    }
 }
 
 /// Put the task on the scheduler to be run later.
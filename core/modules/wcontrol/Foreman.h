@@ -26,7 +26,12 @@
 
 // System headers
 #include <atomic>
+#include <condition_variable>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 // Qserv headers
 #include "mysql/MySqlConfig.h"
@@ -70,6 +75,16 @@ public:
     /// nothing should be harmless, but some Schedulers may work better if cancelled
     /// tasks are removed.
     void taskCancelled(wbase::Task *task) override {}
+
+    /// Set the function used to pre-build subchunk tables for Tasks that are
+    /// expected to run soon. Schedulers that do not prefetch ignore it.
+    virtual void setPrefetchFunc(
+            std::function<void(std::vector<std::shared_ptr<wbase::Task>> const&)> const& func) {}
+
+    /// Set/get the total number of Tasks the scheduler may have inFlight.
+    /// Schedulers without such a budget may ignore it.
+    virtual void setSchedMaxThreads(int schedMaxThreads) {}
+    virtual int getSchedMaxThreads() { return 0; }
 };
 
 /// Foreman is used to maintain a thread pool and schedule Tasks for the thread pool.
@@ -114,17 +129,34 @@ public:
 
 private:
 
+    /// Closed-loop pool sizing: periodically compare each pool's blocked
+    /// thread count (see util::ThreadPool::markBlocked) against its size and
+    /// grow or shrink the pools, and the scheduler's inFlight budget with
+    /// them, within [base, 2*base].
+    void _poolSizerLoop();
+
     std::shared_ptr<wdb::SQLBackend>       _backend;
     std::shared_ptr<wdb::ChunkResourceMgr> _chunkResourceMgr;
 
-    util::ThreadPool::Ptr _pool;
-    Scheduler::Ptr        _scheduler;
+    /// Task thread pools, one per NUMA node, all fed by _scheduler. Each pool's
+    /// threads are pinned to the cpus of its node so a Task runs near the memory
+    /// where MemMan locked its chunk. On a single-node host there is one
+    /// unpinned pool.
+    std::vector<util::ThreadPool::Ptr> _pools;
+    Scheduler::Ptr _scheduler;
 
     util::CommandQueue::Ptr _workerCommandQueue;    ///< dedicated queue for the worker commands
     util::ThreadPool::Ptr   _workerCommandPool;     ///< dedicated pool for executing worker commands
 
     mysql::MySqlConfig const        _mySqlConfig;
     wpublish::QueriesAndChunks::Ptr _queries;
+
+    std::vector<uint> _poolBaseSizes; ///< Configured size of each pool, the sizing floor.
+    uint _basePoolSize{0};            ///< Sum of _poolBaseSizes; also the base scheduler budget.
+    std::thread _poolSizer;           ///< Runs _poolSizerLoop().
+    std::mutex _poolSizerMtx;               ///< Protects _poolSizerStop, used with _poolSizerCv.
+    std::condition_variable _poolSizerCv;   ///< Wakes _poolSizerLoop() for shutdown.
+    bool _poolSizerStop{false};             ///< Tell _poolSizerLoop() to return.
 };
 
 }}}  // namespace lsst::qserv::wcontrol
@@ -45,15 +45,21 @@
 // Qserv headers
 #include "global/Bug.h"
 #include "global/constants.h"
+#include "proto/worker.pb.h"
 #include "sql/SqlResults.h"
 #include "util/IterableFormatter.h"
 #include "wbase/Base.h"
+#include "wbase/Task.h"
 #include "wdb/QuerySql.h"
 
 namespace {
 
 LOG_LOGGER _log = LOG_GET("lsst.qserv.wdb.ChunkResource");
 
+/// Number of prefetched chunks to keep reserved. Old prefetches are released
+/// as new ones arrive, on the assumption that the scan has passed them by.
+size_t const maxPrefetchedChunks = 2;
+
 template <typename T>
 class ScScriptBuilder {
 public:
@@ -320,6 +326,72 @@ ChunkResourceMgr::Ptr ChunkResourceMgr::newMgr(SQLBackend::Ptr const& backend) {
 }
 
 
+ChunkResourceMgr::ChunkResourceMgr(SQLBackend::Ptr const& backend) : _backend(backend) {
+    _prefetchThread.run();
+}
+
+
+ChunkResourceMgr::~ChunkResourceMgr() {
+    _prefetchThread.queEnd();
+    _prefetchThread.join();
+    // Release prefetched reservations while this instance is still whole.
+    std::lock_guard<std::mutex> lock(_prefetchMutex);
+    _prefetched.clear();
+}
+
+
+void ChunkResourceMgr::prefetchTasks(std::vector<std::shared_ptr<wbase::Task>> const& tasks) {
+    // Collect the subchunk reservations the tasks will need. Keep only a
+    // description of each reservation here; the expensive acquire happens
+    // on _prefetchThread.
+    auto infos = std::make_shared<std::vector<ChunkResource::Info>>();
+    for (auto const& task : tasks) {
+        if (task == nullptr || task->msg == nullptr || task->getCancelled()) {
+            continue;
+        }
+        proto::TaskMsg const& msg = *task->msg;
+        for (int i = 0; i < msg.fragment_size(); ++i) {
+            proto::TaskMsg_Fragment const& fragment = msg.fragment(i);
+            if (!fragment.has_subchunks()) {
+                continue; // Nothing to build without subchunks.
+            }
+            proto::TaskMsg_Subchunk const& sc = fragment.subchunks();
+            DbTableSet dbTableSet;
+            for (int j = 0; j < sc.dbtbl_size(); j++) {
+                dbTableSet.emplace(sc.dbtbl(j).db(), sc.dbtbl(j).tbl());
+            }
+            IntVector subchunks(sc.id().begin(), sc.id().end());
+            std::string db = sc.has_database() ? sc.database() : msg.db();
+            infos->push_back(ChunkResource::Info(db, msg.chunkid(), dbTableSet, subchunks));
+        }
+    }
+    if (infos->empty()) {
+        return;
+    }
+    auto self = this; // Valid as _prefetchThread is joined in the destructor.
+    auto cmd = std::make_shared<util::Command>([self, infos](util::CmdData*) {
+        std::vector<ChunkResource> resources;
+        for (auto const& info : *infos) {
+            try {
+                resources.push_back(self->acquire(info.db, info.chunkId, info.tables,
+                                                  info.subChunkIds));
+            } catch (sql::SqlErrorObject const& err) {
+                // The Task that needs the subchunks will hit the same error and
+                // report it; prefetch just gives up on this reservation.
+                LOGS(_log, LOG_LVL_WARN, "prefetch failed chunk=" << info.chunkId
+                     << " err=" << err.errMsg());
+            }
+        }
+        std::lock_guard<std::mutex> lock(self->_prefetchMutex);
+        self->_prefetched.push_back(std::move(resources));
+        while (self->_prefetched.size() > maxPrefetchedChunks) {
+            self->_prefetched.pop_front();
+        }
+    });
+    _prefetchThread.queCmd(cmd);
+}
+
+
 ChunkResource ChunkResourceMgr::acquire(std::string const& db, int chunkId, DbTableSet const& tables) {
     // Make sure that the chunk is ready. (NOP right now.)
     LOGS(_log, LOG_LVL_DEBUG, "acquire db=" << db << " chunkId=" << chunkId << " tables=" << util::printable(tables));
@@ -336,20 +408,30 @@ ChunkResource ChunkResourceMgr::acquire(std::string const& db, int chunkId,
 
 
 void ChunkResourceMgr::release(ChunkResource::Info const& i) {
-     std::lock_guard<std::mutex> lock(_mapMutex);
-     Map& map = _getMap(i.db);
-     ChunkEntry& ce = _getChunkEntry(map, i.chunkId);
-     ce.release(i.db, i.tables, i.subChunkIds, _backend);
+    ChunkEntry* ce = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(_mapMutex);
+        Map& map = _getMap(i.db);
+        ce = &_getChunkEntry(map, i.chunkId);
+    }
+    // Release outside of _mapMutex; ChunkEntry has its own mutex and entries
+    // are never removed from the maps, so the pointer remains valid.
+    ce->release(i.db, i.tables, i.subChunkIds, _backend);
 }
 
 
 void ChunkResourceMgr::acquireUnit(ChunkResource::Info const& i) {
-    std::lock_guard<std::mutex> lock(_mapMutex);
-    Map& map = _getMap(i.db); // Select db
-    ChunkEntry& ce = _getChunkEntry(map, i.chunkId);
-    // Actually acquire
+    ChunkEntry* ce = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(_mapMutex);
+        Map& map = _getMap(i.db); // Select db
+        ce = &_getChunkEntry(map, i.chunkId);
+    }
+    // Actually acquire. This happens outside of _mapMutex so a slow subchunk
+    // build, such as the prefetch thread working on an upcoming chunk, only
+    // blocks users of that chunk and not every acquire and release.
     LOGS(_log, LOG_LVL_DEBUG, "acquireUnit info=" << i);
-    ce.acquire(i.db, i.tables, i.subChunkIds, _backend);
+    ce->acquire(i.db, i.tables, i.subChunkIds, _backend);
 }
 
 
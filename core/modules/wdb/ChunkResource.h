@@ -47,6 +47,7 @@
 #include "global/DbTable.h"
 #include "global/intTypes.h"
 #include "global/stringTypes.h"
+#include "util/EventThread.h"
 #include "wdb/SQLBackend.h"
 
 // Forward declarations
@@ -55,6 +56,9 @@ namespace qserv {
 namespace proto {
     class TaskMsg_Fragment;
 }
+namespace wbase {
+    class Task;
+}
 namespace wdb {
     class Task;
 }}} // End of forward declarations
@@ -101,8 +105,8 @@ public:
 
     /// Factory
     static Ptr newMgr(SQLBackend::Ptr const& backend);
-    ChunkResourceMgr(SQLBackend::Ptr const& backend) : _backend(backend) {}
-    virtual ~ChunkResourceMgr() {}
+    ChunkResourceMgr(SQLBackend::Ptr const& backend);
+    virtual ~ChunkResourceMgr();
 
     /// Reserve a chunk. Currently, this does not result in any explicit chunk
     /// loading.
@@ -118,6 +122,14 @@ public:
                           DbTableSet const& DbTableSet, IntVector const& subChunks);
 
 
+    /// Build the subchunk tables 'tasks' will need before the Tasks actually
+    /// run. The CREATE+INSERT work happens on a background thread so it
+    /// overlaps the scan of the current chunk instead of delaying the first
+    /// Task to touch each subchunk. The reservations are held until later
+    /// prefetches push them out, so unused prefetched tables are discarded
+    /// once the scan has moved on.
+    void prefetchTasks(std::vector<std::shared_ptr<wbase::Task>> const& tasks);
+
     /// Release a reservation. Currently, block until the resource has been
     /// released if the resource is no longer needed by anyone.
     /// Clients should not need to call this explicitly-- ChunkResource
@@ -146,6 +158,10 @@ private:
     // a problem.
     std::shared_ptr<SQLBackend> _backend;
     std::mutex _mapMutex; // Do not alter map without this mutex
+
+    util::EventThread _prefetchThread; ///< Builds prefetched subchunk tables off the Task threads.
+    std::deque<std::vector<ChunkResource>> _prefetched; ///< Reservations held for prefetched chunks.
+    std::mutex _prefetchMutex; ///< Protects _prefetched.
 };
 
 }}} // namespace lsst::qserv::wdb
@@ -0,0 +1,95 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "wdb/FragmentShare.h"
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+// Qserv headers
+#include "proto/worker.pb.h"
+
+namespace {
+LOG_LOGGER _log = LOG_GET("lsst.qserv.wdb.FragmentShare");
+}
+
+namespace lsst {
+namespace qserv {
+namespace wdb {
+
+std::shared_ptr<proto::Result> FragmentShare::Entry::waitForResult(unsigned int& rowCount,
+                                                                   std::size_t& tSize) {
+    std::unique_lock<std::mutex> lock(_mtx);
+    _cv.wait(lock, [this]() { return _done; });
+    rowCount = _rowCount;
+    tSize = _tSize;
+    return _rows;
+}
+
+
+FragmentShare& FragmentShare::instance() {
+    static FragmentShare fragmentShare;
+    return fragmentShare;
+}
+
+
+FragmentShare::Entry::Ptr FragmentShare::acquire(std::string const& key) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    auto iter = _entries.find(key);
+    if (iter != _entries.end()) {
+        LOGS(_log, LOG_LVL_DEBUG, "FragmentShare following key=" << key);
+        return iter->second;
+    }
+    _entries[key] = std::make_shared<Entry>();
+    return nullptr; // Caller is the leader.
+}
+
+
+void FragmentShare::publish(std::string const& key, std::shared_ptr<proto::Result> const& rows,
+                            unsigned int rowCount, std::size_t tSize) {
+    Entry::Ptr entry;
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        auto iter = _entries.find(key);
+        if (iter == _entries.end()) {
+            LOGS(_log, LOG_LVL_WARN, "FragmentShare publish with unknown key=" << key);
+            return;
+        }
+        entry = iter->second;
+        // Remove the key now; a Task arriving later becomes a new leader.
+        _entries.erase(iter);
+    }
+    {
+        std::lock_guard<std::mutex> lock(entry->_mtx);
+        entry->_rows = rows;
+        entry->_rowCount = rowCount;
+        entry->_tSize = tSize;
+        entry->_done = true;
+    }
+    entry->_cv.notify_all();
+    LOGS(_log, LOG_LVL_DEBUG, "FragmentShare published key=" << key
+         << " shared=" << (rows != nullptr) << " rowCount=" << rowCount);
+}
+
+}}} // namespace lsst::qserv::wdb
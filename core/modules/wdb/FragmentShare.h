@@ -0,0 +1,108 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_WDB_FRAGMENTSHARE_H
+#define LSST_QSERV_WDB_FRAGMENTSHARE_H
+
+// System headers
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+// Third-party headers
+#include "boost/utility.hpp"
+
+// Forward declarations
+namespace lsst {
+namespace qserv {
+namespace proto {
+    class Result;
+}}} // End of forward declarations
+
+namespace lsst {
+namespace qserv {
+namespace wdb {
+
+/// FragmentShare lets concurrent Tasks that would execute byte-identical
+/// query fragments on the same chunk share a single execution. The shared
+/// scan schedulers queue Tasks for the same chunk together, so identical
+/// queries (dashboards, repeated QA queries) arrive nearly simultaneously;
+/// the first runner to register a fragment key becomes the leader and runs
+/// the SQL, while followers with the same key block until the leader either
+/// publishes its rows or abandons the share.
+///
+/// A leader only publishes results that fit in a single transmit message;
+/// anything larger, any error, and any cancellation abandons the share and
+/// the followers each run the fragment themselves. An entry lives only while
+/// its leader is running, so memory held is bounded by one message per set
+/// of concurrent duplicates and a Task arriving after the leader finished
+/// simply becomes a new leader.
+class FragmentShare : boost::noncopyable {
+public:
+    /// Rendezvous between one leader and its followers for a single key.
+    class Entry {
+    public:
+        using Ptr = std::shared_ptr<Entry>;
+
+        /// Block until the leader publishes or abandons.
+        /// @param rowCount - set to the shared row count on success.
+        /// @param tSize    - set to the shared transmit size on success.
+        /// @return the shared rows, or nullptr if the share was abandoned.
+        std::shared_ptr<proto::Result> waitForResult(unsigned int& rowCount, std::size_t& tSize);
+
+        friend class FragmentShare;
+
+    private:
+        std::mutex _mtx;
+        std::condition_variable _cv;
+        bool _done{false};
+        std::shared_ptr<proto::Result> _rows; ///< nullptr when abandoned.
+        unsigned int _rowCount{0};
+        std::size_t _tSize{0};
+    };
+
+    /// Return the process-wide instance.
+    static FragmentShare& instance();
+
+    /// Register interest in 'key'.
+    /// @return nullptr if the caller is now the leader for 'key' and must
+    ///         eventually call publish(), otherwise the Entry to wait on.
+    Entry::Ptr acquire(std::string const& key);
+
+    /// Publish the leader's result for 'key' and release the key. Pass
+    /// nullptr 'rows' to abandon the share; waiting followers then run the
+    /// fragment themselves. Must be called exactly once per leader.
+    void publish(std::string const& key, std::shared_ptr<proto::Result> const& rows,
+                 unsigned int rowCount, std::size_t tSize);
+
+private:
+    FragmentShare() = default;
+
+    std::mutex _mtx; ///< Protects _entries.
+    std::map<std::string, Entry::Ptr> _entries; ///< Active leaders by fragment key.
+};
+
+}}} // namespace lsst::qserv::wdb
+
+#endif // LSST_QSERV_WDB_FRAGMENTSHARE_H
@@ -33,7 +33,9 @@
 
 // System headers
 #include <algorithm>
+#include <chrono>
 #include <cstddef>
+#include <cstring>
 #include <iostream>
 #include <memory>
 
@@ -53,25 +55,39 @@
 #include "global/DbTable.h"
 #include "global/debugUtil.h"
 #include "global/UnsupportedError.h"
+#include "mysql/AsyncQueryMgr.h"
 #include "mysql/MySqlConfig.h"
 #include "mysql/MySqlConnection.h"
+#include "mysql/MySqlConnPool.h"
 #include "mysql/SchemaFactory.h"
 #include "proto/ProtoHeaderWrap.h"
 #include "proto/worker.pb.h"
 #include "sql/Schema.h"
 #include "sql/SqlErrorObject.h"
 #include "util/common.h"
+#include "util/Histogram.h"
 #include "util/IterableFormatter.h"
 #include "util/MultiError.h"
 #include "util/StringHash.h"
-#include "util/Timer.h"
+#include "util/ThreadPool.h"
+#include "util/Trace.h"
 #include "util/threadSafe.h"
 #include "wbase/Base.h"
 #include "wbase/SendChannel.h"
 #include "wdb/ChunkResource.h"
+#include "wdb/FragmentShare.h"
+#include "wdb/ResultCache.h"
 
 namespace {
 LOG_LOGGER _log = LOG_GET("lsst.qserv.wdb.QueryRunner");
+
+/// Bytes of already-transmitted results waiting to be sent, above which the
+/// transmit block size stops ramping (the czar is draining slowly).
+size_t const maxTransmitBacklogBytes = 100*1024*1024;
+
+/// Milliseconds spent waiting on mysqld per statement, aggregated over all
+/// Tasks of this worker. Percentiles show up in the per-statement DEBUG log.
+lsst::qserv::util::Histogram mysqldExecHisto("mysqldExecMs");
 }
 
 namespace lsst {
@@ -107,9 +123,12 @@ QueryRunner::QueryRunner(wbase::Task::Ptr const& task,
 bool QueryRunner::_initConnection() {
     mysql::MySqlConfig localMySqlConfig(_mySqlConfig);
     localMySqlConfig.username = _task->user; // Override with czar-passed username.
-    _mysqlConn.reset(new mysql::MySqlConnection(localMySqlConfig));
+    // Check a connection out of the pool; most Tasks reuse a warm connection
+    // instead of paying TCP+auth setup. A pool miss hands back a fresh
+    // instance that still needs to connect.
+    _mysqlConn = mysql::MySqlConnPool::instance().acquire(localMySqlConfig);
 
-    if (not _mysqlConn->connect()) {
+    if (not _mysqlConn->connected() && not _mysqlConn->connect()) {
         LOGS(_log, LOG_LVL_ERROR, _task->getIdStr() << " Unable to connect to MySQL: " << localMySqlConfig);
         util::Error error(-1, "Unable to connect to MySQL; " + localMySqlConfig.toString());
         _multiError.push_back(error);
@@ -145,7 +164,10 @@ bool QueryRunner::runQuery() {
     }
 
     // Wait for memman to finish reserving resources. This can take several seconds.
-    _task->waitForMemMan();
+    {
+        util::ThreadPool::BlockedRegion blocked; // MemMan reads the chunk's tables from disk.
+        _task->waitForMemMan();
+    }
 
     if (_task->getCancelled()) {
         LOGS(_log, LOG_LVL_DEBUG, _task->getIdStr() << " runQuery, task was cancelled after locking tables.");
@@ -179,14 +201,33 @@ bool QueryRunner::runQuery() {
     return false;
 }
 
-MYSQL_RES* QueryRunner::_primeResult(std::string const& query) {
-        bool queryOk = _mysqlConn->queryUnbuffered(query);
+MYSQL_RES* QueryRunner::_awaitResult(std::shared_ptr<mysql::MySqlConnection> const& conn,
+                                     std::future<bool>& future) {
+        util::Span span("worker.mysql", _task->getQueryId());
+        // The statement runs on the shared event-loop threads; this thread
+        // rendezvous on the future, but the in-flight socket waits of all
+        // concurrent chunk queries are multiplexed on the AsyncQueryMgr pool.
+        bool queryOk;
+        auto const execBegin = std::chrono::steady_clock::now();
+        {
+            util::ThreadPool::BlockedRegion blocked; // The rendezvous can wait out a full scan in mysqld.
+            queryOk = future.get();
+        }
+        // The rendezvous time covers mysqld's execution of the statement (or
+        // the tail of it, for statements pipelined on the second connection).
+        auto const execMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - execBegin).count();
+        mysqldExecHisto.record(execMs > 0 ? execMs : 0);
+        _mysqldMs += execMs > 0 ? execMs : 0;
+        LOGS(_log, LOG_LVL_DEBUG, _task->getIdStr() << " mysqld exec=" << execMs << "ms "
+             << mysqldExecHisto.summary());
+        queryOk = queryOk && conn->useResult();
         if (!queryOk) {
-            util::Error error(_mysqlConn->getErrno(), _mysqlConn->getError());
+            util::Error error(conn->getErrno(), conn->getError());
             _multiError.push_back(error);
             return nullptr;
         }
-        return _mysqlConn->getResult();
+        return conn->getResult();
 }
 
 void QueryRunner::_initMsgs() {
@@ -223,27 +264,61 @@ void QueryRunner::_fillSchema(MYSQL_RES* result) {
 bool QueryRunner::_fillRows(MYSQL_RES* result, int numFields, uint& rowCount, size_t& tSize) {
     MYSQL_ROW row;
 
+    // Everything inside the fetch loop runs once per row and a chunk scan can
+    // produce millions of rows, so invariants are hoisted out of the loop and
+    // tSize is kept as a running estimate (cell bytes plus a fixed per-cell
+    // overhead, like the columnar path) instead of re-walking the row with
+    // ByteSize(). tSize only decides when to split the transmit, so it does
+    // not need to be protobuf-exact.
+    bool const columnar = _task->msg->columnarresult();
+    bool const interactive = _task->getOnInteractive();
+    int64_t const rowBudget = _task->msg->rowbudget();
+    // The czar negotiates the cap on a single transmit block in TaskMsg;
+    // fall back to the protobuf-friendly limit when it does not.
+    size_t szLimitBase = proto::ProtoHeaderWrap::PROTOBUFFER_DESIRED_LIMIT;
+    if (_task->msg->transmitblocksize() > 0) {
+        szLimitBase = _task->msg->transmitblocksize();
+    }
+    szLimitBase = std::min(szLimitBase, proto::ProtoHeaderWrap::PROTOBUFFER_HARD_LIMIT);
+
     while ((row = mysql_fetch_row(result))) {
         auto lengths = mysql_fetch_lengths(result);
-        proto::RowBundle* rawRow =_result->add_row();
-        for(int i=0; i < numFields; ++i) {
-            if (row[i]) {
-                rawRow->add_column(row[i], lengths[i]);
-                rawRow->add_isnull(false);
-            } else {
-                rawRow->add_column();
-                rawRow->add_isnull(true);
+        if (columnar) {
+            _packRowColumnar(row, lengths, numFields, tSize);
+        } else {
+            proto::RowBundle* rawRow =_result->add_row();
+            tSize += 2; // per-row message overhead
+            for(int i=0; i < numFields; ++i) {
+                if (row[i]) {
+                    rawRow->add_column(row[i], lengths[i]);
+                    rawRow->add_isnull(false);
+                    tSize += lengths[i] + 8;
+                } else {
+                    rawRow->add_column();
+                    rawRow->add_isnull(true);
+                    tSize += 8;
+                }
             }
         }
-        tSize += rawRow->ByteSize();
         ++rowCount;
+        ++_rowsFetched;
+
+        // The czar needs at most rowBudget rows from this task; anything
+        // beyond that would be discarded there, so stop fetching. The rest
+        // of the result set is thrown away by freeResult().
+        if (rowBudget > 0 && _rowsFetched >= rowBudget) {
+            LOGS(_log, LOG_LVL_DEBUG, _task->getIdStr() << " row budget " << rowBudget
+                 << " satisfied, ending scan early");
+            break;
+        }
 
-        unsigned int szLimit = std::min(proto::ProtoHeaderWrap::PROTOBUFFER_DESIRED_LIMIT,
-                                        proto::ProtoHeaderWrap::PROTOBUFFER_HARD_LIMIT);
+        size_t szLimit = szLimitBase;
 
-        // Use small blocks until it is considered a large result and it is not an interactive query.
-        if (!_largeResult && !_task->getOnInteractive()) {
-            szLimit = std::min(szLimit, _initialBlockSize);
+        // Non-interactive results ramp up: the first block is small so the
+        // czar sees rows early, then _currentBlockSize grows after each
+        // transmit the czar keeps up with.
+        if (!interactive) {
+            szLimit = std::min(szLimit, _currentBlockSize);
         }
 
         // Each element needs to be mysql-sanitized
@@ -257,7 +332,16 @@ bool QueryRunner::_fillRows(MYSQL_RES* result, int numFields, uint& rowCount, si
             _transmit(false, rowCount, tSize);
             rowCount = 0;
             tSize = 0;
+            // Ramp the block size geometrically while the czar is draining
+            // what has been sent; with a transmit backlog, larger blocks
+            // would only pile up more bytes on the worker.
+            if (xrdsvc::StreamBuffer::getTotalBytes() < maxTransmitBacklogBytes) {
+                _currentBlockSize = std::min(_currentBlockSize * 4, szLimitBase);
+            }
             _initMsg();
+            // Only single-message results can be shared; release any followers
+            // now rather than making them wait out the remaining transmits.
+            _abandonShare();
             // This task is going to have multiple results to return to the czar and
             // the speed this task can be completed will be limited by the czar's ability to
             // read in results, which could be very very slow. The upshot of this is the
@@ -275,6 +359,39 @@ bool QueryRunner::_fillRows(MYSQL_RES* result, int numFields, uint& rowCount, si
     return true;
 }
 
+/// Append one row to the columnar RowBlock. Cell bytes go into contiguous
+/// per-column buffers, so packing is an append per cell instead of a
+/// protobuf object per cell.
+void QueryRunner::_packRowColumnar(char** row, unsigned long* lengths, int numFields,
+                                   size_t& tSize) {
+    proto::RowBlock* block = _result->mutable_rowblock();
+    if (block->column_size() == 0) {
+        for(int i=0; i < numFields; ++i) {
+            block->add_column();
+        }
+    }
+    uint32_t rowIdx = block->numrows();
+    for(int i=0; i < numFields; ++i) {
+        proto::ColumnBlock* col = block->mutable_column(i);
+        if (row[i]) {
+            col->mutable_data()->append(row[i], lengths[i]);
+            col->add_cellsize(lengths[i]);
+            tSize += lengths[i] + 4;
+        } else {
+            col->add_cellsize(0);
+            std::string* bitmap = col->mutable_nullbitmap();
+            size_t byteIdx = rowIdx / 8;
+            if (bitmap->size() <= byteIdx) {
+                bitmap->resize(byteIdx + 1, '\0');
+            }
+            (*bitmap)[byteIdx] |= static_cast<char>(1 << (rowIdx % 8));
+            tSize += 4;
+        }
+    }
+    block->set_numrows(rowIdx + 1);
+}
+
+
 /// Transmit result data with its header.
 /// If 'last' is true, this is the last message in the result set
 /// and flags are set accordingly.
@@ -289,71 +406,164 @@ void QueryRunner::_transmit(bool last, uint rowCount, size_t tSize) {
     _result->set_rowcount(rowCount);
     _result->set_transmitsize(tSize);
     _result->set_attemptcount(_task->getAttemptCount());
+    if (last) {
+        // Phase timing for the czar's per-query breakdown. The stamps are
+        // this host's clock; the czar compares them with its own, so the
+        // derived dispatch and transfer phases inherit any clock skew
+        // between the hosts. Serializing this final message is not counted.
+        proto::TaskTiming* timing = _result->mutable_timing();
+        timing->set_queuedtime(_task->getQueueTimeMs());
+        timing->set_starttime(_task->getStartTimeMs());
+        timing->set_sendtime(std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count());
+        timing->set_mysqlms(_mysqldMs);
+        timing->set_serializems(_serializeMs);
+    }
     if (!_multiError.empty()) {
         std::string chunkId = std::to_string(_task->msg->chunkid());
         std::string msg = "Error(s) in result for chunk #" + chunkId + ": " + _multiError.toOneLineString();
         _result->set_errormsg(msg);
         LOGS(_log, LOG_LVL_ERROR, msg);
     }
-    _result->SerializeToString(&resultString);
+    if (_cancelled) {
+        LOGS(_log, LOG_LVL_DEBUG, "_transmit cancelled");
+        _result.reset();
+        _largeResult = true; // Transmits after the first are considered large results.
+        return;
+    }
+
+    // Serialize the message. Unless it must be compressed first, serialize it
+    // directly into the refcounted buffer handed to XrdSsi so the result
+    // never exists twice in worker memory. The fixed-size header frame is
+    // composed in front of the payload in the same buffer, so each transmit
+    // costs a single network operation instead of one for the header and
+    // another for the data.
+    size_t const hdrSize = proto::ProtoHeaderWrap::PROTO_HEADER_SIZE;
+    xrdsvc::StreamBuffer::Ptr streamBuf;
+    int compression = proto::COMP_NONE;
+    size_t uncompressedSize;
+    auto const serializeBegin = std::chrono::steady_clock::now();
+    {
+        util::Span span("worker.serialize", _task->getQueryId());
+        if (_task->msg->resultcompression() == proto::COMP_ZLIB) {
+            _result->SerializeToString(&resultString);
+            uncompressedSize = resultString.size();
+            if (proto::ProtoHeaderWrap::compressMsg(resultString, proto::COMP_ZLIB)) {
+                compression = proto::COMP_ZLIB;
+                LOGS(_log, LOG_LVL_DEBUG, _task->getIdStr() << " compressed result "
+                     << uncompressedSize << " -> " << resultString.size());
+            }
+            resultString.insert(0, _headerFrame(resultString.data(), resultString.size(),
+                                                compression, uncompressedSize));
+            // StreamBuffer::createWithMove invalidates resultString by using std::move()
+            streamBuf = xrdsvc::StreamBuffer::createWithMove(resultString);
+        } else {
+            int const msgSize = _result->ByteSize();
+            uncompressedSize = msgSize;
+            streamBuf = xrdsvc::StreamBuffer::createWithCapacity(hdrSize + msgSize);
+            _result->SerializeToArray(streamBuf->data + hdrSize, msgSize);
+            std::string const frame = _headerFrame(streamBuf->data + hdrSize, msgSize,
+                                                   compression, uncompressedSize);
+            std::memcpy(streamBuf->data, frame.data(), hdrSize);
+        }
+    }
+    _serializeMs += std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - serializeBegin).count();
     _result.reset(); // don't need it anymore and a new one will be made when needed..
 
-    _transmitHeader(resultString);
     LOGS(_log, LOG_LVL_DEBUG, "_transmit last=" << last << " " << _task->getIdStr()
-         << " resultString=" << util::prettyCharList(resultString, 5));
+         << " framed=" << util::prettyCharBuf(streamBuf->data, streamBuf->getSize(), 5));
 
-    if (!_cancelled) {
-        // StreamBuffer::create invalidates resultString by using std::move()
-        xrdsvc::StreamBuffer::Ptr streamBuf(xrdsvc::StreamBuffer::createWithMove(resultString));
-        bool sent = _task->sendChannel->sendStream(streamBuf, last);
-        if (!sent) {
-            LOGS(_log, LOG_LVL_ERROR, _task->getIdStr() << " Failed to transmit message!");
-        }
-        // Block on the buffer actually being sent if 10GB are already waiting or this is a largeResult.
-        auto totalBytes = xrdsvc::StreamBuffer::getTotalBytes();
-        if (_largeResult || totalBytes > 10000000000) {  // TODO:DM-10273 add to configuration
-            LOGS(_log, LOG_LVL_INFO, _task->getIdStr() << " waiting for buffer largeResult=" << _largeResult
-                                      << " totalBytes=" << totalBytes);
-            util::Timer t;
-            t.start();
-            streamBuf->waitForDoneWithThis(); // block until this buffer has been sent.
-            t.stop();
-            LOGS(_log, LOG_LVL_DEBUG, _task->getIdStr() << " waited for " << t.getElapsed());
-        }
-    } else {
-        LOGS(_log, LOG_LVL_DEBUG, "_transmit cancelled");
+    bool sent = _task->sendChannel->sendStream(streamBuf, last);
+    if (!sent) {
+        LOGS(_log, LOG_LVL_ERROR, _task->getIdStr() << " Failed to transmit message!");
+    }
+    // Block on the buffer actually being sent if 10GB are already waiting or this is a largeResult.
+    auto totalBytes = xrdsvc::StreamBuffer::getTotalBytes();
+    if (_largeResult || totalBytes > 10000000000) {  // TODO:DM-10273 add to configuration
+        LOGS(_log, LOG_LVL_INFO, _task->getIdStr() << " waiting for buffer largeResult=" << _largeResult
+                                  << " totalBytes=" << totalBytes);
+        util::Span span("worker.transmitwait", _task->getQueryId());
+        util::ThreadPool::BlockedRegion blocked; // Waiting on the czar to drain.
+        streamBuf->waitForDoneWithThis(); // block until this buffer has been sent.
     }
     _largeResult = true; // Transmits after the first are considered large results.
 }
 
-/// Transmit the protoHeader
-void QueryRunner::_transmitHeader(std::string& msg) {
-    LOGS(_log, LOG_LVL_DEBUG, "_transmitHeader");
-    // Set header
+/// Compose the fixed-size frame carrying the protoHeader
+std::string QueryRunner::_headerFrame(char const* msgData, size_t msgSize,
+                                      int compression, size_t uncompressedSize) {
+    LOGS(_log, LOG_LVL_DEBUG, "_headerFrame");
+    // Set header. size and md5 describe the bytes as transmitted, i.e.
+    // after any compression has been applied.
     _protoHeader->set_protocol(2); // protocol 2: row-by-row message
-    _protoHeader->set_size(msg.size());
-    _protoHeader->set_md5(util::StringHash::getMd5(msg.data(), msg.size()));
+    _protoHeader->set_size(msgSize);
+    _protoHeader->set_md5(util::StringHash::getMd5(msgData, msgSize));
     _protoHeader->set_wname(getHostname());
     _protoHeader->set_largeresult(_largeResult);
+    _protoHeader->set_compression(static_cast<proto::CompressionCodec>(compression));
+    if (compression != proto::COMP_NONE) {
+        _protoHeader->set_uncompressedsize(uncompressedSize);
+    }
     std::string protoHeaderString;
     _protoHeader->SerializeToString(&protoHeaderString);
 
-    // Flush to channel.
     // Make sure protoheader size can be encoded in a byte.
     assert(protoHeaderString.size() < 255);
-    if (!_cancelled) {
-        auto msgBuf = proto::ProtoHeaderWrap::wrap(protoHeaderString);
-        xrdsvc::StreamBuffer::Ptr streamBuf(xrdsvc::StreamBuffer::createWithMove(msgBuf)); // invalidates msgBuf
-        bool sent = _task->sendChannel->sendStream(streamBuf, false);
-        if (!sent) {
-            LOGS(_log, LOG_LVL_ERROR, _task->getIdStr() << " Failed to transmit header!");
+    return proto::ProtoHeaderWrap::wrap(protoHeaderString);
+}
+
+/// Build a key identifying the physical work of this Task's fragments:
+/// Tasks with identical keys produce identical result rows. Fields that only
+/// affect who receives the rows (query/job ids, result names, session,
+/// compression) are deliberately excluded; fields that change the row data
+/// or its representation (queries, subchunks, columnar packing) or its
+/// visibility (user) are included.
+std::string QueryRunner::_fragmentShareKey() {
+    proto::TaskMsg const& m = *_task->msg;
+    std::string buf;
+    auto add = [&buf](std::string const& s) { buf += s; buf += '\0'; };
+    add(_dbName);
+    add(std::to_string(m.chunkid()));
+    add(_task->user);
+    add(std::to_string(m.columnarresult()));
+    add(std::to_string(m.rowbudget())); // budget changes how many rows are produced.
+    for (int i = 0; i < m.fragment_size(); ++i) {
+        proto::TaskMsg_Fragment const& fragment = m.fragment(i);
+        for (std::string const& queryStr : fragment.query()) {
+            add(queryStr);
+        }
+        if (fragment.has_subchunks()) {
+            proto::TaskMsg_Subchunk const& sc = fragment.subchunks();
+            if (sc.has_database()) {
+                add(sc.database());
+            }
+            for (int j = 0; j < sc.dbtbl_size(); ++j) {
+                add(sc.dbtbl(j).db());
+                add(sc.dbtbl(j).tbl());
+            }
+            for (auto subchunkId : sc.id()) {
+                add(std::to_string(subchunkId));
+            }
         }
-        // intentionally not waiting for streamBuf to finish, as this message is tiny.
-    } else {
-        LOGS(_log, LOG_LVL_DEBUG, _task->getIdStr() << " _transmitHeader cancelled");
     }
+    // A colliding key would share the wrong rows, so use the 128-bit fast
+    // hash; it is still far cheaper than a crypto digest on this per-task path.
+    return util::StringHash::getXxHash128(buf.data(), buf.size());
 }
 
+
+/// If this runner leads a fragment share that hasn't been resolved yet,
+/// abandon it so waiting followers run the fragment themselves. Harmless
+/// to call when not leading or already resolved.
+void QueryRunner::_abandonShare() {
+    if (!_shareKey.empty() && !_sharePublished) {
+        FragmentShare::instance().publish(_shareKey, nullptr, 0, 0);
+        _sharePublished = true;
+    }
+}
+
+
 class ChunkResourceRequest {
 public:
     ChunkResourceRequest(std::shared_ptr<ChunkResourceMgr> const& mgr,
@@ -412,34 +622,141 @@ bool QueryRunner::_dispatchChannel() {
 
     uint rowCount = 0;
     size_t tSize = 0;
+    int64_t const rowBudget = m.rowbudget();
+
+    // Tasks with byte-identical fragments on this chunk produce identical
+    // rows, and chunk data only changes at ingest (which invalidates the
+    // cache). Replay a cached result from an earlier execution if one exists.
+    std::string const shareKey = _fragmentShareKey();
+    {
+        auto cached = ResultCache::instance().lookup(shareKey);
+        if (cached != nullptr && !_cancelled) {
+            LOGS(_log, LOG_LVL_DEBUG, _task->getIdStr() << " using cached fragment result rowCount="
+                 << cached->rowCount);
+            _result->CopyFrom(*cached->rows);
+            if (_task->msg->has_session()) {
+                _result->set_session(_task->msg->session());
+            }
+            _transmit(true, cached->rowCount, cached->tSize);
+            return true;
+        }
+    }
 
-    try {
-        for(int i=0; i < m.fragment_size(); ++i) {
-            if (_cancelled) {
-                break;
+    // Concurrent Tasks with byte-identical fragments on this chunk produce
+    // identical rows; let one execution feed all of them. If another runner
+    // already leads this key, wait for its rows instead of re-running the SQL.
+    auto shareEntry = FragmentShare::instance().acquire(shareKey);
+    if (shareEntry != nullptr) {
+        std::shared_ptr<proto::Result> sharedRows;
+        {
+            util::ThreadPool::BlockedRegion blocked; // Waiting on the leading runner's SQL.
+            sharedRows = shareEntry->waitForResult(rowCount, tSize);
+        }
+        if (sharedRows != nullptr && !_cancelled) {
+            LOGS(_log, LOG_LVL_DEBUG, _task->getIdStr() << " using shared fragment result rowCount="
+                 << rowCount);
+            _result->CopyFrom(*sharedRows);
+            if (_task->msg->has_session()) {
+                _result->set_session(_task->msg->session());
             }
+            _transmit(true, rowCount, tSize);
+            return true;
+        }
+        // The leader abandoned the share (large result, error, or cancel);
+        // fall through and run the fragments normally, without leading.
+    } else {
+        _shareKey = shareKey;
+    }
+    // Make certain followers are released if this leader exits on any path.
+    class ShareRelease {
+    public:
+        explicit ShareRelease(QueryRunner* qr) : _qr(qr) {}
+        ~ShareRelease() { _qr->_abandonShare(); }
+    private:
+        QueryRunner* _qr;
+    };
+    ShareRelease shareRelease(this);
+
+    try {
+        // Flatten the fragments into the ordered list of statements to run.
+        // Pipelined execution needs to see statement N+1 while statement N is
+        // still being drained, which the nested per-fragment loops would hide.
+        struct FlatQuery {
+            std::string sql;
+            int fragIdx;
+        };
+        std::vector<FlatQuery> statements;
+        for (int i=0; i < m.fragment_size(); ++i) {
             proto::TaskMsg_Fragment const& fragment(m.fragment(i));
-            std::vector<std::string> queries;
             for (const std::string queryStr: fragment.query()) {
                 if (fragment.has_subchunks() && false == fragment.subchunks().id().empty()) {
                     for (auto subchunkId : fragment.subchunks().id()) {
                         std::string s(queryStr);
                         boost::algorithm::replace_all(s, SUBCHUNK_TAG, std::to_string(subchunkId));
-                        queries.push_back(s);
+                        statements.push_back(FlatQuery{s, i});
                     }
                 } else {
-                    queries.push_back(queryStr);
+                    statements.push_back(FlatQuery{queryStr, i});
                 }
             }
-            ChunkResource cr(req.getResourceFragment(i));
-            // Use query fragment as-is, funnel results.
-            for (auto const& query : queries) {
-                LOGS(_log, LOG_LVL_DEBUG, "running fragment=" << query);
-                MYSQL_RES* res = _primeResult(query); // This runs the SQL query.
-                if (!res) {
-                    erred = true;
-                    continue;
-                }
+        }
+
+        // A second connection lets mysqld execute statement N+1 while this
+        // thread serializes statement N's rows; subchunk-fragmented tasks
+        // otherwise leave mysqld idle for every serialization interval. If
+        // the extra connection cannot be made, the statements simply run
+        // back-to-back on _mysqlConn as before.
+        if (statements.size() > 1) {
+            mysql::MySqlConfig localMySqlConfig(_mySqlConfig);
+            localMySqlConfig.username = _task->user;
+            auto conn = mysql::MySqlConnPool::instance().acquire(localMySqlConfig);
+            if (conn->connected() || conn->connect()) {
+                _pipelineConn = conn;
+            } else {
+                LOGS(_log, LOG_LVL_WARN, _task->getIdStr()
+                     << " no second connection for pipelined fragments, running sequentially");
+            }
+        }
+        auto connFor = [this](int stmtIdx) {
+            return (_pipelineConn != nullptr && stmtIdx % 2 == 1) ? _pipelineConn : _mysqlConn;
+        };
+
+        // Resource reservations are taken as execution reaches each fragment
+        // but held until every fragment is done, so the subchunk scratch
+        // tables that near-neighbor fragments share are built once and kept
+        // instead of being torn down and rebuilt between fragments.
+        std::vector<ChunkResource> heldResources;
+        auto submitStatement = [&](int stmtIdx) {
+            while (static_cast<int>(heldResources.size()) <= statements[stmtIdx].fragIdx) {
+                heldResources.push_back(req.getResourceFragment(heldResources.size()));
+            }
+            LOGS(_log, LOG_LVL_DEBUG, "running fragment=" << statements[stmtIdx].sql);
+            return mysql::AsyncQueryMgr::instance()->submitFuture(*connFor(stmtIdx),
+                                                                  statements[stmtIdx].sql);
+        };
+
+        std::future<bool> future;
+        int inFlight = -1; // statement submitted but not yet consumed.
+        if (!statements.empty() && !_cancelled) {
+            future = submitStatement(0);
+            inFlight = 0;
+        }
+        for (int k = 0; k < static_cast<int>(statements.size()) && inFlight >= 0; ++k) {
+            MYSQL_RES* res = _awaitResult(connFor(k), future);
+            inFlight = -1;
+            // Issue the next statement on the other connection before this
+            // result is drained, so mysqld works on it in the meantime. The
+            // row budget check is speculative here: statement k's rows have
+            // not been counted yet, so at most one surplus statement runs
+            // and its result is discarded below.
+            if (_pipelineConn != nullptr && k + 1 < static_cast<int>(statements.size())
+                && !_cancelled && !(rowBudget > 0 && _rowsFetched >= rowBudget)) {
+                future = submitStatement(k + 1);
+                inFlight = k + 1;
+            }
+            if (!res) {
+                erred = true;
+            } else {
                 if (firstResult) {
                     _fillSchema(res);
                     firstResult = false;
@@ -452,14 +769,53 @@ bool QueryRunner::_dispatchChannel() {
                 if (!_fillRows(res, numFields, rowCount, tSize)) {
                     erred = true;
                 }
-                _mysqlConn->freeResult();
-            } // Each query in a fragment
-        } // Each fragment in a msg.
+                connFor(k)->freeResult();
+            }
+            if (_cancelled) {
+                break;
+            }
+            // Once the row budget is satisfied, the remaining statements
+            // could only produce rows the czar would discard.
+            if (rowBudget > 0 && _rowsFetched >= rowBudget) {
+                break;
+            }
+            // Without a second connection the next statement can only start
+            // once this one's result has been freed.
+            if (_pipelineConn == nullptr && k + 1 < static_cast<int>(statements.size())) {
+                future = submitStatement(k + 1);
+                inFlight = k + 1;
+            }
+        }
+        // A speculatively issued statement may still be running after an
+        // early exit; rendezvous and discard its result so the connection is
+        // not left mid-statement. Its failure, if any, is moot.
+        if (inFlight >= 0) {
+            bool ok;
+            {
+                util::ThreadPool::BlockedRegion blocked; // Waiting out the surplus statement.
+                ok = future.get();
+            }
+            if (ok && connFor(inFlight)->useResult()) {
+                connFor(inFlight)->freeResult();
+            }
+        }
     } catch(sql::SqlErrorObject const& e) {
         util::Error worker_err(e.errNo(), e.errMsg());
         _multiError.push_back(worker_err);
     }
     if (!_cancelled) {
+        // A clean single-message result can feed any followers waiting on the
+        // same fragments, and future Tasks with the same key via the result
+        // cache. Copy the rows before _transmit() consumes _result.
+        if (!erred && !_largeResult && _multiError.empty()) {
+            auto sharedRows = std::make_shared<proto::Result>();
+            sharedRows->CopyFrom(*_result);
+            if (!_shareKey.empty() && !_sharePublished) {
+                FragmentShare::instance().publish(_shareKey, sharedRows, rowCount, tSize);
+                _sharePublished = true;
+            }
+            ResultCache::instance().insert(shareKey, sharedRows, rowCount, tSize);
+        }
         // Send results.
         _transmit(true, rowCount, tSize);
     } else {
@@ -496,9 +852,24 @@ void QueryRunner::cancel() {
           LOGS(_log, LOG_LVL_ERROR, "QueryRunner::cancel() unknown error");
           break;
     }
+    if (_pipelineConn != nullptr) {
+        int pipelineStatus = _pipelineConn->cancel();
+        LOGS(_log, LOG_LVL_WARN, "QueryRunner::cancel() pipeline connection status="
+             << pipelineStatus);
+    }
 }
 
 QueryRunner::~QueryRunner() {
+    // Return the mysqld connection for reuse by a later Task. Cancelled or
+    // erred runs keep their connection out of the pool; it is closed here by
+    // the last shared_ptr instead, so a KILLed or half-consumed session is
+    // never handed to another Task.
+    if (_mysqlConn != nullptr && !_cancelled && _multiError.empty()) {
+        mysql::MySqlConnPool::instance().release(_mysqlConn);
+        if (_pipelineConn != nullptr) {
+            mysql::MySqlConnPool::instance().release(_pipelineConn);
+        }
+    }
 }
 
 }}} // namespace lsst::qserv::wdb
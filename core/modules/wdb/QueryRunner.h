@@ -35,6 +35,7 @@
 
 // System headers
 #include <atomic>
+#include <future>
 #include <memory>
 
 // Qserv headers
@@ -79,14 +80,25 @@ private:
     bool _initConnection();
     void _setDb();
     bool _dispatchChannel(); ///< Dispatch with output sent through a SendChannel
-    MYSQL_RES* _primeResult(std::string const& query); ///< Obtain a result handle for a query.
+    /// Rendezvous on a statement previously handed to the AsyncQueryMgr and
+    /// return its streaming result set, or nullptr after recording the error.
+    MYSQL_RES* _awaitResult(std::shared_ptr<mysql::MySqlConnection> const& conn,
+                            std::future<bool>& future);
 
     bool _fillRows(MYSQL_RES* result, int numFields, uint& rowCount, size_t& tsize);
+    /// @return a key identifying the physical work of this Task's fragments.
+    std::string _fragmentShareKey();
+    void _abandonShare(); ///< Release any followers waiting on this runner's share key.
+    /// Append one row to the columnar RowBlock of the current Result message.
+    void _packRowColumnar(char** row, unsigned long* lengths, int numFields, size_t& tSize);
     void _fillSchema(MYSQL_RES* result);
     void _initMsgs();
     void _initMsg();
     void _transmit(bool last, uint rowCount, size_t size);
-    void _transmitHeader(std::string& msg);
+    /// @return the fixed-size frame (see ProtoHeaderWrap) describing
+    /// the payload bytes as transmitted.
+    std::string _headerFrame(char const* msgData, size_t msgSize, int compression,
+                             size_t uncompressedSize);
 
     ///< Actual task
     wbase::Task::Ptr _task;
@@ -96,14 +108,28 @@ private:
     std::string _dbName;
     std::atomic<bool> _cancelled{false};
     mysql::MySqlConfig const _mySqlConfig;
-    std::unique_ptr<mysql::MySqlConnection> _mysqlConn;
+    /// Checked out of MySqlConnPool; returned for reuse on clean completion.
+    std::shared_ptr<mysql::MySqlConnection> _mysqlConn;
+    /// Second pooled connection so mysqld can execute fragment statement N+1
+    /// while statement N's rows are serialized from _mysqlConn; null when the
+    /// Task has a single statement or the extra connection could not be made.
+    std::shared_ptr<mysql::MySqlConnection> _pipelineConn;
 
     util::MultiError _multiError; // Error log
 
     std::shared_ptr<proto::ProtoHeader> _protoHeader;
     std::shared_ptr<proto::Result> _result;
+    std::string _shareKey; //< FragmentShare key when this runner is a leader, otherwise empty.
+    bool _sharePublished{false}; //< True once the share for _shareKey was published or abandoned.
     bool _largeResult{false}; //< True for all transmits after the first transmit.
-    unsigned int _initialBlockSize{5000}; //< Maximum size of initial transmit block.
+    int64_t _rowsFetched{0}; //< Rows produced so far, across fragments and split transmits.
+    /// Adaptive transmit block size: starts small so the czar sees rows
+    /// early, then ramps geometrically toward the cap negotiated in
+    /// TaskMsg.transmitblocksize while the czar keeps draining.
+    size_t _currentBlockSize{5000};
+
+    uint64_t _mysqldMs{0}; //< Milliseconds spent waiting on mysqld, across fragments.
+    uint64_t _serializeMs{0}; //< Milliseconds spent serializing result messages.
 };
 
 }}} // namespace
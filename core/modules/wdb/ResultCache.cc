@@ -0,0 +1,129 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "wdb/ResultCache.h"
+
+// System headers
+#include <algorithm>
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+// Qserv headers
+#include "proto/worker.pb.h"
+
+namespace {
+LOG_LOGGER _log = LOG_GET("lsst.qserv.wdb.ResultCache");
+}
+
+namespace lsst {
+namespace qserv {
+namespace wdb {
+
+std::size_t const ResultCache::DEFAULT_MAX_BYTES = 1024UL*1024*1024; // 1GB
+
+ResultCache& ResultCache::instance() {
+    static ResultCache resultCache;
+    return resultCache;
+}
+
+
+ResultCache::Entry::Ptr ResultCache::lookup(std::string const& key) {
+    std::lock_guard<std::mutex> lock(_mtx);
+    auto iter = _slots.find(key);
+    if (iter == _slots.end()) {
+        return nullptr;
+    }
+    // Move to the most recently used end.
+    _lru.splice(_lru.end(), _lru, iter->second.lruPos);
+    LOGS(_log, LOG_LVL_DEBUG, "ResultCache hit key=" << key
+         << " rowCount=" << iter->second.entry->rowCount);
+    return iter->second.entry;
+}
+
+
+void ResultCache::insert(std::string const& key, std::shared_ptr<proto::Result const> const& rows,
+                         unsigned int rowCount, std::size_t tSize) {
+    if (rows == nullptr) {
+        return;
+    }
+    // tSize is the transmit-size estimate the fetch loop tracked; it is
+    // within a few percent of the real footprint, which is all the byte
+    // bound needs. Count at least one byte so empty results still cost.
+    std::size_t const entryBytes = std::max<std::size_t>(tSize, 1);
+    if (entryBytes > _maxBytes) {
+        return; // Would evict the whole cache for one entry.
+    }
+    std::lock_guard<std::mutex> lock(_mtx);
+    auto iter = _slots.find(key);
+    if (iter != _slots.end()) {
+        // Replace the existing entry in place.
+        _bytes -= iter->second.bytes;
+        iter->second.entry = std::make_shared<Entry>(Entry{rows, rowCount, tSize});
+        iter->second.bytes = entryBytes;
+        _bytes += entryBytes;
+        _lru.splice(_lru.end(), _lru, iter->second.lruPos);
+        return;
+    }
+    while (_bytes + entryBytes > _maxBytes && !_lru.empty()) {
+        auto evictIter = _slots.find(_lru.front());
+        _bytes -= evictIter->second.bytes;
+        _slots.erase(evictIter);
+        _lru.pop_front();
+    }
+    Slot slot;
+    slot.entry = std::make_shared<Entry>(Entry{rows, rowCount, tSize});
+    slot.bytes = entryBytes;
+    slot.lruPos = _lru.insert(_lru.end(), key);
+    _slots[key] = slot;
+    _bytes += entryBytes;
+    LOGS(_log, LOG_LVL_DEBUG, "ResultCache insert key=" << key << " rowCount=" << rowCount
+         << " bytes=" << entryBytes << " total=" << _bytes);
+}
+
+
+void ResultCache::invalidate() {
+    std::lock_guard<std::mutex> lock(_mtx);
+    if (!_slots.empty()) {
+        LOGS(_log, LOG_LVL_INFO, "ResultCache invalidated, dropping "
+             << _slots.size() << " entries, " << _bytes << " bytes");
+    }
+    _slots.clear();
+    _lru.clear();
+    _bytes = 0;
+}
+
+
+std::size_t ResultCache::entryCount() const {
+    std::lock_guard<std::mutex> lock(_mtx);
+    return _slots.size();
+}
+
+
+std::size_t ResultCache::bytes() const {
+    std::lock_guard<std::mutex> lock(_mtx);
+    return _bytes;
+}
+
+}}} // namespace lsst::qserv::wdb
@@ -0,0 +1,119 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_WDB_RESULTCACHE_H
+#define LSST_QSERV_WDB_RESULTCACHE_H
+
+// System headers
+#include <cstddef>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+// Third-party headers
+#include "boost/utility.hpp"
+
+// Forward declarations
+namespace lsst {
+namespace qserv {
+namespace proto {
+    class Result;
+}}} // End of forward declarations
+
+namespace lsst {
+namespace qserv {
+namespace wdb {
+
+/// ResultCache keeps the result rows of recently finished Tasks so that a
+/// later Task with an identical fragment key can replay them without
+/// re-running the SQL. Where FragmentShare deduplicates executions that are
+/// in flight at the same time, this cache spans time: interactive users
+/// re-issue the same cone searches over and over, and chunk data only
+/// changes at ingest.
+///
+/// The cache is bounded by total payload bytes and evicts least recently
+/// used entries. Only clean single-message results are inserted (the same
+/// restriction FragmentShare places on shared results), so an entry can be
+/// replayed verbatim as one transmit. Any mutation of the worker's chunk
+/// inventory calls invalidate(), which empties the cache; a cached result
+/// is therefore always from the current version of the chunk data.
+class ResultCache : boost::noncopyable {
+public:
+    /// One cached result: the rows plus the counters _transmit() needs.
+    struct Entry {
+        using Ptr = std::shared_ptr<Entry>;
+
+        std::shared_ptr<proto::Result const> rows;
+        unsigned int rowCount = 0;
+        std::size_t tSize = 0;
+    };
+
+    /// Default bound on the total payload bytes kept.
+    static std::size_t const DEFAULT_MAX_BYTES;
+
+    explicit ResultCache(std::size_t maxBytes = DEFAULT_MAX_BYTES)
+        : _maxBytes(maxBytes) {}
+
+    /// Return the process-wide instance.
+    static ResultCache& instance();
+
+    /// @return the cached entry for 'key', or nullptr. A hit makes the
+    ///         entry the most recently used.
+    Entry::Ptr lookup(std::string const& key);
+
+    /// Cache 'rows' under 'key', evicting least recently used entries to
+    /// stay under the byte bound. Results larger than the bound are ignored.
+    void insert(std::string const& key, std::shared_ptr<proto::Result const> const& rows,
+                unsigned int rowCount, std::size_t tSize);
+
+    /// Drop every entry. Called when chunk data changes.
+    void invalidate();
+
+    /// @return the number of cached entries.
+    std::size_t entryCount() const;
+
+    /// @return the total payload bytes currently cached.
+    std::size_t bytes() const;
+
+private:
+    using LruList = std::list<std::string>; ///< keys, least recently used first.
+
+    /// A cache slot: the entry, its cost and its position in the LRU list.
+    struct Slot {
+        Entry::Ptr entry;
+        std::size_t bytes = 0;
+        LruList::iterator lruPos;
+    };
+
+    std::size_t const _maxBytes;
+
+    mutable std::mutex _mtx; ///< Protects everything below.
+    LruList _lru;
+    std::unordered_map<std::string, Slot> _slots;
+    std::size_t _bytes = 0;
+};
+
+}}} // namespace lsst::qserv::wdb
+
+#endif // LSST_QSERV_WDB_RESULTCACHE_H
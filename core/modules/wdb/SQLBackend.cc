@@ -42,6 +42,9 @@ namespace {
 
 LOG_LOGGER _log = LOG_GET("lsst.qserv.wdb.ChunkResource");
 
+/// MySQL error: the table is full (a MEMORY table hit max_heap_table_size).
+int const ER_RECORD_FILE_FULL = 1114;
+
 } // anonymous namespace
 
 
@@ -56,11 +59,37 @@ std::ostream& operator<<(std::ostream& os, ScTable const& st) {
 }
 
 
+size_t const SQLBackend::MAX_WARM_TABLES = 512;
+
+
+std::string SQLBackend::_scTableKey(ScTable const& st) {
+    return st.dbTable.db + ":" + std::to_string(st.chunkId) + ":"
+            + st.dbTable.table + ":" + std::to_string(st.subChunkId);
+}
+
+
+bool SQLBackend::_warmTake(ScTable const& st) {
+    std::lock_guard<std::mutex> lock(_warmMtx);
+    auto it = _warmMap.find(_scTableKey(st));
+    if (it == _warmMap.end()) {
+        return false;
+    }
+    _warmLru.erase(it->second);
+    _warmMap.erase(it);
+    return true;
+}
+
+
 bool SQLBackend::load(ScTableVector const& v, sql::SqlErrorObject& err) {
     using namespace lsst::qserv::wbase;
     memLockRequireOwnership();
     for(ScTableVector::const_iterator i=v.begin(), e=v.end();
             i != e; ++i) {
+        if (_warmTake(*i)) {
+            // The table survived an earlier discard; reuse it as-is.
+            LOGS(_log, LOG_LVL_DEBUG, "SubChunk reusing warm table " << *i);
+            continue;
+        }
         std::string const* createScript = nullptr;
         if (i->chunkId == DUMMY_CHUNK) {
             createScript = &CREATE_DUMMY_SUBCHUNK_SCRIPT;
@@ -72,6 +101,32 @@ bool SQLBackend::load(ScTableVector const& v, sql::SqlErrorObject& err) {
                 % i->chunkId % i->subChunkId).str();
 
         if (!_sqlConn.runQuery(create, err)) {
+            // A dense subchunk (galactic plane) can overflow the MEMORY
+            // engine's table size limit. Rebuild such a table on disk
+            // instead of failing the query: slower to scan, but the
+            // near-neighbor join completes.
+            if (err.errNo() == ER_RECORD_FILE_FULL) {
+                LOGS(_log, LOG_LVL_WARN, "SubChunk table " << *i
+                     << " overflowed the MEMORY engine, rebuilding on disk");
+                // Drop whatever the failed CREATE ... SELECT left behind so
+                // the retry can't adopt a partially filled table.
+                std::string const drop = (boost::format(CLEANUP_SUBCHUNK_SCRIPT)
+                        % i->dbTable.db % i->dbTable.table % i->chunkId % i->subChunkId).str();
+                sql::SqlErrorObject dropErr;
+                _sqlConn.runQuery(drop, dropErr);
+
+                std::string onDisk = create;
+                std::string const memEngine = "ENGINE = MEMORY";
+                std::string const diskEngine = "ENGINE = MyISAM";
+                for (size_t pos = 0; (pos = onDisk.find(memEngine, pos)) != std::string::npos;
+                     pos += diskEngine.size()) {
+                    onDisk.replace(pos, memEngine.size(), diskEngine);
+                }
+                err.reset();
+                if (_sqlConn.runQuery(onDisk, err)) {
+                    continue;
+                }
+            }
             _discard(v.begin(), i);
             return false;
         }
@@ -95,7 +150,28 @@ void SQLBackend::memLockRequireOwnership() {
 void SQLBackend::_discard(ScTableVector::const_iterator begin,
               ScTableVector::const_iterator end) {
     memLockRequireOwnership();
-    for(ScTableVector::const_iterator i=begin, e=end; i != e; ++i) {
+    // Keep the discarded tables warm instead of dropping them; only tables
+    // pushed out of the LRU are dropped for real. Near-neighbor scans touch
+    // the same subchunks over and over, and rebuilding a warm table would
+    // repeat its whole CREATE ... SELECT.
+    ScTableVector evicted;
+    {
+        std::lock_guard<std::mutex> lock(_warmMtx);
+        for(ScTableVector::const_iterator i=begin, e=end; i != e; ++i) {
+            std::string key = _scTableKey(*i);
+            if (_warmMap.find(key) != _warmMap.end()) {
+                continue; // Already warm.
+            }
+            _warmLru.push_back(*i);
+            _warmMap[key] = --_warmLru.end();
+        }
+        while (_warmLru.size() > MAX_WARM_TABLES) {
+            evicted.push_back(_warmLru.front());
+            _warmMap.erase(_scTableKey(_warmLru.front()));
+            _warmLru.pop_front();
+        }
+    }
+    for(ScTableVector::const_iterator i=evicted.begin(), e=evicted.end(); i != e; ++i) {
         std::string discard = (boost::format(lsst::qserv::wbase::CLEANUP_SUBCHUNK_SCRIPT)
                 % i->dbTable.db % i->dbTable.table % i->chunkId % i->subChunkId).str();
         sql::SqlErrorObject err;
@@ -27,10 +27,13 @@
 
 // System headers
 #include <atomic>
+#include <list>
+#include <mutex>
 #include <set>
 #include <string>
 #include <sys/types.h>
 #include <unistd.h>
+#include <unordered_map>
 
 // Qserv headers
 #include "global/DbTable.h"
@@ -70,6 +73,13 @@ typedef std::vector<ScTable> ScTableVector;
 /// in the SQLBackend constructor call to SQLBackend::_memLockAcquire(). The reason it is so important
 /// is that the in-memory tables have their schema written to disk but no data, so they are
 /// just a bunch of empty tables when the program starts up.
+///
+/// Subchunk tables discarded by ChunkResourceMgr are not dropped right away.
+/// They are moved to a bounded LRU of warm tables instead, and a later load()
+/// of the same (db, table, chunk, subchunk) reuses the warm table without
+/// re-running the CREATE ... SELECT. Chunk data only changes when a chunk is
+/// (re)loaded onto the worker, so a warm table stays valid for reuse. Tables
+/// pushed out of the LRU are dropped for real.
 class SQLBackend {
 public:
     using Ptr=std::shared_ptr<SQLBackend>;
@@ -91,6 +101,9 @@ public:
 
     virtual void memLockRequireOwnership();
 
+    /// Maximum number of unreferenced subchunk tables kept warm for reuse.
+    static size_t const MAX_WARM_TABLES;
+
 protected:
     SQLBackend() : _uid(getpid()) {};
 
@@ -99,6 +112,13 @@ protected:
 
     virtual void _discard(ScTableVector::const_iterator begin, ScTableVector::const_iterator end);
 
+    /// @return the warm-cache key for a subchunk table.
+    static std::string _scTableKey(ScTable const& st);
+
+    /// Take a table out of the warm cache if it is there.
+    /// @return true if the table was warm and can be reused as-is.
+    bool _warmTake(ScTable const& st);
+
     /// Run the 'query'. If it fails, terminate the program.
     void _execLockSql(std::string const& query);
 
@@ -123,6 +143,12 @@ protected:
     std::string _lockTbl;
     std::string _lockDbTbl;
     int _uid;
+
+    // Warm subchunk table cache members.
+    std::mutex _warmMtx; ///< protects _warmLru and _warmMap.
+    std::list<ScTable> _warmLru; ///< warm tables, least recently discarded last.
+    /// Key to LRU position for each warm table.
+    std::unordered_map<std::string, std::list<ScTable>::iterator> _warmMap;
 };
 
 
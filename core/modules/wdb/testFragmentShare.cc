@@ -0,0 +1,89 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+ /**
+  * @brief test FragmentShare
+  */
+
+// System headers
+#include <memory>
+#include <thread>
+
+// Qserv headers
+#include "proto/worker.pb.h"
+#include "wdb/FragmentShare.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE FragmentShare
+#include "boost/test/included/unit_test.hpp"
+
+namespace test = boost::test_tools;
+
+using namespace lsst::qserv;
+using lsst::qserv::wdb::FragmentShare;
+
+BOOST_AUTO_TEST_SUITE(Suite)
+
+BOOST_AUTO_TEST_CASE(LeaderFollower) {
+    auto& share = FragmentShare::instance();
+    // First acquire makes the caller the leader.
+    auto entry = share.acquire("keyA");
+    BOOST_CHECK(entry == nullptr);
+    // Later callers with the same key follow.
+    auto follower = share.acquire("keyA");
+    BOOST_REQUIRE(follower != nullptr);
+    // A different key has its own leader.
+    BOOST_CHECK(share.acquire("keyB") == nullptr);
+    share.publish("keyB", nullptr, 0, 0);
+
+    auto rows = std::make_shared<proto::Result>();
+    rows->set_rowcount(7);
+    std::thread t([follower]() {
+        unsigned int rowCount = 0;
+        std::size_t tSize = 0;
+        auto shared = follower->waitForResult(rowCount, tSize);
+        BOOST_REQUIRE(shared != nullptr);
+        BOOST_CHECK_EQUAL(shared->rowcount(), 7);
+        BOOST_CHECK_EQUAL(rowCount, 7u);
+        BOOST_CHECK_EQUAL(tSize, 42u);
+    });
+    share.publish("keyA", rows, 7, 42);
+    t.join();
+
+    // The key was released by publish; a new caller leads again.
+    BOOST_CHECK(share.acquire("keyA") == nullptr);
+    share.publish("keyA", nullptr, 0, 0);
+}
+
+BOOST_AUTO_TEST_CASE(Abandon) {
+    auto& share = FragmentShare::instance();
+    BOOST_CHECK(share.acquire("keyC") == nullptr);
+    auto follower = share.acquire("keyC");
+    BOOST_REQUIRE(follower != nullptr);
+    // Abandoning hands followers a null result; they run the SQL themselves.
+    share.publish("keyC", nullptr, 0, 0);
+    unsigned int rowCount = 99;
+    std::size_t tSize = 99;
+    BOOST_CHECK(follower->waitForResult(rowCount, tSize) == nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
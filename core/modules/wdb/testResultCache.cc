@@ -0,0 +1,100 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+ /**
+  * @brief test ResultCache
+  */
+
+// System headers
+#include <memory>
+
+// Qserv headers
+#include "proto/worker.pb.h"
+#include "wdb/ResultCache.h"
+
+// Boost unit test header
+#define BOOST_TEST_MODULE ResultCache
+#include "boost/test/included/unit_test.hpp"
+
+namespace test = boost::test_tools;
+
+using namespace lsst::qserv;
+using lsst::qserv::wdb::ResultCache;
+
+namespace {
+
+std::shared_ptr<proto::Result const> makeRows(int rowCount) {
+    auto rows = std::make_shared<proto::Result>();
+    rows->set_rowcount(rowCount);
+    return rows;
+}
+
+} // anonymous namespace
+
+BOOST_AUTO_TEST_SUITE(Suite)
+
+BOOST_AUTO_TEST_CASE(InsertAndLookup) {
+    ResultCache cache;
+    BOOST_CHECK(cache.lookup("keyA") == nullptr);
+
+    cache.insert("keyA", makeRows(7), 7, 42);
+    auto entry = cache.lookup("keyA");
+    BOOST_REQUIRE(entry != nullptr);
+    BOOST_CHECK_EQUAL(entry->rows->rowcount(), 7);
+    BOOST_CHECK_EQUAL(entry->rowCount, 7u);
+    BOOST_CHECK_EQUAL(entry->tSize, 42u);
+    BOOST_CHECK_EQUAL(cache.entryCount(), 1u);
+    BOOST_CHECK_EQUAL(cache.bytes(), 42u);
+
+    // Re-inserting the same key replaces the entry, not adds one.
+    cache.insert("keyA", makeRows(8), 8, 50);
+    entry = cache.lookup("keyA");
+    BOOST_REQUIRE(entry != nullptr);
+    BOOST_CHECK_EQUAL(entry->rowCount, 8u);
+    BOOST_CHECK_EQUAL(cache.entryCount(), 1u);
+    BOOST_CHECK_EQUAL(cache.bytes(), 50u);
+
+    cache.invalidate();
+    BOOST_CHECK(cache.lookup("keyA") == nullptr);
+    BOOST_CHECK_EQUAL(cache.entryCount(), 0u);
+    BOOST_CHECK_EQUAL(cache.bytes(), 0u);
+}
+
+BOOST_AUTO_TEST_CASE(LruEviction) {
+    ResultCache cache(100); // tiny byte bound for testing.
+    cache.insert("keyA", makeRows(1), 1, 40);
+    cache.insert("keyB", makeRows(2), 2, 40);
+    // Touch keyA so keyB is the least recently used.
+    BOOST_CHECK(cache.lookup("keyA") != nullptr);
+    // keyC forces an eviction; keyB should go.
+    cache.insert("keyC", makeRows(3), 3, 40);
+    BOOST_CHECK(cache.lookup("keyA") != nullptr);
+    BOOST_CHECK(cache.lookup("keyB") == nullptr);
+    BOOST_CHECK(cache.lookup("keyC") != nullptr);
+    BOOST_CHECK_EQUAL(cache.entryCount(), 2u);
+
+    // An entry larger than the whole bound is never cached.
+    cache.insert("keyD", makeRows(4), 4, 1000);
+    BOOST_CHECK(cache.lookup("keyD") == nullptr);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -28,8 +28,11 @@
 // System headers
 #include <algorithm>
 #include <cassert>
+#include <cstdio>
 #include <deque>
+#include <fstream>
 #include <iostream>
+#include <thread>
 
 // Third-party headers
 
@@ -38,7 +41,9 @@
 
 // Qserv headers
 #include "global/constants.h"
+#include "global/debugUtil.h"
 #include "sql/SqlConnection.h"
+#include "wdb/ResultCache.h"
 
 // This macro to appear witin each block which requires thread safety
 
@@ -48,6 +53,11 @@ namespace { // File-scope helpers
 
 LOG_LOGGER _log = LOG_GET("lsst.qserv.wpublish.ChunkInventory");
 
+/// The format signature of the inventory snapshot files. The version number
+/// must be bumped if the format of the files ever changes.
+std::string const snapshotMagic = "qserv-chunk-inventory";
+unsigned int const snapshotVersion = 1;
+
 using lsst::qserv::sql::SqlConnection;
 using lsst::qserv::sql::SqlErrorObject;
 using lsst::qserv::sql::SqlResultIter;
@@ -144,7 +154,12 @@ public:
     virtual bool operator()(lsst::qserv::ResourceUnit const& ru) {
         switch (ru.unitType()) {
             case lsst::qserv::ResourceUnit::DBCHUNK: return chunkInventory.has(ru.db(), ru.chunk());
-            case lsst::qserv::ResourceUnit::WORKER:  return chunkInventory.id() == ru.hashName();
+            // A worker is addressable both by the unique identifier stored in
+            // the inventory and by its hostname, which the czar learns from
+            // the endpoints of the chunk requests it has in flight.
+            case lsst::qserv::ResourceUnit::WORKER:
+                return chunkInventory.id() == ru.hashName()
+                    or lsst::qserv::getHostname() == ru.hashName();
             default: return false;
         }
     }
@@ -178,11 +193,47 @@ void ChunkInventory::init(std::string const& name, mysql::MySqlConfig const& myS
     _init(sc);
 }
 
+void ChunkInventory::init(std::string const& name, mysql::MySqlConfig const& mySqlConfig,
+                          std::string const& snapshotFile) {
+    _name = name;
+    _snapshotFile = snapshotFile;
+
+    if (not _snapshotFile.empty() and _loadSnapshot()) {
+
+        // The inventory is ready to serve requests. The database scan is still
+        // made as a consistency check on the snapshot, though in a background
+        // thread so the (potentially slow on large inventories) scan won't
+        // delay the worker registration.
+
+        std::thread verifier([this, mySqlConfig]() {
+            try {
+                _verifySnapshot(mySqlConfig);
+            } catch (std::exception const& e) {
+                LOGS(_log, LOG_LVL_ERROR,
+                     "ChunkInventory failed to verify the snapshot against the database: " << e.what());
+            }
+        });
+        verifier.detach();
+        return;
+    }
+
+    // No usable snapshot. Scan the database as before and leave the first
+    // snapshot behind for the next restart.
+
+    SqlConnection sc(mySqlConfig, true);
+    _init(sc);
+    saveSnapshot();
+}
+
 void ChunkInventory::rebuild(std::string const& name, mysql::MySqlConfig const& mySqlConfig) {
     _name = name;
     SqlConnection sc(mySqlConfig, true);
     _rebuild(sc);
     _init(sc);
+    saveSnapshot();
+
+    // Chunk data may have changed; cached task results are stale.
+    wdb::ResultCache::instance().invalidate();
 }
 
 void ChunkInventory::add(std::string const& db, int chunk) {
@@ -194,7 +245,12 @@ void ChunkInventory::add(std::string const& db, int chunk) {
     // Adding unconditionally. if the database key doesn't exist then it will
     // be automatically added by this operation.
     _existMap[db].insert(chunk);
+    ++_version;
+
+    _saveSnapshot();
 
+    // Chunk data changed; cached task results are stale.
+    wdb::ResultCache::instance().invalidate();
 }
 
 void ChunkInventory::add(std::string const& db, int chunk, mysql::MySqlConfig const& mySqlConfig) {
@@ -234,6 +290,12 @@ void ChunkInventory::add(std::string const& db, int chunk, mysql::MySqlConfig co
     // Adding unconditionally. if the database key doesn't exist then it will
     // be automatically added by this operation.
     _existMap[db].insert(chunk);
+    ++_version;
+
+    _saveSnapshot();
+
+    // Chunk data changed; cached task results are stale.
+    wdb::ResultCache::instance().invalidate();
 }
 
 void ChunkInventory::remove(std::string const& db, int chunk) {
@@ -253,6 +315,12 @@ void ChunkInventory::remove(std::string const& db, int chunk) {
     if (chunkItr == chunks.end()) return;
 
     _existMap[db].erase(chunk);
+    ++_version;
+
+    _saveSnapshot();
+
+    // Chunk data changed; cached task results are stale.
+    wdb::ResultCache::instance().invalidate();
 }
 
 void ChunkInventory::remove(std::string const& db, int chunk, mysql::MySqlConfig const& mySqlConfig) {
@@ -289,6 +357,12 @@ void ChunkInventory::remove(std::string const& db, int chunk, mysql::MySqlConfig
     if (chunkItr == chunks.end()) return;
 
     _existMap[db].erase(chunk);
+    ++_version;
+
+    _saveSnapshot();
+
+    // Chunk data changed; cached task results are stale.
+    wdb::ResultCache::instance().invalidate();
 }
 
 bool ChunkInventory::has(std::string const& db, int chunk) const {
@@ -352,6 +426,8 @@ void ChunkInventory::_init(SqlConnection& sc) {
     for (std::string const& db: dbs)
         ::fetchChunks(_name, db, sc, _existMap[db]);
 
+    ++_version;
+
     // get unique identifier of a worker
     ::fetchId(_name, sc, _id);
 }
@@ -383,6 +459,132 @@ void ChunkInventory::_rebuild(SqlConnection& sc) {
     }
 }
 
+void ChunkInventory::saveSnapshot() const {
+
+    LOCK_GUARD;
+
+    _saveSnapshot();
+}
+
+bool ChunkInventory::_loadSnapshot() {
+
+    std::ifstream file(_snapshotFile);
+    if (not file.good()) {
+        LOGS(_log, LOG_LVL_DEBUG, "ChunkInventory no snapshot found at: " << _snapshotFile);
+        return false;
+    }
+
+    // Check the format signature before trusting anything else in the file
+
+    std::string magic;
+    unsigned int version = 0;
+    if (not (file >> magic >> version) or
+        (magic != ::snapshotMagic) or (version != ::snapshotVersion)) {
+        LOGS(_log, LOG_LVL_WARN, "ChunkInventory ignoring incompatible snapshot: " << _snapshotFile);
+        return false;
+    }
+
+    // The identifier of the worker is stored as '-' if it was empty when
+    // the snapshot was made.
+
+    std::string id;
+    if (not (file >> id)) {
+        LOGS(_log, LOG_LVL_WARN, "ChunkInventory ignoring truncated snapshot: " << _snapshotFile);
+        return false;
+    }
+    if (id == "-") id.clear();
+
+    ExistMap existMap;
+
+    std::string db;
+    int chunk;
+    while (file >> db >> chunk) {
+        existMap[db].insert(chunk);
+    }
+    if (file.bad()) {
+        LOGS(_log, LOG_LVL_WARN, "ChunkInventory failed to read snapshot: " << _snapshotFile);
+        return false;
+    }
+
+    LOCK_GUARD;
+
+    _existMap.swap(existMap);
+    _id = id;
+
+    LOGS(_log, LOG_LVL_INFO, "ChunkInventory loaded snapshot: " << _snapshotFile
+         << ", databases: " << _existMap.size());
+    return true;
+}
+
+void ChunkInventory::_saveSnapshot() const {
+
+    if (_snapshotFile.empty()) return;
+
+    // Write into a temporary file first so a crash mid-write can't leave
+    // a truncated snapshot behind, then atomically move it into place.
+
+    std::string const tmpFile = _snapshotFile + ".tmp";
+
+    std::ofstream file(tmpFile, std::ofstream::trunc);
+    if (not file.good()) {
+        LOGS(_log, LOG_LVL_WARN, "ChunkInventory failed to open snapshot file for writing: " << tmpFile);
+        return;
+    }
+    file << ::snapshotMagic << " " << ::snapshotVersion << "\n";
+    file << (_id.empty() ? "-" : _id) << "\n";
+
+    for (auto const& entry: _existMap) {
+        auto const& db = entry.first;
+        for (int chunk: entry.second) {
+            file << db << " " << chunk << "\n";
+        }
+    }
+    file.close();
+
+    if (file.fail() or (std::rename(tmpFile.c_str(), _snapshotFile.c_str()) != 0)) {
+        LOGS(_log, LOG_LVL_WARN, "ChunkInventory failed to write snapshot: " << _snapshotFile);
+        return;
+    }
+    LOGS(_log, LOG_LVL_DEBUG, "ChunkInventory saved snapshot: " << _snapshotFile);
+}
+
+void ChunkInventory::_verifySnapshot(mysql::MySqlConfig const& mySqlConfig) {
+
+    // Scan the database into a separate inventory so the current one stays
+    // available for requests while the scan is in progress.
+
+    ChunkInventory fromDb;
+    fromDb._name = _name;
+
+    SqlConnection sc(mySqlConfig, true);
+    fromDb._init(sc);
+
+    ExistMap const missing = fromDb - *this;    // known to the database, not to the snapshot
+    ExistMap const extra   = *this - fromDb;    // known to the snapshot, not to the database
+
+    if (missing.empty() and extra.empty()) {
+        LOGS(_log, LOG_LVL_INFO, "ChunkInventory snapshot is consistent with the database");
+        return;
+    }
+
+    // The database is the authoritative source. Adopt its content and
+    // refresh the snapshot.
+
+    LOGS(_log, LOG_LVL_WARN, "ChunkInventory snapshot is stale, databases missing chunks: "
+         << missing.size() << ", databases with extra chunks: " << extra.size()
+         << ", adopting the database content");
+
+    ExistMap const existMap = fromDb.existMap();
+
+    LOCK_GUARD;
+
+    _existMap = existMap;
+    _id = fromDb._id;
+    ++_version;
+
+    _saveSnapshot();
+}
+
 ChunkInventory::ExistMap ChunkInventory::existMap() const {
 
     ChunkInventory::ExistMap result;
@@ -396,6 +598,13 @@ ChunkInventory::ExistMap ChunkInventory::existMap() const {
     return result;
 }
 
+uint64_t ChunkInventory::version() const {
+
+    LOCK_GUARD;
+
+    return _version;
+}
+
 ChunkInventory::ExistMap operator-(ChunkInventory const& lhs, ChunkInventory const& rhs) {
 
     // The comparision will be made based on two self-consistent copies of
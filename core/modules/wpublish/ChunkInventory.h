@@ -29,6 +29,7 @@
 #define LSST_QSERV_WPUBLISH_CHUNKINVENTORY_H
 
 // System headers
+#include <cstdint>
 #include <map>
 #include <memory>
 #include <mutex>
@@ -90,6 +91,22 @@ public:
 
     void init(std::string const& name, mysql::MySqlConfig const& mysqlConfig);
 
+    /// Initialize the inventory from a previously saved snapshot file, falling
+    /// back to scanning the database tables if no usable snapshot is found.
+    /// When the snapshot load succeeds the SQL scan is still made, though in
+    /// a background thread as a consistency check whose result replaces the
+    /// snapshot content should the two disagree. Once configured, the snapshot
+    /// file is rewritten after each mutation of the inventory so it stays
+    /// current for the next restart.
+    /// Passing an empty 'snapshotFile' is equivalent to calling the two
+    /// parameter version of the method.
+    void init(std::string const& name, mysql::MySqlConfig const& mysqlConfig,
+              std::string const& snapshotFile);
+
+    /// Write the current inventory into the snapshot file configured
+    /// via init(). No effect if no snapshot file was configured.
+    void saveSnapshot() const;
+
     /// Rebuilding the Chunks table
     void rebuild(std::string const& name, mysql::MySqlConfig const& mysqlConfig);
 
@@ -125,6 +142,11 @@ public:
     /// @return a copy of the map in a thread-safe way
     ExistMap existMap() const;
 
+    /// @return the current version of the inventory. The counter starts at 0
+    /// and is incremented at each mutation of the chunk map, allowing clients
+    /// to detect if the list has changed since they last fetched it.
+    uint64_t version() const;
+
     void dbgPrint(std::ostream& os) const;
 
     friend ChunkInventory::ExistMap operator-(ChunkInventory const& lhs, ChunkInventory const& rhs);
@@ -134,14 +156,34 @@ private:
     void _init(sql::SqlConnection& sc);
     void _rebuild(sql::SqlConnection& sc);
 
+    /// Populate the inventory from the snapshot file.
+    /// @return false if the file is missing or can't be parsed
+    bool _loadSnapshot();
+
+    /// Write the inventory into the snapshot file. The caller must be
+    /// holding a lock on the mutex.
+    void _saveSnapshot() const;
+
+    /// Compare the inventory against the database and adopt (and re-save)
+    /// the database content if the two disagree. Launched in a background
+    /// thread after a successful snapshot load.
+    void _verifySnapshot(mysql::MySqlConfig const& mysqlConfig);
+
 private:
 
     ExistMap _existMap;
     std::string _name;
 
+    /// The version of the chunk map, incremented at each mutation
+    /// (guarded by the mutex)
+    uint64_t _version = 0;
+
     /// a unique identifier of a worker
     std::string _id;
 
+    /// Path to the snapshot file ('empty' if snapshots are not configured)
+    std::string _snapshotFile;
+
     /// The mutex is used to safeguard the methods in the multi-threaded
     /// environment
     mutable std::mutex _mtx;
@@ -0,0 +1,106 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2012-2018 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "wpublish/GetSchedulerStatsCommand.h"
+
+// System headers
+
+// Third-party headers
+
+// LSST headers
+#include "lsst/log/Log.h"
+#include "proto/worker.pb.h"
+#include "wbase/SendChannel.h"
+#include "wsched/BlendScheduler.h"
+#include "wsched/SchedulerBase.h"
+
+// Qserv headers
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.wpublish.GetSchedulerStatsCommand");
+
+} // annonymous namespace
+
+namespace lsst {
+namespace qserv {
+namespace wpublish {
+
+GetSchedulerStatsCommand::GetSchedulerStatsCommand(
+                                std::shared_ptr<wbase::SendChannel>     const& sendChannel,
+                                std::shared_ptr<wsched::BlendScheduler> const& blendScheduler)
+    :   wbase::WorkerCommand(sendChannel),
+        _blendScheduler(blendScheduler) {
+}
+
+void GetSchedulerStatsCommand::reportError(std::string const& message) {
+
+    LOGS(_log, LOG_LVL_ERROR, "GetSchedulerStatsCommand::run  " << message);
+
+    proto::WorkerCommandGetSchedulerStatsR reply;
+
+    reply.set_status(proto::WorkerCommandGetSchedulerStatsR::ERROR);
+    reply.set_error(message);
+
+    _frameBuf.serialize(reply);
+    std::string str(_frameBuf.data(), _frameBuf.size());
+    _sendChannel->sendStream(xrdsvc::StreamBuffer::createWithMove(str), true);
+}
+
+void GetSchedulerStatsCommand::run() {
+
+    LOGS(_log, LOG_LVL_DEBUG, "GetSchedulerStatsCommand::run");
+
+    if (_blendScheduler == nullptr) {
+        reportError("no scheduler is attached to this service");
+        return;
+    }
+
+    proto::WorkerCommandGetSchedulerStatsR reply;
+    reply.set_status(proto::WorkerCommandGetSchedulerStatsR::SUCCESS);
+
+    for (auto const& sched: _blendScheduler->getSubSchedulers()) {
+
+        wsched::SchedulerBase::SchedStats const stats = sched->getSchedStats();
+
+        proto::WorkerCommandSchedulerStats* ptr = reply.add_scheduler();
+        ptr->set_name(sched->getName());
+        ptr->set_in_flight(sched->getInFlight());
+        ptr->set_tasks_queued(stats.tasksQueued);
+        ptr->set_tasks_started(stats.tasksStarted);
+        ptr->set_tasks_completed(stats.tasksCompleted);
+        ptr->set_time_in_queue_ms(stats.totalTimeInQMs);
+        ptr->set_bytes_locked(stats.bytesLocked);
+        for (unsigned int j = 0; j < wsched::SchedulerBase::SchedStats::HIST_BUCKETS; ++j) {
+            ptr->add_queue_depth_histogram(stats.queueDepthHist[j]);
+            ptr->add_time_in_queue_histogram(stats.timeInQHist[j]);
+        }
+    }
+
+    _frameBuf.serialize(reply);
+    std::string str(_frameBuf.data(), _frameBuf.size());
+    _sendChannel->sendStream(xrdsvc::StreamBuffer::createWithMove(str), true);
+}
+
+}}} // namespace lsst::qserv::wpublish
@@ -0,0 +1,94 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2011-2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+/// GetSchedulerStatsCommand.h
+#ifndef LSST_QSERV_WPUBLISH_GET_SCHEDULER_STATS_COMMAND_H
+#define LSST_QSERV_WPUBLISH_GET_SCHEDULER_STATS_COMMAND_H
+
+// System headers
+#include <memory>
+
+// Qserv headers
+#include "wbase/WorkerCommand.h"
+
+// Forward declarations
+namespace lsst {
+namespace qserv {
+namespace wsched {
+class BlendScheduler;
+}}}
+
+namespace lsst {
+namespace qserv {
+namespace wpublish {
+
+/**
+  * Class GetSchedulerStatsCommand returns the statistics counters of
+  * the task schedulers
+  */
+class GetSchedulerStatsCommand
+    :   public wbase::WorkerCommand {
+
+public:
+
+    // The default construction and copy semantics are prohibited
+    GetSchedulerStatsCommand() = delete;
+    GetSchedulerStatsCommand& operator=(GetSchedulerStatsCommand const&) = delete;
+    GetSchedulerStatsCommand(GetSchedulerStatsCommand const&) = delete;
+
+    /// The destructor
+    ~GetSchedulerStatsCommand() override = default;
+
+    /**
+     * The normal constructor of the class
+     *
+     * @param sendChannel    - communication channel for reporting results
+     * @param blendScheduler - top-level scheduler whose sub-schedulers are reported
+     */
+    GetSchedulerStatsCommand(std::shared_ptr<wbase::SendChannel>     const& sendChannel,
+                             std::shared_ptr<wsched::BlendScheduler> const& blendScheduler);
+
+    /**
+     * Implement the corresponding method of the base class
+     *
+     * @see WorkerCommand::run()
+     */
+    void run() override;
+
+private:
+
+    /**
+     * Report error condition to the logging stream and reply back to
+     * a service caller.
+     *
+     * @param message - message to be reported
+     */
+    void reportError(std::string const& message);
+
+private:
+
+    std::shared_ptr<wsched::BlendScheduler> _blendScheduler;
+};
+
+}}} // namespace lsst::qserv::wpublish
+
+#endif // LSST_QSERV_WPUBLISH_GET_SCHEDULER_STATS_COMMAND_H
@@ -0,0 +1,146 @@
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "wpublish/GetSchedulerStatsQservRequest.h"
+
+// System headers
+#include <stdexcept>
+#include <string>
+
+// Qserv headers
+#include "lsst/log/Log.h"
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.wpublish.GetSchedulerStatsQservRequest");
+
+using namespace lsst::qserv;
+
+wpublish::GetSchedulerStatsQservRequest::Status translate(
+        proto::WorkerCommandGetSchedulerStatsR::Status status) {
+    switch (status) {
+        case proto::WorkerCommandGetSchedulerStatsR::SUCCESS:
+            return wpublish::GetSchedulerStatsQservRequest::SUCCESS;
+        case proto::WorkerCommandGetSchedulerStatsR::ERROR:
+            return wpublish::GetSchedulerStatsQservRequest::ERROR;
+    }
+    throw std::domain_error(
+            "GetSchedulerStatsQservRequest::translate  no match for Protobuf status: " +
+            proto::WorkerCommandGetSchedulerStatsR_Status_Name(status));
+}
+}  // namespace
+
+namespace lsst {
+namespace qserv {
+namespace wpublish {
+
+std::string GetSchedulerStatsQservRequest::status2str(Status status) {
+    switch (status) {
+        case SUCCESS: return "SUCCESS";
+        case ERROR:   return "ERROR";
+    }
+    throw std::domain_error(
+            "GetSchedulerStatsQservRequest::status2str  no match for status: " +
+            std::to_string(status));
+}
+
+GetSchedulerStatsQservRequest::Ptr GetSchedulerStatsQservRequest::create(
+                                        GetSchedulerStatsQservRequest::CallbackType onFinish) {
+    return GetSchedulerStatsQservRequest::Ptr(new GetSchedulerStatsQservRequest(
+        onFinish
+    ));
+}
+
+GetSchedulerStatsQservRequest::GetSchedulerStatsQservRequest(
+                                        GetSchedulerStatsQservRequest::CallbackType onFinish)
+    :   _onFinish(onFinish) {
+
+    LOGS(_log, LOG_LVL_DEBUG, "GetSchedulerStatsQservRequest  ** CONSTRUCTED **");
+}
+
+GetSchedulerStatsQservRequest::~GetSchedulerStatsQservRequest() {
+    LOGS(_log, LOG_LVL_DEBUG, "GetSchedulerStatsQservRequest  ** DELETED **");
+}
+
+void GetSchedulerStatsQservRequest::onRequest(proto::FrameBuffer& buf) {
+
+    proto::WorkerCommandH header;
+    header.set_command(proto::WorkerCommandH::GET_SCHEDULER_STATS);
+    buf.serialize(header);
+}
+
+void GetSchedulerStatsQservRequest::onResponse(proto::FrameBufferView& view) {
+
+    static std::string const context = "GetSchedulerStatsQservRequest  ";
+
+    proto::WorkerCommandGetSchedulerStatsR reply;
+    view.parse(reply);
+
+    LOGS(_log, LOG_LVL_DEBUG, context << "** SERVICE REPLY **  status: "
+         << proto::WorkerCommandGetSchedulerStatsR_Status_Name(reply.status()));
+
+    SchedulerStatsCollection schedulers;
+
+    if (reply.status() == proto::WorkerCommandGetSchedulerStatsR::SUCCESS) {
+
+        int const num = reply.scheduler_size();
+        for (int i = 0; i < num; i++) {
+            proto::WorkerCommandSchedulerStats const& entry = reply.scheduler(i);
+            SchedulerStats stats;
+            stats.name             = entry.name();
+            stats.in_flight        = entry.in_flight();
+            stats.tasks_queued     = entry.tasks_queued();
+            stats.tasks_started    = entry.tasks_started();
+            stats.tasks_completed  = entry.tasks_completed();
+            stats.time_in_queue_ms = entry.time_in_queue_ms();
+            stats.bytes_locked     = entry.bytes_locked();
+            for (int j = 0; j < entry.queue_depth_histogram_size(); j++) {
+                stats.queue_depth_histogram.push_back(entry.queue_depth_histogram(j));
+            }
+            for (int j = 0; j < entry.time_in_queue_histogram_size(); j++) {
+                stats.time_in_queue_histogram.push_back(entry.time_in_queue_histogram(j));
+            }
+            schedulers.push_back(stats);
+        }
+        LOGS(_log, LOG_LVL_DEBUG, context << "total schedulers: " << num);
+    }
+
+    if (_onFinish) {
+        _onFinish(
+            ::translate(reply.status()),
+            reply.error(),
+            schedulers);
+    }
+}
+
+void GetSchedulerStatsQservRequest::onError(std::string const& error) {
+
+    if (_onFinish) {
+        _onFinish(
+            Status::ERROR,
+            error,
+            SchedulerStatsCollection());
+    }
+}
+
+}}} // namespace lsst::qserv::wpublish
@@ -0,0 +1,139 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2011-2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+/// GetSchedulerStatsQservRequest.h
+#ifndef LSST_QSERV_WPUBLISH_GET_SCHEDULER_STATS_QSERV_REQUEST_H
+#define LSST_QSERV_WPUBLISH_GET_SCHEDULER_STATS_QSERV_REQUEST_H
+
+// System headers
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <vector>
+
+// Third party headers
+
+// Qserv headers
+#include "wpublish/QservRequest.h"
+
+// Forward declarations
+
+namespace lsst {
+namespace qserv {
+namespace wpublish {
+
+/**
+  * Class GetSchedulerStatsQservRequest implements the client-side requests
+  * the Qserv worker services for the statistics counters of its task
+  * schedulers.
+  */
+class GetSchedulerStatsQservRequest
+    :    public QservRequest {
+
+public:
+
+    /// Completion status of the operation
+    enum Status {
+        SUCCESS,    // successful completion of a request
+        ERROR       // an error occured during command execution
+    };
+
+    /// @return string representation of a status
+    static std::string status2str (Status status);
+
+    /// Struct SchedulerStats a value type encapsulating the statistics
+    /// counters of one scheduler. The histograms share logarithmic bucket
+    /// bounds: bucket N counts values in [10^N, 10^(N+1)), except the first
+    /// bucket which starts at 0 and the last which is unbounded above.
+    struct SchedulerStats {
+        std::string   name;
+        unsigned int  in_flight;
+        std::uint64_t tasks_queued;
+        std::uint64_t tasks_started;
+        std::uint64_t tasks_completed;
+        std::uint64_t time_in_queue_ms;
+        std::uint64_t bytes_locked;
+        std::vector<std::uint64_t> queue_depth_histogram;
+        std::vector<std::uint64_t> time_in_queue_histogram;
+    };
+
+    /// The SchedulerStatsCollection type represents a collection of schedulers
+    using SchedulerStatsCollection = std::list<SchedulerStats>;
+
+    /// The pointer type for instances of the class
+    typedef std::shared_ptr<GetSchedulerStatsQservRequest> Ptr;
+
+    /// The callback function type to be used for notifications on
+    /// the operation completion.
+    using CallbackType =
+        std::function<void(Status,                              // completion status
+                           std::string const&,                  // error message
+                           SchedulerStatsCollection const&)>;   // schedulers (if success)
+
+    /**
+     * Static factory method is needed to prevent issues with the lifespan
+     * and memory management of instances created otherwise (as values or via
+     * low-level pointers).
+     *
+     * @param onFinish - optional callback function to be called upon the completion
+     *                   (successful or not) of the request.
+     * @return smart pointer to the object of the class
+     */
+    static Ptr create(CallbackType onFinish = nullptr);
+
+    // Default construction and copy semantics are prohibited
+    GetSchedulerStatsQservRequest(GetSchedulerStatsQservRequest const&) = delete;
+    GetSchedulerStatsQservRequest& operator=(GetSchedulerStatsQservRequest const&) = delete;
+
+    /// Destructor
+    ~GetSchedulerStatsQservRequest() override;
+
+protected:
+
+    /**
+     * Normal constructor
+     *
+     * @param onFinish - optional callback function to be called upon the completion
+     *                   (successful or not) of the request.
+     */
+    explicit GetSchedulerStatsQservRequest(CallbackType onFinish);
+
+    /// Implement the corresponding method of the base class
+    void onRequest(proto::FrameBuffer& buf) override;
+
+    /// Implement the corresponding method of the base class
+    void onResponse(proto::FrameBufferView& view) override;
+
+    /// Implement the corresponding method of the base class
+    void onError(std::string const& error) override;
+
+private:
+
+    /// Optional callback function to be called upon the completion
+    /// (successfull or not) of the request.
+    CallbackType _onFinish;
+};
+
+}}} // namespace lsst::qserv::wpublish
+
+#endif // LSST_QSERV_WPUBLISH_GET_SCHEDULER_STATS_QSERV_REQUEST_H
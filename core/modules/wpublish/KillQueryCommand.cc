@@ -0,0 +1,94 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "wpublish/KillQueryCommand.h"
+
+// System headers
+
+// Third-party headers
+
+// LSST headers
+#include "lsst/log/Log.h"
+#include "proto/worker.pb.h"
+#include "wbase/SendChannel.h"
+#include "wsched/BlendScheduler.h"
+
+// Qserv headers
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.wpublish.KillQueryCommand");
+
+} // annonymous namespace
+
+namespace lsst {
+namespace qserv {
+namespace wpublish {
+
+KillQueryCommand::KillQueryCommand(
+                        std::shared_ptr<wbase::SendChannel>     const& sendChannel,
+                        std::shared_ptr<wsched::BlendScheduler> const& blendScheduler,
+                        QueryId queryId)
+    :   wbase::WorkerCommand(sendChannel),
+        _blendScheduler(blendScheduler),
+        _queryId(queryId) {
+}
+
+void KillQueryCommand::reportError(std::string const& message) {
+
+    LOGS(_log, LOG_LVL_ERROR, "KillQueryCommand::run  " << message);
+
+    proto::WorkerCommandKillQueryR reply;
+
+    reply.set_status(proto::WorkerCommandKillQueryR::ERROR);
+    reply.set_error(message);
+    reply.set_cancelled(0);
+
+    _frameBuf.serialize(reply);
+    std::string str(_frameBuf.data(), _frameBuf.size());
+    _sendChannel->sendStream(xrdsvc::StreamBuffer::createWithMove(str), true);
+}
+
+void KillQueryCommand::run() {
+
+    LOGS(_log, LOG_LVL_INFO, "KillQueryCommand::run "
+         << QueryIdHelper::makeIdStr(_queryId));
+
+    if (_blendScheduler == nullptr) {
+        reportError("no scheduler is attached to this service");
+        return;
+    }
+
+    int const cancelled = _blendScheduler->killUserQuery(_queryId);
+
+    proto::WorkerCommandKillQueryR reply;
+    reply.set_status(proto::WorkerCommandKillQueryR::SUCCESS);
+    reply.set_cancelled(cancelled);
+
+    _frameBuf.serialize(reply);
+    std::string str(_frameBuf.data(), _frameBuf.size());
+    _sendChannel->sendStream(xrdsvc::StreamBuffer::createWithMove(str), true);
+}
+
+}}} // namespace lsst::qserv::wpublish
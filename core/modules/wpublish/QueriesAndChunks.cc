@@ -59,9 +59,21 @@ QueriesAndChunks::QueriesAndChunks(std::chrono::seconds deadAfter,
     }
 
     auto rExamine = [this](){
+        // Instead of examining every query in one pass, examine one shard of
+        // the queries per wakeup so that the work (and the lock contention it
+        // causes) is amortized over the examine interval. Each shard is still
+        // visited once per _examineAfter.
+        auto const sliceTime =
+            std::chrono::duration_cast<std::chrono::milliseconds>(_examineAfter)/_numShards;
+        unsigned int shard = 0;
+        ScanTableSumsMap scanTblSums;
         while (_loopExamine) {
-            std::this_thread::sleep_for(_examineAfter);
-            if (_loopExamine) examineAll();
+            std::this_thread::sleep_for(sliceTime);
+            if (!_loopExamine) break;
+            // Refresh the table/chunk timing totals once per full sweep.
+            if (shard == 0) scanTblSums = _calcScanTableSums();
+            _examineShard(shard, scanTblSums);
+            shard = (shard + 1) % _numShards;
         }
     };
     std::thread te(rExamine);
@@ -93,12 +105,13 @@ void QueriesAndChunks::setRequiredTasksCompleted(unsigned int value) {
 /// Add statistics for the Task, creating a QueryStatistics object if needed.
 void QueriesAndChunks::addTask(wbase::Task::Ptr const& task) {
     auto qid = task->getQueryId();
-    std::unique_lock<std::mutex> guardStats(_queryStatsMtx);
-    auto itr = _queryStats.find(qid);
+    auto& shard = _getShard(qid);
+    std::unique_lock<std::mutex> guardStats(shard.mtx);
+    auto itr = shard.queryStats.find(qid);
     QueryStatistics::Ptr stats;
-    if (_queryStats.end() == itr) {
+    if (shard.queryStats.end() == itr) {
         stats = std::make_shared<QueryStatistics>(qid);
-        _queryStats[qid] = stats;
+        shard.queryStats[qid] = stats;
     } else {
         stats = itr->second;
     }
@@ -151,6 +164,13 @@ void QueriesAndChunks::finishedTask(wbase::Task::Ptr const& task) {
             stats->_tasksRunning -= 1;
             stats->_tasksCompleted += 1;
             stats->_totalTimeMinutes += taskDuration;
+            // Decayed per-chunk speed estimate; weighted toward history just
+            // enough that one odd chunk does not flip the query's tier.
+            if (stats->_tasksCompleted == 1) {
+                stats->_avgTaskMinutes = taskDuration;
+            } else {
+                stats->_avgTaskMinutes = (3.0*stats->_avgTaskMinutes + taskDuration)/4.0;
+            }
             mostlyDead = stats->_isMostlyDead();
         }
         if (mostlyDead) {
@@ -173,10 +193,10 @@ void QueriesAndChunks::_finishedTaskForChunk(wbase::Task::Ptr const& task, doubl
     }
     ul.unlock();
     auto iter = res.first->second;
-    proto::ScanInfo& scanInfo = task->getScanInfo();
+    proto::ScanInfo const& scanInfo = task->getScanInfo();
     std::string tblName;
     if (!scanInfo.infoTables.empty()) {
-        proto::ScanTableInfo& sti = scanInfo.infoTables.at(0);
+        proto::ScanTableInfo const& sti = scanInfo.infoTables.at(0);
         tblName = ChunkTableStats::makeTableName(sti.db, sti.table);
     }
     ChunkTableStats::Ptr tableStats = iter->add(tblName, minutes);
@@ -223,22 +243,24 @@ void QueriesAndChunks::removeDead() {
 
 /// Remove a statistics for a user query.
 /// Query Ids should be unique for the life of the system, so erasing
-/// a qId multiple times from _queryStats should be harmless.
+/// a qId multiple times from the statistics should be harmless.
 void QueriesAndChunks::removeDead(QueryStatistics::Ptr const& queryStats) {
     std::unique_lock<std::mutex> gS(queryStats->_qStatsMtx);
     QueryId qId = queryStats->_queryId;
     gS.unlock();
     LOGS(_log, LOG_LVL_DEBUG, QueryIdHelper::makeIdStr(qId) << " Queries::removeDead");
 
-    std::lock_guard<std::mutex> gQ(_queryStatsMtx);
-    _queryStats.erase(qId);
+    auto& shard = _getShard(qId);
+    std::lock_guard<std::mutex> gQ(shard.mtx);
+    shard.queryStats.erase(qId);
 }
 
 /// @return the statistics for a user query.
 QueryStatistics::Ptr QueriesAndChunks::getStats(QueryId const& qId) const {
-    std::lock_guard<std::mutex> g(_queryStatsMtx);
-    auto iter = _queryStats.find(qId);
-    if (iter != _queryStats.end()) {
+    auto& shard = _getShard(qId);
+    std::lock_guard<std::mutex> g(shard.mtx);
+    auto iter = shard.queryStats.find(qId);
+    if (iter != shard.queryStats.end()) {
         return iter->second;
     }
     return nullptr;
@@ -253,12 +275,24 @@ void QueriesAndChunks::examineAll() {
     // in each chunk, and their percentage total of the whole.
     auto scanTblSums = _calcScanTableSums();
 
-    // Copy a vector of the Queries in the map and work with the copy
+    for (unsigned int shard = 0; shard < _numShards; ++shard) {
+        _examineShard(shard, scanTblSums);
+    }
+    LOGS(_log, LOG_LVL_DEBUG, "QueriesAndChunks::examineAll end");
+}
+
+
+/// Examine the running Tasks of the queries within one shard of the statistics.
+/// The full examine pass over the queries is amortized by visiting the shards
+/// one at a time (see the examine thread in the constructor).
+void QueriesAndChunks::_examineShard(unsigned int shard, ScanTableSumsMap& scanTblSums) {
+    // Copy a vector of the Queries in the shard and work with the copy
     // to free up the mutex.
     std::vector<QueryStatistics::Ptr> uqs;
     {
-        std::lock_guard<std::mutex> g(_queryStatsMtx);
-        for (auto const& ele : _queryStats) {
+        auto& queryShard = _queryShards[shard];
+        std::lock_guard<std::mutex> g(queryShard.mtx);
+        for (auto const& ele : queryShard.queryStats) {
             auto const q = ele.second;
             uqs.push_back(q);
         }
@@ -321,8 +355,92 @@ void QueriesAndChunks::examineAll() {
                 }
             }
         }
+
+        _checkTier(uq, scanTblSums);
+    }
+}
+
+
+/// Continuous scan-speed classification. The czar's scanRating only predicts
+/// a query's speed; this checks the observed speed once a few chunks have
+/// completed and moves the query's queued Tasks to the tier whose time limit
+/// it actually fits, instead of leaving a mis-rated query on the wrong
+/// scheduler until it is booted.
+void QueriesAndChunks::_checkTier(QueryStatistics::Ptr const& uq, ScanTableSumsMap& scanTblSums) {
+    auto bSched = _blendSched.lock();
+    if (bSched == nullptr || uq->getQueryBooted()) {
+        return;
+    }
+
+    // Estimates from fewer chunks say more about the chunks than the query.
+    int const minTasksForTier = 4;
+
+    // Find a queued Task to learn the query's current scheduler and scan table;
+    // only queued Tasks move, so a running Task's scheduler may be stale.
+    wbase::Task::Ptr task;
+    std::shared_ptr<wsched::ScanScheduler> sched;
+    int completed = 0;
+    double avgMinutes = 0.0;
+    {
+        std::lock_guard<std::mutex> lock(uq->_qStatsMtx);
+        completed = uq->_tasksCompleted;
+        avgMinutes = uq->_avgTaskMinutes;
+        for (auto const& ele : uq->_taskMap) {
+            if (ele.second->getState() != wbase::Task::State::QUEUED) {
+                continue;
+            }
+            auto sc = std::dynamic_pointer_cast<wsched::ScanScheduler>(ele.second->getTaskScheduler());
+            if (sc != nullptr) {
+                task = ele.second;
+                sched = sc;
+                break;
+            }
+        }
+    }
+    if (task == nullptr || completed < minTasksForTier) {
+        return;
+    }
+    if (bSched->isScanSnail(sched)) {
+        return; // Queries only leave the snail tier by finishing.
+    }
+
+    auto begin = task->getScanInfo().infoTables.begin();
+    if (begin == task->getScanInfo().infoTables.end()) {
+        return;
+    }
+    std::string const slowestTable = begin->db + ":" + begin->table;
+    auto iterTbl = scanTblSums.find(slowestTable);
+    if (iterTbl == scanTblSums.end()) {
+        return;
+    }
+    std::size_t const numChunks = iterTbl->second.chunkPercentages.size();
+    if (numChunks == 0) {
+        return;
+    }
+    // A tier's time limit covers a whole scan of the table; one chunk's even
+    // share of it is the per-chunk budget for that tier.
+    double const perChunkShare = 1.0/numChunks;
+
+    if (avgMinutes > perChunkShare*sched->getMaxTimeMinutes()) {
+        auto slower = bSched->getSlowerScanSched(sched);
+        if (slower != nullptr) {
+            LOGS(_log, LOG_LVL_INFO, QueryIdHelper::makeIdStr(uq->_queryId)
+                 << " demoting from " << sched->getName() << " to " << slower->getName()
+                 << " avgTaskMinutes=" << avgMinutes);
+            bSched->moveUserQuery(uq->_queryId, sched, slower);
+        }
+        return;
+    }
+
+    auto faster = bSched->getFasterScanSched(sched);
+    // Promote only with 2x headroom in the faster tier so queries near a
+    // boundary do not ping-pong between schedulers.
+    if (faster != nullptr && avgMinutes < 0.5*perChunkShare*faster->getMaxTimeMinutes()) {
+        LOGS(_log, LOG_LVL_INFO, QueryIdHelper::makeIdStr(uq->_queryId)
+             << " promoting from " << sched->getName() << " to " << faster->getName()
+             << " avgTaskMinutes=" << avgMinutes);
+        bSched->moveUserQuery(uq->_queryId, sched, faster);
     }
-    LOGS(_log, LOG_LVL_DEBUG, "QueriesAndChunks::examineAll end");
 }
 
 
@@ -466,9 +584,10 @@ QueriesAndChunks::removeQueryFrom(QueryId const& qId, wsched::SchedulerBase::Ptr
     std::vector<wbase::Task::Ptr> removedList; // Return value;
 
     // Find the user query.
-    std::unique_lock<std::mutex> lock(_queryStatsMtx);
-    auto query = _queryStats.find(qId);
-    if (query == _queryStats.end()) {
+    auto& shard = _getShard(qId);
+    std::unique_lock<std::mutex> lock(shard.mtx);
+    auto query = shard.queryStats.find(qId);
+    if (query == shard.queryStats.end()) {
         LOGS(_log, LOG_LVL_DEBUG, QueryIdHelper::makeIdStr(qId) << " was not found by removeQueryFrom");
         return removedList;
     }
@@ -513,6 +632,44 @@ QueriesAndChunks::removeQueryFrom(QueryId const& qId, wsched::SchedulerBase::Ptr
 }
 
 
+/// Cancel all Tasks of the user query 'qId'. The queued Tasks are swept off
+/// their schedulers first, so that cancelling the running Tasks below does
+/// not just pull their queued siblings into the run slots. Task::cancel()
+/// is harmless when repeated, so the overlap between the two passes is fine.
+int QueriesAndChunks::cancelQuery(QueryId const& qId) {
+    auto removed = removeQueryFrom(qId, nullptr);
+    for (auto const& task : removed) {
+        task->cancel();
+    }
+
+    // Now cancel every Task the query still tracks - mostly the running
+    // ones, whose mysqld statements are killed through the TaskQueryRunner.
+    std::vector<wbase::Task::Ptr> taskList;
+    {
+        auto& shard = _getShard(qId);
+        std::unique_lock<std::mutex> lock(shard.mtx);
+        auto query = shard.queryStats.find(qId);
+        if (query == shard.queryStats.end()) {
+            LOGS(_log, LOG_LVL_DEBUG, QueryIdHelper::makeIdStr(qId)
+                 << " was not found by cancelQuery");
+            return 0;
+        }
+        auto const stats = query->second;
+        lock.unlock();
+        std::lock_guard<std::mutex> taskLock(stats->_qStatsMtx);
+        for (auto const& elem : stats->_taskMap) {
+            taskList.push_back(elem.second);
+        }
+    }
+    for (auto const& task : taskList) {
+        task->cancel();
+    }
+    LOGS(_log, LOG_LVL_INFO, QueryIdHelper::makeIdStr(qId) << " cancelQuery cancelled "
+         << taskList.size() << " tasks, " << removed.size() << " of them queued");
+    return taskList.size();
+}
+
+
 std::ostream& operator<<(std::ostream& os, QueriesAndChunks const& qc) {
     std::lock_guard<std::mutex> g(qc._chunkMtx);
     os << "Chunks(";
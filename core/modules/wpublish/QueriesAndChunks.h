@@ -25,6 +25,8 @@
 #define LSST_QSERV_WPUBLISH_QUERIESANDCHUNKS_H
 
 // System headers
+#include <array>
+#include <unordered_map>
 
 // Qserv headers
 #include "wbase/Task.h"
@@ -77,6 +79,9 @@ private:
     std::atomic<bool> _queryBooted{false}; ///< True when the entire query booted.
 
     double _totalTimeMinutes{0.0};
+    /// Exponentially decayed minutes per completed Task, the query's online
+    /// speed estimate used to promote/demote it between scan tiers.
+    double _avgTaskMinutes{0.0};
 
     std::map<int, wbase::Task::Ptr> _taskMap; ///< Map of Tasks keyed by job id.
 };
@@ -157,6 +162,12 @@ public:
 
     std::vector<wbase::Task::Ptr> removeQueryFrom(QueryId const& qId,
                    std::shared_ptr<wsched::SchedulerBase> const& sched);
+
+    /// Cancel all Tasks of user query 'qId': queued Tasks are swept off
+    /// their schedulers so they never start, and running Tasks get their
+    /// mysqld statements killed through their TaskQueryRunner.
+    /// @return the number of Tasks cancelled.
+    int cancelQuery(QueryId const& qId);
     void removeDead();
     void removeDead(QueryStatistics::Ptr const& queryStats);
 
@@ -189,10 +200,32 @@ private:
     void _bootTask(QueryStatistics::Ptr const& uq, wbase::Task::Ptr const& task,
                        std::shared_ptr<wsched::SchedulerBase> const& sched);
     ScanTableSumsMap _calcScanTableSums();
+    void _examineShard(unsigned int shard, ScanTableSumsMap& scanTblSums);
     void _finishedTaskForChunk(wbase::Task::Ptr const& task, double minutes);
 
-    mutable std::mutex _queryStatsMtx; ///< protects _queryStats;
-    std::map<QueryId, QueryStatistics::Ptr> _queryStats; ///< Map of Query stats indexed by QueryId.
+    /// Compare the query's decayed minutes-per-chunk estimate against the
+    /// per-chunk share of the scan tiers' time limits and move its queued
+    /// Tasks up or down one tier when it is clearly in the wrong one.
+    void _checkTier(QueryStatistics::Ptr const& uq, ScanTableSumsMap& scanTblSums);
+
+    /// A shard of the user query statistics. The statistics are sharded by
+    /// QueryId so threads working on different queries rarely contend on the
+    /// same mutex, and so the examiner can sweep the queries one shard at
+    /// a time instead of walking everything in a single pass.
+    struct QueryShard {
+        std::mutex mtx; ///< protects queryStats
+        std::unordered_map<QueryId, QueryStatistics::Ptr> queryStats; ///< Query stats indexed by QueryId.
+    };
+
+    /// Number of shards the query statistics are split into.
+    static unsigned int const _numShards{16};
+
+    mutable std::array<QueryShard, _numShards> _queryShards;
+
+    /// @return the shard that owns the statistics for query 'qId'.
+    QueryShard& _getShard(QueryId const& qId) const {
+        return _queryShards[qId % _numShards];
+    }
 
     mutable std::mutex _chunkMtx;
     std::map<int, ChunkStatistics::Ptr> _chunkStats;///< Map of Chunk stats indexed by chunk id.
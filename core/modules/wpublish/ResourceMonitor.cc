@@ -32,9 +32,6 @@
 // Qserv headers
 #include "global/ResourceUnit.h"
 
-// This macro to appear witin each block which requires thread safety
-#define LOCK_GUARD std::lock_guard<std::mutex> lock(_mtx)
-
 namespace {
 
 LOG_LOGGER _log = LOG_GET("lsst.qserv.wpublish.ResourceMonitor");
@@ -45,26 +42,25 @@ namespace lsst {
 namespace qserv {
 namespace wpublish {
 
-void ResourceMonitor::increment(std::string const& resource) {
-
-    LOCK_GUARD;
+size_t const ResourceMonitor::_numShards;
 
-    _resourceCounter[resource]++;
+void ResourceMonitor::increment(std::string const& resource) {
+    entry(resource).numStarted.fetch_add(1, std::memory_order_relaxed);
+    _epoch.fetch_add(1, std::memory_order_release);
 }
 
 void ResourceMonitor::decrement(std::string const& resource) {
-
-    LOCK_GUARD;
-
-    if (not _resourceCounter.count(resource)) return;
-    if (not --(_resourceCounter[resource])) _resourceCounter.erase(resource);
+    Entry* e = findEntry(resource);
+    if (e == nullptr) return;
+    e->numFinished.fetch_add(1, std::memory_order_relaxed);
+    _epoch.fetch_add(1, std::memory_order_release);
 }
 
 unsigned int ResourceMonitor::count(std::string const& resource) const {
-
-    LOCK_GUARD;
-
-    return _resourceCounter.count(resource) ? _resourceCounter.at(resource) : 0;
+    Entry const* e = findEntry(resource);
+    if (e == nullptr) return 0;
+    return e->numStarted.load(std::memory_order_relaxed) -
+           e->numFinished.load(std::memory_order_relaxed);
 }
 
 unsigned int ResourceMonitor::count(int chunk,
@@ -83,13 +79,91 @@ unsigned int ResourceMonitor::count(int chunk,
 
 ResourceMonitor::ResourceCounter ResourceMonitor::resourceCounter() const {
 
-    // Make a copy of the map while under protection of the lock guard.
+    // Harvest a snapshot of the in-use counters one shard at a time. Each
+    // shard mutex is held only for the duration of walking that shard's map,
+    // and the counter loads themselves don't block the concurrent updates.
+    // Resources which are not in use at the moment of the snapshot are
+    // omitted from the report.
+
+    ResourceCounter result;
+
+    for (auto&& shard: _shards) {
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        for (auto&& itr: shard.entries) {
+            unsigned int const inUse =
+                itr.second->numStarted.load( std::memory_order_relaxed) -
+                itr.second->numFinished.load(std::memory_order_relaxed);
+            if (inUse != 0) result[itr.first] = inUse;
+        }
+    }
+    return result;
+}
+
+ResourceMonitor::ResourceTotals ResourceMonitor::deltasSince(Cursor& cursor) const {
 
-    LOCK_GUARD;
+    ResourceTotals deltas;
 
-    ResourceCounter result = _resourceCounter;
-    
-    return result;
+    // Nothing changed since the last query? Then don't bother walking
+    // the counter table.
+
+    uint64_t const epoch = _epoch.load(std::memory_order_acquire);
+    if (epoch == cursor._epoch) return deltas;
+
+    for (auto&& shard: _shards) {
+        std::lock_guard<std::mutex> lock(shard.mtx);
+        for (auto&& itr: shard.entries) {
+
+            Totals totals;
+            totals.numStarted  = itr.second->numStarted.load( std::memory_order_relaxed);
+            totals.numFinished = itr.second->numFinished.load(std::memory_order_relaxed);
+
+            Totals const& lastSeen = cursor._lastSeen[itr.first];
+            if ((totals.numStarted  != lastSeen.numStarted) or
+                (totals.numFinished != lastSeen.numFinished)) {
+
+                Totals& delta = deltas[itr.first];
+                delta.numStarted  = totals.numStarted  - lastSeen.numStarted;
+                delta.numFinished = totals.numFinished - lastSeen.numFinished;
+
+                cursor._lastSeen[itr.first] = totals;
+            }
+        }
+    }
+    cursor._epoch = epoch;
+
+    return deltas;
+}
+
+ResourceMonitor::Entry& ResourceMonitor::entry(std::string const& resource) {
+
+    Shard& shard = _shards[shardIdx(resource)];
+
+    std::lock_guard<std::mutex> lock(shard.mtx);
+
+    auto itr = shard.entries.find(resource);
+    if (itr == shard.entries.end()) {
+        itr = shard.entries.emplace(resource,
+                                    std::unique_ptr<Entry>(new Entry())).first;
+    }
+    return *(itr->second);
 }
 
-}}} // namespace lsst::qserv::wpublish
\ No newline at end of file
+ResourceMonitor::Entry const* ResourceMonitor::findEntry(std::string const& resource) const {
+
+    Shard const& shard = _shards[shardIdx(resource)];
+
+    std::lock_guard<std::mutex> lock(shard.mtx);
+
+    auto const itr = shard.entries.find(resource);
+    return itr == shard.entries.end() ? nullptr : itr->second.get();
+}
+
+ResourceMonitor::Entry* ResourceMonitor::findEntry(std::string const& resource) {
+
+    Shard& shard = _shards[shardIdx(resource)];
+
+    std::lock_guard<std::mutex> lock(shard.mtx);
+
+    auto const itr = shard.entries.find(resource);
+    return itr == shard.entries.end() ? nullptr : itr->second.get();
+}
@@ -25,7 +25,12 @@
 #define LSST_QSERV_WPUBLISH_RESOURCE_MONITOR_H
 
 // System headers
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <functional>
 #include <map>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <vector>
@@ -41,6 +46,14 @@ namespace wpublish {
 /**
   * Class ResourceMonitor is a thread-safe implementation for a counter of resources
   * which are in use at any givem moment by the application.
+  *
+  * The counter table is sharded by a hash of the resource name, and each
+  * resource is represented by a pair of monotonically growing atomic counters
+  * (uses started, uses finished). A shard mutex is held only while locating
+  * (or registering) a resource entry in the shard's map. The counter updates
+  * themselves are atomic operations, so the request start/finish reporting
+  * doesn't contend with the monitoring scrapes which take snapshots of
+  * the counters.
   */
 class ResourceMonitor {
 
@@ -50,6 +63,36 @@ public:
     /// of each resource.
     using ResourceCounter = std::map<std::string, unsigned int>;
 
+    /// Monotonic totals of uses of a single resource. Unlike the in-use
+    /// counters reported via method resourceCounter(), the totals never
+    /// decrease, which makes them suitable for computing rates.
+    struct Totals {
+        uint64_t numStarted  = 0;   ///< the number of uses started
+        uint64_t numFinished = 0;   ///< the number of uses finished
+    };
+
+    /// The map of the monotonic totals (by resource name) reported by
+    /// the bulk query method deltasSince().
+    using ResourceTotals = std::map<std::string, Totals>;
+
+    /**
+     * Class Cursor stores the position of a caller in the stream of counter
+     * updates. A monitoring client keeps its cursor between the calls to
+     * method deltasSince() to receive only the changes accumulated since
+     * the previous call.
+     */
+    class Cursor {
+    public:
+        friend class ResourceMonitor;
+        Cursor() = default;
+    private:
+        /// The value of the monitor's epoch at the last query
+        uint64_t _epoch = 0;
+
+        /// The totals seen at the last query (by resource name)
+        ResourceTotals _lastSeen;
+    };
+
     // The copy semantics is prohibited
     ResourceMonitor& operator=(ResourceMonitor const&) = delete;
     ResourceMonitor(ResourceMonitor const&) = delete;
@@ -96,7 +139,7 @@ public:
      *
      * ATTENTION: the method will return a sum of counters for all uses
      * of the chunk across all databases.
-     * 
+     *
      * @param chunk - chunk number
      * @param dbs   - names of database
      */
@@ -108,15 +151,76 @@ public:
      */
     ResourceCounter resourceCounter() const;
 
+    /**
+     * Return the changes in the monotonic usage totals accumulated since
+     * the previous call made with the same cursor, and advance the cursor.
+     * Only resources whose totals have changed are reported. The first call
+     * made with a fresh cursor reports the full totals.
+     *
+     * If no counter was updated since the previous call then the method
+     * returns an empty collection right away (based on the epoch number)
+     * without walking the counter table. This makes frequent monitoring
+     * scrapes of a mostly idle service essentially free.
+     *
+     * @param cursor - the position of a caller in the stream of updates
+     *
+     * @return the changes in the totals (by resource name)
+     */
+    ResourceTotals deltasSince(Cursor& cursor) const;
+
 private:
 
-    /// Number of uses for each resource
-    ResourceCounter _resourceCounter;
-    
-    /// Mutex for thread safaty 
-    mutable std::mutex _mtx;
+    /// Monotonic atomic counters of a single resource
+    struct Entry {
+        std::atomic<uint64_t> numStarted{0};
+        std::atomic<uint64_t> numFinished{0};
+    };
+
+    /// A shard of the counter table. Entries are allocated on the heap so
+    /// that the atomic counters stay put when the map rebalances.
+    struct Shard {
+        std::map<std::string, std::unique_ptr<Entry>> entries;
+        mutable std::mutex mtx;
+    };
+
+    /// The number of shards in the counter table
+    static size_t const _numShards = 16;
+
+    /// @return the index of a shard the resource belongs to
+    static size_t shardIdx(std::string const& resource) {
+        return std::hash<std::string>()(resource) % _numShards;
+    }
+
+    /**
+     * Locate the counter entry of a resource, registering the resource
+     * if it's not in the table yet.
+     *
+     * @param resource - name of a resource
+     */
+    Entry& entry(std::string const& resource);
+
+    /**
+     * Locate the counter entry of a resource
+     *
+     * @param resource - name of a resource
+     *
+     * @return pointer to the entry, or nullptr if the resource is not known
+     */
+    Entry const* findEntry(std::string const& resource) const;
+
+    /// The non-const counterpart of the above defined method
+    Entry* findEntry(std::string const& resource);
+
+private:
+
+    /// The sharded table of the resource counters
+    std::array<Shard, _numShards> _shards;
+
+    /// The number of counter updates made so far. The epoch allows the bulk
+    /// query method to skip walking the counter table when nothing changed.
+    std::atomic<uint64_t> _epoch{0};
 };
 
 }}} // namespace lsst::qserv::wpublish
 
-#endif // LSST_QSERV_WPUBLISH_RESOURCE_MONITOR_H
\ No newline at end of file
+#endif // LSST_QSERV_WPUBLISH_RESOURCE_MONITOR_H
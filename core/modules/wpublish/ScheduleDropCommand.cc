@@ -0,0 +1,95 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "wpublish/ScheduleDropCommand.h"
+
+// LSST headers
+#include "lsst/log/Log.h"
+#include "wbase/SendChannel.h"
+#include "wpublish/TableGc.h"
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.wpublish.ScheduleDropCommand");
+
+} // annonymous namespace
+
+namespace lsst {
+namespace qserv {
+namespace wpublish {
+
+ScheduleDropCommand::ScheduleDropCommand(std::shared_ptr<wbase::SendChannel> const& sendChannel,
+                                         std::shared_ptr<ResourceMonitor> const& resourceMonitor,
+                                         mysql::MySqlConfig const& mySqlConfig,
+                                         std::string const& db,
+                                         std::string const& table)
+    :   wbase::WorkerCommand(sendChannel),
+        _resourceMonitor(resourceMonitor),
+        _mySqlConfig(mySqlConfig),
+        _db(db),
+        _table(table) {
+}
+
+void ScheduleDropCommand::reportError(proto::WorkerCommandScheduleDropR::Status status,
+                                      std::string const& message) {
+
+    LOGS(_log, LOG_LVL_ERROR, "ScheduleDropCommand::reportError  " << message);
+
+    proto::WorkerCommandScheduleDropR reply;
+
+    reply.set_status(status);
+    reply.set_error(message);
+
+    _frameBuf.serialize(reply);
+    std::string str(_frameBuf.data(), _frameBuf.size());
+    _sendChannel->sendStream(xrdsvc::StreamBuffer::createWithMove(str), true);
+}
+
+void ScheduleDropCommand::run() {
+
+    LOGS(_log, LOG_LVL_DEBUG, "ScheduleDropCommand::run  db: " << _db
+         << ", table: " << _table);
+
+    if (_db.empty()) {
+        reportError(proto::WorkerCommandScheduleDropR::INVALID,
+                    "the database name was found empty");
+        return;
+    }
+
+    TableGc& gc = TableGc::instance();
+    gc.setup(_mySqlConfig, _resourceMonitor);
+
+    if (_table.empty()) gc.scheduleDatabase(_db);
+    else                gc.scheduleTable(_db, _table);
+
+    proto::WorkerCommandScheduleDropR reply;
+    reply.set_status(proto::WorkerCommandScheduleDropR::SUCCESS);
+    reply.set_pending(gc.pending());
+
+    _frameBuf.serialize(reply);
+    std::string str(_frameBuf.data(), _frameBuf.size());
+    _sendChannel->sendStream(xrdsvc::StreamBuffer::createWithMove(str), true);
+}
+
+}}} // namespace lsst::qserv::wpublish
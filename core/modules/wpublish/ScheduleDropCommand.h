@@ -0,0 +1,119 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+/// ScheduleDropCommand.h
+#ifndef LSST_QSERV_WPUBLISH_SCHEDULE_DROP_COMMAND_H
+#define LSST_QSERV_WPUBLISH_SCHEDULE_DROP_COMMAND_H
+
+// System headers
+#include <memory>
+#include <string>
+
+// Qserv headers
+#include "mysql/MySqlConfig.h"
+#include "proto/worker.pb.h"
+#include "wbase/WorkerCommand.h"
+
+// Forward declarations
+namespace lsst {
+namespace qserv {
+namespace wbase {
+class SendChannel;
+}
+namespace wpublish {
+class ResourceMonitor;
+}}}
+
+namespace lsst {
+namespace qserv {
+namespace wpublish {
+
+/**
+  * Class ScheduleDropCommand hands a database (or a single table of
+  * a database) over to the background garbage collector (TableGc) for
+  * deletion and reports back immediately. The actual deletion proceeds
+  * asynchronously, throttled against the scan load of the worker.
+  */
+class ScheduleDropCommand
+    :   public wbase::WorkerCommand {
+
+public:
+
+    // The default construction and copy semantics are prohibited
+    ScheduleDropCommand& operator=(ScheduleDropCommand const&) = delete;
+    ScheduleDropCommand(ScheduleDropCommand const&) = delete;
+    ScheduleDropCommand() = delete;
+
+    /**
+     * The normal constructor of the class
+     *
+     * @param sendChannel     - communication channel for reporting results
+     * @param resourceMonitor - counter of resources which are in use
+     * @param mySqlConfig     - database connection parameters
+     * @param db              - the name of a database to be deleted
+     * @param table           - the name of a table to be deleted; an empty
+     *                          value schedules the whole database
+     */
+    ScheduleDropCommand(std::shared_ptr<wbase::SendChannel> const& sendChannel,
+                        std::shared_ptr<ResourceMonitor> const& resourceMonitor,
+                        mysql::MySqlConfig const& mySqlConfig,
+                        std::string const& db,
+                        std::string const& table);
+
+    /// The destructor
+    ~ScheduleDropCommand() override = default;
+
+    /**
+     * Implement the corresponding method of the base class
+     *
+     * @see WorkerCommand::run()
+     */
+    void run() override;
+
+private:
+
+    /**
+     * Report error condition to the logging stream and reply back to
+     * a service caller.
+     *
+     * @param status  - error status
+     * @param message - message to be reported
+     */
+    void reportError(proto::WorkerCommandScheduleDropR::Status status,
+                     std::string const& message);
+
+    /// Counter of resources which are in use
+    std::shared_ptr<ResourceMonitor> _resourceMonitor;
+
+    /// Database connection parameters
+    mysql::MySqlConfig _mySqlConfig;
+
+    /// The name of a database to be deleted
+    std::string _db;
+
+    /// The name of a table to be deleted (empty for the whole database)
+    std::string _table;
+};
+
+}}} // namespace lsst::qserv::wpublish
+
+#endif // LSST_QSERV_WPUBLISH_SCHEDULE_DROP_COMMAND_H
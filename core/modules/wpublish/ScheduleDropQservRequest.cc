@@ -0,0 +1,130 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "wpublish/ScheduleDropQservRequest.h"
+
+// System headers
+#include <stdexcept>
+#include <string>
+
+// Qserv headers
+#include "lsst/log/Log.h"
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.wpublish.ScheduleDropQservRequest");
+
+using namespace lsst::qserv;
+
+wpublish::ScheduleDropQservRequest::Status translate(proto::WorkerCommandScheduleDropR::Status status) {
+    switch (status) {
+        case proto::WorkerCommandScheduleDropR::SUCCESS: return wpublish::ScheduleDropQservRequest::SUCCESS;
+        case proto::WorkerCommandScheduleDropR::INVALID: return wpublish::ScheduleDropQservRequest::INVALID;
+        case proto::WorkerCommandScheduleDropR::ERROR:   return wpublish::ScheduleDropQservRequest::ERROR;
+    }
+    throw std::domain_error(
+            "ScheduleDropQservRequest::translate  no match for Protobuf status: " +
+            proto::WorkerCommandScheduleDropR_Status_Name(status));
+}
+}  // namespace
+
+namespace lsst {
+namespace qserv {
+namespace wpublish {
+
+std::string ScheduleDropQservRequest::status2str(Status status) {
+    switch (status) {
+        case SUCCESS: return "SUCCESS";
+        case INVALID: return "INVALID";
+        case ERROR:   return "ERROR";
+    }
+    throw std::domain_error(
+            "ScheduleDropQservRequest::status2str  no match for status: " +
+            std::to_string(status));
+}
+
+ScheduleDropQservRequest::Ptr ScheduleDropQservRequest::create(
+                                    std::string const& db,
+                                    std::string const& table,
+                                    ScheduleDropQservRequest::CallbackType onFinish) {
+    return ScheduleDropQservRequest::Ptr(
+        new ScheduleDropQservRequest(db,
+                                     table,
+                                     onFinish));
+}
+
+ScheduleDropQservRequest::ScheduleDropQservRequest(
+                                    std::string const& db,
+                                    std::string const& table,
+                                    ScheduleDropQservRequest::CallbackType onFinish)
+    :   _db(db),
+        _table(table),
+        _onFinish(onFinish) {
+
+    LOGS(_log, LOG_LVL_DEBUG, "ScheduleDropQservRequest  ** CONSTRUCTED **");
+}
+
+ScheduleDropQservRequest::~ScheduleDropQservRequest() {
+    LOGS(_log, LOG_LVL_DEBUG, "ScheduleDropQservRequest  ** DELETED **");
+}
+
+void ScheduleDropQservRequest::onRequest(proto::FrameBuffer& buf) {
+
+    proto::WorkerCommandH header;
+    header.set_command(proto::WorkerCommandH::SCHEDULE_DROP);
+    buf.serialize(header);
+
+    proto::WorkerCommandScheduleDropM message;
+    message.set_db(_db);
+    message.set_table(_table);
+    buf.serialize(message);
+}
+
+void ScheduleDropQservRequest::onResponse(proto::FrameBufferView& view) {
+
+    proto::WorkerCommandScheduleDropR reply;
+    view.parse(reply);
+
+    LOGS(_log, LOG_LVL_DEBUG, "ScheduleDropQservRequest  ** SERVICE REPLY **  status: "
+         << proto::WorkerCommandScheduleDropR_Status_Name(reply.status()));
+
+    if (_onFinish) {
+        _onFinish(
+            ::translate(reply.status()),
+            reply.error(),
+            reply.pending());
+    }
+}
+
+void ScheduleDropQservRequest::onError(std::string const& error) {
+
+    if (_onFinish) {
+        _onFinish(
+            Status::ERROR,
+            error,
+            0);
+    }
+}
+
+}}} // namespace lsst::qserv::wpublish
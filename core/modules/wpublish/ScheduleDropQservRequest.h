@@ -0,0 +1,130 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+/// ScheduleDropQservRequest.h
+#ifndef LSST_QSERV_WPUBLISH_SCHEDULE_DROP_QSERV_REQUEST_H
+#define LSST_QSERV_WPUBLISH_SCHEDULE_DROP_QSERV_REQUEST_H
+
+// System headers
+#include <functional>
+#include <memory>
+#include <string>
+
+// Qserv headers
+#include "wpublish/QservRequest.h"
+
+namespace lsst {
+namespace qserv {
+namespace wpublish {
+
+/**
+  * Class ScheduleDropQservRequest schedules a database (or a single table
+  * of a database) for deletion by the background garbage collector of
+  * a worker. The request completes as soon as the work is queued.
+  */
+class ScheduleDropQservRequest
+    :    public QservRequest {
+
+public:
+
+    /// Completion status of the operation
+    enum Status {
+        SUCCESS,    // successful completion of a request
+        INVALID,    // invalid parameters of the request
+        ERROR       // an error occured during command execution
+    };
+
+    /// @return string representation of a status
+    static std::string status2str(Status status);
+
+    /// The pointer type for instances of the class
+    typedef std::shared_ptr<ScheduleDropQservRequest> Ptr;
+
+    /// The callback function type to be used for notifications on
+    /// the operation completion.
+    using CallbackType =
+        std::function<void(Status,                  // completion status
+                           std::string const&,      // error message
+                           unsigned int)>;          // the number of entries queued
+
+    /**
+     * Static factory method is needed to prevent issues with the lifespan
+     * and memory management of instances created otherwise (as values or via
+     * low-level pointers).
+     *
+     * @param db       - the name of a database to be deleted
+     * @param table    - the name of a table to be deleted; an empty value
+     *                   schedules the whole database
+     * @param onFinish - optional callback function to be called upon the completion
+     *                   (successful or not) of the request.
+     * @return smart pointer to the object of the class
+     */
+    static Ptr create(std::string const& db,
+                      std::string const& table,
+                      CallbackType onFinish = nullptr);
+
+    // Default construction and copy semantics is prohibited
+    ScheduleDropQservRequest() = delete;
+    ScheduleDropQservRequest(ScheduleDropQservRequest const&) = delete;
+    ScheduleDropQservRequest& operator=(ScheduleDropQservRequest const&) = delete;
+
+    /// Destructor
+    ~ScheduleDropQservRequest() override;
+
+protected:
+
+    /**
+     * Normal constructor
+     *
+     * @param db       - the name of a database to be deleted
+     * @param table    - the name of a table to be deleted (may be empty)
+     * @param onFinish - function to be called upon the completion of a request
+     */
+    ScheduleDropQservRequest(std::string const& db,
+                             std::string const& table,
+                             CallbackType onFinish);
+
+    /// Implement the corresponding method of the base class
+    void onRequest(proto::FrameBuffer& buf) override;
+
+    /// Implement the corresponding method of the base class
+    void onResponse(proto::FrameBufferView& view) override;
+
+    /// Implement the corresponding method of the base class
+    void onError(std::string const& error) override;
+
+private:
+
+    /// The name of a database to be deleted
+    std::string _db;
+
+    /// The name of a table to be deleted (empty for the whole database)
+    std::string _table;
+
+    /// Optional callback function to be called upon the completion
+    /// (successfull or not) of the request.
+    CallbackType _onFinish;
+};
+
+}}} // namespace lsst::qserv::wpublish
+
+#endif // LSST_QSERV_WPUBLISH_SCHEDULE_DROP_QSERV_REQUEST_H
@@ -65,6 +65,27 @@ SetChunkListCommand::SetChunkListCommand(std::shared_ptr<wbase::SendChannel>
         _resourceMonitor(resourceMonitor),
         _mySqlConfig(mySqlConfig),
         _chunks(chunks),
+        _incremental(false),
+        _baseVersion(0),
+        _force(force) {
+}
+
+SetChunkListCommand::SetChunkListCommand(std::shared_ptr<wbase::SendChannel>     const& sendChannel,
+                                         std::shared_ptr<ChunkInventory>         const& chunkInventory,
+                                         std::shared_ptr<ResourceMonitor>        const& resourceMonitor,
+                                         mysql::MySqlConfig                      const& mySqlConfig,
+                                         std::vector<SetChunkListCommand::Chunk> const& addChunks,
+                                         std::vector<SetChunkListCommand::Chunk> const& removeChunks,
+                                         uint64_t baseVersion,
+                                         bool force)
+    :   wbase::WorkerCommand(sendChannel),
+        _chunkInventory(chunkInventory),
+        _resourceMonitor(resourceMonitor),
+        _mySqlConfig(mySqlConfig),
+        _addChunks(addChunks),
+        _removeChunks(removeChunks),
+        _incremental(true),
+        _baseVersion(baseVersion),
         _force(force) {
 }
 
@@ -93,6 +114,7 @@ void SetChunkListCommand::reportError(proto::WorkerCommandSetChunkListR::Status
 
     reply.set_status(status);
     reply.set_error(message);
+    reply.set_version(_chunkInventory->version());
     setChunks(reply, prevExistMap);
 
     _frameBuf.serialize(reply);
@@ -108,18 +130,53 @@ void SetChunkListCommand::run() {
     // Store the current collection of chnuks
     ChunkInventory::ExistMap const prevExistMap = _chunkInventory->existMap();
 
-    // Build a temporary object representing a desired chunk list and
-    // compare it with the present one.
-    ChunkInventory::ExistMap newExistMap;
-    for (Chunk const& chunkEntry: _chunks) {
-        newExistMap[chunkEntry.database].insert(chunkEntry.chunk);
-    }
-    ChunkInventory const newChunkInventory(newExistMap,
-                                           _chunkInventory->name(),
-                                           _chunkInventory->id());
+    ChunkInventory::ExistMap toBeRemovedExistMap;
+    ChunkInventory::ExistMap toBeAddedExistMap;
+
+    if (_incremental) {
+
+        // The deltas were computed by the caller against a specific version of
+        // the inventory. Refuse to apply them on top of any other version and
+        // let the caller fall back onto the full-list protocol.
+        uint64_t const version = _chunkInventory->version();
+        if (_baseVersion != version) {
+            reportError(proto::WorkerCommandSetChunkListR::MISMATCH,
+                        "chunk list version mismatch, base version: " + std::to_string(_baseVersion) +
+                        ", current version: " + std::to_string(version),
+                        prevExistMap);
+            return;
+        }
 
-    ChunkInventory::ExistMap const toBeRemovedExistMap =  *_chunkInventory - newChunkInventory;
-    ChunkInventory::ExistMap const toBeAddedExistMap   = newChunkInventory -  *_chunkInventory;
+        // Skip entries which are already in the desired state to make
+        // the operation idempotent.
+        for (Chunk const& chunkEntry: _removeChunks) {
+            auto itr = prevExistMap.find(chunkEntry.database);
+            if ((itr != prevExistMap.end()) and itr->second.count(chunkEntry.chunk)) {
+                toBeRemovedExistMap[chunkEntry.database].insert(chunkEntry.chunk);
+            }
+        }
+        for (Chunk const& chunkEntry: _addChunks) {
+            auto itr = prevExistMap.find(chunkEntry.database);
+            if ((itr == prevExistMap.end()) or not itr->second.count(chunkEntry.chunk)) {
+                toBeAddedExistMap[chunkEntry.database].insert(chunkEntry.chunk);
+            }
+        }
+
+    } else {
+
+        // Build a temporary object representing a desired chunk list and
+        // compare it with the present one.
+        ChunkInventory::ExistMap newExistMap;
+        for (Chunk const& chunkEntry: _chunks) {
+            newExistMap[chunkEntry.database].insert(chunkEntry.chunk);
+        }
+        ChunkInventory const newChunkInventory(newExistMap,
+                                               _chunkInventory->name(),
+                                               _chunkInventory->id());
+
+        toBeRemovedExistMap =  *_chunkInventory - newChunkInventory;
+        toBeAddedExistMap   = newChunkInventory -  *_chunkInventory;
+    }
 
     // Make sure none of the chunks in the 'to be removed' group is not being used
     // unless in the 'force' mode
@@ -224,6 +281,7 @@ void SetChunkListCommand::run() {
     // Send back a reply
     proto::WorkerCommandSetChunkListR reply;
     reply.set_status(proto::WorkerCommandSetChunkListR::SUCCESS);
+    reply.set_version(_chunkInventory->version());
     setChunks(reply, prevExistMap);
 
     _frameBuf.serialize(reply);
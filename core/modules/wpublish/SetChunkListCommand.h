@@ -25,6 +25,7 @@
 #define LSST_QSERV_WPUBLISH_SET_CHUNK_LIST_COMMAND_H
 
 // System headers
+#include <cstdint>
 #include <memory>
 #include <string>
 #include <vector>
@@ -85,6 +86,32 @@ public:
                         std::vector<Chunk>                  const& chunks,
                         bool                                       force);
 
+    /**
+     * The constructor for incremental requests. Instead of replacing
+     * the current chunk list with a new one, the specified chunks get added
+     * to (or removed from) the list in place. The deltas are only applied if
+     * 'baseVersion' matches the current version of the inventory, otherwise
+     * the request is turned down with status MISMATCH and the caller is
+     * expected to fall back onto the full-list protocol.
+     *
+     * @param sendChannel     - communication channel for reporting results
+     * @param chunkInventory  - chunks known to the application
+     * @param resourceMonitor - counters of resources which are being used
+     * @param mySqlConfig     - database connection parameters
+     * @param addChunks       - collection of chunks to be added to the current list
+     * @param removeChunks    - collection of chunks to be removed from the current list
+     * @param baseVersion     - the version of the inventory the deltas were computed against
+     * @param force           - force chunks removal even if chunks are in use
+     */
+    SetChunkListCommand(std::shared_ptr<wbase::SendChannel> const& sendChannel,
+                        std::shared_ptr<ChunkInventory>     const& chunkInventory,
+                        std::shared_ptr<ResourceMonitor>    const& resourceMonitor,
+                        mysql::MySqlConfig                  const& mySqlConfig,
+                        std::vector<Chunk>                  const& addChunks,
+                        std::vector<Chunk>                  const& removeChunks,
+                        uint64_t                                   baseVersion,
+                        bool                                       force);
+
     /// The destructor
     ~SetChunkListCommand() override = default;
 
@@ -123,6 +150,10 @@ private:
     std::shared_ptr<ResourceMonitor> _resourceMonitor;
     mysql::MySqlConfig _mySqlConfig;
     std::vector<Chunk> _chunks;
+    std::vector<Chunk> _addChunks;
+    std::vector<Chunk> _removeChunks;
+    bool _incremental;
+    uint64_t _baseVersion;
     bool _force;
 };
 
@@ -41,6 +41,7 @@ wpublish::SetChunkListQservRequest::Status translate(proto::WorkerCommandSetChun
         case proto::WorkerCommandSetChunkListR::SUCCESS: return wpublish::SetChunkListQservRequest::SUCCESS;
         case proto::WorkerCommandSetChunkListR::INVALID: return wpublish::SetChunkListQservRequest::INVALID;
         case proto::WorkerCommandSetChunkListR::IN_USE:  return wpublish::SetChunkListQservRequest::IN_USE;
+        case proto::WorkerCommandSetChunkListR::MISMATCH: return wpublish::SetChunkListQservRequest::MISMATCH;
         case proto::WorkerCommandSetChunkListR::ERROR:   return wpublish::SetChunkListQservRequest::ERROR;
     }
     throw std::domain_error(
@@ -58,6 +59,7 @@ std::string SetChunkListQservRequest::status2str(Status status) {
         case SUCCESS: return "SUCCESS";
         case INVALID: return "INVALID";
         case IN_USE:  return "IN_USE";
+        case MISMATCH: return "MISMATCH";
         case ERROR:   return "ERROR";
     }
     throw std::domain_error(
@@ -74,17 +76,49 @@ SetChunkListQservRequest::Ptr SetChunkListQservRequest::create(
         onFinish
     ));
                                 }
+SetChunkListQservRequest::Ptr SetChunkListQservRequest::createDelta(
+                                SetChunkListQservRequest::ChunkCollection const& addChunks,
+                                SetChunkListQservRequest::ChunkCollection const& removeChunks,
+                                uint64_t baseVersion,
+                                bool force,
+                                SetChunkListQservRequest::CallbackType onFinish) {
+    return SetChunkListQservRequest::Ptr(new SetChunkListQservRequest(
+        addChunks,
+        removeChunks,
+        baseVersion,
+        force,
+        onFinish
+    ));
+                                }
 SetChunkListQservRequest::SetChunkListQservRequest(
                                 SetChunkListQservRequest::ChunkCollection const& chunks,
                                 bool force,
                                 SetChunkListQservRequest::CallbackType onFinish)
     :   _chunks(chunks),
+        _incremental(false),
+        _baseVersion(0),
         _force(force),
         _onFinish(onFinish) {
 
     LOGS(_log, LOG_LVL_DEBUG, "SetChunkListQservRequest  ** CONSTRUCTED **");
 }
 
+SetChunkListQservRequest::SetChunkListQservRequest(
+                                SetChunkListQservRequest::ChunkCollection const& addChunks,
+                                SetChunkListQservRequest::ChunkCollection const& removeChunks,
+                                uint64_t baseVersion,
+                                bool force,
+                                SetChunkListQservRequest::CallbackType onFinish)
+    :   _addChunks(addChunks),
+        _removeChunks(removeChunks),
+        _incremental(true),
+        _baseVersion(baseVersion),
+        _force(force),
+        _onFinish(onFinish) {
+
+    LOGS(_log, LOG_LVL_DEBUG, "SetChunkListQservRequest  ** CONSTRUCTED ** (incremental)");
+}
+
 SetChunkListQservRequest::~SetChunkListQservRequest() {
     LOGS(_log, LOG_LVL_DEBUG, "SetChunkListQservRequest  ** DELETED **");
 }
@@ -96,10 +130,25 @@ void SetChunkListQservRequest::onRequest(proto::FrameBuffer& buf) {
     buf.serialize(header);
 
     proto::WorkerCommandSetChunkListM message;
-    for(auto const& chunkEntry: _chunks) {
-        proto::WorkerCommandChunk* ptr = message.add_chunks();
-        ptr->set_db(chunkEntry.database);
-        ptr->set_chunk(chunkEntry.chunk);
+    if (_incremental) {
+        message.set_incremental(true);
+        message.set_base_version(_baseVersion);
+        for(auto const& chunkEntry: _addChunks) {
+            proto::WorkerCommandChunk* ptr = message.add_added();
+            ptr->set_db(chunkEntry.database);
+            ptr->set_chunk(chunkEntry.chunk);
+        }
+        for(auto const& chunkEntry: _removeChunks) {
+            proto::WorkerCommandChunk* ptr = message.add_removed();
+            ptr->set_db(chunkEntry.database);
+            ptr->set_chunk(chunkEntry.chunk);
+        }
+    } else {
+        for(auto const& chunkEntry: _chunks) {
+            proto::WorkerCommandChunk* ptr = message.add_chunks();
+            ptr->set_db(chunkEntry.database);
+            ptr->set_chunk(chunkEntry.chunk);
+        }
     }
     message.set_force(_force);
     buf.serialize(message);
@@ -117,7 +166,8 @@ void SetChunkListQservRequest::onResponse(proto::FrameBufferView& view) {
 
     ChunkCollection chunks;
 
-    if (reply.status() == proto::WorkerCommandSetChunkListR::SUCCESS) {
+    if ((reply.status() == proto::WorkerCommandSetChunkListR::SUCCESS) or
+        (reply.status() == proto::WorkerCommandSetChunkListR::MISMATCH)) {
         int const num = reply.chunks_size();
         for (int i = 0; i < num; i++) {
             proto::WorkerCommandChunk const& chunkEntry  = reply.chunks(i);
@@ -131,7 +181,8 @@ void SetChunkListQservRequest::onResponse(proto::FrameBufferView& view) {
         _onFinish(
             ::translate(reply.status()),
             reply.error(),
-            chunks);
+            chunks,
+            reply.version());
     }
 }
 
@@ -141,7 +192,8 @@ void SetChunkListQservRequest::onError(std::string const& error) {
         _onFinish(
             Status::ERROR,
             error,
-            ChunkCollection());
+            ChunkCollection(),
+            0);
     }
 }
 
@@ -25,6 +25,7 @@
 #define LSST_QSERV_WPUBLISH_SET_CHUNK_LIST_QSERV_REQUEST_H
 
 // System headers
+#include <cstdint>
 #include <functional>
 #include <list>
 #include <memory>
@@ -54,6 +55,8 @@ public:
         SUCCESS,    // successful completion of a request
         INVALID,    // invalid parameters of the request
         IN_USE,     // request is rejected because one of the chunks is in use
+        MISMATCH,   // an incremental request was made against a stale version
+                    // of the chunk list; the caller should resend the full list
         ERROR       // an error occured during command execution
     };
 
@@ -79,7 +82,9 @@ public:
     using CallbackType =
         std::function<void(Status,                      // completion status
                            std::string const&,          // error message
-                           ChunkCollection const&)>;    // chunks (if success)
+                           ChunkCollection const&,      // chunks (if success or mismatch)
+                           uint64_t)>;                  // the current version of the worker's
+                                                        // chunk list
     /**
      * Static factory method is needed to prevent issues with the lifespan
      * and memory management of instances created otherwise (as values or via
@@ -98,6 +103,33 @@ public:
                      bool force = false,
                      CallbackType onFinish = nullptr);
 
+    /**
+     * Static factory method for incremental requests. Instead of replacing
+     * the worker's chunk list with a new one, the specified chunks get added
+     * to (or removed from) the list in place. The deltas are only applied if
+     * 'baseVersion' matches the current version of the worker's list (as
+     * reported to the callback of a previous request), otherwise the request
+     * finishes with status MISMATCH and the current list, and the caller is
+     * expected to fall back onto the full-list protocol.
+     *
+     * ATTENTION: the 'use_count' field of structure Chunk is ignored by this
+     * class when used on its input.
+     *
+     * @param addChunks    - collection of chunks to be added to the worker's list
+     * @param removeChunks - collection of chunks to be removed from the worker's list
+     * @param baseVersion  - the version of the worker's chunk list the deltas
+     *                       were computed against
+     * @param force        - force the proposed change even if the chunk is in use
+     * @param onFinish     - optional callback function to be called upon the completion
+     *                       (successful or not) of the request.
+     * @return smart pointer to the object of the class
+     */
+   static Ptr createDelta(ChunkCollection const& addChunks,
+                          ChunkCollection const& removeChunks,
+                          uint64_t baseVersion,
+                          bool force = false,
+                          CallbackType onFinish = nullptr);
+
     // Default onstruction and copy semantics are prohibited
     SetChunkListQservRequest() = delete;
     SetChunkListQservRequest(SetChunkListQservRequest const&) = delete;
@@ -123,6 +155,26 @@ protected:
                              bool force,
                              CallbackType onFinish);
 
+    /**
+     * Constructor for incremental requests
+     *
+     * ATTENTION: the 'use_count' field of structure Chunk is ignored by this
+     * class when used on its input.
+     *
+     * @param addChunks    - collection of chunks to be added to the worker's list
+     * @param removeChunks - collection of chunks to be removed from the worker's list
+     * @param baseVersion  - the version of the worker's chunk list the deltas
+     *                       were computed against
+     * @param force        - force the proposed change even if the chunk is in use
+     * @param onFinish     - optional callback function to be called upon the completion
+     *                       (successful or not) of the request.
+     */
+    SetChunkListQservRequest(ChunkCollection const& addChunks,
+                             ChunkCollection const& removeChunks,
+                             uint64_t baseVersion,
+                             bool force,
+                             CallbackType onFinish);
+
     /// Implement the corresponding method of the base class
     void onRequest(proto::FrameBuffer& buf) override;
 
@@ -135,6 +187,10 @@ protected:
 private:
 
     ChunkCollection _chunks;
+    ChunkCollection _addChunks;
+    ChunkCollection _removeChunks;
+    bool _incremental;
+    uint64_t _baseVersion;
     bool _force;
 
     /// Optional callback function to be called upon the completion
@@ -0,0 +1,150 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "wpublish/SetWorkerTuningCommand.h"
+
+// LSST headers
+#include "lsst/log/Log.h"
+#include "memman/MemMan.h"
+#include "wbase/SendChannel.h"
+#include "wsched/BlendScheduler.h"
+#include "wsched/ScanScheduler.h"
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.wpublish.SetWorkerTuningCommand");
+
+} // annonymous namespace
+
+namespace lsst {
+namespace qserv {
+namespace wpublish {
+
+SetWorkerTuningCommand::SetWorkerTuningCommand(std::shared_ptr<wbase::SendChannel> const& sendChannel,
+                                               std::shared_ptr<wsched::BlendScheduler> const& blendScheduler,
+                                               std::vector<SchedulerTuning> const& schedulers,
+                                               uint64_t memManSizeMb)
+    :   wbase::WorkerCommand(sendChannel),
+        _blendScheduler(blendScheduler),
+        _schedulers(schedulers),
+        _memManSizeMb(memManSizeMb) {
+}
+
+void SetWorkerTuningCommand::reportError(proto::WorkerCommandSetWorkerTuningR::Status status,
+                                         std::string const& message) {
+
+    LOGS(_log, LOG_LVL_ERROR, "SetWorkerTuningCommand::reportError  " << message);
+
+    proto::WorkerCommandSetWorkerTuningR reply;
+
+    reply.set_status(status);
+    reply.set_error(message);
+
+    _frameBuf.serialize(reply);
+    std::string str(_frameBuf.data(), _frameBuf.size());
+    _sendChannel->sendStream(xrdsvc::StreamBuffer::createWithMove(str), true);
+}
+
+void SetWorkerTuningCommand::run() {
+
+    LOGS(_log, LOG_LVL_DEBUG, "SetWorkerTuningCommand::run");
+
+    auto const subSchedulers = _blendScheduler->getSubSchedulers();
+
+    // Validate all scheduler names before changing anything so that
+    // a partially applied update can't result from a typo.
+    for (auto const& tuning: _schedulers) {
+        bool found = false;
+        for (auto const& sched: subSchedulers) {
+            if (sched->getName() == tuning.name) {
+                found = true;
+                break;
+            }
+        }
+        if (not found) {
+            reportError(proto::WorkerCommandSetWorkerTuningR::INVALID,
+                        "no such scheduler: " + tuning.name);
+            return;
+        }
+    }
+
+    unsigned int applied = 0;
+
+    for (auto const& tuning: _schedulers) {
+        for (auto const& sched: subSchedulers) {
+            if (sched->getName() != tuning.name) continue;
+            if (tuning.priority >= 0) {
+                LOGS(_log, LOG_LVL_INFO, "SetWorkerTuningCommand: " << tuning.name
+                     << " priority: " << sched->getPriority() << " -> " << tuning.priority);
+                sched->setDefaultPriority(tuning.priority);
+                ++applied;
+            }
+            if (tuning.maxReserve >= 0) {
+                LOGS(_log, LOG_LVL_INFO, "SetWorkerTuningCommand: " << tuning.name
+                     << " maxReserve: " << sched->getMaxReserve() << " -> " << tuning.maxReserve);
+                sched->setMaxReserveDefault(tuning.maxReserve);
+                ++applied;
+            }
+            if (tuning.maxActiveChunks >= 0) {
+                LOGS(_log, LOG_LVL_INFO, "SetWorkerTuningCommand: " << tuning.name
+                     << " maxActiveChunks: " << sched->getMaxActiveChunks()
+                     << " -> " << tuning.maxActiveChunks);
+                sched->setMaxActiveChunks(tuning.maxActiveChunks);
+                ++applied;
+            }
+        }
+    }
+
+    if (_memManSizeMb != 0) {
+
+        // The memory manager is shared by the scan schedulers, so any of
+        // them provides access to it.
+        memman::MemMan::Ptr memMan;
+        for (auto const& sched: subSchedulers) {
+            auto const scanSched = std::dynamic_pointer_cast<wsched::ScanScheduler>(sched);
+            if (scanSched != nullptr) {
+                memMan = scanSched->getMemMan();
+                break;
+            }
+        }
+        if (memMan == nullptr) {
+            reportError(proto::WorkerCommandSetWorkerTuningR::ERROR,
+                        "no scan scheduler found, can't change the memory budget");
+            return;
+        }
+        LOGS(_log, LOG_LVL_INFO, "SetWorkerTuningCommand: memManSizeMb -> " << _memManSizeMb);
+        memMan->setMaxBytes(_memManSizeMb * 1000000);
+        ++applied;
+    }
+
+    proto::WorkerCommandSetWorkerTuningR reply;
+    reply.set_status(proto::WorkerCommandSetWorkerTuningR::SUCCESS);
+    reply.set_applied(applied);
+
+    _frameBuf.serialize(reply);
+    std::string str(_frameBuf.data(), _frameBuf.size());
+    _sendChannel->sendStream(xrdsvc::StreamBuffer::createWithMove(str), true);
+}
+
+}}} // namespace lsst::qserv::wpublish
@@ -0,0 +1,125 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+/// SetWorkerTuningCommand.h
+#ifndef LSST_QSERV_WPUBLISH_SET_WORKER_TUNING_COMMAND_H
+#define LSST_QSERV_WPUBLISH_SET_WORKER_TUNING_COMMAND_H
+
+// System headers
+#include <memory>
+#include <string>
+#include <vector>
+
+// Qserv headers
+#include "proto/worker.pb.h"
+#include "wbase/WorkerCommand.h"
+
+// Forward declarations
+namespace lsst {
+namespace qserv {
+namespace wbase {
+class SendChannel;
+}
+namespace wsched {
+class BlendScheduler;
+}}}
+
+namespace lsst {
+namespace qserv {
+namespace wpublish {
+
+/**
+  * Class SetWorkerTuningCommand changes tuning parameters of the worker
+  * at runtime: per-scheduler priorities, thread reserves and concurrent
+  * chunk limits, plus the memory budget of the memory manager. Only the
+  * parameters provided by a client are changed, so known-good settings
+  * can be converged on incrementally without worker restarts and the
+  * chunk-inventory and memory-manager warm-up costs those incur.
+  */
+class SetWorkerTuningCommand
+    :   public wbase::WorkerCommand {
+
+public:
+
+    /// Tuning parameters of one task scheduler. Negative values mean
+    /// 'leave the parameter unchanged'.
+    struct SchedulerTuning {
+        std::string name;           ///< the name of the scheduler, e.g. 'SchedFast'
+        int priority = -1;          ///< scheduling priority
+        int maxReserve = -1;        ///< threads reserved for the scheduler
+        int maxActiveChunks = -1;   ///< maximum number of concurrent chunks
+    };
+
+    // The default construction and copy semantics are prohibited
+    SetWorkerTuningCommand& operator=(SetWorkerTuningCommand const&) = delete;
+    SetWorkerTuningCommand(SetWorkerTuningCommand const&) = delete;
+    SetWorkerTuningCommand() = delete;
+
+    /**
+     * The normal constructor of the class
+     *
+     * @param sendChannel    - communication channel for reporting results
+     * @param blendScheduler - top-level scheduler owning the schedulers to tune
+     * @param schedulers     - per-scheduler tuning parameters
+     * @param memManSizeMb   - new memory budget of the memory manager,
+     *                         or 0 to leave it unchanged
+     */
+    SetWorkerTuningCommand(std::shared_ptr<wbase::SendChannel> const& sendChannel,
+                           std::shared_ptr<wsched::BlendScheduler> const& blendScheduler,
+                           std::vector<SchedulerTuning> const& schedulers,
+                           uint64_t memManSizeMb);
+
+    /// The destructor
+    ~SetWorkerTuningCommand() override = default;
+
+    /**
+     * Implement the corresponding method of the base class
+     *
+     * @see WorkerCommand::run()
+     */
+    void run() override;
+
+private:
+
+    /**
+     * Report error condition to the logging stream and reply back to
+     * a service caller.
+     *
+     * @param status  - error status
+     * @param message - message to be reported
+     */
+    void reportError(proto::WorkerCommandSetWorkerTuningR::Status status,
+                     std::string const& message);
+
+    /// Top-level scheduler owning the schedulers to tune
+    std::shared_ptr<wsched::BlendScheduler> _blendScheduler;
+
+    /// Per-scheduler tuning parameters
+    std::vector<SchedulerTuning> _schedulers;
+
+    /// New memory budget of the memory manager (0 - leave unchanged)
+    uint64_t _memManSizeMb;
+};
+
+}}} // namespace lsst::qserv::wpublish
+
+#endif // LSST_QSERV_WPUBLISH_SET_WORKER_TUNING_COMMAND_H
@@ -0,0 +1,136 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "wpublish/SetWorkerTuningQservRequest.h"
+
+// System headers
+#include <stdexcept>
+#include <string>
+
+// Qserv headers
+#include "lsst/log/Log.h"
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.wpublish.SetWorkerTuningQservRequest");
+
+using namespace lsst::qserv;
+
+wpublish::SetWorkerTuningQservRequest::Status translate(proto::WorkerCommandSetWorkerTuningR::Status status) {
+    switch (status) {
+        case proto::WorkerCommandSetWorkerTuningR::SUCCESS: return wpublish::SetWorkerTuningQservRequest::SUCCESS;
+        case proto::WorkerCommandSetWorkerTuningR::INVALID: return wpublish::SetWorkerTuningQservRequest::INVALID;
+        case proto::WorkerCommandSetWorkerTuningR::ERROR:   return wpublish::SetWorkerTuningQservRequest::ERROR;
+    }
+    throw std::domain_error(
+            "SetWorkerTuningQservRequest::translate  no match for Protobuf status: " +
+            proto::WorkerCommandSetWorkerTuningR_Status_Name(status));
+}
+}  // namespace
+
+namespace lsst {
+namespace qserv {
+namespace wpublish {
+
+std::string SetWorkerTuningQservRequest::status2str(Status status) {
+    switch (status) {
+        case SUCCESS: return "SUCCESS";
+        case INVALID: return "INVALID";
+        case ERROR:   return "ERROR";
+    }
+    throw std::domain_error(
+            "SetWorkerTuningQservRequest::status2str  no match for status: " +
+            std::to_string(status));
+}
+
+SetWorkerTuningQservRequest::Ptr SetWorkerTuningQservRequest::create(
+                                    std::vector<SchedulerTuning> const& schedulers,
+                                    uint64_t memManSizeMb,
+                                    SetWorkerTuningQservRequest::CallbackType onFinish) {
+    return SetWorkerTuningQservRequest::Ptr(
+        new SetWorkerTuningQservRequest(schedulers,
+                                        memManSizeMb,
+                                        onFinish));
+}
+
+SetWorkerTuningQservRequest::SetWorkerTuningQservRequest(
+                                    std::vector<SchedulerTuning> const& schedulers,
+                                    uint64_t memManSizeMb,
+                                    SetWorkerTuningQservRequest::CallbackType onFinish)
+    :   _schedulers(schedulers),
+        _memManSizeMb(memManSizeMb),
+        _onFinish(onFinish) {
+
+    LOGS(_log, LOG_LVL_DEBUG, "SetWorkerTuningQservRequest  ** CONSTRUCTED **");
+}
+
+SetWorkerTuningQservRequest::~SetWorkerTuningQservRequest() {
+    LOGS(_log, LOG_LVL_DEBUG, "SetWorkerTuningQservRequest  ** DELETED **");
+}
+
+void SetWorkerTuningQservRequest::onRequest(proto::FrameBuffer& buf) {
+
+    proto::WorkerCommandH header;
+    header.set_command(proto::WorkerCommandH::SET_WORKER_TUNING);
+    buf.serialize(header);
+
+    proto::WorkerCommandSetWorkerTuningM message;
+    for (auto const& tuning: _schedulers) {
+        proto::WorkerCommandSetWorkerTuningM::Scheduler* sched = message.add_scheduler();
+        sched->set_name(tuning.name);
+        if (tuning.priority        >= 0) sched->set_priority(tuning.priority);
+        if (tuning.maxReserve      >= 0) sched->set_max_reserve(tuning.maxReserve);
+        if (tuning.maxActiveChunks >= 0) sched->set_max_active_chunks(tuning.maxActiveChunks);
+    }
+    if (_memManSizeMb != 0) message.set_memman_size_mb(_memManSizeMb);
+    buf.serialize(message);
+}
+
+void SetWorkerTuningQservRequest::onResponse(proto::FrameBufferView& view) {
+
+    proto::WorkerCommandSetWorkerTuningR reply;
+    view.parse(reply);
+
+    LOGS(_log, LOG_LVL_DEBUG, "SetWorkerTuningQservRequest  ** SERVICE REPLY **  status: "
+         << proto::WorkerCommandSetWorkerTuningR_Status_Name(reply.status()));
+
+    if (_onFinish) {
+        _onFinish(
+            ::translate(reply.status()),
+            reply.error(),
+            reply.applied());
+    }
+}
+
+void SetWorkerTuningQservRequest::onError(std::string const& error) {
+
+    if (_onFinish) {
+        _onFinish(
+            Status::ERROR,
+            error,
+            0);
+    }
+}
+
+}}} // namespace lsst::qserv::wpublish
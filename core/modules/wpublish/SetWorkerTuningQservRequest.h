@@ -0,0 +1,141 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+/// SetWorkerTuningQservRequest.h
+#ifndef LSST_QSERV_WPUBLISH_SET_WORKER_TUNING_QSERV_REQUEST_H
+#define LSST_QSERV_WPUBLISH_SET_WORKER_TUNING_QSERV_REQUEST_H
+
+// System headers
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+// Qserv headers
+#include "wpublish/QservRequest.h"
+
+namespace lsst {
+namespace qserv {
+namespace wpublish {
+
+/**
+  * Class SetWorkerTuningQservRequest changes tuning parameters of a worker
+  * at runtime: per-scheduler priorities, thread reserves and concurrent
+  * chunk limits, plus the memory budget of the memory manager. Only the
+  * parameters which are explicitly provided are changed.
+  */
+class SetWorkerTuningQservRequest
+    :    public QservRequest {
+
+public:
+
+    /// Completion status of the operation
+    enum Status {
+        SUCCESS,    // successful completion of a request
+        INVALID,    // invalid parameters of the request
+        ERROR       // an error occured during command execution
+    };
+
+    /// @return string representation of a status
+    static std::string status2str(Status status);
+
+    /// Tuning parameters of one task scheduler. Negative values mean
+    /// 'leave the parameter unchanged'.
+    struct SchedulerTuning {
+        std::string name;           ///< the name of the scheduler, e.g. 'SchedFast'
+        int priority = -1;          ///< scheduling priority
+        int maxReserve = -1;        ///< threads reserved for the scheduler
+        int maxActiveChunks = -1;   ///< maximum number of concurrent chunks
+    };
+
+    /// The pointer type for instances of the class
+    typedef std::shared_ptr<SetWorkerTuningQservRequest> Ptr;
+
+    /// The callback function type to be used for notifications on
+    /// the operation completion.
+    using CallbackType =
+        std::function<void(Status,                  // completion status
+                           std::string const&,      // error message
+                           unsigned int)>;          // the number of parameters applied
+
+    /**
+     * Static factory method is needed to prevent issues with the lifespan
+     * and memory management of instances created otherwise (as values or via
+     * low-level pointers).
+     *
+     * @param schedulers   - per-scheduler tuning parameters
+     * @param memManSizeMb - new memory budget of the memory manager,
+     *                       or 0 to leave it unchanged
+     * @param onFinish     - optional callback function to be called upon the completion
+     *                       (successful or not) of the request.
+     * @return smart pointer to the object of the class
+     */
+    static Ptr create(std::vector<SchedulerTuning> const& schedulers,
+                      uint64_t memManSizeMb,
+                      CallbackType onFinish = nullptr);
+
+    // Default construction and copy semantics is prohibited
+    SetWorkerTuningQservRequest() = delete;
+    SetWorkerTuningQservRequest(SetWorkerTuningQservRequest const&) = delete;
+    SetWorkerTuningQservRequest& operator=(SetWorkerTuningQservRequest const&) = delete;
+
+    /// Destructor
+    ~SetWorkerTuningQservRequest() override;
+
+protected:
+
+    /**
+     * Normal constructor
+     *
+     * @param schedulers   - per-scheduler tuning parameters
+     * @param memManSizeMb - new memory budget (0 - leave unchanged)
+     * @param onFinish     - function to be called upon the completion of a request
+     */
+    SetWorkerTuningQservRequest(std::vector<SchedulerTuning> const& schedulers,
+                                uint64_t memManSizeMb,
+                                CallbackType onFinish);
+
+    /// Implement the corresponding method of the base class
+    void onRequest(proto::FrameBuffer& buf) override;
+
+    /// Implement the corresponding method of the base class
+    void onResponse(proto::FrameBufferView& view) override;
+
+    /// Implement the corresponding method of the base class
+    void onError(std::string const& error) override;
+
+private:
+
+    /// Per-scheduler tuning parameters
+    std::vector<SchedulerTuning> _schedulers;
+
+    /// New memory budget of the memory manager (0 - leave unchanged)
+    uint64_t _memManSizeMb;
+
+    /// Optional callback function to be called upon the completion
+    /// (successfull or not) of the request.
+    CallbackType _onFinish;
+};
+
+}}} // namespace lsst::qserv::wpublish
+
+#endif // LSST_QSERV_WPUBLISH_SET_WORKER_TUNING_QSERV_REQUEST_H
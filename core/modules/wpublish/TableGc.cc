@@ -0,0 +1,240 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+// Class header
+#include "wpublish/TableGc.h"
+
+// System headers
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <vector>
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+// Qserv headers
+#include "sql/SqlConnection.h"
+#include "sql/SqlErrorObject.h"
+#include "wpublish/ResourceMonitor.h"
+
+namespace {
+
+LOG_LOGGER _log = LOG_GET("lsst.qserv.wpublish.TableGc");
+
+// The base pause after each physical drop. The effective pause grows
+// linearly with the number of chunk resources currently in use, up to
+// the cap below, so that the collector backs off when scans are running.
+unsigned int const dropIntervalMs = 100;
+unsigned int const maxLoadFactor = 50;
+
+// How long to wait before retrying entries which couldn't be processed
+// (a chunk in use, or a transient database error)
+unsigned int const retryIntervalMs = 5000;
+
+// Entries failing this many times due to database errors are abandoned
+// (in-use deferrals don't count against the limit)
+unsigned int const maxAttempts = 10;
+
+} // annonymous namespace
+
+namespace lsst {
+namespace qserv {
+namespace wpublish {
+
+TableGc& TableGc::instance() {
+    static TableGc gc;
+    return gc;
+}
+
+void TableGc::setup(mysql::MySqlConfig const& mySqlConfig,
+                    std::shared_ptr<ResourceMonitor> const& resourceMonitor) {
+
+    std::lock_guard<std::mutex> lock(_mtx);
+
+    if (_running) return;
+
+    _mySqlConfig = mySqlConfig;
+    _resourceMonitor = resourceMonitor;
+
+    _thread = std::thread([this]() { _run(); });
+    _thread.detach();
+    _running = true;
+}
+
+void TableGc::scheduleDatabase(std::string const& db) {
+    _schedule(Entry{db, std::string(), 0});
+}
+
+void TableGc::scheduleTable(std::string const& db,
+                            std::string const& table) {
+    _schedule(Entry{db, table, 0});
+}
+
+unsigned int TableGc::pending() const {
+    std::lock_guard<std::mutex> lock(_mtx);
+    return _queue.size();
+}
+
+void TableGc::_schedule(Entry const& entry) {
+    {
+        std::lock_guard<std::mutex> lock(_mtx);
+        _queue.push_back(entry);
+    }
+    _cv.notify_one();
+}
+
+void TableGc::_run() {
+
+    LOGS(_log, LOG_LVL_DEBUG, "TableGc::_run  started");
+
+    // The number of consecutive entries pushed back to the queue. When
+    // every remaining entry has been deferred once there is nothing to do
+    // right now, and the thread waits instead of spinning over the queue.
+    unsigned int deferred = 0;
+
+    while (true) {
+
+        Entry entry;
+        {
+            std::unique_lock<std::mutex> lock(_mtx);
+            if (_queue.empty()) {
+                deferred = 0;
+                _cv.wait(lock, [this]() { return not _queue.empty(); });
+            } else if (deferred >= _queue.size()) {
+                deferred = 0;
+                _cv.wait_for(lock, std::chrono::milliseconds(retryIntervalMs));
+                if (_queue.empty()) continue;
+            }
+            entry = _queue.front();
+            _queue.pop_front();
+        }
+
+        bool dropped = false;
+        try {
+            dropped = _process(entry);
+        } catch (std::exception const& ex) {
+            LOGS(_log, LOG_LVL_ERROR, "TableGc::_run  exception while processing db: "
+                 << entry.db << ", table: " << entry.table << ", ex: " << ex.what());
+            entry.attempts++;
+        }
+
+        if (not dropped) {
+            if (entry.attempts >= maxAttempts) {
+                LOGS(_log, LOG_LVL_ERROR, "TableGc::_run  abandoning after "
+                     << entry.attempts << " failed attempts, db: " << entry.db
+                     << ", table: " << entry.table);
+            } else {
+                std::lock_guard<std::mutex> lock(_mtx);
+                _queue.push_back(entry);
+                deferred++;
+            }
+            continue;
+        }
+        deferred = 0;
+
+        // Pace the deletions. Each in-use chunk resource lengthens the pause
+        // so that scans see less interference from the drops.
+        unsigned int const busy =
+            std::min<unsigned int>(_resourceMonitor->resourceCounter().size(),
+                                   maxLoadFactor);
+        std::this_thread::sleep_for(
+            std::chrono::milliseconds(dropIntervalMs * (1 + busy)));
+    }
+}
+
+bool TableGc::_process(Entry& entry) {
+
+    sql::SqlConnection sqlConn(_mySqlConfig);
+    sql::SqlErrorObject errObj;
+
+    if (entry.table.empty()) {
+
+        // A whole database. Expand it into per-table entries so that each
+        // table drop is individually paced and in-use checked, then requeue
+        // the database itself to be dropped after its tables are gone.
+
+        std::vector<std::string> tables;
+        if (not sqlConn.listTables(tables, errObj, "", entry.db)) {
+            if (not sqlConn.dbExists(entry.db, errObj)) {
+                LOGS(_log, LOG_LVL_DEBUG, "TableGc::_process  database is already gone: "
+                     << entry.db);
+                return true;
+            }
+            LOGS(_log, LOG_LVL_WARN, "TableGc::_process  failed to list tables of db: "
+                 << entry.db << ", error: " << errObj.printErrMsg());
+            entry.attempts++;
+            return false;
+        }
+        if (tables.empty()) {
+            if (not sqlConn.dropDb(entry.db, errObj, false)) {
+                LOGS(_log, LOG_LVL_WARN, "TableGc::_process  failed to drop db: "
+                     << entry.db << ", error: " << errObj.printErrMsg());
+                entry.attempts++;
+                return false;
+            }
+            LOGS(_log, LOG_LVL_INFO, "TableGc::_process  dropped db: " << entry.db);
+            return true;
+        }
+        {
+            std::lock_guard<std::mutex> lock(_mtx);
+            for (std::string const& table: tables) {
+                _queue.push_back(Entry{entry.db, table, 0});
+            }
+            _queue.push_back(Entry{entry.db, std::string(), entry.attempts});
+        }
+        // Not a physical drop; the expansion needs no pacing
+        return true;
+    }
+
+    // A single table. Defer it while its chunk is still in use by
+    // running queries.
+
+    int const chunk = _chunkOf(entry.table);
+    if ((chunk >= 0) and (_resourceMonitor->count(chunk, entry.db) != 0)) {
+        LOGS(_log, LOG_LVL_DEBUG, "TableGc::_process  chunk is in use, deferring table: "
+             << entry.db << "." << entry.table);
+        return false;
+    }
+    if (not sqlConn.dropTable(entry.table, errObj, false, entry.db)) {
+        LOGS(_log, LOG_LVL_WARN, "TableGc::_process  failed to drop table: "
+             << entry.db << "." << entry.table << ", error: " << errObj.printErrMsg());
+        entry.attempts++;
+        return false;
+    }
+    LOGS(_log, LOG_LVL_INFO, "TableGc::_process  dropped table: "
+         << entry.db << "." << entry.table);
+    return true;
+}
+
+int TableGc::_chunkOf(std::string const& table) {
+    std::string::size_type const pos = table.rfind('_');
+    if ((pos == std::string::npos) or (pos + 1 == table.size())) return -1;
+    for (std::string::size_type i = pos + 1; i < table.size(); ++i) {
+        if (not std::isdigit(static_cast<unsigned char>(table[i]))) return -1;
+    }
+    return std::atoi(table.c_str() + pos + 1);
+}
+
+}}} // namespace lsst::qserv::wpublish
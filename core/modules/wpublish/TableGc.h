@@ -0,0 +1,165 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+/// TableGc.h
+#ifndef LSST_QSERV_WPUBLISH_TABLE_GC_H
+#define LSST_QSERV_WPUBLISH_TABLE_GC_H
+
+// System headers
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+
+// Qserv headers
+#include "mysql/MySqlConfig.h"
+
+// Forward declarations
+namespace lsst {
+namespace qserv {
+namespace wpublish {
+class ResourceMonitor;
+}}}
+
+namespace lsst {
+namespace qserv {
+namespace wpublish {
+
+/**
+  * Class TableGc is a rate-limited background garbage collector for
+  * databases and tables which were logically dropped by a user (the CSS
+  * status of the entity is updated first, which makes the entity invisible
+  * to new queries). The physical deletion is decoupled from the user-facing
+  * operation so that a DROP returns instantly regardless of how many chunk
+  * tables the entity has on this worker.
+  *
+  * The collector runs a single background thread which drops one table at
+  * a time and pauses between drops. The pause is scaled up by the number of
+  * chunk resources currently in use by the scheduler, so that the storms of
+  * metadata-lock and I/O activity caused by deleting a large database don't
+  * compete with ongoing scans. Chunk tables whose chunk is still in use by
+  * running queries are pushed to the back of the queue and retried later.
+  *
+  * The queue is kept in memory only. If a worker restarts with deletions
+  * pending then the watcher will re-schedule them when it next reconciles
+  * CSS against the worker's state; drops of missing entities are harmless.
+  */
+class TableGc {
+
+public:
+
+    // The default copy semantics is prohibited
+    TableGc& operator=(TableGc const&) = delete;
+    TableGc(TableGc const&) = delete;
+
+    /// @return reference to the process-wide collector
+    static TableGc& instance();
+
+    /**
+     * Provide the collector with the database connection parameters and
+     * the resource usage counter, and launch the background thread if it's
+     * not running yet. The first call wins; subsequent calls are ignored.
+     *
+     * @param mySqlConfig     - database connection parameters
+     * @param resourceMonitor - counter of resources which are in use
+     */
+    void setup(mysql::MySqlConfig const& mySqlConfig,
+               std::shared_ptr<ResourceMonitor> const& resourceMonitor);
+
+    /**
+     * Schedule all tables of a database (and the database itself) for
+     * deletion.
+     *
+     * @param db - the name of a database
+     */
+    void scheduleDatabase(std::string const& db);
+
+    /**
+     * Schedule a single table of a database for deletion.
+     *
+     * @param db    - the name of a database
+     * @param table - the name of a table
+     */
+    void scheduleTable(std::string const& db,
+                       std::string const& table);
+
+    /// @return the number of entries awaiting deletion
+    unsigned int pending() const;
+
+private:
+
+    /// An entry of the deletion queue. An empty table name stands for
+    /// the database itself (processed by enumerating its tables).
+    struct Entry {
+        std::string db;
+        std::string table;
+        unsigned int attempts = 0;
+    };
+
+    /// The constructor is private to enforce the singleton
+    TableGc() = default;
+
+    /// Add an entry to the queue and wake up the background thread
+    void _schedule(Entry const& entry);
+
+    /// The body of the background thread
+    void _run();
+
+    /**
+     * Process a single entry of the queue
+     *
+     * @param entry - the entry to be processed
+     * @return 'true' if a physical drop was performed (used for pacing)
+     */
+    bool _process(Entry& entry);
+
+    /// @return the chunk number parsed from the standard '_<chunk>' suffix
+    /// of a chunk table name, or -1 if the table is not partitioned
+    static int _chunkOf(std::string const& table);
+
+    /// Database connection parameters (set by setup())
+    mysql::MySqlConfig _mySqlConfig;
+
+    /// Counter of resources which are in use (set by setup())
+    std::shared_ptr<ResourceMonitor> _resourceMonitor;
+
+    /// The queue of entries awaiting deletion
+    std::deque<Entry> _queue;
+
+    /// The background thread (launched by setup())
+    std::thread _thread;
+
+    /// The flag indicating that the thread was launched
+    bool _running = false;
+
+    /// Wakes up the thread when entries are scheduled
+    std::condition_variable _cv;
+
+    /// Guards the queue and the state of the object
+    mutable std::mutex _mtx;
+};
+
+}}} // namespace lsst::qserv::wpublish
+
+#endif // LSST_QSERV_WPUBLISH_TABLE_GC_H
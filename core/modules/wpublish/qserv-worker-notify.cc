@@ -18,7 +18,10 @@
 #include "wpublish/ChunkGroupQservRequest.h"
 #include "wpublish/ChunkListQservRequest.h"
 #include "wpublish/GetChunkListQservRequest.h"
+#include "wpublish/GetSchedulerStatsQservRequest.h"
+#include "wpublish/ScheduleDropQservRequest.h"
 #include "wpublish/SetChunkListQservRequest.h"
+#include "wpublish/SetWorkerTuningQservRequest.h"
 #include "wpublish/TestEchoQservRequest.h"
 
 /// This C++ symbol is provided by the SSI shared library
@@ -35,8 +38,16 @@ namespace {
 std::string operation;
 std::string worker;
 std::string inFileName;
+unsigned long baseVersion;
 unsigned int chunk;
 std::vector<std::string> dbs;
+std::string db;
+std::string table;
+std::string scheduler;
+int priority;
+int maxReserve;
+int maxActiveChunks;
+unsigned int memManSizeMb;
 std::string value;
 std::string serviceProviderLocation;
 bool inUseOnly;
@@ -92,6 +103,59 @@ void readInFile(wpublish::SetChunkListQservRequest::ChunkCollection& chunks) {
     }
 }
 
+/**
+ * Read and parse a space/newline separated stream of signed pairs from
+ * the input file and fill the 'add' and 'remove' collections. Each pair
+ * has the following format:
+ *
+ *   (+|-)<database>:<chunk>
+ *
+ * For example:
+ *
+ *   +LSST:123 +LSST:124 -LSST:23456
+ *   -LSST:0
+ *
+ * @param add    - collection of chunks to be added (the '+' entries)
+ * @param remove - collection of chunks to be removed (the '-' entries)
+ */
+void readInFileDelta(wpublish::SetChunkListQservRequest::ChunkCollection& add,
+                     wpublish::SetChunkListQservRequest::ChunkCollection& remove) {
+
+    add.clear();
+    remove.clear();
+
+    std::ifstream infile(inFileName);
+    if (not infile.good()) {
+        std::cerr << "failed to open file: " << inFileName << std::endl;
+        throw std::runtime_error("failed to open file: " + inFileName);
+    }
+
+    std::string entry;
+    while (infile >> entry) {
+
+        if (entry.empty()) { continue; }
+
+        char const sign = entry[0];
+        std::string::size_type const pos = entry.rfind(':');
+        if (((sign != '+') and (sign != '-')) or
+            (pos == std::string::npos) or
+            (pos <= 1) or (pos == entry.size() - 1)) {
+            throw std::runtime_error(
+                "failed to parse file: " + inFileName + ", illegal (+|-)<database>:<chunk> entry: '" +
+                entry + "'");
+        }
+        unsigned long const chunk    = std::stoul(entry.substr(pos + 1));
+        std::string   const database = entry.substr(1, pos - 1);
+        (sign == '+' ? add : remove).emplace_back(
+            wpublish::SetChunkListQservRequest::Chunk{
+                (unsigned int)chunk,
+                database,
+                0   /* use_count (UNUSED) */
+            }
+        );
+    }
+}
+
 int test() {
 
     // Instantiate a request object
@@ -127,6 +191,40 @@ int test() {
                 finished = true;
             });
 
+        } else if ("GET_SCHEDULER_STATS" == operation) {
+            request = wpublish::GetSchedulerStatsQservRequest::create(
+                [&finished] (wpublish::GetSchedulerStatsQservRequest::Status status,
+                             std::string const& error,
+                             wpublish::GetSchedulerStatsQservRequest::SchedulerStatsCollection const& schedulers) {
+
+                    if (status != wpublish::GetSchedulerStatsQservRequest::Status::SUCCESS) {
+                        std::cout << "status: " << wpublish::GetSchedulerStatsQservRequest::status2str(status) << "\n"
+                                  << "error:  " << error << std::endl;
+                    } else {
+                        std::cout << "# total schedulers: " << schedulers.size() << "\n"
+                                  << std::endl;
+                        for (auto const& entry: schedulers) {
+                            std::cout << entry.name << ":\n"
+                                      << "  in flight:        " << entry.in_flight        << "\n"
+                                      << "  tasks queued:     " << entry.tasks_queued     << "\n"
+                                      << "  tasks started:    " << entry.tasks_started    << "\n"
+                                      << "  tasks completed:  " << entry.tasks_completed  << "\n"
+                                      << "  time in queue ms: " << entry.time_in_queue_ms << "\n"
+                                      << "  bytes locked:     " << entry.bytes_locked     << "\n";
+                            std::cout << "  queue depth histogram:  ";
+                            for (auto count: entry.queue_depth_histogram) {
+                                std::cout << " " << count;
+                            }
+                            std::cout << "\n  time in queue histogram:";
+                            for (auto count: entry.time_in_queue_histogram) {
+                                std::cout << " " << count;
+                            }
+                            std::cout << "\n" << std::endl;
+                        }
+                    }
+                    finished = true;
+                });
+
         } else if ("SET_CHUNK_LIST" == operation) {
 
             wpublish::SetChunkListQservRequest::ChunkCollection chunks;
@@ -137,13 +235,15 @@ int test() {
                 force,
                 [&finished] (wpublish::SetChunkListQservRequest::Status status,
                              std::string const& error,
-                             wpublish::SetChunkListQservRequest::ChunkCollection const& chunks) {
+                             wpublish::SetChunkListQservRequest::ChunkCollection const& chunks,
+                             uint64_t version) {
 
                     if (status != wpublish::SetChunkListQservRequest::Status::SUCCESS) {
                         std::cout << "status: " << wpublish::SetChunkListQservRequest::status2str(status) << "\n"
                                   << "error:  " << error << std::endl;
                     } else {
-                        std::cout << "# total chunks: " << chunks.size() << "\n"
+                        std::cout << "# list version: " << version << "\n"
+                                  << "# total chunks: " << chunks.size() << "\n"
                                   << std::endl;
                         if (chunks.size()) {
                             std::cout << "      chunk |                         database | in use \n"
@@ -159,6 +259,36 @@ int test() {
                     finished = true;
                 });
 
+    } else if ("UPDATE_CHUNK_LIST" == operation) {
+
+            wpublish::SetChunkListQservRequest::ChunkCollection add;
+            wpublish::SetChunkListQservRequest::ChunkCollection remove;
+            readInFileDelta(add, remove);
+
+            request = wpublish::SetChunkListQservRequest::createDelta(
+                add,
+                remove,
+                baseVersion,
+                force,
+                [&finished] (wpublish::SetChunkListQservRequest::Status status,
+                             std::string const& error,
+                             wpublish::SetChunkListQservRequest::ChunkCollection const& chunks,
+                             uint64_t version) {
+
+                    if (status != wpublish::SetChunkListQservRequest::Status::SUCCESS) {
+                        std::cout << "status: " << wpublish::SetChunkListQservRequest::status2str(status) << "\n"
+                                  << "error:  " << error << std::endl;
+                        if (status == wpublish::SetChunkListQservRequest::Status::MISMATCH) {
+                            std::cout << "# current list version: " << version << std::endl;
+                        }
+                    } else {
+                        std::cout << "# list version: " << version << "\n"
+                                  << "# total chunks: " << chunks.size() << "\n"
+                                  << std::endl;
+                    }
+                    finished = true;
+                });
+
     } else if ("REBUILD_CHUNK_LIST" == operation) {
         request = wpublish::RebuildChunkListQservRequest::create(
             reload,
@@ -223,6 +353,50 @@ int test() {
                 finished = true;
             });
 
+    } else if ("SET_WORKER_TUNING" == operation) {
+
+        std::vector<wpublish::SetWorkerTuningQservRequest::SchedulerTuning> schedulers;
+        if (not scheduler.empty()) {
+            wpublish::SetWorkerTuningQservRequest::SchedulerTuning tuning;
+            tuning.name = scheduler;
+            tuning.priority = priority;
+            tuning.maxReserve = maxReserve;
+            tuning.maxActiveChunks = maxActiveChunks;
+            schedulers.push_back(tuning);
+        }
+        request = wpublish::SetWorkerTuningQservRequest::create(
+            schedulers,
+            memManSizeMb,
+            [&finished] (wpublish::SetWorkerTuningQservRequest::Status status,
+                         std::string const& error,
+                         unsigned int applied) {
+
+                if (status != wpublish::SetWorkerTuningQservRequest::Status::SUCCESS) {
+                    std::cout << "status: " << wpublish::SetWorkerTuningQservRequest::status2str(status) << "\n"
+                              << "error:  " << error << std::endl;
+                } else {
+                    std::cout << "# parameters applied: " << applied << std::endl;
+                }
+                finished = true;
+            });
+
+    } else if ("SCHEDULE_DROP" == operation) {
+        request = wpublish::ScheduleDropQservRequest::create(
+            db,
+            table,
+            [&finished] (wpublish::ScheduleDropQservRequest::Status status,
+                         std::string const& error,
+                         unsigned int pending) {
+
+                if (status != wpublish::ScheduleDropQservRequest::Status::SUCCESS) {
+                    std::cout << "status: " << wpublish::ScheduleDropQservRequest::status2str(status) << "\n"
+                              << "error:  " << error << std::endl;
+                } else {
+                    std::cout << "# entries pending deletion: " << pending << std::endl;
+                }
+                finished = true;
+            });
+
     } else if ("TEST_ECHO" == operation) {
         request = wpublish::TestEchoQservRequest::create(
             value,
@@ -292,12 +466,18 @@ int main(int argc, const char* const argv[]) {
             "              [--print-report]\n"
             "\n"
             "Supported operations and mandatory parameters:\n"
-            "    GET_CHUNK_LIST     <worker>\n"
+            "    GET_CHUNK_LIST      <worker>\n"
+            "    GET_SCHEDULER_STATS <worker>\n"
             "    SET_CHUNK_LIST     <worker> <infile>\n"
+            "    UPDATE_CHUNK_LIST  <worker> <version> <infile-delta>\n"
             "    REBUILD_CHUNK_LIST <worker>\n"
             "    RELOAD_CHUNK_LIST  <worker>\n"
             "    ADD_CHUNK_GROUP    <worker> <chunk> <db> [<db> [<db> ... ]]\n"
             "    REMOVE_CHUNK_GROUP <worker> <chunk> <db> [<db> [<db> ... ]]\n"
+            "    SCHEDULE_DROP      <worker> <db> [--table=<table>]\n"
+            "    SET_WORKER_TUNING  <worker> [--scheduler=<name>] [--priority=<num>]\n"
+            "                       [--max-reserve=<num>] [--max-active-chunks=<num>]\n"
+            "                       [--memman-size-mb=<num>]\n"
             "    TEST_ECHO          <worker> <value>\n"
             "\n"
             "Flags an options:\n"
@@ -306,22 +486,40 @@ int main(int argc, const char* const argv[]) {
             "                          Otherwise all chunks will be reported\n"
             "  --reload              - used with REBUILD_CHUNK_LIST to also reload the list into a worker\n"
             "  --force               - force operation in REMOVE_CHUNK_GROUP even for chunks in use\n"
+            "  --table=<table>       - used with SCHEDULE_DROP to schedule a single table instead\n"
+            "                          of the whole database\n"
+            "  --scheduler=<name>    - used with SET_WORKER_TUNING to select the scheduler to tune\n"
+            "                          (e.g. 'SchedFast'); the three options below apply to it and\n"
+            "                          negative or omitted values leave a parameter unchanged\n"
+            "  --priority=<num>           - new priority of the scheduler\n"
+            "  --max-reserve=<num>        - new thread reserve of the scheduler\n"
+            "  --max-active-chunks=<num>  - new concurrent chunk limit of the scheduler\n"
+            "  --memman-size-mb=<num>     - used with SET_WORKER_TUNING to set a new memory budget\n"
             "  --print-report        - print \n"
             "\n"
             "Parameters:\n"
             "  <worker>  - unique identifier of a worker (example: 'worker-1')\n"
             "  <infile>  - text file with space or newline separated pairs of <database>:<chunk>\n"
+            "  <infile-delta> - text file with space or newline separated entries of\n"
+            "              (+|-)<database>:<chunk> where '+' means the chunk is to be added\n"
+            "              to the worker's list and '-' that it's to be removed\n"
+            "  <version> - the version of the worker's chunk list the delta was computed\n"
+            "              against (as reported by SET_CHUNK_LIST or UPDATE_CHUNK_LIST)\n"
             "  <chunk>   - chunk number\n"
             "  <db>      - database name\n"
             "  <value>   - arbitrary string\n");
 
         ::operation = parser.parameterRestrictedBy(1, {
             "GET_CHUNK_LIST",
+            "GET_SCHEDULER_STATS",
             "SET_CHUNK_LIST",
+            "UPDATE_CHUNK_LIST",
             "REBUILD_CHUNK_LIST",
             "RELOAD_CHUNK_LIST",
             "ADD_CHUNK_GROUP",
             "REMOVE_CHUNK_GROUP",
+            "SCHEDULE_DROP",
+            "SET_WORKER_TUNING",
             "TEST_ECHO"});
 
         ::worker = parser.parameter<std::string>(2);
@@ -330,17 +528,32 @@ int main(int argc, const char* const argv[]) {
             "SET_CHUNK_LIST"})) {
             ::inFileName = parser.parameter<std::string>(3);
 
+        } else if (parser.in(::operation, {
+            "UPDATE_CHUNK_LIST"})) {
+            ::baseVersion = parser.parameter<unsigned long>(3);
+            ::inFileName  = parser.parameter<std::string>(4);
+
         } else if (parser.in(::operation, {
             "ADD_CHUNK_GROUP",
             "REMOVE_CHUNK_GROUP"})) {
             ::chunk = parser.parameter<unsigned int>(3);
             ::dbs   = parser.parameters<std::string>(4);
 
+        } else if (parser.in(::operation, {
+            "SCHEDULE_DROP"})) {
+            ::db = parser.parameter<std::string>(3);
+
         } else if (parser.in(::operation, {
             "TEST_ECHO"})) {
             ::value = parser.parameter<std::string>(3);
         }
         ::serviceProviderLocation = parser.option<std::string>("service", "localhost:1094");
+        ::table                   = parser.option<std::string>("table", "");
+        ::scheduler               = parser.option<std::string>("scheduler", "");
+        ::priority                = parser.option<int>("priority", -1);
+        ::maxReserve              = parser.option<int>("max-reserve", -1);
+        ::maxActiveChunks         = parser.option<int>("max-active-chunks", -1);
+        ::memManSizeMb            = parser.option<unsigned int>("memman-size-mb", 0);
         ::inUseOnly               = parser.flag("in-use-only");
         ::reload                  = parser.flag("reload");
         ::force                   = parser.flag("force");
@@ -1,13 +1,45 @@
+/**
+ * @file
+ *
+ * @brief Load generator for Qserv workers.
+ *
+ * Two operations are supported:
+ *
+ *   ECHO  - the original mode: flood the worker management service with
+ *           TEST_ECHO requests (protocol sanity and small-message rates);
+ *
+ *   TASKS - submit a stream of synthetic TaskMsg queries directly to the
+ *           worker SSI service, mixing interactive point queries and
+ *           shared-scan fragments over the worker's chunk tables. Arrivals
+ *           are open-loop (Poisson at --rate tasks per second, regardless
+ *           of completions), so the worker sees realistic queueing rather
+ *           than a closed feedback loop. Per-class latency percentiles
+ *           and throughput are reported at the end.
+ *
+ * TASKS lets worker builds and storage configurations be qualified on a
+ * test node without borrowing the production cluster; the chunk tables
+ * referenced by the query templates must exist on the worker.
+ */
+
 // System header
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
 #include <iostream>
 #include <iomanip>
 #include <fstream>
+#include <mutex>
+#include <random>
 #include <stdexcept>
 #include <string>
+#include <thread>
 #include <vector>
 
 // Third party headers
+#include "XrdSsi/XrdSsiErrInfo.hh"
 #include "XrdSsi/XrdSsiProvider.hh"
+#include "XrdSsi/XrdSsiRequest.hh"
 #include "XrdSsi/XrdSsiService.hh"
 
 // Qserv headers
@@ -21,6 +53,7 @@
 extern XrdSsiProvider* XrdSsiProviderClient;
 
 namespace global   = lsst::qserv;
+namespace proto    = lsst::qserv::proto;
 namespace util     = lsst::qserv::util;
 namespace wpublish = lsst::qserv::wpublish;
 
@@ -28,13 +61,24 @@ namespace {
 
 // Command line parameters
 
+std::string  operation;
 std::string  workersFileName;
 unsigned int numRequests;
 std::string  value;
+std::string  db;
 std::string  serviceProviderLocation;
 unsigned int numWorkers;
 bool workerFirst;
 
+unsigned int rate;
+unsigned int scanPercent;
+unsigned int numChunks;
+unsigned int scanPriority;
+bool lockInMemory;
+std::string  queryTemplate;
+std::string  scanQueryTemplate;
+std::string  resultTable;
+
 
 std::vector<std::string> workers;
 
@@ -58,6 +102,284 @@ bool readWorkersFile() {
 }
 
 
+uint64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+
+/// Replace every occurrence of 'key' in 'text' with 'val'.
+std::string substitute(std::string text, std::string const& key, std::string const& val) {
+    for (std::string::size_type pos = text.find(key);
+         pos != std::string::npos;
+         pos = text.find(key, pos + val.size())) {
+        text.replace(pos, key.size(), val);
+    }
+    return text;
+}
+
+
+/**
+ * Class TaskRequest submits one serialized TaskMsg to a worker SSI service
+ * and drains (discards) the response stream, reporting the total number of
+ * response bytes to its completion callback. Instances hold themselves
+ * alive until the request is finished.
+ */
+class TaskRequest : public XrdSsiRequest {
+
+public:
+
+    /// Called exactly once: success flag and response bytes received.
+    using OnFinish = std::function<void(bool, uint64_t)>;
+
+    // Copy semantics is prohibited
+    TaskRequest(TaskRequest const&) = delete;
+    TaskRequest& operator=(TaskRequest const&) = delete;
+
+    /// Create a request and submit it to the service for the given resource
+    static void submit(XrdSsiService* service,
+                       std::string const& resourcePath,
+                       std::string const& payload,
+                       OnFinish const& onFinish) {
+        std::shared_ptr<TaskRequest> const request(new TaskRequest(payload, onFinish));
+        request->_self = request;
+        XrdSsiResource resource(resourcePath);
+        service->ProcessRequest(*request, resource);
+    }
+
+    ~TaskRequest() override = default;
+
+protected:
+
+    char* GetRequest(int& dlen) override {
+        dlen = _payload.size();
+        return const_cast<char*>(_payload.data());
+    }
+
+    bool ProcessResponse(const XrdSsiErrInfo&  eInfo,
+                         const XrdSsiRespInfo& rInfo) override {
+        if (eInfo.hasError()) {
+            _finish(false);
+            return false;
+        }
+        switch (rInfo.rType) {
+            case XrdSsiRespInfo::isData:
+            case XrdSsiRespInfo::isStream:
+                GetResponseData(_buf, sizeof(_buf));
+                return true;
+            default:
+                _finish(false);
+                return false;
+        }
+    }
+
+    XrdSsiRequest::PRD_Xeq ProcessResponseData(const XrdSsiErrInfo& eInfo,
+                                               char* buff,
+                                               int   blen,
+                                               bool  last) override {
+        if (eInfo.hasError() or (blen < 0)) {
+            _finish(false);
+            return XrdSsiRequest::PRD_Normal;
+        }
+        _bytes += blen;
+        if (last) {
+            _finish(true);
+        } else {
+            GetResponseData(_buf, sizeof(_buf));
+        }
+        return XrdSsiRequest::PRD_Normal;
+    }
+
+private:
+
+    TaskRequest(std::string const& payload, OnFinish const& onFinish)
+        :   _payload(payload),
+            _onFinish(onFinish),
+            _bytes(0) {
+    }
+
+    void _finish(bool success) {
+        // Copy what the callback needs and release the self-reference before
+        // notifying XRootD/SSI, after which the object may get deleted.
+        OnFinish const onFinish = _onFinish;
+        uint64_t const bytes = _bytes;
+        std::shared_ptr<TaskRequest> const self = _self;
+        _self.reset();
+
+        Finished();
+
+        onFinish(success, bytes);
+    }
+
+    std::string const _payload;     ///< serialized TaskMsg
+    OnFinish    const _onFinish;
+    uint64_t _bytes;                ///< response bytes received so far
+    char _buf[65536];               ///< staging buffer for response data
+
+    std::shared_ptr<TaskRequest> _self; ///< keeps the object alive until finished
+};
+
+
+/// Latency samples and counters of one task class (interactive or scan)
+struct ClassStats {
+    std::vector<double> latencyMs;
+    uint64_t bytes = 0;
+    unsigned int errors = 0;
+};
+
+
+double percentile(std::vector<double> const& sorted, double p) {
+    if (sorted.empty()) return 0.;
+    size_t idx = std::min(sorted.size() - 1,
+                          static_cast<size_t>(p * sorted.size()));
+    return sorted[idx];
+}
+
+
+void reportClass(std::string const& name, ClassStats& stats, double wallSec) {
+    std::sort(stats.latencyMs.begin(), stats.latencyMs.end());
+    std::cout << "  " << std::left << std::setw(12) << name << std::right
+              << std::setw(8) << stats.latencyMs.size() << " ok, "
+              << std::setw(4) << stats.errors << " err, "
+              << std::fixed << std::setprecision(1)
+              << std::setw(8) << (stats.latencyMs.size() / wallSec) << " task/s, "
+              << std::setprecision(2)
+              << (stats.bytes / 1048576.) << " MB received\n"
+              << "               latency ms: p50 " << percentile(stats.latencyMs, 0.50)
+              << "  p90 " << percentile(stats.latencyMs, 0.90)
+              << "  p99 " << percentile(stats.latencyMs, 0.99)
+              << "  max " << (stats.latencyMs.empty() ? 0. : stats.latencyMs.back())
+              << std::endl;
+}
+
+
+/// Build the serialized TaskMsg of one synthetic task
+std::string makeTaskPayload(uint64_t queryId, int jobId, int chunk,
+                            bool scan, std::mt19937& rng) {
+
+    std::string const chunkStr = std::to_string(chunk);
+
+    proto::TaskMsg msg;
+    msg.set_session(0);
+    msg.set_db(::db);
+    msg.set_protocol(2);
+    msg.set_queryid(queryId);
+    msg.set_jobid(jobId);
+    msg.set_attemptcount(0);
+    msg.set_chunkid(chunk);
+    msg.set_scaninteractive(not scan);
+    if (scan) {
+        msg.set_scanpriority(::scanPriority);
+        proto::TaskMsg_ScanTable* scanTbl = msg.add_scantable();
+        scanTbl->set_db(::db);
+        scanTbl->set_table("Object");
+        scanTbl->set_lockinmemory(::lockInMemory);
+        scanTbl->set_scanrating(::scanPriority);
+    }
+    std::string query = scan ? ::scanQueryTemplate : ::queryTemplate;
+    query = substitute(query, "%DB%",    ::db);
+    query = substitute(query, "%CHUNK%", chunkStr);
+    query = substitute(query, "%ID%",    std::to_string(rng() % 1000000000));
+
+    proto::TaskMsg_Fragment* frag = msg.add_fragment();
+    frag->add_query(query);
+    frag->set_resulttable(::resultTable);
+
+    std::string payload;
+    msg.SerializeToString(&payload);
+    return payload;
+}
+
+
+int benchmark() {
+
+    // Connect to a service provider
+    XrdSsiErrInfo errInfo;
+    auto serviceProvider =
+        XrdSsiProviderClient->GetService(errInfo,
+                                         serviceProviderLocation);
+    if (!serviceProvider) {
+        std::cerr
+            << "failed to contact service provider at: " << serviceProviderLocation
+            << ", error: " << errInfo.Get() << std::endl;
+        return 1;
+    }
+    std::cout << "connected to service provider at: " << serviceProviderLocation << std::endl;
+
+    std::mt19937 rng(123);
+    std::bernoulli_distribution pickScan(scanPercent / 100.);
+    std::exponential_distribution<double> interArrivalSec(rate > 0 ? rate : 1.);
+
+    std::atomic<unsigned int> outstanding(0);
+    std::mutex statsMtx;
+    ClassStats interactiveStats;
+    ClassStats scanStats;
+
+    // Open-loop submission: tasks are launched on their (Poisson) arrival
+    // times whether or not earlier tasks have completed, so a worker that
+    // cannot keep up accumulates queueing delay instead of throttling the
+    // generator.
+    uint64_t const startNs = nowNs();
+    uint64_t nextArrivalNs = startNs;
+
+    for (unsigned int i = 0; i < numRequests; ++i) {
+
+        if (rate > 0) {
+            nextArrivalNs += static_cast<uint64_t>(interArrivalSec(rng) * 1e9);
+            int64_t const aheadNs = nextArrivalNs - nowNs();
+            if (aheadNs > 0) {
+                std::this_thread::sleep_for(std::chrono::nanoseconds(aheadNs));
+            }
+        }
+        bool const scan = pickScan(rng);
+        int const chunk = rng() % numChunks;
+
+        std::string const payload = makeTaskPayload(1000 + i, i, chunk, scan, rng);
+
+        // Tasks address chunk resources ("/chk/<db>/<chunk>"); the provider
+        // resolves them to whichever worker serves the chunk.
+        global::ResourceUnit ru;
+        ru.setAsDbChunk(db, chunk);
+
+        uint64_t const submittedNs = nowNs();
+        outstanding++;
+        ClassStats& stats = scan ? scanStats : interactiveStats;
+        TaskRequest::submit(
+            serviceProvider, ru.path(), payload,
+            [&outstanding, &statsMtx, &stats, submittedNs] (bool success, uint64_t bytes) {
+                std::lock_guard<std::mutex> lock(statsMtx);
+                if (success) {
+                    stats.latencyMs.push_back((nowNs() - submittedNs) / 1e6);
+                    stats.bytes += bytes;
+                } else {
+                    stats.errors++;
+                }
+                outstanding--;
+            });
+    }
+    uint64_t const submittedAllNs = nowNs();
+
+    // Block while at least one request is in progress
+    util::BlockPost blockPost(1000, 2000);
+    while (outstanding) {
+        blockPost.wait(200);
+    }
+    uint64_t const endNs = nowNs();
+
+    double const wallSec = (endNs - startNs) / 1e9;
+    std::cout << "\nsubmitted " << numRequests << " tasks in "
+              << std::fixed << std::setprecision(2) << ((submittedAllNs - startNs) / 1e9)
+              << " s (offered rate: " << (rate > 0 ? std::to_string(rate) : std::string("unpaced"))
+              << " task/s), drained in " << wallSec << " s\n" << std::endl;
+    {
+        std::lock_guard<std::mutex> lock(statsMtx);
+        reportClass("interactive", interactiveStats, wallSec);
+        reportClass("scan",        scanStats,        wallSec);
+    }
+    return (interactiveStats.errors or scanStats.errors) ? 1 : 0;
+}
+
+
 int test() {
 
     if (not readWorkersFile()) return 1;
@@ -172,31 +494,90 @@ int main(int argc, const char* const argv[]) {
             argv,
             "\n"
             "Usage:\n"
-            "  <workers-file-name> <num-requests> <value>\n"
-            "  [--service=<provider>]\n"
-            "  [--num-workers=<value>]\n"
-            "  [--worker-first]\b"
+            "  <operation> [<parameter> [<parameter> [...]]]\n"
+            "              [--service=<provider>]\n"
+            "              [--num-workers=<value>]\n"
+            "              [--worker-first]\n"
+            "              [--rate=<tasks-per-sec>]\n"
+            "              [--scan-percent=<value>]\n"
+            "              [--chunks=<value>]\n"
+            "              [--scan-priority=<value>]\n"
+            "              [--lock-in-memory]\n"
+            "              [--query=<template>]\n"
+            "              [--scan-query=<template>]\n"
+            "              [--result-table=<name>]\n"
+            "\n"
+            "Supported operations and mandatory parameters:\n"
+            "    ECHO  <workers-file-name> <num-requests> <value>\n"
+            "    TASKS <num-requests> <db>\n"
             "\n"
             "Flags an options:\n"
-            "  --service=<provider>  - location of a service provider (default: 'localhost:1094')\n"
-            "  --num-workers=<value> - the number of workers (default: 1, range: 1..10)\n"
-            "  --worker-first        - iterate over workers, then over requests\n"
+            "  --service=<provider>    - location of a service provider (default: 'localhost:1094')\n"
+            "  --num-workers=<value>   - the number of workers (default: 1, range: 1..10)\n"
+            "  --worker-first          - used with ECHO to iterate over workers, then over requests\n"
+            "  --rate=<tasks-per-sec>  - used with TASKS for the open-loop (Poisson) arrival rate.\n"
+            "                            Zero submits tasks back-to-back (default: 0)\n"
+            "  --scan-percent=<value>  - used with TASKS for the share of shared-scan tasks, the rest\n"
+            "                            being interactive point queries (default: 20, range: 0..100)\n"
+            "  --chunks=<value>        - used with TASKS: chunk numbers are drawn from 0..<value>-1\n"
+            "                            (default: 1000)\n"
+            "  --scan-priority=<value> - used with TASKS for the scan priority (rating) of scan tasks\n"
+            "                            (default: 1)\n"
+            "  --lock-in-memory        - used with TASKS to ask for chunk locking of scan tables\n"
+            "  --query=<template>      - used with TASKS: interactive query template. Placeholders\n"
+            "                            %DB%, %CHUNK% and %ID% are substituted per task\n"
+            "                            (default: 'SELECT * FROM %DB%.Object_%CHUNK% WHERE objectId=%ID%')\n"
+            "  --scan-query=<template> - used with TASKS: scan fragment query template, with the same\n"
+            "                            placeholders (default: 'SELECT COUNT(*) FROM %DB%.Object_%CHUNK%')\n"
+            "  --result-table=<name>   - used with TASKS: name of the worker-side result table\n"
+            "                            (default: 'perf_result')\n"
             "\n"
             "Parameters:\n"
             "  <workers-file-name>  - a file with worker identifiers (one worker per line)\n"
-            "  <num-requests>       - chunk number\n"
-            "  <value>              - arbitrary string\n");
-
-        ::workersFileName = parser.parameter<std::string>(1);
-        ::numRequests     = parser.parameter<unsigned int>(2);
-        ::value           = parser.parameter<std::string>(3);
+            "  <num-requests>       - the total number of requests (ECHO) or tasks (TASKS)\n"
+            "  <value>              - arbitrary string\n"
+            "  <db>                 - the database whose chunk tables the tasks query\n");
+
+        ::operation = parser.parameterRestrictedBy(1, {
+            "ECHO",
+            "TASKS"});
+
+        if (::operation == "ECHO") {
+            ::workersFileName = parser.parameter<std::string>(2);
+            ::numRequests     = parser.parameter<unsigned int>(3);
+            ::value           = parser.parameter<std::string>(4);
+        } else {
+            ::numRequests     = parser.parameter<unsigned int>(2);
+            ::db              = parser.parameter<std::string>(3);
+        }
 
         ::serviceProviderLocation = parser.option<std::string>("service", "localhost:1094");
         ::numWorkers              = parser.option<unsigned int>("num-workers", 1);
         ::workerFirst             = parser.flag("worker-first");
 
+        ::rate              = parser.option<unsigned int>("rate", 0);
+        ::scanPercent       = parser.option<unsigned int>("scan-percent", 20);
+        ::numChunks         = parser.option<unsigned int>("chunks", 1000);
+        ::scanPriority      = parser.option<unsigned int>("scan-priority", 1);
+        ::lockInMemory      = parser.flag("lock-in-memory");
+        ::queryTemplate     = parser.option<std::string>(
+            "query", "SELECT * FROM %DB%.Object_%CHUNK% WHERE objectId=%ID%");
+        ::scanQueryTemplate = parser.option<std::string>(
+            "scan-query", "SELECT COUNT(*) FROM %DB%.Object_%CHUNK%");
+        ::resultTable       = parser.option<std::string>("result-table", "perf_result");
+
+        if (::scanPercent > 100) {
+            std::cerr << "error: --scan-percent must be in 0..100" << std::endl;
+            return 1;
+        }
+        if (not ::numChunks) {
+            std::cerr << "error: --chunks must be positive" << std::endl;
+            return 1;
+        }
+
     } catch (std::exception const& ex) {
         return 1;
     }
+    if (::operation == "TASKS") return ::benchmark();
     return ::test();
 }
@@ -135,4 +135,20 @@ BOOST_AUTO_TEST_CASE(WorkerId) {
     BOOST_CHECK(ci.id() == "worker");
 }
 
+BOOST_AUTO_TEST_CASE(Version) {
+    std::shared_ptr<ChunkSql> cs = std::make_shared<ChunkSql>(chunks, workerId);
+    ChunkInventory ci("test", cs);
+
+    // Each mutation of the chunk map advances the version
+    uint64_t version = ci.version();
+    ci.add("LSST", 123);
+    BOOST_CHECK_EQUAL(ci.version(), version + 1);
+    ci.remove("LSST", 123);
+    BOOST_CHECK_EQUAL(ci.version(), version + 2);
+
+    // Removing a chunk which is not in the inventory is a no-op
+    ci.remove("LSST", 123);
+    BOOST_CHECK_EQUAL(ci.version(), version + 2);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
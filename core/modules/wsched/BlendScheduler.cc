@@ -35,6 +35,7 @@
 // System headers
 #include <algorithm>
 #include <cstddef>
+#include <ctime>
 #include <iostream>
 #include <mutex>
 #include <sstream>
@@ -46,6 +47,7 @@
 #include "global/Bug.h"
 #include "proto/worker.pb.h"
 #include "util/EventThread.h"
+#include "util/NumaNode.h"
 #include "wcontrol/Foreman.h"
 #include "wsched/GroupScheduler.h"
 #include "wsched/ScanScheduler.h"
@@ -85,8 +87,10 @@ BlendScheduler::BlendScheduler(std::string const& name,
     for (auto const& sched : scanSchedulers) {
         _schedulers.push_back(sched);
         sched->setBlendScheduler(this);
+        _scanScheds.push_back(sched);
     }
     _schedulers.push_back(_scanSnail);
+    _scanScheds.push_back(_scanSnail);
     assert(_schedulers.size() >= 2); // Must have at least _group and _scanSnail in the list.
     _sortScanSchedulers();
     for (auto sched : _schedulers) {
@@ -109,11 +113,13 @@ BlendScheduler::~BlendScheduler() {
 
 void BlendScheduler::_sortScanSchedulers() {
     auto greaterThan = [](SchedulerBase::Ptr const& a, SchedulerBase::Ptr const& b)->bool {
-        // Experiment of sorts, priority depends on number of Tasks in each scheduler.
-        auto aVal = a->getPriority() + a->getUserQueriesInQ();
-        auto bVal = b->getPriority() + b->getUserQueriesInQ();
+        // Experiment of sorts, priority depends on number of Tasks in each scheduler
+        // and how long Tasks have been waiting on it.
+        auto aVal = a->getPriority() + a->getUserQueriesInQ() + a->getAgePriority();
+        auto bVal = b->getPriority() + b->getUserQueriesInQ() + b->getAgePriority();
         return aVal > bVal;
     };
+    _lastReorderScans = std::chrono::steady_clock::now();
     // The first scheduler should always be _group (for interactive queries).
     if (_schedulers.size() >= 2) {
         std::sort(_schedulers.begin()+1, _schedulers.end(), greaterThan);
@@ -123,6 +129,15 @@ void BlendScheduler::_sortScanSchedulers() {
 }
 
 
+void BlendScheduler::setPrefetchFunc(
+        std::function<void(std::vector<std::shared_ptr<wbase::Task>> const&)> const& func) {
+    std::lock_guard<std::mutex> lock(util::CommandQueue::_mx);
+    for (auto const& sched : _schedulers) {
+        sched->setPrefetchFunc(func);
+    }
+}
+
+
 void BlendScheduler::queCmd(util::Command::Ptr const& cmd) {
     wbase::Task::Ptr task = std::dynamic_pointer_cast<wbase::Task>(cmd);
     if (task == nullptr) {
@@ -185,8 +200,10 @@ void BlendScheduler::queCmd(util::Command::Ptr const& cmd) {
     task->setTaskScheduler(s);
 
     LOGS(_log, LOG_LVL_DEBUG, "Blend queCmd " << task->getIdStr());
-    s->queCmd(task);
+    // Timestamp the Task before it becomes visible to the sub-scheduler, so
+    // another thread can't pull it off the queue with the time still unset.
     _queries->queuedTask(task);
+    s->queCmd(task);
     _infoChanged = true;
     notify(true);
 }
@@ -238,13 +255,34 @@ bool BlendScheduler::ready() {
 }
 
 
+void BlendScheduler::notify(bool all) {
+    ++_readyEvents;
+    util::CommandQueue::notify(all);
+}
+
+
 /// Returns true when any sub-scheduler has a command ready.
 /// Precondition util::CommandQueue::_mx must be locked when this is called.
 bool BlendScheduler::_ready() {
+    // Edge-triggered readiness: when no scheduling event has arrived since the
+    // last probe came up empty, return the cached answer. Without this, every
+    // pool thread waking on a notification re-ran the MemMan forecasts of all
+    // scan schedulers, which is most of the idle-loop cost on a starved worker.
+    // The event count is read before probing, so an event arriving mid-probe
+    // forces a fresh probe next time. A cached 'true' is never returned, as
+    // getCmd() consumes Tasks without raising an event.
+    uint64_t const events = _readyEvents.load();
+    if (events == _readyEventsSeen && !_readyCached) {
+        return false;
+    }
+
     std::ostringstream os;
     bool ready = false;
 
-    if (_flagReorderScans) {
+    // Re-sort when flagged and periodically, as getAgePriority() grows over time
+    // without setting the flag.
+    if (_flagReorderScans
+        || std::chrono::steady_clock::now() - _lastReorderScans > std::chrono::minutes(1)) {
         _flagReorderScans = false;
         _sortScanSchedulers();
     }
@@ -267,6 +305,8 @@ bool BlendScheduler::_ready() {
     if (changed) {
         LOGS(_log, LOG_LVL_DEBUG, getName() << "_ready() " << os.str());
     }
+    _readyEventsSeen = events;
+    _readyCached = ready;
     return ready;
 }
 
@@ -276,20 +316,67 @@ util::Command::Ptr BlendScheduler::getCmd(bool wait) {
         util::CommandQueue::_cv.wait(lock, [this](){return _ready();});
     }
 
-    // Try to get a command from the schedulers
     util::Command::Ptr cmd;
-    int availableThreads = calcAvailableTheads();
+
+    // Earliest deadline first check. A ready Task that has been queued longer
+    // than its scheduler's maxTimeMinutes is overdue and its UserQuery is at
+    // risk of missing its completion estimate, so it briefly jumps the normal
+    // priority order, including _group.
+    time_t const timeNow = time(nullptr);
+    ScanScheduler::Ptr overdueSched;
+    time_t overdueDeadline = 0;
     for (auto const& sched : _schedulers) {
-        availableThreads = sched->applyAvailableThreads(availableThreads);
-        cmd = sched->getCmd(false); // no wait
+        auto scan = std::dynamic_pointer_cast<ScanScheduler>(sched);
+        if (scan == nullptr) continue;
+        time_t deadline = scan->readyTaskDeadline();
+        if (deadline != 0 && deadline <= timeNow
+            && (overdueSched == nullptr || deadline < overdueDeadline)) {
+            overdueSched = scan;
+            overdueDeadline = deadline;
+        }
+    }
+    if (overdueSched != nullptr) {
+        int availableThreads = calcAvailableTheads();
+        availableThreads = overdueSched->applyAvailableThreads(availableThreads);
+        cmd = overdueSched->getCmd(false); // no wait
         if (cmd != nullptr) {
-            LOGS(_log, LOG_LVL_DEBUG, "Blend getCmd() using cmd from " << sched->getName());
-            wbase::Task::Ptr task = std::dynamic_pointer_cast<wbase::Task>(cmd);
-            break;
+            LOGS(_log, LOG_LVL_DEBUG, "Blend getCmd() overdue cmd from " << overdueSched->getName()
+                 << " late=" << timeNow - overdueDeadline << "sec");
+        }
+    }
+
+    // Try to get a command from the schedulers.
+    // On a multi-node host, the first pass passes over scan schedulers whose ready
+    // Task's chunk was locked on a different NUMA node than this thread, leaving
+    // that Task for a thread running on the right node. The second pass takes
+    // anything, so a Task is never stranded waiting for a matching thread.
+    int const numaPasses = (util::NumaNode::nodeCount() > 1) ? 2 : 1;
+    int const myNode = (numaPasses > 1) ? util::NumaNode::currentNode() : -1;
+    for (int pass = 0; pass < numaPasses && cmd == nullptr; ++pass) {
+        int availableThreads = calcAvailableTheads();
+        for (auto const& sched : _schedulers) {
+            availableThreads = sched->applyAvailableThreads(availableThreads);
+            if (pass == 0 && numaPasses > 1 && myNode >= 0) {
+                auto scan = std::dynamic_pointer_cast<ScanScheduler>(sched);
+                if (scan != nullptr) {
+                    int node = scan->readyTaskNode();
+                    if (node >= 0 && node != myNode) {
+                        LOGS(_log, LOG_LVL_DEBUG, "Blend getCmd() leaving " << sched->getName()
+                             << " for node=" << node << " myNode=" << myNode);
+                        continue;
+                    }
+                }
+            }
+            cmd = sched->getCmd(false); // no wait
+            if (cmd != nullptr) {
+                LOGS(_log, LOG_LVL_DEBUG, "Blend getCmd() using cmd from " << sched->getName());
+                wbase::Task::Ptr task = std::dynamic_pointer_cast<wbase::Task>(cmd);
+                break;
+            }
+            // adjMax = _getAdjustedMaxThreads(adjMax, sched->getInFlight()); // DM-4943 possible alternate method
+            LOGS(_log, LOG_LVL_DEBUG, "Blend getCmd() nothing from " << sched->getName()
+                 << " avail=" << availableThreads);
         }
-        // adjMax = _getAdjustedMaxThreads(adjMax, sched->getInFlight()); // DM-4943 possible alternate method
-        LOGS(_log, LOG_LVL_DEBUG, "Blend getCmd() nothing from " << sched->getName()
-             << " avail=" << availableThreads);
     }
     if (cmd == nullptr) {
         // The scheduler didn't have anything, see if there's anything on the control queue,
@@ -316,6 +403,22 @@ int BlendScheduler::_getAdjustedMaxThreads(int oldAdjMax, int inFlight) {
 }
 
 /// @return the number of threads that are not reserved by any sub-scheduler.
+void BlendScheduler::setSchedMaxThreads(int schedMaxThreads) {
+    {
+        std::lock_guard<std::mutex> lock(util::CommandQueue::_mx);
+        _schedMaxThreads = schedMaxThreads;
+    }
+    // A bigger budget may make queued commands ready.
+    notify(true);
+}
+
+
+int BlendScheduler::getSchedMaxThreads() {
+    std::lock_guard<std::mutex> lock(util::CommandQueue::_mx);
+    return _schedMaxThreads;
+}
+
+
 int BlendScheduler::calcAvailableTheads() {
     int reserve = 0;
     for (auto sched : _schedulers) {
@@ -360,6 +463,14 @@ void BlendScheduler::_logChunkStatus() {
 }
 
 
+/// @return a copy of the sub-scheduler list. The copy is taken under _mx as
+/// _sortScanSchedulers() reorders the list while queries run.
+std::vector<SchedulerBase::Ptr> BlendScheduler::getSubSchedulers() {
+    std::lock_guard<std::mutex> lock(util::CommandQueue::_mx);
+    return _schedulers;
+}
+
+
 bool BlendScheduler::isScanSnail(SchedulerBase::Ptr const& scan) {
     return scan == _scanSnail;
 }
@@ -376,6 +487,51 @@ int BlendScheduler::moveUserQueryToSnail(QueryId qId, SchedulerBase::Ptr const&
 }
 
 
+ScanScheduler::Ptr BlendScheduler::getFasterScanSched(ScanScheduler::Ptr const& sched) {
+    ScanScheduler::Ptr best;
+    std::lock_guard<std::mutex> lock(util::CommandQueue::_mx); // _schedulers order changes under _mx.
+    for (auto const& s : _schedulers) {
+        auto scan = std::dynamic_pointer_cast<ScanScheduler>(s);
+        if (scan == nullptr || scan == _scanSnail || scan == sched) continue;
+        if (scan->getMaxTimeMinutes() < sched->getMaxTimeMinutes()) {
+            if (best == nullptr || scan->getMaxTimeMinutes() > best->getMaxTimeMinutes()) {
+                best = scan;
+            }
+        }
+    }
+    return best;
+}
+
+
+ScanScheduler::Ptr BlendScheduler::getSlowerScanSched(ScanScheduler::Ptr const& sched) {
+    ScanScheduler::Ptr best;
+    std::lock_guard<std::mutex> lock(util::CommandQueue::_mx);
+    for (auto const& s : _schedulers) {
+        auto scan = std::dynamic_pointer_cast<ScanScheduler>(s);
+        if (scan == nullptr || scan == _scanSnail || scan == sched) continue;
+        if (scan->getMaxTimeMinutes() > sched->getMaxTimeMinutes()) {
+            if (best == nullptr || scan->getMaxTimeMinutes() < best->getMaxTimeMinutes()) {
+                best = scan;
+            }
+        }
+    }
+    return best;
+}
+
+
+/// @return true if a scan scheduler other than 'requester' has Tasks in flight
+/// on 'chunkId'. The in-flight counts are read under each scheduler's own
+/// counts mutex, a leaf lock, so this is safe to call from a sub-scheduler's
+/// ready() while this scheduler's mutex is held.
+bool BlendScheduler::chunkActiveOnOtherScan(int chunkId, SchedulerBase const* requester) {
+    for (auto const& scan : _scanScheds) {
+        if (scan.get() == requester) continue;
+        if (scan->chunkAlreadyActive(chunkId)) return true;
+    }
+    return false;
+}
+
+
 int BlendScheduler::moveUserQuery(QueryId qId, SchedulerBase::Ptr const& source,
                                   SchedulerBase::Ptr const& destination) {
     LOGS(_log, LOG_LVL_DEBUG, "moveUserQuery " << QueryIdHelper::makeIdStr(qId)
@@ -397,6 +553,26 @@ int BlendScheduler::moveUserQuery(QueryId qId, SchedulerBase::Ptr const& source,
         destination->queCmd(task);
         ++count;
     }
+    if (count > 0) {
+        // The destination may have become ready; raise the event and wake a thread.
+        notify(true);
+    }
+    return count;
+}
+
+
+int BlendScheduler::killUserQuery(QueryId qId) {
+    LOGS(_log, LOG_LVL_INFO, "killUserQuery " << QueryIdHelper::makeIdStr(qId));
+    if (_queries == nullptr) {
+        LOGS(_log, LOG_LVL_WARN, QueryIdHelper::makeIdStr(qId)
+             << " killUserQuery has no QueriesAndChunks");
+        return 0;
+    }
+    int count = _queries->cancelQuery(qId);
+    if (count > 0) {
+        // Sweeping Tasks out can unblock a scheduler that was out of resources.
+        notify(true);
+    }
     return count;
 }
 
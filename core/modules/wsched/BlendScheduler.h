@@ -24,6 +24,8 @@
 #define LSST_QSERV_WSCHED_BLENDSCHEDULER_H
 
 // System headers
+#include <chrono>
+#include <functional>
 #include <map>
 
 // Qserv headers
@@ -110,6 +112,11 @@ public:
     void queCmd(util::Command::Ptr const& cmd) override;
     util::Command::Ptr getCmd(bool wait) override;
 
+    /// Wake threads waiting in getCmd(). Everything worth waking a thread for
+    /// could change _ready()'s answer, so the cached answer is invalidated
+    /// before the notification goes out; see _ready().
+    void notify(bool all=true) override;
+
     void commandStart(util::Command::Ptr const& cmd) override;
     void commandFinish(util::Command::Ptr const& cmd) override;
 
@@ -119,13 +126,48 @@ public:
     bool ready() override;
     int applyAvailableThreads(int tempMax) override { return tempMax;} //< does nothing
 
+    /// Pass the prefetch function on to the sub-schedulers.
+    void setPrefetchFunc(
+            std::function<void(std::vector<std::shared_ptr<wbase::Task>> const&)> const& func) override;
+
     void setFlagReorderScans() { _flagReorderScans = true; }
     int calcAvailableTheads();
 
+    /// Set the total Task inFlight budget distributed among the sub-schedulers.
+    /// Called by the Foreman's pool sizing loop as the thread pools grow and
+    /// shrink, so blocked threads do not eat the whole budget.
+    void setSchedMaxThreads(int schedMaxThreads) override;
+    int getSchedMaxThreads() override;
+
+    /// @return the sub-schedulers, for statistics reporting.
+    std::vector<SchedulerBase::Ptr> getSubSchedulers();
+
     bool isScanSnail(SchedulerBase::Ptr const& scan);
     int moveUserQueryToSnail(QueryId qId, SchedulerBase::Ptr const& source);
     int moveUserQuery(QueryId qId, SchedulerBase::Ptr const& source, SchedulerBase::Ptr const& destination);
 
+    /// Cancel all Tasks of user query 'qId' on this worker, sweeping its
+    /// queued Tasks from the sub-scheduler queues and killing the mysqld
+    /// statements of its running Tasks. Called by the KILL_QUERY worker
+    /// command when the czar squashes a query.
+    /// @return the number of Tasks cancelled.
+    int killUserQuery(QueryId qId);
+
+    /// @return the scan scheduler one tier faster (next smaller time limit)
+    /// than 'sched', or nullptr if 'sched' is already the fastest. The snail
+    /// scan is not part of the ladder; queries only reach it by booting.
+    std::shared_ptr<ScanScheduler> getFasterScanSched(std::shared_ptr<ScanScheduler> const& sched);
+
+    /// @return the scan scheduler one tier slower (next larger time limit)
+    /// than 'sched', or nullptr if 'sched' is already the slowest non-snail tier.
+    std::shared_ptr<ScanScheduler> getSlowerScanSched(std::shared_ptr<ScanScheduler> const& sched);
+
+    /// @return true if a scan scheduler other than 'requester' has Tasks in
+    /// flight on 'chunkId', meaning that tier already holds the chunk's tables
+    /// locked via MemMan. Called from inside the sub-schedulers' ready() while
+    /// this scheduler's mutex is held, so it must not (and does not) lock it.
+    bool chunkActiveOnOtherScan(int chunkId, SchedulerBase const* requester);
+
 private:
     int _getAdjustedMaxThreads(int oldAdjMax, int inFlight);
     bool _ready();
@@ -139,10 +181,26 @@ private:
     std::shared_ptr<GroupScheduler> _group;    ///< group scheduler
     std::shared_ptr<ScanScheduler> _scanSnail; ///< extremely slow scheduler.
     std::vector<SchedulerBase::Ptr> _schedulers; ///< list of all schedulers including _group and _scanSnail
+    /// The scan schedulers including _scanSnail. Unlike _schedulers, this list
+    /// never changes after construction, so chunkActiveOnOtherScan() can read
+    /// it without a lock.
+    std::vector<std::shared_ptr<ScanScheduler>> _scanScheds;
 
     std::atomic<bool> _flagReorderScans{false};
+    /// Last time the scan schedulers were sorted. They are re-sorted periodically
+    /// so that age based priority boosts take effect without a priority change.
+    std::chrono::steady_clock::time_point _lastReorderScans{std::chrono::steady_clock::now()};
     std::atomic<bool> _infoChanged{true}; //< Used to limit debug logging.
 
+    /// Edge-triggered readiness. Probing a scan scheduler's ready() runs MemMan
+    /// forecasts, so _ready() only re-probes the sub-schedulers after an event
+    /// that could change the answer. All such events (a Task queued or finished,
+    /// a thread budget or priority change, Tasks moved between schedulers) come
+    /// through notify(), which advances _readyEvents.
+    std::atomic<uint64_t> _readyEvents{1}; ///< Generation count of scheduling events.
+    uint64_t _readyEventsSeen{0}; ///< _readyEvents value at the last probe. Protected by _mx.
+    bool _readyCached{false}; ///< Answer of the last full probe. Protected by _mx.
+
     wpublish::QueriesAndChunks::Ptr _queries; /// UserQuery statistics.
 };
 
@@ -173,8 +173,26 @@ bool ChunkDisk::_ready(bool useFlexibleLock) {
             memman::TableInfo ti(tbl.db + "/" + tbl.table, lckOptTbl, lckOptIdx);
             tblVect.push_back(ti);
         }
+        // Let memman decide whose turn it is. Retries land here in arrival
+        // order, so without this gate a slow scan could claim memory ahead
+        // of a fast one that has been waiting longer.
+        if (not _memMan->admit(chunkId, scanInfo.scanRating)) {
+            logMemManRes(true, "waiting for admission", tblVect);
+            return false;
+        }
+        // Forecast the memory this chunk needs before trying to reserve it.
+        // Turning an overcommitted chunk away here is much cheaper than
+        // having prepare() reserve, map, and then fail with ENOMEM.
+        if (_memMan->bytesRequired(tblVect, chunkId) > _memMan->bytesFree()) {
+            logMemManRes(true, "forecast ENOMEM", tblVect);
+            return false;
+        }
+        // Tasks on the slow and snail schedulers read their chunk once, front
+        // to back, so memman may release memory behind the scan cursor
+        // instead of keeping tables locked that mysqld has already read.
+        bool streaming = scanInfo.scanRating > proto::ScanInfo::Rating::MEDIUM;
         // If tblVect is empty, we should get the empty handle
-        memman::MemMan::Handle handle = _memMan->prepare(tblVect, chunkId);
+        memman::MemMan::Handle handle = _memMan->prepare(tblVect, chunkId, streaming);
         if (handle == 0) {
             switch (errno) {
             case ENOMEM:
@@ -195,6 +213,7 @@ bool ChunkDisk::_ready(bool useFlexibleLock) {
             }
         }
         LOGS(_log, LOG_LVL_DEBUG, task->getIdStr() << " setting memHandle=" << handle);
+        _memMan->withdraw(chunkId);
         task->setMemHandle(handle);
         logMemManRes(false, "got handle", tblVect);
         // Once the chunk has been granted, everything equal and below must go on pending.
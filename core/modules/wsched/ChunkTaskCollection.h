@@ -62,6 +62,16 @@ public:
     /// @return true if the next Task will come from a different active chunk.
     virtual bool nextTaskDifferentChunkId() = 0;
 
+    /// @return the NUMA node where the tables for the next ready Task were locked,
+    /// or -1 if unknown. Collections that don't track locality can use the default.
+    virtual int readyTaskNode() { return -1; }
+
+    /// @return the deadline of the next ready Task, 0 if there is none or it has no deadline.
+    virtual time_t readyTaskDeadline() { return 0; }
+
+    /// @return the earliest enqueue time among queued Tasks, 0 if none are queued.
+    virtual time_t oldestTaskEnqueueTime() { return 0; }
+
     /// Remove task from this collection.
     /// @return a pointer to the removed task or nullptr if the task was not found.
     virtual wbase::Task::Ptr removeTask(wbase::Task::Ptr const& task) = 0;
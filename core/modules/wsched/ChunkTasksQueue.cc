@@ -35,6 +35,11 @@
 
 namespace {
 LOG_LOGGER _log = LOG_GET("lsst.qserv.wsched.ChunkTasksQueue");
+
+// How many chunks past the strictly next one the active chunk may jump to
+// reach a chunk another scan tier already has locked in memory. Kept small so
+// a chunk passed over waits at most this many chunks longer for its turn.
+int const chunkPhaseLookahead = 5;
 }
 
 namespace lsst {
@@ -43,24 +48,59 @@ namespace wsched {
 
 
 /// Queue a Task with other tasks on the same chunk.
+/// The Task only goes on the staging buffer here; the dispatch side folds the
+/// buffer into the chunk map with _drainEnqueued(). Threads delivering new
+/// Tasks therefore never wait out a dispatch pass over the queue.
 void ChunkTasksQueue::queueTask(wbase::Task::Ptr const& task) {
-    // Insert a new ChunkTask object into the map if it doesn't already exist.
-    auto insertChunkTask = [this](int chunkId) -> ChunkTasksQueue::ChunkMap::iterator {
+    // Stamp admission here, as the Task may sit in the staging buffer a while
+    // before queTask() sees it.
+    time(&task->entryTime);
+    ::ctime_r(&task->entryTime, task->timestr);
+    {
+        std::lock_guard<std::mutex> lg(_enqueueMx);
+        _enqueuedTasks.push_back(task);
+    }
+    ++_taskCount;
+}
+
+
+/// Fold staged Tasks into the chunk map and the ready-chunk index.
+/// Precondition: _mapMx must be locked.
+void ChunkTasksQueue::_drainEnqueued() {
+    std::vector<wbase::Task::Ptr> staged;
+    {
+        std::lock_guard<std::mutex> lg(_enqueueMx);
+        if (_enqueuedTasks.empty()) {
+            return;
+        }
+        staged.swap(_enqueuedTasks);
+    }
+    for (auto const& task : staged) {
+        int chunkId = task->getChunkId();
         auto iter = _chunkMap.find(chunkId);
         if (iter == _chunkMap.end()) {
-            std::pair<int, ChunkTasks::Ptr> ele(chunkId, std::make_shared<ChunkTasks>(chunkId, _memMan));
+            std::pair<int, ChunkTasks::Ptr> ele(chunkId,
+                    std::make_shared<ChunkTasks>(chunkId, _memMan, _scheduler));
             auto res = _chunkMap.insert(ele); // insert should fail if the key already exists.
             LOGS(_log, LOG_LVL_DEBUG, " queueTask chunk=" << chunkId << " created=" << res.second);
-            iter =  res.first;
+            iter = res.first;
         }
-        return iter;
-    };
+        iter->second->queTask(task);
+        _updateTaskIndex(iter);
+    }
+}
 
-    std::lock_guard<std::mutex> lg(_mapMx);
-    int chunkId = task->getChunkId();
-    auto iter = insertChunkTask(chunkId);
-    ++_taskCount;
-    iter->second->queTask(task);
+
+/// Keep _chunksWithTasks in agreement with the chunk's active heap.
+/// This must be called after any operation that may have changed the heap, as
+/// ChunkTasks does its bookkeeping without locks and relies on this class.
+/// Precondition: _mapMx must be locked.
+void ChunkTasksQueue::_updateTaskIndex(ChunkMap::iterator iter) {
+    if (iter->second->hasActiveTasks()) {
+        _chunksWithTasks.insert(iter->first);
+    } else {
+        _chunksWithTasks.erase(iter->first);
+    }
 }
 
 
@@ -84,6 +124,7 @@ bool ChunkTasksQueue::_ready(bool useFlexibleLock) {
     if (_readyChunk != nullptr) {
         return true;
     }
+    _drainEnqueued();
     if (_empty()) {
         return false;
     }
@@ -95,7 +136,9 @@ bool ChunkTasksQueue::_ready(bool useFlexibleLock) {
     }
 
     // Check the active chunk for valid Tasks
-    if (_activeChunk->second->ready(useFlexibleLock) == ChunkTasks::ReadyState::READY) {
+    ChunkTasks::ReadyState activeState = _activeChunk->second->ready(useFlexibleLock);
+    _updateTaskIndex(_activeChunk); // ready() pops the heap when it finds a Task.
+    if (activeState == ChunkTasks::ReadyState::READY) {
         _readyChunk = _activeChunk->second;
         return true;
     }
@@ -108,6 +151,32 @@ bool ChunkTasksQueue::_ready(bool useFlexibleLock) {
             newActive = _chunkMap.begin();
         }
 
+        // Phase alignment across the scan tiers: each ScanScheduler loops
+        // through the chunks on its own, so the tiers drift apart and the same
+        // chunk gets faulted into memory separately for each of them. If
+        // another tier already has the tables of a chunk a few positions ahead
+        // locked, start with that chunk instead of the strictly next one, so
+        // the locked tables are shared while they are resident. Chunks passed
+        // over stay queued; they are served by the walk below when the active
+        // chunk cannot provide a Task, and by the cursor when it comes around.
+        if (_scheduler != nullptr && newActive != _activeChunk
+                && !_scheduler->chunkActiveOnOtherScan(newActive->first)) {
+            auto candidate = newActive;
+            for (int step = 1; step < chunkPhaseLookahead; ++step) {
+                ++candidate;
+                if (candidate == _chunkMap.end()) {
+                    candidate = _chunkMap.begin();
+                }
+                if (candidate == _activeChunk) break; // wrapped around
+                if (_scheduler->chunkActiveOnOtherScan(candidate->first)) {
+                    LOGS(_log, LOG_LVL_DEBUG, "ChunkTasksQueue aligning with other tier chunk="
+                            << candidate->first << " skipped=" << step);
+                    newActive = candidate;
+                    break;
+                }
+            }
+        }
+
         // Clean up the old _active chunk before moving on.
         _activeChunk->second->setActive(false); // This should move pending Tasks to _activeTasks
         // _inFlightTasks must be empty as readyToAdvance was true.
@@ -115,7 +184,10 @@ bool ChunkTasksQueue::_ready(bool useFlexibleLock) {
             if (newActive == _activeChunk) {
                 newActive = _chunkMap.end();
             }
+            _chunksWithTasks.erase(_activeChunk->first);
             _chunkMap.erase(_activeChunk);
+        } else {
+            _updateTaskIndex(_activeChunk); // setActive(false) moved pending Tasks.
         }
 
         _activeChunk = newActive;
@@ -125,20 +197,38 @@ bool ChunkTasksQueue::_ready(bool useFlexibleLock) {
         }
         newActive->second->movePendingToActive();
         newActive->second->setActive();
+        _updateTaskIndex(newActive);
+
+        // The scan is now committed to the new active chunk. Hand the chunk
+        // after it to the scheduler so its subchunk tables can be built while
+        // the new active chunk is scanned.
+        auto prefetchIter = newActive;
+        ++prefetchIter;
+        if (prefetchIter == _chunkMap.end()) {
+            prefetchIter = _chunkMap.begin();
+        }
+        if (_scheduler != nullptr && prefetchIter != newActive) {
+            _scheduler->prefetchChunkTasks(prefetchIter->second->getQueuedTasks());
+        }
     }
 
-    // Advance through chunks until READY or NO_RESOURCES found, or until entire list scanned.
+    // Advance through chunks until READY or NO_RESOURCES found, or until every chunk
+    // with a queued Task has been examined. _chunksWithTasks jumps the walk straight
+    // to the next chunk in scan order that has something runnable, so chunks whose
+    // Tasks are all in flight or pending cost nothing instead of a map step each.
     auto iter = _activeChunk;
     ChunkTasks::ReadyState chunkState = iter->second->ready(useFlexibleLock);
+    _updateTaskIndex(iter);
     while (chunkState != ChunkTasks::ReadyState::READY
            && chunkState != ChunkTasks::ReadyState::NO_RESOURCES) {
-        ++iter;
-        if (iter == _chunkMap.end()) {
-            iter = _chunkMap.begin();
+        auto candidate = _chunksWithTasks.upper_bound(iter->first);
+        if (candidate == _chunksWithTasks.end()) {
+            candidate = _chunksWithTasks.begin();
         }
-        if (iter == _activeChunk) {
+        if (candidate == _chunksWithTasks.end() || *candidate == _activeChunk->first) {
             return false;
         }
+        iter = _chunkMap.find(*candidate);
         if (_scheduler != nullptr
               && _scheduler->getActiveChunkCount() >= _scheduler->getMaxActiveChunks()) {
             int newChunkId = iter->second->getChunkId();
@@ -148,6 +238,7 @@ bool ChunkTasksQueue::_ready(bool useFlexibleLock) {
         }
 
         chunkState = iter->second->ready(useFlexibleLock);
+        _updateTaskIndex(iter);
     }
     if (chunkState == ChunkTasks::ReadyState::NO_RESOURCES) {
         // Advancing past a chunk where there aren't enough resources could cause many
@@ -179,6 +270,7 @@ wbase::Task::Ptr ChunkTasksQueue::getTask(bool useFlexibleLock) {
 // to change priority.
 bool ChunkTasksQueue::nextTaskDifferentChunkId() {
     std::lock_guard<std::mutex> lock(_mapMx);
+    _drainEnqueued();
     if (_activeChunk == _chunkMap.end()) {
         return true;
     }
@@ -196,6 +288,45 @@ void ChunkTasksQueue::taskComplete(wbase::Task::Ptr const& task) {
 }
 
 
+/// @return the NUMA node of the chunk with the ready Task, -1 if no Task is
+/// ready or the chunk's tables have not been locked yet.
+int ChunkTasksQueue::readyTaskNode() {
+    std::lock_guard<std::mutex> lock(_mapMx);
+    if (_readyChunk == nullptr) {
+        return -1;
+    }
+    return _readyChunk->getMemNode();
+}
+
+
+/// @return the deadline of the Task that is ready to run, 0 if no Task is
+/// ready or the Task has no deadline.
+time_t ChunkTasksQueue::readyTaskDeadline() {
+    std::lock_guard<std::mutex> lock(_mapMx);
+    if (_readyChunk == nullptr) {
+        return 0;
+    }
+    return _readyChunk->readyTaskDeadline();
+}
+
+
+/// @return the earliest entryTime among all queued Tasks, 0 if the queue is empty.
+/// This walks the whole queue, so it is meant for occasional use such as
+/// priority aging, not for every scheduling decision.
+time_t ChunkTasksQueue::oldestTaskEnqueueTime() {
+    std::lock_guard<std::mutex> lock(_mapMx);
+    _drainEnqueued();
+    time_t oldest = 0;
+    for (auto const& entry : _chunkMap) {
+        time_t chunkOldest = entry.second->oldestEnqueueTime();
+        if (chunkOldest != 0 && (oldest == 0 || chunkOldest < oldest)) {
+            oldest = chunkOldest;
+        }
+    }
+    return oldest;
+}
+
+
 bool ChunkTasksQueue::setResourceStarved(bool starved) {
     bool ret = _resourceStarved;
     _resourceStarved = starved;
@@ -216,6 +347,7 @@ wbase::Task::Ptr ChunkTasksQueue::removeTask(wbase::Task::Ptr const& task) {
     // Find the correct chunk
     auto chunkId = task->getChunkId();
     std::lock_guard<std::mutex> lock(_mapMx);
+    _drainEnqueued(); // The task may still be in the staging buffer.
     auto iter = _chunkMap.find(chunkId);
     if (iter == _chunkMap.end()) return nullptr;
 
@@ -224,6 +356,7 @@ wbase::Task::Ptr ChunkTasksQueue::removeTask(wbase::Task::Ptr const& task) {
     auto ret = ct->removeTask(task);
     if (ret != nullptr) {
         --_taskCount; // Need to do this as getTask() wont be called for task.
+        _updateTaskIndex(iter);
     }
     return ret;
 }
@@ -231,7 +364,8 @@ wbase::Task::Ptr ChunkTasksQueue::removeTask(wbase::Task::Ptr const& task) {
 
 bool ChunkTasksQueue::empty() const {
     std::lock_guard<std::mutex> lock(_mapMx);
-    return _empty();
+    std::lock_guard<std::mutex> lg(_enqueueMx);
+    return _empty() && _enqueuedTasks.empty();
 }
 
 /// Remove task from ChunkTasks.
@@ -281,12 +415,30 @@ wbase::Task::Ptr ChunkTasks::SlowTableHeap::pop() {
 }
 
 
+/// Remove a specific Task from the heap, restoring heap order afterwards.
+void ChunkTasks::SlowTableHeap::remove(wbase::Task::Ptr const& task) {
+    if (!_tasks.empty() && _tasks.front() == task) {
+        pop();
+        return;
+    }
+    auto iter = std::find(_tasks.begin(), _tasks.end(), task);
+    if (iter != _tasks.end()) {
+        _tasks.erase(iter);
+        heapify();
+    }
+}
+
+
 /// Queue new Tasks to be run, ordered with the slowest tables first.
 /// This relies on ChunkTasks owner for thread safety.
 void ChunkTasks::queTask(wbase::Task::Ptr const& a) {
-    time(&a->entryTime);
-    /// Compute entry time to reduce spurious valgrind errors
-    ::ctime_r(&a->entryTime, a->timestr);
+    // ChunkTasksQueue::queueTask() stamps admission before staging; only stamp
+    // here when this was called directly.
+    if (a->entryTime == 0) {
+        time(&a->entryTime);
+        /// Compute entry time to reduce spurious valgrind errors
+        ::ctime_r(&a->entryTime, a->timestr);
+    }
 
     const char* state = "";
     // If this is the active chunk, put new Tasks on the pending list, as
@@ -335,6 +487,30 @@ void ChunkTasks::movePendingToActive() {
 }
 
 
+/// @return the earliest entryTime among this chunk's queued Tasks, 0 if none are queued.
+time_t ChunkTasks::oldestEnqueueTime() const {
+    time_t oldest = 0;
+    auto check = [&oldest](std::vector<wbase::Task::Ptr> const& tasks) {
+        for (auto const& task : tasks) {
+            if (task->entryTime != 0 && (oldest == 0 || task->entryTime < oldest)) {
+                oldest = task->entryTime;
+            }
+        }
+    };
+    check(_activeTasks._tasks);
+    check(_pendingTasks);
+    return oldest;
+}
+
+
+/// @return a copy of the queued (not in flight) Tasks for this chunk.
+std::vector<wbase::Task::Ptr> ChunkTasks::getQueuedTasks() const {
+    std::vector<wbase::Task::Ptr> tasks(_activeTasks._tasks);
+    tasks.insert(tasks.end(), _pendingTasks.begin(), _pendingTasks.end());
+    return tasks;
+}
+
+
 /// @return true if active AND pending are empty.
 bool ChunkTasks::empty() const {
     return _activeTasks.empty() && _pendingTasks.empty();
@@ -375,7 +551,7 @@ ChunkTasks::ReadyState ChunkTasks::ready(bool useFlexibleLock) {
     // Calling this function doesn't get expensive until it gets here. Luckily,
     // after this point it will return READY or NO_RESOURCES, and ChunkTasksQueue::_ready
     // will not examine any further chunks upon seeing those results.
-    auto task = _activeTasks.top();
+    auto task = _selectTask();
     if (!task->hasMemHandle()) {
         memman::TableInfo::LockType lckOptTbl = memman::TableInfo::LockType::REQUIRED;
         if (useFlexibleLock) lckOptTbl = memman::TableInfo::LockType::FLEXIBLE;
@@ -392,8 +568,26 @@ ChunkTasks::ReadyState ChunkTasks::ready(bool useFlexibleLock) {
             memman::TableInfo ti(tbl.db + "/" + tbl.table, lckOptTbl, lckOptIdx);
             tblVect.push_back(ti);
         }
+        // Let memman decide whose turn it is. Retries land here in arrival
+        // order, so without this gate a slow scan could claim memory ahead
+        // of a fast one that has been waiting longer.
+        if (not _memMan->admit(chunkId, scanInfo.scanRating)) {
+            logMemManRes(true, "waiting for admission", 0, tblVect);
+            return ChunkTasks::ReadyState::NO_RESOURCES;
+        }
+        // Forecast the memory this chunk needs before trying to reserve it.
+        // Turning an overcommitted chunk away here is much cheaper than
+        // having prepare() reserve, map, and then fail with ENOMEM.
+        if (_memMan->bytesRequired(tblVect, chunkId) > _memMan->bytesFree()) {
+            logMemManRes(true, "forecast ENOMEM", 0, tblVect);
+            return ChunkTasks::ReadyState::NO_RESOURCES;
+        }
+        // Tasks on the slow and snail schedulers read their chunk once, front
+        // to back, so memman may release memory behind the scan cursor
+        // instead of keeping tables locked that mysqld has already read.
+        bool streaming = scanInfo.scanRating > proto::ScanInfo::Rating::MEDIUM;
         // If tblVect is empty, we should get the empty handle
-        memman::MemMan::Handle handle = _memMan->prepare(tblVect, chunkId);
+        memman::MemMan::Handle handle = _memMan->prepare(tblVect, chunkId, streaming);
         if (handle == 0) {
             switch (errno) {
             case ENOMEM:
@@ -413,17 +607,49 @@ ChunkTasks::ReadyState ChunkTasks::ready(bool useFlexibleLock) {
                 return ChunkTasks::ReadyState::NO_RESOURCES;
             }
         }
+        _memMan->withdraw(chunkId);
         task->setMemHandle(handle);
         logMemManRes(false, task->getIdStr() + " got handle", handle, tblVect);
     }
 
     // There is a Task to run at this point, pull it off the heap to avoid confusion.
-    _activeTasks.pop();
+    _activeTasks.remove(task);
     _readyTask = task;
     return ChunkTasks::ReadyState::READY;
 }
 
 
+/// @return the Task to run next from the active heap.
+/// The heap top defines the table set being scanned next. Among the queued
+/// Tasks needing exactly those tables (interchangeable for MemMan), the one
+/// whose user has the fewest Tasks in flight on the scheduler is picked, so
+/// concurrent users progress proportionally instead of one user's backlog
+/// running in queue order. Ties keep the heap order.
+/// ChunkTasks relies on its owner for thread safety.
+wbase::Task::Ptr ChunkTasks::_selectTask() {
+    auto top = _activeTasks.top();
+    if (_scheduler == nullptr || _activeTasks.size() < 2) {
+        return top;
+    }
+    auto best = top;
+    int bestCount = _scheduler->getTaskCountForUser(top->user);
+    for (auto const& task : _activeTasks._tasks) {
+        if (task == top || task->user == best->user) {
+            continue;
+        }
+        if (task->getScanInfo().compareTables(top->getScanInfo()) != 0) {
+            continue;
+        }
+        int count = _scheduler->getTaskCountForUser(task->user);
+        if (count < bestCount) {
+            best = task;
+            bestCount = count;
+        }
+    }
+    return best;
+}
+
+
 /// @return old value of _resourceStarved.
 bool ChunkTasks::setResourceStarved(bool starved){
     auto val = _resourceStarved;
@@ -452,6 +678,11 @@ wbase::Task::Ptr ChunkTasks::getTask(bool useFlexibleLock) {
 
 void ChunkTasks::taskComplete(wbase::Task::Ptr const& task) {
     _inFlightTasks.erase(task.get());
+    // The first Task to lock this chunk's tables establishes which node
+    // the locked pages live on; remaining Tasks should prefer that node.
+    if (_memNode < 0) {
+        _memNode = task->getMemNode();
+    }
 }
 
 
@@ -28,6 +28,8 @@
 #include <list>
 #include <map>
 #include <mutex>
+#include <set>
+#include <vector>
 
 // Qserv headers
 #include "memman/MemMan.h"
@@ -46,17 +48,28 @@ namespace wsched {
 /// The active chunk is the first chunk to be checked for tasks to run.
 /// Placing tasks on the pending list prevents getting stuck on the
 /// active chunk indefinitely.
+/// Among queued Tasks needing the same tables, the one whose user has the
+/// fewest Tasks in flight on 'scheduler' runs first, so concurrent users
+/// share the chunk instead of one user's backlog running in queue order.
 class ChunkTasks {
 public:
     using Ptr = std::shared_ptr<ChunkTasks>;
     enum class ReadyState {READY, NOT_READY, NO_RESOURCES};
 
-    ChunkTasks(int chunkId, memman::MemMan::Ptr const& memMan) : _chunkId{chunkId}, _memMan{memMan} {}
+    /// 'scheduler' provides per-user in-flight counts for fair Task
+    /// selection; it may be nullptr, in which case Tasks run in heap order.
+    ChunkTasks(int chunkId, memman::MemMan::Ptr const& memMan, SchedulerBase* scheduler=nullptr)
+        : _chunkId{chunkId}, _memMan{memMan}, _scheduler{scheduler} {}
     ChunkTasks() = delete;
     ChunkTasks(ChunkTasks const&) = delete;
     ChunkTasks& operator=(ChunkTasks const&) = delete;
 
     bool empty() const;
+    /// @return true if this chunk has a Task on its active heap, i.e. ready() could
+    /// return something other than NOT_READY.
+    bool hasActiveTasks() const { return !_activeTasks.empty(); }
+    /// @return true if this chunk has Tasks running, meaning its tables are locked.
+    bool hasTasksInFlight() const { return !_inFlightTasks.empty(); }
     void queTask(wbase::Task::Ptr const& task);
     wbase::Task::Ptr getTask(bool useFlexibleLock);
     ReadyState ready(bool useFlexibleLock);
@@ -69,6 +82,18 @@ public:
     std::size_t size() const { return _activeTasks.size() + _pendingTasks.size(); }
     int getChunkId() { return _chunkId; }
 
+    /// @return the NUMA node where this chunk's tables were locked, -1 if unknown.
+    int getMemNode() const { return _memNode; }
+
+    /// @return the deadline of the Task ready to run, 0 if none is ready or it has no deadline.
+    time_t readyTaskDeadline() const { return _readyTask != nullptr ? _readyTask->getDeadline() : 0; }
+
+    /// @return the earliest entryTime among this chunk's queued Tasks, 0 if none are queued.
+    time_t oldestEnqueueTime() const;
+
+    /// @return a copy of the queued (not in flight) Tasks for this chunk.
+    std::vector<wbase::Task::Ptr> getQueuedTasks() const;
+
     wbase::Task::Ptr removeTask(wbase::Task::Ptr const& task);
 
     /// Class that keeps the slowest tables at the front of the heap.
@@ -83,6 +108,7 @@ public:
         };
         void push(wbase::Task::Ptr const& task);
         wbase::Task::Ptr pop();
+        void remove(wbase::Task::Ptr const& task); ///< Remove a specific Task, restoring heap order.
         wbase::Task::Ptr top() {
             if (_tasks.empty()) return nullptr;
             return _tasks.front();
@@ -97,7 +123,12 @@ public:
     };
 
 private:
+    /// @return the Task to run next from the active heap, chosen for
+    /// per-user fairness among Tasks needing the heap top's tables.
+    wbase::Task::Ptr _selectTask();
+
     int _chunkId;                    ///< Chunk Id for all Tasks in this instance.
+    int _memNode{-1};               ///< NUMA node where this chunk's tables were locked.
     bool _active{false};            ///< True when this is the active chunk.
     bool _resourceStarved{false};   ///< True when advancement is prevented by lack of memory.
     wbase::Task::Ptr              _readyTask{nullptr}; ///< Task that is ready to run with memory reserved.
@@ -106,6 +137,7 @@ private:
     std::set<wbase::Task*>        _inFlightTasks;      ///< Set of Tasks that this chunk has in flight.
 
     memman::MemMan::Ptr _memMan;
+    SchedulerBase* _scheduler; ///< Source of per-user in-flight counts. This can be nullptr.
 };
 
 
@@ -146,6 +178,9 @@ public:
 
     bool setResourceStarved(bool starved) override;
     bool nextTaskDifferentChunkId() override;
+    int readyTaskNode() override;
+    time_t readyTaskDeadline() override;
+    time_t oldestTaskEnqueueTime() override;
     int getActiveChunkId(); ///< return the active chunk id, or -1 if there isn't one.
 
     wbase::Task::Ptr removeTask(wbase::Task::Ptr const& task) override;
@@ -153,12 +188,27 @@ public:
 private:
     bool _ready(bool useFlexibleLock);
     bool _empty() const { return _chunkMap.empty(); }
+    void _drainEnqueued();
+    void _updateTaskIndex(ChunkMap::iterator iter);
 
-    mutable std::mutex _mapMx; ///< Protects _chunkMap, _activeChunk, and _readyChunk.
+    mutable std::mutex _mapMx; ///< Protects _chunkMap, _activeChunk, _readyChunk, and _chunksWithTasks.
     ChunkMap _chunkMap; ///< map by chunk Id.
     ChunkMap::iterator _activeChunk{_chunkMap.end()}; ///< points at the active ChunkTasks in _chunkList
     ChunkTasks::Ptr _readyChunk{nullptr}; ///< Chunk with the task that's ready to run.
 
+    /// Ids of chunks that have at least one Task on their active heap, ordered
+    /// by scan position. _ready() jumps through this instead of walking every
+    /// chunk in _chunkMap, most of which have nothing runnable when a large
+    /// scan is queued.
+    std::set<int> _chunksWithTasks;
+
+    /// Tasks accepted by queueTask() but not yet folded into _chunkMap.
+    /// Guarded by _enqueueMx alone, so threads delivering new Tasks never
+    /// contend with dispatch, which holds _mapMx for every scheduling decision.
+    /// Lock order: _mapMx before _enqueueMx.
+    std::vector<wbase::Task::Ptr> _enqueuedTasks;
+    mutable std::mutex _enqueueMx; ///< Protects _enqueuedTasks.
+
     memman::MemMan::Ptr _memMan;
     std::atomic<int> _taskCount{0}; ///< Count of all tasks currently in _chunkMap.
     bool _resourceStarved{false};
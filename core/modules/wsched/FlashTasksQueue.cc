@@ -0,0 +1,243 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+
+// Class header
+#include "wsched/FlashTasksQueue.h"
+
+// System headers
+#include <algorithm>
+#include <vector>
+
+// LSST headers
+#include "lsst/log/Log.h"
+
+// Qserv headers
+
+
+namespace {
+LOG_LOGGER _log = LOG_GET("lsst.qserv.wsched.FlashTasksQueue");
+}
+
+namespace lsst {
+namespace qserv {
+namespace wsched {
+
+
+/// Queue a Task with other tasks on the same chunk.
+void FlashTasksQueue::queueTask(wbase::Task::Ptr const& task) {
+    std::lock_guard<std::mutex> lg(_mapMx);
+    int chunkId = task->getChunkId();
+    auto iter = _chunkMap.find(chunkId);
+    if (iter == _chunkMap.end()) {
+        std::pair<int, ChunkTasks::Ptr> ele(chunkId,
+                std::make_shared<ChunkTasks>(chunkId, _memMan, _scheduler));
+        auto res = _chunkMap.insert(ele); // insert should fail if the key already exists.
+        LOGS(_log, LOG_LVL_DEBUG, " queueTask chunk=" << chunkId << " created=" << res.second);
+        iter = res.first;
+    }
+    ++_taskCount;
+    // This queue never marks a chunk active, so Tasks always go on the
+    // chunk's active heap and never its pending list.
+    iter->second->queTask(task);
+}
+
+
+/// @return true if this object is ready to provide a Task from its queue.
+bool FlashTasksQueue::ready(bool useFlexibleLock) {
+    std::lock_guard<std::mutex> lock(_mapMx);
+    return _ready(useFlexibleLock);
+}
+
+
+/// Precondition: _mapMx must be locked.
+/// @return true with _readyChunk set when a Task can run, false otherwise.
+/// Candidate chunks are tried in sharing order rather than id order: chunks
+/// with Tasks already in flight first, as their tables are locked and another
+/// Task shares the MemMan reservation, then by descending queue depth so
+/// locking a new chunk's tables covers the most queued work. A chunk that
+/// does not fit in memory is skipped for this pass; there is no scan-order
+/// invariant to protect on flash storage.
+bool FlashTasksQueue::_ready(bool useFlexibleLock) {
+    if (_readyChunk != nullptr) {
+        return true;
+    }
+    if (_chunkMap.empty()) {
+        return false;
+    }
+
+    std::vector<ChunkTasks::Ptr> candidates;
+    for (auto const& entry : _chunkMap) {
+        if (entry.second->hasActiveTasks()) {
+            candidates.push_back(entry.second);
+        }
+    }
+    std::stable_sort(candidates.begin(), candidates.end(),
+        [](ChunkTasks::Ptr const& a, ChunkTasks::Ptr const& b) {
+            bool aInFlight = a->hasTasksInFlight();
+            bool bInFlight = b->hasTasksInFlight();
+            if (aInFlight != bInFlight) return aInFlight;
+            return a->size() > b->size();
+        });
+
+    for (auto const& cand : candidates) {
+        bool newChunk = !cand->hasTasksInFlight();
+        if (newChunk && _scheduler != nullptr
+              && _scheduler->getActiveChunkCount() >= _scheduler->getMaxActiveChunks()
+              && !_scheduler->chunkAlreadyActive(cand->getChunkId())) {
+            continue;
+        }
+        auto state = cand->ready(useFlexibleLock);
+        if (state == ChunkTasks::ReadyState::READY) {
+            _readyChunk = cand;
+            if (newChunk && _scheduler != nullptr) {
+                // Committed to a new chunk; hand the next candidates' Tasks to
+                // the prefetch hook so their subchunk tables are built
+                // concurrently while this chunk is read.
+                unsigned int prefetched = 0;
+                for (auto const& next : candidates) {
+                    if (next == cand || next->hasTasksInFlight()) continue;
+                    _scheduler->prefetchChunkTasks(next->getQueuedTasks());
+                    if (++prefetched >= PREFETCH_CHUNKS) break;
+                }
+            }
+            return true;
+        }
+        // NO_RESOURCES for this chunk only, try the next candidate.
+    }
+    return false;
+}
+
+
+wbase::Task::Ptr FlashTasksQueue::getTask(bool useFlexibleLock) {
+    std::lock_guard<std::mutex> lock(_mapMx);
+    // Attempt to set _readyChunk.
+    _ready(useFlexibleLock);
+    // If a Task was ready, _readyChunk will not be nullptr.
+    if (_readyChunk != nullptr) {
+        wbase::Task::Ptr task = _readyChunk->getTask(useFlexibleLock);
+        _lastDispatchChunk = _readyChunk->getChunkId();
+        _readyChunk = nullptr;
+        --_taskCount;
+        return task;
+    }
+    return nullptr;
+}
+
+
+/// @return true if the next ready Task is on a different chunk than the last
+/// Task handed out. Used by the owning scheduler to pick a reasonable time
+/// for priority changes.
+bool FlashTasksQueue::nextTaskDifferentChunkId() {
+    std::lock_guard<std::mutex> lock(_mapMx);
+    if (_readyChunk == nullptr) {
+        return true;
+    }
+    return _readyChunk->getChunkId() != _lastDispatchChunk;
+}
+
+
+/// This is called when a Task finishes.
+void FlashTasksQueue::taskComplete(wbase::Task::Ptr const& task) {
+    std::lock_guard<std::mutex> lock(_mapMx);
+    auto iter = _chunkMap.find(task->getChunkId());
+    if (iter != _chunkMap.end()) {
+        iter->second->taskComplete(task);
+        // With no active-chunk bookkeeping, a finished chunk can go away now.
+        if (iter->second->empty() && !iter->second->hasTasksInFlight()) {
+            _chunkMap.erase(iter);
+        }
+    }
+}
+
+
+/// @return the NUMA node of the chunk with the ready Task, -1 if no Task is
+/// ready or the chunk's tables have not been locked yet.
+int FlashTasksQueue::readyTaskNode() {
+    std::lock_guard<std::mutex> lock(_mapMx);
+    if (_readyChunk == nullptr) {
+        return -1;
+    }
+    return _readyChunk->getMemNode();
+}
+
+
+/// @return the deadline of the Task that is ready to run, 0 if no Task is
+/// ready or the Task has no deadline.
+time_t FlashTasksQueue::readyTaskDeadline() {
+    std::lock_guard<std::mutex> lock(_mapMx);
+    if (_readyChunk == nullptr) {
+        return 0;
+    }
+    return _readyChunk->readyTaskDeadline();
+}
+
+
+/// @return the earliest entryTime among all queued Tasks, 0 if the queue is empty.
+/// This walks the whole queue, so it is meant for occasional use such as
+/// priority aging, not for every scheduling decision.
+time_t FlashTasksQueue::oldestTaskEnqueueTime() {
+    std::lock_guard<std::mutex> lock(_mapMx);
+    time_t oldest = 0;
+    for (auto const& entry : _chunkMap) {
+        time_t chunkOldest = entry.second->oldestEnqueueTime();
+        if (chunkOldest != 0 && (oldest == 0 || chunkOldest < oldest)) {
+            oldest = chunkOldest;
+        }
+    }
+    return oldest;
+}
+
+
+bool FlashTasksQueue::setResourceStarved(bool starved) {
+    bool ret = _resourceStarved;
+    _resourceStarved = starved;
+    return ret;
+}
+
+
+wbase::Task::Ptr FlashTasksQueue::removeTask(wbase::Task::Ptr const& task) {
+    auto chunkId = task->getChunkId();
+    std::lock_guard<std::mutex> lock(_mapMx);
+    auto iter = _chunkMap.find(chunkId);
+    if (iter == _chunkMap.end()) return nullptr;
+
+    // Erase the task if it is in the chunk
+    ChunkTasks::Ptr ct = iter->second;
+    auto ret = ct->removeTask(task);
+    if (ret != nullptr) {
+        --_taskCount; // Need to do this as getTask() wont be called for task.
+        if (ct->empty() && !ct->hasTasksInFlight()) {
+            _chunkMap.erase(iter);
+        }
+    }
+    return ret;
+}
+
+
+bool FlashTasksQueue::empty() const {
+    std::lock_guard<std::mutex> lock(_mapMx);
+    return _chunkMap.empty();
+}
+
+}}} // namespace lsst::qserv::wsched
@@ -0,0 +1,101 @@
+// -*- LSST-C++ -*-
+/*
+ * LSST Data Management System
+ * Copyright 2018 LSST Corporation.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+#ifndef LSST_QSERV_WSCHED_FLASHTASKSQUEUE_H
+#define LSST_QSERV_WSCHED_FLASHTASKSQUEUE_H
+
+// System headers
+#include <atomic>
+#include <map>
+#include <mutex>
+
+// Qserv headers
+#include "memman/MemMan.h"
+#include "wbase/Task.h"
+#include "wsched/ChunkTaskCollection.h"
+#include "wsched/ChunkTasksQueue.h"
+#include "wsched/SchedulerBase.h"
+
+namespace lsst {
+namespace qserv {
+namespace wsched {
+
+/// A ChunkTaskCollection for workers whose chunks live on flash storage.
+/// ChunkTasksQueue visits chunks in ascending id order, which minimizes seeks
+/// on spinning disks but serializes chunk access for nothing on SSD/NVMe.
+/// This queue ignores id order entirely:
+/// - Chunks that already have Tasks in flight are preferred, as their tables
+///   are locked in memory and more Tasks on them share the MemMan reservation.
+/// - When a new chunk must be started, the one with the deepest Task queue is
+///   tried first, so locking its tables covers the most queued work.
+/// - A chunk that does not fit in memory is simply skipped for this pass; with
+///   no elevator invariant to protect, another chunk's Tasks can run instead.
+/// When a new chunk is committed, the queued Tasks of the next best candidate
+/// chunks are handed to the scheduler's prefetch hook, so their subchunk
+/// tables are built concurrently and the device's parallelism is used.
+/// Selected per worker with the scheduler.flash_queue configuration flag.
+class FlashTasksQueue : public ChunkTaskCollection {
+public:
+    using Ptr = std::shared_ptr<FlashTasksQueue>;
+    using ChunkMap = std::map<int, ChunkTasks::Ptr>;
+
+    /// Number of candidate chunks handed to the prefetch hook when a new
+    /// chunk is committed.
+    static unsigned int const PREFETCH_CHUNKS = 2;
+
+    FlashTasksQueue(SchedulerBase *scheduler, memman::MemMan::Ptr const& memMan) :
+        _memMan{memMan}, _scheduler{scheduler} {}
+    FlashTasksQueue(FlashTasksQueue const&) = delete;
+    FlashTasksQueue& operator=(FlashTasksQueue const&) = delete;
+
+    void queueTask(wbase::Task::Ptr const& task) override;
+    wbase::Task::Ptr getTask(bool useFlexibleLock) override;
+    bool empty() const override;
+    std::size_t getSize() const override { return _taskCount; }
+    bool ready(bool useFlexibleLock) override;
+    void taskComplete(wbase::Task::Ptr const& task) override;
+
+    bool setResourceStarved(bool starved) override;
+    bool nextTaskDifferentChunkId() override;
+    int readyTaskNode() override;
+    time_t readyTaskDeadline() override;
+    time_t oldestTaskEnqueueTime() override;
+
+    wbase::Task::Ptr removeTask(wbase::Task::Ptr const& task) override;
+
+private:
+    bool _ready(bool useFlexibleLock);
+
+    mutable std::mutex _mapMx; ///< Protects _chunkMap and _readyChunk.
+    ChunkMap _chunkMap; ///< map by chunk Id.
+    ChunkTasks::Ptr _readyChunk{nullptr}; ///< Chunk with the task that's ready to run.
+    int _lastDispatchChunk{-1}; ///< Chunk id of the last Task handed out by getTask().
+
+    memman::MemMan::Ptr _memMan;
+    std::atomic<int> _taskCount{0}; ///< Count of all tasks currently in _chunkMap.
+    bool _resourceStarved{false};
+    SchedulerBase* _scheduler; ///< Pointer to scheduler that owns this. This can be nullptr.
+};
+
+}}} // namespace lsst::qserv::wsched
+
+#endif // LSST_QSERV_WSCHED_FLASHTASKSQUEUE_H
@@ -103,20 +103,30 @@ void GroupScheduler::queCmd(util::Command::Ptr const& cmd) {
         return;
     }
     std::lock_guard<std::mutex> lock(util::CommandQueue::_mx);
-    // Start at the front of the queue looking for a group to accept the task.
-    bool queued = false;
-    for(auto iter = _queue.begin(), end = _queue.end(); iter != end && !queued; ++iter) {
-        GroupQueue::Ptr group = *iter;
-        if (group->queTask(t)) {
-            queued = true;
+    // Look up the newest group for this chunk; any older group for the
+    // chunk is already full and would reject the task anyway.
+    bool const hasChunkId = t->msg->has_chunkid();
+    GroupQueue::Ptr group;
+    if (hasChunkId) {
+        auto iter = _chunkGroups.find(t->msg->chunkid());
+        if (iter != _chunkGroups.end()) {
+            group = iter->second;
         }
+    } else {
+        group = _noChunkGroup;
     }
-    if (!queued) {
-        // Wasn't inserted into an existing group, need to make a new group.
-        auto group = std::make_shared<GroupQueue>(_maxGroupSize, t);
+    if (group == nullptr || !group->queTask(t)) {
+        // No group that can accept the task, need to make a new group.
+        group = std::make_shared<GroupQueue>(_maxGroupSize, t);
         _queue.push_back(group);
+        if (hasChunkId) {
+            _chunkGroups[t->msg->chunkid()] = group;
+        } else {
+            _noChunkGroup = group;
+        }
     }
     auto uqCount = _incrCountForUserQuery(t->getQueryId());
+    _recordTaskQueued();
     LOGS(_log, LOG_LVL_WARN, getName() << " queCmd " << t->getIdStr()
          << " uqCount=" << uqCount);
     util::CommandQueue::_cv.notify_all();
@@ -134,8 +144,19 @@ util::Command::Ptr GroupScheduler::getCmd(bool wait)  {
     auto task = group->getTask();
     if (group->isEmpty()) {
         _queue.pop_front();
+        // Drop the index entry if it still points at the popped group so no
+        // task is queued into a group that is no longer on the queue.
+        if (group->hasChunkId()) {
+            auto iter = _chunkGroups.find(group->getChunkId());
+            if (iter != _chunkGroups.end() && iter->second == group) {
+                _chunkGroups.erase(iter);
+            }
+        } else if (_noChunkGroup == group) {
+            _noChunkGroup.reset();
+        }
     }
     ++_inFlight; // Considered inFlight as soon as it's off the queue.
+    _recordTaskStarted(task->getQueuedTime());
     _decrCountForUserQuery(task->getQueryId());
     _incrChunkTaskCount(task->getChunkId());
     return task;
@@ -144,6 +165,7 @@ util::Command::Ptr GroupScheduler::getCmd(bool wait)  {
 
 void GroupScheduler::commandFinish(util::Command::Ptr const& cmd) {
     --_inFlight;
+    _recordTaskCompleted();
     auto t = std::dynamic_pointer_cast<wbase::Task>(cmd);
     if (t != nullptr) _decrChunkTaskCount(t->getChunkId());
 }
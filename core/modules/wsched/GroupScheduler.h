@@ -23,6 +23,9 @@
 #ifndef LSST_QSERV_WSCHED_GROUPSCHEDULER_H
 #define LSST_QSERV_WSCHED_GROUPSCHEDULER_H
 
+// System headers
+#include <unordered_map>
+
 // Qserv headers
 #include "util/EventThread.h"
 #include "wsched/SchedulerBase.h"
@@ -42,6 +45,8 @@ public:
     wbase::Task::Ptr getTask();
     wbase::Task::Ptr peekTask();
     bool isEmpty() { return _tasks.empty(); }
+    bool hasChunkId() const { return _hasChunkId; }
+    int getChunkId() const { return _chunkId; }
 
 protected:
     bool _hasChunkId{false};
@@ -79,6 +84,13 @@ private:
 
     std::deque<GroupQueue::Ptr> _queue;
     int _maxGroupSize{1};
+
+    /// The newest group per chunk id - the only one that can still accept
+    /// Tasks for that chunk, since a new group is only made once all older
+    /// ones are full. Lets queCmd() find its group without scanning _queue.
+    /// Guarded by util::CommandQueue::_mx along with _queue.
+    std::unordered_map<int, GroupQueue::Ptr> _chunkGroups;
+    GroupQueue::Ptr _noChunkGroup; ///< The newest group for Tasks without a chunk id.
 };
 
 }}} // namespace lsst::qserv::wsched
@@ -34,7 +34,9 @@
 #include "wsched/ScanScheduler.h"
 
 // System headers
+#include <algorithm>
 #include <cstddef>
+#include <ctime>
 #include <iostream>
 #include <mutex>
 #include <sstream>
@@ -48,6 +50,7 @@
 #include "wsched/BlendScheduler.h"
 #include "wsched/ChunkDisk.h"
 #include "wsched/ChunkTasksQueue.h"
+#include "wsched/FlashTasksQueue.h"
 
 namespace {
 LOG_LOGGER _log = LOG_GET("lsst.qserv.wsched.ScanScheduler");
@@ -59,12 +62,18 @@ namespace wsched {
 
 ScanScheduler::ScanScheduler(std::string const& name, int maxThreads, int maxReserve, int priority,
                              int maxActiveChunks, memman::MemMan::Ptr const& memMan,
-                             int minRating, int maxRating, double maxTimeMinutes)
+                             int minRating, int maxRating, double maxTimeMinutes,
+                             bool flashQueue)
     : SchedulerBase{name, maxThreads, maxReserve, maxActiveChunks, priority},
       _memMan{memMan}, _minRating{minRating}, _maxRating{maxRating},
       _maxTimeMinutes{maxTimeMinutes} {
     //_taskQueue = std::make_shared<ChunkDisk>(_memMan); // keeping for testing.
-    _taskQueue = std::make_shared<ChunkTasksQueue>(this, _memMan);
+    if (flashQueue) {
+        // Flash storage has no seek cost, dispatch for sharing instead of id order.
+        _taskQueue = std::make_shared<FlashTasksQueue>(this, _memMan);
+    } else {
+        _taskQueue = std::make_shared<ChunkTasksQueue>(this, _memMan);
+    }
     assert(_minRating <= _maxRating);
 }
 
@@ -89,6 +98,10 @@ void ScanScheduler::commandFinish(util::Command::Ptr const& cmd) {
     }
     std::lock_guard<std::mutex> guard(util::CommandQueue::_mx);
     --_inFlight;
+    _recordTaskCompleted();
+    // The handle is still locked here, so this is the last chance to see how
+    // many bytes MemMan was holding for this Task.
+    _recordBytesLocked(_memMan->getStatus(t->getMemHandle()).bytesLock);
     LOGS(_log, LOG_LVL_DEBUG, t->getIdStr() << " commandFinish " << getName()
                                   << " inFlight=" << _inFlight);
     _taskQueue->taskComplete(t);
@@ -112,6 +125,7 @@ void ScanScheduler::commandFinish(util::Command::Ptr const& cmd) {
     }
 
     _decrChunkTaskCount(t->getChunkId());
+    _decrTaskCountForUser(t->user);
     if (_taskQueue->nextTaskDifferentChunkId()) {
         applyPriority();
     }
@@ -194,10 +208,12 @@ util::Command::Ptr ScanScheduler::getCmd(bool wait)  {
     auto task = _taskQueue->getTask(useFlexibleLock);
     if (task != nullptr) {
         ++_inFlight; // in flight as soon as it is off the queue.
+        _recordTaskStarted(task->getQueuedTime());
         LOGS(_log, LOG_LVL_DEBUG, task->getIdStr() << " getCmd " << getName() << " inflight=" << _inFlight);
         _infoChanged = true;
         _decrCountForUserQuery(task->getQueryId());
         _incrChunkTaskCount(task->getChunkId());
+        _incrTaskCountForUser(task->user);
     }
     return task;
 }
@@ -214,7 +230,14 @@ void ScanScheduler::queCmd(util::Command::Ptr const& cmd) {
     LOGS(_log, LOG_LVL_DEBUG, getName() << " queCmd " << t->getIdStr()
          << " uqCount=" << uqCount);
     t->setMemMan(_memMan);
+    // The UserQuery is expected to finish on this scheduler within _maxTimeMinutes;
+    // a Task that hasn't even started by then is overdue and BlendScheduler's
+    // earliest-deadline-first check will run it ahead of the priority order.
+    if (_maxTimeMinutes > 0.0) {
+        t->setDeadline(time(nullptr) + static_cast<time_t>(_maxTimeMinutes*60.0));
+    }
     _taskQueue->queueTask(t);
+    _recordTaskQueued();
     _infoChanged = true;
     util::CommandQueue::_cv.notify_all();
 }
@@ -263,11 +286,33 @@ bool ScanScheduler::removeTask(wbase::Task::Ptr const& task, bool removeRunning)
 }
 
 
+/// @return extra priority earned by the age of the oldest queued Task, one
+/// step for every 5 minutes it has waited. This keeps a burst of fast scans
+/// from starving a slower scheduler's chunks indefinitely: the starved
+/// scheduler eventually outbids the others when BlendScheduler reorders.
+/// The boost is capped so a pathological wait can't dwarf the configured
+/// priorities entirely.
+int ScanScheduler::getAgePriority() {
+    int const maxBoost = 20;
+    double const minutesPerStep = 5.0;
+    time_t oldest = _taskQueue->oldestTaskEnqueueTime();
+    if (oldest == 0) {
+        return 0;
+    }
+    double waitedMinutes = difftime(time(nullptr), oldest)/60.0;
+    if (waitedMinutes <= 0.0) {
+        return 0;
+    }
+    return std::min(static_cast<int>(waitedMinutes/minutesPerStep), maxBoost);
+}
+
+
 void ScanScheduler::logMemManStats() {
     auto s = _memMan->getStatistics();
     LOGS(_log, LOG_LVL_DEBUG, "bMax=" << s.bytesLockMax
          << " bLocked=" << s.bytesLocked
          << " bReserved=" << s.bytesReserved
+         << " bFree=" << _memMan->bytesFree()
          << " FSets=" << s.numFSets
          << " files=" << s.numFiles
          << " ReqF=" << s.numReqdFiles
@@ -25,7 +25,9 @@
 
 // System headers
 #include<atomic>
+#include <functional>
 #include <mutex>
+#include <vector>
 
 // Qserv headers
 #include "memman/MemMan.h"
@@ -59,9 +61,12 @@ class ScanScheduler : public SchedulerBase {
 public:
     typedef std::shared_ptr<ScanScheduler> Ptr;
 
+    /// 'flashQueue' selects FlashTasksQueue instead of ChunkTasksQueue for
+    /// workers whose chunks live on flash storage, see scheduler.flash_queue.
     ScanScheduler(std::string const& name, int maxThreads, int maxReserve, int priority,
                   int maxActiveChunks, memman::MemMan::Ptr const& memman,
-                  int minRating, int maxRating, double maxTimeMinutes);
+                  int minRating, int maxRating, double maxTimeMinutes,
+                  bool flashQueue=false);
     virtual ~ScanScheduler() {}
 
     void setBlendScheduler(BlendScheduler *blend) {
@@ -75,6 +80,29 @@ public:
     void commandFinish(util::Command::Ptr const& cmd) override;
     bool isRatingInRange(int rating) { return _minRating <= rating && rating <= _maxRating; }
 
+    /// @return the NUMA node where the tables for the next ready Task were
+    /// locked, -1 if there is no ready Task or the node is unknown.
+    int readyTaskNode() { return _taskQueue->readyTaskNode(); }
+
+    /// @return the deadline of the next ready Task, 0 if none.
+    time_t readyTaskDeadline() { return _taskQueue->readyTaskDeadline(); }
+
+    int getAgePriority() override;
+
+    /// Store the function used to pre-build subchunk tables for upcoming Tasks.
+    void setPrefetchFunc(
+            std::function<void(std::vector<std::shared_ptr<wbase::Task>> const&)> const& func) override {
+        _prefetchFunc = func;
+    }
+
+    /// Hand the next chunk's queued Tasks to the prefetch function so their
+    /// subchunk tables are built while the new active chunk is scanned.
+    void prefetchChunkTasks(std::vector<wbase::Task::Ptr> const& tasks) override {
+        if (_prefetchFunc != nullptr && !tasks.empty()) {
+            _prefetchFunc(tasks);
+        }
+    }
+
     // SchedulerBase overrides
     bool ready() override;
     std::size_t getSize() const override ;
@@ -82,6 +110,10 @@ public:
     void logMemManStats();
 
     double getMaxTimeMinutes() const { return _maxTimeMinutes; }
+
+    /// @return the memory manager shared by the scan schedulers, e.g. for
+    /// runtime budget reconfiguration.
+    memman::MemMan::Ptr getMemMan() const { return _memMan; }
     bool removeTask(wbase::Task::Ptr const& task, bool removeRunning) override;
 
 private:
@@ -100,6 +132,9 @@ private:
     double _maxTimeMinutes;
 
     std::atomic<bool> _infoChanged{true}; ///< "Used to limit the amount of debug logging.
+
+    /// Builds subchunk tables ahead of need, see prefetchChunkTasks().
+    std::function<void(std::vector<std::shared_ptr<wbase::Task>> const&)> _prefetchFunc;
 };
 
 }}} // namespace lsst::qserv::wsched
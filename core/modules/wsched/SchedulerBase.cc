@@ -112,6 +112,32 @@ void SchedulerBase::_decrChunkTaskCount(int chunkId) {
 }
 
 
+void SchedulerBase::_incrTaskCountForUser(std::string const& user) {
+    std::lock_guard<std::mutex> lock(_countsMutex);
+    ++_userTaskCounts[user];
+}
+
+
+void SchedulerBase::_decrTaskCountForUser(std::string const& user) {
+    // Decrement the count for this user and remove the entry if count is 0.
+    std::lock_guard<std::mutex> lock(_countsMutex);
+    auto iter = _userTaskCounts.find(user);
+    if (iter != _userTaskCounts.end()) {
+        --(iter->second);
+        if (iter->second <= 0) {
+            _userTaskCounts.erase(iter);
+        }
+    }
+}
+
+
+int SchedulerBase::getTaskCountForUser(std::string const& user) {
+    std::lock_guard<std::mutex> lock(_countsMutex);
+    auto iter = _userTaskCounts.find(user);
+    return iter != _userTaskCounts.end() ? iter->second : 0;
+}
+
+
 int SchedulerBase::getActiveChunkCount() {
     std::lock_guard<std::mutex> lock(_countsMutex);
     return _chunkTasks.size();
@@ -143,4 +169,64 @@ bool SchedulerBase::chunkAlreadyActive(int chunkId) {
     return iter != _chunkTasks.end(); // return true if chunkId was found.
 }
 
+
+bool SchedulerBase::chunkActiveOnOtherScan(int chunkId) {
+    if (_blendScheduler == nullptr) return false;
+    return _blendScheduler->chunkActiveOnOtherScan(chunkId, this);
+}
+
+
+void SchedulerBase::_recordTaskQueued() {
+    ++_tasksQueued;
+    auto depth = ++_queuedTaskCount;
+    _queueDepthHisto.record(depth > 0 ? depth : 0);
+}
+
+
+void SchedulerBase::_recordTaskStarted(std::chrono::milliseconds timeInQ) {
+    ++_tasksStarted;
+    --_queuedTaskCount;
+    uint64_t ms = timeInQ.count() > 0 ? timeInQ.count() : 0;
+    _totalTimeInQMs += ms;
+    _timeInQHisto.record(ms);
+}
+
+
+void SchedulerBase::_recordTaskCompleted() {
+    ++_tasksCompleted;
+}
+
+
+void SchedulerBase::_recordBytesLocked(uint64_t bytes) {
+    _bytesLocked += bytes;
+}
+
+
+SchedulerBase::SchedStats SchedulerBase::getSchedStats() const {
+    SchedStats s;
+    s.tasksQueued = _tasksQueued;
+    s.tasksStarted = _tasksStarted;
+    s.tasksCompleted = _tasksCompleted;
+    s.totalTimeInQMs = _totalTimeInQMs;
+    s.bytesLocked = _bytesLocked;
+    // The exported decade buckets are carved out of the finer histogram
+    // snapshots; boundary counts are pro-rated, see countLessThan().
+    auto const depthSnap = _queueDepthHisto.snapshot();
+    auto const timeSnap = _timeInQHisto.snapshot();
+    uint64_t bound = 10;
+    uint64_t depthBelow = 0;
+    uint64_t timeBelow = 0;
+    for (unsigned int j = 0; j < SchedStats::HIST_BUCKETS; ++j) {
+        bool const last = (j + 1 == SchedStats::HIST_BUCKETS);
+        uint64_t const depthUpTo = last ? depthSnap.count : depthSnap.countLessThan(bound);
+        uint64_t const timeUpTo = last ? timeSnap.count : timeSnap.countLessThan(bound);
+        s.queueDepthHist[j] = depthUpTo - depthBelow;
+        s.timeInQHist[j] = timeUpTo - timeBelow;
+        depthBelow = depthUpTo;
+        timeBelow = timeUpTo;
+        bound *= 10;
+    }
+    return s;
+}
+
 }}} // namespace lsst::qserv::wsched
@@ -26,8 +26,12 @@
 #define LSST_QSERV_WSCHED_SCHEDULERBASE_H
 
 // System headers
+#include <atomic>
+#include <chrono>
+#include <cstdint>
 
 // Qserv headers
+#include "util/Histogram.h"
 #include "wcontrol/Foreman.h"
 
 
@@ -45,11 +49,30 @@ public:
 
     static int getMaxPriority(){ return 1000000000; }
 
+    /// Snapshot of the always-on statistics counters. All counters increase
+    /// monotonically from worker startup; rates are left to the consumer.
+    /// The exported histograms share logarithmic bucket bounds: bucket N
+    /// counts values in [10^N, 10^(N+1)), except the first bucket starts at 0
+    /// and the last is unbounded above. They are derived from the finer
+    /// util::Histogram buckets, so counts right at a decade boundary are
+    /// pro-rated (see util::Histogram::Snapshot::countLessThan()).
+    struct SchedStats {
+        static unsigned int const HIST_BUCKETS = 8;
+        uint64_t tasksQueued{0};      //< Tasks accepted by queCmd().
+        uint64_t tasksStarted{0};     //< Tasks handed to the thread pool.
+        uint64_t tasksCompleted{0};   //< Tasks that finished running.
+        uint64_t totalTimeInQMs{0};   //< Total milliseconds Tasks spent queued.
+        uint64_t bytesLocked{0};      //< Bytes locked via MemMan for completed Tasks.
+        uint64_t queueDepthHist[HIST_BUCKETS]; //< Queue depth when a Task was queued.
+        uint64_t timeInQHist[HIST_BUCKETS];    //< Milliseconds individual Tasks spent queued.
+    };
+
     SchedulerBase(std::string const& name, int maxThreads, int maxReserve,
                   int maxActiveChunks, int priority) :
         _name{name}, _maxReserve{maxReserve}, _maxReserveDefault{maxReserve},
         _maxThreads{maxThreads}, _maxThreadsAdj{maxThreads},
-        _priority{priority}, _priorityDefault{priority}, _priorityNext{priority} {
+        _priority{priority}, _priorityDefault{priority}, _priorityNext{priority},
+        _queueDepthHisto{name + "-queueDepth"}, _timeInQHisto{name + "-timeInQMs"} {
             setMaxActiveChunks(maxActiveChunks);
         }
     virtual ~SchedulerBase() {}
@@ -68,15 +91,41 @@ public:
     void setMaxActiveChunks(int maxActive);
     bool chunkAlreadyActive(int chunkId); ///< Return true if chunkId currently has queries being run on it.
 
+    /// @return true if a scan scheduler other than this one has Tasks in flight
+    /// on 'chunkId', i.e. that tier already has the chunk's tables locked in
+    /// memory. Schedulers not attached to a BlendScheduler return false.
+    /// ChunkTasksQueue uses this to keep the scan tiers in phase on the same
+    /// chunks, so locked tables are shared instead of faulted in per tier.
+    bool chunkActiveOnOtherScan(int chunkId);
+
+    /// @return the number of this scheduler's in-flight Tasks that belong to
+    /// 'user'. ChunkTasks uses this to pick the next Task within a chunk so
+    /// that concurrent users progress proportionally.
+    int getTaskCountForUser(std::string const& user);
+
     /// Methods for altering priority.
     // Hooks for changing this schedulers priority/reserved threads.
     int  getPriority() { return _priority; }
+    /// @return extra priority earned by how long this scheduler's Tasks have
+    /// been waiting. Schedulers that do not age their priority return 0.
+    virtual int getAgePriority() { return 0; }
     void setPriority(int priority); ///< Priority to use starting next chunk
     void applyPriority();           ///< Apply _priorityNext
     void setPriorityDefault();      ///< Return to default priority next chunk
+    /// Change the default priority, e.g. by runtime reconfiguration. The new
+    /// value sticks across the temporary boosts applied by BlendScheduler.
+    void setDefaultPriority(int priority) {
+        _priorityDefault = priority;
+        setPriority(priority);
+    }
     int getMaxReserve() { return _maxReserve; }
     virtual void setMaxReserve(int maxReserve) { _maxReserve = maxReserve; }
     void restoreMaxReserve() { setMaxReserve(_maxReserveDefault); }
+    /// Change the default thread reserve, e.g. by runtime reconfiguration.
+    void setMaxReserveDefault(int maxReserve) {
+        _maxReserveDefault = maxReserve;
+        setMaxReserve(maxReserve);
+    }
 
     /// Use the number of available threads to determine how many threads this
     /// scheduler can use (_maxThreadAdj).
@@ -102,6 +151,26 @@ public:
 
     std::string chunkStatusStr(); //< @return a string
 
+    /// @return a copy of the statistics counters. The counters are read
+    /// individually, so totals can be off by the few Tasks changing state
+    /// mid-snapshot; cheap and lock-free sampling is the point here.
+    SchedStats getSchedStats() const;
+
+    /// @return percentile summaries of the queue depth and time-in-queue
+    /// histograms, suitable for logging.
+    std::string histogramSummaries() const {
+        return _queueDepthHisto.summary() + " " + _timeInQHisto.summary();
+    }
+
+    // Direct access to the histograms, e.g. for Prometheus export.
+    util::Histogram const& queueDepthHistogram() const { return _queueDepthHisto; }
+    util::Histogram const& timeInQHistogram() const { return _timeInQHisto; }
+
+    /// Called when this scheduler's task queue commits to a new chunk, with the
+    /// queued Tasks for the chunk expected to follow it. Schedulers that do not
+    /// prefetch subchunk tables do nothing.
+    virtual void prefetchChunkTasks(std::vector<wbase::Task::Ptr> const& tasks) {}
+
     /// Remove task from this scheduler.
     /// @return - If task was still in the queue, return true.
     /// Most schedulers do not support this operation. Currently only supports
@@ -121,6 +190,17 @@ protected:
     void _incrChunkTaskCount(int chunkId); //< Increase the count of Tasks working on this chunk.
     void _decrChunkTaskCount(int chunkId); //< Decrease the count of Tasks working on this chunk.
 
+    void _incrTaskCountForUser(std::string const& user); //< Increase the in-flight Task count for this user.
+    void _decrTaskCountForUser(std::string const& user); //< Decrease the in-flight Task count for this user.
+
+    // Statistics recording. Each call is a couple of relaxed-enough atomic
+    // increments per Task state change, cheap enough to stay enabled in
+    // production. Sub-schedulers call these from queCmd/getCmd/commandFinish.
+    void _recordTaskQueued();    //< Count a queued Task and sample the queue depth.
+    void _recordTaskStarted(std::chrono::milliseconds timeInQ); //< Count a started Task.
+    void _recordTaskCompleted(); //< Count a completed Task.
+    void _recordBytesLocked(uint64_t bytes); //< Add to the bytes locked via MemMan.
+
     std::string const _name{}; //< Name of this scheduler.
     int _maxReserve{1};    //< Number of threads this scheduler would like to have reserved for its use.
     int _maxReserveDefault{1};
@@ -135,12 +215,23 @@ protected:
     std::atomic<int> _inFlight{0}; //< Number of Tasks running.
 
 private:
+    // Statistics counters, see SchedStats.
+    std::atomic<uint64_t> _tasksQueued{0};
+    std::atomic<uint64_t> _tasksStarted{0};
+    std::atomic<uint64_t> _tasksCompleted{0};
+    std::atomic<uint64_t> _totalTimeInQMs{0};
+    std::atomic<uint64_t> _bytesLocked{0};
+    std::atomic<int64_t> _queuedTaskCount{0}; //< Tasks currently queued, for depth sampling.
+    util::Histogram _queueDepthHisto; //< Queue depth when a Task was queued.
+    util::Histogram _timeInQHisto;    //< Milliseconds individual Tasks spent queued.
+
     /// The true purpose of _userQuerycount is to track how many different UserQuery's are on the queue.
     /// Number of Tasks for each UserQuery in the queue.
     std::map<QueryId, int> _userQueryCounts;
 
     std::map<int, int> _chunkTasks; ///< Number of tasks in each chunk actively being queried.
-    std::mutex _countsMutex; ///< Protects _userQueryCounts and _chunkTasks.
+    std::map<std::string, int> _userTaskCounts; ///< Number of in-flight Tasks for each user.
+    std::mutex _countsMutex; ///< Protects _userQueryCounts, _chunkTasks, and _userTaskCounts.
     // TODO: Decide to keep or remove _maxActiveChunks and related code. This depends primarily
     //       on 'everything' scheduler limits/needs.
     int _maxActiveChunks; ///< Limit the number of chunks this scheduler can work on at one time.
@@ -0,0 +1,453 @@
+/*
+ * LSST Data Management System
+ * Copyright 2018 AURA/LSST.
+ *
+ * This product includes software developed by the
+ * LSST Project (http://www.lsst.org/).
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the LSST License Statement and
+ * the GNU General Public License along with this program.  If not,
+ * see <http://www.lsstcorp.org/LegalNotices/>.
+ */
+
+/**
+ * @file
+ *
+ * @brief Scheduler simulator replaying task traces against BlendScheduler.
+ *
+ * Builds the production scheduler stack (GroupScheduler, the ScanScheduler
+ * tiers and BlendScheduler, wired as in wsched::testSchedulers) and replays
+ * a recorded task trace against it on a virtual clock, so hours of worker
+ * load replay in seconds. Task execution is not performed; each task
+ * occupies a simulated pool thread for its recorded mysqld duration.
+ * Reported at the end:
+ *   - makespan (virtual time from first arrival to last completion);
+ *   - per scan class, p50/p90/p99 of queue wait (start - arrival) and of
+ *     total latency (completion - arrival);
+ *   - memman pressure from a simulated byte-budget memory manager: peak
+ *     bytes locked, lock grants and denials.
+ *
+ * Usage: qserv-wsched-sim <trace-file|-> [poolThreads] [memLimitMB] [chunkMB]
+ *
+ * Trace lines are "arrivalMs queryId jobId chunkId class durationMs" with
+ * class one of i/f/m/s (interactive, fast, medium, slow); '#' comments and
+ * blank lines are ignored. The fields match what QueriesAndChunks records
+ * per finished task (arrival, chunk, scan class, measured mysqld time).
+ * "-" generates a built-in synthetic trace (fixed seed, reproducible).
+ *
+ * Known limit: the age-based priority boosts of the scan schedulers run on
+ * the real clock, so they effectively never fire in a fast replay.
+ */
+
+// System headers
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <queue>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Qserv headers
+#include "memman/MemMan.h"
+#include "proto/ScanTableInfo.h"
+#include "proto/worker.pb.h"
+#include "util/EventThread.h"
+#include "wbase/Task.h"
+#include "wpublish/QueriesAndChunks.h"
+#include "wsched/BlendScheduler.h"
+#include "wsched/GroupScheduler.h"
+#include "wsched/ScanScheduler.h"
+
+using namespace lsst::qserv;
+using lsst::qserv::proto::TaskMsg;
+using lsst::qserv::wbase::Task;
+
+namespace {
+
+/// Memory manager modeling a byte budget: every table with a lock request
+/// costs a fixed per-chunk amount, REQUIRED locks are denied when the
+/// budget is exhausted and FLEXIBLE ones proceed unlocked. Tracks the
+/// pressure numbers the simulation reports.
+class SimMemMan : public memman::MemMan {
+public:
+    SimMemMan(uint64_t maxBytes, uint64_t bytesPerTable)
+        : _maxBytes(maxBytes), _bytesPerTable(bytesPerTable) {}
+
+    int lock(Handle handle, bool strict=false) override { return 0; }
+
+    Handle prepare(std::vector<TableInfo> const& tables, int chunk,
+                   bool streaming=false) override {
+        std::lock_guard<std::mutex> lock(_mtx);
+        uint64_t cost = 0;
+        bool required = false;
+        for (auto const& t : tables) {
+            if (t.theData != TableInfo::LockType::NOLOCK) cost += _bytesPerTable;
+            if (t.theData == TableInfo::LockType::REQUIRED) required = true;
+        }
+        if (cost == 0) return HandleType::ISEMPTY;
+        if (_bytesLocked + cost > _maxBytes) {
+            ++denials;
+            if (required) {
+                errno = ENOMEM;
+                return HandleType::INVALID;
+            }
+            return HandleType::ISEMPTY; // flexible, proceed unlocked
+        }
+        _bytesLocked += cost;
+        peakLocked = std::max(peakLocked, _bytesLocked);
+        ++grants;
+        Handle const h = _nextHandle++;
+        _handles[h] = cost;
+        return h;
+    }
+
+    bool unlock(Handle handle) override {
+        std::lock_guard<std::mutex> lock(_mtx);
+        auto iter = _handles.find(handle);
+        if (iter == _handles.end()) return false;
+        _bytesLocked -= iter->second;
+        _handles.erase(iter);
+        return true;
+    }
+
+    void unlockAll() override {
+        std::lock_guard<std::mutex> lock(_mtx);
+        _handles.clear();
+        _bytesLocked = 0;
+    }
+
+    Statistics getStatistics() override {
+        std::lock_guard<std::mutex> lock(_mtx);
+        Statistics stats{};
+        stats.bytesLockMax = _maxBytes;
+        stats.bytesLocked = _bytesLocked;
+        stats.numLocks = grants;
+        stats.numErrors = denials;
+        return stats;
+    }
+
+    Status getStatus(Handle handle) override {
+        std::lock_guard<std::mutex> lock(_mtx);
+        Status status{};
+        auto iter = _handles.find(handle);
+        if (iter != _handles.end()) status.bytesLock = iter->second;
+        return status;
+    }
+
+    uint64_t peakLocked = 0;
+    uint32_t grants = 0;
+    uint32_t denials = 0;
+
+private:
+    uint64_t const _maxBytes;
+    uint64_t const _bytesPerTable;
+    uint64_t _bytesLocked = 0;
+    Handle _nextHandle = 1000; // above HandleType::ISEMPTY
+    std::map<Handle, uint64_t> _handles;
+    std::mutex _mtx;
+};
+
+/// One replayed task: the trace fields plus the simulation results.
+struct TraceTask {
+    int64_t arrivalMs;
+    uint64_t queryId;
+    int jobId;
+    int chunkId;
+    char scanClass; // i/f/m/s
+    int64_t durationMs;
+    Task::Ptr task;
+    int64_t startMs = -1;
+    int64_t endMs = -1;
+};
+
+int scanRating(char scanClass) {
+    switch (scanClass) {
+        case 'f': return proto::ScanInfo::Rating::FAST;
+        case 'm': return proto::ScanInfo::Rating::MEDIUM;
+        case 's': return proto::ScanInfo::Rating::SLOW;
+        default:  return 0;
+    }
+}
+
+char const* className(char scanClass) {
+    switch (scanClass) {
+        case 'i': return "interactive";
+        case 'f': return "fast       ";
+        case 'm': return "medium     ";
+        case 's': return "slow       ";
+    }
+    return "?";
+}
+
+/// Build the Task for one trace record the way the tests do; interactive
+/// tasks carry no scan tables, scan tasks carry one locked-in-memory table
+/// at the class rating.
+Task::Ptr makeTraceTask(TraceTask const& rec) {
+    auto tm = std::make_shared<TaskMsg>();
+    tm->set_session(1);
+    tm->set_queryid(rec.queryId);
+    tm->set_jobid(rec.jobId);
+    tm->set_chunkid(rec.chunkId);
+    tm->set_db("sim");
+    auto frag = tm->add_fragment();
+    frag->add_query("SELECT simulated");
+    frag->set_resulttable("r_sim");
+    if (rec.scanClass != 'i') {
+        int const rating = scanRating(rec.scanClass);
+        tm->set_scanpriority(rating);
+        auto sTbl = tm->add_scantable();
+        sTbl->set_db("sim");
+        sTbl->set_table("Object");
+        sTbl->set_scanrating(rating);
+        sTbl->set_lockinmemory(true);
+    }
+    Task::Ptr task(new Task(tm, std::shared_ptr<wbase::SendChannel>()));
+    task->setSafeToMoveRunning(true); // No real MemMan wait in the simulator.
+    return task;
+}
+
+bool readTrace(std::istream& in, std::vector<TraceTask>& trace) {
+    std::string line;
+    int lineNum = 0;
+    while (std::getline(in, line)) {
+        ++lineNum;
+        if (line.empty() || line[0] == '#') continue;
+        TraceTask rec;
+        std::string cls;
+        std::istringstream fields(line);
+        if (!(fields >> rec.arrivalMs >> rec.queryId >> rec.jobId
+                     >> rec.chunkId >> cls >> rec.durationMs)
+            || cls.size() != 1 || std::string("ifms").find(cls[0]) == std::string::npos) {
+            std::cerr << "bad trace line " << lineNum << ": " << line << std::endl;
+            return false;
+        }
+        rec.scanClass = cls[0];
+        trace.push_back(rec);
+    }
+    return true;
+}
+
+/// A reproducible stand-in trace: mostly short interactive tasks with a
+/// tail of scans, so the binary is usable before any real trace export.
+void makeSyntheticTrace(std::vector<TraceTask>& trace) {
+    std::mt19937 rng(42);
+    std::uniform_int_distribution<int> chunk(0, 999);
+    std::uniform_real_distribution<double> frac(0.0, 1.0);
+    int64_t arrival = 0;
+    for (int i = 0; i != 10000; ++i) {
+        arrival += std::uniform_int_distribution<int>(0, 20)(rng);
+        TraceTask rec;
+        rec.arrivalMs = arrival;
+        rec.queryId = 1 + i / 20; // ~20 chunk tasks per query
+        rec.jobId = i % 20;
+        rec.chunkId = chunk(rng);
+        double const p = frac(rng);
+        if (p < 0.4) {
+            rec.scanClass = 'i';
+            rec.durationMs = std::uniform_int_distribution<int>(20, 200)(rng);
+        } else if (p < 0.7) {
+            rec.scanClass = 'f';
+            rec.durationMs = std::uniform_int_distribution<int>(500, 2000)(rng);
+        } else if (p < 0.9) {
+            rec.scanClass = 'm';
+            rec.durationMs = std::uniform_int_distribution<int>(2000, 10000)(rng);
+        } else {
+            rec.scanClass = 's';
+            rec.durationMs = std::uniform_int_distribution<int>(10000, 60000)(rng);
+        }
+        trace.push_back(rec);
+    }
+}
+
+int64_t percentile(std::vector<int64_t>& v, double p) {
+    if (v.empty()) return 0;
+    std::sort(v.begin(), v.end());
+    return v[static_cast<size_t>((v.size() - 1) * p)];
+}
+
+} // namespace
+
+
+int main(int argc, char const* argv[]) {
+
+    if (argc < 2) {
+        std::cerr << "usage: qserv-wsched-sim <trace-file|-> [poolThreads]"
+                     " [memLimitMB] [chunkMB]" << std::endl;
+        return 2;
+    }
+    int poolThreads = 12;
+    uint64_t memLimitMB = 16 * 1024;
+    uint64_t chunkMB = 512;
+    if (argc > 2) poolThreads = std::atoi(argv[2]);
+    if (argc > 3) memLimitMB = std::atoll(argv[3]);
+    if (argc > 4) chunkMB = std::atoll(argv[4]);
+    if (poolThreads < wsched::BlendScheduler::getMinPoolSize()) {
+        std::cerr << "poolThreads must be at least "
+                  << wsched::BlendScheduler::getMinPoolSize() << std::endl;
+        return 2;
+    }
+
+    std::vector<TraceTask> trace;
+    if (std::string(argv[1]) == "-") {
+        makeSyntheticTrace(trace);
+    } else {
+        std::ifstream in(argv[1]);
+        if (!in.good()) {
+            std::cerr << "cannot read trace file " << argv[1] << std::endl;
+            return 2;
+        }
+        if (!readTrace(in, trace)) return 2;
+    }
+    if (trace.empty()) {
+        std::cerr << "empty trace" << std::endl;
+        return 2;
+    }
+    std::stable_sort(trace.begin(), trace.end(),
+                     [](TraceTask const& a, TraceTask const& b) {
+                         return a.arrivalMs < b.arrivalMs;
+                     });
+
+    // The scheduler stack, wired as in testSchedulers/Foreman.
+    int const fastest = proto::ScanInfo::Rating::FASTEST;
+    int const fast = proto::ScanInfo::Rating::FAST;
+    int const medium = proto::ScanInfo::Rating::MEDIUM;
+    int const slow = proto::ScanInfo::Rating::SLOW;
+    double const hugeTimeLimit = 1e9; // Booting on time is the real clock's job.
+    int const maxActiveChunks = 20;
+    int priority = 2;
+    auto memMan = std::make_shared<SimMemMan>(memLimitMB << 20, chunkMB << 20);
+    auto group = std::make_shared<wsched::GroupScheduler>(
+            "GroupSched", poolThreads, 2, 3, priority++);
+    auto scanSlow = std::make_shared<wsched::ScanScheduler>(
+            "ScanSlow", poolThreads, 2, priority++, maxActiveChunks, memMan,
+            medium + 1, slow, hugeTimeLimit);
+    auto scanMed = std::make_shared<wsched::ScanScheduler>(
+            "ScanMed", poolThreads, 2, priority++, maxActiveChunks, memMan,
+            fast + 1, medium, hugeTimeLimit);
+    auto scanFast = std::make_shared<wsched::ScanScheduler>(
+            "ScanFast", poolThreads, 3, priority++, maxActiveChunks, memMan,
+            fastest, fast, hugeTimeLimit);
+    std::vector<wsched::ScanScheduler::Ptr> scanSchedulers{scanFast, scanMed};
+    auto queries = std::make_shared<wpublish::QueriesAndChunks>(
+            std::chrono::seconds(1), std::chrono::seconds(0), 5);
+    auto blend = std::make_shared<wsched::BlendScheduler>(
+            "blendSched", queries, poolThreads, group, scanSlow, scanSchedulers);
+    queries->setBlendScheduler(blend);
+    queries->setRequiredTasksCompleted(1);
+
+    std::unordered_map<util::Command*, size_t> byCmd;
+    for (size_t i = 0; i != trace.size(); ++i) {
+        trace[i].task = makeTraceTask(trace[i]);
+        byCmd[trace[i].task.get()] = i;
+    }
+
+    std::printf("%zu tasks, %d pool threads, memman %llu MB budget, %llu MB/chunk\n",
+                trace.size(), poolThreads,
+                static_cast<unsigned long long>(memLimitMB),
+                static_cast<unsigned long long>(chunkMB));
+
+    // Event loop on the virtual clock: arrivals come from the trace, a
+    // completion fires when a started task's recorded duration elapses.
+    auto const wallStart = std::chrono::steady_clock::now();
+    using Completion = std::pair<int64_t, size_t>; // endMs, trace index
+    std::priority_queue<Completion, std::vector<Completion>,
+                        std::greater<Completion>> running;
+    size_t nextArrival = 0;
+    size_t done = 0;
+    int freeThreads = poolThreads;
+    int64_t now = trace.front().arrivalMs;
+    while (done != trace.size()) {
+        // Queue every arrival due now.
+        while (nextArrival != trace.size()
+               && trace[nextArrival].arrivalMs <= now) {
+            blend->queCmd(trace[nextArrival].task);
+            ++nextArrival;
+        }
+        // Start whatever the schedulers will hand a free thread.
+        while (freeThreads > 0) {
+            auto cmd = blend->getCmd(false);
+            if (cmd == nullptr) break;
+            blend->commandStart(cmd);
+            size_t const idx = byCmd.at(cmd.get());
+            trace[idx].startMs = now;
+            running.push(Completion(now + trace[idx].durationMs, idx));
+            --freeThreads;
+        }
+        // Advance to the next event.
+        int64_t const tArr = (nextArrival != trace.size())
+                ? trace[nextArrival].arrivalMs : INT64_MAX;
+        int64_t const tFin = (!running.empty()) ? running.top().first : INT64_MAX;
+        if (tArr == INT64_MAX && tFin == INT64_MAX) {
+            std::cerr << "stalled at " << now << "ms with " << trace.size() - done
+                      << " tasks stuck on the queues (memman budget too small?)"
+                      << std::endl;
+            return 1;
+        }
+        if (tFin <= tArr) {
+            now = tFin;
+            size_t const idx = running.top().second;
+            running.pop();
+            trace[idx].endMs = now;
+            blend->commandFinish(trace[idx].task);
+            ++freeThreads;
+            ++done;
+        } else {
+            now = tArr;
+        }
+    }
+    auto const wallMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - wallStart).count();
+
+    int64_t const makespanMs = now - trace.front().arrivalMs;
+    std::printf("makespan %.3fs virtual, replayed in %.3fs wall (%.0fx)\n",
+                makespanMs / 1e3, wallMs / 1e3,
+                wallMs > 0 ? double(makespanMs) / wallMs : 0.0);
+
+    for (char cls : {'i', 'f', 'm', 's'}) {
+        std::vector<int64_t> waits;
+        std::vector<int64_t> lats;
+        for (auto const& rec : trace) {
+            if (rec.scanClass != cls) continue;
+            waits.push_back(rec.startMs - rec.arrivalMs);
+            lats.push_back(rec.endMs - rec.arrivalMs);
+        }
+        if (waits.empty()) continue;
+        std::printf("%s n=%6zu  wait p50/p90/p99 %7lld/%7lld/%7lld ms"
+                    "  latency p50/p90/p99 %7lld/%7lld/%7lld ms\n",
+                    className(cls), waits.size(),
+                    static_cast<long long>(percentile(waits, 0.5)),
+                    static_cast<long long>(percentile(waits, 0.9)),
+                    static_cast<long long>(percentile(waits, 0.99)),
+                    static_cast<long long>(percentile(lats, 0.5)),
+                    static_cast<long long>(percentile(lats, 0.9)),
+                    static_cast<long long>(percentile(lats, 0.99)));
+    }
+
+    std::printf("memman: peak %llu MB locked of %llu MB budget,"
+                " %u grants, %u denials\n",
+                static_cast<unsigned long long>(memMan->peakLocked >> 20),
+                static_cast<unsigned long long>(memLimitMB),
+                memMan->grants, memMan->denials);
+
+    return 0;
+}
@@ -518,6 +518,12 @@ BOOST_AUTO_TEST_CASE(BlendScheduleTest) {
     auto osF1 = f.blend->getCmd(false);
     BOOST_CHECK(osF1.get() == sF1.get()); // sF1 has lower chunkId than sF2
     BOOST_CHECK(f.blend->calcAvailableTheads() == 3);
+    // sF1's chunk is now in flight on ScanFast, so the other scan tiers see
+    // it as a phase alignment target. ScanFast itself does not, and chunks
+    // with nothing in flight are not targets for anyone.
+    BOOST_CHECK(f.scanMed->chunkActiveOnOtherScan(27) == true);
+    BOOST_CHECK(f.scanFast->chunkActiveOnOtherScan(27) == false);
+    BOOST_CHECK(f.scanMed->chunkActiveOnOtherScan(999) == false);
     auto osF2 = f.blend->getCmd(false);
     BOOST_CHECK(osF2.get() == sF2.get());
     BOOST_CHECK(f.blend->calcAvailableTheads() == 2);
@@ -1100,4 +1106,44 @@ BOOST_AUTO_TEST_CASE(ChunkTasksQueueTest) {
     BOOST_CHECK(ctl.getActiveChunkId() == -1);
 }
 
+
+BOOST_AUTO_TEST_CASE(ScanScheduleUserFairnessTest) {
+    // MemManNone always returns that memory is available.
+    auto memMan = std::make_shared<lsst::qserv::memman::MemManNone>(1, true);
+    wsched::ScanScheduler sched{"ScanSchedUsers", 4, 2, 0, 20, memMan, 0, 100, oneHr};
+    lsst::qserv::QueryId qIdInc = 1;
+    int chunkId = 7;
+
+    auto makeUserTask = [&](std::string const& user) {
+        auto msg = newTaskMsgScan(chunkId, 3, qIdInc++, 0);
+        msg->set_user(user);
+        return makeTask(msg);
+    };
+
+    // Two users with two identical-table Tasks each on the same chunk. The
+    // Tasks are interchangeable for MemMan, so the dispatch order is up to
+    // the per-user fairness of ChunkTasks.
+    sched.queCmd(makeUserTask("alice"));
+    sched.queCmd(makeUserTask("alice"));
+    sched.queCmd(makeUserTask("bob"));
+    sched.queCmd(makeUserTask("bob"));
+
+    BOOST_CHECK(sched.ready() == true);
+    auto t1 = std::dynamic_pointer_cast<Task>(sched.getCmd(false));
+    auto t2 = std::dynamic_pointer_cast<Task>(sched.getCmd(false));
+    // Whichever user went first, the second Task must belong to the other.
+    BOOST_CHECK(t1->user != t2->user);
+    BOOST_CHECK(sched.getTaskCountForUser("alice") == 1);
+    BOOST_CHECK(sched.getTaskCountForUser("bob") == 1);
+    auto t3 = std::dynamic_pointer_cast<Task>(sched.getCmd(false));
+    auto t4 = std::dynamic_pointer_cast<Task>(sched.getCmd(false));
+    BOOST_CHECK(t3->user != t4->user);
+    sched.commandFinish(t1);
+    sched.commandFinish(t2);
+    sched.commandFinish(t3);
+    sched.commandFinish(t4);
+    BOOST_CHECK(sched.getTaskCountForUser("alice") == 0);
+    BOOST_CHECK(sched.getTaskCountForUser("bob") == 0);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
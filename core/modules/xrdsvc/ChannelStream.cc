@@ -37,6 +37,18 @@
 
 namespace {
 LOG_LOGGER _log = LOG_GET("lsst.qserv.xrdsvc.ChannelStream");
+
+// Maximum number of bytes queued on a single stream before append() blocks
+// waiting for the client to consume some of them. This keeps a slow czar
+// from ballooning worker memory with finished results.
+uint64_t const maxQueuedBytes = 1024*1024*1024; // TODO:DM-10273 add to configuration
+
+// Messages no larger than this in combination may be merged with the message
+// still waiting at the back of the queue, so a burst of small transmits (e.g.
+// the tiny results of interactive point queries) costs one network operation
+// instead of one each. The czar treats the stream as a byte sequence, so
+// message boundaries need not be preserved.
+uint64_t const maxCoalesceBytes = 16*1024;
 }
 
 
@@ -71,7 +83,30 @@ void ChannelStream::append(StreamBuffer::Ptr const& streamBuffer, bool last) {
         std::unique_lock<std::mutex> lock(_mutex);
         LOGS(_log, LOG_LVL_DEBUG, "Trying to append message (flowing)");
 
-        _msgs.push_back(streamBuffer);
+        // Backpressure: wait for the client to consume some of the queue
+        // before accepting more data.
+        _hasSpaceCondition.wait(lock, [this](){ return _queuedBytes < maxQueuedBytes; });
+
+        // Coalesce adjacent small messages: copy this one onto the back of
+        // the message still waiting at the back of the queue rather than
+        // paying the per-message overhead for each. Buffers already handed
+        // to GetBuff() are off the queue and unaffected.
+        if (not _msgs.empty()
+            and _msgs.back()->getSize() + streamBuffer->getSize() <= maxCoalesceBytes) {
+            StreamBuffer::Ptr const tail = _msgs.back();
+            std::string merged;
+            merged.reserve(tail->getSize() + streamBuffer->getSize());
+            merged.append(tail->data, tail->getSize());
+            merged.append(streamBuffer->data, streamBuffer->getSize());
+            _msgs.back() = StreamBuffer::createWithMove(merged);
+            // The data of both buffers lives on in the merged one, so they
+            // can be released to anyone waiting on them right away.
+            tail->Recycle();
+            streamBuffer->Recycle();
+        } else {
+            _msgs.push_back(streamBuffer);
+        }
+        _queuedBytes += streamBuffer->getSize();
         _closed = last; // if last is true, then we are closed.
         _hasDataCondition.notify_one();
     }
@@ -97,6 +132,9 @@ XrdSsiStream::Buffer* ChannelStream::GetBuff(XrdSsiErrInfo &eInfo, int &dlen, bo
     StreamBuffer::Ptr sb = _msgs.front();
     dlen = sb->getSize();
     _msgs.pop_front();
+    if (_queuedBytes > static_cast<uint64_t>(dlen)) _queuedBytes -= dlen;
+    else _queuedBytes = 0;
+    _hasSpaceCondition.notify_one();
     last = _closed && _msgs.empty();
     LOGS(_log, LOG_LVL_DEBUG, "returning buffer (" << dlen << ", " << (last ? "(last)" : "(more)") << ")");
     return sb.get();
@@ -25,6 +25,7 @@
 
 // System headers
 #include <condition_variable>
+#include <cstdint>
 #include <deque>
 #include <mutex>
 #include <string>
@@ -60,8 +61,10 @@ private:
     bool _closed; ///< Closed to new append() calls?
     // Can keep a deque of (buf, bufsize) to reduce copying, if needed.
     std::deque<StreamBuffer::Ptr> _msgs; ///< Message queue
+    uint64_t _queuedBytes{0}; ///< Bytes queued in _msgs, protected by _mutex.
     std::mutex _mutex; ///< _msgs protection
     std::condition_variable _hasDataCondition; ///< _msgs condition
+    std::condition_variable _hasSpaceCondition; ///< append() backpressure condition
 };
 
 }}} // namespace lsst::qserv::xrdsvc
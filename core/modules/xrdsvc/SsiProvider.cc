@@ -40,6 +40,7 @@
 
 // Qserv headers
 #include "global/ResourceUnit.h"
+#include "global/debugUtil.h"
 #include "wconfig/WorkerConfig.h"
 #include "wpublish/ChunkInventory.h"
 #include "xrdsvc/XrdName.h"
@@ -72,7 +73,11 @@ namespace lsst {
 namespace qserv {
 namespace xrdsvc {
 
-SsiProviderServer::~SsiProviderServer() {}
+SsiProviderServer::~SsiProviderServer() {
+    // Leave a fresh inventory snapshot behind so the next start won't need
+    // to wait for the database scan.
+    _chunkInventory.saveSnapshot();
+}
 
 /******************************************************************************/
 /*                                  I n i t                                   */
@@ -124,7 +129,8 @@ bool SsiProviderServer::Init(XrdSsiLogger* logP,  XrdSsiCluster* clsP,
     // calls either in the data provider and the metadata provider (we can be
     // either one).
     //
-    _chunkInventory.init(x.getName(), workerConfig.getMySqlConfig());
+    _chunkInventory.init(x.getName(), workerConfig.getMySqlConfig(),
+                         workerConfig.getInventorySnapshotPath());
 
     // If we are a data provider (i.e. xrootd) then we need to get the service
     // object. It will print the exported paths. Otherwise, we need to print
@@ -173,8 +179,11 @@ XrdSsiProvider::rStat SsiProviderServer::QueryResource(char const* rName,
     } else if (ru.unitType() == ResourceUnit::WORKER) {
 
         // Extract the worker name and alidate it against the one which is
-        // provided through the inventory
-        if (not _chunkInventory.id().empty() and _chunkInventory.id() == ru.hashName()) {
+        // provided through the inventory. The worker also answers to its
+        // hostname so that the czar can address it using the endpoints of
+        // the chunk requests it has in flight.
+        if ((not _chunkInventory.id().empty() and _chunkInventory.id() == ru.hashName())
+            or getHostname() == ru.hashName()) {
             LOGS(_log, LOG_LVL_DEBUG, "SsiProvider Query " << rName << " present");
             return isPresent;
         }
@@ -38,20 +38,37 @@
 #include "global/ResourceUnit.h"
 #include "proto/FrameBuffer.h"
 #include "proto/worker.pb.h"
+#include "util/ThreadPool.h"
 #include "util/Timer.h"
 #include "wbase/MsgProcessor.h"
 #include "wbase/SendChannel.h"
 #include "wpublish/AddChunkGroupCommand.h"
 #include "wpublish/ChunkListCommand.h"
 #include "wpublish/GetChunkListCommand.h"
+#include "wpublish/GetSchedulerStatsCommand.h"
+#include "wpublish/KillQueryCommand.h"
 #include "wpublish/RemoveChunkGroupCommand.h"
 #include "wpublish/ResourceMonitor.h"
+#include "wpublish/ScheduleDropCommand.h"
 #include "wpublish/SetChunkListCommand.h"
+#include "wpublish/SetWorkerTuningCommand.h"
 #include "wpublish/TestEchoCommand.h"
 #include "xrdsvc/ChannelStream.h"
 
 namespace {
 LOG_LOGGER _log = LOG_GET("lsst.qserv.xrdsvc.SsiRequest");
+
+/// Threads that decode TaskMsgs and build Tasks off the XRootD SSI intake
+/// thread, so intake only checks the inventory and copies the request bytes
+/// no matter how large the message is. A few threads suffice: decoding is
+/// brief next to running the task, and ordering across requests is free.
+lsst::qserv::util::ThreadPool::Ptr const& intakePool() {
+    static lsst::qserv::util::ThreadPool::Ptr const pool =
+            lsst::qserv::util::ThreadPool::newThreadPool(
+                    4, std::make_shared<lsst::qserv::util::CommandQueue>());
+    return pool;
+}
+
 }
 
 namespace lsst {
@@ -110,39 +127,46 @@ void SsiRequest::execute(XrdSsiRequest& req) {
             // Increment the counter of the database/chunk resources in use
             _resourceMonitor->increment(_resourceName);
 
-            // reqData has the entire request, so we can unpack it without waiting for
-            // more data.
-            LOGS(_log, LOG_LVL_DEBUG, "Decoding TaskMsg of size " << reqSize);
-            auto taskMsg = std::make_shared<proto::TaskMsg>();
-            if (!taskMsg->ParseFromArray(reqData, reqSize) ||
-                !taskMsg->IsInitialized()) {
-                reportError("Failed to decode TaskMsg on resource db=" + ru.db() +
-                            " chunkId=" + std::to_string(ru.chunk()));
-                return;
-            }
+            // Copy the request bytes and release the xrootd buffer right away;
+            // decoding the TaskMsg (arbitrarily large) is deferred to the
+            // intake pool so this SSI thread goes straight back to accepting
+            // requests. The inventory check above is the only per-request
+            // work left inline. The copy must complete before the release,
+            // and the release before the hand-off, since the reply channel
+            // built below holds a reference to this (bound) SsiRequest.
+            auto reqStr = std::make_shared<std::string>(reqData, reqSize);
+            ReleaseRequestBuffer();
 
-            if (!taskMsg->has_db() || !taskMsg->has_chunkid()
-                || (ru.db()    != taskMsg->db())
-                || (ru.chunk() != taskMsg->chunkid())) {
-                reportError("Mismatched db/chunk in TaskMsg on resource db=" + ru.db() +
-                            " chunkId=" + std::to_string(ru.chunk()));
-                return;
-            }
+            auto self = shared_from_this();
+            auto parseAndQueue = [self, reqStr, ru](util::CmdData*) {
+                LOGS(_log, LOG_LVL_DEBUG, "Decoding TaskMsg of size " << reqStr->size());
+                auto taskMsg = std::make_shared<proto::TaskMsg>();
+                if (!taskMsg->ParseFromArray(reqStr->data(), reqStr->size()) ||
+                    !taskMsg->IsInitialized()) {
+                    LOGS(_log, LOG_LVL_WARN, "Failed to decode TaskMsg on resource db=" <<
+                         ru.db() << " chunkId=" << ru.chunk());
+                    self->replyError("Failed to decode TaskMsg on resource db=" + ru.db() +
+                                     " chunkId=" + std::to_string(ru.chunk()), EINVAL);
+                    return;
+                }
 
-            // Now that the request is decoded (successfully or not), release the
-            // xrootd request buffer. To avoid data races, this must happen before
-            // the task is handed off to another thread for processing, as there is a
-            // reference to this SsiRequest inside the reply channel for the task,
-            // and after the call to BindRequest.
-            auto task = std::make_shared<wbase::Task>(
-                                taskMsg,
-                                std::make_shared<wbase::SendChannel>(shared_from_this()));
-            ReleaseRequestBuffer();
-            t.start();
-            _processor->processTask(task); // Queues task to be run later.
-            t.stop();
-            LOGS(_log, LOG_LVL_DEBUG, "Enqueued TaskMsg for " << ru <<
-                 " in " << t.getElapsed() << " seconds");
+                if (!taskMsg->has_db() || !taskMsg->has_chunkid()
+                    || (ru.db()    != taskMsg->db())
+                    || (ru.chunk() != taskMsg->chunkid())) {
+                    LOGS(_log, LOG_LVL_WARN, "Mismatched db/chunk in TaskMsg on resource db=" <<
+                         ru.db() << " chunkId=" << ru.chunk());
+                    self->replyError("Mismatched db/chunk in TaskMsg on resource db=" + ru.db() +
+                                     " chunkId=" + std::to_string(ru.chunk()), EINVAL);
+                    return;
+                }
+
+                auto task = std::make_shared<wbase::Task>(
+                                    taskMsg,
+                                    std::make_shared<wbase::SendChannel>(self));
+                self->_processor->processTask(task); // Queues task to be run later.
+                LOGS(_log, LOG_LVL_DEBUG, "Enqueued TaskMsg for " << ru);
+            };
+            intakePool()->getQueue()->queCmd(std::make_shared<util::Command>(parseAndQueue));
 
             break;
         }
@@ -263,30 +287,118 @@ wbase::WorkerCommand::Ptr SsiRequest::parseWorkerCommand(char const* reqData, in
                                     _resourceMonitor);
                 break;
             }
+            case proto::WorkerCommandH::GET_SCHEDULER_STATS: {
+
+                command = std::make_shared<wpublish::GetSchedulerStatsCommand> (
+                                    sendChannel,
+                                    _scheduler);
+                break;
+            }
+            case proto::WorkerCommandH::KILL_QUERY: {
+
+                LOGS(_log, LOG_LVL_DEBUG, "Decoding WorkerCommandKillQueryM");
+                proto::WorkerCommandKillQueryM message;
+                view.parse(message);
+
+                command = std::make_shared<wpublish::KillQueryCommand> (
+                                    sendChannel,
+                                    _scheduler,
+                                    message.query_id());
+                break;
+            }
+            case proto::WorkerCommandH::SCHEDULE_DROP: {
+
+                LOGS(_log, LOG_LVL_DEBUG, "Decoding WorkerCommandScheduleDropM");
+                proto::WorkerCommandScheduleDropM message;
+                view.parse(message);
+
+                command = std::make_shared<wpublish::ScheduleDropCommand> (
+                                    sendChannel,
+                                    _resourceMonitor,
+                                    _mySqlConfig,
+                                    message.db(),
+                                    message.table());
+                break;
+            }
+            case proto::WorkerCommandH::SET_WORKER_TUNING: {
+
+                LOGS(_log, LOG_LVL_DEBUG, "Decoding WorkerCommandSetWorkerTuningM");
+                proto::WorkerCommandSetWorkerTuningM message;
+                view.parse(message);
+
+                std::vector<wpublish::SetWorkerTuningCommand::SchedulerTuning> schedulers;
+                for (int i = 0, num = message.scheduler_size(); i < num; ++i) {
+                    auto const& sched = message.scheduler(i);
+                    wpublish::SetWorkerTuningCommand::SchedulerTuning tuning;
+                    tuning.name = sched.name();
+                    if (sched.has_priority())          tuning.priority        = sched.priority();
+                    if (sched.has_max_reserve())       tuning.maxReserve      = sched.max_reserve();
+                    if (sched.has_max_active_chunks()) tuning.maxActiveChunks = sched.max_active_chunks();
+                    schedulers.push_back(tuning);
+                }
+                command = std::make_shared<wpublish::SetWorkerTuningCommand> (
+                                    sendChannel,
+                                    _scheduler,
+                                    schedulers,
+                                    message.has_memman_size_mb() ? message.memman_size_mb() : 0);
+                break;
+            }
             case proto::WorkerCommandH::SET_CHUNK_LIST: {
 
                 LOGS(_log, LOG_LVL_DEBUG, "Decoding WorkerCommandSetChunkListM");
                 proto::WorkerCommandSetChunkListM message;
                 view.parse(message);
 
-                std::vector<wpublish::SetChunkListCommand::Chunk> chunks;
-                for (int i = 0, num = message.chunks_size(); i < num; ++i) {
-                    chunks.push_back(
-                        wpublish::SetChunkListCommand::Chunk{
-                            message.chunks(i).db(),
-                            message.chunks(i).chunk()
-                        }
-                    );
-                }
                 bool const force = message.force();
 
-                command = std::make_shared<wpublish::SetChunkListCommand> (
-                                    sendChannel,
-                                    _chunkInventory,
-                                    _resourceMonitor,
-                                    _mySqlConfig,
-                                    chunks,
-                                    force);
+                if (message.incremental()) {
+
+                    std::vector<wpublish::SetChunkListCommand::Chunk> addChunks;
+                    for (int i = 0, num = message.added_size(); i < num; ++i) {
+                        addChunks.push_back(
+                            wpublish::SetChunkListCommand::Chunk{
+                                message.added(i).db(),
+                                message.added(i).chunk()
+                            }
+                        );
+                    }
+                    std::vector<wpublish::SetChunkListCommand::Chunk> removeChunks;
+                    for (int i = 0, num = message.removed_size(); i < num; ++i) {
+                        removeChunks.push_back(
+                            wpublish::SetChunkListCommand::Chunk{
+                                message.removed(i).db(),
+                                message.removed(i).chunk()
+                            }
+                        );
+                    }
+                    command = std::make_shared<wpublish::SetChunkListCommand> (
+                                        sendChannel,
+                                        _chunkInventory,
+                                        _resourceMonitor,
+                                        _mySqlConfig,
+                                        addChunks,
+                                        removeChunks,
+                                        message.base_version(),
+                                        force);
+                } else {
+
+                    std::vector<wpublish::SetChunkListCommand::Chunk> chunks;
+                    for (int i = 0, num = message.chunks_size(); i < num; ++i) {
+                        chunks.push_back(
+                            wpublish::SetChunkListCommand::Chunk{
+                                message.chunks(i).db(),
+                                message.chunks(i).chunk()
+                            }
+                        );
+                    }
+                    command = std::make_shared<wpublish::SetChunkListCommand> (
+                                        sendChannel,
+                                        _chunkInventory,
+                                        _resourceMonitor,
+                                        _mySqlConfig,
+                                        chunks,
+                                        force);
+                }
                 break;
             }
             default:
@@ -51,6 +51,9 @@ struct MsgProcessor;
 }
 namespace wpublish {
 class ResourceMonitor;
+}
+namespace wsched {
+class BlendScheduler;
 }}}
 
 namespace lsst {
@@ -79,12 +82,14 @@ public:
             std::string const&                               rname,
             std::shared_ptr<wpublish::ChunkInventory> const& chunkInventory,
             std::shared_ptr<wbase::MsgProcessor> const&      processor,
-            mysql::MySqlConfig const&                        mySqlConfig) {
+            mysql::MySqlConfig const&                        mySqlConfig,
+            std::shared_ptr<wsched::BlendScheduler> const&   scheduler = nullptr) {
 
         return SsiRequest::Ptr(new SsiRequest(rname,
                                               chunkInventory,
                                               processor,
-                                              mySqlConfig));
+                                              mySqlConfig,
+                                              scheduler));
     }
 
     virtual ~SsiRequest();
@@ -111,13 +116,15 @@ private:
     SsiRequest(std::string const&                               rname,
                std::shared_ptr<wpublish::ChunkInventory> const& chunkInventory,
                std::shared_ptr<wbase::MsgProcessor> const&      processor,
-               mysql::MySqlConfig const&                        mySqlConfig)
+               mysql::MySqlConfig const&                        mySqlConfig,
+               std::shared_ptr<wsched::BlendScheduler> const&   scheduler)
         :   _chunkInventory(chunkInventory),
             _validator(_chunkInventory->newValidator()),
             _processor(processor),
             _resourceName(rname),
             _stream(0),
-            _mySqlConfig(mySqlConfig) {
+            _mySqlConfig(mySqlConfig),
+            _scheduler(scheduler) {
     }
     
     /// For internal error reporting
@@ -149,6 +156,9 @@ private:
     ChannelStream* _stream;
 
     mysql::MySqlConfig const _mySqlConfig;
+
+    /// Task scheduler, for the statistics reporting command.
+    std::shared_ptr<wsched::BlendScheduler> _scheduler;
 };
 
 }}} // namespace
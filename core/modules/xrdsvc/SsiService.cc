@@ -26,6 +26,7 @@
 
 // System headers
 #include <cassert>
+#include <future>
 #include <iostream>
 #include <string>
 #include <stdlib.h>
@@ -42,7 +43,9 @@
 #include "memman/MemMan.h"
 #include "memman/MemManNone.h"
 #include "mysql/MySqlConnection.h"
+#include "qhttp/MetricsServer.h"
 #include "sql/SqlConnection.h"
+#include "util/ObjectCensus.h"
 #include "wbase/Base.h"
 #include "wconfig/WorkerConfig.h"
 #include "wconfig/WorkerConfigError.h"
@@ -77,20 +80,30 @@ SsiService::SsiService(XrdSsiLogger* log, wconfig::WorkerConfig const& workerCon
     LOGS(_log, LOG_LVL_DEBUG, "SsiService starting...");
 
 
-    if (not mysql::MySqlConnection::checkConnection(_mySqlConfig)) {
-        LOGS(_log, LOG_LVL_FATAL, "Unable to connect to MySQL using configuration:" << _mySqlConfig);
-        throw wconfig::WorkerConfigError("Unable to connect to MySQL");
-    }
-    _initInventory();
+    // The inventory database scan is the slow part of worker bring-up and
+    // nothing below needs its result, so it runs on its own thread while the
+    // memory manager and the schedulers are constructed eagerly. Request
+    // intake gates on _inventoryReady (see ProcessRequest), so the latch is
+    // released only once the inventory is complete; a bring-up failure is
+    // rethrown from there instead of from this constructor.
+    _inventoryReady = std::async(std::launch::async, [this]() {
+        if (not mysql::MySqlConnection::checkConnection(_mySqlConfig)) {
+            LOGS(_log, LOG_LVL_FATAL, "Unable to connect to MySQL using configuration:" << _mySqlConfig);
+            throw wconfig::WorkerConfigError("Unable to connect to MySQL");
+        }
+        _initInventory();
+    }).share();
 
     std::string cfgMemMan = workerConfig.getMemManClass();
     memman::MemMan::Ptr memMan;
     if (cfgMemMan  == "MemManReal") {
         // Default to 1 gigabyte
         uint64_t memManSize = workerConfig.getMemManSizeMb()*1000000;
-        LOGS(_log, LOG_LVL_DEBUG, "Using MemManReal with memManSizeMb=" << workerConfig.getMemManSizeMb() 
-            << " location=" <<  workerConfig.getMemManLocation());
-        memMan = std::shared_ptr<memman::MemMan>(memman::MemMan::create(memManSize, workerConfig.getMemManLocation()));
+        LOGS(_log, LOG_LVL_DEBUG, "Using MemManReal with memManSizeMb=" << workerConfig.getMemManSizeMb()
+            << " location=" <<  workerConfig.getMemManLocation()
+            << " hugePages=" << workerConfig.getMemManHugePages());
+        memMan = std::shared_ptr<memman::MemMan>(memman::MemMan::create(memManSize, workerConfig.getMemManLocation(),
+                                                                        workerConfig.getMemManHugePages()));
     } else if (cfgMemMan == "MemManNone"){
         memMan = std::make_shared<memman::MemManNone>(1, false);
     } else {
@@ -118,22 +131,23 @@ SsiService::SsiService(XrdSsiLogger* log, wconfig::WorkerConfig const& workerCon
     double slowScanMaxMinutes = (double)workerConfig.getScanMaxMinutesSlow();
     double snailScanMaxMinutes = (double)workerConfig.getScanMaxMinutesSnail();
     int maxTasksBootedPerUserQuery = workerConfig.getMaxTasksBootedPerUserQuery();
+    bool flashQueue = workerConfig.getScanFlashQueue(); // SSD/NVMe workers skip the elevator order.
     std::vector<wsched::ScanScheduler::Ptr> scanSchedulers{
         std::make_shared<wsched::ScanScheduler>(
             "SchedSlow", maxThread, workerConfig.getMaxReserveSlow(), workerConfig.getPrioritySlow(),
-            workerConfig.getMaxActiveChunksSlow(), memMan, medium+1, slow, slowScanMaxMinutes),
+            workerConfig.getMaxActiveChunksSlow(), memMan, medium+1, slow, slowScanMaxMinutes, flashQueue),
         std::make_shared<wsched::ScanScheduler>(
             "SchedMed", maxThread, workerConfig.getMaxReserveMed(), workerConfig.getPriorityMed(),
-            workerConfig.getMaxActiveChunksMed(), memMan, fast+1, medium, medScanMaxMinutes),
+            workerConfig.getMaxActiveChunksMed(), memMan, fast+1, medium, medScanMaxMinutes, flashQueue),
         std::make_shared<wsched::ScanScheduler>(
             "SchedFast", maxThread, workerConfig.getMaxReserveFast(), workerConfig.getPriorityFast(),
-            workerConfig.getMaxActiveChunksFast(), memMan, fastest, fast, fastScanMaxMinutes),
+            workerConfig.getMaxActiveChunksFast(), memMan, fastest, fast, fastScanMaxMinutes, flashQueue),
 
     };
 
     auto snail = std::make_shared<wsched::ScanScheduler>(
         "SchedSnail", maxThread, workerConfig.getMaxReserveSnail(), workerConfig.getPrioritySnail(),
-        workerConfig.getMaxActiveChunksSnail(), memMan, slow+1, slowest, snailScanMaxMinutes);
+        workerConfig.getMaxActiveChunksSnail(), memMan, slow+1, slowest, snailScanMaxMinutes, flashQueue);
 
     wpublish::QueriesAndChunks::Ptr queries =
         std::make_shared<wpublish::QueriesAndChunks>(std::chrono::minutes(5), std::chrono::minutes(5),
@@ -147,6 +161,72 @@ SsiService::SsiService(XrdSsiLogger* log, wconfig::WorkerConfig const& workerCon
 
     _foreman = std::make_shared<wcontrol::Foreman>(
             blendSched, poolSize, workerConfig.getMySqlConfig(), queries);
+    _scheduler = blendSched;
+    _memMan = memMan;
+
+    if (workerConfig.getMetricsPort() != 0) {
+        _startMetricsServer(workerConfig.getMetricsPort());
+    }
+}
+
+void SsiService::_startMetricsServer(unsigned int port) {
+    _metricsServer = qhttp::MetricsServer::create(port);
+
+    // Per-scheduler counters and latency percentiles. getSchedStats() merges
+    // lock-free histogram shards, so a scrape never contends with queCmd().
+    auto scheduler = _scheduler;
+    _metricsServer->addSource([scheduler](std::ostream& os) {
+        for (auto const& sched : scheduler->getSubSchedulers()) {
+            std::string const labels = "scheduler=\"" + sched->getName() + "\"";
+            auto const stats = sched->getSchedStats();
+            qhttp::MetricsServer::writeMetric(os, "qserv_worker_tasks_queued_total", labels,
+                                              stats.tasksQueued);
+            qhttp::MetricsServer::writeMetric(os, "qserv_worker_tasks_started_total", labels,
+                                              stats.tasksStarted);
+            qhttp::MetricsServer::writeMetric(os, "qserv_worker_tasks_completed_total", labels,
+                                              stats.tasksCompleted);
+            qhttp::MetricsServer::writeMetric(os, "qserv_worker_bytes_locked_total", labels,
+                                              stats.bytesLocked);
+            qhttp::MetricsServer::writeMetric(os, "qserv_worker_tasks_in_flight", labels,
+                                              static_cast<uint64_t>(sched->getInFlight()));
+            qhttp::MetricsServer::writeMetric(os, "qserv_worker_tasks_in_queue", labels,
+                                              static_cast<uint64_t>(sched->getSize()));
+            sched->timeInQHistogram().writePrometheus(os, "qserv_worker_time_in_queue_ms", labels);
+        }
+    });
+
+    // Live-object counts from the census: one relaxed atomic read per
+    // registered class.
+    _metricsServer->addSource([](std::ostream& os) {
+        for (auto const& entry : util::ObjectCensus::get().snapshot()) {
+            std::string const labels = "class=\"" + entry.first + "\"";
+            qhttp::MetricsServer::writeMetric(os, "qserv_worker_live_objects", labels,
+                                              static_cast<uint64_t>(entry.second));
+        }
+    });
+
+    // Memory manager occupancy, a handful of atomic counter reads.
+    auto memMan = _memMan;
+    _metricsServer->addSource([memMan](std::ostream& os) {
+        auto const stats = memMan->getStatistics();
+        qhttp::MetricsServer::writeMetric(os, "qserv_worker_memman_bytes_locked", "",
+                                          stats.bytesLocked);
+        qhttp::MetricsServer::writeMetric(os, "qserv_worker_memman_bytes_reserved", "",
+                                          stats.bytesReserved);
+        qhttp::MetricsServer::writeMetric(os, "qserv_worker_memman_bytes_lock_max", "",
+                                          stats.bytesLockMax);
+        qhttp::MetricsServer::writeMetric(os, "qserv_worker_memman_locks_total", "",
+                                          static_cast<uint64_t>(stats.numLocks));
+        qhttp::MetricsServer::writeMetric(os, "qserv_worker_memman_map_errors_total", "",
+                                          static_cast<uint64_t>(stats.numMapErrors));
+        qhttp::MetricsServer::writeMetric(os, "qserv_worker_memman_lock_errors_total", "",
+                                          static_cast<uint64_t>(stats.numLokErrors));
+        qhttp::MetricsServer::writeMetric(os, "qserv_worker_memman_errors_total", "",
+                                          static_cast<uint64_t>(stats.numErrors));
+    });
+
+    _metricsServer->start();
+    LOGS(_log, LOG_LVL_INFO, "Serving /metrics on port " << port);
 }
 
 SsiService::~SsiService() {
@@ -155,7 +235,15 @@ SsiService::~SsiService() {
 
 void SsiService::ProcessRequest(XrdSsiRequest &reqRef, XrdSsiResource &resRef) {
     LOGS(_log, LOG_LVL_DEBUG, "Got request call where rName is: " << resRef.rName);
-    auto request = SsiRequest::newSsiRequest(resRef.rName, _chunkInventory, _foreman, _mySqlConfig);
+
+    // Wait out the background inventory scan; once it has finished this is a
+    // memory fence with no contention. If bring-up failed the exception is
+    // rethrown here for every request, as the worker cannot serve anything.
+    _inventoryReady.get();
+
+
+    auto request = SsiRequest::newSsiRequest(resRef.rName, _chunkInventory, _foreman, _mySqlConfig,
+                                             _scheduler);
 
     // Continue execution in the session object as SSI gave us a new thread.
     // Object deletes itself when finished is called.
@@ -25,6 +25,7 @@
 #define LSST_QSERV_XRDSVC_SSISERVICE_H
 
 // System headers
+#include <future>
 #include <memory>
 
 // Third-party headers
@@ -40,11 +41,20 @@ class XrdSsiLogger;
 
 namespace lsst {
 namespace qserv {
+namespace memman {
+  class MemMan;
+}
+namespace qhttp {
+  class MetricsServer;
+}
 namespace wcontrol {
   class Foreman;
 }
 namespace wpublish {
   class ChunkInventory;
+}
+namespace wsched {
+  class BlendScheduler;
 }}} // End of forward declarations
 
 
@@ -75,8 +85,22 @@ private:
     void _initInventory();
     void _configure();
 
+    /// Start the embedded HTTP server exposing worker counters on /metrics.
+    void _startMetricsServer(unsigned int port);
+
     std::shared_ptr<wpublish::ChunkInventory> _chunkInventory;
+
+    /// Readiness latch for the inventory scan, which runs on its own thread
+    /// while the rest of the service is constructed. ProcessRequest() blocks
+    /// on it, so no request can see a partially built inventory.
+    std::shared_future<void> _inventoryReady;
     std::shared_ptr<wcontrol::Foreman> _foreman;
+    std::shared_ptr<wsched::BlendScheduler> _scheduler; ///< For statistics reporting.
+    std::shared_ptr<memman::MemMan> _memMan; ///< For statistics reporting.
+
+    /// Embedded HTTP server for the Prometheus /metrics endpoint,
+    /// nullptr unless metrics.port is configured.
+    std::shared_ptr<qhttp::MetricsServer> _metricsServer;
 
     mysql::MySqlConfig const _mySqlConfig;
 
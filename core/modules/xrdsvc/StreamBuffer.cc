@@ -24,6 +24,10 @@
 // Class header
 #include "xrdsvc/StreamBuffer.h"
 
+// System headers
+#include <mutex>
+#include <vector>
+
 // Third-party headers
 #include "boost/utility.hpp"
 
@@ -35,6 +39,80 @@
 
 namespace {
 LOG_LOGGER _log = LOG_GET("lsst.qserv.xrdsvc.StreamBuffer");
+
+
+/// A pool of recycled StreamBuffer storage, size-classed by power of two
+/// capacity. Transmit blocks cluster around a few sizes (the negotiated
+/// block cap and the header size), so pooling their storage turns the
+/// per-transmit large malloc/free pair into a pop/push. Segments smaller
+/// than the minimum class or arriving when the pool is at its byte or
+/// per-class count cap are simply freed, which is also the trim policy.
+class SegmentPool {
+public:
+    static size_t const MIN_SEGMENT = 4096; ///< Don't pool below this; SSO strings are free anyway.
+    static size_t const MAX_POOLED_BYTES = 256*1024*1024;
+    static size_t const MAX_PER_CLASS = 16;
+
+    static SegmentPool& instance() {
+        static SegmentPool pool;
+        return pool;
+    }
+
+    /// @return a string with capacity >= minSize from the pool, or an
+    /// empty string for the caller to grow itself.
+    std::string acquire(size_t minSize) {
+        std::lock_guard<std::mutex> lock(_mtx);
+        for (size_t c = _classOf(minSize); c < _classes.size(); ++c) {
+            auto& segs = _classes[c];
+            if (!segs.empty()) {
+                std::string seg = std::move(segs.back());
+                segs.pop_back();
+                _bytes -= seg.capacity();
+                --_count;
+                seg.clear();
+                return seg;
+            }
+        }
+        return std::string();
+    }
+
+    /// Park 'seg' for reuse, or free it if it is too small or the pool is full.
+    void release(std::string&& seg) {
+        size_t const cap = seg.capacity();
+        if (cap < MIN_SEGMENT) return;
+        std::lock_guard<std::mutex> lock(_mtx);
+        // A segment of capacity 'cap' belongs to the class it can satisfy,
+        // i.e. the largest class whose requests all fit in it.
+        size_t c = _classOf(cap);
+        if ((size_t(1) << c) > cap) --c;
+        if (c >= _classes.size()) c = _classes.size() - 1;
+        if (_bytes + cap > MAX_POOLED_BYTES || _classes[c].size() >= MAX_PER_CLASS) {
+            return; // freed on destruction of 'seg'
+        }
+        _bytes += cap;
+        ++_count;
+        _classes[c].push_back(std::move(seg));
+    }
+
+    size_t bytes() const { return _bytes; }
+    size_t count() const { return _count; }
+
+private:
+    SegmentPool() : _classes(28) {} // classes up to 2^27 = 128MB
+
+    /// @return the smallest class index whose segments can hold 'size' bytes.
+    size_t _classOf(size_t size) const {
+        size_t c = 12; // 2^12 == MIN_SEGMENT
+        while ((size_t(1) << c) < size && c + 1 < _classes.size()) ++c;
+        return c;
+    }
+
+    std::mutex _mtx;
+    std::vector<std::vector<std::string>> _classes;
+    std::atomic<size_t> _bytes{0};
+    std::atomic<size_t> _count{0};
+};
+
 }
 
 
@@ -52,6 +130,13 @@ StreamBuffer::Ptr StreamBuffer::createWithMove(std::string &input) {
  }
 
 
+StreamBuffer::Ptr StreamBuffer::createWithCapacity(size_t bufSize) {
+     Ptr ptr(new StreamBuffer(bufSize));
+     ptr->_selfKeepAlive = ptr;
+     return ptr;
+ }
+
+
 StreamBuffer::StreamBuffer(std::string &input) {
     _dataStr = std::move(input);
     // TODO: try to make 'data' a const char* in xrootd code.
@@ -65,12 +150,37 @@ StreamBuffer::StreamBuffer(std::string &input) {
 }
 
 
+StreamBuffer::StreamBuffer(size_t bufSize) {
+    // Reuse a recycled segment when one of adequate capacity is pooled;
+    // resize() is then a no-op allocation-wise.
+    _dataStr = SegmentPool::instance().acquire(bufSize);
+    _dataStr.resize(bufSize);
+    data = (char*)(_dataStr.data());
+    next = 0;
+
+    _totalBytes += _dataStr.size();
+    LOGS(_log, LOG_LVL_DEBUG, "StreamBuffer::_totalBytes=" << _totalBytes);
+}
+
+
 StreamBuffer::~StreamBuffer() {
     _totalBytes -= _dataStr.size();
+    // Park the storage for the next transmit instead of freeing it.
+    SegmentPool::instance().release(std::move(_dataStr));
     LOGS(_log, LOG_LVL_DEBUG, "~StreamBuffer::_totalBytes=" << _totalBytes);
 }
 
 
+size_t StreamBuffer::getPooledBytes() {
+    return SegmentPool::instance().bytes();
+}
+
+
+size_t StreamBuffer::getPooledCount() {
+    return SegmentPool::instance().count();
+}
+
+
  /// xrdssi calls this to recycle the buffer when finished.
  void StreamBuffer::Recycle() {
      {
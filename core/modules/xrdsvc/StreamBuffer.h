@@ -31,7 +31,7 @@
 #include <string>
 
 // qserv headers
-#include "util/InstanceCount.h"
+#include "util/ObjectCensus.h"
 
 // Third-party headers
 #include "XrdSsi/XrdSsiErrInfo.hh" // required by XrdSsiStream
@@ -46,7 +46,10 @@ namespace xrdsvc {
 /// to XrdSsi.
 /// Its notable feature is the Recycle() function, which XrdSsi will
 /// promptly call when it no longer needs the buffer.
-class StreamBuffer : public XrdSsiStream::Buffer {
+/// The backing storage is drawn from and returned to a size-classed pool
+/// (see StreamBuffer.cc), so steady-state transmits reuse a small set of
+/// large segments instead of churning the allocator with them.
+class StreamBuffer : public XrdSsiStream::Buffer, public util::CensusMember<StreamBuffer> {
 public:
     using Ptr = std::shared_ptr<StreamBuffer>;
 
@@ -59,11 +62,22 @@ public:
     //  The constructor uses move to avoid copying the string.
     static StreamBuffer::Ptr createWithMove(std::string &input);
 
+    /// Factory function for a buffer of 'bufSize' bytes to be filled in place
+    /// through 'data', e.g. by protobuf serialization, so the result never
+    /// exists anywhere but in the buffer handed to XrdSsi.
+    static StreamBuffer::Ptr createWithCapacity(size_t bufSize);
+
     size_t getSize() const { return _dataStr.size(); }
 
     /// @Return total number of bytes used by ALL StreamBuffer objects.
     static size_t getTotalBytes() { return _totalBytes; }
 
+    /// @Return bytes currently parked in the recycled segment pool.
+    static size_t getPooledBytes();
+
+    /// @Return number of segments currently parked in the recycled segment pool.
+    static size_t getPooledCount();
+
     //!> Call to recycle the buffer when finished
     void Recycle() override;
 
@@ -80,12 +94,14 @@ private:
     // This constructor will invalidate 'input'.
     explicit StreamBuffer(std::string &input);
 
+    // Construct an uninitialized buffer of 'bufSize' bytes.
+    explicit StreamBuffer(size_t bufSize);
+
     std::string _dataStr;
     std::mutex _mtx;
     std::condition_variable _cv;
     bool _doneWithThis{false};
     Ptr _selfKeepAlive; ///< keep this object alive until after Recycle() is called.
-    util::InstanceCount _ic{"StreamBuffer"}; ///< Useful as it indicates amount of waiting for czar.
 
     static std::atomic<size_t> _totalBytes;
 };
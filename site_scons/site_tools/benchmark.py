@@ -0,0 +1,199 @@
+"""
+Tool-specific initialization for Benchmark and BenchmarkCheck builders.
+
+This module defines SCons tool (with name benchmark) which handles running
+of the performance benchmarks as a build tier ("scons bench"). It follows
+the shape of the unittest tool: the Benchmark builder runs one benchmark
+binary and records the outcome without failing the build, BenchmarkCheck
+inspects the recorded outcomes, writes the aggregate JSON report and
+generates an error if any benchmark breached its envelope.
+
+Benchmarks are gated against checked-in baseline envelopes selected by
+machine profile (the BENCH_BASELINES environment entry points at the
+profile's JSON file). The baseline file declares, per benchmark binary:
+
+    {
+      "benchmarks": {
+        "<binary-name>": {
+          "args": ["arg1", ...],          # command line of the gated run
+          "metrics": {
+            "<metric-name>": {
+              "pattern": "<regex>",       # searched in the benchmark output;
+                                          # omit to use the measured wall time
+              "group": 1,                 # capture group holding the value
+              "min": <number>,            # envelope bounds; either or both
+              "max": <number>
+            }, ...
+          }
+        }, ...
+      }
+    }
+
+A benchmark fails its gate if it exits non-zero, if a declared metric is
+not found in its output (output format drift must not silently disable a
+gate), or if a metric value falls outside its envelope. A benchmark with
+no baseline entry runs with default arguments and only its exit status is
+checked.
+
+The per-benchmark target is a JSON file (binary name + ".bench") with the
+run's metrics; BenchmarkCheck merges them into one report.
+"""
+from __future__ import print_function
+
+import json
+import os
+import re
+import time
+
+from SCons.Builder import Builder
+from SCons.Errors import StopError
+
+
+def _loadBaselines(env):
+    """Return the parsed baseline file of the selected profile, or {}."""
+    path = env.get('BENCH_BASELINES')
+    if not path or not os.path.isfile(path):
+        return {}
+    with open(path) as f:
+        return json.load(f)
+
+
+class _benchmark(object):
+    """
+    Class which implements builder action for Benchmark.
+    """
+
+    def __call__(self, target, source, env):
+        """Both target and source should be a single file"""
+        if len(target) != 1:
+            raise StopError("unexpected number of targets for benchmark: " + str(target))
+        if len(source) != 1:
+            raise StopError("unexpected number of sources for benchmark: " + str(source))
+
+        out = str(target[0])
+        exe = str(source[0])
+        name = os.path.basename(exe)
+        log = out + '.log'
+
+        config = _loadBaselines(env).get('benchmarks', {}).get(name, {})
+        args = [str(a) for a in config.get('args', [])]
+
+        # benchmark binaries are not installed yet, so the qserv shared
+        # libraries have to come from the build directory
+        cmdenv = ["{}='{}'".format("LD_LIBRARY_PATH", env.subst('$build_dir'))]
+        log_config = env.get("UNIT_TEST_LOG_CONFIG")
+        if log_config:
+            cmdenv.append("LSST_LOG_CONFIG={}".format(log_config))
+
+        cmd = "{} {} {} > {} 2>&1".format(" ".join(cmdenv), exe, " ".join(args), log)
+
+        result = {
+            "benchmark": name,
+            "command": " ".join([exe] + args),
+            "log": log,
+            "metrics": {},
+            "failures": [],
+        }
+        start = time.time()
+        try:
+            ret = os.system(cmd)
+        except Exception as exc:
+            ret = -1
+            result['failures'].append("failed to run: " + str(exc))
+        result['wall_sec'] = round(time.time() - start, 3)
+        result['exit_status'] = ret
+        if ret != 0:
+            result['failures'].append("exit status %d" % ret)
+
+        try:
+            with open(log) as f:
+                output = f.read()
+        except IOError:
+            output = ""
+
+        for metric, spec in sorted(config.get('metrics', {}).items()):
+            pattern = spec.get('pattern')
+            if pattern is None:
+                value = result['wall_sec']
+            else:
+                match = re.search(pattern, output)
+                if match is None:
+                    result['failures'].append("metric %s not found in output" % metric)
+                    continue
+                value = float(match.group(spec.get('group', 1)))
+            result['metrics'][metric] = value
+            if 'max' in spec and value > spec['max']:
+                result['failures'].append(
+                    "metric %s = %s breaches max %s" % (metric, value, spec['max']))
+            if 'min' in spec and value < spec['min']:
+                result['failures'].append(
+                    "metric %s = %s breaches min %s" % (metric, value, spec['min']))
+
+        with open(out, "w") as f:
+            json.dump(result, f, indent=2, sort_keys=True)
+
+        # record the outcome for BenchmarkCheck; like unit tests, a single
+        # breach must not stop the remaining benchmarks from running
+        env.Append(BENCH_RESULTS=[result])
+        if result['failures']:
+            msg = '*** Benchmark %s failed its envelope, check %s ***' % (name, log)
+            stars = '*' * len(msg)
+            print(stars, msg, sep="\n")
+            for failure in result['failures']:
+                print('***   ' + failure)
+            print(stars)
+            env.Append(BENCHMARKS_FAILED=[name])
+
+    def strfunction(self, target, source, env):
+        return "Benchmark: " + str(source[0])
+
+
+class _benchmarkCheck(object):
+    """
+    Class which implements builder action for BenchmarkCheck. The target is
+    the aggregate JSON report; it is removed if any benchmark failed so an
+    incomplete report is never mistaken for a green one.
+    """
+
+    def __call__(self, target, source, env):
+        fpath = str(target[0])
+
+        report = {
+            "profile": env.get('BENCH_PROFILE', 'default'),
+            "baselines": env.get('BENCH_BASELINES', ''),
+            "generated": time.strftime("%Y-%m-%dT%H:%M:%S"),
+            "results": env.Flatten(env.get('BENCH_RESULTS', [])),
+        }
+        with open(fpath, "w") as f:
+            json.dump(report, f, indent=2, sort_keys=True)
+        print("benchmark report written to " + fpath)
+
+        failures = env.Flatten(env.get('BENCHMARKS_FAILED', []))
+        if failures:
+            print("Following benchmarks breached their envelopes: %s"
+                  % ' '.join(str(x) for x in failures))
+            try:
+                os.unlink(fpath)
+            except OSError:
+                pass
+            return "%d benchmark(s) failed" % len(failures)
+
+    def strfunction(self, target, source, env):
+        pass
+
+
+def generate(env):
+    """Add Builders and construction variables for running benchmarks."""
+
+    try:
+        # it may be defined already
+        builder = env['BUILDERS']['Benchmark']
+    except KeyError:
+        env['BUILDERS']['Benchmark'] = Builder(action=_benchmark(), suffix='.bench')
+        env['BUILDERS']['BenchmarkCheck'] = Builder(action=_benchmarkCheck())
+        env['BENCH_RESULTS'] = []
+        env['BENCHMARKS_FAILED'] = []
+
+
+def exists(env):
+    return True
@@ -285,6 +285,7 @@ def _setBuildEnv():
     env.Tool('antlr')
     env.Tool('antlr4')
     env.Tool('unittest')
+    env.Tool('benchmark')
     env.Tool('dirclean')
 
 